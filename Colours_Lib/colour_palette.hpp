@@ -0,0 +1,141 @@
+/**
+ * @file colour_palette.hpp
+ *
+ * @brief Palette di colori "constexpr", con impacchettamento a tempo di compilazione nei formati
+ * SDL_PIXELFORMAT_* più comuni.
+ **/
+
+#ifndef COLOUR_PALETTE_H_
+#define COLOUR_PALETTE_H_
+
+#include <SDL.h>
+#include "colours.hpp"
+
+/**
+ * @brief An RGBA colour whose conversions are all "constexpr": a colour key or fill colour built from
+ * the palette below, packed for a format known at compile time, is folded into an immediate instead
+ * of costing an SDL_AllocFormat / SDL_MapRGBA round trip at runtime.
+ **/
+struct Colour
+{
+  Uint8 R;
+  Uint8 G;
+  Uint8 B;
+  Uint8 A;
+
+  constexpr Colour( Uint8 Red, Uint8 Green, Uint8 Blue, Uint8 Alpha = ALPHA_MAX )
+    : R(Red), G(Green), B(Blue), A(Alpha)
+  {;}
+
+  /**
+   * @brief Same colour, different alpha.
+   **/
+  constexpr Colour WithAlpha( Uint8 Alpha ) const
+  {
+    return Colour( R, G, B, Alpha );
+  }
+
+  /**
+   * @brief Premultiplied alpha variant: the colour channels scaled by alpha, rounded to nearest. To
+   * be drawn with a blend mode that expects it, e.g. SDL_ComposeCustomBlendMode( SDL_BLENDFACTOR_ONE,
+   * SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, ... ).
+   **/
+  constexpr Colour Premultiplied( void ) const
+  {
+    return Colour( Scale_Pvt( R, A ), Scale_Pvt( G, A ), Scale_Pvt( B, A ), A );
+  }
+
+  constexpr SDL_Color ToSDL( void ) const
+  {
+    return SDL_Color{ R, G, B, A };
+  }
+
+  /**
+   * @brief The pixel value of this colour in a given format, equal to what SDL_MapRGBA returns.
+   * Formats without alpha drop it, as SDL does. The 32 bit layouts and RGB565 are packed at compile
+   * time; any other format falls back to SDL_MapRGBA at runtime (so it cannot be used to initialise a
+   * constexpr variable).
+   **/
+  constexpr Uint32 Pack( Uint32 Format ) const
+  {
+    switch ( Format )
+    {
+      case SDL_PIXELFORMAT_ARGB8888: return Word_Pvt( A, R, G, B );
+      case SDL_PIXELFORMAT_RGBA8888: return Word_Pvt( R, G, B, A );
+      case SDL_PIXELFORMAT_ABGR8888: return Word_Pvt( A, B, G, R );
+      case SDL_PIXELFORMAT_BGRA8888: return Word_Pvt( B, G, R, A );
+      case SDL_PIXELFORMAT_RGB888:   return Word_Pvt( 0, R, G, B );
+      case SDL_PIXELFORMAT_BGR888:   return Word_Pvt( 0, B, G, R );
+      case SDL_PIXELFORMAT_RGBX8888: return Word_Pvt( R, G, B, 0 );
+      case SDL_PIXELFORMAT_BGRX8888: return Word_Pvt( B, G, R, 0 );
+      case SDL_PIXELFORMAT_RGB565:
+        return ( static_cast<Uint32>( R >> 3 ) << 11 ) | ( static_cast<Uint32>( G >> 2 ) << 5 ) | static_cast<Uint32>( B >> 3 );
+      default:
+        return PackAtRuntime_Pvt( Format );
+    }
+  }
+
+private:
+
+  static constexpr Uint8 Scale_Pvt( Uint8 Channel, Uint8 Alpha )
+  {
+    return static_cast<Uint8>( ( Channel * Alpha + ALPHA_MAX / 2 ) / ALPHA_MAX );
+  }
+
+  // Packs four bytes, most significant first
+  static constexpr Uint32 Word_Pvt( Uint8 b3, Uint8 b2, Uint8 b1, Uint8 b0 )
+  {
+    return ( static_cast<Uint32>( b3 ) << 24 ) | ( static_cast<Uint32>( b2 ) << 16 ) |
+           ( static_cast<Uint32>( b1 ) <<  8 ) |   static_cast<Uint32>( b0 );
+  }
+
+  Uint32 PackAtRuntime_Pvt( Uint32 Format ) const
+  {
+    SDL_PixelFormat* Mapping = SDL_AllocFormat( Format );
+    const Uint32     Pixel   = ( Mapping != NULL ) ? SDL_MapRGBA( Mapping, R, G, B, A ) : 0;
+
+    SDL_FreeFormat( Mapping );
+
+    return Pixel;
+  }
+};
+
+
+/**
+ * @brief Sets the draw colour of a renderer from a palette entry, instead of four macros.
+ **/
+inline int SetRenderDrawColour( SDL_Renderer* Renderer_Ptr, const Colour& DrawColour )
+{
+  return SDL_SetRenderDrawColor( Renderer_Ptr, DrawColour.R, DrawColour.G, DrawColour.B, DrawColour.A );
+}
+
+
+// Palette: gli stessi colori di colours.hpp
+namespace Palette
+{
+  constexpr Colour White     { WHITE_R     , WHITE_G     , WHITE_B      };
+  constexpr Colour Black     { BLACK_R     , BLACK_G     , BLACK_B      };
+  constexpr Colour Red       { RED_R       , RED_G       , RED_B        };
+  constexpr Colour Cyan      { CYAN_R      , CYAN_G      , CYAN_B       };
+  constexpr Colour Yellow    { YELLOW_R    , YELLOW_G    , YELLOW_B     };
+  constexpr Colour Green     { GREEN_R     , GREEN_G     , GREEN_B      };
+  constexpr Colour DarkGreen { GRN_DRK_R   , GRN_DRK_G   , GRN_DRK_B    };
+  constexpr Colour Blue      { BLUE_R      , BLUE_G      , BLUE_B       };
+  constexpr Colour Fuchsia   { FUCHSIA_R   , FUCHSIA_G   , FUCHSIA_B    };
+  constexpr Colour Orange    { ORANGE_R    , ORANGE_G    , ORANGE_B     };
+  constexpr Colour Gold      { GOLD_R      , GOLD_G      , GOLD_B       };
+  constexpr Colour LightGrey { LIGHT_GREY_R, LIGHT_GREY_G, LIGHT_GREY_B };
+
+  // Colore chiave dei fogli di sprite e trasparenza completa
+  constexpr Colour ColourKey   = Cyan;
+  constexpr Colour Transparent = White.WithAlpha( ALPHA_MIN );
+}
+
+// Compile-time checks of the packing against the layouts documented by SDL
+static_assert( Palette::Cyan.Pack( SDL_PIXELFORMAT_ARGB8888 ) == 0xFF00FFFFu, "ARGB8888 packing" );
+static_assert( Palette::Cyan.Pack( SDL_PIXELFORMAT_RGBA8888 ) == 0x00FFFFFFu, "RGBA8888 packing" );
+static_assert( Palette::Red.Pack ( SDL_PIXELFORMAT_ABGR8888 ) == 0xFF0000FFu, "ABGR8888 packing" );
+static_assert( Palette::Red.Pack ( SDL_PIXELFORMAT_RGB888   ) == 0x00FF0000u, "RGB888 packing"   );
+static_assert( Palette::White.WithAlpha( 0x80 ).Premultiplied().R == 0x80, "Premultiplication" );
+
+#endif // COLOUR_PALETTE_H_
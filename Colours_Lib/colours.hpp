@@ -66,4 +66,9 @@
 #define GOLD_G 0xD7
 #define GOLD_B 0x00
 
+// Colore grigio chiaro
+#define LIGHT_GREY_R 0xD3
+#define LIGHT_GREY_G 0xD3
+#define LIGHT_GREY_B 0xD3
+
 #endif // COLOURS_H_
\ No newline at end of file
@@ -0,0 +1,71 @@
+@echo off
+
+cls
+echo.
+
+@REM Library's name
+set ENGINE_LIB_NAME=libEngine.a
+
+@REM Source files. LTexture_Text.cpp is a separate object, so that programs not using SDL_ttf do
+@REM not need to link it
+set SOURCE_FILES=LTexture.cpp LTexture_Baked.cpp LTexture_Text.cpp LSpriteBatch.cpp LDrawList.cpp LCollision.cpp LCollision_Packed.cpp LCollision_Tree.cpp LPathfinder.cpp LTimer.cpp LFramePacer.cpp LFrameStats.cpp LJobSystem.cpp LLockStats.cpp LTimerWheel.cpp LStreamingTexture.cpp LPixelOps.cpp LBlockCompress.cpp LRenderTargets.cpp LLightMap.cpp LFrameArena.cpp LGlyphMetrics.cpp LTextCache.cpp LGlyphAtlas.cpp LTextField.cpp LSdfFont.cpp LAudioMixer.cpp LAudioStream.cpp LAudioAnalyser.cpp LMappedFile.cpp LAssetPack.cpp LSaveFile.cpp LSnapshot.cpp LAutosave.cpp LWindowManager.cpp LInput.cpp LInputPump.cpp LAnimation.cpp LEntityStore.cpp LEntitySystems.cpp LFrameCapture.cpp LSoftRenderer.cpp LDynamicResolution.cpp LRendererSelect.cpp LLateLatch.cpp LEventFilter.cpp LAsyncText.cpp LMusicStream.cpp LImaAdpcm.cpp LTextureAtlas.cpp LMultiView.cpp LScrollingLayers.cpp LChunkStreamer.cpp LPrimitiveBatch.cpp LDebugDraw.cpp LPerfHarness.cpp LPerfHarness_Run.cpp LTrace.cpp
+set OBJECT_FILES=LTexture.o LTexture_Baked.o LTexture_Text.o LSpriteBatch.o LDrawList.o LCollision.o LCollision_Packed.o LCollision_Tree.o LPathfinder.o LTimer.o LFramePacer.o LFrameStats.o LJobSystem.o LLockStats.o LTimerWheel.o LStreamingTexture.o LPixelOps.o LBlockCompress.o LRenderTargets.o LLightMap.o LFrameArena.o LGlyphMetrics.o LTextCache.o LGlyphAtlas.o LTextField.o LSdfFont.o LAudioMixer.o LAudioStream.o LAudioAnalyser.o LMappedFile.o LAssetPack.o LSaveFile.o LSnapshot.o LAutosave.o LWindowManager.o LInput.o LInputPump.o LAnimation.o LEntityStore.o LEntitySystems.o LFrameCapture.o LSoftRenderer.o LDynamicResolution.o LRendererSelect.o LLateLatch.o LEventFilter.o LAsyncText.o LMusicStream.o LImaAdpcm.o LTextureAtlas.o LMultiView.o LScrollingLayers.o LChunkStreamer.o LPrimitiveBatch.o LDebugDraw.o LPerfHarness.o LPerfHarness_Run.o LTrace.o
+
+@REM Header files
+set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
+set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
+set SDL2_TTF_INCLUDE_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\include\SDL2
+set COLOURS_LIB_INCLUDE_PATH=..\Colours_Lib
+set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF_INCLUDE_PATH% -I%COLOURS_LIB_INCLUDE_PATH%
+
+@REM C++ compilation options. Optimised: every program linking the library gets the same code
+set COMPILATION_OPTIONS=-O2 -Wall -Wextra -Wpedantic -Wconversion
+
+
+if %1.==-c. goto Clean
+
+
+@REM Build library
+if exist %ENGINE_LIB_NAME% (
+  echo %ENGINE_LIB_NAME% already exists. Deleting...
+  echo.
+  del %ENGINE_LIB_NAME%
+) else (
+  echo.
+)
+
+
+echo Building library...
+echo.
+
+@REM echo on
+g++ -c %COMPILATION_OPTIONS% %SOURCE_FILES% %SDL2_INCLUDE_PATHS%
+@REM echo off
+
+IF %ERRORLEVEL% NEQ 0 goto Error
+
+ar rcs %ENGINE_LIB_NAME% %OBJECT_FILES%
+
+IF %ERRORLEVEL% NEQ 0 goto Error
+
+del %OBJECT_FILES%
+echo.
+echo [32mCompilation was successful![0m
+echo.
+exit /b
+
+
+:Error
+  echo.
+  echo [31m*** Error ***[0m
+  echo.
+  echo Compilation errors were encountered.
+  exit /b
+
+
+:Clean
+  echo Cleaning artifacts...
+  echo.
+  del %ENGINE_LIB_NAME%
+  echo Done.
+  echo.
@@ -0,0 +1,304 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAnimation.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr size_t MAX_ANIMATIONS = 0x10000;   // Indices kept in a Uint16 per instance
+
+
+/***************************************************************************************************
+* LAnimationSet methods
+****************************************************************************************************/
+
+LAnimationSet::LAnimationSet( void )
+  : m_Clips(), m_Animations()
+{;}
+
+
+/**
+ * @brief Adds an animation, copying its clips to the end of the packed table.
+ *
+ * @param Clips The frames, in order.
+ * @param FrameCount How many.
+ * @param FrameTime_s How long every frame is shown.
+ * @param IsLooping true to start again after the last frame; false to stay on it.
+ * @return the index of the animation, to spawn instances with; -1 if the arguments are not valid.
+ **/
+int LAnimationSet::add( const SDL_Rect* Clips, int FrameCount, double FrameTime_s, bool IsLooping )
+{
+  if ( Clips == NULL || FrameCount <= 0 || !( FrameTime_s > 0.0 ) || m_Animations.size() == MAX_ANIMATIONS )
+  {
+    printf( "\nUnable to add an animation of %d frames, %f s each!", FrameCount, FrameTime_s );
+    return -1;
+  }
+  else
+  {;}
+
+  const Animation NewAnimation{ static_cast<Uint32>( m_Clips.size() ), static_cast<Uint32>( FrameCount ),
+                                static_cast<float>( 1.0 / FrameTime_s ), static_cast<float>( FrameCount * FrameTime_s ),
+                                IsLooping };
+
+  m_Clips.insert( m_Clips.end(), Clips, Clips + FrameCount );
+  m_Animations.push_back( NewAnimation );
+
+  return static_cast<int>( m_Animations.size() ) - 1;
+}
+
+
+/**
+ * @brief Adds an animation whose frames are side by side on one row of the sprite sheet, the usual
+ * layout: every frame is the size of the first, and starts where the previous one ends.
+ *
+ * @param First The clip of the first frame.
+ * @param FrameCount Frames on the row, from the first.
+ * @param FrameTime_s How long every frame is shown.
+ * @param IsLooping true to start again after the last frame; false to stay on it.
+ * @return the index of the animation; -1 if the arguments are not valid.
+ **/
+int LAnimationSet::addStrip( const SDL_Rect& First, int FrameCount, double FrameTime_s, bool IsLooping )
+{
+  std::vector<SDL_Rect> Strip;
+
+  for ( int i = 0; i < FrameCount; ++i )
+  {
+    Strip.push_back( SDL_Rect{ First.x + i * First.w, First.y, First.w, First.h } );
+  }
+
+  return add( Strip.data(), FrameCount, FrameTime_s, IsLooping );
+}
+
+
+/**
+ * @brief Removes every animation. The animators of the set must be cleared too.
+ **/
+void LAnimationSet::clear( void )
+{
+  m_Clips.clear();
+  m_Animations.clear();
+}
+
+
+size_t LAnimationSet::GetAnimationCount( void ) const
+{
+  return m_Animations.size();
+}
+
+
+/**
+ * @return the frames of an animation; 0 for an invalid index.
+ **/
+int LAnimationSet::GetFrameCount( int Index ) const
+{
+  return ( Index >= 0 && static_cast<size_t>( Index ) < m_Animations.size() ) ? static_cast<int>( m_Animations[Index].FrameCount ) : 0;
+}
+
+
+/**
+ * @return the seconds an animation lasts, at speed 1; 0 for an invalid index.
+ **/
+double LAnimationSet::GetDuration( int Index ) const
+{
+  return ( Index >= 0 && static_cast<size_t>( Index ) < m_Animations.size() ) ? static_cast<double>( m_Animations[Index].Duration_s ) : 0.0;
+}
+
+
+/**
+ * @return the clip at an index of the packed table, as given by LAnimator::GetClipIndex.
+ **/
+const SDL_Rect& LAnimationSet::GetClip( Uint32 ClipIndex ) const
+{
+  return m_Clips[ClipIndex];
+}
+
+
+/***************************************************************************************************
+* LAnimator methods
+****************************************************************************************************/
+
+LAnimator::LAnimator( const LAnimationSet& Set )
+  : m_Set_Ptr(&Set), m_Animations(), m_Times_s(), m_Speeds(), m_ClipIndices()
+{;}
+
+
+/**
+ * @brief Adds an instance; it is the last one, GetCount() - 1.
+ *
+ * @param Animation The animation it plays, from the set.
+ * @param Time_s How far into the animation it starts, e.g. to keep a crowd out of step.
+ * @param Speed 1 for the animation's own pace, 2 for twice as fast, and so on.
+ * @return false if the animation is not in the set, and nothing is added.
+ **/
+bool LAnimator::spawn( int Animation, float Time_s, float Speed )
+{
+  if ( Animation < 0 || static_cast<size_t>( Animation ) >= m_Set_Ptr->m_Animations.size() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Animations.push_back( static_cast<Uint16>( Animation ) );
+  m_Times_s.push_back( 0.f );
+  m_Speeds.push_back( SDL_max( Speed, 0.f ) );
+  m_ClipIndices.push_back( 0 );
+
+  return play( m_Animations.size() - 1, Animation, Time_s );
+}
+
+
+/**
+ * @brief Switches an instance to an animation, from a point in it.
+ *
+ * @return false if the instance or the animation does not exist.
+ **/
+bool LAnimator::play( size_t Instance, int Animation, float Time_s )
+{
+  if ( Instance >= m_Animations.size() || Animation < 0 || static_cast<size_t>( Animation ) >= m_Set_Ptr->m_Animations.size() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const LAnimationSet::Animation& Played  = m_Set_Ptr->m_Animations[Animation];
+  float                           Start_s = SDL_max( Time_s, 0.f );
+
+  if ( Start_s >= Played.Duration_s )
+  {
+    Start_s = Played.IsLooping ? std::fmod( Start_s, Played.Duration_s ) : Played.Duration_s;
+  }
+  else
+  {;}
+
+  m_Animations [Instance] = static_cast<Uint16>( Animation );
+  m_Times_s    [Instance] = Start_s;
+  m_ClipIndices[Instance] = GetClipIndex_Pvt( m_Animations[Instance], Start_s );
+
+  return true;
+}
+
+
+void LAnimator::setSpeed( size_t Instance, float Speed )
+{
+  if ( Instance < m_Speeds.size() )
+  {
+    m_Speeds[Instance] = SDL_max( Speed, 0.f );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Advances every instance by the time elapsed since the previous update, and updates the
+ * clip each one shows.
+ *
+ * @param DeltaTime_s Seconds, e.g. from LHighResTimer::lap.
+ **/
+void LAnimator::update( double DeltaTime_s )
+{
+  const LAnimationSet::Animation* Table_Ptr   = m_Set_Ptr->m_Animations.data();
+  const Uint16*                   Playing_Ptr = m_Animations.data();
+  const float*                    Speeds_Ptr  = m_Speeds.data();
+  float*                          Times_Ptr   = m_Times_s.data();
+  Uint32*                         Clips_Ptr   = m_ClipIndices.data();
+  const size_t                    Count       = m_Animations.size();
+  const float                     Step_s      = static_cast<float>( DeltaTime_s );
+
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    const LAnimationSet::Animation& Played = Table_Ptr[ Playing_Ptr[i] ];
+
+    float Time_s = Times_Ptr[i] + Step_s * Speeds_Ptr[i];
+
+    if ( Time_s >= Played.Duration_s )
+    {
+      // One step rarely spans more than a loop, but a long stall may
+      Time_s = Played.IsLooping ? Time_s - Played.Duration_s * std::floor( Time_s / Played.Duration_s ) : Played.Duration_s;
+    }
+    else
+    {;}
+
+    const Uint32 Frame = static_cast<Uint32>( Time_s * Played.FramesPerSecond );
+
+    Times_Ptr[i] = Time_s;
+    Clips_Ptr[i] = Played.FirstClip + SDL_min( Frame, Played.FrameCount - 1 );
+  }
+}
+
+
+/**
+ * @brief Removes every instance.
+ **/
+void LAnimator::clear( void )
+{
+  m_Animations.clear();
+  m_Times_s.clear();
+  m_Speeds.clear();
+  m_ClipIndices.clear();
+}
+
+
+size_t LAnimator::GetCount( void ) const
+{
+  return m_Animations.size();
+}
+
+
+/**
+ * @return the index, in the set's packed clip table, of the clip an instance shows.
+ **/
+Uint32 LAnimator::GetClipIndex( size_t Instance ) const
+{
+  return m_ClipIndices[Instance];
+}
+
+
+/**
+ * @return the clip an instance shows.
+ **/
+const SDL_Rect& LAnimator::GetClip( size_t Instance ) const
+{
+  return m_Set_Ptr->m_Clips[ m_ClipIndices[Instance] ];
+}
+
+
+/**
+ * @return the clip indices of all the instances, GetCount() of them, for drawing them in one loop.
+ **/
+const Uint32* LAnimator::GetClipIndices( void ) const
+{
+  return m_ClipIndices.data();
+}
+
+
+/**
+ * @return true if an instance has reached the end of an animation that does not loop.
+ **/
+bool LAnimator::IsFinished( size_t Instance ) const
+{
+  const LAnimationSet::Animation& Played = m_Set_Ptr->m_Animations[ m_Animations[Instance] ];
+
+  return !Played.IsLooping && m_Times_s[Instance] >= Played.Duration_s;
+}
+
+
+/**
+ * @return the index, in the packed clip table, of the frame shown at a time into an animation.
+ **/
+Uint32 LAnimator::GetClipIndex_Pvt( Uint16 Animation, float Time_s ) const
+{
+  const LAnimationSet::Animation& Played = m_Set_Ptr->m_Animations[Animation];
+  const Uint32                    Frame  = static_cast<Uint32>( Time_s * Played.FramesPerSecond );
+
+  return Played.FirstClip + SDL_min( Frame, Played.FrameCount - 1 );
+}
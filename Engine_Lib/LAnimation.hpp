@@ -0,0 +1,92 @@
+/**
+ * @file LAnimation.hpp
+ *
+ * @brief Sprite sheet animations: the clips of every animation packed in one table, and crowds of
+ * animated instances advanced by elapsed time in a single loop.
+ **/
+
+#ifndef LANIMATION_HPP
+#define LANIMATION_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief The animations of a sprite sheet. The clips of all of them are packed, in order, in one
+ * table; an animation is a run of it, played at a fixed number of frames per second, looping or
+ * stopping on its last frame.
+ *
+ * Animations are only ever added: the index returned by "add" stays valid until "clear".
+ **/
+class LAnimationSet
+{
+public:
+
+  LAnimationSet( void );
+
+  int    add               ( const SDL_Rect*, int, double, bool = true );
+  int    addStrip          ( const SDL_Rect&, int, double, bool = true );
+  void   clear             ( void );
+
+  size_t          GetAnimationCount ( void ) const;
+  int             GetFrameCount     ( int ) const;
+  double          GetDuration       ( int ) const;
+  const SDL_Rect& GetClip           ( Uint32 ) const;
+
+private:
+
+  friend class LAnimator;
+
+  struct Animation
+  {
+    Uint32 FirstClip;        // In m_Clips
+    Uint32 FrameCount;
+    float  FramesPerSecond;
+    float  Duration_s;       // FrameCount frames
+    bool   IsLooping;
+  };
+
+  std::vector<SDL_Rect>  m_Clips;        // Every animation's, one after the other
+  std::vector<Animation> m_Animations;
+};
+
+
+/**
+ * @brief Many instances playing animations of one LAnimationSet, kept as structure of arrays: which
+ * animation, how far into it, at what speed, and the clip it shows. "update" advances all of them by
+ * the elapsed time in one loop over these arrays, reading the few animations from the set's table,
+ * and leaves the index of each instance's clip in the packed clip table, ready for drawing.
+ *
+ * Time is counted in seconds, from a high resolution timer, not in rendered frames: the animations
+ * play at the same pace whatever the refresh rate. Speeds are not negative; 0 freezes an instance.
+ **/
+class LAnimator
+{
+public:
+
+  explicit LAnimator( const LAnimationSet& );
+
+  bool   spawn         ( int, float = 0.f, float = 1.f );
+  bool   play          ( size_t, int, float = 0.f );
+  void   setSpeed      ( size_t, float );
+  void   update        ( double );
+  void   clear         ( void );
+
+  size_t          GetCount       ( void ) const;
+  Uint32          GetClipIndex   ( size_t ) const;
+  const SDL_Rect& GetClip        ( size_t ) const;
+  const Uint32*   GetClipIndices ( void ) const;
+  bool            IsFinished     ( size_t ) const;
+
+private:
+
+  Uint32 GetClipIndex_Pvt ( Uint16, float ) const;
+
+  const LAnimationSet* m_Set_Ptr;
+  std::vector<Uint16>  m_Animations;     // Per instance, index in the set
+  std::vector<float>   m_Times_s;        // Per instance, into the animation, wrapped when looping
+  std::vector<float>   m_Speeds;         // Per instance, 1 for the animation's own pace
+  std::vector<Uint32>  m_ClipIndices;    // Per instance, in the set's packed clip table
+};
+
+#endif // LANIMATION_HPP
@@ -0,0 +1,724 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAssetPack.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr size_t MIN_MATCH   = 4;                // Shorter repeats stay literals
+static constexpr size_t MAX_OFFSET  = 0xFFFF;           // Distances are stored in two bytes
+static constexpr int    HASH_BITS   = 14;               // Of the table of the last position of each 4 bytes
+static constexpr size_t NO_POSITION = static_cast<size_t>( -1 );
+static constexpr size_t RUN_NIBBLE  = 15;               // Nibble that says the length goes on in bytes
+static constexpr size_t PAGE_BYTES  = 4096;             // Stride of the prefetch touches
+
+
+/***************************************************************************************************
+* Private variables
+****************************************************************************************************/
+
+static LAssetPack* g_DefaultPack = nullptr;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Writes what a length nibble could not hold: runs of 255, then the rest.
+ **/
+static void WriteLength( std::vector<Uint8>& Out, size_t Length )
+{
+  if ( Length >= RUN_NIBBLE )
+  {
+    Length -= RUN_NIBBLE;
+
+    while ( Length >= 255 )
+    {
+      Out.push_back( 255 );
+      Length -= 255;
+    }
+
+    Out.push_back( static_cast<Uint8>( Length ) );
+  }
+  else
+  {;}
+}
+
+
+static bool ReadLength( const Uint8* Source_Ptr, size_t Size, size_t& In, size_t& Length )
+{
+  if ( Length == RUN_NIBBLE )
+  {
+    Uint8 Byte;
+
+    do
+    {
+      if ( In == Size )
+      {
+        return false;
+      }
+      else
+      {;}
+
+      Byte    = Source_Ptr[In++];
+      Length += Byte;
+    }
+    while ( Byte == 255 );
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Writes a token, the literals before a match, and the match unless it is the last sequence
+ * (Length 0), which has literals only.
+ **/
+static void WriteSequence( std::vector<Uint8>& Out, const Uint8* Literals_Ptr, size_t Literals, size_t Offset, size_t Length )
+{
+  const size_t MatchCode = ( Length != 0 ) ? Length - MIN_MATCH : 0;
+
+  Out.push_back( static_cast<Uint8>( ( std::min( Literals, RUN_NIBBLE ) << 4 ) | std::min( MatchCode, RUN_NIBBLE ) ) );
+  WriteLength( Out, Literals );
+  Out.insert( Out.end(), Literals_Ptr, Literals_Ptr + Literals );
+
+  if ( Length != 0 )
+  {
+    Out.push_back( static_cast<Uint8>( Offset & 0xFF ) );
+    Out.push_back( static_cast<Uint8>( Offset >> 8 ) );
+    WriteLength( Out, MatchCode );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @return <0, 0 or >0, as memcmp, with a shorter name before the longer one it begins.
+ **/
+static int CompareNames( const char* A_Ptr, size_t LengthA, const char* B_Ptr, size_t LengthB )
+{
+  const int Result = memcmp( A_Ptr, B_Ptr, std::min( LengthA, LengthB ) );
+
+  if ( Result != 0 )
+  {
+    return Result;
+  }
+  else
+  {;}
+
+  return ( LengthA < LengthB ) ? -1 : ( LengthA > LengthB ) ? 1 : 0;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Compresses Size bytes into Out, as sequences of literals and matches: a token with both
+ * lengths in its nibbles, longer lengths in extra bytes, the literals, and the distance back to the
+ * match in two bytes. A greedy parse with a hash of the last position of every 4 bytes: meant for
+ * packing offline, where text, fonts, WAVs and BMPs shrink well; PNGs do not, and are stored.
+ **/
+void LAssetCompress( const Uint8* Source_Ptr, size_t Size, std::vector<Uint8>& Out )
+{
+  std::vector<size_t> Table( static_cast<size_t>( 1 ) << HASH_BITS, NO_POSITION );
+
+  Out.clear();
+  Out.reserve( Size + Size / 255 + 16 );
+
+  size_t Anchor = 0;
+  size_t i      = 0;
+
+  while ( i + MIN_MATCH <= Size )
+  {
+    Uint32 Key;
+
+    memcpy( &Key, Source_Ptr + i, sizeof(Key) );
+
+    const size_t Hash      = ( Key * 2654435761u ) >> ( 32 - HASH_BITS );
+    const size_t Candidate = Table[Hash];
+
+    Table[Hash] = i;
+
+    if ( Candidate != NO_POSITION && i - Candidate <= MAX_OFFSET && memcmp( Source_Ptr + Candidate, Source_Ptr + i, MIN_MATCH ) == 0 )
+    {
+      size_t Length = MIN_MATCH;
+
+      while ( i + Length < Size && Source_Ptr[Candidate + Length] == Source_Ptr[i + Length] )
+      {
+        ++Length;
+      }
+
+      WriteSequence( Out, Source_Ptr + Anchor, i - Anchor, i - Candidate, Length );
+
+      i      += Length;
+      Anchor  = i;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  WriteSequence( Out, Source_Ptr + Anchor, Size - Anchor, 0, 0 );
+}
+
+
+/**
+ * @brief Decompresses what LAssetCompress wrote. Every length and distance is checked against both
+ * buffers, so a damaged pack fails instead of writing out of bounds.
+ *
+ * @return true if exactly DestinationSize bytes came out.
+ **/
+bool LAssetDecompress( const Uint8* Source_Ptr, size_t SourceSize, Uint8* Destination_Ptr, size_t DestinationSize )
+{
+  size_t In  = 0;
+  size_t Out = 0;
+
+  while ( In != SourceSize )
+  {
+    const Uint8 Token    = Source_Ptr[In++];
+    size_t      Literals = Token >> 4;
+
+    if ( !ReadLength( Source_Ptr, SourceSize, In, Literals )
+         || Literals > SourceSize - In || Literals > DestinationSize - Out )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    memcpy( Destination_Ptr + Out, Source_Ptr + In, Literals );
+    In  += Literals;
+    Out += Literals;
+
+    if ( In == SourceSize )
+    {
+      break; // The last sequence has no match
+    }
+    else if ( SourceSize - In < 2 )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    const size_t Offset = Source_Ptr[In] | ( static_cast<size_t>( Source_Ptr[In + 1] ) << 8 );
+    size_t       Length = Token & 0x0F;
+
+    In += 2;
+
+    if ( Offset == 0 || Offset > Out || !ReadLength( Source_Ptr, SourceSize, In, Length )
+         || ( Length += MIN_MATCH ) > DestinationSize - Out )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    // Byte by byte: the match may overlap what it is copying, to repeat a short run
+    for ( size_t k = 0; k != Length; ++k )
+    {
+      Destination_Ptr[Out + k] = Destination_Ptr[Out - Offset + k];
+    }
+
+    Out += Length;
+  }
+
+  return Out == DestinationSize;
+}
+
+
+/**
+ * @brief Opens an asset from the default pack if it holds it, and from the file of the same name
+ * otherwise: the call sites stay the same with and without a pack.
+ *
+ * @return An SDL_RWops for reading, to be closed by the caller (or by the loader it is handed to);
+ * NULL if neither has it.
+ **/
+SDL_RWops* LOpenAsset( const std::string& Path )
+{
+  if ( g_DefaultPack != nullptr && g_DefaultPack->IsOpen() )
+  {
+    SDL_RWops* Asset_Ptr = g_DefaultPack->openRW( Path );
+
+    if ( Asset_Ptr != NULL )
+    {
+      return Asset_Ptr;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  return SDL_RWFromFile( Path.c_str(), "rb" );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LAssetPack::LAssetPack( void )
+  : m_File(), m_Entries(nullptr), m_Names(nullptr), m_NumOfEntries(0), m_Slots(), m_Queue_Ptr(),
+    m_Prefetcher_Ptr(nullptr), m_Lock_Ptr(SDL_CreateMutex()), m_Loaded_Ptr(SDL_CreateCond()), m_Pending(0)
+{;}
+
+
+LAssetPack::~LAssetPack( void )
+{
+  close();
+
+  if ( g_DefaultPack == this )
+  {
+    g_DefaultPack = nullptr;
+  }
+  else
+  {;}
+
+  SDL_DestroyCond( m_Loaded_Ptr );
+  SDL_DestroyMutex( m_Lock_Ptr );
+}
+
+
+/**
+ * @brief Sets the pack LOpenAsset looks into first; nullptr for none.
+ **/
+void LAssetPack::SetDefault( LAssetPack* Pack_Ptr )
+{
+  g_DefaultPack = Pack_Ptr;
+}
+
+
+LAssetPack* LAssetPack::GetDefault( void )
+{
+  return g_DefaultPack;
+}
+
+
+/**
+ * @brief The name of a path inside a pack: forward slashes, and no leading "./".
+ **/
+std::string LAssetPack::NormaliseName( const std::string& Path )
+{
+  std::string Name( Path );
+
+  std::replace( Name.begin(), Name.end(), '\\', '/' );
+
+  while ( Name.compare( 0, 2, "./" ) == 0 )
+  {
+    Name.erase( 0, 2 );
+  }
+
+  return Name;
+}
+
+
+/**
+ * @brief Maps a pack and checks its table of contents.
+ *
+ * @return true if the pack is valid; it is left closed otherwise.
+ **/
+bool LAssetPack::open( const std::string& Path )
+{
+  close();
+
+  if ( !m_File.open( Path.c_str() ) )
+  {
+    printf( "\nUnable to map asset pack \"%s\"!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  const Uint8* const Data_Ptr = m_File.GetData();
+  const size_t       Size     = m_File.GetSize();
+  LAssetPackHeader   Header;
+  bool               IsValid  = Size >= sizeof(Header);
+
+  if ( IsValid )
+  {
+    memcpy( &Header, Data_Ptr, sizeof(Header) );
+
+    IsValid = memcmp( Header.Magic, LASSET_PACK_MAGIC, sizeof(Header.Magic) ) == 0 && Header.Version == LASSET_PACK_VERSION
+              && Header.TocOffset <= Size && Header.TocSize <= Size - Header.TocOffset
+              && Header.TocOffset % alignof(LAssetPackEntry) == 0
+              && Header.NumOfEntries <= Header.TocSize / sizeof(LAssetPackEntry);
+  }
+  else
+  {;}
+
+  if ( IsValid )
+  {
+    m_Entries      = reinterpret_cast<const LAssetPackEntry*>( Data_Ptr + Header.TocOffset );
+    m_Names        = reinterpret_cast<const char*>( m_Entries + Header.NumOfEntries );
+    m_NumOfEntries = Header.NumOfEntries;
+
+    const Uint64 NamesSize = Header.TocSize - Header.NumOfEntries * sizeof(LAssetPackEntry);
+
+    for ( Uint32 i = 0; IsValid && i != m_NumOfEntries; ++i )
+    {
+      const LAssetPackEntry& Entry = m_Entries[i];
+
+      IsValid = Entry.Offset <= Header.TocOffset && Entry.StoredSize <= Header.TocOffset - Entry.Offset
+                && static_cast<Uint64>( Entry.NameOffset ) + Entry.NameLength <= NamesSize
+                && ( ( Entry.Compression == LASSET_PACK_STORED && Entry.StoredSize == Entry.Size )
+                     || Entry.Compression == LASSET_PACK_LZ )
+                && ( i == 0 || CompareNames( m_Names + m_Entries[i - 1].NameOffset, m_Entries[i - 1].NameLength,
+                                             m_Names + Entry.NameOffset, Entry.NameLength ) < 0 );
+    }
+  }
+  else
+  {;}
+
+  if ( !IsValid )
+  {
+    printf( "\nAsset pack \"%s\" is not valid!", Path.c_str() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  m_Slots.reset( new Slot[m_NumOfEntries] );
+
+  for ( Uint32 i = 0; i != m_NumOfEntries; ++i )
+  {
+    m_Slots[i].Status.store( State::COLD, std::memory_order_relaxed );
+  }
+
+  m_Queue_Ptr.reset( new Queue( std::max<size_t>( m_NumOfEntries, 1 ) ) );
+  m_Pending.store( 0, std::memory_order_relaxed );
+
+  return true;
+}
+
+
+/**
+ * @brief Stops the prefetch thread, frees what was decompressed and unmaps the pack.
+ **/
+void LAssetPack::close( void )
+{
+  if ( m_Prefetcher_Ptr != nullptr )
+  {
+    // The thread takes what is left in the queue, then sees it closed and empty
+    m_Queue_Ptr->close();
+    SDL_WaitThread( m_Prefetcher_Ptr, nullptr );
+    m_Prefetcher_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Queue_Ptr.reset();
+  m_Slots.reset();
+  m_Entries      = nullptr;
+  m_Names        = nullptr;
+  m_NumOfEntries = 0;
+  m_File.close();
+}
+
+
+bool LAssetPack::contains( const std::string& Name ) const
+{
+  return Find_Pvt( Name ) >= 0;
+}
+
+
+/**
+ * @return An SDL_RWops over the entry, to be closed by the caller; NULL if the pack does not have it,
+ * or it could not be decompressed.
+ **/
+SDL_RWops* LAssetPack::openRW( const std::string& Name )
+{
+  const Uint8* Data_Ptr = nullptr;
+  size_t       Size     = 0;
+
+  return view( Name, Data_Ptr, Size ) ? SDL_RWFromConstMem( Data_Ptr, static_cast<int>( Size ) ) : NULL;
+}
+
+
+/**
+ * @brief The bytes of an entry, without an SDL_RWops: in the mapping for a stored entry, at the
+ * alignment of the pack, in the decompressed copy otherwise.
+ *
+ * @return false if the pack does not have it, or it could not be decompressed.
+ **/
+bool LAssetPack::view( const std::string& Name, const Uint8*& Data_Ptr, size_t& Size )
+{
+  const int Index = Find_Pvt( Name );
+
+  if ( Index < 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Uint32           i     = static_cast<Uint32>( Index );
+  const LAssetPackEntry& Entry = m_Entries[i];
+
+  if ( Entry.Compression == LASSET_PACK_STORED )
+  {
+    Data_Ptr = m_File.GetData() + Entry.Offset;
+    Size     = static_cast<size_t>( Entry.Size );
+    return true;
+  }
+  else if ( Acquire_Pvt( i ) )
+  {
+    Data_Ptr = m_Slots[i].Data.data();
+    Size     = m_Slots[i].Data.size();
+    return true;
+  }
+  else
+  {
+    printf( "\nUnable to decompress \"%s\" from the asset pack!", Name.c_str() );
+    return false;
+  }
+}
+
+
+/**
+ * @brief Queues an entry for the prefetch thread, started on first use. Nothing happens if the pack
+ * does not have it, or it was already queued or read.
+ **/
+void LAssetPack::prefetch( const std::string& Name )
+{
+  const int Index = Find_Pvt( Name );
+  State     Cold  = State::COLD;
+
+  if ( Index < 0 || !m_Slots[Index].Status.compare_exchange_strong( Cold, State::QUEUED, std::memory_order_acq_rel ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( m_Prefetcher_Ptr == nullptr )
+  {
+    m_Prefetcher_Ptr = SDL_CreateThread( Prefetcher_Pvt, "LAssetPack", this );
+
+    if ( m_Prefetcher_Ptr == nullptr )
+    {
+      // Read on first use instead
+      printf( "\nUnable to start the prefetch thread! SDL Error: %s", SDL_GetError() );
+      m_Slots[Index].Status.store( State::COLD, std::memory_order_release );
+      return;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  // Each entry is queued at most once, and the queue has room for all of them
+  m_Pending.fetch_add( 1, std::memory_order_relaxed );
+  m_Queue_Ptr->push( static_cast<Uint32>( Index ) );
+}
+
+
+/**
+ * @brief Queues every entry, in the order of the pack.
+ **/
+void LAssetPack::prefetchAll( void )
+{
+  for ( Uint32 i = 0; i != m_NumOfEntries; ++i )
+  {
+    prefetch( std::string( m_Names + m_Entries[i].NameOffset, m_Entries[i].NameLength ) );
+  }
+}
+
+
+bool LAssetPack::IsOpen( void ) const
+{
+  return m_Entries != nullptr;
+}
+
+
+/**
+ * @return true if reading the entry will not have to wait for the disk, nor decompress it.
+ **/
+bool LAssetPack::IsReady( const std::string& Name ) const
+{
+  const int Index = Find_Pvt( Name );
+
+  return Index >= 0 && m_Slots[Index].Status.load( std::memory_order_acquire ) == State::READY;
+}
+
+
+/**
+ * @return Entries queued for prefetching and not read yet, for a loading screen.
+ **/
+size_t LAssetPack::GetPending( void ) const
+{
+  return m_Pending.load( std::memory_order_relaxed );
+}
+
+
+size_t LAssetPack::GetNumOfEntries( void ) const
+{
+  return m_NumOfEntries;
+}
+
+
+/**
+ * @brief Takes the queued entries one at a time, until the queue is closed and empty. An entry
+ * already taken by a reader is skipped.
+ **/
+int SDLCALL LAssetPack::Prefetcher_Pvt( void* Pack_Ptr )
+{
+  LAssetPack& Self = *static_cast<LAssetPack*>( Pack_Ptr );
+  Uint32      Index;
+
+  LTrace::nameThread( "LAssetPack" );
+
+  while ( Self.m_Queue_Ptr->pop( Index ) )
+  {
+    State Queued = State::QUEUED;
+
+    if ( Self.m_Slots[Index].Status.compare_exchange_strong( Queued, State::LOADING, std::memory_order_acq_rel ) )
+    {
+      LTrace::Zone Traced( "Asset prefetch" );
+
+      Self.Load_Pvt( Index );
+      Self.m_Pending.fetch_sub( 1, std::memory_order_relaxed );
+    }
+    else
+    {;}
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Binary search of the sorted table of contents.
+ *
+ * @return The index of the entry; -1 if none has the name.
+ **/
+int LAssetPack::Find_Pvt( const std::string& Path ) const
+{
+  const std::string Name  = NormaliseName( Path );
+  Uint32            Low   = 0;
+  Uint32            High  = m_NumOfEntries;
+
+  while ( Low < High )
+  {
+    const Uint32 Middle = Low + ( High - Low ) / 2;
+    const int    Order  = CompareNames( m_Names + m_Entries[Middle].NameOffset, m_Entries[Middle].NameLength, Name.data(), Name.size() );
+
+    if ( Order == 0 )
+    {
+      return static_cast<int>( Middle );
+    }
+    else if ( Order < 0 )
+    {
+      Low = Middle + 1;
+    }
+    else
+    {
+      High = Middle;
+    }
+  }
+
+  return -1;
+}
+
+
+/**
+ * @brief Makes sure a compressed entry is decompressed: loads it here if nobody has started, waits
+ * for the thread that has.
+ *
+ * @return false if it could not be decompressed.
+ **/
+bool LAssetPack::Acquire_Pvt( Uint32 Index )
+{
+  Slot& Entry  = m_Slots[Index];
+  State Status = Entry.Status.load( std::memory_order_acquire );
+
+  for ( ;; )
+  {
+    if ( Status == State::READY || Status == State::FAILED )
+    {
+      return Status == State::READY;
+    }
+    else if ( Status == State::LOADING )
+    {
+      SDL_LockMutex( m_Lock_Ptr );
+
+      while ( Entry.Status.load( std::memory_order_acquire ) == State::LOADING )
+      {
+        SDL_CondWait( m_Loaded_Ptr, m_Lock_Ptr );
+      }
+
+      SDL_UnlockMutex( m_Lock_Ptr );
+      Status = Entry.Status.load( std::memory_order_acquire );
+    }
+    else if ( Entry.Status.compare_exchange_weak( Status, State::LOADING, std::memory_order_acq_rel ) )
+    {
+      // Cold, or still queued: no need to wait for the prefetch thread to get to it
+      const bool WasQueued = ( Status == State::QUEUED );
+
+      Load_Pvt( Index );
+
+      if ( WasQueued )
+      {
+        m_Pending.fetch_sub( 1, std::memory_order_relaxed );
+      }
+      else
+      {;}
+
+      Status = Entry.Status.load( std::memory_order_acquire );
+    }
+    else
+    {;} // Status now holds what another thread set
+  }
+}
+
+
+/**
+ * @brief Called by whoever moved the entry to LOADING. Decompresses a compressed entry; touches a
+ * page in every PAGE_BYTES of a stored one, so that the OS reads it in now rather than at first use.
+ **/
+void LAssetPack::Load_Pvt( Uint32 Index )
+{
+  const LAssetPackEntry& Entry    = m_Entries[Index];
+  const Uint8*           Data_Ptr = m_File.GetData() + Entry.Offset;
+  Slot&                  Target   = m_Slots[Index];
+  bool                   IsLoaded = true;
+
+  if ( Entry.Compression == LASSET_PACK_STORED )
+  {
+    volatile Uint8 Sink = 0;
+
+    for ( Uint64 Offset = 0; Offset < Entry.StoredSize; Offset += PAGE_BYTES )
+    {
+      Sink = static_cast<Uint8>( Sink ^ Data_Ptr[Offset] );
+    }
+  }
+  else
+  {
+    Target.Data.resize( static_cast<size_t>( Entry.Size ) );
+    IsLoaded = LAssetDecompress( Data_Ptr, static_cast<size_t>( Entry.StoredSize ), Target.Data.data(), Target.Data.size() );
+  }
+
+  Target.Status.store( IsLoaded ? State::READY : State::FAILED, std::memory_order_release );
+
+  SDL_LockMutex( m_Lock_Ptr );
+  SDL_CondBroadcast( m_Loaded_Ptr );
+  SDL_UnlockMutex( m_Lock_Ptr );
+}
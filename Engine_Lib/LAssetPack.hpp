@@ -0,0 +1,153 @@
+/**
+ * @file LAssetPack.hpp
+ *
+ * @brief Asset packs (".lpak"): many files in one, written offline by the PackAssets tool, mapped
+ * once and read through SDL_RWops, with prefetching on a thread of their own.
+ **/
+
+#ifndef LASSETPACK_HPP
+#define LASSETPACK_HPP
+
+#include "LMappedFile.hpp"
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A pack is this header, the data of the entries, and the table of contents: an
+ * LAssetPackEntry per entry, sorted by name, followed by the names one after the other.
+ *
+ * Entries stored as they are start at a multiple of Alignment (a page, by default), so that a
+ * mapped ".ltx" or map inside the pack is as aligned as a file of its own; compressed ones only at
+ * a multiple of 16.
+ *
+ * Fields are stored in the byte order of the machine that packed the file, as in the baked
+ * textures: a pack written on a machine of the other order is rejected by its magic.
+ **/
+struct LAssetPackHeader
+{
+  char   Magic[4];      // LASSET_PACK_MAGIC
+  Uint32 Version;       // LASSET_PACK_VERSION
+  Uint32 NumOfEntries;
+  Uint32 Alignment;     // Of the stored entries
+  Uint64 TocOffset;
+  Uint64 TocSize;       // Entries and names
+};
+
+struct LAssetPackEntry
+{
+  Uint64 Offset;        // Of the data, from the start of the pack
+  Uint64 StoredSize;    // In the pack
+  Uint64 Size;          // Once decompressed
+  Uint32 NameOffset;    // From the end of the entries
+  Uint32 NameLength;
+  Uint32 Compression;   // LASSET_PACK_STORED or LASSET_PACK_LZ
+  Uint32 Reserved;
+};
+
+static constexpr char   LASSET_PACK_MAGIC[4]     = { 'L', 'P', 'A', 'K' };
+static constexpr Uint32 LASSET_PACK_VERSION      = 1;
+static constexpr Uint32 LASSET_PACK_STORED       = 0;
+static constexpr Uint32 LASSET_PACK_LZ           = 1;
+static constexpr Uint32 LASSET_PACK_ALIGNMENT    = 4096;
+static constexpr char   LASSET_PACK_EXTENSION[]  = ".lpak";
+
+static_assert( sizeof(LAssetPackHeader) == 32, "The pack header must have no padding" );
+static_assert( sizeof(LAssetPackEntry)  == 40, "The pack entries must have no padding" );
+
+// Byte-oriented LZ77 of the compressed entries, used by PackAssets and by LAssetPack
+void LAssetCompress  ( const Uint8*, size_t, std::vector<Uint8>& );
+bool LAssetDecompress( const Uint8*, size_t, Uint8*, size_t );
+
+
+/**
+ * @brief An open pack. The whole file is mapped by "open": a single open of a single file, however
+ * many assets are read from it, which is what counts on a network drive.
+ *
+ * "openRW" returns an SDL_RWops over an entry, to hand to IMG_Load_RW, TTF_OpenFontRW,
+ * SDL_LoadWAV_RW and the like. A stored entry is read straight from the mapping; a compressed one is
+ * decompressed once, on first use or by the prefetch thread, and kept until "close".
+ *
+ * "prefetch" queues entries for the prefetch thread, which decompresses them or touches their pages
+ * while the program does something else; an entry asked for while the thread is on it is waited
+ * for, one still queued is read on the spot.
+ *
+ * open, close and prefetch are called from one thread; openRW, view and IsReady from any. The
+ * SDL_RWops and views must not outlive the pack.
+ *
+ * "SetDefault" makes a pack the one LOpenAsset, LTexture and LAudioMixer look into first.
+ **/
+class LAssetPack
+{
+public:
+
+  LAssetPack( void );
+  ~LAssetPack( void );
+
+  LAssetPack( const LAssetPack& )            = delete;
+  LAssetPack& operator=( const LAssetPack& ) = delete;
+
+  static void        SetDefault   ( LAssetPack* );
+  static LAssetPack* GetDefault   ( void );
+  static std::string NormaliseName( const std::string& );
+
+  bool        open           ( const std::string& );
+  void        close          ( void );
+
+  bool        contains       ( const std::string& ) const;
+  SDL_RWops*  openRW         ( const std::string& );
+  bool        view           ( const std::string&, const Uint8*&, size_t& );
+
+  void        prefetch       ( const std::string& );
+  void        prefetchAll    ( void );
+
+  bool        IsOpen         ( void ) const;
+  bool        IsReady        ( const std::string& ) const;
+  size_t      GetPending     ( void ) const;
+  size_t      GetNumOfEntries( void ) const;
+
+private:
+
+  enum class State : Uint8
+  {
+    COLD,
+    QUEUED,
+    LOADING,
+    READY,
+    FAILED
+  };
+
+  struct Slot
+  {
+    std::atomic<State> Status;
+    std::vector<Uint8> Data;      // Decompressed; written once, by whoever moved Status to LOADING
+  };
+
+  typedef LBlockingRing< LSpscRing<Uint32> > Queue;
+
+  static int SDLCALL Prefetcher_Pvt( void* );
+
+  int  Find_Pvt   ( const std::string& ) const;
+  bool Acquire_Pvt( Uint32 );
+  void Load_Pvt   ( Uint32 );
+
+  LMappedFile                   m_File;
+  const LAssetPackEntry*        m_Entries;     // In the mapping
+  const char*                   m_Names;       // In the mapping
+  Uint32                        m_NumOfEntries;
+  std::unique_ptr<Slot[]>       m_Slots;
+  std::unique_ptr<Queue>        m_Queue_Ptr;   // This thread to the prefetcher
+  SDL_Thread*                   m_Prefetcher_Ptr;
+  SDL_mutex*                    m_Lock_Ptr;    // Only to sleep on m_Loaded_Ptr
+  SDL_cond*                     m_Loaded_Ptr;  // Broadcast whenever an entry leaves LOADING
+  std::atomic<size_t>           m_Pending;     // Queued and not loaded yet
+};
+
+
+SDL_RWops* LOpenAsset( const std::string& );
+
+#endif // LASSETPACK_HPP
@@ -0,0 +1,401 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAsyncText.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static bool IsSameColour( SDL_Color First, SDL_Color Second )
+{
+  return First.r == Second.r && First.g == Second.g && First.b == Second.b && First.a == Second.a;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LTextRasteriser::LTextRasteriser( void )
+  : m_Jobs_Ptr(nullptr), m_Fonts(), m_FreeFonts(), m_Results(s_MAX_PENDING), m_Running(), m_Pending(0), m_Targets(),
+    m_NextTarget(1)
+{;}
+
+
+LTextRasteriser::~LTextRasteriser( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Opens the font for every thread of the job system that may rasterise.
+ *
+ * @param Jobs      Job system already initialised; it must outlive "close".
+ * @param Path      Font file, as for TTF_OpenFont.
+ * @param PointSize Size of the font.
+ * @return false if the font could not be opened.
+ **/
+bool LTextRasteriser::open( LJobSystem& Jobs, const char* Path, int PointSize )
+{
+  close();
+
+  const size_t NumOfFonts = static_cast<size_t>( Jobs.GetWorkerCount() ) + 1;
+
+  for ( size_t i = 0; i != NumOfFonts; ++i )
+  {
+    TTF_Font* Font_Ptr = TTF_OpenFont( Path, PointSize );
+
+    if ( Font_Ptr == nullptr )
+    {
+      printf( "\nText rasteriser: unable to open %s! SDL_ttf Error: %s", Path, TTF_GetError() );
+      close();
+      return false;
+    }
+    else
+    {;}
+
+    m_Fonts.push_back( Font_Ptr );
+  }
+
+  m_FreeFonts.reset( new LMpmcRing<TTF_Font*>( NumOfFonts ) );
+  m_FreeFonts->pushBatch( m_Fonts.data(), m_Fonts.size() );
+
+  m_Jobs_Ptr = &Jobs;
+
+  return true;
+}
+
+
+/**
+ * @brief Waits for the jobs still running, drops their surfaces and closes the fonts. The
+ * LAsyncText objects keep their textures.
+ **/
+void LTextRasteriser::close( void )
+{
+  if ( m_Jobs_Ptr != nullptr )
+  {
+    m_Jobs_Ptr->wait( m_Running );
+  }
+  else
+  {;}
+
+  Result Done;
+
+  while ( m_Results.pop( Done ) )
+  {
+    SDL_FreeSurface( Done.Surface_Ptr );
+  }
+
+  for ( const auto& Target : m_Targets )
+  {
+    Target.second->Detach_Pvt();
+  }
+
+  for ( TTF_Font* Open_Ptr : m_Fonts )
+  {
+    TTF_CloseFont( Open_Ptr );
+  }
+
+  m_Fonts.clear();
+  m_FreeFonts.reset();
+  m_Targets.clear();
+  m_Pending  = 0;
+  m_Jobs_Ptr = nullptr;
+}
+
+
+/**
+ * @brief Uploads the strings rasterised since the last call, up to s_MAX_UPLOADS. Once per frame,
+ * before the texts are set and drawn.
+ **/
+void LTextRasteriser::update( SDL_Renderer* Renderer_Ptr )
+{
+  Result Done;
+
+  for ( int Uploads = 0; Uploads != s_MAX_UPLOADS && m_Results.pop( Done ); ++Uploads )
+  {
+    --m_Pending;
+
+    const auto   Target      = m_Targets.find( Done.Target );
+    SDL_Texture* Texture_Ptr = nullptr;
+
+    // A text freed meanwhile finds nothing
+    if ( Target != m_Targets.end() && Done.Surface_Ptr != nullptr )
+    {
+      Texture_Ptr = SDL_CreateTextureFromSurface( Renderer_Ptr, Done.Surface_Ptr );
+
+      if ( Texture_Ptr == nullptr )
+      {
+        printf( "\nText rasteriser: unable to create a texture! SDL Error: %s", SDL_GetError() );
+      }
+      else
+      {;}
+    }
+    else
+    {;}
+
+    if ( Target != m_Targets.end() )
+    {
+      Target->second->Receive_Pvt( Texture_Ptr, ( Done.Surface_Ptr != nullptr ) ? Done.Surface_Ptr->w : 0,
+                                   ( Done.Surface_Ptr != nullptr ) ? Done.Surface_Ptr->h : 0 );
+    }
+    else
+    {;}
+
+    SDL_FreeSurface( Done.Surface_Ptr );
+  }
+}
+
+
+bool LTextRasteriser::IsOpen( void ) const
+{
+  return m_Jobs_Ptr != nullptr;
+}
+
+
+/**
+ * @return Strings being rasterised or waiting for "update".
+ **/
+size_t LTextRasteriser::GetPending( void ) const
+{
+  return m_Pending;
+}
+
+
+/**
+ * @brief The job: rasterises a string with a font of the pool and queues the surface.
+ **/
+void LTextRasteriser::Rasterise_Pvt( void* Data_Ptr )
+{
+  Job*             Job_Ptr = static_cast<Job*>( Data_Ptr );
+  LTextRasteriser& Owner   = *Job_Ptr->Owner_Ptr;
+  TTF_Font*        Font_Ptr = nullptr;
+
+  // There is a font for every thread that can run a job
+  while ( !Owner.m_FreeFonts->pop( Font_Ptr ) )
+  {
+    SDL_Delay( 0 );
+  }
+
+  SDL_Surface* Surface_Ptr = Job_Ptr->IsBlended ? TTF_RenderUTF8_Blended( Font_Ptr, Job_Ptr->Text.c_str(), Job_Ptr->Colour )
+                                                : TTF_RenderUTF8_Solid  ( Font_Ptr, Job_Ptr->Text.c_str(), Job_Ptr->Colour );
+
+  Owner.m_FreeFonts->push( Font_Ptr );
+
+  // Never full: no more than s_MAX_PENDING jobs are submitted before their results are popped
+  Owner.m_Results.push( Result{ Job_Ptr->Target, Surface_Ptr } );
+
+  delete Job_Ptr;
+}
+
+
+Uint32 LTextRasteriser::Register_Pvt( LAsyncText* Text_Ptr )
+{
+  const Uint32 Id = m_NextTarget++;
+
+  m_Targets.emplace( Id, Text_Ptr );
+
+  return Id;
+}
+
+
+void LTextRasteriser::Unregister_Pvt( Uint32 Id )
+{
+  m_Targets.erase( Id );
+}
+
+
+/**
+ * @return false, and nothing submitted, if the rasteriser is closed or full.
+ **/
+bool LTextRasteriser::Submit_Pvt( Uint32 Target, const std::string& Text, SDL_Color Colour, bool IsBlended )
+{
+  if ( m_Jobs_Ptr == nullptr || m_Pending == s_MAX_PENDING )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  ++m_Pending;
+  m_Jobs_Ptr->run( Rasterise_Pvt, new Job{ this, Target, Text, Colour, IsBlended }, &m_Running );
+
+  return true;
+}
+
+
+LAsyncText::LAsyncText( void )
+  : m_Rasteriser_Ptr(nullptr), m_Id(0), m_Texture_Ptr(nullptr), m_Width(0), m_Height(0), m_Text(), m_Colour{ 0, 0, 0, 0 },
+    m_IsBlended(false), m_IsDirty(false), m_IsInFlight(false)
+{;}
+
+
+LAsyncText::~LAsyncText( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Asks for a string, unless it is the one already asked for.
+ *
+ * @param IsBlended Antialiased (TTF_RenderUTF8_Blended) rather than TTF_RenderUTF8_Solid.
+ **/
+void LAsyncText::setText( LTextRasteriser& Rasteriser, const std::string& Text, SDL_Color Colour, bool IsBlended )
+{
+  if ( m_Rasteriser_Ptr != &Rasteriser )
+  {
+    Detach_Pvt();
+
+    m_Rasteriser_Ptr = &Rasteriser;
+    m_Id             = Rasteriser.Register_Pvt( this );
+    m_IsDirty        = true;
+  }
+  else
+  {;}
+
+  if ( Text != m_Text || !IsSameColour( Colour, m_Colour ) || IsBlended != m_IsBlended )
+  {
+    m_Text      = Text;
+    m_Colour    = Colour;
+    m_IsBlended = IsBlended;
+    m_IsDirty   = true;
+  }
+  else
+  {;}
+
+  if ( m_IsDirty && !m_IsInFlight )
+  {
+    Submit_Pvt();
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Draws the last string received, if any, with its top left corner at ( x, y ).
+ **/
+void LAsyncText::render( SDL_Renderer* Renderer_Ptr, int x, int y ) const
+{
+  if ( m_Texture_Ptr != nullptr )
+  {
+    const SDL_Rect Quad = { x, y, m_Width, m_Height };
+
+    SDL_RenderCopy( Renderer_Ptr, m_Texture_Ptr, nullptr, &Quad );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Destroys the texture, and forgets the string being rasterised.
+ **/
+void LAsyncText::free( void )
+{
+  Detach_Pvt();
+
+  if ( m_Texture_Ptr != nullptr )
+  {
+    SDL_DestroyTexture( m_Texture_Ptr );
+    m_Texture_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Width  = 0;
+  m_Height = 0;
+  m_Text.clear();
+}
+
+
+/**
+ * @return Whether a string set is not shown yet.
+ **/
+bool LAsyncText::IsPending( void ) const
+{
+  return m_IsDirty || m_IsInFlight;
+}
+
+
+int LAsyncText::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LAsyncText::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+void LAsyncText::Submit_Pvt( void )
+{
+  if ( m_Rasteriser_Ptr->Submit_Pvt( m_Id, m_Text, m_Colour, m_IsBlended ) )
+  {
+    m_IsDirty    = false;
+    m_IsInFlight = true;
+  }
+  else
+  {;} // Full or closed: the next setText tries again
+}
+
+
+/**
+ * @brief Takes the texture of the string submitted last, and submits the one set meanwhile, if any.
+ *
+ * @param Texture_Ptr nullptr if it could not be made: the previous texture stays.
+ **/
+void LAsyncText::Receive_Pvt( SDL_Texture* Texture_Ptr, int Width, int Height )
+{
+  m_IsInFlight = false;
+
+  if ( Texture_Ptr != nullptr )
+  {
+    if ( m_Texture_Ptr != nullptr )
+    {
+      SDL_DestroyTexture( m_Texture_Ptr );
+    }
+    else
+    {;}
+
+    m_Texture_Ptr = Texture_Ptr;
+    m_Width       = Width;
+    m_Height      = Height;
+  }
+  else
+  {;}
+
+  if ( m_IsDirty )
+  {
+    Submit_Pvt();
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Leaves the rasteriser: a job still running for it is dropped when it is done.
+ **/
+void LAsyncText::Detach_Pvt( void )
+{
+  if ( m_Rasteriser_Ptr != nullptr )
+  {
+    m_Rasteriser_Ptr->Unregister_Pvt( m_Id );
+  }
+  else
+  {;}
+
+  m_Rasteriser_Ptr = nullptr;
+  m_Id             = 0;
+  m_IsInFlight     = false;
+}
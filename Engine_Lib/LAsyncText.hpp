@@ -0,0 +1,145 @@
+/**
+ * @file LAsyncText.hpp
+ *
+ * @brief Text rasterised with SDL_ttf on the workers of an LJobSystem and uploaded on the main
+ * thread a frame later: a long string, or one that changes every frame, no longer stalls the frame
+ * that sets it.
+ **/
+
+#ifndef LASYNCTEXT_HPP
+#define LASYNCTEXT_HPP
+
+#include "LJobSystem.hpp"
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class LAsyncText;
+
+
+/**
+ * @brief Rasterises the strings of its LAsyncText objects with one font, at one size, on the
+ * workers of a job system. SDL_ttf fonts cannot be shared between threads: "open" opens the font
+ * once per worker, plus one for the thread waiting on the jobs, which also runs them, and every job
+ * takes a handle of its own from a lock-free pool for as long as it rasterises.
+ *
+ * The surfaces come back through a lock-free queue; "update", called once per frame on the main
+ * thread, turns at most s_MAX_UPLOADS of them into textures and hands them to their LAsyncText. At
+ * most s_MAX_PENDING strings are rasterised or waiting to be uploaded at the same time.
+ *
+ * "open", "close" and "update" are called from the main thread, which owns the renderer; "close"
+ * waits for the jobs still running, and comes before TTF_Quit and before the job system shuts down.
+ **/
+class LTextRasteriser
+{
+public:
+
+  static constexpr size_t s_MAX_PENDING = 64;
+  static constexpr int    s_MAX_UPLOADS = 8;   // Textures created per update
+
+  LTextRasteriser( void );
+  ~LTextRasteriser( void );
+
+  LTextRasteriser( const LTextRasteriser& )            = delete;
+  LTextRasteriser& operator=( const LTextRasteriser& ) = delete;
+
+  bool   open      ( LJobSystem&, const char*, int );
+  void   close     ( void );
+  void   update    ( SDL_Renderer* );
+
+  bool   IsOpen    ( void ) const;
+  size_t GetPending( void ) const;
+
+private:
+
+  friend class LAsyncText;
+
+  /**
+   * @brief A string to rasterise, owned by the job that does it.
+   **/
+  struct Job
+  {
+    LTextRasteriser* Owner_Ptr;
+    Uint32           Target;      // Id of the LAsyncText
+    std::string      Text;        // UTF-8
+    SDL_Color        Colour;
+    bool             IsBlended;
+  };
+
+  struct Result
+  {
+    Uint32       Target;
+    SDL_Surface* Surface_Ptr;     // nullptr if SDL_ttf failed
+  };
+
+  static void Rasterise_Pvt( void* );
+
+  Uint32 Register_Pvt  ( LAsyncText* );
+  void   Unregister_Pvt( Uint32 );
+  bool   Submit_Pvt    ( Uint32, const std::string&, SDL_Color, bool );
+
+  LJobSystem*                               m_Jobs_Ptr;
+  std::vector<TTF_Font*>                    m_Fonts;       // One per thread that may run a job
+  std::unique_ptr<LMpmcRing<TTF_Font*>>     m_FreeFonts;   // Sized by "open"
+  LMpmcRing<Result>                         m_Results;     // Workers to main thread
+  LJobCounter                               m_Running;
+  size_t                                    m_Pending;     // Submitted and not uploaded yet
+  std::unordered_map<Uint32, LAsyncText*>   m_Targets;     // Main thread only
+  Uint32                                    m_NextTarget;
+};
+
+
+/**
+ * @brief A string drawn from a texture that an LTextRasteriser makes in the background. "setText"
+ * asks for the new string and returns at once: "render" keeps drawing the previous one until the
+ * new texture arrives, nothing before the first. One string at a time is rasterised for it: a text
+ * set again and again while a job runs, such as a timer, is rasterised again with the latest
+ * string only when the job is done. A request the rasteriser refuses, being full, is made again by
+ * the next "setText".
+ *
+ * Everything is called from the main thread.
+ **/
+class LAsyncText
+{
+public:
+
+  LAsyncText( void );
+  ~LAsyncText( void );
+
+  LAsyncText( const LAsyncText& )            = delete;
+  LAsyncText& operator=( const LAsyncText& ) = delete;
+
+  void setText   ( LTextRasteriser&, const std::string&, SDL_Color, bool = false );
+  void render    ( SDL_Renderer*, int, int ) const;
+  void free      ( void );
+
+  bool IsPending ( void ) const;
+  int  GetWidth  ( void ) const;
+  int  GetHeight ( void ) const;
+
+private:
+
+  friend class LTextRasteriser;
+
+  void Submit_Pvt ( void );
+  void Receive_Pvt( SDL_Texture*, int, int );
+  void Detach_Pvt ( void );
+
+  LTextRasteriser* m_Rasteriser_Ptr;
+  Uint32           m_Id;             // In m_Rasteriser_Ptr
+  SDL_Texture*     m_Texture_Ptr;    // Of the last string received
+  int              m_Width;
+  int              m_Height;
+  std::string      m_Text;           // Last string set
+  SDL_Color        m_Colour;
+  bool             m_IsBlended;
+  bool             m_IsDirty;        // m_Text not submitted yet
+  bool             m_IsInFlight;     // A job of this text is running or waiting for the upload
+};
+
+#endif // LASYNCTEXT_HPP
@@ -0,0 +1,321 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAudioAnalyser.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr double TWO_PI       = 6.283185307179586;
+static constexpr size_t FEED_BATCH   = 256;    // Frames converted on the stack, then pushed at once
+static constexpr size_t POP_BATCH    = 1024;   // Frames popped at once by the worker
+static constexpr size_t HISTORY_MASK = LAudioAnalyser::s_HISTORY_FRAMES - 1;
+
+static_assert( ( LAudioAnalyser::s_FFT_SIZE & ( LAudioAnalyser::s_FFT_SIZE - 1 ) ) == 0, "The FFT size must be a power of two" );
+static_assert( ( LAudioAnalyser::s_HISTORY_FRAMES & HISTORY_MASK ) == 0, "The history must be a power of two" );
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LAudioAnalyser::LAudioAnalyser( void )
+  : m_Ring(s_HISTORY_FRAMES), m_History(s_HISTORY_FRAMES), m_Window(s_FFT_SIZE), m_Cos(s_FFT_SIZE / 2),
+    m_Sin(s_FFT_SIZE / 2), m_BitReverse(s_FFT_SIZE), m_Real(s_FFT_SIZE), m_Imag(s_FFT_SIZE), m_BandEdges(),
+    m_Results(), m_Worker_Ptr(nullptr), m_Frames(0), m_LastEnd(0), m_IsStopping(false), m_Lag(0), m_Dropped(0)
+{
+  size_t Bits = 0;
+
+  while ( ( static_cast<size_t>( 1 ) << Bits ) != s_FFT_SIZE )
+  {
+    ++Bits;
+  }
+
+  for ( size_t i = 0; i != s_FFT_SIZE; ++i )
+  {
+    size_t Reversed = 0;
+
+    for ( size_t Bit = 0; Bit != Bits; ++Bit )
+    {
+      Reversed |= ( ( i >> Bit ) & 1 ) << ( Bits - 1 - Bit );
+    }
+
+    m_BitReverse[i] = Reversed;
+    m_Window[i]     = static_cast<float>( 0.5 - 0.5 * std::cos( TWO_PI * static_cast<double>( i ) / s_FFT_SIZE ) );
+  }
+
+  for ( size_t k = 0; k != s_FFT_SIZE / 2; ++k )
+  {
+    m_Cos[k] = static_cast<float>( std::cos( TWO_PI * static_cast<double>( k ) / s_FFT_SIZE ) );
+    m_Sin[k] = static_cast<float>( std::sin( TWO_PI * static_cast<double>( k ) / s_FFT_SIZE ) );
+  }
+
+  // Logarithmic from the first bin above DC to Nyquist, with at least one bin per band
+  const double Bins = static_cast<double>( s_FFT_SIZE / 2 );
+
+  m_BandEdges[0] = 1;
+
+  for ( size_t b = 1; b <= s_NUM_OF_BANDS; ++b )
+  {
+    const size_t Edge = static_cast<size_t>( std::pow( Bins, static_cast<double>( b ) / s_NUM_OF_BANDS ) + 0.5 );
+
+    m_BandEdges[b] = std::min( std::max( Edge, m_BandEdges[b - 1] + 1 ), s_FFT_SIZE / 2 );
+  }
+}
+
+
+LAudioAnalyser::~LAudioAnalyser( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Starts the worker thread.
+ *
+ * @return true if running.
+ **/
+bool LAudioAnalyser::start( void )
+{
+  if ( m_Worker_Ptr != nullptr )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_Worker_Ptr = SDL_CreateThread( Worker_Pvt, "LAudioAnalyser", this );
+
+  if ( m_Worker_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the analyser thread! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+void LAudioAnalyser::stop( void )
+{
+  if ( m_Worker_Ptr != nullptr )
+  {
+    m_IsStopping.store( true, std::memory_order_relaxed );
+    SDL_WaitThread( m_Worker_Ptr, nullptr );
+    m_Worker_Ptr = nullptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Feeding thread only, one at a time. Queues interleaved float samples for the worker: the
+ * first two channels are kept, a single one counts as both. Never waits; if the ring has no room for
+ * all the frames, none are queued.
+ **/
+void LAudioAnalyser::feed( const float* Samples_Ptr, size_t Frames, int Channels )
+{
+  if ( Frames > m_Ring.GetCapacity() - m_Ring.GetSize() )
+  {
+    m_Dropped.fetch_add( Frames, std::memory_order_relaxed );
+    return;
+  }
+  else
+  {;}
+
+  const size_t Stride = static_cast<size_t>( Channels );
+  const size_t Right  = ( Channels > 1 ) ? 1 : 0;
+  Frame        Batch[FEED_BATCH];
+
+  for ( size_t Done = 0; Done != Frames; )
+  {
+    const size_t Count = std::min( FEED_BATCH, Frames - Done );
+
+    for ( size_t i = 0; i != Count; ++i )
+    {
+      const float* Frame_Ptr = Samples_Ptr + ( Done + i ) * Stride;
+
+      Batch[i] = Frame{ Frame_Ptr[0], Frame_Ptr[Right] };
+    }
+
+    m_Ring.pushBatch( Batch, Count );
+    Done += Count;
+  }
+}
+
+
+/**
+ * @brief Any thread. Frames fed but not heard yet: the window analysed ends that many frames before
+ * the last one fed, up to s_HISTORY_FRAMES - s_FFT_SIZE.
+ **/
+void LAudioAnalyser::setLag( size_t Frames )
+{
+  m_Lag.store( Frames, std::memory_order_relaxed );
+}
+
+
+bool LAudioAnalyser::IsRunning( void ) const
+{
+  return m_Worker_Ptr != nullptr;
+}
+
+
+/**
+ * @brief Drawing thread only: the latest analysis published. It stays the same while nothing new
+ * is fed.
+ **/
+const LAudioAnalyser::Analysis& LAudioAnalyser::GetLatest( void )
+{
+  m_Results.acquire();
+
+  return m_Results.GetFront();
+}
+
+
+Uint64 LAudioAnalyser::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Moves what was fed into the history, and analyses the window the lag points at if it has
+ * moved since the last time.
+ **/
+int SDLCALL LAudioAnalyser::Worker_Pvt( void* Analyser_Ptr )
+{
+  LAudioAnalyser& Self = *static_cast<LAudioAnalyser*>( Analyser_Ptr );
+  Frame           Batch[POP_BATCH];
+
+  LTrace::nameThread( "LAudioAnalyser" );
+
+  while ( !Self.m_IsStopping.load( std::memory_order_relaxed ) )
+  {
+    size_t Count;
+
+    while ( ( Count = Self.m_Ring.popBatch( Batch, POP_BATCH ) ) != 0 )
+    {
+      for ( size_t i = 0; i != Count; ++i )
+      {
+        Self.m_History[ ( Self.m_Frames + i ) & HISTORY_MASK ] = Batch[i];
+      }
+
+      Self.m_Frames += Count;
+    }
+
+    const Uint64 Lag = std::min<Uint64>( Self.m_Lag.load( std::memory_order_relaxed ), s_HISTORY_FRAMES - s_FFT_SIZE );
+    const Uint64 End = ( Self.m_Frames > Lag ) ? Self.m_Frames - Lag : 0;
+
+    if ( End >= s_FFT_SIZE && End != Self.m_LastEnd )
+    {
+      LTrace::Zone Traced( "Audio analysis" );
+
+      Self.Analyse_Pvt( End );
+      Self.m_LastEnd = End;
+    }
+    else
+    {;}
+
+    SDL_Delay( s_PERIOD_MS );
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Measures the s_FFT_SIZE frames before End, and publishes the result.
+ **/
+void LAudioAnalyser::Analyse_Pvt( Uint64 End )
+{
+  Analysis& Result = m_Results.GetBack();
+  float     SumL   = 0.f;
+  float     SumR   = 0.f;
+  float     PeakL  = 0.f;
+  float     PeakR  = 0.f;
+
+  for ( size_t i = 0; i != s_FFT_SIZE; ++i )
+  {
+    const Frame& Each = m_History[ ( End - s_FFT_SIZE + i ) & HISTORY_MASK ];
+
+    SumL  += Each.L * Each.L;
+    SumR  += Each.R * Each.R;
+    PeakL  = std::max( PeakL, std::fabs( Each.L ) );
+    PeakR  = std::max( PeakR, std::fabs( Each.R ) );
+
+    // Stored in bit reversed order, as the transform wants it
+    m_Real[ m_BitReverse[i] ] = 0.5f * ( Each.L + Each.R ) * m_Window[i];
+    m_Imag[ m_BitReverse[i] ] = 0.f;
+  }
+
+  Result.Rms[0]  = std::min( std::sqrt( SumL / s_FFT_SIZE ), 1.f );
+  Result.Rms[1]  = std::min( std::sqrt( SumR / s_FFT_SIZE ), 1.f );
+  Result.Peak[0] = std::min( PeakL, 1.f );
+  Result.Peak[1] = std::min( PeakR, 1.f );
+
+  Transform_Pvt();
+
+  // A full scale sine through the Hann window peaks at a quarter of the size
+  const float Scale = 4.f / s_FFT_SIZE;
+
+  for ( size_t b = 0; b != s_NUM_OF_BANDS; ++b )
+  {
+    float Power = 0.f;
+
+    for ( size_t Bin = m_BandEdges[b]; Bin < m_BandEdges[b + 1]; ++Bin )
+    {
+      Power = std::max( Power, m_Real[Bin] * m_Real[Bin] + m_Imag[Bin] * m_Imag[Bin] );
+    }
+
+    const float Decibels = 20.f * std::log10( std::max( std::sqrt( Power ) * Scale, 1e-9f ) );
+
+    Result.Bands[b] = std::min( std::max( ( Decibels - s_FLOOR_DB ) / -s_FLOOR_DB, 0.f ), 1.f );
+  }
+
+  Result.Frame = End;
+  m_Results.publish();
+}
+
+
+/**
+ * @brief Forward FFT of m_Real and m_Imag, in place, radix 2; the input is in bit reversed order.
+ **/
+void LAudioAnalyser::Transform_Pvt( void )
+{
+  for ( size_t Size = 2; Size <= s_FFT_SIZE; Size <<= 1 )
+  {
+    const size_t Half = Size / 2;
+    const size_t Step = s_FFT_SIZE / Size;
+
+    for ( size_t Start = 0; Start != s_FFT_SIZE; Start += Size )
+    {
+      for ( size_t k = 0; k != Half; ++k )
+      {
+        // e^(-i 2 pi k / Size)
+        const float  Wr   = m_Cos[k * Step];
+        const float  Wi   = -m_Sin[k * Step];
+        const size_t Top  = Start + k;
+        const size_t Down = Top + Half;
+        const float  Tr   = Wr * m_Real[Down] - Wi * m_Imag[Down];
+        const float  Ti   = Wr * m_Imag[Down] + Wi * m_Real[Down];
+
+        m_Real[Down]  = m_Real[Top] - Tr;
+        m_Imag[Down]  = m_Imag[Top] - Ti;
+        m_Real[Top]  += Tr;
+        m_Imag[Top]  += Ti;
+      }
+    }
+  }
+}
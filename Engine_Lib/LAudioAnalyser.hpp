@@ -0,0 +1,95 @@
+/**
+ * @file LAudioAnalyser.hpp
+ *
+ * @brief Level meters and spectrum of a stream of audio, computed on a thread of their own.
+ **/
+
+#ifndef LAUDIOANALYSER_HPP
+#define LAUDIOANALYSER_HPP
+
+#include "LRingBuffer.hpp"
+#include "LTripleBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * @brief Measures the RMS and peak level of the left and right channel, and the spectrum of their
+ * mix in s_NUM_OF_BANDS logarithmic bands, over the last s_FFT_SIZE frames, every s_PERIOD_MS.
+ *
+ * The samples are fed by the thread that already moves them, never by the audio callback: the
+ * writer of LAudioRecorder, the reader of LAudioPlayer. A worker thread copies them from a
+ * lock-free ring into a history, analyses it and publishes the result through a triple buffer, so
+ * that neither the feeding thread nor the one drawing ever waits. A feed that finds the ring full
+ * is dropped and counted.
+ *
+ * A player feeds samples ahead of what is heard: "setLag" says by how many frames, and the window
+ * analysed ends that far back in the history.
+ **/
+class LAudioAnalyser
+{
+public:
+
+  static constexpr size_t s_FFT_SIZE       = 1024;         // Frames analysed; a power of two
+  static constexpr size_t s_NUM_OF_BANDS   = 32;
+  static constexpr size_t s_HISTORY_FRAMES = 128 * 1024;   // Longest lag, plus a window
+  static constexpr Uint32 s_PERIOD_MS      = 15;           // About once per frame at 60 Hz
+  static constexpr float  s_FLOOR_DB       = -60.f;        // Level shown as an empty band
+
+  struct Analysis
+  {
+    float  Rms  [2]                = {};   // Left and right, 0 to 1
+    float  Peak [2]                = {};   // Left and right, 0 to 1
+    float  Bands[s_NUM_OF_BANDS]   = {};   // From s_FLOOR_DB (0) to full scale (1), lowest first
+    Uint64 Frame                   = 0;    // Frames fed before the end of the window
+  };
+
+  LAudioAnalyser( void );
+  ~LAudioAnalyser( void );
+
+  LAudioAnalyser( const LAudioAnalyser& )            = delete;
+  LAudioAnalyser& operator=( const LAudioAnalyser& ) = delete;
+
+  bool            start     ( void );
+  void            stop      ( void );
+
+  void            feed      ( const float*, size_t, int );
+  void            setLag    ( size_t );
+
+  bool            IsRunning ( void ) const;
+  const Analysis& GetLatest ( void );
+  Uint64          GetDropped( void ) const;
+
+private:
+
+  struct Frame
+  {
+    float L;
+    float R;
+  };
+
+  static int SDLCALL Worker_Pvt( void* );
+
+  void Analyse_Pvt  ( Uint64 );
+  void Transform_Pvt( void );
+
+  LSpscRing<Frame>        m_Ring;                          // Feeding thread to worker
+  std::vector<Frame>      m_History;                       // Worker only, indexed by frame number
+  std::vector<float>      m_Window;                        // Hann
+  std::vector<float>      m_Cos;                           // Twiddle factors, half a turn
+  std::vector<float>      m_Sin;
+  std::vector<size_t>     m_BitReverse;
+  std::vector<float>      m_Real;                          // Worker only
+  std::vector<float>      m_Imag;
+  size_t                  m_BandEdges[s_NUM_OF_BANDS + 1]; // First bin of each band, and the end
+  LTripleBuffer<Analysis> m_Results;
+  SDL_Thread*             m_Worker_Ptr;
+  Uint64                  m_Frames;                        // Copied into the history; worker only
+  Uint64                  m_LastEnd;                       // Of the last window analysed; worker only
+  std::atomic<bool>       m_IsStopping;
+  std::atomic<size_t>     m_Lag;
+  std::atomic<Uint64>     m_Dropped;                       // Frames that found the ring full
+};
+
+#endif // LAUDIOANALYSER_HPP
@@ -0,0 +1,831 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAudioMixer.hpp"
+#include "LAssetPack.hpp"
+#include "LMusicStream.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LAUDIOMIXER_USE_SSE2
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr int    NUM_OF_CHANNELS = 2;            // Stereo, interleaved
+static constexpr size_t COMMAND_BATCH   = 32;           // Commands taken from the queue at once
+static constexpr float  QUARTER_TURN    = 1.5707963f;   // Pi / 2
+static constexpr float  KEEP_BONUS      = 1.25f;        // A real voice stays real unless beaten by this much
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Adds Count stereo frames of a sound to the mix, with gains moving by a step per frame.
+ *
+ * @param GainL, GainR The gains of the first frame; set to those of the frame after the last.
+ **/
+static void MixRamped( float* Out_Ptr, const float* Source_Ptr, size_t Count, float& GainL, float& GainR,
+                       float StepL, float StepR )
+{
+  size_t i = 0;
+
+#if defined(LAUDIOMIXER_USE_SSE2)
+  // Two frames per register: L0 R0 L1 R1
+  __m128       Gain = _mm_set_ps( GainR + StepR, GainL + StepL, GainR, GainL );
+  const __m128 Step = _mm_set_ps( 2.f * StepR, 2.f * StepL, 2.f * StepR, 2.f * StepL );
+
+  for ( ; i + 2 <= Count; i += 2 )
+  {
+    const __m128 Samples = _mm_loadu_ps( Source_Ptr + 2 * i );
+    const __m128 Mixed   = _mm_loadu_ps( Out_Ptr + 2 * i );
+
+    _mm_storeu_ps( Out_Ptr + 2 * i, _mm_add_ps( Mixed, _mm_mul_ps( Samples, Gain ) ) );
+    Gain = _mm_add_ps( Gain, Step );
+  }
+
+  float Lanes[4];
+
+  _mm_storeu_ps( Lanes, Gain );
+  GainL = Lanes[0];
+  GainR = Lanes[1];
+#endif
+
+  for ( ; i != Count; ++i )
+  {
+    Out_Ptr[2 * i]     += Source_Ptr[2 * i]     * GainL;
+    Out_Ptr[2 * i + 1] += Source_Ptr[2 * i + 1] * GainR;
+    GainL              += StepL;
+    GainR              += StepR;
+  }
+}
+
+
+/**
+ * @return The gain of a sound at a distance from the listener: 1 up to a distance of 1, in whatever
+ *         unit the game uses, then the inverse of the distance.
+ **/
+static float Attenuation( float Distance )
+{
+  return 1.f / std::max( Distance, 1.f );
+}
+
+
+/**
+ * @brief Scales the mix by the master gain, ramped, and clips it to the range of the device.
+ **/
+static void ScaleAndClip( float* Out_Ptr, size_t Count, float Gain, float Step )
+{
+  size_t i = 0;
+
+#if defined(LAUDIOMIXER_USE_SSE2)
+  __m128       Gains = _mm_set_ps( Gain + Step, Gain + Step, Gain, Gain );
+  const __m128 Steps = _mm_set1_ps( 2.f * Step );
+  const __m128 Low   = _mm_set1_ps( -1.f );
+  const __m128 High  = _mm_set1_ps(  1.f );
+
+  for ( ; i + 2 <= Count; i += 2 )
+  {
+    const __m128 Scaled = _mm_mul_ps( _mm_loadu_ps( Out_Ptr + 2 * i ), Gains );
+
+    _mm_storeu_ps( Out_Ptr + 2 * i, _mm_min_ps( _mm_max_ps( Scaled, Low ), High ) );
+    Gains = _mm_add_ps( Gains, Steps );
+  }
+
+  Gain += Step * static_cast<float>( i );
+#endif
+
+  for ( ; i != Count; ++i )
+  {
+    Out_Ptr[2 * i]     = std::min( std::max( Out_Ptr[2 * i]     * Gain, -1.f ), 1.f );
+    Out_Ptr[2 * i + 1] = std::min( std::max( Out_Ptr[2 * i + 1] * Gain, -1.f ), 1.f );
+    Gain              += Step;
+  }
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param MaxVoices  Sounds that can play at the same time, real or virtual.
+ * @param RealVoices Sounds mixed at the same time, the most audible.
+ **/
+LAudioMixer::LAudioMixer( size_t MaxVoices, size_t RealVoices )
+  : m_Commands(s_COMMAND_CAPACITY), m_Voices(std::max( MaxVoices, static_cast<size_t>( 1 ) )), m_Ranked(m_Voices.size()),
+    m_RealVoices(std::max( RealVoices, static_cast<size_t>( 1 ) )), m_Weights(), m_Device(0), m_Spec(), m_NextId(0), m_MasterGain(1.f), m_MasterTarget(1.f), m_Music_Ptr(nullptr), m_MusicGain(0.f), m_MusicTarget(1.f),
+    m_IsMusicPaused(false), m_IsMusicStopping(false), m_MusicBuffer(), m_Playing_Ptr(nullptr), m_IsPaused(false), m_ActiveVoices(0),
+    m_VirtualVoices(0), m_Dropped(0)
+{
+  std::fill( m_Weights, m_Weights + s_NUM_OF_CATEGORIES, 1.f );
+}
+
+
+LAudioMixer::~LAudioMixer( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Opens the default audio device and starts mixing. SDL must have been initialised with
+ * SDL_INIT_AUDIO.
+ *
+ * @param Frames Frames per buffer: rounded up to a power of two, at least s_MIN_FRAMES. The
+ *               smaller, the lower the latency, and the more often the callback runs.
+ * @param Frequency Requested sample rate; the device may pick another.
+ * @return true if the device was opened.
+ **/
+bool LAudioMixer::open( int Frames, int Frequency )
+{
+  close();
+
+  SDL_AudioSpec Wanted = {};
+
+  Wanted.freq     = Frequency;
+  Wanted.format   = AUDIO_F32SYS;
+  Wanted.channels = NUM_OF_CHANNELS;
+  Wanted.samples  = static_cast<Uint16>( LRingCapacity( static_cast<size_t>( std::max( Frames, s_MIN_FRAMES ) ) ) );
+  Wanted.callback = Callback_Pvt;
+  Wanted.userdata = this;
+
+  // Format and channels must be as asked, since the callback writes float stereo
+  m_Device = SDL_OpenAudioDevice( nullptr, 0, &Wanted, &m_Spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE );
+
+  if ( m_Device == 0 )
+  {
+    printf( "\nUnable to open the audio device! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  // Nothing plays yet, and the callback is not running: stale commands can go
+  Command Stale;
+
+  while ( m_Commands.pop( Stale ) )
+  {;}
+
+  for ( Voice& Each : m_Voices )
+  {
+    Each.Sound_Ptr = nullptr;
+  }
+
+  std::fill( m_Weights, m_Weights + s_NUM_OF_CATEGORIES, 1.f );
+
+  m_MasterGain   = 1.f;
+  m_MasterTarget = 1.f;
+  m_Music_Ptr    = nullptr;
+  m_Playing_Ptr  = nullptr;
+  m_MusicBuffer.assign( static_cast<size_t>( m_Spec.samples ) * NUM_OF_CHANNELS, 0.f );
+
+  SDL_PauseAudioDevice( m_Device, 0 );
+
+  return true;
+}
+
+
+/**
+ * @brief Stops the device; once it returns, the callback is no longer running and the sounds can
+ * be freed.
+ **/
+void LAudioMixer::close( void )
+{
+  if ( m_Device != 0 )
+  {
+    SDL_CloseAudioDevice( m_Device );
+    m_Device = 0;
+  }
+  else
+  {;}
+
+  for ( Voice& Each : m_Voices )
+  {
+    Each.Sound_Ptr = nullptr;
+  }
+
+  m_Music_Ptr   = nullptr;
+  m_Playing_Ptr = nullptr;
+  m_ActiveVoices.store( 0, std::memory_order_relaxed );
+  m_VirtualVoices.store( 0, std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Loads a WAV file, from the default asset pack if it holds it, and converts it to the
+ * format of the open device.
+ *
+ * @return true if loaded; Sound is left alone otherwise.
+ **/
+bool LAudioMixer::load( const std::string& Path, LSound& Sound ) const
+{
+  if ( m_Device == 0 )
+  {
+    printf( "\nUnable to load %s: the mixer is not open!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_AudioSpec Spec;
+  Uint8*        Buffer_Ptr = nullptr;
+  Uint32        Length     = 0;
+
+  if ( SDL_LoadWAV_RW( LOpenAsset( Path ), 1, &Spec, &Buffer_Ptr, &Length ) == nullptr )
+  {
+    printf( "\nUnable to load %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_AudioStream* Stream_Ptr = SDL_NewAudioStream( Spec.format, Spec.channels, Spec.freq,
+                                                    AUDIO_F32SYS, NUM_OF_CHANNELS, m_Spec.freq );
+  bool             IsLoaded   = false;
+
+  if ( Stream_Ptr == nullptr
+       || SDL_AudioStreamPut( Stream_Ptr, Buffer_Ptr, static_cast<int>( Length ) ) != 0
+       || SDL_AudioStreamFlush( Stream_Ptr ) != 0 )
+  {
+    printf( "\nUnable to convert %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {
+    const int Available = SDL_AudioStreamAvailable( Stream_Ptr );
+
+    Sound.Samples.resize( static_cast<size_t>( Available ) / sizeof(float) );
+    SDL_AudioStreamGet( Stream_Ptr, Sound.Samples.data(), Available );
+    IsLoaded = true;
+  }
+
+  SDL_FreeAudioStream( Stream_Ptr );
+  SDL_FreeWAV( Buffer_Ptr );
+
+  return IsLoaded;
+}
+
+
+/**
+ * @brief Starts a sound, from the next buffer; it is mixed if it is among the most audible.
+ *
+ * @param Volume 0 is silent, 1 is as recorded.
+ * @param Pan -1 is left, 0 centre, 1 right; the loudness stays the same across.
+ * @param IsLooping Whether it plays until stopped.
+ * @param Category From 0 to s_NUM_OF_CATEGORIES - 1: its weight scales the priority of the sound.
+ * @param Distance From the listener: beyond 1 the volume drops with its inverse.
+ * @return The handle to stop it or change its volume with.
+ **/
+LAudioMixer::Handle LAudioMixer::play( const LSound& Sound, float Volume, float Pan, bool IsLooping, int Category, float Distance )
+{
+  if ( ++m_NextId == 0 )
+  {
+    ++m_NextId;
+  }
+  else
+  {;}
+
+  const float Angle = ( std::min( std::max( Pan, -1.f ), 1.f ) + 1.f ) * 0.5f * QUARTER_TURN;
+  const float Gain  = Volume * Attenuation( Distance );
+
+  Send_Pvt( Command{ CommandType::PLAY, m_NextId, &Sound, nullptr, Gain * std::cos( Angle ), Gain * std::sin( Angle ), IsLooping,
+                     std::min( std::max( Category, 0 ), s_NUM_OF_CATEGORIES - 1 ) } );
+
+  return m_NextId;
+}
+
+
+/**
+ * @brief Fades a sound out over one buffer. Nothing happens if it has already ended.
+ **/
+void LAudioMixer::stop( Handle Id )
+{
+  Send_Pvt( Command{ CommandType::STOP, Id, nullptr, nullptr, 0.f, 0.f, false, 0 } );
+}
+
+
+/**
+ * @brief Moves the volume, pan and distance of a playing sound, over one buffer.
+ **/
+void LAudioMixer::setVolume( Handle Id, float Volume, float Pan, float Distance )
+{
+  const float Angle = ( std::min( std::max( Pan, -1.f ), 1.f ) + 1.f ) * 0.5f * QUARTER_TURN;
+  const float Gain  = Volume * Attenuation( Distance );
+
+  Send_Pvt( Command{ CommandType::SET_VOLUME, Id, nullptr, nullptr, Gain * std::cos( Angle ), Gain * std::sin( Angle ), false, 0 } );
+}
+
+
+void LAudioMixer::stopAll( void )
+{
+  Send_Pvt( Command{ CommandType::STOP_ALL, 0, nullptr, nullptr, 0.f, 0.f, false, 0 } );
+}
+
+
+void LAudioMixer::setMasterVolume( float Volume )
+{
+  Send_Pvt( Command{ CommandType::SET_MASTER_VOLUME, 0, nullptr, nullptr, Volume, Volume, false, 0 } );
+}
+
+
+/**
+ * @brief Scales the priority of the sounds of a category, 1 for all of them to start with. It does
+ * not change how loud they are mixed.
+ **/
+void LAudioMixer::setCategoryWeight( int Category, float Weight )
+{
+  if ( Category < 0 || Category >= s_NUM_OF_CATEGORIES )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Send_Pvt( Command{ CommandType::SET_CATEGORY_WEIGHT, 0, nullptr, nullptr, Weight, Weight, false, Category } );
+}
+
+
+/**
+ * @brief Makes a stream the music, in place of the one playing, if any. It fades in over one
+ * buffer, from where the stream is: "restart" it first to play it again from the start.
+ *
+ * @param Volume 0 is silent, 1 is as recorded.
+ **/
+void LAudioMixer::playMusic( LMusicStream& Stream, float Volume )
+{
+  m_Playing_Ptr = &Stream;
+  m_IsPaused    = false;
+
+  Send_Pvt( Command{ CommandType::PLAY_MUSIC, 0, nullptr, &Stream, Volume, Volume, false, 0 } );
+}
+
+
+/**
+ * @brief Fades the music out over one buffer; the stream is not read until "resumeMusic".
+ **/
+void LAudioMixer::pauseMusic( void )
+{
+  m_IsPaused = true;
+
+  Send_Pvt( Command{ CommandType::PAUSE_MUSIC, 0, nullptr, nullptr, 0.f, 0.f, false, 0 } );
+}
+
+
+void LAudioMixer::resumeMusic( void )
+{
+  m_IsPaused = false;
+
+  Send_Pvt( Command{ CommandType::RESUME_MUSIC, 0, nullptr, nullptr, 0.f, 0.f, false, 0 } );
+}
+
+
+/**
+ * @brief Fades the music out over one buffer, then lets the stream go.
+ **/
+void LAudioMixer::stopMusic( void )
+{
+  m_Playing_Ptr = nullptr;
+  m_IsPaused    = false;
+
+  Send_Pvt( Command{ CommandType::STOP_MUSIC, 0, nullptr, nullptr, 0.f, 0.f, false, 0 } );
+}
+
+
+void LAudioMixer::setMusicVolume( float Volume )
+{
+  Send_Pvt( Command{ CommandType::SET_MUSIC_VOLUME, 0, nullptr, nullptr, Volume, Volume, false, 0 } );
+}
+
+
+bool LAudioMixer::IsOpen( void ) const
+{
+  return m_Device != 0;
+}
+
+
+/**
+ * @return Frames per buffer of the open device.
+ **/
+int LAudioMixer::GetFrames( void ) const
+{
+  return m_Spec.samples;
+}
+
+
+int LAudioMixer::GetFrequency( void ) const
+{
+  return m_Spec.freq;
+}
+
+
+/**
+ * @return Length of a buffer: how late a sound may start, on top of what the driver adds.
+ **/
+double LAudioMixer::GetLatency_ms( void ) const
+{
+  return ( m_Spec.freq != 0 ) ? 1000.0 * m_Spec.samples / m_Spec.freq : 0.0;
+}
+
+
+size_t LAudioMixer::GetMaxVoices( void ) const
+{
+  return m_Voices.size();
+}
+
+
+size_t LAudioMixer::GetRealVoices( void ) const
+{
+  return m_RealVoices;
+}
+
+
+/**
+ * @return Voices mixed by the last buffer.
+ **/
+int LAudioMixer::GetActiveVoices( void ) const
+{
+  return m_ActiveVoices.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Voices playing but not mixed by the last buffer.
+ **/
+int LAudioMixer::GetVirtualVoices( void ) const
+{
+  return m_VirtualVoices.load( std::memory_order_relaxed );
+}
+
+
+Uint64 LAudioMixer::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Whether some music was asked for, paused or not, and has not been played to its end.
+ **/
+bool LAudioMixer::IsMusicPlaying( void ) const
+{
+  return m_Playing_Ptr != nullptr && !m_Playing_Ptr->IsFinished();
+}
+
+
+bool LAudioMixer::IsMusicPaused( void ) const
+{
+  return IsMusicPlaying() && m_IsPaused;
+}
+
+
+void SDLCALL LAudioMixer::Callback_Pvt( void* Mixer_Ptr, Uint8* Stream_Ptr, int Length )
+{
+  LTrace::nameThread( "Audio callback" );
+  LTrace::Zone Traced( "Audio mix" );
+
+  static_cast<LAudioMixer*>( Mixer_Ptr )->Mix_Pvt( reinterpret_cast<float*>( Stream_Ptr ),
+                                                  Length / static_cast<int>( NUM_OF_CHANNELS * sizeof(float) ) );
+}
+
+
+/**
+ * @brief Runs on the audio thread: applies the commands sent since the last buffer, then mixes every
+ * voice into it. Neither locks nor allocates.
+ **/
+void LAudioMixer::Mix_Pvt( float* Out_Ptr, int Frames )
+{
+  Command Batch[COMMAND_BATCH];
+  size_t  Count;
+
+  while ( ( Count = m_Commands.popBatch( Batch, COMMAND_BATCH ) ) != 0 )
+  {
+    for ( size_t i = 0; i != Count; ++i )
+    {
+      Apply_Pvt( Batch[i] );
+    }
+  }
+
+  Rank_Pvt();
+
+  const size_t Length  = static_cast<size_t>( Frames );
+  const float  PerStep = 1.f / static_cast<float>( Frames );
+  int          Active  = 0;
+  int          Virtual = 0;
+
+  std::fill( Out_Ptr, Out_Ptr + Length * NUM_OF_CHANNELS, 0.f );
+
+  for ( Voice& Each : m_Voices )
+  {
+    if ( Each.Sound_Ptr == nullptr )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const size_t SoundEnd = Each.Sound_Ptr->GetFrames();
+
+    if ( Each.IsVirtual && !Each.IsAudible )
+    {
+      // Keeps time without being read
+      const bool HasEnded = ( SoundEnd == 0 ) || ( !Each.IsLooping && Each.Position + Length >= SoundEnd );
+
+      if ( HasEnded || Each.IsStopping )
+      {
+        Each.Sound_Ptr = nullptr;
+      }
+      else
+      {
+        Each.Position = ( Each.Position + Length ) % SoundEnd;
+        ++Virtual;
+      }
+      continue;
+    }
+    else if ( Each.IsVirtual )
+    {
+      // Promoted: in where it has got to, from silence
+      Each.IsVirtual = false;
+      Each.GainL     = 0.f;
+      Each.GainR     = 0.f;
+    }
+    else
+    {;}
+
+    ++Active;
+
+    const float  TargetL   = Each.IsAudible ? Each.TargetL : 0.f;
+    const float  TargetR   = Each.IsAudible ? Each.TargetR : 0.f;
+    const float  StepL     = ( TargetL - Each.GainL ) * PerStep;
+    const float  StepR     = ( TargetR - Each.GainR ) * PerStep;
+    size_t       Done      = 0;
+    bool         HasEnded  = ( SoundEnd == 0 );
+
+    while ( Done != Length && !HasEnded )
+    {
+      const size_t Run = std::min( Length - Done, SoundEnd - Each.Position );
+
+      MixRamped( Out_Ptr + Done * NUM_OF_CHANNELS, Each.Sound_Ptr->Samples.data() + Each.Position * NUM_OF_CHANNELS,
+                 Run, Each.GainL, Each.GainR, StepL, StepR );
+
+      Done          += Run;
+      Each.Position += Run;
+
+      if ( Each.Position == SoundEnd )
+      {
+        Each.Position = 0;
+        HasEnded      = !Each.IsLooping;
+      }
+      else
+      {;}
+    }
+
+    if ( HasEnded || Each.IsStopping )
+    {
+      Each.Sound_Ptr = nullptr;
+    }
+    else
+    {
+      // Exactly on target, whatever the rounding of the steps; demoted once faded out
+      Each.GainL     = TargetL;
+      Each.GainR     = TargetR;
+      Each.IsVirtual = !Each.IsAudible;
+    }
+  }
+
+  MixMusic_Pvt( Out_Ptr, Length, PerStep );
+
+  ScaleAndClip( Out_Ptr, Length, m_MasterGain, ( m_MasterTarget - m_MasterGain ) * PerStep );
+  m_MasterGain = m_MasterTarget;
+
+  m_ActiveVoices.store( Active, std::memory_order_relaxed );
+  m_VirtualVoices.store( Virtual, std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Runs on the audio thread: marks as audible the voices to mix in the next buffer, the
+ * m_RealVoices with the highest priority. The voices stopping are not ranked: they fade out if
+ * they were real, and go at once if they were not.
+ **/
+void LAudioMixer::Rank_Pvt( void )
+{
+  size_t Count = 0;
+
+  for ( Voice& Each : m_Voices )
+  {
+    if ( Each.Sound_Ptr != nullptr && !Each.IsStopping )
+    {
+      Each.IsAudible    = true;
+      m_Ranked[Count++] = &Each;
+    }
+    else
+    {
+      Each.IsAudible = false;
+    }
+  }
+
+  if ( Count <= m_RealVoices )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const float* Weights_Ptr = m_Weights;
+  const auto   Priority    = [Weights_Ptr]( const Voice* Voice_Ptr )
+  {
+    const float Audible = std::max( Voice_Ptr->TargetL, Voice_Ptr->TargetR ) * Weights_Ptr[Voice_Ptr->Category];
+
+    return Voice_Ptr->IsVirtual ? Audible : Audible * KEEP_BONUS;
+  };
+
+  // Highest first; equal ones by age, so that the choice does not flicker
+  std::nth_element( m_Ranked.begin(), m_Ranked.begin() + static_cast<std::ptrdiff_t>( m_RealVoices ),
+                    m_Ranked.begin() + static_cast<std::ptrdiff_t>( Count ),
+                    [&Priority]( const Voice* First_Ptr, const Voice* Second_Ptr )
+                    {
+                      const float First  = Priority( First_Ptr );
+                      const float Second = Priority( Second_Ptr );
+
+                      return ( First != Second ) ? First > Second : First_Ptr->Id < Second_Ptr->Id;
+                    } );
+
+  for ( size_t i = m_RealVoices; i != Count; ++i )
+  {
+    m_Ranked[i]->IsAudible = false;
+  }
+}
+
+
+/**
+ * @brief Runs on the audio thread: adds a buffer of the music to the mix. The frames its decoder
+ * does not have ready yet are silent.
+ **/
+void LAudioMixer::MixMusic_Pvt( float* Out_Ptr, size_t Length, float PerStep )
+{
+  if ( m_Music_Ptr == nullptr || ( m_IsMusicPaused && m_MusicGain == 0.f ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const float  Target = ( m_IsMusicPaused || m_IsMusicStopping ) ? 0.f : m_MusicTarget;
+  const float  Step   = ( Target - m_MusicGain ) * PerStep;
+  const size_t Piece  = m_MusicBuffer.size() / NUM_OF_CHANNELS;
+  float        GainL  = m_MusicGain;
+  float        GainR  = m_MusicGain;
+
+  for ( size_t Done = 0; Done < Length; Done += Piece )
+  {
+    const size_t Run  = std::min( Piece, Length - Done );
+    const size_t Read = m_Music_Ptr->read( m_MusicBuffer.data(), Run );
+
+    std::fill( m_MusicBuffer.begin() + static_cast<std::ptrdiff_t>( Read * NUM_OF_CHANNELS ),
+               m_MusicBuffer.begin() + static_cast<std::ptrdiff_t>( Run  * NUM_OF_CHANNELS ), 0.f );
+
+    MixRamped( Out_Ptr + Done * NUM_OF_CHANNELS, m_MusicBuffer.data(), Run, GainL, GainR, Step, Step );
+  }
+
+  m_MusicGain = Target;
+
+  if ( m_IsMusicStopping || m_Music_Ptr->IsFinished() )
+  {
+    m_Music_Ptr = nullptr;
+  }
+  else
+  {;}
+}
+
+
+void LAudioMixer::Apply_Pvt( const Command& Order )
+{
+  switch ( Order.Type )
+  {
+    case CommandType::PLAY:
+    {
+      auto Free = std::find_if( m_Voices.begin(), m_Voices.end(), []( const Voice& Each ) { return Each.Sound_Ptr == nullptr; } );
+
+      if ( Free == m_Voices.end() )
+      {
+        m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+      }
+      else
+      {
+        // Virtual until ranked, then faded in over the first buffer it is mixed in, in case the sound
+        // does not start from silence
+        *Free = Voice{ Order.Sound_Ptr, Order.Id, 0, 0.f, 0.f, Order.GainL, Order.GainR, Order.IsLooping, false, Order.Category,
+                       false, true };
+      }
+      break;
+    }
+
+    case CommandType::STOP:
+    {
+      Voice* Voice_Ptr = Find_Pvt( Order.Id );
+
+      if ( Voice_Ptr != nullptr )
+      {
+        Voice_Ptr->IsStopping = true;
+      }
+      else
+      {;}
+      break;
+    }
+
+    case CommandType::SET_VOLUME:
+    {
+      Voice* Voice_Ptr = Find_Pvt( Order.Id );
+
+      if ( Voice_Ptr != nullptr )
+      {
+        Voice_Ptr->TargetL = Order.GainL;
+        Voice_Ptr->TargetR = Order.GainR;
+      }
+      else
+      {;}
+      break;
+    }
+
+    case CommandType::STOP_ALL:
+      for ( Voice& Each : m_Voices )
+      {
+        Each.IsStopping = true;
+      }
+      break;
+
+    case CommandType::SET_MASTER_VOLUME:
+      m_MasterTarget = Order.GainL;
+      break;
+
+    case CommandType::SET_CATEGORY_WEIGHT:
+      m_Weights[Order.Category] = Order.GainL;
+      break;
+
+    case CommandType::PLAY_MUSIC:
+      // Faded in over the first buffer, as a voice
+      m_Music_Ptr       = Order.Music_Ptr;
+      m_MusicGain       = 0.f;
+      m_MusicTarget     = Order.GainL;
+      m_IsMusicPaused   = false;
+      m_IsMusicStopping = false;
+      break;
+
+    case CommandType::PAUSE_MUSIC:
+      m_IsMusicPaused = true;
+      break;
+
+    case CommandType::RESUME_MUSIC:
+      m_IsMusicPaused = false;
+      break;
+
+    case CommandType::STOP_MUSIC:
+      m_IsMusicStopping = true;
+      break;
+
+    case CommandType::SET_MUSIC_VOLUME:
+      m_MusicTarget = Order.GainL;
+      break;
+  }
+}
+
+
+/**
+ * @brief Queues a command for the next buffer; if the queue is full, the command is dropped.
+ **/
+void LAudioMixer::Send_Pvt( const Command& Order )
+{
+  if ( !m_Commands.push( Order ) )
+  {
+    m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+  }
+  else
+  {;}
+}
+
+
+LAudioMixer::Voice* LAudioMixer::Find_Pvt( Handle Id )
+{
+  for ( Voice& Each : m_Voices )
+  {
+    if ( Each.Sound_Ptr != nullptr && Each.Id == Id )
+    {
+      return &Each;
+    }
+    else
+    {;}
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file LAudioMixer.hpp
+ *
+ * @brief Software mixer for sound effects, run by the SDL audio callback on a small buffer.
+ **/
+
+#ifndef LAUDIOMIXER_HPP
+#define LAUDIOMIXER_HPP
+
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+class LMusicStream;
+
+/**
+ * @brief A sound effect decoded once to the format the mixer works in: 32-bit float stereo,
+ * interleaved, at the frequency of the device.
+ **/
+struct LSound
+{
+  std::vector<float> Samples;
+
+  size_t GetFrames( void ) const { return Samples.size() / 2; }
+};
+
+/**
+ * @brief Mixes sound effects in the callback of its own audio device, with a buffer that can be as
+ * small as s_MIN_FRAMES: a sound starts playing within a buffer or two of being asked for.
+ *
+ * The voices are allocated when the mixer is built and never again; a sound played when they are
+ * all busy is dropped, and counted. Every change of volume, including the start and the end of a
+ * sound, is ramped over one buffer, so that nothing clicks. The mixing loops take two stereo
+ * frames per SSE2 operation where it is available.
+ *
+ * Only the most audible voices, up to a budget of real voices, are mixed: the others are virtual,
+ * their position moving on with time but nothing read. A voice is ranked by its volume, lowered by
+ * its distance from the listener, times the weight of its category ("setCategoryWeight"), so that,
+ * say, dialogue wins over distant footsteps; a voice already real is kept on a tie. A voice that
+ * becomes real fades in where it would have been, one that becomes virtual fades out, each over a
+ * buffer. The cost of a callback is bounded by the budget, however many sounds the game plays.
+ *
+ * The game talks to the callback through a lock-free queue of commands, and never waits for it:
+ * "play", "stop", "setVolume" and the like may be called by one thread only, usually the main one.
+ * A sound must stay loaded while a voice plays it: free the sounds after "close".
+ *
+ * Besides the voices, one LMusicStream at a time is mixed as the music, read by the callback from
+ * the chunks its decoder thread has ready: "playMusic", "pauseMusic", "resumeMusic" and
+ * "stopMusic" fade it over one buffer, as the voices. A stream must stay open while it is the
+ * music: close it after "close", or after "stopMusic" once a buffer has gone by.
+ **/
+class LAudioMixer
+{
+public:
+
+  static constexpr int    s_MIN_FRAMES         = 128;
+  static constexpr int    s_DEFAULT_FRAMES     = 256;   // About 5 ms at 48 kHz
+  static constexpr int    s_DEFAULT_FREQUENCY  = 48000;
+  static constexpr size_t s_DEFAULT_VOICES     = 256;
+  static constexpr size_t s_DEFAULT_REAL_VOICES = 48;    // Mixed; the others are virtual
+  static constexpr int    s_NUM_OF_CATEGORIES  = 8;
+  static constexpr size_t s_COMMAND_CAPACITY   = 1024;  // Commands sent between two callbacks
+
+  typedef Uint32 Handle; // A playing sound; 0 is none
+
+  explicit LAudioMixer( size_t = s_DEFAULT_VOICES, size_t = s_DEFAULT_REAL_VOICES );
+  ~LAudioMixer( void );
+
+  LAudioMixer( const LAudioMixer& )            = delete;
+  LAudioMixer& operator=( const LAudioMixer& ) = delete;
+
+  bool   open           ( int = s_DEFAULT_FRAMES, int = s_DEFAULT_FREQUENCY );
+  void   close          ( void );
+  bool   load           ( const std::string&, LSound& ) const;
+
+  Handle play           ( const LSound&, float = 1.f, float = 0.f, bool = false, int = 0, float = 0.f );
+  void   stop           ( Handle );
+  void   setVolume      ( Handle, float, float = 0.f, float = 0.f );
+  void   stopAll        ( void );
+  void   setMasterVolume( float );
+  void   setCategoryWeight( int, float );
+
+  void   playMusic      ( LMusicStream&, float = 1.f );
+  void   pauseMusic     ( void );
+  void   resumeMusic    ( void );
+  void   stopMusic      ( void );
+  void   setMusicVolume ( float );
+
+  bool   IsOpen         ( void ) const;
+  int    GetFrames      ( void ) const;
+  int    GetFrequency   ( void ) const;
+  double GetLatency_ms  ( void ) const;
+  size_t GetMaxVoices   ( void ) const;
+  size_t GetRealVoices  ( void ) const;
+  int    GetActiveVoices( void ) const;
+  int    GetVirtualVoices( void ) const;
+  Uint64 GetDropped     ( void ) const;
+  bool   IsMusicPlaying ( void ) const;
+  bool   IsMusicPaused  ( void ) const;
+
+private:
+
+  enum class CommandType
+  {
+    PLAY,
+    STOP,
+    SET_VOLUME,
+    STOP_ALL,
+    SET_MASTER_VOLUME,
+    SET_CATEGORY_WEIGHT,
+    PLAY_MUSIC,
+    PAUSE_MUSIC,
+    RESUME_MUSIC,
+    STOP_MUSIC,
+    SET_MUSIC_VOLUME
+  };
+
+  struct Command
+  {
+    CommandType   Type;
+    Handle        Id;
+    const LSound* Sound_Ptr;
+    LMusicStream* Music_Ptr;
+    float         GainL;
+    float         GainR;
+    bool          IsLooping;
+    int           Category;
+  };
+
+  struct Voice
+  {
+    const LSound* Sound_Ptr;  // nullptr when free
+    Handle        Id;
+    size_t        Position;   // Next frame to mix
+    float         GainL;      // Reached at the end of the last buffer
+    float         GainR;
+    float         TargetL;    // Reached at the end of the next one
+    float         TargetR;
+    bool          IsLooping;
+    bool          IsStopping; // Ramping down, then freed
+    int           Category;
+    bool          IsAudible;  // Among the real voices for the next buffer
+    bool          IsVirtual;  // Not mixed, gains at 0
+  };
+
+  static void SDLCALL Callback_Pvt( void*, Uint8*, int );
+
+  void   Mix_Pvt    ( float*, int );
+  void   Rank_Pvt   ( void );
+  void   MixMusic_Pvt( float*, size_t, float );
+  void   Apply_Pvt  ( const Command& );
+  void   Send_Pvt   ( const Command& );
+  Voice* Find_Pvt   ( Handle );
+
+  LSpscRing<Command>  m_Commands;     // Main thread to callback
+  std::vector<Voice>  m_Voices;       // Callback only while the device is open
+  std::vector<Voice*> m_Ranked;       // Callback only: allocated with the voices
+  size_t              m_RealVoices;
+  float               m_Weights[s_NUM_OF_CATEGORIES]; // Callback only
+  SDL_AudioDeviceID   m_Device;
+  SDL_AudioSpec       m_Spec;         // What the device accepted
+  Handle              m_NextId;       // Main thread only
+  float               m_MasterGain;   // Callback only
+  float               m_MasterTarget;
+  LMusicStream*       m_Music_Ptr;    // Callback only: nullptr when none
+  float               m_MusicGain;
+  float               m_MusicTarget;
+  bool                m_IsMusicPaused;  // Faded out, and not read
+  bool                m_IsMusicStopping;
+  std::vector<float>  m_MusicBuffer;  // A buffer of music, read before it is mixed
+  LMusicStream*       m_Playing_Ptr;  // Main thread only: the music asked for
+  bool                m_IsPaused;     // Main thread only
+  std::atomic<int>    m_ActiveVoices; // Written by the callback
+  std::atomic<int>    m_VirtualVoices;
+  std::atomic<Uint64> m_Dropped;      // Plays that found no free voice, or a full queue
+};
+
+#endif // LAUDIOMIXER_HPP
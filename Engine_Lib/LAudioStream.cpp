@@ -0,0 +1,979 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAudioStream.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint16 WAVE_FORMAT_PCM        = 0x0001;
+static constexpr Uint16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static constexpr Uint16 WAVE_FORMAT_IMA_ADPCM  = 0x0011;
+static constexpr Uint32 HEADER_BYTES           = 44;         // RIFF, fmt and data chunk headers
+static constexpr Uint32 IMA_HEADER_BYTES       = 60;         // And 4 more bytes of fmt, and a fact chunk
+static constexpr Uint32 MAX_CHUNK_BYTES        = 0xFFFFFFFF; // Sizes saturate past 4 GB of audio
+static constexpr Uint32 WRITER_SLEEP_MS        = 10;         // Well below s_RING_SECONDS
+static constexpr Uint32 READER_SLEEP_MS        = 10;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static size_t BytesPerFrame( const SDL_AudioSpec& Spec )
+{
+  return Spec.channels * sizeof(float);
+}
+
+
+static size_t BytesPerSecond( const SDL_AudioSpec& Spec )
+{
+  return static_cast<size_t>( Spec.freq ) * BytesPerFrame( Spec );
+}
+
+
+static Uint16 BitsPerSample( LWavEncoding Encoding )
+{
+  return ( Encoding == LWavEncoding::FLOAT_32 ) ? 32 : ( Encoding == LWavEncoding::PCM_16 ) ? 16 : 4;
+}
+
+
+/**
+ * @return Bytes of a frame in the file, or of an ADPCM block.
+ **/
+static Uint16 BlockAlign( const SDL_AudioSpec& Spec, LWavEncoding Encoding )
+{
+  return static_cast<Uint16>( Spec.channels * ( ( Encoding == LWavEncoding::IMA_ADPCM ) ? LAudioRecorder::s_IMA_BLOCK_BYTES
+                                                                                        : BitsPerSample( Encoding ) / 8u ) );
+}
+
+
+static Sint16 ToPcm16( float Sample )
+{
+  return static_cast<Sint16>( std::lrint( std::min( std::max( Sample, -1.f ), 1.f ) * 32767.f ) );
+}
+
+
+/**
+ * @brief Bytes in a ring of RingSeconds, and never less than two chunks.
+ **/
+static size_t RingBytes( const SDL_AudioSpec& Spec, double RingSeconds, size_t ChunkBytes )
+{
+  return std::max( static_cast<size_t>( RingSeconds * static_cast<double>( BytesPerSecond( Spec ) ) ), 2 * ChunkBytes );
+}
+
+
+/**
+ * @brief Writes the WAV header at the start of the file, and leaves the file at its end. ADPCM
+ * needs the frames too, in a fact chunk.
+ **/
+static bool WriteWavHeader( SDL_RWops* File_Ptr, const SDL_AudioSpec& Spec, LWavEncoding Encoding, Uint64 DataBytes, Uint64 Frames )
+{
+  const bool   IsAdpcm        = ( Encoding == LWavEncoding::IMA_ADPCM );
+  const Uint32 HeaderBytes    = IsAdpcm ? IMA_HEADER_BYTES : HEADER_BYTES;
+  const Uint32 DataSize       = static_cast<Uint32>( std::min<Uint64>( DataBytes, MAX_CHUNK_BYTES - HeaderBytes ) );
+  const Uint16 Align          = BlockAlign( Spec, Encoding );
+  const Uint32 FramesPerBlock = IsAdpcm ? static_cast<Uint32>( ImaBlockFrames( Align, Spec.channels ) ) : 1;
+  const Uint16 Format         = IsAdpcm ? WAVE_FORMAT_IMA_ADPCM
+                                        : ( Encoding == LWavEncoding::PCM_16 ) ? WAVE_FORMAT_PCM : WAVE_FORMAT_IEEE_FLOAT;
+
+  bool IsWritten = SDL_RWseek( File_Ptr, 0, RW_SEEK_SET ) == 0
+                   && SDL_RWwrite( File_Ptr, "RIFF", 4, 1 ) == 1
+                   && SDL_WriteLE32( File_Ptr, HeaderBytes - 8 + DataSize ) == 1
+                   && SDL_RWwrite( File_Ptr, "WAVEfmt ", 8, 1 ) == 1
+                   && SDL_WriteLE32( File_Ptr, IsAdpcm ? 20 : 16 ) == 1
+                   && SDL_WriteLE16( File_Ptr, Format ) == 1
+                   && SDL_WriteLE16( File_Ptr, Spec.channels ) == 1
+                   && SDL_WriteLE32( File_Ptr, static_cast<Uint32>( Spec.freq ) ) == 1
+                   && SDL_WriteLE32( File_Ptr, static_cast<Uint32>( Spec.freq ) * Align / FramesPerBlock ) == 1
+                   && SDL_WriteLE16( File_Ptr, Align ) == 1
+                   && SDL_WriteLE16( File_Ptr, BitsPerSample( Encoding ) ) == 1;
+
+  if ( IsAdpcm )
+  {
+    IsWritten = IsWritten
+                && SDL_WriteLE16( File_Ptr, 2 ) == 1                                    // Extension size
+                && SDL_WriteLE16( File_Ptr, static_cast<Uint16>( FramesPerBlock ) ) == 1
+                && SDL_RWwrite( File_Ptr, "fact", 4, 1 ) == 1
+                && SDL_WriteLE32( File_Ptr, 4 ) == 1
+                && SDL_WriteLE32( File_Ptr, static_cast<Uint32>( std::min<Uint64>( Frames, MAX_CHUNK_BYTES ) ) ) == 1;
+  }
+  else
+  {;}
+
+  IsWritten = IsWritten
+              && SDL_RWwrite( File_Ptr, "data", 4, 1 ) == 1
+              && SDL_WriteLE32( File_Ptr, DataSize ) == 1;
+
+  return IsWritten && SDL_RWseek( File_Ptr, 0, RW_SEEK_END ) >= 0;
+}
+
+
+/**
+ * @brief Reads the header of a WAV file in one of the encodings LAudioRecorder writes, skipping the
+ * chunks it does not need, and leaves the file at the start of the samples.
+ *
+ * @param Spec Gets the frequency and channels.
+ * @param Encoding, Align Get the encoding and the bytes of a frame, or of an ADPCM block.
+ * @param DataBytes Gets the size of the samples.
+ * @return false if the file is not in one of those encodings.
+ **/
+static bool ReadWavHeader( SDL_RWops* File_Ptr, SDL_AudioSpec& Spec, LWavEncoding& Encoding, Uint16& Align, Uint64& DataBytes )
+{
+  char Id[4];
+
+  if ( SDL_RWread( File_Ptr, Id, 4, 1 ) != 1 || memcmp( Id, "RIFF", 4 ) != 0
+       || SDL_RWseek( File_Ptr, 4, RW_SEEK_CUR ) < 0
+       || SDL_RWread( File_Ptr, Id, 4, 1 ) != 1 || memcmp( Id, "WAVE", 4 ) != 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  bool HasFormat = false;
+
+  while ( SDL_RWread( File_Ptr, Id, 4, 1 ) == 1 )
+  {
+    const Uint32 Size = SDL_ReadLE32( File_Ptr );
+
+    if ( memcmp( Id, "data", 4 ) == 0 )
+    {
+      DataBytes = Size;
+      return HasFormat;
+    }
+    else if ( memcmp( Id, "fmt ", 4 ) == 0 && Size >= 16 )
+    {
+      const Uint16 Format = SDL_ReadLE16( File_Ptr );
+
+      Spec.channels = static_cast<Uint8>( SDL_ReadLE16( File_Ptr ) );
+      Spec.freq     = static_cast<int>( SDL_ReadLE32( File_Ptr ) );
+      SDL_ReadLE32( File_Ptr );                                   // Bytes per second
+      Align         = SDL_ReadLE16( File_Ptr );
+
+      const Uint16 Bits = SDL_ReadLE16( File_Ptr );
+
+      Encoding  = ( Format == WAVE_FORMAT_IMA_ADPCM ) ? LWavEncoding::IMA_ADPCM
+                : ( Format == WAVE_FORMAT_PCM )       ? LWavEncoding::PCM_16 : LWavEncoding::FLOAT_32;
+
+      HasFormat = ( Format == WAVE_FORMAT_IEEE_FLOAT || Format == WAVE_FORMAT_PCM || Format == WAVE_FORMAT_IMA_ADPCM )
+                  && Bits == BitsPerSample( Encoding ) && Spec.channels != 0 && Spec.freq > 0
+                  && ( Encoding != LWavEncoding::IMA_ADPCM || ( Spec.channels <= IMA_MAX_CHANNELS && Align > 4 * Spec.channels ) )
+                  && ( Encoding == LWavEncoding::IMA_ADPCM || Align == Spec.channels * Bits / 8 );
+
+      if ( !HasFormat || SDL_RWseek( File_Ptr, ( Size - 16 ) + ( Size & 1 ), RW_SEEK_CUR ) < 0 )
+      {
+        return false;
+      }
+      else
+      {;}
+    }
+    else if ( SDL_RWseek( File_Ptr, static_cast<Sint64>( Size ) + ( Size & 1 ), RW_SEEK_CUR ) < 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/***************************************************************************************************
+* Methods - LAudioRecorder
+****************************************************************************************************/
+
+LAudioRecorder::LAudioRecorder( void )
+  : m_Ring_Ptr(), m_Chunk(s_CHUNK_BYTES), m_ChunkBytes(s_CHUNK_BYTES), m_Encoding(LWavEncoding::FLOAT_32), m_Encoded(), m_Pcm(),
+    m_PcmFrames(0), m_ImaIndex(), m_Frames(0), m_Analyser_Ptr(nullptr), m_Device(0), m_Spec(), m_File_Ptr(nullptr),
+    m_Writer_Ptr(nullptr), m_DataBytes(0), m_HasFailed(false), m_IsStopping(false), m_Written(0), m_Captured(0), m_Dropped(0)
+{;}
+
+
+LAudioRecorder::~LAudioRecorder( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Opens a capture device, paused. SDL must have been initialised with SDL_INIT_AUDIO.
+ *
+ * @param Name Name of the device, as given by SDL_GetAudioDeviceName; nullptr for the default one.
+ * @param Frequency Requested sample rate; the device may pick another.
+ * @param Frames Frames per callback.
+ * @return true if the device was opened.
+ **/
+bool LAudioRecorder::open( const char* Name, int Frequency, int Channels, int Frames )
+{
+  close();
+
+  SDL_AudioSpec Wanted = {};
+
+  Wanted.freq     = Frequency;
+  Wanted.format   = AUDIO_F32LSB;   // As the samples go in the file
+  Wanted.channels = static_cast<Uint8>( Channels );
+  Wanted.samples  = static_cast<Uint16>( Frames );
+  Wanted.callback = Callback_Pvt;
+  Wanted.userdata = this;
+
+  m_Device = SDL_OpenAudioDevice( Name, SDL_TRUE, &Wanted, &m_Spec, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE );
+
+  if ( m_Device == 0 )
+  {
+    printf( "\nUnable to open the recording device! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Ring_Ptr.reset( new LSpscRing<Uint8>( RingBytes( m_Spec, s_RING_SECONDS, s_CHUNK_BYTES ) ) );
+  m_ChunkBytes = s_CHUNK_BYTES - s_CHUNK_BYTES % BytesPerFrame( m_Spec );
+
+  return true;
+}
+
+
+/**
+ * @brief Stops any recording, and closes the device.
+ **/
+void LAudioRecorder::close( void )
+{
+  stop();
+
+  if ( m_Device != 0 )
+  {
+    SDL_CloseAudioDevice( m_Device );
+    m_Device = 0;
+  }
+  else
+  {;}
+
+  m_Ring_Ptr.reset();
+}
+
+
+/**
+ * @brief Creates the file, starts the writer thread and unpauses the device.
+ *
+ * @param Encoding Of the samples in the file: IMA_ADPCM takes up to IMA_MAX_CHANNELS channels.
+ * @return true if recording.
+ **/
+bool LAudioRecorder::start( const std::string& Path, LWavEncoding Encoding )
+{
+  if ( m_Device == 0 || m_Writer_Ptr != nullptr )
+  {
+    printf( "\nUnable to record to %s: the recorder is %s!", Path.c_str(), ( m_Device == 0 ) ? "not open" : "busy" );
+    return false;
+  }
+  else if ( Encoding == LWavEncoding::IMA_ADPCM && m_Spec.channels > IMA_MAX_CHANNELS )
+  {
+    printf( "\nUnable to record to %s: too many channels for ADPCM!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Encoding = Encoding;
+  m_File_Ptr = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  if ( m_File_Ptr == nullptr || !WriteWavHeader( m_File_Ptr, m_Spec, m_Encoding, 0, 0 ) )
+  {
+    printf( "\nUnable to create %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+
+    if ( m_File_Ptr != nullptr )
+    {
+      SDL_RWclose( m_File_Ptr );
+      m_File_Ptr = nullptr;
+    }
+    else
+    {;}
+
+    return false;
+  }
+  else
+  {;}
+
+  // Neither the callback nor a writer is running: this thread may take the consumer side
+  Drain_Pvt();
+
+  // Room for what a chunk encodes to; ADPCM also keeps what does not fill a block, up to a block
+  const size_t Channels    = m_Spec.channels;
+  const size_t ChunkFrames = m_ChunkBytes / BytesPerFrame( m_Spec );
+  const size_t Align       = BlockAlign( m_Spec, m_Encoding );
+  const size_t BlockFrames = ImaBlockFrames( Align, m_Spec.channels );
+
+  if ( m_Encoding == LWavEncoding::PCM_16 )
+  {
+    m_Encoded.resize( ChunkFrames * Align );
+  }
+  else if ( m_Encoding == LWavEncoding::IMA_ADPCM )
+  {
+    m_Encoded.resize( ( ChunkFrames / BlockFrames + 2 ) * Align );
+    m_Pcm.resize( ( ChunkFrames + 2 * BlockFrames ) * Channels );
+  }
+  else
+  {;}
+
+  std::fill( m_ImaIndex, m_ImaIndex + IMA_MAX_CHANNELS, 0 );
+  m_PcmFrames = 0;
+  m_Frames    = 0;
+  m_DataBytes = 0;
+  m_HasFailed = false;
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_Written.store( 0, std::memory_order_relaxed );
+  m_Captured.store( 0, std::memory_order_relaxed );
+  m_Dropped.store( 0, std::memory_order_relaxed );
+
+  m_Writer_Ptr = SDL_CreateThread( Writer_Pvt, "LAudioRecorder", this );
+
+  if ( m_Writer_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the writer thread! SDL Error: %s", SDL_GetError() );
+    SDL_RWclose( m_File_Ptr );
+    m_File_Ptr = nullptr;
+    return false;
+  }
+  else
+  {;}
+
+  SDL_PauseAudioDevice( m_Device, 0 );
+
+  return true;
+}
+
+
+/**
+ * @brief Pauses the device, lets the writer empty the ring, and completes the header.
+ *
+ * @return true if everything captured and not dropped is in the file.
+ **/
+bool LAudioRecorder::stop( void )
+{
+  if ( m_Writer_Ptr == nullptr )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Takes the device lock: once it returns, the callback is not running and will not run again
+  SDL_PauseAudioDevice( m_Device, 1 );
+
+  m_IsStopping.store( true, std::memory_order_release );
+  SDL_WaitThread( m_Writer_Ptr, nullptr );
+  m_Writer_Ptr = nullptr;
+
+  const bool IsWritten = !m_HasFailed && WriteWavHeader( m_File_Ptr, m_Spec, m_Encoding, m_DataBytes, m_Frames );
+  const bool IsClosed  = SDL_RWclose( m_File_Ptr ) == 0;
+
+  m_File_Ptr = nullptr;
+
+  if ( !IsWritten || !IsClosed )
+  {
+    printf( "\nUnable to write the recording! SDL Error: %s", SDL_GetError() );
+  }
+  else
+  {;}
+
+  return IsWritten && IsClosed;
+}
+
+
+/**
+ * @brief Feeds the samples written to an analyser too, from the writer thread; nullptr for none.
+ * Only while not recording.
+ **/
+void LAudioRecorder::setAnalyser( LAudioAnalyser* Analyser_Ptr )
+{
+  m_Analyser_Ptr = Analyser_Ptr;
+}
+
+
+bool LAudioRecorder::IsOpen( void ) const
+{
+  return m_Device != 0;
+}
+
+
+bool LAudioRecorder::IsRecording( void ) const
+{
+  return m_Writer_Ptr != nullptr;
+}
+
+
+/**
+ * @return Length of the current, or last, recording, dropped samples included.
+ **/
+double LAudioRecorder::GetSeconds( void ) const
+{
+  const size_t PerSecond = BytesPerSecond( m_Spec );
+
+  return ( PerSecond != 0 ) ? static_cast<double>( m_Captured.load( std::memory_order_relaxed ) ) / static_cast<double>( PerSecond ) : 0.0;
+}
+
+
+/**
+ * @return Bytes of the current, or last, recording lost because the ring was full.
+ **/
+Uint64 LAudioRecorder::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Bytes of samples in the file of the current, or last, recording, encoded.
+ **/
+Uint64 LAudioRecorder::GetFileBytes( void ) const
+{
+  return m_Written.load( std::memory_order_relaxed );
+}
+
+
+const SDL_AudioSpec& LAudioRecorder::GetSpec( void ) const
+{
+  return m_Spec;
+}
+
+
+/**
+ * @brief Runs on the audio thread: copies the whole frames that fit in the ring, and counts the rest.
+ **/
+void SDLCALL LAudioRecorder::Callback_Pvt( void* Recorder_Ptr, Uint8* Stream_Ptr, int Length )
+{
+  LTrace::nameThread( "Audio callback" );
+  LTrace::Zone Traced( "Audio capture" );
+
+  LAudioRecorder& Self   = *static_cast<LAudioRecorder*>( Recorder_Ptr );
+  const size_t    Bytes  = static_cast<size_t>( Length );
+  const size_t    Room   = Self.m_Ring_Ptr->GetCapacity() - Self.m_Ring_Ptr->GetSize();
+  const size_t    Pushed = Self.m_Ring_Ptr->pushBatch( Stream_Ptr, std::min( Bytes, Room - Room % BytesPerFrame( Self.m_Spec ) ) );
+
+  Self.m_Captured.fetch_add( Bytes, std::memory_order_relaxed );
+
+  if ( Pushed != Bytes )
+  {
+    Self.m_Dropped.fetch_add( Bytes - Pushed, std::memory_order_relaxed );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Empties the ring into the file a chunk at a time, encoded, sleeping when there is less
+ * than a chunk, and feeds the analyser as the samples arrive. Once stopped, writes what is left and
+ * returns.
+ **/
+int SDLCALL LAudioRecorder::Writer_Pvt( void* Recorder_Ptr )
+{
+  LAudioRecorder& Self       = *static_cast<LAudioRecorder*>( Recorder_Ptr );
+  const size_t    FrameBytes = BytesPerFrame( Self.m_Spec );
+  size_t          Filled     = 0;
+
+  LTrace::nameThread( "LAudioRecorder" );
+
+  for ( ;; )
+  {
+    // Read before popping: if set, the callback has pushed for the last time
+    const bool   IsLast = Self.m_IsStopping.load( std::memory_order_acquire );
+
+    // The ring only holds whole frames, and whole frames are asked for
+    const size_t Popped = Self.m_Ring_Ptr->popBatch( Self.m_Chunk.data() + Filled, Self.m_ChunkBytes - Filled );
+
+    if ( Self.m_Analyser_Ptr != nullptr && Popped != 0 )
+    {
+      Self.m_Analyser_Ptr->feed( reinterpret_cast<const float*>( Self.m_Chunk.data() + Filled ), Popped / FrameBytes,
+                                 Self.m_Spec.channels );
+    }
+    else
+    {;}
+
+    Filled += Popped;
+
+    if ( Filled == Self.m_ChunkBytes )
+    {
+      Self.Encode_Pvt( Filled, false );
+      Filled = 0;
+    }
+    else if ( IsLast )
+    {
+      Self.Encode_Pvt( Filled, true );
+      return 0;
+    }
+    else
+    {
+      SDL_Delay( WRITER_SLEEP_MS );
+    }
+  }
+}
+
+
+/**
+ * @brief Encodes the samples of the chunk, whole frames, and writes them. ADPCM keeps the frames
+ * that do not fill a block for the next call; the last call writes them in a short block, padded
+ * with the last frame to a whole group of 8.
+ **/
+void LAudioRecorder::Encode_Pvt( size_t Bytes, bool IsLast )
+{
+  LTrace::Zone Traced( "Audio encode" );
+
+  const float* Samples_Ptr = reinterpret_cast<const float*>( m_Chunk.data() );
+  const size_t Channels    = m_Spec.channels;
+  const size_t Frames      = Bytes / BytesPerFrame( m_Spec );
+  const size_t Samples     = Frames * Channels;
+
+  m_Frames += Frames;
+
+  switch ( m_Encoding )
+  {
+    case LWavEncoding::FLOAT_32:
+      Write_Pvt( m_Chunk.data(), Bytes );
+      break;
+
+    case LWavEncoding::PCM_16:
+      for ( size_t i = 0; i != Samples; ++i )
+      {
+        const Uint16 Sample = static_cast<Uint16>( ToPcm16( Samples_Ptr[i] ) );
+
+        m_Encoded[2 * i]     = static_cast<Uint8>( Sample & 0xFF );
+        m_Encoded[2 * i + 1] = static_cast<Uint8>( Sample >> 8 );
+      }
+
+      Write_Pvt( m_Encoded.data(), 2 * Samples );
+      break;
+
+    case LWavEncoding::IMA_ADPCM:
+    {
+      const size_t Align       = BlockAlign( m_Spec, m_Encoding );
+      const size_t BlockFrames = ImaBlockFrames( Align, m_Spec.channels );
+      Sint16*      Pcm_Ptr     = m_Pcm.data();
+      size_t       Done        = 0;
+      size_t       Encoded     = 0;
+
+      for ( size_t i = 0; i != Samples; ++i )
+      {
+        Pcm_Ptr[m_PcmFrames * Channels + i] = ToPcm16( Samples_Ptr[i] );
+      }
+
+      m_PcmFrames += Frames;
+
+      for ( ; m_PcmFrames - Done >= BlockFrames; Done += BlockFrames )
+      {
+        Encoded += EncodeImaBlock( Pcm_Ptr + Done * Channels, BlockFrames, m_Spec.channels, m_ImaIndex, m_Encoded.data() + Encoded );
+      }
+
+      if ( IsLast && Done != m_PcmFrames )
+      {
+        const size_t Left   = m_PcmFrames - Done;
+        const size_t Padded = 1 + ( Left + 6 ) / 8 * 8;
+
+        for ( size_t f = Left; f != Padded; ++f )
+        {
+          std::copy( Pcm_Ptr + ( Done + Left - 1 ) * Channels, Pcm_Ptr + ( Done + Left ) * Channels, Pcm_Ptr + ( Done + f ) * Channels );
+        }
+
+        Encoded += EncodeImaBlock( Pcm_Ptr + Done * Channels, Padded, m_Spec.channels, m_ImaIndex, m_Encoded.data() + Encoded );
+        Done     = m_PcmFrames;
+      }
+      else
+      {;}
+
+      std::copy( Pcm_Ptr + Done * Channels, Pcm_Ptr + m_PcmFrames * Channels, Pcm_Ptr );
+      m_PcmFrames -= Done;
+
+      Write_Pvt( m_Encoded.data(), Encoded );
+      break;
+    }
+  }
+}
+
+
+void LAudioRecorder::Write_Pvt( const Uint8* Data_Ptr, size_t Bytes )
+{
+  const size_t Written = ( Bytes != 0 ) ? SDL_RWwrite( m_File_Ptr, Data_Ptr, 1, Bytes ) : 0;
+
+  m_DataBytes += Written;
+  m_HasFailed  = m_HasFailed || ( Written != Bytes );
+  m_Written.store( m_DataBytes, std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Throws away whatever a stopped recording left in the ring.
+ **/
+void LAudioRecorder::Drain_Pvt( void )
+{
+  while ( m_Ring_Ptr->popBatch( m_Chunk.data(), s_CHUNK_BYTES ) != 0 )
+  {;}
+}
+
+
+/***************************************************************************************************
+* Methods - LAudioPlayer
+****************************************************************************************************/
+
+LAudioPlayer::LAudioPlayer( void )
+  : m_Ring_Ptr(), m_Chunk(s_CHUNK_BYTES), m_ChunkBytes(s_CHUNK_BYTES), m_Encoding(LWavEncoding::FLOAT_32), m_BlockAlign(0), m_Raw(),
+    m_RawBytes(s_CHUNK_BYTES), m_Pcm(), m_Analyser_Ptr(nullptr), m_Device(0),
+    m_Spec(), m_File_Ptr(nullptr), m_Reader_Ptr(nullptr),
+    m_DataBytes(0), m_IsStopping(false), m_IsEndOfFile(false), m_IsFinished(false), m_Underruns(0)
+{;}
+
+
+LAudioPlayer::~LAudioPlayer( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Opens the file and the default playback device, fills the ring and starts playing. SDL
+ * must have been initialised with SDL_INIT_AUDIO.
+ *
+ * @param Frames Frames per callback.
+ * @return true if playing.
+ **/
+bool LAudioPlayer::start( const std::string& Path, int Frames )
+{
+  stop();
+
+  m_File_Ptr = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( m_File_Ptr == nullptr )
+  {
+    printf( "\nUnable to open %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_AudioSpec Wanted = {};
+
+  if ( !ReadWavHeader( m_File_Ptr, Wanted, m_Encoding, m_BlockAlign, m_DataBytes ) )
+  {
+    printf( "\nUnable to play %s: not a 32-bit float, 16-bit PCM or IMA ADPCM WAV file!", Path.c_str() );
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  Wanted.format   = AUDIO_F32LSB;
+  Wanted.samples  = static_cast<Uint16>( Frames );
+  Wanted.callback = Callback_Pvt;
+  Wanted.userdata = this;
+
+  // No changes allowed: SDL converts to what the device wants
+  m_Device = SDL_OpenAudioDevice( nullptr, SDL_FALSE, &Wanted, &m_Spec, 0 );
+
+  if ( m_Device == 0 )
+  {
+    printf( "\nUnable to open the playback device! SDL Error: %s", SDL_GetError() );
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  // A chunk decodes from whole samples, or whole ADPCM blocks: one at least
+  const size_t FrameBytes = BytesPerFrame( m_Spec );
+
+  m_ChunkBytes = s_CHUNK_BYTES - s_CHUNK_BYTES % FrameBytes;
+
+  if ( m_Encoding == LWavEncoding::PCM_16 )
+  {
+    m_RawBytes = m_ChunkBytes / 2;
+  }
+  else if ( m_Encoding == LWavEncoding::IMA_ADPCM )
+  {
+    const size_t BlockFrames = ImaBlockFrames( m_BlockAlign, m_Spec.channels );
+    const size_t Blocks      = std::max( m_ChunkBytes / ( BlockFrames * FrameBytes ), static_cast<size_t>( 1 ) );
+
+    m_ChunkBytes = std::max( m_ChunkBytes, BlockFrames * FrameBytes );
+    m_RawBytes   = Blocks * m_BlockAlign;
+    m_Pcm.resize( BlockFrames * m_Spec.channels );
+  }
+  else
+  {
+    m_RawBytes = m_ChunkBytes;
+  }
+
+  m_Chunk.resize( std::max( m_ChunkBytes, s_CHUNK_BYTES ) );
+  m_Raw.resize( ( m_Encoding != LWavEncoding::FLOAT_32 ) ? m_RawBytes : 0 );
+  m_Ring_Ptr.reset( new LSpscRing<Uint8>( RingBytes( m_Spec, s_RING_SECONDS, m_ChunkBytes ) ) );
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_IsEndOfFile.store( false, std::memory_order_relaxed );
+  m_IsFinished.store( false, std::memory_order_relaxed );
+  m_Underruns.store( 0, std::memory_order_relaxed );
+
+  // The reader is not running yet: the first fill is done here, so playback starts without a gap
+  Fill_Pvt();
+
+  m_Reader_Ptr = SDL_CreateThread( Reader_Pvt, "LAudioPlayer", this );
+
+  if ( m_Reader_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the reader thread! SDL Error: %s", SDL_GetError() );
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  SDL_PauseAudioDevice( m_Device, 0 );
+
+  return true;
+}
+
+
+/**
+ * @brief Closes the device, then the reader thread and the file.
+ **/
+void LAudioPlayer::stop( void )
+{
+  if ( m_Device != 0 )
+  {
+    SDL_CloseAudioDevice( m_Device );
+    m_Device = 0;
+  }
+  else
+  {;}
+
+  if ( m_Reader_Ptr != nullptr )
+  {
+    m_IsStopping.store( true, std::memory_order_relaxed );
+    SDL_WaitThread( m_Reader_Ptr, nullptr );
+    m_Reader_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  if ( m_File_Ptr != nullptr )
+  {
+    SDL_RWclose( m_File_Ptr );
+    m_File_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Ring_Ptr.reset();
+}
+
+
+/**
+ * @brief Feeds the samples read to an analyser too, from the reader thread; nullptr for none. Only
+ * while not playing.
+ **/
+void LAudioPlayer::setAnalyser( LAudioAnalyser* Analyser_Ptr )
+{
+  m_Analyser_Ptr = Analyser_Ptr;
+}
+
+
+bool LAudioPlayer::IsPlaying( void ) const
+{
+  return m_Device != 0 && !IsFinished();
+}
+
+
+/**
+ * @return true once the whole file has been played; the device is left open until stop.
+ **/
+bool LAudioPlayer::IsFinished( void ) const
+{
+  return m_IsFinished.load( std::memory_order_acquire );
+}
+
+
+/**
+ * @return Callbacks of the current, or last, playback that filled part of their buffer with
+ * silence because the reader was late.
+ **/
+Uint64 LAudioPlayer::GetUnderruns( void ) const
+{
+  return m_Underruns.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Runs on the audio thread: copies out of the ring, and pads with silence what is missing.
+ **/
+void SDLCALL LAudioPlayer::Callback_Pvt( void* Player_Ptr, Uint8* Stream_Ptr, int Length )
+{
+  LTrace::nameThread( "Audio callback" );
+  LTrace::Zone Traced( "Audio playback" );
+
+  LAudioPlayer& Self = *static_cast<LAudioPlayer*>( Player_Ptr );
+
+  // Read before popping: if set, the ring already holds the end of the file
+  const bool   IsEnd  = Self.m_IsEndOfFile.load( std::memory_order_acquire );
+  const size_t Bytes  = static_cast<size_t>( Length );
+  const size_t Popped = Self.m_Ring_Ptr->popBatch( Stream_Ptr, Bytes );
+
+  if ( Popped != Bytes )
+  {
+    // Float silence is all zero bits
+    memset( Stream_Ptr + Popped, 0, Bytes - Popped );
+
+    if ( IsEnd )
+    {
+      Self.m_IsFinished.store( true, std::memory_order_release );
+    }
+    else
+    {
+      Self.m_Underruns.fetch_add( 1, std::memory_order_relaxed );
+    }
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Keeps the ring filled until the end of the file, and the analyser's lag up to date until
+ * everything has been played, or until stopped.
+ **/
+int SDLCALL LAudioPlayer::Reader_Pvt( void* Player_Ptr )
+{
+  LAudioPlayer& Self = *static_cast<LAudioPlayer*>( Player_Ptr );
+
+  LTrace::nameThread( "LAudioPlayer" );
+
+  for ( ;; )
+  {
+    {
+      LTrace::Zone Traced( "Audio read" );
+      Self.Fill_Pvt();
+    }
+
+    if ( Self.m_IsStopping.load( std::memory_order_relaxed ) || Self.m_IsFinished.load( std::memory_order_relaxed ) )
+    {
+      break;
+    }
+    else
+    {
+      SDL_Delay( READER_SLEEP_MS );
+    }
+  }
+
+  if ( Self.m_Analyser_Ptr != nullptr )
+  {
+    Self.m_Analyser_Ptr->setLag( 0 );
+  }
+  else
+  {;}
+
+  return 0;
+}
+
+
+/**
+ * @brief Reads the file a chunk at a time, decoded, for as long as the ring has room for a whole
+ * chunk, and feeds the analyser. A short read ends the playback there, as if the file ended.
+ *
+ * The analyser's lag is what sits in the ring, plus the device's buffer.
+ **/
+void LAudioPlayer::Fill_Pvt( void )
+{
+  const size_t FrameBytes = BytesPerFrame( m_Spec );
+
+  // The size is an upper bound on this side, so the room is never overestimated
+  while ( !m_IsEndOfFile.load( std::memory_order_relaxed )
+          && m_Ring_Ptr->GetCapacity() - m_Ring_Ptr->GetSize() >= m_ChunkBytes )
+  {
+    Uint8*       Raw_Ptr = ( m_Encoding == LWavEncoding::FLOAT_32 ) ? m_Chunk.data() : m_Raw.data();
+    const size_t Wanted  = static_cast<size_t>( std::min<Uint64>( m_RawBytes, m_DataBytes ) );
+    const size_t Read    = ( Wanted != 0 ) ? SDL_RWread( m_File_Ptr, Raw_Ptr, 1, Wanted ) : 0;
+    const size_t Bytes   = Decode_Pvt( Read );
+
+    m_Ring_Ptr->pushBatch( m_Chunk.data(), Bytes );
+    m_DataBytes -= Read;
+
+    if ( m_Analyser_Ptr != nullptr )
+    {
+      m_Analyser_Ptr->feed( reinterpret_cast<const float*>( m_Chunk.data() ), Bytes / FrameBytes, m_Spec.channels );
+    }
+    else
+    {;}
+
+    if ( Read != Wanted || m_DataBytes == 0 )
+    {
+      // Publishes the last samples to the callback
+      m_IsEndOfFile.store( true, std::memory_order_release );
+    }
+    else
+    {;}
+  }
+
+  if ( m_Analyser_Ptr != nullptr )
+  {
+    m_Analyser_Ptr->setLag( m_Ring_Ptr->GetSize() / FrameBytes + m_Spec.samples );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Decodes what was read from the file into the chunk, as 32-bit float.
+ *
+ * @return Bytes in the chunk: whole frames.
+ **/
+size_t LAudioPlayer::Decode_Pvt( size_t Read )
+{
+  const size_t Channels    = m_Spec.channels;
+  float*       Samples_Ptr = reinterpret_cast<float*>( m_Chunk.data() );
+
+  switch ( m_Encoding )
+  {
+    case LWavEncoding::PCM_16:
+    {
+      const size_t Samples = Read / ( 2 * Channels ) * Channels;
+
+      for ( size_t i = 0; i != Samples; ++i )
+      {
+        const Sint16 Sample = static_cast<Sint16>( m_Raw[2 * i] | ( m_Raw[2 * i + 1] << 8 ) );
+
+        Samples_Ptr[i] = static_cast<float>( Sample ) / 32768.f;
+      }
+
+      return Samples * sizeof(float);
+    }
+
+    case LWavEncoding::IMA_ADPCM:
+    {
+      size_t Frames = 0;
+
+      for ( size_t Start = 0; Start < Read; Start += m_BlockAlign )
+      {
+        const size_t Decoded = DecodeImaBlock( m_Raw.data() + Start, std::min( static_cast<size_t>( m_BlockAlign ), Read - Start ),
+                                               m_Spec.channels, m_Pcm.data() );
+
+        for ( size_t i = 0; i != Decoded * Channels; ++i )
+        {
+          Samples_Ptr[Frames * Channels + i] = static_cast<float>( m_Pcm[i] ) / 32768.f;
+        }
+
+        Frames += Decoded;
+      }
+
+      return Frames * BytesPerFrame( m_Spec );
+    }
+
+    case LWavEncoding::FLOAT_32:
+    default:
+      return Read - Read % BytesPerFrame( m_Spec );
+  }
+}
@@ -0,0 +1,162 @@
+/**
+ * @file LAudioStream.hpp
+ *
+ * @brief Recording to and playing from WAV files of any length, streamed through a ring buffer.
+ **/
+
+#ifndef LAUDIOSTREAM_HPP
+#define LAUDIOSTREAM_HPP
+
+#include "LAudioAnalyser.hpp"
+#include "LImaAdpcm.hpp"
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How LAudioRecorder stores the samples: as the callback captures them, 32-bit float, or in
+ * an encoding that takes less room, applied by the writer thread.
+ **/
+enum class LWavEncoding
+{
+  FLOAT_32,   // 4 bytes a sample, as captured
+  PCM_16,     // 2 bytes a sample: lossless for a 16-bit input, as most are
+  IMA_ADPCM   // 4 bits a sample, lossy: an eighth of FLOAT_32
+};
+
+
+/**
+ * @brief Records from a capture device into a WAV file, little-endian. The audio callback only
+ * copies the captured samples, 32-bit float, into a lock-free ring, and never waits: if the ring is
+ * full, the samples are dropped and counted, whole frames at a time. A writer thread empties the
+ * ring, encodes the samples as asked by "start" and writes the file in large chunks; the header gets
+ * its sizes when the recording stops. It also feeds an LAudioAnalyser, if given one.
+ *
+ * The ring holds about s_RING_SECONDS of audio, the time the disk or the encoder may stall for
+ * without losing anything: memory stays the same however long the recording is. Encoding a chunk
+ * takes a small fraction of the time it lasts, so it does not make the ring fill up.
+ *
+ * "start", "stop" and the rest are called from one thread.
+ **/
+class LAudioRecorder
+{
+public:
+
+  static constexpr int    s_DEFAULT_FREQUENCY = 44100;
+  static constexpr int    s_DEFAULT_FRAMES    = 4096;
+  static constexpr double s_RING_SECONDS      = 1.0;
+  static constexpr size_t s_CHUNK_BYTES       = 64 * 1024; // Written at once, before encoding
+  static constexpr size_t s_IMA_BLOCK_BYTES   = 512;       // Per channel
+
+  LAudioRecorder( void );
+  ~LAudioRecorder( void );
+
+  LAudioRecorder( const LAudioRecorder& )            = delete;
+  LAudioRecorder& operator=( const LAudioRecorder& ) = delete;
+
+  bool                 open       ( const char*, int = s_DEFAULT_FREQUENCY, int = 2, int = s_DEFAULT_FRAMES );
+  void                 close      ( void );
+  bool                 start      ( const std::string&, LWavEncoding = LWavEncoding::FLOAT_32 );
+  bool                 stop       ( void );
+  void                 setAnalyser( LAudioAnalyser* );
+
+  bool                 IsOpen     ( void ) const;
+  bool                 IsRecording( void ) const;
+  double               GetSeconds ( void ) const;
+  Uint64               GetDropped ( void ) const;
+  Uint64               GetFileBytes( void ) const;
+  const SDL_AudioSpec& GetSpec    ( void ) const;
+
+private:
+
+  static void SDLCALL Callback_Pvt( void*, Uint8*, int );
+  static int  SDLCALL Writer_Pvt  ( void* );
+
+  void Encode_Pvt( size_t, bool );
+  void Write_Pvt ( const Uint8*, size_t );
+  void Drain_Pvt ( void );
+
+  std::unique_ptr< LSpscRing<Uint8> > m_Ring_Ptr;    // Callback to writer
+  std::vector<Uint8>                  m_Chunk;       // Writer only
+  size_t                              m_ChunkBytes;  // s_CHUNK_BYTES, in whole frames
+  LWavEncoding                        m_Encoding;
+  std::vector<Uint8>                  m_Encoded;     // Writer only
+  std::vector<Sint16>                 m_Pcm;         // Writer only: frames waiting for a whole ADPCM block
+  size_t                              m_PcmFrames;
+  int                                 m_ImaIndex[IMA_MAX_CHANNELS]; // Carried from block to block
+  Uint64                              m_Frames;      // Encoded; writer only until joined
+  LAudioAnalyser*                     m_Analyser_Ptr;
+  SDL_AudioDeviceID                   m_Device;
+  SDL_AudioSpec                       m_Spec;
+  SDL_RWops*                          m_File_Ptr;
+  SDL_Thread*                         m_Writer_Ptr;
+  Uint64                              m_DataBytes;   // Written to the file; writer only until joined
+  bool                                m_HasFailed;   // A write fell short; writer only until joined
+  std::atomic<bool>                   m_IsStopping;
+  std::atomic<Uint64>                 m_Written;     // m_DataBytes, for the other threads
+  std::atomic<Uint64>                 m_Captured;    // Bytes given by the device, written by the callback
+  std::atomic<Uint64>                 m_Dropped;     // Bytes that found the ring full
+};
+
+
+/**
+ * @brief Plays a WAV file, in any of the encodings LAudioRecorder writes, from disk. A reader thread
+ * decodes it to 32-bit float and keeps a lock-free ring filled a chunk at a time; the audio callback
+ * only copies out of it, and plays silence if the reader lags behind. The reader also feeds an
+ * LAudioAnalyser, if given one, and keeps its lag to what is in the ring and in the device's buffer.
+ **/
+class LAudioPlayer
+{
+public:
+
+  static constexpr int    s_DEFAULT_FRAMES = 4096;
+  static constexpr double s_RING_SECONDS   = 1.0;
+  static constexpr size_t s_CHUNK_BYTES    = 64 * 1024; // Read at once
+
+  LAudioPlayer( void );
+  ~LAudioPlayer( void );
+
+  LAudioPlayer( const LAudioPlayer& )            = delete;
+  LAudioPlayer& operator=( const LAudioPlayer& ) = delete;
+
+  bool   start       ( const std::string&, int = s_DEFAULT_FRAMES );
+  void   stop        ( void );
+  void   setAnalyser ( LAudioAnalyser* );
+
+  bool   IsPlaying   ( void ) const;
+  bool   IsFinished  ( void ) const;
+  Uint64 GetUnderruns( void ) const;
+
+private:
+
+  static void SDLCALL Callback_Pvt( void*, Uint8*, int );
+  static int  SDLCALL Reader_Pvt  ( void* );
+
+  void   Fill_Pvt  ( void );
+  size_t Decode_Pvt( size_t );
+
+  std::unique_ptr< LSpscRing<Uint8> > m_Ring_Ptr;    // Reader to callback
+  std::vector<Uint8>                  m_Chunk;       // Reader only: decoded
+  size_t                              m_ChunkBytes;  // s_CHUNK_BYTES, in whole frames
+  LWavEncoding                        m_Encoding;
+  Uint16                              m_BlockAlign;
+  std::vector<Uint8>                  m_Raw;         // Reader only: as in the file, when encoded
+  size_t                              m_RawBytes;    // Read at once: decodes to m_ChunkBytes at most
+  std::vector<Sint16>                 m_Pcm;         // Reader only: an ADPCM block decoded
+  LAudioAnalyser*                     m_Analyser_Ptr;
+  SDL_AudioDeviceID                   m_Device;
+  SDL_AudioSpec                       m_Spec;
+  SDL_RWops*                          m_File_Ptr;
+  SDL_Thread*                         m_Reader_Ptr;
+  Uint64                              m_DataBytes;   // Left to read; reader only
+  std::atomic<bool>                   m_IsStopping;
+  std::atomic<bool>                   m_IsEndOfFile; // Everything is in the ring; the reader stays to keep the lag
+  std::atomic<bool>                   m_IsFinished;  // And played
+  std::atomic<Uint64>                 m_Underruns;   // Callbacks that found the ring short
+};
+
+#endif // LAUDIOSTREAM_HPP
@@ -0,0 +1,193 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LAutosave.hpp"
+#include "LTrace.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LAutosave::LAutosave( void )
+  : m_Snapshots(), m_Path(), m_SchemaVersion(0), m_Interval_ms(0), m_LastSubmit_ms(0), m_Saver_Ptr(nullptr),
+    m_Wake_Ptr(nullptr), m_IsStopping(false), m_Saves(0), m_Failures(0), m_LastSave_ms(0)
+{;}
+
+
+LAutosave::~LAutosave( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Starts the saver thread.
+ *
+ * @param Path The save file, replaced by every commit.
+ * @param SchemaVersion Handed to LSaveWriter::commit.
+ * @param Interval_ms The least time between two snapshots, as told by IsDue.
+ * @return true if running.
+ **/
+bool LAutosave::start( const std::string& Path, Uint32 SchemaVersion, Uint32 Interval_ms )
+{
+  stop();
+
+  m_Path          = Path;
+  m_SchemaVersion = SchemaVersion;
+  m_Interval_ms   = Interval_ms;
+  m_LastSubmit_ms = SDL_GetTicks64();
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_Wake_Ptr      = SDL_CreateSemaphore( 0 );
+
+  if ( m_Wake_Ptr != nullptr )
+  {
+    m_Saver_Ptr = SDL_CreateThread( Saver_Pvt, "LAutosave", this );
+  }
+  else
+  {;}
+
+  if ( m_Saver_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the autosave thread! SDL Error: %s", SDL_GetError() );
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Saves the last snapshot submitted, if it has not been saved yet, and stops the thread.
+ **/
+void LAutosave::stop( void )
+{
+  if ( m_Saver_Ptr != nullptr )
+  {
+    m_IsStopping.store( true, std::memory_order_release );
+    SDL_SemPost( m_Wake_Ptr );
+    SDL_WaitThread( m_Saver_Ptr, nullptr );
+    m_Saver_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  if ( m_Wake_Ptr != nullptr )
+  {
+    SDL_DestroySemaphore( m_Wake_Ptr );
+    m_Wake_Ptr = nullptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @return true once the interval has passed since the last submit.
+ **/
+bool LAutosave::IsDue( void ) const
+{
+  return SDL_GetTicks64() - m_LastSubmit_ms >= m_Interval_ms;
+}
+
+
+/**
+ * @brief The buffer to write the next snapshot into, emptied; its memory is kept from snapshot to
+ * snapshot, so that writing the same state again does not allocate.
+ **/
+LSaveWriter& LAutosave::GetSnapshot( void )
+{
+  LSaveWriter& Snapshot = m_Snapshots.GetBack();
+
+  Snapshot.clear();
+
+  return Snapshot;
+}
+
+
+/**
+ * @brief Hands the snapshot to the saver thread, and takes the next buffer. Never waits.
+ **/
+void LAutosave::submit( void )
+{
+  m_Snapshots.publish();
+  m_LastSubmit_ms = SDL_GetTicks64();
+
+  if ( m_Wake_Ptr != nullptr )
+  {
+    SDL_SemPost( m_Wake_Ptr );
+  }
+  else
+  {;}
+}
+
+
+bool LAutosave::IsRunning( void ) const
+{
+  return m_Saver_Ptr != nullptr;
+}
+
+
+Uint32 LAutosave::GetSaves( void ) const
+{
+  return m_Saves.load( std::memory_order_relaxed );
+}
+
+
+Uint32 LAutosave::GetFailures( void ) const
+{
+  return m_Failures.load( std::memory_order_relaxed );
+}
+
+
+Uint32 LAutosave::GetLastSave_ms( void ) const
+{
+  return m_LastSave_ms.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Sleeps until woken, then commits the newest snapshot, if there is one not saved yet. The
+ * stop is read before the snapshot: once it is seen, the last snapshot submitted is seen as well.
+ **/
+int SDLCALL LAutosave::Saver_Pvt( void* Autosave_Ptr )
+{
+  LAutosave& Self       = *static_cast<LAutosave*>( Autosave_Ptr );
+  bool       IsStopping = false;
+
+  LTrace::nameThread( "LAutosave" );
+
+  while ( !IsStopping )
+  {
+    SDL_SemWait( Self.m_Wake_Ptr );
+
+    IsStopping = Self.m_IsStopping.load( std::memory_order_acquire );
+
+    if ( Self.m_Snapshots.acquire() )
+    {
+      LTrace::Zone Traced( "Autosave" );
+      const Uint64 Start_ms = SDL_GetTicks64();
+
+      if ( Self.m_Snapshots.GetFront().commit( Self.m_Path, Self.m_SchemaVersion ) )
+      {
+        Self.m_Saves.fetch_add( 1, std::memory_order_relaxed );
+      }
+      else
+      {
+        Self.m_Failures.fetch_add( 1, std::memory_order_relaxed );
+      }
+
+      Self.m_LastSave_ms.store( static_cast<Uint32>( SDL_GetTicks64() - Start_ms ), std::memory_order_relaxed );
+    }
+    else
+    {;} // Woken by a submit whose snapshot was saved along with an earlier one
+  }
+
+  return 0;
+}
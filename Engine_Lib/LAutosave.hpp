@@ -0,0 +1,69 @@
+/**
+ * @file LAutosave.hpp
+ *
+ * @brief Saves snapshots of a program's state at intervals, on a thread of its own.
+ **/
+
+#ifndef LAUTOSAVE_HPP
+#define LAUTOSAVE_HPP
+
+#include "LSaveFile.hpp"
+#include "LTripleBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <string>
+
+/**
+ * @brief The main thread writes a snapshot of its state into GetSnapshot, a buffer of its own, and
+ * submits it: that is a copy in memory and an atomic exchange, never a wait. The saver thread then
+ * commits the latest snapshot submitted with LSaveWriter, while the main thread goes on. Snapshots
+ * submitted while the disk is busy replace each other: only the newest is saved.
+ *
+ * "IsDue" tells when the interval has passed since the last submit, so that a program that changes
+ * its state every frame snapshots it only that often. "stop" saves the last snapshot submitted, if
+ * it was not saved yet, and waits for it: at exit only the changes since the last autosave are left
+ * to write.
+ *
+ * start, stop, IsDue, GetSnapshot and submit are called from one thread.
+ **/
+class LAutosave
+{
+public:
+
+  LAutosave( void );
+  ~LAutosave( void );
+
+  LAutosave( const LAutosave& )            = delete;
+  LAutosave& operator=( const LAutosave& ) = delete;
+
+  bool         start          ( const std::string&, Uint32, Uint32 );
+  void         stop           ( void );
+
+  bool         IsDue          ( void ) const;
+  LSaveWriter& GetSnapshot    ( void );
+  void         submit         ( void );
+
+  bool         IsRunning      ( void ) const;
+  Uint32       GetSaves       ( void ) const;
+  Uint32       GetFailures    ( void ) const;
+  Uint32       GetLastSave_ms ( void ) const;
+
+private:
+
+  static int SDLCALL Saver_Pvt( void* );
+
+  LTripleBuffer<LSaveWriter> m_Snapshots;       // Main thread to saver
+  std::string                m_Path;
+  Uint32                     m_SchemaVersion;
+  Uint32                     m_Interval_ms;
+  Uint64                     m_LastSubmit_ms;
+  SDL_Thread*                m_Saver_Ptr;
+  SDL_sem*                   m_Wake_Ptr;        // Posted on every submit, and by stop
+  std::atomic<bool>          m_IsStopping;
+  std::atomic<Uint32>        m_Saves;
+  std::atomic<Uint32>        m_Failures;
+  std::atomic<Uint32>        m_LastSave_ms;     // How long the last commit took
+};
+
+#endif // LAUTOSAVE_HPP
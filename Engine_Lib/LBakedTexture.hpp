@@ -0,0 +1,78 @@
+/**
+ * @file LBakedTexture.hpp
+ *
+ * @brief Layout of the baked texture files (".ltx", and ".ltc" for the block compressed ones),
+ * written offline by the BakeTextures tool and read by LTexture::loadFromBaked and the GL renderers.
+ **/
+
+#ifndef LBAKEDTEXTURE_HPP
+#define LBAKEDTEXTURE_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief A baked file is this header followed by Height rows of Pitch bytes, already in the pixel
+ * format stored in the header and with the colour key already turned into transparency: the loader
+ * hands the mapped rows straight to SDL_UpdateTexture.
+ *
+ * When Levels is above 1, the rows of the smaller levels of the mip chain follow, each level half
+ * the size of the previous one (at least 1 pixel a side, see HalvePixels) and tightly packed too:
+ * LBakedMipSize gives their sizes. Version 1 files, without Levels, are no longer read: bake them
+ * again.
+ *
+ * Fields are stored in the byte order of the machine that baked the file; the loader rejects files
+ * whose magic does not match, so a file baked on a big-endian machine is simply not used.
+ **/
+struct LBakedTextureHeader
+{
+  char   Magic[4]; // LBAKED_TEXTURE_MAGIC
+  Uint32 Version;  // LBAKED_TEXTURE_VERSION
+  Uint32 Format;   // SDL_PIXELFORMAT_*; 32 bits per pixel
+  Sint32 Width;
+  Sint32 Height;
+  Sint32 Pitch;    // Bytes per row; Width * 4, rows are tightly packed
+  Uint32 Levels;   // Of the mip chain, the full size included: 1 to LBAKED_TEXTURE_MAX_LEVELS
+  Uint32 Reserved; // 0
+};
+
+static constexpr char   LBAKED_TEXTURE_MAGIC[4]   = { 'L', 'T', 'X', 'B' };
+static constexpr Uint32 LBAKED_TEXTURE_VERSION    = 2;
+static constexpr Uint32 LBAKED_TEXTURE_MAX_LEVELS = 8;
+static constexpr char   LBAKED_TEXTURE_EXTENSION[] = ".ltx";
+
+static_assert( sizeof(LBakedTextureHeader) == 32, "The baked header must have no padding" );
+
+
+/**
+ * @brief Size of a level of the mip chain of a Width x Height image; level 0 is the image.
+ **/
+inline SDL_Point LBakedMipSize( int Width, int Height, int Level )
+{
+  return SDL_Point{ SDL_max( Width >> Level, 1 ), SDL_max( Height >> Level, 1 ) };
+}
+
+
+/**
+ * @brief A block compressed file (".ltc", next to the ".ltx" of the same image) is this header
+ * followed by the blocks of each level of the mip chain, from the full size down, each level
+ * GetCompressedSize( Format, Width, Height ) bytes for its LBakedMipSize. The blocks are uploaded
+ * as they are with glCompressedTexImage2D, by renderers that sample Format; the others use the
+ * ".ltx". Byte order as in LBakedTextureHeader.
+ **/
+struct LBakedBlocksHeader
+{
+  char   Magic[4]; // LBAKED_BLOCKS_MAGIC
+  Uint32 Version;  // LBAKED_BLOCKS_VERSION
+  Uint32 Format;   // LBlockFormat
+  Sint32 Width;
+  Sint32 Height;
+  Uint32 Levels;   // 1 to LBAKED_TEXTURE_MAX_LEVELS
+};
+
+static constexpr char   LBAKED_BLOCKS_MAGIC[4]    = { 'L', 'T', 'C', 'B' };
+static constexpr Uint32 LBAKED_BLOCKS_VERSION     = 1;
+static constexpr char   LBAKED_BLOCKS_EXTENSION[] = ".ltc";
+
+static_assert( sizeof(LBakedBlocksHeader) == 24, "The blocks header must have no padding" );
+
+#endif // LBAKEDTEXTURE_HPP
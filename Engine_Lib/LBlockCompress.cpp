@@ -0,0 +1,776 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LBlockCompress.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr int BLOCK_SIDE    = 4;     // Texels
+static constexpr int BLOCK_TEXELS  = BLOCK_SIDE * BLOCK_SIDE;
+static constexpr int AXIS_PASSES   = 8;     // Power iterations for the principal axis of a block
+
+// ETC1 / ETC2 intensity modifiers, one row per table; the column is the texel's index, whose high
+// bit is the sign
+static const int ETC_MODIFIERS[8][4] =
+{
+  {  2,   8,  -2,   -8 }, {  5,  17,  -5,  -17 }, {  9,  29,  -9,  -29 }, { 13,  42, -13,  -42 },
+  { 18,  60, -18,  -60 }, { 24,  80, -24,  -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 },
+};
+
+// EAC alpha modifiers, one row per table, multiplied by the block's multiplier
+static const int EAC_MODIFIERS[16][8] =
+{
+  { -3, -6,  -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+  { -2, -5,  -8, -13, 1, 4, 7, 12 }, { -2, -4,  -6, -13, 1, 3, 5, 12 },
+  { -3, -6,  -8, -12, 2, 5, 7, 11 }, { -3, -7,  -9, -11, 2, 6, 8, 10 },
+  { -4, -7,  -8, -11, 3, 6, 7, 10 }, { -3, -5,  -8, -11, 2, 4, 7, 10 },
+  { -2, -6,  -8, -10, 1, 5, 7,  9 }, { -2, -5,  -8, -10, 1, 4, 7,  9 },
+  { -2, -4,  -8, -10, 1, 3, 7,  9 }, { -2, -5,  -7, -10, 1, 4, 6,  9 },
+  { -3, -4,  -7, -10, 2, 3, 6,  9 }, { -1, -2,  -3, -10, 0, 1, 2,  9 },
+  { -4, -6,  -8,  -9, 3, 5, 7,  8 }, { -3, -5,  -7,  -9, 2, 4, 6,  8 },
+};
+
+static constexpr int EAC_FLAT_TABLE = 13;   // Has a modifier of 0, at index 4
+static constexpr int EAC_FLAT_INDEX = 4;
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+// The texels of a block, rows from the top: Texels[ y * BLOCK_SIDE + x ] is R, G, B, A
+typedef Uint8 BlockTexels[BLOCK_TEXELS][4];
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static int clampByte( int Value )
+{
+  return std::min( std::max( Value, 0 ), 255 );
+}
+
+
+static int squaredDistance( const int* Colour, const Uint8* Texel )
+{
+  const int R = Colour[0] - Texel[0];
+  const int G = Colour[1] - Texel[1];
+  const int B = Colour[2] - Texel[2];
+
+  return R * R + G * G + B * B;
+}
+
+
+/**
+ * @brief Copies the texels of a block; those past the edges of the image repeat its last row or
+ * column.
+ **/
+static void loadBlock( const Uint8* Pixels_Ptr, int Width, int Height, int Pitch, int BlockX, int BlockY, BlockTexels& Texels )
+{
+  for ( int y = 0; y != BLOCK_SIDE; ++y )
+  {
+    const int    Row     = std::min( BlockY * BLOCK_SIDE + y, Height - 1 );
+    const Uint8* Row_Ptr = Pixels_Ptr + static_cast<ptrdiff_t>( Row ) * Pitch;
+
+    for ( int x = 0; x != BLOCK_SIDE; ++x )
+    {
+      const Uint8* Texel_Ptr = Row_Ptr + std::min( BlockX * BLOCK_SIDE + x, Width - 1 ) * 4;
+
+      std::copy( Texel_Ptr, Texel_Ptr + 4, Texels[ y * BLOCK_SIDE + x ] );
+    }
+  }
+}
+
+
+static Uint16 pack565( const float* Colour )
+{
+  const int R = clampByte( static_cast<int>( std::lround( Colour[0] ) ) );
+  const int G = clampByte( static_cast<int>( std::lround( Colour[1] ) ) );
+  const int B = clampByte( static_cast<int>( std::lround( Colour[2] ) ) );
+
+  return static_cast<Uint16>( ( ( R * 31 + 127 ) / 255 ) << 11 | ( ( G * 63 + 127 ) / 255 ) << 5 | ( ( B * 31 + 127 ) / 255 ) );
+}
+
+
+static void unpack565( Uint16 Packed, int* Colour )
+{
+  const int R = ( Packed >> 11 ) & 0x1F;
+  const int G = ( Packed >> 5 ) & 0x3F;
+  const int B = Packed & 0x1F;
+
+  Colour[0] = ( R << 3 ) | ( R >> 2 );
+  Colour[1] = ( G << 2 ) | ( G >> 4 );
+  Colour[2] = ( B << 3 ) | ( B >> 2 );
+}
+
+
+/**
+ * @brief A BC1 colour block: the two end colours are the extremes of the block's texels along their
+ * principal axis, and every texel takes the nearest of the colours between them.
+ *
+ * @param PunchThrough BC1 with alpha: texels with alpha under 128 become transparent, and the block
+ * uses the three colour mode if it has any. Otherwise (BC3's colour) always four colours, and only
+ * the fully transparent texels are left out of the fit.
+ **/
+static void encodeBC1( const BlockTexels& Texels, bool PunchThrough, Uint8* Out_Ptr )
+{
+  const int AlphaLimit = PunchThrough ? 128 : 1;
+  bool      IsFitted[BLOCK_TEXELS];
+  int       Fitted          = 0;
+  bool      HasTransparent  = false;
+  float     Mean[3]         = { 0.f, 0.f, 0.f };
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    IsFitted[i]     = Texels[i][3] >= AlphaLimit;
+    HasTransparent |= PunchThrough && !IsFitted[i];
+
+    if ( IsFitted[i] )
+    {
+      for ( int c = 0; c != 3; ++c )
+      {
+        Mean[c] += Texels[i][c];
+      }
+
+      ++Fitted;
+    }
+    else
+    {;}
+  }
+
+  // A block transparent throughout: fit its colours all the same, as nothing will show them
+  if ( Fitted == 0 )
+  {
+    std::fill( IsFitted, IsFitted + BLOCK_TEXELS, true );
+    Fitted = BLOCK_TEXELS;
+
+    for ( int i = 0; i != BLOCK_TEXELS; ++i )
+    {
+      for ( int c = 0; c != 3; ++c )
+      {
+        Mean[c] += Texels[i][c];
+      }
+    }
+  }
+  else
+  {;}
+
+  for ( float& Channel : Mean )
+  {
+    Channel /= static_cast<float>( Fitted );
+  }
+
+  float Covariance[3][3] = {};
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    if ( IsFitted[i] )
+    {
+      for ( int Row = 0; Row != 3; ++Row )
+      {
+        for ( int Column = 0; Column != 3; ++Column )
+        {
+          Covariance[Row][Column] += ( Texels[i][Row] - Mean[Row] ) * ( Texels[i][Column] - Mean[Column] );
+        }
+      }
+    }
+    else
+    {;}
+  }
+
+  // Principal axis by power iteration, from the grey diagonal
+  float Axis[3] = { 1.f, 1.f, 1.f };
+
+  for ( int Pass = 0; Pass != AXIS_PASSES; ++Pass )
+  {
+    float Next[3] = { 0.f, 0.f, 0.f };
+
+    for ( int Row = 0; Row != 3; ++Row )
+    {
+      for ( int Column = 0; Column != 3; ++Column )
+      {
+        Next[Row] += Covariance[Row][Column] * Axis[Column];
+      }
+    }
+
+    const float Length = std::max( std::fabs( Next[0] ), std::max( std::fabs( Next[1] ), std::fabs( Next[2] ) ) );
+
+    if ( Length < 1e-6f )
+    {
+      break; // A single colour: any axis does
+    }
+    else
+    {;}
+
+    for ( int c = 0; c != 3; ++c )
+    {
+      Axis[c] = Next[c] / Length;
+    }
+  }
+
+  const float AxisLength2 = Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2];
+  float       Lowest      = 0.f;
+  float       Highest     = 0.f;
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    if ( IsFitted[i] )
+    {
+      const float Projection = ( ( Texels[i][0] - Mean[0] ) * Axis[0] + ( Texels[i][1] - Mean[1] ) * Axis[1]
+                                 + ( Texels[i][2] - Mean[2] ) * Axis[2] ) / AxisLength2;
+
+      Lowest  = std::min( Lowest, Projection );
+      Highest = std::max( Highest, Projection );
+    }
+    else
+    {;}
+  }
+
+  float Low[3];
+  float High[3];
+
+  for ( int c = 0; c != 3; ++c )
+  {
+    Low[c]  = Mean[c] + Axis[c] * Lowest;
+    High[c] = Mean[c] + Axis[c] * Highest;
+  }
+
+  Uint16 First  = pack565( High );
+  Uint16 Second = pack565( Low );
+
+  // The order of the end colours picks the mode: first above second for four colours
+  if ( HasTransparent ? First > Second : First < Second )
+  {
+    std::swap( First, Second );
+  }
+  else
+  {;}
+
+  int Palette[4][3];
+
+  unpack565( First, Palette[0] );
+  unpack565( Second, Palette[1] );
+
+  const bool IsFourColours = !HasTransparent && First != Second;
+  const int  Colours       = IsFourColours ? 4 : 3;
+
+  for ( int c = 0; c != 3; ++c )
+  {
+    if ( IsFourColours )
+    {
+      Palette[2][c] = ( 2 * Palette[0][c] + Palette[1][c] ) / 3;
+      Palette[3][c] = ( Palette[0][c] + 2 * Palette[1][c] ) / 3;
+    }
+    else
+    {
+      Palette[2][c] = ( Palette[0][c] + Palette[1][c] ) / 2;
+      Palette[3][c] = 0;
+    }
+  }
+
+  Uint32 Indices = 0;
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    Uint32 Best = 3; // Transparent, in the three colour mode
+
+    if ( !HasTransparent || Texels[i][3] >= 128 )
+    {
+      int BestDistance = INT_MAX;
+
+      for ( int Index = 0; Index != Colours; ++Index )
+      {
+        const int Distance = squaredDistance( Palette[Index], Texels[i] );
+
+        if ( Distance < BestDistance )
+        {
+          BestDistance = Distance;
+          Best         = static_cast<Uint32>( Index );
+        }
+        else
+        {;}
+      }
+    }
+    else
+    {;}
+
+    Indices |= Best << ( 2 * i );
+  }
+
+  Out_Ptr[0] = static_cast<Uint8>( First );
+  Out_Ptr[1] = static_cast<Uint8>( First >> 8 );
+  Out_Ptr[2] = static_cast<Uint8>( Second );
+  Out_Ptr[3] = static_cast<Uint8>( Second >> 8 );
+
+  for ( int Byte = 0; Byte != 4; ++Byte )
+  {
+    Out_Ptr[4 + Byte] = static_cast<Uint8>( Indices >> ( 8 * Byte ) );
+  }
+}
+
+
+/**
+ * @brief A BC3 alpha block: the lowest and highest alpha of the block, and six values between them.
+ **/
+static void encodeBC3Alpha( const BlockTexels& Texels, Uint8* Out_Ptr )
+{
+  int Lowest  = 255;
+  int Highest = 0;
+
+  for ( const Uint8* Texel : Texels )
+  {
+    Lowest  = std::min( Lowest, static_cast<int>( Texel[3] ) );
+    Highest = std::max( Highest, static_cast<int>( Texel[3] ) );
+  }
+
+  // First above second: eight values; equal ones decode as the first for index 0
+  int Palette[8] = { Highest, Lowest };
+
+  for ( int Index = 2; Index != 8; ++Index )
+  {
+    Palette[Index] = ( ( 8 - Index ) * Highest + ( Index - 1 ) * Lowest ) / 7;
+  }
+
+  Uint64 Indices = 0;
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    Uint64 Best         = 0;
+    int    BestDistance = INT_MAX;
+
+    for ( int Index = 0; Index != ( Highest > Lowest ? 8 : 1 ); ++Index )
+    {
+      const int Distance = std::abs( Palette[Index] - Texels[i][3] );
+
+      if ( Distance < BestDistance )
+      {
+        BestDistance = Distance;
+        Best         = static_cast<Uint64>( Index );
+      }
+      else
+      {;}
+    }
+
+    Indices |= Best << ( 3 * i );
+  }
+
+  Out_Ptr[0] = static_cast<Uint8>( Highest );
+  Out_Ptr[1] = static_cast<Uint8>( Lowest );
+
+  for ( int Byte = 0; Byte != 6; ++Byte )
+  {
+    Out_Ptr[2 + Byte] = static_cast<Uint8>( Indices >> ( 8 * Byte ) );
+  }
+}
+
+
+/**
+ * @brief Best ETC modifier table for a half block of the given base colour.
+ *
+ * @param Half      Whether each texel of the block is in this half.
+ * @param Weights   0 for the texels whose colour does not matter (transparent), else 1.
+ * @param Table     The table chosen.
+ * @param Indices   The index of each texel of the half, for that table.
+ * @return the squared error of the half with that table.
+ **/
+static int fitEtcHalf( const BlockTexels& Texels, const bool* Half, const int* Weights, const int* Base, int& Table, int* Indices )
+{
+  int BestError = INT_MAX;
+
+  for ( int Candidate = 0; Candidate != 8; ++Candidate )
+  {
+    int Error = 0;
+    int CandidateIndices[BLOCK_TEXELS];
+
+    for ( int i = 0; i != BLOCK_TEXELS && Error < BestError; ++i )
+    {
+      if ( Half[i] )
+      {
+        int BestDistance = INT_MAX;
+
+        for ( int Index = 0; Index != 4; ++Index )
+        {
+          const int Modifier    = ETC_MODIFIERS[Candidate][Index];
+          const int Colour[3]   = { clampByte( Base[0] + Modifier ), clampByte( Base[1] + Modifier ), clampByte( Base[2] + Modifier ) };
+          const int Distance    = squaredDistance( Colour, Texels[i] );
+
+          if ( Distance < BestDistance )
+          {
+            BestDistance        = Distance;
+            CandidateIndices[i] = Index;
+          }
+          else
+          {;}
+        }
+
+        Error += BestDistance * Weights[i];
+      }
+      else
+      {;}
+    }
+
+    if ( Error < BestError )
+    {
+      BestError = Error;
+      Table     = Candidate;
+
+      for ( int i = 0; i != BLOCK_TEXELS; ++i )
+      {
+        Indices[i] = Half[i] ? CandidateIndices[i] : Indices[i];
+      }
+    }
+    else
+    {;}
+  }
+
+  return BestError;
+}
+
+
+/**
+ * @brief An ETC2 colour block, in the individual or the differential mode of ETC1: the block is
+ * split in two halves, side by side or one above the other, each with a base colour, the average of
+ * its texels, and a table of intensity modifiers. Every split and mode is tried, and the one with the
+ * smallest error kept.
+ *
+ * @param HasAlpha Whether the fully transparent texels can be left out of the fit.
+ **/
+static void encodeETC( const BlockTexels& Texels, bool HasAlpha, Uint8* Out_Ptr )
+{
+  int Weights[BLOCK_TEXELS];
+  int Visible = 0;
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    Weights[i] = ( !HasAlpha || Texels[i][3] != 0 ) ? 1 : 0;
+    Visible   += Weights[i];
+  }
+
+  if ( Visible == 0 )
+  {
+    std::fill( Weights, Weights + BLOCK_TEXELS, 1 );
+  }
+  else
+  {;}
+
+  Uint32 BestHigh  = 0;
+  Uint32 BestLow   = 0;
+  int    BestError = INT_MAX;
+
+  for ( Uint32 Flip = 0; Flip != 2; ++Flip )
+  {
+    // Half 0 is the left (no flip) or top (flip) two columns or rows of texels
+    bool  Halves[2][BLOCK_TEXELS];
+    float Average[2][3] = {};
+
+    for ( int i = 0; i != BLOCK_TEXELS; ++i )
+    {
+      const int  x      = i % BLOCK_SIDE;
+      const int  y      = i / BLOCK_SIDE;
+      const bool IsLast = ( Flip != 0 ) ? y >= 2 : x >= 2;
+
+      Halves[0][i] = !IsLast;
+      Halves[1][i] = IsLast;
+    }
+
+    for ( int Half = 0; Half != 2; ++Half )
+    {
+      int Weight = 0;
+
+      for ( int i = 0; i != BLOCK_TEXELS; ++i )
+      {
+        const int TexelWeight = Halves[Half][i] ? Weights[i] : 0;
+
+        for ( int c = 0; c != 3; ++c )
+        {
+          Average[Half][c] += static_cast<float>( Texels[i][c] * TexelWeight );
+        }
+
+        Weight += TexelWeight;
+      }
+
+      for ( int c = 0; c != 3; ++c )
+      {
+        Average[Half][c] = ( Weight != 0 ) ? Average[Half][c] / static_cast<float>( Weight ) : 0.f;
+      }
+    }
+
+    // Differential: 5 bits a channel, the second base within -4..3 of the first; individual: 4 bits
+    for ( int IsDifferential = 1; IsDifferential != -1; --IsDifferential )
+    {
+      const int Levels = IsDifferential ? 31 : 15;
+      int       Quantised[2][3];
+      int       Base[2][3];
+      bool      Fits = true;
+
+      for ( int Half = 0; Half != 2; ++Half )
+      {
+        for ( int c = 0; c != 3; ++c )
+        {
+          Quantised[Half][c] = static_cast<int>( std::lround( Average[Half][c] * static_cast<float>( Levels ) / 255.f ) );
+          Base[Half][c]      = IsDifferential ? ( Quantised[Half][c] << 3 ) | ( Quantised[Half][c] >> 2 ) : Quantised[Half][c] * 17;
+        }
+      }
+
+      for ( int c = 0; c != 3 && IsDifferential; ++c )
+      {
+        const int Delta = Quantised[1][c] - Quantised[0][c];
+
+        Fits = Fits && Delta >= -4 && Delta <= 3;
+      }
+
+      if ( !Fits )
+      {
+        continue;
+      }
+      else
+      {;}
+
+      int Tables[2]  = { 0, 0 };
+      int Indices[BLOCK_TEXELS] = {};
+      int Error      = fitEtcHalf( Texels, Halves[0], Weights, Base[0], Tables[0], Indices );
+
+      Error = ( Error < BestError ) ? Error + fitEtcHalf( Texels, Halves[1], Weights, Base[1], Tables[1], Indices ) : Error;
+
+      if ( Error >= BestError )
+      {
+        continue;
+      }
+      else
+      {;}
+
+      Uint32 High = static_cast<Uint32>( Tables[0] ) << 5 | static_cast<Uint32>( Tables[1] ) << 2
+                    | static_cast<Uint32>( IsDifferential ) << 1 | Flip;
+
+      for ( int c = 0; c != 3; ++c )
+      {
+        const Uint32 Shift = 24 - 8 * static_cast<Uint32>( c );
+
+        if ( IsDifferential )
+        {
+          High |= static_cast<Uint32>( Quantised[0][c] ) << ( Shift + 3 ) | ( static_cast<Uint32>( Quantised[1][c] - Quantised[0][c] ) & 7 ) << Shift;
+        }
+        else
+        {
+          High |= static_cast<Uint32>( Quantised[0][c] ) << ( Shift + 4 ) | static_cast<Uint32>( Quantised[1][c] ) << Shift;
+        }
+      }
+
+      // Texel indices by columns: bit x * 4 + y, high bits in the upper half
+      Uint32 Low = 0;
+
+      for ( int i = 0; i != BLOCK_TEXELS; ++i )
+      {
+        const Uint32 Bit = static_cast<Uint32>( ( i % BLOCK_SIDE ) * BLOCK_SIDE + i / BLOCK_SIDE );
+
+        Low |= static_cast<Uint32>( Indices[i] >> 1 ) << ( 16 + Bit ) | static_cast<Uint32>( Indices[i] & 1 ) << Bit;
+      }
+
+      BestError = Error;
+      BestHigh  = High;
+      BestLow   = Low;
+    }
+  }
+
+  for ( int Byte = 0; Byte != 4; ++Byte )
+  {
+    Out_Ptr[Byte]     = static_cast<Uint8>( BestHigh >> ( 24 - 8 * Byte ) );
+    Out_Ptr[4 + Byte] = static_cast<Uint8>( BestLow >> ( 24 - 8 * Byte ) );
+  }
+}
+
+
+/**
+ * @brief An EAC alpha block: a base value, a multiplier and a table of eight modifiers. The tables
+ * are tried with the multipliers and bases around those that span the block's alpha.
+ **/
+static void encodeEAC( const BlockTexels& Texels, Uint8* Out_Ptr )
+{
+  int Lowest  = 255;
+  int Highest = 0;
+
+  for ( const Uint8* Texel : Texels )
+  {
+    Lowest  = std::min( Lowest, static_cast<int>( Texel[3] ) );
+    Highest = std::max( Highest, static_cast<int>( Texel[3] ) );
+  }
+
+  int BestBase       = Lowest;
+  int BestMultiplier = 1;
+  int BestTable      = EAC_FLAT_TABLE;
+  int BestIndices[BLOCK_TEXELS];
+  int BestError      = INT_MAX;
+
+  std::fill( BestIndices, BestIndices + BLOCK_TEXELS, EAC_FLAT_INDEX );
+
+  for ( int Table = 0; Table != 16 && Highest != Lowest; ++Table )
+  {
+    const int* Modifiers = EAC_MODIFIERS[Table];
+    const int  Span      = *std::max_element( Modifiers, Modifiers + 8 ) - *std::min_element( Modifiers, Modifiers + 8 );
+    const int  Middle    = *std::max_element( Modifiers, Modifiers + 8 ) + *std::min_element( Modifiers, Modifiers + 8 );
+    const int  Guess     = std::min( std::max( ( Highest - Lowest + Span / 2 ) / Span, 1 ), 15 );
+
+    for ( int Multiplier = std::max( Guess - 1, 1 ); Multiplier <= std::min( Guess + 1, 15 ); ++Multiplier )
+    {
+      const int Centre = clampByte( ( Highest + Lowest - Middle * Multiplier ) / 2 );
+
+      for ( int Base = std::max( Centre - 1, 0 ); Base <= std::min( Centre + 1, 255 ); ++Base )
+      {
+        int Error = 0;
+        int Indices[BLOCK_TEXELS];
+
+        for ( int i = 0; i != BLOCK_TEXELS && Error < BestError; ++i )
+        {
+          int BestDistance = INT_MAX;
+
+          for ( int Index = 0; Index != 8; ++Index )
+          {
+            const int Distance = std::abs( clampByte( Base + Modifiers[Index] * Multiplier ) - Texels[i][3] );
+
+            if ( Distance < BestDistance )
+            {
+              BestDistance = Distance;
+              Indices[i]   = Index;
+            }
+            else
+            {;}
+          }
+
+          Error += BestDistance * BestDistance;
+        }
+
+        if ( Error < BestError )
+        {
+          BestError      = Error;
+          BestBase       = Base;
+          BestMultiplier = Multiplier;
+          BestTable      = Table;
+          std::copy( Indices, Indices + BLOCK_TEXELS, BestIndices );
+        }
+        else
+        {;}
+      }
+    }
+  }
+
+  // Texel indices by columns, the first in the highest bits
+  Uint64 Bits = static_cast<Uint64>( BestBase ) << 56 | static_cast<Uint64>( BestMultiplier ) << 52 | static_cast<Uint64>( BestTable ) << 48;
+
+  for ( int i = 0; i != BLOCK_TEXELS; ++i )
+  {
+    const int Position = ( i % BLOCK_SIDE ) * BLOCK_SIDE + i / BLOCK_SIDE;
+
+    Bits |= static_cast<Uint64>( BestIndices[i] ) << ( 45 - 3 * Position );
+  }
+
+  for ( int Byte = 0; Byte != 8; ++Byte )
+  {
+    Out_Ptr[Byte] = static_cast<Uint8>( Bits >> ( 56 - 8 * Byte ) );
+  }
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @return the bytes of a block: 8 for BC1 and ETC2_RGB, 16 for the formats with an alpha block.
+ **/
+size_t GetBlockBytes( LBlockFormat Format )
+{
+  return ( Format == LBlockFormat::BC3 || Format == LBlockFormat::ETC2_RGBA ) ? 16 : 8;
+}
+
+
+/**
+ * @return the bytes of an image of Width x Height texels, in whole blocks.
+ **/
+size_t GetCompressedSize( LBlockFormat Format, int Width, int Height )
+{
+  const size_t Columns = static_cast<size_t>( ( Width + BLOCK_SIDE - 1 ) / BLOCK_SIDE );
+  const size_t Rows    = static_cast<size_t>( ( Height + BLOCK_SIDE - 1 ) / BLOCK_SIDE );
+
+  return Columns * Rows * GetBlockBytes( Format );
+}
+
+
+const char* GetBlockFormatName( LBlockFormat Format )
+{
+  switch ( Format )
+  {
+    case LBlockFormat::BC1:       return "BC1";
+    case LBlockFormat::BC3:       return "BC3";
+    case LBlockFormat::ETC2_RGB:  return "ETC2 RGB";
+    case LBlockFormat::ETC2_RGBA: return "ETC2 RGBA";
+    default:                      return "unknown";
+  }
+}
+
+
+/**
+ * @brief Compresses an image for upload with glCompressedTexImage2D. The encoders are made for
+ * baking, not for every frame: they fit each block on its own, a few microseconds each, with the
+ * quality of the usual fast modes of the offline compressors.
+ *
+ * @param Pixels_Ptr Rows of Pitch bytes, R, G, B and A bytes per pixel (SDL_PIXELFORMAT_RGBA32).
+ * @param Out_Ptr    GetCompressedSize( Format, Width, Height ) bytes.
+ * @return false if a size is empty, the pitch is shorter than a row or the format is unknown: nothing
+ * is written.
+ **/
+bool CompressBlocks( const void* Pixels_Ptr, int Width, int Height, int Pitch, LBlockFormat Format, void* Out_Ptr )
+{
+  if ( Width <= 0 || Height <= 0 || Pitch < Width * 4 || Format < LBlockFormat::BC1 || Format > LBlockFormat::ETC2_RGBA )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Uint8* Pixels  = static_cast<const Uint8*>( Pixels_Ptr );
+  Uint8*       Block   = static_cast<Uint8*>( Out_Ptr );
+  const size_t Bytes   = GetBlockBytes( Format );
+  BlockTexels  Texels;
+
+  for ( int BlockY = 0; BlockY * BLOCK_SIDE < Height; ++BlockY )
+  {
+    for ( int BlockX = 0; BlockX * BLOCK_SIDE < Width; ++BlockX )
+    {
+      loadBlock( Pixels, Width, Height, Pitch, BlockX, BlockY, Texels );
+
+      switch ( Format )
+      {
+        case LBlockFormat::BC1:
+          encodeBC1( Texels, true, Block );
+          break;
+
+        case LBlockFormat::BC3:
+          encodeBC3Alpha( Texels, Block );
+          encodeBC1( Texels, false, Block + 8 );
+          break;
+
+        case LBlockFormat::ETC2_RGB:
+          encodeETC( Texels, false, Block );
+          break;
+
+        default:
+          encodeEAC( Texels, Block );
+          encodeETC( Texels, true, Block + 8 );
+          break;
+      }
+
+      Block += Bytes;
+    }
+  }
+
+  return true;
+}
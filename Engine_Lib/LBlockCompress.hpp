@@ -0,0 +1,46 @@
+/**
+ * @file LBlockCompress.hpp
+ *
+ * @brief Block compression of 32-bit images into the formats GPUs sample directly, BCn on desktops
+ * and ETC2 on OpenGL ES: a fourth to an eighth of the memory and upload of RGBA8888.
+ **/
+
+#ifndef LBLOCKCOMPRESS_HPP
+#define LBLOCKCOMPRESS_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief The compressed formats, each made of blocks of 4x4 texels:
+ * - BC1 (DXT1, EXT_texture_compression_s3tc): 8 bytes a block, two 5:6:5 colours and two bits per
+ *   texel; texels with alpha under 128 become transparent, the others opaque;
+ * - BC3 (DXT5): 16 bytes, a BC1 colour block after an alpha block of two values and three bits per
+ *   texel, for smooth alpha;
+ * - ETC2_RGB (core in OpenGL ES 3.0 and OpenGL 4.3): 8 bytes, opaque; written in the modes ETC1
+ *   has, which every ETC2 decoder reads;
+ * - ETC2_RGBA (ETC2 with EAC alpha): 16 bytes, an EAC alpha block before an ETC2_RGB one.
+ *
+ * The values are stored in baked files: do not renumber them.
+ **/
+enum class LBlockFormat : Uint32
+{
+  BC1       = 1,
+  BC3       = 2,
+  ETC2_RGB  = 3,
+  ETC2_RGBA = 4,
+};
+
+/*
+ * Sizes, in bytes, of a block and of a Width x Height image; its edges are padded to whole blocks.
+ */
+size_t      GetBlockBytes     ( LBlockFormat );
+size_t      GetCompressedSize ( LBlockFormat, int, int );
+const char* GetBlockFormatName( LBlockFormat );
+
+/*
+ * Compresses an image of Width x Height RGBA32 pixels (bytes R, G, B, A in memory) in rows of Pitch
+ * bytes into GetCompressedSize bytes of blocks: rows of blocks from the top, blocks from the left.
+ */
+bool        CompressBlocks    ( const void*, int, int, int, LBlockFormat, void* );
+
+#endif // LBLOCKCOMPRESS_HPP
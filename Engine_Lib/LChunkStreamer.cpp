@@ -0,0 +1,557 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LChunkStreamer.hpp"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Splits a path into its folder, with the separator, and its file name without extension.
+ **/
+static void SplitPath( const std::string& Path, std::string& Folder, std::string& Stem )
+{
+  const size_t Separator = Path.find_last_of( "/\\" );
+  const size_t Start     = ( Separator != std::string::npos ) ? Separator + 1 : 0;
+  const size_t Dot       = Path.find_last_of( '.' );
+  const size_t End       = ( Dot != std::string::npos && Dot > Start ) ? Dot : Path.size();
+
+  Folder = Path.substr( 0, Start );
+  Stem   = Path.substr( Start, End - Start );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LChunkStreamer::LChunkStreamer( void )
+  : m_Jobs_Ptr(nullptr), m_Renderer_Ptr(nullptr), m_Header(), m_Chunks(), m_Wanted(), m_Nearby(), m_Pending(),
+    m_ResidentList(), m_Budget(0), m_Radius_px(0), m_LookAhead(0.0f), m_Update(0), m_Uploads(0), m_IsPrimed(false),
+    m_Loads(0), m_Evictions(0), m_Misses(0)
+{
+  memset( &m_Header, 0, sizeof(m_Header) );
+}
+
+
+LChunkStreamer::~LChunkStreamer( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Reads a chunk map written by SliceChunks. No chunk is loaded until the first update.
+ *
+ * @param Path The ".chunks" file; the chunk images are next to it.
+ * @param Jobs The workers that decode the chunks; they must outlive the streamer, or its close.
+ * @param Budget Resident chunks at most: at least the chunks a camera can overlap, ideally twice
+ * as many.
+ * @param Renderer_Ptr The renderer of the chunk textures; the default one if omitted.
+ * @return false, leaving the streamer closed, if the map is missing or was not written by this
+ * version on a machine of the same byte order.
+ **/
+bool LChunkStreamer::open( const std::string& Path, LJobSystem& Jobs, int Budget, SDL_Renderer* Renderer_Ptr )
+{
+  close();
+
+  SDL_RWops* Input = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( Input == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  std::vector<Uint8> Present;
+
+  bool Success = SDL_RWread( Input, &m_Header, sizeof(m_Header), 1 ) == 1
+                 && memcmp( m_Header.Magic, LCHUNKS_MAGIC, sizeof(m_Header.Magic) ) == 0
+                 && m_Header.Version == LCHUNKS_VERSION
+                 && m_Header.ChunkSize > 0 && m_Header.Columns > 0 && m_Header.Rows > 0
+                 && m_Header.LevelW > ( m_Header.Columns - 1 ) * m_Header.ChunkSize && m_Header.LevelW <= m_Header.Columns * m_Header.ChunkSize
+                 && m_Header.LevelH > ( m_Header.Rows    - 1 ) * m_Header.ChunkSize && m_Header.LevelH <= m_Header.Rows    * m_Header.ChunkSize;
+
+  if ( Success )
+  {
+    Present.resize( static_cast<size_t>( m_Header.Columns ) * static_cast<size_t>( m_Header.Rows ) );
+    Success = SDL_RWread( Input, Present.data(), 1, Present.size() ) == Present.size();
+  }
+  else
+  {;}
+
+  SDL_RWclose( Input );
+
+  if ( !Success )
+  {
+    printf( "\n\"%s\" is not a chunk map of this version!", Path.c_str() );
+    memset( &m_Header, 0, sizeof(m_Header) );
+    return false;
+  }
+  else
+  {;}
+
+  std::string Folder, Stem;
+  SplitPath( Path, Folder, Stem );
+
+  m_Chunks.reset( new Chunk[ Present.size() ] );
+
+  for ( int Row = 0; Row != m_Header.Rows; ++Row )
+  {
+    for ( int Column = 0; Column != m_Header.Columns; ++Column )
+    {
+      const size_t Index = static_cast<size_t>( Row ) * static_cast<size_t>( m_Header.Columns ) + static_cast<size_t>( Column );
+
+      if ( Present[Index] != 0 )
+      {
+        m_Chunks[Index].Status = State::Unloaded;
+        m_Chunks[Index].Path   = Folder + Stem + "_" + std::to_string( Column ) + "_" + std::to_string( Row ) + ".png";
+      }
+      else
+      {;}
+    }
+  }
+
+  m_Jobs_Ptr     = &Jobs;
+  m_Renderer_Ptr = Renderer_Ptr;
+  m_Budget       = SDL_max( Budget, 1 );
+  m_Radius_px    = m_Header.ChunkSize / 2;
+  m_LookAhead    = 30.0f;
+
+  return true;
+}
+
+
+/**
+ * @brief Waits for the chunks being decoded and frees every chunk.
+ **/
+void LChunkStreamer::close( void )
+{
+  for ( int Index : m_Pending )
+  {
+    m_Jobs_Ptr->wait( m_Chunks[Index].Decoding );
+    SDL_FreeSurface( m_Chunks[Index].Surface );
+  }
+
+  m_Chunks.reset();
+  m_Wanted.clear();
+  m_Nearby.clear();
+  m_Pending.clear();
+  m_ResidentList.clear();
+  memset( &m_Header, 0, sizeof(m_Header) );
+
+  m_Jobs_Ptr  = nullptr;
+  m_Update    = 0;
+  m_IsPrimed  = false;
+  m_Loads     = 0;
+  m_Evictions = 0;
+  m_Misses    = 0;
+}
+
+
+/**
+ * @param Radius_px How far around the camera, and around where it is heading, chunks are prefetched.
+ * Half a chunk by default.
+ * @param LookAhead How many updates of the camera velocity are prefetched ahead of it. 30 by default.
+ **/
+void LChunkStreamer::setPrefetch( int Radius_px, float LookAhead )
+{
+  m_Radius_px = SDL_max( Radius_px, 0 );
+  m_LookAhead = SDL_max( LookAhead, 0.0f );
+}
+
+
+/**
+ * @brief Once per frame, before render: wants the chunks around the camera, uploads the decoded
+ * ones and evicts beyond the budget.
+ *
+ * @param Camera The area of the level the camera sees.
+ * @param VelocityX, VelocityY How far the camera moves per update, in pixels.
+ **/
+void LChunkStreamer::update( const SDL_Rect& Camera, float VelocityX, float VelocityY )
+{
+  if ( !isOpen() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  ++m_Update;
+  m_Uploads = 0;
+  m_Wanted.clear();
+  m_Nearby.clear();
+
+  int Left, Top, Right, Bottom;
+
+  // The chunks the camera sees come first, whatever the budget
+  if ( GetCells_Pvt( Camera, Left, Top, Right, Bottom ) )
+  {
+    for ( int Row = Top; Row <= Bottom; ++Row )
+    {
+      for ( int Column = Left; Column <= Right; ++Column )
+      {
+        const int Index = Row * m_Header.Columns + Column;
+
+        if ( m_Chunks[Index].Status != State::Absent )
+        {
+          m_Chunks[Index].LastVisible = m_Update;
+          m_Wanted.push_back( Index );
+        }
+        else
+        {;}
+      }
+    }
+  }
+  else
+  {;}
+
+  const size_t Visible = m_Wanted.size();
+
+  // Then those around the camera and where it is heading, nearest first
+  SDL_Rect Ahead = Camera;
+  Ahead.x += static_cast<int>( VelocityX * m_LookAhead );
+  Ahead.y += static_cast<int>( VelocityY * m_LookAhead );
+
+  SDL_Rect Area;
+  SDL_UnionRect( &Camera, &Ahead, &Area );
+
+  Area.x -= m_Radius_px;
+  Area.y -= m_Radius_px;
+  Area.w += m_Radius_px * 2;
+  Area.h += m_Radius_px * 2;
+
+  if ( GetCells_Pvt( Area, Left, Top, Right, Bottom ) )
+  {
+    for ( int Row = Top; Row <= Bottom; ++Row )
+    {
+      for ( int Column = Left; Column <= Right; ++Column )
+      {
+        const int Index = Row * m_Header.Columns + Column;
+
+        if ( m_Chunks[Index].Status != State::Absent && m_Chunks[Index].LastVisible != m_Update )
+        {
+          m_Nearby.push_back( Index );
+        }
+        else
+        {;}
+      }
+    }
+  }
+  else
+  {;}
+
+  const int CentreX = Camera.x + Camera.w / 2;
+  const int CentreY = Camera.y + Camera.h / 2;
+
+  const auto DistanceOf = [this, CentreX, CentreY]( int Index )
+  {
+    const Sint64 dx = static_cast<Sint64>( Index % m_Header.Columns ) * m_Header.ChunkSize + m_Header.ChunkSize / 2 - CentreX;
+    const Sint64 dy = static_cast<Sint64>( Index / m_Header.Columns ) * m_Header.ChunkSize + m_Header.ChunkSize / 2 - CentreY;
+
+    return dx * dx + dy * dy;
+  };
+
+  std::sort( m_Nearby.begin(), m_Nearby.end(), [&DistanceOf]( int A, int B ) { return DistanceOf( A ) < DistanceOf( B ); } );
+
+  for ( size_t i = 0; i != m_Nearby.size() && m_Wanted.size() < static_cast<size_t>( m_Budget ); ++i )
+  {
+    m_Wanted.push_back( m_Nearby[i] );
+  }
+
+  // Decoding starts in order of priority
+  for ( int Index : m_Wanted )
+  {
+    m_Chunks[Index].LastWanted = m_Update;
+
+    if ( m_Chunks[Index].Status == State::Unloaded && ( !m_IsPrimed || static_cast<int>( m_Pending.size() ) < s_MAX_DECODING ) )
+    {
+      Decode_Pvt( Index );
+    }
+    else
+    {;}
+  }
+
+  // The first time there is nothing to show yet: wait for what the camera sees
+  if ( !m_IsPrimed )
+  {
+    for ( size_t i = 0; i != Visible; ++i )
+    {
+      m_Jobs_Ptr->wait( m_Chunks[ m_Wanted[i] ].Decoding );
+    }
+
+    m_IsPrimed = true;
+  }
+  else
+  {;}
+
+  // Decoded chunks: visible ones are uploaded at once, the others a few per update, and those no
+  // longer wanted dropped
+  for ( size_t i = 0; i != m_Pending.size(); )
+  {
+    const int Index   = m_Pending[i];
+    Chunk&    Current = m_Chunks[Index];
+
+    if ( !Current.Decoding.isDone() )
+    {
+      ++i;
+    }
+    else if ( Current.LastWanted != m_Update )
+    {
+      SDL_FreeSurface( Current.Surface );
+      Current.Surface = nullptr;
+      Current.Status  = State::Unloaded;
+
+      m_Pending[i] = m_Pending.back();
+      m_Pending.pop_back();
+    }
+    else if ( Current.LastVisible == m_Update || m_Uploads < s_UPLOADS_PER_UPDATE )
+    {
+      m_Uploads += ( Current.LastVisible == m_Update ) ? 0 : 1;
+      Upload_Pvt( Index );
+
+      m_Pending[i] = m_Pending.back();
+      m_Pending.pop_back();
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  for ( size_t i = 0; i != Visible; ++i )
+  {
+    m_Misses += ( m_Chunks[ m_Wanted[i] ].Status != State::Resident ) ? 1 : 0;
+  }
+
+  Evict_Pvt();
+}
+
+
+/**
+ * @brief Draws what the camera sees of the resident chunks, at the top-left corner of the window.
+ *
+ * @param Camera As given to update.
+ **/
+void LChunkStreamer::render( const SDL_Rect& Camera ) const
+{
+  int Left, Top, Right, Bottom;
+
+  if ( !isOpen() || !GetCells_Pvt( Camera, Left, Top, Right, Bottom ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  for ( int Row = Top; Row <= Bottom; ++Row )
+  {
+    for ( int Column = Left; Column <= Right; ++Column )
+    {
+      const Chunk& Current = m_Chunks[ Row * m_Header.Columns + Column ];
+
+      if ( Current.Status != State::Resident )
+      {
+        continue;
+      }
+      else
+      {;}
+
+      const SDL_Rect Bounds{ Column * m_Header.ChunkSize, Row * m_Header.ChunkSize, Current.Texture.getWidth(), Current.Texture.getHeight() };
+      SDL_Rect       Seen;
+
+      if ( SDL_IntersectRect( &Bounds, &Camera, &Seen ) )
+      {
+        const SDL_Rect Clip{ Seen.x - Bounds.x, Seen.y - Bounds.y, Seen.w, Seen.h };
+
+        Current.Texture.render( Seen.x - Camera.x, Seen.y - Camera.y, &Clip );
+      }
+      else
+      {;}
+    }
+  }
+}
+
+
+bool LChunkStreamer::isOpen( void ) const
+{
+  return m_Chunks != nullptr;
+}
+
+
+int LChunkStreamer::GetLevelWidth( void ) const
+{
+  return m_Header.LevelW;
+}
+
+
+int LChunkStreamer::GetLevelHeight( void ) const
+{
+  return m_Header.LevelH;
+}
+
+
+int LChunkStreamer::GetResident( void ) const
+{
+  return static_cast<int>( m_ResidentList.size() );
+}
+
+
+int LChunkStreamer::GetDecoding( void ) const
+{
+  return static_cast<int>( m_Pending.size() );
+}
+
+
+/**
+ * @return the chunks uploaded since open.
+ **/
+size_t LChunkStreamer::GetLoads( void ) const
+{
+  return m_Loads;
+}
+
+
+size_t LChunkStreamer::GetEvictions( void ) const
+{
+  return m_Evictions;
+}
+
+
+/**
+ * @return the visible chunks that were not ready, summed over the updates since open.
+ **/
+size_t LChunkStreamer::GetMisses( void ) const
+{
+  return m_Misses;
+}
+
+
+/**
+ * @brief Runs on a worker: reads and decodes the image of a chunk, in the format of the textures.
+ **/
+void LChunkStreamer::DecodeJob_Pvt( void* Data )
+{
+  Chunk&       Current = *static_cast<Chunk*>( Data );
+  SDL_Surface* Loaded  = IMG_Load( Current.Path.c_str() );
+
+  if ( Loaded == NULL )
+  {
+    printf( "\nUnable to load chunk \"%s\"! SDL_image Error: %s", Current.Path.c_str(), IMG_GetError() );
+    return;
+  }
+  else
+  {;}
+
+  Current.Surface = SDL_ConvertSurfaceFormat( Loaded, SDL_PIXELFORMAT_ARGB8888, 0 );
+  SDL_FreeSurface( Loaded );
+}
+
+
+/**
+ * @brief The range of chunks, inclusive, that an area of the level covers.
+ *
+ * @return false if the area is outside the level.
+ **/
+bool LChunkStreamer::GetCells_Pvt( const SDL_Rect& Area, int& Left, int& Top, int& Right, int& Bottom ) const
+{
+  const SDL_Rect Level{ 0, 0, m_Header.LevelW, m_Header.LevelH };
+  SDL_Rect       Inside;
+
+  if ( !SDL_IntersectRect( &Area, &Level, &Inside ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Left   = Inside.x / m_Header.ChunkSize;
+  Top    = Inside.y / m_Header.ChunkSize;
+  Right  = ( Inside.x + Inside.w - 1 ) / m_Header.ChunkSize;
+  Bottom = ( Inside.y + Inside.h - 1 ) / m_Header.ChunkSize;
+
+  return true;
+}
+
+
+void LChunkStreamer::Decode_Pvt( int Index )
+{
+  m_Chunks[Index].Status = State::Decoding;
+  m_Pending.push_back( Index );
+
+  m_Jobs_Ptr->run( DecodeJob_Pvt, &m_Chunks[Index], &m_Chunks[Index].Decoding );
+}
+
+
+/**
+ * @brief Creates the texture of a decoded chunk. A chunk whose image could not be read is left out
+ * from then on.
+ **/
+void LChunkStreamer::Upload_Pvt( int Index )
+{
+  Chunk& Current = m_Chunks[Index];
+
+  const bool Success = ( Current.Surface != nullptr ) && Current.Texture.loadFromSurface( Current.Surface, m_Renderer_Ptr );
+
+  SDL_FreeSurface( Current.Surface );
+  Current.Surface = nullptr;
+
+  if ( Success )
+  {
+    Current.Status = State::Resident;
+    m_ResidentList.push_back( Index );
+    ++m_Loads;
+  }
+  else
+  {
+    Current.Status = State::Absent;
+  }
+}
+
+
+/**
+ * @brief Frees resident chunks beyond the budget, least recently wanted first; wanted ones stay.
+ **/
+void LChunkStreamer::Evict_Pvt( void )
+{
+  while ( static_cast<int>( m_ResidentList.size() ) > m_Budget )
+  {
+    size_t Oldest = m_ResidentList.size();
+
+    for ( size_t i = 0; i != m_ResidentList.size(); ++i )
+    {
+      const Chunk& Current = m_Chunks[ m_ResidentList[i] ];
+
+      if ( Current.LastWanted != m_Update
+           && ( Oldest == m_ResidentList.size() || Current.LastWanted < m_Chunks[ m_ResidentList[Oldest] ].LastWanted ) )
+      {
+        Oldest = i;
+      }
+      else
+      {;}
+    }
+
+    if ( Oldest == m_ResidentList.size() )
+    {
+      return;
+    }
+    else
+    {;}
+
+    m_Chunks[ m_ResidentList[Oldest] ].Texture.free();
+    m_Chunks[ m_ResidentList[Oldest] ].Status = State::Unloaded;
+    ++m_Evictions;
+
+    m_ResidentList[Oldest] = m_ResidentList.back();
+    m_ResidentList.pop_back();
+  }
+}
@@ -0,0 +1,124 @@
+/**
+ * @file LChunkStreamer.hpp
+ *
+ * @brief Streaming of a large level image cut into chunks by the SliceChunks tool: only the chunks
+ * around the camera are resident, loaded ahead of it on worker threads and evicted behind it.
+ **/
+
+#ifndef LCHUNKSTREAMER_HPP
+#define LCHUNKSTREAMER_HPP
+
+#include <SDL.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "LJobSystem.hpp"
+#include "LTexture.hpp"
+
+/**
+ * @brief A chunk map (".chunks") is this header, then one byte per chunk, row after row: 1 if its
+ * image was written, 0 if it was left out because fully transparent. The image of the chunk in
+ * column c and row r is "<map name>_<c>_<r>.png", next to the map. Fields are stored in the byte
+ * order of the machine that sliced the level, as in the ".atlas" files.
+ **/
+struct LChunkMapHeader
+{
+  char   Magic[4];      // LCHUNKS_MAGIC
+  Uint32 Version;       // LCHUNKS_VERSION
+  Sint32 LevelW;        // Of the whole level, in pixels
+  Sint32 LevelH;
+  Sint32 ChunkSize;     // Side of a chunk; those of the last column and row may be smaller
+  Sint32 Columns;
+  Sint32 Rows;
+};
+
+static constexpr char   LCHUNKS_MAGIC[4]    = { 'L', 'C', 'H', 'K' };
+static constexpr Uint32 LCHUNKS_VERSION     = 1;
+static constexpr char   LCHUNKS_EXTENSION[] = ".chunks";
+
+static_assert( sizeof(LChunkMapHeader) == 28, "The chunk map header must have no padding" );
+
+/**
+ * @brief Keeps the chunks of a level near the camera resident, within a fixed number of textures.
+ *
+ * Every update wants the chunks the camera sees, then those within a prefetch radius of where the
+ * camera is heading: its velocity times a look-ahead, nearest to the camera first, as many as the
+ * budget allows. Wanted chunks are decoded by LJobSystem workers (file reading, PNG decoding and
+ * conversion) and uploaded by the calling thread, which owns the renderer, a few per update so that
+ * no frame stalls; decodes no longer wanted when they finish are dropped. Resident chunks beyond the
+ * budget are evicted, least recently wanted first.
+ *
+ * Only the first update after "open" waits for the chunks the camera sees. After that a visible
+ * chunk that is not ready yet is drawn as a hole and counted as a miss: a prefetch radius or a
+ * look-ahead too small for the camera speed shows as misses, not as hitches.
+ **/
+class LChunkStreamer
+{
+public:
+
+  LChunkStreamer( void );
+  ~LChunkStreamer( void );
+
+  LChunkStreamer( const LChunkStreamer& ) = delete;
+  LChunkStreamer& operator=( const LChunkStreamer& ) = delete;
+
+  bool open        ( const std::string&, LJobSystem&, int, SDL_Renderer* = nullptr );
+  void close       ( void );
+  void setPrefetch ( int, float );
+  void update      ( const SDL_Rect&, float = 0.0f, float = 0.0f );
+  void render      ( const SDL_Rect& ) const;
+  bool isOpen      ( void ) const;
+
+  int    GetLevelWidth  ( void ) const;
+  int    GetLevelHeight ( void ) const;
+  int    GetResident    ( void ) const;
+  int    GetDecoding    ( void ) const;
+  size_t GetLoads       ( void ) const;
+  size_t GetEvictions   ( void ) const;
+  size_t GetMisses      ( void ) const;
+
+private:
+
+  enum class State { Absent, Unloaded, Decoding, Resident };
+
+  struct Chunk
+  {
+    State        Status     = State::Absent;
+    std::string  Path;
+    SDL_Surface* Surface    = nullptr;   // Written by the decoding job, read once it is done
+    LTexture     Texture;
+    LJobCounter  Decoding;
+    Uint32       LastWanted  = 0;        // Update that last wanted the chunk
+    Uint32       LastVisible = 0;        // Update that last saw it in the camera
+  };
+
+  static void DecodeJob_Pvt( void* );
+
+  bool GetCells_Pvt ( const SDL_Rect&, int&, int&, int&, int& ) const;
+  void Decode_Pvt   ( int );
+  void Upload_Pvt   ( int );
+  void Evict_Pvt    ( void );
+
+  static constexpr int s_MAX_DECODING        = 4;     // Chunks decoded at once
+  static constexpr int s_UPLOADS_PER_UPDATE  = 2;     // Prefetched chunks uploaded per update
+
+  LJobSystem*              m_Jobs_Ptr;
+  SDL_Renderer*            m_Renderer_Ptr;
+  LChunkMapHeader          m_Header;
+  std::unique_ptr<Chunk[]> m_Chunks;          // Row after row
+  std::vector<int>         m_Wanted;          // By priority: visible first, then by distance
+  std::vector<int>         m_Nearby;          // Prefetch candidates; storage is kept between updates
+  std::vector<int>         m_Pending;         // Being decoded
+  std::vector<int>         m_ResidentList;
+  int                      m_Budget;          // Resident chunks at most
+  int                      m_Radius_px;
+  float                    m_LookAhead;       // Updates of camera motion prefetched
+  Uint32                   m_Update;
+  int                      m_Uploads;         // Prefetched chunks uploaded by the current update
+  bool                     m_IsPrimed;
+  size_t                   m_Loads;
+  size_t                   m_Evictions;
+  size_t                   m_Misses;
+};
+
+#endif // LCHUNKSTREAMER_HPP
@@ -0,0 +1,828 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LCollision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static Sint64 DistanceSquared( int x1, int y1, int x2, int y2 )
+{
+  const Sint64 DeltaX = static_cast<Sint64>( x2 ) - x1;
+  const Sint64 DeltaY = static_cast<Sint64>( y2 ) - y1;
+
+  return DeltaX * DeltaX + DeltaY * DeltaY;
+}
+
+
+/**
+ * @brief Box set against any collider: the boxes outside the bounds of the other shape are skipped
+ * with a single test each.
+ **/
+static bool CheckRectSet( const std::vector<SDL_Rect>& Rects, const LCollider& Other )
+{
+  for ( const SDL_Rect& Box : Rects )
+  {
+    if ( !CheckCollision( Box, Other.Bounds ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    switch ( Other.Type )
+    {
+      case LCollider::Shape::Rect:
+        return true;
+
+      case LCollider::Shape::Circle:
+        if ( CheckCollision( Other.Circle, Box ) ) { return true; } else {;}
+        break;
+
+      case LCollider::Shape::RectSet:
+        if ( CheckCollision( *Other.Rects, Box ) ) { return true; } else {;}
+        break;
+    }
+  }
+
+  return false;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Box to box: separating axis test on the four sides.
+ **/
+bool CheckCollision( const SDL_Rect& a, const SDL_Rect& b )
+{
+  return !( ( a.y + a.h <= b.y ) || ( a.y >= b.y + b.h ) || ( a.x + a.w <= b.x ) || ( a.x >= b.x + b.w ) );
+}
+
+
+/**
+ * @brief Circle to circle: the distance between the centres is less than the sum of the radii.
+ **/
+bool CheckCollision( const LCircle& a, const LCircle& b )
+{
+  const Sint64 TotalRadius = static_cast<Sint64>( a.r ) + b.r;
+
+  return DistanceSquared( a.x, a.y, b.x, b.y ) < TotalRadius * TotalRadius;
+}
+
+
+/**
+ * @brief Circle to box: the point of the box closest to the centre is inside the circle.
+ **/
+bool CheckCollision( const LCircle& a, const SDL_Rect& b )
+{
+  const int ClosestX = std::min( std::max( a.x, b.x ), b.x + b.w );
+  const int ClosestY = std::min( std::max( a.y, b.y ), b.y + b.h );
+
+  return DistanceSquared( a.x, a.y, ClosestX, ClosestY ) < static_cast<Sint64>( a.r ) * a.r;
+}
+
+
+/**
+ * @brief Box set to box: any box of the set overlaps the other one.
+ **/
+bool CheckCollision( const std::vector<SDL_Rect>& a, const SDL_Rect& b )
+{
+  for ( const SDL_Rect& Box : a )
+  {
+    if ( CheckCollision( Box, b ) )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Box set to box set: any pair of boxes overlaps. Stops at the first one.
+ **/
+bool CheckCollision( const std::vector<SDL_Rect>& a, const std::vector<SDL_Rect>& b )
+{
+  for ( const SDL_Rect& Box : a )
+  {
+    if ( CheckCollision( b, Box ) )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Any shape to any shape: the bounding boxes first, then the shapes themselves.
+ **/
+bool CheckCollision( const LCollider& a, const LCollider& b )
+{
+  if ( !CheckCollision( a.Bounds, b.Bounds ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Order the shapes so that a box set, if any, comes first, then a circle
+  if ( a.Type == LCollider::Shape::RectSet )
+  {
+    return CheckRectSet( *a.Rects, b );
+  }
+  else if ( b.Type == LCollider::Shape::RectSet )
+  {
+    return CheckRectSet( *b.Rects, a );
+  }
+  else if ( a.Type == LCollider::Shape::Circle )
+  {
+    return ( b.Type == LCollider::Shape::Circle ) ? CheckCollision( a.Circle, b.Circle ) : CheckCollision( a.Circle, b.Bounds );
+  }
+  else if ( b.Type == LCollider::Shape::Circle )
+  {
+    return CheckCollision( b.Circle, a.Bounds );
+  }
+  else
+  {
+    // Two boxes: the bounds test was the whole test
+    return true;
+  }
+}
+
+
+/**
+ * @brief Moving box to box: the entry and exit times of each axis, from the gaps between the sides
+ * facing along the velocity. The boxes overlap between the later entry and the earlier exit; the
+ * axis entered last gives the normal.
+ **/
+LSweepHit SweepCollision( const SDL_Rect& a, double VelX, double VelY, const SDL_Rect& b )
+{
+  LSweepHit Sweep;
+
+  if ( CheckCollision( a, b ) )
+  {
+    Sweep.Hit  = true;
+    Sweep.Time = 0.0;
+    return Sweep;
+  }
+  else
+  {;}
+
+  const double Infinity = std::numeric_limits<double>::infinity();
+  double       Entry[2], Exit[2];
+
+  const double Velocity[2] = { VelX, VelY };
+  const double Lower   [2] = { static_cast<double>( b.x ) - ( a.x + a.w ), static_cast<double>( b.y ) - ( a.y + a.h ) };
+  const double Upper   [2] = { static_cast<double>( b.x + b.w ) - a.x    , static_cast<double>( b.y + b.h ) - a.y     };
+
+  for ( int Axis = 0; Axis != 2; ++Axis )
+  {
+    if ( Velocity[Axis] != 0.0 )
+    {
+      Entry[Axis] = std::min( Lower[Axis] / Velocity[Axis], Upper[Axis] / Velocity[Axis] );
+      Exit [Axis] = std::max( Lower[Axis] / Velocity[Axis], Upper[Axis] / Velocity[Axis] );
+    }
+    else if ( Lower[Axis] < 0.0 && Upper[Axis] > 0.0 )
+    {
+      // Not moving along this axis, and already overlapping along it
+      Entry[Axis] = -Infinity;
+      Exit [Axis] =  Infinity;
+    }
+    else
+    {
+      return Sweep;
+    }
+  }
+
+  const double EntryTime = std::max( Entry[0], Entry[1] );
+  const double ExitTime  = std::min( Exit [0], Exit [1] );
+
+  // Touching only, or meeting outside of this step
+  if ( EntryTime >= ExitTime || EntryTime < 0.0 || EntryTime >= 1.0 )
+  {
+    return Sweep;
+  }
+  else
+  {;}
+
+  Sweep.Hit  = true;
+  Sweep.Time = EntryTime;
+
+  if ( Entry[0] > Entry[1] )
+  {
+    Sweep.NormalX = ( VelX > 0.0 ) ? -1.0 : 1.0;
+  }
+  else
+  {
+    Sweep.NormalY = ( VelY > 0.0 ) ? -1.0 : 1.0;
+  }
+
+  return Sweep;
+}
+
+
+/**
+ * @brief Moving circle to circle: the first time the distance between the centres equals the sum of
+ * the radii, a root of a quadratic in the time.
+ **/
+LSweepHit SweepCollision( const LCircle& a, double VelX, double VelY, const LCircle& b )
+{
+  LSweepHit Sweep;
+
+  if ( CheckCollision( a, b ) )
+  {
+    Sweep.Hit  = true;
+    Sweep.Time = 0.0;
+    return Sweep;
+  }
+  else
+  {;}
+
+  const double DeltaX      = static_cast<double>( a.x ) - b.x;
+  const double DeltaY      = static_cast<double>( a.y ) - b.y;
+  const double TotalRadius = static_cast<double>( a.r ) + b.r;
+
+  // | Delta + t * Velocity |^2 = TotalRadius^2, as A t^2 + 2 B t + C = 0
+  const double A = VelX * VelX + VelY * VelY;
+  const double B = DeltaX * VelX + DeltaY * VelY;
+  const double C = DeltaX * DeltaX + DeltaY * DeltaY - TotalRadius * TotalRadius;
+
+  const double Discriminant = B * B - A * C;
+
+  // Standing still, moving apart, or passing by without overlapping
+  if ( A == 0.0 || B >= 0.0 || Discriminant <= 0.0 )
+  {
+    return Sweep;
+  }
+  else
+  {;}
+
+  const double Time = ( -B - std::sqrt( Discriminant ) ) / A;
+
+  if ( Time >= 1.0 )
+  {
+    return Sweep;
+  }
+  else
+  {;}
+
+  Sweep.Hit     = true;
+  Sweep.Time    = std::max( Time, 0.0 );
+  Sweep.NormalX = ( DeltaX + Sweep.Time * VelX ) / TotalRadius;
+  Sweep.NormalY = ( DeltaY + Sweep.Time * VelY ) / TotalRadius;
+
+  return Sweep;
+}
+
+
+/**
+ * @brief Moving circle to box: the centre swept against the box grown by the radius, whose sides are
+ * the box widened and heightened by the radius and whose corners are circles of that radius. The
+ * earliest of the six contacts wins.
+ **/
+LSweepHit SweepCollision( const LCircle& a, double VelX, double VelY, const SDL_Rect& b )
+{
+  LSweepHit Sweep;
+
+  if ( CheckCollision( a, b ) )
+  {
+    Sweep.Hit  = true;
+    Sweep.Time = 0.0;
+    return Sweep;
+  }
+  else
+  {;}
+
+  const SDL_Rect Centre = { a.x, a.y, 0, 0 };
+  LSweepHit      Parts[6];
+
+  Parts[0] = SweepCollision( Centre, VelX, VelY, SDL_Rect{ b.x - a.r, b.y, b.w + 2 * a.r, b.h } );
+  Parts[1] = SweepCollision( Centre, VelX, VelY, SDL_Rect{ b.x, b.y - a.r, b.w, b.h + 2 * a.r } );
+  Parts[2] = SweepCollision( LCircle{ a.x, a.y, 0 }, VelX, VelY, LCircle{ b.x      , b.y      , a.r } );
+  Parts[3] = SweepCollision( LCircle{ a.x, a.y, 0 }, VelX, VelY, LCircle{ b.x + b.w, b.y      , a.r } );
+  Parts[4] = SweepCollision( LCircle{ a.x, a.y, 0 }, VelX, VelY, LCircle{ b.x      , b.y + b.h, a.r } );
+  Parts[5] = SweepCollision( LCircle{ a.x, a.y, 0 }, VelX, VelY, LCircle{ b.x + b.w, b.y + b.h, a.r } );
+
+  for ( const LSweepHit& Part : Parts )
+  {
+    Sweep = EarliestSweep( Sweep, Part );
+  }
+
+  return Sweep;
+}
+
+
+/**
+ * @brief The first of two contacts along the same step, for a shape moving among several obstacles.
+ **/
+LSweepHit EarliestSweep( const LSweepHit& a, const LSweepHit& b )
+{
+  if ( !a.Hit )
+  {
+    return b;
+  }
+  else if ( b.Hit && b.Time < a.Time )
+  {
+    return b;
+  }
+  else
+  {
+    return a;
+  }
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief How far a shape swept along one axis by Velocity can go in whole pixels: the full step when
+ * nothing was hit, otherwise up to the contact, rounded towards the start so that the shapes do not
+ * overlap. A contact landing on a whole pixel, as between boxes, is reached exactly. For a diagonal
+ * sweep the rounding of the two axes is not enough to keep a circle out: sweep one axis at a time.
+ **/
+int LSweepHit::Travel( int Velocity ) const
+{
+  if ( !Hit )
+  {
+    return Velocity;
+  }
+  else
+  {;}
+
+  const double Distance = Time * Velocity;
+
+  return static_cast<int>( ( Distance > 0.0 ) ? std::floor( Distance + 1e-6 ) : std::ceil( Distance - 1e-6 ) );
+}
+
+
+LCollider LCollider::FromRect( const SDL_Rect& Box )
+{
+  LCollider Collider;
+  Collider.Type   = Shape::Rect;
+  Collider.Bounds = Box;
+
+  return Collider;
+}
+
+
+LCollider LCollider::FromCircle( const LCircle& Circle )
+{
+  LCollider Collider;
+  Collider.Type   = Shape::Circle;
+  Collider.Bounds = SDL_Rect{ Circle.x - Circle.r, Circle.y - Circle.r, 2 * Circle.r, 2 * Circle.r };
+  Collider.Circle = Circle;
+
+  return Collider;
+}
+
+
+LCollider LCollider::FromRectSet( const std::vector<SDL_Rect>& Rects )
+{
+  LCollider Collider;
+  Collider.Type   = Shape::RectSet;
+  Collider.Bounds = SDL_Rect{ 0, 0, 0, 0 };
+  Collider.Rects  = &Rects;
+
+  if ( !Rects.empty() )
+  {
+    int Left = Rects[0].x, Right  = Rects[0].x + Rects[0].w;
+    int Top  = Rects[0].y, Bottom = Rects[0].y + Rects[0].h;
+
+    for ( const SDL_Rect& Box : Rects )
+    {
+      Left   = std::min( Left  , Box.x );
+      Top    = std::min( Top   , Box.y );
+      Right  = std::max( Right , Box.x + Box.w );
+      Bottom = std::max( Bottom, Box.y + Box.h );
+    }
+
+    Collider.Bounds = SDL_Rect{ Left, Top, Right - Left, Bottom - Top };
+  }
+  else
+  {;}
+
+  return Collider;
+}
+
+
+LBroadPhase::LBroadPhase( void )
+  : m_Tests(0)
+{;}
+
+
+/**
+ * @brief Starts a new frame. The storage and the sorted order of the previous one are kept.
+ **/
+void LBroadPhase::clear( void )
+{
+  m_Colliders.clear();
+  m_Pairs.clear();
+}
+
+
+/**
+ * @brief Adds a collider to the current frame.
+ *
+ * @return The index the collider is reported with in the pairs.
+ **/
+int LBroadPhase::add( const LCollider& Collider )
+{
+  m_Colliders.push_back( Collider );
+
+  return static_cast<int>( m_Colliders.size() - 1 );
+}
+
+
+/**
+ * @brief Finds every pair of colliders of the current frame that overlap.
+ *
+ * @return The pairs, valid until the next clear.
+ **/
+const std::vector<LCollisionPair>& LBroadPhase::findPairs( void )
+{
+  m_Pairs.clear();
+  m_Tests = 0;
+
+  Sort_Pvt();
+
+  for ( size_t i = 0; i != m_Order.size(); ++i )
+  {
+    const LCollider& First = m_Colliders[ static_cast<size_t>( m_Order[i] ) ];
+    const int        Right = First.Bounds.x + First.Bounds.w;
+
+    // Sweep: every later box starting before this one ends overlaps it along x
+    for ( size_t j = i + 1; j != m_Order.size(); ++j )
+    {
+      const LCollider& Second = m_Colliders[ static_cast<size_t>( m_Order[j] ) ];
+
+      if ( Second.Bounds.x >= Right )
+      {
+        break;
+      }
+      else
+      {;}
+
+      ++m_Tests;
+
+      if ( CheckCollision( First, Second ) )
+      {
+        m_Pairs.push_back( LCollisionPair{ std::min( m_Order[i], m_Order[j] ), std::max( m_Order[i], m_Order[j] ) } );
+      }
+      else
+      {;}
+    }
+  }
+
+  return m_Pairs;
+}
+
+
+const LCollider& LBroadPhase::GetCollider( int Index ) const
+{
+  return m_Colliders[ static_cast<size_t>( Index ) ];
+}
+
+
+size_t LBroadPhase::GetTests( void ) const
+{
+  return m_Tests;
+}
+
+
+/**
+ * @brief Sorts the colliders by the left side of their bounds. Insertion sort on the order of the
+ * previous frame, which is almost sorted already; a full sort when the number of colliders changed.
+ **/
+void LBroadPhase::Sort_Pvt( void )
+{
+  const auto LeftOf = [this]( int Index ) { return m_Colliders[ static_cast<size_t>( Index ) ].Bounds.x; };
+
+  if ( m_Order.size() != m_Colliders.size() )
+  {
+    m_Order.resize( m_Colliders.size() );
+    std::iota( m_Order.begin(), m_Order.end(), 0 );
+    std::sort( m_Order.begin(), m_Order.end(), [&LeftOf]( int a, int b ) { return LeftOf( a ) < LeftOf( b ); } );
+    return;
+  }
+  else
+  {;}
+
+  for ( size_t i = 1; i < m_Order.size(); ++i )
+  {
+    const int Index = m_Order[i];
+    const int Left  = LeftOf( Index );
+    size_t    j     = i;
+
+    while ( j > 0 && LeftOf( m_Order[j - 1] ) > Left )
+    {
+      m_Order[j] = m_Order[j - 1];
+      --j;
+    }
+
+    m_Order[j] = Index;
+  }
+}
+
+
+/***************************************************************************************************
+* LSpatialGrid methods
+****************************************************************************************************/
+
+/**
+ * @param World The area the grid covers.
+ * @param CellSize_px The side of a cell: about the size of the largest boxes, or a fraction of the
+ * smallest area queried.
+ **/
+LSpatialGrid::LSpatialGrid( const SDL_Rect& World, int CellSize_px )
+  : m_World(World), m_CellSize_px(SDL_max( CellSize_px, 1 )), m_Columns(0), m_Rows(0),
+    m_Bounds(), m_CellStarts(), m_CellBoxes(), m_IsBuilt(false)
+{
+  m_Columns = SDL_max( ( World.w + m_CellSize_px - 1 ) / m_CellSize_px, 1 );
+  m_Rows    = SDL_max( ( World.h + m_CellSize_px - 1 ) / m_CellSize_px, 1 );
+}
+
+
+void LSpatialGrid::clear( void )
+{
+  m_Bounds.clear();
+  m_IsBuilt = false;
+}
+
+
+/**
+ * @return the index of the box, reported by "query".
+ **/
+int LSpatialGrid::add( const SDL_Rect& Bounds )
+{
+  m_Bounds.push_back( Bounds );
+  m_IsBuilt = false;
+
+  return static_cast<int>( m_Bounds.size() ) - 1;
+}
+
+
+/**
+ * @brief Bins the boxes by cell: counts the entries of every cell, turns the counts into starts,
+ * then writes each box in the cells it covers. Nothing is allocated once the arrays have grown.
+ **/
+void LSpatialGrid::build( void )
+{
+  if ( m_IsBuilt )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_CellStarts.assign( static_cast<size_t>( m_Columns ) * m_Rows + 1, 0 );
+
+  int Left, Top, Right, Bottom;
+
+  for ( const SDL_Rect& Bounds : m_Bounds )
+  {
+    GetCells_Pvt( Bounds, Left, Top, Right, Bottom );
+
+    for ( int Row = Top; Row <= Bottom; ++Row )
+    {
+      for ( int Column = Left; Column <= Right; ++Column )
+      {
+        ++m_CellStarts[ Row * m_Columns + Column + 1 ];
+      }
+    }
+  }
+
+  for ( size_t Cell = 1; Cell != m_CellStarts.size(); ++Cell )
+  {
+    m_CellStarts[Cell] += m_CellStarts[Cell - 1];
+  }
+
+  m_CellBoxes.resize( static_cast<size_t>( m_CellStarts.back() ) );
+
+  // Filled through a copy of the starts, advanced as the cells fill; box indices stay in order
+  std::vector<int> Next( m_CellStarts.begin(), m_CellStarts.end() - 1 );
+
+  for ( size_t Box = 0; Box != m_Bounds.size(); ++Box )
+  {
+    GetCells_Pvt( m_Bounds[Box], Left, Top, Right, Bottom );
+
+    for ( int Row = Top; Row <= Bottom; ++Row )
+    {
+      for ( int Column = Left; Column <= Right; ++Column )
+      {
+        m_CellBoxes[ Next[ Row * m_Columns + Column ]++ ] = static_cast<int>( Box );
+      }
+    }
+  }
+
+  m_IsBuilt = true;
+}
+
+
+/**
+ * @brief Finds the boxes that overlap an area, each once. The grid must be built.
+ *
+ * @param Area In world coordinates.
+ * @param Boxes Where the indices of the boxes are appended, cell after cell.
+ **/
+void LSpatialGrid::query( const SDL_Rect& Area, std::vector<int>& Boxes ) const
+{
+  if ( !m_IsBuilt )
+  {
+    printf( "\nLSpatialGrid queried before being built!" );
+    return;
+  }
+  else
+  {;}
+
+  int Left, Top, Right, Bottom;
+  GetCells_Pvt( Area, Left, Top, Right, Bottom );
+
+  for ( int Row = Top; Row <= Bottom; ++Row )
+  {
+    for ( int Column = Left; Column <= Right; ++Column )
+    {
+      const int Cell = Row * m_Columns + Column;
+
+      for ( int Entry = m_CellStarts[Cell]; Entry != m_CellStarts[Cell + 1]; ++Entry )
+      {
+        const int       Box    = m_CellBoxes[Entry];
+        const SDL_Rect& Bounds = m_Bounds[Box];
+
+        if ( !SDL_HasIntersection( &Bounds, &Area ) )
+        {
+          continue;
+        }
+        else
+        {;}
+
+        // Reported from the first cell shared by the box and the area only
+        int BoxLeft, BoxTop, BoxRight, BoxBottom;
+        GetCells_Pvt( Bounds, BoxLeft, BoxTop, BoxRight, BoxBottom );
+
+        if ( SDL_max( BoxLeft, Left ) == Column && SDL_max( BoxTop, Top ) == Row )
+        {
+          Boxes.push_back( Box );
+        }
+        else
+        {;}
+      }
+    }
+  }
+}
+
+
+size_t LSpatialGrid::GetCount( void ) const
+{
+  return m_Bounds.size();
+}
+
+
+const SDL_Rect& LSpatialGrid::GetBounds( int Box ) const
+{
+  return m_Bounds[Box];
+}
+
+
+/**
+ * @brief The range of cells, inclusive, that a rectangle covers, clamped to the grid.
+ **/
+void LSpatialGrid::GetCells_Pvt( const SDL_Rect& Area, int& Left, int& Top, int& Right, int& Bottom ) const
+{
+  const auto CellOf = [this]( int Offset, int Count )
+  {
+    return ( Offset < 0 ) ? 0 : SDL_min( Offset / m_CellSize_px, Count - 1 );
+  };
+
+  Left   = CellOf( Area.x - m_World.x, m_Columns );
+  Top    = CellOf( Area.y - m_World.y, m_Rows );
+  Right  = CellOf( Area.x + SDL_max( Area.w, 1 ) - 1 - m_World.x, m_Columns );
+  Bottom = CellOf( Area.y + SDL_max( Area.h, 1 ) - 1 - m_World.y, m_Rows );
+}
+
+
+/***************************************************************************************************
+* LTriggerSet methods
+****************************************************************************************************/
+
+/**
+ * @param World The area the triggers are in.
+ * @param CellSize_px The side of a cell of the index: about the size of the box setting them off.
+ **/
+LTriggerSet::LTriggerSet( const SDL_Rect& World, int CellSize_px )
+  : m_Grid(World, CellSize_px), m_Inside(), m_Found(), m_Hits()
+{;}
+
+
+/**
+ * @brief Removes every trigger, e.g. when a level is left.
+ **/
+void LTriggerSet::clear( void )
+{
+  m_Grid.clear();
+  reset();
+}
+
+
+/**
+ * @return the index of the trigger, reported in the hits.
+ **/
+int LTriggerSet::add( const SDL_Rect& Bounds )
+{
+  return m_Grid.add( Bounds );
+}
+
+
+/**
+ * @brief Forgets which triggers the box is in: the next update reports Enter for all of them, and
+ * no Exit. For a box placed rather than moved, e.g. at the start of a level.
+ **/
+void LTriggerSet::reset( void )
+{
+  m_Inside.clear();
+  m_Hits.clear();
+}
+
+
+/**
+ * @brief Moves the box that sets the triggers off.
+ *
+ * @param Box Where it is now, in world coordinates.
+ * @return The Enter, Stay and Exit events by increasing trigger index, valid until the next update.
+ **/
+const std::vector<LTriggerHit>& LTriggerSet::update( const SDL_Rect& Box )
+{
+  m_Grid.build();
+
+  m_Found.clear();
+  m_Grid.query( Box, m_Found );
+  std::sort( m_Found.begin(), m_Found.end() );
+
+  m_Hits.clear();
+
+  // Both lists are sorted: one merge tells the triggers entered, kept and left
+  size_t Now    = 0;
+  size_t Before = 0;
+
+  while ( Now != m_Found.size() || Before != m_Inside.size() )
+  {
+    if ( Before == m_Inside.size() || ( Now != m_Found.size() && m_Found[Now] < m_Inside[Before] ) )
+    {
+      m_Hits.push_back( LTriggerHit{ m_Found[Now++], LTriggerEvent::Enter } );
+    }
+    else if ( Now == m_Found.size() || m_Inside[Before] < m_Found[Now] )
+    {
+      m_Hits.push_back( LTriggerHit{ m_Inside[Before++], LTriggerEvent::Exit } );
+    }
+    else
+    {
+      m_Hits.push_back( LTriggerHit{ m_Found[Now++], LTriggerEvent::Stay } );
+      ++Before;
+    }
+  }
+
+  m_Inside.swap( m_Found );
+
+  return m_Hits;
+}
+
+
+/**
+ * @return true if the box was inside the trigger at the last update.
+ **/
+bool LTriggerSet::IsInside( int Trigger ) const
+{
+  return std::binary_search( m_Inside.begin(), m_Inside.end(), Trigger );
+}
+
+
+size_t LTriggerSet::GetCount( void ) const
+{
+  return m_Grid.GetCount();
+}
+
+
+const SDL_Rect& LTriggerSet::GetBounds( int Trigger ) const
+{
+  return m_Grid.GetBounds( Trigger );
+}
@@ -0,0 +1,378 @@
+/**
+ * @file LCollision.hpp
+ *
+ * @brief Collision detection shared by the tutorials: narrow phase tests for boxes, circles and box
+ * sets, a sweep-and-prune broad phase that reports the colliding pairs of a whole scene, a uniform
+ * grid for area queries, a bounding volume hierarchy for the static geometry of a level, and trigger
+ * volumes set off by a moving box.
+ **/
+
+#ifndef LCOLLISION_HPP
+#define LCOLLISION_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief A circle: centre and radius, in pixels.
+ **/
+struct LCircle
+{
+  int x, y;
+  int r;
+};
+
+
+/**
+ * @brief Any of the shapes the narrow phase knows, with its bounding box. A box set refers to the
+ * caller's vector, which must outlive the collider.
+ **/
+struct LCollider
+{
+  enum class Shape { Rect, Circle, RectSet };
+
+  Shape                        Type;
+  SDL_Rect                     Bounds;                 // Bounding box; the shape itself for Rect
+  LCircle                      Circle  = { 0, 0, 0 };  // Circle only
+  const std::vector<SDL_Rect>* Rects   = nullptr;      // RectSet only
+
+  static LCollider FromRect   ( const SDL_Rect& );
+  static LCollider FromCircle ( const LCircle& );
+  static LCollider FromRectSet( const std::vector<SDL_Rect>& );
+};
+
+
+/**
+ * @brief Two colliders that overlap, by the index they were added with. A < B.
+ **/
+struct LCollisionPair
+{
+  int A;
+  int B;
+};
+
+
+/*
+ * Narrow phase. Boxes touching along an edge do not collide; a circle collides with what lies
+ * strictly inside its radius.
+ */
+bool CheckCollision( const SDL_Rect&, const SDL_Rect& );
+bool CheckCollision( const LCircle&, const LCircle& );
+bool CheckCollision( const LCircle&, const SDL_Rect& );
+bool CheckCollision( const std::vector<SDL_Rect>&, const SDL_Rect& );
+bool CheckCollision( const std::vector<SDL_Rect>&, const std::vector<SDL_Rect>& );
+bool CheckCollision( const LCollider&, const LCollider& );
+
+
+/**
+ * @brief Result of a swept test: whether a shape moving by a velocity over one step meets another,
+ * how far along the step it does, and the normal of the contact, pointing away from the obstacle.
+ * Shapes that already overlap meet at time 0 with a null normal.
+ **/
+struct LSweepHit
+{
+  bool   Hit     = false;
+  double Time    = 1.0;   // Fraction of the step, in [0, 1)
+  double NormalX = 0.0;
+  double NormalY = 0.0;
+
+  int Travel( int ) const;
+};
+
+
+/*
+ * Swept (continuous) narrow phase: the first shape moves by the velocity, the second stands still.
+ * A fast object cannot tunnel through a thin one, and stops against it instead of short of it.
+ */
+LSweepHit SweepCollision( const SDL_Rect&, double, double, const SDL_Rect& );
+LSweepHit SweepCollision( const LCircle&, double, double, const LCircle& );
+LSweepHit SweepCollision( const LCircle&, double, double, const SDL_Rect& );
+LSweepHit EarliestSweep ( const LSweepHit&, const LSweepHit& );
+
+
+/**
+ * @brief A box set packed for batch tests. The sides of the boxes are kept in separate arrays, four
+ * boxes to a group: a box is tested against a whole group with one SIMD comparison (SSE2 or NEON,
+ * scalar elsewhere). Each group has its bounding box, and so does the set, so that most tests end
+ * before reaching the boxes.
+ *
+ * The boxes are relative to the origin of their set, and the tests take the position of each set:
+ * an object that moves does not need to rebuild its boxes.
+ *
+ * "findHits" tests a circle against every box instead, with no branch: one bit per box, as for
+ * LPackedCircles.
+ **/
+class LPackedRects
+{
+public:
+
+  LPackedRects( void );
+  explicit LPackedRects( const std::vector<SDL_Rect>& );
+
+  void            assign    ( const std::vector<SDL_Rect>& );
+  bool            overlaps  ( const SDL_Rect& ) const;   // Box relative to the origin of the set
+  size_t          findHits  ( const LCircle&, std::vector<Uint32>& ) const;   // Likewise the circle
+  SDL_Rect        GetRect   ( size_t ) const;
+  const SDL_Rect& GetBounds ( void ) const;
+  size_t          GetSize   ( void ) const;
+
+private:
+
+  static constexpr size_t s_LANES = 4;
+
+  bool OverlapsGroup_Pvt( size_t, const SDL_Rect& ) const;
+
+  std::vector<Sint32>   m_Left;         // Padded to a multiple of s_LANES with boxes that never overlap
+  std::vector<Sint32>   m_Top;
+  std::vector<Sint32>   m_Right;
+  std::vector<Sint32>   m_Bottom;
+  std::vector<SDL_Rect> m_GroupBounds;  // One per group of s_LANES boxes
+  SDL_Rect              m_Bounds;
+  size_t                m_Size;
+};
+
+
+/**
+ * @brief Many circles, such as the bullets of a shoot 'em up, packed for testing one circle against
+ * all of them. Centres and radii are kept in separate arrays of floats, four circles to a group, and
+ * a group is tested with a few SIMD operations (SSE2 or NEON, scalar elsewhere): the squared
+ * distance of the centres against the squared sum of the radii, with no square root and no branch.
+ *
+ * "findHits" writes a hit mask, bit i % 32 of word i / 32 set for circle i, and returns the number
+ * of hits: the caller walks only the bits that are set. Floats keep the tests the same as
+ * CheckCollision( LCircle, LCircle ) while distances and radii stay within 4096 pixels, where their
+ * squares are exact.
+ *
+ * Circles are added once and then moved with "set", every frame if need be, without reallocating.
+ **/
+class LPackedCircles
+{
+public:
+
+  LPackedCircles( void );
+  explicit LPackedCircles( const std::vector<LCircle>& );
+
+  void    assign   ( const std::vector<LCircle>& );
+  void    clear    ( void );
+  size_t  add      ( const LCircle& );
+  void    set      ( size_t, const LCircle& );
+  size_t  findHits ( const LCircle&, std::vector<Uint32>& ) const;
+  LCircle GetCircle( size_t ) const;
+  size_t  GetSize  ( void ) const;
+
+private:
+
+  static constexpr size_t s_LANES = 4;
+
+  std::vector<float> m_X;      // Padded to a multiple of s_LANES; the padding is masked out
+  std::vector<float> m_Y;
+  std::vector<float> m_R;
+  size_t             m_Size;
+};
+
+
+/**
+ * @brief One bit per pixel of a sprite, set where the sprite is opaque: pixel-exact collision,
+ * 64 pixels per AND of two words.
+ **/
+class LCollisionMask
+{
+public:
+
+  LCollisionMask( void );
+
+  bool   loadFromSurface( SDL_Surface*, Uint8 = 0x80 );
+  bool   isSet          ( int, int ) const;
+  Uint64 GetBits        ( int, int ) const;
+  int    GetWidth       ( void ) const;
+  int    GetHeight      ( void ) const;
+
+private:
+
+  int                 m_Width;
+  int                 m_Height;
+  int                 m_WordsPerRow;
+  std::vector<Uint64> m_Bits;         // Row by row; bit i of a word is pixel i of its 64 in the row
+};
+
+
+/*
+ * Packed and pixel-exact narrow phase: each shape is given with the position of its origin.
+ */
+bool CheckCollision( const LPackedRects&, int, int, const LPackedRects&, int, int );
+bool CheckCollision( const LPackedRects&, int, int, const SDL_Rect& );
+bool CheckCollision( const LCollisionMask&, int, int, const LCollisionMask&, int, int );
+
+
+/**
+ * @brief Sweep-and-prune broad phase. The colliders of a frame are added between "clear" and
+ * "findPairs"; the bounding boxes are sorted along x, so only boxes whose x extents overlap are
+ * compared, and only pairs whose boxes overlap reach the narrow phase.
+ *
+ * The sorted order is kept between frames: when the same objects are added in the same order and
+ * move a little, re-sorting it is close to linear.
+ **/
+class LBroadPhase
+{
+public:
+
+  LBroadPhase( void );
+
+  void                               clear     ( void );
+  int                                add       ( const LCollider& );
+  const std::vector<LCollisionPair>& findPairs ( void );
+  const LCollider&                   GetCollider( int ) const;
+  size_t                             GetTests  ( void ) const;
+
+private:
+
+  void Sort_Pvt( void );
+
+  std::vector<LCollider>      m_Colliders;
+  std::vector<int>            m_Order;      // Collider indices by increasing Bounds.x
+  std::vector<LCollisionPair> m_Pairs;
+  size_t                      m_Tests;      // Bounding box tests done by the last findPairs
+};
+
+
+/**
+ * @brief Uniform grid over a world area. The boxes of a frame are added between "clear" and
+ * "build"; "build" bins them by cell in two linear passes, into one array of cell entries, and
+ * "query" then visits only the cells an area covers.
+ *
+ * A box spanning several cells is listed in each of them, but reported once per query: only from
+ * the first cell it shares with the area. Boxes outside the world are kept in the border cells.
+ **/
+class LSpatialGrid
+{
+public:
+
+  LSpatialGrid( const SDL_Rect&, int );
+
+  void            clear     ( void );
+  int             add       ( const SDL_Rect& );
+  void            build     ( void );
+  void            query     ( const SDL_Rect&, std::vector<int>& ) const;
+  size_t          GetCount  ( void ) const;
+  const SDL_Rect& GetBounds ( int ) const;
+
+private:
+
+  void GetCells_Pvt( const SDL_Rect&, int&, int&, int&, int& ) const;
+
+  SDL_Rect              m_World;
+  int                   m_CellSize_px;
+  int                   m_Columns;
+  int                   m_Rows;
+  std::vector<SDL_Rect> m_Bounds;       // Per box, by index
+  std::vector<int>      m_CellStarts;   // Per cell, where its boxes start in m_CellBoxes; one more at the end
+  std::vector<int>      m_CellBoxes;    // Box indices, cell after cell
+  bool                  m_IsBuilt;
+};
+
+
+/**
+ * @brief Bounding volume hierarchy over the static boxes of a level (walls, platforms, solid tiles),
+ * built once when the level is loaded. The boxes are split at the median of their centres along the
+ * longest axis, until at most s_LEAF_SIZE are left, so that the tree is balanced and a box or circle
+ * query visits O(log n) nodes plus those it overlaps, wherever the boxes are and however they differ
+ * in size. Where LSpatialGrid is rebuilt every frame for what moves, this is built once and never
+ * updated: the two are meant to be used together.
+ *
+ * The nodes are stored depth first in one array, each left child right after its parent, and the
+ * boxes are copied in the order of the leaves, so a query walks memory mostly forwards. The boxes
+ * keep the index they were given with, which is what the queries report.
+ **/
+class LStaticTree
+{
+public:
+
+  static constexpr int s_LEAF_SIZE = 4;
+
+  LStaticTree( void );
+
+  void            build         ( const std::vector<SDL_Rect>& );
+  void            buildFromTiles( const std::vector<int>&, int, int, int, int = 0 );
+  bool            overlaps      ( const SDL_Rect& ) const;
+  bool            overlaps      ( const LCircle& ) const;
+  void            query         ( const SDL_Rect&, std::vector<int>& ) const;
+  void            query         ( const LCircle&, std::vector<int>& ) const;
+  size_t          GetCount      ( void ) const;
+  const SDL_Rect& GetRect       ( int ) const;
+  size_t          GetNodeCount  ( void ) const;
+  const SDL_Rect& GetNodeBounds ( int ) const;
+
+private:
+
+  static constexpr int s_MAX_DEPTH = 64;   // Of the query stack; a median split reaches log2(n)
+
+  /**
+   * @brief A leaf has Count boxes from First in m_Leaves; an inner node has Count 0, its left child
+   * right after it and its right child at Right.
+   **/
+  struct Node
+  {
+    SDL_Rect Bounds;
+    int      First;
+    int      Count;
+    int      Right;
+  };
+
+  void Build_Pvt( int, int );
+
+  template <typename Shape, typename Visit>
+  bool Walk_Pvt( const Shape&, Visit ) const;
+
+  std::vector<SDL_Rect> m_Rects;    // By index
+  std::vector<Node>     m_Nodes;    // Depth first; the root first
+  std::vector<SDL_Rect> m_Leaves;   // Leaf after leaf
+  std::vector<int>      m_Ids;      // Index of each box of m_Leaves
+};
+
+
+
+/**
+ * @brief What happened to a trigger volume in the last LTriggerSet::update.
+ **/
+enum class LTriggerEvent { Enter, Stay, Exit };
+
+struct LTriggerHit
+{
+  int           Trigger;    // As returned by LTriggerSet::add
+  LTriggerEvent Event;
+};
+
+
+/**
+ * @brief Trigger volumes (doors, switches, the edges of a level) set off by one moving box, such as
+ * the player's.
+ *
+ * The triggers are static: they are added once, and indexed in a LSpatialGrid on the first update.
+ * Each update then tests only the triggers in the cells the box covers, whatever their number, and
+ * reports the changes against the previous update: Enter for a trigger the box has just reached,
+ * Stay while it remains inside, Exit once it has left. A transition acting on Enter fires once,
+ * where polling an overlap every frame would fire again each frame the box stays there.
+ **/
+class LTriggerSet
+{
+public:
+
+  LTriggerSet( const SDL_Rect&, int );
+
+  void                             clear    ( void );
+  int                              add      ( const SDL_Rect& );
+  void                             reset    ( void );
+  const std::vector<LTriggerHit>&  update   ( const SDL_Rect& );
+  bool                             IsInside ( int ) const;
+  size_t                           GetCount ( void ) const;
+  const SDL_Rect&                  GetBounds( int ) const;
+
+private:
+
+  LSpatialGrid             m_Grid;
+  std::vector<int>         m_Inside;   // Triggers the box was in at the last update, sorted
+  std::vector<int>         m_Found;    // Triggers it is in now; storage is kept between updates
+  std::vector<LTriggerHit> m_Hits;
+};
+
+#endif // LCOLLISION_HPP
@@ -0,0 +1,642 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LCollision.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define LCOLLISION_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define LCOLLISION_NEON
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// Sides of the padding boxes: their left side is never left of anything, nor their right side right
+static const Sint32 NeverLeft  = SDL_MAX_SINT32;
+static const Sint32 NeverRight = SDL_MIN_SINT32;
+
+static const int BITS_PER_WORD = 64;
+
+static const size_t HITS_PER_WORD = 32;   // Bits of a word of a hit mask
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static SDL_Rect Translated( SDL_Rect Box, int x, int y )
+{
+  Box.x += x;
+  Box.y += y;
+
+  return Box;
+}
+
+
+/**
+ * @brief Whether a box overlaps any of four boxes given by their sides, with the same edge rule as
+ * CheckCollision( SDL_Rect, SDL_Rect ).
+ **/
+static bool OverlapsAny4( const Sint32* Left, const Sint32* Top, const Sint32* Right, const Sint32* Bottom, const SDL_Rect& Box )
+{
+#if defined(LCOLLISION_SSE2)
+  const __m128i BoxLeft   = _mm_set1_epi32( Box.x );
+  const __m128i BoxTop    = _mm_set1_epi32( Box.y );
+  const __m128i BoxRight  = _mm_set1_epi32( Box.x + Box.w );
+  const __m128i BoxBottom = _mm_set1_epi32( Box.y + Box.h );
+
+  const __m128i OnX = _mm_and_si128( _mm_cmplt_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Left   ) ), BoxRight  ),
+                                     _mm_cmpgt_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Right  ) ), BoxLeft   ) );
+  const __m128i OnY = _mm_and_si128( _mm_cmplt_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Top    ) ), BoxBottom ),
+                                     _mm_cmpgt_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Bottom ) ), BoxTop    ) );
+
+  return _mm_movemask_epi8( _mm_and_si128( OnX, OnY ) ) != 0;
+#elif defined(LCOLLISION_NEON)
+  const uint32x4_t OnX = vandq_u32( vcltq_s32( vld1q_s32( Left   ), vdupq_n_s32( Box.x + Box.w ) ),
+                                    vcgtq_s32( vld1q_s32( Right  ), vdupq_n_s32( Box.x ) ) );
+  const uint32x4_t OnY = vandq_u32( vcltq_s32( vld1q_s32( Top    ), vdupq_n_s32( Box.y + Box.h ) ),
+                                    vcgtq_s32( vld1q_s32( Bottom ), vdupq_n_s32( Box.y ) ) );
+  const uint32x4_t Hit = vandq_u32( OnX, OnY );
+  const uint32x2_t Any = vorr_u32( vget_low_u32( Hit ), vget_high_u32( Hit ) );
+
+  return ( vget_lane_u32( Any, 0 ) | vget_lane_u32( Any, 1 ) ) != 0;
+#else
+  for ( int i = 0; i != 4; ++i )
+  {
+    if ( Left[i] < Box.x + Box.w && Right[i] > Box.x && Top[i] < Box.y + Box.h && Bottom[i] > Box.y )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+#endif
+}
+
+
+#if defined(LCOLLISION_NEON)
+/**
+ * @brief One bit per lane set to all ones, as _mm_movemask_ps does.
+ **/
+static Uint32 MoveMask4( uint32x4_t Lanes )
+{
+  static const uint32_t Weights[4] = { 1, 2, 4, 8 };
+
+  const uint32x4_t Bits = vandq_u32( Lanes, vld1q_u32( Weights ) );
+  uint32x2_t       Sum  = vpadd_u32( vget_low_u32( Bits ), vget_high_u32( Bits ) );
+  Sum                   = vpadd_u32( Sum, Sum );
+
+  return vget_lane_u32( Sum, 0 );
+}
+#endif
+
+
+/**
+ * @brief Which of four circles, given by the arrays of their centres and radii, overlap a circle:
+ * bit i for circle i. The same rule as CheckCollision( LCircle, LCircle ), on squared distances.
+ **/
+static Uint32 CirclesHit4( const float* X, const float* Y, const float* R, const LCircle& Circle )
+{
+  const float x = static_cast<float>( Circle.x );
+  const float y = static_cast<float>( Circle.y );
+  const float r = static_cast<float>( Circle.r );
+
+#if defined(LCOLLISION_SSE2)
+  const __m128 DeltaX = _mm_sub_ps( _mm_loadu_ps( X ), _mm_set1_ps( x ) );
+  const __m128 DeltaY = _mm_sub_ps( _mm_loadu_ps( Y ), _mm_set1_ps( y ) );
+  const __m128 Radius = _mm_add_ps( _mm_loadu_ps( R ), _mm_set1_ps( r ) );
+
+  const __m128 Distance2 = _mm_add_ps( _mm_mul_ps( DeltaX, DeltaX ), _mm_mul_ps( DeltaY, DeltaY ) );
+
+  return static_cast<Uint32>( _mm_movemask_ps( _mm_cmplt_ps( Distance2, _mm_mul_ps( Radius, Radius ) ) ) );
+#elif defined(LCOLLISION_NEON)
+  const float32x4_t DeltaX = vsubq_f32( vld1q_f32( X ), vdupq_n_f32( x ) );
+  const float32x4_t DeltaY = vsubq_f32( vld1q_f32( Y ), vdupq_n_f32( y ) );
+  const float32x4_t Radius = vaddq_f32( vld1q_f32( R ), vdupq_n_f32( r ) );
+
+  const float32x4_t Distance2 = vaddq_f32( vmulq_f32( DeltaX, DeltaX ), vmulq_f32( DeltaY, DeltaY ) );
+
+  return MoveMask4( vcltq_f32( Distance2, vmulq_f32( Radius, Radius ) ) );
+#else
+  Uint32 Hits = 0;
+
+  for ( int i = 0; i != 4; ++i )
+  {
+    const float DeltaX = X[i] - x;
+    const float DeltaY = Y[i] - y;
+    const float Radius = R[i] + r;
+
+    Hits |= static_cast<Uint32>( DeltaX * DeltaX + DeltaY * DeltaY < Radius * Radius ) << i;
+  }
+
+  return Hits;
+#endif
+}
+
+
+/**
+ * @brief Which of four boxes, given by their sides, lie partly inside a circle: bit i for box i. The
+ * same rule as CheckCollision( LCircle, SDL_Rect ): the point of the box closest to the centre, found
+ * with min and max, is within the radius.
+ **/
+static Uint32 BoxesHit4( const Sint32* Left, const Sint32* Top, const Sint32* Right, const Sint32* Bottom, const LCircle& Circle )
+{
+  const float x = static_cast<float>( Circle.x );
+  const float y = static_cast<float>( Circle.y );
+  const float r = static_cast<float>( Circle.r );
+
+#if defined(LCOLLISION_SSE2)
+  const __m128 CentreX = _mm_set1_ps( x );
+  const __m128 CentreY = _mm_set1_ps( y );
+
+  const __m128 ClosestX = _mm_min_ps( _mm_max_ps( CentreX, _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Left  ) ) ) ),
+                                      _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Right  ) ) ) );
+  const __m128 ClosestY = _mm_min_ps( _mm_max_ps( CentreY, _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Top   ) ) ) ),
+                                      _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Bottom ) ) ) );
+
+  const __m128 DeltaX    = _mm_sub_ps( ClosestX, CentreX );
+  const __m128 DeltaY    = _mm_sub_ps( ClosestY, CentreY );
+  const __m128 Distance2 = _mm_add_ps( _mm_mul_ps( DeltaX, DeltaX ), _mm_mul_ps( DeltaY, DeltaY ) );
+
+  return static_cast<Uint32>( _mm_movemask_ps( _mm_cmplt_ps( Distance2, _mm_set1_ps( r * r ) ) ) );
+#elif defined(LCOLLISION_NEON)
+  const float32x4_t CentreX = vdupq_n_f32( x );
+  const float32x4_t CentreY = vdupq_n_f32( y );
+
+  const float32x4_t ClosestX = vminq_f32( vmaxq_f32( CentreX, vcvtq_f32_s32( vld1q_s32( Left ) ) ), vcvtq_f32_s32( vld1q_s32( Right  ) ) );
+  const float32x4_t ClosestY = vminq_f32( vmaxq_f32( CentreY, vcvtq_f32_s32( vld1q_s32( Top  ) ) ), vcvtq_f32_s32( vld1q_s32( Bottom ) ) );
+
+  const float32x4_t DeltaX    = vsubq_f32( ClosestX, CentreX );
+  const float32x4_t DeltaY    = vsubq_f32( ClosestY, CentreY );
+  const float32x4_t Distance2 = vaddq_f32( vmulq_f32( DeltaX, DeltaX ), vmulq_f32( DeltaY, DeltaY ) );
+
+  return MoveMask4( vcltq_f32( Distance2, vdupq_n_f32( r * r ) ) );
+#else
+  Uint32 Hits = 0;
+
+  for ( int i = 0; i != 4; ++i )
+  {
+    const float DeltaX = std::min( std::max( x, static_cast<float>( Left[i] ) ), static_cast<float>( Right [i] ) ) - x;
+    const float DeltaY = std::min( std::max( y, static_cast<float>( Top [i] ) ), static_cast<float>( Bottom[i] ) ) - y;
+
+    Hits |= static_cast<Uint32>( DeltaX * DeltaX + DeltaY * DeltaY < r * r ) << i;
+  }
+
+  return Hits;
+#endif
+}
+
+
+/**
+ * @brief Clears the bits of a hit mask past the last element, then counts the bits set.
+ **/
+static size_t FinishHits( std::vector<Uint32>& Hits, size_t Size )
+{
+  if ( Size % HITS_PER_WORD != 0 )
+  {
+    Hits.back() &= ( Uint32( 1 ) << ( Size % HITS_PER_WORD ) ) - 1;
+  }
+  else
+  {;}
+
+  size_t Count = 0;
+
+  for ( Uint32 Word : Hits )
+  {
+    // Bits set in pairs, nibbles and bytes, then the bytes summed by a multiplication
+    Word  = Word - ( ( Word >> 1 ) & 0x55555555u );
+    Word  = ( Word & 0x33333333u ) + ( ( Word >> 2 ) & 0x33333333u );
+    Word  = ( Word + ( Word >> 4 ) ) & 0x0F0F0F0Fu;
+    Count += ( Word * 0x01010101u ) >> 24;
+  }
+
+  return Count;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Box set to box set. Nothing is tested if the bounds of the sets miss each other; otherwise
+ * each box of a, moved into the space of b, is tested only against the groups of b whose bounds it
+ * touches, four boxes at a time.
+ **/
+bool CheckCollision( const LPackedRects& a, int ax, int ay, const LPackedRects& b, int bx, int by )
+{
+  const int OffsetX = ax - bx;
+  const int OffsetY = ay - by;
+
+  if ( a.GetSize() == 0 || b.GetSize() == 0 || !CheckCollision( Translated( a.GetBounds(), OffsetX, OffsetY ), b.GetBounds() ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  for ( size_t i = 0; i != a.GetSize(); ++i )
+  {
+    if ( b.overlaps( Translated( a.GetRect( i ), OffsetX, OffsetY ) ) )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Box set to box, both in world coordinates.
+ **/
+bool CheckCollision( const LPackedRects& a, int ax, int ay, const SDL_Rect& b )
+{
+  return a.overlaps( Translated( b, -ax, -ay ) );
+}
+
+
+/**
+ * @brief Mask to mask: the rows where the masks overlap are ANDed 64 pixels at a time.
+ **/
+bool CheckCollision( const LCollisionMask& a, int ax, int ay, const LCollisionMask& b, int bx, int by )
+{
+  const SDL_Rect BoxA{ ax, ay, a.GetWidth(), a.GetHeight() };
+  const SDL_Rect BoxB{ bx, by, b.GetWidth(), b.GetHeight() };
+  SDL_Rect       Overlap;
+
+  if ( SDL_IntersectRect( &BoxA, &BoxB, &Overlap ) == SDL_FALSE )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Columns of the overlap in b, and where b's column 0 falls in a
+  const int FirstWord = ( Overlap.x - bx ) / BITS_PER_WORD;
+  const int LastWord  = ( Overlap.x + Overlap.w - 1 - bx ) / BITS_PER_WORD;
+  const int Shift     = bx - ax;
+
+  for ( int y = Overlap.y; y != Overlap.y + Overlap.h; ++y )
+  {
+    for ( int Word = FirstWord; Word <= LastWord; ++Word )
+    {
+      if ( ( b.GetBits( y - by, Word * BITS_PER_WORD ) & a.GetBits( y - ay, Word * BITS_PER_WORD + Shift ) ) != 0 )
+      {
+        return true;
+      }
+      else
+      {;}
+    }
+  }
+
+  return false;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LPackedRects::LPackedRects( void )
+  : m_Bounds{ 0, 0, 0, 0 }, m_Size(0)
+{;}
+
+
+LPackedRects::LPackedRects( const std::vector<SDL_Rect>& Rects )
+  : LPackedRects()
+{
+  assign( Rects );
+}
+
+
+/**
+ * @brief Packs a box set, relative to the origin of the set.
+ **/
+void LPackedRects::assign( const std::vector<SDL_Rect>& Rects )
+{
+  m_Size = Rects.size();
+
+  const size_t Groups = ( m_Size + s_LANES - 1 ) / s_LANES;
+
+  m_Left  .assign( Groups * s_LANES, NeverLeft  );
+  m_Top   .assign( Groups * s_LANES, NeverLeft  );
+  m_Right .assign( Groups * s_LANES, NeverRight );
+  m_Bottom.assign( Groups * s_LANES, NeverRight );
+  m_GroupBounds.assign( Groups, SDL_Rect{ 0, 0, 0, 0 } );
+
+  for ( size_t i = 0; i != m_Size; ++i )
+  {
+    m_Left  [i] = Rects[i].x;
+    m_Top   [i] = Rects[i].y;
+    m_Right [i] = Rects[i].x + Rects[i].w;
+    m_Bottom[i] = Rects[i].y + Rects[i].h;
+  }
+
+  // Bounds of every group, then of the whole set
+  for ( size_t Group = 0; Group != Groups; ++Group )
+  {
+    const std::vector<SDL_Rect> Members( Rects.begin() + static_cast<std::ptrdiff_t>( Group * s_LANES ),
+                                         Rects.begin() + static_cast<std::ptrdiff_t>( std::min( m_Size, ( Group + 1 ) * s_LANES ) ) );
+
+    m_GroupBounds[Group] = LCollider::FromRectSet( Members ).Bounds;
+  }
+
+  m_Bounds = LCollider::FromRectSet( m_GroupBounds ).Bounds;
+}
+
+
+/**
+ * @brief Whether a box, relative to the origin of the set, overlaps any box of the set.
+ **/
+bool LPackedRects::overlaps( const SDL_Rect& Box ) const
+{
+  if ( m_Size == 0 || !CheckCollision( Box, m_Bounds ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  for ( size_t Group = 0; Group != m_GroupBounds.size(); ++Group )
+  {
+    if ( OverlapsGroup_Pvt( Group, Box ) )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Tests a circle, relative to the origin of the set, against every box.
+ *
+ * @param Hits Set to one bit per box, bit i % 32 of word i / 32 for box i, set if it lies partly
+ * inside the circle.
+ * @return The number of boxes hit.
+ **/
+size_t LPackedRects::findHits( const LCircle& Circle, std::vector<Uint32>& Hits ) const
+{
+  Hits.assign( ( m_Size + HITS_PER_WORD - 1 ) / HITS_PER_WORD, 0 );
+
+  for ( size_t First = 0; First < m_Size; First += s_LANES )
+  {
+    Hits[ First / HITS_PER_WORD ] |= BoxesHit4( &m_Left[First], &m_Top[First], &m_Right[First], &m_Bottom[First], Circle ) << ( First % HITS_PER_WORD );
+  }
+
+  return FinishHits( Hits, m_Size );
+}
+
+
+SDL_Rect LPackedRects::GetRect( size_t Index ) const
+{
+  return SDL_Rect{ m_Left[Index], m_Top[Index], m_Right[Index] - m_Left[Index], m_Bottom[Index] - m_Top[Index] };
+}
+
+
+const SDL_Rect& LPackedRects::GetBounds( void ) const
+{
+  return m_Bounds;
+}
+
+
+size_t LPackedRects::GetSize( void ) const
+{
+  return m_Size;
+}
+
+
+bool LPackedRects::OverlapsGroup_Pvt( size_t Group, const SDL_Rect& Box ) const
+{
+  const size_t First = Group * s_LANES;
+
+  return CheckCollision( Box, m_GroupBounds[Group] ) &&
+         OverlapsAny4( &m_Left[First], &m_Top[First], &m_Right[First], &m_Bottom[First], Box );
+}
+
+
+LPackedCircles::LPackedCircles( void )
+  : m_X(), m_Y(), m_R(), m_Size(0)
+{;}
+
+
+LPackedCircles::LPackedCircles( const std::vector<LCircle>& Circles )
+  : LPackedCircles()
+{
+  assign( Circles );
+}
+
+
+void LPackedCircles::assign( const std::vector<LCircle>& Circles )
+{
+  clear();
+
+  for ( const LCircle& Circle : Circles )
+  {
+    add( Circle );
+  }
+}
+
+
+/**
+ * @brief Removes every circle; the arrays keep their storage.
+ **/
+void LPackedCircles::clear( void )
+{
+  m_X.clear();
+  m_Y.clear();
+  m_R.clear();
+  m_Size = 0;
+}
+
+
+/**
+ * @return The index of the circle, by which "findHits" reports it.
+ **/
+size_t LPackedCircles::add( const LCircle& Circle )
+{
+  // A new group of padding circles, whose bits "findHits" clears
+  if ( m_Size == m_X.size() )
+  {
+    m_X.resize( m_Size + s_LANES, 0.0f );
+    m_Y.resize( m_Size + s_LANES, 0.0f );
+    m_R.resize( m_Size + s_LANES, 0.0f );
+  }
+  else
+  {;}
+
+  set( m_Size, Circle );
+
+  return m_Size++;
+}
+
+
+/**
+ * @brief Moves, or resizes, a circle already added.
+ **/
+void LPackedCircles::set( size_t Index, const LCircle& Circle )
+{
+  m_X[Index] = static_cast<float>( Circle.x );
+  m_Y[Index] = static_cast<float>( Circle.y );
+  m_R[Index] = static_cast<float>( Circle.r );
+}
+
+
+/**
+ * @brief Tests a circle against all the circles, a group of four at a time.
+ *
+ * @param Hits Set to one bit per circle, bit i % 32 of word i / 32 for circle i, set if it overlaps.
+ * @return The number of circles hit.
+ **/
+size_t LPackedCircles::findHits( const LCircle& Circle, std::vector<Uint32>& Hits ) const
+{
+  Hits.assign( ( m_Size + HITS_PER_WORD - 1 ) / HITS_PER_WORD, 0 );
+
+  for ( size_t First = 0; First < m_Size; First += s_LANES )
+  {
+    Hits[ First / HITS_PER_WORD ] |= CirclesHit4( &m_X[First], &m_Y[First], &m_R[First], Circle ) << ( First % HITS_PER_WORD );
+  }
+
+  return FinishHits( Hits, m_Size );
+}
+
+
+LCircle LPackedCircles::GetCircle( size_t Index ) const
+{
+  return LCircle{ static_cast<int>( m_X[Index] ), static_cast<int>( m_Y[Index] ), static_cast<int>( m_R[Index] ) };
+}
+
+
+size_t LPackedCircles::GetSize( void ) const
+{
+  return m_Size;
+}
+
+
+LCollisionMask::LCollisionMask( void )
+  : m_Width(0), m_Height(0), m_WordsPerRow(0)
+{;}
+
+
+/**
+ * @brief Builds the mask of a surface. Pixels whose alpha reaches the threshold are set; if the
+ * surface has a colour key, its pixels count as transparent.
+ *
+ * @param Source The surface; it is not modified.
+ * @param AlphaThreshold Lowest alpha of a solid pixel. Defaults to half opacity.
+ * @return true if successful; false otherwise
+ **/
+bool LCollisionMask::loadFromSurface( SDL_Surface* Source, Uint8 AlphaThreshold )
+{
+  m_Width  = 0;
+  m_Height = 0;
+  m_Bits.clear();
+
+  if ( Source == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Converting to a format with alpha turns the colour key into transparency
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Source, SDL_PIXELFORMAT_ARGB8888, 0 );
+
+  if ( Converted == NULL || SDL_LockSurface( Converted ) != 0 )
+  {
+    printf( "\nUnable to build collision mask! SDL Error: %s", SDL_GetError() );
+    SDL_FreeSurface( Converted );
+    return false;
+  }
+  else
+  {;}
+
+  m_Width       = Converted->w;
+  m_Height      = Converted->h;
+  m_WordsPerRow = ( m_Width + BITS_PER_WORD - 1 ) / BITS_PER_WORD;
+  m_Bits.assign( static_cast<size_t>( m_WordsPerRow ) * static_cast<size_t>( m_Height ), 0 );
+
+  for ( int y = 0; y != m_Height; ++y )
+  {
+    const Uint32* Row  = reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( Converted->pixels ) + y * Converted->pitch );
+    Uint64*       Bits = &m_Bits[ static_cast<size_t>( y ) * static_cast<size_t>( m_WordsPerRow ) ];
+
+    for ( int x = 0; x != m_Width; ++x )
+    {
+      if ( ( Row[x] >> 24 ) >= AlphaThreshold )
+      {
+        Bits[ x / BITS_PER_WORD ] |= Uint64( 1 ) << ( x % BITS_PER_WORD );
+      }
+      else
+      {;}
+    }
+  }
+
+  SDL_UnlockSurface( Converted );
+  SDL_FreeSurface( Converted );
+
+  return true;
+}
+
+
+bool LCollisionMask::isSet( int x, int y ) const
+{
+  return ( GetBits( y, x ) & 1 ) != 0;
+}
+
+
+/**
+ * @brief The 64 pixels of a row starting at a column, one per bit; pixels outside the mask are 0.
+ *
+ * @param Row
+ * @param Column May be negative or beyond the width.
+ **/
+Uint64 LCollisionMask::GetBits( int Row, int Column ) const
+{
+  if ( Row < 0 || Row >= m_Height )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  const Uint64* Words = &m_Bits[ static_cast<size_t>( Row ) * static_cast<size_t>( m_WordsPerRow ) ];
+
+  // Word holding the first pixel, rounding towards minus infinity, and the pixel's place in it
+  const int Word  = ( Column >= 0 ) ? Column / BITS_PER_WORD : -( ( BITS_PER_WORD - 1 - Column ) / BITS_PER_WORD );
+  const int Shift = Column - Word * BITS_PER_WORD;
+
+  const Uint64 Low  = ( Word     >= 0 && Word     < m_WordsPerRow ) ? Words[Word]     : 0;
+  const Uint64 High = ( Word + 1 >= 0 && Word + 1 < m_WordsPerRow ) ? Words[Word + 1] : 0;
+
+  return ( Shift == 0 ) ? Low : ( Low >> Shift ) | ( High << ( BITS_PER_WORD - Shift ) );
+}
+
+
+int LCollisionMask::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LCollisionMask::GetHeight( void ) const
+{
+  return m_Height;
+}
@@ -0,0 +1,340 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LCollision.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief The smallest box holding both.
+ **/
+static SDL_Rect Union( const SDL_Rect& a, const SDL_Rect& b )
+{
+  const int Left   = std::min( a.x, b.x );
+  const int Top    = std::min( a.y, b.y );
+  const int Right  = std::max( a.x + a.w, b.x + b.w );
+  const int Bottom = std::max( a.y + a.h, b.y + b.h );
+
+  return SDL_Rect{ Left, Top, Right - Left, Bottom - Top };
+}
+
+
+/**
+ * @brief Twice the centre of a box along an axis, 0 for x and 1 for y: integer, and as good for
+ * comparing.
+ **/
+static int Centre2( const SDL_Rect& Box, int Axis )
+{
+  return ( Axis == 0 ) ? 2 * Box.x + Box.w : 2 * Box.y + Box.h;
+}
+
+
+/***************************************************************************************************
+* LStaticTree methods
+****************************************************************************************************/
+
+LStaticTree::LStaticTree( void )
+  : m_Rects(), m_Nodes(), m_Leaves(), m_Ids()
+{;}
+
+
+/**
+ * @brief Builds the tree over a list of boxes, replacing the previous one.
+ *
+ * @param Rects The boxes; their indices in the list are what the queries report.
+ **/
+void LStaticTree::build( const std::vector<SDL_Rect>& Rects )
+{
+  m_Rects = Rects;
+  m_Nodes.clear();
+  m_Leaves.clear();
+  m_Ids.resize( m_Rects.size() );
+
+  for ( size_t Box = 0; Box != m_Ids.size(); ++Box )
+  {
+    m_Ids[Box] = static_cast<int>( Box );
+  }
+
+  if ( m_Rects.empty() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // Halving more than s_LEAF_SIZE boxes leaves at least 2 in a leaf: fewer than n nodes
+  m_Nodes.reserve( m_Rects.size() );
+
+  Build_Pvt( 0, static_cast<int>( m_Rects.size() ) );
+
+  m_Leaves.reserve( m_Ids.size() );
+
+  for ( const int Box : m_Ids )
+  {
+    m_Leaves.push_back( m_Rects[Box] );
+  }
+}
+
+
+/**
+ * @brief Builds the tree over the solid tiles of a tile map. Solid tiles next to each other in a
+ * row become one box, and a box grows down over the rows below that have a run with the same ends:
+ * a wall or a floor is a few boxes rather than one per tile.
+ *
+ * @param Tiles   Tile types, row after row; the map has Tiles.size() / Columns rows.
+ * @param Columns Tiles in a row.
+ * @param TileW   Width of a tile, in pixels.
+ * @param TileH   Height of a tile, in pixels.
+ * @param Empty   The type of the tiles that are not solid.
+ **/
+void LStaticTree::buildFromTiles( const std::vector<int>& Tiles, int Columns, int TileW, int TileH, int Empty )
+{
+  std::vector<SDL_Rect> Rects;
+
+  if ( Columns <= 0 || TileW <= 0 || TileH <= 0 )
+  {
+    printf( "\nLStaticTree: invalid tile map of %d columns, tiles of %dx%d!", Columns, TileW, TileH );
+    build( Rects );
+    return;
+  }
+  else
+  {;}
+
+  const int Rows = static_cast<int>( Tiles.size() / static_cast<size_t>( Columns ) );
+
+  // Per column, the box whose run started there in the row above; -1 if none
+  std::vector<int> Above( static_cast<size_t>( Columns ), -1 );
+  std::vector<int> Current( static_cast<size_t>( Columns ), -1 );
+
+  for ( int Row = 0; Row != Rows; ++Row )
+  {
+    const int* Line = Tiles.data() + static_cast<size_t>( Row ) * Columns;
+
+    std::fill( Current.begin(), Current.end(), -1 );
+
+    for ( int Column = 0; Column != Columns; )
+    {
+      if ( Line[Column] == Empty )
+      {
+        ++Column;
+        continue;
+      }
+      else
+      {;}
+
+      const int Start = Column;
+
+      while ( Column != Columns && Line[Column] != Empty )
+      {
+        ++Column;
+      }
+
+      const int Width = ( Column - Start ) * TileW;
+      const int Box   = Above[Start];
+
+      if ( Box != -1 && Rects[Box].w == Width )
+      {
+        Rects[Box].h += TileH;
+        Current[Start] = Box;
+      }
+      else
+      {
+        Rects.push_back( SDL_Rect{ Start * TileW, Row * TileH, Width, TileH } );
+        Current[Start] = static_cast<int>( Rects.size() ) - 1;
+      }
+    }
+
+    Above.swap( Current );
+  }
+
+  build( Rects );
+}
+
+
+/**
+ * @return Whether any box overlaps the one given; boxes touching along an edge do not.
+ **/
+bool LStaticTree::overlaps( const SDL_Rect& Area ) const
+{
+  return Walk_Pvt( Area, []( int ) { return true; } );
+}
+
+
+/**
+ * @return Whether any box lies partly inside the circle.
+ **/
+bool LStaticTree::overlaps( const LCircle& Circle ) const
+{
+  return Walk_Pvt( Circle, []( int ) { return true; } );
+}
+
+
+/**
+ * @brief Finds the boxes that overlap an area, each once.
+ *
+ * @param Boxes Where their indices are appended, in the order of the leaves.
+ **/
+void LStaticTree::query( const SDL_Rect& Area, std::vector<int>& Boxes ) const
+{
+  Walk_Pvt( Area, [&Boxes]( int Box ) { Boxes.push_back( Box ); return false; } );
+}
+
+
+/**
+ * @brief Finds the boxes that lie partly inside a circle, each once.
+ *
+ * @param Boxes Where their indices are appended, in the order of the leaves.
+ **/
+void LStaticTree::query( const LCircle& Circle, std::vector<int>& Boxes ) const
+{
+  Walk_Pvt( Circle, [&Boxes]( int Box ) { Boxes.push_back( Box ); return false; } );
+}
+
+
+size_t LStaticTree::GetCount( void ) const
+{
+  return m_Rects.size();
+}
+
+
+const SDL_Rect& LStaticTree::GetRect( int Box ) const
+{
+  return m_Rects[Box];
+}
+
+
+size_t LStaticTree::GetNodeCount( void ) const
+{
+  return m_Nodes.size();
+}
+
+
+/**
+ * @brief The bounds of a node, the root being 0: for drawing the tree.
+ **/
+const SDL_Rect& LStaticTree::GetNodeBounds( int Node ) const
+{
+  return m_Nodes[Node].Bounds;
+}
+
+
+/**
+ * @brief Makes the node of Count boxes of m_Ids from First, and its children: the boxes are split in
+ * two halves by the median of their centres along the axis where the centres spread the most.
+ **/
+void LStaticTree::Build_Pvt( int First, int Count )
+{
+  const int Index = static_cast<int>( m_Nodes.size() );
+  int*      Ids   = m_Ids.data() + First;
+
+  SDL_Rect Bounds = m_Rects[ Ids[0] ];
+  int      Low [2] = { Centre2( Bounds, 0 ), Centre2( Bounds, 1 ) };
+  int      High[2] = { Low[0], Low[1] };
+
+  for ( int Box = 1; Box != Count; ++Box )
+  {
+    const SDL_Rect& Rect = m_Rects[ Ids[Box] ];
+
+    Bounds = Union( Bounds, Rect );
+
+    for ( int Axis = 0; Axis != 2; ++Axis )
+    {
+      Low [Axis] = std::min( Low [Axis], Centre2( Rect, Axis ) );
+      High[Axis] = std::max( High[Axis], Centre2( Rect, Axis ) );
+    }
+  }
+
+  m_Nodes.push_back( Node{ Bounds, First, Count, 0 } );
+
+  if ( Count <= s_LEAF_SIZE )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // Boxes sharing a centre are still split by count, so that the depth stays log2(n)
+  const int Axis = ( High[0] - Low[0] >= High[1] - Low[1] ) ? 0 : 1;
+  const int Half = Count / 2;
+
+  std::nth_element( Ids, Ids + Half, Ids + Count, [this, Axis]( int a, int b )
+  {
+    return Centre2( m_Rects[a], Axis ) < Centre2( m_Rects[b], Axis );
+  } );
+
+  m_Nodes[Index].Count = 0;
+
+  Build_Pvt( First, Half );
+
+  m_Nodes[Index].Right = static_cast<int>( m_Nodes.size() );
+
+  Build_Pvt( First + Half, Count - Half );
+}
+
+
+/**
+ * @brief Visits the boxes that overlap a shape, down the nodes whose bounds overlap it; the ones
+ * left for later wait on a stack.
+ *
+ * @param Visit Called with the index of each box; returning true ends the walk.
+ * @return Whether Visit ended it.
+ **/
+template <typename Shape, typename Visit>
+bool LStaticTree::Walk_Pvt( const Shape& Area, Visit Visitor ) const
+{
+  if ( m_Nodes.empty() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  int Stack[s_MAX_DEPTH];
+  int Size  = 0;
+  int Index = 0;
+
+  for ( ;; )
+  {
+    const Node& Current = m_Nodes[Index];
+
+    if ( CheckCollision( Area, Current.Bounds ) )
+    {
+      if ( Current.Count == 0 )
+      {
+        Stack[Size++] = Current.Right;
+        ++Index;
+        continue;
+      }
+      else
+      {;}
+
+      for ( int Box = Current.First; Box != Current.First + Current.Count; ++Box )
+      {
+        if ( CheckCollision( Area, m_Leaves[Box] ) && Visitor( m_Ids[Box] ) )
+        {
+          return true;
+        }
+        else
+        {;}
+      }
+    }
+    else
+    {;}
+
+    if ( Size == 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    Index = Stack[--Size];
+  }
+}
@@ -0,0 +1,244 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LDebugDraw.hpp"
+#include "LPrimitiveBatch.hpp"
+
+#include <cmath>
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+static LPrimitiveBatch g_Batch;
+static bool            g_Visible    = false;
+static bool            g_PathChosen = false;   // The batch's path is picked at the first render
+static int             g_CameraX    = 0;
+static int             g_CameraY    = 0;
+
+// Circles are drawn as polygons of this many sides
+static constexpr int g_CIRCLE_SIDES = 24;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief F3 shows or hides the overlay.
+ **/
+void LDebugDraw::HandleEvent_Pvt( const SDL_Event& Event )
+{
+  if ( Event.type == SDL_KEYDOWN && Event.key.repeat == 0 && Event.key.keysym.sym == SDLK_F3 )
+  {
+    SetVisible_Pvt( !g_Visible );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Hiding the overlay also drops the shapes pushed so far in the frame.
+ **/
+void LDebugDraw::SetVisible_Pvt( bool Visible )
+{
+  if ( !Visible )
+  {
+    g_Batch.begin();
+  }
+  else
+  {;}
+
+  g_Visible = Visible;
+}
+
+
+bool LDebugDraw::IsVisible_Pvt( void )
+{
+  return g_Visible;
+}
+
+
+/**
+ * @brief Sets the world position of the window's top left corner for the shapes that follow; 0, 0
+ * pushes in window coordinates, as for a HUD.
+ **/
+void LDebugDraw::SetCamera_Pvt( int X, int Y )
+{
+  g_CameraX = X;
+  g_CameraY = Y;
+}
+
+
+void LDebugDraw::Point_Pvt( int X, int Y, SDL_Color Colour )
+{
+  if ( g_Visible )
+  {
+    g_Batch.addPoint( X - g_CameraX, Y - g_CameraY, Colour );
+  }
+  else
+  {;}
+}
+
+
+void LDebugDraw::Line_Pvt( int X1, int Y1, int X2, int Y2, SDL_Color Colour )
+{
+  if ( g_Visible )
+  {
+    g_Batch.addLine( X1 - g_CameraX, Y1 - g_CameraY, X2 - g_CameraX, Y2 - g_CameraY, Colour );
+  }
+  else
+  {;}
+}
+
+
+void LDebugDraw::Rect_Pvt( const SDL_Rect& Rect, SDL_Color Colour )
+{
+  if ( g_Visible )
+  {
+    g_Batch.addRect( SDL_Rect{ Rect.x - g_CameraX, Rect.y - g_CameraY, Rect.w, Rect.h }, Colour );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief A filled rectangle; with an alpha below 255 it tints what is under it.
+ **/
+void LDebugDraw::FillRect_Pvt( const SDL_Rect& Rect, SDL_Color Colour )
+{
+  if ( g_Visible )
+  {
+    g_Batch.addFillRect( SDL_Rect{ Rect.x - g_CameraX, Rect.y - g_CameraY, Rect.w, Rect.h }, Colour );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief The outline of a circle, as a polygon whose corners are on it; the sides are joined end to
+ * start, so the DrawCalls path submits them with one SDL_RenderDrawLines.
+ **/
+void LDebugDraw::Circle_Pvt( int X, int Y, int Radius, SDL_Color Colour )
+{
+  if ( !g_Visible || Radius <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  static float s_Cos[g_CIRCLE_SIDES + 1];
+  static float s_Sin[g_CIRCLE_SIDES + 1];
+  static bool  s_Ready = false;
+
+  if ( !s_Ready )
+  {
+    for ( int i = 0; i <= g_CIRCLE_SIDES; ++i )
+    {
+      const double Angle = 6.283185307179586 * ( i % g_CIRCLE_SIDES ) / g_CIRCLE_SIDES;
+
+      s_Cos[i] = static_cast<float>( std::cos( Angle ) );
+      s_Sin[i] = static_cast<float>( std::sin( Angle ) );
+    }
+
+    s_Ready = true;
+  }
+  else
+  {;}
+
+  const float CentreX = static_cast<float>( X - g_CameraX );
+  const float CentreY = static_cast<float>( Y - g_CameraY );
+  const float R       = static_cast<float>( Radius );
+
+  int PreviousX = static_cast<int>( std::lround( CentreX + R ) );
+  int PreviousY = static_cast<int>( std::lround( CentreY ) );
+
+  for ( int i = 1; i <= g_CIRCLE_SIDES; ++i )
+  {
+    const int NextX = static_cast<int>( std::lround( CentreX + R * s_Cos[i] ) );
+    const int NextY = static_cast<int>( std::lround( CentreY + R * s_Sin[i] ) );
+
+    g_Batch.addLine( PreviousX, PreviousY, NextX, NextY, Colour );
+
+    PreviousX = NextX;
+    PreviousY = NextY;
+  }
+}
+
+
+/**
+ * @brief The lines of a grid of CellW x CellH cells covering Area, borders included: the cells of a
+ * spatial index or a tile map. Every line is a shape, so pass the visible cells, not a whole level.
+ **/
+void LDebugDraw::Grid_Pvt( const SDL_Rect& Area, int CellW, int CellH, SDL_Color Colour )
+{
+  if ( !g_Visible || CellW <= 0 || CellH <= 0 || Area.w <= 0 || Area.h <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const int Left   = Area.x - g_CameraX;
+  const int Top    = Area.y - g_CameraY;
+  const int Right  = Left + Area.w;
+  const int Bottom = Top  + Area.h;
+
+  for ( int x = Left; x <= Right; x += CellW )
+  {
+    g_Batch.addLine( x, Top, x, Bottom, Colour );
+  }
+
+  for ( int y = Top; y <= Bottom; y += CellH )
+  {
+    g_Batch.addLine( Left, y, Right, y, Colour );
+  }
+}
+
+
+/**
+ * @brief Draws the shapes of the frame over it, with alpha blending, then forgets them and resets
+ * the camera. Call it last, just before SDL_RenderPresent.
+ *
+ * The path is the renderer's best (LPrimitiveBatch::GetBestPath), chosen at the first call; if it
+ * is not the default one, the shapes of that first frame are dropped.
+ **/
+void LDebugDraw::Render_Pvt( SDL_Renderer* Renderer_Ptr )
+{
+  if ( !g_PathChosen )
+  {
+    const LPrimitivePath Best = LPrimitiveBatch::GetBestPath( Renderer_Ptr );
+
+    if ( Best != g_Batch.GetPath() )
+    {
+      g_Batch.setPath( Best );
+    }
+    else
+    {;}
+
+    g_PathChosen = true;
+  }
+  else
+  {;}
+
+  if ( g_Batch.GetShapeCount() != 0 )
+  {
+    SDL_BlendMode Previous = SDL_BLENDMODE_NONE;
+
+    SDL_GetRenderDrawBlendMode( Renderer_Ptr, &Previous );
+    SDL_SetRenderDrawBlendMode( Renderer_Ptr, SDL_BLENDMODE_BLEND );
+    g_Batch.flush( Renderer_Ptr );
+    SDL_SetRenderDrawBlendMode( Renderer_Ptr, Previous );
+  }
+  else
+  {;}
+
+  g_CameraX = 0;
+  g_CameraY = 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file LDebugDraw.hpp
+ *
+ * @brief Debug overlay: any module pushes colliders, cells and cameras during the frame, and they
+ * are drawn over it in one LPrimitiveBatch flush. Compiled out of release builds.
+ **/
+
+#ifndef LDEBUGDRAW_HPP
+#define LDEBUGDRAW_HPP
+
+#include <SDL.h>
+
+/**
+ * 1 compiles the overlay in, 0 turns every call into an empty inline function. It follows NDEBUG
+ * unless the program defines it: -DLDEBUGDRAW_ENABLED=1 keeps the overlay in an optimised build.
+ **/
+#if !defined(LDEBUGDRAW_ENABLED)
+  #if defined(NDEBUG)
+    #define LDEBUGDRAW_ENABLED 0
+  #else
+    #define LDEBUGDRAW_ENABLED 1
+  #endif
+#endif
+
+
+/**
+ * @brief Frame-wide list of debug shapes, with static functions only, so that it needs no object
+ * to be passed around.
+ *
+ * Shapes are in world coordinates, moved by the camera of the last "setCamera"; "render" draws them
+ * over the frame, forgets them and resets the camera to the window. The overlay starts hidden and F3
+ * toggles it ("handleEvent"): while hidden every push returns at once, so that a debug build
+ * measures as it would without it.
+ *
+ * With LDEBUGDRAW_ENABLED at 0 the functions are empty and inline, and "isVisible" is a constant
+ * false: calls, and the loops that only feed them behind an "if ( LDebugDraw::isVisible() )", are
+ * removed by the compiler, with no branch or allocation left. The library always builds the _Pvt
+ * functions, so that a program and Engine_Lib built with different settings still link.
+ *
+ * Not thread safe: push from the thread that renders.
+ **/
+class LDebugDraw
+{
+public:
+
+#if LDEBUGDRAW_ENABLED
+
+  static void handleEvent ( const SDL_Event& Event )                                { HandleEvent_Pvt( Event ); }
+  static void setVisible  ( bool Visible )                                          { SetVisible_Pvt( Visible ); }
+  static bool isVisible   ( void )                                                  { return IsVisible_Pvt(); }
+  static void setCamera   ( int X, int Y )                                          { SetCamera_Pvt( X, Y ); }
+  static void point       ( int X, int Y, SDL_Color Colour )                        { Point_Pvt( X, Y, Colour ); }
+  static void line        ( int X1, int Y1, int X2, int Y2, SDL_Color Colour )      { Line_Pvt( X1, Y1, X2, Y2, Colour ); }
+  static void rect        ( const SDL_Rect& Rect, SDL_Color Colour )                { Rect_Pvt( Rect, Colour ); }
+  static void fillRect    ( const SDL_Rect& Rect, SDL_Color Colour )                { FillRect_Pvt( Rect, Colour ); }
+  static void circle      ( int X, int Y, int Radius, SDL_Color Colour )            { Circle_Pvt( X, Y, Radius, Colour ); }
+  static void grid        ( const SDL_Rect& Area, int CellW, int CellH, SDL_Color Colour ) { Grid_Pvt( Area, CellW, CellH, Colour ); }
+  static void render      ( SDL_Renderer* Renderer_Ptr )                            { Render_Pvt( Renderer_Ptr ); }
+
+#else
+
+  static void           handleEvent ( const SDL_Event& )                            {;}
+  static void           setVisible  ( bool )                                        {;}
+  static constexpr bool isVisible   ( void )                                        { return false; }
+  static void           setCamera   ( int, int )                                    {;}
+  static void           point       ( int, int, SDL_Color )                         {;}
+  static void           line        ( int, int, int, int, SDL_Color )               {;}
+  static void           rect        ( const SDL_Rect&, SDL_Color )                  {;}
+  static void           fillRect    ( const SDL_Rect&, SDL_Color )                  {;}
+  static void           circle      ( int, int, int, SDL_Color )                    {;}
+  static void           grid        ( const SDL_Rect&, int, int, SDL_Color )        {;}
+  static void           render      ( SDL_Renderer* )                               {;}
+
+#endif
+
+private:
+
+  static void HandleEvent_Pvt ( const SDL_Event& );
+  static void SetVisible_Pvt  ( bool );
+  static bool IsVisible_Pvt   ( void );
+  static void SetCamera_Pvt   ( int, int );
+  static void Point_Pvt       ( int, int, SDL_Color );
+  static void Line_Pvt        ( int, int, int, int, SDL_Color );
+  static void Rect_Pvt        ( const SDL_Rect&, SDL_Color );
+  static void FillRect_Pvt    ( const SDL_Rect&, SDL_Color );
+  static void Circle_Pvt      ( int, int, int, SDL_Color );
+  static void Grid_Pvt        ( const SDL_Rect&, int, int, SDL_Color );
+  static void Render_Pvt      ( SDL_Renderer* );
+};
+
+#endif // LDEBUGDRAW_HPP
@@ -0,0 +1,638 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LDrawList.hpp"
+#include "LPerfHarness.hpp"
+#include "colours.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const SDL_Color NoModulation{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+static constexpr int RADIX_BITS   = 8;
+static constexpr int RADIX_PASSES = 64 / RADIX_BITS;
+static constexpr int RADIX_SIZE   = 1 << RADIX_BITS;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief The rank of a blend mode in the keys: opaque first, then the usual modes, custom ones last.
+ **/
+static Uint32 BlendRank( SDL_BlendMode Mode )
+{
+  switch ( Mode )
+  {
+    case SDL_BLENDMODE_NONE:  return 0;
+    case SDL_BLENDMODE_BLEND: return 1;
+    case SDL_BLENDMODE_ADD:   return 2;
+    case SDL_BLENDMODE_MOD:   return 3;
+    case SDL_BLENDMODE_MUL:   return 4;
+    default:                  return 5;
+  }
+}
+
+
+/**
+ * @brief Pixels of a destination inside a viewport of Width x Height.
+ **/
+static double VisibleArea( const SDL_FRect& Destination, int Width, int Height )
+{
+  const float W = std::min( Destination.x + Destination.w, static_cast<float>( Width  ) ) - std::max( Destination.x, 0.0f );
+  const float H = std::min( Destination.y + Destination.h, static_cast<float>( Height ) ) - std::max( Destination.y, 0.0f );
+
+  return ( W > 0.0f && H > 0.0f ) ? static_cast<double>( W ) * static_cast<double>( H ) : 0.0;
+}
+
+
+/***************************************************************************************************
+* LDrawList methods
+****************************************************************************************************/
+
+LDrawList::LDrawList( void )
+  : m_Textures(), m_OpaqueTextures(), m_Items(), m_Entries(), m_Scratch(), m_Vertices(), m_Indices(), m_DepthFirst{ 0, 0, 0, 0 },
+    m_Frame(1), m_NextId(1), m_IsClearQueued(false), m_ClearColour(NoModulation), m_DrawCalls(0), m_StateChanges(0),
+    m_Culled(0), m_Overdraw(0.0)
+{
+  m_Items.reserve( s_RESERVED_ITEMS );
+  m_Entries.reserve( s_RESERVED_ITEMS );
+}
+
+
+/**
+ * @brief Chooses how the draws of a layer are ordered; every layer starts ordered by state.
+ **/
+void LDrawList::setOrder( Uint8 Layer, LDrawOrder Order )
+{
+  const Uint64 Bit = Uint64(1) << ( Layer % 64 );
+
+  if ( Order == LDrawOrder::Depth )
+  {
+    m_DepthFirst[Layer / 64] |= Bit;
+  }
+  else
+  {
+    m_DepthFirst[Layer / 64] &= ~Bit;
+  }
+}
+
+
+/**
+ * @brief Declares whether all the texels of a blending texture are opaque, as those of a background
+ * with a colour key it does not use: its sprites that are not faded can then hide what is under them.
+ **/
+void LDrawList::setOpaque( SDL_Texture* Texture_Ptr, bool IsOpaque )
+{
+  if ( IsOpaque )
+  {
+    m_OpaqueTextures.insert( Texture_Ptr );
+  }
+  else
+  {
+    m_OpaqueTextures.erase( Texture_Ptr );
+  }
+
+  // Read again at its next use
+  auto Found = m_Textures.find( Texture_Ptr );
+
+  if ( Found != m_Textures.end() )
+  {
+    Found->second.Frame = 0;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Starts a new frame. Queued draws are discarded, but the allocated storage is kept, and the
+ * blend modes and sizes of the textures will be read again.
+ **/
+void LDrawList::begin( void )
+{
+  m_Items.clear();
+  m_Entries.clear();
+
+  m_IsClearQueued = false;
+
+  ++m_Frame;
+
+  // Ids must only differ within a frame: when they run out, the textures still in use get new ones
+  if ( m_NextId > s_MAX_TEXTURES )
+  {
+    m_Textures.clear();
+    m_NextId = 1;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Queues the clear of the render target, done first by "flush" unless a sprite hides it.
+ **/
+void LDrawList::clear( SDL_Color Colour )
+{
+  m_IsClearQueued = true;
+  m_ClearColour   = Colour;
+}
+
+
+/**
+ * @brief Queues a sprite, with the same placement rules as LTexture::render.
+ *
+ * @param Layer Drawn after the lower ones.
+ * @param Depth Order within the layer, lower first.
+ * @param Texture_Ptr The texture to sample from.
+ * @param x x position of the sprite.
+ * @param y y position of the sprite.
+ * @param Clip Portion of the texture to draw. Defaults to NULL (the whole texture).
+ **/
+void LDrawList::add( Uint8 Layer, float Depth, SDL_Texture* Texture_Ptr, int x, int y, const SDL_Rect* Clip )
+{
+  const TextureInfo* Info_Ptr = FindTexture_Pvt( Texture_Ptr );
+
+  if ( Info_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect  Whole{ 0, 0, Info_Ptr->Width, Info_Ptr->Height };
+  const SDL_Rect& Source = ( Clip != NULL ) ? *Clip : Whole;
+
+  add( Layer, Depth, Texture_Ptr, Source, SDL_Rect{ x, y, Source.w, Source.h }, NoModulation );
+}
+
+
+/**
+ * @brief Queues a tinted or faded sprite.
+ *
+ * @param Clip Portion of the texture to draw.
+ * @param Destination Where to draw the clip in the render target.
+ * @param Modulation Multiplies the texels, for this sprite only.
+ **/
+void LDrawList::add( Uint8 Layer, float Depth, SDL_Texture* Texture_Ptr, const SDL_Rect& Clip, const SDL_Rect& Destination,
+                     SDL_Color Modulation )
+{
+  const SDL_FRect FloatClip{ static_cast<float>( Clip.x ), static_cast<float>( Clip.y ),
+                             static_cast<float>( Clip.w ), static_cast<float>( Clip.h ) };
+  const SDL_FRect FloatDestination{ static_cast<float>( Destination.x ), static_cast<float>( Destination.y ),
+                                    static_cast<float>( Destination.w ), static_cast<float>( Destination.h ) };
+
+  add( Layer, Depth, Texture_Ptr, FloatClip, FloatDestination, Modulation );
+}
+
+
+/**
+ * @brief Queues a sprite in floating point, for sub-pixel placement: all the others end here.
+ *
+ * @param Clip Portion of the texture to draw, in texels.
+ * @param Destination Where to draw the clip in the render target.
+ * @param Modulation Multiplies the texels, for this sprite only.
+ **/
+void LDrawList::add( Uint8 Layer, float Depth, SDL_Texture* Texture_Ptr, const SDL_FRect& Clip, const SDL_FRect& Destination,
+                     SDL_Color Modulation )
+{
+  const TextureInfo* Info_Ptr = FindTexture_Pvt( Texture_Ptr );
+
+  if ( Info_Ptr == nullptr || Info_Ptr->Width == 0 || Info_Ptr->Height == 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const float InverseW = 1.0f / static_cast<float>( Info_Ptr->Width );
+  const float InverseH = 1.0f / static_cast<float>( Info_Ptr->Height );
+
+  Item Sprite;
+
+  Sprite.Texture_Ptr = Texture_Ptr;
+  Sprite.Draw        = nullptr;
+  Sprite.Data        = nullptr;
+  Sprite.Clip        = SDL_FRect{ Clip.x * InverseW, Clip.y * InverseH, Clip.w * InverseW, Clip.h * InverseH };
+  Sprite.Destination = Destination;
+  Sprite.Modulation  = Modulation;
+  Sprite.IsOpaque    = ( Info_Ptr->Blend == BlendRank( SDL_BLENDMODE_NONE ) ) ||
+                       ( Info_Ptr->IsOpaque && Info_Ptr->Blend == BlendRank( SDL_BLENDMODE_BLEND ) && Modulation.a == ALPHA_MAX );
+
+  Push_Pvt( Layer, Depth, ( Info_Ptr->Blend << s_TEXTURE_BITS ) | Info_Ptr->Id, Sprite );
+}
+
+
+/**
+ * @brief Queues a call: whatever the function draws is drawn in its place in the sorted list.
+ *
+ * @param Draw Called by "flush" with the renderer and Data; it counts its own draw calls.
+ * @param Data Must live until the flush.
+ **/
+void LDrawList::addCall( Uint8 Layer, float Depth, DrawFunction Draw, void* Data )
+{
+  if ( Draw == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Item Call;
+
+  Call.Texture_Ptr = NULL;
+  Call.Draw        = Draw;
+  Call.Data        = Data;
+  Call.Clip        = SDL_FRect{ 0.0f, 0.0f, 0.0f, 0.0f };
+  Call.Destination = Call.Clip;
+  Call.Modulation  = NoModulation;
+  Call.IsOpaque    = false;
+
+  Push_Pvt( Layer, Depth, s_CALL_STATE, Call );
+}
+
+
+/**
+ * @brief Sorts and draws the queued draws, from the last opaque sprite covering the viewport if
+ * there is one, then starts a new frame.
+ *
+ * @param Renderer The renderer to draw with; the draws are discarded if NULL.
+ **/
+void LDrawList::flush( SDL_Renderer* Renderer )
+{
+  m_DrawCalls    = 0;
+  m_StateChanges = 0;
+  m_Culled       = 0;
+  m_Overdraw     = 0.0;
+
+  if ( Renderer == NULL )
+  {
+    begin();
+    return;
+  }
+  else
+  {;}
+
+  SDL_Rect Viewport;
+
+  SDL_RenderGetViewport( Renderer, &Viewport );
+
+  const double ViewportArea = static_cast<double>( Viewport.w ) * static_cast<double>( Viewport.h );
+  double       Drawn        = 0.0;
+
+  if ( !m_Entries.empty() )
+  {
+    Sort_Pvt();
+  }
+  else
+  {;}
+
+  const size_t Cover = FindCover_Pvt( Viewport );
+  const size_t First = ( Cover != m_Entries.size() ) ? Cover : 0;
+
+  if ( m_IsClearQueued && Cover == m_Entries.size() )
+  {
+    Uint8 r, g, b, a;
+
+    SDL_GetRenderDrawColor( Renderer, &r, &g, &b, &a );
+    SDL_SetRenderDrawColor( Renderer, m_ClearColour.r, m_ClearColour.g, m_ClearColour.b, m_ClearColour.a );
+    SDL_RenderClear( Renderer );
+    SDL_SetRenderDrawColor( Renderer, r, g, b, a );
+
+    Drawn += ViewportArea;
+  }
+  else
+  {;}
+
+  m_Culled = First;
+
+  SDL_Texture* Current_Ptr = NULL;
+
+  m_Vertices.clear();
+  m_Indices.clear();
+
+  for ( size_t Index = First; Index != m_Entries.size(); ++Index )
+  {
+    const Item& Next = m_Items[ m_Entries[Index].Item ];
+
+    if ( Next.Draw != nullptr )
+    {
+      Submit_Pvt( Renderer, Current_Ptr );
+      Current_Ptr = NULL;
+
+      Next.Draw( Renderer, Next.Data );
+      continue;
+    }
+    else if ( Next.Texture_Ptr != Current_Ptr )
+    {
+      Submit_Pvt( Renderer, Current_Ptr );
+      Current_Ptr = Next.Texture_Ptr;
+      ++m_StateChanges;
+    }
+    else
+    {;}
+
+    const float Left   = Next.Destination.x;
+    const float Top    = Next.Destination.y;
+    const float Right  = Left + Next.Destination.w;
+    const float Bottom = Top  + Next.Destination.h;
+    const float U0     = Next.Clip.x;
+    const float V0     = Next.Clip.y;
+    const float U1     = U0 + Next.Clip.w;
+    const float V1     = V0 + Next.Clip.h;
+    const int   Vertex = static_cast<int>( m_Vertices.size() );
+
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left , Top    }, Next.Modulation, SDL_FPoint{ U0, V0 } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Right, Top    }, Next.Modulation, SDL_FPoint{ U1, V0 } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Right, Bottom }, Next.Modulation, SDL_FPoint{ U1, V1 } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left , Bottom }, Next.Modulation, SDL_FPoint{ U0, V1 } } );
+
+    const int Corners[6] = { Vertex, Vertex + 1, Vertex + 2, Vertex, Vertex + 2, Vertex + 3 };
+
+    m_Indices.insert( m_Indices.end(), Corners, Corners + 6 );
+
+    Drawn += VisibleArea( Next.Destination, Viewport.w, Viewport.h );
+  }
+
+  Submit_Pvt( Renderer, Current_Ptr );
+
+  if ( ViewportArea > 0.0 )
+  {
+    m_Overdraw = Drawn / ViewportArea;
+
+    LPerfHarness::countPixels( static_cast<Uint64>( Drawn ), static_cast<Uint64>( ViewportArea ) );
+  }
+  else
+  {;}
+
+  LPerfHarness::countDrawCalls( m_DrawCalls );
+
+  begin();
+}
+
+
+LDrawOrder LDrawList::GetOrder( Uint8 Layer ) const
+{
+  return ( ( m_DepthFirst[Layer / 64] >> ( Layer % 64 ) ) & 1 ) ? LDrawOrder::Depth : LDrawOrder::State;
+}
+
+
+/**
+ * @return The draws queued since "begin".
+ **/
+size_t LDrawList::GetCount( void ) const
+{
+  return m_Entries.size();
+}
+
+
+/**
+ * @return The SDL_RenderGeometry calls of the last flush; the calls queued with "addCall" count
+ * their own.
+ **/
+int LDrawList::GetDrawCalls( void ) const
+{
+  return m_DrawCalls;
+}
+
+
+/**
+ * @return The texture changes of the last flush: the runs of sprites of the same texture.
+ **/
+int LDrawList::GetStateChanges( void ) const
+{
+  return m_StateChanges;
+}
+
+
+/**
+ * @return The draws of the last flush skipped under an opaque sprite covering the viewport.
+ **/
+size_t LDrawList::GetCulled( void ) const
+{
+  return m_Culled;
+}
+
+
+/**
+ * @return The pixels written by the last flush, the clear included, over those of the viewport:
+ * 1 when each pixel is written once. Pixels of the calls are not known, and not counted.
+ **/
+double LDrawList::GetOverdraw( void ) const
+{
+  return m_Overdraw;
+}
+
+
+/**
+ * @brief Finds a texture, giving it an id the first time and reading its blend mode and size the
+ * first time in a frame.
+ *
+ * @return NULL if the texture cannot be drawn.
+ **/
+const LDrawList::TextureInfo* LDrawList::FindTexture_Pvt( SDL_Texture* Texture_Ptr )
+{
+  if ( Texture_Ptr == NULL )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  auto Found = m_Textures.find( Texture_Ptr );
+
+  if ( Found == m_Textures.end() )
+  {
+    if ( m_NextId > s_MAX_TEXTURES )
+    {
+      printf( "\nLDrawList: more than %u textures in a frame!", static_cast<unsigned>( s_MAX_TEXTURES ) );
+      return nullptr;
+    }
+    else
+    {;}
+
+    Found = m_Textures.emplace( Texture_Ptr, TextureInfo{ m_NextId++, 0, 0, false, 0, 0 } ).first;
+  }
+  else
+  {;}
+
+  TextureInfo& Info = Found->second;
+
+  if ( Info.Frame != m_Frame )
+  {
+    SDL_BlendMode Mode = SDL_BLENDMODE_NONE;
+
+    if ( SDL_GetTextureBlendMode( Texture_Ptr, &Mode ) != 0 ||
+         SDL_QueryTexture( Texture_Ptr, NULL, NULL, &Info.Width, &Info.Height ) != 0 )
+    {
+      printf( "\nLDrawList: unable to query a texture! SDL Error: %s", SDL_GetError() );
+      m_Textures.erase( Found );
+      return nullptr;
+    }
+    else
+    {;}
+
+    Info.Blend    = BlendRank( Mode );
+    Info.IsOpaque = ( m_OpaqueTextures.count( Texture_Ptr ) != 0 );
+    Info.Frame    = m_Frame;
+  }
+  else
+  {;}
+
+  return &Info;
+}
+
+
+/**
+ * @brief Queues an item with its key: layer, then state and depth or depth and state.
+ *
+ * @param State Blend rank and texture id, 24 bits.
+ **/
+void LDrawList::Push_Pvt( Uint8 Layer, float Depth, Uint32 State, const Item& Queued )
+{
+  const Uint64 Depth64 = DepthBits_Pvt( Depth );
+  const Uint64 State64 = State;
+  Uint64       Key     = Uint64( Layer ) << 56;
+
+  if ( GetOrder( Layer ) == LDrawOrder::Depth )
+  {
+    Key |= ( Depth64 << 24 ) | State64;
+  }
+  else
+  {
+    Key |= ( State64 << 32 ) | Depth64;
+  }
+
+  m_Entries.push_back( Entry{ Key, static_cast<Uint32>( m_Items.size() ) } );
+  m_Items.push_back( Queued );
+}
+
+
+/**
+ * @brief Sorts the entries by key, least significant byte first; a byte every key shares is not
+ * moved on. Each pass is stable, so the whole sort is.
+ **/
+void LDrawList::Sort_Pvt( void )
+{
+  size_t Counts[RADIX_PASSES][RADIX_SIZE];
+
+  std::memset( Counts, 0, sizeof( Counts ) );
+
+  for ( const Entry& Unsorted : m_Entries )
+  {
+    for ( int Pass = 0; Pass != RADIX_PASSES; ++Pass )
+    {
+      ++Counts[Pass][ ( Unsorted.Key >> ( Pass * RADIX_BITS ) ) & ( RADIX_SIZE - 1 ) ];
+    }
+  }
+
+  m_Scratch.resize( m_Entries.size() );
+
+  for ( int Pass = 0; Pass != RADIX_PASSES; ++Pass )
+  {
+    const int Shift = Pass * RADIX_BITS;
+    size_t*   Count = Counts[Pass];
+
+    if ( Count[ ( m_Entries[0].Key >> Shift ) & ( RADIX_SIZE - 1 ) ] == m_Entries.size() )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    size_t Offset = 0;
+
+    for ( int Digit = 0; Digit != RADIX_SIZE; ++Digit )
+    {
+      const size_t Size = Count[Digit];
+
+      Count[Digit] = Offset;
+      Offset      += Size;
+    }
+
+    for ( const Entry& Unsorted : m_Entries )
+    {
+      m_Scratch[ Count[ ( Unsorted.Key >> Shift ) & ( RADIX_SIZE - 1 ) ]++ ] = Unsorted;
+    }
+
+    m_Entries.swap( m_Scratch );
+  }
+}
+
+
+/**
+ * @brief Finds the last sorted sprite that is opaque and covers the whole viewport: nothing drawn
+ * before it can be seen.
+ *
+ * @return Its index in m_Entries; m_Entries.size() if there is none.
+ **/
+size_t LDrawList::FindCover_Pvt( const SDL_Rect& Viewport ) const
+{
+  const float Right  = static_cast<float>( Viewport.w );
+  const float Bottom = static_cast<float>( Viewport.h );
+
+  for ( size_t Index = m_Entries.size(); Index != 0; --Index )
+  {
+    const Item& Candidate = m_Items[ m_Entries[Index - 1].Item ];
+    const SDL_FRect& Area = Candidate.Destination;
+
+    if ( Candidate.IsOpaque && Area.x <= 0.0f && Area.y <= 0.0f && Area.x + Area.w >= Right && Area.y + Area.h >= Bottom )
+    {
+      return Index - 1;
+    }
+    else
+    {;}
+  }
+
+  return m_Entries.size();
+}
+
+
+/**
+ * @brief Draws the run of sprites queued so far, all of one texture.
+ **/
+void LDrawList::Submit_Pvt( SDL_Renderer* Renderer, SDL_Texture* Texture_Ptr )
+{
+  if ( m_Indices.empty() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( SDL_RenderGeometry( Renderer, Texture_Ptr, m_Vertices.data(), static_cast<int>( m_Vertices.size() ),
+                           m_Indices.data(), static_cast<int>( m_Indices.size() ) ) != 0 )
+  {
+    printf( "\nLDrawList: unable to draw %d sprites! SDL Error: %s", static_cast<int>( m_Indices.size() / 6 ), SDL_GetError() );
+  }
+  else
+  {;}
+
+  ++m_DrawCalls;
+
+  m_Vertices.clear();
+  m_Indices.clear();
+}
+
+
+/**
+ * @brief The bits of a depth, made to sort as unsigned integers in the order of the floats:
+ * negative ones have all their bits flipped, the others only the sign.
+ **/
+Uint32 LDrawList::DepthBits_Pvt( float Depth )
+{
+  Uint32 Bits;
+
+  std::memcpy( &Bits, &Depth, sizeof( Bits ) );
+
+  return ( Bits & 0x80000000u ) ? ~Bits : ( Bits | 0x80000000u );
+}
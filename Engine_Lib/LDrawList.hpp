@@ -0,0 +1,147 @@
+/**
+ * @file LDrawList.hpp
+ *
+ * @brief A frame's draws, submitted in any order and drawn sorted by layer, state and depth with as
+ * few texture changes as possible.
+ **/
+
+#ifndef LDRAWLIST_HPP
+#define LDRAWLIST_HPP
+
+#include <SDL.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief How the draws of a layer of a LDrawList are ordered.
+ *
+ * State: by blend mode, then texture, then depth. The sprites of a texture are drawn together, in
+ * one SDL_RenderGeometry call, and opaque textures before blending ones; sprites of different
+ * textures that overlap may be drawn in any order. For backgrounds, tiles and particles.
+ *
+ * Depth: by depth, then blend mode and texture. Overlapping sprites are drawn back to front, as the
+ * objects of a top-down view sorted by their feet; only the sprites next to each other in depth that
+ * share a texture share a draw call.
+ **/
+enum class LDrawOrder { State, Depth };
+
+
+/**
+ * @brief Frame draw list. Every draw queued between "begin" and "flush" gets a 64 bit sort key: its
+ * layer in the highest 8 bits, then its blend mode, its texture and its depth in the order of the
+ * layer (LDrawOrder). "flush" sorts the keys with a radix sort, 8 bits per pass, skipping the passes
+ * where every key has the same byte, and draws the sorted list: one SDL_RenderGeometry call for each
+ * run of sprites of the same texture. The sort is stable, so draws with the same key keep the order
+ * they were queued in.
+ *
+ * Layers are drawn from 0 up: the order in which the code queues its draws no longer matters, only
+ * their layers and depths. A lower depth is drawn first.
+ *
+ * Sprites take an SDL_Texture, whose blend mode is read once per frame: tutorials with their own
+ * texture class can use the list as well as those using Engine_Lib/LTexture. Colour and alpha
+ * modulation are per sprite, written in its vertices; leave the modulation of the texture white and
+ * opaque. Anything else, as text or shapes, is a call: a function drawing on the renderer, sorted
+ * like the sprites; in a layer ordered by state the calls come after the sprites. Storage is kept
+ * between frames, so that steady-state frames do not allocate.
+ *
+ * Overdraw: the clear of the frame can be queued too ("clear", in place of SDL_RenderClear). Before
+ * drawing, "flush" looks for the last opaque sprite in the sorted list that covers the whole
+ * viewport, as a background: the clear and every draw before it are skipped, as none of their
+ * pixels would be seen. A sprite is opaque when its texture does not blend (SDL_BLENDMODE_NONE), or
+ * when it blends but was declared opaque with "setOpaque" and the sprite is not faded; calls are
+ * never opaque. The pixels written by each flush, over those of the viewport, are its overdraw,
+ * reported to LPerfHarness.
+ **/
+class LDrawList
+{
+public:
+
+  typedef void (*DrawFunction)( SDL_Renderer*, void* );
+
+  LDrawList( void );
+
+  LDrawList( const LDrawList& )            = delete;
+  LDrawList& operator=( const LDrawList& ) = delete;
+
+  void       setOrder        ( Uint8, LDrawOrder );
+  void       setOpaque       ( SDL_Texture*, bool );
+  void       begin           ( void );
+  void       clear           ( SDL_Color );
+  void       add             ( Uint8, float, SDL_Texture*, int, int, const SDL_Rect* = NULL );
+  void       add             ( Uint8, float, SDL_Texture*, const SDL_Rect&, const SDL_Rect&, SDL_Color );
+  void       add             ( Uint8, float, SDL_Texture*, const SDL_FRect&, const SDL_FRect&, SDL_Color );
+  void       addCall         ( Uint8, float, DrawFunction, void* );
+  void       flush           ( SDL_Renderer* );
+
+  LDrawOrder GetOrder        ( Uint8 ) const;
+  size_t     GetCount        ( void ) const;
+  int        GetDrawCalls    ( void ) const;
+  int        GetStateChanges ( void ) const;
+  size_t     GetCulled       ( void ) const;
+  double     GetOverdraw     ( void ) const;
+
+private:
+
+  static constexpr int    s_TEXTURE_BITS   = 21;
+  static constexpr Uint32 s_MAX_TEXTURES   = ( 1u << s_TEXTURE_BITS ) - 1;   // Id 0 is never given
+  static constexpr Uint32 s_CALL_STATE     = ( 1u << 24 ) - 1;               // After every texture
+  static constexpr size_t s_RESERVED_ITEMS = 256;
+
+  /**
+   * @brief What the list knows of a texture: its id is kept, the rest is read again every frame.
+   **/
+  struct TextureInfo
+  {
+    Uint32 Id;
+    Uint32 Frame;      // When Blend and the size were read
+    Uint32 Blend;      // Rank of the blend mode in the keys
+    bool   IsOpaque;   // Its texels hide what is under them
+    int    Width;
+    int    Height;
+  };
+
+  struct Item
+  {
+    SDL_Texture* Texture_Ptr;   // NULL for a call
+    DrawFunction Draw;
+    void*        Data;
+    SDL_FRect    Clip;          // Texture coordinates, from 0 to 1
+    SDL_FRect    Destination;
+    SDL_Color    Modulation;
+    bool         IsOpaque;
+  };
+
+  struct Entry
+  {
+    Uint64 Key;
+    Uint32 Item;
+  };
+
+  const TextureInfo* FindTexture_Pvt ( SDL_Texture* );
+  void               Push_Pvt        ( Uint8, float, Uint32, const Item& );
+  void               Sort_Pvt        ( void );
+  size_t             FindCover_Pvt   ( const SDL_Rect& ) const;
+  void               Submit_Pvt      ( SDL_Renderer*, SDL_Texture* );
+
+  static Uint32      DepthBits_Pvt   ( float );
+
+  std::unordered_map<SDL_Texture*, TextureInfo> m_Textures;
+  std::unordered_set<SDL_Texture*>              m_OpaqueTextures;
+  std::vector<Item>                             m_Items;
+  std::vector<Entry>                            m_Entries;
+  std::vector<Entry>                            m_Scratch;        // Of the sort
+  std::vector<SDL_Vertex>                       m_Vertices;       // Of the run being drawn
+  std::vector<int>                              m_Indices;
+  Uint64                                        m_DepthFirst[4];  // A bit per layer ordered by depth
+  Uint32                                        m_Frame;
+  Uint32                                        m_NextId;
+  bool                                          m_IsClearQueued;
+  SDL_Color                                     m_ClearColour;
+  int                                           m_DrawCalls;      // Of the last flush
+  int                                           m_StateChanges;
+  size_t                                        m_Culled;
+  double                                        m_Overdraw;
+};
+
+#endif // LDRAWLIST_HPP
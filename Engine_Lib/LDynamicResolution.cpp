@@ -0,0 +1,346 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LDynamicResolution.hpp"
+#include "LFrameArena.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 SCENE_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+static constexpr double MAX_SAMPLE   = 2.0;   // Of the budget: a hitch counts as one missed frame, not as many
+static constexpr int    MAX_DROP     = 2;     // Steps: with VSync a late frame takes two periods, which overstates the load
+static constexpr double MAX_RELAX_s  = 60.0;  // The ceiling relaxes slower after each overrun, up to this
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief A size at a scale, rounded down as SDL_RenderSetViewport does, in float.
+ **/
+static int ScaleSize( int Size, double Scale )
+{
+  return std::max( static_cast<int>( std::floor( static_cast<float>( Size ) * static_cast<float>( Scale ) ) ), 1 );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LDynamicResolution::LDynamicResolution( void )
+  : m_Renderer_Ptr(nullptr), m_Scene_Ptr(nullptr), m_Previous_Ptr(nullptr), m_IsRedirected(false), m_Width(0),
+    m_Height(0), m_Budget(s_DEFAULT_BUDGET_s), m_MinScale(0.5), m_MaxScale(1.0), m_Scale(1.0), m_Ceiling(1.0),
+    m_SinceOverrun(0.0), m_RelaxTime(s_CEILING_RELAX_s), m_IsProbing(false), m_AverageBusy(0.0), m_AverageFrame(0.0),
+    m_Settling(s_SETTLE_FRAMES), m_LastPresent(0)
+{;}
+
+
+LDynamicResolution::~LDynamicResolution( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Creates the scene target and starts at full scale.
+ *
+ * @param Width, Height Native size of the scene, in the coordinates it is drawn with.
+ * @param Budget Seconds per frame to hold, e.g. 1 / 60.
+ * @return false if the renderer has no target textures.
+ **/
+bool LDynamicResolution::create( SDL_Renderer* Renderer_Ptr, int Width, int Height, double Budget )
+{
+  free();
+
+  m_Scene_Ptr = SDL_CreateTexture( Renderer_Ptr, SCENE_FORMAT, SDL_TEXTUREACCESS_TARGET, Width, Height );
+
+  if ( m_Scene_Ptr == nullptr )
+  {
+    printf( "\nDynamic resolution: unable to create a %d x %d target! SDL Error: %s", Width, Height, SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  // Stretched smoothly, and copied over what is below
+  SDL_SetTextureScaleMode( m_Scene_Ptr, SDL_ScaleModeLinear );
+  SDL_SetTextureBlendMode( m_Scene_Ptr, SDL_BLENDMODE_NONE );
+
+  m_Renderer_Ptr = Renderer_Ptr;
+  m_Width        = Width;
+  m_Height       = Height;
+  m_Scale        = m_MaxScale;
+  m_Ceiling      = m_MaxScale;
+  m_SinceOverrun = 0.0;
+  m_RelaxTime    = s_CEILING_RELAX_s;
+  m_IsProbing    = false;
+  m_Settling     = s_SETTLE_FRAMES;
+  m_LastPresent  = 0;
+
+  setBudget( Budget );
+
+  printf( "\nDynamic resolution: %d x %d, scale %.2f to %.2f, budget %.2f ms", m_Width, m_Height, m_MinScale, m_MaxScale, m_Budget * 1000.0 );
+
+  return true;
+}
+
+
+void LDynamicResolution::free( void )
+{
+  if ( m_Scene_Ptr != nullptr )
+  {
+    SDL_DestroyTexture( m_Scene_Ptr );
+    m_Scene_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Renderer_Ptr = nullptr;
+  m_IsRedirected = false;
+  m_Width        = 0;
+  m_Height       = 0;
+}
+
+
+void LDynamicResolution::setBudget( double Budget )
+{
+  m_Budget = ( Budget > 0.0 ) ? Budget : s_DEFAULT_BUDGET_s;
+}
+
+
+/**
+ * @brief Limits the scale, in steps of s_SCALE_STEP; never above 1, the native size.
+ **/
+void LDynamicResolution::setScaleRange( double MinScale, double MaxScale )
+{
+  m_MaxScale = std::min( std::max( MaxScale, s_SCALE_STEP ), 1.0 );
+  m_MinScale = std::min( std::max( MinScale, s_SCALE_STEP ), m_MaxScale );
+  m_Ceiling  = m_MaxScale;
+
+  SetScale_Pvt( m_Scale );
+}
+
+
+/**
+ * @brief Redirects the drawing into the scene target, at the current scale, unless it is full.
+ **/
+void LDynamicResolution::beginScene( void )
+{
+  if ( m_Scene_Ptr == nullptr || m_Scale >= 1.0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Native{ 0, 0, m_Width, m_Height };
+
+  m_Previous_Ptr = SDL_GetRenderTarget( m_Renderer_Ptr );
+  m_IsRedirected = true;
+
+  // Scale first: the viewport, in native coordinates, is scaled with it and clips to the scene
+  SDL_SetRenderTarget  ( m_Renderer_Ptr, m_Scene_Ptr );
+  SDL_RenderSetScale   ( m_Renderer_Ptr, static_cast<float>( m_Scale ), static_cast<float>( m_Scale ) );
+  SDL_RenderSetViewport( m_Renderer_Ptr, &Native );
+}
+
+
+/**
+ * @brief Goes back to the target found by beginScene, and stretches the scene on it.
+ **/
+void LDynamicResolution::endScene( void )
+{
+  if ( !m_IsRedirected )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Scene { 0, 0, GetSceneWidth(), GetSceneHeight() };
+  const SDL_Rect Native{ 0, 0, m_Width, m_Height };
+
+  SDL_SetRenderTarget( m_Renderer_Ptr, m_Previous_Ptr );
+  SDL_RenderCopy     ( m_Renderer_Ptr, m_Scene_Ptr, &Scene, &Native );
+
+  m_IsRedirected = false;
+}
+
+
+/**
+ * @brief Presents the frame with PresentFrame, and adapts the scale to how long it took.
+ **/
+void LDynamicResolution::present( SDL_Renderer* Renderer_Ptr )
+{
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  PresentFrame( Renderer_Ptr );
+
+  if ( m_Scene_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint64 End       = SDL_GetPerformanceCounter();
+  const double Frequency = static_cast<double>( SDL_GetPerformanceFrequency() );
+
+  if ( m_LastPresent != 0 )
+  {
+    Update_Pvt( static_cast<double>( Start - m_LastPresent ) / Frequency, static_cast<double>( End - m_LastPresent ) / Frequency );
+  }
+  else
+  {;}
+
+  m_LastPresent = End;
+}
+
+
+bool LDynamicResolution::IsActive( void ) const
+{
+  return m_Scene_Ptr != nullptr;
+}
+
+
+double LDynamicResolution::GetScale( void ) const
+{
+  return m_Scale;
+}
+
+
+int LDynamicResolution::GetSceneWidth( void ) const
+{
+  return ScaleSize( m_Width, m_Scale );
+}
+
+
+int LDynamicResolution::GetSceneHeight( void ) const
+{
+  return ScaleSize( m_Height, m_Scale );
+}
+
+
+double LDynamicResolution::GetBudget( void ) const
+{
+  return m_Budget;
+}
+
+
+/**
+ * @return Seconds of the frame spent outside the present, averaged.
+ **/
+double LDynamicResolution::GetAverageBusy( void ) const
+{
+  return m_AverageBusy;
+}
+
+
+/**
+ * @return Seconds from one present to the next, averaged.
+ **/
+double LDynamicResolution::GetAverageFrame( void ) const
+{
+  return m_AverageFrame;
+}
+
+
+/**
+ * @param Busy  Seconds from the end of the last present to the start of this one.
+ * @param Frame Seconds from the end of the last present to the end of this one.
+ **/
+void LDynamicResolution::Update_Pvt( double Busy, double Frame )
+{
+  Busy  = std::min( Busy,  m_Budget * MAX_SAMPLE );
+  Frame = std::min( Frame, m_Budget * MAX_SAMPLE );
+
+  // The ceiling comes back up while nothing runs over, sooner after each rise that held
+  m_SinceOverrun += Frame;
+
+  if ( m_SinceOverrun >= m_RelaxTime && m_Ceiling < m_MaxScale )
+  {
+    m_RelaxTime    = m_IsProbing ? std::max( m_RelaxTime / 2.0, s_CEILING_RELAX_s ) : m_RelaxTime;
+    m_Ceiling      = std::min( m_Ceiling + s_SCALE_STEP, m_MaxScale );
+    m_SinceOverrun = 0.0;
+    m_IsProbing    = true;
+  }
+  else
+  {;}
+
+  // Right after a change the averages restart from the last frame of the wait
+  if ( m_Settling > 0 )
+  {
+    --m_Settling;
+    m_AverageBusy  = Busy;
+    m_AverageFrame = Frame;
+    return;
+  }
+  else
+  {;}
+
+  m_AverageBusy  += ( Busy  - m_AverageBusy  ) * s_AVERAGE_WEIGHT;
+  m_AverageFrame += ( Frame - m_AverageFrame ) * s_AVERAGE_WEIGHT;
+
+  if ( m_AverageFrame > m_Budget * s_OVERRUN )
+  {
+    m_SinceOverrun = 0.0;
+
+    if ( m_Scale > m_MinScale )
+    {
+      // The pixels, hence the time, go with the square of the scale: one step down at least. A
+      // ceiling raised again and too high still is tried again later each time
+      const double Estimate = m_Scale * std::sqrt( m_Budget / m_AverageFrame );
+
+      m_Ceiling   = std::max( m_Scale - s_SCALE_STEP, m_MinScale );
+      m_RelaxTime = m_IsProbing ? std::min( m_RelaxTime * 2.0, MAX_RELAX_s ) : s_CEILING_RELAX_s;
+      SetScale_Pvt( std::min( std::max( Estimate, m_Scale - MAX_DROP * s_SCALE_STEP ), m_Ceiling ) );
+    }
+    else
+    {;}
+
+    m_IsProbing = false;
+  }
+  else if ( m_AverageBusy < m_Budget * s_HEADROOM && m_Scale < m_Ceiling )
+  {
+    SetScale_Pvt( m_Scale + s_SCALE_STEP );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Sets the scale to the nearest step in range; a change restarts the averages.
+ **/
+void LDynamicResolution::SetScale_Pvt( double Scale )
+{
+  Scale = std::round( Scale / s_SCALE_STEP ) * s_SCALE_STEP;
+  Scale = std::min( std::max( Scale, m_MinScale ), m_MaxScale );
+
+  if ( std::fabs( Scale - m_Scale ) < s_SCALE_STEP / 2.0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_Scale    = Scale;
+  m_Settling = s_SETTLE_FRAMES;
+
+  if ( m_Scene_Ptr != nullptr )
+  {
+    printf( "\nDynamic resolution: scale %.2f, %d x %d", m_Scale, GetSceneWidth(), GetSceneHeight() );
+  }
+  else
+  {;}
+}
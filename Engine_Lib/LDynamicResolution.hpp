@@ -0,0 +1,100 @@
+/**
+ * @file LDynamicResolution.hpp
+ *
+ * @brief Dynamic resolution: the scene drawn into a target scaled down when frames run over their
+ * time budget, and back up when there is room again, then stretched on the window; the interface
+ * stays at the native resolution.
+ **/
+
+#ifndef LDYNAMICRESOLUTION_HPP
+#define LDYNAMICRESOLUTION_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief Between "beginScene" and "endScene" the renderer draws into a target texture at GetScale
+ * times the native size, through SDL_RenderSetScale: the scene keeps drawing in native coordinates.
+ * "endScene" stretches it, with linear filtering, over ( 0, 0, width, height ) of the target it
+ * found; what is drawn afterwards (text, HUD) is at the native resolution. The scene is opaque: it
+ * replaces what was under it.
+ *
+ * "present" presents the frame (PresentFrame) and times it. SDL 2 has no GPU timer, so the load is
+ * told apart from the waiting by the present itself, which blocks for the vertical blank and for a
+ * GPU that is behind:
+ * - Frames further apart than the budget, on average, mean the GPU or the CPU is late: the scale
+ *   drops, by how much over the budget they are (the pixels drawn scale with its square), and the
+ *   scale that was too much becomes a ceiling for a while;
+ * - Frames busy (the time outside the present) for less than s_HEADROOM of the budget, on average,
+ *   leave room: the scale grows by one s_SCALE_STEP, up to the ceiling.
+ * After a change the averages start over, and nothing changes for s_SETTLE_FRAMES, so that they
+ * measure the new size. The ceiling rises again one step every s_CEILING_RELAX_s without overruns,
+ * a period doubled whenever the risen ceiling overruns again, so that a scale just too high is not
+ * tried over and over, and halved back whenever it holds.
+ * With VSync the budget must not be shorter than the refresh period: no frame would ever be on time.
+ *
+ * Code switching render targets in the scene goes back to the one it found, as LCachedLayer does;
+ * SDL resets the scale on every switch, so cached layers are best updated before beginScene.
+ * At full scale the scene is drawn straight on the target, with no copy. Without "create", as
+ * well, beginScene and endScene do nothing and "present" only presents. Everything is called from
+ * the render thread.
+ **/
+class LDynamicResolution
+{
+public:
+
+  static constexpr double s_DEFAULT_BUDGET_s = 1.0 / 60.0;
+  static constexpr double s_SCALE_STEP       = 0.05;
+  static constexpr double s_HEADROOM         = 0.70;
+  static constexpr double s_OVERRUN          = 1.10;  // Of the budget, the frame interval that is late
+  static constexpr int    s_SETTLE_FRAMES    = 30;
+  static constexpr double s_CEILING_RELAX_s  = 5.0;
+  static constexpr double s_AVERAGE_WEIGHT   = 1.0 / 16.0;
+
+  LDynamicResolution( void );
+  ~LDynamicResolution( void );
+
+  LDynamicResolution( const LDynamicResolution& )            = delete;
+  LDynamicResolution& operator=( const LDynamicResolution& ) = delete;
+
+  bool   create         ( SDL_Renderer*, int, int, double = s_DEFAULT_BUDGET_s );
+  void   free           ( void );
+  void   setBudget      ( double );
+  void   setScaleRange  ( double, double );
+  void   beginScene     ( void );
+  void   endScene       ( void );
+  void   present        ( SDL_Renderer* );
+
+  bool   IsActive       ( void ) const;
+  double GetScale       ( void ) const;
+  int    GetSceneWidth  ( void ) const;
+  int    GetSceneHeight ( void ) const;
+  double GetBudget      ( void ) const;
+  double GetAverageBusy ( void ) const;
+  double GetAverageFrame( void ) const;
+
+private:
+
+  void Update_Pvt  ( double, double );
+  void SetScale_Pvt( double );
+
+  SDL_Renderer* m_Renderer_Ptr;
+  SDL_Texture*  m_Scene_Ptr;        // Native size: the scene uses its top left corner
+  SDL_Texture*  m_Previous_Ptr;     // Target found by beginScene
+  bool          m_IsRedirected;     // Between a beginScene that switched to m_Scene_Ptr and endScene
+  int           m_Width;            // Native size
+  int           m_Height;
+  double        m_Budget;           // Seconds per frame
+  double        m_MinScale;
+  double        m_MaxScale;
+  double        m_Scale;
+  double        m_Ceiling;          // Highest scale allowed, lowered by overruns
+  double        m_SinceOverrun;     // Seconds
+  double        m_RelaxTime;        // Seconds without overruns before the ceiling rises a step
+  bool          m_IsProbing;        // The ceiling rose since the last overrun
+  double        m_AverageBusy;      // Exponential averages, in seconds
+  double        m_AverageFrame;
+  int           m_Settling;         // Frames left before the scale may change again
+  Uint64        m_LastPresent;      // Performance counter at the end of the last present
+};
+
+#endif // LDYNAMICRESOLUTION_HPP
@@ -0,0 +1,125 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LEntityStore.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LEntityStore::LEntityStore( void )
+  : m_Generations(), m_FreeIndices(), m_Pools(), m_Count(0)
+{;}
+
+
+/**
+ * @brief A new entity, with no components yet.
+ **/
+LEntity LEntityStore::create( void )
+{
+  Uint32 Index = 0;
+
+  if ( !m_FreeIndices.empty() )
+  {
+    Index = m_FreeIndices.back();
+    m_FreeIndices.pop_back();
+  }
+  else
+  {
+    Index = static_cast<Uint32>( m_Generations.size() );
+    m_Generations.push_back( 0 );
+  }
+
+  ++m_Generations[Index];  // Odd: alive
+  ++m_Count;
+
+  return LEntity{ Index, m_Generations[Index] };
+}
+
+
+/**
+ * @brief Destroys an entity and removes its components from the attached arrays. Handles of
+ * entities already destroyed are ignored.
+ **/
+void LEntityStore::destroy( LEntity Dead )
+{
+  if ( !IsAlive( Dead ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  for ( LComponentPool* Pool_Ptr : m_Pools )
+  {
+    Pool_Ptr->remove( Dead );
+  }
+
+  ++m_Generations[Dead.Index];  // Even: dead, and every handle to it stale
+  m_FreeIndices.push_back( Dead.Index );
+  --m_Count;
+}
+
+
+/**
+ * @brief Lets "destroy" and "clear" remove components from an array. The array must outlive the
+ * store, or the store be cleared of it first.
+ **/
+void LEntityStore::attach( LComponentPool& Pool )
+{
+  if ( std::find( m_Pools.begin(), m_Pools.end(), &Pool ) == m_Pools.end() )
+  {
+    m_Pools.push_back( &Pool );
+  }
+  else
+  {
+    printf( "\nComponent array already attached to the entity store" );
+  }
+}
+
+
+/**
+ * @brief Destroys every entity, and empties the attached arrays. Generations are kept, so that
+ * handles from before stay stale.
+ **/
+void LEntityStore::clear( void )
+{
+  for ( LComponentPool* Pool_Ptr : m_Pools )
+  {
+    Pool_Ptr->clear();
+  }
+
+  m_FreeIndices.clear();
+
+  for ( Uint32 Index = static_cast<Uint32>( m_Generations.size() ); Index-- != 0; )
+  {
+    m_Generations[Index] += ( m_Generations[Index] & 1u );  // Alive ones become dead
+    m_FreeIndices.push_back( Index );                      // Reused from index 0 up
+  }
+
+  m_Count = 0;
+}
+
+
+void LEntityStore::reserve( size_t Capacity )
+{
+  m_Generations.reserve( Capacity );
+  m_FreeIndices.reserve( Capacity );
+}
+
+
+bool LEntityStore::IsAlive( LEntity Handle ) const
+{
+  return Handle.Index < m_Generations.size() && m_Generations[Handle.Index] == Handle.Generation && ( Handle.Generation & 1u ) != 0;
+}
+
+
+size_t LEntityStore::GetCount( void ) const
+{
+  return m_Count;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file LEntityStore.hpp
+ *
+ * @brief Entities as plain handles, with their components kept in dense arrays, one per kind of
+ * component, for systems that update all of them in one loop.
+ **/
+
+#ifndef LENTITYSTORE_HPP
+#define LENTITYSTORE_HPP
+
+#include <SDL.h>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Handle of an entity. The index is reused once the entity is destroyed, the generation is
+ * not: a handle kept after "destroy" never reaches the entity created in its place.
+ **/
+struct LEntity
+{
+  Uint32 Index;
+  Uint32 Generation;
+
+  bool operator==( const LEntity& Other ) const { return Index == Other.Index && Generation == Other.Generation; }
+  bool operator!=( const LEntity& Other ) const { return !( *this == Other ); }
+};
+
+
+/**
+ * @brief What the store needs of a component array: removing the component of a destroyed entity,
+ * or all of them.
+ **/
+class LComponentPool
+{
+public:
+
+  virtual ~LComponentPool( void ) = default;
+
+  virtual void remove( LEntity ) = 0;
+  virtual void clear ( void )    = 0;
+};
+
+
+/**
+ * @brief The components of one kind, e.g. the positions, of every entity that has one.
+ *
+ * The components are packed at the front of one array, whatever the entities they belong to, with
+ * the owner of each alongside: a system walks "data()" from 0 to "size()" with no gaps and no
+ * indirection. A sparse table, indexed by entity, gives the slot of an entity's component for the
+ * lookups. Removing a component moves the last one into its slot, so slots change but handles do
+ * not; keep handles, not slots or pointers, across adds and removes.
+ *
+ * Systems reading two arrays (positions and velocities) get the matching components from the same
+ * slot of both when the arrays list the same entities in the same order, the usual case when the
+ * entities get all their components as they are created; "sortLike" restores that order otherwise.
+ **/
+template <typename T>
+class LComponentArray : public LComponentPool
+{
+public:
+
+  static constexpr Uint32 s_NO_SLOT = 0xFFFFFFFFu;
+
+  /**
+   * @brief Gives an entity its component, or replaces the one it has.
+   **/
+  T& add( LEntity Owner, const T& Component )
+  {
+    if ( Owner.Index >= m_Slots.size() )
+    {
+      m_Slots.resize( Owner.Index + 1, s_NO_SLOT );
+    }
+    else
+    {;}
+
+    Uint32& Slot = m_Slots[Owner.Index];
+
+    if ( Slot == s_NO_SLOT )
+    {
+      Slot = static_cast<Uint32>( m_Items.size() );
+      m_Items.push_back( Component );
+      m_Owners.push_back( Owner );
+    }
+    else
+    {
+      m_Items[Slot]  = Component;
+      m_Owners[Slot] = Owner;
+    }
+
+    return m_Items[Slot];
+  }
+
+  void remove( LEntity Owner ) override
+  {
+    const Uint32 Slot = GetSlot( Owner );
+
+    if ( Slot == s_NO_SLOT )
+    {
+      return;
+    }
+    else
+    {;}
+
+    const Uint32 Last = static_cast<Uint32>( m_Items.size() - 1 );
+
+    if ( Slot != Last )
+    {
+      m_Items[Slot]                 = m_Items[Last];
+      m_Owners[Slot]                = m_Owners[Last];
+      m_Slots[m_Owners[Slot].Index] = Slot;
+    }
+    else
+    {;}
+
+    m_Slots[Owner.Index] = s_NO_SLOT;
+    m_Items.pop_back();
+    m_Owners.pop_back();
+  }
+
+  /**
+   * @brief Orders the components as the entities of another array: those it also lists come first,
+   * in its order, the others after them. Linear in the number of components.
+   **/
+  template <typename U>
+  void sortLike( const LComponentArray<U>& Leader )
+  {
+    Uint32 Next = 0;
+
+    for ( size_t i = 0; i != Leader.size(); ++i )
+    {
+      const Uint32 Slot = GetSlot( Leader.GetOwner( i ) );
+
+      if ( Slot != s_NO_SLOT )
+      {
+        Swap_Pvt( Slot, Next++ );
+      }
+      else
+      {;}
+    }
+  }
+
+  /**
+   * @brief Whether the first components are those of another array's entities, in its order, i.e.
+   * slot i of both belongs to the same entity for all of the other's slots.
+   **/
+  template <typename U>
+  bool IsOrderedLike( const LComponentArray<U>& Leader ) const
+  {
+    for ( size_t i = 0; i != Leader.size(); ++i )
+    {
+      if ( i == m_Owners.size() || m_Owners[i] != Leader.GetOwner( i ) )
+      {
+        return false;
+      }
+      else
+      {;}
+    }
+
+    return true;
+  }
+
+  void reserve( size_t Capacity )
+  {
+    m_Items.reserve( Capacity );
+    m_Owners.reserve( Capacity );
+  }
+
+  void clear( void ) override
+  {
+    m_Items.clear();
+    m_Owners.clear();
+    m_Slots.clear();
+  }
+
+  /**
+   * @brief The slot of an entity's component, or s_NO_SLOT if it has none.
+   **/
+  Uint32 GetSlot( LEntity Owner ) const
+  {
+    if ( Owner.Index < m_Slots.size() )
+    {
+      const Uint32 Slot = m_Slots[Owner.Index];
+
+      return ( Slot != s_NO_SLOT && m_Owners[Slot].Generation == Owner.Generation ) ? Slot : s_NO_SLOT;
+    }
+    else
+    {
+      return s_NO_SLOT;
+    }
+  }
+
+  T*       get( LEntity Owner )       { const Uint32 Slot = GetSlot( Owner ); return ( Slot != s_NO_SLOT ) ? &m_Items[Slot] : nullptr; }
+  const T* get( LEntity Owner ) const { const Uint32 Slot = GetSlot( Owner ); return ( Slot != s_NO_SLOT ) ? &m_Items[Slot] : nullptr; }
+
+  bool           Has      ( LEntity Owner ) const { return GetSlot( Owner ) != s_NO_SLOT; }
+  LEntity        GetOwner ( size_t Slot )   const { return m_Owners[Slot]; }
+  const LEntity* GetOwners( void )          const { return m_Owners.data(); }
+  size_t         size     ( void )          const { return m_Items.size(); }
+  T*             data     ( void )                { return m_Items.data(); }
+  const T*       data     ( void )          const { return m_Items.data(); }
+
+private:
+
+  void Swap_Pvt( Uint32 First, Uint32 Second )
+  {
+    if ( First == Second )
+    {
+      return;
+    }
+    else
+    {;}
+
+    std::swap( m_Items[First],  m_Items[Second] );
+    std::swap( m_Owners[First], m_Owners[Second] );
+
+    m_Slots[m_Owners[First].Index]  = First;
+    m_Slots[m_Owners[Second].Index] = Second;
+  }
+
+  std::vector<T>       m_Items;    // Packed
+  std::vector<LEntity> m_Owners;   // Per slot, the entity of m_Items' component
+  std::vector<Uint32>  m_Slots;    // Per entity index, its slot in m_Items, or s_NO_SLOT
+};
+
+
+/**
+ * @brief Hands out entity handles and takes them back. The indices of destroyed entities are reused,
+ * most recent first, under a new generation; "destroy" also removes the entity's components from
+ * every array attached to the store.
+ *
+ * The store only knows which entities are alive: what an entity is, is the set of components the
+ * program has given it.
+ **/
+class LEntityStore
+{
+public:
+
+  LEntityStore( void );
+
+  LEntity create    ( void );
+  void    destroy   ( LEntity );
+  void    attach    ( LComponentPool& );
+  void    clear     ( void );
+  void    reserve   ( size_t );
+
+  bool    IsAlive   ( LEntity ) const;
+  size_t  GetCount  ( void ) const;
+
+private:
+
+  std::vector<Uint32>          m_Generations;  // Per index, the current generation; odd while alive
+  std::vector<Uint32>          m_FreeIndices;  // Of destroyed entities
+  std::vector<LComponentPool*> m_Pools;        // Attached component arrays
+  size_t                       m_Count;        // Entities alive
+};
+
+#endif // LENTITYSTORE_HPP
@@ -0,0 +1,560 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LEntitySystems.hpp"
+#include "LJobSystem.hpp"
+#include "LSmallVector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define LENTITY_SSE2
+
+  // AVX is compiled in anyway, for the function marked below, and used only if the CPU has it
+  #if defined(__GNUC__) || defined(_MSC_VER)
+    #include <immintrin.h>
+    #define LENTITY_AVX
+  #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define LENTITY_NEON
+#endif
+
+#if defined(LENTITY_AVX) && defined(__GNUC__)
+  #define LENTITY_TARGET_AVX __attribute__(( target( "avx" ) ))
+#else
+  #define LENTITY_TARGET_AVX
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// The kernels see positions, velocities and boxes as runs of x, y pairs
+static_assert( sizeof(LPosition) == 2 * sizeof(float) && sizeof(LVelocity) == 2 * sizeof(float), "Two floats per component" );
+static_assert( sizeof(LBox) == 2 * sizeof(int), "Two ints per box" );
+
+// Ranges per thread, so that a worker held up elsewhere leaves its share to the others; the
+// smallest range, below which queueing the job costs more than running it; ranges start on a
+// multiple of RANGE_ALIGNMENT entities, 128 bytes of positions, so no two threads write one line
+static const size_t RANGES_PER_THREAD  = 4;
+static const size_t MIN_RANGE_ENTITIES = 8192;
+static const size_t RANGE_ALIGNMENT    = 16;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief A run of entities to step: Count floats of each, x and y alternating from an x.
+ **/
+struct StepRun
+{
+  float*     Positions_Ptr;
+  float*     Velocities_Ptr;
+  const int* Boxes_Ptr;
+  size_t     Count;
+  float      Step;       // Seconds
+  float      Min[2];     // x, y: the area's top left corner
+  float      Max[2];     // x, y: its bottom right corner
+};
+
+
+typedef void (*StepKernel)( const StepRun& );
+
+
+/**
+ * @brief Moves, then clamps to [Min, Max - box] and turns the velocity inwards where clamped: below
+ * the low edge it becomes |v|, past the high one -|v|.
+ **/
+static void Step_Scalar( const StepRun& Run )
+{
+  for ( size_t i = 0; i != Run.Count; ++i )
+  {
+    const float Low   = Run.Min[i & 1];
+    const float High  = Run.Max[i & 1] - static_cast<float>( Run.Boxes_Ptr[i] );
+    const float Moved = Run.Positions_Ptr[i] + Run.Velocities_Ptr[i] * Run.Step;
+    const float Speed = std::fabs( Run.Velocities_Ptr[i] );
+
+    Run.Velocities_Ptr[i] = ( Moved < Low ) ? Speed : ( ( Moved > High ) ? -Speed : Run.Velocities_Ptr[i] );
+    Run.Positions_Ptr[i]  = std::min( std::max( Moved, Low ), High );
+  }
+}
+
+
+#if defined(LENTITY_SSE2)
+/**
+ * @brief Two entities per step. SSE2 has no blend: the selections are and / andnot / or.
+ **/
+static void Step_SSE2( const StepRun& Run )
+{
+  const __m128 Low      = _mm_setr_ps( Run.Min[0], Run.Min[1], Run.Min[0], Run.Min[1] );
+  const __m128 Corner   = _mm_setr_ps( Run.Max[0], Run.Max[1], Run.Max[0], Run.Max[1] );
+  const __m128 Step     = _mm_set1_ps( Run.Step );
+  const __m128 SignBit  = _mm_set1_ps( -0.f );
+  size_t       i        = 0;
+
+  for ( ; i + 4 <= Run.Count; i += 4 )
+  {
+    const __m128 Position = _mm_loadu_ps( Run.Positions_Ptr + i );
+    const __m128 Velocity = _mm_loadu_ps( Run.Velocities_Ptr + i );
+    const __m128 Box      = _mm_cvtepi32_ps( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Run.Boxes_Ptr + i ) ) );
+    const __m128 High     = _mm_sub_ps( Corner, Box );
+    const __m128 Moved    = _mm_add_ps( Position, _mm_mul_ps( Velocity, Step ) );
+    const __m128 Speed    = _mm_andnot_ps( SignBit, Velocity );
+    const __m128 IsBelow  = _mm_cmplt_ps( Moved, Low );
+    const __m128 IsAbove  = _mm_cmpgt_ps( Moved, High );
+
+    __m128 Bounced = _mm_or_ps( _mm_and_ps( IsAbove, _mm_or_ps( Speed, SignBit ) ), _mm_andnot_ps( IsAbove, Velocity ) );
+    Bounced        = _mm_or_ps( _mm_and_ps( IsBelow, Speed ), _mm_andnot_ps( IsBelow, Bounced ) );
+
+    _mm_storeu_ps( Run.Velocities_Ptr + i, Bounced );
+    _mm_storeu_ps( Run.Positions_Ptr + i, _mm_min_ps( _mm_max_ps( Moved, Low ), High ) );
+  }
+
+  Step_Scalar( StepRun{ Run.Positions_Ptr + i, Run.Velocities_Ptr + i, Run.Boxes_Ptr + i, Run.Count - i,
+                        Run.Step, { Run.Min[0], Run.Min[1] }, { Run.Max[0], Run.Max[1] } } );
+}
+#endif
+
+
+#if defined(LENTITY_AVX)
+/**
+ * @brief Four entities per step.
+ **/
+LENTITY_TARGET_AVX static void Step_AVX( const StepRun& Run )
+{
+  const __m256 Low      = _mm256_setr_ps( Run.Min[0], Run.Min[1], Run.Min[0], Run.Min[1], Run.Min[0], Run.Min[1], Run.Min[0], Run.Min[1] );
+  const __m256 Corner   = _mm256_setr_ps( Run.Max[0], Run.Max[1], Run.Max[0], Run.Max[1], Run.Max[0], Run.Max[1], Run.Max[0], Run.Max[1] );
+  const __m256 Step     = _mm256_set1_ps( Run.Step );
+  const __m256 SignBit  = _mm256_set1_ps( -0.f );
+  size_t       i        = 0;
+
+  for ( ; i + 8 <= Run.Count; i += 8 )
+  {
+    const __m256 Position = _mm256_loadu_ps( Run.Positions_Ptr + i );
+    const __m256 Velocity = _mm256_loadu_ps( Run.Velocities_Ptr + i );
+    const __m256 Box      = _mm256_cvtepi32_ps( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( Run.Boxes_Ptr + i ) ) );
+    const __m256 High     = _mm256_sub_ps( Corner, Box );
+    const __m256 Moved    = _mm256_add_ps( Position, _mm256_mul_ps( Velocity, Step ) );
+    const __m256 Speed    = _mm256_andnot_ps( SignBit, Velocity );
+    const __m256 IsBelow  = _mm256_cmp_ps( Moved, Low, _CMP_LT_OQ );
+    const __m256 IsAbove  = _mm256_cmp_ps( Moved, High, _CMP_GT_OQ );
+
+    __m256 Bounced = _mm256_blendv_ps( Velocity, _mm256_or_ps( Speed, SignBit ), IsAbove );
+    Bounced        = _mm256_blendv_ps( Bounced, Speed, IsBelow );
+
+    _mm256_storeu_ps( Run.Velocities_Ptr + i, Bounced );
+    _mm256_storeu_ps( Run.Positions_Ptr + i, _mm256_min_ps( _mm256_max_ps( Moved, Low ), High ) );
+  }
+
+  Step_Scalar( StepRun{ Run.Positions_Ptr + i, Run.Velocities_Ptr + i, Run.Boxes_Ptr + i, Run.Count - i,
+                        Run.Step, { Run.Min[0], Run.Min[1] }, { Run.Max[0], Run.Max[1] } } );
+}
+#endif
+
+
+#if defined(LENTITY_NEON)
+/**
+ * @brief Two entities per step.
+ **/
+static void Step_NEON( const StepRun& Run )
+{
+  const float       LowPair[4]    = { Run.Min[0], Run.Min[1], Run.Min[0], Run.Min[1] };
+  const float       CornerPair[4] = { Run.Max[0], Run.Max[1], Run.Max[0], Run.Max[1] };
+  const float32x4_t Low           = vld1q_f32( LowPair );
+  const float32x4_t Corner        = vld1q_f32( CornerPair );
+  size_t            i             = 0;
+
+  for ( ; i + 4 <= Run.Count; i += 4 )
+  {
+    const float32x4_t Position = vld1q_f32( Run.Positions_Ptr + i );
+    const float32x4_t Velocity = vld1q_f32( Run.Velocities_Ptr + i );
+    const float32x4_t High     = vsubq_f32( Corner, vcvtq_f32_s32( vld1q_s32( Run.Boxes_Ptr + i ) ) );
+    const float32x4_t Moved    = vaddq_f32( Position, vmulq_n_f32( Velocity, Run.Step ) );
+    const float32x4_t Speed    = vabsq_f32( Velocity );
+
+    float32x4_t Bounced = vbslq_f32( vcgtq_f32( Moved, High ), vnegq_f32( Speed ), Velocity );
+    Bounced             = vbslq_f32( vcltq_f32( Moved, Low ), Speed, Bounced );
+
+    vst1q_f32( Run.Velocities_Ptr + i, Bounced );
+    vst1q_f32( Run.Positions_Ptr + i, vminq_f32( vmaxq_f32( Moved, Low ), High ) );
+  }
+
+  Step_Scalar( StepRun{ Run.Positions_Ptr + i, Run.Velocities_Ptr + i, Run.Boxes_Ptr + i, Run.Count - i,
+                        Run.Step, { Run.Min[0], Run.Min[1] }, { Run.Max[0], Run.Max[1] } } );
+}
+#endif
+
+
+struct EntityKernel
+{
+  const char* Name;
+  StepKernel  Step;
+};
+
+
+/**
+ * @brief The best kernel for this CPU: SSE2 and NEON are there whenever the compiler targets them,
+ * AVX is checked at runtime.
+ **/
+static const EntityKernel& ChooseKernel( void )
+{
+#if defined(LENTITY_AVX)
+  static const EntityKernel KERNEL_AVX{ "AVX", Step_AVX };
+
+  if ( SDL_HasAVX() )
+  {
+    return KERNEL_AVX;
+  }
+  else
+  {;}
+#endif
+
+#if defined(LENTITY_SSE2)
+  static const EntityKernel KERNEL_SSE2{ "SSE2", Step_SSE2 };
+  return KERNEL_SSE2;
+#elif defined(LENTITY_NEON)
+  static const EntityKernel KERNEL_NEON{ "NEON", Step_NEON };
+  return KERNEL_NEON;
+#else
+  static const EntityKernel KERNEL_SCALAR{ "Scalar", Step_Scalar };
+  return KERNEL_SCALAR;
+#endif
+}
+
+
+static const EntityKernel& Kernel( void )
+{
+  static const EntityKernel& Chosen = ChooseKernel();
+
+  return Chosen;
+}
+
+/**
+ * @brief The component of Array belonging to the owner of Slot in Leader: straight from the same
+ * slot when the two arrays are in the same order, looked up otherwise; nullptr if there is none.
+ **/
+template <typename T, typename U>
+static T* FindMatch( LComponentArray<T>& Array, const LComponentArray<U>& Leader, size_t Slot )
+{
+  const LEntity Owner = Leader.GetOwner( Slot );
+
+  if ( Slot < Array.size() && Array.GetOwner( Slot ) == Owner )
+  {
+    return Array.data() + Slot;
+  }
+  else
+  {
+    return Array.get( Owner );
+  }
+}
+
+
+template <typename T, typename U>
+static const T* FindMatch( const LComponentArray<T>& Array, const LComponentArray<U>& Leader, size_t Slot )
+{
+  return FindMatch( const_cast<LComponentArray<T>&>( Array ), Leader, Slot );
+}
+
+
+/**
+ * @brief The velocity slots [First, Last) of a StepEntities call, with what the kernels need.
+ **/
+struct StepRange
+{
+  LComponentArray<LPosition>*  Positions_Ptr;
+  LComponentArray<LVelocity>*  Velocities_Ptr;
+  const LComponentArray<LBox>* Boxes_Ptr;
+  size_t                       First;
+  size_t                       Last;
+  StepRun                      Bounds;   // Step and area; pointers and count are set per run
+};
+
+
+/**
+ * @brief Steps a range of velocity slots: in one run through the kernel when the positions and
+ * boxes of those slots belong to the same entities, else one entity at a time, as found by lookup.
+ **/
+static void StepRange_Pvt( const StepRange& Range )
+{
+  LComponentArray<LPosition>&  Positions  = *Range.Positions_Ptr;
+  LComponentArray<LVelocity>&  Velocities = *Range.Velocities_Ptr;
+  const LComponentArray<LBox>& Boxes      = *Range.Boxes_Ptr;
+  const size_t                 Count      = Range.Last - Range.First;
+  StepRun                      Run        = Range.Bounds;
+
+  const bool IsMatching = Range.Last <= Positions.size() && Range.Last <= Boxes.size() &&
+                          memcmp( Positions.GetOwners() + Range.First, Velocities.GetOwners() + Range.First, Count * sizeof(LEntity) ) == 0 &&
+                          memcmp( Boxes.GetOwners()     + Range.First, Velocities.GetOwners() + Range.First, Count * sizeof(LEntity) ) == 0;
+
+  if ( IsMatching )
+  {
+    Run.Positions_Ptr  = &Positions.data()[Range.First].x;
+    Run.Velocities_Ptr = &Velocities.data()[Range.First].x;
+    Run.Boxes_Ptr      = &Boxes.data()[Range.First].w;
+    Run.Count          = Count * 2;
+
+    Kernel().Step( Run );
+    return;
+  }
+  else
+  {;}
+
+  for ( size_t i = Range.First; i != Range.Last; ++i )
+  {
+    LPosition*  Position_Ptr = FindMatch( Positions, Velocities, i );
+    const LBox* Box_Ptr      = FindMatch( Boxes, Velocities, i );
+
+    if ( Position_Ptr == nullptr )
+    {
+      continue;
+    }
+    else if ( Box_Ptr == nullptr )
+    {
+      Position_Ptr->x += Velocities.data()[i].x * Run.Step; // Nothing to confine
+      Position_Ptr->y += Velocities.data()[i].y * Run.Step;
+    }
+    else
+    {
+      Run.Positions_Ptr  = &Position_Ptr->x;
+      Run.Velocities_Ptr = &Velocities.data()[i].x;
+      Run.Boxes_Ptr      = &Box_Ptr->w;
+      Run.Count          = 2;
+
+      Step_Scalar( Run );
+    }
+  }
+}
+
+
+static void RunStepRange( void* Data )
+{
+  StepRange_Pvt( *static_cast<const StepRange*>( Data ) );
+}
+
+
+/***************************************************************************************************
+* Systems
+****************************************************************************************************/
+
+/**
+ * @brief Moves every entity with a velocity by the elapsed time.
+ *
+ * @param Positions Moved.
+ * @param Velocities In pixels per second.
+ * @param TimeStep_s Since the last move.
+ **/
+void MoveEntities( LComponentArray<LPosition>& Positions, const LComponentArray<LVelocity>& Velocities, double TimeStep_s )
+{
+  const float      Step           = static_cast<float>( TimeStep_s );
+  const LVelocity* Velocities_Ptr = Velocities.data();
+
+  for ( size_t i = 0; i != Velocities.size(); ++i )
+  {
+    LPosition* Position_Ptr = FindMatch( Positions, Velocities, i );
+
+    if ( Position_Ptr != nullptr )
+    {
+      Position_Ptr->x += Velocities_Ptr[i].x * Step;
+      Position_Ptr->y += Velocities_Ptr[i].y * Step;
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Keeps the box of every entity inside an area, moving back those that went past its edges.
+ *
+ * @param Positions Corrected.
+ * @param Boxes The collision boxes.
+ * @param Area Where the boxes must stay.
+ * @param Velocities_Ptr If given, the entities pushed back bounce: the velocity across the edge
+ * they reached is turned towards the inside.
+ **/
+void ConfineEntities( LComponentArray<LPosition>& Positions, const LComponentArray<LBox>& Boxes, const SDL_Rect& Area,
+                      LComponentArray<LVelocity>* Velocities_Ptr )
+{
+  const LBox* Boxes_Ptr = Boxes.data();
+
+  for ( size_t i = 0; i != Boxes.size(); ++i )
+  {
+    LPosition* Position_Ptr = FindMatch( Positions, Boxes, i );
+
+    if ( Position_Ptr == nullptr )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const float Left   = static_cast<float>( Area.x );
+    const float Top    = static_cast<float>( Area.y );
+    const float Right  = static_cast<float>( Area.x + Area.w - Boxes_Ptr[i].w );
+    const float Bottom = static_cast<float>( Area.y + Area.h - Boxes_Ptr[i].h );
+
+    // -1 / +1: pushed back from the left / right edge (top / bottom), towards +x / -x (+y / -y)
+    int BounceX = 0;
+    int BounceY = 0;
+
+    if      ( Position_Ptr->x < Left  ) { Position_Ptr->x = Left;  BounceX = +1; }
+    else if ( Position_Ptr->x > Right ) { Position_Ptr->x = Right; BounceX = -1; }
+    else {;}
+
+    if      ( Position_Ptr->y < Top    ) { Position_Ptr->y = Top;    BounceY = +1; }
+    else if ( Position_Ptr->y > Bottom ) { Position_Ptr->y = Bottom; BounceY = -1; }
+    else {;}
+
+    if ( Velocities_Ptr != nullptr && ( BounceX != 0 || BounceY != 0 ) )
+    {
+      LVelocity* Velocity_Ptr = FindMatch( *Velocities_Ptr, Boxes, i );
+
+      if ( Velocity_Ptr != nullptr )
+      {
+        if ( BounceX != 0 && Velocity_Ptr->x * static_cast<float>( BounceX ) < 0.f ) { Velocity_Ptr->x = -Velocity_Ptr->x; } else {;}
+        if ( BounceY != 0 && Velocity_Ptr->y * static_cast<float>( BounceY ) < 0.f ) { Velocity_Ptr->y = -Velocity_Ptr->y; } else {;}
+      }
+      else
+      {;}
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Rebuilds a grid with the boxes of the entities, for the collision queries of the frame.
+ * The index of each box in the grid is its slot in Boxes: "Boxes.GetOwner( Index )" is the entity
+ * found by LSpatialGrid::query.
+ *
+ * Entities with a box but no position are added with an empty box, to keep the indices in step.
+ **/
+void GridEntities( const LComponentArray<LPosition>& Positions, const LComponentArray<LBox>& Boxes, LSpatialGrid& Grid )
+{
+  const LBox* Boxes_Ptr = Boxes.data();
+
+  Grid.clear();
+
+  for ( size_t i = 0; i != Boxes.size(); ++i )
+  {
+    const LPosition* Position_Ptr = FindMatch( Positions, Boxes, i );
+
+    if ( Position_Ptr != nullptr )
+    {
+      Grid.add( SDL_Rect{ static_cast<int>( Position_Ptr->x ), static_cast<int>( Position_Ptr->y ), Boxes_Ptr[i].w, Boxes_Ptr[i].h } );
+    }
+    else
+    {
+      Grid.add( SDL_Rect{ 0, 0, 0, 0 } );
+    }
+  }
+
+  Grid.build();
+}
+
+
+/**
+ * @brief Queues the sprite of every entity into a batch, at its position, in the order of the
+ * sprites: one draw call per texture when the batch is flushed.
+ **/
+void DrawEntities( const LComponentArray<LPosition>& Positions, const LComponentArray<LSprite>& Sprites, LSpriteBatch& Batch )
+{
+  const LSprite* Sprites_Ptr = Sprites.data();
+
+  for ( size_t i = 0; i != Sprites.size(); ++i )
+  {
+    const LPosition* Position_Ptr = FindMatch( Positions, Sprites, i );
+    const LSprite&   Sprite       = Sprites_Ptr[i];
+
+    if ( Position_Ptr == nullptr || Sprite.Texture_Ptr == nullptr )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const bool      IsWhole = SDL_RectEmpty( &Sprite.Clip );
+    const SDL_FRect Clip    = IsWhole ? SDL_FRect{ 0.f, 0.f, static_cast<float>( Sprite.Texture_Ptr->getWidth() ), static_cast<float>( Sprite.Texture_Ptr->getHeight() ) }
+                                      : SDL_FRect{ static_cast<float>( Sprite.Clip.x ), static_cast<float>( Sprite.Clip.y ),
+                                                   static_cast<float>( Sprite.Clip.w ), static_cast<float>( Sprite.Clip.h ) };
+
+    Batch.add( *Sprite.Texture_Ptr, Clip, SDL_FRect{ Position_Ptr->x, Position_Ptr->y, Clip.w, Clip.h }, Sprite.Colour );
+  }
+}
+
+
+/**
+ * @brief Moves every entity with a velocity by the elapsed time, keeps its box inside an area and
+ * makes it bounce off the edges it reached.
+ *
+ * @param Positions Moved and confined.
+ * @param Velocities In pixels per second; turned inwards at the edges.
+ * @param Boxes The collision boxes.
+ * @param Area Where the boxes must stay.
+ * @param TimeStep_s Since the last step.
+ * @param Jobs_Ptr If given, large crowds are stepped in ranges on its workers too.
+ **/
+void StepEntities( LComponentArray<LPosition>& Positions, LComponentArray<LVelocity>& Velocities, const LComponentArray<LBox>& Boxes,
+                   const SDL_Rect& Area, double TimeStep_s, LJobSystem* Jobs_Ptr )
+{
+  const size_t Count   = Velocities.size();
+  const size_t Threads = ( Jobs_Ptr != nullptr ) ? static_cast<size_t>( Jobs_Ptr->GetWorkerCount() ) + 1 : 1;
+  const size_t Ranges  = std::min( Threads * RANGES_PER_THREAD, Count / MIN_RANGE_ENTITIES );
+
+  const StepRun Bounds{ nullptr, nullptr, nullptr, 0, static_cast<float>( TimeStep_s ),
+                        { static_cast<float>( Area.x ), static_cast<float>( Area.y ) },
+                        { static_cast<float>( Area.x + Area.w ), static_cast<float>( Area.y + Area.h ) } };
+
+  if ( Ranges <= 1 || Threads == 1 )
+  {
+    StepRange_Pvt( StepRange{ &Positions, &Velocities, &Boxes, 0, Count, Bounds } );
+    return;
+  }
+  else
+  {;}
+
+  LSmallVector<StepRange, 64> Work;
+  size_t                      First = 0;
+
+  Work.reserve( Ranges );
+
+  for ( size_t Range = 1; Range <= Ranges; ++Range )
+  {
+    const size_t Last = ( Range != Ranges ) ? Count * Range / Ranges / RANGE_ALIGNMENT * RANGE_ALIGNMENT : Count;
+
+    if ( Last > First )
+    {
+      Work.push_back( StepRange{ &Positions, &Velocities, &Boxes, First, Last, Bounds } );
+      First = Last;
+    }
+    else
+    {;}
+  }
+
+  LJobCounter Done;
+
+  for ( StepRange& Range : Work )
+  {
+    Jobs_Ptr->run( RunStepRange, &Range, &Done );
+  }
+
+  Jobs_Ptr->wait( Done );
+}
+
+
+/**
+ * @brief The name of the kernel StepEntities uses on this CPU: "AVX", "SSE2", "NEON" or "Scalar".
+ **/
+const char* GetEntityKernel( void )
+{
+  return Kernel().Name;
+}
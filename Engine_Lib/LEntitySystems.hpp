@@ -0,0 +1,86 @@
+/**
+ * @file LEntitySystems.hpp
+ *
+ * @brief The components most entities are made of, and the systems that move, confine, index and
+ * draw all of them, each in one loop over the component arrays of LEntityStore.
+ **/
+
+#ifndef LENTITYSYSTEMS_HPP
+#define LENTITYSYSTEMS_HPP
+
+#include <SDL.h>
+#include "LCollision.hpp"
+#include "LEntityStore.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+
+class LJobSystem;
+
+/**
+ * @brief Top left corner, in pixels.
+ **/
+struct LPosition
+{
+  float x;
+  float y;
+};
+
+
+/**
+ * @brief In pixels per second.
+ **/
+struct LVelocity
+{
+  float x;
+  float y;
+};
+
+
+/**
+ * @brief Size of the collision box, whose top left corner is the position.
+ **/
+struct LBox
+{
+  int w;
+  int h;
+};
+
+
+/**
+ * @brief What to draw at the position: a clip of a texture, all of it when the clip is empty,
+ * tinted by a colour. The texture must outlive the component.
+ **/
+struct LSprite
+{
+  const LTexture* Texture_Ptr;
+  SDL_Rect        Clip;
+  SDL_Color       Colour;
+};
+
+
+/*
+ * Systems. Each walks the packed components of its first array and finds the matching component
+ * of the others in the same slot when the arrays are in the same order (see
+ * LComponentArray::sortLike), through the sparse lookup otherwise. Entities missing one of the
+ * components are skipped.
+ */
+
+void        MoveEntities       ( LComponentArray<LPosition>&, const LComponentArray<LVelocity>&, double );
+void        ConfineEntities    ( LComponentArray<LPosition>&, const LComponentArray<LBox>&, const SDL_Rect&, LComponentArray<LVelocity>* = nullptr );
+void        GridEntities       ( const LComponentArray<LPosition>&, const LComponentArray<LBox>&, LSpatialGrid& );
+void        DrawEntities       ( const LComponentArray<LPosition>&, const LComponentArray<LSprite>&, LSpriteBatch& );
+
+/*
+ * Move, confine and bounce in a single pass: the core update of crowds. When the three arrays are
+ * in the same order (the entities got their components together, or were sorted with "sortLike"),
+ * positions, velocities and boxes are walked as plain runs of floats and ints, 4 or 8 lanes at a
+ * time with SSE2, AVX or NEON, clamped with min / max instead of branches; with a job system, large
+ * crowds are split in ranges run on its workers and the calling thread. Ranges whose slots do not
+ * match are stepped entity by entity, through the lookup. Entities with no velocity are left alone;
+ * every kernel gives the same results.
+ */
+void        StepEntities       ( LComponentArray<LPosition>&, LComponentArray<LVelocity>&, const LComponentArray<LBox>&,
+                                 const SDL_Rect&, double, LJobSystem* = nullptr );
+const char* GetEntityKernel    ( void );
+
+#endif // LENTITYSYSTEMS_HPP
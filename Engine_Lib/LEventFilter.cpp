@@ -0,0 +1,267 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LEventFilter.hpp"
+
+#include <algorithm>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Whether an event has to pass whatever was subscribed to. SDL calls the event watches, the
+ * renderer's among them, only with the events the filter kept: window, display and render events
+ * pass for them.
+ **/
+static bool IsVital( Uint32 Type )
+{
+  return Type == SDL_QUIT || ( Type >= SDL_APP_TERMINATING && Type <= SDL_APP_DIDENTERFOREGROUND ) ||
+         Type == SDL_DISPLAYEVENT || Type == SDL_WINDOWEVENT || Type == SDL_RENDER_TARGETS_RESET || Type == SDL_RENDER_DEVICE_RESET;
+}
+
+
+/**
+ * @brief Whether a motion event continues the one before it: same window, same mouse.
+ **/
+static bool IsSameMotion( const SDL_Event& Previous, const SDL_Event& Event )
+{
+  return Previous.type == SDL_MOUSEMOTION && Event.type == SDL_MOUSEMOTION &&
+         Previous.motion.windowID == Event.motion.windowID && Previous.motion.which == Event.motion.which;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LEventFilter::LEventFilter( void )
+  : m_Subscribed(), m_IsFiltering(false), m_IsInstalled(false), m_Previous(nullptr), m_PreviousData_Ptr(nullptr),
+    m_Events(), m_Next(0), m_IsFilled(false), m_Budget(s_DEFAULT_BUDGET), m_Dropped(0), m_Coalesced(0)
+{
+  m_Events.reserve( m_Budget );
+}
+
+
+LEventFilter::~LEventFilter( void )
+{
+  uninstall();
+}
+
+
+/**
+ * @brief Keeps the events of a type; to be called before "install".
+ **/
+void LEventFilter::subscribe( Uint32 Type )
+{
+  subscribe( Type, Type );
+}
+
+
+/**
+ * @brief Keeps the events of the types from First to Last, both included (e.g. SDL_KEYDOWN to
+ * SDL_KEYMAPCHANGED); to be called before "install".
+ **/
+void LEventFilter::subscribe( Uint32 First, Uint32 Last )
+{
+  for ( Uint32 Type = First; Type <= Last && Type < SDL_LASTEVENT; ++Type )
+  {
+    m_Subscribed.set( Type );
+    m_IsFiltering = true;
+  }
+}
+
+
+/**
+ * @brief Sets the filter, and drops the events already queued that it would not have let in.
+ **/
+void LEventFilter::install( void )
+{
+  if ( m_IsInstalled )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( !SDL_GetEventFilter( &m_Previous, &m_PreviousData_Ptr ) )
+  {
+    m_Previous         = nullptr;
+    m_PreviousData_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  SDL_SetEventFilter( Filter_Pvt, this );
+  SDL_FilterEvents  ( Filter_Pvt, this );
+
+  m_IsInstalled = true;
+}
+
+
+/**
+ * @brief Sets back the filter found by "install".
+ **/
+void LEventFilter::uninstall( void )
+{
+  if ( !m_IsInstalled )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_SetEventFilter( m_Previous, m_PreviousData_Ptr );
+
+  m_IsInstalled = false;
+}
+
+
+/**
+ * @brief Sets how many events a frame handles at most, at least 1.
+ **/
+void LEventFilter::setBudget( size_t Budget )
+{
+  m_Budget = std::max( Budget, static_cast<size_t>( 1 ) );
+  m_Events.reserve( m_Budget );
+}
+
+
+/**
+ * @brief Hands out the next event of the frame, as SDL_PollEvent.
+ *
+ * @return false at the end of the frame's events; the next call starts the next frame's.
+ **/
+bool LEventFilter::poll( SDL_Event& Event )
+{
+  if ( m_Next == m_Events.size() )
+  {
+    if ( m_IsFilled )
+    {
+      m_IsFilled = false;
+      return false;
+    }
+    else
+    {;}
+
+    Fill_Pvt();
+
+    if ( m_Events.empty() )
+    {
+      return false;
+    }
+    else
+    {
+      m_IsFilled = true;
+    }
+  }
+  else
+  {;}
+
+  Event = m_Events[m_Next++];
+
+  return true;
+}
+
+
+/**
+ * @brief Waits for an event, as SDL_WaitEventTimeout, leaving it queued for "poll".
+ *
+ * @param Timeout_ms Longest wait; returns at once if the frame has events left to hand out.
+ * @return false if no event arrived in time.
+ **/
+bool LEventFilter::wait( int Timeout_ms )
+{
+  if ( m_Next != m_Events.size() )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  return SDL_WaitEventTimeout( nullptr, Timeout_ms ) != 0;
+}
+
+
+bool LEventFilter::IsSubscribed( Uint32 Type ) const
+{
+  return !m_IsFiltering || IsVital( Type ) || ( Type < SDL_LASTEVENT && m_Subscribed.test( Type ) );
+}
+
+
+/**
+ * @return Events dropped by the filter since it was created.
+ **/
+Uint32 LEventFilter::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Motion events merged into a later one since the filter was created.
+ **/
+Uint64 LEventFilter::GetCoalesced( void ) const
+{
+  return m_Coalesced;
+}
+
+
+/**
+ * @brief The SDL event filter: 1 keeps the event, 0 drops it.
+ **/
+int SDLCALL LEventFilter::Filter_Pvt( void* Data_Ptr, SDL_Event* Event_Ptr )
+{
+  LEventFilter& Filter = *static_cast<LEventFilter*>( Data_Ptr );
+
+  if ( !Filter.IsSubscribed( Event_Ptr->type ) )
+  {
+    Filter.m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+    return 0;
+  }
+  else
+  {;}
+
+  return ( Filter.m_Previous != nullptr ) ? Filter.m_Previous( Filter.m_PreviousData_Ptr, Event_Ptr ) : 1;
+}
+
+
+/**
+ * @brief Takes the frame's events from the queue, up to the budget, motion merged.
+ **/
+void LEventFilter::Fill_Pvt( void )
+{
+  m_Events.clear();
+  m_Next = 0;
+
+  SDL_PumpEvents();
+
+  SDL_Event Event;
+
+  while ( m_Events.size() < m_Budget && SDL_PeepEvents( &Event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT ) > 0 )
+  {
+    // Queued before "install", or with no filter installed
+    if ( !IsSubscribed( Event.type ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    if ( !m_Events.empty() && IsSameMotion( m_Events.back(), Event ) )
+    {
+      SDL_MouseMotionEvent& Motion = m_Events.back().motion;
+
+      Event.motion.xrel += Motion.xrel;
+      Event.motion.yrel += Motion.yrel;
+      Motion             = Event.motion;
+      ++m_Coalesced;
+    }
+    else
+    {
+      m_Events.push_back( Event );
+    }
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file LEventFilter.hpp
+ *
+ * @brief The event queue with only the event types the program handles, and the mouse motion
+ * merged: a mouse polled at 1000 Hz or more queues dozens of motion events per frame, each one
+ * handed to every element that follows the mouse.
+ **/
+
+#ifndef LEVENTFILTER_HPP
+#define LEVENTFILTER_HPP
+
+#include <SDL.h>
+#include <atomic>
+#include <bitset>
+#include <vector>
+
+/**
+ * @brief "install" sets an SDL event filter (SDL_SetEventFilter) that drops, as they are queued,
+ * the events of the types nobody subscribed to: they neither fill the queue nor wake an
+ * SDL_WaitEvent. SDL_QUIT, the application events (SDL_APP_*), and the display, window and render
+ * events, which the renderer itself watches, always pass. Without "install", or with no type
+ * subscribed, every type passes.
+ *
+ * "poll" replaces the SDL_PollEvent loop: the first call of a frame drains the queue, at most
+ * s_DEFAULT_BUDGET events or the budget set, merging every run of mouse motion events of the same
+ * window and mouse into the last one, with the relative motion summed; the calls that follow hand
+ * the events out in order, and return false at the end of them. The events left over stay queued
+ * for the next frame, so that the work of a frame is bounded however many events arrive.
+ *
+ * Only one filter is installed at a time: the one found by "install" is called for the events kept,
+ * and set back by "uninstall". SDL calls the filter from the thread that queues the event, so the
+ * subscriptions are made before "install". Everything else is called from the main thread, after
+ * SDL_Init (SDL_Quit removes the filter).
+ **/
+class LEventFilter
+{
+public:
+
+  static constexpr size_t s_DEFAULT_BUDGET = 256;   // Events per frame
+
+  LEventFilter( void );
+  ~LEventFilter( void );
+
+  LEventFilter( const LEventFilter& )            = delete;
+  LEventFilter& operator=( const LEventFilter& ) = delete;
+
+  void   subscribe      ( Uint32 );
+  void   subscribe      ( Uint32, Uint32 );
+  void   install        ( void );
+  void   uninstall      ( void );
+  void   setBudget      ( size_t );
+
+  bool   poll           ( SDL_Event& );
+  bool   wait           ( int );
+
+  bool   IsSubscribed   ( Uint32 ) const;
+  Uint32 GetDropped     ( void ) const;
+  Uint64 GetCoalesced   ( void ) const;
+
+private:
+
+  static int SDLCALL Filter_Pvt( void*, SDL_Event* );
+
+  void Fill_Pvt( void );
+
+  std::bitset<SDL_LASTEVENT> m_Subscribed;      // By event type
+  bool                       m_IsFiltering;     // Some type is subscribed
+  bool                       m_IsInstalled;
+  SDL_EventFilter            m_Previous;        // Found by "install"
+  void*                      m_PreviousData_Ptr;
+  std::vector<SDL_Event>     m_Events;          // Of the frame
+  size_t                     m_Next;
+  bool                       m_IsFilled;        // m_Events is the frame's, until handed out
+  size_t                     m_Budget;
+  std::atomic<Uint32>        m_Dropped;         // By the filter, on any thread
+  Uint64                     m_Coalesced;       // Motion events merged into the next one
+};
+
+#endif // LEVENTFILTER_HPP
@@ -0,0 +1,65 @@
+/**
+ * @file LFixed.hpp
+ *
+ * @brief 16.16 fixed point numbers, for physics that gives the same bits on every compiler, FPU mode
+ * and platform, and runs on targets without an FPU.
+ **/
+
+#ifndef LFIXED_HPP
+#define LFIXED_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief A signed 16.16 fixed point number: Raw / 65536, from -32768 to 32768 minus 1 / 65536.
+ *
+ * Every operation is done on integers, the products and quotients on 64 bits, and rounds toward zero
+ * as the integer division does: the results depend on nothing but the operands. Going out of the
+ * range is undefined, as for any signed integer.
+ *
+ * FromDouble is for the constants, computed at compile time, and for the parameters read once, as
+ * from a file: the loops should see only fixed point numbers.
+ **/
+struct LFixed
+{
+  static constexpr int    FRACTION_BITS = 16;
+  static constexpr Sint32 ONE           = 1 << FRACTION_BITS;
+
+  Sint32 Raw;
+
+  static constexpr LFixed FromRaw( Sint32 Value )    { return LFixed{ Value }; }
+  static constexpr LFixed FromInt( int Value )       { return LFixed{ static_cast<Sint32>( Value ) * ONE }; }
+
+  // Rounded to the nearest
+  static constexpr LFixed FromDouble( double Value )
+  {
+    return LFixed{ static_cast<Sint32>( Value * ONE + ( ( Value < 0.0 ) ? -0.5 : 0.5 ) ) };
+  }
+
+  // Toward zero, as static_cast<int> of a double
+  constexpr int    ToInt   ( void ) const            { return static_cast<int>( Raw / ONE ); }
+  constexpr double ToDouble( void ) const            { return static_cast<double>( Raw ) / ONE; }
+
+  constexpr LFixed operator-( void ) const           { return LFixed{ -Raw }; }
+
+  constexpr LFixed operator+( LFixed Other ) const   { return LFixed{ Raw + Other.Raw }; }
+  constexpr LFixed operator-( LFixed Other ) const   { return LFixed{ Raw - Other.Raw }; }
+  constexpr LFixed operator*( LFixed Other ) const   { return LFixed{ static_cast<Sint32>( static_cast<Sint64>( Raw ) * Other.Raw / ONE ) }; }
+  constexpr LFixed operator/( LFixed Other ) const   { return LFixed{ static_cast<Sint32>( static_cast<Sint64>( Raw ) * ONE / Other.Raw ) }; }
+  constexpr LFixed operator*( int Value ) const      { return LFixed{ Raw * Value }; }
+  constexpr LFixed operator/( int Value ) const      { return LFixed{ Raw / Value }; }
+
+  LFixed& operator+=( LFixed Other )                 { Raw += Other.Raw; return *this; }
+  LFixed& operator-=( LFixed Other )                 { Raw -= Other.Raw; return *this; }
+
+  constexpr bool operator==( LFixed Other ) const    { return Raw == Other.Raw; }
+  constexpr bool operator!=( LFixed Other ) const    { return Raw != Other.Raw; }
+  constexpr bool operator< ( LFixed Other ) const    { return Raw <  Other.Raw; }
+  constexpr bool operator> ( LFixed Other ) const    { return Raw >  Other.Raw; }
+  constexpr bool operator<=( LFixed Other ) const    { return Raw <= Other.Raw; }
+  constexpr bool operator>=( LFixed Other ) const    { return Raw >= Other.Raw; }
+};
+
+static_assert( sizeof(LFixed) == 4, "A fixed point number is its raw value" );
+
+#endif // LFIXED_HPP
@@ -0,0 +1,276 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LFrameArena.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdlib>
+#include <new>
+
+
+/***************************************************************************************************
+* Private variables
+****************************************************************************************************/
+
+// Calls of operator new since the start of the program, from any thread
+static std::atomic<Uint64> HeapAllocations( 0 );
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static Uint8* AlignUp( Uint8* Pointer, size_t Alignment )
+{
+  const uintptr_t Address = reinterpret_cast<uintptr_t>( Pointer );
+
+  return Pointer + ( ( Alignment - Address % Alignment ) % Alignment );
+}
+
+
+#if !defined(NDEBUG)
+/*
+ * Replacements of the global allocation functions, counting. The other forms (arrays, nothrow,
+ * sized delete) end up here as well.
+ */
+void* operator new( size_t Size )
+{
+  HeapAllocations.fetch_add( 1, std::memory_order_relaxed );
+
+  void* Memory_Ptr = std::malloc( Size != 0 ? Size : 1 );
+
+  if ( Memory_Ptr == nullptr )
+  {
+    throw std::bad_alloc();
+  }
+  else
+  {;}
+
+  return Memory_Ptr;
+}
+
+
+void operator delete( void* Memory_Ptr ) noexcept
+{
+  std::free( Memory_Ptr );
+}
+
+
+void operator delete( void* Memory_Ptr, size_t ) noexcept
+{
+  std::free( Memory_Ptr );
+}
+#endif
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param Capacity Bytes of the block; it grows if a frame ever needs more.
+ **/
+LFrameArena::LFrameArena( size_t Capacity )
+  : m_Block( std::max( Capacity, static_cast<size_t>( 1 ) ) ), m_Next_Ptr(m_Block.data()),
+    m_End_Ptr(m_Block.data() + m_Block.size()), m_Used(0), m_Peak(0),
+    m_HeapAtReset( GetHeapAllocations() ), m_FrameHeap(0), m_HeapFrames(0), m_Frames(0)
+{
+  m_Overflow.reserve( 8 );
+}
+
+
+LFrameArena::~LFrameArena( void )
+{;}
+
+
+/**
+ * @brief Room for Size bytes until the next "reset".
+ *
+ * @param Alignment A power of two.
+ * @return The memory, uninitialised. Never nullptr.
+ **/
+void* LFrameArena::allocate( size_t Size, size_t Alignment )
+{
+  Uint8* const Start_Ptr = AlignUp( m_Next_Ptr, Alignment );
+
+  if ( Start_Ptr > m_End_Ptr || Size > static_cast<size_t>( m_End_Ptr - Start_Ptr ) )
+  {
+    return Overflow_Pvt( Size, Alignment );
+  }
+  else
+  {;}
+
+  m_Used     += static_cast<size_t>( Start_Ptr - m_Next_Ptr ) + Size;
+  m_Next_Ptr  = Start_Ptr + Size;
+
+  return Start_Ptr;
+}
+
+
+/**
+ * @brief printf into the arena, with the format of SDL_snprintf.
+ *
+ * @return The string, until the next "reset"; an empty one if the format is wrong.
+ **/
+const char* LFrameArena::format( const char* Format, ... )
+{
+  va_list Arguments;
+  va_list Again;
+
+  va_start( Arguments, Format );
+  va_copy( Again, Arguments );
+
+  // Straight into the free part of the block, which is almost always large enough
+  const size_t Room   = static_cast<size_t>( m_End_Ptr - m_Next_Ptr );
+  const int    Length = SDL_vsnprintf( reinterpret_cast<char*>( m_Next_Ptr ), Room, Format, Arguments );
+  char*        Text_Ptr;
+
+  if ( Length < 0 )
+  {
+    Text_Ptr = static_cast<char*>( allocate( 1, 1 ) );
+    Text_Ptr[0] = '\0';
+  }
+  else if ( static_cast<size_t>( Length ) < Room )
+  {
+    Text_Ptr = static_cast<char*>( allocate( static_cast<size_t>( Length ) + 1, 1 ) );
+  }
+  else
+  {
+    Text_Ptr = static_cast<char*>( allocate( static_cast<size_t>( Length ) + 1, 1 ) );
+    SDL_vsnprintf( Text_Ptr, static_cast<size_t>( Length ) + 1, Format, Again );
+  }
+
+  va_end( Again );
+  va_end( Arguments );
+
+  return Text_Ptr;
+}
+
+
+/**
+ * @brief Takes back everything allocated since the last reset, at the end of a frame.
+ **/
+void LFrameArena::reset( void )
+{
+  m_Peak = std::max( m_Peak, m_Used );
+
+  // The frame did not fit: the block grows to hold the largest one so far
+  if ( !m_Overflow.empty() )
+  {
+    m_Overflow.clear();
+    std::vector<Uint8>( m_Peak + m_Peak / 4 ).swap( m_Block );
+  }
+  else
+  {;}
+
+  m_Next_Ptr = m_Block.data();
+  m_End_Ptr  = m_Block.data() + m_Block.size();
+  m_Used     = 0;
+
+  const Uint64 Heap = GetHeapAllocations();
+
+  m_FrameHeap   = Heap - m_HeapAtReset;
+  m_HeapAtReset = Heap;
+  m_HeapFrames += ( m_FrameHeap != 0 ) ? 1 : 0;
+  ++m_Frames;
+}
+
+
+/**
+ * @return Bytes handed out since the last reset.
+ **/
+size_t LFrameArena::GetUsed( void ) const
+{
+  return m_Used;
+}
+
+
+size_t LFrameArena::GetCapacity( void ) const
+{
+  return m_Block.size();
+}
+
+
+/**
+ * @return The most bytes used by a frame.
+ **/
+size_t LFrameArena::GetPeak( void ) const
+{
+  return std::max( m_Peak, m_Used );
+}
+
+
+/**
+ * @return Calls of operator new since the program started, by any thread; always 0 with NDEBUG.
+ **/
+Uint64 LFrameArena::GetHeapAllocations( void )
+{
+  return HeapAllocations.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Heap allocations between the last two resets, by any thread.
+ **/
+Uint64 LFrameArena::GetFrameHeapAllocations( void ) const
+{
+  return m_FrameHeap;
+}
+
+
+/**
+ * @return The frames, up to the last reset, during which the heap was allocated from.
+ **/
+Uint64 LFrameArena::GetHeapFrames( void ) const
+{
+  return m_HeapFrames;
+}
+
+
+Uint64 LFrameArena::GetFrames( void ) const
+{
+  return m_Frames;
+}
+
+
+/**
+ * @return The arena of the main loop, reset by PresentFrame.
+ **/
+LFrameArena& LFrameArena::GetFrame( void )
+{
+  static LFrameArena Frame;
+
+  return Frame;
+}
+
+
+/**
+ * @brief A block from the heap for what does not fit in the current one, freed at the next reset.
+ **/
+void* LFrameArena::Overflow_Pvt( size_t Size, size_t Alignment )
+{
+  m_Overflow.emplace_back( std::max( Size + Alignment, m_Block.size() ) );
+
+  std::vector<Uint8>& Block     = m_Overflow.back();
+  Uint8* const        Start_Ptr = AlignUp( Block.data(), Alignment );
+
+  m_Used     += static_cast<size_t>( Start_Ptr - Block.data() ) + Size;
+  m_Next_Ptr  = Start_Ptr + Size;
+  m_End_Ptr   = Block.data() + Block.size();
+
+  return Start_Ptr;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+void PresentFrame( SDL_Renderer* Renderer_Ptr )
+{
+  SDL_RenderPresent( Renderer_Ptr );
+  LFrameArena::GetFrame().reset();
+}
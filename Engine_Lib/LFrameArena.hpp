@@ -0,0 +1,91 @@
+/**
+ * @file LFrameArena.hpp
+ *
+ * @brief Linear allocator for the temporaries of a frame, emptied once per frame.
+ **/
+
+#ifndef LFRAMEARENA_HPP
+#define LFRAMEARENA_HPP
+
+#include <SDL.h>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief One block of memory handed out by moving a pointer forward, and taken back all at once by
+ * "reset": allocating is a few instructions, and nothing is freed one by one. Strings formatted for
+ * the HUD, scratch arrays and the like live until the end of the frame, with no heap allocation.
+ *
+ * A frame that needs more than the block takes extra blocks from the heap; the next "reset" frees
+ * them and grows the block to the most used so far, so that from then on the frame fits again.
+ *
+ * "GetFrame" is the arena of the main loop, reset by PresentFrame. Not thread safe: other threads
+ * use arenas of their own.
+ *
+ * In builds without NDEBUG, every "operator new" of the program is counted: "reset" keeps how many
+ * happened during the frame, to check that the steady state allocates nothing.
+ **/
+class LFrameArena
+{
+public:
+
+  static constexpr size_t s_DEFAULT_CAPACITY = 256 * 1024;
+
+  explicit LFrameArena( size_t = s_DEFAULT_CAPACITY );
+  ~LFrameArena( void );
+
+  LFrameArena( const LFrameArena& )            = delete;
+  LFrameArena& operator=( const LFrameArena& ) = delete;
+
+  void*         allocate   ( size_t, size_t = alignof(std::max_align_t) );
+  const char*   format     ( SDL_PRINTF_FORMAT_STRING const char*, ... ) SDL_PRINTF_VARARG_FUNC( 2 );
+  void          reset      ( void );
+
+  /**
+   * @brief Room for Count objects of a trivial type, left uninitialised; nothing is destroyed.
+   **/
+  template <typename T>
+  T* allocateArray( size_t Count )
+  {
+    static_assert( std::is_trivially_destructible<T>::value, "Arena objects are never destroyed" );
+
+    return static_cast<T*>( allocate( Count * sizeof(T), alignof(T) ) );
+  }
+
+  size_t        GetUsed    ( void ) const;
+  size_t        GetCapacity( void ) const;
+  size_t        GetPeak    ( void ) const;
+
+  // Heap allocations, without NDEBUG only: all of them, those of the last frame, and the frames
+  // that had any
+  static Uint64 GetHeapAllocations     ( void );
+  Uint64        GetFrameHeapAllocations( void ) const;
+  Uint64        GetHeapFrames          ( void ) const;
+  Uint64        GetFrames              ( void ) const;
+
+  static LFrameArena& GetFrame( void );
+
+private:
+
+  void* Overflow_Pvt( size_t, size_t );
+
+  std::vector<Uint8>               m_Block;
+  std::vector< std::vector<Uint8> > m_Overflow;   // Extra blocks of this frame, freed by "reset"
+  Uint8*                           m_Next_Ptr;    // First free byte of the current block
+  Uint8*                           m_End_Ptr;     // End of the current block
+  size_t                           m_Used;        // Bytes handed out this frame, blocks included
+  size_t                           m_Peak;
+  Uint64                           m_HeapAtReset;
+  Uint64                           m_FrameHeap;
+  Uint64                           m_HeapFrames;
+  Uint64                           m_Frames;
+};
+
+
+/**
+ * @brief SDL_RenderPresent, then resets the frame arena: the temporaries of the frame are gone.
+ **/
+void PresentFrame( SDL_Renderer* );
+
+#endif // LFRAMEARENA_HPP
@@ -0,0 +1,533 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LFrameCapture.hpp"
+#include "LTrace.hpp"
+
+#include <SDL_image.h>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 STAGING_FORMAT = SDL_PIXELFORMAT_ARGB8888; // Native to most renderers: no conversion on read back
+static constexpr Uint32 ENCODED_FORMAT = SDL_PIXELFORMAT_RGB888;   // The same bytes, alpha ignored: frames are opaque
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static bool EndsWith( const std::string& Text, const char* Suffix )
+{
+  const size_t Length = SDL_strlen( Suffix );
+
+  return Text.size() >= Length && Text.compare( Text.size() - Length, Length, Suffix ) == 0;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LFrameEncoder::LFrameEncoder( void )
+  : m_Pixels(), m_Free( s_NUM_OF_BUFFERS ), m_Filled(), m_Acquired{ nullptr, 0 }, m_Path(), m_Format(Format::PNG_SEQUENCE),
+    m_Width(0), m_Height(0), m_Pitch(0), m_PixelFormat(SDL_PIXELFORMAT_UNKNOWN), m_NextNumber(0), m_Video_Ptr(nullptr),
+    m_Encoder_Ptr(nullptr), m_Encoded(0), m_Dropped(0), m_Failures(0)
+{;}
+
+
+LFrameEncoder::~LFrameEncoder( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Allocates the buffers and starts the encoder thread.
+ *
+ * @param Path Prefix of the PNG files, or the raw video file.
+ * @param Width, Height Size of every frame, in pixels.
+ * @param PixelFormat Layout of the pixels submitted, e.g. SDL_PIXELFORMAT_ARGB8888.
+ * @return true if running.
+ **/
+bool LFrameEncoder::start( const std::string& Path, Format Written, int Width, int Height, Uint32 PixelFormat )
+{
+  stop();
+
+  m_Path        = Path;
+  m_Format      = Written;
+  m_Width       = Width;
+  m_Height      = Height;
+  m_Pitch       = Width * SDL_BYTESPERPIXEL( PixelFormat );
+  m_PixelFormat = PixelFormat;
+  m_NextNumber  = 0;
+  m_Acquired    = Frame{ nullptr, 0 };
+  m_Encoded.store( 0, std::memory_order_relaxed );
+  m_Dropped.store( 0, std::memory_order_relaxed );
+  m_Failures.store( 0, std::memory_order_relaxed );
+
+  if ( Width <= 0 || Height <= 0 || m_Pitch <= 0 )
+  {
+    printf( "\nUnable to capture %dx%d frames!", Width, Height );
+    return false;
+  }
+  else
+  {;}
+
+  if ( m_Format == Format::RAW_VIDEO )
+  {
+    m_Video_Ptr = SDL_RWFromFile( m_Path.c_str(), "wb" );
+
+    if ( m_Video_Ptr == nullptr )
+    {
+      printf( "\nUnable to create %s! SDL Error: %s", m_Path.c_str(), SDL_GetError() );
+      return false;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  const size_t FrameBytes = static_cast<size_t>( m_Pitch ) * static_cast<size_t>( m_Height );
+
+  m_Pixels.assign( s_NUM_OF_BUFFERS * FrameBytes, 0 );
+
+  // No thread is running: this one can fill the ring from the encoder's side
+  Uint8* Stale_Ptr = nullptr;
+
+  while ( m_Free.pop( Stale_Ptr ) )
+  {;}
+
+  for ( size_t i = 0; i != s_NUM_OF_BUFFERS; ++i )
+  {
+    m_Free.push( m_Pixels.data() + i * FrameBytes );
+  }
+
+  m_Filled.reset( new FrameQueue( s_NUM_OF_BUFFERS ) );
+  m_Encoder_Ptr = SDL_CreateThread( Encoder_Pvt, "LFrameEncoder", this );
+
+  if ( m_Encoder_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the frame encoder thread! SDL Error: %s", SDL_GetError() );
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  if ( m_Format == Format::RAW_VIDEO )
+  {
+    printf( "\nCapturing raw video to %s: %dx%d, %s, %d bytes per row", m_Path.c_str(), m_Width, m_Height,
+            SDL_GetPixelFormatName( m_PixelFormat ), m_Pitch );
+  }
+  else
+  {
+    printf( "\nCapturing %dx%d frames to %s_<frame>.png", m_Width, m_Height, m_Path.c_str() );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the frames submitted and not written yet, then stops the thread and closes the file.
+ **/
+void LFrameEncoder::stop( void )
+{
+  if ( m_Encoder_Ptr != nullptr )
+  {
+    m_Filled->close();
+    SDL_WaitThread( m_Encoder_Ptr, nullptr );
+    m_Encoder_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Filled.reset();
+
+  if ( m_Video_Ptr != nullptr )
+  {
+    if ( SDL_RWclose( m_Video_Ptr ) != 0 )
+    {
+      m_Failures.fetch_add( 1, std::memory_order_relaxed );
+    }
+    else
+    {;}
+
+    m_Video_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Acquired = Frame{ nullptr, 0 };
+}
+
+
+/**
+ * @brief A buffer for the next frame, GetPitch * GetHeight bytes, to fill and submit. A buffer
+ * acquired and not submitted is handed out again.
+ *
+ * @return nullptr if no buffer is free: the frame is dropped.
+ **/
+Uint8* LFrameEncoder::acquire( void )
+{
+  if ( m_Encoder_Ptr == nullptr )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  const Uint32 Number = m_NextNumber++;
+
+  if ( m_Acquired.Pixels_Ptr == nullptr && !m_Free.pop( m_Acquired.Pixels_Ptr ) )
+  {
+    m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+    return nullptr;
+  }
+  else
+  {;}
+
+  m_Acquired.Number = Number;
+
+  return m_Acquired.Pixels_Ptr;
+}
+
+
+/**
+ * @brief Hands the buffer filled to the encoder thread. Never waits.
+ **/
+void LFrameEncoder::submit( Uint8* Pixels_Ptr )
+{
+  if ( Pixels_Ptr == nullptr || Pixels_Ptr != m_Acquired.Pixels_Ptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // There are as many slots as buffers: the push cannot fail
+  m_Filled->tryPush( m_Acquired );
+  m_Acquired = Frame{ nullptr, 0 };
+}
+
+
+bool LFrameEncoder::IsRunning( void ) const
+{
+  return m_Encoder_Ptr != nullptr;
+}
+
+
+int LFrameEncoder::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LFrameEncoder::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+int LFrameEncoder::GetPitch( void ) const
+{
+  return m_Pitch;
+}
+
+
+Uint32 LFrameEncoder::GetPixelFormat( void ) const
+{
+  return m_PixelFormat;
+}
+
+
+Uint32 LFrameEncoder::GetEncoded( void ) const
+{
+  return m_Encoded.load( std::memory_order_relaxed );
+}
+
+
+Uint32 LFrameEncoder::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+Uint32 LFrameEncoder::GetFailures( void ) const
+{
+  return m_Failures.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Writes the frames as they come, and gives their buffers back; returns once the queue is
+ * closed and empty.
+ **/
+int SDLCALL LFrameEncoder::Encoder_Pvt( void* Encoder_Ptr )
+{
+  LFrameEncoder& Self = *static_cast<LFrameEncoder*>( Encoder_Ptr );
+  Frame          Filled;
+
+  LTrace::nameThread( "LFrameEncoder" );
+
+  while ( Self.m_Filled->pop( Filled ) )
+  {
+    if ( Self.Write_Pvt( Filled ) )
+    {
+      Self.m_Encoded.fetch_add( 1, std::memory_order_relaxed );
+    }
+    else
+    {
+      Self.m_Failures.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    Self.m_Free.push( Filled.Pixels_Ptr );
+  }
+
+  return 0;
+}
+
+
+bool LFrameEncoder::Write_Pvt( const Frame& Filled )
+{
+  LTrace::Zone Traced( "Encode frame" );
+
+  if ( m_Format == Format::RAW_VIDEO )
+  {
+    return SDL_RWwrite( m_Video_Ptr, Filled.Pixels_Ptr, static_cast<size_t>( m_Pitch ) * static_cast<size_t>( m_Height ), 1 ) == 1;
+  }
+  else
+  {;}
+
+  char Name[32];
+  snprintf( Name, sizeof(Name), "_%06u.png", static_cast<unsigned>( Filled.Number ) );
+
+  SDL_Surface* Surface_Ptr = SDL_CreateRGBSurfaceWithFormatFrom( Filled.Pixels_Ptr, m_Width, m_Height, SDL_BITSPERPIXEL( m_PixelFormat ),
+                                                                 m_Pitch, m_PixelFormat );
+
+  if ( Surface_Ptr == nullptr )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const bool IsWritten = ( IMG_SavePNG( Surface_Ptr, ( m_Path + Name ).c_str() ) == 0 );
+
+  SDL_FreeSurface( Surface_Ptr );
+
+  return IsWritten;
+}
+
+
+LFrameCapture::LFrameCapture( void )
+  : m_Encoder(), m_Renderer_Ptr(nullptr), m_Staging{}, m_IsDrawn{}, m_Slot(0)
+{;}
+
+
+LFrameCapture::~LFrameCapture( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Creates the staging targets, the size of the renderer's output, and starts the encoder.
+ *
+ * @param Path See LFrameEncoder.
+ * @return true if capturing.
+ **/
+bool LFrameCapture::start( SDL_Renderer* Renderer_Ptr, const std::string& Path, LFrameEncoder::Format Written )
+{
+  stop();
+
+  int Width  = 0;
+  int Height = 0;
+
+  if ( Renderer_Ptr == nullptr || SDL_GetRendererOutputSize( Renderer_Ptr, &Width, &Height ) != 0 )
+  {
+    printf( "\nUnable to capture: no renderer output! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Renderer_Ptr = Renderer_Ptr;
+  m_Slot         = 0;
+
+  for ( int i = 0; i != s_NUM_OF_STAGING; ++i )
+  {
+    m_Staging[i] = SDL_CreateTexture( m_Renderer_Ptr, STAGING_FORMAT, SDL_TEXTUREACCESS_TARGET, Width, Height );
+    m_IsDrawn[i] = false;
+
+    if ( m_Staging[i] == nullptr )
+    {
+      printf( "\nUnable to create the capture targets! SDL Error: %s", SDL_GetError() );
+      stop();
+      return false;
+    }
+    else
+    {;}
+  }
+
+  if ( !m_Encoder.start( Path, Written, Width, Height, ENCODED_FORMAT ) )
+  {
+    stop();
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Reads back the frames drawn and not read yet, waits for the encoder to write them, and
+ * frees the staging targets. The renderer draws on the window again.
+ **/
+void LFrameCapture::stop( void )
+{
+  if ( m_Encoder.IsRunning() )
+  {
+    // Oldest first: the slot after the current one was drawn first
+    for ( int i = 1; i <= s_NUM_OF_STAGING; ++i )
+    {
+      ReadBack_Pvt( ( m_Slot + i ) % s_NUM_OF_STAGING );
+    }
+
+    m_Encoder.stop();
+
+    printf( "\nCapture stopped: %u frames written, %u dropped, %u failed",
+            m_Encoder.GetEncoded(), m_Encoder.GetDropped(), m_Encoder.GetFailures() );
+  }
+  else
+  {;}
+
+  if ( m_Renderer_Ptr != nullptr )
+  {
+    SDL_SetRenderTarget( m_Renderer_Ptr, nullptr );
+  }
+  else
+  {;}
+
+  for ( int i = 0; i != s_NUM_OF_STAGING; ++i )
+  {
+    if ( m_Staging[i] != nullptr )
+    {
+      SDL_DestroyTexture( m_Staging[i] );
+      m_Staging[i] = nullptr;
+    }
+    else
+    {;}
+
+    m_IsDrawn[i] = false;
+  }
+
+  m_Renderer_Ptr = nullptr;
+}
+
+
+/**
+ * @brief Redirects the drawing of the frame into its staging target.
+ **/
+void LFrameCapture::beginFrame( void )
+{
+  if ( !m_Encoder.IsRunning() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_SetRenderTarget( m_Renderer_Ptr, m_Staging[m_Slot] );
+}
+
+
+/**
+ * @brief Shows the frame on the window and reads back the previous one, then moves on to the next
+ * staging target: the one just read.
+ **/
+void LFrameCapture::endFrame( void )
+{
+  if ( !m_Encoder.IsRunning() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  LTrace::Zone Traced( "Capture frame" );
+
+  SDL_SetRenderTarget( m_Renderer_Ptr, nullptr );
+  SDL_RenderCopy( m_Renderer_Ptr, m_Staging[m_Slot], nullptr, nullptr );
+
+  m_IsDrawn[m_Slot] = true;
+  m_Slot            = ( m_Slot + 1 ) % s_NUM_OF_STAGING;
+
+  ReadBack_Pvt( m_Slot );
+}
+
+
+bool LFrameCapture::IsRunning( void ) const
+{
+  return m_Encoder.IsRunning();
+}
+
+
+const LFrameEncoder& LFrameCapture::GetEncoder( void ) const
+{
+  return m_Encoder;
+}
+
+
+/**
+ * @return RAW_VIDEO for a path ending in ".raw", PNG_SEQUENCE otherwise.
+ **/
+LFrameEncoder::Format LFrameCapture::GetFormatOf( const std::string& Path )
+{
+  return EndsWith( Path, ".raw" ) ? LFrameEncoder::Format::RAW_VIDEO : LFrameEncoder::Format::PNG_SEQUENCE;
+}
+
+
+/**
+ * @brief Copies a staging target into a buffer of the encoder, if one is free, and submits it. The
+ * renderer is left drawing on the window.
+ **/
+void LFrameCapture::ReadBack_Pvt( int Slot )
+{
+  if ( !m_IsDrawn[Slot] )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_IsDrawn[Slot] = false;
+
+  Uint8* Pixels_Ptr = m_Encoder.acquire();
+
+  if ( Pixels_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_SetRenderTarget( m_Renderer_Ptr, m_Staging[Slot] );
+
+  if ( SDL_RenderReadPixels( m_Renderer_Ptr, nullptr, STAGING_FORMAT, Pixels_Ptr, m_Encoder.GetPitch() ) == 0 )
+  {
+    m_Encoder.submit( Pixels_Ptr );
+  }
+  else
+  {;} // The buffer is handed out again with the next frame
+
+  SDL_SetRenderTarget( m_Renderer_Ptr, nullptr );
+}
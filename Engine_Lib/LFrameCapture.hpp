@@ -0,0 +1,143 @@
+/**
+ * @file LFrameCapture.hpp
+ *
+ * @brief Capture of the rendered frames to PNG sequences or raw video, read back from the GPU a
+ * frame late and encoded on a thread of its own, so that recording never stalls the render thread.
+ **/
+
+#ifndef LFRAMECAPTURE_HPP
+#define LFRAMECAPTURE_HPP
+
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes frames on its own thread. The render thread asks for a free buffer, fills it with
+ * the pixels of a frame and submits it; the encoder writes it out and hands the buffer back. There
+ * are s_NUM_OF_BUFFERS buffers, allocated by "start": a frame that finds none free, because the disk
+ * is behind, is dropped and counted, never waited for.
+ *
+ * PNG_SEQUENCE writes "<Path>_<frame>.png" per frame, numbered from 0 by "acquire" so that dropped
+ * frames show as gaps. RAW_VIDEO writes the frames one after the other, with no header, into
+ * "<Path>": rows top to bottom, GetPitch bytes each. "start" prints the size and the pixel format;
+ * SDL_PIXELFORMAT_RGB888 is what ffmpeg reads with "-f rawvideo -pixel_format bgr0".
+ *
+ * start, stop, acquire and submit are called from one thread.
+ **/
+class LFrameEncoder
+{
+public:
+
+  enum class Format
+  {
+    PNG_SEQUENCE,
+    RAW_VIDEO
+  };
+
+  static constexpr size_t s_NUM_OF_BUFFERS = 4;
+
+  LFrameEncoder( void );
+  ~LFrameEncoder( void );
+
+  LFrameEncoder( const LFrameEncoder& )            = delete;
+  LFrameEncoder& operator=( const LFrameEncoder& ) = delete;
+
+  bool   start         ( const std::string&, Format, int, int, Uint32 );
+  void   stop          ( void );
+  Uint8* acquire       ( void );
+  void   submit        ( Uint8* );
+
+  bool   IsRunning     ( void ) const;
+  int    GetWidth      ( void ) const;
+  int    GetHeight     ( void ) const;
+  int    GetPitch      ( void ) const;
+  Uint32 GetPixelFormat( void ) const;
+  Uint32 GetEncoded    ( void ) const;
+  Uint32 GetDropped    ( void ) const;
+  Uint32 GetFailures   ( void ) const;
+
+private:
+
+  struct Frame
+  {
+    Uint8* Pixels_Ptr;
+    Uint32 Number;
+  };
+
+  typedef LBlockingRing<LSpscRing<Frame>> FrameQueue;
+
+  static int SDLCALL Encoder_Pvt( void* );
+
+  bool Write_Pvt( const Frame& );
+
+  std::vector<Uint8>          m_Pixels;     // s_NUM_OF_BUFFERS frames
+  LSpscRing<Uint8*>           m_Free;       // Encoder to render thread
+  std::unique_ptr<FrameQueue> m_Filled;     // Render thread to encoder; closed by stop
+  Frame                       m_Acquired;   // Handed out by acquire, not submitted yet
+  std::string                 m_Path;
+  Format                      m_Format;
+  int                         m_Width;
+  int                         m_Height;
+  int                         m_Pitch;
+  Uint32                      m_PixelFormat;
+  Uint32                      m_NextNumber; // Frames acquired or dropped
+  SDL_RWops*                  m_Video_Ptr;  // RAW_VIDEO only
+  SDL_Thread*                 m_Encoder_Ptr;
+  std::atomic<Uint32>         m_Encoded;
+  std::atomic<Uint32>         m_Dropped;
+  std::atomic<Uint32>         m_Failures;
+};
+
+
+/**
+ * @brief Captures what an SDL renderer draws on the window. Between "beginFrame" and "endFrame" the
+ * renderer draws into a staging render target instead of the window; "endFrame" copies it on the
+ * window and reads back the staging target drawn the frame before, which the GPU has finished by
+ * now, into a buffer of the encoder. With s_NUM_OF_STAGING targets used in turn, the read never
+ * waits for the frame just drawn.
+ *
+ * Code switching render targets in the frame goes back to the one it found (SDL_GetRenderTarget,
+ * as LRenderTargets does), not to the window. When capture is not running, beginFrame and endFrame
+ * do nothing: the calls can stay in the main loop.
+ *
+ * Call "endFrame" last, just before SDL_RenderPresent; all calls from the render thread.
+ **/
+class LFrameCapture
+{
+public:
+
+  static constexpr int s_NUM_OF_STAGING = 2;
+
+  LFrameCapture( void );
+  ~LFrameCapture( void );
+
+  LFrameCapture( const LFrameCapture& )            = delete;
+  LFrameCapture& operator=( const LFrameCapture& ) = delete;
+
+  bool start     ( SDL_Renderer*, const std::string&, LFrameEncoder::Format );
+  void stop      ( void );
+  void beginFrame( void );
+  void endFrame  ( void );
+
+  bool                 IsRunning ( void ) const;
+  const LFrameEncoder& GetEncoder( void ) const;
+
+  static LFrameEncoder::Format GetFormatOf( const std::string& );
+
+private:
+
+  void ReadBack_Pvt( int );
+
+  LFrameEncoder m_Encoder;
+  SDL_Renderer* m_Renderer_Ptr;
+  SDL_Texture*  m_Staging[s_NUM_OF_STAGING];
+  bool          m_IsDrawn[s_NUM_OF_STAGING];  // Drawn and not read back yet
+  int           m_Slot;                       // Staging target of the current frame
+};
+
+#endif // LFRAMECAPTURE_HPP
@@ -0,0 +1,163 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LFramePacer.hpp"
+
+#include <algorithm>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 MS_IN_A_S = 1000;
+
+// Margin before the first sleep is measured, and the least one kept afterwards, in milliseconds
+static constexpr Uint64 INITIAL_MARGIN_MS = 2;
+static constexpr Uint64 MINIMUM_MARGIN_MS = 1;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LFramePacer::LFramePacer( void )
+  : m_TargetRate(0.0), m_Period(0), m_Deadline(0), m_LastFrameEnd(0), m_LastFrameTime(0),
+    m_SleepMargin( SDL_GetPerformanceFrequency() * INITIAL_MARGIN_MS / MS_IN_A_S ), m_MissedFrames(0)
+{
+  setTargetRate( s_DEFAULT_RATE );
+}
+
+
+/**
+ * @brief Sets the frames per second to pace to. Takes effect from the next frame.
+ **/
+void LFramePacer::setTargetRate( double FramesPerSecond )
+{
+  m_TargetRate = ( FramesPerSecond > 0.0 ) ? FramesPerSecond : s_DEFAULT_RATE;
+  m_Period     = static_cast<Uint64>( static_cast<double>( SDL_GetPerformanceFrequency() ) / m_TargetRate + 0.5 );
+}
+
+
+/**
+ * @brief Paces to the refresh rate of the display the window is on, to be called again when the
+ * window moves to another display.
+ *
+ * @return false, keeping the current rate, when the display does not report its refresh rate.
+ **/
+bool LFramePacer::matchDisplay( SDL_Window* Window_Ptr )
+{
+  SDL_DisplayMode Mode;
+  const int       Display = SDL_GetWindowDisplayIndex( Window_Ptr );
+
+  if ( Display < 0 || SDL_GetCurrentDisplayMode( Display, &Mode ) != 0 || Mode.refresh_rate <= 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  setTargetRate( Mode.refresh_rate );
+
+  return true;
+}
+
+
+/**
+ * @brief Starts the first frame now.
+ **/
+void LFramePacer::start( void )
+{
+  m_LastFrameEnd  = SDL_GetPerformanceCounter();
+  m_Deadline      = m_LastFrameEnd + m_Period;
+  m_LastFrameTime = 0;
+  m_MissedFrames  = 0;
+}
+
+
+/**
+ * @brief Ends the current frame: returns at its deadline, or at once if the deadline has passed.
+ **/
+void LFramePacer::wait( void )
+{
+  Uint64 Now = SDL_GetPerformanceCounter();
+
+  if ( Now >= m_Deadline )
+  {
+    // Late: every deadline passed is a frame missed. The next frame gets a whole period
+    m_MissedFrames += ( Now - m_Deadline ) / m_Period + 1;
+    m_Deadline      = Now + m_Period;
+  }
+  else
+  {
+    if ( m_Deadline - Now > m_SleepMargin )
+    {
+      Sleep_Pvt( m_Deadline - Now - m_SleepMargin );
+    }
+    else
+    {;}
+
+    // Spin for the rest of the frame
+    do
+    {
+      Now = SDL_GetPerformanceCounter();
+    }
+    while ( Now < m_Deadline );
+
+    m_Deadline += m_Period;
+  }
+
+  m_LastFrameTime = Now - m_LastFrameEnd;
+  m_LastFrameEnd  = Now;
+}
+
+
+double LFramePacer::GetTargetRate( void ) const
+{
+  return m_TargetRate;
+}
+
+
+/**
+ * @return Duration of the last frame, waiting included, in seconds.
+ **/
+double LFramePacer::GetFrameTime( void ) const
+{
+  return static_cast<double>( m_LastFrameTime ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+}
+
+
+Uint64 LFramePacer::GetMissedFrames( void ) const
+{
+  return m_MissedFrames;
+}
+
+
+/**
+ * @brief Sleeps for about Counts performance counter counts, in whole milliseconds rounded down, and
+ * updates the margin from how much later than asked the sleep ended. The margin jumps up to a larger
+ * oversleep and slowly decays after a smaller one.
+ **/
+void LFramePacer::Sleep_Pvt( Uint64 Counts )
+{
+  const Uint64 Frequency = SDL_GetPerformanceFrequency();
+  const Uint64 Delay_ms  = Counts * MS_IN_A_S / Frequency;
+
+  if ( Delay_ms == 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint64 Before = SDL_GetPerformanceCounter();
+  SDL_Delay( static_cast<Uint32>( Delay_ms ) );
+  const Uint64 Slept  = SDL_GetPerformanceCounter() - Before;
+
+  const Uint64 Asked     = Delay_ms * Frequency / MS_IN_A_S;
+  const Uint64 Oversleep = ( Slept > Asked ) ? Slept - Asked : 0;
+  const Uint64 Minimum   = Frequency * MINIMUM_MARGIN_MS / MS_IN_A_S;
+
+  m_SleepMargin = std::max( { Oversleep, m_SleepMargin - m_SleepMargin / 16, Minimum } );
+}
@@ -0,0 +1,51 @@
+/**
+ * @file LFramePacer.hpp
+ *
+ * @brief Frame rate cap with even frame times, for the examples that run without VSync.
+ **/
+
+#ifndef LFRAMEPACER_HPP
+#define LFRAMEPACER_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief Ends every frame on a fixed grid of deadlines, one frame period apart. The wait sleeps with
+ * SDL_Delay while more than a safety margin is left, then spins on the performance counter up to the
+ * deadline: the oversleep of the scheduler is absorbed by the margin, and the spin lasts only the
+ * margin. The margin follows the oversleep measured on each sleep.
+ *
+ * A frame that ends after its deadline is counted as missed, and the grid starts again from it
+ * instead of rushing the next frames to catch up.
+ **/
+class LFramePacer
+{
+public:
+
+  LFramePacer( void );
+
+  void   setTargetRate   ( double );
+  bool   matchDisplay    ( SDL_Window* );
+  void   start           ( void );
+  void   wait            ( void );
+
+  double GetTargetRate   ( void ) const;
+  double GetFrameTime    ( void ) const;
+  Uint64 GetMissedFrames ( void ) const;
+
+private:
+
+  static constexpr double s_DEFAULT_RATE = 60.0;
+
+  void Sleep_Pvt( Uint64 );
+
+  double m_TargetRate;    // Frames per second
+  Uint64 m_Period;        // Performance counter counts per frame
+  Uint64 m_Deadline;      // End of the current frame
+  Uint64 m_LastFrameEnd;
+  Uint64 m_LastFrameTime;
+  Uint64 m_SleepMargin;   // Counts left to the spin, at least the recent oversleep
+  Uint64 m_MissedFrames;
+};
+
+#endif // LFRAMEPACER_HPP
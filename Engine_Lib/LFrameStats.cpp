@@ -0,0 +1,211 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LFrameStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr double MS_IN_A_S = 1000.0;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param WindowSize Number of frames the statistics are computed over.
+ * @param ReportInterval Seconds of frame time between two reports.
+ **/
+LFrameStats::LFrameStats( size_t WindowSize, double ReportInterval )
+  : m_Times( std::max( WindowSize, static_cast<size_t>(1) ), 0.0 ), m_Next(0), m_Count(0), m_Sum(0.0),
+    m_ReportInterval(ReportInterval), m_SinceReport(0.0)
+{
+  m_Sorted.reserve( m_Times.size() );
+}
+
+
+/**
+ * @brief Adds the time of a frame, in seconds, replacing the oldest one once the window is full.
+ **/
+void LFrameStats::addFrame( double Seconds )
+{
+  if ( m_Count == m_Times.size() )
+  {
+    m_Sum -= m_Times[m_Next];
+  }
+  else
+  {
+    ++m_Count;
+  }
+
+  m_Times[m_Next] = Seconds;
+  m_Sum          += Seconds;
+  m_SinceReport  += Seconds;
+  m_Next          = ( m_Next + 1 ) % m_Times.size();
+
+  // Sum again from time to time, so that rounding errors of the running sum do not add up
+  if ( m_Next == 0 )
+  {
+    m_Sum = 0.0;
+
+    for ( const double Time : m_Times )
+    {
+      m_Sum += Time;
+    }
+  }
+  else
+  {;}
+}
+
+
+void LFrameStats::clear( void )
+{
+  std::fill( m_Times.begin(), m_Times.end(), 0.0 );
+  m_Next        = 0;
+  m_Count       = 0;
+  m_Sum         = 0.0;
+  m_SinceReport = 0.0;
+}
+
+
+/**
+ * @return true once per report interval, when the frames added since the last report add up to it.
+ **/
+bool LFrameStats::isReportDue( void )
+{
+  if ( m_SinceReport < m_ReportInterval )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_SinceReport = ( m_ReportInterval > 0.0 ) ? std::fmod( m_SinceReport, m_ReportInterval ) : 0.0;
+
+  return true;
+}
+
+
+size_t LFrameStats::GetCount( void ) const
+{
+  return m_Count;
+}
+
+
+double LFrameStats::GetMin( void ) const
+{
+  return ( m_Count != 0 ) ? *std::min_element( m_Times.begin(), m_Times.begin() + static_cast<std::ptrdiff_t>( m_Count ) ) : 0.0;
+}
+
+
+double LFrameStats::GetAverage( void ) const
+{
+  return ( m_Count != 0 ) ? m_Sum / static_cast<double>( m_Count ) : 0.0;
+}
+
+
+double LFrameStats::GetMax( void ) const
+{
+  return ( m_Count != 0 ) ? *std::max_element( m_Times.begin(), m_Times.begin() + static_cast<std::ptrdiff_t>( m_Count ) ) : 0.0;
+}
+
+
+/**
+ * @brief Frame time that the given fraction of the frames does not exceed, nearest rank: 0.99 for
+ * the 99th percentile.
+ **/
+double LFrameStats::GetPercentile( double Fraction ) const
+{
+  if ( m_Count == 0 )
+  {
+    return 0.0;
+  }
+  else
+  {;}
+
+  const double Clamped = std::min( std::max( Fraction, 0.0 ), 1.0 );
+  const size_t Rank    = static_cast<size_t>( std::ceil( Clamped * static_cast<double>( m_Count ) ) );
+  const size_t Index   = ( Rank > 0 ) ? Rank - 1 : 0;
+
+  m_Sorted.assign( m_Times.begin(), m_Times.begin() + static_cast<std::ptrdiff_t>( m_Count ) );
+  std::nth_element( m_Sorted.begin(), m_Sorted.begin() + static_cast<std::ptrdiff_t>( Index ), m_Sorted.end() );
+
+  return m_Sorted[Index];
+}
+
+
+/**
+ * @return Frames per second over the window: the frames divided by the time they took.
+ **/
+double LFrameStats::GetAverageFPS( void ) const
+{
+  return ( m_Sum > 0.0 ) ? static_cast<double>( m_Count ) / m_Sum : 0.0;
+}
+
+
+/**
+ * @brief Counts the frames of the window by time, in bins BinWidth seconds wide starting from 0. The
+ * last bin is the slowest frame's, so Counts has as many bins as needed.
+ **/
+void LFrameStats::GetHistogram( std::vector<Uint32>& Counts, double BinWidth ) const
+{
+  Counts.clear();
+
+  if ( m_Count == 0 || BinWidth <= 0.0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Counts.resize( static_cast<size_t>( GetMax() / BinWidth ) + 1, 0 );
+
+  for ( size_t i = 0; i != m_Count; ++i )
+  {
+    ++Counts[ static_cast<size_t>( m_Times[i] / BinWidth ) ];
+  }
+}
+
+
+/**
+ * @brief Writes the histogram as CSV: the lower edge of each bin in milliseconds and its count.
+ *
+ * @return false if the file could not be written.
+ **/
+bool LFrameStats::saveHistogram( const std::string& Path, double BinWidth ) const
+{
+  std::vector<Uint32> Counts;
+  GetHistogram( Counts, BinWidth );
+
+  SDL_RWops* File_Ptr = SDL_RWFromFile( Path.c_str(), "w" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to save %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  char Line[64];
+  int  Length  = snprintf( Line, sizeof( Line ), "frame_time_ms,frames\n" );
+  bool Success = ( SDL_RWwrite( File_Ptr, Line, static_cast<size_t>( Length ), 1 ) == 1 );
+
+  for ( size_t Bin = 0; Success && Bin != Counts.size(); ++Bin )
+  {
+    Length  = snprintf( Line, sizeof( Line ), "%.3f,%u\n", static_cast<double>( Bin ) * BinWidth * MS_IN_A_S, static_cast<unsigned>( Counts[Bin] ) );
+    Success = ( SDL_RWwrite( File_Ptr, Line, static_cast<size_t>( Length ), 1 ) == 1 );
+  }
+
+  SDL_RWclose( File_Ptr );
+
+  return Success;
+}
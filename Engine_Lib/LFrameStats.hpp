@@ -0,0 +1,57 @@
+/**
+ * @file LFrameStats.hpp
+ *
+ * @brief Frame time statistics over the last frames, for frame rate counters and stutter hunting.
+ **/
+
+#ifndef LFRAMESTATS_HPP
+#define LFRAMESTATS_HPP
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Keeps the times of the last frames in a ring buffer and reports their minimum, average,
+ * maximum and 99th percentile, and a histogram. Unlike an average over the whole run, a stutter
+ * shows up in the maximum and the percentile for as long as it is in the window, and the spike of
+ * the first frames leaves it.
+ *
+ * The statistics are computed when asked for, not on every frame: a HUD asks for them when
+ * "isReportDue" says that the report interval, counted in frame time, has elapsed.
+ **/
+class LFrameStats
+{
+public:
+
+  static constexpr size_t s_DEFAULT_WINDOW = 240;   // Frames
+  static constexpr double s_DEFAULT_REPORT = 0.25;  // Seconds between two reports
+
+  explicit LFrameStats( size_t = s_DEFAULT_WINDOW, double = s_DEFAULT_REPORT );
+
+  void   addFrame       ( double );
+  void   clear          ( void );
+  bool   isReportDue    ( void );
+
+  size_t GetCount       ( void ) const;
+  double GetMin         ( void ) const;
+  double GetAverage     ( void ) const;
+  double GetMax         ( void ) const;
+  double GetPercentile  ( double ) const;
+  double GetAverageFPS  ( void ) const;
+
+  void   GetHistogram   ( std::vector<Uint32>&, double ) const;
+  bool   saveHistogram  ( const std::string&, double ) const;
+
+private:
+
+  std::vector<double>         m_Times;        // Seconds, ring buffer of the last frames
+  size_t                      m_Next;         // Slot of the next frame
+  size_t                      m_Count;        // Frames in the window, up to its size
+  double                      m_Sum;
+  double                      m_ReportInterval;
+  double                      m_SinceReport;  // Frame time added since the last report
+  mutable std::vector<double> m_Sorted;       // Scratch space of GetPercentile
+};
+
+#endif // LFRAMESTATS_HPP
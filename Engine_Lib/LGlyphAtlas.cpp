@@ -0,0 +1,578 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32    ATLAS_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+static constexpr SDL_Color GLYPH_COLOUR = { 0xFF, 0xFF, 0xFF, 0xFF }; // Tinted when drawn
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param Size Width and height of each page.
+ * @param MaxPages Pages created at most, at least 1.
+ **/
+LGlyphAtlas::LGlyphAtlas( int Size, int MaxPages )
+  : m_Font_Ptr(nullptr), m_Renderer_Ptr(nullptr), m_Pages(), m_Size(Size), m_MaxPages(std::max( MaxPages, 1 )), m_LineHeight(0),
+    m_Frame(0), m_Count(0), m_Evictions(0), m_IsFull(false), m_HasKerning(false), m_Direct(), m_Others()
+{;}
+
+
+LGlyphAtlas::~LGlyphAtlas( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Creates the first, empty, page for a font. Nothing is rasterised yet.
+ *
+ * @param Font_Ptr The font; it must stay open until "free".
+ * @param Renderer_Ptr The renderer the text will be drawn with.
+ * @return true if the texture was created.
+ **/
+bool LGlyphAtlas::create( TTF_Font* Font_Ptr, SDL_Renderer* Renderer_Ptr )
+{
+  free();
+
+  m_Renderer_Ptr = Renderer_Ptr;
+
+  if ( !AddPage_Pvt() )
+  {
+    m_Renderer_Ptr = nullptr;
+    return false;
+  }
+  else
+  {;}
+
+  m_Font_Ptr   = Font_Ptr;
+  m_LineHeight = TTF_FontHeight( Font_Ptr );
+  m_HasKerning = TTF_GetFontKerning( Font_Ptr ) != 0;
+
+  return true;
+}
+
+
+/**
+ * @brief Destroys the pages and forgets every glyph.
+ **/
+void LGlyphAtlas::free( void )
+{
+  for ( Page& Each : m_Pages )
+  {
+    SDL_DestroyTexture( Each.Texture_Ptr );
+  }
+
+  m_Pages.clear();
+
+  m_Font_Ptr     = nullptr;
+  m_Renderer_Ptr = nullptr;
+  m_LineHeight   = 0;
+  m_Count        = 0;
+  m_IsFull       = false;
+
+  for ( Entry& Each : m_Direct )
+  {
+    Each = Entry();
+  }
+
+  m_Others.clear();
+}
+
+
+/**
+ * @brief Starts a frame: the pages not used since the last call can be evicted.
+ **/
+void LGlyphAtlas::nextFrame( void )
+{
+  ++m_Frame;
+}
+
+
+/**
+ * @brief A glyph, rasterised and uploaded the first time it is asked for, and again after being
+ * evicted. Its page is marked as used in this frame.
+ *
+ * @param Codepoint Unicode code point.
+ * @return The glyph, at the same address until "free"; nullptr if the atlas was not created.
+ **/
+const LGlyphAtlas::Glyph* LGlyphAtlas::getGlyph( Uint32 Codepoint )
+{
+  if ( m_Pages.empty() )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  Entry& Found = Find_Pvt( Codepoint );
+
+  // No room found in this frame: try again in the next
+  if ( !Found.IsReady && Found.Tried != m_Frame + 1 )
+  {
+    Rasterise_Pvt( Codepoint, Found );
+  }
+  else
+  {;}
+
+  if ( Found.Public.Page >= 0 )
+  {
+    m_Pages[static_cast<size_t>( Found.Public.Page )].LastUse = m_Frame;
+  }
+  else
+  {;}
+
+  return &Found.Public;
+}
+
+
+/**
+ * @return Pen adjustment between two consecutive glyphs; 0 if the font has no kerning.
+ **/
+int LGlyphAtlas::getKerning( Uint32 Previous, Uint32 Codepoint ) const
+{
+  return m_HasKerning ? TTF_GetFontKerningSizeGlyphs32( m_Font_Ptr, Previous, Codepoint ) : 0;
+}
+
+
+/**
+ * @return The texture of a page; nullptr if there is no such page.
+ **/
+SDL_Texture* LGlyphAtlas::GetTexture( int PageIndex ) const
+{
+  return ( PageIndex >= 0 && PageIndex < GetPageCount() ) ? m_Pages[static_cast<size_t>( PageIndex )].Texture_Ptr : nullptr;
+}
+
+
+SDL_Renderer* LGlyphAtlas::GetRenderer( void ) const
+{
+  return m_Renderer_Ptr;
+}
+
+
+/**
+ * @return Width and height of each page.
+ **/
+int LGlyphAtlas::GetSize( void ) const
+{
+  return m_Size;
+}
+
+
+int LGlyphAtlas::GetPageCount( void ) const
+{
+  return static_cast<int>( m_Pages.size() );
+}
+
+
+int LGlyphAtlas::GetLineHeight( void ) const
+{
+  return m_LineHeight;
+}
+
+
+/**
+ * @return Glyphs in the pages.
+ **/
+size_t LGlyphAtlas::GetCount( void ) const
+{
+  return m_Count;
+}
+
+
+/**
+ * @return Pages emptied to make room since the atlas was constructed.
+ **/
+size_t LGlyphAtlas::GetEvictions( void ) const
+{
+  return m_Evictions;
+}
+
+
+LGlyphAtlas::Entry& LGlyphAtlas::Find_Pvt( Uint32 Codepoint )
+{
+  return ( Codepoint < s_NUM_OF_DIRECT ) ? m_Direct[Codepoint] : m_Others[Codepoint];
+}
+
+
+/**
+ * @brief Renders a glyph and copies it into a page, making room if needed.
+ **/
+void LGlyphAtlas::Rasterise_Pvt( Uint32 Codepoint, Entry& Target )
+{
+  Glyph& Result = Target.Public;
+  int    MinX, MaxX, MinY, MaxY;
+
+  Result         = Glyph{ SDL_Rect{ 0, 0, 0, 0 }, -1, 0 };
+  Target.IsReady = true;
+
+  if ( TTF_GlyphMetrics32( m_Font_Ptr, Codepoint, &MinX, &MaxX, &MinY, &MaxY, &Result.Advance ) != 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_Surface* Rendered_Ptr = TTF_RenderGlyph32_Blended( m_Font_Ptr, Codepoint, GLYPH_COLOUR );
+
+  if ( Rendered_Ptr == nullptr )
+  {
+    return; // E.g. the space: nothing to draw
+  }
+  else
+  {;}
+
+  SDL_Surface* Converted_Ptr = SDL_ConvertSurfaceFormat( Rendered_Ptr, ATLAS_FORMAT, 0 );
+  SDL_FreeSurface( Rendered_Ptr );
+
+  if ( Converted_Ptr == nullptr )
+  {
+    printf( "\nUnable to convert glyph %u! SDL Error: %s", static_cast<unsigned>( Codepoint ), SDL_GetError() );
+    return;
+  }
+  else
+  {;}
+
+  const int Width  = Converted_Ptr->w + s_PADDING_px;
+  const int Height = Converted_Ptr->h + s_PADDING_px;
+  int       PageIndex;
+  SDL_Rect  Clip;
+
+  if ( Width > m_Size || Height > m_Size )
+  {
+    printf( "\nGlyph %u is larger than a page of the atlas: it will not be drawn!", static_cast<unsigned>( Codepoint ) );
+    SDL_FreeSurface( Converted_Ptr );
+    return;
+  }
+  else
+  {;}
+
+  // A new page while allowed, then the one used least recently
+  const bool IsPlaced = Place_Pvt( Width, Height, PageIndex, Clip ) ||
+                        ( AddPage_Pvt() && Place_Pvt( Width, Height, PageIndex, Clip ) ) ||
+                        ( Evict_Pvt()   && Place_Pvt( Width, Height, PageIndex, Clip ) );
+
+  if ( !IsPlaced )
+  {
+    if ( !m_IsFull )
+    {
+      printf( "\nGlyph atlas full: the glyphs that do not fit will be drawn from a later frame!" );
+      m_IsFull = true;
+    }
+    else
+    {;}
+
+    Target.IsReady = false;
+    Target.Tried   = m_Frame + 1;
+  }
+  else
+  {
+    Page& Chosen = m_Pages[static_cast<size_t>( PageIndex )];
+
+    Clip.w = Converted_Ptr->w;
+    Clip.h = Converted_Ptr->h;
+
+    if ( SDL_UpdateTexture( Chosen.Texture_Ptr, &Clip, Converted_Ptr->pixels, Converted_Ptr->pitch ) != 0 )
+    {
+      printf( "\nUnable to upload glyph %u! SDL Error: %s", static_cast<unsigned>( Codepoint ), SDL_GetError() );
+    }
+    else
+    {
+      Result.Clip = Clip;
+      Result.Page = PageIndex;
+      Chosen.Codepoints.push_back( Codepoint );
+      Chosen.LastUse = m_Frame;
+      ++m_Count;
+    }
+  }
+
+  SDL_FreeSurface( Converted_Ptr );
+}
+
+
+/**
+ * @brief Finds room for a padded glyph in the pages, the first with any, where its top ends lowest.
+ *
+ * @param PageIndex, Clip Set to where it goes; the clip includes the padding.
+ * @return false if no page has room.
+ **/
+bool LGlyphAtlas::Place_Pvt( int Width, int Height, int& PageIndex, SDL_Rect& Clip )
+{
+  for ( size_t p = 0; p != m_Pages.size(); ++p )
+  {
+    Page&  Each     = m_Pages[p];
+    size_t Best     = Each.Skyline.size();
+    int    BestTop  = m_Size + 1;
+    int    BestY    = 0;
+
+    for ( size_t i = 0; i != Each.Skyline.size(); ++i )
+    {
+      int Y;
+
+      if ( Fit_Pvt( Each, i, Width, Height, Y ) && Y + Height < BestTop )
+      {
+        Best    = i;
+        BestTop = Y + Height;
+        BestY   = Y;
+      }
+      else
+      {;}
+    }
+
+    if ( Best != Each.Skyline.size() )
+    {
+      Clip      = SDL_Rect{ Each.Skyline[Best].x, BestY, Width, Height };
+      PageIndex = static_cast<int>( p );
+
+      Reserve_Pvt( Each, Best, Clip );
+
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Whether a rectangle fits with its left edge at the start of a skyline segment.
+ *
+ * @param Y Set to the lowest it can go: the top of the highest segment under it.
+ **/
+bool LGlyphAtlas::Fit_Pvt( const Page& Packed, size_t Segment, int Width, int Height, int& Y ) const
+{
+  const int Left = Packed.Skyline[Segment].x;
+
+  if ( Left + Width > m_Size )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  int Covered = 0;
+
+  Y = 0;
+
+  for ( size_t i = Segment; Covered < Width; ++i )
+  {
+    const int End = ( i + 1 != Packed.Skyline.size() ) ? Packed.Skyline[i + 1].x : m_Size;
+
+    Y        = std::max( Y, Packed.Skyline[i].y );
+    Covered += End - Packed.Skyline[i].x;
+
+    if ( Y + Height > m_Size )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Raises the skyline over a rectangle placed at the start of a segment.
+ **/
+void LGlyphAtlas::Reserve_Pvt( Page& Packed, size_t Segment, const SDL_Rect& Placed )
+{
+  std::vector<SDL_Point>& Skyline = Packed.Skyline;
+  const int               Right   = Placed.x + Placed.w;
+
+  Skyline.insert( Skyline.begin() + static_cast<std::ptrdiff_t>( Segment ), SDL_Point{ Placed.x, Placed.y + Placed.h } );
+
+  // The segments under the rectangle shrink from the left, or go
+  for ( size_t i = Segment + 1; i < Skyline.size() && Skyline[i].x < Right; )
+  {
+    const int End = ( i + 1 != Skyline.size() ) ? Skyline[i + 1].x : m_Size;
+
+    if ( End <= Right )
+    {
+      Skyline.erase( Skyline.begin() + static_cast<std::ptrdiff_t>( i ) );
+    }
+    else
+    {
+      Skyline[i].x = Right;
+      break;
+    }
+  }
+
+  // Neighbours at the same height are one segment
+  for ( size_t i = 0; i + 1 < Skyline.size(); )
+  {
+    if ( Skyline[i].y == Skyline[i + 1].y )
+    {
+      Skyline.erase( Skyline.begin() + static_cast<std::ptrdiff_t>( i + 1 ) );
+    }
+    else
+    {
+      ++i;
+    }
+  }
+}
+
+
+/**
+ * @return false if the pages are at their maximum, or the texture could not be created.
+ **/
+bool LGlyphAtlas::AddPage_Pvt( void )
+{
+  if ( GetPageCount() == m_MaxPages )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Texture* Texture_Ptr = SDL_CreateTexture( m_Renderer_Ptr, ATLAS_FORMAT, SDL_TEXTUREACCESS_STATIC, m_Size, m_Size );
+
+  if ( Texture_Ptr == nullptr )
+  {
+    printf( "\nUnable to create glyph atlas texture! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_SetTextureBlendMode( Texture_Ptr, SDL_BLENDMODE_BLEND );
+
+  m_Pages.push_back( Page{ Texture_Ptr, {}, {}, m_Frame } );
+  Clear_Pvt( m_Pages.back() );
+
+  return true;
+}
+
+
+/**
+ * @brief Empties the page used least recently, if it was not used in this frame. Its glyphs are
+ * rasterised again when asked for.
+ *
+ * @return false if every page was used in this frame.
+ **/
+bool LGlyphAtlas::Evict_Pvt( void )
+{
+  Page* Oldest_Ptr = nullptr;
+
+  for ( Page& Each : m_Pages )
+  {
+    if ( Each.LastUse != m_Frame && ( Oldest_Ptr == nullptr || Each.LastUse < Oldest_Ptr->LastUse ) )
+    {
+      Oldest_Ptr = &Each;
+    }
+    else
+    {;}
+  }
+
+  if ( Oldest_Ptr == nullptr )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  for ( Uint32 Codepoint : Oldest_Ptr->Codepoints )
+  {
+    Find_Pvt( Codepoint ) = Entry();
+  }
+
+  m_Count -= Oldest_Ptr->Codepoints.size();
+  ++m_Evictions;
+
+  Clear_Pvt( *Oldest_Ptr );
+
+  return true;
+}
+
+
+/**
+ * @brief Makes a page transparent, so that the padding around the glyphs is, and empty.
+ **/
+void LGlyphAtlas::Clear_Pvt( Page& Cleared )
+{
+  const std::vector<Uint32> Clear( static_cast<size_t>( m_Size ) * static_cast<size_t>( m_Size ), 0 );
+
+  SDL_UpdateTexture( Cleared.Texture_Ptr, NULL, Clear.data(), m_Size * static_cast<int>( sizeof(Uint32) ) );
+
+  Cleared.Skyline.assign( 1, SDL_Point{ 0, 0 } );
+  Cleared.Codepoints.clear();
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Decodes the UTF-8 sequence at the start of Text_Ptr. A byte that does not start a valid
+ * sequence is taken as a Latin-1 character on its own, so that any text can be edited.
+ *
+ * @param Bytes Set to the length of the sequence.
+ **/
+Uint32 DecodeUtf8( const unsigned char* Text_Ptr, int& Bytes )
+{
+  const unsigned char Lead = Text_Ptr[0];
+  int                 Length;
+  Uint32              Codepoint;
+
+  if ( Lead < 0x80 )
+  {
+    Bytes = 1;
+    return Lead;
+  }
+  else if ( ( Lead & 0xE0 ) == 0xC0 )
+  {
+    Length    = 2;
+    Codepoint = Lead & 0x1F;
+  }
+  else if ( ( Lead & 0xF0 ) == 0xE0 )
+  {
+    Length    = 3;
+    Codepoint = Lead & 0x0F;
+  }
+  else if ( ( Lead & 0xF8 ) == 0xF0 )
+  {
+    Length    = 4;
+    Codepoint = Lead & 0x07;
+  }
+  else
+  {
+    Bytes = 1;
+    return Lead;
+  }
+
+  for ( int i = 1; i != Length; ++i )
+  {
+    if ( ( Text_Ptr[i] & 0xC0 ) != 0x80 )
+    {
+      Bytes = 1;
+      return Lead;
+    }
+    else
+    {;}
+
+    Codepoint = ( Codepoint << 6 ) | ( Text_Ptr[i] & 0x3F );
+  }
+
+  Bytes = Length;
+  return Codepoint;
+}
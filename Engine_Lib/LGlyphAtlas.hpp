@@ -0,0 +1,125 @@
+/**
+ * @file LGlyphAtlas.hpp
+ *
+ * @brief Glyphs of a TTF font rasterised on first use into a few texture pages.
+ **/
+
+#ifndef LGLYPHATLAS_HPP
+#define LGLYPHATLAS_HPP
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Texture pages holding the glyphs of one font, each rasterised by SDL_ttf the first time it
+ * is asked for and then reused: drawing text is a matter of textured quads, and a glyph costs a
+ * rasterisation and an upload once, however many strings contain it. Any Unicode code point can be
+ * asked for, so that a script with thousands of glyphs, CJK, only costs the ones on screen.
+ *
+ * Glyphs are rasterised in white, to be tinted through the vertex colour, and packed with a skyline:
+ * each glyph goes where its top ends lowest, which wastes less than rows do when the heights vary.
+ * A page is created when the others are full, up to the maximum given; then the page used least
+ * recently is emptied, and its glyphs are rasterised again when asked for. The texture memory is
+ * bounded by the number of pages.
+ *
+ * A glyph keeps its address until "free", even when evicted, so that a laid out text can hold it;
+ * what is drawn asks for it again, with "getGlyph", to bring it back and to mark it as in use. Call
+ * "nextFrame" once per frame: only the pages not used since the last call are evicted, so the
+ * glyphs of a frame stay where they were queued. Without it nothing is evicted, and once the pages
+ * are full new glyphs keep their advance but are not drawn.
+ *
+ * The font must stay open until "free".
+ **/
+class LGlyphAtlas
+{
+public:
+
+  static constexpr int s_DEFAULT_SIZE  = 1024;
+  static constexpr int s_DEFAULT_PAGES = 4;
+
+  struct Glyph
+  {
+    SDL_Rect Clip;    // Position in its page; empty if there is nothing to draw, or it was evicted
+    int      Page;    // -1 with an empty clip
+    int      Advance; // Horizontal pen movement
+  };
+
+  explicit LGlyphAtlas( int = s_DEFAULT_SIZE, int = s_DEFAULT_PAGES );
+  ~LGlyphAtlas( void );
+
+  LGlyphAtlas( const LGlyphAtlas& )            = delete;
+  LGlyphAtlas& operator=( const LGlyphAtlas& ) = delete;
+
+  bool          create       ( TTF_Font*, SDL_Renderer* );
+  void          free         ( void );
+  void          nextFrame    ( void );
+  const Glyph*  getGlyph     ( Uint32 );
+  int           getKerning   ( Uint32, Uint32 ) const;
+
+  SDL_Texture*  GetTexture   ( int = 0 ) const;
+  SDL_Renderer* GetRenderer  ( void ) const;
+  int           GetSize      ( void ) const;
+  int           GetPageCount ( void ) const;
+  int           GetLineHeight( void ) const;
+  size_t        GetCount     ( void ) const;
+  size_t        GetEvictions ( void ) const;
+
+private:
+
+  static constexpr Uint32 s_NUM_OF_DIRECT = 128; // ASCII glyphs live in an array
+  static constexpr int    s_PADDING_px    = 1;   // Between glyphs, against filtering bleed
+
+  struct Entry
+  {
+    Glyph  Public  = { SDL_Rect{ 0, 0, 0, 0 }, -1, 0 };
+    bool   IsReady = false; // Rasterised, and in a page if there is something to draw
+    Uint32 Tried   = 0;     // Frame of the last attempt that found no room, plus one
+  };
+
+  /**
+   * @brief A texture, and the top of what is packed in it: segment i spans from Skyline[i].x to the
+   * next segment, or to the right edge, at height Skyline[i].y.
+   **/
+  struct Page
+  {
+    SDL_Texture*           Texture_Ptr;
+    std::vector<SDL_Point> Skyline;
+    std::vector<Uint32>    Codepoints;  // Of the glyphs packed in it
+    Uint32                 LastUse;     // Frame
+  };
+
+  Entry& Find_Pvt      ( Uint32 );
+  void   Rasterise_Pvt ( Uint32, Entry& );
+  bool   Place_Pvt     ( int, int, int&, SDL_Rect& );
+  bool   Fit_Pvt       ( const Page&, size_t, int, int, int& ) const;
+  void   Reserve_Pvt   ( Page&, size_t, const SDL_Rect& );
+  bool   AddPage_Pvt   ( void );
+  bool   Evict_Pvt     ( void );
+  void   Clear_Pvt     ( Page& );
+
+  TTF_Font*                         m_Font_Ptr;
+  SDL_Renderer*                     m_Renderer_Ptr;
+  std::vector<Page>                 m_Pages;
+  int                               m_Size;
+  int                               m_MaxPages;
+  int                               m_LineHeight;
+  Uint32                            m_Frame;
+  size_t                            m_Count;       // Glyphs in the pages
+  size_t                            m_Evictions;   // Pages emptied
+  bool                              m_IsFull;      // Reported
+  bool                              m_HasKerning;
+  Entry                             m_Direct[s_NUM_OF_DIRECT];
+  std::unordered_map<Uint32, Entry> m_Others;
+};
+
+
+/*
+ * Code point of the UTF-8 sequence at the start of the text, and its length in bytes. A byte that
+ * does not start a valid sequence is taken as a Latin-1 character on its own.
+ */
+Uint32 DecodeUtf8( const unsigned char*, int& );
+
+#endif // LGLYPHATLAS_HPP
@@ -0,0 +1,233 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGlyphMetrics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr int BYTES_PER_PIXEL = 4;
+static constexpr int NOT_FOUND       = -1;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static int FirstInked( const std::vector<Uint8>& Ink )
+{
+  for ( size_t i = 0; i != Ink.size(); ++i )
+  {
+    if ( Ink[i] != 0 )
+    {
+      return static_cast<int>( i );
+    }
+    else
+    {;}
+  }
+
+  return NOT_FOUND;
+}
+
+
+static int LastInked( const std::vector<Uint8>& Ink )
+{
+  for ( size_t i = Ink.size(); i != 0; --i )
+  {
+    if ( Ink[i - 1] != 0 )
+    {
+      return static_cast<int>( i - 1 );
+    }
+    else
+    {;}
+  }
+
+  return NOT_FOUND;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Measures the glyphs of a bitmap font sheet. Each cell is read once, row by row, marking
+ * the rows and columns that have ink; the edges of the glyph are the first and last of them.
+ *
+ * @param Pixels_Ptr The sheet, 32 bits per pixel in any format.
+ * @param Pitch Bytes per row.
+ * @param Width Pixels per row, at least LGLYPH_GRID.
+ * @param Height Rows, at least LGLYPH_GRID.
+ * @param Metrics Filled in on success. An empty cell gets the whole cell.
+ **/
+bool ComputeGlyphMetrics( const Uint32* Pixels_Ptr, int Pitch, int Width, int Height, LGlyphMetrics& Metrics )
+{
+  if ( Pixels_Ptr == nullptr || Width < LGLYPH_GRID || Height < LGLYPH_GRID || Pitch < Width * BYTES_PER_PIXEL )
+  {
+    printf( "\nUnable to measure the glyphs of a %dx%d sheet!", Width, Height );
+    return false;
+  }
+  else
+  {;}
+
+  const int    CellW      = Width  / LGLYPH_GRID;
+  const int    CellH      = Height / LGLYPH_GRID;
+  const size_t RowPixels  = static_cast<size_t>( Pitch / BYTES_PER_PIXEL );
+  const Uint32 Background = Pixels_Ptr[0];
+
+  std::vector<Uint8> RowInk( static_cast<size_t>( CellH ) );
+  std::vector<Uint8> ColumnInk( static_cast<size_t>( CellW ) );
+
+  int Top     = CellH; // The highest ink of any glyph
+  int BottomA = CellH; // The lowest ink of 'A', i.e. the baseline
+
+  for ( int Glyph = 0; Glyph != LGLYPH_COUNT; ++Glyph )
+  {
+    const int CellX = CellW * ( Glyph % LGLYPH_GRID );
+    const int CellY = CellH * ( Glyph / LGLYPH_GRID );
+
+    std::fill( RowInk.begin(), RowInk.end(), static_cast<Uint8>( 0 ) );
+    std::fill( ColumnInk.begin(), ColumnInk.end(), static_cast<Uint8>( 0 ) );
+
+    for ( int y = 0; y != CellH; ++y )
+    {
+      const Uint32* Row_Ptr = Pixels_Ptr + static_cast<size_t>( CellY + y ) * RowPixels + static_cast<size_t>( CellX );
+      Uint8         Inked   = 0;
+
+      for ( int x = 0; x != CellW; ++x )
+      {
+        const Uint8 IsInk = ( Row_Ptr[x] != Background ) ? 1 : 0;
+
+        ColumnInk[static_cast<size_t>( x )] |= IsInk;
+        Inked                               |= IsInk;
+      }
+
+      RowInk[static_cast<size_t>( y )] = Inked;
+    }
+
+    const int Left  = FirstInked( ColumnInk );
+    const int Right = LastInked( ColumnInk );
+    SDL_Rect& Clip  = Metrics.Glyphs[Glyph];
+
+    Clip.x = CellX + ( ( Left != NOT_FOUND ) ? Left : 0 );
+    Clip.y = CellY;
+    Clip.w = ( Left != NOT_FOUND ) ? Right - Left + 1 : CellW;
+    Clip.h = CellH;
+
+    const int GlyphTop = FirstInked( RowInk );
+
+    if ( GlyphTop != NOT_FOUND && GlyphTop < Top )
+    {
+      Top = GlyphTop;
+    }
+    else
+    {;}
+
+    if ( Glyph == 'A' && GlyphTop != NOT_FOUND )
+    {
+      BottomA = LastInked( RowInk );
+    }
+    else
+    {;}
+  }
+
+  Metrics.Space   = CellW / 2;
+  Metrics.NewLine = BottomA - Top;
+
+  // The rows above the highest glyph are empty in every cell
+  for ( SDL_Rect& Clip : Metrics.Glyphs )
+  {
+    Clip.y += Top;
+    Clip.h -= Top;
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the metrics to a ".glyphs" file, usually "<sheet>" + LBAKED_GLYPHS_EXTENSION.
+ **/
+bool SaveGlyphMetrics( const std::string& Path, const LGlyphMetrics& Metrics )
+{
+  LBakedGlyphsHeader Header;
+  memcpy( Header.Magic, LBAKED_GLYPHS_MAGIC, sizeof(Header.Magic) );
+  Header.Version = LBAKED_GLYPHS_VERSION;
+  Header.Count   = LGLYPH_COUNT;
+  Header.Space   = Metrics.Space;
+  Header.NewLine = Metrics.NewLine;
+
+  SDL_RWops* Output = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  bool Success = ( Output != NULL )
+                 && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1
+                 && SDL_RWwrite( Output, Metrics.Glyphs, sizeof(Metrics.Glyphs), 1 ) == 1;
+
+  if ( Output != NULL )
+  {
+    Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+  }
+  else
+  {;}
+
+  if ( !Success )
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+
+  return Success;
+}
+
+
+/**
+ * @brief Reads the metrics of a ".glyphs" file: one read of a few KiB, instead of measuring the
+ * sheet.
+ *
+ * @return false, leaving Metrics untouched, if the file is missing or was not written by
+ * SaveGlyphMetrics on a machine of the same byte order.
+ **/
+bool LoadGlyphMetrics( const std::string& Path, LGlyphMetrics& Metrics )
+{
+  SDL_RWops* Input = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( Input == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  LBakedGlyphsHeader Header;
+  SDL_Rect           Glyphs[LGLYPH_COUNT];
+
+  bool Success = SDL_RWread( Input, &Header, sizeof(Header), 1 ) == 1
+                 && memcmp( Header.Magic, LBAKED_GLYPHS_MAGIC, sizeof(Header.Magic) ) == 0
+                 && Header.Version == LBAKED_GLYPHS_VERSION
+                 && Header.Count == LGLYPH_COUNT
+                 && SDL_RWread( Input, Glyphs, sizeof(Glyphs), 1 ) == 1;
+
+  SDL_RWclose( Input );
+
+  if ( Success )
+  {
+    memcpy( Metrics.Glyphs, Glyphs, sizeof(Glyphs) );
+    Metrics.Space   = Header.Space;
+    Metrics.NewLine = Header.NewLine;
+  }
+  else
+  {
+    printf( "\n\"%s\" is not a glyph metrics file of this version!", Path.c_str() );
+  }
+
+  return Success;
+}
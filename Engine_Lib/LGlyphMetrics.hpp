@@ -0,0 +1,58 @@
+/**
+ * @file LGlyphMetrics.hpp
+ *
+ * @brief Clip rectangles and spacing of the glyphs of a bitmap font, measured once from its pixels
+ * and stored in a ".glyphs" file, written offline by the BakeTextures tool.
+ **/
+
+#ifndef LGLYPHMETRICS_HPP
+#define LGLYPHMETRICS_HPP
+
+#include <SDL.h>
+#include <string>
+
+static constexpr int LGLYPH_GRID  = 16;                         // Glyphs per row and per column of the sheet
+static constexpr int LGLYPH_COUNT = LGLYPH_GRID * LGLYPH_GRID;  // One per byte value, in order
+
+/**
+ * @brief Where each glyph is in the sheet, trimmed to its ink; the rows above the highest glyph are
+ * trimmed from every one of them, so that all share the same top.
+ **/
+struct LGlyphMetrics
+{
+  SDL_Rect Glyphs[LGLYPH_COUNT];
+  int      Space;   // Advance of ' '
+  int      NewLine; // Advance of '\n': from the top to the bottom of 'A'
+};
+
+/**
+ * @brief A ".glyphs" file is this header followed by Count rectangles, of four Sint32 each (x, y,
+ * w, h). Fields are stored in the byte order of the machine that baked the file, as in the ".ltx"
+ * files.
+ **/
+struct LBakedGlyphsHeader
+{
+  char   Magic[4]; // LBAKED_GLYPHS_MAGIC
+  Uint32 Version;  // LBAKED_GLYPHS_VERSION
+  Sint32 Count;    // LGLYPH_COUNT
+  Sint32 Space;
+  Sint32 NewLine;
+};
+
+static constexpr char   LBAKED_GLYPHS_MAGIC[4]    = { 'L', 'G', 'L', 'Y' };
+static constexpr Uint32 LBAKED_GLYPHS_VERSION     = 1;
+static constexpr char   LBAKED_GLYPHS_EXTENSION[] = ".glyphs";
+
+static_assert( sizeof(LBakedGlyphsHeader) == 20, "The baked header must have no padding" );
+static_assert( sizeof(SDL_Rect) == 4 * sizeof(Sint32), "Rectangles are stored as they are" );
+
+/*
+ * The sheet is a grid of LGLYPH_GRID x LGLYPH_GRID cells on a plain background, the colour of its
+ * top-left pixel. Measuring reads every pixel once: pass the 32-bit pixels of a locked texture or
+ * surface, with their pitch in bytes. Loading reads the numbers back, without touching the pixels.
+ */
+bool ComputeGlyphMetrics( const Uint32*, int, int, int, LGlyphMetrics& );
+bool SaveGlyphMetrics   ( const std::string&, const LGlyphMetrics& );
+bool LoadGlyphMetrics   ( const std::string&, LGlyphMetrics& );
+
+#endif // LGLYPHMETRICS_HPP
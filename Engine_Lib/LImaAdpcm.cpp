@@ -0,0 +1,197 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LImaAdpcm.hpp"
+
+#include <algorithm>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// Quantiser steps, and how each code moves along them
+static constexpr Sint16 IMA_STEPS[89] =
+{
+      7,     8,     9,    10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+     31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+   2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+   9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static constexpr int IMA_INDEX_MOVES[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+static constexpr int IMA_MAX_INDEX       = 88;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Decodes one code, updating the predictor and the step index of its channel.
+ **/
+static Sint16 DecodeImaNibble( Uint8 Code, int& Predictor, int& Index )
+{
+  const int Step = IMA_STEPS[Index];
+  int       Diff = Step >> 3;
+
+  Diff += ( Code & 4 ) ? Step      : 0;
+  Diff += ( Code & 2 ) ? Step >> 1 : 0;
+  Diff += ( Code & 1 ) ? Step >> 2 : 0;
+
+  Predictor = std::min( std::max( ( Code & 8 ) ? Predictor - Diff : Predictor + Diff, -32768 ), 32767 );
+  Index     = std::min( std::max( Index + IMA_INDEX_MOVES[Code], 0 ), IMA_MAX_INDEX );
+
+  return static_cast<Sint16>( Predictor );
+}
+
+
+/**
+ * @brief Encodes one sample: the code whose decoding comes closest, and the state the decoder will
+ * be in after it.
+ **/
+static Uint8 EncodeImaNibble( int Sample, int& Predictor, int& Index )
+{
+  const int Step  = IMA_STEPS[Index];
+  int       Left  = Sample - Predictor;
+  Uint8     Code  = 0;
+
+  if ( Left < 0 )
+  {
+    Code = 8;
+    Left = -Left;
+  }
+  else
+  {;}
+
+  if ( Left >= Step )
+  {
+    Code |= 4;
+    Left -= Step;
+  }
+  else
+  {;}
+
+  if ( Left >= Step >> 1 )
+  {
+    Code |= 2;
+    Left -= Step >> 1;
+  }
+  else
+  {;}
+
+  if ( Left >= Step >> 2 )
+  {
+    Code |= 1;
+  }
+  else
+  {;}
+
+  // The decoder's arithmetic, so that both drift alike
+  DecodeImaNibble( Code, Predictor, Index );
+
+  return Code;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+size_t ImaBlockFrames( size_t Bytes, int Channels )
+{
+  const size_t Header = 4 * static_cast<size_t>( Channels );
+
+  return ( Channels > 0 && Bytes >= Header ) ? 1 + 8 * ( ( Bytes - Header ) / Header ) : 0;
+}
+
+
+size_t EncodeImaBlock( const Sint16* In_Ptr, size_t Frames, int Channels, int* Index_Ptr, Uint8* Block_Ptr )
+{
+  const size_t Stride = static_cast<size_t>( Channels );
+  const size_t Groups = ( Frames - 1 ) / 8;
+  int          Predictor[IMA_MAX_CHANNELS];
+
+  for ( int c = 0; c != Channels; ++c )
+  {
+    Uint8* Head_Ptr = Block_Ptr + 4 * c;
+
+    // The first sample goes as it is
+    Predictor[c] = In_Ptr[c];
+    Head_Ptr[0]  = static_cast<Uint8>( Predictor[c] & 0xFF );
+    Head_Ptr[1]  = static_cast<Uint8>( ( Predictor[c] >> 8 ) & 0xFF );
+    Head_Ptr[2]  = static_cast<Uint8>( Index_Ptr[c] );
+    Head_Ptr[3]  = 0;
+  }
+
+  Uint8* Data_Ptr = Block_Ptr + 4 * Stride;
+
+  for ( size_t g = 0; g != Groups; ++g )
+  {
+    for ( int c = 0; c != Channels; ++c )
+    {
+      const Sint16* Frame_Ptr = In_Ptr + ( 1 + 8 * g ) * Stride + static_cast<size_t>( c );
+
+      for ( size_t b = 0; b != 4; ++b )
+      {
+        // Low nibble first
+        const Uint8 Low  = EncodeImaNibble( Frame_Ptr[( 2 * b     ) * Stride], Predictor[c], Index_Ptr[c] );
+        const Uint8 High = EncodeImaNibble( Frame_Ptr[( 2 * b + 1 ) * Stride], Predictor[c], Index_Ptr[c] );
+
+        *Data_Ptr++ = static_cast<Uint8>( Low | ( High << 4 ) );
+      }
+    }
+  }
+
+  return static_cast<size_t>( Data_Ptr - Block_Ptr );
+}
+
+
+size_t DecodeImaBlock( const Uint8* Block_Ptr, size_t Bytes, int Channels, Sint16* Out_Ptr )
+{
+  const size_t Header = 4 * static_cast<size_t>( Channels );
+
+  if ( Bytes < Header )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  int Predictor[IMA_MAX_CHANNELS];
+  int Index    [IMA_MAX_CHANNELS];
+
+  for ( int c = 0; c != Channels; ++c )
+  {
+    const Uint8* Head_Ptr = Block_Ptr + 4 * c;
+
+    Predictor[c] = static_cast<Sint16>( Head_Ptr[0] | ( Head_Ptr[1] << 8 ) );
+    Index    [c] = std::min( static_cast<int>( Head_Ptr[2] ), IMA_MAX_INDEX );
+    Out_Ptr  [c] = static_cast<Sint16>( Predictor[c] );
+  }
+
+  const size_t Groups   = ( Bytes - Header ) / Header;   // 8 frames each
+  const Uint8* Data_Ptr = Block_Ptr + Header;
+
+  for ( size_t g = 0; g != Groups; ++g )
+  {
+    for ( int c = 0; c != Channels; ++c )
+    {
+      Sint16* Frame_Ptr = Out_Ptr + ( 1 + 8 * g ) * static_cast<size_t>( Channels ) + static_cast<size_t>( c );
+
+      for ( int b = 0; b != 4; ++b )
+      {
+        const Uint8 Byte = *Data_Ptr++;
+
+        // Low nibble first
+        Frame_Ptr[( 2 * b     ) * Channels] = DecodeImaNibble( Byte & 0x0F, Predictor[c], Index[c] );
+        Frame_Ptr[( 2 * b + 1 ) * Channels] = DecodeImaNibble( Byte >> 4  , Predictor[c], Index[c] );
+      }
+    }
+  }
+
+  return 1 + 8 * Groups;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file LImaAdpcm.hpp
+ *
+ * @brief IMA ADPCM, 4 bits a sample, in the blocks WAV files store it in.
+ **/
+
+#ifndef LIMAADPCM_HPP
+#define LIMAADPCM_HPP
+
+#include <SDL.h>
+
+static constexpr int IMA_MAX_CHANNELS = 8;
+
+/*
+ * A block holds a 4-byte header per channel, with the first sample, then 4 bytes, 8 samples, of
+ * each channel in turn: a block of Bytes bytes holds ImaBlockFrames( Bytes, Channels ) frames.
+ * Samples are interleaved 16-bit, up to IMA_MAX_CHANNELS channels.
+ */
+size_t ImaBlockFrames( size_t, int );
+
+/*
+ * Encodes ImaBlockFrames frames into a block. The step index of each channel, 0 to start with, is
+ * carried from one block to the next. Returns the bytes written.
+ */
+size_t EncodeImaBlock( const Sint16*, size_t, int, int*, Uint8* );
+
+/*
+ * Decodes a block, which may be short, as the last one of a file. Returns the frames decoded.
+ */
+size_t DecodeImaBlock( const Uint8*, size_t, int, Sint16* );
+
+#endif // LIMAADPCM_HPP
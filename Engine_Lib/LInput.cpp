@@ -0,0 +1,559 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LInput.hpp"
+#include "LInputPump.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const size_t EVENTS_RESERVED = 64;   // Events in a frame before the vector grows
+static const Sint16 AXIS_MAX        = 32767;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return true for the events that are input from the user, those the latency is measured from.
+ **/
+static bool isInput( const SDL_Event& Event )
+{
+  switch ( Event.type )
+  {
+    case SDL_KEYDOWN:
+    return Event.key.repeat == 0;
+
+    case SDL_KEYUP:
+    case SDL_MOUSEMOTION:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_JOYAXISMOTION:
+    case SDL_JOYBUTTONDOWN:
+    case SDL_JOYBUTTONUP:
+    return true;
+
+    default:
+    return false;
+  }
+}
+
+
+/**
+ * @return true for the joystick input events, which an LInputPump reads instead of the queue.
+ **/
+static bool isJoystickInput( const SDL_Event& Event )
+{
+  return Event.type == SDL_JOYAXISMOTION || Event.type == SDL_JOYBUTTONDOWN || Event.type == SDL_JOYBUTTONUP;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LInput::LInput( void )
+  : m_Snapshot(), m_Actions(), m_Bindings(), m_Events(), m_NextEvent(0),
+    m_ActionsDown(0), m_ActionsPressed(0), m_ActionsReleased(0), m_Values(), m_PrevAxes(),
+    m_DeadZone(s_DEFAULT_DEAD_ZONE), m_Joystick_Ptr(nullptr), m_JoystickID(-1),
+    m_Pump_Ptr(nullptr), m_Frequency(SDL_GetPerformanceFrequency()), m_IsLatencyPending(false), m_Latency()
+{
+  m_Events.reserve( EVENTS_RESERVED );
+}
+
+
+LInput::~LInput( void )
+{
+  CloseJoystick_Pvt();
+}
+
+
+/**
+ * @return the identifier of the action, to bind and query it with; that of the action already
+ * there with the same name; or -1 if there are s_MAX_ACTIONS already.
+ **/
+int LInput::addAction( const std::string& Name )
+{
+  const int Found = FindAction( Name );
+
+  if ( Found >= 0 )
+  {
+    return Found;
+  }
+  else if ( m_Actions.size() == s_MAX_ACTIONS )
+  {
+    printf( "\nUnable to add the input action \"%s\": there are %d already!", Name.c_str(), s_MAX_ACTIONS );
+    return -1;
+  }
+  else
+  {;}
+
+  m_Actions.push_back( Name );
+
+  return static_cast<int>( m_Actions.size() ) - 1;
+}
+
+
+/**
+ * @brief Adds a binding to an action: a key, a button or an axis direction more that sets it off.
+ **/
+bool LInput::bind( int Action, Source From, int Code )
+{
+  if ( Action < 0 || Action >= static_cast<int>( m_Actions.size() ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Bindings.push_back( Binding{ Action, From, Code } );
+
+  return true;
+}
+
+
+/**
+ * @return the identifier of the action, or -1. Look the actions up once, not every frame.
+ **/
+int LInput::FindAction( const std::string& Name ) const
+{
+  const auto Found = std::find( m_Actions.begin(), m_Actions.end(), Name );
+
+  return ( Found != m_Actions.end() ) ? static_cast<int>( Found - m_Actions.begin() ) : -1;
+}
+
+
+void LInput::setDeadZone( Sint16 DeadZone )
+{
+  m_DeadZone = std::min<Sint16>( std::max<Sint16>( DeadZone, 0 ), AXIS_MAX - 1 );
+}
+
+
+/**
+ * @brief Takes the joystick from the pump given, read on its thread, or from the event queue again
+ * with nullptr. The pump is not owned, and must outlive its use here.
+ **/
+void LInput::setPump( LInputPump* Pump_Ptr )
+{
+  m_Pump_Ptr = Pump_Ptr;
+}
+
+
+/**
+ * @brief Drains the event queue into the snapshot and updates the actions. Call once per frame,
+ * instead of the SDL_PollEvent loop; "nextEvent" then hands out the events drained.
+ **/
+void LInput::poll( void )
+{
+  const Uint64 PrevPoll_Counts = m_Snapshot.Poll_Counts;
+
+  std::copy( m_Snapshot.Axes, m_Snapshot.Axes + LInputSnapshot::s_MAX_AXES, m_PrevAxes );
+
+  m_Snapshot.KeysPressed.reset();
+  m_Snapshot.KeysReleased.reset();
+  m_Snapshot.ButtonsPressed    = 0;
+  m_Snapshot.ButtonsReleased   = 0;
+  m_Snapshot.MousePressed      = 0;
+  m_Snapshot.MouseReleased     = 0;
+  m_Snapshot.FirstInput_Counts = 0;
+
+  m_Events.clear();
+  m_NextEvent = 0;
+
+  // The events are queued, and stamped by SDL, now
+  SDL_PumpEvents();
+
+  const Uint64 Poll_Counts = SDL_GetPerformanceCounter();
+  const Uint32 Poll_Ticks  = SDL_GetTicks();
+
+  m_Snapshot.Poll_Counts = Poll_Counts;
+
+  SDL_Event Event;
+  Uint64    Counts = 0;
+
+  // Stamped by the pump already, on the counter
+  while ( m_Pump_Ptr != nullptr && m_Pump_Ptr->popEvent( Event, Counts ) )
+  {
+    Take_Pvt( Event, Counts );
+  }
+
+  while ( SDL_PeepEvents( &Event, 1, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT ) > 0 )
+  {
+    if ( m_Pump_Ptr != nullptr && isJoystickInput( Event ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    // From the millisecond stamp of SDL to the counter; never before the previous poll
+    const Uint64 Age = static_cast<Uint64>( Poll_Ticks - Event.common.timestamp ) * m_Frequency / 1000;
+
+    Counts = std::max( ( Age < Poll_Counts ) ? Poll_Counts - Age : 0, PrevPoll_Counts );
+
+    Take_Pvt( Event, Counts );
+  }
+
+  UpdateActions_Pvt();
+}
+
+
+/**
+ * @brief Hands out the events of the last poll in order, input included, for the code that still
+ * works on events (quit, window events, text input).
+ *
+ * @return false when there are no more.
+ **/
+bool LInput::nextEvent( SDL_Event& Event, Uint64* Counts_Ptr )
+{
+  if ( m_NextEvent == m_Events.size() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Event = m_Events[m_NextEvent].Event;
+
+  if ( Counts_Ptr != nullptr )
+  {
+    *Counts_Ptr = m_Events[m_NextEvent].Counts;
+  }
+  else
+  {;}
+
+  ++m_NextEvent;
+
+  return true;
+}
+
+
+/**
+ * @brief Call right after SDL_RenderPresent: if the frame was the first to see some input, the time
+ * since the oldest of it goes into the latency statistics.
+ **/
+void LInput::presented( void )
+{
+  if ( m_IsLatencyPending )
+  {
+    const Uint64 Now = SDL_GetPerformanceCounter();
+
+    m_Latency.addFrame( static_cast<double>( Now - m_Snapshot.FirstInput_Counts ) / static_cast<double>( m_Frequency ) );
+    m_IsLatencyPending = false;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Closes the joystick; call before SDL_Quit.
+ **/
+void LInput::close( void )
+{
+  CloseJoystick_Pvt();
+}
+
+
+bool LInput::IsDown( int Action ) const
+{
+  return Action >= 0 && Action < s_MAX_ACTIONS && ( ( m_ActionsDown >> Action ) & 1 ) != 0;
+}
+
+
+bool LInput::WasPressed( int Action ) const
+{
+  return Action >= 0 && Action < s_MAX_ACTIONS && ( ( m_ActionsPressed >> Action ) & 1 ) != 0;
+}
+
+
+bool LInput::WasReleased( int Action ) const
+{
+  return Action >= 0 && Action < s_MAX_ACTIONS && ( ( m_ActionsReleased >> Action ) & 1 ) != 0;
+}
+
+
+/**
+ * @return from 0, released, to 1: held fully down, or an axis at its end.
+ **/
+float LInput::GetValue( int Action ) const
+{
+  return ( Action >= 0 && Action < s_MAX_ACTIONS ) ? m_Values[Action] : 0.0f;
+}
+
+
+const LInputSnapshot& LInput::GetSnapshot( void ) const
+{
+  return m_Snapshot;
+}
+
+
+const LFrameStats& LInput::GetLatency( void ) const
+{
+  return m_Latency;
+}
+
+
+/**
+ * @brief Processes one event of the poll and keeps it, with its stamp, for "nextEvent".
+ **/
+void LInput::Take_Pvt( const SDL_Event& Event, Uint64 Counts )
+{
+  if ( isInput( Event ) && ( m_Snapshot.FirstInput_Counts == 0 || Counts < m_Snapshot.FirstInput_Counts ) )
+  {
+    m_Snapshot.FirstInput_Counts = Counts;
+    m_IsLatencyPending           = true;
+  }
+  else
+  {;}
+
+  Process_Pvt( Event );
+  m_Events.push_back( StampedEvent{ Event, Counts } );
+}
+
+
+/**
+ * @brief Brings the snapshot up to date with one event.
+ **/
+void LInput::Process_Pvt( const SDL_Event& Event )
+{
+  LInputSnapshot& Input = m_Snapshot;
+
+  switch ( Event.type )
+  {
+    case SDL_QUIT:
+    Input.Quit = true;
+    break;
+
+    case SDL_KEYDOWN:
+    Input.KeysDown.set( Event.key.keysym.scancode );
+
+    if ( Event.key.repeat == 0 )
+    {
+      Input.KeysPressed.set( Event.key.keysym.scancode );
+    }
+    else
+    {;}
+    break;
+
+    case SDL_KEYUP:
+    Input.KeysDown.reset( Event.key.keysym.scancode );
+    Input.KeysReleased.set( Event.key.keysym.scancode );
+    break;
+
+    case SDL_MOUSEMOTION:
+    Input.MouseX = Event.motion.x;
+    Input.MouseY = Event.motion.y;
+    break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    Input.MouseX        = Event.button.x;
+    Input.MouseY        = Event.button.y;
+    Input.MouseDown    |= SDL_BUTTON( Event.button.button );
+    Input.MousePressed |= SDL_BUTTON( Event.button.button );
+    break;
+
+    case SDL_MOUSEBUTTONUP:
+    Input.MouseX         = Event.button.x;
+    Input.MouseY         = Event.button.y;
+    Input.MouseDown     &= ~SDL_BUTTON( Event.button.button );
+    Input.MouseReleased |= SDL_BUTTON( Event.button.button );
+    break;
+
+    case SDL_JOYAXISMOTION:
+    if ( Event.jaxis.which == m_JoystickID && Event.jaxis.axis < LInputSnapshot::s_MAX_AXES )
+    {
+      Input.Axes[Event.jaxis.axis] = ( std::abs( Event.jaxis.value ) > m_DeadZone ) ? Event.jaxis.value : 0;
+    }
+    else
+    {;}
+    break;
+
+    case SDL_JOYBUTTONDOWN:
+    if ( Event.jbutton.which == m_JoystickID && Event.jbutton.button < 32 )
+    {
+      Input.ButtonsDown    |= 1u << Event.jbutton.button;
+      Input.ButtonsPressed |= 1u << Event.jbutton.button;
+    }
+    else
+    {;}
+    break;
+
+    case SDL_JOYBUTTONUP:
+    if ( Event.jbutton.which == m_JoystickID && Event.jbutton.button < 32 )
+    {
+      Input.ButtonsDown     &= ~( 1u << Event.jbutton.button );
+      Input.ButtonsReleased |= 1u << Event.jbutton.button;
+    }
+    else
+    {;}
+    break;
+
+    case SDL_JOYDEVICEADDED:
+    if ( m_Joystick_Ptr == nullptr )
+    {
+      OpenJoystick_Pvt();
+    }
+    else
+    {;}
+    break;
+
+    case SDL_JOYDEVICEREMOVED:
+    if ( Event.jdevice.which == m_JoystickID )
+    {
+      CloseJoystick_Pvt();
+      OpenJoystick_Pvt();
+    }
+    else
+    {;}
+    break;
+
+    default:
+    break;
+  }
+}
+
+
+/**
+ * @brief Opens the first joystick there is, if any.
+ **/
+void LInput::OpenJoystick_Pvt( void )
+{
+  for ( int i = 0; i < SDL_NumJoysticks() && m_Joystick_Ptr == nullptr; ++i )
+  {
+    m_Joystick_Ptr = SDL_JoystickOpen( i );
+  }
+
+  m_JoystickID = ( m_Joystick_Ptr != nullptr ) ? SDL_JoystickInstanceID( m_Joystick_Ptr ) : -1;
+}
+
+
+/**
+ * @brief Closes the joystick, and lets go of whatever it held down.
+ **/
+void LInput::CloseJoystick_Pvt( void )
+{
+  if ( m_Joystick_Ptr != nullptr )
+  {
+    SDL_JoystickClose( m_Joystick_Ptr );
+  }
+  else
+  {;}
+
+  m_Joystick_Ptr = nullptr;
+  m_JoystickID   = -1;
+
+  m_Snapshot.ButtonsReleased |= m_Snapshot.ButtonsDown;
+  m_Snapshot.ButtonsDown      = 0;
+  std::fill( m_Snapshot.Axes, m_Snapshot.Axes + LInputSnapshot::s_MAX_AXES, Sint16(0) );
+}
+
+
+/**
+ * @brief Works out the state of every action from its bindings, once per poll, so that querying
+ * them is a bit test.
+ **/
+void LInput::UpdateActions_Pvt( void )
+{
+  m_ActionsDown     = 0;
+  m_ActionsPressed  = 0;
+  m_ActionsReleased = 0;
+  std::fill( m_Values, m_Values + s_MAX_ACTIONS, 0.0f );
+
+  for ( const Binding& Each : m_Bindings )
+  {
+    bool        IsDown     = false;
+    bool        IsPressed  = false;
+    bool        IsReleased = false;
+    const float Value      = GetBinding_Pvt( Each, IsDown, IsPressed, IsReleased );
+    const Uint64 Bit       = Uint64(1) << Each.Action;
+
+    m_ActionsDown     |= IsDown     ? Bit : 0;
+    m_ActionsPressed  |= IsPressed  ? Bit : 0;
+    m_ActionsReleased |= IsReleased ? Bit : 0;
+
+    m_Values[Each.Action] = std::max( m_Values[Each.Action], Value );
+  }
+
+  // Released only when no other binding holds the action down
+  m_ActionsReleased &= ~m_ActionsDown;
+}
+
+
+/**
+ * @return the value of a binding, from 0 to 1, and whether it is down, went down or went up.
+ **/
+float LInput::GetBinding_Pvt( const Binding& Each, bool& IsDown, bool& IsPressed, bool& IsReleased ) const
+{
+  const LInputSnapshot& Input = m_Snapshot;
+
+  switch ( Each.From )
+  {
+    case Source::KEY:
+    if ( Each.Code < 0 || Each.Code >= SDL_NUM_SCANCODES )
+    {
+      return 0.0f;
+    }
+    else
+    {;}
+
+    IsDown     = Input.KeysDown.test( static_cast<size_t>( Each.Code ) );
+    IsPressed  = Input.KeysPressed.test( static_cast<size_t>( Each.Code ) );
+    IsReleased = Input.KeysReleased.test( static_cast<size_t>( Each.Code ) );
+    break;
+
+    case Source::MOUSE_BUTTON:
+    case Source::JOY_BUTTON:
+    {
+      if ( Each.Code < 0 || Each.Code >= 32 )
+      {
+        return 0.0f;
+      }
+      else
+      {;}
+
+      const bool   IsMouse = Each.From == Source::MOUSE_BUTTON;
+      const Uint32 Mask    = IsMouse ? SDL_BUTTON( Each.Code ) : ( 1u << Each.Code );
+
+      IsDown     = ( ( IsMouse ? Input.MouseDown     : Input.ButtonsDown )     & Mask ) != 0;
+      IsPressed  = ( ( IsMouse ? Input.MousePressed  : Input.ButtonsPressed )  & Mask ) != 0;
+      IsReleased = ( ( IsMouse ? Input.MouseReleased : Input.ButtonsReleased ) & Mask ) != 0;
+    }
+    break;
+
+    case Source::JOY_AXIS_MINUS:
+    case Source::JOY_AXIS_PLUS:
+    {
+      if ( Each.Code < 0 || Each.Code >= LInputSnapshot::s_MAX_AXES )
+      {
+        return 0.0f;
+      }
+      else
+      {;}
+
+      // Along the direction of the binding: negative when the axis points the other way
+      const int Sign = ( Each.From == Source::JOY_AXIS_PLUS ) ? 1 : -1;
+      const int Now  = Sign * Input.Axes[Each.Code];
+      const int Prev = Sign * m_PrevAxes[Each.Code];
+
+      IsDown     = Now > 0;
+      IsPressed  = Now > 0 && Prev <= 0;
+      IsReleased = Now <= 0 && Prev > 0;
+
+      return IsDown ? std::min( 1.0f, static_cast<float>( Now - m_DeadZone ) / static_cast<float>( AXIS_MAX - m_DeadZone ) ) : 0.0f;
+    }
+
+    default:
+    return 0.0f;
+  }
+
+  return IsDown ? 1.0f : 0.0f;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file LInput.hpp
+ *
+ * @brief Input read once per frame: the event queue drained into a snapshot of keyboard, mouse and
+ * joystick, mapped to named actions, with the input-to-photon latency measured on the way.
+ **/
+
+#ifndef LINPUT_HPP
+#define LINPUT_HPP
+
+#include "LFrameStats.hpp"
+
+#include <SDL.h>
+#include <bitset>
+#include <string>
+#include <vector>
+
+class LInputPump;
+
+/**
+ * @brief The input devices as they were when the frame polled them. "Pressed" and "Released" hold
+ * what changed since the previous poll: a key tapped and let go between two frames is pressed and
+ * released in the same snapshot, even if it was never seen down.
+ **/
+struct LInputSnapshot
+{
+  static constexpr int s_MAX_AXES = 8;
+
+  std::bitset<SDL_NUM_SCANCODES> KeysDown;          // By SDL_Scancode
+  std::bitset<SDL_NUM_SCANCODES> KeysPressed;       // Key repeats excluded
+  std::bitset<SDL_NUM_SCANCODES> KeysReleased;
+
+  Sint16 Axes[s_MAX_AXES];                          // First joystick; 0 within the dead zone
+  Uint32 ButtonsDown;                               // First joystick, a bit per button
+  Uint32 ButtonsPressed;
+  Uint32 ButtonsReleased;
+
+  int    MouseX;                                    // In the window with the mouse focus
+  int    MouseY;
+  Uint32 MouseDown;                                 // SDL_BUTTON() masks
+  Uint32 MousePressed;
+  Uint32 MouseReleased;
+
+  Uint64 Poll_Counts;                               // Performance counter when the queue was pumped
+  Uint64 FirstInput_Counts;                         // Of the oldest input event; 0 if there were none
+  bool   Quit;                                      // SDL_QUIT was in the queue
+};
+
+
+/**
+ * @brief Drains the event queue once per frame with "poll", and hands the program a snapshot of the
+ * devices and the state of its actions. Nothing queries SDL afterwards: asking whether an action or
+ * a key is down is a bit test, from anywhere and as often as wanted.
+ *
+ * Actions are named and bound to keys, mouse buttons, joystick buttons or one direction of a
+ * joystick axis; an action is down while any of its bindings is, and its value goes from 0 to 1 with
+ * the axis past the dead zone (1 for keys and buttons).
+ *
+ * Every event is stamped on the performance counter. SDL stamps them in milliseconds when they are
+ * queued, that is when the queue is pumped: the stamp is moved onto the counter with the pump as
+ * reference, so that events of the same frame keep their order and age. The input is read as late
+ * as possible by calling "poll" right before the update, after any frame pacing wait.
+ *
+ * "presented", called after SDL_RenderPresent, records the time from the oldest input event of the
+ * frame to the present: the input-to-photon latency short of the scan-out of the display, which no
+ * program can see.
+ *
+ * The first joystick found is opened, and replaced when it is removed; SDL_INIT_JOYSTICK must have
+ * been given to SDL_Init for it. "close" lets it go, and must come before SDL_Quit.
+ *
+ * With "setPump", the joystick axes and buttons come from an LInputPump instead, read on its own
+ * thread and stamped when they were read rather than when the queue was pumped: they are taken
+ * before the other events of the poll, and SDL's own joystick input events are left out.
+ **/
+class LInput
+{
+public:
+
+  enum class Source : Uint8
+  {
+    KEY,              // SDL_Scancode
+    MOUSE_BUTTON,     // SDL_BUTTON_LEFT...
+    JOY_BUTTON,       // 0 to 31
+    JOY_AXIS_MINUS,   // Axis index, moved below the dead zone
+    JOY_AXIS_PLUS     // Axis index, moved above the dead zone
+  };
+
+  static constexpr int    s_MAX_ACTIONS       = 64;
+  static constexpr Sint16 s_DEFAULT_DEAD_ZONE = 8000;
+
+  LInput( void );
+  ~LInput( void );
+
+  LInput( const LInput& )            = delete;
+  LInput& operator=( const LInput& ) = delete;
+
+  int    addAction   ( const std::string& );
+  bool   bind        ( int, Source, int );
+  int    FindAction  ( const std::string& ) const;
+  void   setDeadZone ( Sint16 );
+  void   setPump     ( LInputPump* );
+
+  void   poll        ( void );
+  bool   nextEvent   ( SDL_Event&, Uint64* = nullptr );
+  void   presented   ( void );
+  void   close       ( void );
+
+  bool   IsDown      ( int ) const;
+  bool   WasPressed  ( int ) const;
+  bool   WasReleased ( int ) const;
+  float  GetValue    ( int ) const;
+
+  const LInputSnapshot& GetSnapshot( void ) const;
+  const LFrameStats&    GetLatency ( void ) const;
+
+private:
+
+  struct Binding
+  {
+    int    Action;
+    Source From;
+    int    Code;
+  };
+
+  struct StampedEvent
+  {
+    SDL_Event Event;
+    Uint64    Counts;
+  };
+
+  void   Take_Pvt         ( const SDL_Event&, Uint64 );
+  void   Process_Pvt      ( const SDL_Event& );
+  void   OpenJoystick_Pvt ( void );
+  void   CloseJoystick_Pvt( void );
+  void   UpdateActions_Pvt( void );
+  float  GetBinding_Pvt   ( const Binding&, bool&, bool&, bool& ) const;
+
+  LInputSnapshot            m_Snapshot;
+  std::vector<std::string>  m_Actions;
+  std::vector<Binding>      m_Bindings;
+  std::vector<StampedEvent> m_Events;           // Of the last poll
+  size_t                    m_NextEvent;
+  Uint64                    m_ActionsDown;      // A bit per action
+  Uint64                    m_ActionsPressed;
+  Uint64                    m_ActionsReleased;
+  float                     m_Values[s_MAX_ACTIONS];
+  Sint16                    m_PrevAxes[LInputSnapshot::s_MAX_AXES];
+  Sint16                    m_DeadZone;
+  SDL_Joystick*             m_Joystick_Ptr;
+  SDL_JoystickID            m_JoystickID;
+  LInputPump*               m_Pump_Ptr;         // Not owned; nullptr to read the joystick from the queue
+  Uint64                    m_Frequency;        // Performance counter counts per second
+  bool                      m_IsLatencyPending; // Input polled and not presented yet
+  LFrameStats               m_Latency;          // Seconds from input to present
+};
+
+#endif // LINPUT_HPP
@@ -0,0 +1,377 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LInputPump.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LInputPump::LInputPump( void )
+  : m_Events(s_QUEUE_SIZE), m_Commands(s_QUEUE_SIZE / 16), m_Pump_Ptr(nullptr), m_Period_ms(s_DEFAULT_PERIOD_ms),
+    m_IsStopping(false), m_Dropped(0), m_RumbleFailures(0), m_Joystick_Ptr(nullptr), m_JoystickID(-1),
+    m_Haptic_Ptr(nullptr), m_Axes(), m_Buttons(0)
+{;}
+
+
+LInputPump::~LInputPump( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Starts the pump thread.
+ *
+ * @param Period_ms The time between two readings of the joystick, at least 1 ms.
+ * @return true if running.
+ **/
+bool LInputPump::start( Uint32 Period_ms )
+{
+  stop();
+
+  m_Period_ms = std::max<Uint32>( Period_ms, 1 );
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_Pump_Ptr  = SDL_CreateThread( Pump_Pvt, "LInputPump", this );
+
+  if ( m_Pump_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the input thread! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Stops the thread, which stops any rumble and closes the joystick. The events not popped
+ * yet are kept.
+ **/
+void LInputPump::stop( void )
+{
+  if ( m_Pump_Ptr != nullptr )
+  {
+    m_IsStopping.store( true, std::memory_order_release );
+    SDL_WaitThread( m_Pump_Ptr, nullptr );
+    m_Pump_Ptr = nullptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Hands out the next joystick event read by the thread, with the performance counter at the
+ * time it was read.
+ *
+ * @return false when there are no more.
+ **/
+bool LInputPump::popEvent( SDL_Event& Event, Uint64& Counts )
+{
+  StampedEvent Next;
+
+  if ( !m_Events.pop( Next ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Event  = Next.Event;
+  Counts = Next.Counts;
+
+  return true;
+}
+
+
+/**
+ * @brief Queues a rumble for the thread to play, replacing the one playing if any. Never waits.
+ *
+ * @param Low The strength of the low frequency (left) motor, 0 to 0xFFFF.
+ * @param High The strength of the high frequency (right) motor, 0 to 0xFFFF.
+ * @param Duration_ms How long it lasts; 0 stops the rumble.
+ * @return false if the thread is not running or has too many commands queued already.
+ **/
+bool LInputPump::rumble( Uint16 Low, Uint16 High, Uint32 Duration_ms )
+{
+  if ( m_Pump_Ptr == nullptr || !m_Commands.push( Command{ Low, High, Duration_ms } ) )
+  {
+    m_RumbleFailures.fetch_add( 1, std::memory_order_relaxed );
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+bool LInputPump::IsRunning( void ) const
+{
+  return m_Pump_Ptr != nullptr;
+}
+
+
+Uint32 LInputPump::GetDropped( void ) const
+{
+  return m_Dropped.load( std::memory_order_relaxed );
+}
+
+
+Uint32 LInputPump::GetRumbleFailures( void ) const
+{
+  return m_RumbleFailures.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief The pump thread: reads the joystick, plays the rumble commands, and sleeps for the period.
+ **/
+int SDLCALL LInputPump::Pump_Pvt( void* Data_Ptr )
+{
+  LInputPump& Pump    = *static_cast<LInputPump*>( Data_Ptr );
+  Uint64      Scan_ms = 0;
+
+  LTrace::nameThread( "LInputPump" );
+
+  while ( !Pump.m_IsStopping.load( std::memory_order_acquire ) )
+  {
+    SDL_JoystickUpdate();
+
+    if ( Pump.m_Joystick_Ptr != nullptr && !SDL_JoystickGetAttached( Pump.m_Joystick_Ptr ) )
+    {
+      Pump.Close_Pvt();
+    }
+    else
+    {;}
+
+    if ( Pump.m_Joystick_Ptr == nullptr && SDL_GetTicks64() >= Scan_ms )
+    {
+      Pump.Open_Pvt();
+      Scan_ms = SDL_GetTicks64() + s_SCAN_ms;
+    }
+    else
+    {;}
+
+    if ( Pump.m_Joystick_Ptr != nullptr )
+    {
+      LTrace::Zone Traced( "Joystick read" );
+      Pump.Read_Pvt();
+    }
+    else
+    {;}
+
+    Command Next;
+
+    while ( Pump.m_Commands.pop( Next ) )
+    {
+      Pump.Rumble_Pvt( Next );
+    }
+
+    SDL_Delay( Pump.m_Period_ms );
+  }
+
+  if ( Pump.m_Joystick_Ptr != nullptr )
+  {
+    Pump.Rumble_Pvt( Command{ 0, 0, 0 } );
+  }
+  else
+  {;}
+
+  Pump.Close_Pvt();
+
+  return 0;
+}
+
+
+/**
+ * @brief Opens the first joystick there is, if any, and takes its state as it is: only what changes
+ * afterwards becomes an event.
+ **/
+void LInputPump::Open_Pvt( void )
+{
+  for ( int i = 0; i < SDL_NumJoysticks() && m_Joystick_Ptr == nullptr; ++i )
+  {
+    m_Joystick_Ptr = SDL_JoystickOpen( i );
+  }
+
+  if ( m_Joystick_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const int NumOfAxes    = std::min( SDL_JoystickNumAxes( m_Joystick_Ptr ), s_MAX_AXES );
+  const int NumOfButtons = std::min( SDL_JoystickNumButtons( m_Joystick_Ptr ), s_MAX_BUTTONS );
+
+  m_JoystickID = SDL_JoystickInstanceID( m_Joystick_Ptr );
+  m_Buttons    = 0;
+  std::fill( m_Axes, m_Axes + s_MAX_AXES, Sint16(0) );
+
+  for ( int i = 0; i < NumOfAxes; ++i )
+  {
+    m_Axes[i] = SDL_JoystickGetAxis( m_Joystick_Ptr, i );
+  }
+
+  for ( int i = 0; i < NumOfButtons; ++i )
+  {
+    m_Buttons |= ( SDL_JoystickGetButton( m_Joystick_Ptr, i ) != 0 ) ? ( 1u << i ) : 0;
+  }
+}
+
+
+void LInputPump::Close_Pvt( void )
+{
+  if ( m_Haptic_Ptr != nullptr )
+  {
+    SDL_HapticClose( m_Haptic_Ptr );
+    m_Haptic_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  if ( m_Joystick_Ptr != nullptr )
+  {
+    SDL_JoystickClose( m_Joystick_Ptr );
+    m_Joystick_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_JoystickID = -1;
+}
+
+
+/**
+ * @brief Compares the joystick with its last reading, and pushes an event for every axis and button
+ * that changed, all stamped with the time of this reading.
+ **/
+void LInputPump::Read_Pvt( void )
+{
+  const Uint64 Counts       = SDL_GetPerformanceCounter();
+  const Uint32 Ticks        = SDL_GetTicks();
+  const int    NumOfAxes    = std::min( SDL_JoystickNumAxes( m_Joystick_Ptr ), s_MAX_AXES );
+  const int    NumOfButtons = std::min( SDL_JoystickNumButtons( m_Joystick_Ptr ), s_MAX_BUTTONS );
+
+  SDL_Event Event = {};
+
+  for ( int i = 0; i < NumOfAxes; ++i )
+  {
+    const Sint16 Value = SDL_JoystickGetAxis( m_Joystick_Ptr, i );
+
+    if ( Value != m_Axes[i] )
+    {
+      Event.jaxis.type      = SDL_JOYAXISMOTION;
+      Event.jaxis.timestamp = Ticks;
+      Event.jaxis.which     = m_JoystickID;
+      Event.jaxis.axis      = static_cast<Uint8>( i );
+      Event.jaxis.value     = Value;
+
+      Push_Pvt( Event, Counts );
+      m_Axes[i] = Value;
+    }
+    else
+    {;}
+  }
+
+  for ( int i = 0; i < NumOfButtons; ++i )
+  {
+    const Uint32 Bit    = 1u << i;
+    const Uint32 IsDown = ( SDL_JoystickGetButton( m_Joystick_Ptr, i ) != 0 ) ? Bit : 0;
+
+    if ( IsDown != ( m_Buttons & Bit ) )
+    {
+      Event.jbutton.type      = ( IsDown != 0 ) ? SDL_JOYBUTTONDOWN : SDL_JOYBUTTONUP;
+      Event.jbutton.timestamp = Ticks;
+      Event.jbutton.which     = m_JoystickID;
+      Event.jbutton.button    = static_cast<Uint8>( i );
+      Event.jbutton.state     = ( IsDown != 0 ) ? SDL_PRESSED : SDL_RELEASED;
+
+      Push_Pvt( Event, Counts );
+      m_Buttons ^= Bit;
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Queues an event for the main thread; a full queue drops it, as the main thread has not
+ * polled for at least s_QUEUE_SIZE changes.
+ **/
+void LInputPump::Push_Pvt( const SDL_Event& Event, Uint64 Counts )
+{
+  if ( !m_Events.push( StampedEvent{ Event, Counts } ) )
+  {
+    m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Plays a rumble on the joystick: through SDL_JoystickRumble, which game controllers and most
+ * gamepads take, or else through the haptic API, opened the first time it is needed.
+ **/
+void LInputPump::Rumble_Pvt( const Command& Rumble )
+{
+  if ( m_Joystick_Ptr == nullptr )
+  {
+    m_RumbleFailures.fetch_add( 1, std::memory_order_relaxed );
+    return;
+  }
+  else if ( SDL_JoystickRumble( m_Joystick_Ptr, Rumble.Low, Rumble.High, Rumble.Duration_ms ) == 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( m_Haptic_Ptr == nullptr && SDL_JoystickIsHaptic( m_Joystick_Ptr ) == 1 )
+  {
+    m_Haptic_Ptr = SDL_HapticOpenFromJoystick( m_Joystick_Ptr );
+
+    if ( m_Haptic_Ptr != nullptr && SDL_HapticRumbleInit( m_Haptic_Ptr ) != 0 )
+    {
+      SDL_HapticClose( m_Haptic_Ptr );
+      m_Haptic_Ptr = nullptr;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  if ( m_Haptic_Ptr == nullptr )
+  {
+    m_RumbleFailures.fetch_add( 1, std::memory_order_relaxed );
+    return;
+  }
+  else
+  {;}
+
+  // The haptic rumble has a single strength
+  const float Strength = static_cast<float>( std::max( Rumble.Low, Rumble.High ) ) / 0xFFFF;
+  const int   Result   = ( Strength > 0.0f && Rumble.Duration_ms > 0 )
+                         ? SDL_HapticRumblePlay( m_Haptic_Ptr, Strength, Rumble.Duration_ms )
+                         : SDL_HapticRumbleStop( m_Haptic_Ptr );
+
+  if ( Result != 0 )
+  {
+    m_RumbleFailures.fetch_add( 1, std::memory_order_relaxed );
+  }
+  else
+  {;}
+}
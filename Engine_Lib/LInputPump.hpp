@@ -0,0 +1,102 @@
+/**
+ * @file LInputPump.hpp
+ *
+ * @brief Joystick input read on a thread of its own, many times per frame, and rumble played from
+ * the same thread: a slow frame neither delays the reading of the input nor waits for the device.
+ **/
+
+#ifndef LINPUTPUMP_HPP
+#define LINPUTPUMP_HPP
+
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+
+/**
+ * @brief The pump thread reads the axes and buttons of the first joystick every period (1 ms by
+ * default) and pushes every change, as an SDL_JOYAXISMOTION, SDL_JOYBUTTONDOWN or SDL_JOYBUTTONUP
+ * event stamped on the performance counter when it was read, into a lock-free queue. The main
+ * thread pops them once per frame, in order, usually through LInput::setPump: a button pressed in
+ * the middle of a slow frame is stamped when it was pressed, not when the frame got round to it.
+ *
+ * "rumble" queues a command for the same thread, which plays it with SDL_JoystickRumble (game
+ * controllers included), or through the haptic API for the joysticks that only have that. The main
+ * thread never waits for the device to take it.
+ *
+ * The pump opens the first joystick by itself, and looks for one twice a second while there is
+ * none. SDL_INIT_JOYSTICK, and SDL_INIT_HAPTIC for the haptic rumble, must have been given to
+ * SDL_Init. Joystick backends that deliver the input to the main thread only (such as IOKit on
+ * macOS) give the pump nothing newer than the main thread's own SDL_PumpEvents; on Windows,
+ * SDL_HINT_JOYSTICK_THREAD set to "1" before SDL_Init moves SDL's own joystick messages off the
+ * main thread too.
+ *
+ * start, stop, popEvent and rumble are called from one thread, and stop before SDL_Quit.
+ **/
+class LInputPump
+{
+public:
+
+  static constexpr Uint32 s_DEFAULT_PERIOD_ms = 1;
+  static constexpr size_t s_QUEUE_SIZE        = 1024;    // Events; the commands get a sixteenth
+
+  LInputPump( void );
+  ~LInputPump( void );
+
+  LInputPump( const LInputPump& )            = delete;
+  LInputPump& operator=( const LInputPump& ) = delete;
+
+  bool   start           ( Uint32 = s_DEFAULT_PERIOD_ms );
+  void   stop            ( void );
+
+  bool   popEvent        ( SDL_Event&, Uint64& );
+  bool   rumble          ( Uint16, Uint16, Uint32 );
+
+  bool   IsRunning       ( void ) const;
+  Uint32 GetDropped      ( void ) const;
+  Uint32 GetRumbleFailures( void ) const;
+
+private:
+
+  static constexpr int    s_MAX_AXES    = 8;
+  static constexpr int    s_MAX_BUTTONS = 32;
+  static constexpr Uint32 s_SCAN_ms     = 500;   // Between two looks for a joystick
+
+  struct StampedEvent
+  {
+    SDL_Event Event;
+    Uint64    Counts;
+  };
+
+  struct Command
+  {
+    Uint16 Low;        // Strength of the low frequency motor
+    Uint16 High;       // Strength of the high frequency motor
+    Uint32 Duration_ms;
+  };
+
+  static int SDLCALL Pump_Pvt( void* );
+
+  void   Open_Pvt        ( void );
+  void   Close_Pvt       ( void );
+  void   Read_Pvt        ( void );
+  void   Push_Pvt        ( const SDL_Event&, Uint64 );
+  void   Rumble_Pvt      ( const Command& );
+
+  LSpscRing<StampedEvent> m_Events;          // Pump to main thread
+  LSpscRing<Command>      m_Commands;        // Main thread to pump
+  SDL_Thread*             m_Pump_Ptr;
+  Uint32                  m_Period_ms;
+  std::atomic<bool>       m_IsStopping;
+  std::atomic<Uint32>     m_Dropped;         // Events lost to a full queue
+  std::atomic<Uint32>     m_RumbleFailures;  // Commands lost to a full queue or refused by the device
+
+  // Pump thread only
+  SDL_Joystick*           m_Joystick_Ptr;
+  SDL_JoystickID          m_JoystickID;
+  SDL_Haptic*             m_Haptic_Ptr;      // Opened on the first rumble SDL_JoystickRumble refuses
+  Sint16                  m_Axes[s_MAX_AXES];
+  Uint32                  m_Buttons;
+};
+
+#endif // LINPUTPUMP_HPP
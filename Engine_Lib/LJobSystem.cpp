@@ -0,0 +1,446 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LJobSystem.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+
+/***************************************************************************************************
+* Private variables
+****************************************************************************************************/
+
+// The pool the current thread is a worker of, and its queue; none for the threads outside pools
+static thread_local const LJobSystem* tOwner_Ptr = nullptr;
+static thread_local size_t            tQueue     = 0;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LJobCounter::LJobCounter( void )
+  : m_Pending{ 0 }, m_Finishing{ 0 }, m_Lock(0)
+{;}
+
+
+/**
+ * @return true when every job counted is done and none is still using the counter: a counter that
+ * is done can be destroyed.
+ **/
+bool LJobCounter::isDone( void ) const
+{
+  return SDL_AtomicGet( &m_Pending ) == 0 && SDL_AtomicGet( &m_Finishing ) == 0;
+}
+
+
+int LJobCounter::GetPending( void ) const
+{
+  return SDL_AtomicGet( &m_Pending );
+}
+
+
+LJobSystem::LJobSystem( void )
+  : m_Wake_Ptr(NULL), m_Sleeping{ 0 }, m_Quit{ 0 }
+{;}
+
+
+LJobSystem::~LJobSystem( void )
+{
+  shutdown();
+}
+
+
+/**
+ * @brief Starts the workers.
+ *
+ * @param Workers Number of worker threads; 0, the default, for one per core but the calling one.
+ * @return false if the threads could not be started. Without the pool, jobs run when they are
+ * queued, on the thread that queues them.
+ **/
+bool LJobSystem::init( int Workers )
+{
+  shutdown();
+
+  if ( Workers <= 0 )
+  {
+    Workers = std::max( SDL_GetCPUCount() - 1, 1 );
+  }
+  else
+  {;}
+
+  m_Wake_Ptr = SDL_CreateSemaphore( 0 );
+
+  if ( m_Wake_Ptr == NULL )
+  {
+    printf( "\nUnable to create the job semaphore! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_AtomicSet( &m_Quit, 0 );
+  SDL_AtomicSet( &m_Sleeping, 0 );
+
+  // Sized once: the workers keep pointers to their entries
+  m_Queues  = std::vector<Queue>( static_cast<size_t>( Workers ) + 1 );
+  m_Workers = std::vector<Worker>( static_cast<size_t>( Workers ) );
+
+  bool Success = true;
+
+  for ( size_t i = 0; i != m_Workers.size(); ++i )
+  {
+    const std::string Name = "Job worker " + std::to_string( i );
+
+    m_Workers[i] = Worker{ this, i + 1, NULL };
+    m_Workers[i].Thread_Ptr = SDL_CreateThread( WorkerMain_Pvt, Name.c_str(), &m_Workers[i] );
+
+    if ( m_Workers[i].Thread_Ptr == NULL )
+    {
+      printf( "\nUnable to create %s! SDL Error: %s", Name.c_str(), SDL_GetError() );
+      Success = false;
+    }
+    else
+    {;}
+  }
+
+  return Success;
+}
+
+
+/**
+ * @brief Stops the workers once every queued job has run, and waits for them.
+ **/
+void LJobSystem::shutdown( void )
+{
+  if ( m_Wake_Ptr == NULL )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_AtomicSet( &m_Quit, 1 );
+
+  for ( size_t i = 0; i != m_Workers.size(); ++i )
+  {
+    SDL_SemPost( m_Wake_Ptr );
+  }
+
+  for ( Worker& Thread : m_Workers )
+  {
+    if ( Thread.Thread_Ptr != NULL )
+    {
+      SDL_WaitThread( Thread.Thread_Ptr, NULL );
+    }
+    else
+    {;}
+  }
+
+  // Jobs queued while the workers were leaving run here
+  LJob Job;
+
+  while ( FindJob_Pvt( 0, Job ) )
+  {
+    Execute_Pvt( Job );
+  }
+
+  m_Workers.clear();
+  m_Queues.clear();
+  SDL_DestroySemaphore( m_Wake_Ptr );
+  m_Wake_Ptr = NULL;
+}
+
+
+/**
+ * @brief Queues a job on the queue of the calling thread.
+ *
+ * @param Function The job.
+ * @param Data Passed to the job.
+ * @param Counter Incremented now and decremented when the job is done. Optional.
+ **/
+void LJobSystem::run( LJobFunction Function, void* Data, LJobCounter* Counter )
+{
+  if ( Counter != nullptr )
+  {
+    SDL_AtomicIncRef( &Counter->m_Pending );
+  }
+  else
+  {;}
+
+  Submit_Pvt( LJob{ Function, Data, Counter } );
+}
+
+
+/**
+ * @brief Queues a job once every job counted by Dependency is done: at once if they already are.
+ * Counter, if any, counts the job from now, so waiting for it waits for the dependency too.
+ **/
+void LJobSystem::runAfter( LJobCounter& Dependency, LJobFunction Function, void* Data, LJobCounter* Counter )
+{
+  if ( Counter != nullptr )
+  {
+    SDL_AtomicIncRef( &Counter->m_Pending );
+  }
+  else
+  {;}
+
+  const LJob Job{ Function, Data, Counter };
+
+  // Checked under the lock: the last job of the dependency takes it before reading the list
+  SDL_AtomicLock( &Dependency.m_Lock );
+
+  const bool IsReady = ( SDL_AtomicGet( &Dependency.m_Pending ) == 0 );
+
+  if ( !IsReady )
+  {
+    Dependency.m_Continuations.push_back( Job );
+  }
+  else
+  {;}
+
+  SDL_AtomicUnlock( &Dependency.m_Lock );
+
+  if ( IsReady )
+  {
+    Submit_Pvt( Job );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Returns when every job counted by Counter is done, running queued jobs, of any group, in
+ * the meantime.
+ **/
+void LJobSystem::wait( LJobCounter& Counter )
+{
+  const size_t Own = GetQueue_Pvt();
+  LJob         Job;
+
+  while ( !Counter.isDone() )
+  {
+    if ( FindJob_Pvt( Own, Job ) )
+    {
+      Execute_Pvt( Job );
+    }
+    else
+    {
+      // The last jobs are running elsewhere
+      SDL_Delay( 0 );
+    }
+  }
+}
+
+
+int LJobSystem::GetWorkerCount( void ) const
+{
+  return static_cast<int>( m_Workers.size() );
+}
+
+
+/**
+ * @brief Worker loop: runs jobs while there are any, sleeps otherwise, and leaves when asked to and
+ * nothing is left.
+ **/
+int LJobSystem::WorkerMain_Pvt( void* Data )
+{
+  const Worker& Self   = *static_cast<const Worker*>( Data );
+  LJobSystem&   System = *Self.System_Ptr;
+  LJob          Job;
+
+  tOwner_Ptr = &System;
+  tQueue     = Self.Index;
+
+  char Name[32];
+  snprintf( Name, sizeof(Name), "Job worker %zu", Self.Index - 1 );
+  LTrace::nameThread( Name );
+
+  for ( ;; )
+  {
+    if ( System.FindJob_Pvt( Self.Index, Job ) )
+    {
+      System.Execute_Pvt( Job );
+      continue;
+    }
+    else
+    {;}
+
+    if ( SDL_AtomicGet( &System.m_Quit ) != 0 )
+    {
+      break;
+    }
+    else
+    {;}
+
+    // Announce the sleep before looking once more: a job queued after the last look sees it and posts
+    SDL_AtomicIncRef( &System.m_Sleeping );
+
+    if ( System.FindJob_Pvt( Self.Index, Job ) )
+    {
+      SDL_AtomicAdd( &System.m_Sleeping, -1 );
+      System.Execute_Pvt( Job );
+    }
+    else
+    {
+      SDL_SemWait( System.m_Wake_Ptr );
+      SDL_AtomicAdd( &System.m_Sleeping, -1 );
+    }
+  }
+
+  return 0;
+}
+
+
+void LJobSystem::Submit_Pvt( const LJob& Job )
+{
+  if ( m_Queues.empty() )
+  {
+    // No pool: run it here
+    Execute_Pvt( Job );
+    return;
+  }
+  else
+  {;}
+
+  Queue& Own = m_Queues[ GetQueue_Pvt() ];
+
+  SDL_AtomicLock( &Own.Lock );
+  Own.Jobs.push_back( Job );
+  SDL_AtomicUnlock( &Own.Lock );
+
+  if ( m_Wake_Ptr != NULL && SDL_AtomicGet( &m_Sleeping ) > 0 )
+  {
+    SDL_SemPost( m_Wake_Ptr );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Takes the newest job of the given queue, or else steals the oldest job of another one.
+ **/
+bool LJobSystem::FindJob_Pvt( size_t Own, LJob& Job )
+{
+  for ( size_t i = 0; i != m_Queues.size(); ++i )
+  {
+    const size_t Index  = ( Own + i ) % m_Queues.size();
+    Queue&       Source = m_Queues[Index];
+    bool         Found  = false;
+
+    SDL_AtomicLock( &Source.Lock );
+
+    if ( !Source.Jobs.empty() )
+    {
+      if ( Index == Own )
+      {
+        Job = Source.Jobs.back();
+        Source.Jobs.pop_back();
+      }
+      else
+      {
+        Job = Source.Jobs.front();
+        Source.Jobs.pop_front();
+      }
+
+      Found = true;
+    }
+    else
+    {;}
+
+    SDL_AtomicUnlock( &Source.Lock );
+
+    if ( Found )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Runs a job and counts it done; the last job of a counter releases the jobs waiting for it.
+ **/
+void LJobSystem::Execute_Pvt( const LJob& Job )
+{
+  {
+    LTrace::Zone Traced( "Job" );
+    Job.Function( Job.Data );
+  }
+
+  if ( Job.Counter == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  LJobCounter&      Counter = *Job.Counter;
+  std::vector<LJob> Ready;
+
+  for ( ;; )
+  {
+    const int Pending = SDL_AtomicGet( &Counter.m_Pending );
+
+    if ( Pending > 1 )
+    {
+      // Not the last job: once the count is down, the counter is not touched again
+      if ( SDL_AtomicCAS( &Counter.m_Pending, Pending, Pending - 1 ) )
+      {
+        return;
+      }
+      else
+      {;}
+    }
+    else
+    {
+      // The last job, unless another one is added meanwhile. Until m_Finishing drops back the
+      // counter is not done, and its owner cannot destroy it
+      SDL_AtomicIncRef( &Counter.m_Finishing );
+
+      const bool IsLast = SDL_AtomicCAS( &Counter.m_Pending, Pending, 0 );
+
+      if ( IsLast )
+      {
+        SDL_AtomicLock( &Counter.m_Lock );
+        Ready.swap( Counter.m_Continuations );
+        SDL_AtomicUnlock( &Counter.m_Lock );
+      }
+      else
+      {;}
+
+      SDL_AtomicAdd( &Counter.m_Finishing, -1 );
+
+      if ( IsLast )
+      {
+        break;
+      }
+      else
+      {;}
+    }
+  }
+
+  for ( const LJob& Next : Ready )
+  {
+    Submit_Pvt( Next );
+  }
+}
+
+
+/**
+ * @brief The queue of the calling thread: its own for a worker of this pool, the shared one else.
+ **/
+size_t LJobSystem::GetQueue_Pvt( void ) const
+{
+  return ( tOwner_Ptr == this ) ? tQueue : 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file LJobSystem.hpp
+ *
+ * @brief Worker thread pool running small jobs, for the stages of a frame that fan out.
+ **/
+
+#ifndef LJOBSYSTEM_HPP
+#define LJOBSYSTEM_HPP
+
+#include <SDL.h>
+#include <deque>
+#include <vector>
+
+typedef void (*LJobFunction)( void* );
+
+class LJobCounter;
+
+
+/**
+ * @brief A function to run on a worker, its data, and the counter to decrement when it is done.
+ **/
+struct LJob
+{
+  LJobFunction Function;
+  void*        Data;
+  LJobCounter* Counter;
+};
+
+
+/**
+ * @brief Counts the jobs of a group still to finish. Jobs can be made to wait for a counter to reach
+ * zero, which is how dependencies between groups are expressed; a thread can wait for it too.
+ **/
+class LJobCounter
+{
+public:
+
+  LJobCounter( void );
+
+  bool isDone    ( void ) const;
+  int  GetPending( void ) const;
+
+private:
+
+  friend class LJobSystem;
+
+  mutable SDL_atomic_t m_Pending;
+  mutable SDL_atomic_t m_Finishing;      // Jobs past their function, still using the counter
+  SDL_SpinLock         m_Lock;           // Guards m_Continuations
+  std::vector<LJob>    m_Continuations;  // Jobs to submit when m_Pending reaches zero
+};
+
+
+/**
+ * @brief A fixed pool of worker threads, one per core besides the calling one. Every worker has its
+ * own queue: it pushes and pops at the back of it, so that the data of the jobs it just queued is
+ * still in its cache, and when it runs out it steals from the front of the others. Threads outside
+ * the pool share one more queue.
+ *
+ * Idle workers sleep on a semaphore, posted only when some are asleep. A thread waiting for a counter
+ * runs jobs meanwhile instead of blocking, so waiting from inside a job cannot deadlock the pool.
+ **/
+class LJobSystem
+{
+public:
+
+  LJobSystem( void );
+  ~LJobSystem( void );
+
+  bool init          ( int = 0 );
+  void shutdown      ( void );
+  void run           ( LJobFunction, void*, LJobCounter* = nullptr );
+  void runAfter      ( LJobCounter&, LJobFunction, void*, LJobCounter* = nullptr );
+  void wait          ( LJobCounter& );
+  int  GetWorkerCount( void ) const;
+
+private:
+
+  /**
+   * @brief The queue of a worker, on its own cache line so that the locks do not share one.
+   **/
+  struct alignas(64) Queue
+  {
+    SDL_SpinLock     Lock = 0;
+    std::deque<LJob> Jobs;
+  };
+
+  struct Worker
+  {
+    LJobSystem* System_Ptr;
+    size_t      Index;
+    SDL_Thread* Thread_Ptr;
+  };
+
+  static int WorkerMain_Pvt( void* );
+
+  void   Submit_Pvt    ( const LJob& );
+  bool   FindJob_Pvt   ( size_t, LJob& );
+  void   Execute_Pvt   ( const LJob& );
+  size_t GetQueue_Pvt  ( void ) const;
+
+  std::vector<Queue>  m_Queues;    // Queue 0 is shared by the threads outside the pool
+  std::vector<Worker> m_Workers;   // Worker i owns queue i + 1
+  SDL_sem*            m_Wake_Ptr;
+  SDL_atomic_t        m_Sleeping;
+  SDL_atomic_t        m_Quit;
+};
+
+#endif // LJOBSYSTEM_HPP
@@ -0,0 +1,233 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LLateLatch.hpp"
+#include "LFrameArena.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint64 MS_IN_A_S    = 1000;
+static constexpr Uint64 WORK_DECAY   = 64;   // The work estimate loses 1 / WORK_DECAY per shorter frame
+static constexpr Uint64 MARGIN_DECAY = 64;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LLateLatch::LLateLatch( void )
+  : m_IsEnabled(false), m_Frequency(SDL_GetPerformanceFrequency()), m_Period(0), m_Work(0), m_Margin(0), m_FrameStart(0),
+    m_LastPresent(0), m_Delay(0), m_LatencySum(0), m_Frames(0), m_Missed(0)
+{
+  setPeriod( s_DEFAULT_PERIOD_s );
+}
+
+
+/**
+ * @brief Turns the wait on or off; the latency is measured either way.
+ **/
+void LLateLatch::setEnabled( bool IsEnabled )
+{
+  m_IsEnabled = IsEnabled;
+  m_Delay     = 0;
+}
+
+
+/**
+ * @brief Sets the refresh period, in seconds, and starts the estimates over.
+ **/
+void LLateLatch::setPeriod( double Period )
+{
+  Period = ( Period > 0.0 ) ? Period : s_DEFAULT_PERIOD_s;
+
+  m_Period      = static_cast<Uint64>( static_cast<double>( m_Frequency ) * Period + 0.5 );
+  m_Margin      = static_cast<Uint64>( static_cast<double>( m_Frequency ) * s_MIN_MARGIN_s + 0.5 );
+  m_Work        = m_Period / 2;
+  m_LastPresent = 0;
+}
+
+
+/**
+ * @brief Takes the period of the display the window is on, to be called again when the window
+ * moves to another display.
+ *
+ * @return false, keeping the current period, when the display does not report its refresh rate.
+ **/
+bool LLateLatch::matchDisplay( SDL_Window* Window_Ptr )
+{
+  SDL_DisplayMode Mode;
+  const int       Display = SDL_GetWindowDisplayIndex( Window_Ptr );
+
+  if ( Display < 0 || SDL_GetCurrentDisplayMode( Display, &Mode ) != 0 || Mode.refresh_rate <= 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  setPeriod( 1.0 / Mode.refresh_rate );
+
+  return true;
+}
+
+
+/**
+ * @brief Holds the frame back until the latest start that still makes the next blank, then starts
+ * it. To be called right before the input of the frame is read.
+ **/
+void LLateLatch::wait( void )
+{
+  const Uint64 Before = SDL_GetPerformanceCounter();
+  Uint64       Now    = Before;
+
+  if ( m_IsEnabled && m_LastPresent != 0 )
+  {
+    const Uint64 Longest = static_cast<Uint64>( static_cast<double>( m_Period ) * s_MAX_DELAY );
+    const Uint64 Needed  = m_Work + m_Margin;
+    const Uint64 Start   = m_LastPresent + std::min( ( m_Period > Needed ) ? m_Period - Needed : 0, Longest );
+
+    // Sleep while the scheduler can be trusted, spin the rest
+    const Uint64 Spin = m_Frequency * s_SPIN_ms / MS_IN_A_S;
+
+    if ( Start > Now + Spin )
+    {
+      SDL_Delay( static_cast<Uint32>( ( Start - Now - Spin ) * MS_IN_A_S / m_Frequency ) );
+    }
+    else
+    {;}
+
+    while ( Now < Start )
+    {
+      Now = SDL_GetPerformanceCounter();
+    }
+  }
+  else
+  {;}
+
+  m_Delay      = Now - Before;
+  m_FrameStart = Now;
+}
+
+
+/**
+ * @brief Reads the mouse again, for what follows the cursor, right before it is drawn.
+ *
+ * @param X, Y The position of the mouse in the window with the mouse focus.
+ * @return The buttons down, as SDL_GetMouseState.
+ **/
+Uint32 LLateLatch::latchMouse( int& X, int& Y )
+{
+  SDL_PumpEvents();
+
+  return SDL_GetMouseState( &X, &Y );
+}
+
+
+/**
+ * @brief Presents the frame with PresentFrame, and updates the estimates from how long it took.
+ **/
+void LLateLatch::present( SDL_Renderer* Renderer_Ptr )
+{
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  PresentFrame( Renderer_Ptr );
+
+  const Uint64 End = SDL_GetPerformanceCounter();
+
+  if ( m_FrameStart != 0 )
+  {
+    m_Work        = std::max( Start - m_FrameStart, m_Work - m_Work / WORK_DECAY );
+    m_LatencySum += End - m_FrameStart;
+    ++m_Frames;
+  }
+  else
+  {;}
+
+  // A blank missed: wait less from now on. The margin comes back down slowly while none is
+  const Uint64 Minimum = static_cast<Uint64>( static_cast<double>( m_Frequency ) * s_MIN_MARGIN_s + 0.5 );
+
+  if ( m_LastPresent != 0 && static_cast<double>( End - m_LastPresent ) > static_cast<double>( m_Period ) * s_MISSED )
+  {
+    ++m_Missed;
+    m_Margin = std::min( m_Margin * 2, m_Period / 4 );
+  }
+  else
+  {
+    m_Margin = std::max( m_Margin - m_Margin / MARGIN_DECAY, Minimum );
+  }
+
+  m_LastPresent = End;
+  m_FrameStart  = 0;
+}
+
+
+/**
+ * @brief Prints the latency, the delay and the estimates.
+ **/
+void LLateLatch::report( void ) const
+{
+  printf( "\nLate latch %s: latency %.2f ms over %llu frames, last delay %.2f ms, work %.2f ms, margin %.2f ms, %llu blanks missed",
+          m_IsEnabled ? "on" : "off", GetAverageLatency() * 1000.0, static_cast<unsigned long long>( m_Frames ), GetDelay() * 1000.0,
+          GetWorkEstimate() * 1000.0, Seconds_Pvt( m_Margin ) * 1000.0, static_cast<unsigned long long>( m_Missed ) );
+}
+
+
+bool LLateLatch::IsEnabled( void ) const
+{
+  return m_IsEnabled;
+}
+
+
+/**
+ * @return Seconds per refresh.
+ **/
+double LLateLatch::GetPeriod( void ) const
+{
+  return Seconds_Pvt( m_Period );
+}
+
+
+/**
+ * @return Seconds the last wait held the frame back.
+ **/
+double LLateLatch::GetDelay( void ) const
+{
+  return Seconds_Pvt( m_Delay );
+}
+
+
+/**
+ * @return Seconds a frame is expected to take, from the wait to the present.
+ **/
+double LLateLatch::GetWorkEstimate( void ) const
+{
+  return Seconds_Pvt( m_Work );
+}
+
+
+/**
+ * @return Seconds from the end of the wait to the end of the present, averaged; 0 before a frame.
+ **/
+double LLateLatch::GetAverageLatency( void ) const
+{
+  return ( m_Frames != 0 ) ? Seconds_Pvt( m_LatencySum ) / static_cast<double>( m_Frames ) : 0.0;
+}
+
+
+Uint64 LLateLatch::GetMissedFrames( void ) const
+{
+  return m_Missed;
+}
+
+
+double LLateLatch::Seconds_Pvt( Uint64 Counts ) const
+{
+  return static_cast<double>( Counts ) / static_cast<double>( m_Frequency );
+}
@@ -0,0 +1,79 @@
+/**
+ * @file LLateLatch.hpp
+ *
+ * @brief Late latching: the frame starts, and reads its input, as late as it can while still making
+ * the next vertical blank, instead of right after the previous present; the mouse can be read again
+ * just before the last draw calls.
+ **/
+
+#ifndef LLATELATCH_HPP
+#define LLATELATCH_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief With VSync, the present returns at a vertical blank and the frame that follows, if it
+ * starts at once, reads an input that waits almost a whole refresh period before it is shown.
+ * "wait", called where the frame reads its input, holds the frame back until the next blank less
+ * the time the frame is expected to take and a safety margin, so that the same frame is shown at
+ * the same blank with the input read later.
+ *
+ * The time a frame takes, from "wait" to the present, is followed as LFramePacer follows its
+ * oversleep: it jumps up to a longer frame and slowly decays after shorter ones. A frame that misses
+ * its blank doubles the margin, up to a quarter of the period; the margin decays back afterwards.
+ * The wait is never longer than s_MAX_DELAY of the period, and sleeps with SDL_Delay only while
+ * more than s_SPIN_ms are left, spinning on the performance counter afterwards.
+ *
+ * "latchMouse", right before the draw calls that follow the cursor, pumps the events and reads the
+ * position of the mouse again; the events pumped stay queued for the next frame. "present" stands
+ * for PresentFrame and measures the latency, from the end of the wait to the end of the present,
+ * also when the latch is off: the two can be compared.
+ *
+ * Without VSync the wait still starts each frame a period after the previous present, and caps the
+ * frame rate to the period. Everything is called from the render thread.
+ **/
+class LLateLatch
+{
+public:
+
+  static constexpr double s_DEFAULT_PERIOD_s = 1.0 / 60.0;
+  static constexpr double s_MAX_DELAY        = 0.75;   // Of the period
+  static constexpr double s_MIN_MARGIN_s     = 0.001;
+  static constexpr double s_MISSED           = 1.5;    // Periods between presents that mean a blank was missed
+  static constexpr Uint32 s_SPIN_ms          = 2;
+
+  LLateLatch( void );
+
+  void   setEnabled       ( bool );
+  void   setPeriod        ( double );
+  bool   matchDisplay     ( SDL_Window* );
+  void   wait             ( void );
+  Uint32 latchMouse       ( int&, int& );
+  void   present          ( SDL_Renderer* );
+  void   report           ( void ) const;
+
+  bool   IsEnabled        ( void ) const;
+  double GetPeriod        ( void ) const;
+  double GetDelay         ( void ) const;
+  double GetWorkEstimate  ( void ) const;
+  double GetAverageLatency( void ) const;
+  Uint64 GetMissedFrames  ( void ) const;
+
+private:
+
+  double Seconds_Pvt( Uint64 ) const;
+
+  bool   m_IsEnabled;
+  Uint64 m_Frequency;     // Performance counter counts per second
+  Uint64 m_Period;        // Counts per refresh
+  Uint64 m_Work;          // Counts from the wait to the present, the recent longest
+  Uint64 m_Margin;        // Counts kept before the blank
+  Uint64 m_FrameStart;    // End of the last wait, 0 before the first one
+  Uint64 m_LastPresent;   // End of the last present, 0 before the first one
+  Uint64 m_Delay;         // Counts the last wait held the frame back
+  Uint64 m_LatencySum;    // Counts, over m_Frames
+  Uint64 m_Frames;
+  Uint64 m_Missed;
+};
+
+#endif // LLATELATCH_HPP
@@ -0,0 +1,511 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LLightMap.hpp"
+#include "LPerfHarness.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Division rounding towards minus infinity, so that the buffer stays aligned left and above
+ * the level too.
+ **/
+static int FloorDiv( int Value, int Divisor )
+{
+  return ( Value >= 0 ) ? Value / Divisor : -( ( -Value + Divisor - 1 ) / Divisor );
+}
+
+
+/***************************************************************************************************
+* LLightMap methods
+****************************************************************************************************/
+
+LLightMap::LLightMap( void )
+  : m_Pool_Ptr(nullptr), m_Sprite_Ptr(nullptr), m_Buffer_Ptr(nullptr), m_Static(), m_IsStaticCached(false),
+    m_StaticLights(), m_Lights(), m_Vertices(), m_Indices(), m_Ambient{ 0x00, 0x00, 0x00, 0xFF },
+    m_Camera{ 0, 0, 0, 0 }, m_ViewW(0), m_ViewH(0), m_Scale(1), m_BufferW(0), m_BufferH(0), m_DrawCalls(0)
+{;}
+
+
+LLightMap::~LLightMap( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Creates the light sprite, the buffer and, if the level fits in a texture at the scale of the
+ * buffer, the layer of the static lights. The ambient colour starts black.
+ *
+ * @param Pool   Where the targets come from; its renderer draws the lights.
+ * @param ViewW  Width of the view, in pixels.
+ * @param ViewH  Height of the view.
+ * @param LevelW Width of the level, in pixels, for the static lights.
+ * @param LevelH Height of the level.
+ * @param Scale  Pixels of the view per texel of the buffer.
+ * @return false if the renderer cannot draw into textures, or a texture could not be created.
+ **/
+bool LLightMap::create( LRenderTargetPool& Pool, int ViewW, int ViewH, int LevelW, int LevelH, int Scale )
+{
+  free();
+
+  SDL_Renderer* Renderer_Ptr = Pool.GetRenderer();
+
+  if ( Renderer_Ptr == nullptr || SDL_RenderTargetSupported( Renderer_Ptr ) == SDL_FALSE )
+  {
+    printf( "\nLLightMap: the renderer cannot draw into textures!" );
+    return false;
+  }
+  else if ( ViewW <= 0 || ViewH <= 0 || Scale <= 0 )
+  {
+    printf( "\nLLightMap: invalid view of %dx%d pixels, scale %d!", ViewW, ViewH, Scale );
+    return false;
+  }
+  else
+  {;}
+
+  m_Pool_Ptr = &Pool;
+  m_ViewW    = ViewW;
+  m_ViewH    = ViewH;
+  m_Scale    = Scale;
+
+  // The view starts up to Scale - 1 pixels past the texel it falls in
+  m_BufferW = ( ViewW + 2 * Scale - 2 ) / Scale;
+  m_BufferH = ( ViewH + 2 * Scale - 2 ) / Scale;
+
+  m_Buffer_Ptr = Pool.acquire( m_BufferW, m_BufferH );
+
+  if ( m_Buffer_Ptr == nullptr || !CreateSprite_Pvt( Renderer_Ptr ) )
+  {
+    free();
+    return false;
+  }
+  else
+  {;}
+
+  const int StaticW = ( SDL_max( LevelW, 1 ) + Scale - 1 ) / Scale;
+  const int StaticH = ( SDL_max( LevelH, 1 ) + Scale - 1 ) / Scale;
+
+  SDL_RendererInfo Info;
+
+  // A maximum of 0 means none
+  const bool Fits = ( SDL_GetRendererInfo( Renderer_Ptr, &Info ) == 0 ) &&
+                    ( Info.max_texture_width  == 0 || StaticW <= Info.max_texture_width  ) &&
+                    ( Info.max_texture_height == 0 || StaticH <= Info.max_texture_height );
+
+  m_IsStaticCached = Fits && m_Static.create( Pool, StaticW, StaticH, DrawStatic_Pvt, this );
+
+  if ( !m_IsStaticCached )
+  {
+    printf( "\nLLightMap: a level of %dx%d pixels does not fit a texture, static lights drawn every frame", LevelW, LevelH );
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Gives the targets back to the pool, and forgets the lights.
+ **/
+void LLightMap::free( void )
+{
+  m_Static.free();
+
+  if ( m_Pool_Ptr != nullptr && m_Buffer_Ptr != nullptr )
+  {
+    m_Pool_Ptr->release( m_Buffer_Ptr );
+  }
+  else
+  {;}
+
+  if ( m_Sprite_Ptr != nullptr )
+  {
+    SDL_DestroyTexture( m_Sprite_Ptr );
+  }
+  else
+  {;}
+
+  m_Pool_Ptr       = nullptr;
+  m_Sprite_Ptr     = nullptr;
+  m_Buffer_Ptr     = nullptr;
+  m_IsStaticCached = false;
+  m_BufferW        = 0;
+  m_BufferH        = 0;
+
+  m_StaticLights.clear();
+  m_Lights.clear();
+}
+
+
+/**
+ * @brief The light of the places no light reaches; black hides them, white shows the scene as it is.
+ **/
+void LLightMap::setAmbient( SDL_Color Ambient )
+{
+  m_Ambient = Ambient;
+}
+
+
+/**
+ * @return The index of the light, for "setStatic".
+ **/
+int LLightMap::addStatic( const Light& Added )
+{
+  m_StaticLights.push_back( Added );
+  m_Static.invalidate();
+
+  return static_cast<int>( m_StaticLights.size() ) - 1;
+}
+
+
+/**
+ * @brief Changes a static light; the layer is drawn again only if it really changed.
+ **/
+void LLightMap::setStatic( int Index, const Light& Changed )
+{
+  if ( Index < 0 || static_cast<size_t>( Index ) >= m_StaticLights.size() )
+  {
+    printf( "\nLLightMap: no static light %d!", Index );
+    return;
+  }
+  else
+  {;}
+
+  Light& Current = m_StaticLights[ static_cast<size_t>( Index ) ];
+
+  if ( Current.Centre.x != Changed.Centre.x || Current.Centre.y != Changed.Centre.y || Current.Radius != Changed.Radius ||
+       Current.Colour.r != Changed.Colour.r || Current.Colour.g != Changed.Colour.g || Current.Colour.b != Changed.Colour.b ||
+       Current.Colour.a != Changed.Colour.a )
+  {
+    Current = Changed;
+    m_Static.invalidate();
+  }
+  else
+  {;}
+}
+
+
+void LLightMap::clearStatic( void )
+{
+  m_StaticLights.clear();
+  m_Static.invalidate();
+}
+
+
+/**
+ * @brief The static lights are drawn again: for SDL_RENDER_TARGETS_RESET. The buffer is drawn every
+ * frame anyway.
+ **/
+void LLightMap::invalidate( void )
+{
+  m_Static.invalidate();
+}
+
+
+/**
+ * @brief Starts a frame: the area of the level in view, and no dynamic light yet.
+ **/
+void LLightMap::begin( const SDL_Rect& Camera )
+{
+  m_Camera = Camera;
+  m_Lights.clear();
+}
+
+
+/**
+ * @brief Adds a dynamic light to this frame; lights out of view cost nothing but the test.
+ **/
+void LLightMap::add( const Light& Added )
+{
+  m_Lights.push_back( Added );
+}
+
+
+/**
+ * @brief Draws the light buffer, the static lights first if they changed, and lays it over the view
+ * with one multiplying copy. The render target, draw colour and clip of the renderer are restored.
+ *
+ * @param x, y Where the view is in the current target.
+ **/
+void LLightMap::render( int x, int y )
+{
+  if ( m_Buffer_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_Renderer* Renderer_Ptr = m_Pool_Ptr->GetRenderer();
+  int           Copies       = 0;
+
+  // The lights add theirs in Flush_Pvt
+  m_DrawCalls = 0;
+
+  if ( m_IsStaticCached )
+  {
+    m_Static.update();
+  }
+  else
+  {;}
+
+  // The texel grid of the buffer falls on multiples of the scale in the level
+  const int      Left = FloorDiv( m_Camera.x, m_Scale );
+  const int      Top  = FloorDiv( m_Camera.y, m_Scale );
+  const SDL_Rect Area = { Left * m_Scale, Top * m_Scale, m_BufferW * m_Scale, m_BufferH * m_Scale };
+
+  SDL_Texture* Previous_Ptr = SDL_GetRenderTarget( Renderer_Ptr );
+  Uint8        r, g, b, a;
+
+  if ( SDL_SetRenderTarget( Renderer_Ptr, m_Buffer_Ptr ) != 0 )
+  {
+    printf( "\nUnable to draw the light buffer! SDL Error: \"%s\"", SDL_GetError() );
+    return;
+  }
+  else
+  {;}
+
+  SDL_GetRenderDrawColor( Renderer_Ptr, &r, &g, &b, &a );
+  SDL_SetRenderDrawColor( Renderer_Ptr, m_Ambient.r, m_Ambient.g, m_Ambient.b, 0xFF );
+  SDL_RenderClear( Renderer_Ptr );
+
+  if ( m_IsStaticCached )
+  {
+    const SDL_Rect Wanted = { Left, Top, m_BufferW, m_BufferH };
+    const SDL_Rect Layer  = { 0, 0, m_Static.GetWidth(), m_Static.GetHeight() };
+    SDL_Rect       Source;
+
+    if ( SDL_IntersectRect( &Wanted, &Layer, &Source ) == SDL_TRUE )
+    {
+      const SDL_Rect Destination = { Source.x - Left, Source.y - Top, Source.w, Source.h };
+
+      SDL_SetTextureBlendMode( m_Static.GetTexture(), SDL_BLENDMODE_ADD );
+      SDL_RenderCopy( Renderer_Ptr, m_Static.GetTexture(), &Source, &Destination );
+      ++Copies;
+    }
+    else
+    {;}
+  }
+  else
+  {
+    Queue_Pvt( m_StaticLights, Area );
+  }
+
+  Queue_Pvt( m_Lights, Area );
+  Flush_Pvt( Renderer_Ptr );
+
+  SDL_SetRenderTarget   ( Renderer_Ptr, Previous_Ptr );
+  SDL_SetRenderDrawColor( Renderer_Ptr, r, g, b, a );
+
+  // The buffer overhangs the view by less than two texels: clip it to the view
+  const SDL_Rect View        = { x, y, m_ViewW, m_ViewH };
+  const SDL_Rect Destination = { x + Area.x - m_Camera.x, y + Area.y - m_Camera.y, Area.w, Area.h };
+  const bool     WasClipped  = ( SDL_RenderIsClipEnabled( Renderer_Ptr ) == SDL_TRUE );
+  SDL_Rect       Clip;
+
+  SDL_RenderGetClipRect( Renderer_Ptr, &Clip );
+  SDL_RenderSetClipRect( Renderer_Ptr, &View );
+
+  SDL_SetTextureBlendMode( m_Buffer_Ptr, SDL_BLENDMODE_MOD );
+  SDL_RenderCopy( Renderer_Ptr, m_Buffer_Ptr, NULL, &Destination );
+  ++Copies;
+
+  SDL_RenderSetClipRect( Renderer_Ptr, WasClipped ? &Clip : NULL );
+
+  m_DrawCalls += Copies;
+  LPerfHarness::countDrawCalls( Copies );
+}
+
+
+bool LLightMap::IsCreated( void ) const
+{
+  return m_Buffer_Ptr != nullptr;
+}
+
+
+size_t LLightMap::GetStaticCount( void ) const
+{
+  return m_StaticLights.size();
+}
+
+
+const LLightMap::Light& LLightMap::GetStatic( int Index ) const
+{
+  return m_StaticLights[ static_cast<size_t>( Index ) ];
+}
+
+
+/**
+ * @return How many times the static lights were drawn into their layer.
+ **/
+int LLightMap::GetStaticDraws( void ) const
+{
+  return m_Static.GetDrawCount();
+}
+
+
+/**
+ * @return The draw calls of the last "render": the copies of the static layer and of the buffer,
+ * and those drawing lights.
+ **/
+int LLightMap::GetDrawCalls( void ) const
+{
+  return m_DrawCalls;
+}
+
+
+/**
+ * @brief The light sprite: white at the centre, fading as (1 - d²)² to black at the edge, and opaque,
+ * so that it adds the same whatever the alpha of the renderer's format.
+ **/
+bool LLightMap::CreateSprite_Pvt( SDL_Renderer* Renderer_Ptr )
+{
+  SDL_Surface* Surface_Ptr = SDL_CreateRGBSurfaceWithFormat( 0, s_SPRITE_SIZE, s_SPRITE_SIZE, 32, SDL_PIXELFORMAT_RGBA32 );
+
+  if ( Surface_Ptr == NULL )
+  {
+    printf( "\nUnable to create the light sprite! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const float Half = 0.5f * static_cast<float>( s_SPRITE_SIZE );
+
+  for ( int Row = 0; Row != s_SPRITE_SIZE; ++Row )
+  {
+    Uint32*     Pixels = reinterpret_cast<Uint32*>( static_cast<Uint8*>( Surface_Ptr->pixels ) + Row * Surface_Ptr->pitch );
+    const float dy     = ( static_cast<float>( Row ) + 0.5f - Half ) / Half;
+
+    for ( int Column = 0; Column != s_SPRITE_SIZE; ++Column )
+    {
+      const float dx       = ( static_cast<float>( Column ) + 0.5f - Half ) / Half;
+      const float Distance = SDL_min( dx * dx + dy * dy, 1.0f );
+      const float Falloff  = ( 1.0f - Distance ) * ( 1.0f - Distance );
+      const Uint8 Value    = static_cast<Uint8>( Falloff * 255.0f + 0.5f );
+
+      Pixels[Column] = SDL_MapRGBA( Surface_Ptr->format, Value, Value, Value, 0xFF );
+    }
+  }
+
+  m_Sprite_Ptr = SDL_CreateTextureFromSurface( Renderer_Ptr, Surface_Ptr );
+
+  SDL_FreeSurface( Surface_Ptr );
+
+  if ( m_Sprite_Ptr == NULL )
+  {
+    printf( "\nUnable to create the light texture! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_SetTextureBlendMode( m_Sprite_Ptr, SDL_BLENDMODE_ADD );
+
+  return true;
+}
+
+
+/**
+ * @brief Appends two triangles for each light overlapping an area of the level, in texels of the
+ * target the area covers; the intensity goes in the alpha of the vertices, which ADD multiplies.
+ **/
+void LLightMap::Queue_Pvt( const std::vector<Light>& Lights, const SDL_Rect& Area )
+{
+  const float Scale = static_cast<float>( m_Scale );
+  const float Right = static_cast<float>( Area.x + Area.w );
+  const float Below = static_cast<float>( Area.y + Area.h );
+
+  for ( const Light& Lamp : Lights )
+  {
+    if ( Lamp.Centre.x + Lamp.Radius <= static_cast<float>( Area.x ) || Lamp.Centre.x - Lamp.Radius >= Right ||
+         Lamp.Centre.y + Lamp.Radius <= static_cast<float>( Area.y ) || Lamp.Centre.y - Lamp.Radius >= Below ||
+         Lamp.Colour.a == 0 )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const float Left   = ( Lamp.Centre.x - Lamp.Radius - static_cast<float>( Area.x ) ) / Scale;
+    const float Top    = ( Lamp.Centre.y - Lamp.Radius - static_cast<float>( Area.y ) ) / Scale;
+    const float Side   = 2.0f * Lamp.Radius / Scale;
+    const int   First  = static_cast<int>( m_Vertices.size() );
+
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left       , Top        }, Lamp.Colour, SDL_FPoint{ 0.0f, 0.0f } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left + Side, Top        }, Lamp.Colour, SDL_FPoint{ 1.0f, 0.0f } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left + Side, Top + Side }, Lamp.Colour, SDL_FPoint{ 1.0f, 1.0f } } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{ Left       , Top + Side }, Lamp.Colour, SDL_FPoint{ 0.0f, 1.0f } } );
+
+    const int Corners[6] = { 0, 1, 2, 0, 2, 3 };
+
+    for ( const int Corner : Corners )
+    {
+      m_Indices.push_back( First + Corner );
+    }
+  }
+}
+
+
+/**
+ * @brief Draws the lights queued into the current target with one SDL_RenderGeometry, or one copy
+ * each if the renderer has none.
+ **/
+void LLightMap::Flush_Pvt( SDL_Renderer* Renderer_Ptr )
+{
+  int Calls = 0;
+
+  if ( m_Vertices.empty() )
+  {
+    return;
+  }
+  else if ( SDL_RenderGeometry( Renderer_Ptr, m_Sprite_Ptr, m_Vertices.data(), static_cast<int>( m_Vertices.size() ),
+                                m_Indices.data(), static_cast<int>( m_Indices.size() ) ) == 0 )
+  {
+    Calls = 1;
+  }
+  else
+  {
+    for ( size_t Corner = 0; Corner < m_Vertices.size(); Corner += 4 )
+    {
+      const SDL_Vertex& TopLeft     = m_Vertices[Corner];
+      const SDL_Vertex& BottomRight = m_Vertices[Corner + 2];
+      const SDL_FRect   Destination = { TopLeft.position.x, TopLeft.position.y,
+                                        BottomRight.position.x - TopLeft.position.x, BottomRight.position.y - TopLeft.position.y };
+
+      SDL_SetTextureColorMod( m_Sprite_Ptr, TopLeft.color.r, TopLeft.color.g, TopLeft.color.b );
+      SDL_SetTextureAlphaMod( m_Sprite_Ptr, TopLeft.color.a );
+      SDL_RenderCopyF( Renderer_Ptr, m_Sprite_Ptr, NULL, &Destination );
+      ++Calls;
+    }
+
+    SDL_SetTextureColorMod( m_Sprite_Ptr, 0xFF, 0xFF, 0xFF );
+    SDL_SetTextureAlphaMod( m_Sprite_Ptr, 0xFF );
+  }
+
+  m_Vertices.clear();
+  m_Indices.clear();
+
+  m_DrawCalls += Calls;
+  LPerfHarness::countDrawCalls( Calls );
+}
+
+
+/**
+ * @brief Draws the static lights into their layer, which covers the level from its top left corner.
+ **/
+void LLightMap::DrawStatic_Pvt( SDL_Renderer* Renderer_Ptr, void* Data_Ptr )
+{
+  LLightMap& Self = *static_cast<LLightMap*>( Data_Ptr );
+
+  Self.Queue_Pvt( Self.m_StaticLights, SDL_Rect{ 0, 0, Self.m_Static.GetWidth() * Self.m_Scale, Self.m_Static.GetHeight() * Self.m_Scale } );
+  Self.Flush_Pvt( Renderer_Ptr );
+}
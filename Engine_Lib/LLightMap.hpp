@@ -0,0 +1,96 @@
+/**
+ * @file LLightMap.hpp
+ *
+ * @brief 2D lighting: lights added into a low resolution light buffer, laid over the scene with one
+ * multiplying copy.
+ **/
+
+#ifndef LLIGHTMAP_HPP
+#define LLIGHTMAP_HPP
+
+#include "LRenderTargets.hpp"
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief The light falling on a scrolling level. Each light is a soft round sprite, added (blend mode
+ * ADD) into a light buffer s_DEFAULT_SCALE times smaller than the view, which starts from the ambient
+ * colour; the buffer is then stretched over the view with blend mode MOD, so that every pixel of the
+ * scene is multiplied by the light reaching it. Lights saturate at white: they reveal the scene, they
+ * do not brighten it.
+ *
+ * Static lights are in an LCachedLayer as large as the level, at the scale of the buffer, drawn
+ * again only after one of them changes; a frame copies the part in view. Dynamic lights are added
+ * every frame between "begin" and "render". Either kind is drawn with a single SDL_RenderGeometry
+ * for all of its lights in view, so dozens of lights cost a few draw calls, not a pass each. When
+ * the level is too large for a texture, the static lights are drawn with the dynamic ones.
+ *
+ * The buffer is aligned to multiples of the scale in the level, so that the light does not swim
+ * while the camera scrolls. Invalidate the map on SDL_RENDER_TARGETS_RESET.
+ **/
+class LLightMap
+{
+public:
+
+  static constexpr int s_DEFAULT_SCALE = 4;
+  static constexpr int s_SPRITE_SIZE   = 128;   // Side of the light sprite, in texels
+
+  struct Light
+  {
+    SDL_FPoint Centre;     // In the level, in pixels
+    float      Radius;     // In pixels; nothing is lit beyond it
+    SDL_Color  Colour;     // Alpha is the intensity
+  };
+
+  LLightMap( void );
+  ~LLightMap( void );
+
+  LLightMap( const LLightMap& )            = delete;
+  LLightMap& operator=( const LLightMap& ) = delete;
+
+  bool         create        ( LRenderTargetPool&, int, int, int, int, int = s_DEFAULT_SCALE );
+  void         free          ( void );
+  void         setAmbient    ( SDL_Color );
+  int          addStatic     ( const Light& );
+  void         setStatic     ( int, const Light& );
+  void         clearStatic   ( void );
+  void         invalidate    ( void );
+  void         begin         ( const SDL_Rect& );
+  void         add           ( const Light& );
+  void         render        ( int = 0, int = 0 );
+
+  bool         IsCreated     ( void ) const;
+  size_t       GetStaticCount( void ) const;
+  const Light& GetStatic     ( int ) const;
+  int          GetStaticDraws( void ) const;
+  int          GetDrawCalls  ( void ) const;
+
+private:
+
+  bool CreateSprite_Pvt( SDL_Renderer* );
+  void Queue_Pvt       ( const std::vector<Light>&, const SDL_Rect& );
+  void Flush_Pvt       ( SDL_Renderer* );
+
+  static void DrawStatic_Pvt( SDL_Renderer*, void* );
+
+  LRenderTargetPool*      m_Pool_Ptr;
+  SDL_Texture*            m_Sprite_Ptr;
+  SDL_Texture*            m_Buffer_Ptr;
+  LCachedLayer            m_Static;
+  bool                    m_IsStaticCached;   // Else the static lights are drawn every frame
+  std::vector<Light>      m_StaticLights;
+  std::vector<Light>      m_Lights;           // Of this frame
+  std::vector<SDL_Vertex> m_Vertices;
+  std::vector<int>        m_Indices;
+  SDL_Color               m_Ambient;
+  SDL_Rect                m_Camera;
+  int                     m_ViewW;            // In pixels
+  int                     m_ViewH;
+  int                     m_Scale;
+  int                     m_BufferW;          // In texels
+  int                     m_BufferH;
+  int                     m_DrawCalls;        // Of the last "render"
+};
+
+#endif // LLIGHTMAP_HPP
@@ -0,0 +1,260 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LLockStats.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define LLOCKSTATS_PAUSE() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+  #define LLOCKSTATS_PAUSE() __asm__ __volatile__( "yield" )
+#else
+  #define LLOCKSTATS_PAUSE() ((void)0)
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr double MS_IN_A_S = 1000.0;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static double TicksToSeconds( Uint64 Ticks )
+{
+  return static_cast<double>( Ticks ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @return The fraction of the acquisitions that had to wait.
+ **/
+double LLockStats::GetContention( void ) const
+{
+  return ( Acquisitions != 0 ) ? static_cast<double>( Contended ) / static_cast<double>( Acquisitions ) : 0.0;
+}
+
+
+/**
+ * @brief Prints the counters on one line, with the name of the lock.
+ **/
+void LLockStats::log( const char* Name ) const
+{
+  SDL_Log( "%s: %llu acquisitions, %llu contended (%.1f%%), %llu spins, waited %.3f ms (max %.3f ms), last owner %lu",
+           Name, static_cast<unsigned long long>( Acquisitions ), static_cast<unsigned long long>( Contended ),
+           GetContention() * 100.0, static_cast<unsigned long long>( Spins ), WaitSeconds * MS_IN_A_S,
+           MaxWaitSeconds * MS_IN_A_S, static_cast<unsigned long>( Owner ) );
+}
+
+
+/**
+ * @param Name Name of the lock in the reports; the string must outlive the lock.
+ **/
+LLockCounters::LLockCounters( const char* Name )
+  : m_Name(Name), m_Acquisitions(0), m_Contended(0), m_Spins(0), m_WaitTicks(0), m_MaxWaitTicks(0), m_Owner(0)
+{;}
+
+
+LLockStats LLockCounters::GetStats( void ) const
+{
+  LLockStats Stats;
+
+  Stats.Acquisitions   = m_Acquisitions.load( std::memory_order_relaxed );
+  Stats.Contended      = m_Contended   .load( std::memory_order_relaxed );
+  Stats.Spins          = m_Spins       .load( std::memory_order_relaxed );
+  Stats.WaitSeconds    = TicksToSeconds( m_WaitTicks   .load( std::memory_order_relaxed ) );
+  Stats.MaxWaitSeconds = TicksToSeconds( m_MaxWaitTicks.load( std::memory_order_relaxed ) );
+  Stats.Owner          = m_Owner       .load( std::memory_order_relaxed );
+
+  return Stats;
+}
+
+
+const char* LLockCounters::GetName( void ) const
+{
+  return m_Name;
+}
+
+
+void LLockCounters::resetStats( void )
+{
+  m_Acquisitions.store( 0, std::memory_order_relaxed );
+  m_Contended   .store( 0, std::memory_order_relaxed );
+  m_Spins       .store( 0, std::memory_order_relaxed );
+  m_WaitTicks   .store( 0, std::memory_order_relaxed );
+  m_MaxWaitTicks.store( 0, std::memory_order_relaxed );
+}
+
+
+void LLockCounters::logStats( void ) const
+{
+  GetStats().log( m_Name );
+}
+
+
+/**
+ * @brief Counts an acquisition by the calling thread.
+ **/
+void LLockCounters::Acquired_Pvt( void )
+{
+  m_Acquisitions.fetch_add( 1, std::memory_order_relaxed );
+  m_Owner.store( SDL_ThreadID(), std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Counts a contended acquisition: the failed attempts, if any, and the ticks it waited.
+ **/
+void LLockCounters::Waited_Pvt( Uint64 Spins, Uint64 Ticks )
+{
+  m_Contended.fetch_add( 1,     std::memory_order_relaxed );
+  m_Spins    .fetch_add( Spins, std::memory_order_relaxed );
+  m_WaitTicks.fetch_add( Ticks, std::memory_order_relaxed );
+
+  Uint64 MaxTicks = m_MaxWaitTicks.load( std::memory_order_relaxed );
+
+  while ( Ticks > MaxTicks && !m_MaxWaitTicks.compare_exchange_weak( MaxTicks, Ticks, std::memory_order_relaxed ) )
+  {;}
+}
+
+
+LSpinLock::LSpinLock( const char* Name )
+  : LLockCounters(Name), m_Lock(0)
+{;}
+
+
+void LSpinLock::lock( void )
+{
+  if ( SDL_AtomicTryLock( &m_Lock ) )
+  {
+    Acquired_Pvt();
+    return;
+  }
+  else
+  {;}
+
+  // Contended: back off between the attempts, and time the wait
+  const Uint64 Start  = SDL_GetPerformanceCounter();
+  Uint64       Spins  = 1;
+  Uint32       Pauses = 1;
+
+  while ( !SDL_AtomicTryLock( &m_Lock ) )
+  {
+    ++Spins;
+
+    if ( Pauses <= s_MAX_PAUSES )
+    {
+      for ( Uint32 i = 0; i != Pauses; ++i )
+      {
+        LLOCKSTATS_PAUSE();
+      }
+
+      Pauses *= 2;
+    }
+    else
+    {
+      // The owner is taking long, or is not running: give it the core
+      SDL_Delay(0);
+    }
+  }
+
+  Acquired_Pvt();
+  Waited_Pvt( Spins, SDL_GetPerformanceCounter() - Start );
+}
+
+
+bool LSpinLock::tryLock( void )
+{
+  if ( SDL_AtomicTryLock( &m_Lock ) )
+  {
+    Acquired_Pvt();
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+void LSpinLock::unlock( void )
+{
+  SDL_AtomicUnlock( &m_Lock );
+}
+
+
+/**
+ * @param InitialValue Number of threads that can hold the semaphore at once.
+ **/
+LSemaphore::LSemaphore( Uint32 InitialValue, const char* Name )
+  : LLockCounters(Name), m_Semaphore_Ptr( SDL_CreateSemaphore(InitialValue) )
+{;}
+
+
+LSemaphore::~LSemaphore( void )
+{
+  if ( m_Semaphore_Ptr != nullptr )
+  {
+    SDL_DestroySemaphore( m_Semaphore_Ptr );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @return false if the SDL semaphore could not be created (see SDL_GetError).
+ **/
+bool LSemaphore::isValid( void ) const
+{
+  return m_Semaphore_Ptr != nullptr;
+}
+
+
+void LSemaphore::wait( void )
+{
+  if ( SDL_SemTryWait( m_Semaphore_Ptr ) == 0 )
+  {
+    Acquired_Pvt();
+    return;
+  }
+  else
+  {;}
+
+  // Contended: the thread sleeps in the operating system, so spins do not apply
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  SDL_SemWait( m_Semaphore_Ptr );
+
+  Acquired_Pvt();
+  Waited_Pvt( 0, SDL_GetPerformanceCounter() - Start );
+}
+
+
+bool LSemaphore::tryWait( void )
+{
+  if ( SDL_SemTryWait( m_Semaphore_Ptr ) == 0 )
+  {
+    Acquired_Pvt();
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+void LSemaphore::post( void )
+{
+  SDL_SemPost( m_Semaphore_Ptr );
+}
@@ -0,0 +1,111 @@
+/**
+ * @file LLockStats.hpp
+ *
+ * @brief A spin lock and a semaphore that count how often, and for how long, threads wait for them:
+ * the data to decide whether a lock is worth removing.
+ **/
+
+#ifndef LLOCKSTATS_HPP
+#define LLOCKSTATS_HPP
+
+#include <SDL.h>
+#include <atomic>
+
+/**
+ * @brief Counters of a lock since it was created or last reset.
+ **/
+struct LLockStats
+{
+  Uint64       Acquisitions   = 0;
+  Uint64       Contended      = 0;    // Acquisitions that found the lock taken and had to wait
+  Uint64       Spins          = 0;    // Failed attempts of a spin lock, over all its acquisitions
+  double       WaitSeconds    = 0.0;  // Time spent waiting, over all the contended acquisitions
+  double       MaxWaitSeconds = 0.0;
+  SDL_threadID Owner          = 0;    // Thread that acquired the lock last
+
+  double GetContention( void ) const;
+  void   log          ( const char* ) const;
+};
+
+
+/**
+ * @brief Counters shared by the instrumented locks. They are atomic so that another thread can read
+ * them at any time; they are updated only by the threads that had to wait, apart from the count of
+ * acquisitions, so a lock nobody is contending for costs close to nothing more.
+ **/
+class LLockCounters
+{
+public:
+
+  LLockCounters( const char* );
+
+  LLockStats  GetStats ( void ) const;
+  const char* GetName  ( void ) const;
+  void        resetStats( void );
+  void        logStats ( void ) const;
+
+protected:
+
+  void Acquired_Pvt( void );
+  void Waited_Pvt  ( Uint64, Uint64 );
+
+private:
+
+  const char*                m_Name;
+  std::atomic<Uint64>        m_Acquisitions;
+  std::atomic<Uint64>        m_Contended;
+  std::atomic<Uint64>        m_Spins;
+  std::atomic<Uint64>        m_WaitTicks;      // Performance counter ticks
+  std::atomic<Uint64>        m_MaxWaitTicks;
+  std::atomic<SDL_threadID>  m_Owner;
+};
+
+
+/**
+ * @brief A spin lock, for critical sections of a few instructions, with exponential backoff: after a
+ * failed attempt it pauses the core for 1, 2, 4... up to s_MAX_PAUSES pause instructions before the
+ * next one, so that threads waiting for the lock do not keep stealing its cache line from the one
+ * holding it; past that, it yields the rest of its time slice between attempts.
+ **/
+class LSpinLock : public LLockCounters
+{
+public:
+
+  static constexpr Uint32 s_MAX_PAUSES = 64;
+
+  explicit LSpinLock( const char* = "Spin lock" );
+
+  void lock   ( void );
+  bool tryLock( void );
+  void unlock ( void );
+
+private:
+
+  SDL_SpinLock m_Lock;
+};
+
+
+/**
+ * @brief A semaphore that records the waits of "wait". It owns its SDL semaphore.
+ **/
+class LSemaphore : public LLockCounters
+{
+public:
+
+  explicit LSemaphore( Uint32, const char* = "Semaphore" );
+  ~LSemaphore( void );
+
+  LSemaphore( const LSemaphore& )            = delete;
+  LSemaphore& operator=( const LSemaphore& ) = delete;
+
+  bool isValid( void ) const;
+  void wait   ( void );
+  bool tryWait( void );
+  void post   ( void );
+
+private:
+
+  SDL_sem* m_Semaphore_Ptr;
+};
+
+#endif // LLOCKSTATS_HPP
@@ -0,0 +1,114 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LMappedFile.hpp"
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LMappedFile::LMappedFile( void )
+#if defined(_WIN32)
+  : m_File(INVALID_HANDLE_VALUE), m_Mapping(NULL), m_Data(NULL), m_Size(0)
+#else
+  : m_File(-1), m_Data(NULL), m_Size(0)
+#endif
+{;}
+
+
+LMappedFile::LMappedFile( const char* Path )
+  : LMappedFile()
+{
+  open( Path );
+}
+
+
+LMappedFile::~LMappedFile( void )
+{
+  close();
+}
+
+
+/**
+ * @return true if mapped; an empty file is not.
+ **/
+bool LMappedFile::open( const char* Path )
+{
+  close();
+
+#if defined(_WIN32)
+  m_File = CreateFileA( Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+
+  LARGE_INTEGER FileSize;
+
+  if ( m_File != INVALID_HANDLE_VALUE && GetFileSizeEx( m_File, &FileSize ) && FileSize.QuadPart > 0 )
+  {
+    m_Mapping = CreateFileMappingA( m_File, NULL, PAGE_READONLY, 0, 0, NULL );
+
+    if ( m_Mapping != NULL )
+    {
+      m_Data = static_cast<const Uint8*>( MapViewOfFile( m_Mapping, FILE_MAP_READ, 0, 0, 0 ) );
+      m_Size = ( m_Data != NULL ) ? static_cast<size_t>( FileSize.QuadPart ) : 0;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+#else
+  m_File = ::open( Path, O_RDONLY );
+
+  struct stat FileStatus;
+
+  if ( m_File >= 0 && fstat( m_File, &FileStatus ) == 0 && FileStatus.st_size > 0 )
+  {
+    void* Data = mmap( NULL, static_cast<size_t>( FileStatus.st_size ), PROT_READ, MAP_PRIVATE, m_File, 0 );
+
+    if ( Data != MAP_FAILED )
+    {
+      m_Data = static_cast<const Uint8*>( Data );
+      m_Size = static_cast<size_t>( FileStatus.st_size );
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+#endif
+
+  return m_Data != NULL;
+}
+
+
+void LMappedFile::close( void )
+{
+#if defined(_WIN32)
+  if ( m_Data != NULL )                 { UnmapViewOfFile( m_Data ); }  else {;}
+  if ( m_Mapping != NULL )              { CloseHandle( m_Mapping ); }   else {;}
+  if ( m_File != INVALID_HANDLE_VALUE ) { CloseHandle( m_File ); }      else {;}
+
+  m_File    = INVALID_HANDLE_VALUE;
+  m_Mapping = NULL;
+#else
+  if ( m_Data != NULL ) { munmap( const_cast<Uint8*>( m_Data ), m_Size ); } else {;}
+  if ( m_File >= 0 )    { ::close( m_File ); }                             else {;}
+
+  m_File = -1;
+#endif
+
+  m_Data = NULL;
+  m_Size = 0;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file LMappedFile.hpp
+ *
+ * @brief Read-only memory mapping of a whole file.
+ **/
+
+#ifndef LMAPPEDFILE_HPP
+#define LMAPPEDFILE_HPP
+
+#include <SDL.h>
+#include <cstddef>
+
+/**
+ * @brief Maps a whole file for reading, and releases it on destruction or on the next "open". The
+ * pages are read straight from the OS file cache, when first touched: no buffer is allocated and
+ * nothing is copied.
+ **/
+class LMappedFile
+{
+public:
+
+  LMappedFile( void );
+  explicit LMappedFile( const char* );
+  ~LMappedFile( void );
+
+  LMappedFile( const LMappedFile& )            = delete;
+  LMappedFile& operator=( const LMappedFile& ) = delete;
+
+  bool open ( const char* );
+  void close( void );
+
+  const Uint8* GetData( void ) const { return m_Data; }
+  size_t       GetSize( void ) const { return m_Size; }
+
+private:
+
+#if defined(_WIN32)
+  void*        m_File;      // HANDLE
+  void*        m_Mapping;   // HANDLE
+#else
+  int          m_File;
+#endif
+  const Uint8* m_Data;
+  size_t       m_Size;
+};
+
+#endif // LMAPPEDFILE_HPP
@@ -0,0 +1,203 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LMultiView.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return Value * Numerator / Denominator, without overflowing in between.
+ **/
+static int Scale( int Value, int Numerator, int Denominator )
+{
+  return static_cast<int>( static_cast<Sint64>( Value ) * Numerator / Denominator );
+}
+
+
+/**
+ * @brief Maps the part of a sprite that a view sees to the window: the piece of its clip to draw,
+ * and where.
+ *
+ * @param Bounds The sprite, in the world.
+ * @param Clip The sprite, in its texture.
+ * @return false if the view sees none of it.
+ **/
+static bool MapToView( const SDL_Rect& Bounds, const SDL_Rect& Clip, const LView& View, SDL_Rect& Source, SDL_Rect& Destination )
+{
+  SDL_Rect Seen;
+
+  if ( !SDL_IntersectRect( &Bounds, &View.Camera, &Seen ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Both ends are mapped, so that the cut pieces of neighbouring sprites meet without gaps
+  const int SeenRight  = Seen.x + Seen.w;
+  const int SeenBottom = Seen.y + Seen.h;
+
+  Source.x = Clip.x + Scale( Seen.x    - Bounds.x, Clip.w, Bounds.w );
+  Source.y = Clip.y + Scale( Seen.y    - Bounds.y, Clip.h, Bounds.h );
+  Source.w = Clip.x + Scale( SeenRight  - Bounds.x, Clip.w, Bounds.w ) - Source.x;
+  Source.h = Clip.y + Scale( SeenBottom - Bounds.y, Clip.h, Bounds.h ) - Source.y;
+
+  Destination.x = View.Viewport.x + Scale( Seen.x     - View.Camera.x, View.Viewport.w, View.Camera.w );
+  Destination.y = View.Viewport.y + Scale( Seen.y     - View.Camera.y, View.Viewport.h, View.Camera.h );
+  Destination.w = View.Viewport.x + Scale( SeenRight  - View.Camera.x, View.Viewport.w, View.Camera.w ) - Destination.x;
+  Destination.h = View.Viewport.y + Scale( SeenBottom - View.Camera.y, View.Viewport.h, View.Camera.h ) - Destination.y;
+
+  return Source.w > 0 && Source.h > 0 && Destination.w > 0 && Destination.h > 0;
+}
+
+
+/***************************************************************************************************
+* LMultiView methods
+****************************************************************************************************/
+
+/**
+ * @param World The area the sprites are in, for the spatial index.
+ * @param CellSize_px The side of a cell of the index.
+ **/
+LMultiView::LMultiView( const SDL_Rect& World, int CellSize_px )
+  : m_Grid(World, CellSize_px), m_Sprites(), m_Views(), m_Visible(), m_Found()
+{;}
+
+
+/**
+ * @param Camera The world area the view shows.
+ * @param Viewport Where, in the window.
+ * @return the index of the view; -1 if either rectangle is empty.
+ **/
+int LMultiView::addView( const SDL_Rect& Camera, const SDL_Rect& Viewport )
+{
+  if ( Camera.w <= 0 || Camera.h <= 0 || Viewport.w <= 0 || Viewport.h <= 0 )
+  {
+    printf( "\nUnable to add a view of %dx%d into %dx%d pixels!", Camera.w, Camera.h, Viewport.w, Viewport.h );
+    return -1;
+  }
+  else
+  {;}
+
+  m_Views.push_back( LView{ Camera, Viewport } );
+  m_Visible.push_back( 0 );
+
+  return static_cast<int>( m_Views.size() ) - 1;
+}
+
+
+/**
+ * @brief Moves a view's camera, e.g. to follow its player.
+ **/
+void LMultiView::setCamera( int View, const SDL_Rect& Camera )
+{
+  if ( View >= 0 && View < GetViewCount() && Camera.w > 0 && Camera.h > 0 )
+  {
+    m_Views[View].Camera = Camera;
+  }
+  else
+  {;}
+}
+
+
+void LMultiView::clearViews( void )
+{
+  m_Views.clear();
+  m_Visible.clear();
+}
+
+
+/**
+ * @brief Removes every sprite: a moving scene is added again every frame, as a LBroadPhase is.
+ **/
+void LMultiView::clearSprites( void )
+{
+  m_Grid.clear();
+  m_Sprites.clear();
+}
+
+
+/**
+ * @param Source_Texture The texture of the sprite; it must outlive the next render.
+ * @param Clip The sprite, in the texture.
+ * @param Bounds Where it is, in the world; scaled from Clip if the sizes differ.
+ * @return the index of the sprite.
+ **/
+int LMultiView::addSprite( const LTexture& Source_Texture, const SDL_Rect& Clip, const SDL_Rect& Bounds )
+{
+  m_Sprites.push_back( Sprite{ &Source_Texture, Clip } );
+
+  return m_Grid.add( Bounds );
+}
+
+
+/**
+ * @brief Draws every view: builds the index, culls each view against it, and flushes one batch.
+ *
+ * @param Batch Where the sprites are added; it is begun and flushed here.
+ * @param Renderer_Ptr As for LSpriteBatch::flush.
+ **/
+void LMultiView::render( LSpriteBatch& Batch, SDL_Renderer* Renderer_Ptr )
+{
+  m_Grid.build();
+  Batch.begin();
+
+  SDL_Rect Source;
+  SDL_Rect Destination;
+
+  for ( size_t View = 0; View != m_Views.size(); ++View )
+  {
+    m_Found.clear();
+    m_Grid.query( m_Views[View].Camera, m_Found );
+
+    // Back in the order the sprites were added, which the cells lose
+    std::sort( m_Found.begin(), m_Found.end() );
+
+    size_t Visible = 0;
+
+    for ( int Index : m_Found )
+    {
+      const Sprite& Drawn = m_Sprites[Index];
+
+      if ( MapToView( m_Grid.GetBounds( Index ), Drawn.Clip, m_Views[View], Source, Destination ) )
+      {
+        Batch.add( *Drawn.Texture_Ptr, Source, Destination );
+        ++Visible;
+      }
+      else
+      {;}
+    }
+
+    m_Visible[View] = Visible;
+  }
+
+  Batch.flush( Renderer_Ptr );
+}
+
+
+int LMultiView::GetViewCount( void ) const
+{
+  return static_cast<int>( m_Views.size() );
+}
+
+
+const LView& LMultiView::GetView( int View ) const
+{
+  return m_Views[View];
+}
+
+
+/**
+ * @return the sprites a view drew in the last render.
+ **/
+size_t LMultiView::GetVisible( int View ) const
+{
+  return m_Visible[View];
+}
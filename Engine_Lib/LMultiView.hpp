@@ -0,0 +1,73 @@
+/**
+ * @file LMultiView.hpp
+ *
+ * @brief Split screen: one scene of sprites seen by several cameras, each shown in a viewport of
+ * the window, culled against one shared spatial index and drawn through one sprite batch.
+ **/
+
+#ifndef LMULTIVIEW_HPP
+#define LMULTIVIEW_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "LCollision.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+
+/**
+ * @brief What a camera sees and where: the world area Camera is drawn into the window area
+ * Viewport, scaled if their sizes differ.
+ **/
+struct LView
+{
+  SDL_Rect Camera;
+  SDL_Rect Viewport;
+};
+
+
+/**
+ * @brief A scene of sprites, placed in world coordinates, seen by any number of views.
+ *
+ * "render" builds the spatial index of the scene once, queries it once per view, and adds what each
+ * view sees to a single LSpriteBatch, already moved, scaled and cut to the view's viewport on the
+ * CPU. The viewport of the renderer is never changed: the views share one flush, so every texture
+ * is bound and drawn once per frame whatever the number of views, where a SDL_RenderSetViewport per
+ * view would cost a full pass over the scene and a draw call per texture for each of them.
+ *
+ * Viewports should not overlap: the batch groups sprites by texture, so where they do, the order of
+ * the views is not kept. Sprites are drawn unrotated; within a view and a texture, in the order they
+ * were added.
+ **/
+class LMultiView
+{
+public:
+
+  LMultiView( const SDL_Rect&, int );
+
+  int  addView      ( const SDL_Rect&, const SDL_Rect& );
+  void setCamera    ( int, const SDL_Rect& );
+  void clearViews   ( void );
+  void clearSprites ( void );
+  int  addSprite    ( const LTexture&, const SDL_Rect&, const SDL_Rect& );
+  void render       ( LSpriteBatch&, SDL_Renderer* = nullptr );
+
+  int          GetViewCount ( void ) const;
+  const LView& GetView      ( int ) const;
+  size_t       GetVisible   ( int ) const;
+
+private:
+
+  struct Sprite
+  {
+    const LTexture* Texture_Ptr;
+    SDL_Rect        Clip;
+  };
+
+  LSpatialGrid        m_Grid;
+  std::vector<Sprite> m_Sprites;    // By the same index as their bounds in m_Grid
+  std::vector<LView>  m_Views;
+  std::vector<size_t> m_Visible;    // Per view, sprites drawn by the last render
+  std::vector<int>    m_Found;      // Results of a query; storage is kept between frames
+};
+
+#endif // LMULTIVIEW_HPP
@@ -0,0 +1,560 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LMusicStream.hpp"
+#include "LAssetPack.hpp"
+#include "LImaAdpcm.hpp"
+#include "LTrace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint16 WAVE_FORMAT_PCM        = 0x0001;
+static constexpr Uint16 WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static constexpr Uint16 WAVE_FORMAT_IMA_ADPCM  = 0x0011;
+static constexpr Uint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+static constexpr int    NUM_OF_CHANNELS   = 2;           // What the mixer takes: stereo, interleaved
+static constexpr size_t RAW_BYTES         = 16 * 1024;   // Read from the file at once
+static constexpr Uint32 DECODER_SLEEP_MS  = 10;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LMusicStream::LMusicStream( void )
+  : m_Chunks(), m_Decoded_Ptr(), m_Played_Ptr(), m_Current_Ptr(nullptr), m_Offset(0), m_File_Ptr(nullptr),
+    m_Converter_Ptr(nullptr), m_Encoding(0), m_Format(0), m_Channels(0), m_Frequency(0), m_BlockAlign(0), m_DataStart(0),
+    m_DataBytes(0), m_DataLeft(0), m_Raw(), m_Pcm(), m_IsLooping(false), m_IsSourceDone(false), m_DecoderEpoch(0),
+    m_Decoder_Ptr(nullptr), m_IsStopping(false), m_Epoch(0), m_EndOfEpoch(0), m_HasStarted(false), m_IsFinished(false),
+    m_Underruns(0)
+{;}
+
+
+LMusicStream::~LMusicStream( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Opens a track, decodes its first chunk and starts the decoder thread.
+ *
+ * @param Path WAV file, looked for in the default asset pack first.
+ * @param Frequency Of the mixer that plays it, LAudioMixer::GetFrequency.
+ * @param IsLooping Whether it starts again when it ends.
+ * @return true if the track can be played.
+ **/
+bool LMusicStream::open( const std::string& Path, int Frequency, bool IsLooping )
+{
+  close();
+
+  m_File_Ptr = LOpenAsset( Path );
+
+  if ( m_File_Ptr == nullptr )
+  {
+    printf( "\nUnable to open %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  if ( !ReadHeader_Pvt() )
+  {
+    printf( "\nUnable to stream %s: not a PCM or IMA ADPCM WAV file!", Path.c_str() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  m_Converter_Ptr = SDL_NewAudioStream( m_Format, static_cast<Uint8>( m_Channels ), m_Frequency,
+                                        AUDIO_F32SYS, NUM_OF_CHANNELS, Frequency );
+
+  if ( m_Converter_Ptr == nullptr )
+  {
+    printf( "\nUnable to convert %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  // Whole blocks, so that an ADPCM block is never split between two reads
+  const size_t Blocks = std::max( RAW_BYTES / m_BlockAlign, static_cast<size_t>( 1 ) );
+
+  m_Raw.resize( Blocks * m_BlockAlign );
+
+  if ( m_Encoding == WAVE_FORMAT_IMA_ADPCM )
+  {
+    const size_t FramesPerBlock = ImaBlockFrames( m_BlockAlign, m_Channels );
+
+    m_Pcm.resize( Blocks * FramesPerBlock * static_cast<size_t>( m_Channels ) );
+  }
+  else
+  {;}
+
+  // About s_RING_SECONDS of chunks, two at least: one playing while the other is decoded
+  const size_t NumOfChunks = std::max( static_cast<size_t>( Frequency * s_RING_SECONDS / s_CHUNK_FRAMES + 1.0 ), static_cast<size_t>( 2 ) );
+
+  m_Chunks.resize( NumOfChunks );
+  m_Decoded_Ptr.reset( new LSpscRing<Chunk*>( NumOfChunks ) );
+  m_Played_Ptr.reset ( new LSpscRing<Chunk*>( NumOfChunks ) );
+
+  for ( Chunk& Each : m_Chunks )
+  {
+    Each.Samples.resize( static_cast<size_t>( s_CHUNK_FRAMES ) * NUM_OF_CHANNELS );
+    Each.Frames = 0;
+    Each.Epoch  = 0;
+    m_Played_Ptr->push( &Each );
+  }
+
+  m_IsLooping    = IsLooping;
+  m_IsSourceDone = false;
+  m_DataLeft     = m_DataBytes;
+  m_DecoderEpoch = 0;
+  m_IsStopping.store( false, std::memory_order_relaxed );
+  m_Epoch.store( 0, std::memory_order_relaxed );
+  m_EndOfEpoch.store( 0, std::memory_order_relaxed );
+  m_HasStarted.store( false, std::memory_order_relaxed );
+  m_IsFinished.store( false, std::memory_order_relaxed );
+  m_Underruns.store( 0, std::memory_order_relaxed );
+
+  // The decoder is not running yet: the first chunk is decoded here, so playback starts at once
+  Chunk* First_Ptr = nullptr;
+
+  m_Played_Ptr->pop( First_Ptr );
+  Produce_Pvt( *First_Ptr );
+
+  m_Decoder_Ptr = SDL_CreateThread( Decoder_Pvt, "LMusicStream", this );
+
+  if ( m_Decoder_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the music decoder thread! SDL Error: %s", SDL_GetError() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Stops the decoder thread and closes the file. The mixer must not be playing the stream.
+ **/
+void LMusicStream::close( void )
+{
+  if ( m_Decoder_Ptr != nullptr )
+  {
+    m_IsStopping.store( true, std::memory_order_relaxed );
+    SDL_WaitThread( m_Decoder_Ptr, nullptr );
+    m_Decoder_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  if ( m_Converter_Ptr != nullptr )
+  {
+    SDL_FreeAudioStream( m_Converter_Ptr );
+    m_Converter_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  if ( m_File_Ptr != nullptr )
+  {
+    SDL_RWclose( m_File_Ptr );
+    m_File_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  m_Decoded_Ptr.reset();
+  m_Played_Ptr.reset();
+  m_Chunks.clear();
+  m_Raw.clear();
+  m_Pcm.clear();
+  m_Current_Ptr = nullptr;
+  m_Offset      = 0;
+}
+
+
+/**
+ * @brief Plays the track from the start at the next read, once its first chunk is decoded again.
+ * Nothing happens if nothing was read since it was opened or restarted.
+ **/
+void LMusicStream::restart( void )
+{
+  if ( m_Decoder_Ptr == nullptr || !m_HasStarted.load( std::memory_order_relaxed ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_HasStarted.store( false, std::memory_order_relaxed );
+  m_IsFinished.store( false, std::memory_order_relaxed );
+  m_Epoch.fetch_add( 1, std::memory_order_release );
+}
+
+
+/**
+ * @brief Audio callback only. Copies the next frames of the track, never waiting for the decoder.
+ *
+ * @param Out_Ptr Stereo float frames.
+ * @return Frames copied: fewer than asked for when the track has ended, or the decoder lags
+ *         behind; the rest of Out_Ptr is left alone.
+ **/
+size_t LMusicStream::read( float* Out_Ptr, size_t Frames )
+{
+  if ( m_Decoded_Ptr == nullptr )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  const Uint32 Epoch = m_Epoch.load( std::memory_order_acquire );
+  size_t       Done  = 0;
+
+  while ( Done != Frames )
+  {
+    if ( m_Current_Ptr == nullptr )
+    {
+      if ( !m_Decoded_Ptr->pop( m_Current_Ptr ) )
+      {
+        m_Current_Ptr = nullptr;
+
+        if ( m_EndOfEpoch.load( std::memory_order_acquire ) == Epoch + 1 )
+        {
+          m_IsFinished.store( true, std::memory_order_relaxed );
+        }
+        else
+        {
+          m_Underruns.fetch_add( 1, std::memory_order_relaxed );
+        }
+        break;
+      }
+      else
+      {
+        m_Offset = 0;
+      }
+    }
+    else
+    {;}
+
+    // Decoded before a restart
+    if ( m_Current_Ptr->Epoch != Epoch )
+    {
+      m_Played_Ptr->push( m_Current_Ptr );
+      m_Current_Ptr = nullptr;
+      continue;
+    }
+    else
+    {;}
+
+    const size_t Run = std::min( Frames - Done, m_Current_Ptr->Frames - m_Offset );
+
+    memcpy( Out_Ptr + Done * NUM_OF_CHANNELS, m_Current_Ptr->Samples.data() + m_Offset * NUM_OF_CHANNELS,
+            Run * NUM_OF_CHANNELS * sizeof(float) );
+
+    Done     += Run;
+    m_Offset += Run;
+
+    if ( m_Offset == m_Current_Ptr->Frames )
+    {
+      m_Played_Ptr->push( m_Current_Ptr );
+      m_Current_Ptr = nullptr;
+    }
+    else
+    {;}
+  }
+
+  if ( Done != 0 )
+  {
+    m_HasStarted.store( true, std::memory_order_relaxed );
+  }
+  else
+  {;}
+
+  return Done;
+}
+
+
+bool LMusicStream::IsOpen( void ) const
+{
+  return m_Decoder_Ptr != nullptr;
+}
+
+
+/**
+ * @return Whether a track that does not loop has been played to its end.
+ **/
+bool LMusicStream::IsFinished( void ) const
+{
+  return m_IsFinished.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Reads that found no decoded chunk, the track not being over.
+ **/
+Uint64 LMusicStream::GetUnderruns( void ) const
+{
+  return m_Underruns.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Bytes held for the track: decoded chunks and read buffers.
+ **/
+size_t LMusicStream::GetMemoryBytes( void ) const
+{
+  return m_Chunks.size() * static_cast<size_t>( s_CHUNK_FRAMES ) * NUM_OF_CHANNELS * sizeof(float)
+         + m_Raw.size() + m_Pcm.size() * sizeof(Sint16);
+}
+
+
+int SDLCALL LMusicStream::Decoder_Pvt( void* Stream_Ptr )
+{
+  LMusicStream& Self = *static_cast<LMusicStream*>( Stream_Ptr );
+
+  LTrace::nameThread( "LMusicStream" );
+
+  while ( !Self.m_IsStopping.load( std::memory_order_relaxed ) )
+  {
+    const Uint32 Epoch = Self.m_Epoch.load( std::memory_order_acquire );
+
+    if ( Epoch != Self.m_DecoderEpoch )
+    {
+      Self.m_DecoderEpoch = Epoch;
+      Self.Rewind_Pvt();
+    }
+    else
+    {;}
+
+    const bool HasMore = !Self.m_IsSourceDone || SDL_AudioStreamAvailable( Self.m_Converter_Ptr ) > 0;
+    Chunk*     Free_Ptr = nullptr;
+
+    if ( HasMore && Self.m_Played_Ptr->pop( Free_Ptr ) )
+    {
+      LTrace::Zone Traced( "Music decode" );
+      Self.Produce_Pvt( *Free_Ptr );
+    }
+    else
+    {
+      SDL_Delay( DECODER_SLEEP_MS );
+    }
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Reads the header up to the samples, which the file is left at.
+ *
+ * @return false if the file is not a WAV the stream can decode.
+ **/
+bool LMusicStream::ReadHeader_Pvt( void )
+{
+  char Id[4];
+
+  if ( SDL_RWread( m_File_Ptr, Id, 4, 1 ) != 1 || memcmp( Id, "RIFF", 4 ) != 0
+       || SDL_RWseek( m_File_Ptr, 4, RW_SEEK_CUR ) < 0
+       || SDL_RWread( m_File_Ptr, Id, 4, 1 ) != 1 || memcmp( Id, "WAVE", 4 ) != 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  bool HasFormat = false;
+
+  while ( SDL_RWread( m_File_Ptr, Id, 4, 1 ) == 1 )
+  {
+    const Uint32 Size = SDL_ReadLE32( m_File_Ptr );
+
+    if ( memcmp( Id, "data", 4 ) == 0 )
+    {
+      m_DataStart = SDL_RWtell( m_File_Ptr );
+      m_DataBytes = Size;
+      return HasFormat && m_DataStart >= 0;
+    }
+    else if ( memcmp( Id, "fmt ", 4 ) == 0 && Size >= 16 )
+    {
+      m_Encoding  = SDL_ReadLE16( m_File_Ptr );
+      m_Channels  = SDL_ReadLE16( m_File_Ptr );
+      m_Frequency = static_cast<int>( SDL_ReadLE32( m_File_Ptr ) );
+      SDL_ReadLE32( m_File_Ptr );                                   // Bytes per second
+      m_BlockAlign = SDL_ReadLE16( m_File_Ptr );
+
+      const Uint16 Bits = SDL_ReadLE16( m_File_Ptr );
+      Uint32       Read = 16;
+
+      // The encoding of an extensible format is in the first two bytes of its sub-format
+      if ( m_Encoding == WAVE_FORMAT_EXTENSIBLE && Size >= 40 )
+      {
+        SDL_ReadLE16( m_File_Ptr );                                 // Extension size
+        SDL_ReadLE16( m_File_Ptr );                                 // Valid bits
+        SDL_ReadLE32( m_File_Ptr );                                 // Channel mask
+        m_Encoding = SDL_ReadLE16( m_File_Ptr );
+        Read       = 26;
+      }
+      else
+      {;}
+
+      m_Format = ( m_Encoding == WAVE_FORMAT_PCM        && Bits == 8  ) ? AUDIO_U8
+               : ( m_Encoding == WAVE_FORMAT_PCM        && Bits == 16 ) ? AUDIO_S16LSB
+               : ( m_Encoding == WAVE_FORMAT_PCM        && Bits == 32 ) ? AUDIO_S32LSB
+               : ( m_Encoding == WAVE_FORMAT_IEEE_FLOAT && Bits == 32 ) ? AUDIO_F32LSB
+               : ( m_Encoding == WAVE_FORMAT_IMA_ADPCM  && Bits == 4  ) ? AUDIO_S16SYS
+               : 0;
+
+      HasFormat = m_Format != 0 && m_Channels > 0 && m_Channels <= IMA_MAX_CHANNELS && m_Frequency > 0 && m_BlockAlign != 0
+                  && ( m_Encoding != WAVE_FORMAT_IMA_ADPCM || m_BlockAlign > 4 * m_Channels );
+
+      if ( !HasFormat || SDL_RWseek( m_File_Ptr, ( Size - Read ) + ( Size & 1 ), RW_SEEK_CUR ) < 0 )
+      {
+        return false;
+      }
+      else
+      {;}
+    }
+    else if ( SDL_RWseek( m_File_Ptr, static_cast<Sint64>( Size ) + ( Size & 1 ), RW_SEEK_CUR ) < 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Converts the track until a chunk is full, or the track is over.
+ *
+ * @param Out_Ptr s_CHUNK_FRAMES stereo float frames.
+ * @return Frames converted.
+ **/
+size_t LMusicStream::Decode_Pvt( float* Out_Ptr )
+{
+  const int Wanted = s_CHUNK_FRAMES * NUM_OF_CHANNELS * static_cast<int>( sizeof(float) );
+
+  while ( SDL_AudioStreamAvailable( m_Converter_Ptr ) < Wanted && Feed_Pvt() )
+  {;}
+
+  const int Got = SDL_AudioStreamGet( m_Converter_Ptr, Out_Ptr, Wanted );
+
+  return ( Got > 0 ) ? static_cast<size_t>( Got ) / ( NUM_OF_CHANNELS * sizeof(float) ) : 0;
+}
+
+
+/**
+ * @brief Reads the next piece of the file into the converter, going back to the start of the
+ * samples at the end of a looping track.
+ *
+ * @return false once everything has been handed to the converter, and flushed.
+ **/
+bool LMusicStream::Feed_Pvt( void )
+{
+  if ( m_IsSourceDone )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  if ( m_DataLeft == 0 && m_IsLooping && m_DataBytes != 0 )
+  {
+    // The converter keeps its state: no gap at the loop point
+    SDL_RWseek( m_File_Ptr, m_DataStart, RW_SEEK_SET );
+    m_DataLeft = m_DataBytes;
+  }
+  else
+  {;}
+
+  const size_t Bytes = static_cast<size_t>( std::min( static_cast<Uint64>( m_Raw.size() ), m_DataLeft ) );
+  const size_t Read  = ( Bytes != 0 ) ? SDL_RWread( m_File_Ptr, m_Raw.data(), 1, Bytes ) : 0;
+
+  if ( Read == 0 )
+  {
+    if ( m_DataLeft != 0 )
+    {
+      printf( "\nMusic stream: the file ends before its samples do!" );
+    }
+    else
+    {;}
+
+    SDL_AudioStreamFlush( m_Converter_Ptr );
+    m_IsSourceDone = true;
+    return false;
+  }
+  else
+  {;}
+
+  m_DataLeft -= Read;
+
+  if ( m_Encoding == WAVE_FORMAT_IMA_ADPCM )
+  {
+    size_t Frames = 0;
+
+    for ( size_t Start = 0; Start < Read; Start += m_BlockAlign )
+    {
+      Frames += DecodeImaBlock( m_Raw.data() + Start, std::min( static_cast<size_t>( m_BlockAlign ), Read - Start ), m_Channels,
+                                m_Pcm.data() + Frames * static_cast<size_t>( m_Channels ) );
+    }
+
+    SDL_AudioStreamPut( m_Converter_Ptr, m_Pcm.data(), static_cast<int>( Frames * static_cast<size_t>( m_Channels ) * sizeof(Sint16) ) );
+  }
+  else
+  {
+    SDL_AudioStreamPut( m_Converter_Ptr, m_Raw.data(), static_cast<int>( Read ) );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Goes back to the first sample, dropping what the converter holds.
+ **/
+void LMusicStream::Rewind_Pvt( void )
+{
+  SDL_RWseek( m_File_Ptr, m_DataStart, RW_SEEK_SET );
+  SDL_AudioStreamClear( m_Converter_Ptr );
+
+  m_DataLeft     = m_DataBytes;
+  m_IsSourceDone = false;
+}
+
+
+/**
+ * @brief Decodes into a chunk, hands it to the callback, and flags the last chunk of the track.
+ **/
+void LMusicStream::Produce_Pvt( Chunk& Target )
+{
+  Target.Epoch  = m_DecoderEpoch;
+  Target.Frames = Decode_Pvt( Target.Samples.data() );
+
+  m_Decoded_Ptr->push( &Target );
+
+  if ( m_IsSourceDone && SDL_AudioStreamAvailable( m_Converter_Ptr ) == 0 )
+  {
+    m_EndOfEpoch.store( m_DecoderEpoch + 1, std::memory_order_release );
+  }
+  else
+  {;}
+}
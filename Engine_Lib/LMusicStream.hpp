@@ -0,0 +1,106 @@
+/**
+ * @file LMusicStream.hpp
+ *
+ * @brief Music decoded a chunk at a time on a thread of its own, for LAudioMixer: a track costs
+ * about a second of samples in memory, however long it is, and starts after its first chunk.
+ **/
+
+#ifndef LMUSICSTREAM_HPP
+#define LMUSICSTREAM_HPP
+
+#include "LRingBuffer.hpp"
+
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A WAV track, PCM (8, 16 or 32-bit integer, 32-bit float) or IMA ADPCM, 4 bits a sample,
+ * read from the default asset pack if it holds it. "open" decodes the first chunk, s_CHUNK_FRAMES
+ * converted to the format of the mixer, 32-bit float stereo at its frequency, then starts a decoder
+ * thread that keeps about s_RING_SECONDS decoded ahead.
+ *
+ * The chunks are allocated by "open" and then passed around through two lock-free rings: decoded
+ * ones to the mixer, played ones back. "read", which only the audio callback calls, copies out of
+ * them and never waits: if the decoder lags behind, what is missing is left to the caller, and
+ * counted. A looping track goes back to its start without a gap, the converter keeping its state.
+ *
+ * "restart" makes the track play again from the start: the chunks already decoded are tagged with
+ * an older generation and dropped by "read". "open", "close" and "restart" are called from one
+ * thread, usually the main one; the stream must stay open while the mixer plays it.
+ **/
+class LMusicStream
+{
+public:
+
+  static constexpr int    s_CHUNK_FRAMES = 4096;   // Decoded at once
+  static constexpr double s_RING_SECONDS = 1.0;
+
+  LMusicStream( void );
+  ~LMusicStream( void );
+
+  LMusicStream( const LMusicStream& )            = delete;
+  LMusicStream& operator=( const LMusicStream& ) = delete;
+
+  bool   open          ( const std::string&, int, bool = true );
+  void   close         ( void );
+  void   restart       ( void );
+  size_t read          ( float*, size_t );
+
+  bool   IsOpen        ( void ) const;
+  bool   IsFinished    ( void ) const;
+  Uint64 GetUnderruns  ( void ) const;
+  size_t GetMemoryBytes( void ) const;
+
+private:
+
+  struct Chunk
+  {
+    std::vector<float> Samples;   // s_CHUNK_FRAMES stereo frames
+    size_t             Frames;    // Decoded; fewer in the last chunk of a track
+    Uint32             Epoch;     // Generation it was decoded for
+  };
+
+  static int SDLCALL Decoder_Pvt( void* );
+
+  bool   ReadHeader_Pvt( void );
+  size_t Decode_Pvt    ( float* );
+  bool   Feed_Pvt      ( void );
+  void   Rewind_Pvt    ( void );
+  void   Produce_Pvt   ( Chunk& );
+
+  std::vector<Chunk>                   m_Chunks;
+  std::unique_ptr< LSpscRing<Chunk*> > m_Decoded_Ptr;     // Decoder to callback
+  std::unique_ptr< LSpscRing<Chunk*> > m_Played_Ptr;      // Callback to decoder
+  Chunk*                               m_Current_Ptr;     // Being played; callback only
+  size_t                               m_Offset;          // In it, in frames
+
+  // Source; decoder only once the thread runs
+  SDL_RWops*                           m_File_Ptr;
+  SDL_AudioStream*                     m_Converter_Ptr;
+  Uint16                               m_Encoding;        // WAVE_FORMAT_* of the data
+  SDL_AudioFormat                      m_Format;          // Of the PCM handed to the converter
+  int                                  m_Channels;
+  int                                  m_Frequency;
+  Uint16                               m_BlockAlign;
+  Sint64                               m_DataStart;       // Offset of the samples in the file
+  Uint64                               m_DataBytes;
+  Uint64                               m_DataLeft;
+  std::vector<Uint8>                   m_Raw;             // Read at once, in whole blocks
+  std::vector<Sint16>                  m_Pcm;             // ADPCM decoded
+  bool                                 m_IsLooping;
+  bool                                 m_IsSourceDone;    // Everything handed to the converter
+  Uint32                               m_DecoderEpoch;
+
+  SDL_Thread*                          m_Decoder_Ptr;
+  std::atomic<bool>                    m_IsStopping;
+  std::atomic<Uint32>                  m_Epoch;           // Bumped by "restart"
+  std::atomic<Uint32>                  m_EndOfEpoch;      // Epoch + 1 whose last chunk is decoded; 0 if none
+  std::atomic<bool>                    m_HasStarted;      // Something was read since "restart"
+  std::atomic<bool>                    m_IsFinished;      // And played
+  std::atomic<Uint64>                  m_Underruns;       // Reads that found no chunk ready
+};
+
+#endif // LMUSICSTREAM_HPP
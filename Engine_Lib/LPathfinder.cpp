@@ -0,0 +1,808 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LPathfinder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Cost of the shortest way between two cells of an empty grid: diagonal steps as long as
+ * both coordinates change, then straight ones. It never overestimates, as A* needs.
+ **/
+static int Distance( int x0, int y0, int x1, int y1 )
+{
+  const int dx = std::abs( x1 - x0 );
+  const int dy = std::abs( y1 - y0 );
+
+  return LPathfinder::s_DIAGONAL * std::min( dx, dy ) + LPathfinder::s_STRAIGHT * std::abs( dx - dy );
+}
+
+
+static int Sign( int Value )
+{
+  return ( Value > 0 ) - ( Value < 0 );
+}
+
+
+/**
+ * @return The cache key of a path: the cells of its start and goal.
+ **/
+static Uint64 Key( Uint32 Width, const SDL_Point& Start, const SDL_Point& Goal )
+{
+  return ( Uint64( static_cast<Uint32>( Start.y ) * Width + static_cast<Uint32>( Start.x ) ) << 32 ) |
+           Uint64( static_cast<Uint32>( Goal.y  ) * Width + static_cast<Uint32>( Goal.x  ) );
+}
+
+
+/**
+ * @brief Grows a box of cells to hold one more.
+ **/
+static void Grow( SDL_Rect& Box, int x, int y )
+{
+  const int Left   = std::min( Box.x, x );
+  const int Top    = std::min( Box.y, y );
+  const int Right  = std::max( Box.x + Box.w, x + 1 );
+  const int Bottom = std::max( Box.y + Box.h, y + 1 );
+
+  Box = SDL_Rect{ Left, Top, Right - Left, Bottom - Top };
+}
+
+
+/***************************************************************************************************
+* LPathfinder methods
+****************************************************************************************************/
+
+/**
+ * @return true outside the grid, so that the searches never leave it.
+ **/
+bool LPathfinder::Grid::isBlocked( int x, int y ) const
+{
+  if ( x < 0 || y < 0 || x >= Width || y >= Height )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  const size_t Cell = static_cast<size_t>( y ) * static_cast<size_t>( Width ) + static_cast<size_t>( x );
+
+  return ( ( Cells_Ptr[Cell >> 6] >> ( Cell & 63 ) ) & 1 ) != 0;
+}
+
+
+/**
+ * @brief Makes Bits hold the cells, copying them if the grid was made on cells it does not own, and
+ * points Cells_Ptr to them again, as a copied grid still points to the cells of the original.
+ **/
+void LPathfinder::Grid::own( void )
+{
+  if ( Bits.empty() )
+  {
+    const size_t Cells = static_cast<size_t>( Width ) * static_cast<size_t>( Height );
+
+    Bits.assign( Cells_Ptr, Cells_Ptr + ( Cells + 63 ) / 64 );
+  }
+  else
+  {;}
+
+  Cells_Ptr = Bits.data();
+}
+
+
+LPathfinder::LPathfinder( void )
+  : m_Grid_Ptr(), m_Jobs_Ptr(nullptr), m_Running(), m_Spare(), m_Ready(), m_Cache(),
+    m_Version(0), m_Clock(0), m_CacheHits(0), m_Searches(0)
+{;}
+
+
+LPathfinder::~LPathfinder( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Makes a grid of free cells, replacing the previous one.
+ *
+ * @param Jobs The pool solving the batches; without one they are solved by "request".
+ * @return false if the size is not valid.
+ **/
+bool LPathfinder::create( int Width, int Height, LJobSystem* Jobs_Ptr )
+{
+  free();
+
+  if ( Width <= 0 || Height <= 0 || static_cast<Uint64>( Width ) * static_cast<Uint64>( Height ) > SDL_MAX_UINT32 )
+  {
+    printf( "\nLPathfinder: invalid grid of %dx%d cells!", Width, Height );
+    return false;
+  }
+  else
+  {;}
+
+  const size_t Cells = static_cast<size_t>( Width ) * static_cast<size_t>( Height );
+
+  m_Grid_Ptr = std::make_shared<Grid>( Grid{ Width, Height, std::vector<Uint64>( ( Cells + 63 ) / 64, 0 ), nullptr } );
+  m_Grid_Ptr->Cells_Ptr = m_Grid_Ptr->Bits.data();
+  m_Jobs_Ptr = Jobs_Ptr;
+
+  return true;
+}
+
+
+/**
+ * @brief Makes a grid on cells it does not own, as those handed out by GetCells and saved in a
+ * file now mapped: nothing is copied or read, whatever the size of the grid, until the first
+ * "setBlocked" copies the cells.
+ *
+ * @param Cells_Ptr The cells, row after row, a set bit for a blocked one. They must stay valid until
+ *                  "free" or the next "create": batches queued before the copy still read them.
+ * @param Count     Of Cells_Ptr, in words: the grid is not made if it does not match the size.
+ **/
+bool LPathfinder::create( int Width, int Height, const Uint64* Cells_Ptr, size_t Count, LJobSystem* Jobs_Ptr )
+{
+  free();
+
+  const Uint64 Cells = static_cast<Uint64>( Width ) * static_cast<Uint64>( Height );
+
+  if ( Width <= 0 || Height <= 0 || Cells > SDL_MAX_UINT32 || Cells_Ptr == nullptr || Count != ( Cells + 63 ) / 64 )
+  {
+    printf( "\nLPathfinder: invalid grid of %dx%d cells in %u words!", Width, Height, static_cast<unsigned>( Count ) );
+    return false;
+  }
+  else
+  {;}
+
+  m_Grid_Ptr = std::make_shared<Grid>( Grid{ Width, Height, std::vector<Uint64>(), Cells_Ptr } );
+  m_Jobs_Ptr = Jobs_Ptr;
+
+  return true;
+}
+
+
+/**
+ * @brief Waits for the batches still queued, and drops them with the grid and the cache.
+ **/
+void LPathfinder::free( void )
+{
+  wait();
+
+  m_Running.clear();
+  m_Spare.clear();
+  m_Ready.clear();
+  m_Cache.clear();
+  m_Grid_Ptr.reset();
+  m_Jobs_Ptr = nullptr;
+}
+
+
+/**
+ * @brief Blocks or frees a cell, and drops the cached paths whose search looked at it.
+ **/
+void LPathfinder::setBlocked( int x, int y, bool Blocked )
+{
+  if ( !m_Grid_Ptr || x < 0 || y < 0 || x >= m_Grid_Ptr->Width || y >= m_Grid_Ptr->Height )
+  {
+    printf( "\nLPathfinder: cell %d, %d is outside the grid!", x, y );
+    return;
+  }
+  else if ( m_Grid_Ptr->isBlocked( x, y ) == Blocked )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // Queued batches keep the grid they were given
+  if ( m_Grid_Ptr.use_count() > 1 )
+  {
+    m_Grid_Ptr = std::make_shared<Grid>( *m_Grid_Ptr );
+  }
+  else
+  {;}
+
+  m_Grid_Ptr->own();
+
+  const size_t Cell = static_cast<size_t>( y ) * static_cast<size_t>( m_Grid_Ptr->Width ) + static_cast<size_t>( x );
+
+  m_Grid_Ptr->Bits[Cell >> 6] ^= Uint64(1) << ( Cell & 63 );
+
+  ++m_Version;
+
+  const SDL_Point Point = { x, y };
+
+  for ( auto It = m_Cache.begin(); It != m_Cache.end(); )
+  {
+    if ( SDL_PointInRect( &Point, &It->second.Reads ) )
+    {
+      It = m_Cache.erase( It );
+    }
+    else
+    {
+      ++It;
+    }
+  }
+}
+
+
+/**
+ * @return Whether a cell is blocked; the cells outside the grid are.
+ **/
+bool LPathfinder::isBlocked( int x, int y ) const
+{
+  return !m_Grid_Ptr || m_Grid_Ptr->isBlocked( x, y );
+}
+
+
+/**
+ * @brief Queues a batch of requests. Those in the cache, or with a cell outside the grid, are
+ * answered by the next "collect"; the others are split in jobs of s_REQUESTS_PER_JOB.
+ **/
+void LPathfinder::request( const std::vector<Request>& Requests )
+{
+  if ( !m_Grid_Ptr )
+  {
+    printf( "\nLPathfinder: requests without a grid!" );
+    return;
+  }
+  else
+  {;}
+
+  const Uint32 Width  = static_cast<Uint32>( m_Grid_Ptr->Width );
+  const int    Height = m_Grid_Ptr->Height;
+  Batch*       Current_Ptr = nullptr;
+
+  for ( const Request& Wanted : Requests )
+  {
+    if ( Wanted.Start.x < 0 || Wanted.Start.y < 0 || Wanted.Start.x >= m_Grid_Ptr->Width || Wanted.Start.y >= Height ||
+         Wanted.Goal.x  < 0 || Wanted.Goal.y  < 0 || Wanted.Goal.x  >= m_Grid_Ptr->Width || Wanted.Goal.y  >= Height )
+    {
+      m_Ready.push_back( Result{ Wanted.Id, false, 0, std::vector<SDL_Point>() } );
+      continue;
+    }
+    else
+    {;}
+
+    const auto It = m_Cache.find( Key( Width, Wanted.Start, Wanted.Goal ) );
+
+    if ( It != m_Cache.end() )
+    {
+      It->second.LastUse = ++m_Clock;
+      m_Ready.push_back( It->second.Path );
+      m_Ready.back().Id = Wanted.Id;
+      ++m_CacheHits;
+      continue;
+    }
+    else
+    {;}
+
+    if ( Current_Ptr == nullptr )
+    {
+      Current_Ptr = NewBatch_Pvt();
+    }
+    else
+    {;}
+
+    Current_Ptr->Requests.push_back( Wanted );
+
+    if ( Current_Ptr->Requests.size() == s_REQUESTS_PER_JOB )
+    {
+      Launch_Pvt( *Current_Ptr );
+      Current_Ptr = nullptr;
+    }
+    else
+    {;}
+  }
+
+  if ( Current_Ptr != nullptr )
+  {
+    Launch_Pvt( *Current_Ptr );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Hands out the results done since the last call: the cache hits, and the batches their jobs
+ * finished, whose paths go in the cache if the grid has not changed since they were queued.
+ *
+ * @param Results Replaced by them, in no particular order; match them by Id.
+ **/
+void LPathfinder::collect( std::vector<Result>& Results )
+{
+  Results.clear();
+  Results.swap( m_Ready );
+
+  for ( size_t i = 0; i != m_Running.size(); )
+  {
+    if ( !m_Running[i]->Solving.isDone() )
+    {
+      ++i;
+      continue;
+    }
+    else
+    {;}
+
+    Batch& Done = *m_Running[i];
+
+    for ( size_t Path = 0; Path != Done.Results.size(); ++Path )
+    {
+      if ( Done.Version == m_Version )
+      {
+        const Request& Wanted = Done.Requests[Path];
+        const Uint32   Width  = static_cast<Uint32>( m_Grid_Ptr->Width );
+
+        Store_Pvt( Done.Results[Path], Done.Reads[Path], Key( Width, Wanted.Start, Wanted.Goal ) );
+      }
+      else
+      {;}
+
+      Results.push_back( std::move( Done.Results[Path] ) );
+    }
+
+    Finish_Pvt( Done );
+
+    m_Spare.push_back( std::move( m_Running[i] ) );
+    m_Running[i] = std::move( m_Running.back() );
+    m_Running.pop_back();
+  }
+}
+
+
+/**
+ * @brief Waits for the queued batches to be solved; "collect" still hands them out.
+ **/
+void LPathfinder::wait( void )
+{
+  if ( m_Jobs_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  for ( const std::unique_ptr<Batch>& Queued : m_Running )
+  {
+    m_Jobs_Ptr->wait( Queued->Solving );
+  }
+}
+
+
+int LPathfinder::GetWidth( void ) const
+{
+  return m_Grid_Ptr ? m_Grid_Ptr->Width : 0;
+}
+
+
+int LPathfinder::GetHeight( void ) const
+{
+  return m_Grid_Ptr ? m_Grid_Ptr->Height : 0;
+}
+
+
+/**
+ * @return The cells, row after row, a set bit for a blocked one, and their words in Count; nullptr
+ * without a grid. Valid until the next edit.
+ **/
+const Uint64* LPathfinder::GetCells( size_t& Count ) const
+{
+  Count = m_Grid_Ptr ? ( static_cast<size_t>( m_Grid_Ptr->Width ) * static_cast<size_t>( m_Grid_Ptr->Height ) + 63 ) / 64 : 0;
+
+  return m_Grid_Ptr ? m_Grid_Ptr->Cells_Ptr : nullptr;
+}
+
+
+/**
+ * @return The requests queued and not handed out yet.
+ **/
+size_t LPathfinder::GetPending( void ) const
+{
+  size_t Pending = m_Ready.size();
+
+  for ( const std::unique_ptr<Batch>& Queued : m_Running )
+  {
+    Pending += Queued->Requests.size();
+  }
+
+  return Pending;
+}
+
+
+size_t LPathfinder::GetCacheSize( void ) const
+{
+  return m_Cache.size();
+}
+
+
+size_t LPathfinder::GetCacheHits( void ) const
+{
+  return m_CacheHits;
+}
+
+
+size_t LPathfinder::GetSearches( void ) const
+{
+  return m_Searches;
+}
+
+
+void LPathfinder::SolveJob_Pvt( void* Data )
+{
+  Solve_Pvt( *static_cast<Batch*>( Data ) );
+}
+
+
+/**
+ * @brief Runs the searches of a batch on its grid; only the batch is written.
+ **/
+void LPathfinder::Solve_Pvt( Batch& Queued )
+{
+  Queued.Results.resize( Queued.Requests.size() );
+  Queued.Reads.resize( Queued.Requests.size() );
+
+  for ( size_t i = 0; i != Queued.Requests.size(); ++i )
+  {
+    Find_Pvt( *Queued.Grid_Ptr, Queued.Requests[i], Queued.Work, Queued.Results[i] );
+
+    Queued.Reads[i] = Queued.Work.Reads;
+  }
+}
+
+
+/**
+ * @brief A* over the jump points, from the start to the goal.
+ *
+ * @param Work Its nodes and open list, reused; Work.Reads is set to the cells the search looked at,
+ * and their neighbours: an edit anywhere else leaves the result as it is.
+ * @return Whether a path was found; not if either end is blocked, or after s_MAX_JUMP_POINTS.
+ **/
+bool LPathfinder::Find_Pvt( const Grid& Cells, const Request& Wanted, Search& Work, Result& Path )
+{
+  const SDL_Point Start = Wanted.Start;
+  const SDL_Point Goal  = Wanted.Goal;
+  const Uint32    Width = static_cast<Uint32>( Cells.Width );
+
+  Path.Id      = Wanted.Id;
+  Path.IsFound = false;
+  Path.Cost    = 0;
+  Path.Points.clear();
+
+  Work.Reads = SDL_Rect{ Start.x, Start.y, 1, 1 };
+  Grow( Work.Reads, Goal.x, Goal.y );
+
+  Work.Nodes.clear();
+  Work.Heap.clear();
+
+  // Lowest estimate first, and the furthest from the start among equals
+  const auto Later = []( const Open& a, const Open& b )
+  {
+    return ( a.Estimate != b.Estimate ) ? ( a.Estimate > b.Estimate ) : ( a.Cost < b.Cost );
+  };
+
+  const Uint32 First = static_cast<Uint32>( Start.y ) * Width + static_cast<Uint32>( Start.x );
+
+  if ( !Cells.isBlocked( Start.x, Start.y ) && !Cells.isBlocked( Goal.x, Goal.y ) )
+  {
+    Work.Nodes[First] = Node{ 0, First, false };
+    Work.Heap.push_back( Open{ Distance( Start.x, Start.y, Goal.x, Goal.y ), 0, First } );
+  }
+  else
+  {;}
+
+  size_t Expanded = 0;
+
+  while ( !Work.Heap.empty() && Expanded != s_MAX_JUMP_POINTS )
+  {
+    std::pop_heap( Work.Heap.begin(), Work.Heap.end(), Later );
+
+    const Open Current = Work.Heap.back();
+
+    Work.Heap.pop_back();
+
+    Node& Visited = Work.Nodes[Current.Cell];
+
+    // Reached again more cheaply since it was queued
+    if ( Visited.IsClosed || Visited.Cost != Current.Cost )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    Visited.IsClosed = true;
+    ++Expanded;
+
+    const int    x      = static_cast<int>( Current.Cell % Width );
+    const int    y      = static_cast<int>( Current.Cell / Width );
+    const Uint32 Parent = Visited.Parent;
+
+    if ( x == Goal.x && y == Goal.y )
+    {
+      Path.IsFound = true;
+      Path.Cost    = Current.Cost;
+
+      for ( Uint32 Cell = Current.Cell; ; Cell = Work.Nodes[Cell].Parent )
+      {
+        Path.Points.push_back( SDL_Point{ static_cast<int>( Cell % Width ), static_cast<int>( Cell / Width ) } );
+
+        if ( Cell == First )
+        {
+          break;
+        }
+        else
+        {;}
+      }
+
+      std::reverse( Path.Points.begin(), Path.Points.end() );
+      break;
+    }
+    else
+    {;}
+
+    // The directions worth taking: all from the start, else ahead of the way it came and the ways
+    // a wall beside it opened
+    int Steps[8][2];
+    int Count = 0;
+
+    const auto Add = [&Steps, &Count]( int dx, int dy )
+    {
+      Steps[Count][0] = dx;
+      Steps[Count][1] = dy;
+      ++Count;
+    };
+
+    const auto Free = [&Cells, x, y]( int dx, int dy )
+    {
+      return !Cells.isBlocked( x + dx, y + dy );
+    };
+
+    if ( Current.Cell == First )
+    {
+      for ( int dy = -1; dy <= 1; ++dy )
+      {
+        for ( int dx = -1; dx <= 1; ++dx )
+        {
+          if ( ( dx != 0 || dy != 0 ) && Free( dx, dy ) && Free( dx, 0 ) && Free( 0, dy ) )
+          {
+            Add( dx, dy );
+          }
+          else
+          {;}
+        }
+      }
+    }
+    else
+    {
+      const int dx = Sign( x - static_cast<int>( Parent % Width ) );
+      const int dy = Sign( y - static_cast<int>( Parent / Width ) );
+
+      if ( dx != 0 && dy != 0 )
+      {
+        if ( Free( dx, 0 ) )                   { Add( dx, 0 ); } else {;}
+        if ( Free( 0, dy ) )                   { Add( 0, dy ); } else {;}
+        if ( Free( dx, 0 ) && Free( 0, dy ) )  { Add( dx, dy ); } else {;}
+      }
+      else
+      {
+        // Across the way it came: the two sides, and ahead
+        const int ax = dy;
+        const int ay = dx;
+
+        for ( int Side = -1; Side <= 1; Side += 2 )
+        {
+          if ( Free( Side * ax, Side * ay ) )
+          {
+            Add( Side * ax, Side * ay );
+
+            if ( Free( dx, dy ) )
+            {
+              Add( dx + Side * ax, dy + Side * ay );
+            }
+            else
+            {;}
+          }
+          else
+          {;}
+        }
+
+        if ( Free( dx, dy ) ) { Add( dx, dy ); } else {;}
+      }
+    }
+
+    for ( int Step = 0; Step != Count; ++Step )
+    {
+      SDL_Point Point;
+
+      if ( !Jump_Pvt( Cells, x + Steps[Step][0], y + Steps[Step][1], Steps[Step][0], Steps[Step][1], Goal, Work, Point ) )
+      {
+        continue;
+      }
+      else
+      {;}
+
+      const Uint32 Cell = static_cast<Uint32>( Point.y ) * Width + static_cast<Uint32>( Point.x );
+      const int    Cost = Current.Cost + Distance( x, y, Point.x, Point.y );
+      const auto   It   = Work.Nodes.find( Cell );
+
+      if ( It == Work.Nodes.end() )
+      {
+        Work.Nodes.emplace( Cell, Node{ Cost, Current.Cell, false } );
+      }
+      else if ( !It->second.IsClosed && Cost < It->second.Cost )
+      {
+        It->second = Node{ Cost, Current.Cell, false };
+      }
+      else
+      {
+        continue;
+      }
+
+      Work.Heap.push_back( Open{ Cost + Distance( Point.x, Point.y, Goal.x, Goal.y ), Cost, Cell } );
+      std::push_heap( Work.Heap.begin(), Work.Heap.end(), Later );
+    }
+  }
+
+  // The neighbours of the cells read were read too
+  Work.Reads.x -= 1;
+  Work.Reads.y -= 1;
+  Work.Reads.w += 2;
+  Work.Reads.h += 2;
+
+  return Path.IsFound;
+}
+
+
+/**
+ * @brief Runs from a cell along a direction until the next jump point: the goal, a cell beside the
+ * end of a wall, which opens a way the cells before could not take, or, going diagonally, a cell
+ * from which a straight run finds one. A diagonal run stops before cutting a corner.
+ *
+ * @param x, y   The first cell of the run; a diagonal step into it must already be allowed.
+ * @param dx, dy The direction, -1, 0 or 1 each.
+ * @param Point  The jump point found.
+ * @return false if the run ended against a wall or the edge of the grid.
+ **/
+bool LPathfinder::Jump_Pvt( const Grid& Cells, int x, int y, int dx, int dy, const SDL_Point& Goal, Search& Work, SDL_Point& Point )
+{
+  Grow( Work.Reads, x, y );
+
+  for ( ;; )
+  {
+    bool IsJumpPoint = false;
+
+    if ( Cells.isBlocked( x, y ) )
+    {
+      break;
+    }
+    else if ( x == Goal.x && y == Goal.y )
+    {
+      IsJumpPoint = true;
+    }
+    else if ( dx != 0 && dy != 0 )
+    {
+      SDL_Point Ahead;
+
+      IsJumpPoint = Jump_Pvt( Cells, x + dx, y, dx, 0, Goal, Work, Ahead ) ||
+                    Jump_Pvt( Cells, x, y + dy, 0, dy, Goal, Work, Ahead );
+    }
+    else if ( dx != 0 )
+    {
+      IsJumpPoint = ( !Cells.isBlocked( x, y - 1 ) && Cells.isBlocked( x - dx, y - 1 ) ) ||
+                    ( !Cells.isBlocked( x, y + 1 ) && Cells.isBlocked( x - dx, y + 1 ) );
+    }
+    else
+    {
+      IsJumpPoint = ( !Cells.isBlocked( x - 1, y ) && Cells.isBlocked( x - 1, y - dy ) ) ||
+                    ( !Cells.isBlocked( x + 1, y ) && Cells.isBlocked( x + 1, y - dy ) );
+    }
+
+    if ( IsJumpPoint )
+    {
+      Grow( Work.Reads, x, y );
+      Point = SDL_Point{ x, y };
+      return true;
+    }
+    else if ( Cells.isBlocked( x + dx, y ) || Cells.isBlocked( x, y + dy ) )
+    {
+      break;
+    }
+    else
+    {;}
+
+    x += dx;
+    y += dy;
+  }
+
+  Grow( Work.Reads, x, y );
+
+  return false;
+}
+
+
+/**
+ * @return A batch on the current grid, from the spare ones if any, counted as running.
+ **/
+LPathfinder::Batch* LPathfinder::NewBatch_Pvt( void )
+{
+  if ( m_Spare.empty() )
+  {
+    m_Running.push_back( std::unique_ptr<Batch>( new Batch() ) );
+  }
+  else
+  {
+    m_Running.push_back( std::move( m_Spare.back() ) );
+    m_Spare.pop_back();
+  }
+
+  Batch& Queued = *m_Running.back();
+
+  Queued.Grid_Ptr = m_Grid_Ptr;
+  Queued.Version  = m_Version;
+
+  return &Queued;
+}
+
+
+/**
+ * @brief Hands a batch to a job, or solves it now without a job system.
+ **/
+void LPathfinder::Launch_Pvt( Batch& Queued )
+{
+  m_Searches += Queued.Requests.size();
+
+  if ( m_Jobs_Ptr != nullptr )
+  {
+    m_Jobs_Ptr->run( SolveJob_Pvt, &Queued, &Queued.Solving );
+  }
+  else
+  {
+    Solve_Pvt( Queued );
+  }
+}
+
+
+/**
+ * @brief Empties a batch handed out, keeping its memory, and lets go of its grid.
+ **/
+void LPathfinder::Finish_Pvt( Batch& Done )
+{
+  Done.Requests.clear();
+  Done.Results.clear();
+  Done.Reads.clear();
+  Done.Grid_Ptr.reset();
+}
+
+
+/**
+ * @brief Caches a path; when the cache is full, the one used least recently makes room.
+ **/
+void LPathfinder::Store_Pvt( const Result& Path, const SDL_Rect& Reads, Uint64 Key )
+{
+  if ( m_Cache.size() >= s_CACHE_SIZE && m_Cache.find( Key ) == m_Cache.end() )
+  {
+    auto Oldest = m_Cache.begin();
+
+    for ( auto It = m_Cache.begin(); It != m_Cache.end(); ++It )
+    {
+      if ( It->second.LastUse < Oldest->second.LastUse )
+      {
+        Oldest = It;
+      }
+      else
+      {;}
+    }
+
+    m_Cache.erase( Oldest );
+  }
+  else
+  {;}
+
+  m_Cache[Key] = Entry{ Path, Reads, ++m_Clock };
+}
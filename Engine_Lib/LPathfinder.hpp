@@ -0,0 +1,166 @@
+/**
+ * @file LPathfinder.hpp
+ *
+ * @brief Paths on a tile grid, by A* with jump point search, solved in batches on the workers of
+ * LJobSystem and cached until the map changes where they were searched.
+ **/
+
+#ifndef LPATHFINDER_HPP
+#define LPATHFINDER_HPP
+
+#include "LJobSystem.hpp"
+
+#include <SDL.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A grid of free and blocked cells, one bit each, and the paths between its cells. Moves go
+ * to the 8 neighbours, a diagonal one only when both cells it passes between are free: paths never
+ * cut the corner of a wall. A straight step costs s_STRAIGHT, a diagonal one s_DIAGONAL.
+ *
+ * A search is A* over jump points: from a cell it runs along each direction worth taking and stops
+ * only where a wall ends and opens a new way, so that open spaces cost a few nodes rather than one
+ * per cell. A path is the list of its turning points, start and goal included; the cells between two
+ * of them are a straight or a diagonal line. The paths found are the shortest.
+ *
+ * "request" queues a batch, a few requests per job, and "collect", called once per frame from the
+ * same thread, hands out what is done: without a job system the batch is solved on the spot. A
+ * request found in the cache is answered by the next "collect" without a search.
+ *
+ * The grid of a batch is a snapshot: "setBlocked" copies the grid first when batches still read it,
+ * and never waits for them. A grid can also be made on cells kept elsewhere, as those of a mapped
+ * file saved from GetCells: they are read in place, and copied by the first "setBlocked". A cached path remembers the area its search read, and an edit inside it
+ * drops the path; the paths of batches queued before an edit are handed out but not cached.
+ **/
+class LPathfinder
+{
+public:
+
+  static constexpr int    s_STRAIGHT         = 100;
+  static constexpr int    s_DIAGONAL         = 141;
+  static constexpr size_t s_REQUESTS_PER_JOB = 16;
+  static constexpr size_t s_MAX_JUMP_POINTS  = 1 << 16;   // Expanded by a search before giving up
+  static constexpr size_t s_CACHE_SIZE       = 1024;      // Paths
+
+  struct Request
+  {
+    int       Id;      // The caller's, handed back with the result
+    SDL_Point Start;   // Cells
+    SDL_Point Goal;
+  };
+
+  struct Result
+  {
+    int                    Id;
+    bool                   IsFound;
+    int                    Cost;      // Steps weighted by s_STRAIGHT and s_DIAGONAL
+    std::vector<SDL_Point> Points;    // Start, turning points and goal; empty if not found
+  };
+
+  LPathfinder( void );
+  ~LPathfinder( void );
+
+  LPathfinder( const LPathfinder& )            = delete;
+  LPathfinder& operator=( const LPathfinder& ) = delete;
+
+  bool   create        ( int, int, LJobSystem* = nullptr );
+  bool   create        ( int, int, const Uint64*, size_t, LJobSystem* = nullptr );
+  void   free          ( void );
+  void   setBlocked    ( int, int, bool );
+  bool   isBlocked     ( int, int ) const;
+  void   request       ( const std::vector<Request>& );
+  void   collect       ( std::vector<Result>& );
+  void   wait          ( void );
+
+  int    GetWidth      ( void ) const;
+  int    GetHeight     ( void ) const;
+  const Uint64* GetCells( size_t& ) const;
+  size_t GetPending    ( void ) const;
+  size_t GetCacheSize  ( void ) const;
+  size_t GetCacheHits  ( void ) const;
+  size_t GetSearches   ( void ) const;
+
+private:
+
+  /**
+   * @brief The cells, row after row, a set bit for a blocked one. They are in Bits, or elsewhere
+   * until the first edit when the grid was made on cells it does not own.
+   **/
+  struct Grid
+  {
+    int                 Width;
+    int                 Height;
+    std::vector<Uint64> Bits;
+    const Uint64*       Cells_Ptr;   // Bits.data(), or the cells the grid was made on
+
+    bool isBlocked( int, int ) const;
+    void own      ( void );
+  };
+
+  struct Node
+  {
+    int    Cost;        // From the start
+    Uint32 Parent;      // Cell of the jump point it was reached from
+    bool   IsClosed;
+  };
+
+  struct Open
+  {
+    int    Estimate;    // Cost plus the distance left
+    int    Cost;
+    Uint32 Cell;
+  };
+
+  /**
+   * @brief What a search needs, kept by a batch so that its searches allocate once.
+   **/
+  struct Search
+  {
+    std::unordered_map<Uint32, Node> Nodes;
+    std::vector<Open>                Heap;
+    SDL_Rect                         Reads;   // Cells the search looked at, grown by one
+  };
+
+  struct Batch
+  {
+    std::shared_ptr<const Grid> Grid_Ptr;
+    std::vector<Request>        Requests;
+    std::vector<Result>         Results;
+    std::vector<SDL_Rect>       Reads;      // Of each result
+    Search                      Work;
+    Uint32                      Version;    // Of the grid when queued
+    LJobCounter                 Solving;
+  };
+
+  struct Entry
+  {
+    Result   Path;
+    SDL_Rect Reads;
+    Uint32   LastUse;
+  };
+
+  static void SolveJob_Pvt ( void* );
+  static void Solve_Pvt    ( Batch& );
+  static bool Find_Pvt     ( const Grid&, const Request&, Search&, Result& );
+  static bool Jump_Pvt     ( const Grid&, int, int, int, int, const SDL_Point&, Search&, SDL_Point& );
+
+  Batch* NewBatch_Pvt      ( void );
+  void   Launch_Pvt        ( Batch& );
+  void   Finish_Pvt        ( Batch& );
+  void   Store_Pvt         ( const Result&, const SDL_Rect&, Uint64 );
+
+  std::shared_ptr<Grid>                 m_Grid_Ptr;
+  LJobSystem*                           m_Jobs_Ptr;
+  std::vector< std::unique_ptr<Batch> > m_Running;
+  std::vector< std::unique_ptr<Batch> > m_Spare;
+  std::vector<Result>                   m_Ready;      // Cache hits, for the next "collect"
+  std::unordered_map<Uint64, Entry>     m_Cache;      // By start and goal cells
+  Uint32                                m_Version;    // Bumped by the edits
+  Uint32                                m_Clock;      // Of the cache uses
+  size_t                                m_CacheHits;
+  size_t                                m_Searches;
+};
+
+#endif // LPATHFINDER_HPP
@@ -0,0 +1,57 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LPerfHarness.hpp"
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+// Draw calls issued since the start of the program. The rest of the harness is in
+// LPerfHarness_Run.cpp, linked only by the programs that run it.
+static Uint64 g_DrawCalls = 0;
+
+// Pixels written, and pixels of the targets they were written to, since the start of the program
+static Uint64 g_PixelsDrawn = 0;
+static Uint64 g_PixelsShown = 0;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+void LPerfHarness::countDrawCalls( int Count )
+{
+  g_DrawCalls += static_cast<Uint64>( Count );
+}
+
+
+/**
+ * @param Drawn Pixels written by a pass, overdraw included.
+ * @param Shown Pixels of the target it wrote to.
+ **/
+void LPerfHarness::countPixels( Uint64 Drawn, Uint64 Shown )
+{
+  g_PixelsDrawn += Drawn;
+  g_PixelsShown += Shown;
+}
+
+
+Uint64 LPerfHarness::GetDrawCalls( void )
+{
+  return g_DrawCalls;
+}
+
+
+Uint64 LPerfHarness::GetPixelsDrawn( void )
+{
+  return g_PixelsDrawn;
+}
+
+
+Uint64 LPerfHarness::GetPixelsShown( void )
+{
+  return g_PixelsShown;
+}
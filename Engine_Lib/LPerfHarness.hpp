@@ -0,0 +1,71 @@
+/**
+ * @file LPerfHarness.hpp
+ *
+ * @brief Scripted, headless performance runs: a fixed number of frames with recorded input, timed
+ * and checked against a budget, so that a slower build fails before it is shipped.
+ **/
+
+#ifndef LPERFHARNESS_HPP
+#define LPERFHARNESS_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief Turns a program's main loop into a performance check, with static functions only, so that
+ * the loop needs just a call at its top and one at its bottom.
+ *
+ * "configure" reads the "--perf-" options of the command line, before SDL_Init:
+ *   --perf-frames=<N>     runs N frames, then queues SDL_QUIT; without it nothing changes
+ *   --perf-script=<file>  input to queue, frame by frame (see below)
+ *   --perf-budget=<file>  limits that fail the run when exceeded (see below)
+ *   --perf-warmup=<N>     first frames left out of the statistics (30 by default)
+ *   --perf-csv=<file>     time, heap allocations, draw calls and overdraw of every frame
+ *   --perf-window         keeps the real video driver, to watch the script play
+ * During a run the dummy video driver and the software renderer are selected, with no vsync: there
+ * is no window nor GPU, the frames are not paced, and the frame time is the work of the CPU alone.
+ *
+ * "beginFrame", before the event loop, queues the scripted events of the frame; "endFrame", after
+ * SDL_RenderPresent, records how long the frame took, the operator new calls made meanwhile (by any
+ * thread; counted by LFrameArena in builds without NDEBUG only) and the draw calls the engine issued.
+ * "finish" prints the statistics, writes the CSV and returns false if a budget was exceeded or the
+ * run did not reach its frames; the program turns it into its exit code, and skips any wait for
+ * the user while "isActive".
+ *
+ * The script has one event per line, ordered by frame; empty lines and lines starting with '#' are
+ * ignored:
+ *   <frame> down <key>       <frame> up <key>      (key names as SDL_GetKeyFromName: Up, Return, S)
+ *   <frame> click <x> <y> <left|right>             (button pressed and released)
+ *   <frame> drag <x> <y> <left|right>              (mouse moved with the button held)
+ * Keys reach the event queue only: SDL_GetKeyboardState does not see them.
+ *
+ * The budget has one limit per line, "<name> <value>", same comments as the script; frame times
+ * are in milliseconds, the other limits per frame:
+ *   frame_ms_average, frame_ms_p99, frame_ms_max, allocations_max, draw_calls_max, overdraw_max
+ *
+ * Draw calls are counted by the engine's draw paths (LTexture, the batches, the caches and render
+ * targets) through "countDrawCalls", and by any program code that adds its own; the counter costs
+ * an addition, and is kept in its own object so that programs using no harness do not link the run.
+ * Pixels are counted the same way, through "countPixels", by the paths that know them (LDrawList):
+ * the overdraw of a frame is the pixels written over those of the targets they were written to, 0
+ * in frames where nothing counted them.
+ *
+ * Not thread safe: call it from the thread that renders.
+ **/
+class LPerfHarness
+{
+public:
+
+  static bool   configure     ( int, char* [] );
+  static bool   isActive      ( void );
+  static void   beginFrame    ( void );
+  static void   endFrame      ( void );
+  static bool   finish        ( void );
+
+  static void   countDrawCalls( int );
+  static void   countPixels   ( Uint64, Uint64 );
+  static Uint64 GetDrawCalls  ( void );
+  static Uint64 GetPixelsDrawn( void );
+  static Uint64 GetPixelsShown( void );
+};
+
+#endif // LPERFHARNESS_HPP
@@ -0,0 +1,546 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LPerfHarness.hpp"
+#include "LFrameArena.hpp"
+#include "LFrameStats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const Uint32 g_DEFAULT_WARMUP = 30;   // Frames: textures uploaded, caches filled, pools grown
+
+enum Limit
+{
+  FRAME_MS_AVERAGE = 0,
+  FRAME_MS_P99,
+  FRAME_MS_MAX,
+  ALLOCATIONS_MAX,
+  DRAW_CALLS_MAX,
+  OVERDRAW_MAX,
+
+  HOW_MANY_LIMITS
+};
+
+static const char* g_LIMIT_NAMES[HOW_MANY_LIMITS] =
+{
+  "frame_ms_average", "frame_ms_p99", "frame_ms_max", "allocations_max", "draw_calls_max", "overdraw_max"
+};
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+struct ScriptedEvent
+{
+  Uint32    Frame;
+  SDL_Event Event;
+};
+
+struct FrameRecord
+{
+  double Time_ms;
+  Uint64 Allocations;
+  Uint64 DrawCalls;
+  double Overdraw;
+};
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+static bool                       g_IsActive           = false;
+static Uint32                     g_NumOfFrames        = 0;
+static Uint32                     g_WarmupFrames       = g_DEFAULT_WARMUP;
+static Uint32                     g_Frame              = 0;      // Frames begun so far
+static std::vector<ScriptedEvent> g_Script;
+static size_t                     g_NextEvent          = 0;
+static std::vector<FrameRecord>   g_Records;                     // Reserved up front: no allocation while running
+static std::string                g_CsvPath;
+static double                     g_Limits[HOW_MANY_LIMITS];
+static bool                       g_IsLimitSet[HOW_MANY_LIMITS] = {};
+static Uint64                     g_FrameStart         = 0;
+static Uint64                     g_AllocationsAtStart = 0;
+static Uint64                     g_DrawCallsAtStart   = 0;
+static Uint64                     g_DrawnAtStart       = 0;
+static Uint64                     g_ShownAtStart       = 0;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return true if Arg starts with Option; Value_Ptr then points past it.
+ **/
+static bool MatchOption( const char* Arg, const char* Option, const char*& Value_Ptr )
+{
+  const size_t Length = strlen( Option );
+
+  if ( strncmp( Arg, Option, Length ) == 0 )
+  {
+    Value_Ptr = Arg + Length;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+static Uint8 ParseButton( const char* Name )
+{
+  return ( strcmp( Name, "right" ) == 0 ) ? SDL_BUTTON_RIGHT : SDL_BUTTON_LEFT;
+}
+
+
+/**
+ * @brief Reads the input script. A malformed line fails the run rather than being skipped: a
+ * script that no longer does what it says would make the budget meaningless.
+ **/
+static bool LoadScript( const char* Path )
+{
+  FILE* File_Ptr = fopen( Path, "r" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to open performance script \"%s\"!", Path );
+    return false;
+  }
+  else
+  {;}
+
+  char Line[128];
+  int  LineNumber = 0;
+  bool IsValid    = true;
+
+  while ( IsValid && fgets( Line, sizeof(Line), File_Ptr ) != NULL )
+  {
+    ++LineNumber;
+
+    unsigned long Frame = 0;
+    char          Action[8];
+    char          Argument[32];
+    int           X = 0;
+    int           Y = 0;
+
+    if ( Line[0] == '#' || Line[0] == '\n' || Line[0] == '\r' )
+    {
+      continue;
+    }
+    else if ( sscanf( Line, "%lu %7s", &Frame, Action ) != 2 )
+    {
+      IsValid = false;
+      break;
+    }
+    else
+    {;}
+
+    ScriptedEvent Scripted;
+    memset( &Scripted, 0, sizeof(Scripted) );
+    Scripted.Frame = static_cast<Uint32>( Frame );
+
+    if ( ( strcmp( Action, "down" ) == 0 || strcmp( Action, "up" ) == 0 ) &&
+         sscanf( Line, "%*u %*7s %31s", Argument ) == 1 && SDL_GetKeyFromName( Argument ) != SDLK_UNKNOWN )
+    {
+      const bool IsDown = ( strcmp( Action, "down" ) == 0 );
+
+      Scripted.Event.type                = IsDown ? SDL_KEYDOWN : SDL_KEYUP;
+      Scripted.Event.key.state           = IsDown ? SDL_PRESSED : SDL_RELEASED;
+      Scripted.Event.key.keysym.sym      = SDL_GetKeyFromName( Argument );
+      Scripted.Event.key.keysym.scancode = SDL_GetScancodeFromKey( Scripted.Event.key.keysym.sym );
+      g_Script.push_back( Scripted );
+    }
+    else if ( strcmp( Action, "click" ) == 0 && sscanf( Line, "%*u %*7s %d %d %31s", &X, &Y, Argument ) == 3 )
+    {
+      Scripted.Event.type          = SDL_MOUSEBUTTONDOWN;
+      Scripted.Event.button.button = ParseButton( Argument );
+      Scripted.Event.button.state  = SDL_PRESSED;
+      Scripted.Event.button.clicks = 1;
+      Scripted.Event.button.x      = X;
+      Scripted.Event.button.y      = Y;
+      g_Script.push_back( Scripted );
+
+      Scripted.Event.type          = SDL_MOUSEBUTTONUP;
+      Scripted.Event.button.state  = SDL_RELEASED;
+      g_Script.push_back( Scripted );
+    }
+    else if ( strcmp( Action, "drag" ) == 0 && sscanf( Line, "%*u %*7s %d %d %31s", &X, &Y, Argument ) == 3 )
+    {
+      Scripted.Event.type         = SDL_MOUSEMOTION;
+      Scripted.Event.motion.state = SDL_BUTTON( ParseButton( Argument ) );
+      Scripted.Event.motion.x     = X;
+      Scripted.Event.motion.y     = Y;
+      g_Script.push_back( Scripted );
+    }
+    else
+    {
+      IsValid = false;
+    }
+  }
+
+  fclose( File_Ptr );
+
+  if ( !IsValid )
+  {
+    printf( "\nPerformance script \"%s\", line %d: malformed event!", Path, LineNumber );
+    return false;
+  }
+  else
+  {;}
+
+  // Out of order lines would never be reached
+  std::stable_sort( g_Script.begin(), g_Script.end(),
+                    []( const ScriptedEvent& A, const ScriptedEvent& B ) { return A.Frame < B.Frame; } );
+
+  return true;
+}
+
+
+static bool LoadBudget( const char* Path )
+{
+  FILE* File_Ptr = fopen( Path, "r" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to open performance budget \"%s\"!", Path );
+    return false;
+  }
+  else
+  {;}
+
+  char Line[128];
+  int  LineNumber = 0;
+  bool IsValid    = true;
+
+  while ( IsValid && fgets( Line, sizeof(Line), File_Ptr ) != NULL )
+  {
+    ++LineNumber;
+
+    char   Name[32];
+    double Value = 0.0;
+
+    if ( Line[0] == '#' || Line[0] == '\n' || Line[0] == '\r' )
+    {
+      continue;
+    }
+    else if ( sscanf( Line, "%31s %lf", Name, &Value ) != 2 )
+    {
+      IsValid = false;
+      break;
+    }
+    else
+    {;}
+
+    IsValid = false;
+
+    for ( int i = 0; i != HOW_MANY_LIMITS; ++i )
+    {
+      if ( strcmp( Name, g_LIMIT_NAMES[i] ) == 0 )
+      {
+        g_Limits[i]     = Value;
+        g_IsLimitSet[i] = true;
+        IsValid         = true;
+      }
+      else
+      {;}
+    }
+  }
+
+  fclose( File_Ptr );
+
+  if ( !IsValid )
+  {
+    printf( "\nPerformance budget \"%s\", line %d: unknown or malformed limit!", Path, LineNumber );
+    return false;
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+static bool WriteCsv( void )
+{
+  FILE* File_Ptr = fopen( g_CsvPath.c_str(), "w" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to write \"%s\"!", g_CsvPath.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  fprintf( File_Ptr, "frame,time_ms,allocations,draw_calls,overdraw,warmup\n" );
+
+  for ( size_t i = 0; i != g_Records.size(); ++i )
+  {
+    fprintf( File_Ptr, "%zu,%.4f,%llu,%llu,%.3f,%d\n", i, g_Records[i].Time_ms,
+             static_cast<unsigned long long>( g_Records[i].Allocations ),
+             static_cast<unsigned long long>( g_Records[i].DrawCalls ), g_Records[i].Overdraw, ( i < g_WarmupFrames ) ? 1 : 0 );
+  }
+
+  return fclose( File_Ptr ) == 0;
+}
+
+
+/**
+ * @brief Prints a measure against its limit, if it has one.
+ *
+ * @return false if the limit was exceeded.
+ **/
+static bool CheckLimit( Limit Which, double Measured, const char* Format )
+{
+  char Text[32];
+  snprintf( Text, sizeof(Text), Format, Measured );
+
+  if ( !g_IsLimitSet[Which] )
+  {
+    printf( "\n\t%-18s %12s", g_LIMIT_NAMES[Which], Text );
+    return true;
+  }
+  else if ( Measured <= g_Limits[Which] )
+  {
+    printf( "\n\t%-18s %12s  (budget %g) OK", g_LIMIT_NAMES[Which], Text, g_Limits[Which] );
+    return true;
+  }
+  else
+  {
+    printf( "\n\t%-18s %12s  (budget %g) OVER BUDGET", g_LIMIT_NAMES[Which], Text, g_Limits[Which] );
+    return false;
+  }
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief Reads the "--perf-" options; call it before SDL_Init, which picks the video driver.
+ *
+ * @return false if the script or the budget cannot be read: the program should quit, failing.
+ **/
+bool LPerfHarness::configure( int argc, char* argv[] )
+{
+  const char* ScriptPath_Ptr = NULL;
+  const char* BudgetPath_Ptr = NULL;
+  const char* Value_Ptr      = NULL;
+  bool        KeepsWindow    = false;
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( MatchOption( argv[i], "--perf-frames=", Value_Ptr ) )
+    {
+      g_NumOfFrames = static_cast<Uint32>( strtoul( Value_Ptr, NULL, 10 ) );
+    }
+    else if ( MatchOption( argv[i], "--perf-warmup=", Value_Ptr ) )
+    {
+      g_WarmupFrames = static_cast<Uint32>( strtoul( Value_Ptr, NULL, 10 ) );
+    }
+    else if ( MatchOption( argv[i], "--perf-script=", Value_Ptr ) )
+    {
+      ScriptPath_Ptr = Value_Ptr;
+    }
+    else if ( MatchOption( argv[i], "--perf-budget=", Value_Ptr ) )
+    {
+      BudgetPath_Ptr = Value_Ptr;
+    }
+    else if ( MatchOption( argv[i], "--perf-csv=", Value_Ptr ) )
+    {
+      g_CsvPath = Value_Ptr;
+    }
+    else if ( strcmp( argv[i], "--perf-window" ) == 0 )
+    {
+      KeepsWindow = true;
+    }
+    else
+    {;}
+  }
+
+  g_IsActive = ( g_NumOfFrames > 0 );
+
+  if ( !g_IsActive )
+  {
+    return true;
+  }
+  else if ( ( ScriptPath_Ptr != NULL && !LoadScript( ScriptPath_Ptr ) ) || ( BudgetPath_Ptr != NULL && !LoadBudget( BudgetPath_Ptr ) ) )
+  {
+    return false; // Still active: "finish" fails the run, and the program does not wait for ENTER
+  }
+  else
+  {;}
+
+  if ( !KeepsWindow )
+  {
+    SDL_setenv( "SDL_VIDEODRIVER", "dummy", 1 );
+    SDL_SetHint( SDL_HINT_RENDER_DRIVER, "software" );
+  }
+  else
+  {;}
+
+  // Unpaced in both cases: the hint wins over SDL_RENDERER_PRESENTVSYNC
+  SDL_SetHint( SDL_HINT_RENDER_VSYNC, "0" );
+
+  g_Records.reserve( g_NumOfFrames );
+
+  printf( "\nPerformance run: %u frames (%u of warm-up), %zu scripted events%s", g_NumOfFrames, g_WarmupFrames,
+          g_Script.size(), KeepsWindow ? "" : ", headless" );
+
+  return true;
+}
+
+
+bool LPerfHarness::isActive( void )
+{
+  return g_IsActive;
+}
+
+
+/**
+ * @brief Queues the scripted events of the frame, and SDL_QUIT in the last one, then starts timing
+ * it. Call it before polling the events.
+ **/
+void LPerfHarness::beginFrame( void )
+{
+  if ( !g_IsActive )
+  {
+    return;
+  }
+  else
+  {;}
+
+  for ( ; g_NextEvent != g_Script.size() && g_Script[g_NextEvent].Frame <= g_Frame; ++g_NextEvent )
+  {
+    SDL_Event Event = g_Script[g_NextEvent].Event;
+
+    if ( SDL_PushEvent( &Event ) < 0 )
+    {
+      printf( "\nScripted event of frame %u not queued! SDL Error: %s", g_Frame, SDL_GetError() );
+    }
+    else
+    {;}
+  }
+
+  if ( g_Frame + 1 == g_NumOfFrames )
+  {
+    SDL_Event Quit;
+    memset( &Quit, 0, sizeof(Quit) );
+    Quit.type = SDL_QUIT;
+
+    SDL_PushEvent( &Quit );
+  }
+  else
+  {;}
+
+  g_AllocationsAtStart = LFrameArena::GetHeapAllocations();
+  g_DrawCallsAtStart   = GetDrawCalls();
+  g_DrawnAtStart       = GetPixelsDrawn();
+  g_ShownAtStart       = GetPixelsShown();
+  g_FrameStart         = SDL_GetPerformanceCounter();
+}
+
+
+/**
+ * @brief Records the frame. Call it after SDL_RenderPresent.
+ **/
+void LPerfHarness::endFrame( void )
+{
+  if ( !g_IsActive )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint64 End   = SDL_GetPerformanceCounter();
+  const Uint64 Shown = GetPixelsShown() - g_ShownAtStart;
+
+  if ( g_Records.size() < g_NumOfFrames )
+  {
+    g_Records.push_back( FrameRecord{ static_cast<double>( End - g_FrameStart ) * 1000.0 / static_cast<double>( SDL_GetPerformanceFrequency() ),
+                                      LFrameArena::GetHeapAllocations() - g_AllocationsAtStart,
+                                      GetDrawCalls() - g_DrawCallsAtStart,
+                                      ( Shown != 0 ) ? static_cast<double>( GetPixelsDrawn() - g_DrawnAtStart ) / static_cast<double>( Shown ) : 0.0 } );
+  }
+  else
+  {;}
+
+  ++g_Frame;
+}
+
+
+/**
+ * @brief Prints the statistics of the frames after the warm-up, checks them against the budget and
+ * writes the CSV.
+ *
+ * @return true if no run was asked for, or if it reached its frames within the budget.
+ **/
+bool LPerfHarness::finish( void )
+{
+  if ( !g_IsActive )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  bool IsWithinBudget = ( g_CsvPath.empty() || WriteCsv() );
+
+  if ( g_Records.size() < g_NumOfFrames || g_Records.size() <= g_WarmupFrames )
+  {
+    printf( "\nPerformance run FAILED: %zu frames of %u, %u of warm-up", g_Records.size(), g_NumOfFrames, g_WarmupFrames );
+    return false;
+  }
+  else
+  {;}
+
+  const size_t Measured = g_Records.size() - g_WarmupFrames;
+  LFrameStats  Times( Measured );
+  Uint64       MaxAllocations = 0;
+  Uint64       MaxDrawCalls   = 0;
+  double       MaxOverdraw    = 0.0;
+
+  for ( size_t i = g_WarmupFrames; i != g_Records.size(); ++i )
+  {
+    Times.addFrame( g_Records[i].Time_ms / 1000.0 );
+    MaxAllocations = std::max( MaxAllocations, g_Records[i].Allocations );
+    MaxDrawCalls   = std::max( MaxDrawCalls  , g_Records[i].DrawCalls   );
+    MaxOverdraw    = std::max( MaxOverdraw   , g_Records[i].Overdraw    );
+  }
+
+  printf( "\nPerformance run: %zu frames measured", Measured );
+
+  IsWithinBudget = CheckLimit( FRAME_MS_AVERAGE, Times.GetAverage() * 1000.0       , "%.3f" ) && IsWithinBudget;
+  IsWithinBudget = CheckLimit( FRAME_MS_P99    , Times.GetPercentile( 0.99 ) * 1000.0, "%.3f" ) && IsWithinBudget;
+  IsWithinBudget = CheckLimit( FRAME_MS_MAX    , Times.GetMax() * 1000.0           , "%.3f" ) && IsWithinBudget;
+
+#if !defined(NDEBUG)
+  IsWithinBudget = CheckLimit( ALLOCATIONS_MAX , static_cast<double>( MaxAllocations ), "%.0f" ) && IsWithinBudget;
+#else
+  printf( "\n\t%-18s %12s", g_LIMIT_NAMES[ALLOCATIONS_MAX], "not counted" ); // operator new is counted without NDEBUG only
+  (void)MaxAllocations;
+#endif
+
+  IsWithinBudget = CheckLimit( DRAW_CALLS_MAX  , static_cast<double>( MaxDrawCalls ), "%.0f" ) && IsWithinBudget;
+  IsWithinBudget = CheckLimit( OVERDRAW_MAX    , MaxOverdraw                       , "%.2f" ) && IsWithinBudget;
+
+  printf( "\nPerformance run %s\n", IsWithinBudget ? "within budget" : "FAILED" );
+
+  return IsWithinBudget;
+}
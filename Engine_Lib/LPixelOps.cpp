@@ -0,0 +1,1420 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LPixelOps.hpp"
+#include "LJobSystem.hpp"
+#include "LSmallVector.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define LPIXELOPS_SSE2
+
+  // AVX2 is compiled in anyway, for the functions marked below, and used only if the CPU has it
+  #if defined(__GNUC__) || defined(_MSC_VER)
+    #include <immintrin.h>
+    #define LPIXELOPS_AVX2
+  #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define LPIXELOPS_NEON
+#endif
+
+#if defined(LPIXELOPS_AVX2) && defined(__GNUC__)
+  #define LPIXELOPS_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#else
+  #define LPIXELOPS_TARGET_AVX2
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const Uint8 NO_BYTE = 0x80;  // In a byte map: no source byte, the destination takes the fill
+
+// Bands per thread, so that a worker held up elsewhere leaves its share to the others, and the
+// smallest band: below it, queueing the job costs more than running it where it is
+static const size_t BANDS_PER_THREAD = 4;
+static const size_t MIN_BAND_BYTES   = 64 * 1024;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Where each destination byte of a swizzle comes from.
+ **/
+struct ByteMap
+{
+  Uint8  Source[4];  // Source byte of destination byte i, or NO_BYTE
+  Uint32 Fill;       // 0xFF in the destination bytes with no source
+};
+
+
+/**
+ * @brief Where a column of a scaled row comes from: between source pixels Left and Left + 1, at
+ * Weight / 256 of the way.
+ **/
+struct ScaleColumn
+{
+  Uint32 Left;
+  Uint32 Weight;     // 0..256
+};
+
+
+/**
+ * @brief The same operations, one set per instruction set.
+ **/
+struct PixelKernels
+{
+  const char* Name;
+  void      (*ColourKey)   ( Uint32*, size_t, Uint32, Uint32 );
+  void      (*Tint)        ( Uint32*, size_t, Uint32 );
+  void      (*Premultiply) ( Uint32*, size_t, Uint32 );
+  void      (*Swizzle)     ( const Uint32*, Uint32*, size_t, const ByteMap& );
+  void      (*BlendRows)   ( const Uint32*, const Uint32*, Uint32*, size_t, Uint32 );
+  void      (*BlendColumns)( const Uint32*, Uint32*, size_t, const ScaleColumn* );
+  void      (*Composite)   ( const Uint32*, Uint32*, size_t, Uint32 );
+};
+
+
+/**
+ * @brief a * b / 255, rounded to nearest, for a and b in 0..255: exact, with no division.
+ **/
+static inline Uint32 MulByte( Uint32 a, Uint32 b )
+{
+  const Uint32 Product = a * b + 128;
+
+  return ( Product + ( Product >> 8 ) ) >> 8;
+}
+
+
+static inline Uint32 MulPixel( Uint32 Pixel, Uint32 Factors )
+{
+  return   MulByte(   Pixel         & 0xFF,   Factors         & 0xFF )
+         | MulByte( ( Pixel >>  8 ) & 0xFF, ( Factors >>  8 ) & 0xFF ) <<  8
+         | MulByte( ( Pixel >> 16 ) & 0xFF, ( Factors >> 16 ) & 0xFF ) << 16
+         | MulByte(   Pixel >> 24,            Factors >> 24          ) << 24;
+}
+
+
+/**
+ * @brief The factors that premultiply a pixel: its alpha in every byte, 255 in the alpha byte.
+ **/
+static inline Uint32 AlphaFactors( Uint32 Pixel, Uint32 AlphaShift )
+{
+  return ( ( ( Pixel >> AlphaShift ) & 0xFF ) * 0x01010101u ) | ( 0xFFu << AlphaShift );
+}
+
+
+/**
+ * @brief ( a * ( 256 - Weight ) + b * Weight ) >> 8 on each byte, two bytes per multiplication:
+ * 255 * 256 still fits the 16 bits between them.
+ **/
+static inline Uint32 LerpPixel( Uint32 a, Uint32 b, Uint32 Weight )
+{
+  const Uint32 Keep = 256 - Weight;
+  const Uint32 Even = ( (   a        & 0x00FF00FF ) * Keep + (   b        & 0x00FF00FF ) * Weight ) >> 8;
+  const Uint32 Odd  =   ( ( a >> 8 ) & 0x00FF00FF ) * Keep + ( ( b >> 8 ) & 0x00FF00FF ) * Weight;
+
+  return ( Even & 0x00FF00FF ) | ( Odd & 0xFF00FF00 );
+}
+
+
+static void ColourKey_Scalar( Uint32* Pixels_Ptr, size_t Count, Uint32 Key, Uint32 Replacement )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    if ( Pixels_Ptr[i] == Key )
+    {
+      Pixels_Ptr[i] = Replacement;
+    }
+    else
+    {;}
+  }
+}
+
+
+static void Tint_Scalar( Uint32* Pixels_Ptr, size_t Count, Uint32 Tint )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    Pixels_Ptr[i] = MulPixel( Pixels_Ptr[i], Tint );
+  }
+}
+
+
+static void Premultiply_Scalar( Uint32* Pixels_Ptr, size_t Count, Uint32 AlphaShift )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    Pixels_Ptr[i] = MulPixel( Pixels_Ptr[i], AlphaFactors( Pixels_Ptr[i], AlphaShift ) );
+  }
+}
+
+
+static void Swizzle_Scalar( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, const ByteMap& Map )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    const Uint32 Pixel = Source_Ptr[i];
+    Uint32       Out   = Map.Fill;
+
+    for ( Uint32 Byte = 0; Byte != 4; ++Byte )
+    {
+      if ( Map.Source[Byte] != NO_BYTE )
+      {
+        Out |= ( ( Pixel >> ( 8 * Map.Source[Byte] ) ) & 0xFF ) << ( 8 * Byte );
+      }
+      else
+      {;}
+    }
+
+    Destination_Ptr[i] = Out;
+  }
+}
+
+
+/**
+ * @brief Blends two rows into one, Weight / 256 of the way from Top_Ptr to Bottom_Ptr.
+ **/
+static void BlendRows_Scalar( const Uint32* Top_Ptr, const Uint32* Bottom_Ptr, Uint32* Out_Ptr, size_t Count, Uint32 Weight )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    Out_Ptr[i] = LerpPixel( Top_Ptr[i], Bottom_Ptr[i], Weight );
+  }
+}
+
+
+/**
+ * @brief Resamples a row: Row_Ptr holds one pixel more than the source row, its last repeated.
+ **/
+static void BlendColumns_Scalar( const Uint32* Row_Ptr, Uint32* Out_Ptr, size_t Count, const ScaleColumn* Columns_Ptr )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    const ScaleColumn& Column = Columns_Ptr[i];
+
+    Out_Ptr[i] = LerpPixel( Row_Ptr[Column.Left], Row_Ptr[Column.Left + 1], Column.Weight );
+  }
+}
+
+
+/**
+ * @brief Source over destination, the source premultiplied and modulated first: each channel of the
+ * destination keeps 255 - source alpha of itself, and the source is added.
+ **/
+static void Composite_Scalar( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 Modulate )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    const Uint32 Pixel = MulPixel( Source_Ptr[i], Modulate );
+    const Uint32 Keep  = ( 255 - ( Pixel >> 24 ) ) * 0x01010101u;
+
+    Destination_Ptr[i] = Pixel + MulPixel( Destination_Ptr[i], Keep );
+  }
+}
+
+
+#if defined(LPIXELOPS_SSE2)
+/**
+ * @brief MulByte on 16 bytes, in two halves of eight 16-bit products.
+ **/
+static inline __m128i MulBytes_SSE2( __m128i Pixels, __m128i Factors )
+{
+  const __m128i Zero = _mm_setzero_si128();
+  const __m128i Half = _mm_set1_epi16( 128 );
+
+  __m128i Low  = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( Pixels, Zero ), _mm_unpacklo_epi8( Factors, Zero ) ), Half );
+  __m128i High = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( Pixels, Zero ), _mm_unpackhi_epi8( Factors, Zero ) ), Half );
+
+  Low  = _mm_srli_epi16( _mm_add_epi16( Low,  _mm_srli_epi16( Low,  8 ) ), 8 );
+  High = _mm_srli_epi16( _mm_add_epi16( High, _mm_srli_epi16( High, 8 ) ), 8 );
+
+  return _mm_packus_epi16( Low, High );
+}
+
+
+static void ColourKey_SSE2( Uint32* Pixels_Ptr, size_t Count, Uint32 Key, Uint32 Replacement )
+{
+  const __m128i Keys         = _mm_set1_epi32( static_cast<int>( Key ) );
+  const __m128i Replacements = _mm_set1_epi32( static_cast<int>( Replacement ) );
+  size_t        i            = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    __m128i* Block_Ptr = reinterpret_cast<__m128i*>( Pixels_Ptr + i );
+    const __m128i Pixels = _mm_loadu_si128( Block_Ptr );
+    const __m128i Equal  = _mm_cmpeq_epi32( Pixels, Keys );
+
+    _mm_storeu_si128( Block_Ptr, _mm_or_si128( _mm_andnot_si128( Equal, Pixels ), _mm_and_si128( Equal, Replacements ) ) );
+  }
+
+  ColourKey_Scalar( Pixels_Ptr + i, Count - i, Key, Replacement );
+}
+
+
+static void Tint_SSE2( Uint32* Pixels_Ptr, size_t Count, Uint32 Tint )
+{
+  const __m128i Factors = _mm_set1_epi32( static_cast<int>( Tint ) );
+  size_t        i       = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    __m128i* Block_Ptr = reinterpret_cast<__m128i*>( Pixels_Ptr + i );
+
+    _mm_storeu_si128( Block_Ptr, MulBytes_SSE2( _mm_loadu_si128( Block_Ptr ), Factors ) );
+  }
+
+  Tint_Scalar( Pixels_Ptr + i, Count - i, Tint );
+}
+
+
+static void Premultiply_SSE2( Uint32* Pixels_Ptr, size_t Count, Uint32 AlphaShift )
+{
+  const __m128i Shift     = _mm_cvtsi32_si128( static_cast<int>( AlphaShift ) );
+  const __m128i ByteMask  = _mm_set1_epi32( 0xFF );
+  const __m128i AlphaMask = _mm_set1_epi32( static_cast<int>( 0xFFu << AlphaShift ) );
+  size_t        i         = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    __m128i* Block_Ptr = reinterpret_cast<__m128i*>( Pixels_Ptr + i );
+    const __m128i Pixels = _mm_loadu_si128( Block_Ptr );
+
+    // Alpha in every byte: SSE2 has no 32-bit multiplication by 0x01010101
+    __m128i Factors = _mm_and_si128( _mm_srl_epi32( Pixels, Shift ), ByteMask );
+    Factors = _mm_or_si128( Factors, _mm_slli_epi32( Factors, 8 ) );
+    Factors = _mm_or_si128( Factors, _mm_slli_epi32( Factors, 16 ) );
+
+    _mm_storeu_si128( Block_Ptr, MulBytes_SSE2( Pixels, _mm_or_si128( Factors, AlphaMask ) ) );
+  }
+
+  Premultiply_Scalar( Pixels_Ptr + i, Count - i, AlphaShift );
+}
+
+
+/**
+ * @brief Each destination byte is shifted out of its source byte: SSE2 has no byte shuffle.
+ **/
+static void Swizzle_SSE2( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, const ByteMap& Map )
+{
+  __m128i SourceShift[4];
+  __m128i DestinationShift[4];
+  __m128i Keep[4];
+
+  for ( int Byte = 0; Byte != 4; ++Byte )
+  {
+    const bool Mapped = ( Map.Source[Byte] != NO_BYTE );
+
+    SourceShift[Byte]      = _mm_cvtsi32_si128( Mapped ? 8 * Map.Source[Byte] : 0 );
+    DestinationShift[Byte] = _mm_cvtsi32_si128( 8 * Byte );
+    Keep[Byte]             = _mm_set1_epi32( Mapped ? 0xFF : 0 );
+  }
+
+  const __m128i Fill = _mm_set1_epi32( static_cast<int>( Map.Fill ) );
+  size_t        i    = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const __m128i Pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( Source_Ptr + i ) );
+    __m128i       Out    = Fill;
+
+    for ( int Byte = 0; Byte != 4; ++Byte )
+    {
+      Out = _mm_or_si128( Out, _mm_sll_epi32( _mm_and_si128( _mm_srl_epi32( Pixels, SourceShift[Byte] ), Keep[Byte] ), DestinationShift[Byte] ) );
+    }
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( Destination_Ptr + i ), Out );
+  }
+
+  Swizzle_Scalar( Source_Ptr + i, Destination_Ptr + i, Count - i, Map );
+}
+
+
+static void BlendRows_SSE2( const Uint32* Top_Ptr, const Uint32* Bottom_Ptr, Uint32* Out_Ptr, size_t Count, Uint32 Weight )
+{
+  const __m128i Zero = _mm_setzero_si128();
+  const __m128i Keep = _mm_set1_epi16( static_cast<short>( 256 - Weight ) );
+  const __m128i Take = _mm_set1_epi16( static_cast<short>( Weight ) );
+  size_t        i    = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const __m128i Top    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( Top_Ptr + i ) );
+    const __m128i Bottom = _mm_loadu_si128( reinterpret_cast<const __m128i*>( Bottom_Ptr + i ) );
+
+    // Sums reach 255 * 256: past a signed 16-bit, but shifted as unsigned
+    const __m128i Low  = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( Top, Zero ), Keep ), _mm_mullo_epi16( _mm_unpacklo_epi8( Bottom, Zero ), Take ) );
+    const __m128i High = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( Top, Zero ), Keep ), _mm_mullo_epi16( _mm_unpackhi_epi8( Bottom, Zero ), Take ) );
+
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( Out_Ptr + i ), _mm_packus_epi16( _mm_srli_epi16( Low, 8 ), _mm_srli_epi16( High, 8 ) ) );
+  }
+
+  BlendRows_Scalar( Top_Ptr + i, Bottom_Ptr + i, Out_Ptr + i, Count - i, Weight );
+}
+
+
+/**
+ * @brief The two weights of a column, each in the four 16-bit lanes of the pixel it multiplies.
+ **/
+static inline __m128i ColumnWeights_SSE2( const ScaleColumn& Column )
+{
+  const short Keep = static_cast<short>( 256 - Column.Weight );
+  const short Take = static_cast<short>( Column.Weight );
+
+  return _mm_set_epi16( Take, Take, Take, Take, Keep, Keep, Keep, Keep );
+}
+
+
+/**
+ * @brief Two columns at a time: the pair of source pixels of each is read with one 64-bit load.
+ **/
+static void BlendColumns_SSE2( const Uint32* Row_Ptr, Uint32* Out_Ptr, size_t Count, const ScaleColumn* Columns_Ptr )
+{
+  const __m128i Zero = _mm_setzero_si128();
+  size_t        i    = 0;
+
+  for ( ; i + 2 <= Count; i += 2 )
+  {
+    const ScaleColumn& First  = Columns_Ptr[i];
+    const ScaleColumn& Second = Columns_Ptr[i + 1];
+
+    const __m128i Pairs = _mm_unpacklo_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( Row_Ptr + First.Left ) ),
+                                              _mm_loadl_epi64( reinterpret_cast<const __m128i*>( Row_Ptr + Second.Left ) ) );
+
+    __m128i FirstSum  = _mm_mullo_epi16( _mm_unpacklo_epi8( Pairs, Zero ), ColumnWeights_SSE2( First ) );
+    __m128i SecondSum = _mm_mullo_epi16( _mm_unpackhi_epi8( Pairs, Zero ), ColumnWeights_SSE2( Second ) );
+
+    // Left pixel plus right pixel, in the low four lanes
+    FirstSum  = _mm_add_epi16( FirstSum,  _mm_srli_si128( FirstSum,  8 ) );
+    SecondSum = _mm_add_epi16( SecondSum, _mm_srli_si128( SecondSum, 8 ) );
+
+    const __m128i Sums = _mm_srli_epi16( _mm_unpacklo_epi64( FirstSum, SecondSum ), 8 );
+
+    _mm_storel_epi64( reinterpret_cast<__m128i*>( Out_Ptr + i ), _mm_packus_epi16( Sums, Zero ) );
+  }
+
+  BlendColumns_Scalar( Row_Ptr, Out_Ptr + i, Count - i, Columns_Ptr + i );
+}
+
+
+static void Composite_SSE2( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 Modulate )
+{
+  const __m128i Factors = _mm_set1_epi32( static_cast<int>( Modulate ) );
+  const __m128i Opaque  = _mm_set1_epi32( 0xFF );
+  size_t        i       = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    __m128i* Block_Ptr = reinterpret_cast<__m128i*>( Destination_Ptr + i );
+    const __m128i Pixels = MulBytes_SSE2( _mm_loadu_si128( reinterpret_cast<const __m128i*>( Source_Ptr + i ) ), Factors );
+
+    // 255 - alpha in every byte, as in Premultiply_SSE2
+    __m128i Keep = _mm_xor_si128( _mm_srli_epi32( Pixels, 24 ), Opaque );
+    Keep = _mm_or_si128( Keep, _mm_slli_epi32( Keep, 8 ) );
+    Keep = _mm_or_si128( Keep, _mm_slli_epi32( Keep, 16 ) );
+
+    _mm_storeu_si128( Block_Ptr, _mm_adds_epu8( Pixels, MulBytes_SSE2( _mm_loadu_si128( Block_Ptr ), Keep ) ) );
+  }
+
+  Composite_Scalar( Source_Ptr + i, Destination_Ptr + i, Count - i, Modulate );
+}
+
+
+static const PixelKernels KERNELS_SSE2{ "SSE2", ColourKey_SSE2, Tint_SSE2, Premultiply_SSE2, Swizzle_SSE2, BlendRows_SSE2, BlendColumns_SSE2, Composite_SSE2 };
+#endif
+
+
+#if defined(LPIXELOPS_AVX2)
+/*
+ * Eight pixels at a time; the last seven at most are left to the SSE2 kernels. Unpacking and
+ * packing work within each 128-bit lane, so MulBytes_AVX2 keeps the pixels in order.
+ */
+LPIXELOPS_TARGET_AVX2 static inline __m256i MulBytes_AVX2( __m256i Pixels, __m256i Factors )
+{
+  const __m256i Zero = _mm256_setzero_si256();
+  const __m256i Half = _mm256_set1_epi16( 128 );
+
+  __m256i Low  = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpacklo_epi8( Pixels, Zero ), _mm256_unpacklo_epi8( Factors, Zero ) ), Half );
+  __m256i High = _mm256_add_epi16( _mm256_mullo_epi16( _mm256_unpackhi_epi8( Pixels, Zero ), _mm256_unpackhi_epi8( Factors, Zero ) ), Half );
+
+  Low  = _mm256_srli_epi16( _mm256_add_epi16( Low,  _mm256_srli_epi16( Low,  8 ) ), 8 );
+  High = _mm256_srli_epi16( _mm256_add_epi16( High, _mm256_srli_epi16( High, 8 ) ), 8 );
+
+  return _mm256_packus_epi16( Low, High );
+}
+
+
+LPIXELOPS_TARGET_AVX2 static void ColourKey_AVX2( Uint32* Pixels_Ptr, size_t Count, Uint32 Key, Uint32 Replacement )
+{
+  const __m256i Keys         = _mm256_set1_epi32( static_cast<int>( Key ) );
+  const __m256i Replacements = _mm256_set1_epi32( static_cast<int>( Replacement ) );
+  size_t        i            = 0;
+
+  for ( ; i + 8 <= Count; i += 8 )
+  {
+    __m256i* Block_Ptr = reinterpret_cast<__m256i*>( Pixels_Ptr + i );
+    const __m256i Pixels = _mm256_loadu_si256( Block_Ptr );
+
+    _mm256_storeu_si256( Block_Ptr, _mm256_blendv_epi8( Pixels, Replacements, _mm256_cmpeq_epi32( Pixels, Keys ) ) );
+  }
+
+  ColourKey_SSE2( Pixels_Ptr + i, Count - i, Key, Replacement );
+}
+
+
+LPIXELOPS_TARGET_AVX2 static void Tint_AVX2( Uint32* Pixels_Ptr, size_t Count, Uint32 Tint )
+{
+  const __m256i Factors = _mm256_set1_epi32( static_cast<int>( Tint ) );
+  size_t        i       = 0;
+
+  for ( ; i + 8 <= Count; i += 8 )
+  {
+    __m256i* Block_Ptr = reinterpret_cast<__m256i*>( Pixels_Ptr + i );
+
+    _mm256_storeu_si256( Block_Ptr, MulBytes_AVX2( _mm256_loadu_si256( Block_Ptr ), Factors ) );
+  }
+
+  Tint_SSE2( Pixels_Ptr + i, Count - i, Tint );
+}
+
+
+LPIXELOPS_TARGET_AVX2 static void Premultiply_AVX2( Uint32* Pixels_Ptr, size_t Count, Uint32 AlphaShift )
+{
+  const __m128i Shift     = _mm_cvtsi32_si128( static_cast<int>( AlphaShift ) );
+  const __m256i ByteMask  = _mm256_set1_epi32( 0xFF );
+  const __m256i Spread    = _mm256_set1_epi32( 0x01010101 );
+  const __m256i AlphaMask = _mm256_set1_epi32( static_cast<int>( 0xFFu << AlphaShift ) );
+  size_t        i         = 0;
+
+  for ( ; i + 8 <= Count; i += 8 )
+  {
+    __m256i* Block_Ptr = reinterpret_cast<__m256i*>( Pixels_Ptr + i );
+    const __m256i Pixels = _mm256_loadu_si256( Block_Ptr );
+    const __m256i Alpha  = _mm256_mullo_epi32( _mm256_and_si256( _mm256_srl_epi32( Pixels, Shift ), ByteMask ), Spread );
+
+    _mm256_storeu_si256( Block_Ptr, MulBytes_AVX2( Pixels, _mm256_or_si256( Alpha, AlphaMask ) ) );
+  }
+
+  Premultiply_SSE2( Pixels_Ptr + i, Count - i, AlphaShift );
+}
+
+
+/**
+ * @brief One byte shuffle per eight pixels; unmapped bytes are zeroed by the shuffle, then filled.
+ **/
+LPIXELOPS_TARGET_AVX2 static void Swizzle_AVX2( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, const ByteMap& Map )
+{
+  alignas(32) Uint8 Control[32];
+
+  for ( int Byte = 0; Byte != 32; ++Byte )
+  {
+    const Uint8 Source = Map.Source[Byte % 4];
+
+    // Indices are within the 128-bit lane: pixel ( Byte / 4 ) % 4 of the lane
+    Control[Byte] = ( Source == NO_BYTE ) ? NO_BYTE : static_cast<Uint8>( 4 * ( ( Byte / 4 ) % 4 ) + Source );
+  }
+
+  const __m256i Shuffle = _mm256_load_si256( reinterpret_cast<const __m256i*>( Control ) );
+  const __m256i Fill    = _mm256_set1_epi32( static_cast<int>( Map.Fill ) );
+  size_t        i       = 0;
+
+  for ( ; i + 8 <= Count; i += 8 )
+  {
+    const __m256i Pixels = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( Source_Ptr + i ) );
+
+    _mm256_storeu_si256( reinterpret_cast<__m256i*>( Destination_Ptr + i ), _mm256_or_si256( _mm256_shuffle_epi8( Pixels, Shuffle ), Fill ) );
+  }
+
+  Swizzle_SSE2( Source_Ptr + i, Destination_Ptr + i, Count - i, Map );
+}
+
+
+LPIXELOPS_TARGET_AVX2 static void Composite_AVX2( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 Modulate )
+{
+  const __m256i Factors = _mm256_set1_epi32( static_cast<int>( Modulate ) );
+  const __m256i Opaque  = _mm256_set1_epi32( 0xFF );
+  const __m256i Spread  = _mm256_set1_epi32( 0x01010101 );
+  size_t        i       = 0;
+
+  for ( ; i + 8 <= Count; i += 8 )
+  {
+    __m256i* Block_Ptr = reinterpret_cast<__m256i*>( Destination_Ptr + i );
+    const __m256i Pixels = MulBytes_AVX2( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( Source_Ptr + i ) ), Factors );
+    const __m256i Keep   = _mm256_mullo_epi32( _mm256_xor_si256( _mm256_srli_epi32( Pixels, 24 ), Opaque ), Spread );
+
+    _mm256_storeu_si256( Block_Ptr, _mm256_adds_epu8( Pixels, MulBytes_AVX2( _mm256_loadu_si256( Block_Ptr ), Keep ) ) );
+  }
+
+  Composite_SSE2( Source_Ptr + i, Destination_Ptr + i, Count - i, Modulate );
+}
+
+
+// Scaling is bound by its loads, pixel by pixel for the columns: it keeps the SSE2 kernels
+static const PixelKernels KERNELS_AVX2{ "AVX2", ColourKey_AVX2, Tint_AVX2, Premultiply_AVX2, Swizzle_AVX2, BlendRows_SSE2, BlendColumns_SSE2, Composite_AVX2 };
+#endif
+
+
+#if defined(LPIXELOPS_NEON)
+/**
+ * @brief MulByte on 16 bytes: ( p + ( ( p + 128 ) >> 8 ) + 128 ) >> 8, p being each product.
+ **/
+static inline uint32x4_t MulBytes_NEON( uint32x4_t Pixels, uint32x4_t Factors )
+{
+  const uint8x16_t Bytes    = vreinterpretq_u8_u32( Pixels );
+  const uint8x16_t Multiply = vreinterpretq_u8_u32( Factors );
+  const uint16x8_t Low      = vmull_u8( vget_low_u8 ( Bytes ), vget_low_u8 ( Multiply ) );
+  const uint16x8_t High     = vmull_u8( vget_high_u8( Bytes ), vget_high_u8( Multiply ) );
+
+  return vreinterpretq_u32_u8( vcombine_u8( vraddhn_u16( Low,  vrshrq_n_u16( Low,  8 ) ),
+                                            vraddhn_u16( High, vrshrq_n_u16( High, 8 ) ) ) );
+}
+
+
+static void ColourKey_NEON( Uint32* Pixels_Ptr, size_t Count, Uint32 Key, Uint32 Replacement )
+{
+  const uint32x4_t Keys         = vdupq_n_u32( Key );
+  const uint32x4_t Replacements = vdupq_n_u32( Replacement );
+  size_t           i            = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const uint32x4_t Pixels = vld1q_u32( Pixels_Ptr + i );
+
+    vst1q_u32( Pixels_Ptr + i, vbslq_u32( vceqq_u32( Pixels, Keys ), Replacements, Pixels ) );
+  }
+
+  ColourKey_Scalar( Pixels_Ptr + i, Count - i, Key, Replacement );
+}
+
+
+static void Tint_NEON( Uint32* Pixels_Ptr, size_t Count, Uint32 Tint )
+{
+  const uint32x4_t Factors = vdupq_n_u32( Tint );
+  size_t           i       = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    vst1q_u32( Pixels_Ptr + i, MulBytes_NEON( vld1q_u32( Pixels_Ptr + i ), Factors ) );
+  }
+
+  Tint_Scalar( Pixels_Ptr + i, Count - i, Tint );
+}
+
+
+static void Premultiply_NEON( Uint32* Pixels_Ptr, size_t Count, Uint32 AlphaShift )
+{
+  const int32x4_t  Shift     = vdupq_n_s32( -static_cast<int>( AlphaShift ) );
+  const uint32x4_t ByteMask  = vdupq_n_u32( 0xFF );
+  const uint32x4_t AlphaMask = vdupq_n_u32( 0xFFu << AlphaShift );
+  size_t           i         = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const uint32x4_t Pixels = vld1q_u32( Pixels_Ptr + i );
+    const uint32x4_t Alpha  = vmulq_n_u32( vandq_u32( vshlq_u32( Pixels, Shift ), ByteMask ), 0x01010101u );
+
+    vst1q_u32( Pixels_Ptr + i, MulBytes_NEON( Pixels, vorrq_u32( Alpha, AlphaMask ) ) );
+  }
+
+  Premultiply_Scalar( Pixels_Ptr + i, Count - i, AlphaShift );
+}
+
+
+/**
+ * @brief As Swizzle_SSE2; negative shift counts shift right.
+ **/
+static void Swizzle_NEON( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, const ByteMap& Map )
+{
+  int32x4_t  SourceShift[4];
+  int32x4_t  DestinationShift[4];
+  uint32x4_t Keep[4];
+
+  for ( int Byte = 0; Byte != 4; ++Byte )
+  {
+    const bool Mapped = ( Map.Source[Byte] != NO_BYTE );
+
+    SourceShift[Byte]      = vdupq_n_s32( Mapped ? -8 * Map.Source[Byte] : 0 );
+    DestinationShift[Byte] = vdupq_n_s32( 8 * Byte );
+    Keep[Byte]             = vdupq_n_u32( Mapped ? 0xFF : 0 );
+  }
+
+  const uint32x4_t Fill = vdupq_n_u32( Map.Fill );
+  size_t           i    = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const uint32x4_t Pixels = vld1q_u32( Source_Ptr + i );
+    uint32x4_t       Out    = Fill;
+
+    for ( int Byte = 0; Byte != 4; ++Byte )
+    {
+      Out = vorrq_u32( Out, vshlq_u32( vandq_u32( vshlq_u32( Pixels, SourceShift[Byte] ), Keep[Byte] ), DestinationShift[Byte] ) );
+    }
+
+    vst1q_u32( Destination_Ptr + i, Out );
+  }
+
+  Swizzle_Scalar( Source_Ptr + i, Destination_Ptr + i, Count - i, Map );
+}
+
+
+static void BlendRows_NEON( const Uint32* Top_Ptr, const Uint32* Bottom_Ptr, Uint32* Out_Ptr, size_t Count, Uint32 Weight )
+{
+  const uint16x8_t Keep = vdupq_n_u16( static_cast<uint16_t>( 256 - Weight ) );
+  const uint16x8_t Take = vdupq_n_u16( static_cast<uint16_t>( Weight ) );
+  size_t           i    = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const uint8x16_t Top    = vreinterpretq_u8_u32( vld1q_u32( Top_Ptr + i ) );
+    const uint8x16_t Bottom = vreinterpretq_u8_u32( vld1q_u32( Bottom_Ptr + i ) );
+
+    const uint16x8_t Low  = vmlaq_u16( vmulq_u16( vmovl_u8( vget_low_u8 ( Top ) ), Keep ), vmovl_u8( vget_low_u8 ( Bottom ) ), Take );
+    const uint16x8_t High = vmlaq_u16( vmulq_u16( vmovl_u8( vget_high_u8( Top ) ), Keep ), vmovl_u8( vget_high_u8( Bottom ) ), Take );
+
+    vst1q_u32( Out_Ptr + i, vreinterpretq_u32_u8( vcombine_u8( vshrn_n_u16( Low, 8 ), vshrn_n_u16( High, 8 ) ) ) );
+  }
+
+  BlendRows_Scalar( Top_Ptr + i, Bottom_Ptr + i, Out_Ptr + i, Count - i, Weight );
+}
+
+
+/**
+ * @brief As BlendColumns_SSE2, one column at a time.
+ **/
+static void BlendColumns_NEON( const Uint32* Row_Ptr, Uint32* Out_Ptr, size_t Count, const ScaleColumn* Columns_Ptr )
+{
+  for ( size_t i = 0; i != Count; ++i )
+  {
+    const ScaleColumn& Column = Columns_Ptr[i];
+
+    const uint16x8_t Pair    = vmovl_u8( vld1_u8( reinterpret_cast<const uint8_t*>( Row_Ptr + Column.Left ) ) );
+    const uint16x8_t Weights = vcombine_u16( vdup_n_u16( static_cast<uint16_t>( 256 - Column.Weight ) ), vdup_n_u16( static_cast<uint16_t>( Column.Weight ) ) );
+    const uint16x8_t Product = vmulq_u16( Pair, Weights );
+    const uint16x4_t Sum     = vshr_n_u16( vadd_u16( vget_low_u16( Product ), vget_high_u16( Product ) ), 8 );
+
+    vst1_lane_u32( Out_Ptr + i, vreinterpret_u32_u8( vmovn_u16( vcombine_u16( Sum, Sum ) ) ), 0 );
+  }
+}
+
+
+static void Composite_NEON( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 Modulate )
+{
+  const uint32x4_t Factors = vdupq_n_u32( Modulate );
+  const uint32x4_t Opaque  = vdupq_n_u32( 0xFF );
+  size_t           i       = 0;
+
+  for ( ; i + 4 <= Count; i += 4 )
+  {
+    const uint32x4_t Pixels = MulBytes_NEON( vld1q_u32( Source_Ptr + i ), Factors );
+    const uint32x4_t Keep   = vmulq_n_u32( veorq_u32( vshrq_n_u32( Pixels, 24 ), Opaque ), 0x01010101u );
+    const uint32x4_t Kept   = MulBytes_NEON( vld1q_u32( Destination_Ptr + i ), Keep );
+
+    vst1q_u32( Destination_Ptr + i, vreinterpretq_u32_u8( vqaddq_u8( vreinterpretq_u8_u32( Pixels ), vreinterpretq_u8_u32( Kept ) ) ) );
+  }
+
+  Composite_Scalar( Source_Ptr + i, Destination_Ptr + i, Count - i, Modulate );
+}
+
+
+static const PixelKernels KERNELS_NEON{ "NEON", ColourKey_NEON, Tint_NEON, Premultiply_NEON, Swizzle_NEON, BlendRows_NEON, BlendColumns_NEON, Composite_NEON };
+#endif
+
+
+#if !defined(LPIXELOPS_SSE2) && !defined(LPIXELOPS_NEON)
+static const PixelKernels KERNELS_SCALAR{ "Scalar", ColourKey_Scalar, Tint_Scalar, Premultiply_Scalar, Swizzle_Scalar, BlendRows_Scalar, BlendColumns_Scalar, Composite_Scalar };
+#endif
+
+
+/**
+ * @brief The best kernels for this CPU. SSE2 and NEON are there whenever the compiler targets them;
+ * AVX2 is checked at runtime.
+ **/
+static const PixelKernels& ChooseKernels( void )
+{
+#if defined(LPIXELOPS_AVX2)
+  if ( SDL_HasAVX2() )
+  {
+    return KERNELS_AVX2;
+  }
+  else
+  {;}
+#endif
+
+#if defined(LPIXELOPS_SSE2)
+  return KERNELS_SSE2;
+#elif defined(LPIXELOPS_NEON)
+  return KERNELS_NEON;
+#else
+  return KERNELS_SCALAR;
+#endif
+}
+
+
+static const PixelKernels& Kernels( void )
+{
+  static const PixelKernels& Chosen = ChooseKernels();
+
+  return Chosen;
+}
+
+
+/**
+ * @brief The shift of the red, green, blue and alpha byte of a format, -1 for a missing channel.
+ *
+ * @return false unless the format has 32 bits per pixel and 8 bits per channel.
+ **/
+static bool GetByteShifts( Uint32 Format, int Shifts[4] )
+{
+  int    Bits = 0;
+  Uint32 Masks[4];
+
+  if ( SDL_PixelFormatEnumToMasks( Format, &Bits, &Masks[0], &Masks[1], &Masks[2], &Masks[3] ) == SDL_FALSE || Bits != 32 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  for ( int Channel = 0; Channel != 4; ++Channel )
+  {
+    Shifts[Channel] = -1;
+
+    for ( int Shift = 0; Shift != 32; Shift += 8 )
+    {
+      if ( Masks[Channel] == ( 0xFFu << Shift ) )
+      {
+        Shifts[Channel] = Shift;
+      }
+      else
+      {;}
+    }
+
+    if ( Masks[Channel] != 0 && Shifts[Channel] < 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief A cache line, at least 64 bytes: two bands never write to the same one.
+ **/
+static size_t GetCacheLine( void )
+{
+  const int Line = SDL_GetCPUCacheLineSize();
+
+  return ( Line > 64 && ( Line & ( Line - 1 ) ) == 0 ) ? static_cast<size_t>( Line ) : 64;
+}
+
+
+struct PixelBand
+{
+  Uint32*            Pixels_Ptr;
+  size_t             Count;
+  LPixelBandFunction Function;
+  void*              Data;
+};
+
+
+static void RunPixelBand( void* Data )
+{
+  const PixelBand& Band = *static_cast<const PixelBand*>( Data );
+
+  Band.Function( Band.Pixels_Ptr, Band.Count, Band.Data );
+}
+
+
+struct ColourKeyParameters
+{
+  Uint32 Key;
+  Uint32 Replacement;
+};
+
+
+static void ColourKeyBand( Uint32* Pixels_Ptr, size_t Count, void* Data )
+{
+  const ColourKeyParameters& Parameters = *static_cast<const ColourKeyParameters*>( Data );
+
+  Kernels().ColourKey( Pixels_Ptr, Count, Parameters.Key, Parameters.Replacement );
+}
+
+
+static void TintBand( Uint32* Pixels_Ptr, size_t Count, void* Data )
+{
+  Kernels().Tint( Pixels_Ptr, Count, *static_cast<const Uint32*>( Data ) );
+}
+
+
+static void PremultiplyBand( Uint32* Pixels_Ptr, size_t Count, void* Data )
+{
+  Kernels().Premultiply( Pixels_Ptr, Count, *static_cast<const Uint32*>( Data ) );
+}
+
+
+static void SwizzleBand( Uint32* Pixels_Ptr, size_t Count, void* Data )
+{
+  Kernels().Swizzle( Pixels_Ptr, Pixels_Ptr, Count, *static_cast<const ByteMap*>( Data ) );
+}
+
+
+/**
+ * @brief Which byte of the destination takes which byte of the source, for SwizzlePixels.
+ *
+ * @return false if either format is not 32 bits, 8 per channel.
+ **/
+static bool GetByteMap( Uint32 SourceFormat, Uint32 DestinationFormat, ByteMap& Map )
+{
+  int SourceShifts[4];
+  int DestinationShifts[4];
+
+  if ( !GetByteShifts( SourceFormat, SourceShifts ) || !GetByteShifts( DestinationFormat, DestinationShifts ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Map = ByteMap{ { NO_BYTE, NO_BYTE, NO_BYTE, NO_BYTE }, 0 };
+
+  for ( int Channel = 0; Channel != 4; ++Channel )
+  {
+    if ( DestinationShifts[Channel] >= 0 && SourceShifts[Channel] >= 0 )
+    {
+      Map.Source[DestinationShifts[Channel] / 8] = static_cast<Uint8>( SourceShifts[Channel] / 8 );
+    }
+    else
+    {;}
+  }
+
+  for ( int Byte = 0; Byte != 4; ++Byte )
+  {
+    if ( Map.Source[Byte] == NO_BYTE )
+    {
+      Map.Fill |= 0xFFu << ( 8 * Byte );
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Replaces every pixel equal to Key with Replacement: e.g., the colour key with the same
+ * colour, transparent.
+ **/
+void ApplyColourKey( Uint32* Pixels_Ptr, size_t Count, Uint32 Key, Uint32 Replacement )
+{
+  Kernels().ColourKey( Pixels_Ptr, Count, Key, Replacement );
+}
+
+
+/**
+ * @brief Multiplies every channel by the same channel of Tint, 255 standing for 1, as
+ * SDL_SetTextureColorMod and SDL_SetTextureAlphaMod do when rendering.
+ **/
+void TintPixels( Uint32* Pixels_Ptr, size_t Count, Uint32 Tint )
+{
+  Kernels().Tint( Pixels_Ptr, Count, Tint );
+}
+
+
+/**
+ * @brief Multiplies the colour channels by alpha, for blending with premultiplied alpha.
+ *
+ * @param Format Format of the pixels.
+ * @return false if the format has no alpha or is not 8 bits per channel: the pixels are unchanged.
+ **/
+bool PremultiplyAlpha( Uint32* Pixels_Ptr, size_t Count, Uint32 Format )
+{
+  int Shifts[4];
+
+  if ( !GetByteShifts( Format, Shifts ) || Shifts[3] < 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Kernels().Premultiply( Pixels_Ptr, Count, static_cast<Uint32>( Shifts[3] ) );
+
+  return true;
+}
+
+
+/**
+ * @brief Converts pixels between two formats of 8 bits per channel by moving their bytes, e.g. from
+ * ABGR8888 to ARGB8888. The channels the source lacks, and the padding, are set to 0xFF.
+ *
+ * @param Source_Ptr      May be the same as Destination_Ptr, to convert in place.
+ * @return false if either format is not 32 bits, 8 per channel: nothing is written.
+ **/
+bool SwizzlePixels( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 SourceFormat, Uint32 DestinationFormat )
+{
+  ByteMap Map;
+
+  if ( !GetByteMap( SourceFormat, DestinationFormat, Map ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Kernels().Swizzle( Source_Ptr, Destination_Ptr, Count, Map );
+
+  return true;
+}
+
+
+/**
+ * @brief Scales an image of 32-bit pixels to another size, e.g. a picture to the window surface:
+ * the software counterpart of letting the renderer stretch a texture. Smooth scaling is bilinear,
+ * centred on the pixels as the renderer's linear filtering is; otherwise, nearest neighbour.
+ *
+ * Bilinear scaling goes a destination row at a time: the two source rows around it are blended
+ * into one, then each column is blended from the two pixels around it. The bytes are blended alike,
+ * whatever the format: alpha is not premultiplied, so only opaque images are exact at the edges.
+ *
+ * It costs a pass over the destination: cache the result, and scale again only when a size changes.
+ *
+ * @param Source_Ptr      Rows of SourcePitch bytes.
+ * @param Destination_Ptr Rows of DestinationPitch bytes; must not overlap the source.
+ * @return false if a size is empty or a pitch is shorter than its row: nothing is written.
+ **/
+bool ScalePixels( const void* Source_Ptr, int SourceW, int SourceH, int SourcePitch,
+                  void* Destination_Ptr, int DestinationW, int DestinationH, int DestinationPitch, bool Smooth )
+{
+  if ( SourceW <= 0 || SourceH <= 0 || DestinationW <= 0 || DestinationH <= 0
+       || SourcePitch < 4 * SourceW || DestinationPitch < 4 * DestinationW )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Uint8* const Source      = static_cast<const Uint8*>( Source_Ptr );
+  Uint8* const       Destination = static_cast<Uint8*>( Destination_Ptr );
+
+  // 16.16 fixed point source coordinates, per destination column and row
+  const Sint64 StepX = ( static_cast<Sint64>( SourceW ) << 16 ) / DestinationW;
+  const Sint64 StepY = ( static_cast<Sint64>( SourceH ) << 16 ) / DestinationH;
+
+  if ( !Smooth )
+  {
+    std::vector<Uint32> Columns( static_cast<size_t>( DestinationW ) );
+
+    for ( int x = 0; x != DestinationW; ++x )
+    {
+      Columns[x] = static_cast<Uint32>( std::min<Sint64>( ( x * StepX + StepX / 2 ) >> 16, SourceW - 1 ) );
+    }
+
+    for ( int y = 0; y != DestinationH; ++y )
+    {
+      const Sint64  Row     = std::min<Sint64>( ( y * StepY + StepY / 2 ) >> 16, SourceH - 1 );
+      const Uint32* Row_Ptr = reinterpret_cast<const Uint32*>( Source + Row * SourcePitch );
+      Uint32*       Out_Ptr = reinterpret_cast<Uint32*>( Destination + static_cast<Sint64>( y ) * DestinationPitch );
+
+      for ( int x = 0; x != DestinationW; ++x )
+      {
+        Out_Ptr[x] = Row_Ptr[Columns[x]];
+      }
+    }
+
+    return true;
+  }
+  else
+  {;}
+
+  // Centre of the pixel, moved back by half a source pixel; clamped at the edges, which the
+  // repeated last pixel of Blended also covers
+  std::vector<ScaleColumn> Columns( static_cast<size_t>( DestinationW ) );
+
+  for ( int x = 0; x != DestinationW; ++x )
+  {
+    const Sint64 Position = std::max<Sint64>( x * StepX + StepX / 2 - 0x8000, 0 );
+    const Sint64 Left     = std::min<Sint64>( Position >> 16, SourceW - 1 );
+
+    Columns[x] = ScaleColumn{ static_cast<Uint32>( Left ), ( Left == SourceW - 1 ) ? 0 : static_cast<Uint32>( ( Position >> 8 ) & 0xFF ) };
+  }
+
+  const PixelKernels& Chosen = Kernels();
+  std::vector<Uint32> Blended( static_cast<size_t>( SourceW ) + 1 );
+
+  for ( int y = 0; y != DestinationH; ++y )
+  {
+    const Sint64  Position   = std::max<Sint64>( y * StepY + StepY / 2 - 0x8000, 0 );
+    const Sint64  Top        = std::min<Sint64>( Position >> 16, SourceH - 1 );
+    const Sint64  Bottom     = std::min<Sint64>( Top + 1, SourceH - 1 );
+    const Uint32  Weight     = ( Top == Bottom ) ? 0 : static_cast<Uint32>( ( Position >> 8 ) & 0xFF );
+    const Uint32* Top_Ptr    = reinterpret_cast<const Uint32*>( Source + Top * SourcePitch );
+    const Uint32* Bottom_Ptr = reinterpret_cast<const Uint32*>( Source + Bottom * SourcePitch );
+
+    if ( Weight == 0 )
+    {
+      std::copy( Top_Ptr, Top_Ptr + SourceW, Blended.begin() );
+    }
+    else
+    {
+      Chosen.BlendRows( Top_Ptr, Bottom_Ptr, Blended.data(), static_cast<size_t>( SourceW ), Weight );
+    }
+
+    Blended[SourceW] = Blended[SourceW - 1];
+
+    Chosen.BlendColumns( Blended.data(), reinterpret_cast<Uint32*>( Destination + static_cast<Sint64>( y ) * DestinationPitch ),
+                         static_cast<size_t>( DestinationW ), Columns.data() );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Halves an image of 32-bit pixels, for the next level of a mip chain: every destination
+ * pixel is the average of a 2x2 block of the source. Odd sizes drop the last column or row, as the
+ * levels of an OpenGL texture do; a side of 1 pixel stays 1, its pixels averaged twice.
+ *
+ * The colours are weighted by their alpha, so that the transparent pixels around a sprite, which
+ * keep the colour they had before keying (cyan), do not bleed into its edges at the smaller levels.
+ * Formats without alpha are averaged plainly.
+ *
+ * @param Source_Ptr      Rows of SourcePitch bytes.
+ * @param Destination_Ptr Rows of DestinationPitch bytes; must not overlap the source.
+ * @param Format          SDL_PIXELFORMAT_* of both, 32 bits per pixel.
+ * @return false if a size is empty, a pitch is shorter than its row or the format is not 32 bits:
+ * nothing is written.
+ **/
+bool HalvePixels( const void* Source_Ptr, int SourceW, int SourceH, int SourcePitch,
+                  void* Destination_Ptr, int DestinationPitch, Uint32 Format )
+{
+  const int DestinationW = std::max( SourceW / 2, 1 );
+  const int DestinationH = std::max( SourceH / 2, 1 );
+  int       Shifts[4];
+
+  if ( SourceW <= 0 || SourceH <= 0 || SourcePitch < 4 * SourceW || DestinationPitch < 4 * DestinationW
+       || !GetByteShifts( Format, Shifts ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Uint8* const Source      = static_cast<const Uint8*>( Source_Ptr );
+  Uint8* const       Destination = static_cast<Uint8*>( Destination_Ptr );
+  const int          AlphaShift  = Shifts[3];
+
+  for ( int y = 0; y != DestinationH; ++y )
+  {
+    const Uint32* Top_Ptr    = reinterpret_cast<const Uint32*>( Source + static_cast<Sint64>( 2 * y ) * SourcePitch );
+    const Uint32* Bottom_Ptr = reinterpret_cast<const Uint32*>( Source + static_cast<Sint64>( std::min( 2 * y + 1, SourceH - 1 ) ) * SourcePitch );
+    Uint32*       Out_Ptr    = reinterpret_cast<Uint32*>( Destination + static_cast<Sint64>( y ) * DestinationPitch );
+
+    for ( int x = 0; x != DestinationW; ++x )
+    {
+      const int    Left     = 2 * x;
+      const int    Right    = std::min( Left + 1, SourceW - 1 );
+      const Uint32 Block[4] = { Top_Ptr[Left], Top_Ptr[Right], Bottom_Ptr[Left], Bottom_Ptr[Right] };
+      Uint32       Weights[4];
+      Uint32       TotalWeight = 0;
+      Uint32       Out         = 0;
+
+      for ( int i = 0; i != 4; ++i )
+      {
+        Weights[i]   = ( AlphaShift >= 0 ) ? ( Block[i] >> AlphaShift ) & 0xFF : 1;
+        TotalWeight += Weights[i];
+      }
+
+      // A block transparent throughout keeps the plain average of its colours
+      if ( TotalWeight == 0 )
+      {
+        for ( Uint32& Weight : Weights )
+        {
+          Weight = 1;
+        }
+
+        TotalWeight = 4;
+      }
+      else
+      {;}
+
+      for ( int Shift = 0; Shift != 32; Shift += 8 )
+      {
+        Uint32 Sum = 0;
+
+        if ( Shift == AlphaShift )
+        {
+          for ( const Uint32 Pixel : Block )
+          {
+            Sum += ( Pixel >> Shift ) & 0xFF;
+          }
+
+          Out |= ( ( Sum + 2 ) / 4 ) << Shift;
+        }
+        else
+        {
+          for ( int i = 0; i != 4; ++i )
+          {
+            Sum += ( ( Block[i] >> Shift ) & 0xFF ) * Weights[i];
+          }
+
+          Out |= ( ( Sum + TotalWeight / 2 ) / TotalWeight ) << Shift;
+        }
+      }
+
+      Out_Ptr[x] = Out;
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Turns an image of 32-bit pixels into 8-bit indices into a palette of its colours, for
+ * textures whose colours are resolved by a lookup when drawn. The colours are numbered in the order
+ * they are first met, rows from the top; all the fully transparent pixels share one entry, {0, 0, 0,
+ * 0}, whatever colour they kept from before keying.
+ *
+ * @param Indices_Ptr Rows of IndexPitch bytes, one per pixel.
+ * @param Palette_Ptr 256 entries, of which the return value are written; formats without alpha get
+ * opaque colours.
+ * @return the number of colours, 1 to 256; 0 if the image has more than 256 colours, a size is empty,
+ * a pitch is shorter than its row or the format is not 32 bits (the indices are then incomplete).
+ **/
+int IndexPixels( const void* Source_Ptr, int Width, int Height, int SourcePitch, Uint32 Format,
+                 Uint8* Indices_Ptr, int IndexPitch, SDL_Color* Palette_Ptr )
+{
+  int Shifts[4];
+
+  if ( Width <= 0 || Height <= 0 || SourcePitch < 4 * Width || IndexPitch < Width || !GetByteShifts( Format, Shifts ) )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  const Uint8* const Source     = static_cast<const Uint8*>( Source_Ptr );
+  const Uint32       AlphaMask  = ( Shifts[3] >= 0 ) ? 0xFFu << Shifts[3] : 0;
+  Uint32             Colours[256];
+  int                Count      = 0;
+  int                Last       = 0;   // Index of the previous pixel: runs of a colour are common
+
+  for ( int y = 0; y != Height; ++y )
+  {
+    const Uint32* Row_Ptr = reinterpret_cast<const Uint32*>( Source + static_cast<Sint64>( y ) * SourcePitch );
+    Uint8*        Out_Ptr = Indices_Ptr + static_cast<Sint64>( y ) * IndexPitch;
+
+    for ( int x = 0; x != Width; ++x )
+    {
+      // Transparent pixels all become the same colour, transparent black
+      const Uint32 Pixel = ( AlphaMask != 0 && ( Row_Ptr[x] & AlphaMask ) == 0 ) ? 0 : Row_Ptr[x];
+      int          Index = ( Count != 0 && Colours[Last] == Pixel ) ? Last : 0;
+
+      while ( Index != Count && Colours[Index] != Pixel )
+      {
+        ++Index;
+      }
+
+      if ( Index == Count )
+      {
+        if ( Count == 256 )
+        {
+          return 0;
+        }
+        else
+        {;}
+
+        Colours[Count++] = Pixel;
+      }
+      else
+      {;}
+
+      Out_Ptr[x] = static_cast<Uint8>( Index );
+      Last       = Index;
+    }
+  }
+
+  for ( int i = 0; i != Count; ++i )
+  {
+    Palette_Ptr[i].r = static_cast<Uint8>( Colours[i] >> Shifts[0] );
+    Palette_Ptr[i].g = static_cast<Uint8>( Colours[i] >> Shifts[1] );
+    Palette_Ptr[i].b = static_cast<Uint8>( Colours[i] >> Shifts[2] );
+    Palette_Ptr[i].a = ( Shifts[3] >= 0 ) ? static_cast<Uint8>( Colours[i] >> Shifts[3] ) : 0xFF;
+  }
+
+  return Count;
+}
+
+
+/**
+ * @brief Blends a run of pixels over another, e.g. a sprite's row over the frame: the source, with
+ * premultiplied alpha, is multiplied by Modulate (as TintPixels does), then added to what the
+ * destination keeps of itself, 255 - alpha of the source. The alpha byte is the high one, as in
+ * ARGB8888; a destination without alpha (RGB888) just gets its padding byte blended too.
+ *
+ * @param Source_Ptr      Must not overlap the destination, unless it is the destination.
+ **/
+void CompositePixels( const Uint32* Source_Ptr, Uint32* Destination_Ptr, size_t Count, Uint32 Modulate )
+{
+  Kernels().Composite( Source_Ptr, Destination_Ptr, Count, Modulate );
+}
+
+
+/**
+ * @brief Blends two runs of pixels into a third, Weight / 256 of the way from the first to the
+ * second, byte by byte: the vertical step of bilinear filtering.
+ *
+ * @param Weight 0..256.
+ **/
+void LerpPixels( const Uint32* First_Ptr, const Uint32* Second_Ptr, Uint32* Out_Ptr, size_t Count, Uint32 Weight )
+{
+  Kernels().BlendRows( First_Ptr, Second_Ptr, Out_Ptr, Count, std::min<Uint32>( Weight, 256 ) );
+}
+
+
+/**
+ * @return The instruction set of the kernels in use: "AVX2", "SSE2", "NEON" or "Scalar".
+ **/
+const char* GetPixelOpsKernel( void )
+{
+  return Kernels().Name;
+}
+
+
+/**
+ * @brief Runs Function on bands of the rows, on the workers of Jobs and on the calling thread, and
+ * returns when every band is done. Each band gets a run of whole pixels, whose ends (but for the
+ * ends of the buffer) are on cache line boundaries: no two threads write to the same line.
+ *
+ * @param Pixels_Ptr Locked pixels, 32 bits each, e.g. LTexture::getPixels.
+ * @param Pitch      Bytes per row, e.g. LTexture::getPitch.
+ * @param Rows       Number of rows.
+ * @param Data       Passed to Function with each band.
+ **/
+void ForEachPixelBand( LJobSystem& Jobs, void* Pixels_Ptr, int Pitch, int Rows, LPixelBandFunction Function, void* Data )
+{
+  Uint8* const First_Ptr = static_cast<Uint8*>( Pixels_Ptr );
+  const size_t Bytes     = static_cast<size_t>( std::max( Pitch, 0 ) ) * static_cast<size_t>( std::max( Rows, 0 ) );
+  const size_t Threads   = static_cast<size_t>( Jobs.GetWorkerCount() ) + 1;
+  const size_t Bands     = std::min( { Threads * BANDS_PER_THREAD, Bytes / MIN_BAND_BYTES, static_cast<size_t>( std::max( Rows, 0 ) ) } );
+
+  if ( Bands <= 1 || Threads == 1 )
+  {
+    Function( reinterpret_cast<Uint32*>( First_Ptr ), Bytes / 4, Data );
+    return;
+  }
+  else
+  {;}
+
+  // Inside the function up to 16 threads; beyond, on the heap, as any thread may call this
+  const size_t                Line  = GetCacheLine();
+  LSmallVector<PixelBand, 64> Work;
+  size_t                      Start = 0;
+
+  Work.reserve( Bands );
+
+  for ( size_t Band = 1; Band <= Bands; ++Band )
+  {
+    size_t End = Bytes;
+
+    // The first byte of the band's first row, moved on to the next cache line
+    if ( Band != Bands )
+    {
+      const size_t Row = static_cast<size_t>( Rows ) * Band / Bands;
+
+      End  = Row * static_cast<size_t>( Pitch );
+      End += ( Line - reinterpret_cast<uintptr_t>( First_Ptr + End ) % Line ) % Line;
+      End  = std::min( End, Bytes );
+    }
+    else
+    {;}
+
+    if ( End > Start )
+    {
+      Work.push_back( PixelBand{ reinterpret_cast<Uint32*>( First_Ptr + Start ), ( End - Start ) / 4, Function, Data } );
+      Start = End;
+    }
+    else
+    {;}
+  }
+
+  LJobCounter Done;
+
+  for ( PixelBand& Band : Work )
+  {
+    Jobs.run( RunPixelBand, &Band, &Done );
+  }
+
+  Jobs.wait( Done );
+}
+
+
+void ApplyColourKey( LJobSystem& Jobs, void* Pixels_Ptr, int Pitch, int Rows, Uint32 Key, Uint32 Replacement )
+{
+  ColourKeyParameters Parameters{ Key, Replacement };
+
+  ForEachPixelBand( Jobs, Pixels_Ptr, Pitch, Rows, ColourKeyBand, &Parameters );
+}
+
+
+void TintPixels( LJobSystem& Jobs, void* Pixels_Ptr, int Pitch, int Rows, Uint32 Tint )
+{
+  ForEachPixelBand( Jobs, Pixels_Ptr, Pitch, Rows, TintBand, &Tint );
+}
+
+
+bool PremultiplyAlpha( LJobSystem& Jobs, void* Pixels_Ptr, int Pitch, int Rows, Uint32 Format )
+{
+  int Shifts[4];
+
+  if ( !GetByteShifts( Format, Shifts ) || Shifts[3] < 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Uint32 AlphaShift = static_cast<Uint32>( Shifts[3] );
+
+  ForEachPixelBand( Jobs, Pixels_Ptr, Pitch, Rows, PremultiplyBand, &AlphaShift );
+
+  return true;
+}
+
+
+/**
+ * @brief Converts the pixels in place, from SourceFormat to DestinationFormat.
+ **/
+bool SwizzlePixels( LJobSystem& Jobs, void* Pixels_Ptr, int Pitch, int Rows, Uint32 SourceFormat, Uint32 DestinationFormat )
+{
+  ByteMap Map;
+
+  if ( !GetByteMap( SourceFormat, DestinationFormat, Map ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  ForEachPixelBand( Jobs, Pixels_Ptr, Pitch, Rows, SwizzleBand, &Map );
+
+  return true;
+}
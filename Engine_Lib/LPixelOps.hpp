@@ -0,0 +1,67 @@
+/**
+ * @file LPixelOps.hpp
+ *
+ * @brief Whole-buffer transforms of 32-bit pixels, for textures and surfaces processed at load time,
+ * and their scaling.
+ **/
+
+#ifndef LPIXELOPS_HPP
+#define LPIXELOPS_HPP
+
+#include <SDL.h>
+
+class LJobSystem;
+
+typedef void (*LPixelBandFunction)( Uint32*, size_t, void* );
+
+/*
+ * Each function works on a run of 32-bit pixels, e.g. the locked pixels of a texture: pitch / 4 *
+ * height of them, padding included. The kernel is picked at the first call from what the CPU
+ * supports, AVX2, SSE2, NEON or plain C++, and all of them give the same results.
+ *
+ * Colours given as a Uint32 are packed in the format of the pixels (SDL_MapRGBA, Colour::Pack).
+ */
+void        ApplyColourKey   ( Uint32*, size_t, Uint32, Uint32 );
+void        TintPixels       ( Uint32*, size_t, Uint32 );
+bool        PremultiplyAlpha ( Uint32*, size_t, Uint32 );
+bool        SwizzlePixels    ( const Uint32*, Uint32*, size_t, Uint32, Uint32 );
+
+/*
+ * Images of Width x Height pixels in rows of Pitch bytes, source first: scaled to the size of the
+ * destination, bilinear or nearest neighbour.
+ */
+bool        ScalePixels      ( const void*, int, int, int, void*, int, int, int, bool );
+
+/*
+ * The next level of a mip chain: an image of Width x Height pixels in rows of Pitch bytes, halved
+ * into the destination, max( Width / 2, 1 ) x max( Height / 2, 1 ) pixels in rows of its own pitch.
+ */
+bool        HalvePixels      ( const void*, int, int, int, void*, int, Uint32 );
+
+/*
+ * An image of Width x Height pixels in rows of Pitch bytes, as 8-bit indices in rows of their own
+ * pitch into a palette of up to 256 colours; returns how many, 0 if there are more.
+ */
+int         IndexPixels      ( const void*, int, int, int, Uint32, Uint8*, int, SDL_Color* );
+
+/*
+ * Runs of pixels combined, for software rendering (see LSoftRenderer): blended over others, or
+ * interpolated between two.
+ */
+void        CompositePixels  ( const Uint32*, Uint32*, size_t, Uint32 );
+void        LerpPixels       ( const Uint32*, const Uint32*, Uint32*, size_t, Uint32 );
+
+const char* GetPixelOpsKernel( void );
+
+/*
+ * The same on the workers of a job system, for buffers of Rows rows of Pitch bytes: the rows are
+ * split in bands whose edges fall on cache lines, and the calling thread runs bands too while it
+ * waits for them all. Buffers too small to be worth it are processed on the calling thread alone.
+ */
+void        ForEachPixelBand ( LJobSystem&, void*, int, int, LPixelBandFunction, void* );
+void        ApplyColourKey   ( LJobSystem&, void*, int, int, Uint32, Uint32 );
+void        TintPixels       ( LJobSystem&, void*, int, int, Uint32 );
+bool        PremultiplyAlpha ( LJobSystem&, void*, int, int, Uint32 );
+bool        SwizzlePixels    ( LJobSystem&, void*, int, int, Uint32, Uint32 );
+
+#endif // LPIXELOPS_HPP
@@ -0,0 +1,424 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LPrimitiveBatch.hpp"
+#include "LPerfHarness.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static bool IsSameColour( SDL_Color a, SDL_Color b )
+{
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LPrimitiveBatch::LPrimitiveBatch( LPrimitivePath Path )
+  : m_Path(Path), m_Buckets(), m_ActiveBuckets(0), m_Vertices(), m_Indices(), m_Shapes(0), m_LastDrawCalls(0)
+{;}
+
+
+/**
+ * @brief Changes how the shapes are submitted; the ones queued so far are discarded.
+ **/
+void LPrimitiveBatch::setPath( LPrimitivePath Path )
+{
+  begin();
+  m_Path = Path;
+}
+
+
+/**
+ * @brief Starts a new frame. Queued shapes are discarded, but the allocated storage is kept.
+ **/
+void LPrimitiveBatch::begin( void )
+{
+  for ( size_t i = 0; i != m_ActiveBuckets; ++i )
+  {
+    Bucket& Current = m_Buckets[i];
+
+    Current.Fills.clear();
+    Current.Outlines.clear();
+    Current.LinePoints.clear();
+    Current.LineRunEnds.clear();
+    Current.Points.clear();
+  }
+
+  m_ActiveBuckets = 0;
+  m_Vertices.clear();
+  m_Indices.clear();
+  m_Shapes = 0;
+}
+
+
+/**
+ * @brief Queues a point, as SDL_RenderDrawPoint.
+ **/
+void LPrimitiveBatch::addPoint( int x, int y, SDL_Color Colour )
+{
+  ++m_Shapes;
+
+  if ( m_Path == LPrimitivePath::Geometry )
+  {
+    AddQuad_Pvt( static_cast<float>( x ), static_cast<float>( y ), 1.0f, 1.0f, Colour );
+  }
+  else
+  {
+    FindBucket_Pvt( Colour ).Points.push_back( SDL_Point{ x, y } );
+  }
+}
+
+
+/**
+ * @brief Queues a line, both ends included, as SDL_RenderDrawLine.
+ **/
+void LPrimitiveBatch::addLine( int x1, int y1, int x2, int y2, SDL_Color Colour )
+{
+  ++m_Shapes;
+
+  if ( m_Path == LPrimitivePath::Geometry )
+  {
+    // A quad one pixel wide from the centre of the first end pixel to the centre of the last,
+    // stretched by half a pixel at both ends so that it covers them
+    const float Dx     = static_cast<float>( x2 - x1 );
+    const float Dy     = static_cast<float>( y2 - y1 );
+    const float Length = std::sqrt( Dx * Dx + Dy * Dy );
+
+    if ( Length == 0.0f )
+    {
+      AddQuad_Pvt( static_cast<float>( x1 ), static_cast<float>( y1 ), 1.0f, 1.0f, Colour );
+      return;
+    }
+    else
+    {;}
+
+    const float Ux = 0.5f * Dx / Length;
+    const float Uy = 0.5f * Dy / Length;
+    const float x1Centre = static_cast<float>( x1 ) + 0.5f;
+    const float y1Centre = static_cast<float>( y1 ) + 0.5f;
+    const float x2Centre = static_cast<float>( x2 ) + 0.5f;
+    const float y2Centre = static_cast<float>( y2 ) + 0.5f;
+
+    const float X[4] = { x1Centre - Ux + Uy, x2Centre + Ux + Uy, x2Centre + Ux - Uy, x1Centre - Ux - Uy };
+    const float Y[4] = { y1Centre - Uy - Ux, y2Centre + Uy - Ux, y2Centre + Uy + Ux, y1Centre - Uy + Ux };
+
+    AddQuad_Pvt( X, Y, Colour );
+    return;
+  }
+  else
+  {;}
+
+  Bucket& Current = FindBucket_Pvt( Colour );
+
+  if ( x1 == x2 || y1 == y2 )
+  {
+    Current.Fills.push_back( SDL_Rect{ SDL_min( x1, x2 ), SDL_min( y1, y2 ), std::abs( x2 - x1 ) + 1, std::abs( y2 - y1 ) + 1 } );
+  }
+  else if ( !Current.LineRunEnds.empty() && Current.LinePoints.back().x == x1 && Current.LinePoints.back().y == y1 )
+  {
+    // Joined to the end of the last run: it goes in the same SDL_RenderDrawLines call
+    Current.LinePoints.push_back( SDL_Point{ x2, y2 } );
+    Current.LineRunEnds.back() = static_cast<int>( Current.LinePoints.size() );
+  }
+  else
+  {
+    Current.LinePoints.push_back( SDL_Point{ x1, y1 } );
+    Current.LinePoints.push_back( SDL_Point{ x2, y2 } );
+    Current.LineRunEnds.push_back( static_cast<int>( Current.LinePoints.size() ) );
+  }
+}
+
+
+/**
+ * @brief Queues the outline of a rectangle, as SDL_RenderDrawRect.
+ **/
+void LPrimitiveBatch::addRect( const SDL_Rect& Rect, SDL_Color Colour )
+{
+  if ( Rect.w <= 0 || Rect.h <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  ++m_Shapes;
+
+  if ( m_Path == LPrimitivePath::DrawCalls )
+  {
+    FindBucket_Pvt( Colour ).Outlines.push_back( Rect );
+    return;
+  }
+  else
+  {;}
+
+  const float x = static_cast<float>( Rect.x );
+  const float y = static_cast<float>( Rect.y );
+  const float w = static_cast<float>( Rect.w );
+  const float h = static_cast<float>( Rect.h );
+
+  // Top and bottom rows whole, then the sides between them
+  AddQuad_Pvt( x, y, w, 1.0f, Colour );
+
+  if ( Rect.h > 1 )
+  {
+    AddQuad_Pvt( x, y + h - 1.0f, w, 1.0f, Colour );
+  }
+  else
+  {;}
+
+  if ( Rect.h > 2 )
+  {
+    AddQuad_Pvt( x, y + 1.0f, 1.0f, h - 2.0f, Colour );
+
+    if ( Rect.w > 1 )
+    {
+      AddQuad_Pvt( x + w - 1.0f, y + 1.0f, 1.0f, h - 2.0f, Colour );
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Queues a filled rectangle, as SDL_RenderFillRect.
+ **/
+void LPrimitiveBatch::addFillRect( const SDL_Rect& Rect, SDL_Color Colour )
+{
+  if ( Rect.w <= 0 || Rect.h <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  ++m_Shapes;
+
+  if ( m_Path == LPrimitivePath::Geometry )
+  {
+    AddQuad_Pvt( static_cast<float>( Rect.x ), static_cast<float>( Rect.y ), static_cast<float>( Rect.w ), static_cast<float>( Rect.h ), Colour );
+  }
+  else
+  {
+    FindBucket_Pvt( Colour ).Fills.push_back( Rect );
+  }
+}
+
+
+/**
+ * @brief Submits all the queued shapes and starts a new frame. The draw colour of the renderer is
+ * left as it was.
+ **/
+void LPrimitiveBatch::flush( SDL_Renderer* Renderer_Ptr )
+{
+  m_LastDrawCalls = 0;
+
+  if ( m_Path == LPrimitivePath::DrawCalls )
+  {
+    FlushCalls_Pvt( Renderer_Ptr );
+  }
+  else if ( !m_Indices.empty() )
+  {
+    if ( SDL_RenderGeometry( Renderer_Ptr, NULL, m_Vertices.data(), static_cast<int>( m_Vertices.size() ),
+                             m_Indices.data(), static_cast<int>( m_Indices.size() ) ) != 0 )
+    {
+      printf( "\nPrimitive batch could not be drawn! SDL Error: %s", SDL_GetError() );
+    }
+    else
+    {
+      m_LastDrawCalls = 1;
+    }
+  }
+  else
+  {;}
+
+  LPerfHarness::countDrawCalls( m_LastDrawCalls );
+
+  begin();
+}
+
+
+LPrimitivePath LPrimitiveBatch::GetPath( void ) const
+{
+  return m_Path;
+}
+
+
+/**
+ * @brief Number of shapes queued since begin.
+ **/
+size_t LPrimitiveBatch::GetShapeCount( void ) const
+{
+  return m_Shapes;
+}
+
+
+/**
+ * @brief Number of draw calls issued by the last flush.
+ **/
+int LPrimitiveBatch::GetDrawCalls( void ) const
+{
+  return m_LastDrawCalls;
+}
+
+
+/**
+ * @return Geometry for a renderer that draws on the GPU, where a single call is what counts;
+ * DrawCalls for the software renderer, whose fills and lines are cheaper than its triangles.
+ **/
+LPrimitivePath LPrimitiveBatch::GetBestPath( SDL_Renderer* Renderer_Ptr )
+{
+  SDL_RendererInfo Info;
+
+  if ( SDL_GetRendererInfo( Renderer_Ptr, &Info ) == 0 && ( Info.flags & SDL_RENDERER_ACCELERATED ) != 0
+       && strcmp( Info.name, "software" ) != 0 )
+  {
+    return LPrimitivePath::Geometry;
+  }
+  else
+  {
+    return LPrimitivePath::DrawCalls;
+  }
+}
+
+
+/**
+ * @brief Returns the bucket of a colour, activating a new one if needed.
+ **/
+LPrimitiveBatch::Bucket& LPrimitiveBatch::FindBucket_Pvt( SDL_Color Colour )
+{
+  for ( size_t i = 0; i != m_ActiveBuckets; ++i )
+  {
+    if ( IsSameColour( m_Buckets[i].Colour, Colour ) )
+    {
+      return m_Buckets[i];
+    }
+    else
+    {;}
+  }
+
+  if ( m_ActiveBuckets == m_Buckets.size() )
+  {
+    m_Buckets.emplace_back();
+  }
+  else
+  {;}
+
+  Bucket& NewBucket = m_Buckets[m_ActiveBuckets];
+  ++m_ActiveBuckets;
+
+  NewBucket.Colour = Colour;
+
+  return NewBucket;
+}
+
+
+/**
+ * @brief Appends an axis-aligned quad.
+ **/
+void LPrimitiveBatch::AddQuad_Pvt( float x, float y, float w, float h, SDL_Color Colour )
+{
+  const float X[4] = { x, x + w, x + w, x };
+  const float Y[4] = { y, y, y + h, y + h };
+
+  AddQuad_Pvt( X, Y, Colour );
+}
+
+
+/**
+ * @brief Appends the four corners of a quad, in order around it, and its two triangles.
+ **/
+void LPrimitiveBatch::AddQuad_Pvt( const float* X, const float* Y, SDL_Color Colour )
+{
+  if ( m_Vertices.capacity() == 0 )
+  {
+    m_Vertices.reserve( s_RESERVED_QUADS * 4 );
+    m_Indices.reserve ( s_RESERVED_QUADS * 6 );
+  }
+  else
+  {;}
+
+  const int First = static_cast<int>( m_Vertices.size() );
+
+  for ( int i = 0; i != 4; ++i )
+  {
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{X[i], Y[i]}, Colour, SDL_FPoint{0.0f, 0.0f} } );
+  }
+
+  m_Indices.push_back( First     );
+  m_Indices.push_back( First + 1 );
+  m_Indices.push_back( First + 2 );
+  m_Indices.push_back( First + 2 );
+  m_Indices.push_back( First + 3 );
+  m_Indices.push_back( First     );
+}
+
+
+/**
+ * @brief DrawCalls path: one colour at a time, one call per kind of shape, one per run of lines.
+ **/
+void LPrimitiveBatch::FlushCalls_Pvt( SDL_Renderer* Renderer_Ptr )
+{
+  Uint8 r = 0;
+  Uint8 g = 0;
+  Uint8 b = 0;
+  Uint8 a = 0;
+
+  SDL_GetRenderDrawColor( Renderer_Ptr, &r, &g, &b, &a );
+
+  for ( size_t i = 0; i != m_ActiveBuckets; ++i )
+  {
+    const Bucket& Current = m_Buckets[i];
+
+    SDL_SetRenderDrawColor( Renderer_Ptr, Current.Colour.r, Current.Colour.g, Current.Colour.b, Current.Colour.a );
+
+    if ( !Current.Fills.empty() )
+    {
+      SDL_RenderFillRects( Renderer_Ptr, Current.Fills.data(), static_cast<int>( Current.Fills.size() ) );
+      ++m_LastDrawCalls;
+    }
+    else
+    {;}
+
+    if ( !Current.Outlines.empty() )
+    {
+      SDL_RenderDrawRects( Renderer_Ptr, Current.Outlines.data(), static_cast<int>( Current.Outlines.size() ) );
+      ++m_LastDrawCalls;
+    }
+    else
+    {;}
+
+    int RunStart = 0;
+
+    for ( int RunEnd : Current.LineRunEnds )
+    {
+      SDL_RenderDrawLines( Renderer_Ptr, Current.LinePoints.data() + RunStart, RunEnd - RunStart );
+      ++m_LastDrawCalls;
+      RunStart = RunEnd;
+    }
+
+    if ( !Current.Points.empty() )
+    {
+      SDL_RenderDrawPoints( Renderer_Ptr, Current.Points.data(), static_cast<int>( Current.Points.size() ) );
+      ++m_LastDrawCalls;
+    }
+    else
+    {;}
+  }
+
+  SDL_SetRenderDrawColor( Renderer_Ptr, r, g, b, a );
+}
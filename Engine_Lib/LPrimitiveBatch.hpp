@@ -0,0 +1,91 @@
+/**
+ * @file LPrimitiveBatch.hpp
+ *
+ * @brief Collects points, lines and rectangles, outlined or filled, and submits them with as few
+ * draw calls as possible: debug overlays of thousands of shapes in a handful of calls.
+ **/
+
+#ifndef LPRIMITIVEBATCH_HPP
+#define LPRIMITIVEBATCH_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief How a LPrimitiveBatch submits its shapes.
+ *
+ * DrawCalls: grouped by colour, with SDL_RenderFillRects, SDL_RenderDrawRects, SDL_RenderDrawLines
+ * and SDL_RenderDrawPoints; at most four calls per colour, and the pixels are exactly those of the
+ * single calls.
+ *
+ * Geometry: every shape turned into coloured triangles on the CPU, and all of them drawn with one
+ * SDL_RenderGeometry call. The order of the shapes is kept, whatever their colour; lines that are
+ * neither horizontal nor vertical may differ from SDL's by a pixel at their ends.
+ **/
+enum class LPrimitivePath { DrawCalls, Geometry };
+
+
+/**
+ * @brief Primitive batch. Shapes queued between "begin" and "flush" are kept in arrays reused from
+ * frame to frame, so that steady-state frames do not allocate.
+ *
+ * On the DrawCalls path the colours are drawn in order of first appearance, and within a colour the
+ * filled rectangles first, then the outlines, the lines and the points. Horizontal and vertical
+ * lines, as the lines of a grid, are the same pixels as a filled rectangle one pixel wide, and are
+ * queued as such: only slanted lines need SDL_RenderDrawLines, one call for each run of lines joined
+ * end to start. Colours are few in a frame, so their lookup is a linear search.
+ *
+ * Blending is the renderer's draw blend mode (SDL_SetRenderDrawBlendMode) on both paths.
+ **/
+class LPrimitiveBatch
+{
+public:
+
+  LPrimitiveBatch( LPrimitivePath = LPrimitivePath::DrawCalls );
+
+  void setPath     ( LPrimitivePath );
+  void begin       ( void );
+  void addPoint    ( int, int, SDL_Color );
+  void addLine     ( int, int, int, int, SDL_Color );
+  void addRect     ( const SDL_Rect&, SDL_Color );
+  void addFillRect ( const SDL_Rect&, SDL_Color );
+  void flush       ( SDL_Renderer* );
+
+  LPrimitivePath GetPath       ( void ) const;
+  size_t         GetShapeCount ( void ) const;
+  int            GetDrawCalls  ( void ) const;
+
+  static LPrimitivePath GetBestPath( SDL_Renderer* );
+
+private:
+
+  /**
+   * @brief All the shapes of a colour, for the DrawCalls path.
+   **/
+  struct Bucket
+  {
+    SDL_Color              Colour{ 0, 0, 0, 0 };
+    std::vector<SDL_Rect>  Fills;
+    std::vector<SDL_Rect>  Outlines;
+    std::vector<SDL_Point> LinePoints;   // Runs of joined lines, one after the other
+    std::vector<int>       LineRunEnds;  // Where each run ends in LinePoints
+    std::vector<SDL_Point> Points;
+  };
+
+  Bucket& FindBucket_Pvt ( SDL_Color );
+  void    AddQuad_Pvt    ( float, float, float, float, SDL_Color );
+  void    AddQuad_Pvt    ( const float*, const float*, SDL_Color );
+  void    FlushCalls_Pvt ( SDL_Renderer* );
+
+  static constexpr size_t s_RESERVED_QUADS = 256;
+
+  LPrimitivePath          m_Path;
+  std::vector<Bucket>     m_Buckets;        // One entry per colour; storage is kept between frames
+  size_t                  m_ActiveBuckets;  // Entries of m_Buckets used in the current frame
+  std::vector<SDL_Vertex> m_Vertices;       // Geometry path
+  std::vector<int>        m_Indices;
+  size_t                  m_Shapes;         // Queued since begin
+  int                     m_LastDrawCalls;  // Draw calls issued by the last flush
+};
+
+#endif // LPRIMITIVEBATCH_HPP
@@ -0,0 +1,350 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LRenderTargets.hpp"
+#include "LPerfHarness.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param Renderer_Ptr The renderer the targets are created for; it can also be set later.
+ **/
+LRenderTargetPool::LRenderTargetPool( SDL_Renderer* Renderer_Ptr )
+  : m_Renderer_Ptr(Renderer_Ptr)
+{;}
+
+
+LRenderTargetPool::~LRenderTargetPool( void )
+{
+  clear();
+}
+
+
+/**
+ * @brief Moves the pool to another renderer: the textures of the previous one are destroyed, so none
+ * may be in use.
+ **/
+void LRenderTargetPool::setRenderer( SDL_Renderer* Renderer_Ptr )
+{
+  if ( Renderer_Ptr != m_Renderer_Ptr )
+  {
+    clear();
+    m_Renderer_Ptr = Renderer_Ptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Hands out a target texture, reusing a free one of the same size and format when there is
+ * one. Its blend mode is reset to SDL_BLENDMODE_BLEND and its colour and alpha modulation to none;
+ * the contents of a reused texture are whatever its last user left.
+ *
+ * @return The texture, to give back with "release", or nullptr if it could not be created.
+ **/
+SDL_Texture* LRenderTargetPool::acquire( int Width, int Height, Uint32 Format )
+{
+  SDL_Texture* Texture_Ptr = nullptr;
+
+  for ( Target& Free : m_Targets )
+  {
+    if ( !Free.InUse && Free.Width == Width && Free.Height == Height && Free.Format == Format )
+    {
+      Free.InUse  = true;
+      Texture_Ptr = Free.Texture_Ptr;
+      break;
+    }
+    else
+    {;}
+  }
+
+  if ( Texture_Ptr == nullptr )
+  {
+    Texture_Ptr = SDL_CreateTexture( m_Renderer_Ptr, Format, SDL_TEXTUREACCESS_TARGET, Width, Height );
+
+    if ( Texture_Ptr == nullptr )
+    {
+      printf( "\nUnable to create render target! SDL Error: \"%s\"", SDL_GetError() );
+      return nullptr;
+    }
+    else
+    {;}
+
+    m_Targets.push_back( Target{ Texture_Ptr, Width, Height, Format, true } );
+  }
+  else
+  {;}
+
+  SDL_SetTextureBlendMode( Texture_Ptr, SDL_BLENDMODE_BLEND );
+  SDL_SetTextureColorMod ( Texture_Ptr, 0xFF, 0xFF, 0xFF );
+  SDL_SetTextureAlphaMod ( Texture_Ptr, 0xFF );
+
+  return Texture_Ptr;
+}
+
+
+/**
+ * @brief Gives a texture back to the pool, for the next "acquire" of its size and format. Textures
+ * not from this pool are ignored.
+ **/
+void LRenderTargetPool::release( SDL_Texture* Texture_Ptr )
+{
+  for ( Target& Used : m_Targets )
+  {
+    if ( Used.Texture_Ptr == Texture_Ptr )
+    {
+      Used.InUse = false;
+      break;
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Destroys the free textures, e.g. after a level whose effects needed sizes no longer used.
+ **/
+void LRenderTargetPool::trim( void )
+{
+  size_t Kept = 0;
+
+  for ( Target& Each : m_Targets )
+  {
+    if ( Each.InUse )
+    {
+      m_Targets[Kept++] = Each;
+    }
+    else
+    {
+      SDL_DestroyTexture( Each.Texture_Ptr );
+    }
+  }
+
+  m_Targets.resize( Kept );
+}
+
+
+/**
+ * @brief Destroys every texture of the pool: none may be in use any more.
+ **/
+void LRenderTargetPool::clear( void )
+{
+  for ( Target& Each : m_Targets )
+  {
+    SDL_DestroyTexture( Each.Texture_Ptr );
+  }
+
+  m_Targets.clear();
+}
+
+
+SDL_Renderer* LRenderTargetPool::GetRenderer( void ) const
+{
+  return m_Renderer_Ptr;
+}
+
+
+/**
+ * @return The textures of the pool, in use or free.
+ **/
+size_t LRenderTargetPool::GetCount( void ) const
+{
+  return m_Targets.size();
+}
+
+
+size_t LRenderTargetPool::GetFreeCount( void ) const
+{
+  size_t Free = 0;
+
+  for ( const Target& Each : m_Targets )
+  {
+    Free += Each.InUse ? 0 : 1;
+  }
+
+  return Free;
+}
+
+
+LCachedLayer::LCachedLayer( void )
+  : m_Pool_Ptr(nullptr), m_Texture_Ptr(nullptr), m_Draw(nullptr), m_Data_Ptr(nullptr),
+    m_Width(0), m_Height(0), m_Dirty(false), m_DrawCount(0)
+{;}
+
+
+LCachedLayer::~LCachedLayer( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Takes a target from the pool for the layer, to be drawn at the first "update" or "render".
+ * The pool must outlive the layer.
+ *
+ * @param Draw     Draws the contents of the layer, given the renderer of the pool and Data_Ptr.
+ * @param Data_Ptr Passed to Draw.
+ * @return false if no target could be had.
+ **/
+bool LCachedLayer::create( LRenderTargetPool& Pool, int Width, int Height, LLayerDrawFunction Draw, void* Data_Ptr, Uint32 Format )
+{
+  free();
+
+  m_Texture_Ptr = Pool.acquire( Width, Height, Format );
+
+  if ( m_Texture_Ptr == nullptr )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Pool_Ptr  = &Pool;
+  m_Draw      = Draw;
+  m_Data_Ptr  = Data_Ptr;
+  m_Width     = Width;
+  m_Height    = Height;
+  m_Dirty     = true;
+  m_DrawCount = 0;
+
+  return true;
+}
+
+
+/**
+ * @brief Gives the target back to the pool.
+ **/
+void LCachedLayer::free( void )
+{
+  if ( m_Pool_Ptr != nullptr )
+  {
+    m_Pool_Ptr->release( m_Texture_Ptr );
+  }
+  else
+  {;}
+
+  m_Pool_Ptr    = nullptr;
+  m_Texture_Ptr = nullptr;
+  m_Draw        = nullptr;
+  m_Data_Ptr    = nullptr;
+  m_Width       = 0;
+  m_Height      = 0;
+  m_Dirty       = false;
+}
+
+
+/**
+ * @brief The contents changed: they are drawn again before the layer is next rendered.
+ **/
+void LCachedLayer::invalidate( void )
+{
+  m_Dirty = ( m_Texture_Ptr != nullptr );
+}
+
+
+/**
+ * @brief Draws the contents into the target, if they were invalidated since last time.
+ *
+ * @return true if they were drawn.
+ **/
+bool LCachedLayer::update( void )
+{
+  if ( !m_Dirty )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Renderer* Renderer_Ptr = m_Pool_Ptr->GetRenderer();
+  SDL_Texture*  Previous_Ptr = SDL_GetRenderTarget( Renderer_Ptr );
+  Uint8         r, g, b, a;
+
+  if ( SDL_SetRenderTarget( Renderer_Ptr, m_Texture_Ptr ) != 0 )
+  {
+    printf( "\nUnable to draw cached layer! SDL Error: \"%s\"", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_GetRenderDrawColor( Renderer_Ptr, &r, &g, &b, &a );
+  SDL_SetRenderDrawColor( Renderer_Ptr, 0x00, 0x00, 0x00, 0x00 );
+  SDL_RenderClear( Renderer_Ptr );
+
+  m_Draw( Renderer_Ptr, m_Data_Ptr );
+
+  SDL_SetRenderTarget   ( Renderer_Ptr, Previous_Ptr );
+  SDL_SetRenderDrawColor( Renderer_Ptr, r, g, b, a );
+
+  m_Dirty = false;
+  ++m_DrawCount;
+
+  return true;
+}
+
+
+/**
+ * @brief Draws the layer into the current target, at its size, as a single copy; it is first brought
+ * up to date if it was invalidated.
+ *
+ * @param Angle      Degrees, clockwise, around Center_Ptr.
+ * @param Center_Ptr Relative to x, y; NULL for the centre of the layer.
+ **/
+void LCachedLayer::render( int x, int y, double Angle, const SDL_Point* Center_Ptr, SDL_RendererFlip Flip )
+{
+  if ( m_Texture_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  update();
+
+  const SDL_Rect Destination{ x, y, m_Width, m_Height };
+
+  SDL_RenderCopyEx( m_Pool_Ptr->GetRenderer(), m_Texture_Ptr, NULL, &Destination, Angle, Center_Ptr, Flip );
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+bool LCachedLayer::isDirty( void ) const
+{
+  return m_Dirty;
+}
+
+
+SDL_Texture* LCachedLayer::GetTexture( void ) const
+{
+  return m_Texture_Ptr;
+}
+
+
+int LCachedLayer::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LCachedLayer::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+/**
+ * @return How many times the contents were drawn since "create".
+ **/
+int LCachedLayer::GetDrawCount( void ) const
+{
+  return m_DrawCount;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file LRenderTargets.hpp
+ *
+ * @brief Reused render target textures, and layers drawn into them only when they change.
+ **/
+
+#ifndef LRENDERTARGETS_HPP
+#define LRENDERTARGETS_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief Target textures of one renderer, kept for reuse once released. "acquire" hands out a free
+ * texture of the same size and format if there is one, and creates one only otherwise: effects that
+ * need a scratch target each frame, or layers created and freed over and over, stop creating and
+ * destroying GPU textures.
+ *
+ * Every texture is destroyed with the pool, or by "clear"; "trim" destroys only the free ones.
+ **/
+class LRenderTargetPool
+{
+public:
+
+  explicit LRenderTargetPool( SDL_Renderer* = nullptr );
+  ~LRenderTargetPool( void );
+
+  LRenderTargetPool( const LRenderTargetPool& )            = delete;
+  LRenderTargetPool& operator=( const LRenderTargetPool& ) = delete;
+
+  void          setRenderer ( SDL_Renderer* );
+  SDL_Texture*  acquire     ( int, int, Uint32 = SDL_PIXELFORMAT_RGBA8888 );
+  void          release     ( SDL_Texture* );
+  void          trim        ( void );
+  void          clear       ( void );
+
+  SDL_Renderer* GetRenderer ( void ) const;
+  size_t        GetCount    ( void ) const;
+  size_t        GetFreeCount( void ) const;
+
+private:
+
+  struct Target
+  {
+    SDL_Texture* Texture_Ptr;
+    int          Width;
+    int          Height;
+    Uint32       Format;
+    bool         InUse;
+  };
+
+  SDL_Renderer*       m_Renderer_Ptr;
+  std::vector<Target> m_Targets;
+};
+
+
+/**
+ * @brief Draws the contents of a layer into the current render target, which is the layer's.
+ **/
+typedef void (*LLayerDrawFunction)( SDL_Renderer*, void* );
+
+
+/**
+ * @brief A part of the scene that seldom changes, drawn once into a target of the pool and then
+ * rendered as a single texture, e.g. rotated or scaled as a whole. "invalidate" marks it to be drawn
+ * again before it is next rendered; until then rendering it is one copy, whatever it contains.
+ *
+ * The layer starts transparent before each draw. The render target and the draw colour of the
+ * renderer are restored afterwards.
+ *
+ * Some renderers (Direct3D) lose the contents of their targets when the window is resized or the
+ * device is reset: invalidate every layer on SDL_RENDER_TARGETS_RESET.
+ **/
+class LCachedLayer
+{
+public:
+
+  LCachedLayer( void );
+  ~LCachedLayer( void );
+
+  LCachedLayer( const LCachedLayer& )            = delete;
+  LCachedLayer& operator=( const LCachedLayer& ) = delete;
+
+  bool         create        ( LRenderTargetPool&, int, int, LLayerDrawFunction, void*, Uint32 = SDL_PIXELFORMAT_RGBA8888 );
+  void         free          ( void );
+  void         invalidate    ( void );
+  bool         update        ( void );
+  void         render        ( int, int, double = 0.0, const SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
+
+  bool         isDirty       ( void ) const;
+  SDL_Texture* GetTexture    ( void ) const;
+  int          GetWidth      ( void ) const;
+  int          GetHeight     ( void ) const;
+  int          GetDrawCount  ( void ) const;
+
+private:
+
+  LRenderTargetPool* m_Pool_Ptr;
+  SDL_Texture*       m_Texture_Ptr;
+  LLayerDrawFunction m_Draw;
+  void*              m_Data_Ptr;
+  int                m_Width;
+  int                m_Height;
+  bool               m_Dirty;
+  int                m_DrawCount;   // Times the contents were drawn, for statistics
+};
+
+#endif // LRENDERTARGETS_HPP
@@ -0,0 +1,515 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LRendererSelect.hpp"
+#include "LFrameArena.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr int    FIRST_AVAILABLE = -1;    // SDL_CreateRenderer picks one with the flags
+static constexpr Uint8  SPRITE_ALPHA    = 128;   // Blended, as most sprites are
+static constexpr Uint32 LCG_MULTIPLIER  = 1664525u;
+static constexpr Uint32 LCG_INCREMENT   = 1013904223u;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static double Seconds( Uint64 Ticks )
+{
+  return static_cast<double>( Ticks ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+}
+
+
+static size_t ModeIndex( LPresentMode Mode )
+{
+  return static_cast<size_t>( Mode );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @return The drivers SDL was built with, in its order of preference; none measured yet.
+ **/
+std::vector<LRenderDriver> LRendererSelect::GetDrivers( void )
+{
+  std::vector<LRenderDriver> Drivers;
+
+  for ( int Driver = 0; Driver < SDL_GetNumRenderDrivers(); ++Driver )
+  {
+    SDL_RendererInfo Info;
+
+    if ( SDL_GetRenderDriverInfo( Driver, &Info ) == 0 )
+    {
+      Drivers.push_back( LRenderDriver{ Driver, Info.name, ( Info.flags & SDL_RENDERER_ACCELERATED ) != 0, 0.0 } );
+    }
+    else
+    {;}
+  }
+
+  return Drivers;
+}
+
+
+/**
+ * @return The position of the driver with that name, -1 if there is none.
+ **/
+int LRendererSelect::find( const std::vector<LRenderDriver>& Drivers, const std::string& Name )
+{
+  for ( size_t Driver = 0; Driver != Drivers.size(); ++Driver )
+  {
+    if ( Drivers[Driver].Name == Name )
+    {
+      return static_cast<int>( Driver );
+    }
+    else
+    {;}
+  }
+
+  return -1;
+}
+
+
+/**
+ * @brief Measures every driver on the window, one at a time. Nothing must be using a renderer of
+ * the window meanwhile.
+ **/
+void LRendererSelect::benchmark( SDL_Window* Window_Ptr, std::vector<LRenderDriver>& Drivers )
+{
+  for ( LRenderDriver& Driver : Drivers )
+  {
+    Driver.FrameTime = Benchmark_Pvt( Window_Ptr, Driver.Index );
+
+    if ( Driver.FrameTime > 0.0 )
+    {
+      printf( "\nRenderer benchmark: %-12s %7.3f ms per frame", Driver.Name.c_str(), Driver.FrameTime * 1000.0 );
+    }
+    else
+    {
+      printf( "\nRenderer benchmark: %-12s unavailable", Driver.Name.c_str() );
+    }
+  }
+}
+
+
+/**
+ * @return The position of the driver with the shortest frame time measured, -1 if none was.
+ **/
+int LRendererSelect::GetFastest( const std::vector<LRenderDriver>& Drivers )
+{
+  int Fastest = -1;
+
+  for ( size_t Driver = 0; Driver != Drivers.size(); ++Driver )
+  {
+    if ( Drivers[Driver].FrameTime > 0.0 && ( Fastest < 0 || Drivers[Driver].FrameTime < Drivers[static_cast<size_t>( Fastest )].FrameTime ) )
+    {
+      Fastest = static_cast<int>( Driver );
+    }
+    else
+    {;}
+  }
+
+  return Fastest;
+}
+
+
+/**
+ * @brief Creates the renderer of the window.
+ *
+ * @param Name          Driver to use; if empty, or not there, the fastest one, or SDL's choice.
+ * @param IsBenchmarked Whether to measure the drivers when none is named.
+ * @param Mode          Present mode to start with: with VSync unless VSYNC_OFF.
+ * @return nullptr if SDL could not create it, as SDL_CreateRenderer.
+ **/
+SDL_Renderer* LRendererSelect::create( SDL_Window* Window_Ptr, const std::string& Name, bool IsBenchmarked, LPresentMode Mode )
+{
+  std::vector<LRenderDriver> Drivers = GetDrivers();
+  int                        Chosen  = -1;
+
+  if ( !Name.empty() )
+  {
+    Chosen = find( Drivers, Name );
+
+    if ( Chosen < 0 )
+    {
+      printf( "\nRenderer: no driver called \"%s\", letting SDL choose.", Name.c_str() );
+    }
+    else
+    {;}
+  }
+  else if ( IsBenchmarked )
+  {
+    benchmark( Window_Ptr, Drivers );
+    Chosen = GetFastest( Drivers );
+  }
+  else
+  {;}
+
+  Uint32 Flags = ( Mode != LPresentMode::VSYNC_OFF ) ? static_cast<Uint32>( SDL_RENDERER_PRESENTVSYNC ) : 0u;
+  int    Index = FIRST_AVAILABLE;
+
+  if ( Chosen >= 0 )
+  {
+    const LRenderDriver& Driver = Drivers[static_cast<size_t>( Chosen )];
+
+    Index  = Driver.Index;
+    Flags |= Driver.IsAccelerated ? SDL_RENDERER_ACCELERATED : SDL_RENDERER_SOFTWARE;
+  }
+  else
+  {
+    Flags |= SDL_RENDERER_ACCELERATED;
+  }
+
+  SDL_Renderer*    Renderer_Ptr = SDL_CreateRenderer( Window_Ptr, Index, Flags );
+  SDL_RendererInfo Info;
+
+  if ( Renderer_Ptr != nullptr && SDL_GetRendererInfo( Renderer_Ptr, &Info ) == 0 )
+  {
+    printf( "\nRenderer: %s, %s", Info.name, LPresentControl::GetName( Mode ) );
+  }
+  else
+  {;}
+
+  return Renderer_Ptr;
+}
+
+
+/**
+ * @return Seconds per frame of the driver at that index, -1 if it could not be created.
+ **/
+double LRendererSelect::Benchmark_Pvt( SDL_Window* Window_Ptr, int Index )
+{
+  SDL_Renderer* Renderer_Ptr = SDL_CreateRenderer( Window_Ptr, Index, 0 );
+
+  if ( Renderer_Ptr == nullptr )
+  {
+    return -1.0;
+  }
+  else
+  {;}
+
+  SDL_Surface* Surface_Ptr = SDL_CreateRGBSurfaceWithFormat( 0, s_BENCH_SPRITE_SIZE, s_BENCH_SPRITE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+  SDL_Texture* Sprite_Ptr  = nullptr;
+
+  if ( Surface_Ptr != nullptr )
+  {
+    SDL_FillRect( Surface_Ptr, nullptr, SDL_MapRGBA( Surface_Ptr->format, 0xFF, 0x80, 0x40, 0xFF ) );
+    Sprite_Ptr = SDL_CreateTextureFromSurface( Renderer_Ptr, Surface_Ptr );
+    SDL_FreeSurface( Surface_Ptr );
+  }
+  else
+  {;}
+
+  if ( Sprite_Ptr == nullptr )
+  {
+    SDL_DestroyRenderer( Renderer_Ptr );
+    return -1.0;
+  }
+  else
+  {;}
+
+  SDL_SetTextureBlendMode( Sprite_Ptr, SDL_BLENDMODE_BLEND );
+  SDL_SetTextureAlphaMod ( Sprite_Ptr, SPRITE_ALPHA );
+
+  int Width  = 0;
+  int Height = 0;
+
+  SDL_GetRendererOutputSize( Renderer_Ptr, &Width, &Height );
+  Width  = std::max( Width  - s_BENCH_SPRITE_SIZE, 1 );
+  Height = std::max( Height - s_BENCH_SPRITE_SIZE, 1 );
+
+  // The same positions for every driver
+  Uint32 Random = 1u;
+  Uint64 Start  = 0;
+
+  for ( int Frame = 0; Frame != s_BENCH_WARMUP + s_BENCH_FRAMES; ++Frame )
+  {
+    if ( Frame == s_BENCH_WARMUP )
+    {
+      Start = SDL_GetPerformanceCounter();
+    }
+    else
+    {;}
+
+    SDL_SetRenderDrawColor( Renderer_Ptr, 0x00, 0x00, 0x00, 0xFF );
+    SDL_RenderClear( Renderer_Ptr );
+
+    for ( int Sprite = 0; Sprite != s_BENCH_SPRITES; ++Sprite )
+    {
+      Random = Random * LCG_MULTIPLIER + LCG_INCREMENT;
+
+      const SDL_Rect Destination{ static_cast<int>( ( Random >> 16 ) % static_cast<Uint32>( Width ) ),
+                                  static_cast<int>( ( Random & 0xFFFFu ) % static_cast<Uint32>( Height ) ),
+                                  s_BENCH_SPRITE_SIZE, s_BENCH_SPRITE_SIZE };
+
+      SDL_RenderCopy( Renderer_Ptr, Sprite_Ptr, nullptr, &Destination );
+    }
+
+    SDL_RenderPresent( Renderer_Ptr );
+  }
+
+  // Reading a pixel back waits for the GPU to finish the frames queued
+  const SDL_Rect Pixel{ 0, 0, 1, 1 };
+  Uint32         Colour = 0;
+
+  SDL_RenderReadPixels( Renderer_Ptr, &Pixel, SDL_PIXELFORMAT_ARGB8888, &Colour, static_cast<int>( sizeof( Colour ) ) );
+
+  const double Elapsed = Seconds( SDL_GetPerformanceCounter() - Start );
+
+  SDL_DestroyTexture ( Sprite_Ptr );
+  SDL_DestroyRenderer( Renderer_Ptr );
+
+  return Elapsed / s_BENCH_FRAMES;
+}
+
+
+LPresentControl::LPresentControl( void )
+  : m_Renderer_Ptr(nullptr), m_Mode(LPresentMode::VSYNC_ON), m_IsVSyncOn(true), m_Period(1.0 / 60.0), m_FrameStart(0),
+    m_LastPresent(0), m_RecentFrame(0.0), m_RecentBusy(0.0), m_Settling(s_SETTLE_FRAMES), m_Switches(0), m_Totals{}
+{;}
+
+
+/**
+ * @brief Takes over the present mode of a renderer; the refresh period comes from the display of
+ * the window, 60 Hz if it does not say.
+ **/
+void LPresentControl::attach( SDL_Renderer* Renderer_Ptr, SDL_Window* Window_Ptr, LPresentMode Mode )
+{
+  SDL_DisplayMode Display;
+
+  m_Renderer_Ptr = Renderer_Ptr;
+  m_Period       = ( SDL_GetWindowDisplayMode( Window_Ptr, &Display ) == 0 && Display.refresh_rate > 0 ) ? 1.0 / Display.refresh_rate : 1.0 / 60.0;
+
+  for ( Totals& Mode_Totals : m_Totals )
+  {
+    Mode_Totals = Totals{};
+  }
+
+  m_Switches = 0;
+
+  setMode( Mode );
+}
+
+
+void LPresentControl::setMode( LPresentMode Mode )
+{
+  m_Mode        = Mode;
+  m_LastPresent = 0;
+  m_FrameStart  = 0;
+  m_RecentFrame = 0.0;
+  m_RecentBusy  = 0.0;
+  m_Settling    = s_SETTLE_FRAMES;
+
+  SetVSync_Pvt( Mode != LPresentMode::VSYNC_OFF );
+}
+
+
+/**
+ * @brief VSync off, on, adaptive, and off again.
+ **/
+void LPresentControl::nextMode( void )
+{
+  setMode( static_cast<LPresentMode>( ( ModeIndex( m_Mode ) + 1 ) % s_NUM_OF_MODES ) );
+
+  printf( "\nPresent mode: %s", GetName( m_Mode ) );
+}
+
+
+/**
+ * @brief Marks the moment the input of the frame is read, where its latency starts.
+ **/
+void LPresentControl::beginFrame( void )
+{
+  m_FrameStart = SDL_GetPerformanceCounter();
+}
+
+
+/**
+ * @brief Presents the frame with PresentFrame, measures it and, in ADAPTIVE, switches VSync.
+ **/
+void LPresentControl::present( void )
+{
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  PresentFrame( m_Renderer_Ptr );
+
+  const Uint64 End = SDL_GetPerformanceCounter();
+
+  if ( m_LastPresent == 0 )
+  {
+    m_LastPresent = End;
+    return;
+  }
+  else
+  {;}
+
+  const double Frame = Seconds( End   - m_LastPresent );
+  const double Busy  = Seconds( Start - m_LastPresent );
+  Totals&      Mode  = m_Totals[ModeIndex( m_Mode )];
+
+  Mode.Frame   += Frame;
+  Mode.Latency += ( m_FrameStart != 0 ) ? Seconds( End - m_FrameStart ) : Frame;
+  ++Mode.Frames;
+
+  m_LastPresent = End;
+
+  if ( m_Mode != LPresentMode::ADAPTIVE )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // Right after a switch the averages restart from the last frame of the wait
+  if ( m_Settling > 0 )
+  {
+    --m_Settling;
+    m_RecentFrame = Frame;
+    m_RecentBusy  = Busy;
+    return;
+  }
+  else
+  {;}
+
+  m_RecentFrame += ( Frame - m_RecentFrame ) * s_AVERAGE_WEIGHT;
+  m_RecentBusy  += ( Busy  - m_RecentBusy  ) * s_AVERAGE_WEIGHT;
+
+  // Late with VSync: each frame waits for a second blank. On time without it: it tears for nothing
+  if ( m_IsVSyncOn && m_RecentFrame > m_Period * s_LATE )
+  {
+    SetVSync_Pvt( false );
+  }
+  else if ( !m_IsVSyncOn && m_RecentBusy < m_Period * s_ON_TIME )
+  {
+    SetVSync_Pvt( true );
+  }
+  else
+  {
+    return;
+  }
+
+  m_Settling = s_SETTLE_FRAMES;
+  ++m_Switches;
+}
+
+
+/**
+ * @brief Prints frame time and latency of every mode used so far.
+ **/
+void LPresentControl::report( void ) const
+{
+  printf( "\nPresent modes, refresh period %.2f ms:", m_Period * 1000.0 );
+
+  for ( int Mode = 0; Mode != s_NUM_OF_MODES; ++Mode )
+  {
+    const LPresentMode Present = static_cast<LPresentMode>( Mode );
+
+    if ( m_Totals[ModeIndex( Present )].Frames != 0 )
+    {
+      printf( "\n  %-9s %6.2f ms per frame, %6.2f ms latency, %llu frames", GetName( Present ), GetAverageFrame( Present ) * 1000.0,
+              GetAverageLatency( Present ) * 1000.0, static_cast<unsigned long long>( m_Totals[ModeIndex( Present )].Frames ) );
+    }
+    else
+    {;}
+  }
+
+  printf( "\n  Adaptive switched VSync %llu times", static_cast<unsigned long long>( m_Switches ) );
+}
+
+
+LPresentMode LPresentControl::GetMode( void ) const
+{
+  return m_Mode;
+}
+
+
+bool LPresentControl::IsVSyncOn( void ) const
+{
+  return m_IsVSyncOn;
+}
+
+
+/**
+ * @return Seconds from one present to the next in that mode, 0 if it was not used.
+ **/
+double LPresentControl::GetAverageFrame( LPresentMode Mode ) const
+{
+  const Totals& Mode_Totals = m_Totals[ModeIndex( Mode )];
+
+  return ( Mode_Totals.Frames != 0 ) ? Mode_Totals.Frame / static_cast<double>( Mode_Totals.Frames ) : 0.0;
+}
+
+
+/**
+ * @return Seconds from beginFrame to the end of the present in that mode, 0 if it was not used.
+ **/
+double LPresentControl::GetAverageLatency( LPresentMode Mode ) const
+{
+  const Totals& Mode_Totals = m_Totals[ModeIndex( Mode )];
+
+  return ( Mode_Totals.Frames != 0 ) ? Mode_Totals.Latency / static_cast<double>( Mode_Totals.Frames ) : 0.0;
+}
+
+
+const char* LPresentControl::GetName( LPresentMode Mode )
+{
+  switch ( Mode )
+  {
+    case LPresentMode::VSYNC_OFF: return "vsync off";
+    case LPresentMode::VSYNC_ON:  return "vsync on";
+    case LPresentMode::ADAPTIVE:  return "adaptive";
+  }
+
+  return "";
+}
+
+
+/**
+ * @param Name "off", "on" or "adaptive", as on the command line.
+ * @return false, with Mode unchanged, for any other name.
+ **/
+bool LPresentControl::GetModeOf( const std::string& Name, LPresentMode& Mode )
+{
+  if ( Name == "off" )
+  {
+    Mode = LPresentMode::VSYNC_OFF;
+  }
+  else if ( Name == "on" )
+  {
+    Mode = LPresentMode::VSYNC_ON;
+  }
+  else if ( Name == "adaptive" )
+  {
+    Mode = LPresentMode::ADAPTIVE;
+  }
+  else
+  {
+    return false;
+  }
+
+  return true;
+}
+
+
+void LPresentControl::SetVSync_Pvt( bool IsOn )
+{
+  if ( m_Renderer_Ptr != nullptr && SDL_RenderSetVSync( m_Renderer_Ptr, IsOn ? 1 : 0 ) != 0 )
+  {
+    printf( "\nUnable to turn VSync %s! SDL Error: %s", IsOn ? "on" : "off", SDL_GetError() );
+  }
+  else
+  {
+    m_IsVSyncOn = IsOn;
+  }
+}
@@ -0,0 +1,138 @@
+/**
+ * @file LRendererSelect.hpp
+ *
+ * @brief Choice of the render driver, by name or by a short benchmark at startup, and of the present
+ * mode (VSync off, on or adaptive), switched at run time with the latency of each one measured.
+ **/
+
+#ifndef LRENDERERSELECT_HPP
+#define LRENDERERSELECT_HPP
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How frames are presented. ADAPTIVE waits for the vertical blank while frames keep up with
+ * the display, and stops waiting while they do not, instead of dropping to half the refresh rate:
+ * SDL_Renderer only turns VSync on and off, so LPresentControl does the switching.
+ **/
+enum class LPresentMode
+{
+  VSYNC_OFF,
+  VSYNC_ON,
+  ADAPTIVE
+};
+
+
+/**
+ * @brief A render driver of SDL, as SDL_GetRenderDriverInfo describes it, and how it did in the
+ * benchmark.
+ **/
+struct LRenderDriver
+{
+  int         Index;          // For SDL_CreateRenderer
+  std::string Name;           // "direct3d11", "opengl", "software"...
+  bool        IsAccelerated;
+  double      FrameTime;      // Seconds per frame of the benchmark; 0 if not measured, < 0 if it failed
+};
+
+
+/**
+ * @brief Creates the renderer of a window on the driver asked for, or on the fastest one. Drivers
+ * differ by two or three times on the same machine, and not in the same order on every machine.
+ *
+ * The benchmark creates a renderer of each driver in turn on the window, without VSync, and draws
+ * s_BENCH_FRAMES frames of s_BENCH_SPRITES blended sprites, then reads a pixel back so that the
+ * GPU has finished them too. It takes a fraction of a second per driver; the window may flicker
+ * while drivers are switched (OpenGL ones recreate it).
+ **/
+class LRendererSelect
+{
+public:
+
+  static constexpr int s_BENCH_FRAMES      = 30;
+  static constexpr int s_BENCH_WARMUP      = 3;
+  static constexpr int s_BENCH_SPRITES     = 2000;
+  static constexpr int s_BENCH_SPRITE_SIZE = 32;
+
+  static std::vector<LRenderDriver> GetDrivers( void );
+  static int                        find      ( const std::vector<LRenderDriver>&, const std::string& );
+  static void                       benchmark ( SDL_Window*, std::vector<LRenderDriver>& );
+  static int                        GetFastest( const std::vector<LRenderDriver>& );
+  static SDL_Renderer*              create    ( SDL_Window*, const std::string&, bool, LPresentMode );
+
+private:
+
+  static double Benchmark_Pvt( SDL_Window*, int );
+};
+
+
+/**
+ * @brief Switches the present mode of a renderer at run time (SDL_RenderSetVSync, SDL 2.0.18) and
+ * measures each mode: frame time, and latency, from "beginFrame", when the input is read, to the
+ * return of the present that shows it. A present that returns may still wait in the driver's queue
+ * for a vertical blank, so the latency is a lower bound; VSync adds up to a refresh period to it.
+ *
+ * ADAPTIVE turns VSync off when the frames, on average, take longer than s_LATE of a refresh
+ * period, and back on when the work outside the present, on average, takes less than s_ON_TIME of
+ * it; s_SETTLE_FRAMES frames pass between two switches.
+ *
+ * Call beginFrame before handling the events, and "present" instead of PresentFrame (which it calls).
+ **/
+class LPresentControl
+{
+public:
+
+  static constexpr double s_LATE           = 1.20;
+  static constexpr double s_ON_TIME        = 0.90;
+  static constexpr int    s_SETTLE_FRAMES  = 15;
+  static constexpr double s_AVERAGE_WEIGHT = 1.0 / 8.0;
+
+  LPresentControl( void );
+
+  void         attach           ( SDL_Renderer*, SDL_Window*, LPresentMode );
+  void         setMode          ( LPresentMode );
+  void         nextMode         ( void );
+  void         beginFrame       ( void );
+  void         present          ( void );
+  void         report           ( void ) const;
+
+  LPresentMode GetMode          ( void ) const;
+  bool         IsVSyncOn        ( void ) const;
+  double       GetAverageFrame  ( LPresentMode ) const;
+  double       GetAverageLatency( LPresentMode ) const;
+
+  static const char* GetName    ( LPresentMode );
+  static bool        GetModeOf  ( const std::string&, LPresentMode& );
+
+private:
+
+  static constexpr int s_NUM_OF_MODES = 3;
+
+  /**
+   * @brief What a mode did while it was on.
+   **/
+  struct Totals
+  {
+    double Frame;      // Seconds
+    double Latency;
+    Uint64 Frames;
+  };
+
+  void SetVSync_Pvt( bool );
+
+  SDL_Renderer* m_Renderer_Ptr;
+  LPresentMode  m_Mode;
+  bool          m_IsVSyncOn;
+  double        m_Period;          // Of the display's refresh, in seconds
+  Uint64        m_FrameStart;      // Performance counter at beginFrame, 0 if not called
+  Uint64        m_LastPresent;     // At the end of the last present
+  double        m_RecentFrame;     // Exponential averages of ADAPTIVE, in seconds
+  double        m_RecentBusy;
+  int           m_Settling;        // Frames before ADAPTIVE may switch again
+  Uint64        m_Switches;        // Times ADAPTIVE switched VSync
+  Totals        m_Totals[s_NUM_OF_MODES];
+};
+
+#endif // LRENDERERSELECT_HPP
@@ -0,0 +1,518 @@
+/**
+ * @file LRingBuffer.hpp
+ *
+ * @brief Bounded lock-free queues for handing data from thread to thread, and a blocking wrapper for
+ * the threads that have nothing else to do while they wait.
+ **/
+
+#ifndef LRINGBUFFER_HPP
+#define LRINGBUFFER_HPP
+
+#include <SDL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Rounds a capacity up to a power of two, so that indices wrap with a mask.
+ **/
+inline size_t LRingCapacity( size_t Capacity )
+{
+  size_t Rounded = 1;
+
+  while ( Rounded < Capacity )
+  {
+    Rounded <<= 1;
+  }
+
+  return Rounded;
+}
+
+
+/**
+ * @brief Single producer, single consumer ring. The producer only writes the tail and the consumer
+ * only the head, each on its own cache line, and each side keeps a copy of the other's index: it is
+ * read again only when the copy says the ring is full, or empty. An item costs no lock and, most of
+ * the time, no cache line moving between the cores.
+ *
+ * Exactly one thread may push and one thread may pop.
+ **/
+template <typename T>
+class LSpscRing
+{
+public:
+
+  typedef T Value;
+
+  explicit LSpscRing( size_t Capacity )
+    : m_Slots( LRingCapacity( Capacity ) ), m_Mask( m_Slots.size() - 1 ),
+      m_Head(0), m_CachedTail(0), m_Tail(0), m_CachedHead(0)
+  {;}
+
+  bool push( const T& Item ) { return pushBatch( &Item, 1 ) == 1; }
+  bool pop ( T& Item )       { return popBatch ( &Item, 1 ) == 1; }
+
+  /**
+   * @brief Producer only. Pushes as many of the items as there is room for, in order.
+   *
+   * @return The number of items pushed.
+   **/
+  size_t pushBatch( const T* Items, size_t Count )
+  {
+    const size_t Tail = m_Tail.load( std::memory_order_relaxed );
+
+    if ( m_Slots.size() - ( Tail - m_CachedHead ) < Count )
+    {
+      m_CachedHead = m_Head.load( std::memory_order_acquire );
+    }
+    else
+    {;}
+
+    const size_t Pushed = std::min( Count, m_Slots.size() - ( Tail - m_CachedHead ) );
+
+    for ( size_t i = 0; i != Pushed; ++i )
+    {
+      m_Slots[ ( Tail + i ) & m_Mask ] = Items[i];
+    }
+
+    // Publishes the items to the consumer
+    m_Tail.store( Tail + Pushed, std::memory_order_release );
+
+    return Pushed;
+  }
+
+  /**
+   * @brief Consumer only. Pops up to Count items, oldest first.
+   *
+   * @return The number of items popped.
+   **/
+  size_t popBatch( T* Items, size_t Count )
+  {
+    const size_t Head = m_Head.load( std::memory_order_relaxed );
+
+    if ( m_CachedTail - Head < Count )
+    {
+      m_CachedTail = m_Tail.load( std::memory_order_acquire );
+    }
+    else
+    {;}
+
+    const size_t Popped = std::min( Count, m_CachedTail - Head );
+
+    for ( size_t i = 0; i != Popped; ++i )
+    {
+      Items[i] = m_Slots[ ( Head + i ) & m_Mask ];
+    }
+
+    // Hands the slots back to the producer
+    m_Head.store( Head + Popped, std::memory_order_release );
+
+    return Popped;
+  }
+
+  size_t GetCapacity( void ) const
+  {
+    return m_Slots.size();
+  }
+
+  /**
+   * @return Items in the ring; only a hint while the other side is running.
+   **/
+  size_t GetSize( void ) const
+  {
+    return m_Tail.load( std::memory_order_acquire ) - m_Head.load( std::memory_order_acquire );
+  }
+
+private:
+
+  std::vector<T>                  m_Slots;
+  const size_t                    m_Mask;
+
+  alignas(64) std::atomic<size_t> m_Head;        // Next slot to pop; written by the consumer
+  size_t                          m_CachedTail;  // The consumer's copy of m_Tail
+
+  alignas(64) std::atomic<size_t> m_Tail;        // Next slot to push; written by the producer
+  size_t                          m_CachedHead;  // The producer's copy of m_Head
+};
+
+
+/**
+ * @brief Multiple producers, multiple consumers ring (D. Vyukov's bounded queue). Every slot has a
+ * sequence number that says whether it is free for the push of a given turn or full for its pop; a
+ * thread claims a slot, or a run of consecutive ones for a batch, with a single compare-and-swap of
+ * the tail or head, and then fills or empties it without any lock.
+ **/
+template <typename T>
+class LMpmcRing
+{
+public:
+
+  typedef T Value;
+
+  explicit LMpmcRing( size_t Capacity )
+    : m_Capacity( LRingCapacity( Capacity ) ), m_Mask( m_Capacity - 1 ),
+      m_Cells( new Cell[ m_Capacity ] ), m_Head(0), m_Tail(0)
+  {
+    for ( size_t i = 0; i != m_Capacity; ++i )
+    {
+      m_Cells[i].Sequence.store( i, std::memory_order_relaxed );
+    }
+  }
+
+  bool push( const T& Item ) { return pushBatch( &Item, 1 ) == 1; }
+  bool pop ( T& Item )       { return popBatch ( &Item, 1 ) == 1; }
+
+  /**
+   * @brief Pushes as many of the items as there are free slots in a row, in order. The items of a
+   * batch stay together: no other producer's item comes in between.
+   *
+   * @return The number of items pushed.
+   **/
+  size_t pushBatch( const T* Items, size_t Count )
+  {
+    size_t Position = m_Tail.load( std::memory_order_relaxed );
+    size_t Claimed  = 0;
+
+    while ( Count != 0 )
+    {
+      // A slot is free for the push at Position when its sequence equals Position
+      Claimed = CountReady_Pvt( Position, 0, Count );
+
+      if ( Claimed == 0 )
+      {
+        const size_t Sequence = m_Cells[ Position & m_Mask ].Sequence.load( std::memory_order_acquire );
+
+        if ( static_cast<std::intptr_t>( Sequence - Position ) < 0 )
+        {
+          return 0;   // Full
+        }
+        else
+        {
+          Position = m_Tail.load( std::memory_order_relaxed );   // Taken meanwhile
+        }
+      }
+      else if ( m_Tail.compare_exchange_weak( Position, Position + Claimed, std::memory_order_relaxed ) )
+      {
+        break;
+      }
+      else
+      {;} // Another producer moved the tail: Position is its new value
+    }
+
+    for ( size_t i = 0; i != Claimed; ++i )
+    {
+      Cell& Target = m_Cells[ ( Position + i ) & m_Mask ];
+
+      Target.Value = Items[i];
+      Target.Sequence.store( Position + i + 1, std::memory_order_release );
+    }
+
+    return Claimed;
+  }
+
+  /**
+   * @brief Pops up to Count items that are ready in a row, oldest first.
+   *
+   * @return The number of items popped.
+   **/
+  size_t popBatch( T* Items, size_t Count )
+  {
+    size_t Position = m_Head.load( std::memory_order_relaxed );
+    size_t Claimed  = 0;
+
+    while ( Count != 0 )
+    {
+      // A slot is full for the pop at Position when its sequence equals Position + 1
+      Claimed = CountReady_Pvt( Position, 1, Count );
+
+      if ( Claimed == 0 )
+      {
+        const size_t Sequence = m_Cells[ Position & m_Mask ].Sequence.load( std::memory_order_acquire );
+
+        if ( static_cast<std::intptr_t>( Sequence - ( Position + 1 ) ) < 0 )
+        {
+          return 0;   // Empty
+        }
+        else
+        {
+          Position = m_Head.load( std::memory_order_relaxed );
+        }
+      }
+      else if ( m_Head.compare_exchange_weak( Position, Position + Claimed, std::memory_order_relaxed ) )
+      {
+        break;
+      }
+      else
+      {;}
+    }
+
+    for ( size_t i = 0; i != Claimed; ++i )
+    {
+      Cell& Source = m_Cells[ ( Position + i ) & m_Mask ];
+
+      Items[i] = Source.Value;
+      Source.Sequence.store( Position + i + m_Capacity, std::memory_order_release );
+    }
+
+    return Claimed;
+  }
+
+  size_t GetCapacity( void ) const
+  {
+    return m_Capacity;
+  }
+
+  /**
+   * @return Items in the ring, claimed ones included; only a hint while other threads are running.
+   **/
+  size_t GetSize( void ) const
+  {
+    const size_t Tail = m_Tail.load( std::memory_order_acquire );
+    const size_t Head = m_Head.load( std::memory_order_acquire );
+
+    return ( Tail > Head ) ? Tail - Head : 0;
+  }
+
+private:
+
+  struct Cell
+  {
+    std::atomic<size_t> Sequence;
+    T                   Value;
+  };
+
+  /**
+   * @brief Number of slots, from Position and up to Count of them, whose sequence is Position + Offset
+   * in turn: ready to be claimed together.
+   **/
+  size_t CountReady_Pvt( size_t Position, size_t Offset, size_t Count ) const
+  {
+    size_t Ready = 0;
+
+    while ( Ready != Count && Ready != m_Capacity &&
+            m_Cells[ ( Position + Ready ) & m_Mask ].Sequence.load( std::memory_order_acquire ) == Position + Ready + Offset )
+    {
+      ++Ready;
+    }
+
+    return Ready;
+  }
+
+  const size_t                    m_Capacity;
+  const size_t                    m_Mask;
+  std::unique_ptr<Cell[]>         m_Cells;
+
+  alignas(64) std::atomic<size_t> m_Head;
+  alignas(64) std::atomic<size_t> m_Tail;
+};
+
+
+/**
+ * @brief Blocking push and pop over a lock-free ring, LSpscRing or LMpmcRing. While there is room, or
+ * there are items, it costs what the ring costs: the mutex is taken only by a thread that has to
+ * sleep, and by the other side to wake it, which it does only when someone is asleep.
+ *
+ * "close" wakes everyone up and makes the pushes fail; the pops fail once the ring is empty.
+ **/
+template <class Ring>
+class LBlockingRing
+{
+public:
+
+  typedef typename Ring::Value Value;
+
+  explicit LBlockingRing( size_t Capacity )
+    : m_Ring( Capacity ), m_Lock_Ptr( SDL_CreateMutex() ), m_NotEmpty_Ptr( SDL_CreateCond() ),
+      m_NotFull_Ptr( SDL_CreateCond() ), m_WaitingPop(0), m_WaitingPush(0), m_IsClosed(false)
+  {;}
+
+  ~LBlockingRing( void )
+  {
+    SDL_DestroyCond ( m_NotFull_Ptr );
+    SDL_DestroyCond ( m_NotEmpty_Ptr );
+    SDL_DestroyMutex( m_Lock_Ptr );
+  }
+
+  LBlockingRing( const LBlockingRing& )            = delete;
+  LBlockingRing& operator=( const LBlockingRing& ) = delete;
+
+  /**
+   * @brief Pushes without waiting.
+   *
+   * @return false if the ring is full or closed.
+   **/
+  bool tryPush( const Value& Item )
+  {
+    if ( m_IsClosed.load() || !m_Ring.push( Item ) )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    Wake_Pvt( m_NotEmpty_Ptr, m_WaitingPop );
+
+    return true;
+  }
+
+  /**
+   * @brief Pops without waiting.
+   *
+   * @return false if the ring is empty.
+   **/
+  bool tryPop( Value& Item )
+  {
+    if ( !m_Ring.pop( Item ) )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    Wake_Pvt( m_NotFull_Ptr, m_WaitingPush );
+
+    return true;
+  }
+
+  bool push( const Value& Item ) { return pushBatch( &Item, 1 ) == 1; }
+  bool pop ( Value& Item )       { return popBatch ( &Item, 1 ) == 1; }
+
+  /**
+   * @brief Pushes every item, waiting for room as needed.
+   *
+   * @return The number of items pushed: fewer than Count only if the ring was closed.
+   **/
+  size_t pushBatch( const Value* Items, size_t Count )
+  {
+    size_t Done = 0;
+
+    while ( Done != Count && !m_IsClosed.load() )
+    {
+      size_t Pushed = m_Ring.pushBatch( Items + Done, Count - Done );
+
+      if ( Pushed == 0 )
+      {
+        Pushed = Sleep_Pvt( m_NotFull_Ptr, m_WaitingPush, [&]() { return m_Ring.pushBatch( Items + Done, Count - Done ); } );
+      }
+      else
+      {;}
+
+      if ( Pushed != 0 )
+      {
+        Done += Pushed;
+        Wake_Pvt( m_NotEmpty_Ptr, m_WaitingPop );
+      }
+      else
+      {;}
+    }
+
+    return Done;
+  }
+
+  /**
+   * @brief Pops up to Count items, waiting for the first one if the ring is empty.
+   *
+   * @return The number of items popped: 0 only if the ring is closed and empty.
+   **/
+  size_t popBatch( Value* Items, size_t Count )
+  {
+    size_t Popped = m_Ring.popBatch( Items, Count );
+
+    if ( Popped == 0 )
+    {
+      Popped = Sleep_Pvt( m_NotEmpty_Ptr, m_WaitingPop, [&]() { return m_Ring.popBatch( Items, Count ); } );
+    }
+    else
+    {;}
+
+    if ( Popped != 0 )
+    {
+      Wake_Pvt( m_NotFull_Ptr, m_WaitingPush );
+    }
+    else
+    {;}
+
+    return Popped;
+  }
+
+  /**
+   * @brief Makes every push fail from now on, and wakes up the waiting threads.
+   **/
+  void close( void )
+  {
+    m_IsClosed.store( true );
+
+    SDL_LockMutex( m_Lock_Ptr );
+    SDL_CondBroadcast( m_NotEmpty_Ptr );
+    SDL_CondBroadcast( m_NotFull_Ptr );
+    SDL_UnlockMutex( m_Lock_Ptr );
+  }
+
+  bool isClosed( void ) const
+  {
+    return m_IsClosed.load();
+  }
+
+  Ring& GetRing( void )
+  {
+    return m_Ring;
+  }
+
+private:
+
+  /**
+   * @brief Sleeps on a condition until Attempt moves some items or the ring is closed. The sleeper
+   * is announced before the last attempt, and the other side checks for sleepers after its own
+   * move: with a full fence on both sides, at least one of the two sees the other.
+   *
+   * @return What the successful attempt returned, or 0 once closed.
+   **/
+  template <typename Attempt>
+  size_t Sleep_Pvt( SDL_cond* Condition_Ptr, std::atomic<int>& Sleepers, Attempt TryMove )
+  {
+    size_t Moved = 0;
+
+    SDL_LockMutex( m_Lock_Ptr );
+    Sleepers.fetch_add( 1 );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    while ( ( Moved = TryMove() ) == 0 && !m_IsClosed.load() )
+    {
+      SDL_CondWait( Condition_Ptr, m_Lock_Ptr );
+    }
+
+    Sleepers.fetch_sub( 1 );
+    SDL_UnlockMutex( m_Lock_Ptr );
+
+    return Moved;
+  }
+
+  /**
+   * @brief Wakes the threads sleeping on a condition, if any: no lock is taken when none sleeps.
+   **/
+  void Wake_Pvt( SDL_cond* Condition_Ptr, std::atomic<int>& Sleepers )
+  {
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    if ( Sleepers.load() > 0 )
+    {
+      SDL_LockMutex( m_Lock_Ptr );
+      SDL_CondBroadcast( Condition_Ptr );
+      SDL_UnlockMutex( m_Lock_Ptr );
+    }
+    else
+    {;}
+  }
+
+  Ring              m_Ring;
+  SDL_mutex*        m_Lock_Ptr;
+  SDL_cond*         m_NotEmpty_Ptr;
+  SDL_cond*         m_NotFull_Ptr;
+  std::atomic<int>  m_WaitingPop;
+  std::atomic<int>  m_WaitingPush;
+  std::atomic<bool> m_IsClosed;
+};
+
+#endif // LRINGBUFFER_HPP
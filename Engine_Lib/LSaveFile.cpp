@@ -0,0 +1,338 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LSaveFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 CRC_POLYNOMIAL = 0xEDB88320;   // CRC-32 of zlib and PNG, reflected
+static constexpr size_t CRC_SLICES     = 8;            // Bytes folded per step
+static constexpr char   TEMPORARY_EXTENSION[] = ".tmp";
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Tables of "slicing by 8": Tables[k][b] is the CRC of byte b followed by k zero bytes, so
+ * that eight bytes are folded with eight lookups and no dependency between them.
+ **/
+struct CrcTables
+{
+  Uint32 Tables[CRC_SLICES][256];
+
+  CrcTables( void )
+  {
+    for ( Uint32 b = 0; b != 256; ++b )
+    {
+      Uint32 Crc = b;
+
+      for ( int Bit = 0; Bit != 8; ++Bit )
+      {
+        Crc = ( Crc >> 1 ) ^ ( ( Crc & 1 ) ? CRC_POLYNOMIAL : 0 );
+      }
+
+      Tables[0][b] = Crc;
+    }
+
+    for ( size_t k = 1; k != CRC_SLICES; ++k )
+    {
+      for ( Uint32 b = 0; b != 256; ++b )
+      {
+        Tables[k][b] = ( Tables[k - 1][b] >> 8 ) ^ Tables[0][ Tables[k - 1][b] & 0xFF ];
+      }
+    }
+  }
+};
+
+
+/**
+ * @brief Makes sure what was written to the file has reached the disk, not just the OS cache.
+ **/
+static bool flushToDisk( FILE* File_Ptr )
+{
+  if ( fflush( File_Ptr ) != 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+#if defined(_WIN32)
+  return _commit( _fileno( File_Ptr ) ) == 0;
+#else
+  return fsync( fileno( File_Ptr ) ) == 0;
+#endif
+}
+
+
+/**
+ * @brief Renames From over To, replacing To in one step.
+ **/
+static bool replaceFile( const std::string& From, const std::string& To )
+{
+#if defined(_WIN32)
+  return MoveFileExA( From.c_str(), To.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+#else
+  return rename( From.c_str(), To.c_str() ) == 0;
+#endif
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief CRC-32, as zlib's crc32: pass the result of a previous call as Crc to go on with more data.
+ **/
+Uint32 LCrc32( const void* Data_Ptr, size_t Size, Uint32 Crc )
+{
+  static const CrcTables Crc_Tables;
+
+  const Uint32 ( &T )[CRC_SLICES][256] = Crc_Tables.Tables;
+  const Uint8* Bytes_Ptr               = static_cast<const Uint8*>( Data_Ptr );
+
+  Crc = ~Crc;
+
+  for ( ; Size >= CRC_SLICES; Size -= CRC_SLICES, Bytes_Ptr += CRC_SLICES )
+  {
+    Uint32 Low;
+    Uint32 High;
+
+    memcpy( &Low,  Bytes_Ptr,     sizeof(Low) );
+    memcpy( &High, Bytes_Ptr + 4, sizeof(High) );
+
+    if ( SDL_BYTEORDER == SDL_BIG_ENDIAN )
+    {
+      Low  = SDL_Swap32( Low );
+      High = SDL_Swap32( High );
+    }
+    else
+    {;}
+
+    Low ^= Crc;
+    Crc  = T[7][ Low & 0xFF ] ^ T[6][ ( Low >> 8 ) & 0xFF ] ^ T[5][ ( Low >> 16 ) & 0xFF ] ^ T[4][ Low >> 24 ]
+         ^ T[3][ High & 0xFF ] ^ T[2][ ( High >> 8 ) & 0xFF ] ^ T[1][ ( High >> 16 ) & 0xFF ] ^ T[0][ High >> 24 ];
+  }
+
+  for ( ; Size != 0; --Size, ++Bytes_Ptr )
+  {
+    Crc = ( Crc >> 8 ) ^ T[0][ ( Crc ^ *Bytes_Ptr ) & 0xFF ];
+  }
+
+  return ~Crc;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LSaveWriter::LSaveWriter( void )
+  : m_Buffer(sizeof(LSaveHeader))
+{;}
+
+
+/**
+ * @brief Makes room for a payload of the given size, so that writing it never reallocates.
+ **/
+void LSaveWriter::reserve( size_t PayloadSize )
+{
+  m_Buffer.reserve( sizeof(LSaveHeader) + PayloadSize );
+}
+
+
+/**
+ * @brief Drops the payload, keeping the memory, to build the next save.
+ **/
+void LSaveWriter::clear( void )
+{
+  m_Buffer.resize( sizeof(LSaveHeader) );
+}
+
+
+void LSaveWriter::write( const void* Data_Ptr, size_t Size )
+{
+  const Uint8* Bytes_Ptr = static_cast<const Uint8*>( Data_Ptr );
+
+  m_Buffer.insert( m_Buffer.end(), Bytes_Ptr, Bytes_Ptr + Size );
+}
+
+
+/**
+ * @brief Saves header and payload to Path, replacing it only once the new file is whole and on the
+ * disk. The payload is kept: clear it before building the next save.
+ *
+ * @param SchemaVersion The version of the payload, handed back by LSaveReader::GetVersion.
+ * @return true if saved; Path is left as it was otherwise.
+ **/
+bool LSaveWriter::commit( const std::string& Path, Uint32 SchemaVersion )
+{
+  LSaveHeader Header;
+
+  memcpy( Header.Magic, LSAVE_MAGIC, sizeof(Header.Magic) );
+  Header.FormatVersion = LSAVE_FORMAT_VERSION;
+  Header.SchemaVersion = SchemaVersion;
+  Header.PayloadSize   = GetSize();
+  Header.Crc           = LCrc32( m_Buffer.data() + sizeof(Header), GetSize() );
+
+  memcpy( m_Buffer.data(), &Header, sizeof(Header) );
+
+  const std::string TemporaryPath = Path + TEMPORARY_EXTENSION;
+  FILE*             File_Ptr      = fopen( TemporaryPath.c_str(), "wb" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to create \"%s\"!", TemporaryPath.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  bool Success = fwrite( m_Buffer.data(), m_Buffer.size(), 1, File_Ptr ) == 1 && flushToDisk( File_Ptr );
+
+  Success = ( fclose( File_Ptr ) == 0 ) && Success;
+  Success = Success && replaceFile( TemporaryPath, Path );
+
+  if ( !Success )
+  {
+    printf( "\nUnable to save \"%s\"!", Path.c_str() );
+    remove( TemporaryPath.c_str() );
+  }
+  else
+  {;}
+
+  return Success;
+}
+
+
+/**
+ * @return The size of the payload written so far.
+ **/
+size_t LSaveWriter::GetSize( void ) const
+{
+  return m_Buffer.size() - sizeof(LSaveHeader);
+}
+
+
+LSaveReader::LSaveReader( void )
+  : m_Payload(), m_Position(0), m_Version(0)
+{;}
+
+
+/**
+ * @brief Loads a save file: the header with one read, the payload with another, straight into its
+ * buffer.
+ *
+ * @param MaxVersion The newest schema version this program can read; older ones are loaded, for the
+ * program to convert according to GetVersion.
+ * @return Status::LOADED if the payload can be read.
+ **/
+LSaveReader::Status LSaveReader::load( const std::string& Path, Uint32 MaxVersion )
+{
+  m_Payload.clear();
+  m_Position = 0;
+  m_Version  = 0;
+
+  SDL_RWops* File_Ptr = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( File_Ptr == NULL )
+  {
+    return Status::MISSING;
+  }
+  else
+  {;}
+
+  const Sint64 FileSize = SDL_RWsize( File_Ptr );
+  LSaveHeader  Header;
+  Status       Result   = Status::CORRUPT;
+
+  if ( FileSize >= static_cast<Sint64>( sizeof(Header) ) && SDL_RWread( File_Ptr, &Header, sizeof(Header), 1 ) == 1
+       && memcmp( Header.Magic, LSAVE_MAGIC, sizeof(Header.Magic) ) == 0 && Header.FormatVersion == LSAVE_FORMAT_VERSION
+       && Header.PayloadSize == static_cast<Uint64>( FileSize ) - sizeof(Header) )
+  {
+    m_Payload.resize( static_cast<size_t>( Header.PayloadSize ) );
+
+    if ( Header.SchemaVersion > MaxVersion )
+    {
+      Result = Status::NEWER;
+    }
+    else if ( ( m_Payload.empty() || SDL_RWread( File_Ptr, m_Payload.data(), m_Payload.size(), 1 ) == 1 )
+              && LCrc32( m_Payload.data(), m_Payload.size() ) == Header.Crc )
+    {
+      Result = Status::LOADED;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  SDL_RWclose( File_Ptr );
+
+  if ( Result == Status::LOADED )
+  {
+    m_Version = Header.SchemaVersion;
+  }
+  else
+  {
+    printf( ( Result == Status::NEWER ) ? "\n\"%s\" was saved by a newer version!" : "\n\"%s\" is not a valid save file!", Path.c_str() );
+    m_Payload.clear();
+  }
+
+  return Result;
+}
+
+
+/**
+ * @brief Copies the next Size bytes of the payload.
+ *
+ * @return false, copying nothing, if fewer are left.
+ **/
+bool LSaveReader::read( void* Data_Ptr, size_t Size )
+{
+  if ( Size > GetRemaining() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  memcpy( Data_Ptr, m_Payload.data() + m_Position, Size );
+  m_Position += Size;
+
+  return true;
+}
+
+
+/**
+ * @return The schema version the loaded file was saved with.
+ **/
+Uint32 LSaveReader::GetVersion( void ) const
+{
+  return m_Version;
+}
+
+
+size_t LSaveReader::GetRemaining( void ) const
+{
+  return m_Payload.size() - m_Position;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file LSaveFile.hpp
+ *
+ * @brief Save files: a header with a schema version and a CRC-32, and the payload after it, written
+ * with a single write to a temporary file that then replaces the old one.
+ **/
+
+#ifndef LSAVEFILE_HPP
+#define LSAVEFILE_HPP
+
+#include <SDL.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A save file is this header followed by PayloadSize bytes, whatever the program wrote.
+ *
+ * Fields, and the values in the payload, are stored in the byte order of the machine that saved
+ * the file: on a machine of the other order the format version does not match, and the file is
+ * rejected.
+ **/
+struct LSaveHeader
+{
+  char   Magic[4];        // LSAVE_MAGIC
+  Uint32 FormatVersion;   // LSAVE_FORMAT_VERSION: of this header
+  Uint32 SchemaVersion;   // Of the payload, chosen by the program
+  Uint32 Crc;             // LCrc32 of the payload
+  Uint64 PayloadSize;
+};
+
+static constexpr char   LSAVE_MAGIC[4]       = { 'L', 'S', 'A', 'V' };
+static constexpr Uint32 LSAVE_FORMAT_VERSION = 1;
+
+static_assert( sizeof(LSaveHeader) == 24, "The save header must have no padding" );
+
+Uint32 LCrc32( const void*, size_t, Uint32 = 0 );
+
+
+/**
+ * @brief Builds a payload in memory, then saves it in one go. The header is kept at the start of
+ * the same buffer, so that header and payload leave with a single write.
+ *
+ * "commit" writes "<Path>.tmp", flushes it to the disk and renames it over Path: whenever the
+ * program or the machine stops, Path holds either the old save or the new one, never half of it.
+ **/
+class LSaveWriter
+{
+public:
+
+  LSaveWriter( void );
+
+  void   reserve( size_t );
+  void   clear  ( void );
+  void   write  ( const void*, size_t );
+  bool   commit ( const std::string&, Uint32 );
+
+  template <typename T>
+  void   writeValue( const T& Value )                 { writeArray( &Value, 1 ); }
+
+  template <typename T>
+  void   writeArray( const T* Values_Ptr, size_t Count )
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "Only plain data can be saved as it is" );
+    write( Values_Ptr, sizeof(T) * Count );
+  }
+
+  size_t GetSize( void ) const;
+
+private:
+
+  std::vector<Uint8> m_Buffer;   // Header, then payload
+};
+
+
+/**
+ * @brief Loads a save file with a single read, checks its header and CRC, then hands the payload
+ * out in the order it was written.
+ **/
+class LSaveReader
+{
+public:
+
+  enum class Status
+  {
+    LOADED,
+    MISSING,    // Not an error: a first run
+    CORRUPT,    // Not a save file, cut short, or failing the CRC
+    NEWER       // Saved by a newer version of the program
+  };
+
+  LSaveReader( void );
+
+  Status load( const std::string&, Uint32 );
+  bool   read( void*, size_t );
+
+  template <typename T>
+  bool   readValue( T& Value )                        { return readArray( &Value, 1 ); }
+
+  template <typename T>
+  bool   readArray( T* Values_Ptr, size_t Count )
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "Only plain data can be loaded as it is" );
+    return read( Values_Ptr, sizeof(T) * Count );
+  }
+
+  Uint32 GetVersion  ( void ) const;
+  size_t GetRemaining( void ) const;
+
+private:
+
+  std::vector<Uint8> m_Payload;
+  size_t             m_Position;
+  Uint32             m_Version;
+};
+
+#endif // LSAVEFILE_HPP
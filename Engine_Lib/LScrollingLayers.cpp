@@ -0,0 +1,189 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LScrollingLayers.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return Offset brought within [0, Tile).
+ **/
+static float Wrap( float Offset, int Tile )
+{
+  const float Size    = static_cast<float>( Tile );
+  float       Wrapped = std::fmod( Offset, Size );
+
+  if ( Wrapped < 0.0f )
+  {
+    Wrapped += Size;
+  }
+  else
+  {;}
+
+  // A tiny negative offset rounds up to the tile size itself
+  return ( Wrapped < Size ) ? Wrapped : 0.0f;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LScrollingLayers::LScrollingLayers( void )
+  : m_Layers(), m_Pieces(0)
+{;}
+
+
+/**
+ * @brief Adds a layer in front of the others.
+ *
+ * @param Source_Texture The texture of the layer; it must outlive the layer.
+ * @param Area Where the layer is repeated, in the window.
+ * @param FactorX How fast the layer scrolls with the camera, horizontally: 1 as fast, 0.5 half as
+ * fast (farther away), 0 not at all.
+ * @param FactorY The same, vertically. Defaults to 0.
+ * @param Clip The tile, in the texture. Defaults to NULL (the whole texture).
+ * @return the index of the layer; -1 if the texture is not loaded or the tile or the area is empty.
+ **/
+int LScrollingLayers::addLayer( const LTexture& Source_Texture, const SDL_Rect& Area, float FactorX, float FactorY, const SDL_Rect* Clip )
+{
+  const SDL_Rect Whole{ 0, 0, Source_Texture.getWidth(), Source_Texture.getHeight() };
+  const SDL_Rect& Tile = ( Clip != NULL ) ? *Clip : Whole;
+
+  if ( !Source_Texture.isValid() || Tile.w <= 0 || Tile.h <= 0 || Area.w <= 0 || Area.h <= 0 )
+  {
+    printf( "\nUnable to add a scrolling layer of a %dx%d tile over %dx%d pixels!", Tile.w, Tile.h, Area.w, Area.h );
+    return -1;
+  }
+  else
+  {;}
+
+  m_Layers.push_back( Layer{ &Source_Texture, Tile, Area, FactorX, FactorY, 0.0f, 0.0f } );
+
+  return GetLayerCount() - 1;
+}
+
+
+void LScrollingLayers::clear( void )
+{
+  m_Layers.clear();
+}
+
+
+/**
+ * @brief Moves the camera: every layer scrolls by the motion times its factors. Positive values
+ * move the view right and down, so the layers move left and up.
+ *
+ * @param dx Horizontal motion, in pixels; fractions are kept.
+ * @param dy Vertical motion. Defaults to 0.
+ **/
+void LScrollingLayers::scroll( float dx, float dy )
+{
+  for ( Layer& Current : m_Layers )
+  {
+    Current.OffsetX = Wrap( Current.OffsetX + dx * Current.FactorX, Current.Clip.w );
+    Current.OffsetY = Wrap( Current.OffsetY + dy * Current.FactorY, Current.Clip.h );
+  }
+}
+
+
+/**
+ * @brief Places a layer directly, e.g. from a camera position of its own.
+ **/
+void LScrollingLayers::setOffset( int Index, float x, float y )
+{
+  if ( Index >= 0 && Index < GetLayerCount() )
+  {
+    m_Layers[Index].OffsetX = Wrap( x, m_Layers[Index].Clip.w );
+    m_Layers[Index].OffsetY = Wrap( y, m_Layers[Index].Clip.h );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Queues every layer, back to front, into a batch begun by the caller: other sprites can
+ * follow them in the same flush.
+ **/
+void LScrollingLayers::add( LSpriteBatch& Batch )
+{
+  m_Pieces = 0;
+
+  for ( const Layer& Current : m_Layers )
+  {
+    const float TileW = static_cast<float>( Current.Clip.w );
+    const float TileH = static_cast<float>( Current.Clip.h );
+    const float AreaW = static_cast<float>( Current.Area.w );
+    const float AreaH = static_cast<float>( Current.Area.h );
+
+    // Rows and columns of pieces: the rest of the tile from the offset, whole tiles, then the start
+    // of one. Each piece is a span of the tile, so no pixel of the area is drawn twice
+    float StartY = Current.OffsetY;
+
+    for ( float y = 0.0f; y < AreaH; y += TileH - StartY, StartY = 0.0f )
+    {
+      const float SpanY  = SDL_min( TileH - StartY, AreaH - y );
+      float       StartX = Current.OffsetX;
+
+      for ( float x = 0.0f; x < AreaW; x += TileW - StartX, StartX = 0.0f )
+      {
+        const float SpanX = SDL_min( TileW - StartX, AreaW - x );
+
+        const SDL_FRect Source     { static_cast<float>( Current.Clip.x ) + StartX, static_cast<float>( Current.Clip.y ) + StartY, SpanX, SpanY };
+        const SDL_FRect Destination{ static_cast<float>( Current.Area.x ) + x     , static_cast<float>( Current.Area.y ) + y     , SpanX, SpanY };
+
+        Batch.add( *Current.Texture_Ptr, Source, Destination );
+        ++m_Pieces;
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Draws every layer: begins the batch, queues the layers and flushes it.
+ *
+ * @param Batch The batch to draw with.
+ * @param Renderer_Ptr As for LSpriteBatch::flush.
+ **/
+void LScrollingLayers::render( LSpriteBatch& Batch, SDL_Renderer* Renderer_Ptr )
+{
+  Batch.begin();
+  add( Batch );
+  Batch.flush( Renderer_Ptr );
+}
+
+
+int LScrollingLayers::GetLayerCount( void ) const
+{
+  return static_cast<int>( m_Layers.size() );
+}
+
+
+float LScrollingLayers::GetOffsetX( int Index ) const
+{
+  return m_Layers[Index].OffsetX;
+}
+
+
+float LScrollingLayers::GetOffsetY( int Index ) const
+{
+  return m_Layers[Index].OffsetY;
+}
+
+
+/**
+ * @return the pieces queued by the last add, for all the layers.
+ **/
+size_t LScrollingLayers::GetPieces( void ) const
+{
+  return m_Pieces;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file LScrollingLayers.hpp
+ *
+ * @brief Endless scrolling backgrounds: textures repeated without seams over areas of the window,
+ * each moving at its own parallax speed, drawn through one sprite batch.
+ **/
+
+#ifndef LSCROLLINGLAYERS_HPP
+#define LSCROLLINGLAYERS_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+
+/**
+ * @brief The layers of a scrolling background, back to front.
+ *
+ * A layer is a clip of a texture (a tile) repeated over an area of the window and shifted by an
+ * offset, kept wrapped within the tile and in floating point, so that slow layers move by fractions
+ * of a pixel and never drift however long they scroll. "scroll" moves every layer by the camera
+ * motion times its parallax factor.
+ *
+ * SDL_Renderer cannot wrap texture coordinates, so each layer is cut into the fewest pieces of its
+ * tile that cover its area exactly: for a tile as large as the area, two columns where the old way
+ * drew the whole texture twice. Every pixel of an area is drawn once per layer, and all the pieces
+ * of all the layers go to one LSpriteBatch, one draw call per texture.
+ *
+ * The batch groups the pieces by texture: layers sharing a texture should be consecutive, or not
+ * overlap, for the back to front order to hold.
+ **/
+class LScrollingLayers
+{
+public:
+
+  LScrollingLayers( void );
+
+  int  addLayer  ( const LTexture&, const SDL_Rect&, float, float = 0.0f, const SDL_Rect* = NULL );
+  void clear     ( void );
+  void scroll    ( float, float = 0.0f );
+  void setOffset ( int, float, float );
+  void add       ( LSpriteBatch& );
+  void render    ( LSpriteBatch&, SDL_Renderer* = nullptr );
+
+  int    GetLayerCount ( void ) const;
+  float  GetOffsetX    ( int ) const;
+  float  GetOffsetY    ( int ) const;
+  size_t GetPieces     ( void ) const;
+
+private:
+
+  struct Layer
+  {
+    const LTexture* Texture_Ptr;
+    SDL_Rect        Clip;       // The tile, in the texture
+    SDL_Rect        Area;       // Where it is repeated, in the window
+    float           FactorX;    // Parallax: 1 moves with the camera, 0 stands still
+    float           FactorY;
+    float           OffsetX;    // Of the area's top-left corner in the tile, within [0, Clip.w)
+    float           OffsetY;    // Within [0, Clip.h)
+  };
+
+  std::vector<Layer> m_Layers;
+  size_t             m_Pieces;   // Queued by the last add
+};
+
+#endif // LSCROLLINGLAYERS_HPP
@@ -0,0 +1,534 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LSdfFont.hpp"
+#include "LGlyphAtlas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32    GLYPH_FORMAT   = SDL_PIXELFORMAT_ARGB8888;
+static constexpr SDL_Color GLYPH_COLOUR   = { 0xFF, 0xFF, 0xFF, 0xFF };
+static constexpr Uint32    INSIDE_ALPHA   = 128;   // Coverage from which a pixel is part of the glyph
+static constexpr float     FAR_AWAY       = 1e20f; // Squared distance of a pixel with no feature yet
+static constexpr float     OUTLINE_VALUE  = 128.f;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Squared distance transform of one line of samples, in place (Felzenszwalb and
+ * Huttenlocher): each sample becomes its squared distance to the nearest feature, the samples
+ * that are 0, in linear time.
+ *
+ * @param Line_Ptr First sample.
+ * @param Count Samples in the line.
+ * @param Step Distance between consecutive samples, in floats.
+ * @param F, Z, V Scratch, at least Count + 1 items each.
+ **/
+static void DistanceTransform1D( float* Line_Ptr, int Count, int Step, float* F, float* Z, int* V )
+{
+  for ( int q = 0; q != Count; ++q )
+  {
+    F[q] = Line_Ptr[q * Step];
+  }
+
+  // Lower envelope of the parabolas rooted at each sample
+  int k = 0;
+
+  V[0] = 0;
+  Z[0] = -FAR_AWAY;
+  Z[1] =  FAR_AWAY;
+
+  for ( int q = 1; q != Count; ++q )
+  {
+    float Meet;
+
+    while ( true )
+    {
+      const int r = V[k];
+
+      Meet = ( ( F[q] + static_cast<float>( q * q ) ) - ( F[r] + static_cast<float>( r * r ) ) ) / static_cast<float>( 2 * ( q - r ) );
+
+      if ( Meet > Z[k] )
+      {
+        break;
+      }
+      else
+      {
+        --k;
+      }
+    }
+
+    ++k;
+    V[k]     = q;
+    Z[k]     = Meet;
+    Z[k + 1] = FAR_AWAY;
+  }
+
+  k = 0;
+
+  for ( int q = 0; q != Count; ++q )
+  {
+    while ( Z[k + 1] < static_cast<float>( q ) )
+    {
+      ++k;
+    }
+
+    const int Offset = q - V[k];
+
+    Line_Ptr[q * Step] = static_cast<float>( Offset * Offset ) + F[V[k]];
+  }
+}
+
+
+/**
+ * @brief Squared distance transform of a grid: columns, then rows.
+ **/
+static void DistanceTransform2D( std::vector<float>& Grid, int Width, int Height,
+                                 std::vector<float>& F, std::vector<float>& Z, std::vector<int>& V )
+{
+  const size_t Longest = static_cast<size_t>( std::max( Width, Height ) ) + 1;
+
+  F.resize( Longest );
+  Z.resize( Longest );
+  V.resize( Longest );
+
+  for ( int x = 0; x != Width; ++x )
+  {
+    DistanceTransform1D( &Grid[static_cast<size_t>( x )], Height, Width, F.data(), Z.data(), V.data() );
+  }
+
+  for ( int y = 0; y != Height; ++y )
+  {
+    DistanceTransform1D( &Grid[static_cast<size_t>( y ) * static_cast<size_t>( Width )], Width, 1, F.data(), Z.data(), V.data() );
+  }
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LSdfFont::LSdfFont( void )
+  : m_Height(0), m_BaseSize(0), m_LineHeight(0), m_Spread(s_DEFAULT_SPREAD_px), m_PenX(0), m_PenY(0),
+    m_RowHeight(0), m_IsBaked(), m_Glyphs()
+{;}
+
+
+/**
+ * @brief Bakes the distance fields of the Latin-1 glyphs of a font. Takes a few milliseconds per
+ * glyph; the font can be closed afterwards.
+ *
+ * @param Font_Ptr The font, opened at the base size.
+ * @param BaseSize The point size it was opened at; the sizes given to "layout" are relative to it.
+ * @param Spread Distance, in base-size pixels, covered by the field on each side of the outline.
+ *               Larger allows outlines and glows; the atlas grows with it.
+ * @return true if the font was baked.
+ **/
+bool LSdfFont::bake( TTF_Font* Font_Ptr, int BaseSize, int Spread )
+{
+  free();
+
+  if ( Font_Ptr == nullptr || BaseSize <= 0 )
+  {
+    printf( "\nUnable to bake the distance field: no font!" );
+    return false;
+  }
+  else
+  {;}
+
+  m_BaseSize   = BaseSize;
+  m_LineHeight = TTF_FontHeight( Font_Ptr );
+  m_Spread     = std::max( Spread, 1 );
+
+  for ( Uint32 Codepoint = s_FIRST_GLYPH; Codepoint != s_NUM_OF_GLYPHS; ++Codepoint )
+  {
+    // DEL and the C1 controls
+    if ( Codepoint >= 0x7F && Codepoint < 0xA0 )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    BakeGlyph_Pvt( Font_Ptr, Codepoint );
+  }
+
+  m_Height = m_PenY + m_RowHeight;
+
+  // Kerning of every pair, looked up from the table when text is laid out
+  if ( TTF_GetFontKerning( Font_Ptr ) != 0 )
+  {
+    m_Kerning.assign( static_cast<size_t>( s_NUM_OF_GLYPHS ) * s_NUM_OF_GLYPHS, 0 );
+
+    for ( Uint32 Previous = s_FIRST_GLYPH; Previous != s_NUM_OF_GLYPHS; ++Previous )
+    {
+      for ( Uint32 Codepoint = s_FIRST_GLYPH; Codepoint != s_NUM_OF_GLYPHS && m_IsBaked[Previous]; ++Codepoint )
+      {
+        if ( m_IsBaked[Codepoint] )
+        {
+          m_Kerning[Previous * s_NUM_OF_GLYPHS + Codepoint] =
+            static_cast<Sint16>( TTF_GetFontKerningSizeGlyphs32( Font_Ptr, Previous, Codepoint ) );
+        }
+        else
+        {;}
+      }
+    }
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Forgets the glyphs and releases the atlas.
+ **/
+void LSdfFont::free( void )
+{
+  std::vector<Uint8>().swap( m_Pixels );
+  std::vector<Sint16>().swap( m_Kerning );
+
+  m_Height     = 0;
+  m_BaseSize   = 0;
+  m_LineHeight = 0;
+  m_PenX       = 0;
+  m_PenY       = 0;
+  m_RowHeight  = 0;
+
+  for ( bool& IsBaked : m_IsBaked )
+  {
+    IsBaked = false;
+  }
+}
+
+
+/**
+ * @brief Frees the texels once they are uploaded; the glyphs are kept, and text can still be laid
+ * out.
+ **/
+void LSdfFont::releasePixels( void )
+{
+  std::vector<Uint8>().swap( m_Pixels );
+}
+
+
+/**
+ * @return Width in pixels of the widest line of the text, drawn at Size points.
+ **/
+float LSdfFont::measure( const char* Text_Ptr, float Size ) const
+{
+  if ( Text_Ptr == nullptr || !IsBaked() )
+  {
+    return 0.f;
+  }
+  else
+  {;}
+
+  const unsigned char* Next_Ptr = reinterpret_cast<const unsigned char*>( Text_Ptr );
+  int                  Widest   = 0;
+  int                  Width    = 0;
+  Uint32               Previous = 0;
+
+  while ( *Next_Ptr != '\0' )
+  {
+    int          Bytes;
+    const Uint32 Codepoint = DecodeUtf8( Next_Ptr, Bytes );
+
+    Next_Ptr += Bytes;
+
+    if ( Codepoint == '\n' )
+    {
+      Widest   = std::max( Widest, Width );
+      Width    = 0;
+      Previous = 0;
+      continue;
+    }
+    else
+    {;}
+
+    const Uint32 Baked = Resolve_Pvt( Codepoint );
+
+    Width   += GetKerning_Pvt( Previous, Baked ) + m_Glyphs[Baked].Advance;
+    Previous = Baked;
+  }
+
+  return static_cast<float>( std::max( Widest, Width ) ) * Size / static_cast<float>( m_BaseSize );
+}
+
+
+/**
+ * @brief Appends the quads of a text, two triangles per visible glyph, to be drawn with the atlas
+ * texture. Nothing is drawn: the caller collects a frame's text and submits it in one call.
+ *
+ * @param Text_Ptr UTF-8 text; '\n' starts a new line.
+ * @param X, Y Top-left corner of the first line, in window pixels.
+ * @param Size Point size to draw at.
+ * @param Vertices Where the triangles are appended; reuse it across frames so that it stops
+ *                 allocating.
+ **/
+void LSdfFont::layout( const char* Text_Ptr, float X, float Y, float Size, std::vector<LSdfVertex>& Vertices ) const
+{
+  if ( Text_Ptr == nullptr || !IsBaked() || m_Height == 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const float          Scale    = Size / static_cast<float>( m_BaseSize );
+  const float          Margin   = static_cast<float>( m_Spread ) * Scale;
+  const float          ToU      = 1.f / static_cast<float>( s_ATLAS_W );
+  const float          ToV      = 1.f / static_cast<float>( m_Height );
+  const unsigned char* Next_Ptr = reinterpret_cast<const unsigned char*>( Text_Ptr );
+  float                PenX     = X;
+  float                PenY     = Y;
+  Uint32               Previous = 0;
+
+  while ( *Next_Ptr != '\0' )
+  {
+    int          Bytes;
+    const Uint32 Codepoint = DecodeUtf8( Next_Ptr, Bytes );
+
+    Next_Ptr += Bytes;
+
+    if ( Codepoint == '\n' )
+    {
+      PenX     = X;
+      PenY    += static_cast<float>( m_LineHeight ) * Scale;
+      Previous = 0;
+      continue;
+    }
+    else
+    {;}
+
+    const Uint32 Baked = Resolve_Pvt( Codepoint );
+    const Glyph& Each  = m_Glyphs[Baked];
+
+    PenX    += static_cast<float>( GetKerning_Pvt( Previous, Baked ) ) * Scale;
+    Previous = Baked;
+
+    if ( Each.Clip.w != 0 )
+    {
+      // The field starts "Spread" pixels before the pen and above the line
+      const float Left   = PenX - Margin;
+      const float Top    = PenY - Margin;
+      const float Right  = Left + static_cast<float>( Each.Clip.w ) * Scale;
+      const float Bottom = Top  + static_cast<float>( Each.Clip.h ) * Scale;
+      const float U0     = static_cast<float>( Each.Clip.x ) * ToU;
+      const float V0     = static_cast<float>( Each.Clip.y ) * ToV;
+      const float U1     = static_cast<float>( Each.Clip.x + Each.Clip.w ) * ToU;
+      const float V1     = static_cast<float>( Each.Clip.y + Each.Clip.h ) * ToV;
+
+      Vertices.push_back( LSdfVertex{ Left , Top   , U0, V0 } );
+      Vertices.push_back( LSdfVertex{ Right, Top   , U1, V0 } );
+      Vertices.push_back( LSdfVertex{ Left , Bottom, U0, V1 } );
+      Vertices.push_back( LSdfVertex{ Right, Top   , U1, V0 } );
+      Vertices.push_back( LSdfVertex{ Right, Bottom, U1, V1 } );
+      Vertices.push_back( LSdfVertex{ Left , Bottom, U0, V1 } );
+    }
+    else
+    {;}
+
+    PenX += static_cast<float>( Each.Advance ) * Scale;
+  }
+}
+
+
+/**
+ * @return Distance between two lines drawn at Size points.
+ **/
+float LSdfFont::getLineHeight( float Size ) const
+{
+  return IsBaked() ? static_cast<float>( m_LineHeight ) * Size / static_cast<float>( m_BaseSize ) : 0.f;
+}
+
+
+bool LSdfFont::IsBaked( void ) const
+{
+  return m_BaseSize != 0;
+}
+
+
+/**
+ * @return GetWidth() x GetHeight() texels, one byte each, rows packed; nullptr once released.
+ **/
+const Uint8* LSdfFont::GetPixels( void ) const
+{
+  return m_Pixels.data();
+}
+
+
+int LSdfFont::GetWidth( void ) const
+{
+  return s_ATLAS_W;
+}
+
+
+int LSdfFont::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+int LSdfFont::GetBaseSize( void ) const
+{
+  return m_BaseSize;
+}
+
+
+int LSdfFont::GetSpread( void ) const
+{
+  return m_Spread;
+}
+
+
+/**
+ * @brief Renders a glyph at the base size and stores its distance field in the next free spot of
+ * the atlas: for every texel, the distance to the nearest pixel on the other side of the outline.
+ **/
+void LSdfFont::BakeGlyph_Pvt( TTF_Font* Font_Ptr, Uint32 Codepoint )
+{
+  Glyph& Result = m_Glyphs[Codepoint];
+  int    MinX, MaxX, MinY, MaxY;
+
+  Result = Glyph{ SDL_Rect{ 0, 0, 0, 0 }, 0 };
+
+  if ( TTF_GlyphMetrics32( Font_Ptr, Codepoint, &MinX, &MaxX, &MinY, &MaxY, &Result.Advance ) != 0 )
+  {
+    return; // Not in the font: drawn as s_MISSING
+  }
+  else
+  {;}
+
+  m_IsBaked[Codepoint] = true;
+
+  SDL_Surface* Rendered_Ptr = TTF_RenderGlyph32_Blended( Font_Ptr, Codepoint, GLYPH_COLOUR );
+
+  if ( Rendered_Ptr == nullptr )
+  {
+    return; // E.g. the space: nothing to draw
+  }
+  else
+  {;}
+
+  SDL_Surface* Converted_Ptr = SDL_ConvertSurfaceFormat( Rendered_Ptr, GLYPH_FORMAT, 0 );
+  SDL_FreeSurface( Rendered_Ptr );
+
+  if ( Converted_Ptr == nullptr )
+  {
+    printf( "\nUnable to convert glyph %u! SDL Error: %s", static_cast<unsigned>( Codepoint ), SDL_GetError() );
+    return;
+  }
+  else
+  {;}
+
+  // The glyph cell, with room for the field all around
+  const int    Width  = Converted_Ptr->w + 2 * m_Spread;
+  const int    Height = Converted_Ptr->h + 2 * m_Spread;
+  const size_t Count  = static_cast<size_t>( Width ) * static_cast<size_t>( Height );
+
+  if ( Width > s_ATLAS_W )
+  {
+    printf( "\nGlyph %u is too wide for the distance field atlas!", static_cast<unsigned>( Codepoint ) );
+    SDL_FreeSurface( Converted_Ptr );
+    return;
+  }
+  else
+  {;}
+
+  std::vector<float> ToInside ( Count, FAR_AWAY ); // Squared distance to the glyph
+  std::vector<float> ToOutside( Count, 0.f );      // Squared distance to the background
+
+  for ( int y = 0; y != Converted_Ptr->h; ++y )
+  {
+    const Uint32* Row_Ptr = reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( Converted_Ptr->pixels ) + y * Converted_Ptr->pitch );
+
+    for ( int x = 0; x != Converted_Ptr->w; ++x )
+    {
+      if ( ( Row_Ptr[x] >> 24 ) >= INSIDE_ALPHA )
+      {
+        const size_t i = static_cast<size_t>( y + m_Spread ) * static_cast<size_t>( Width ) + static_cast<size_t>( x + m_Spread );
+
+        ToInside [i] = 0.f;
+        ToOutside[i] = FAR_AWAY;
+      }
+      else
+      {;}
+    }
+  }
+
+  SDL_FreeSurface( Converted_Ptr );
+
+  std::vector<float> F, Z;
+  std::vector<int>   V;
+
+  DistanceTransform2D( ToInside , Width, Height, F, Z, V );
+  DistanceTransform2D( ToOutside, Width, Height, F, Z, V );
+
+  // Next row when this one is full
+  if ( m_PenX + Width > s_ATLAS_W )
+  {
+    m_PenX      = 0;
+    m_PenY     += m_RowHeight + s_PADDING_px;
+    m_RowHeight = 0;
+  }
+  else
+  {;}
+
+  const size_t Rows = static_cast<size_t>( m_PenY + Height );
+
+  if ( m_Pixels.size() < Rows * s_ATLAS_W )
+  {
+    m_Pixels.resize( Rows * s_ATLAS_W, 0 ); // 0 is as far outside as the field goes
+  }
+  else
+  {;}
+
+  // Signed distance, positive inside, measured from the outline between the pixels
+  const float ToValue = ( OUTLINE_VALUE - 1.f ) / static_cast<float>( m_Spread );
+
+  for ( int y = 0; y != Height; ++y )
+  {
+    Uint8* Texel_Ptr = &m_Pixels[static_cast<size_t>( m_PenY + y ) * s_ATLAS_W + static_cast<size_t>( m_PenX )];
+
+    for ( int x = 0; x != Width; ++x )
+    {
+      const size_t i        = static_cast<size_t>( y ) * static_cast<size_t>( Width ) + static_cast<size_t>( x );
+      const float  Distance = ( ToInside[i] == 0.f ) ? std::sqrt( ToOutside[i] ) - 0.5f : 0.5f - std::sqrt( ToInside[i] );
+      const float  Value    = OUTLINE_VALUE + Distance * ToValue;
+
+      Texel_Ptr[x] = static_cast<Uint8>( std::min( std::max( Value, 0.f ), 255.f ) );
+    }
+  }
+
+  Result.Clip = SDL_Rect{ m_PenX, m_PenY, Width, Height };
+  m_PenX     += Width + s_PADDING_px;
+  m_RowHeight = std::max( m_RowHeight, Height );
+}
+
+
+/**
+ * @return The glyph to draw for a code point: itself if baked, s_MISSING otherwise.
+ **/
+Uint32 LSdfFont::Resolve_Pvt( Uint32 Codepoint ) const
+{
+  return ( Codepoint < s_NUM_OF_GLYPHS && m_IsBaked[Codepoint] ) ? Codepoint : s_MISSING;
+}
+
+
+int LSdfFont::GetKerning_Pvt( Uint32 Previous, Uint32 Codepoint ) const
+{
+  return ( m_Kerning.empty() || Previous == 0 ) ? 0 : m_Kerning[Previous * s_NUM_OF_GLYPHS + Codepoint];
+}
@@ -0,0 +1,90 @@
+/**
+ * @file LSdfFont.hpp
+ *
+ * @brief Signed distance field atlas of a TTF font: baked once at one size, drawn at any size.
+ **/
+
+#ifndef LSDFFONT_HPP
+#define LSDFFONT_HPP
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <vector>
+
+/**
+ * @brief A corner of a glyph quad: position in window pixels, y down, and atlas coordinates.
+ **/
+struct LSdfVertex
+{
+  float X;
+  float Y;
+  float U;
+  float V;
+};
+
+/**
+ * @brief The glyphs of a font, Latin-1 range, stored as distances from their outline rather than as
+ * coverage. The atlas is baked once from the font opened at a base size; since distances scale
+ * linearly, a shader that thresholds them at the outline draws crisp text at any size from the same
+ * texture, with no font to reopen and nothing to rasterise again.
+ *
+ * Each texel is 8 bits: 128 on the outline, more inside, less outside, reaching 0 and 255 at
+ * "Spread" base-size pixels away. The atlas stays in system memory, for the caller to upload to
+ * a single-channel texture and then release; the font is only needed by "bake".
+ **/
+class LSdfFont
+{
+public:
+
+  static constexpr int s_DEFAULT_SPREAD_px = 6;
+  static constexpr int s_ATLAS_W           = 512;
+
+  struct Glyph
+  {
+    SDL_Rect Clip;    // Position in the atlas, the spread included; empty if there is nothing to draw
+    int      Advance; // Horizontal pen movement, at the base size
+  };
+
+  LSdfFont( void );
+
+  bool          bake         ( TTF_Font*, int, int = s_DEFAULT_SPREAD_px );
+  void          free         ( void );
+  void          releasePixels( void );
+
+  float         measure      ( const char*, float ) const;
+  void          layout       ( const char*, float, float, float, std::vector<LSdfVertex>& ) const;
+  float         getLineHeight( float ) const;
+
+  bool          IsBaked      ( void ) const;
+  const Uint8*  GetPixels    ( void ) const;
+  int           GetWidth     ( void ) const;
+  int           GetHeight    ( void ) const;
+  int           GetBaseSize  ( void ) const;
+  int           GetSpread    ( void ) const;
+
+private:
+
+  static constexpr Uint32 s_NUM_OF_GLYPHS = 256; // Latin-1
+  static constexpr Uint32 s_FIRST_GLYPH   = 32;  // Control characters are not baked
+  static constexpr Uint32 s_MISSING       = '?'; // Drawn for what is not baked
+  static constexpr int    s_PADDING_px    = 1;   // Between glyphs, against filtering bleed
+
+  void         BakeGlyph_Pvt ( TTF_Font*, Uint32 );
+  Uint32       Resolve_Pvt   ( Uint32 ) const;
+  int          GetKerning_Pvt( Uint32, Uint32 ) const;
+
+  std::vector<Uint8>  m_Pixels;
+  std::vector<Sint16> m_Kerning;     // s_NUM_OF_GLYPHS x s_NUM_OF_GLYPHS, base size; empty without kerning
+  int                 m_Height;      // Rows of the atlas in use
+  int                 m_BaseSize;    // Point size the font was opened at
+  int                 m_LineHeight;  // At the base size
+  int                 m_Spread;
+  int                 m_PenX;        // Where the next glyph goes
+  int                 m_PenY;
+  int                 m_RowHeight;   // Tallest glyph of the current row
+  bool                m_IsBaked[s_NUM_OF_GLYPHS];
+  Glyph               m_Glyphs[s_NUM_OF_GLYPHS];
+};
+
+#endif // LSDFFONT_HPP
@@ -0,0 +1,132 @@
+/**
+ * @file LSmallVector.hpp
+ *
+ * @brief Array that keeps its first items inside itself, for short per-frame lists.
+ **/
+
+#ifndef LSMALLVECTOR_HPP
+#define LSMALLVECTOR_HPP
+
+#include "LFrameArena.hpp"
+
+#include <SDL.h>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief A vector of trivial items whose first N live in the object itself: lists that are usually
+ * short, built and dropped within a frame, allocate nothing. Beyond N, the items move to the frame
+ * arena given at construction, which must not be reset while the vector is in use, or to the heap
+ * when there is none (e.g. on worker threads).
+ **/
+template <typename T, size_t N>
+class LSmallVector
+{
+  static_assert( std::is_trivially_copyable<T>::value, "Items are moved with memcpy" );
+  static_assert( N > 0, "At least one item inside" );
+
+public:
+
+  explicit LSmallVector( LFrameArena* Arena_Ptr = nullptr )
+    : m_Items_Ptr(reinterpret_cast<T*>( m_Inline )), m_Size(0), m_Capacity(N), m_Arena_Ptr(Arena_Ptr)
+  {;}
+
+  ~LSmallVector( void )
+  {
+    Release_Pvt();
+  }
+
+  LSmallVector( const LSmallVector& )            = delete;
+  LSmallVector& operator=( const LSmallVector& ) = delete;
+
+  void push_back( const T& Item )
+  {
+    if ( m_Size == m_Capacity )
+    {
+      // Item may be one of ours: copied before the items move
+      const T Copy = Item;
+
+      reserve( m_Capacity * 2 );
+      m_Items_Ptr[m_Size++] = Copy;
+    }
+    else
+    {
+      m_Items_Ptr[m_Size++] = Item;
+    }
+  }
+
+  void pop_back( void ) { --m_Size; }
+  void clear   ( void ) { m_Size = 0; }
+
+  /**
+   * @brief New items are left uninitialised.
+   **/
+  void resize( size_t Size )
+  {
+    reserve( Size );
+    m_Size = Size;
+  }
+
+  void reserve( size_t Capacity )
+  {
+    if ( Capacity <= m_Capacity )
+    {
+      return;
+    }
+    else
+    {;}
+
+    T* const Items_Ptr = ( m_Arena_Ptr != nullptr )
+                         ? m_Arena_Ptr->allocateArray<T>( Capacity )
+                         : static_cast<T*>( ::operator new( Capacity * sizeof(T) ) );
+
+    std::memcpy( static_cast<void*>( Items_Ptr ), m_Items_Ptr, m_Size * sizeof(T) );
+    Release_Pvt();
+
+    m_Items_Ptr = Items_Ptr;
+    m_Capacity  = Capacity;
+  }
+
+  T&       operator[]( size_t i )       { return m_Items_Ptr[i]; }
+  const T& operator[]( size_t i ) const { return m_Items_Ptr[i]; }
+
+  T*       data ( void )       { return m_Items_Ptr; }
+  const T* data ( void ) const { return m_Items_Ptr; }
+  T*       begin( void )       { return m_Items_Ptr; }
+  const T* begin( void ) const { return m_Items_Ptr; }
+  T*       end  ( void )       { return m_Items_Ptr + m_Size; }
+  const T* end  ( void ) const { return m_Items_Ptr + m_Size; }
+
+  size_t   size       ( void ) const { return m_Size; }
+  bool     empty      ( void ) const { return m_Size == 0; }
+  size_t   GetCapacity( void ) const { return m_Capacity; }
+
+  /**
+   * @return true while the items are still inside the object.
+   **/
+  bool     isInline   ( void ) const { return m_Items_Ptr == reinterpret_cast<const T*>( m_Inline ); }
+
+private:
+
+  /**
+   * @brief Frees the items taken from the heap; those of the arena go with its next reset.
+   **/
+  void Release_Pvt( void )
+  {
+    if ( !isInline() && m_Arena_Ptr == nullptr )
+    {
+      ::operator delete( m_Items_Ptr );
+    }
+    else
+    {;}
+  }
+
+  alignas(T) unsigned char m_Inline[ N * sizeof(T) ];
+  T*                       m_Items_Ptr;
+  size_t                   m_Size;
+  size_t                   m_Capacity;
+  LFrameArena*             m_Arena_Ptr;
+};
+
+#endif // LSMALLVECTOR_HPP
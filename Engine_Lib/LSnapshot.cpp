@@ -0,0 +1,261 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LSnapshot.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LSnapshotWriter::LSnapshotWriter( void )
+  : m_Writer(), m_Sections(), m_IsOpen(false)
+{;}
+
+
+/**
+ * @brief Makes room for sections of the given total size, so that writing them never reallocates.
+ **/
+void LSnapshotWriter::reserve( size_t Size )
+{
+  m_Writer.reserve( Size );
+}
+
+
+/**
+ * @brief Drops the sections, keeping the memory, to build the next snapshot.
+ **/
+void LSnapshotWriter::clear( void )
+{
+  m_Writer.clear();
+  m_Sections.clear();
+  m_IsOpen = false;
+}
+
+
+/**
+ * @brief Ends the current section, if any, and starts the next: what is written from now on is its
+ * content. A tag written twice is found as its first section.
+ **/
+void LSnapshotWriter::beginSection( Uint32 Tag )
+{
+  EndSection_Pvt();
+
+  static const Uint8 Zeros[LSNAPSHOT_ALIGN] = {};
+
+  const size_t Misaligned = ( sizeof(LSaveHeader) + GetSize() ) % LSNAPSHOT_ALIGN;
+
+  if ( Misaligned != 0 )
+  {
+    m_Writer.write( Zeros, LSNAPSHOT_ALIGN - Misaligned );
+  }
+  else
+  {;}
+
+  m_Sections.push_back( LSnapshotSection{ Tag, 0, GetSize(), 0 } );
+  m_IsOpen = true;
+}
+
+
+void LSnapshotWriter::write( const void* Data_Ptr, size_t Size )
+{
+  if ( !m_IsOpen )
+  {
+    printf( "\nLSnapshotWriter: data written outside a section!" );
+    return;
+  }
+  else
+  {;}
+
+  m_Writer.write( Data_Ptr, Size );
+}
+
+
+/**
+ * @brief Ends the last section, appends the table of the sections and the trailer, and saves the
+ * snapshot to Path through LSaveWriter, replacing it only once the new file is whole and on the
+ * disk. The writer is then left empty, for the next snapshot.
+ *
+ * @param SchemaVersion The version of the content of the sections: a snapshot is used only by a
+ * program of the same version.
+ * @return true if saved; Path is left as it was otherwise.
+ **/
+bool LSnapshotWriter::commit( const std::string& Path, Uint32 SchemaVersion )
+{
+  // The table is a section of its own as far as alignment goes
+  beginSection( 0 );
+  m_Sections.pop_back();
+  m_IsOpen = false;
+
+  LSnapshotTrailer Trailer;
+
+  memcpy( Trailer.Magic, LSNAPSHOT_MAGIC, sizeof(Trailer.Magic) );
+  Trailer.Sections    = static_cast<Uint32>( m_Sections.size() );
+  Trailer.TableOffset = GetSize();
+
+  m_Writer.writeArray( m_Sections.data(), m_Sections.size() );
+  m_Writer.writeValue( Trailer );
+
+  const bool Success = m_Writer.commit( Path, SchemaVersion );
+
+  clear();
+
+  return Success;
+}
+
+
+/**
+ * @return The size of the snapshot written so far, padding included.
+ **/
+size_t LSnapshotWriter::GetSize( void ) const
+{
+  return m_Writer.GetSize();
+}
+
+
+void LSnapshotWriter::EndSection_Pvt( void )
+{
+  if ( m_IsOpen )
+  {
+    m_Sections.back().Size = GetSize() - m_Sections.back().Offset;
+    m_IsOpen               = false;
+  }
+  else
+  {;}
+}
+
+
+LSnapshotImage::LSnapshotImage( void )
+  : m_File(), m_Sections(NULL), m_SectionCount(0), m_Version(0)
+{;}
+
+
+/**
+ * @brief Maps a snapshot and checks its header, trailer and table of sections. Nothing else is read.
+ *
+ * @param SchemaVersion The version of the content of the sections this program uses: the sections
+ * are used in place, so a snapshot of any other version is rejected, an older one as CORRUPT.
+ * @return Status::LOADED if the sections can be used.
+ **/
+LSaveReader::Status LSnapshotImage::open( const std::string& Path, Uint32 SchemaVersion )
+{
+  close();
+
+  if ( !m_File.open( Path.c_str() ) )
+  {
+    return LSaveReader::Status::MISSING;
+  }
+  else
+  {;}
+
+  const Uint8*        Data_Ptr = m_File.GetData();
+  const size_t        FileSize = m_File.GetSize();
+  LSaveHeader         Header;
+  LSnapshotTrailer    Trailer;
+  LSaveReader::Status Result   = LSaveReader::Status::CORRUPT;
+
+  if ( FileSize >= sizeof(Header) + sizeof(Trailer) )
+  {
+    memcpy( &Header,  Data_Ptr, sizeof(Header) );
+    memcpy( &Trailer, Data_Ptr + FileSize - sizeof(Trailer), sizeof(Trailer) );
+  }
+  else
+  {
+    memset( &Header,  0, sizeof(Header) );
+    memset( &Trailer, 0, sizeof(Trailer) );
+  }
+
+  // Zeroed when too short, failing the magic
+  const bool   IsSnapshot = memcmp( Header.Magic, LSAVE_MAGIC, sizeof(Header.Magic) ) == 0 && Header.FormatVersion == LSAVE_FORMAT_VERSION
+                            && Header.PayloadSize == FileSize - sizeof(Header) && memcmp( Trailer.Magic, LSNAPSHOT_MAGIC, sizeof(Trailer.Magic) ) == 0;
+  const Uint64 TableEnd   = IsSnapshot ? Header.PayloadSize - sizeof(Trailer) : 0;
+
+  if ( IsSnapshot && Header.SchemaVersion > SchemaVersion )
+  {
+    Result = LSaveReader::Status::NEWER;
+  }
+  else if ( IsSnapshot && Header.SchemaVersion == SchemaVersion && Trailer.TableOffset <= TableEnd
+            && ( TableEnd - Trailer.TableOffset ) == static_cast<Uint64>( Trailer.Sections ) * sizeof(LSnapshotSection)
+            && ( sizeof(Header) + Trailer.TableOffset ) % LSNAPSHOT_ALIGN == 0 )
+  {
+    m_Sections     = reinterpret_cast<const LSnapshotSection*>( Data_Ptr + sizeof(Header) + Trailer.TableOffset );
+    m_SectionCount = Trailer.Sections;
+    Result         = LSaveReader::Status::LOADED;
+
+    for ( size_t i = 0; i != m_SectionCount; ++i )
+    {
+      const LSnapshotSection& Section = m_Sections[i];
+
+      if ( Section.Offset > Trailer.TableOffset || Section.Size > Trailer.TableOffset - Section.Offset
+           || ( sizeof(Header) + Section.Offset ) % LSNAPSHOT_ALIGN != 0 )
+      {
+        Result = LSaveReader::Status::CORRUPT;
+        break;
+      }
+      else
+      {;}
+    }
+  }
+  else
+  {;}
+
+  if ( Result == LSaveReader::Status::LOADED )
+  {
+    m_Version = Header.SchemaVersion;
+  }
+  else
+  {
+    printf( ( Result == LSaveReader::Status::NEWER ) ? "\n\"%s\" was saved by a newer version!" : "\n\"%s\" is not a valid snapshot!", Path.c_str() );
+    close();
+  }
+
+  return Result;
+}
+
+
+/**
+ * @brief Unmaps the snapshot: the sections handed out are no longer valid.
+ **/
+void LSnapshotImage::close( void )
+{
+  m_File.close();
+  m_Sections     = NULL;
+  m_SectionCount = 0;
+  m_Version      = 0;
+}
+
+
+/**
+ * @return The first section with the given tag, and its size in Size; NULL, with Size 0, if there is
+ * none or no snapshot is open.
+ **/
+const void* LSnapshotImage::GetSection( Uint32 Tag, size_t& Size ) const
+{
+  for ( size_t i = 0; i != m_SectionCount; ++i )
+  {
+    if ( m_Sections[i].Tag == Tag )
+    {
+      Size = static_cast<size_t>( m_Sections[i].Size );
+      return m_File.GetData() + sizeof(LSaveHeader) + m_Sections[i].Offset;
+    }
+    else
+    {;}
+  }
+
+  Size = 0;
+
+  return NULL;
+}
+
+
+/**
+ * @return The schema version of the open snapshot.
+ **/
+Uint32 LSnapshotImage::GetVersion( void ) const
+{
+  return m_Version;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file LSnapshot.hpp
+ *
+ * @brief Snapshots: the whole state of a program saved as tagged sections of plain data, to be
+ * memory-mapped and used in place on the next start instead of being rebuilt.
+ **/
+
+#ifndef LSNAPSHOT_HPP
+#define LSNAPSHOT_HPP
+
+#include "LMappedFile.hpp"
+#include "LSaveFile.hpp"
+
+#include <SDL.h>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Where a section lies in the payload. Sections are found by Tag, in any order.
+ **/
+struct LSnapshotSection
+{
+  Uint32 Tag;        // LSnapshotTag
+  Uint32 Reserved;
+  Uint64 Offset;     // From the start of the payload
+  Uint64 Size;       // Bytes
+};
+
+/**
+ * @brief The last bytes of the payload: the table of the sections is written after them, so that a
+ * snapshot is written front to back and nothing has to be patched.
+ **/
+struct LSnapshotTrailer
+{
+  char   Magic[4];      // LSNAPSHOT_MAGIC
+  Uint32 Sections;
+  Uint64 TableOffset;   // From the start of the payload
+};
+
+static constexpr char   LSNAPSHOT_MAGIC[4] = { 'L', 'S', 'N', 'P' };
+static constexpr size_t LSNAPSHOT_ALIGN    = 16;   // Of every section, in the file
+
+static_assert( sizeof(LSnapshotSection) == 24, "The snapshot sections must have no padding" );
+static_assert( sizeof(LSnapshotTrailer) == 16, "The snapshot trailer must have no padding" );
+
+/**
+ * @return The tag of four characters, as "LSnapshotTag( 'M', 'A', 'P', ' ' )".
+ **/
+constexpr Uint32 LSnapshotTag( char a, char b, char c, char d )
+{
+  return static_cast<Uint32>( static_cast<Uint8>( a ) ) | ( static_cast<Uint32>( static_cast<Uint8>( b ) ) << 8 )
+       | ( static_cast<Uint32>( static_cast<Uint8>( c ) ) << 16 ) | ( static_cast<Uint32>( static_cast<Uint8>( d ) ) << 24 );
+}
+
+
+/**
+ * @brief Builds a snapshot in memory, section after section, and saves it as an LSaveFile would:
+ * one write to a temporary file renamed over the old one.
+ *
+ * What goes in a section is used in place when the snapshot is mapped, so it must be plain data with
+ * no pointer: what would be a pointer is saved as an index or an offset in the same or another
+ * section. Each section starts at a multiple of LSNAPSHOT_ALIGN bytes from the start of the file, so
+ * that any array of plain data can be read where it lies.
+ **/
+class LSnapshotWriter
+{
+public:
+
+  LSnapshotWriter( void );
+
+  void   reserve     ( size_t );
+  void   clear       ( void );
+  void   beginSection( Uint32 );
+  void   write       ( const void*, size_t );
+  bool   commit      ( const std::string&, Uint32 );
+
+  template <typename T>
+  void   writeValue( const T& Value )                 { writeArray( &Value, 1 ); }
+
+  template <typename T>
+  void   writeArray( const T* Values_Ptr, size_t Count )
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "Only plain data can be mapped as it is" );
+    write( Values_Ptr, sizeof(T) * Count );
+  }
+
+  size_t GetSize( void ) const;
+
+private:
+
+  void   EndSection_Pvt( void );
+
+  LSaveWriter                   m_Writer;
+  std::vector<LSnapshotSection> m_Sections;
+  bool                          m_IsOpen;     // A section was begun and not ended yet
+};
+
+
+/**
+ * @brief A snapshot mapped in memory: "open" checks the header, the trailer and the table of the
+ * sections, which is all it reads; the sections are read where they lie, their pages loaded by the
+ * OS when first touched. Opening costs the same whatever the size of the snapshot.
+ *
+ * The CRC in the header is not checked, as that would read the whole file: a snapshot is trusted as
+ * a cache the program wrote itself. The bounds of every section are checked, so a file cut short is
+ * rejected, but one changed inside a section is not noticed.
+ *
+ * The sections point into the mapping: they, and what was built on them, must not outlive the image.
+ **/
+class LSnapshotImage
+{
+public:
+
+  LSnapshotImage( void );
+
+  LSnapshotImage( const LSnapshotImage& )            = delete;
+  LSnapshotImage& operator=( const LSnapshotImage& ) = delete;
+
+  LSaveReader::Status open ( const std::string&, Uint32 );
+  void                close( void );
+
+  const void*         GetSection( Uint32, size_t& ) const;
+  Uint32              GetVersion( void ) const;
+
+  /**
+   * @return The section as an array, and its elements in Count; NULL, with Count 0, if the snapshot
+   * has no such section or its size is not a whole number of elements. An empty section is not NULL.
+   **/
+  template <typename T>
+  const T* GetArray( Uint32 Tag, size_t& Count ) const
+  {
+    static_assert( std::is_trivially_copyable<T>::value, "Only plain data can be mapped as it is" );
+    static_assert( LSNAPSHOT_ALIGN % alignof(T) == 0, "The sections are not aligned enough for the type" );
+
+    size_t      Size     = 0;
+    const void* Data_Ptr = GetSection( Tag, Size );
+
+    if ( Data_Ptr == NULL || Size % sizeof(T) != 0 )
+    {
+      Count = 0;
+      return NULL;
+    }
+    else
+    {;}
+
+    Count = Size / sizeof(T);
+
+    return static_cast<const T*>( Data_Ptr );
+  }
+
+private:
+
+  LMappedFile             m_File;
+  const LSnapshotSection* m_Sections;
+  size_t                  m_SectionCount;
+  Uint32                  m_Version;
+};
+
+#endif // LSNAPSHOT_HPP
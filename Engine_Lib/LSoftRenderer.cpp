@@ -0,0 +1,900 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LSoftRenderer.hpp"
+#include "LJobSystem.hpp"
+#include "LPixelOps.hpp"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 PIXEL_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+static constexpr Uint32 NO_MODULATE  = 0xFFFFFFFFu;
+static constexpr Sint64 ONE          = 0x10000;     // 1.0 in 16.16 fixed point
+static constexpr Sint64 HALF         = 0x8000;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief As LPixelOps' LerpPixel: Weight / 256 of the way from a to b, two bytes per multiplication.
+ **/
+static inline Uint32 LerpPixel( Uint32 a, Uint32 b, Uint32 Weight )
+{
+  const Uint32 Keep = 256 - Weight;
+  const Uint32 Even = ( (   a        & 0x00FF00FF ) * Keep + (   b        & 0x00FF00FF ) * Weight ) >> 8;
+  const Uint32 Odd  =   ( ( a >> 8 ) & 0x00FF00FF ) * Keep + ( ( b >> 8 ) & 0x00FF00FF ) * Weight;
+
+  return ( Even & 0x00FF00FF ) | ( Odd & 0xFF00FF00 );
+}
+
+
+/**
+ * @brief c * a / 255, rounded, for a colour channel premultiplied by alpha.
+ **/
+static inline Uint32 ScaleByte( Uint32 c, Uint32 a )
+{
+  return ( c * a + 127 ) / 255;
+}
+
+
+static inline Sint64 FloorDiv( Sint64 a, Sint64 b )
+{
+  return ( a >= 0 ) ? a / b : -( ( -a + b - 1 ) / b );
+}
+
+
+/**
+ * @brief Narrows [First, Last) to the x for which Lo <= Start + x * Step < Hi: the part of a row
+ * whose texture coordinate falls inside the clip.
+ **/
+static void ClipSpan( Sint64 Start, Sint64 Step, Sint64 Lo, Sint64 Hi, int& First, int& Last )
+{
+  Sint64 From = First;
+  Sint64 To   = Last;
+
+  if ( Step > 0 )
+  {
+    From = std::max( From, -FloorDiv( Start - Lo, Step ) );   // ceil( ( Lo - Start ) / Step )
+    To   = std::min( To,   -FloorDiv( Start - Hi, Step ) );
+  }
+  else if ( Step < 0 )
+  {
+    From = std::max( From, FloorDiv( Start - Hi, -Step ) + 1 );
+    To   = std::min( To,   FloorDiv( Start - Lo, -Step ) + 1 );
+  }
+  else if ( Start < Lo || Start >= Hi )
+  {
+    To = From;
+  }
+  else
+  {;}
+
+  First = static_cast<int>( From );
+  Last  = static_cast<int>( std::max( From, To ) );
+}
+
+
+/**
+ * @brief Where a bilinear sample falls along one axis: between texels First and First + 1, at
+ * Weight / 256 of the way; clamped to the clip, where the weight drops to 0.
+ **/
+static inline void BilinearTaps( Sint64 Position, int ClipStart, int ClipSize, int& First, Uint32& Weight )
+{
+  const Sint64 Shifted = Position - HALF;
+  const Sint64 Texel   = Shifted >> 16;
+
+  if ( Texel < ClipStart )
+  {
+    First  = ClipStart;
+    Weight = 0;
+  }
+  else if ( Texel >= ClipStart + ClipSize - 1 )
+  {
+    First  = ClipStart + ClipSize - 1;
+    Weight = 0;
+  }
+  else
+  {
+    First  = static_cast<int>( Texel );
+    Weight = static_cast<Uint32>( ( Shifted >> 8 ) & 0xFF );
+  }
+}
+
+
+static inline int ClampTexel( Sint64 Position, int ClipStart, int ClipSize )
+{
+  return static_cast<int>( std::min<Sint64>( std::max<Sint64>( Position >> 16, ClipStart ), ClipStart + ClipSize - 1 ) );
+}
+
+
+static inline Uint32 SampleBilinear( const Uint32* Pixels_Ptr, int Pitch, const SDL_Rect& Clip, Sint64 U, Sint64 V )
+{
+  int    Left, Top;
+  Uint32 WeightX, WeightY;
+
+  BilinearTaps( U, Clip.x, Clip.w, Left, WeightX );
+  BilinearTaps( V, Clip.y, Clip.h, Top,  WeightY );
+
+  const Uint32* Top_Ptr    = Pixels_Ptr + static_cast<size_t>( Top ) * static_cast<size_t>( Pitch ) + Left;
+  const Uint32* Bottom_Ptr = Top_Ptr + ( ( WeightY != 0 ) ? Pitch : 0 );
+  const int     Right      = ( WeightX != 0 ) ? 1 : 0;
+
+  return LerpPixel( LerpPixel( Top_Ptr[0], Top_Ptr[Right], WeightX ), LerpPixel( Bottom_Ptr[0], Bottom_Ptr[Right], WeightX ), WeightY );
+}
+
+
+static bool Intersect( const SDL_Rect& a, const SDL_Rect& b, SDL_Rect& Result )
+{
+  const int Left   = std::max( a.x, b.x );
+  const int Top    = std::max( a.y, b.y );
+  const int Right  = std::min( a.x + a.w, b.x + b.w );
+  const int Bottom = std::min( a.y + a.h, b.y + b.h );
+
+  Result = SDL_Rect{ Left, Top, std::max( Right - Left, 0 ), std::max( Bottom - Top, 0 ) };
+
+  return Result.w > 0 && Result.h > 0;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LSoftTexture::LSoftTexture( void )
+  : m_Pixels(), m_Width(0), m_Height(0), m_ColourMod{ 0xFF, 0xFF, 0xFF }, m_AlphaMod(0xFF),
+    m_IsBlending(true), m_IsSmooth(true)
+{;}
+
+
+/**
+ * @brief Copies pixels of any 32-bit format with 8 bits per channel, and premultiplies them.
+ * Formats without alpha are opaque.
+ *
+ * @param Pitch Bytes per row of Pixels_Ptr.
+ * @return false if the size is empty or the format is not 32 bits, 8 per channel.
+ **/
+bool LSoftTexture::create( const void* Pixels_Ptr, int Width, int Height, int Pitch, Uint32 Format )
+{
+  free();
+
+  if ( Pixels_Ptr == NULL || Width <= 0 || Height <= 0 || Pitch < 4 * Width )
+  {
+    printf( "\nLSoftTexture: invalid image of %d x %d pixels", Width, Height );
+    return false;
+  }
+  else
+  {;}
+
+  m_Pixels.resize( static_cast<size_t>( Width ) * static_cast<size_t>( Height ) );
+
+  for ( int Row = 0; Row != Height; ++Row )
+  {
+    const Uint32* Source_Ptr = reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( Pixels_Ptr ) + static_cast<size_t>( Row ) * static_cast<size_t>( Pitch ) );
+
+    if ( !SwizzlePixels( Source_Ptr, &m_Pixels[static_cast<size_t>( Row ) * static_cast<size_t>( Width )], static_cast<size_t>( Width ), Format, PIXEL_FORMAT ) )
+    {
+      printf( "\nLSoftTexture: unsupported pixel format %s", SDL_GetPixelFormatName( Format ) );
+      free();
+      return false;
+    }
+    else
+    {;}
+  }
+
+  PremultiplyAlpha( m_Pixels.data(), m_Pixels.size(), PIXEL_FORMAT );
+
+  m_Width  = Width;
+  m_Height = Height;
+
+  return true;
+}
+
+
+/**
+ * @brief Converts a surface, of any format, and makes its colour key transparent. A colour key set
+ * on the surface with SDL_SetColorKey is kept as well.
+ *
+ * @param ColourKey_Ptr Colour to make transparent, or NULL.
+ **/
+bool LSoftTexture::loadFromSurface( SDL_Surface* Surface_Ptr, const SDL_Color* ColourKey_Ptr )
+{
+  free();
+
+  if ( Surface_Ptr == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Surface* Converted_Ptr = SDL_ConvertSurfaceFormat( Surface_Ptr, PIXEL_FORMAT, 0 );
+
+  if ( Converted_Ptr == NULL )
+  {
+    printf( "\nLSoftTexture: unable to convert the surface! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  if ( ColourKey_Ptr != NULL )
+  {
+    const Uint32 Key = 0xFF000000u | ( static_cast<Uint32>( ColourKey_Ptr->r ) << 16 ) | ( static_cast<Uint32>( ColourKey_Ptr->g ) << 8 ) | ColourKey_Ptr->b;
+
+    for ( int Row = 0; Row != Converted_Ptr->h; ++Row )
+    {
+      ApplyColourKey( reinterpret_cast<Uint32*>( static_cast<Uint8*>( Converted_Ptr->pixels ) + static_cast<size_t>( Row ) * static_cast<size_t>( Converted_Ptr->pitch ) ),
+                      static_cast<size_t>( Converted_Ptr->w ), Key, 0 );
+    }
+  }
+  else
+  {;}
+
+  const bool IsCreated = create( Converted_Ptr->pixels, Converted_Ptr->w, Converted_Ptr->h, Converted_Ptr->pitch, PIXEL_FORMAT );
+
+  SDL_FreeSurface( Converted_Ptr );
+
+  return IsCreated;
+}
+
+
+bool LSoftTexture::loadFromFile( const char* Path, const SDL_Color* ColourKey_Ptr )
+{
+  SDL_Surface* Loaded_Ptr = IMG_Load( Path );
+
+  if ( Loaded_Ptr == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path, IMG_GetError() );
+    free();
+    return false;
+  }
+  else
+  {;}
+
+  const bool IsLoaded = loadFromSurface( Loaded_Ptr, ColourKey_Ptr );
+
+  SDL_FreeSurface( Loaded_Ptr );
+
+  return IsLoaded;
+}
+
+
+void LSoftTexture::free( void )
+{
+  m_Pixels.clear();
+  m_Pixels.shrink_to_fit();
+  m_Width  = 0;
+  m_Height = 0;
+}
+
+
+void LSoftTexture::setColorMod( Uint8 Red, Uint8 Green, Uint8 Blue )
+{
+  m_ColourMod[0] = Red;
+  m_ColourMod[1] = Green;
+  m_ColourMod[2] = Blue;
+}
+
+
+void LSoftTexture::setAlphaMod( Uint8 Alpha )
+{
+  m_AlphaMod = Alpha;
+}
+
+
+void LSoftTexture::setBlendMode( SDL_BlendMode Mode )
+{
+  m_IsBlending = ( Mode != SDL_BLENDMODE_NONE );
+}
+
+
+void LSoftTexture::setSmooth( bool IsSmooth )
+{
+  m_IsSmooth = IsSmooth;
+}
+
+
+int LSoftTexture::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LSoftTexture::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+const Uint32* LSoftTexture::GetPixels( void ) const
+{
+  return m_Pixels.data();
+}
+
+
+/**
+ * @return The factors the premultiplied pixels are multiplied by, ARGB: the colour modulation is
+ * premultiplied by the alpha modulation too.
+ **/
+Uint32 LSoftTexture::GetModulate( void ) const
+{
+  return   ( static_cast<Uint32>( m_AlphaMod ) << 24 )
+         | ( ScaleByte( m_ColourMod[0], m_AlphaMod ) << 16 )
+         | ( ScaleByte( m_ColourMod[1], m_AlphaMod ) <<  8 )
+         |   ScaleByte( m_ColourMod[2], m_AlphaMod );
+}
+
+
+bool LSoftTexture::IsBlending( void ) const
+{
+  return m_IsBlending;
+}
+
+
+bool LSoftTexture::IsSmooth( void ) const
+{
+  return m_IsSmooth;
+}
+
+
+LSoftRenderer::LSoftRenderer( void )
+  : m_Surface_Ptr(NULL), m_Pixels_Ptr(NULL), m_Width(0), m_Height(0), m_Pitch(0), m_Jobs_Ptr(nullptr),
+    m_DrawColour(0xFF000000u), m_IsDrawBlending(false), m_TilesX(0), m_TilesY(0), m_DrawCalls(0),
+    m_Commands(), m_TileStarts(), m_TileEnds(), m_TileLists(), m_TileJobs()
+{;}
+
+
+/**
+ * @brief Draws on a surface from now on, e.g. SDL_GetWindowSurface; set it again whenever the
+ * window is resized, as its surface changes. Calls queued and not flushed are dropped.
+ *
+ * @param Jobs_Ptr Job system whose workers draw the tiles, or nullptr to draw on the calling thread.
+ * @return false unless the surface is ARGB8888 or RGB888.
+ **/
+bool LSoftRenderer::setTarget( SDL_Surface* Surface_Ptr, LJobSystem* Jobs_Ptr )
+{
+  if ( Surface_Ptr == NULL || ( Surface_Ptr->format->format != SDL_PIXELFORMAT_ARGB8888 && Surface_Ptr->format->format != SDL_PIXELFORMAT_RGB888 ) )
+  {
+    printf( "\nLSoftRenderer: the surface must be ARGB8888 or RGB888, not %s",
+            ( Surface_Ptr != NULL ) ? SDL_GetPixelFormatName( Surface_Ptr->format->format ) : "missing" );
+    setTarget( NULL, 0, 0, 0, Jobs_Ptr );
+    return false;
+  }
+  else
+  {;}
+
+  const bool IsSet = setTarget( Surface_Ptr->pixels, Surface_Ptr->w, Surface_Ptr->h, Surface_Ptr->pitch, Jobs_Ptr );
+
+  m_Surface_Ptr = Surface_Ptr;
+
+  return IsSet;
+}
+
+
+/**
+ * @brief Draws on ARGB8888 pixels in memory, Height rows of Pitch bytes.
+ **/
+bool LSoftRenderer::setTarget( void* Pixels_Ptr, int Width, int Height, int Pitch, LJobSystem* Jobs_Ptr )
+{
+  const bool IsValid = ( Width > 0 && Height > 0 && Pitch >= 4 * Width );
+
+  m_Surface_Ptr = NULL;
+  m_Pixels_Ptr  = static_cast<Uint8*>( Pixels_Ptr );
+  m_Width       = IsValid ? Width  : 0;
+  m_Height      = IsValid ? Height : 0;
+  m_Pitch       = IsValid ? Pitch  : 0;
+  m_Jobs_Ptr    = Jobs_Ptr;
+  m_TilesX      = ( m_Width  + s_TILE_SIZE - 1 ) / s_TILE_SIZE;
+  m_TilesY      = ( m_Height + s_TILE_SIZE - 1 ) / s_TILE_SIZE;
+  m_Commands.clear();
+
+  return IsValid;
+}
+
+
+void LSoftRenderer::setDrawColor( Uint8 Red, Uint8 Green, Uint8 Blue, Uint8 Alpha )
+{
+  m_DrawColour = ( static_cast<Uint32>( Alpha ) << 24 ) | ( ScaleByte( Red, Alpha ) << 16 ) | ( ScaleByte( Green, Alpha ) << 8 ) | ScaleByte( Blue, Alpha );
+}
+
+
+void LSoftRenderer::setDrawBlendMode( SDL_BlendMode Mode )
+{
+  m_IsDrawBlending = ( Mode != SDL_BLENDMODE_NONE );
+}
+
+
+/**
+ * @brief Fills the whole surface with the draw colour, never blending, as SDL_RenderClear.
+ **/
+void LSoftRenderer::clear( void )
+{
+  Command Fill{};
+
+  Fill.Type   = Kind::FILL;
+  Fill.Bounds = SDL_Rect{ 0, 0, m_Width, m_Height };
+  Fill.Colour = m_DrawColour;
+
+  Queue_Pvt( Fill );
+}
+
+
+/**
+ * @param Rect_Ptr Area to fill, or NULL for the whole surface.
+ **/
+void LSoftRenderer::fillRect( const SDL_Rect* Rect_Ptr )
+{
+  Command Fill{};
+
+  Fill.Type       = Kind::FILL;
+  Fill.Colour     = m_DrawColour;
+  Fill.IsBlending = m_IsDrawBlending && ( m_DrawColour >> 24 ) != 0xFF;
+
+  if ( Intersect( ( Rect_Ptr != NULL ) ? *Rect_Ptr : SDL_Rect{ 0, 0, m_Width, m_Height }, SDL_Rect{ 0, 0, m_Width, m_Height }, Fill.Bounds ) )
+  {
+    Queue_Pvt( Fill );
+  }
+  else
+  {;}
+}
+
+
+void LSoftRenderer::copy( const LSoftTexture& Texture, const SDL_Rect* Clip_Ptr, const SDL_Rect* Destination_Ptr )
+{
+  copyEx( Texture, Clip_Ptr, Destination_Ptr, 0.0, NULL, SDL_FLIP_NONE );
+}
+
+
+/**
+ * @brief As SDL_RenderCopyEx: the destination is rotated by Angle degrees clockwise around Centre,
+ * relative to the destination (its middle if NULL), and flipped.
+ *
+ * @param Clip_Ptr        Part of the texture, or NULL for all of it.
+ * @param Destination_Ptr Where on the surface, or NULL for all of it.
+ **/
+void LSoftRenderer::copyEx( const LSoftTexture& Texture, const SDL_Rect* Clip_Ptr, const SDL_Rect* Destination_Ptr,
+                            double Angle, const SDL_Point* Centre_Ptr, SDL_RendererFlip Flip )
+{
+  Command  Copy{};
+  SDL_Rect Destination = ( Destination_Ptr != NULL ) ? *Destination_Ptr : SDL_Rect{ 0, 0, m_Width, m_Height };
+
+  if ( !Intersect( ( Clip_Ptr != NULL ) ? *Clip_Ptr : SDL_Rect{ 0, 0, Texture.GetWidth(), Texture.GetHeight() },
+                   SDL_Rect{ 0, 0, Texture.GetWidth(), Texture.GetHeight() }, Copy.Clip )
+       || Destination.w <= 0 || Destination.h <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const double Turn    = std::fmod( Angle, 360.0 );
+  const bool   Rotated = ( Turn != 0.0 );
+  const double Radians = Turn * M_PI / 180.0;
+  const double Cos     = Rotated ? std::cos( Radians ) : 1.0;
+  const double Sin     = Rotated ? std::sin( Radians ) : 0.0;
+  const double CentreX = Destination.x + ( ( Centre_Ptr != NULL ) ? Centre_Ptr->x : Destination.w / 2 );
+  const double CentreY = Destination.y + ( ( Centre_Ptr != NULL ) ? Centre_Ptr->y : Destination.h / 2 );
+
+  // Bounds: the corners of the destination, rotated clockwise around the centre
+  double MinX = HUGE_VAL, MinY = HUGE_VAL, MaxX = -HUGE_VAL, MaxY = -HUGE_VAL;
+
+  for ( int Corner = 0; Corner != 4; ++Corner )
+  {
+    const double x = Destination.x + ( ( Corner & 1 ) ? Destination.w : 0 ) - CentreX;
+    const double y = Destination.y + ( ( Corner & 2 ) ? Destination.h : 0 ) - CentreY;
+
+    MinX = std::min( MinX, CentreX + x * Cos - y * Sin );
+    MaxX = std::max( MaxX, CentreX + x * Cos - y * Sin );
+    MinY = std::min( MinY, CentreY + x * Sin + y * Cos );
+    MaxY = std::max( MaxY, CentreY + x * Sin + y * Cos );
+  }
+
+  const SDL_Rect Covered{ static_cast<int>( std::floor( MinX ) ), static_cast<int>( std::floor( MinY ) ),
+                          static_cast<int>( std::ceil( MaxX ) - std::floor( MinX ) ), static_cast<int>( std::ceil( MaxY ) - std::floor( MinY ) ) };
+
+  if ( !Intersect( Covered, SDL_Rect{ 0, 0, m_Width, m_Height }, Copy.Bounds ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // A point of the surface, rotated back around the centre, then flipped, then scaled to the clip
+  const double ScaleX = static_cast<double>( Copy.Clip.w ) / Destination.w * ( ( Flip & SDL_FLIP_HORIZONTAL ) ? -1.0 : 1.0 );
+  const double ScaleY = static_cast<double>( Copy.Clip.h ) / Destination.h * ( ( Flip & SDL_FLIP_VERTICAL   ) ? -1.0 : 1.0 );
+  const double FirstX = 0.5 - CentreX;
+  const double FirstY = 0.5 - CentreY;
+  const double LocalX = (  Cos * FirstX + Sin * FirstY ) + ( CentreX - Destination.x );
+  const double LocalY = ( -Sin * FirstX + Cos * FirstY ) + ( CentreY - Destination.y );
+  const double U0     = Copy.Clip.x + ( ( Flip & SDL_FLIP_HORIZONTAL ) ? Copy.Clip.w : 0 ) + LocalX * ScaleX;
+  const double V0     = Copy.Clip.y + ( ( Flip & SDL_FLIP_VERTICAL   ) ? Copy.Clip.h : 0 ) + LocalY * ScaleY;
+
+  Copy.Type        = Rotated ? Kind::COPY_ROTATED : Kind::COPY;
+  Copy.Texture_Ptr = &Texture;
+  Copy.Colour      = Texture.GetModulate();
+  Copy.IsBlending  = Texture.IsBlending();
+  Copy.IsSmooth    = Texture.IsSmooth();
+  Copy.U0          = std::llround( U0 * ONE );
+  Copy.V0          = std::llround( V0 * ONE );
+  Copy.DuDx        = std::llround(  Cos * ScaleX * ONE );
+  Copy.DuDy        = std::llround(  Sin * ScaleX * ONE );
+  Copy.DvDx        = std::llround( -Sin * ScaleY * ONE );
+  Copy.DvDy        = std::llround(  Cos * ScaleY * ONE );
+
+  Queue_Pvt( Copy );
+}
+
+
+/**
+ * @brief Draws the queued calls: lists each one in the tiles it overlaps, in order, then draws the
+ * tiles, in parallel if there is a job system.
+ **/
+void LSoftRenderer::flush( void )
+{
+  m_DrawCalls = static_cast<int>( m_Commands.size() );
+
+  if ( m_Commands.empty() || m_Pixels_Ptr == NULL )
+  {
+    m_Commands.clear();
+    return;
+  }
+  else
+  {;}
+
+  const size_t Tiles = static_cast<size_t>( m_TilesX ) * static_cast<size_t>( m_TilesY );
+
+  // How many calls each tile lists, then where its list starts
+  m_TileStarts.assign( Tiles + 1, 0 );
+
+  for ( const Command& Queued : m_Commands )
+  {
+    for ( int Row = Queued.Bounds.y / s_TILE_SIZE; Row <= ( Queued.Bounds.y + Queued.Bounds.h - 1 ) / s_TILE_SIZE; ++Row )
+    {
+      for ( int Column = Queued.Bounds.x / s_TILE_SIZE; Column <= ( Queued.Bounds.x + Queued.Bounds.w - 1 ) / s_TILE_SIZE; ++Column )
+      {
+        ++m_TileStarts[static_cast<size_t>( Row * m_TilesX + Column ) + 1];
+      }
+    }
+  }
+
+  for ( size_t Tile = 0; Tile != Tiles; ++Tile )
+  {
+    m_TileStarts[Tile + 1] += m_TileStarts[Tile];
+  }
+
+  m_TileEnds.assign( m_TileStarts.begin(), m_TileStarts.end() - 1 );
+  m_TileLists.resize( m_TileStarts[Tiles] );
+
+  for ( size_t i = 0; i != m_Commands.size(); ++i )
+  {
+    const SDL_Rect& Bounds = m_Commands[i].Bounds;
+
+    for ( int Row = Bounds.y / s_TILE_SIZE; Row <= ( Bounds.y + Bounds.h - 1 ) / s_TILE_SIZE; ++Row )
+    {
+      for ( int Column = Bounds.x / s_TILE_SIZE; Column <= ( Bounds.x + Bounds.w - 1 ) / s_TILE_SIZE; ++Column )
+      {
+        m_TileLists[m_TileEnds[static_cast<size_t>( Row * m_TilesX + Column )]++] = static_cast<Uint32>( i );
+      }
+    }
+  }
+
+  const bool IsLocked = ( m_Surface_Ptr != NULL && SDL_MUSTLOCK( m_Surface_Ptr ) );
+
+  if ( IsLocked )
+  {
+    SDL_LockSurface( m_Surface_Ptr );
+    m_Pixels_Ptr = static_cast<Uint8*>( m_Surface_Ptr->pixels );
+  }
+  else
+  {;}
+
+  m_TileJobs.clear();
+
+  for ( size_t Tile = 0; Tile != Tiles; ++Tile )
+  {
+    if ( m_TileStarts[Tile + 1] != m_TileStarts[Tile] )
+    {
+      m_TileJobs.push_back( TileJob{ this, static_cast<int>( Tile ) } );
+    }
+    else
+    {;}
+  }
+
+  if ( m_Jobs_Ptr != nullptr && m_Jobs_Ptr->GetWorkerCount() > 0 && m_TileJobs.size() > 1 )
+  {
+    LJobCounter Done;
+
+    for ( TileJob& Job : m_TileJobs )
+    {
+      m_Jobs_Ptr->run( DrawTileJob_Pvt, &Job, &Done );
+    }
+
+    m_Jobs_Ptr->wait( Done );
+  }
+  else
+  {
+    for ( const TileJob& Job : m_TileJobs )
+    {
+      DrawTile_Pvt( Job.Tile );
+    }
+  }
+
+  if ( IsLocked )
+  {
+    SDL_UnlockSurface( m_Surface_Ptr );
+  }
+  else
+  {;}
+
+  m_Commands.clear();
+}
+
+
+int LSoftRenderer::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LSoftRenderer::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+/**
+ * @return The calls drawn by the last flush.
+ **/
+int LSoftRenderer::GetDrawCalls( void ) const
+{
+  return m_DrawCalls;
+}
+
+
+void LSoftRenderer::DrawTileJob_Pvt( void* Data )
+{
+  const TileJob& Job = *static_cast<const TileJob*>( Data );
+
+  Job.Renderer_Ptr->DrawTile_Pvt( Job.Tile );
+}
+
+
+void LSoftRenderer::Queue_Pvt( const Command& Queued )
+{
+  if ( m_Pixels_Ptr != NULL )
+  {
+    m_Commands.push_back( Queued );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Draws the calls listed in a tile, clipped to it, in the order they were queued.
+ **/
+void LSoftRenderer::DrawTile_Pvt( int Tile )
+{
+  const SDL_Rect TileRect{ ( Tile % m_TilesX ) * s_TILE_SIZE, ( Tile / m_TilesX ) * s_TILE_SIZE, s_TILE_SIZE, s_TILE_SIZE };
+
+  for ( Uint32 i = m_TileStarts[static_cast<size_t>( Tile )]; i != m_TileStarts[static_cast<size_t>( Tile ) + 1]; ++i )
+  {
+    const Command& Queued = m_Commands[m_TileLists[i]];
+    SDL_Rect       Area;
+
+    if ( !Intersect( Queued.Bounds, TileRect, Area ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    switch ( Queued.Type )
+    {
+      case Kind::FILL:         Fill_Pvt       ( Queued, Area ); break;
+      case Kind::COPY:         Copy_Pvt       ( Queued, Area ); break;
+      case Kind::COPY_ROTATED: CopyRotated_Pvt( Queued, Area ); break;
+    }
+  }
+}
+
+
+void LSoftRenderer::Fill_Pvt( const Command& Fill, const SDL_Rect& Area )
+{
+  Uint32 Colours[s_TILE_SIZE];
+
+  std::fill( Colours, Colours + Area.w, Fill.Colour );
+
+  for ( int y = Area.y; y != Area.y + Area.h; ++y )
+  {
+    Uint32* Out_Ptr = GetRow_Pvt( y ) + Area.x;
+
+    if ( Fill.IsBlending )
+    {
+      CompositePixels( Colours, Out_Ptr, static_cast<size_t>( Area.w ), NO_MODULATE );
+    }
+    else
+    {
+      std::copy( Colours, Colours + Area.w, Out_Ptr );
+    }
+  }
+}
+
+
+/**
+ * @brief A copy that is not rotated: each row samples a single texture row (two when smooth), and
+ * the columns step by DuDx. At the texture's size, the rows are blended as they are.
+ **/
+void LSoftRenderer::Copy_Pvt( const Command& Copy, const SDL_Rect& Area )
+{
+  const LSoftTexture& Texture = *Copy.Texture_Ptr;
+  const Uint32*       Pixels  = Texture.GetPixels();
+  const int           Pitch   = Texture.GetWidth();
+  const SDL_Rect&     Clip    = Copy.Clip;
+  const size_t        Count   = static_cast<size_t>( Area.w );
+  const Sint64        UStart  = Copy.U0 + Area.x * Copy.DuDx;
+
+  // Unscaled, on texel centres, and all inside the clip: the texture row is the run of pixels
+  const Sint64 FirstTexel = UStart >> 16;
+  const bool   IsAligned  = ( Copy.DuDx == ONE && ( UStart & 0xFFFF ) == HALF && FirstTexel >= Clip.x && FirstTexel + Area.w <= Clip.x + Clip.w );
+
+  Uint32 Span[s_TILE_SIZE];
+  Uint32 Lower[s_TILE_SIZE];
+
+  for ( int y = Area.y; y != Area.y + Area.h; ++y )
+  {
+    const Sint64 V       = Copy.V0 + y * Copy.DvDy;
+    Uint32*      Out_Ptr = GetRow_Pvt( y ) + Area.x;
+
+    if ( !Copy.IsSmooth || ( IsAligned && ( V & 0xFFFF ) == HALF ) )
+    {
+      const Uint32* Row_Ptr = Pixels + static_cast<size_t>( ClampTexel( V, Clip.y, Clip.h ) ) * static_cast<size_t>( Pitch );
+
+      if ( IsAligned )
+      {
+        Blend_Pvt( Copy, Row_Ptr + FirstTexel, Out_Ptr, Area.w );
+        continue;
+      }
+      else
+      {;}
+
+      Sint64 U = UStart;
+
+      for ( size_t i = 0; i != Count; ++i, U += Copy.DuDx )
+      {
+        Span[i] = Row_Ptr[ClampTexel( U, Clip.x, Clip.w )];
+      }
+
+      Blend_Pvt( Copy, Span, Out_Ptr, Area.w );
+      continue;
+    }
+    else
+    {;}
+
+    // Bilinear: the upper and lower texture rows, then one between them
+    int    Top;
+    Uint32 WeightY;
+
+    BilinearTaps( V, Clip.y, Clip.h, Top, WeightY );
+
+    const Uint32* Top_Ptr    = Pixels + static_cast<size_t>( Top ) * static_cast<size_t>( Pitch );
+    const Uint32* Bottom_Ptr = Top_Ptr + ( ( WeightY != 0 ) ? Pitch : 0 );
+
+    if ( IsAligned )
+    {
+      LerpPixels( Top_Ptr + FirstTexel, Bottom_Ptr + FirstTexel, Span, Count, WeightY );
+      Blend_Pvt( Copy, Span, Out_Ptr, Area.w );
+      continue;
+    }
+    else
+    {;}
+
+    Sint64 U = UStart;
+
+    for ( size_t i = 0; i != Count; ++i, U += Copy.DuDx )
+    {
+      int    Left;
+      Uint32 WeightX;
+
+      BilinearTaps( U, Clip.x, Clip.w, Left, WeightX );
+
+      const int Right = Left + ( ( WeightX != 0 ) ? 1 : 0 );
+
+      Span[i]  = LerpPixel( Top_Ptr[Left],    Top_Ptr[Right],    WeightX );
+      Lower[i] = LerpPixel( Bottom_Ptr[Left], Bottom_Ptr[Right], WeightX );
+    }
+
+    if ( WeightY != 0 )
+    {
+      LerpPixels( Span, Lower, Span, Count, WeightY );
+    }
+    else
+    {;}
+
+    Blend_Pvt( Copy, Span, Out_Ptr, Area.w );
+  }
+}
+
+
+/**
+ * @brief A rotated copy: each row is narrowed to the pixels whose centres map inside the clip, and
+ * those are sampled one by one, a step of ( DuDx, DvDx ) apart.
+ **/
+void LSoftRenderer::CopyRotated_Pvt( const Command& Copy, const SDL_Rect& Area )
+{
+  const LSoftTexture& Texture = *Copy.Texture_Ptr;
+  const Uint32*       Pixels  = Texture.GetPixels();
+  const int           Pitch   = Texture.GetWidth();
+  const SDL_Rect&     Clip    = Copy.Clip;
+
+  Uint32 Span[s_TILE_SIZE];
+
+  for ( int y = Area.y; y != Area.y + Area.h; ++y )
+  {
+    const Sint64 URow  = Copy.U0 + y * Copy.DuDy;
+    const Sint64 VRow  = Copy.V0 + y * Copy.DvDy;
+    int          First = Area.x;
+    int          Last  = Area.x + Area.w;
+
+    ClipSpan( URow, Copy.DuDx, static_cast<Sint64>( Clip.x ) << 16, static_cast<Sint64>( Clip.x + Clip.w ) << 16, First, Last );
+    ClipSpan( VRow, Copy.DvDx, static_cast<Sint64>( Clip.y ) << 16, static_cast<Sint64>( Clip.y + Clip.h ) << 16, First, Last );
+
+    if ( First >= Last )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    Sint64 U = URow + First * Copy.DuDx;
+    Sint64 V = VRow + First * Copy.DvDx;
+
+    for ( int x = First; x != Last; ++x, U += Copy.DuDx, V += Copy.DvDx )
+    {
+      Span[x - First] = Copy.IsSmooth ? SampleBilinear( Pixels, Pitch, Clip, U, V )
+                                      : Pixels[static_cast<size_t>( ClampTexel( V, Clip.y, Clip.h ) ) * static_cast<size_t>( Pitch ) + ClampTexel( U, Clip.x, Clip.w )];
+    }
+
+    Blend_Pvt( Copy, Span, GetRow_Pvt( y ) + First, Last - First );
+  }
+}
+
+
+/**
+ * @brief Puts a run of texture pixels on the surface: blended, or copied, modulated either way.
+ **/
+void LSoftRenderer::Blend_Pvt( const Command& Copy, const Uint32* Source_Ptr, Uint32* Destination_Ptr, int Count ) const
+{
+  if ( Copy.IsBlending )
+  {
+    CompositePixels( Source_Ptr, Destination_Ptr, static_cast<size_t>( Count ), Copy.Colour );
+  }
+  else
+  {
+    std::copy( Source_Ptr, Source_Ptr + Count, Destination_Ptr );
+
+    if ( Copy.Colour != NO_MODULATE )
+    {
+      TintPixels( Destination_Ptr, static_cast<size_t>( Count ), Copy.Colour );
+    }
+    else
+    {;}
+  }
+}
+
+
+Uint32* LSoftRenderer::GetRow_Pvt( int y ) const
+{
+  return reinterpret_cast<Uint32*>( m_Pixels_Ptr + static_cast<size_t>( y ) * static_cast<size_t>( m_Pitch ) );
+}
@@ -0,0 +1,165 @@
+/**
+ * @file LSoftRenderer.hpp
+ *
+ * @brief Software rendering on the CPU for machines without a GPU: textures copied, scaled, rotated
+ * and blended onto a surface by SIMD kernels, the frame split in tiles drawn by the job system.
+ **/
+
+#ifndef LSOFTRENDERER_HPP
+#define LSOFTRENDERER_HPP
+
+#include <SDL.h>
+#include <vector>
+
+class LJobSystem;
+
+
+/**
+ * @brief An image for LSoftRenderer: ARGB8888 pixels with premultiplied alpha, so that blending
+ * and bilinear filtering are exact at the edges, and the way it is drawn, as SDL_Texture keeps it.
+ *
+ * Colour and alpha modulation, blend mode and scale mode are the texture's, as with SDL_Texture:
+ * SDL_BLENDMODE_NONE copies, any other mode blends; smooth scaling is bilinear, otherwise nearest
+ * neighbour. A new texture blends and is smooth.
+ **/
+class LSoftTexture
+{
+public:
+
+  LSoftTexture( void );
+
+  bool          create         ( const void*, int, int, int, Uint32 );
+  bool          loadFromSurface( SDL_Surface*, const SDL_Color* = NULL );
+  bool          loadFromFile   ( const char*, const SDL_Color* = NULL );
+  void          free           ( void );
+
+  void          setColorMod    ( Uint8, Uint8, Uint8 );
+  void          setAlphaMod    ( Uint8 );
+  void          setBlendMode   ( SDL_BlendMode );
+  void          setSmooth      ( bool );
+
+  int           GetWidth       ( void ) const;
+  int           GetHeight      ( void ) const;
+  const Uint32* GetPixels      ( void ) const;
+  Uint32        GetModulate    ( void ) const;
+  bool          IsBlending     ( void ) const;
+  bool          IsSmooth       ( void ) const;
+
+private:
+
+  std::vector<Uint32> m_Pixels;        // Rows of m_Width pixels, no padding
+  int                 m_Width;
+  int                 m_Height;
+  Uint8               m_ColourMod[3];
+  Uint8               m_AlphaMod;
+  bool                m_IsBlending;
+  bool                m_IsSmooth;
+};
+
+
+/**
+ * @brief Draws on a 32-bit surface, ARGB8888 or RGB888 as window surfaces usually are, with the
+ * calls of SDL_Renderer: clear, fillRect, copy and copyEx. Fills blend as SDL's do, only after
+ * setDrawBlendMode( SDL_BLENDMODE_BLEND ).
+ *
+ * The calls are queued, and "flush" draws them all: the surface is split in s_TILE_SIZE squared
+ * tiles, each call is listed in the tiles it overlaps, and each tile draws its list in order,
+ * clipped to itself. The tiles run on the workers of the job system, if one is given: two tiles
+ * never write the same pixel, and a tile's pixels stay in the cache while all its calls draw there.
+ *
+ * Every row of a copy is resampled into a run of texture pixels, as long as the tile at most, and
+ * blended with CompositePixels (SSE2, AVX2 or NEON, see LPixelOps). A copy at the texture's size
+ * blends the texture's rows as they are; nearest neighbour scaling picks the pixels; bilinear
+ * blends the four around each one, the two rows with LerpPixels. Rotated copies map each pixel back
+ * into the texture, a fixed step per pixel along the row, over the part of the row the rotated
+ * rectangle covers only. Pixel centres are sampled, as SDL's renderers do, and the texture is
+ * clamped to the clip, so atlas neighbours do not bleed in; edges are not antialiased.
+ *
+ * The textures of the queued calls must live, unchanged, until "flush". Call SDL_UpdateWindowSurface
+ * after it to show a window surface.
+ **/
+class LSoftRenderer
+{
+public:
+
+  static constexpr int s_TILE_SIZE = 64;
+
+  LSoftRenderer( void );
+
+  bool setTarget       ( SDL_Surface*, LJobSystem* = nullptr );
+  bool setTarget       ( void*, int, int, int, LJobSystem* = nullptr );
+
+  void setDrawColor    ( Uint8, Uint8, Uint8, Uint8 );
+  void setDrawBlendMode( SDL_BlendMode );
+  void clear           ( void );
+  void fillRect        ( const SDL_Rect* );
+  void copy            ( const LSoftTexture&, const SDL_Rect*, const SDL_Rect* );
+  void copyEx          ( const LSoftTexture&, const SDL_Rect*, const SDL_Rect*, double, const SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
+  void flush           ( void );
+
+  int  GetWidth        ( void ) const;
+  int  GetHeight       ( void ) const;
+  int  GetDrawCalls    ( void ) const;
+
+private:
+
+  enum class Kind
+  {
+    FILL,
+    COPY,          // Not rotated: the texture row of a surface row is the same all along it
+    COPY_ROTATED
+  };
+
+  /**
+   * @brief A queued call. Copies map the surface to the texture: the centre of pixel ( x, y )
+   * samples the texture at U = U0 + x * DuDx + y * DuDy, V likewise, in 16.16 fixed point.
+   **/
+  struct Command
+  {
+    Kind                Type;
+    const LSoftTexture* Texture_Ptr;
+    SDL_Rect            Bounds;      // On the surface, clipped to it
+    SDL_Rect            Clip;        // Of the texture
+    Uint32              Colour;      // FILL: premultiplied ARGB; copies: the modulation
+    bool                IsBlending;
+    bool                IsSmooth;
+    Sint64              U0, V0;
+    Sint64              DuDx, DvDx;
+    Sint64              DuDy, DvDy;
+  };
+
+  struct TileJob
+  {
+    LSoftRenderer* Renderer_Ptr;
+    int            Tile;
+  };
+
+  static void DrawTileJob_Pvt( void* );
+
+  void    Queue_Pvt     ( const Command& );
+  void    DrawTile_Pvt  ( int );
+  void    Fill_Pvt      ( const Command&, const SDL_Rect& );
+  void    Copy_Pvt      ( const Command&, const SDL_Rect& );
+  void    CopyRotated_Pvt( const Command&, const SDL_Rect& );
+  void    Blend_Pvt     ( const Command&, const Uint32*, Uint32*, int ) const;
+  Uint32* GetRow_Pvt    ( int ) const;
+
+  SDL_Surface*         m_Surface_Ptr;    // NULL when drawing on plain pixels
+  Uint8*               m_Pixels_Ptr;
+  int                  m_Width;
+  int                  m_Height;
+  int                  m_Pitch;
+  LJobSystem*          m_Jobs_Ptr;
+  Uint32               m_DrawColour;     // Premultiplied ARGB
+  bool                 m_IsDrawBlending;
+  int                  m_TilesX;
+  int                  m_TilesY;
+  int                  m_DrawCalls;      // Drawn by the last flush
+  std::vector<Command> m_Commands;
+  std::vector<Uint32>  m_TileStarts;     // Per tile, its first entry in m_TileLists; one more at the end
+  std::vector<Uint32>  m_TileEnds;       // While listing, the next free entry of each tile
+  std::vector<Uint32>  m_TileLists;      // Indices into m_Commands, tile by tile, in order
+  std::vector<TileJob> m_TileJobs;
+};
+
+#endif // LSOFTRENDERER_HPP
@@ -0,0 +1,409 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LSpriteBatch.hpp"
+#include "LPerfHarness.hpp"
+#include "colours.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+  #include <emmintrin.h>
+  #define LSPRITEBATCH_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define LSPRITEBATCH_NEON
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const SDL_Color NoModulation{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+static constexpr double RADIANS_IN_A_DEGREE = 3.14159265358979323846 / 180.0;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Rotates the corners of a rectangle, clockwise on screen as SDL_RenderCopyEx does, in order
+ * top-left, top-right, bottom-right, bottom-left.
+ *
+ * @param Left, Top, Right, Bottom The rectangle, relative to the centre of rotation.
+ * @param CentreX, CentreY The centre of rotation, in the render target.
+ * @param Sin, Cos Of the angle.
+ * @param X, Y The four corners, in the render target.
+ **/
+static void RotateCorners( float Left, float Top, float Right, float Bottom, float CentreX, float CentreY,
+                           float Sin, float Cos, float X[4], float Y[4] )
+{
+#if defined(LSPRITEBATCH_SSE2)
+  const __m128 Dx = _mm_setr_ps( Left, Right, Right, Left );
+  const __m128 Dy = _mm_setr_ps( Top, Top, Bottom, Bottom );
+  const __m128 S  = _mm_set1_ps( Sin );
+  const __m128 C  = _mm_set1_ps( Cos );
+
+  _mm_storeu_ps( X, _mm_add_ps( _mm_set1_ps( CentreX ), _mm_sub_ps( _mm_mul_ps( C, Dx ), _mm_mul_ps( S, Dy ) ) ) );
+  _mm_storeu_ps( Y, _mm_add_ps( _mm_set1_ps( CentreY ), _mm_add_ps( _mm_mul_ps( S, Dx ), _mm_mul_ps( C, Dy ) ) ) );
+#elif defined(LSPRITEBATCH_NEON)
+  const float       DxValues[4] = { Left, Right, Right, Left };
+  const float       DyValues[4] = { Top, Top, Bottom, Bottom };
+  const float32x4_t Dx          = vld1q_f32( DxValues );
+  const float32x4_t Dy          = vld1q_f32( DyValues );
+
+  vst1q_f32( X, vmlsq_n_f32( vmlaq_n_f32( vdupq_n_f32( CentreX ), Dx, Cos ), Dy, Sin ) );
+  vst1q_f32( Y, vmlaq_n_f32( vmlaq_n_f32( vdupq_n_f32( CentreY ), Dx, Sin ), Dy, Cos ) );
+#else
+  const float Dx[4] = { Left, Right, Right, Left };
+  const float Dy[4] = { Top, Top, Bottom, Bottom };
+
+  for ( int i = 0; i != 4; ++i )
+  {
+    X[i] = CentreX + Cos * Dx[i] - Sin * Dy[i];
+    Y[i] = CentreY + Sin * Dx[i] + Cos * Dy[i];
+  }
+#endif
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LSpriteBatch::LSpriteBatch( void )
+  : m_ActiveBatches(0), m_LastDrawCalls(0)
+{;}
+
+
+/**
+ * @brief Starts a new frame. Queued geometry is discarded, but the allocated storage is kept, so
+ * that steady-state frames do not allocate.
+ **/
+void LSpriteBatch::begin( void )
+{
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    m_Batches[i].Vertices.clear();
+    m_Batches[i].Indices.clear();
+  }
+
+  m_ActiveBatches = 0;
+}
+
+
+/**
+ * @brief Queues a sprite, with the same placement rules as LTexture::render.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param x x position of the sprite.
+ * @param y y position of the sprite.
+ * @param Clip Portion of the texture to draw. Defaults to NULL (the whole texture).
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, int x, int y, const SDL_Rect* Clip )
+{
+  add( Source_Texture, x, y, Clip, NoModulation );
+}
+
+
+/**
+ * @brief Queues a tinted or faded sprite, with the same placement rules as LTexture::render.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param x x position of the sprite.
+ * @param y y position of the sprite.
+ * @param Clip Portion of the texture to draw; NULL for the whole texture.
+ * @param Modulation Multiplies the texels, as LTexture::setColor and setAlpha would, for this sprite only.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, int x, int y, const SDL_Rect* Clip, SDL_Color Modulation )
+{
+  const SDL_Rect Whole{ 0, 0, Source_Texture.getWidth(), Source_Texture.getHeight() };
+  const SDL_Rect& Source = ( Clip != NULL ) ? *Clip : Whole;
+
+  add( Source_Texture, Source, SDL_Rect{ x, y, Source.w, Source.h }, Modulation );
+}
+
+
+/**
+ * @brief Queues a sprite.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw.
+ * @param Destination Where to draw the clip in the render target.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, const SDL_Rect& Clip, const SDL_Rect& Destination )
+{
+  add( Source_Texture, Clip, Destination, NoModulation );
+}
+
+
+/**
+ * @brief Queues a tinted or faded sprite.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw.
+ * @param Destination Where to draw the clip in the render target.
+ * @param Modulation Multiplies the texels, as LTexture::setColor and setAlpha would, for this sprite only.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, const SDL_Rect& Clip, const SDL_Rect& Destination, SDL_Color Modulation )
+{
+  add( Source_Texture, Clip, Destination, 0.0, NULL, SDL_FLIP_NONE, Modulation );
+}
+
+
+/**
+ * @brief Queues a rotated or flipped sprite, with the same arguments as LTexture::render.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param x x position of the sprite.
+ * @param y y position of the sprite.
+ * @param Clip Portion of the texture to draw; NULL for the whole texture.
+ * @param Angle Degrees, clockwise.
+ * @param Centre Centre of rotation, relative to (x, y). Defaults to NULL (centre of the sprite).
+ * @param Flip Flips the image around the vertical or horizontal axis. Defaults to SDL_FLIP_NONE.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, int x, int y, const SDL_Rect* Clip, double Angle,
+                        const SDL_Point* Centre, SDL_RendererFlip Flip )
+{
+  const SDL_Rect Whole{ 0, 0, Source_Texture.getWidth(), Source_Texture.getHeight() };
+  const SDL_Rect& Source = ( Clip != NULL ) ? *Clip : Whole;
+
+  add( Source_Texture, Source, SDL_Rect{ x, y, Source.w, Source.h }, Angle, Centre, Flip, NoModulation );
+}
+
+
+/**
+ * @brief Queues a sprite: all the others end here.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw.
+ * @param Destination Where to draw the clip in the render target, before rotating it.
+ * @param Angle Degrees, clockwise.
+ * @param Centre Centre of rotation, relative to the destination; NULL for its centre.
+ * @param Flip Flips the image around the vertical or horizontal axis.
+ * @param Modulation Multiplies the texels, as LTexture::setColor and setAlpha would, for this sprite only.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, const SDL_Rect& Clip, const SDL_Rect& Destination, double Angle,
+                        const SDL_Point* Centre, SDL_RendererFlip Flip, SDL_Color Modulation )
+{
+  if ( !Source_Texture.isValid() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Batch& CurrentBatch = FindBatch_Pvt( Source_Texture );
+
+  const float InvW = 1.0f / static_cast<float>( CurrentBatch.Width_px  );
+  const float InvH = 1.0f / static_cast<float>( CurrentBatch.Height_px );
+
+  float u0 = static_cast<float>( Clip.x          ) * InvW;
+  float v0 = static_cast<float>( Clip.y          ) * InvH;
+  float u1 = static_cast<float>( Clip.x + Clip.w ) * InvW;
+  float v1 = static_cast<float>( Clip.y + Clip.h ) * InvH;
+
+  // Flipping mirrors the clip inside the destination: the texture coordinates swap, not the corners
+  if ( ( Flip & SDL_FLIP_HORIZONTAL ) != 0 )
+  {
+    std::swap( u0, u1 );
+  }
+  else
+  {;}
+
+  if ( ( Flip & SDL_FLIP_VERTICAL ) != 0 )
+  {
+    std::swap( v0, v1 );
+  }
+  else
+  {;}
+
+  const float x0 = static_cast<float>( Destination.x                 );
+  const float y0 = static_cast<float>( Destination.y                 );
+  const float x1 = static_cast<float>( Destination.x + Destination.w );
+  const float y1 = static_cast<float>( Destination.y + Destination.h );
+
+  // Top-left, top-right, bottom-right, bottom-left
+  float X[4] = { x0, x1, x1, x0 };
+  float Y[4] = { y0, y0, y1, y1 };
+
+  if ( Angle != 0.0 )
+  {
+    const float CentreX = ( Centre != NULL ) ? x0 + static_cast<float>( Centre->x ) : x0 + static_cast<float>( Destination.w ) * 0.5f;
+    const float CentreY = ( Centre != NULL ) ? y0 + static_cast<float>( Centre->y ) : y0 + static_cast<float>( Destination.h ) * 0.5f;
+    const double Radians = Angle * RADIANS_IN_A_DEGREE;
+
+    RotateCorners( x0 - CentreX, y0 - CentreY, x1 - CentreX, y1 - CentreY, CentreX, CentreY,
+                   static_cast<float>( std::sin( Radians ) ), static_cast<float>( std::cos( Radians ) ), X, Y );
+  }
+  else
+  {;}
+
+  AddQuad_Pvt( CurrentBatch, X, Y, u0, v0, u1, v1, Modulation );
+}
+
+
+/**
+ * @brief Queues a sprite placed with sub-pixel precision.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw, in texels; it may start and end between them.
+ * @param Destination Where to draw the clip in the render target.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, const SDL_FRect& Clip, const SDL_FRect& Destination )
+{
+  add( Source_Texture, Clip, Destination, NoModulation );
+}
+
+
+/**
+ * @brief Queues a tinted or faded sprite placed with sub-pixel precision. Unrotated: the corners
+ * are written as they are.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw, in texels; it may start and end between them.
+ * @param Destination Where to draw the clip in the render target.
+ * @param Modulation Multiplies the texels, as LTexture::setColor and setAlpha would, for this sprite only.
+ **/
+void LSpriteBatch::add( const LTexture& Source_Texture, const SDL_FRect& Clip, const SDL_FRect& Destination, SDL_Color Modulation )
+{
+  if ( !Source_Texture.isValid() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Batch& CurrentBatch = FindBatch_Pvt( Source_Texture );
+
+  const float InvW = 1.0f / static_cast<float>( CurrentBatch.Width_px  );
+  const float InvH = 1.0f / static_cast<float>( CurrentBatch.Height_px );
+
+  const float x0 = Destination.x;
+  const float y0 = Destination.y;
+  const float x1 = Destination.x + Destination.w;
+  const float y1 = Destination.y + Destination.h;
+
+  // Top-left, top-right, bottom-right, bottom-left
+  const float X[4] = { x0, x1, x1, x0 };
+  const float Y[4] = { y0, y0, y1, y1 };
+
+  AddQuad_Pvt( CurrentBatch, X, Y, Clip.x * InvW, Clip.y * InvH, ( Clip.x + Clip.w ) * InvW, ( Clip.y + Clip.h ) * InvH, Modulation );
+}
+
+
+/**
+ * @brief Submits all the queued sprites, one draw call per texture.
+ *
+ * @param Renderer_Ptr The renderer to draw with; if omitted, the one of each texture.
+ **/
+void LSpriteBatch::flush( SDL_Renderer* Renderer_Ptr )
+{
+  m_LastDrawCalls = 0;
+
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    Batch& CurrentBatch = m_Batches[i];
+
+    if ( CurrentBatch.Indices.empty() )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    SDL_Renderer* Target = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : CurrentBatch.Renderer_Ptr;
+
+    if ( SDL_RenderGeometry( Target, CurrentBatch.Texture_Ptr,
+                             CurrentBatch.Vertices.data(), static_cast<int>( CurrentBatch.Vertices.size() ),
+                             CurrentBatch.Indices.data() , static_cast<int>( CurrentBatch.Indices.size()  ) ) != 0 )
+    {
+      printf( "\nSprite batch could not be drawn! SDL Error: %s", SDL_GetError() );
+    }
+    else
+    {
+      ++m_LastDrawCalls;
+    }
+  }
+
+  LPerfHarness::countDrawCalls( m_LastDrawCalls );
+
+  begin();
+}
+
+
+/**
+ * @brief Number of draw calls issued by the last flush.
+ **/
+int LSpriteBatch::GetDrawCalls( void ) const
+{
+  return m_LastDrawCalls;
+}
+
+
+/**
+ * @brief Appends the four corners of a sprite, top-left first and clockwise, and its two triangles.
+ **/
+void LSpriteBatch::AddQuad_Pvt( Batch& CurrentBatch, const float* X, const float* Y, float u0, float v0, float u1, float v1,
+                                SDL_Color Modulation )
+{
+  const int First = static_cast<int>( CurrentBatch.Vertices.size() );
+
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{X[0], Y[0]}, Modulation, SDL_FPoint{u0, v0} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{X[1], Y[1]}, Modulation, SDL_FPoint{u1, v0} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{X[2], Y[2]}, Modulation, SDL_FPoint{u1, v1} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{X[3], Y[3]}, Modulation, SDL_FPoint{u0, v1} } );
+
+  // Two triangles: top-left, top-right, bottom-right and bottom-right, bottom-left, top-left
+  CurrentBatch.Indices.push_back( First     );
+  CurrentBatch.Indices.push_back( First + 1 );
+  CurrentBatch.Indices.push_back( First + 2 );
+  CurrentBatch.Indices.push_back( First + 2 );
+  CurrentBatch.Indices.push_back( First + 3 );
+  CurrentBatch.Indices.push_back( First     );
+}
+
+
+/**
+ * @brief Returns the batch associated to a texture, activating a new one if needed. The textures
+ * used in a frame are few, so a linear search is enough.
+ **/
+LSpriteBatch::Batch& LSpriteBatch::FindBatch_Pvt( const LTexture& Source_Texture )
+{
+  SDL_Texture* Texture_Ptr = Source_Texture.getSDLTexture();
+
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    if ( m_Batches[i].Texture_Ptr == Texture_Ptr )
+    {
+      return m_Batches[i];
+    }
+    else
+    {;}
+  }
+
+  if ( m_ActiveBatches == m_Batches.size() )
+  {
+    m_Batches.emplace_back();
+    m_Batches.back().Vertices.reserve( s_RESERVED_SPRITES * s_VERTICES_PER_SPRITE );
+    m_Batches.back().Indices.reserve ( s_RESERVED_SPRITES * s_INDICES_PER_SPRITE  );
+  }
+  else
+  {;}
+
+  Batch& NewBatch = m_Batches[m_ActiveBatches];
+  ++m_ActiveBatches;
+
+  NewBatch.Texture_Ptr  = Texture_Ptr;
+  NewBatch.Renderer_Ptr = Source_Texture.getRenderer();
+  NewBatch.Width_px     = Source_Texture.getWidth();
+  NewBatch.Height_px    = Source_Texture.getHeight();
+
+  return NewBatch;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file LSpriteBatch.hpp
+ *
+ * @brief Collects sprite draws and submits them with as few draw calls as possible.
+ **/
+
+#ifndef LSPRITEBATCH_HPP
+#define LSPRITEBATCH_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "LTexture.hpp"
+
+/**
+ * @brief Sprite batch. Every clip / destination pair queued between "begin" and "flush" is
+ * converted into two triangles of a contiguous vertex array; "flush" then issues a single
+ * SDL_RenderGeometry call for each texture. Sprites sampling different textures are drawn in
+ * order of first appearance of their texture.
+ *
+ * Rotation and flipping take the same arguments as LTexture::render, and SDL_RenderCopyEx's rules:
+ * degrees clockwise around a centre relative to the destination, its middle by default. The corners
+ * are rotated on the CPU, four at a time with SSE2 or NEON where the compiler targets them, so
+ * rotated sprites share the draw call of their texture like the others; without rotation the
+ * corners are written as they are, and a flip only swaps texture coordinates.
+ *
+ * Clip and destination can also be given in floating point, for sub-pixel placement and scrolling:
+ * the texture coordinates then fall between texels, as with SDL_RenderCopyF.
+ *
+ * Colour and alpha modulation are per sprite, written in its vertices, so that tinted and faded
+ * sprites of the same texture still share its draw call, where LTexture::setColor and setAlpha
+ * change the texture for every draw and would need a flush in between. Leave the modulation of the
+ * texture itself white and opaque. The blend mode is still the texture's: for alpha to fade the
+ * sprites, the texture must blend (SDL_BLENDMODE_BLEND).
+ **/
+class LSpriteBatch
+{
+public:
+
+  LSpriteBatch( void );
+
+  void begin        ( void );
+  void add          ( const LTexture&, int, int, const SDL_Rect* = NULL );
+  void add          ( const LTexture&, int, int, const SDL_Rect*, SDL_Color );
+  void add          ( const LTexture&, const SDL_Rect&, const SDL_Rect& );
+  void add          ( const LTexture&, const SDL_Rect&, const SDL_Rect&, SDL_Color );
+  void add          ( const LTexture&, int, int, const SDL_Rect*, double, const SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
+  void add          ( const LTexture&, const SDL_Rect&, const SDL_Rect&, double, const SDL_Point*, SDL_RendererFlip, SDL_Color );
+  void add          ( const LTexture&, const SDL_FRect&, const SDL_FRect& );
+  void add          ( const LTexture&, const SDL_FRect&, const SDL_FRect&, SDL_Color );
+  void flush        ( SDL_Renderer* = nullptr );
+  int  GetDrawCalls ( void ) const;
+
+private:
+
+  /**
+   * @brief All the geometry queued for a single texture.
+   **/
+  struct Batch
+  {
+    SDL_Texture*            Texture_Ptr = nullptr;
+    SDL_Renderer*           Renderer_Ptr = nullptr;
+    int                     Width_px    = 0;
+    int                     Height_px   = 0;
+    std::vector<SDL_Vertex> Vertices;
+    std::vector<int>        Indices;
+  };
+
+  Batch& FindBatch_Pvt( const LTexture& );
+  void   AddQuad_Pvt  ( Batch&, const float*, const float*, float, float, float, float, SDL_Color );
+
+  static constexpr size_t s_VERTICES_PER_SPRITE = 4;
+  static constexpr size_t s_INDICES_PER_SPRITE  = 6;
+  static constexpr size_t s_RESERVED_SPRITES    = 64;
+
+  std::vector<Batch> m_Batches;         // One entry per texture; storage is kept between frames
+  size_t             m_ActiveBatches;   // Entries of m_Batches used in the current frame
+  int                m_LastDrawCalls;   // Draw calls issued by the last flush
+};
+
+#endif // LSPRITEBATCH_HPP
@@ -0,0 +1,256 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LStreamingTexture.hpp"
+#include "LPerfHarness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LStreamingTexture::LStreamingTexture( void )
+  : m_Renderer_Ptr(nullptr), m_Texture_Ptr(nullptr), m_Width(0), m_Height(0), m_Pitch(0),
+    m_Free(s_MAX_STAGING), m_Ready(s_MAX_STAGING), m_Writing(s_NONE)
+{;}
+
+
+LStreamingTexture::~LStreamingTexture( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Creates the texture and its staging buffers. Neither thread may be using the texture.
+ *
+ * @param Renderer_Ptr The renderer the texture is for, used by "upload" and "render".
+ * @param Format       Pixel format of the texture and of the staging buffers.
+ * @param Staging      Number of staging buffers, 2 or 3: with 3 the producer can be one more frame
+ *                     ahead of the renderer.
+ * @return false if the texture could not be created.
+ **/
+bool LStreamingTexture::create( SDL_Renderer* Renderer_Ptr, int Width, int Height, Uint32 Format, size_t Staging )
+{
+  free();
+
+  m_Texture_Ptr = SDL_CreateTexture( Renderer_Ptr, Format, SDL_TEXTUREACCESS_STREAMING, Width, Height );
+
+  if ( m_Texture_Ptr == nullptr )
+  {
+    printf( "\nUnable to create streaming texture! SDL Error: \"%s\"", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Renderer_Ptr = Renderer_Ptr;
+  m_Width        = Width;
+  m_Height       = Height;
+  m_Pitch        = Width * SDL_BYTESPERPIXEL( Format );
+
+  Staging = std::min( std::max( Staging, static_cast<size_t>(2) ), s_MAX_STAGING );
+
+  for ( Uint8 i = 0; i != Staging; ++i )
+  {
+    m_Staging[i].assign( static_cast<size_t>( m_Pitch ) * static_cast<size_t>( m_Height ), 0 );
+    m_Free.push( i );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Destroys the texture and the staging buffers. Neither thread may be using the texture.
+ **/
+void LStreamingTexture::free( void )
+{
+  if ( m_Texture_Ptr != nullptr )
+  {
+    SDL_DestroyTexture( m_Texture_Ptr );
+    m_Texture_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  Uint8 Index = 0;
+
+  while ( m_Free.pop( Index ) || m_Ready.pop( Index ) )
+  {;}
+
+  for ( std::vector<Uint8>& Buffer : m_Staging )
+  {
+    std::vector<Uint8>().swap( Buffer );
+  }
+
+  m_Renderer_Ptr = nullptr;
+  m_Width        = 0;
+  m_Height       = 0;
+  m_Pitch        = 0;
+  m_Writing      = s_NONE;
+}
+
+
+/**
+ * @brief Producer thread: takes a free staging buffer to write the next frame into. Only the dirty
+ * rectangle given to "endWrite" is uploaded, so a partial update writes just that part; the rest of
+ * the buffer holds older frames.
+ *
+ * @param Pitch Set to the bytes per row of the buffer.
+ * @return The pixels, or nullptr while every buffer waits for upload: try again later.
+ **/
+void* LStreamingTexture::beginWrite( int& Pitch )
+{
+  Pitch = m_Pitch;
+
+  if ( m_Writing == s_NONE && !m_Free.pop( m_Writing ) )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  return m_Staging[m_Writing].data();
+}
+
+
+/**
+ * @brief Producer thread: queues the buffer taken with "beginWrite" for upload.
+ *
+ * @param Dirty_Ptr The part of the frame that changed, or NULL for all of it.
+ **/
+void LStreamingTexture::endWrite( const SDL_Rect* Dirty_Ptr )
+{
+  if ( m_Writing == s_NONE )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Whole{ 0, 0, m_Width, m_Height };
+
+  if ( Dirty_Ptr == NULL || !SDL_IntersectRect( Dirty_Ptr, &Whole, &m_Dirty[m_Writing] ) )
+  {
+    m_Dirty[m_Writing] = ( Dirty_Ptr == NULL ) ? Whole : SDL_Rect{ 0, 0, 0, 0 };
+  }
+  else
+  {;}
+
+  m_Ready.push( m_Writing );
+  m_Writing = s_NONE;
+}
+
+
+/**
+ * @brief Render thread: copies the frames written since the last call into the texture, oldest
+ * first, each only over its dirty rectangle, and gives their buffers back to the producer.
+ *
+ * @return The number of frames uploaded.
+ **/
+int LStreamingTexture::upload( void )
+{
+  Uint8 Index    = 0;
+  int   Uploaded = 0;
+
+  while ( m_Ready.pop( Index ) )
+  {
+    const SDL_Rect& Dirty = m_Dirty[Index];
+
+    if ( Dirty.w > 0 && Dirty.h > 0 )
+    {
+      const Uint8* Pixels_Ptr = m_Staging[Index].data() + Dirty.y * m_Pitch + Dirty.x * ( m_Pitch / m_Width );
+
+      if ( SDL_UpdateTexture( m_Texture_Ptr, &Dirty, Pixels_Ptr, m_Pitch ) != 0 )
+      {
+        printf( "\nUnable to update streaming texture! SDL Error: \"%s\"", SDL_GetError() );
+      }
+      else
+      {;}
+    }
+    else
+    {;}
+
+    m_Free.push( Index );
+    ++Uploaded;
+  }
+
+  return Uploaded;
+}
+
+
+/**
+ * @brief Render thread: gives direct access to the pixels of the texture, to write a frame into
+ * them with no staging buffer. They are write-only: whatever they held before is lost, so the whole
+ * rectangle must be written. Frames queued by the producer and not uploaded yet will still overwrite
+ * it at the next "upload".
+ *
+ * @param Pitch    Set to the bytes per row of the locked pixels, which may exceed the width.
+ * @param Rect_Ptr The part to lock, or NULL for the whole texture.
+ * @return The pixels, or nullptr if the texture could not be locked.
+ **/
+void* LStreamingTexture::lockTexture( int& Pitch, const SDL_Rect* Rect_Ptr )
+{
+  void* Pixels_Ptr = nullptr;
+
+  if ( SDL_LockTexture( m_Texture_Ptr, Rect_Ptr, &Pixels_Ptr, &Pitch ) != 0 )
+  {
+    printf( "\nUnable to lock streaming texture! SDL Error: \"%s\"", SDL_GetError() );
+    Pitch = 0;
+    return nullptr;
+  }
+  else
+  {;}
+
+  return Pixels_Ptr;
+}
+
+
+/**
+ * @brief Render thread: uploads what was written since "lockTexture".
+ **/
+void LStreamingTexture::unlockTexture( void )
+{
+  SDL_UnlockTexture( m_Texture_Ptr );
+}
+
+
+/**
+ * @brief Render thread: draws the texture at the given position, at its size.
+ **/
+void LStreamingTexture::render( int x, int y ) const
+{
+  const SDL_Rect Destination{ x, y, m_Width, m_Height };
+
+  SDL_RenderCopy( m_Renderer_Ptr, m_Texture_Ptr, NULL, &Destination );
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+SDL_Texture* LStreamingTexture::GetTexture( void ) const
+{
+  return m_Texture_Ptr;
+}
+
+
+int LStreamingTexture::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LStreamingTexture::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+int LStreamingTexture::GetPitch( void ) const
+{
+  return m_Pitch;
+}
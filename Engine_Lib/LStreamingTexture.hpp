@@ -0,0 +1,75 @@
+/**
+ * @file LStreamingTexture.hpp
+ *
+ * @brief Texture fed by a producer thread, for video-rate content.
+ **/
+
+#ifndef LSTREAMINGTEXTURE_HPP
+#define LSTREAMINGTEXTURE_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "LRingBuffer.hpp"
+
+/**
+ * @brief A streaming texture with two or three staging buffers in system memory. A producer thread
+ * fills a free buffer between "beginWrite" and "endWrite", with no lock and without touching the
+ * renderer; the render thread then "upload"s the buffers written since last time, in order, with
+ * SDL_UpdateTexture. While the renderer draws a frame, the producer is already writing the next.
+ *
+ * "endWrite" can give the rectangle that changed: only that part is uploaded. Frames are never
+ * skipped, so that partial updates add up; when every buffer is waiting for upload "beginWrite"
+ * fails, and the producer waits for the renderer.
+ *
+ * A source that can decode or generate into any pitch-aligned memory writes straight into the
+ * staging buffer, or, on the render thread, into the texture itself between "lockTexture" and
+ * "unlockTexture": no intermediate frame, and no copy besides the upload.
+ **/
+class LStreamingTexture
+{
+public:
+
+  static constexpr size_t s_MAX_STAGING = 3;
+
+  LStreamingTexture( void );
+  ~LStreamingTexture( void );
+
+  LStreamingTexture( const LStreamingTexture& )            = delete;
+  LStreamingTexture& operator=( const LStreamingTexture& ) = delete;
+
+  bool         create    ( SDL_Renderer*, int, int, Uint32 = SDL_PIXELFORMAT_RGBA8888, size_t = 2 );
+  void         free      ( void );
+
+  // Producer thread
+  void*        beginWrite( int& );
+  void         endWrite  ( const SDL_Rect* = NULL );
+
+  // Render thread
+  int          upload       ( void );
+  void*        lockTexture  ( int&, const SDL_Rect* = NULL );
+  void         unlockTexture( void );
+  void         render       ( int, int ) const;
+
+  SDL_Texture* GetTexture( void ) const;
+  int          GetWidth  ( void ) const;
+  int          GetHeight ( void ) const;
+  int          GetPitch  ( void ) const;
+
+private:
+
+  static constexpr Uint8 s_NONE = 0xFF;
+
+  SDL_Renderer*      m_Renderer_Ptr;
+  SDL_Texture*       m_Texture_Ptr;
+  int                m_Width;
+  int                m_Height;
+  int                m_Pitch;                  // Bytes per row of a staging buffer
+
+  std::vector<Uint8> m_Staging[s_MAX_STAGING];
+  SDL_Rect           m_Dirty[s_MAX_STAGING];   // Written by the producer before the buffer is queued
+  LSpscRing<Uint8>   m_Free;                   // Buffers the producer can write, from the renderer
+  LSpscRing<Uint8>   m_Ready;                  // Buffers to upload, from the producer
+  Uint8              m_Writing;                // Producer's buffer, s_NONE between writes
+};
+
+#endif // LSTREAMINGTEXTURE_HPP
@@ -0,0 +1,282 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTextCache.hpp"
+#include "LPerfHarness.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// FNV-1a, 64 bits
+static constexpr Uint64 HASH_OFFSET = 14695981039346656037ULL;
+static constexpr Uint64 HASH_PRIME  = 1099511628211ULL;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static Uint64 HashBytes( Uint64 Hash, const void* Data_Ptr, size_t Size )
+{
+  const Uint8* Byte_Ptr = static_cast<const Uint8*>( Data_Ptr );
+
+  for ( size_t i = 0; i != Size; ++i )
+  {
+    Hash = ( Hash ^ Byte_Ptr[i] ) * HASH_PRIME;
+  }
+
+  return Hash;
+}
+
+
+static Uint32 PackColour( SDL_Color Colour )
+{
+  return ( static_cast<Uint32>( Colour.r ) << 24 ) | ( static_cast<Uint32>( Colour.g ) << 16 )
+       | ( static_cast<Uint32>( Colour.b ) <<  8 ) |   static_cast<Uint32>( Colour.a );
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+void LCachedText::render( SDL_Renderer* Renderer_Ptr, int x, int y ) const
+{
+  const SDL_Rect Quad = { x, y, Width, Height };
+
+  SDL_RenderCopy( Renderer_Ptr, Texture_Ptr, NULL, &Quad );
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+/**
+ * @param Renderer_Ptr The renderer the textures are created for; it can also be set later.
+ * @param Capacity Strings kept besides the static ones.
+ **/
+LTextCache::LTextCache( SDL_Renderer* Renderer_Ptr, size_t Capacity )
+  : m_Renderer_Ptr(Renderer_Ptr), m_Capacity(Capacity > 0 ? Capacity : 1), m_Hits(0), m_Misses(0), m_Evictions(0)
+{
+  m_Index.reserve( m_Capacity * 2 );
+}
+
+
+LTextCache::~LTextCache( void )
+{
+  clear();
+}
+
+
+/**
+ * @brief Moves the cache to another renderer: the textures of the previous one are destroyed.
+ **/
+void LTextCache::setRenderer( SDL_Renderer* Renderer_Ptr )
+{
+  if ( Renderer_Ptr != m_Renderer_Ptr )
+  {
+    clear();
+    m_Renderer_Ptr = Renderer_Ptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief The texture of a string, rendered only if it is not in the cache yet.
+ *
+ * @param Font_Ptr The font to render with.
+ * @param Text_Ptr The string; an empty one is rendered as a space, which SDL_ttf can draw.
+ * @param Colour The colour of the string.
+ * @param IsStatic true to keep the string until "clear", e.g. for prompts. A string once static
+ * stays so.
+ * @return The texture, or nullptr if the string could not be rendered.
+ **/
+const LCachedText* LTextCache::get( TTF_Font* Font_Ptr, const char* Text_Ptr, SDL_Color Colour, bool IsStatic )
+{
+  if ( Text_Ptr == nullptr || Text_Ptr[0] == '\0' )
+  {
+    Text_Ptr = " ";
+  }
+  else
+  {;}
+
+  const int    FontHeight = TTF_FontHeight( Font_Ptr );
+  const Uint32 Packed     = PackColour( Colour );
+  const size_t Length     = strlen( Text_Ptr );
+
+  Uint64 Hash = HASH_OFFSET;
+  Hash = HashBytes( Hash, &Font_Ptr, sizeof(Font_Ptr) );
+  Hash = HashBytes( Hash, &FontHeight, sizeof(FontHeight) );
+  Hash = HashBytes( Hash, &Packed, sizeof(Packed) );
+  Hash = HashBytes( Hash, Text_Ptr, Length );
+
+  auto Found = m_Index.find( Hash );
+
+  if ( Found != m_Index.end() )
+  {
+    Entry& Cached = *Found->second;
+
+    if ( Cached.Font_Ptr == Font_Ptr && Cached.FontHeight == FontHeight && Cached.Colour == Packed
+         && Cached.Text.size() == Length && memcmp( Cached.Text.data(), Text_Ptr, Length ) == 0 )
+    {
+      ++m_Hits;
+
+      // Most recent first; splicing keeps the iterator, and the string, where they are
+      if ( !Cached.IsStatic && IsStatic )
+      {
+        Cached.IsStatic = true;
+        m_Static.splice( m_Static.begin(), m_Recent, Found->second );
+      }
+      else if ( !Cached.IsStatic )
+      {
+        m_Recent.splice( m_Recent.begin(), m_Recent, Found->second );
+      }
+      else
+      {;}
+
+      return &Cached.Rendered;
+    }
+    else
+    {
+      // Another string with the same hash: it makes room for this one
+      Evict_Pvt( Found->second );
+    }
+  }
+  else
+  {;}
+
+  ++m_Misses;
+
+  SDL_Surface* Surface_Ptr = TTF_RenderText_Blended( Font_Ptr, Text_Ptr, Colour );
+
+  if ( Surface_Ptr == NULL )
+  {
+    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
+    return nullptr;
+  }
+  else
+  {;}
+
+  SDL_Texture* Texture_Ptr = SDL_CreateTextureFromSurface( m_Renderer_Ptr, Surface_Ptr );
+  const int    Width       = Surface_Ptr->w;
+  const int    Height      = Surface_Ptr->h;
+
+  SDL_FreeSurface( Surface_Ptr );
+
+  if ( Texture_Ptr == NULL )
+  {
+    printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
+    return nullptr;
+  }
+  else
+  {;}
+
+  if ( !IsStatic && m_Recent.size() >= m_Capacity )
+  {
+    Evict_Pvt( std::prev( m_Recent.end() ) );
+  }
+  else
+  {;}
+
+  EntryList& List = IsStatic ? m_Static : m_Recent;
+
+  List.push_front( Entry{ Hash, Font_Ptr, FontHeight, Packed, IsStatic, std::string( Text_Ptr, Length ),
+                          LCachedText{ Texture_Ptr, Width, Height } } );
+  m_Index[Hash] = List.begin();
+
+  return &List.front().Rendered;
+}
+
+
+/**
+ * @brief Draws a string with its top-left corner at (x, y), rendering it first if needed.
+ **/
+void LTextCache::render( TTF_Font* Font_Ptr, const char* Text_Ptr, SDL_Color Colour, int x, int y, bool IsStatic )
+{
+  const LCachedText* Text = get( Font_Ptr, Text_Ptr, Colour, IsStatic );
+
+  if ( Text != nullptr )
+  {
+    Text->render( m_Renderer_Ptr, x, y );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Destroys every texture, the static ones included.
+ **/
+void LTextCache::clear( void )
+{
+  for ( EntryList* List : { &m_Recent, &m_Static } )
+  {
+    for ( Entry& Each : *List )
+    {
+      SDL_DestroyTexture( Each.Rendered.Texture_Ptr );
+    }
+
+    List->clear();
+  }
+
+  m_Index.clear();
+}
+
+
+SDL_Renderer* LTextCache::GetRenderer( void ) const
+{
+  return m_Renderer_Ptr;
+}
+
+
+/**
+ * @return Strings in the cache, the static ones included.
+ **/
+size_t LTextCache::GetCount( void ) const
+{
+  return m_Recent.size() + m_Static.size();
+}
+
+
+size_t LTextCache::GetCapacity( void ) const
+{
+  return m_Capacity;
+}
+
+
+Uint64 LTextCache::GetHits( void ) const
+{
+  return m_Hits;
+}
+
+
+/**
+ * @return Strings rendered, i.e. not found in the cache.
+ **/
+Uint64 LTextCache::GetMisses( void ) const
+{
+  return m_Misses;
+}
+
+
+Uint64 LTextCache::GetEvictions( void ) const
+{
+  return m_Evictions;
+}
+
+
+void LTextCache::Evict_Pvt( EntryList::iterator Victim )
+{
+  SDL_DestroyTexture( Victim->Rendered.Texture_Ptr );
+  m_Index.erase( Victim->Hash );
+  ( Victim->IsStatic ? m_Static : m_Recent ).erase( Victim );
+  ++m_Evictions;
+}
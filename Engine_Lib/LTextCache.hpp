@@ -0,0 +1,93 @@
+/**
+ * @file LTextCache.hpp
+ *
+ * @brief Textures of rendered strings, kept for as long as the same string is drawn again.
+ **/
+
+#ifndef LTEXTCACHE_HPP
+#define LTEXTCACHE_HPP
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief The texture of a string in the cache.
+ **/
+struct LCachedText
+{
+  SDL_Texture* Texture_Ptr;
+  int          Width;
+  int          Height;
+
+  void render( SDL_Renderer*, int, int ) const;
+};
+
+
+/**
+ * @brief Strings rendered with SDL_ttf, keyed by font, font height, colour and text: drawing the
+ * same string again, every frame or on every change of a value that keeps coming back, costs a hash
+ * lookup instead of rasterising it and uploading a new texture.
+ *
+ * At most Capacity strings are kept, the least recently used one making room for a new one, besides
+ * those marked static, e.g. prompts and labels, which are never evicted.
+ *
+ * A string handed out by "get" stays valid until a later "get" evicts it: fetch the strings in the
+ * frame in which they are drawn, rather than keeping the pointers. Call "clear" before closing a
+ * font or destroying the renderer.
+ **/
+class LTextCache
+{
+public:
+
+  static constexpr size_t s_DEFAULT_CAPACITY = 64;
+
+  explicit LTextCache( SDL_Renderer* = nullptr, size_t = s_DEFAULT_CAPACITY );
+  ~LTextCache( void );
+
+  LTextCache( const LTextCache& )            = delete;
+  LTextCache& operator=( const LTextCache& ) = delete;
+
+  void               setRenderer ( SDL_Renderer* );
+  const LCachedText* get         ( TTF_Font*, const char*, SDL_Color, bool = false );
+  void               render      ( TTF_Font*, const char*, SDL_Color, int, int, bool = false );
+  void               clear       ( void );
+
+  SDL_Renderer*      GetRenderer ( void ) const;
+  size_t             GetCount    ( void ) const;
+  size_t             GetCapacity ( void ) const;
+  Uint64             GetHits     ( void ) const;
+  Uint64             GetMisses   ( void ) const;
+  Uint64             GetEvictions( void ) const;
+
+private:
+
+  struct Entry
+  {
+    Uint64      Hash;
+    TTF_Font*   Font_Ptr;
+    int         FontHeight;
+    Uint32      Colour;   // RGBA, one byte each
+    bool        IsStatic;
+    std::string Text;
+    LCachedText Rendered;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  void Evict_Pvt( EntryList::iterator );
+
+  SDL_Renderer*                                     m_Renderer_Ptr;
+  size_t                                            m_Capacity;
+  EntryList                                         m_Recent;  // Most recently used first
+  EntryList                                         m_Static;  // Never evicted
+  std::unordered_map<Uint64, EntryList::iterator>   m_Index;   // Both lists, by hash
+  Uint64                                            m_Hits;
+  Uint64                                            m_Misses;
+  Uint64                                            m_Evictions;
+};
+
+#endif // LTEXTCACHE_HPP
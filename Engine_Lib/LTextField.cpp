@@ -0,0 +1,308 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTextField.hpp"
+#include "LPerfHarness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param Atlas The glyphs; it must outlive the field and be created before text is added.
+ **/
+LTextField::LTextField( LGlyphAtlas& Atlas )
+  : m_Atlas(Atlas), m_Lines(1), m_Area{ 0, 0, 0, 0 }, m_Colour{ 0x00, 0x00, 0x00, 0xFF }, m_IsCentered(false)
+{;}
+
+
+/**
+ * @brief Where the field is drawn. Lines are clipped to the area horizontally, and only the last
+ * ones that fit are drawn.
+ **/
+void LTextField::setArea( const SDL_Rect& Area )
+{
+  m_Area = Area;
+}
+
+
+void LTextField::setColour( SDL_Color Colour )
+{
+  m_Colour = Colour;
+}
+
+
+/**
+ * @brief Centres the lines narrower than the area.
+ **/
+void LTextField::setCentered( bool IsCentered )
+{
+  m_IsCentered = IsCentered;
+}
+
+
+void LTextField::setText( const char* Text_Ptr )
+{
+  clear();
+  append( Text_Ptr );
+}
+
+
+/**
+ * @brief Adds text at the end: typed characters, or a whole paste. Only the new glyphs are laid out,
+ * so the cost is that of the text added, whatever the length of the field.
+ *
+ * @param Text_Ptr UTF-8 text; '\n' starts a new line.
+ **/
+void LTextField::append( const char* Text_Ptr )
+{
+  if ( Text_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const unsigned char* Next_Ptr = reinterpret_cast<const unsigned char*>( Text_Ptr );
+  const size_t         Length   = strlen( Text_Ptr );
+
+  m_Text.append( Text_Ptr, Length );
+
+  while ( *Next_Ptr != '\0' )
+  {
+    int          Bytes;
+    const Uint32 Codepoint = DecodeUtf8( Next_Ptr, Bytes );
+
+    AppendCodepoint_Pvt( Codepoint, Bytes );
+    Next_Ptr += Bytes;
+  }
+}
+
+
+/**
+ * @brief Deletes the last character.
+ *
+ * @return false if the field was already empty.
+ **/
+bool LTextField::backspace( void )
+{
+  Line& Last = m_Lines.back();
+
+  if ( !Last.Glyphs.empty() )
+  {
+    const PlacedGlyph Removed = Last.Glyphs.back();
+
+    Last.Glyphs.pop_back();
+    m_Text.erase( m_Text.size() - static_cast<size_t>( Removed.Bytes ) );
+
+    // Back to the pen position before the glyph, kerning included
+    Last.Width = Last.Glyphs.empty() ? 0 : Removed.X - m_Atlas.getKerning( Last.Glyphs.back().Codepoint, Removed.Codepoint );
+
+    return true;
+  }
+  else if ( m_Lines.size() > 1 )
+  {
+    // The line was empty: the '\n' that started it goes
+    m_Lines.pop_back();
+    m_Text.pop_back();
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+void LTextField::clear( void )
+{
+  m_Text.clear();
+  m_Lines.clear();
+  m_Lines.emplace_back();
+}
+
+
+/**
+ * @brief Draws the visible glyphs, with a draw call per atlas page.
+ *
+ * @param Renderer_Ptr The renderer to draw with; the one of the atlas if omitted.
+ **/
+void LTextField::render( SDL_Renderer* Renderer_Ptr )
+{
+  const int LineHeight = m_Atlas.GetLineHeight();
+
+  if ( m_Atlas.GetTexture() == nullptr || LineHeight <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const size_t Visible = std::max( static_cast<size_t>( m_Area.h / LineHeight ), static_cast<size_t>( 1 ) );
+  const size_t First   = ( m_Lines.size() > Visible ) ? m_Lines.size() - Visible : 0;
+
+  for ( Batch& Each : m_Batches )
+  {
+    Each.Vertices.clear();
+    Each.Indices.clear();
+  }
+
+  for ( size_t i = First; i != m_Lines.size(); ++i )
+  {
+    const Line& Each = m_Lines[i];
+
+    // Narrow lines start at the left or are centred; wide ones end at the right edge
+    const int Left = ( Each.Width > m_Area.w ) ? m_Area.w - Each.Width
+                   : m_IsCentered              ? ( m_Area.w - Each.Width ) / 2
+                   : 0;
+
+    QueueLine_Pvt( Each, m_Area.x + Left, m_Area.y + static_cast<int>( i - First ) * LineHeight );
+  }
+
+  SDL_Renderer* Target = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : m_Atlas.GetRenderer();
+
+  for ( size_t Page = 0; Page != m_Batches.size(); ++Page )
+  {
+    const Batch& Each = m_Batches[Page];
+
+    if ( !Each.Indices.empty() )
+    {
+      if ( SDL_RenderGeometry( Target, m_Atlas.GetTexture( static_cast<int>( Page ) ),
+                               Each.Vertices.data(), static_cast<int>( Each.Vertices.size() ),
+                               Each.Indices.data() , static_cast<int>( Each.Indices.size()  ) ) != 0 )
+      {
+        printf( "\nText field could not be drawn! SDL Error: %s", SDL_GetError() );
+      }
+      else
+      {
+        LPerfHarness::countDrawCalls( 1 );
+      }
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @return The text, UTF-8.
+ **/
+const std::string& LTextField::getText( void ) const
+{
+  return m_Text;
+}
+
+
+size_t LTextField::GetLineCount( void ) const
+{
+  return m_Lines.size();
+}
+
+
+/**
+ * @return Width of a line, in pixels.
+ **/
+int LTextField::GetLineWidth( size_t Index ) const
+{
+  return ( Index < m_Lines.size() ) ? m_Lines[Index].Width : 0;
+}
+
+
+/**
+ * @brief Lays out one more glyph at the end of the last line, or starts a new line.
+ **/
+void LTextField::AppendCodepoint_Pvt( Uint32 Codepoint, int Bytes )
+{
+  if ( Codepoint == '\n' )
+  {
+    m_Lines.emplace_back();
+    return;
+  }
+  else
+  {;}
+
+  Line&                     Last      = m_Lines.back();
+  const LGlyphAtlas::Glyph* Glyph_Ptr = ( Codepoint >= ' ' ) ? m_Atlas.getGlyph( Codepoint ) : nullptr;
+  const int                 X         = Last.Width + ( Last.Glyphs.empty() ? 0 : m_Atlas.getKerning( Last.Glyphs.back().Codepoint, Codepoint ) );
+
+  Last.Glyphs.push_back( PlacedGlyph{ Glyph_Ptr, Codepoint, X, Bytes } );
+  Last.Width = X + ( ( Glyph_Ptr != nullptr ) ? Glyph_Ptr->Advance : 0 );
+}
+
+
+/**
+ * @brief Queues the glyphs of a line that fall inside the area.
+ **/
+void LTextField::QueueLine_Pvt( const Line& Queued, int x, int y )
+{
+  const float InvSize = 1.0f / static_cast<float>( m_Atlas.GetSize() );
+  const int   Right   = m_Area.x + m_Area.w;
+
+  // Glyphs are in order along the line: skip straight to the first one that starts in the area,
+  // and back one, which may reach into it
+  auto Glyph = std::lower_bound( Queued.Glyphs.begin(), Queued.Glyphs.end(), m_Area.x - x,
+                                 []( const PlacedGlyph& Each, int Start ) { return Each.X < Start; } );
+
+  if ( Glyph != Queued.Glyphs.begin() )
+  {
+    --Glyph;
+  }
+  else
+  {;}
+
+  for ( ; Glyph != Queued.Glyphs.end() && x + Glyph->X < Right; ++Glyph )
+  {
+    // Asked for again: brought back if evicted, kept in its page for this frame
+    const LGlyphAtlas::Glyph* Drawn_Ptr = ( Glyph->Glyph_Ptr != nullptr ) ? m_Atlas.getGlyph( Glyph->Codepoint ) : nullptr;
+
+    if ( Drawn_Ptr == nullptr || Drawn_Ptr->Page < 0 )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const SDL_Rect& Clip = Drawn_Ptr->Clip;
+
+    if ( static_cast<size_t>( Drawn_Ptr->Page ) >= m_Batches.size() )
+    {
+      m_Batches.resize( static_cast<size_t>( Drawn_Ptr->Page ) + 1 );
+    }
+    else
+    {;}
+
+    std::vector<SDL_Vertex>& Vertices = m_Batches[static_cast<size_t>( Drawn_Ptr->Page )].Vertices;
+    std::vector<int>&        Indices  = m_Batches[static_cast<size_t>( Drawn_Ptr->Page )].Indices;
+
+    const float u0 = static_cast<float>( Clip.x          ) * InvSize;
+    const float v0 = static_cast<float>( Clip.y          ) * InvSize;
+    const float u1 = static_cast<float>( Clip.x + Clip.w ) * InvSize;
+    const float v1 = static_cast<float>( Clip.y + Clip.h ) * InvSize;
+
+    const float x0 = static_cast<float>( x + Glyph->X          );
+    const float y0 = static_cast<float>( y                     );
+    const float x1 = static_cast<float>( x + Glyph->X + Clip.w );
+    const float y1 = static_cast<float>( y + Clip.h            );
+
+    const int First = static_cast<int>( Vertices.size() );
+
+    Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y0}, m_Colour, SDL_FPoint{u0, v0} } );
+    Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y0}, m_Colour, SDL_FPoint{u1, v0} } );
+    Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y1}, m_Colour, SDL_FPoint{u1, v1} } );
+    Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y1}, m_Colour, SDL_FPoint{u0, v1} } );
+
+    // Two triangles: top-left, top-right, bottom-right and bottom-right, bottom-left, top-left
+    Indices.push_back( First     );
+    Indices.push_back( First + 1 );
+    Indices.push_back( First + 2 );
+    Indices.push_back( First + 2 );
+    Indices.push_back( First + 3 );
+    Indices.push_back( First     );
+  }
+}
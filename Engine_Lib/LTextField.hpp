@@ -0,0 +1,84 @@
+/**
+ * @file LTextField.hpp
+ *
+ * @brief Editable text drawn from a glyph atlas, laid out one glyph at a time as it is typed.
+ **/
+
+#ifndef LTEXTFIELD_HPP
+#define LTEXTFIELD_HPP
+
+#include "LGlyphAtlas.hpp"
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A multi-line text field. The UTF-8 text is kept together with the layout of each line, the
+ * position of each of its glyphs in the atlas and on the line: typing or deleting a character
+ * touches one glyph at the end of the last line, and appending a long string, e.g. a paste, lays out
+ * only what it adds. Nothing is rasterised again, but the glyphs seen for the first time.
+ *
+ * "render" draws the lines that fit in the area, the last ones, with one SDL_RenderGeometry call
+ * per atlas page they use. A line wider than the area shows its end, where the text is being typed.
+ * The glyphs drawn are asked for again, so that the ones the atlas evicted come back.
+ **/
+class LTextField
+{
+public:
+
+  explicit LTextField( LGlyphAtlas& );
+
+  void               setArea    ( const SDL_Rect& );
+  void               setColour  ( SDL_Color );
+  void               setCentered( bool );
+
+  void               setText    ( const char* );
+  void               append     ( const char* );
+  bool               backspace  ( void );
+  void               clear      ( void );
+
+  void               render     ( SDL_Renderer* = nullptr );
+
+  const std::string& getText     ( void ) const;
+  size_t             GetLineCount( void ) const;
+  int                GetLineWidth( size_t ) const;
+
+private:
+
+  struct PlacedGlyph
+  {
+    const LGlyphAtlas::Glyph* Glyph_Ptr; // nullptr for what is not drawn, e.g. '\r'
+    Uint32                    Codepoint;
+    int                       X;         // From the start of the line
+    int                       Bytes;     // Of the UTF-8 text
+  };
+
+  struct Line
+  {
+    std::vector<PlacedGlyph> Glyphs;
+    int                      Width = 0;
+  };
+
+  void AppendCodepoint_Pvt( Uint32, int );
+  void QueueLine_Pvt      ( const Line&, int, int );
+
+  LGlyphAtlas&            m_Atlas;
+  std::string             m_Text;
+  std::vector<Line>       m_Lines;    // Never empty
+  SDL_Rect                m_Area;
+  SDL_Color               m_Colour;
+  bool                    m_IsCentered;
+
+  struct Batch
+  {
+    std::vector<SDL_Vertex> Vertices;
+    std::vector<int>        Indices;
+  };
+
+  // Geometry of the last render, by atlas page. Storage is kept, so steady-state frames do not
+  // allocate
+  std::vector<Batch>      m_Batches;
+};
+
+#endif // LTEXTFIELD_HPP
@@ -0,0 +1,540 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTexture.hpp"
+#include "LBakedTexture.hpp"
+#include "LAssetPack.hpp"
+#include "LPerfHarness.hpp"
+#include "LPixelOps.hpp"
+#include "colours.hpp"
+
+#include <SDL_image.h>
+#include <cstdio>
+#include <vector>
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+static SDL_Renderer* g_DefaultRenderer = NULL;
+
+// Native format of the last renderer queried by the thread: a thread uses a single renderer, so one
+// entry is enough, and threads loading for renderers of their own do not share it
+static thread_local SDL_Renderer* t_NativeFormatRenderer = NULL;
+static thread_local Uint32        t_NativeFormat         = SDL_PIXELFORMAT_UNKNOWN;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LTexture::LTexture( void )
+  : m_Texture(NULL), m_Renderer(NULL), m_Width(0), m_Height(0), m_Levels(), m_LevelCount(0)
+{;}
+
+
+LTexture::~LTexture( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Takes over the SDL texture of another instance, which is left empty.
+ **/
+LTexture::LTexture( LTexture&& Other ) noexcept
+  : m_Texture(NULL), m_Renderer(NULL), m_Width(0), m_Height(0), m_Levels(), m_LevelCount(0)
+{
+  TakeOver_Pvt( Other );
+}
+
+
+/**
+ * @brief Frees the current SDL texture, then takes over the one of another instance, which is left
+ * empty.
+ **/
+LTexture& LTexture::operator=( LTexture&& Other ) noexcept
+{
+  if ( this != &Other )
+  {
+    free();
+    TakeOver_Pvt( Other );
+  }
+  else
+  {;}
+
+  return *this;
+}
+
+
+/**
+ * @brief Sets the renderer used when none is given explicitly.
+ **/
+void LTexture::SetDefaultRenderer( SDL_Renderer* Renderer_Ptr )
+{
+  g_DefaultRenderer = Renderer_Ptr;
+}
+
+
+SDL_Renderer* LTexture::GetDefaultRenderer( void )
+{
+  return g_DefaultRenderer;
+}
+
+
+/**
+ * @brief Loads an image, colour keying cyan pixels. If a baked copy of the image ("<Path>.ltx")
+ * exists, it is loaded instead, with no decoding or conversion. Both are read from the default
+ * asset pack if it holds them.
+ *
+ * @param Path The path of the image.
+ * @param Renderer_Ptr The renderer that will render this texture; the default one if omitted.
+ * @param Levels Of the mip chain made from the decoded image, see loadFromSurface. A baked copy
+ * brings the levels it was baked with instead.
+ * @return true if successful; false otherwise.
+ **/
+bool LTexture::loadFromFile( const std::string& Path, SDL_Renderer* Renderer_Ptr, int Levels )
+{
+  if ( LoadBaked_Pvt( Path + LBAKED_TEXTURE_EXTENSION, Renderer_Ptr, false ) )
+  {
+    return true;
+  }
+  else
+  {;} // Not baked, or baked for a different renderer: decode the image
+
+  // Get rid of preexisting texture
+  free();
+
+  SDL_Surface* LoadedSurface = IMG_Load_RW( LOpenAsset( Path ), 1 );
+
+  if ( LoadedSurface == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_SetColorKey( LoadedSurface, SDL_TRUE, SDL_MapRGB( LoadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+
+  const bool Success = loadFromSurface( LoadedSurface, Renderer_Ptr, Levels );
+
+  if ( !Success )
+  {
+    printf( "\nUnable to create texture from \"%s\"!", Path.c_str() );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( LoadedSurface );
+
+  return Success;
+}
+
+
+/**
+ * @brief Creates the texture from a surface, converting it first to the renderer's native format.
+ * The colour key of the surface, if any, becomes transparency.
+ *
+ * @param Surface_Ptr The source pixels. Still owned by the caller.
+ * @param Renderer_Ptr The renderer that will render this texture; the default one if omitted.
+ * @param Levels Of the mip chain, the full size included: 1 (the default) for none, up to
+ * s_MAX_LEVELS. The smaller levels are halved from the converted pixels by HalvePixels, and only for
+ * 32-bit formats; a level that cannot be created ends the chain, but not the load.
+ * @return true if successful; false otherwise.
+ **/
+bool LTexture::loadFromSurface( SDL_Surface* Surface_Ptr, SDL_Renderer* Renderer_Ptr, int Levels )
+{
+  // Get rid of preexisting texture
+  free();
+
+  m_Renderer = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : g_DefaultRenderer;
+
+  const Uint32 NativeFormat = GetNativeFormat_Pvt( m_Renderer );
+  SDL_Surface* Converted    = NULL;
+
+  if ( NativeFormat != SDL_PIXELFORMAT_UNKNOWN && NativeFormat != Surface_Ptr->format->format )
+  {
+    Converted = SDL_ConvertSurfaceFormat( Surface_Ptr, NativeFormat, 0 );
+  }
+  else
+  {;} // Already native, or unknown: let SDL choose
+
+  SDL_Surface* Source = ( Converted != NULL ) ? Converted : Surface_Ptr;
+
+  m_Texture = SDL_CreateTextureFromSurface( m_Renderer, Source );
+
+  if ( m_Texture == NULL )
+  {
+    printf( "\nUnable to create texture! SDL Error: %s", SDL_GetError() );
+  }
+  else
+  {
+    m_Width      = Source->w;
+    m_Height     = Source->h;
+    m_LevelCount = 1;
+  }
+
+  Levels = SDL_min( Levels, s_MAX_LEVELS );
+
+  if ( m_Texture != NULL && Levels > 1 && Source->format->BytesPerPixel == 4 && SDL_LockSurface( Source ) == 0 )
+  {
+    // Each level halved from the previous one: the first from the surface
+    std::vector<Uint32> Previous;
+    std::vector<Uint32> Level;
+    const void*         Pixels_Ptr = Source->pixels;
+    int                 Pitch      = Source->pitch;
+    int                 Width      = Source->w;
+    int                 Height     = Source->h;
+
+    while ( m_LevelCount != Levels && ( Width > 1 || Height > 1 ) )
+    {
+      const int HalfW = SDL_max( Width / 2, 1 );
+      const int HalfH = SDL_max( Height / 2, 1 );
+
+      Level.resize( static_cast<size_t>( HalfW ) * static_cast<size_t>( HalfH ) );
+
+      if ( !HalvePixels( Pixels_Ptr, Width, Height, Pitch, Level.data(), HalfW * 4, Source->format->format )
+           || !AddLevel_Pvt( Level.data(), HalfW * 4, HalfW, HalfH, Source->format->format ) )
+      {
+        break;
+      }
+      else
+      {;}
+
+      Previous.swap( Level );
+      Pixels_Ptr = Previous.data();
+      Pitch      = HalfW * 4;
+      Width      = HalfW;
+      Height     = HalfH;
+    }
+
+    SDL_UnlockSurface( Source );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Converted );
+
+  return m_Texture != NULL;
+}
+
+
+/**
+ * @brief Creates an empty texture in the renderer's native format.
+ *
+ * @param Width
+ * @param Height
+ * @param Access SDL_TEXTUREACCESS_STREAMING to lock it, SDL_TEXTUREACCESS_TARGET to render into it.
+ * @param Renderer_Ptr The renderer that will render this texture; the default one if omitted.
+ * @return true if successful; false otherwise.
+ **/
+bool LTexture::createBlank( int Width, int Height, SDL_TextureAccess Access, SDL_Renderer* Renderer_Ptr )
+{
+  // Get rid of preexisting texture
+  free();
+
+  m_Renderer = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : g_DefaultRenderer;
+
+  Uint32 Format = GetNativeFormat_Pvt( m_Renderer );
+  Format = ( Format != SDL_PIXELFORMAT_UNKNOWN ) ? Format : SDL_PIXELFORMAT_RGBA8888;
+
+  m_Texture = SDL_CreateTexture( m_Renderer, Format, Access, Width, Height );
+
+  if ( m_Texture == NULL )
+  {
+    printf( "\nUnable to create blank texture! SDL Error: %s", SDL_GetError() );
+  }
+  else
+  {
+    m_Width      = Width;
+    m_Height     = Height;
+    m_LevelCount = 1;
+  }
+
+  return m_Texture != NULL;
+}
+
+
+void LTexture::free( void )
+{
+  for ( int i = 1; i < m_LevelCount; ++i )
+  {
+    SDL_DestroyTexture( m_Levels[i - 1] );
+    m_Levels[i - 1] = NULL;
+  }
+
+  if ( m_Texture != NULL )
+  {
+    SDL_DestroyTexture( m_Texture );
+    m_Texture = NULL;
+    m_Width   = 0;
+    m_Height  = 0;
+  }
+  else
+  {;}
+
+  m_LevelCount = 0;
+}
+
+
+/**
+ * @brief Modulate texture rgb, for every draw of the texture. To tint single sprites, pass their
+ * colour to LSpriteBatch::add instead: they keep sharing one draw call.
+ **/
+void LTexture::setColor( Uint8 Red, Uint8 Green, Uint8 Blue )
+{
+  SDL_SetTextureColorMod( m_Texture, Red, Green, Blue );
+
+  for ( int i = 1; i < m_LevelCount; ++i )
+  {
+    SDL_SetTextureColorMod( m_Levels[i - 1], Red, Green, Blue );
+  }
+}
+
+
+/**
+ * @brief Set blending function
+ **/
+void LTexture::setBlendMode( SDL_BlendMode Blending )
+{
+  SDL_SetTextureBlendMode( m_Texture, Blending );
+
+  for ( int i = 1; i < m_LevelCount; ++i )
+  {
+    SDL_SetTextureBlendMode( m_Levels[i - 1], Blending );
+  }
+}
+
+
+/**
+ * @brief Modulate texture alpha, for every draw of the texture. To fade single sprites, pass their
+ * alpha to LSpriteBatch::add instead.
+ **/
+void LTexture::setAlpha( Uint8 Alpha )
+{
+  SDL_SetTextureAlphaMod( m_Texture, Alpha );
+
+  for ( int i = 1; i < m_LevelCount; ++i )
+  {
+    SDL_SetTextureAlphaMod( m_Levels[i - 1], Alpha );
+  }
+}
+
+
+/**
+ * @brief Renders the texture, immediately. To draw many sprites of the same texture, rotated and
+ * flipped ones included, prefer queueing them in an LSpriteBatch.
+ *
+ * @param x x position on the window where the texture will be rendered.
+ * @param y y position on the window where the texture will be rendered.
+ * @param Clip Portion of the texture to render. Defaults to NULL (renders the whole texture).
+ * @param Angle Rotation angle around the centre. Defaults to 0.0 (no rotation).
+ * @param Centre Centre of rotation. Defaults to NULL (centre of the destination).
+ * @param Flip Flips the image around the vertical or horizontal axis. Defaults to SDL_FLIP_NONE.
+ **/
+void LTexture::render( int x, int y, const SDL_Rect* Clip, double Angle, const SDL_Point* Centre, SDL_RendererFlip Flip ) const
+{
+  SDL_Rect RenderQuad = { x, y, m_Width, m_Height };
+
+  if ( Clip != NULL )
+  {
+    RenderQuad.w = Clip->w;
+    RenderQuad.h = Clip->h;
+  }
+  else
+  {;}
+
+  if ( Angle == 0.0 && Flip == SDL_FLIP_NONE )
+  {
+    SDL_RenderCopy( m_Renderer, m_Texture, Clip, &RenderQuad ); // Cheaper path
+  }
+  else
+  {
+    SDL_RenderCopyEx( m_Renderer, m_Texture, Clip, &RenderQuad, Angle, Centre, Flip );
+  }
+
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+/**
+ * @brief Renders the texture, or part of it, stretched to a rectangle, immediately. When the
+ * rectangle is smaller than the part drawn, the texture is sampled from its smallest mip level still
+ * at least as large, so that every texel read contributes to the picture: less memory read, and no
+ * shimmering while the view moves. Clips on multiples of the level's scale (2, 4, 8) map exactly;
+ * others are rounded to its texels.
+ *
+ * @param Destination Where the texture is drawn, in the window.
+ * @param Clip Portion of the texture to render, at full size. Defaults to NULL (the whole texture).
+ **/
+void LTexture::renderScaled( const SDL_Rect& Destination, const SDL_Rect* Clip ) const
+{
+  const SDL_Rect Source = ( Clip != NULL ) ? *Clip : SDL_Rect{ 0, 0, m_Width, m_Height };
+  int            Level  = 0;
+
+  while ( Level + 1 < m_LevelCount && ( Source.w >> ( Level + 1 ) ) >= Destination.w && ( Source.h >> ( Level + 1 ) ) >= Destination.h )
+  {
+    ++Level;
+  }
+
+  if ( Level == 0 )
+  {
+    SDL_RenderCopy( m_Renderer, m_Texture, Clip, &Destination );
+  }
+  else
+  {
+    // Each level halves the previous one, rounding down
+    const int      Left   = Source.x >> Level;
+    const int      Top    = Source.y >> Level;
+    const SDL_Rect Scaled = { Left, Top, SDL_max( ( ( Source.x + Source.w ) >> Level ) - Left, 1 ),
+                                         SDL_max( ( ( Source.y + Source.h ) >> Level ) - Top, 1 ) };
+
+    SDL_RenderCopy( m_Renderer, m_Levels[Level - 1], &Scaled, &Destination );
+  }
+
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+int LTexture::getWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int LTexture::getHeight( void ) const
+{
+  return m_Height;
+}
+
+
+/**
+ * @return the levels of the mip chain, the full size included: 1 without smaller variants, 0 when
+ * empty.
+ **/
+int LTexture::getLevels( void ) const
+{
+  return m_LevelCount;
+}
+
+
+bool LTexture::isValid( void ) const
+{
+  return m_Texture != NULL;
+}
+
+
+SDL_Texture* LTexture::getSDLTexture( void ) const
+{
+  return m_Texture;
+}
+
+
+SDL_Renderer* LTexture::getRenderer( void ) const
+{
+  return m_Renderer;
+}
+
+
+/**
+ * @brief The first non-YUV format the renderer supports natively. Queried once per renderer.
+ *
+ * @return Uint32 SDL_PIXELFORMAT_UNKNOWN if the renderer cannot be queried.
+ **/
+Uint32 LTexture::GetNativeFormat_Pvt( SDL_Renderer* Renderer_Ptr )
+{
+  if ( Renderer_Ptr == t_NativeFormatRenderer )
+  {
+    return t_NativeFormat;
+  }
+  else
+  {;}
+
+  SDL_RendererInfo Info;
+  Uint32 Format = SDL_PIXELFORMAT_UNKNOWN;
+
+  if ( Renderer_Ptr != NULL && SDL_GetRendererInfo( Renderer_Ptr, &Info ) == 0 )
+  {
+    for ( Uint32 i = 0; i != Info.num_texture_formats; ++i )
+    {
+      if ( !SDL_ISPIXELFORMAT_FOURCC( Info.texture_formats[i] ) )
+      {
+        Format = Info.texture_formats[i];
+        break;
+      }
+      else
+      {;}
+    }
+  }
+  else
+  {;}
+
+  t_NativeFormatRenderer = Renderer_Ptr;
+  t_NativeFormat         = Format;
+
+  return Format;
+}
+
+
+/**
+ * @brief Appends a smaller variant to the mip chain, uploaded from the given pixels, with the blend
+ * mode of the full size texture.
+ *
+ * @return false, with the chain left as it was, if the texture could not be created.
+ **/
+bool LTexture::AddLevel_Pvt( const void* Pixels_Ptr, int Pitch, int Width, int Height, Uint32 Format )
+{
+  SDL_Texture*  Level_Ptr = SDL_CreateTexture( m_Renderer, Format, SDL_TEXTUREACCESS_STATIC, Width, Height );
+  SDL_BlendMode Blending  = SDL_BLENDMODE_BLEND;
+
+  if ( Level_Ptr == NULL || SDL_UpdateTexture( Level_Ptr, NULL, Pixels_Ptr, Pitch ) != 0 )
+  {
+    printf( "\nUnable to create mip level %d (%dx%d)! SDL Error: %s", m_LevelCount, Width, Height, SDL_GetError() );
+
+    if ( Level_Ptr != NULL )
+    {
+      SDL_DestroyTexture( Level_Ptr );
+    }
+    else
+    {;}
+
+    return false;
+  }
+  else
+  {;}
+
+  SDL_GetTextureBlendMode( m_Texture, &Blending );
+  SDL_SetTextureBlendMode( Level_Ptr, Blending );
+
+  m_Levels[m_LevelCount - 1] = Level_Ptr;
+  ++m_LevelCount;
+
+  return true;
+}
+
+
+/**
+ * @brief Takes over the textures of another instance, which is left empty. This one must be empty.
+ **/
+void LTexture::TakeOver_Pvt( LTexture& Other )
+{
+  m_Texture    = Other.m_Texture;
+  m_Renderer   = Other.m_Renderer;
+  m_Width      = Other.m_Width;
+  m_Height     = Other.m_Height;
+  m_LevelCount = Other.m_LevelCount;
+
+  for ( int i = 0; i != s_MAX_LEVELS - 1; ++i )
+  {
+    m_Levels[i]       = Other.m_Levels[i];
+    Other.m_Levels[i] = NULL;
+  }
+
+  Other.m_Texture    = NULL;
+  Other.m_Width      = 0;
+  Other.m_Height     = 0;
+  Other.m_LevelCount = 0;
+}
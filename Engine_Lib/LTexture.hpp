@@ -0,0 +1,96 @@
+/**
+ * @file LTexture.hpp
+ *
+ * @brief Texture wrapper shared by the tutorials and the projects. Replaces the per-program copies
+ * of "class LTexture".
+ **/
+
+#ifndef LTEXTURE_HPP
+#define LTEXTURE_HPP
+
+#include <SDL.h>
+#include <string>
+
+/**
+ * @brief A texture. It owns its SDL texture, so it can be moved but not copied.
+ *
+ * Images are converted once, at load time, into the renderer's native pixel format (looked up once
+ * per renderer and cached), so that the upload needs no further conversion by the driver. Images
+ * baked offline by the BakeTextures tool skip decoding and conversion altogether: loadFromFile picks
+ * up the baked copy "<image>.ltx" whenever it exists next to the image.
+ *
+ * Mip levels: a texture drawn smaller than it is, as a zoomed out view or a minimap, samples a few of
+ * its texels per pixel, skipping the others: it shimmers while it moves, and reads the whole image
+ * for a fraction of it. A texture loaded with more than one level keeps smaller variants of itself,
+ * each half the size of the previous one, and "renderScaled" draws from the smallest one still at
+ * least as large as the destination. The variants are made at load time from the pixels of the image,
+ * or mapped from a baked copy made with "BakeTextures --mips", and take a third more memory.
+ *
+ * Every method taking an SDL renderer falls back to the default one, set with
+ * "SetDefaultRenderer", when the renderer is omitted: this keeps the call sites of the tutorials,
+ * which rely on a global renderer, unchanged.
+ **/
+class LTexture
+{
+public:
+
+   LTexture( void );
+  ~LTexture( void );
+
+  LTexture( const LTexture&  ) = delete;
+  LTexture(       LTexture&& ) noexcept;
+
+  LTexture& operator=( const LTexture&  ) = delete;
+  LTexture& operator=(       LTexture&& ) noexcept;
+
+  static constexpr int s_MAX_LEVELS = 4;   // Of the mip chain, the full size included
+
+  static void          SetDefaultRenderer( SDL_Renderer* );
+  static SDL_Renderer* GetDefaultRenderer( void );
+
+  bool loadFromFile   ( const std::string&, SDL_Renderer* = nullptr, int = 1 );
+  bool loadFromBaked  ( const std::string&, SDL_Renderer* = nullptr );
+  bool loadFromSurface( SDL_Surface*, SDL_Renderer* = nullptr, int = 1 );
+  bool createBlank    ( int, int, SDL_TextureAccess = SDL_TEXTUREACCESS_STREAMING, SDL_Renderer* = nullptr );
+
+#if defined(SDL_TTF_MAJOR_VERSION)
+  // Creates image from font string. Defined in LTexture_Text.cpp, so that programs not using
+  // SDL_ttf do not need to link it
+  bool loadFromRenderedText( TTF_Font*, const char*, SDL_Color, SDL_Renderer* = nullptr );
+  bool loadFromRenderedText( TTF_Font*, const std::string&, SDL_Color, SDL_Renderer* = nullptr );
+#endif
+
+  void free        ( void );
+  void setColor    ( Uint8, Uint8, Uint8 );
+  void setBlendMode( SDL_BlendMode );
+  void setAlpha    ( Uint8 );
+  void render      ( int, int, const SDL_Rect* = NULL, double = 0.0, const SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE ) const;
+  void renderScaled( const SDL_Rect&, const SDL_Rect* = NULL ) const;
+
+  int           getWidth     ( void ) const;
+  int           getHeight    ( void ) const;
+  int           getLevels    ( void ) const;
+  bool          isValid      ( void ) const;
+  SDL_Texture*  getSDLTexture( void ) const;
+  SDL_Renderer* getRenderer  ( void ) const;
+
+private:
+
+  static Uint32 GetNativeFormat_Pvt  ( SDL_Renderer* );
+  static bool   IsFormatSupported_Pvt( SDL_Renderer*, Uint32 );
+
+  // Defined in LTexture_Baked.cpp, together with the file mapping code
+  bool LoadBaked_Pvt( const std::string&, SDL_Renderer*, bool );
+
+  bool AddLevel_Pvt ( const void*, int, int, int, Uint32 );
+  void TakeOver_Pvt ( LTexture& );
+
+  SDL_Texture*  m_Texture;  // The actual hardware texture
+  SDL_Renderer* m_Renderer; // The renderer it belongs to
+  int           m_Width;
+  int           m_Height;
+  SDL_Texture*  m_Levels[s_MAX_LEVELS - 1]; // Smaller variants, each half the previous one
+  int           m_LevelCount;               // m_Texture included
+};
+
+#endif // LTEXTURE_HPP
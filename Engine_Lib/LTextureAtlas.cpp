@@ -0,0 +1,279 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTextureAtlas.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return the folder of a file, with its separator, or an empty string for a file in the current
+ * folder.
+ **/
+static std::string FolderOf( const std::string& Path )
+{
+  const size_t Separator = Path.find_last_of( "/\\" );
+
+  return ( Separator != std::string::npos ) ? Path.substr( 0, Separator + 1 ) : std::string();
+}
+
+
+static bool IsNameBefore( const LAtlasClipRecord& Record, const std::string& Name )
+{
+  return strcmp( Record.Name, Name.c_str() ) < 0;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LTextureAtlas::LTextureAtlas( void )
+  : m_Folder(), m_Pages(), m_Paths(), m_Clips()
+{;}
+
+
+/**
+ * @brief Reads an ".atlas" file written by PackAtlas, replacing the table.
+ *
+ * @return false, leaving the atlas empty, if the file is missing or was not written by this
+ * version on a machine of the same byte order.
+ **/
+bool LTextureAtlas::load( const std::string& Path )
+{
+  clear();
+
+  SDL_RWops* Input = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( Input == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  LAtlasHeader                  Header;
+  std::vector<LAtlasPageRecord> Pages;
+
+  bool Success = SDL_RWread( Input, &Header, sizeof(Header), 1 ) == 1
+                 && memcmp( Header.Magic, LATLAS_MAGIC, sizeof(Header.Magic) ) == 0
+                 && Header.Version == LATLAS_VERSION
+                 && Header.PageCount > 0 && Header.ClipCount >= 0;
+
+  if ( Success )
+  {
+    Pages.resize( static_cast<size_t>( Header.PageCount ) );
+    m_Clips.resize( static_cast<size_t>( Header.ClipCount ) );
+
+    Success = SDL_RWread( Input, Pages.data(), sizeof(LAtlasPageRecord), Pages.size() ) == Pages.size()
+              && SDL_RWread( Input, m_Clips.data(), sizeof(LAtlasClipRecord), m_Clips.size() ) == m_Clips.size();
+  }
+  else
+  {;}
+
+  SDL_RWclose( Input );
+
+  // Strings and pages are checked, so that a damaged file cannot send the reader past an array
+  for ( size_t i = 0; Success && i != m_Clips.size(); ++i )
+  {
+    const LAtlasClipRecord& Record = m_Clips[i];
+
+    Success = memchr( Record.Name, '\0', sizeof(Record.Name) ) != NULL && Record.Page >= 0 && Record.Page < Header.PageCount
+              && ( i == 0 || strcmp( m_Clips[i - 1].Name, Record.Name ) < 0 );
+  }
+
+  for ( size_t i = 0; Success && i != Pages.size(); ++i )
+  {
+    Success = memchr( Pages[i].File, '\0', sizeof(Pages[i].File) ) != NULL;
+  }
+
+  if ( !Success )
+  {
+    printf( "\n\"%s\" is not an atlas file of this version!", Path.c_str() );
+    clear();
+    return false;
+  }
+  else
+  {;}
+
+  m_Folder = FolderOf( Path );
+
+  for ( const LAtlasPageRecord& Page : Pages )
+  {
+    m_Pages.push_back( Page.File );
+    m_Paths.push_back( m_Folder + Page.File );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the table as an ".atlas" file; the page images are written by the caller, in the
+ * same folder.
+ *
+ * @return false if the file could not be written.
+ **/
+bool LTextureAtlas::save( const std::string& Path ) const
+{
+  LAtlasHeader Header;
+  memcpy( Header.Magic, LATLAS_MAGIC, sizeof(Header.Magic) );
+  Header.Version   = LATLAS_VERSION;
+  Header.PageCount = static_cast<Sint32>( m_Pages.size() );
+  Header.ClipCount = static_cast<Sint32>( m_Clips.size() );
+
+  std::vector<LAtlasPageRecord> Pages( m_Pages.size() );
+
+  for ( size_t i = 0; i != m_Pages.size(); ++i )
+  {
+    SDL_strlcpy( Pages[i].File, m_Pages[i].c_str(), sizeof(Pages[i].File) );
+  }
+
+  SDL_RWops* Output = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  bool Success = ( Output != NULL )
+                 && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1
+                 && SDL_RWwrite( Output, Pages.data(), sizeof(LAtlasPageRecord), Pages.size() ) == Pages.size()
+                 && SDL_RWwrite( Output, m_Clips.data(), sizeof(LAtlasClipRecord), m_Clips.size() ) == m_Clips.size();
+
+  if ( Output != NULL )
+  {
+    Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+  }
+  else
+  {;}
+
+  if ( !Success )
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+
+  return Success;
+}
+
+
+void LTextureAtlas::clear( void )
+{
+  m_Folder.clear();
+  m_Pages.clear();
+  m_Paths.clear();
+  m_Clips.clear();
+}
+
+
+/**
+ * @brief Adds a page, as the packer does before saving.
+ *
+ * @param File The image of the page, relative to the atlas file.
+ * @return the index of the page; -1 if the name does not fit a record.
+ **/
+int LTextureAtlas::addPage( const std::string& File )
+{
+  if ( File.empty() || File.size() >= sizeof(LAtlasPageRecord::File) )
+  {
+    printf( "\nUnable to add the atlas page \"%s\": the name is empty or too long!", File.c_str() );
+    return -1;
+  }
+  else
+  {;}
+
+  m_Pages.push_back( File );
+  m_Paths.push_back( m_Folder + File );
+
+  return static_cast<int>( m_Pages.size() ) - 1;
+}
+
+
+/**
+ * @brief Adds a clip, keeping the table sorted by name.
+ *
+ * @return false if the name is empty, too long or already there, or the page does not exist.
+ **/
+bool LTextureAtlas::addClip( const std::string& Name, int Page, const SDL_Rect& Clip )
+{
+  const auto Position = std::lower_bound( m_Clips.begin(), m_Clips.end(), Name, IsNameBefore );
+
+  if ( Name.empty() || Name.size() >= sizeof(LAtlasClipRecord::Name) || Page < 0 || Page >= GetPageCount()
+       || ( Position != m_Clips.end() && Name == Position->Name ) )
+  {
+    printf( "\nUnable to add the atlas clip \"%s\": the name is empty, too long or taken, or the page is not valid!", Name.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  LAtlasClipRecord Record;
+  memset( &Record, 0, sizeof(Record) );
+  SDL_strlcpy( Record.Name, Name.c_str(), sizeof(Record.Name) );
+  Record.Page = Page;
+  Record.Clip = Clip;
+
+  m_Clips.insert( Position, Record );
+
+  return true;
+}
+
+
+/**
+ * @return the index of the clip of a loose image, by its name; -1 if it is not in the atlas.
+ **/
+int LTextureAtlas::find( const std::string& Name ) const
+{
+  const auto Position = std::lower_bound( m_Clips.begin(), m_Clips.end(), Name, IsNameBefore );
+
+  return ( Position != m_Clips.end() && Name == Position->Name ) ? static_cast<int>( Position - m_Clips.begin() ) : -1;
+}
+
+
+int LTextureAtlas::GetPageCount( void ) const
+{
+  return static_cast<int>( m_Pages.size() );
+}
+
+
+/**
+ * @return the image file of a page, with the folder of the atlas in front: ready for loadFromFile.
+ **/
+const std::string& LTextureAtlas::GetPagePath( int Page ) const
+{
+  return m_Paths[Page];
+}
+
+
+int LTextureAtlas::GetClipCount( void ) const
+{
+  return static_cast<int>( m_Clips.size() );
+}
+
+
+std::string LTextureAtlas::GetName( int Index ) const
+{
+  return m_Clips[Index].Name;
+}
+
+
+/**
+ * @return the page holding a clip.
+ **/
+int LTextureAtlas::GetPage( int Index ) const
+{
+  return m_Clips[Index].Page;
+}
+
+
+/**
+ * @return where a clip is in its page.
+ **/
+const SDL_Rect& LTextureAtlas::GetClip( int Index ) const
+{
+  return m_Clips[Index].Clip;
+}
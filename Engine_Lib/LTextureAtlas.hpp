@@ -0,0 +1,83 @@
+/**
+ * @file LTextureAtlas.hpp
+ *
+ * @brief Clip table of a texture atlas (".atlas"): where each of many loose images ended up in the
+ * few pages the PackAtlas tool packed them into.
+ **/
+
+#ifndef LTEXTUREATLAS_HPP
+#define LTEXTUREATLAS_HPP
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief An ".atlas" file is this header, then PageCount page records, then ClipCount clip records,
+ * sorted by name. Fields are stored in the byte order of the machine that packed the atlas, as in
+ * the ".ltx" files.
+ **/
+struct LAtlasHeader
+{
+  char   Magic[4];   // LATLAS_MAGIC
+  Uint32 Version;    // LATLAS_VERSION
+  Sint32 PageCount;
+  Sint32 ClipCount;
+};
+
+struct LAtlasPageRecord
+{
+  char File[64];     // Image of the page, relative to the atlas file; zero terminated
+};
+
+struct LAtlasClipRecord
+{
+  char     Name[52]; // Of the loose image, without folder and extension; zero terminated
+  Sint32   Page;
+  SDL_Rect Clip;     // In the page, in pixels, padding excluded
+};
+
+static constexpr char   LATLAS_MAGIC[4]    = { 'L', 'A', 'T', 'L' };
+static constexpr Uint32 LATLAS_VERSION     = 1;
+static constexpr char   LATLAS_EXTENSION[] = ".atlas";
+
+static_assert( sizeof(LAtlasHeader)     == 16, "The atlas header must have no padding" );
+static_assert( sizeof(LAtlasClipRecord) == 72, "The clip record must have no padding" );
+
+/**
+ * @brief The clip table of an atlas, loaded with one read of each part. It knows the pages only by
+ * their image files: load them with any texture class, LTexture or a tutorial's own, and draw the
+ * clip of a sprite from the texture of its page.
+ *
+ * Look the sprites up by name once, with "find", and keep the index: the names are sorted, so a
+ * lookup is a binary search, but still a string comparison per step.
+ **/
+class LTextureAtlas
+{
+public:
+
+  LTextureAtlas( void );
+
+  bool load          ( const std::string& );
+  bool save          ( const std::string& ) const;
+  void clear         ( void );
+  int  addPage       ( const std::string& );
+  bool addClip       ( const std::string&, int, const SDL_Rect& );
+  int  find          ( const std::string& ) const;
+
+  int                GetPageCount ( void ) const;
+  const std::string& GetPagePath  ( int ) const;
+  int                GetClipCount ( void ) const;
+  std::string        GetName      ( int ) const;
+  int                GetPage      ( int ) const;
+  const SDL_Rect&    GetClip      ( int ) const;
+
+private:
+
+  std::string                   m_Folder;   // Of the atlas file, with its separator, or empty
+  std::vector<std::string>      m_Pages;    // Image files, relative to m_Folder
+  std::vector<std::string>      m_Paths;    // The same, with m_Folder in front
+  std::vector<LAtlasClipRecord> m_Clips;    // Sorted by name
+};
+
+#endif // LTEXTUREATLAS_HPP
@@ -0,0 +1,190 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTexture.hpp"
+#include "LBakedTexture.hpp"
+#include "LAssetPack.hpp"
+#include "LMappedFile.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief Loads a texture baked offline by BakeTextures. The pixels are mapped from the file, or
+ * viewed in the default asset pack if it holds the file, and uploaded as they are: no decoding,
+ * colour keying or format conversion happens at runtime. The mip levels baked with "--mips" become
+ * the smaller variants of the texture, up to s_MAX_LEVELS.
+ *
+ * @param Path The path of the ".ltx" file.
+ * @param Renderer_Ptr The renderer that will render this texture; the default one if omitted.
+ * @return true if successful; false if the file is missing, malformed, or baked in a format the
+ * renderer cannot sample directly (bake it again with the format reported by BakeTextures --list).
+ **/
+bool LTexture::loadFromBaked( const std::string& Path, SDL_Renderer* Renderer_Ptr )
+{
+  return LoadBaked_Pvt( Path, Renderer_Ptr, true );
+}
+
+
+/**
+ * @brief Implementation of loadFromBaked.
+ *
+ * @param ReportMissing false to fail silently when the file does not exist, as loadFromFile does
+ * while probing for a baked copy of an image.
+ **/
+bool LTexture::LoadBaked_Pvt( const std::string& Path, SDL_Renderer* Renderer_Ptr, bool ReportMissing )
+{
+  // Get rid of preexisting texture
+  free();
+
+  LMappedFile  File;
+  LAssetPack*  Pack_Ptr = LAssetPack::GetDefault();
+  const Uint8* Data_Ptr = nullptr;
+  size_t       Size     = 0;
+
+  // Stored in the pack as they are, at the alignment of a page: no copy either way
+  if ( Pack_Ptr == nullptr || !Pack_Ptr->IsOpen() || !Pack_Ptr->view( Path, Data_Ptr, Size ) )
+  {
+    File.open( Path.c_str() );
+    Data_Ptr = File.GetData();
+    Size     = File.GetSize();
+  }
+  else
+  {;}
+
+  if ( Data_Ptr == nullptr )
+  {
+    if ( ReportMissing )
+    {
+      printf( "\nUnable to map baked texture \"%s\"!", Path.c_str() );
+    }
+    else
+    {;}
+
+    return false;
+  }
+  else
+  {;}
+
+  LBakedTextureHeader Header;
+
+  if ( Size < sizeof(Header) )
+  {
+    printf( "\nBaked texture \"%s\" is truncated!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  memcpy( &Header, Data_Ptr, sizeof(Header) );
+
+  // The full size image, then the smaller levels of the mip chain
+  size_t PixelBytes = static_cast<size_t>( Header.Pitch ) * static_cast<size_t>( Header.Height );
+
+  for ( Uint32 i = 1; i < Header.Levels && i < LBAKED_TEXTURE_MAX_LEVELS; ++i )
+  {
+    const SDL_Point LevelSize = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) );
+
+    PixelBytes += static_cast<size_t>( LevelSize.x ) * static_cast<size_t>( LevelSize.y ) * 4;
+  }
+
+  if ( memcmp( Header.Magic, LBAKED_TEXTURE_MAGIC, sizeof(Header.Magic) ) != 0 || Header.Version != LBAKED_TEXTURE_VERSION ||
+       Header.Width <= 0 || Header.Height <= 0 || Header.Pitch < Header.Width * 4 ||
+       Header.Levels == 0 || Header.Levels > LBAKED_TEXTURE_MAX_LEVELS || Size < sizeof(Header) + PixelBytes )
+  {
+    printf( "\nBaked texture \"%s\" is not valid!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Renderer = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : GetDefaultRenderer();
+
+  if ( !IsFormatSupported_Pvt( m_Renderer, Header.Format ) )
+  {
+    printf( "\nBaked texture \"%s\" is in %s, which the renderer does not support!", Path.c_str(), SDL_GetPixelFormatName( Header.Format ) );
+    return false;
+  }
+  else
+  {;}
+
+  m_Texture = SDL_CreateTexture( m_Renderer, Header.Format, SDL_TEXTUREACCESS_STATIC, Header.Width, Header.Height );
+
+  if ( m_Texture == NULL )
+  {
+    printf( "\nUnable to create texture for \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  if ( SDL_UpdateTexture( m_Texture, NULL, Data_Ptr + sizeof(Header), Header.Pitch ) != 0 )
+  {
+    printf( "\nUnable to upload \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    free();
+    return false;
+  }
+  else
+  {;}
+
+  // Same blending SDL_CreateTextureFromSurface sets up for surfaces with alpha or a colour key
+  SDL_SetTextureBlendMode( m_Texture, SDL_BLENDMODE_BLEND );
+
+  m_Width      = Header.Width;
+  m_Height     = Header.Height;
+  m_LevelCount = 1;
+
+  // The levels this texture keeps, uploaded from the file as they are; those past s_MAX_LEVELS are
+  // too small to be worth a texture
+  const Uint8* Level_Ptr = Data_Ptr + sizeof(Header) + static_cast<size_t>( Header.Pitch ) * static_cast<size_t>( Header.Height );
+
+  for ( int i = 1; i < static_cast<int>( Header.Levels ) && i < s_MAX_LEVELS; ++i )
+  {
+    const SDL_Point LevelSize = LBakedMipSize( Header.Width, Header.Height, i );
+
+    if ( !AddLevel_Pvt( Level_Ptr, LevelSize.x * 4, LevelSize.x, LevelSize.y, Header.Format ) )
+    {
+      break;
+    }
+    else
+    {;}
+
+    Level_Ptr += static_cast<size_t>( LevelSize.x ) * static_cast<size_t>( LevelSize.y ) * 4;
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Whether the renderer samples textures of the given format without converting them.
+ **/
+bool LTexture::IsFormatSupported_Pvt( SDL_Renderer* Renderer_Ptr, Uint32 Format )
+{
+  SDL_RendererInfo Info;
+
+  if ( Renderer_Ptr == NULL || SDL_GetRendererInfo( Renderer_Ptr, &Info ) != 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  for ( Uint32 i = 0; i != Info.num_texture_formats; ++i )
+  {
+    if ( Info.texture_formats[i] == Format )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
@@ -0,0 +1,50 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL_ttf.h> // Before LTexture.hpp, to enable loadFromRenderedText
+#include "LTexture.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief Creates the texture from a string, e.g. one formatted in the frame arena.
+ *
+ * @param Font_Ptr The font to render with.
+ * @param Text_Ptr The string.
+ * @param Colour The colour of the string.
+ * @param Renderer_Ptr The renderer that will render this texture; the default one if omitted.
+ * @return true if successful; false otherwise.
+ **/
+bool LTexture::loadFromRenderedText( TTF_Font* Font_Ptr, const char* Text_Ptr, SDL_Color Colour, SDL_Renderer* Renderer_Ptr )
+{
+  // Get rid of preexisting texture
+  free();
+
+  SDL_Surface* TextSurface = TTF_RenderText_Blended( Font_Ptr, Text_Ptr, Colour );
+
+  if ( TextSurface == NULL )
+  {
+    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const bool Success = loadFromSurface( TextSurface, Renderer_Ptr );
+
+  SDL_FreeSurface( TextSurface );
+
+  return Success;
+}
+
+
+bool LTexture::loadFromRenderedText( TTF_Font* Font_Ptr, const std::string& Text, SDL_Color Colour, SDL_Renderer* Renderer_Ptr )
+{
+  return loadFromRenderedText( Font_Ptr, Text.c_str(), Colour, Renderer_Ptr );
+}
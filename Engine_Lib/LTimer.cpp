@@ -0,0 +1,147 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTimer.hpp"
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Performance counter counts to nanoseconds. Whole seconds and the remainder are converted
+ * apart, so that the product cannot overflow.
+ **/
+static Uint64 CountsToNanoseconds( Uint64 Counts )
+{
+  const Uint64 Frequency = SDL_GetPerformanceFrequency();
+
+  return ( Counts / Frequency ) * LHighResTimer::s_NS_IN_A_S + ( Counts % Frequency ) * LHighResTimer::s_NS_IN_A_S / Frequency;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LHighResTimer::LHighResTimer( void )
+  : m_StartCounts(0), m_PausedCounts(0), m_IsPaused(false), m_IsStarted(false)
+{;}
+
+
+/**
+ * @brief Starts the timer from zero, or restarts it if it was running or paused.
+ **/
+void LHighResTimer::start( void )
+{
+  m_IsStarted    = true;
+  m_IsPaused     = false;
+  m_StartCounts  = SDL_GetPerformanceCounter();
+  m_PausedCounts = 0;
+}
+
+
+void LHighResTimer::stop( void )
+{
+  m_IsStarted    = false;
+  m_IsPaused     = false;
+  m_StartCounts  = 0;
+  m_PausedCounts = 0;
+}
+
+
+void LHighResTimer::pause( void )
+{
+  if ( m_IsStarted && !m_IsPaused )
+  {
+    m_IsPaused     = true;
+    m_PausedCounts = SDL_GetPerformanceCounter() - m_StartCounts;
+    m_StartCounts  = 0;
+  }
+  else
+  {;} // Not started or already paused
+}
+
+
+void LHighResTimer::unpause( void )
+{
+  if ( m_IsStarted && m_IsPaused )
+  {
+    // Start as far in the past as the time elapsed before the pause
+    m_IsPaused     = false;
+    m_StartCounts  = SDL_GetPerformanceCounter() - m_PausedCounts;
+    m_PausedCounts = 0;
+  }
+  else
+  {;} // Not started or already running
+}
+
+
+/**
+ * @brief Restarts the timer and returns the time elapsed until then, in seconds, from a single
+ * reading of the counter: a step timer loses no time between reading and restarting. A stopped timer
+ * is started and returns 0.
+ **/
+double LHighResTimer::lap( void )
+{
+  const Uint64 Now     = SDL_GetPerformanceCounter();
+  const Uint64 Elapsed = m_IsStarted ? ( m_IsPaused ? m_PausedCounts : Now - m_StartCounts ) : 0;
+
+  m_IsStarted    = true;
+  m_IsPaused     = false;
+  m_StartCounts  = Now;
+  m_PausedCounts = 0;
+
+  return static_cast<double>( Elapsed ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+}
+
+
+/**
+ * @return Nanoseconds since the timer started, pauses excluded; 0 when stopped.
+ **/
+Uint64 LHighResTimer::getTicks( void ) const
+{
+  return CountsToNanoseconds( GetCounts_Pvt() );
+}
+
+
+/**
+ * @return Seconds since the timer started, pauses excluded; 0 when stopped.
+ **/
+double LHighResTimer::getSeconds( void ) const
+{
+  return static_cast<double>( GetCounts_Pvt() ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+}
+
+
+bool LHighResTimer::isStarted( void ) const
+{
+  return m_IsStarted;
+}
+
+
+bool LHighResTimer::isPaused( void ) const
+{
+  return m_IsPaused && m_IsStarted;
+}
+
+
+/**
+ * @brief Performance counter counts elapsed: frozen while paused, 0 when stopped.
+ **/
+Uint64 LHighResTimer::GetCounts_Pvt( void ) const
+{
+  if ( !m_IsStarted )
+  {
+    return 0;
+  }
+  else if ( m_IsPaused )
+  {
+    return m_PausedCounts;
+  }
+  else
+  {
+    return SDL_GetPerformanceCounter() - m_StartCounts;
+  }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file LTimer.hpp
+ *
+ * @brief High-resolution timer for the examples that time frames or steps.
+ **/
+
+#ifndef LTIMER_HPP
+#define LTIMER_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief The start/stop/pause/unpause timer of the tutorials, read from SDL_GetPerformanceCounter
+ * instead of SDL_GetTicks. The ticks are nanoseconds in 64 bits: no millisecond rounding, which at
+ * 144 Hz and more is a large part of a frame, and no wrap-around after 49 days.
+ **/
+class LHighResTimer
+{
+public:
+
+  static constexpr Uint64 s_NS_IN_A_S  = 1'000'000'000;
+  static constexpr Uint64 s_NS_IN_A_MS = 1'000'000;
+
+  LHighResTimer( void );
+
+  void   start     ( void );
+  void   stop      ( void );
+  void   pause     ( void );
+  void   unpause   ( void );
+  double lap       ( void );
+
+  Uint64 getTicks  ( void ) const;
+  double getSeconds( void ) const;
+
+  bool   isStarted ( void ) const;
+  bool   isPaused  ( void ) const;
+
+private:
+
+  Uint64 GetCounts_Pvt( void ) const;
+
+  Uint64 m_StartCounts;   // Performance counter when the timer started
+  Uint64 m_PausedCounts;  // Counts elapsed when the timer was paused
+  bool   m_IsPaused;
+  bool   m_IsStarted;
+};
+
+#endif // LTIMER_HPP
@@ -0,0 +1,326 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTimerWheel.hpp"
+#include "LTrace.hpp"
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @param Now Current time, in milliseconds, as "advance" will be given it (e.g. SDL_GetTicks()).
+ **/
+LTimerWheel::LTimerWheel( Uint32 Now )
+  : m_Heads( s_WHEELS * s_SLOTS, s_NONE ), m_FreeHead(s_NONE), m_Time(Now), m_Pending(0)
+{;}
+
+
+/**
+ * @brief Schedules a callback Delay milliseconds from the time of the last "advance": it runs in
+ * the first "advance" that reaches that time.
+ *
+ * @param Delay   Milliseconds; 0 counts as 1, so that the callback never runs inside "add".
+ * @param Param   Passed to the callback.
+ * @return The handle to cancel the timer with.
+ **/
+LTimerHandle LTimerWheel::add( Uint32 Delay, LTimerCallback Callback, void* Param )
+{
+  Uint32 Index = m_FreeHead;
+
+  if ( Index != s_NONE )
+  {
+    m_FreeHead = m_Nodes[Index].Next;
+  }
+  else
+  {
+    Index = static_cast<Uint32>( m_Nodes.size() );
+    m_Nodes.push_back( Node{ 0, 0, nullptr, nullptr, s_NONE, s_NONE, s_NONE, 0 } );
+  }
+
+  Node& Timer = m_Nodes[Index];
+
+  Timer.Interval = ( Delay != 0 ) ? Delay : 1;
+  Timer.Expiry   = m_Time + Timer.Interval;
+  Timer.Callback = Callback;
+  Timer.Param    = Param;
+  ++Timer.Generation;
+
+  Link_Pvt( Index );
+  ++m_Pending;
+
+  return LTimerHandle{ Index, Timer.Generation };
+}
+
+
+/**
+ * @brief Removes a timer before it runs. A callback can cancel its own timer, to stop it repeating.
+ *
+ * @return false if the timer had already run out or been cancelled.
+ **/
+bool LTimerWheel::cancel( LTimerHandle Handle )
+{
+  if ( !isPending( Handle ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // A timer whose callback is running is in no slot
+  if ( m_Nodes[Handle.Index].Slot != s_NONE )
+  {
+    Unlink_Pvt( Handle.Index );
+  }
+  else
+  {;}
+
+  Free_Pvt( Handle.Index );
+
+  return true;
+}
+
+
+bool LTimerWheel::isPending( LTimerHandle Handle ) const
+{
+  return Handle.Index < m_Nodes.size() && ( Handle.Generation & 1 ) != 0 &&
+         m_Nodes[Handle.Index].Generation == Handle.Generation;
+}
+
+
+/**
+ * @brief Runs the timers due up to Now, millisecond by millisecond, in order of expiry.
+ *
+ * @return The number of callbacks run.
+ **/
+size_t LTimerWheel::advance( Uint32 Now )
+{
+  LTrace::Zone Traced( "Timers" );
+
+  size_t Run = 0;
+
+  // Nothing to wait for: the wheels can jump ahead
+  if ( m_Pending == 0 )
+  {
+    m_Time = Now;
+  }
+  else
+  {;}
+
+  while ( m_Time != Now )
+  {
+    Run += Tick_Pvt();
+
+    if ( m_Pending == 0 )
+    {
+      m_Time = Now;
+    }
+    else
+    {;}
+  }
+
+  return Run;
+}
+
+
+/**
+ * @brief Cancels every timer.
+ **/
+void LTimerWheel::clear( void )
+{
+  for ( Uint32 i = 0; i != m_Nodes.size(); ++i )
+  {
+    if ( ( m_Nodes[i].Generation & 1 ) != 0 )
+    {
+      cancel( LTimerHandle{ i, m_Nodes[i].Generation } );
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @return The last millisecond run.
+ **/
+Uint32 LTimerWheel::GetTime( void ) const
+{
+  return m_Time;
+}
+
+
+size_t LTimerWheel::GetPendingCount( void ) const
+{
+  return m_Pending;
+}
+
+
+/**
+ * @brief Puts a node in the slot of its expiry, on the finest wheel whose range reaches it.
+ **/
+void LTimerWheel::Link_Pvt( Uint32 Index )
+{
+  Node&        Timer = m_Nodes[Index];
+  const Uint32 Delta = Timer.Expiry - m_Time;
+  Uint32       Wheel = 0;
+
+  while ( Wheel + 1 != s_WHEELS && ( Delta >> ( s_SLOT_BITS * ( Wheel + 1 ) ) ) != 0 )
+  {
+    ++Wheel;
+  }
+
+  const Uint32 Slot = Wheel * s_SLOTS + ( ( Timer.Expiry >> ( s_SLOT_BITS * Wheel ) ) & s_SLOT_MASK );
+
+  Timer.Slot = Slot;
+  Timer.Prev = s_NONE;
+  Timer.Next = m_Heads[Slot];
+
+  if ( Timer.Next != s_NONE )
+  {
+    m_Nodes[Timer.Next].Prev = Index;
+  }
+  else
+  {;}
+
+  m_Heads[Slot] = Index;
+}
+
+
+void LTimerWheel::Unlink_Pvt( Uint32 Index )
+{
+  Node& Timer = m_Nodes[Index];
+
+  if ( Timer.Prev != s_NONE )
+  {
+    m_Nodes[Timer.Prev].Next = Timer.Next;
+  }
+  else
+  {
+    m_Heads[Timer.Slot] = Timer.Next;
+  }
+
+  if ( Timer.Next != s_NONE )
+  {
+    m_Nodes[Timer.Next].Prev = Timer.Prev;
+  }
+  else
+  {;}
+
+  Timer.Slot = s_NONE;
+}
+
+
+/**
+ * @brief Returns an unlinked node to the free list; its handles stop matching it.
+ **/
+void LTimerWheel::Free_Pvt( Uint32 Index )
+{
+  Node& Timer = m_Nodes[Index];
+
+  ++Timer.Generation;
+  Timer.Callback = nullptr;
+  Timer.Param    = nullptr;
+  Timer.Next     = m_FreeHead;
+  m_FreeHead     = Index;
+  --m_Pending;
+}
+
+
+/**
+ * @brief Empties the current slot of a wheel into the finer ones, now that they can hold its timers.
+ **/
+void LTimerWheel::Cascade_Pvt( Uint32 Wheel )
+{
+  const Uint32 Slot  = Wheel * s_SLOTS + ( ( m_Time >> ( s_SLOT_BITS * Wheel ) ) & s_SLOT_MASK );
+  Uint32       Index = m_Heads[Slot];
+
+  m_Heads[Slot] = s_NONE;
+
+  while ( Index != s_NONE )
+  {
+    const Uint32 Next = m_Nodes[Index].Next;
+
+    Link_Pvt( Index );
+    Index = Next;
+  }
+}
+
+
+/**
+ * @brief Moves on by a millisecond and runs the batch of timers that expire in it.
+ *
+ * @return The number of callbacks run.
+ **/
+size_t LTimerWheel::Tick_Pvt( void )
+{
+  ++m_Time;
+
+  // Coarser wheels first whose slot has come round, so that their timers reach the first wheel
+  Uint32 Wheels = 1;
+
+  while ( Wheels != s_WHEELS && ( m_Time & ( ( 1u << ( s_SLOT_BITS * Wheels ) ) - 1 ) ) == 0 )
+  {
+    ++Wheels;
+  }
+
+  for ( Uint32 Wheel = Wheels - 1; Wheel != 0; --Wheel )
+  {
+    Cascade_Pvt( Wheel );
+  }
+
+  // Detaches the batch first: the callbacks may add timers to this very slot, for the next turn
+  const Uint32 Slot  = m_Time & s_SLOT_MASK;
+  Uint32       Index = m_Heads[Slot];
+
+  m_Heads[Slot] = s_NONE;
+  m_Expired.clear();
+
+  while ( Index != s_NONE )
+  {
+    Node& Timer = m_Nodes[Index];
+
+    Timer.Slot = s_NONE;
+    m_Expired.push_back( LTimerHandle{ Index, Timer.Generation } );
+    Index = Timer.Next;
+  }
+
+  size_t Run = 0;
+
+  for ( const LTimerHandle& Handle : m_Expired )
+  {
+    // Cancelled by an earlier callback of the batch
+    if ( !isPending( Handle ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const Node&  Timer    = m_Nodes[Handle.Index];
+    const Uint32 Interval = Timer.Callback( Timer.Interval, Timer.Param );
+
+    ++Run;
+
+    // The callback may have cancelled its timer, and adding timers may have moved the nodes
+    if ( !isPending( Handle ) )
+    {
+      continue;
+    }
+    else if ( Interval != 0 )
+    {
+      Node& Again = m_Nodes[Handle.Index];
+
+      Again.Interval = Interval;
+      Again.Expiry   = m_Time + Interval;
+      Link_Pvt( Handle.Index );
+    }
+    else
+    {
+      Free_Pvt( Handle.Index );
+    }
+  }
+
+  return Run;
+}
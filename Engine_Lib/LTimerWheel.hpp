@@ -0,0 +1,91 @@
+/**
+ * @file LTimerWheel.hpp
+ *
+ * @brief Gameplay timers by the ten thousand, run by the main loop instead of SDL's timer thread.
+ **/
+
+#ifndef LTIMERWHEEL_HPP
+#define LTIMERWHEEL_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief Same signature as an SDL_TimerCallback: it gets the interval and the parameter of its timer,
+ * and returns the interval to run again after, or 0 to stop.
+ **/
+typedef Uint32 (*LTimerCallback)( Uint32, void* );
+
+
+/**
+ * @brief Refers to a timer of a wheel. The handle of a timer that ran out, or was cancelled, stays
+ * harmless: its slot is reused under another generation.
+ **/
+struct LTimerHandle
+{
+  Uint32 Index      = 0;
+  Uint32 Generation = 0;  // 0 for no timer
+};
+
+
+/**
+ * @brief Hierarchical timer wheel, in milliseconds. Four wheels of 256 slots each cover 2^8, 2^16,
+ * 2^24 and 2^32 ms ahead: a timer goes in the slot of its expiry on the finest wheel that reaches
+ * it, and moves down a wheel each time the finer one turns round, until it is in the first wheel,
+ * whose slots are single milliseconds. Inserting and cancelling unlink and link one node: O(1),
+ * however many timers there are.
+ *
+ * "advance" is called once per frame with the current time. It runs the timers of every elapsed
+ * millisecond, in batches of one slot, on the calling thread: callbacks can touch the game state
+ * with no locks, and add or cancel timers, themselves included.
+ **/
+class LTimerWheel
+{
+public:
+
+  explicit LTimerWheel( Uint32 = 0 );
+
+  LTimerHandle add            ( Uint32, LTimerCallback, void* );
+  bool         cancel         ( LTimerHandle );
+  bool         isPending      ( LTimerHandle ) const;
+  size_t       advance        ( Uint32 );
+  void         clear          ( void );
+
+  Uint32       GetTime        ( void ) const;
+  size_t       GetPendingCount( void ) const;
+
+private:
+
+  static constexpr Uint32 s_WHEELS     = 4;
+  static constexpr Uint32 s_SLOT_BITS  = 8;
+  static constexpr Uint32 s_SLOTS      = 1 << s_SLOT_BITS;  // Per wheel
+  static constexpr Uint32 s_SLOT_MASK  = s_SLOTS - 1;
+  static constexpr Uint32 s_NONE       = 0xFFFFFFFF;          // No node, or no slot
+
+  struct Node
+  {
+    Uint32         Expiry;
+    Uint32         Interval;
+    LTimerCallback Callback;
+    void*          Param;
+    Uint32         Prev;
+    Uint32         Next;        // Also links the free nodes
+    Uint32         Slot;        // s_NONE while free or running
+    Uint32         Generation;  // Odd while in use
+  };
+
+  void   Link_Pvt   ( Uint32 );
+  void   Unlink_Pvt ( Uint32 );
+  void   Free_Pvt   ( Uint32 );
+  void   Cascade_Pvt( Uint32 );
+  size_t Tick_Pvt   ( void );
+
+  std::vector<Node>         m_Nodes;
+  std::vector<Uint32>       m_Heads;     // First node of each slot, s_WHEELS * s_SLOTS
+  std::vector<LTimerHandle> m_Expired;   // Batch of the tick being run
+  Uint32                    m_FreeHead;
+  Uint32                    m_Time;      // Last millisecond run
+  size_t                    m_Pending;
+};
+
+#endif // LTIMERWHEEL_HPP
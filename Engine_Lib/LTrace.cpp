@@ -0,0 +1,396 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LTrace.hpp"
+#include "LRingBuffer.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const char   g_OPTION[]         = "--trace=";
+static const size_t g_WRITE_BATCH      = 256;   // Events popped at a time by the writer
+static const Uint32 g_WRITE_PERIOD_ms  = 5;     // Sleep of the writer when the queue is empty
+static const size_t g_MAX_THREADS      = 64;    // Thread names kept
+static const size_t g_NAME_LENGTH      = 32;
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+enum class Phase : char
+{
+  COMPLETE = 'X',
+  COUNTER  = 'C',
+  INSTANT  = 'i',
+  METADATA = 'M'
+};
+
+struct TraceEvent
+{
+  Phase        Type;
+  const char*  Name;
+  Uint64       Start;     // Performance counter
+  Uint64       Duration;  // Counter ticks, COMPLETE only
+  double       Value;     // COUNTER only
+  SDL_threadID Thread;
+};
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+// Created by the first "open" and never destroyed: a thread still inside a push when the trace is
+// closed never touches freed memory.
+static LMpmcRing<TraceEvent>* g_Queue_Ptr  = nullptr;
+
+static std::atomic<bool>   g_IsOpen(false);
+static std::atomic<bool>   g_IsStopping(false);
+static std::atomic<Uint32> g_Dropped(0);
+static SDL_Thread*         g_Writer_Ptr = nullptr;
+static FILE*               g_File_Ptr   = nullptr;
+static Uint64              g_Origin     = 0;      // Performance counter at "open", time zero of the trace
+static double              g_TicksPerMicrosecond = 1.0;
+
+// Names of the threads met so far, kept while the trace is closed too, so that a trace opened later
+// names the threads started before it
+static SDL_SpinLock        g_NamesLock  = 0;
+static char                g_ThreadNames[g_MAX_THREADS][g_NAME_LENGTH];
+static SDL_threadID        g_ThreadIDs[g_MAX_THREADS];
+static size_t              g_NumOfNames = 0;
+
+static thread_local bool   t_IsNamed    = false;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static void Push( Phase Type, const char* Name, Uint64 Start, Uint64 Duration, double Value )
+{
+  if ( !g_IsOpen.load( std::memory_order_acquire ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( !g_Queue_Ptr->push( TraceEvent{ Type, Name, Start, Duration, Value, SDL_ThreadID() } ) )
+  {
+    g_Dropped.fetch_add( 1, std::memory_order_relaxed );
+  }
+  else
+  {;}
+}
+
+
+static double ToMicroseconds( Uint64 Ticks )
+{
+  return static_cast<double>( Ticks ) / g_TicksPerMicrosecond;
+}
+
+
+static void WriteEvent( const TraceEvent& Event )
+{
+  const unsigned long Thread = static_cast<unsigned long>( Event.Thread );
+
+  // Events recorded before "open" (e.g. a zone opened just before it) start at zero
+  const Uint64 Start = ( Event.Start > g_Origin ) ? Event.Start - g_Origin : 0;
+
+  switch ( Event.Type )
+  {
+    case Phase::COMPLETE:
+      fprintf( g_File_Ptr, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+               Event.Name, Thread, ToMicroseconds( Start ), ToMicroseconds( Event.Duration ) );
+      break;
+
+    case Phase::COUNTER:
+      fprintf( g_File_Ptr, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"args\":{\"value\":%g}}",
+               Event.Name, Thread, ToMicroseconds( Start ), Event.Value );
+      break;
+
+    case Phase::INSTANT:
+      fprintf( g_File_Ptr, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f}",
+               Event.Name, Thread, ToMicroseconds( Start ) );
+      break;
+
+    case Phase::METADATA:
+      fprintf( g_File_Ptr, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+               Thread, Event.Name );
+      break;
+  }
+}
+
+
+/**
+ * @brief Writer thread: names the threads met so far, then streams the queue to the file until the
+ * trace is closed and the queue is empty.
+ **/
+static int SDLCALL Writer( void* )
+{
+  SDL_AtomicLock( &g_NamesLock );
+
+  for ( size_t i = 0; i != g_NumOfNames; ++i )
+  {
+    WriteEvent( TraceEvent{ Phase::METADATA, g_ThreadNames[i], 0, 0, 0.0, g_ThreadIDs[i] } );
+  }
+
+  SDL_AtomicUnlock( &g_NamesLock );
+
+  TraceEvent Batch[g_WRITE_BATCH];
+
+  for ( ;; )
+  {
+    // Read before popping: what was pushed before the trace closed is written before leaving
+    const bool   IsStopping = g_IsStopping.load( std::memory_order_acquire );
+    const size_t Popped     = g_Queue_Ptr->popBatch( Batch, g_WRITE_BATCH );
+
+    for ( size_t i = 0; i != Popped; ++i )
+    {
+      WriteEvent( Batch[i] );
+    }
+
+    if ( Popped == 0 )
+    {
+      if ( IsStopping )
+      {
+        break;
+      }
+      else
+      {;}
+
+      fflush( g_File_Ptr );
+      SDL_Delay( g_WRITE_PERIOD_ms );
+    }
+    else
+    {;}
+  }
+
+  return 0;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LTrace::Zone::Zone( const char* Name )
+  : m_Name(nullptr), m_Start(0)
+{
+  if ( LTrace::isOpen() )
+  {
+    m_Name  = Name;
+    m_Start = SDL_GetPerformanceCounter();
+  }
+  else
+  {;}
+}
+
+
+LTrace::Zone::~Zone( void )
+{
+  if ( m_Name != nullptr )
+  {
+    Push( Phase::COMPLETE, m_Name, m_Start, SDL_GetPerformanceCounter() - m_Start, 0.0 );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Opens the trace if the command line asks for it with "--trace=<file>".
+ *
+ * @return false if asked for but the file could not be opened; true otherwise.
+ **/
+bool LTrace::configure( int argc, char* argv[] )
+{
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], g_OPTION, sizeof(g_OPTION) - 1 ) == 0 )
+    {
+      return open( argv[i] + sizeof(g_OPTION) - 1 );
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Creates the trace file and starts the writer thread. Closes the trace already open, if any.
+ *
+ * @param Path The trace file, e.g. "Trace.json".
+ * @return true if recording.
+ **/
+bool LTrace::open( const char* Path )
+{
+  close();
+
+  g_File_Ptr = fopen( Path, "w" );
+
+  if ( g_File_Ptr == nullptr )
+  {
+    printf( "\nUnable to create the trace file \"%s\"!", Path );
+    return false;
+  }
+  else
+  {;}
+
+  if ( g_Queue_Ptr == nullptr )
+  {
+    g_Queue_Ptr = new LMpmcRing<TraceEvent>( s_QUEUE_SIZE );
+  }
+  else
+  {
+    // Events pushed while the last trace was closing belong to no trace
+    TraceEvent Stale;
+    while ( g_Queue_Ptr->pop( Stale ) ) {;}
+  }
+
+  // The array is left open at the end: the viewers accept it, and a crash leaves a valid trace
+  fprintf( g_File_Ptr, "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SDL2\"}}" );
+
+  g_Origin              = SDL_GetPerformanceCounter();
+  g_TicksPerMicrosecond = static_cast<double>( SDL_GetPerformanceFrequency() ) / 1e6;
+  g_Dropped.store( 0, std::memory_order_relaxed );
+  g_IsStopping.store( false, std::memory_order_relaxed );
+  g_IsOpen.store( true, std::memory_order_release );
+
+  g_Writer_Ptr = SDL_CreateThread( Writer, "LTrace", nullptr );
+
+  if ( g_Writer_Ptr == nullptr )
+  {
+    printf( "\nUnable to start the trace writer! SDL Error: %s", SDL_GetError() );
+
+    g_IsOpen.store( false, std::memory_order_release );
+    fclose( g_File_Ptr );
+    g_File_Ptr = nullptr;
+
+    return false;
+  }
+  else
+  {;}
+
+  printf( "\nTracing to \"%s\"", Path );
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the events still queued, stops the writer and closes the file.
+ **/
+void LTrace::close( void )
+{
+  if ( g_Writer_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  g_IsOpen.store( false, std::memory_order_release );
+  g_IsStopping.store( true, std::memory_order_release );
+  SDL_WaitThread( g_Writer_Ptr, nullptr );
+  g_Writer_Ptr = nullptr;
+
+  fprintf( g_File_Ptr, "\n]\n" );
+  fclose( g_File_Ptr );
+  g_File_Ptr = nullptr;
+
+  const Uint32 Dropped = g_Dropped.load( std::memory_order_relaxed );
+
+  if ( Dropped != 0 )
+  {
+    printf( "\nTrace: %u events dropped, the queue was full", static_cast<unsigned>( Dropped ) );
+  }
+  else
+  {;}
+}
+
+
+bool LTrace::isOpen( void )
+{
+  return g_IsOpen.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @brief Names the calling thread in the trace. Only the first call of each thread counts, so that
+ * a callback can call it every time it runs.
+ *
+ * @param Name Copied, up to 31 characters.
+ **/
+void LTrace::nameThread( const char* Name )
+{
+  if ( t_IsNamed )
+  {
+    return;
+  }
+  else
+  {;}
+
+  t_IsNamed = true;
+
+  const char* Stored_Ptr = nullptr;
+
+  SDL_AtomicLock( &g_NamesLock );
+
+  if ( g_NumOfNames != g_MAX_THREADS )
+  {
+    SDL_strlcpy( g_ThreadNames[g_NumOfNames], Name, g_NAME_LENGTH );
+    g_ThreadIDs[g_NumOfNames] = SDL_ThreadID();
+    Stored_Ptr = g_ThreadNames[g_NumOfNames];
+    ++g_NumOfNames;
+  }
+  else
+  {;}
+
+  SDL_AtomicUnlock( &g_NamesLock );
+
+  if ( Stored_Ptr != nullptr )
+  {
+    Push( Phase::METADATA, Stored_Ptr, 0, 0, 0.0 );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Plots a value, as a track of its own.
+ **/
+void LTrace::counter( const char* Name, double Value )
+{
+  Push( Phase::COUNTER, Name, SDL_GetPerformanceCounter(), 0, Value );
+}
+
+
+/**
+ * @brief Marks the start of a frame, as a line across every thread. Call it at the top of the main
+ * loop.
+ **/
+void LTrace::frameMark( void )
+{
+  Push( Phase::INSTANT, "Frame", SDL_GetPerformanceCounter(), 0, 0.0 );
+}
+
+
+/**
+ * @brief Events lost since "open" because the queue was full.
+ **/
+Uint32 LTrace::GetDropped( void )
+{
+  return g_Dropped.load( std::memory_order_relaxed );
+}
@@ -0,0 +1,72 @@
+/**
+ * @file LTrace.hpp
+ *
+ * @brief Timeline of every thread of a program (main loop, job workers, audio callback, input
+ * pump, autosave and asset threads) streamed to a Chrome trace file while the program runs.
+ **/
+
+#ifndef LTRACE_HPP
+#define LTRACE_HPP
+
+#include <SDL.h>
+
+/**
+ * @brief Trace events, with static functions only, so that any module and any thread can record
+ * without an object being passed around.
+ *
+ * "configure" opens the trace when the command line has "--trace=<file>"; "open" does the same
+ * with a path. From then on:
+ *   - a "Zone" times its scope, on the thread that created it;
+ *   - "nameThread" names the calling thread (the engine's threads name themselves with the name
+ *     they were created with);
+ *   - "counter" plots a value, e.g. the draw calls of the frame;
+ *   - "frameMark" marks the start of a frame of the main loop, across every thread.
+ * Events go into a lock-free queue, with no lock nor allocation, so that the audio callback can
+ * record too; a writer thread streams them to the file in the Chrome "trace_event" JSON format,
+ * which chrome://tracing and https://ui.perfetto.dev open. An event that finds the queue full is
+ * dropped and counted. The file is flushed whenever the queue is empty: a program that crashes
+ * leaves a trace that the viewers open all the same.
+ *
+ * While the trace is closed every call returns after one atomic load. Zone, counter and thread
+ * names must not contain '"' or '\', and the zone and counter names must live as long as the
+ * program (string literals). "close" stops the writer, and is called before SDL_Quit.
+ **/
+class LTrace
+{
+public:
+
+  static constexpr size_t s_QUEUE_SIZE = 65536;   // Events waiting for the writer
+
+  /**
+   * @brief Times its scope, from construction to destruction. A zone opened while the trace is
+   * closed records nothing.
+   **/
+  class Zone
+  {
+  public:
+
+    explicit Zone( const char* );
+            ~Zone( void );
+
+    Zone( const Zone& )            = delete;
+    Zone& operator=( const Zone& ) = delete;
+
+  private:
+
+    const char* m_Name;
+    Uint64      m_Start;
+  };
+
+  static bool   configure ( int, char* [] );
+  static bool   open      ( const char* );
+  static void   close     ( void );
+  static bool   isOpen    ( void );
+
+  static void   nameThread( const char* );
+  static void   counter   ( const char*, double );
+  static void   frameMark ( void );
+
+  static Uint32 GetDropped( void );
+};
+
+#endif // LTRACE_HPP
@@ -0,0 +1,90 @@
+/**
+ * @file LTripleBuffer.hpp
+ *
+ * @brief Hands the latest state from a producer thread to a consumer thread, neither ever waiting.
+ **/
+
+#ifndef LTRIPLEBUFFER_HPP
+#define LTRIPLEBUFFER_HPP
+
+#include <SDL.h>
+#include <atomic>
+
+/**
+ * @brief Three copies of a state: the producer fills the back one and publishes it, swapping it with
+ * the middle one, and the consumer swaps the middle one with its front one to read the latest state
+ * published. Each swap is a single atomic exchange, and there is always a buffer free for either
+ * side: a slow consumer skips states, a slow producer makes it read the same state again.
+ *
+ * Exactly one thread may use the back side (GetBack, publish) and one the front side (acquire,
+ * GetFront). The buffers keep their contents and capacity from turn to turn.
+ **/
+template <typename T>
+class LTripleBuffer
+{
+public:
+
+  LTripleBuffer( void )
+    : m_Front(0), m_Back(1), m_Middle(2)
+  {;}
+
+  LTripleBuffer( const LTripleBuffer& )            = delete;
+  LTripleBuffer& operator=( const LTripleBuffer& ) = delete;
+
+  /**
+   * @brief Producer only: the buffer to fill before "publish".
+   **/
+  T& GetBack( void )
+  {
+    return m_Buffers[m_Back];
+  }
+
+  /**
+   * @brief Producer only: makes the back buffer the latest state, and takes a free one as back.
+   **/
+  void publish( void )
+  {
+    const Uint8 Published = static_cast<Uint8>( m_Back | s_FRESH );
+
+    m_Back = static_cast<Uint8>( m_Middle.exchange( Published, std::memory_order_acq_rel ) & s_INDEX );
+  }
+
+  /**
+   * @brief Consumer only: moves to the latest state published, if it has not read it yet.
+   *
+   * @return true if the front buffer changed.
+   **/
+  bool acquire( void )
+  {
+    if ( ( m_Middle.load( std::memory_order_relaxed ) & s_FRESH ) == 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    m_Front = static_cast<Uint8>( m_Middle.exchange( m_Front, std::memory_order_acq_rel ) & s_INDEX );
+
+    return true;
+  }
+
+  /**
+   * @brief Consumer only: the state last acquired.
+   **/
+  T& GetFront( void )
+  {
+    return m_Buffers[m_Front];
+  }
+
+private:
+
+  static constexpr Uint8 s_INDEX = 0x03;
+  static constexpr Uint8 s_FRESH = 0x04;  // Set in m_Middle when it holds a state not yet acquired
+
+  T                              m_Buffers[3];
+  Uint8                          m_Front;    // Consumer's buffer
+  Uint8                          m_Back;     // Producer's buffer
+  alignas(64) std::atomic<Uint8> m_Middle;   // The buffer between the two, and s_FRESH
+};
+
+#endif // LTRIPLEBUFFER_HPP
@@ -0,0 +1,282 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LWindowManager.hpp"
+
+#include <algorithm>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LWindowManager::LWindowManager( void )
+  : m_Entries(), m_BackgroundPeriod_ms(0), m_Rendered(0), m_Skipped(0)
+{
+  setBackgroundRate( s_DEFAULT_BACKGROUND_RATE );
+}
+
+
+/**
+ * @brief Starts following a window, from the state it is in now; its first frame is rendered.
+ **/
+void LWindowManager::add( SDL_Window* Window_Ptr )
+{
+  if ( Window_Ptr == nullptr || Find_Pvt( Window_Ptr ) != nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint32 Flags = SDL_GetWindowFlags( Window_Ptr );
+  int          Width;
+  int          Height;
+
+  SDL_GetWindowSize( Window_Ptr, &Width, &Height );
+
+  m_Entries.push_back( Entry{ Window_Ptr, SDL_GetWindowID( Window_Ptr ),
+                              ( Flags & SDL_WINDOW_SHOWN ) != 0, ( Flags & SDL_WINDOW_MINIMIZED ) != 0,
+                              Width == 0 || Height == 0, ( Flags & SDL_WINDOW_INPUT_FOCUS ) != 0, true, 0 } );
+}
+
+
+/**
+ * @brief Stops following a window, before it is destroyed.
+ **/
+void LWindowManager::remove( SDL_Window* Window_Ptr )
+{
+  m_Entries.erase( std::remove_if( m_Entries.begin(), m_Entries.end(),
+                                   [Window_Ptr]( const Entry& Each ) { return Each.Window_Ptr == Window_Ptr; } ),
+                   m_Entries.end() );
+}
+
+
+/**
+ * @brief Call with every event; only the window events of the windows added are looked at.
+ **/
+void LWindowManager::handleEvent( const SDL_Event& Event )
+{
+  Entry* Entry_Ptr = ( Event.type == SDL_WINDOWEVENT ) ? Find_Pvt( Event.window.windowID ) : nullptr;
+
+  if ( Entry_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Entry& Window = *Entry_Ptr;
+
+  switch ( Event.window.event )
+  {
+    case SDL_WINDOWEVENT_SHOWN:
+      Window.IsShown = true;
+      Window.IsDirty = true;
+      break;
+
+    case SDL_WINDOWEVENT_HIDDEN:
+      Window.IsShown = false;
+      break;
+
+    case SDL_WINDOWEVENT_MINIMIZED:
+      Window.IsMinimized = true;
+      break;
+
+    case SDL_WINDOWEVENT_MAXIMIZED:
+    case SDL_WINDOWEVENT_RESTORED:
+      Window.IsMinimized = false;
+      Window.IsDirty     = true;
+      break;
+
+    case SDL_WINDOWEVENT_SIZE_CHANGED:
+      Window.IsEmpty = ( Event.window.data1 == 0 || Event.window.data2 == 0 );
+      Window.IsDirty = true;
+      break;
+
+    case SDL_WINDOWEVENT_EXPOSED:
+      Window.IsDirty = true;
+      break;
+
+    case SDL_WINDOWEVENT_FOCUS_GAINED:
+      Window.HasFocus = true;
+      break;
+
+    case SDL_WINDOWEVENT_FOCUS_LOST:
+      Window.HasFocus = false;
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+/**
+ * @brief Call once per frame for each window, and render and present it only if true: the window is
+ * then taken as rendered. A window not added is always rendered.
+ **/
+bool LWindowManager::shouldRender( SDL_Window* Window_Ptr )
+{
+  Entry* Entry_Ptr = Find_Pvt( SDL_GetWindowID( Window_Ptr ) );
+
+  if ( Entry_Ptr == nullptr )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  Entry&       Window = *Entry_Ptr;
+  const Uint64 Now_ms = SDL_GetTicks64();
+
+  if ( IsPaused_Pvt( Window )
+       || !( Window.IsDirty || Window.HasFocus || Now_ms - Window.LastRender_ms >= m_BackgroundPeriod_ms ) )
+  {
+    ++m_Skipped;
+    return false;
+  }
+  else
+  {;}
+
+  Window.IsDirty       = false;
+  Window.LastRender_ms = Now_ms;
+  ++m_Rendered;
+
+  return true;
+}
+
+
+/**
+ * @brief Takes the next event, as SDL_PollEvent, if a window needs a frame now; otherwise waits for
+ * one, until the next background frame is due, or for as long as it takes if every window is
+ * paused. The other events of the frame are then taken with SDL_PollEvent as usual.
+ *
+ * @return true if Event holds an event.
+ **/
+bool LWindowManager::waitEvent( SDL_Event& Event )
+{
+  const int Timeout_ms = GetIdleTimeout_ms();
+
+  if ( Timeout_ms == 0 )
+  {
+    return SDL_PollEvent( &Event ) != 0;
+  }
+  else if ( Timeout_ms < 0 )
+  {
+    return SDL_WaitEvent( &Event ) != 0;
+  }
+  else
+  {
+    return SDL_WaitEventTimeout( &Event, Timeout_ms ) != 0;
+  }
+}
+
+
+/**
+ * @brief Frames per second of the visible windows without the keyboard focus.
+ **/
+void LWindowManager::setBackgroundRate( double Rate )
+{
+  m_BackgroundPeriod_ms = ( Rate > 0.0 ) ? static_cast<Uint64>( 1000.0 / Rate ) : 0;
+}
+
+
+/**
+ * @return true if the window is hidden, minimised or zero-sized; false if it is not added.
+ **/
+bool LWindowManager::IsPaused( SDL_Window* Window_Ptr ) const
+{
+  const Entry* Entry_Ptr = Find_Pvt( Window_Ptr );
+
+  return Entry_Ptr != nullptr && IsPaused_Pvt( *Entry_Ptr );
+}
+
+
+/**
+ * @return 0 if a window needs a frame now, the milliseconds to the next background frame otherwise;
+ * -1 if every window is paused, and only an event can change that.
+ **/
+int LWindowManager::GetIdleTimeout_ms( void ) const
+{
+  const Uint64 Now_ms     = SDL_GetTicks64();
+  Sint64       Timeout_ms = -1;
+
+  for ( const Entry& Window : m_Entries )
+  {
+    if ( IsPaused_Pvt( Window ) )
+    {
+      continue;
+    }
+    else if ( Window.IsDirty || Window.HasFocus )
+    {
+      return 0;
+    }
+    else
+    {;}
+
+    const Uint64 Elapsed_ms = Now_ms - Window.LastRender_ms;
+    const Sint64 Left_ms    = ( Elapsed_ms < m_BackgroundPeriod_ms ) ? static_cast<Sint64>( m_BackgroundPeriod_ms - Elapsed_ms ) : 0;
+
+    Timeout_ms = ( Timeout_ms < 0 ) ? Left_ms : std::min( Timeout_ms, Left_ms );
+  }
+
+  return static_cast<int>( Timeout_ms );
+}
+
+
+/**
+ * @return Frames shouldRender allowed, over all the windows.
+ **/
+Uint64 LWindowManager::GetRendered( void ) const
+{
+  return m_Rendered;
+}
+
+
+/**
+ * @return Frames shouldRender refused, over all the windows.
+ **/
+Uint64 LWindowManager::GetSkipped( void ) const
+{
+  return m_Skipped;
+}
+
+
+LWindowManager::Entry* LWindowManager::Find_Pvt( Uint32 ID )
+{
+  for ( Entry& Window : m_Entries )
+  {
+    if ( Window.ID == ID )
+    {
+      return &Window;
+    }
+    else
+    {;}
+  }
+
+  return nullptr;
+}
+
+
+const LWindowManager::Entry* LWindowManager::Find_Pvt( SDL_Window* Window_Ptr ) const
+{
+  for ( const Entry& Window : m_Entries )
+  {
+    if ( Window.Window_Ptr == Window_Ptr )
+    {
+      return &Window;
+    }
+    else
+    {;}
+  }
+
+  return nullptr;
+}
+
+
+bool LWindowManager::IsPaused_Pvt( const Entry& Window )
+{
+  return !Window.IsShown || Window.IsMinimized || Window.IsEmpty;
+}
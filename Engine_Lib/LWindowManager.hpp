@@ -0,0 +1,73 @@
+/**
+ * @file LWindowManager.hpp
+ *
+ * @brief Decides which windows are worth a frame: none for the ones nobody can see, a few per second
+ * for the ones in the background.
+ **/
+
+#ifndef LWINDOWMANAGER_HPP
+#define LWINDOWMANAGER_HPP
+
+#include <SDL.h>
+#include <vector>
+
+/**
+ * @brief Follows the window events of the windows added to it, and tells the main loop which of
+ * them to render this time round:
+ * - a hidden, minimised or zero-sized window is not rendered nor presented at all; SDL 2 reports no
+ *   other occlusion, so a window covered by others counts as visible;
+ * - the window with the keyboard focus is rendered every frame;
+ * - the other visible ones at the background rate;
+ * - any visible window whose contents were lost (exposed, resized, restored, shown) on the next
+ *   frame, whatever its rate.
+ *
+ * "waitEvent" takes the place of the first SDL_PollEvent of a frame: when no window needs a frame
+ * now, it sleeps until one does or an event arrives, instead of spinning the loop.
+ **/
+class LWindowManager
+{
+public:
+
+  LWindowManager( void );
+
+  void   add              ( SDL_Window* );
+  void   remove           ( SDL_Window* );
+  void   handleEvent      ( const SDL_Event& );
+
+  bool   shouldRender     ( SDL_Window* );
+  bool   waitEvent        ( SDL_Event& );
+
+  void   setBackgroundRate( double );
+
+  bool   IsPaused         ( SDL_Window* ) const;
+  int    GetIdleTimeout_ms( void ) const;
+  Uint64 GetRendered      ( void ) const;
+  Uint64 GetSkipped       ( void ) const;
+
+private:
+
+  static constexpr double s_DEFAULT_BACKGROUND_RATE = 10.0;
+
+  struct Entry
+  {
+    SDL_Window* Window_Ptr;
+    Uint32      ID;
+    bool        IsShown;
+    bool        IsMinimized;
+    bool        IsEmpty;        // Zero width or height
+    bool        HasFocus;       // Keyboard focus
+    bool        IsDirty;        // Contents lost: render on the next frame
+    Uint64      LastRender_ms;
+  };
+
+  Entry*       Find_Pvt    ( Uint32 );
+  const Entry* Find_Pvt    ( SDL_Window* ) const;
+  static bool  IsPaused_Pvt( const Entry& );
+
+  std::vector<Entry> m_Entries;
+  Uint64             m_BackgroundPeriod_ms;
+  Uint64             m_Rendered;
+  Uint64             m_Skipped;
+};
+
+#endif // LWINDOWMANAGER_HPP
@@ -0,0 +1,541 @@
+/**
+ * @file BakeTextures.cpp
+ *
+ * @brief Offline asset bake: converts images into ".ltx" files that LTexture loads by mapping them
+ * and uploading the pixels as they are, compresses them for the GPU, and measures the glyphs of
+ * bitmap fonts.
+ *
+ * Usage:
+ *   BakeTextures [--format=<name>] [--no-colour-key] [--glyphs] [--mips] [--compress=<family>] <image>...
+ *   BakeTextures --list
+ *
+ * Every <image> is written to "<image>.ltx", next to it, so that LTexture::loadFromFile picks the
+ * baked copy up without changing the call sites. The colour key (cyan, as in loadFromFile) becomes
+ * transparency at bake time. <name> is one of the 32-bit formats below, without the
+ * "SDL_PIXELFORMAT_" prefix, and must match the renderer's native format: "--list" prints the
+ * formats the renderers of this machine support, native one first.
+ *
+ * With "--mips", the smaller levels of the mip chain follow the image in the file, each half the
+ * size of the previous one, down to LBAKED_TEXTURE_MAX_LEVELS levels or a side of 1 pixel: the
+ * textures drawn smaller than they are (LTexture::renderScaled) then sample a level near the size
+ * they are drawn at, instead of skipping texels of the full image. They cost a third more memory.
+ *
+ * With "--compress", the image is also block compressed to "<image>.ltc" (LBakedBlocksHeader), with
+ * its mip chain if "--mips": <family> is "bc" for desktop GPUs or "etc2" for OpenGL ES ones. The
+ * format of each image follows its alpha: BC1 or ETC2_RGB when it is opaque, BC1 (punch-through) or
+ * ETC2_RGBA when it is only transparent or opaque, as the colour keyed sprites, BC3 or ETC2_RGBA when
+ * it blends. The ".ltx" is still written: renderers that cannot sample the format fall back to it.
+ *
+ * With "--glyphs", the images are bitmap font sheets: the clip rectangles and spacing of their
+ * glyphs are also written to "<image>.glyphs", which LoadGlyphMetrics reads instead of measuring
+ * the sheet at startup.
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LBakedTexture.hpp"
+#include "LBlockCompress.hpp"
+#include "LGlyphMetrics.hpp"
+#include "LPixelOps.hpp"
+#include "colours.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const Uint32 BakeableFormats[] =
+{
+  SDL_PIXELFORMAT_ARGB8888, // Direct3D, OpenGL and software renderers
+  SDL_PIXELFORMAT_ABGR8888, // OpenGL ES
+  SDL_PIXELFORMAT_RGBA8888,
+  SDL_PIXELFORMAT_BGRA8888,
+};
+
+static const char  FormatPrefix[]   = "SDL_PIXELFORMAT_";
+static const int   BYTES_PER_PIXEL  = 4;
+
+// GPU formats "--compress" can write; None writes no ".ltc"
+enum class CompressFamily { None, BC, ETC2 };
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Looks up a format by its short name, e.g. "ARGB8888".
+ *
+ * @return SDL_PIXELFORMAT_UNKNOWN if the name is not one of BakeableFormats.
+ **/
+static Uint32 parseFormat( const char* Name )
+{
+  for ( Uint32 Format : BakeableFormats )
+  {
+    const char* FullName = SDL_GetPixelFormatName( Format );
+
+    if ( strcmp( FullName + strlen( FormatPrefix ), Name ) == 0 )
+    {
+      return Format;
+    }
+    else
+    {;}
+  }
+
+  return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+
+/**
+ * @brief Prints the texture formats of every render driver available on this machine.
+ **/
+static int listFormats( void )
+{
+  SDL_Window* Window = SDL_CreateWindow( "BakeTextures", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 16, 16, SDL_WINDOW_HIDDEN );
+
+  if ( Window == NULL )
+  {
+    printf( "\nUnable to create a window! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  for ( int Driver = 0; Driver != SDL_GetNumRenderDrivers(); ++Driver )
+  {
+    SDL_Renderer* Renderer = SDL_CreateRenderer( Window, Driver, 0 );
+    SDL_RendererInfo Info;
+
+    if ( Renderer != NULL && SDL_GetRendererInfo( Renderer, &Info ) == 0 )
+    {
+      printf( "%s:", Info.name );
+
+      for ( Uint32 i = 0; i != Info.num_texture_formats; ++i )
+      {
+        printf( " %s", SDL_GetPixelFormatName( Info.texture_formats[i] ) + strlen( FormatPrefix ) );
+      }
+
+      printf( "\n" );
+    }
+    else
+    {;}
+
+    if ( Renderer != NULL )
+    {
+      SDL_DestroyRenderer( Renderer );
+    }
+    else
+    {;}
+  }
+
+  SDL_DestroyWindow( Window );
+
+  return 0;
+}
+
+
+/**
+ * @brief Measures the glyphs of a bitmap font sheet, before its colour key is applied.
+ *
+ * @return true if "<Path>.glyphs" was written.
+ **/
+static bool bakeGlyphs( const std::string& Path, SDL_Surface* Sheet )
+{
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Sheet, SDL_PIXELFORMAT_ARGB8888, 0 );
+
+  if ( Converted == NULL )
+  {
+    printf( "\nUnable to convert \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const std::string OutputPath = Path + LBAKED_GLYPHS_EXTENSION;
+  LGlyphMetrics     Metrics;
+
+  SDL_LockSurface( Converted );
+  bool Success = ComputeGlyphMetrics( static_cast<const Uint32*>( Converted->pixels ), Converted->pitch,
+                                      Converted->w, Converted->h, Metrics );
+  SDL_UnlockSurface( Converted );
+  SDL_FreeSurface( Converted );
+
+  Success = Success && SaveGlyphMetrics( OutputPath, Metrics );
+
+  if ( Success )
+  {
+    printf( "%s -> %s (space %d, new line %d)\n", Path.c_str(), OutputPath.c_str(), Metrics.Space, Metrics.NewLine );
+  }
+  else
+  {;}
+
+  return Success;
+}
+
+
+/**
+ * @brief Picks the block format of an image of the family from its alpha.
+ **/
+static LBlockFormat chooseBlockFormat( const SDL_Surface* Image, CompressFamily Family )
+{
+  bool IsOpaque = true;
+  bool IsBinary = true;
+
+  for ( int y = 0; y != Image->h; ++y )
+  {
+    const Uint8* Pixel = static_cast<const Uint8*>( Image->pixels ) + y * Image->pitch;
+
+    for ( int x = 0; x != Image->w; ++x, Pixel += BYTES_PER_PIXEL )
+    {
+      IsOpaque = IsOpaque && Pixel[3] == 255;
+      IsBinary = IsBinary && ( Pixel[3] == 255 || Pixel[3] == 0 );
+    }
+  }
+
+  if ( Family == CompressFamily::BC )
+  {
+    return IsBinary ? LBlockFormat::BC1 : LBlockFormat::BC3;
+  }
+  else
+  {
+    return IsOpaque ? LBlockFormat::ETC2_RGB : LBlockFormat::ETC2_RGBA;
+  }
+}
+
+
+/**
+ * @brief Writes the blocks of every level of an image, from the full size down.
+ *
+ * @param Image  Colour key already applied; converted to RGBA32 here for the encoders.
+ * @return true if "<Path>.ltc" was written.
+ **/
+static bool bakeBlocks( const std::string& Path, SDL_Surface* Image, Uint32 Levels, CompressFamily Family )
+{
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Image, SDL_PIXELFORMAT_RGBA32, 0 );
+
+  if ( Converted == NULL )
+  {
+    printf( "\nUnable to convert \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const std::string OutputPath = Path + LBAKED_BLOCKS_EXTENSION;
+  SDL_RWops* Output = SDL_RWFromFile( OutputPath.c_str(), "wb" );
+
+  LBakedBlocksHeader Header;
+  memcpy( Header.Magic, LBAKED_BLOCKS_MAGIC, sizeof(Header.Magic) );
+  Header.Version = LBAKED_BLOCKS_VERSION;
+  Header.Format  = static_cast<Uint32>( chooseBlockFormat( Converted, Family ) );
+  Header.Width   = Converted->w;
+  Header.Height  = Converted->h;
+  Header.Levels  = Levels;
+
+  const LBlockFormat  BlockFormat = static_cast<LBlockFormat>( Header.Format );
+  bool                Success     = ( Output != NULL ) && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1;
+  std::vector<Uint8>  Blocks;
+  std::vector<Uint32> Previous;
+  std::vector<Uint32> Level;
+  const void*         Source_Ptr  = Converted->pixels;
+  int                 SourcePitch = Converted->pitch;
+  size_t              Bytes       = 0;
+
+  for ( Uint32 i = 0; Success && i != Header.Levels; ++i )
+  {
+    const SDL_Point Size = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) );
+
+    if ( i != 0 )
+    {
+      const SDL_Point SourceSize = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) - 1 );
+
+      Level.resize( static_cast<size_t>( Size.x ) * static_cast<size_t>( Size.y ) );
+      Success = HalvePixels( Source_Ptr, SourceSize.x, SourceSize.y, SourcePitch, Level.data(), Size.x * BYTES_PER_PIXEL,
+                             SDL_PIXELFORMAT_RGBA32 );
+      Previous.swap( Level );
+      Source_Ptr  = Previous.data();
+      SourcePitch = Size.x * BYTES_PER_PIXEL;
+    }
+    else
+    {;}
+
+    Blocks.resize( GetCompressedSize( BlockFormat, Size.x, Size.y ) );
+    Success = Success && CompressBlocks( Source_Ptr, Size.x, Size.y, SourcePitch, BlockFormat, Blocks.data() )
+              && SDL_RWwrite( Output, Blocks.data(), Blocks.size(), 1 ) == 1;
+    Bytes  += Blocks.size();
+  }
+
+  if ( Output != NULL )
+  {
+    Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+  }
+  else
+  {;}
+
+  if ( Success )
+  {
+    printf( "%s -> %s (%s, %u levels, %u bytes)\n", Path.c_str(), OutputPath.c_str(), GetBlockFormatName( BlockFormat ),
+            Header.Levels, static_cast<unsigned>( Bytes ) );
+  }
+  else
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", OutputPath.c_str(), SDL_GetError() );
+  }
+
+  SDL_FreeSurface( Converted );
+
+  return Success;
+}
+
+
+/**
+ * @brief Bakes one image.
+ *
+ * @return true if "<Path>.ltx" was written, "<Path>.glyphs" if Glyphs and "<Path>.ltc" if Family is
+ * not None.
+ **/
+static bool bakeImage( const std::string& Path, Uint32 Format, bool ColourKey, bool Glyphs, bool Mips, CompressFamily Family )
+{
+  SDL_Surface* Loaded = IMG_Load( Path.c_str() );
+
+  if ( Loaded == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  if ( Glyphs && !bakeGlyphs( Path, Loaded ) )
+  {
+    SDL_FreeSurface( Loaded );
+    return false;
+  }
+  else
+  {;}
+
+  if ( ColourKey )
+  {
+    SDL_SetColorKey( Loaded, SDL_TRUE, SDL_MapRGB( Loaded->format, CYAN_R, CYAN_G, CYAN_B ) );
+  }
+  else
+  {;}
+
+  // Converting a colour keyed surface to a format with alpha turns the key into transparency
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Loaded, Format, 0 );
+  SDL_FreeSurface( Loaded );
+
+  if ( Converted == NULL )
+  {
+    printf( "\nUnable to convert \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const std::string OutputPath = Path + LBAKED_TEXTURE_EXTENSION;
+  SDL_RWops* Output = SDL_RWFromFile( OutputPath.c_str(), "wb" );
+
+  LBakedTextureHeader Header;
+  memcpy( Header.Magic, LBAKED_TEXTURE_MAGIC, sizeof(Header.Magic) );
+  Header.Version = LBAKED_TEXTURE_VERSION;
+  Header.Format  = Format;
+  Header.Width   = Converted->w;
+  Header.Height  = Converted->h;
+  Header.Pitch   = Converted->w * BYTES_PER_PIXEL;
+  Header.Levels  = 1;
+
+  // Every level halves the previous one, until a side is 1 pixel
+  while ( Mips && Header.Levels != LBAKED_TEXTURE_MAX_LEVELS && ( Header.Width >> Header.Levels ) != 0
+          && ( Header.Height >> Header.Levels ) != 0 )
+  {
+    ++Header.Levels;
+  }
+
+  Header.Reserved = 0;
+
+  bool Success = ( Output != NULL ) && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1;
+
+  // The surface rows may be padded: write them tightly packed
+  const Uint8* Row = static_cast<const Uint8*>( Converted->pixels );
+
+  for ( int y = 0; Success && y != Converted->h; ++y )
+  {
+    Success = SDL_RWwrite( Output, Row, static_cast<size_t>( Header.Pitch ), 1 ) == 1;
+    Row += Converted->pitch;
+  }
+
+  // The smaller levels, each halved from the one before: the first from the surface
+  std::vector<Uint32> Previous;
+  std::vector<Uint32> Level;
+  const void*         Source_Ptr  = Converted->pixels;
+  int                 SourcePitch = Converted->pitch;
+
+  for ( Uint32 i = 1; Success && i != Header.Levels; ++i )
+  {
+    const SDL_Point SourceSize = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) - 1 );
+    const SDL_Point Size       = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) );
+
+    Level.resize( static_cast<size_t>( Size.x ) * static_cast<size_t>( Size.y ) );
+
+    Success = HalvePixels( Source_Ptr, SourceSize.x, SourceSize.y, SourcePitch, Level.data(), Size.x * BYTES_PER_PIXEL, Format )
+              && SDL_RWwrite( Output, Level.data(), Level.size() * sizeof(Uint32), 1 ) == 1;
+
+    Previous.swap( Level );
+    Source_Ptr  = Previous.data();
+    SourcePitch = Size.x * BYTES_PER_PIXEL;
+  }
+
+  if ( Output != NULL )
+  {
+    Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+  }
+  else
+  {;}
+
+  if ( Success )
+  {
+    printf( "%s -> %s (%dx%d, %s, %u levels)\n", Path.c_str(), OutputPath.c_str(), Header.Width, Header.Height,
+            SDL_GetPixelFormatName( Format ), Header.Levels );
+  }
+  else
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", OutputPath.c_str(), SDL_GetError() );
+  }
+
+  if ( Success && Family != CompressFamily::None )
+  {
+    Success = bakeBlocks( Path, Converted, Header.Levels, Family );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Converted );
+
+  return Success;
+}
+
+
+/***************************************************************************************************
+* Main
+****************************************************************************************************/
+
+int main( int argc, char* argv[] )
+{
+  Uint32 Format    = SDL_PIXELFORMAT_ARGB8888;
+  bool   ColourKey = true;
+  bool   List      = false;
+  bool   Glyphs    = false;
+  bool   Mips      = false;
+  int    Failures  = 0;
+  int    Images    = 0;
+
+  CompressFamily Family = CompressFamily::None;
+
+  static const char FormatOption[]   = "--format=";
+  static const char CompressOption[] = "--compress=";
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], FormatOption, strlen( FormatOption ) ) == 0 )
+    {
+      Format = parseFormat( argv[i] + strlen( FormatOption ) );
+
+      if ( Format == SDL_PIXELFORMAT_UNKNOWN )
+      {
+        printf( "\nUnsupported format \"%s\"!\n", argv[i] + strlen( FormatOption ) );
+        return 1;
+      }
+      else
+      {;}
+    }
+    else if ( strcmp( argv[i], "--no-colour-key" ) == 0 )
+    {
+      ColourKey = false;
+    }
+    else if ( strcmp( argv[i], "--glyphs" ) == 0 )
+    {
+      Glyphs = true;
+    }
+    else if ( strcmp( argv[i], "--mips" ) == 0 )
+    {
+      Mips = true;
+    }
+    else if ( strncmp( argv[i], CompressOption, strlen( CompressOption ) ) == 0 )
+    {
+      const char* Name = argv[i] + strlen( CompressOption );
+
+      if ( strcmp( Name, "bc" ) == 0 )
+      {
+        Family = CompressFamily::BC;
+      }
+      else if ( strcmp( Name, "etc2" ) == 0 )
+      {
+        Family = CompressFamily::ETC2;
+      }
+      else
+      {
+        printf( "\nUnsupported compression \"%s\"!\n", Name );
+        return 1;
+      }
+    }
+    else if ( strcmp( argv[i], "--list" ) == 0 )
+    {
+      List = true;
+    }
+    else
+    {;} // An image: baked below, once all the options are known
+  }
+
+  if ( SDL_Init( List ? SDL_INIT_VIDEO : 0 ) < 0 )
+  {
+    printf( "\nSDL could not initialize! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  if ( List )
+  {
+    const int Result = listFormats();
+    SDL_Quit();
+    return Result;
+  }
+  else
+  {;}
+
+  IMG_Init( IMG_INIT_PNG | IMG_INIT_JPG );
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], "--", 2 ) != 0 )
+    {
+      ++Images;
+      Failures += bakeImage( argv[i], Format, ColourKey, Glyphs, Mips, Family ) ? 0 : 1;
+    }
+    else
+    {;}
+  }
+
+  if ( Images == 0 )
+  {
+    printf( "Usage: BakeTextures [--format=<name>] [--no-colour-key] [--glyphs] [--mips] [--compress=bc|etc2] <image>...\n"
+            "       BakeTextures --list\n" );
+  }
+  else
+  {;}
+
+  IMG_Quit();
+  SDL_Quit();
+
+  return ( Failures == 0 && Images != 0 ) ? 0 : 1;
+}
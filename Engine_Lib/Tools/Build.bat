@@ -0,0 +1,135 @@
+@echo off
+
+cls
+echo.
+
+@REM Set temporary environment variables
+set SDL2_PROJECT_NAME=BakeTextures
+set SDL2_PACK_PROJECT_NAME=PackAssets
+set SDL2_ATLAS_PROJECT_NAME=PackAtlas
+set SDL2_SLICE_PROJECT_NAME=SliceChunks
+set SDL2_BENCH_PROJECT_NAME=EngineBench
+set SDL2_SWEEP_PROJECT_NAME=SceneBench
+
+@REM Source files
+set SOURCE_FILES=BakeTextures.cpp
+set PACK_SOURCE_FILES=PackAssets.cpp
+set ATLAS_SOURCE_FILES=PackAtlas.cpp
+set SLICE_SOURCE_FILES=SliceChunks.cpp
+set BENCH_SOURCE_FILES=EngineBench.cpp
+set SWEEP_SOURCE_FILES=SceneBench.cpp
+
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..
+set COLOURS_LIB_INCLUDE_PATH=..\..\Colours_Lib
+
+@REM Static libraries
+set SDL2_LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
+set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
+set SDL2_TTF_LIB_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\lib\
+set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% -L%ENGINE_LIB_PATH%
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2 -lSDL2_image
+@REM Only EngineBench and SceneBench render text
+set BENCH_LIB_PATHS=%SDL2_LIB_PATHS% -L%SDL2_TTF_LIB_PATH%
+set BENCH_LIBRARIES=%SDL2_LIBRARIES% -lSDL2_ttf
+
+@REM Header files
+set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
+set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
+set SDL2_TTF_INCLUDE_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\include\SDL2
+set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%ENGINE_LIB_PATH% -I%COLOURS_LIB_INCLUDE_PATH%
+set BENCH_INCLUDE_PATHS=%SDL2_INCLUDE_PATHS% -I%SDL2_TTF_INCLUDE_PATH%
+
+@REM C++ compilation options
+set COMPILATION_OPTIONS=-O2 -Wall -Wextra -Wpedantic -Wconversion
+
+
+if %1.==-c. goto Clean
+
+
+@REM Build executable
+if exist %SDL2_PROJECT_NAME%.exe (
+  echo %SDL2_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+if exist %SDL2_PACK_PROJECT_NAME%.exe (
+  echo %SDL2_PACK_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_PACK_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+if exist %SDL2_ATLAS_PROJECT_NAME%.exe (
+  echo %SDL2_ATLAS_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_ATLAS_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+if exist %SDL2_SLICE_PROJECT_NAME%.exe (
+  echo %SDL2_SLICE_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_SLICE_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+if exist %SDL2_BENCH_PROJECT_NAME%.exe (
+  echo %SDL2_BENCH_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_BENCH_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+if exist %SDL2_SWEEP_PROJECT_NAME%.exe (
+  echo %SDL2_SWEEP_PROJECT_NAME%.exe already exists. Deleting...
+  echo.
+  del %SDL2_SWEEP_PROJECT_NAME%.exe
+) else (
+  echo.
+)
+
+
+echo Building executable...
+echo.
+
+echo on
+g++ %COMPILATION_OPTIONS% %SOURCE_FILES% %SDL2_INCLUDE_PATHS% %SDL2_LIB_PATHS% %SDL2_LIBRARIES% -o %SDL2_PROJECT_NAME%.exe
+@if %ERRORLEVEL% EQU 0 g++ %COMPILATION_OPTIONS% %PACK_SOURCE_FILES% %SDL2_INCLUDE_PATHS% %SDL2_LIB_PATHS% %SDL2_LIBRARIES% -o %SDL2_PACK_PROJECT_NAME%.exe
+@if %ERRORLEVEL% EQU 0 g++ %COMPILATION_OPTIONS% %ATLAS_SOURCE_FILES% %SDL2_INCLUDE_PATHS% %SDL2_LIB_PATHS% %SDL2_LIBRARIES% -o %SDL2_ATLAS_PROJECT_NAME%.exe
+@if %ERRORLEVEL% EQU 0 g++ %COMPILATION_OPTIONS% %SLICE_SOURCE_FILES% %SDL2_INCLUDE_PATHS% %SDL2_LIB_PATHS% %SDL2_LIBRARIES% -o %SDL2_SLICE_PROJECT_NAME%.exe
+@if %ERRORLEVEL% EQU 0 g++ %COMPILATION_OPTIONS% %BENCH_SOURCE_FILES% %BENCH_INCLUDE_PATHS% %BENCH_LIB_PATHS% %BENCH_LIBRARIES% -o %SDL2_BENCH_PROJECT_NAME%.exe
+@if %ERRORLEVEL% EQU 0 g++ %COMPILATION_OPTIONS% %SWEEP_SOURCE_FILES% %BENCH_INCLUDE_PATHS% %BENCH_LIB_PATHS% %BENCH_LIBRARIES% -o %SDL2_SWEEP_PROJECT_NAME%.exe
+echo off
+
+IF %ERRORLEVEL% EQU 0 (
+  echo.
+  echo [32mCompilation was successful![0m
+  echo.
+) else (
+  echo.
+  echo [31m*** Error ***[0m
+  echo.
+  echo Compilation errors were encountered.
+)
+exit /b
+
+
+:Clean
+  echo Cleaning artifacts...
+  echo.
+  del %SDL2_PROJECT_NAME%.exe
+  del %SDL2_PACK_PROJECT_NAME%.exe
+  del %SDL2_ATLAS_PROJECT_NAME%.exe
+  del %SDL2_SLICE_PROJECT_NAME%.exe
+  del %SDL2_BENCH_PROJECT_NAME%.exe
+  del %SDL2_SWEEP_PROJECT_NAME%.exe
+  echo Done.
+  echo.
\ No newline at end of file
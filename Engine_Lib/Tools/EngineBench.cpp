@@ -0,0 +1,718 @@
+/**
+ * @file EngineBench.cpp
+ *
+ * @brief Microbenchmarks of the engine library: texture rendering, text rendering and the collision
+ * tests of LCollision. It runs headless, rendering with SDL's software renderer into a surface, so
+ * that it needs no window nor GPU, and writes its results as JSON to be compared between releases.
+ *
+ * Usage:
+ *   EngineBench [--filter=<text>] [--min-time=<s>] [--repetitions=<n>] [--font=<ttf>] [--json=<file>]
+ *
+ * Every case whose name contains <text> (all by default) is run for at least <s> seconds (0.5 by
+ * default), <n> times (1 by default); the number of iterations grows until a run lasts that long.
+ * The table is printed on the console; <file> receives the same results in the JSON layout of
+ * Google Benchmark ("context" and "benchmarks", times per iteration in nanoseconds), so that its
+ * comparison scripts work on two files. With more than one repetition the median of each case is
+ * added as an "aggregate" entry. The text cases need a TrueType font and are skipped without
+ * --font.
+ *
+ * The collision cases are the tests used by 27 (boxes), 28 (box sets, packed boxes and pixel masks)
+ * and 29 (circles), plus the sweep test and the broad phases. The tile lookup of 39, the particles
+ * of 38 and the ball of Pallina are written inside those programs, not in the library, so they are
+ * not here; Pallina times its own simulation headless with --replay.
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "LTexture.hpp"
+#include "LCollision.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const int    TARGET_W         = 1024;  // Surface the software renderer draws into
+static const int    TARGET_H         = 768;
+static const int    SPRITE_SIZE      = 64;
+static const int    DOT_SIZE         = 20;    // The dot of 27, 28 and 29
+static const int    FONT_SIZE        = 28;
+static const size_t NUM_OF_INPUTS    = 1024;  // Inputs cycled through, a power of two
+static const size_t INPUT_MASK       = NUM_OF_INPUTS - 1;
+static const int    BROAD_COLLIDERS  = 256;
+static const int    GRID_BOXES       = 4096;
+static const int    GRID_WORLD       = 8192;
+static const int    GRID_CELL        = 128;
+static const double DEFAULT_MIN_TIME = 0.5;
+static const size_t MAX_ITERATIONS   = 1000000000;
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+typedef void (*BenchFunction)( size_t );
+
+/**
+ * @brief A benchmark: runs its operation the given number of times.
+ **/
+struct BenchCase
+{
+  const char*   Name;
+  BenchFunction Function;
+  bool          NeedsFont;
+};
+
+/**
+ * @brief One timed run of a case. Times are per iteration.
+ **/
+struct BenchResult
+{
+  std::string Name;
+  size_t      Iterations;
+  double      RealTime_ns;
+  double      CpuTime_ns;
+};
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+static volatile size_t g_Sink = 0; // Results are stored here, so that the work is not optimised away
+
+static SDL_Surface*  g_Target   = NULL;
+static SDL_Renderer* g_Renderer = NULL;
+static TTF_Font*     g_Font     = NULL;
+
+static LTexture g_Sprite;
+static LTexture g_Text;
+
+// Inputs, generated once with a fixed seed so that every run and release sees the same ones
+static std::vector<SDL_Point> g_Points;
+static std::vector<SDL_Rect>  g_Rects;
+static std::vector<LCircle>   g_Circles;
+static std::vector<SDL_Point> g_Offsets;     // Of a dot from another, from well apart to overlapping
+static std::vector<SDL_Rect>  g_Cameras;
+
+static std::vector<SDL_Rect>  g_DotColliders; // The per-pixel boxes of 28's dot, at the origin
+static std::vector<std::vector<SDL_Rect>> g_MovedColliders; // The same boxes at each offset
+static LPackedRects           g_DotPacked;
+static LCollisionMask         g_DotMask;
+
+static LBroadPhase            g_BroadPhase;
+static LSpatialGrid           g_Grid( SDL_Rect{ 0, 0, GRID_WORLD, GRID_WORLD }, GRID_CELL );
+static std::vector<int>       g_Found;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return a pseudo-random number: the same sequence at every run, on every platform.
+ **/
+static Uint32 nextRandom( void )
+{
+  static Uint32 s_State = 12345u;
+
+  s_State = s_State * 1664525u + 1013904223u;
+
+  return s_State >> 8;
+}
+
+
+static int randomIn( int Min, int Max )
+{
+  return Min + static_cast<int>( nextRandom() % static_cast<Uint32>( Max - Min + 1 ) );
+}
+
+
+/**
+ * @brief A filled circle of DOT_SIZE pixels, transparent around it, as 28's dot image.
+ **/
+static SDL_Surface* createDotSurface( void )
+{
+  SDL_Surface* Dot = SDL_CreateRGBSurfaceWithFormat( 0, DOT_SIZE, DOT_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+
+  if ( Dot == NULL )
+  {
+    return NULL;
+  }
+  else
+  {;}
+
+  const int Radius = DOT_SIZE / 2;
+
+  for ( int y = 0; y != DOT_SIZE; ++y )
+  {
+    Uint32* Row = reinterpret_cast<Uint32*>( static_cast<Uint8*>( Dot->pixels ) + y * Dot->pitch );
+
+    for ( int x = 0; x != DOT_SIZE; ++x )
+    {
+      const int Dx = 2 * x + 1 - DOT_SIZE;
+      const int Dy = 2 * y + 1 - DOT_SIZE;
+
+      Row[x] = ( Dx * Dx + Dy * Dy <= 4 * Radius * Radius ) ? 0xFFFF0000u : 0x00000000u;
+    }
+  }
+
+  return Dot;
+}
+
+
+/**
+ * @brief Prepares the renderer, the textures and the inputs of every case.
+ **/
+static bool setUp( const char* FontPath )
+{
+  g_Target = SDL_CreateRGBSurfaceWithFormat( 0, TARGET_W, TARGET_H, 32, SDL_PIXELFORMAT_ARGB8888 );
+
+  if ( g_Target == NULL || ( g_Renderer = SDL_CreateSoftwareRenderer( g_Target ) ) == NULL )
+  {
+    printf( "\nUnable to create the software renderer! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  LTexture::SetDefaultRenderer( g_Renderer );
+
+  SDL_Surface* Sprite = SDL_CreateRGBSurfaceWithFormat( 0, SPRITE_SIZE, SPRITE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+  SDL_Surface* Dot    = createDotSurface();
+
+  const bool AreTexturesLoaded = ( Sprite != NULL && SDL_FillRect( Sprite, NULL, 0xFF3080C0u ) == 0 && g_Sprite.loadFromSurface( Sprite ) &&
+                                   Dot    != NULL && g_DotMask.loadFromSurface( Dot ) );
+
+  SDL_FreeSurface( Sprite );
+  SDL_FreeSurface( Dot );
+
+  if ( !AreTexturesLoaded )
+  {
+    printf( "\nUnable to create the test images! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  if ( FontPath != NULL && ( g_Font = TTF_OpenFont( FontPath, FONT_SIZE ) ) == NULL )
+  {
+    printf( "\nUnable to open \"%s\"! SDL_ttf Error: %s", FontPath, TTF_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  for ( size_t i = 0; i != NUM_OF_INPUTS; ++i )
+  {
+    g_Points .push_back( SDL_Point{ randomIn( -SPRITE_SIZE / 2, TARGET_W - SPRITE_SIZE / 2 ), randomIn( -SPRITE_SIZE / 2, TARGET_H - SPRITE_SIZE / 2 ) } );
+    g_Rects  .push_back( SDL_Rect { randomIn( 0, 200 ), randomIn( 0, 200 ), randomIn( 4, 40 ), randomIn( 4, 40 ) } );
+    g_Circles.push_back( LCircle  { randomIn( 0, 200 ), randomIn( 0, 200 ), randomIn( 2, 20 ) } );
+    g_Offsets.push_back( SDL_Point{ randomIn( -DOT_SIZE - 4, DOT_SIZE + 4 ), randomIn( -DOT_SIZE - 4, DOT_SIZE + 4 ) } );
+    g_Cameras.push_back( SDL_Rect { randomIn( 0, GRID_WORLD - 640 ), randomIn( 0, GRID_WORLD - 480 ), 640, 480 } );
+  }
+
+  // One box per row of the dot's opaque pixels, as 28 builds them
+  for ( int y = 0; y != DOT_SIZE; ++y )
+  {
+    const int HalfWidth = static_cast<int>( SDL_sqrt( static_cast<double>( DOT_SIZE * DOT_SIZE / 4 - ( y - DOT_SIZE / 2 ) * ( y - DOT_SIZE / 2 ) ) ) );
+
+    g_DotColliders.push_back( SDL_Rect{ DOT_SIZE / 2 - HalfWidth, y, 2 * HalfWidth, 1 } );
+  }
+
+  g_DotPacked.assign( g_DotColliders );
+
+  for ( const auto& Offset : g_Offsets )
+  {
+    std::vector<SDL_Rect> Moved( g_DotColliders );
+
+    for ( auto& Box : Moved )
+    {
+      Box.x += Offset.x;
+      Box.y += Offset.y;
+    }
+
+    g_MovedColliders.push_back( Moved );
+  }
+
+  for ( int i = 0; i != GRID_BOXES; ++i )
+  {
+    g_Grid.add( SDL_Rect{ randomIn( 0, GRID_WORLD - 64 ), randomIn( 0, GRID_WORLD - 64 ), randomIn( 8, 64 ), randomIn( 8, 64 ) } );
+  }
+
+  g_Grid.build();
+
+  return true;
+}
+
+
+static void tearDown( void )
+{
+  g_Sprite.free();
+  g_Text.free();
+
+  if ( g_Font != NULL )
+  {
+    TTF_CloseFont( g_Font );
+  }
+  else
+  {;}
+
+  SDL_DestroyRenderer( g_Renderer );
+  SDL_FreeSurface( g_Target );
+}
+
+
+/*
+ * The cases. Each one cycles through the inputs, so that the same pair is not tested every time.
+ */
+
+static void benchRender( size_t Iterations )
+{
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    const SDL_Point& Where = g_Points[i & INPUT_MASK];
+
+    g_Sprite.render( Where.x, Where.y );
+  }
+
+  SDL_RenderFlush( g_Renderer );
+}
+
+
+static void benchRenderClipRotated( size_t Iterations )
+{
+  const SDL_Rect Clip{ 0, 0, SPRITE_SIZE / 2, SPRITE_SIZE / 2 };
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    const SDL_Point& Where = g_Points[i & INPUT_MASK];
+
+    g_Sprite.render( Where.x, Where.y, &Clip, static_cast<double>( i % 360 ), NULL, SDL_FLIP_HORIZONTAL );
+  }
+
+  SDL_RenderFlush( g_Renderer );
+}
+
+
+static void benchRenderedText( size_t Iterations )
+{
+  const SDL_Color Black{ 0, 0, 0, 0xFF };
+  char            Text[32];
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    snprintf( Text, sizeof(Text), "Score: %zu", i );
+    g_Text.loadFromRenderedText( g_Font, Text, Black );
+  }
+
+  g_Sink = static_cast<size_t>( g_Text.getWidth() );
+}
+
+
+static void benchRectRect( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    Hits += CheckCollision( g_Rects[i & INPUT_MASK], g_Rects[( i + 1 ) & INPUT_MASK] ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchCircleCircle( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    Hits += CheckCollision( g_Circles[i & INPUT_MASK], g_Circles[( i + 1 ) & INPUT_MASK] ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchCircleRect( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    Hits += CheckCollision( g_Circles[i & INPUT_MASK], g_Rects[i & INPUT_MASK] ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchRectSetRect( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    Hits += CheckCollision( g_MovedColliders[i & INPUT_MASK], SDL_Rect{ 0, 0, DOT_SIZE, DOT_SIZE } ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchRectSetRectSet( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    Hits += CheckCollision( g_DotColliders, g_MovedColliders[i & INPUT_MASK] ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchPackedRects( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    const SDL_Point& Offset = g_Offsets[i & INPUT_MASK];
+
+    Hits += CheckCollision( g_DotPacked, 0, 0, g_DotPacked, Offset.x, Offset.y ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchMask( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    const SDL_Point& Offset = g_Offsets[i & INPUT_MASK];
+
+    Hits += CheckCollision( g_DotMask, 0, 0, g_DotMask, Offset.x, Offset.y ) ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchSweepRect( size_t Iterations )
+{
+  size_t Hits = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    const SDL_Point& Velocity = g_Offsets[i & INPUT_MASK];
+
+    Hits += SweepCollision( g_Rects[i & INPUT_MASK], Velocity.x * 4.0, Velocity.y * 4.0, g_Rects[( i + 1 ) & INPUT_MASK] ).Hit ? 1 : 0;
+  }
+
+  g_Sink = Hits;
+}
+
+
+static void benchBroadPhase( size_t Iterations )
+{
+  size_t Pairs = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    g_BroadPhase.clear();
+
+    for ( int j = 0; j != BROAD_COLLIDERS; ++j )
+    {
+      const SDL_Rect& Box = g_Rects[( i + static_cast<size_t>( j ) ) & INPUT_MASK];
+
+      g_BroadPhase.add( LCollider::FromRect( SDL_Rect{ Box.x + j * 4, Box.y, Box.w, Box.h } ) );
+    }
+
+    Pairs += g_BroadPhase.findPairs().size();
+  }
+
+  g_Sink = Pairs;
+}
+
+
+static void benchGridQuery( size_t Iterations )
+{
+  size_t Found = 0;
+
+  for ( size_t i = 0; i != Iterations; ++i )
+  {
+    g_Grid.query( g_Cameras[i & INPUT_MASK], g_Found );
+    Found += g_Found.size();
+  }
+
+  g_Sink = Found;
+}
+
+
+static const BenchCase CASES[]
+{
+  { "LTexture_render/64x64"               , benchRender           , false },
+  { "LTexture_render/clip_rotated_flipped", benchRenderClipRotated, false },
+  { "LTexture_loadFromRenderedText"       , benchRenderedText     , true  },
+  { "CheckCollision/rect_rect"            , benchRectRect         , false },
+  { "CheckCollision/circle_circle"        , benchCircleCircle     , false },
+  { "CheckCollision/circle_rect"          , benchCircleRect       , false },
+  { "CheckCollision/rect_set_rect"        , benchRectSetRect      , false },
+  { "CheckCollision/rect_set_rect_set"    , benchRectSetRectSet   , false },
+  { "CheckCollision/packed_rects"         , benchPackedRects      , false },
+  { "CheckCollision/pixel_mask"           , benchMask             , false },
+  { "SweepCollision/rect"                 , benchSweepRect        , false },
+  { "LBroadPhase/256"                     , benchBroadPhase       , false },
+  { "LSpatialGrid/query_640x480"          , benchGridQuery        , false },
+};
+
+
+/**
+ * @brief Runs a case with more and more iterations, as Google Benchmark does, until a run lasts at
+ * least MinTime_s; that run is the result.
+ **/
+static BenchResult runCase( const BenchCase& Case, double MinTime_s )
+{
+  const double Frequency  = static_cast<double>( SDL_GetPerformanceFrequency() );
+  size_t       Iterations = 1;
+
+  Case.Function( 1 ); // Warm-up: caches, lazily built tables
+
+  while ( true )
+  {
+    const Uint64       Start    = SDL_GetPerformanceCounter();
+    const std::clock_t CpuStart = std::clock();
+
+    Case.Function( Iterations );
+
+    const double Real_s = static_cast<double>( SDL_GetPerformanceCounter() - Start ) / Frequency;
+    const double Cpu_s  = static_cast<double>( std::clock() - CpuStart ) / CLOCKS_PER_SEC;
+
+    if ( Real_s >= MinTime_s || Iterations >= MAX_ITERATIONS )
+    {
+      const double Count = static_cast<double>( Iterations );
+
+      return BenchResult{ Case.Name, Iterations, Real_s * 1e9 / Count, Cpu_s * 1e9 / Count };
+    }
+    else
+    {;}
+
+    // Aim a little past the minimum time, growing by 2 to 10 times per attempt
+    const double Multiplier = ( Real_s > 0.0 ) ? std::min( 10.0, std::max( 2.0, MinTime_s * 1.4 / Real_s ) ) : 10.0;
+
+    Iterations = std::min( MAX_ITERATIONS, static_cast<size_t>( static_cast<double>( Iterations ) * Multiplier ) );
+  }
+}
+
+
+/**
+ * @brief Writes one entry of the "benchmarks" array.
+ **/
+static void writeJsonEntry( FILE* File_Ptr, const BenchResult& Result, size_t Repetitions, bool IsMedian, bool IsLast )
+{
+  fprintf( File_Ptr, "    {\n" );
+  fprintf( File_Ptr, "      \"name\": \"%s%s\",\n", Result.Name.c_str(), IsMedian ? "_median" : "" );
+  fprintf( File_Ptr, "      \"run_name\": \"%s\",\n", Result.Name.c_str() );
+  fprintf( File_Ptr, "      \"run_type\": \"%s\",\n", IsMedian ? "aggregate" : "iteration" );
+  fprintf( File_Ptr, "      \"repetitions\": %zu,\n", Repetitions );
+
+  if ( IsMedian )
+  {
+    fprintf( File_Ptr, "      \"aggregate_name\": \"median\",\n" );
+  }
+  else
+  {;}
+
+  fprintf( File_Ptr, "      \"iterations\": %zu,\n", Result.Iterations );
+  fprintf( File_Ptr, "      \"real_time\": %.3f,\n", Result.RealTime_ns );
+  fprintf( File_Ptr, "      \"cpu_time\": %.3f,\n", Result.CpuTime_ns );
+  fprintf( File_Ptr, "      \"time_unit\": \"ns\"\n" );
+  fprintf( File_Ptr, "    }%s\n", IsLast ? "" : "," );
+}
+
+
+/**
+ * @brief Writes the results in the JSON layout of Google Benchmark.
+ **/
+static bool writeJson( const std::string& Path, const char* Executable, const std::vector<BenchResult>& Runs,
+                       const std::vector<BenchResult>& Medians, size_t Repetitions )
+{
+  FILE* File_Ptr = fopen( Path.c_str(), "w" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to write \"%s\"!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  char             Date[32];
+  const std::time_t Now = std::time( NULL );
+  SDL_version      Version;
+
+  std::strftime( Date, sizeof(Date), "%Y-%m-%dT%H:%M:%S", std::localtime( &Now ) );
+  SDL_GetVersion( &Version );
+
+  fprintf( File_Ptr, "{\n" );
+  fprintf( File_Ptr, "  \"context\": {\n" );
+  fprintf( File_Ptr, "    \"date\": \"%s\",\n", Date );
+  fprintf( File_Ptr, "    \"executable\": \"%s\",\n", Executable );
+  fprintf( File_Ptr, "    \"num_cpus\": %d,\n", SDL_GetCPUCount() );
+  fprintf( File_Ptr, "    \"sdl_version\": \"%d.%d.%d\",\n", Version.major, Version.minor, Version.patch );
+  fprintf( File_Ptr, "    \"renderer\": \"software\",\n" );
+#if defined(NDEBUG)
+  fprintf( File_Ptr, "    \"library_build_type\": \"release\"\n" );
+#else
+  fprintf( File_Ptr, "    \"library_build_type\": \"debug\"\n" );
+#endif
+  fprintf( File_Ptr, "  },\n" );
+  fprintf( File_Ptr, "  \"benchmarks\": [\n" );
+
+  for ( size_t i = 0; i != Runs.size(); ++i )
+  {
+    writeJsonEntry( File_Ptr, Runs[i], Repetitions, false, Medians.empty() && i + 1 == Runs.size() );
+  }
+
+  for ( size_t i = 0; i != Medians.size(); ++i )
+  {
+    writeJsonEntry( File_Ptr, Medians[i], Repetitions, true, i + 1 == Medians.size() );
+  }
+
+  fprintf( File_Ptr, "  ]\n" );
+  fprintf( File_Ptr, "}\n" );
+
+  return fclose( File_Ptr ) == 0;
+}
+
+
+/***************************************************************************************************
+* Main function
+****************************************************************************************************/
+
+int main( int argc, char* args[] )
+{
+  const char* Filter      = "";
+  const char* FontPath    = NULL;
+  const char* JsonPath    = NULL;
+  double      MinTime_s   = DEFAULT_MIN_TIME;
+  size_t      Repetitions = 1;
+
+  for ( int i = 1; i != argc; ++i )
+  {
+    if ( strncmp( args[i], "--filter=", strlen("--filter=") ) == 0 )
+    {
+      Filter = args[i] + strlen("--filter=");
+    }
+    else if ( strncmp( args[i], "--min-time=", strlen("--min-time=") ) == 0 )
+    {
+      MinTime_s = atof( args[i] + strlen("--min-time=") );
+    }
+    else if ( strncmp( args[i], "--repetitions=", strlen("--repetitions=") ) == 0 )
+    {
+      Repetitions = std::max<size_t>( 1, strtoul( args[i] + strlen("--repetitions="), NULL, 10 ) );
+    }
+    else if ( strncmp( args[i], "--font=", strlen("--font=") ) == 0 )
+    {
+      FontPath = args[i] + strlen("--font=");
+    }
+    else if ( strncmp( args[i], "--json=", strlen("--json=") ) == 0 )
+    {
+      JsonPath = args[i] + strlen("--json=");
+    }
+    else
+    {
+      printf( "\nUsage: EngineBench [--filter=<text>] [--min-time=<s>] [--repetitions=<n>] [--font=<ttf>] [--json=<file>]\n" );
+      return 1;
+    }
+  }
+
+  if ( SDL_Init( 0 ) < 0 || TTF_Init() == -1 )
+  {
+    printf( "\nSDL could not initialise! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  if ( !setUp( FontPath ) )
+  {
+    tearDown();
+    TTF_Quit();
+    SDL_Quit();
+    return 1;
+  }
+  else
+  {;}
+
+  std::vector<BenchResult> Runs;
+  std::vector<BenchResult> Medians;
+
+  printf( "\n%-40s %14s %14s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations" );
+
+  for ( const auto& Case : CASES )
+  {
+    if ( strstr( Case.Name, Filter ) == NULL )
+    {
+      continue;
+    }
+    else if ( Case.NeedsFont && g_Font == NULL )
+    {
+      printf( "%-40s %14s\n", Case.Name, "skipped: no --font" );
+      continue;
+    }
+    else
+    {;}
+
+    std::vector<BenchResult> Repeated;
+
+    for ( size_t r = 0; r != Repetitions; ++r )
+    {
+      Repeated.push_back( runCase( Case, MinTime_s ) );
+
+      const BenchResult& Result = Repeated.back();
+
+      printf( "%-40s %14.1f %14.1f %12zu\n", Result.Name.c_str(), Result.RealTime_ns, Result.CpuTime_ns, Result.Iterations );
+    }
+
+    Runs.insert( Runs.end(), Repeated.begin(), Repeated.end() );
+
+    if ( Repetitions > 1 )
+    {
+      std::sort( Repeated.begin(), Repeated.end(), []( const BenchResult& A, const BenchResult& B ) { return A.RealTime_ns < B.RealTime_ns; } );
+
+      Medians.push_back( Repeated[Repeated.size() / 2] );
+
+      printf( "%-40s %14.1f %14.1f\n", ( Case.Name + std::string( "_median" ) ).c_str(), Medians.back().RealTime_ns, Medians.back().CpuTime_ns );
+    }
+    else
+    {;}
+  }
+
+  const bool IsWritten = ( JsonPath == NULL || writeJson( JsonPath, args[0], Runs, Medians, Repetitions ) );
+
+  tearDown();
+  TTF_Quit();
+  SDL_Quit();
+
+  return IsWritten ? 0 : 1;
+}
@@ -0,0 +1,312 @@
+/**
+ * @file PackAssets.cpp
+ *
+ * @brief Offline asset pack: writes many files into one ".lpak", which LAssetPack maps with a single
+ * open and LOpenAsset, LTexture and LAudioMixer read from.
+ *
+ * Usage:
+ *   PackAssets [--align=<bytes>] [--store] <pack> <file>...
+ *
+ * Every <file> is stored under its path as given, with forward slashes: pack from the directory the
+ * program will run in, with the same relative paths it loads. Baked textures (".ltx") are stored as
+ * they are, at <bytes> (4096 by default, a power of two), so that they are mapped as aligned as a
+ * file of their own; everything else is compressed, unless that saves less than a tenth of it (as
+ * for PNGs and JPEGs, compressed already), or "--store" is given.
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LAssetPack.hpp"
+#include "LBakedTexture.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const Uint64 COMPRESSED_ALIGNMENT = 16;
+static const Uint64 WORTH_COMPRESSING    = 9;   // Tenths of the size the compressed copy must be under
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+struct PackedFile
+{
+  std::string        Name;
+  std::vector<Uint8> Data;     // As read, or compressed
+  Uint64             Size;     // As read
+  Uint32             Compression;
+};
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static bool endsWith( const std::string& Text, const char* Suffix )
+{
+  const size_t Length = strlen( Suffix );
+
+  return Text.size() >= Length && Text.compare( Text.size() - Length, Length, Suffix ) == 0;
+}
+
+
+/**
+ * @brief Writes zeros up to the next multiple of Alignment.
+ **/
+static bool pad( SDL_RWops* Output, Uint64& Offset, Uint64 Alignment )
+{
+  static const Uint8 Zeros[LASSET_PACK_ALIGNMENT] = {};
+
+  while ( Offset % Alignment != 0 )
+  {
+    const size_t Count = static_cast<size_t>( std::min<Uint64>( Alignment - Offset % Alignment, sizeof(Zeros) ) );
+
+    if ( SDL_RWwrite( Output, Zeros, Count, 1 ) != 1 )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    Offset += Count;
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Reads one file, and compresses it if it is worth it.
+ *
+ * @return false if it could not be read.
+ **/
+static bool readFile( const std::string& Path, bool Store, PackedFile& File )
+{
+  size_t Size     = 0;
+  void*  Data_Ptr = SDL_LoadFile( Path.c_str(), &Size );
+
+  if ( Data_Ptr == NULL )
+  {
+    printf( "\nUnable to read \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const Uint8* Bytes_Ptr = static_cast<const Uint8*>( Data_Ptr );
+
+  File.Name        = LAssetPack::NormaliseName( Path );
+  File.Size        = Size;
+  File.Compression = LASSET_PACK_STORED;
+
+  if ( !Store && !endsWith( Path, LBAKED_TEXTURE_EXTENSION ) )
+  {
+    LAssetCompress( Bytes_Ptr, Size, File.Data );
+
+    if ( File.Data.size() * 10 < Size * WORTH_COMPRESSING )
+    {
+      File.Compression = LASSET_PACK_LZ;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  if ( File.Compression == LASSET_PACK_STORED )
+  {
+    File.Data.assign( Bytes_Ptr, Bytes_Ptr + Size );
+  }
+  else
+  {;}
+
+  SDL_free( Data_Ptr );
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the header, the data of the files, and the table of contents. The header is
+ * written last, so that a pack cut short by an error is rejected by LAssetPack.
+ *
+ * @return true if the whole pack was written.
+ **/
+static bool writePack( const std::string& Path, const std::vector<PackedFile>& Files, Uint32 Alignment )
+{
+  SDL_RWops* Output = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  if ( Output == NULL )
+  {
+    printf( "\nUnable to create \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  LAssetPackHeader             Header = {};
+  std::vector<LAssetPackEntry> Entries( Files.size() );
+  std::string                  Names;
+  Uint64                       Offset = sizeof(Header);
+  bool                         Success = SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1;
+
+  for ( size_t i = 0; Success && i != Files.size(); ++i )
+  {
+    const PackedFile& File  = Files[i];
+    LAssetPackEntry&  Entry = Entries[i];
+
+    Success = pad( Output, Offset, ( File.Compression == LASSET_PACK_STORED ) ? Alignment : COMPRESSED_ALIGNMENT )
+              && ( File.Data.empty() || SDL_RWwrite( Output, File.Data.data(), File.Data.size(), 1 ) == 1 );
+
+    Entry.Offset      = Offset;
+    Entry.StoredSize  = File.Data.size();
+    Entry.Size        = File.Size;
+    Entry.NameOffset  = static_cast<Uint32>( Names.size() );
+    Entry.NameLength  = static_cast<Uint32>( File.Name.size() );
+    Entry.Compression = File.Compression;
+    Entry.Reserved    = 0;
+
+    Offset += File.Data.size();
+    Names  += File.Name;
+  }
+
+  Success = Success && pad( Output, Offset, alignof(LAssetPackEntry) );
+
+  memcpy( Header.Magic, LASSET_PACK_MAGIC, sizeof(Header.Magic) );
+  Header.Version      = LASSET_PACK_VERSION;
+  Header.NumOfEntries = static_cast<Uint32>( Files.size() );
+  Header.Alignment    = Alignment;
+  Header.TocOffset    = Offset;
+  Header.TocSize      = Entries.size() * sizeof(LAssetPackEntry) + Names.size();
+
+  Success = Success
+            && ( Entries.empty() || SDL_RWwrite( Output, Entries.data(), sizeof(LAssetPackEntry), Entries.size() ) == Entries.size() )
+            && ( Names.empty() || SDL_RWwrite( Output, Names.data(), Names.size(), 1 ) == 1 )
+            && SDL_RWseek( Output, 0, RW_SEEK_SET ) == 0
+            && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1;
+
+  Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+
+  if ( Success )
+  {
+    printf( "%s: %u files, %llu bytes\n", Path.c_str(), Header.NumOfEntries,
+            static_cast<unsigned long long>( Header.TocOffset + Header.TocSize ) );
+  }
+  else
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+
+  return Success;
+}
+
+
+/***************************************************************************************************
+* Main
+****************************************************************************************************/
+
+int main( int argc, char* argv[] )
+{
+  Uint32                   Alignment = LASSET_PACK_ALIGNMENT;
+  bool                     Store     = false;
+  std::string              PackPath;
+  std::vector<std::string> Paths;
+
+  static const char AlignOption[] = "--align=";
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], AlignOption, strlen( AlignOption ) ) == 0 )
+    {
+      const unsigned long Value = strtoul( argv[i] + strlen( AlignOption ), nullptr, 10 );
+
+      if ( Value < COMPRESSED_ALIGNMENT || Value > LASSET_PACK_ALIGNMENT || ( Value & ( Value - 1 ) ) != 0 )
+      {
+        printf( "\nThe alignment must be a power of two from %u to %u!\n",
+                static_cast<unsigned>( COMPRESSED_ALIGNMENT ), static_cast<unsigned>( LASSET_PACK_ALIGNMENT ) );
+        return 1;
+      }
+      else
+      {;}
+
+      Alignment = static_cast<Uint32>( Value );
+    }
+    else if ( strcmp( argv[i], "--store" ) == 0 )
+    {
+      Store = true;
+    }
+    else if ( PackPath.empty() )
+    {
+      PackPath = argv[i];
+    }
+    else
+    {
+      Paths.push_back( argv[i] );
+    }
+  }
+
+  if ( Paths.empty() )
+  {
+    printf( "Usage: PackAssets [--align=<bytes>] [--store] <pack> <file>...\n" );
+    return 1;
+  }
+  else
+  {;}
+
+  if ( SDL_Init( 0 ) < 0 )
+  {
+    printf( "\nSDL could not initialize! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  std::vector<PackedFile> Files( Paths.size() );
+  bool                    Success = true;
+
+  for ( size_t i = 0; Success && i != Paths.size(); ++i )
+  {
+    Success = readFile( Paths[i], Store, Files[i] );
+  }
+
+  // LAssetPack looks entries up by binary search
+  std::sort( Files.begin(), Files.end(),
+             []( const PackedFile& A, const PackedFile& B ) { return A.Name < B.Name; } );
+
+  for ( size_t i = 1; Success && i < Files.size(); ++i )
+  {
+    if ( Files[i - 1].Name == Files[i].Name )
+    {
+      printf( "\n\"%s\" is given twice!\n", Files[i].Name.c_str() );
+      Success = false;
+    }
+    else
+    {;}
+  }
+
+  for ( size_t i = 0; Success && i != Files.size(); ++i )
+  {
+    printf( "%s: %llu -> %llu bytes%s\n", Files[i].Name.c_str(), static_cast<unsigned long long>( Files[i].Size ),
+            static_cast<unsigned long long>( Files[i].Data.size() ),
+            ( Files[i].Compression == LASSET_PACK_LZ ) ? ", compressed" : "" );
+  }
+
+  Success = Success && writePack( PackPath, Files, Alignment );
+
+  SDL_Quit();
+
+  return Success ? 0 : 1;
+}
@@ -0,0 +1,483 @@
+/**
+ * @file PackAtlas.cpp
+ *
+ * @brief Offline atlas packer: packs loose images into a few power-of-two pages and writes the clip
+ * table that LTextureAtlas loads, so that sprites drawn together come from one texture.
+ *
+ * Usage:
+ *   PackAtlas [--max-size=<px>] [--padding=<px>] [--no-colour-key] <atlas> <image>...
+ *
+ * The images are placed with the max-rects algorithm (best short side fit), largest first, on pages
+ * of at most <px> pixels a side (2048 by default); each page is then cropped to the smallest power
+ * of two, in width and in height, that holds what was placed on it. Every image is surrounded by
+ * <px> pixels of padding (2 by default) filled with copies of its edge pixels, so that filtering
+ * and rounding never bring in a neighbour.
+ *
+ * The pages are written next to <atlas> as "<atlas name>_<n>.png", and the clip table as <atlas>
+ * itself: one clip per image, named after its file without folder and extension, so names must be
+ * unique. The colour key (cyan, as in loadFromFile) becomes transparency, unless "--no-colour-key".
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LTextureAtlas.hpp"
+#include "colours.hpp"
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+struct LooseImage
+{
+  std::string  Path;
+  std::string  Name;
+  SDL_Surface* Surface_Ptr;   // ARGB8888, colour key already turned into transparency
+  int          Page;          // -1 until placed
+  SDL_Rect     Clip;          // In the page, padding excluded
+};
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const int DEFAULT_MAX_SIZE = 2048;
+static const int DEFAULT_PADDING  = 2;
+static const int MIN_PAGE_SIZE    = 64;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return the file name of a path, without folder and extension.
+ **/
+static std::string stemOf( const std::string& Path )
+{
+  const size_t Separator = Path.find_last_of( "/\\" );
+  const size_t Start     = ( Separator != std::string::npos ) ? Separator + 1 : 0;
+  const size_t Dot       = Path.find_last_of( '.' );
+  const size_t End       = ( Dot != std::string::npos && Dot > Start ) ? Dot : Path.size();
+
+  return Path.substr( Start, End - Start );
+}
+
+
+static std::string folderOf( const std::string& Path )
+{
+  const size_t Separator = Path.find_last_of( "/\\" );
+
+  return ( Separator != std::string::npos ) ? Path.substr( 0, Separator + 1 ) : std::string();
+}
+
+
+static int nextPowerOfTwo( int Value )
+{
+  int Power = 1;
+
+  while ( Power < Value )
+  {
+    Power *= 2;
+  }
+
+  return Power;
+}
+
+
+static bool overlaps( const SDL_Rect& A, const SDL_Rect& B )
+{
+  return A.x < B.x + B.w && B.x < A.x + A.w && A.y < B.y + B.h && B.y < A.y + A.h;
+}
+
+
+static bool contains( const SDL_Rect& Outer, const SDL_Rect& Inner )
+{
+  return Inner.x >= Outer.x && Inner.y >= Outer.y
+         && Inner.x + Inner.w <= Outer.x + Outer.w && Inner.y + Inner.h <= Outer.y + Outer.h;
+}
+
+
+/**
+ * @brief Places a W x H rectangle in the free space of a page, max-rects style: in the free
+ * rectangle that it fits most tightly along its shorter side; then every free rectangle it overlaps
+ * is split into the up to four maximal rectangles around it, and those held by another are dropped.
+ *
+ * @param Free The maximal free rectangles of the page.
+ * @return false if the rectangle does not fit anywhere.
+ **/
+static bool placeRect( std::vector<SDL_Rect>& Free, int W, int H, SDL_Rect& Placed )
+{
+  int BestShort = INT_MAX;
+  int BestLong  = INT_MAX;
+  int Best      = -1;
+
+  for ( size_t i = 0; i != Free.size(); ++i )
+  {
+    if ( Free[i].w < W || Free[i].h < H )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const int Short = std::min( Free[i].w - W, Free[i].h - H );
+    const int Long  = std::max( Free[i].w - W, Free[i].h - H );
+
+    if ( Short < BestShort || ( Short == BestShort && Long < BestLong ) )
+    {
+      BestShort = Short;
+      BestLong  = Long;
+      Best      = static_cast<int>( i );
+    }
+    else
+    {;}
+  }
+
+  if ( Best == -1 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Placed = SDL_Rect{ Free[Best].x, Free[Best].y, W, H };
+
+  std::vector<SDL_Rect> Split;
+
+  for ( const SDL_Rect& Each : Free )
+  {
+    if ( !overlaps( Each, Placed ) )
+    {
+      Split.push_back( Each );
+      continue;
+    }
+    else
+    {;}
+
+    if ( Placed.x > Each.x )
+    {
+      Split.push_back( SDL_Rect{ Each.x, Each.y, Placed.x - Each.x, Each.h } );
+    }
+    else
+    {;}
+
+    if ( Placed.x + Placed.w < Each.x + Each.w )
+    {
+      Split.push_back( SDL_Rect{ Placed.x + Placed.w, Each.y, Each.x + Each.w - Placed.x - Placed.w, Each.h } );
+    }
+    else
+    {;}
+
+    if ( Placed.y > Each.y )
+    {
+      Split.push_back( SDL_Rect{ Each.x, Each.y, Each.w, Placed.y - Each.y } );
+    }
+    else
+    {;}
+
+    if ( Placed.y + Placed.h < Each.y + Each.h )
+    {
+      Split.push_back( SDL_Rect{ Each.x, Placed.y + Placed.h, Each.w, Each.y + Each.h - Placed.y - Placed.h } );
+    }
+    else
+    {;}
+  }
+
+  // Only maximal rectangles are kept: of two equal ones, the first
+  Free.clear();
+
+  for ( size_t i = 0; i != Split.size(); ++i )
+  {
+    bool IsHeld = false;
+
+    for ( size_t j = 0; !IsHeld && j != Split.size(); ++j )
+    {
+      IsHeld = ( i != j ) && contains( Split[j], Split[i] ) && ( !contains( Split[i], Split[j] ) || j < i );
+    }
+
+    if ( !IsHeld )
+    {
+      Free.push_back( Split[i] );
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Copies an image into a page, with its edge pixels repeated over the padding around it.
+ **/
+static void copyPadded( const SDL_Surface* Image, SDL_Surface* Page, const SDL_Rect& Clip, int Padding )
+{
+  const Uint8* Source      = static_cast<const Uint8*>( Image->pixels );
+  Uint8*       Destination = static_cast<Uint8*>( Page->pixels );
+
+  for ( int y = -Padding; y != Clip.h + Padding; ++y )
+  {
+    const Uint32* SourceRow      = reinterpret_cast<const Uint32*>( Source + std::min( std::max( y, 0 ), Clip.h - 1 ) * Image->pitch );
+    Uint32*       DestinationRow = reinterpret_cast<Uint32*>( Destination + ( Clip.y + y ) * Page->pitch );
+
+    for ( int x = -Padding; x != Clip.w + Padding; ++x )
+    {
+      DestinationRow[Clip.x + x] = SourceRow[ std::min( std::max( x, 0 ), Clip.w - 1 ) ];
+    }
+  }
+}
+
+
+/**
+ * @brief Loads one image, converted to ARGB8888.
+ *
+ * @return NULL if it could not be loaded.
+ **/
+static SDL_Surface* loadImage( const std::string& Path, bool ColourKey )
+{
+  SDL_Surface* Loaded = IMG_Load( Path.c_str() );
+
+  if ( Loaded == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+    return NULL;
+  }
+  else
+  {;}
+
+  if ( ColourKey )
+  {
+    SDL_SetColorKey( Loaded, SDL_TRUE, SDL_MapRGB( Loaded->format, CYAN_R, CYAN_G, CYAN_B ) );
+  }
+  else
+  {;}
+
+  // Converting a colour keyed surface to a format with alpha turns the key into transparency
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Loaded, SDL_PIXELFORMAT_ARGB8888, 0 );
+  SDL_FreeSurface( Loaded );
+
+  if ( Converted == NULL )
+  {
+    printf( "\nUnable to convert \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+
+  return Converted;
+}
+
+
+/**
+ * @brief Packs the images still without a page into a new one, writes it, and adds it to the atlas.
+ *
+ * @return the images placed on the page; 0 if it could not be written.
+ **/
+static int packPage( std::vector<LooseImage>& Images, int MaxSize, int Padding, const std::string& AtlasPath, LTextureAtlas& Atlas )
+{
+  std::vector<SDL_Rect> Free( 1, SDL_Rect{ 0, 0, MaxSize, MaxSize } );
+  std::vector<size_t>   Placed;
+  int                   UsedW    = 0;
+  int                   UsedH    = 0;
+  long long             UsedArea = 0;
+  const int             Page     = Atlas.GetPageCount();
+
+  for ( size_t i = 0; i != Images.size(); ++i )
+  {
+    LooseImage& Image = Images[i];
+    SDL_Rect    Padded;
+
+    if ( Image.Page == -1 && placeRect( Free, Image.Surface_Ptr->w + 2 * Padding, Image.Surface_Ptr->h + 2 * Padding, Padded ) )
+    {
+      Image.Page = Page;
+      Image.Clip = SDL_Rect{ Padded.x + Padding, Padded.y + Padding, Image.Surface_Ptr->w, Image.Surface_Ptr->h };
+      Placed.push_back( i );
+
+      UsedW     = std::max( UsedW, Padded.x + Padded.w );
+      UsedH     = std::max( UsedH, Padded.y + Padded.h );
+      UsedArea += static_cast<long long>( Image.Clip.w ) * Image.Clip.h;
+    }
+    else
+    {;}
+  }
+
+  const int PageW = nextPowerOfTwo( UsedW );
+  const int PageH = nextPowerOfTwo( UsedH );
+
+  SDL_Surface* PageSurface = SDL_CreateRGBSurfaceWithFormat( 0, PageW, PageH, 32, SDL_PIXELFORMAT_ARGB8888 );
+
+  if ( PageSurface == NULL )
+  {
+    printf( "\nUnable to create a %dx%d page! SDL Error: %s", PageW, PageH, SDL_GetError() );
+    return 0;
+  }
+  else
+  {;}
+
+  // Transparent where nothing was placed
+  SDL_FillRect( PageSurface, NULL, 0 );
+
+  for ( size_t Index : Placed )
+  {
+    SDL_LockSurface( Images[Index].Surface_Ptr );
+    copyPadded( Images[Index].Surface_Ptr, PageSurface, Images[Index].Clip, Padding );
+    SDL_UnlockSurface( Images[Index].Surface_Ptr );
+  }
+
+  const std::string File = stemOf( AtlasPath ) + "_" + std::to_string( Page ) + ".png";
+  const std::string Path = folderOf( AtlasPath ) + File;
+
+  const bool Success = IMG_SavePNG( PageSurface, Path.c_str() ) == 0 && Atlas.addPage( File ) == Page;
+
+  SDL_FreeSurface( PageSurface );
+
+  if ( !Success )
+  {
+    printf( "\nUnable to write the page \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return 0;
+  }
+  else
+  {;}
+
+  printf( "%s: %dx%d, %u images, %d%% used\n", Path.c_str(), PageW, PageH, static_cast<unsigned>( Placed.size() ),
+          static_cast<int>( 100 * UsedArea / ( static_cast<long long>( PageW ) * PageH ) ) );
+
+  return static_cast<int>( Placed.size() );
+}
+
+
+/***************************************************************************************************
+* Main
+****************************************************************************************************/
+
+int main( int argc, char* argv[] )
+{
+  int         MaxSize   = DEFAULT_MAX_SIZE;
+  int         Padding   = DEFAULT_PADDING;
+  bool        ColourKey = true;
+  std::string AtlasPath;
+
+  std::vector<LooseImage> Images;
+
+  static const char MaxSizeOption[] = "--max-size=";
+  static const char PaddingOption[] = "--padding=";
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], MaxSizeOption, strlen( MaxSizeOption ) ) == 0 )
+    {
+      MaxSize = atoi( argv[i] + strlen( MaxSizeOption ) );
+    }
+    else if ( strncmp( argv[i], PaddingOption, strlen( PaddingOption ) ) == 0 )
+    {
+      Padding = atoi( argv[i] + strlen( PaddingOption ) );
+    }
+    else if ( strcmp( argv[i], "--no-colour-key" ) == 0 )
+    {
+      ColourKey = false;
+    }
+    else if ( AtlasPath.empty() )
+    {
+      AtlasPath = argv[i];
+    }
+    else
+    {
+      Images.push_back( LooseImage{ argv[i], stemOf( argv[i] ), NULL, -1, SDL_Rect{ 0, 0, 0, 0 } } );
+    }
+  }
+
+  if ( AtlasPath.empty() || Images.empty() || MaxSize < MIN_PAGE_SIZE || nextPowerOfTwo( MaxSize ) != MaxSize || Padding < 0 )
+  {
+    printf( "Usage: PackAtlas [--max-size=<px>] [--padding=<px>] [--no-colour-key] <atlas> <image>...\n"
+            "       <px> of --max-size is a power of two, %d or more\n", MIN_PAGE_SIZE );
+    return 1;
+  }
+  else
+  {;}
+
+  if ( SDL_Init( 0 ) < 0 )
+  {
+    printf( "\nSDL could not initialize! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  IMG_Init( IMG_INIT_PNG | IMG_INIT_JPG );
+
+  bool Success = true;
+
+  for ( LooseImage& Image : Images )
+  {
+    Image.Surface_Ptr = loadImage( Image.Path, ColourKey );
+
+    if ( Image.Surface_Ptr == NULL )
+    {
+      Success = false;
+    }
+    else if ( Image.Surface_Ptr->w + 2 * Padding > MaxSize || Image.Surface_Ptr->h + 2 * Padding > MaxSize )
+    {
+      printf( "\n\"%s\" does not fit a page of %d pixels, with its padding!", Image.Path.c_str(), MaxSize );
+      Success = false;
+    }
+    else
+    {;}
+  }
+
+  // Largest first: the small ones fill the gaps left between them
+  std::stable_sort( Images.begin(), Images.end(), []( const LooseImage& A, const LooseImage& B )
+  {
+    const int SideA = ( A.Surface_Ptr != NULL ) ? std::max( A.Surface_Ptr->w, A.Surface_Ptr->h ) : 0;
+    const int SideB = ( B.Surface_Ptr != NULL ) ? std::max( B.Surface_Ptr->w, B.Surface_Ptr->h ) : 0;
+
+    return SideA > SideB;
+  } );
+
+  LTextureAtlas Atlas;
+  size_t        Packed = 0;
+
+  while ( Success && Packed != Images.size() )
+  {
+    const int OnPage = packPage( Images, MaxSize, Padding, AtlasPath, Atlas );
+
+    Packed  += static_cast<size_t>( OnPage );
+    Success  = OnPage != 0;
+  }
+
+  for ( size_t i = 0; Success && i != Images.size(); ++i )
+  {
+    Success = Atlas.addClip( Images[i].Name, Images[i].Page, Images[i].Clip );
+  }
+
+  Success = Success && Atlas.save( AtlasPath );
+
+  if ( Success )
+  {
+    printf( "%s: %u images on %d pages\n", AtlasPath.c_str(), static_cast<unsigned>( Images.size() ), Atlas.GetPageCount() );
+  }
+  else
+  {;}
+
+  for ( LooseImage& Image : Images )
+  {
+    SDL_FreeSurface( Image.Surface_Ptr );
+  }
+
+  IMG_Quit();
+  SDL_Quit();
+
+  return Success ? 0 : 1;
+}
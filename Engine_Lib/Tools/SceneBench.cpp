@@ -0,0 +1,1048 @@
+/**
+ * @file SceneBench.cpp
+ *
+ * @brief Scaling sweeps of the scenes of the tutorials: each scene is run at a growing size, and
+ * frame time, CPU time, present time and memory are recorded at every step, giving a curve of the
+ * cost against the size rather than a single number.
+ *
+ * Usage:
+ *   SceneBench [--scene=<name>] [--frames=<n>] [--warmup=<n>] [--max-frame-ms=<ms>] [--font=<ttf>]
+ *              [--headless] [--csv=<file>]
+ *
+ * The scenes, and what they sweep:
+ * - entities:  dots moved and bounced by StepEntities, drawn by LSpriteBatch, as 44's crowd;
+ * - tiles:     square maps of 80x80 tiles, each one tested against the panning camera, as in 39;
+ * - particles: groups of 20 particles living 10 frames, with their shimmer, as 38's;
+ * - text:      strings rendered with SDL_ttf and drawn every frame, as 16 does for one (needs --font);
+ * - windows:   windows with a renderer each, all of them drawn and presented every frame, as 36's
+ *              worst case: LWindowManager would throttle the ones in the background.
+ * Every scene whose name contains <name> (all by default) is run; the size doubles at every step,
+ * until the last one of the scene or until the average frame takes more than <ms> (100 by default).
+ *
+ * A step runs <n> frames (300 by default) after <warmup> frames that are not measured (30 by
+ * default), updated with a fixed step of 1/60 s so that every run does the same work. The renderer
+ * is not paced: the hint turns vsync off. With --headless the scenes are drawn by the software
+ * renderer into dummy windows, for machines with no display; the curves then measure the CPU alone.
+ *
+ * The columns, per frame on average but for the percentiles and the memory:
+ * - frame_ms:    the whole frame, update, draws and presents; its median, 95th percentile and worst;
+ * - cpu_ms:      CPU time of the process, all its threads (the job workers and the driver's too);
+ * - present_ms:  time spent in SDL_RenderPresent. SDL_Renderer offers no GPU timer: with vsync off,
+ *                present waits when the GPU falls behind, so this grows with the GPU time once the
+ *                GPU is the bottleneck, and stays near zero while the CPU is;
+ * - resident_kib and peak_resident_kib: the memory of the process in RAM at the end of the step, and
+ *                the most it has had since it started. Video memory is not visible to SDL, nor counted.
+ * The table is printed on the console, and <file> receives it as CSV, one row per step.
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #define PSAPI_VERSION 2      // GetProcessMemoryInfo from kernel32: no psapi library to link
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/resource.h>
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+#include "LEntityStore.hpp"
+#include "LEntitySystems.hpp"
+#include "LJobSystem.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const int    WINDOW_W              = 640;
+static const int    WINDOW_H              = 480;
+static const int    DOT_SIZE              = 20;     // 44's dot
+static const int    CROWD_MAX_VEL         = 200;    // Pixels per second, as 44's crowd
+static const int    TILE_SIZE             = 80;     // 39's tiles
+static const int    TILE_TYPES            = 3;      // Red, green and blue, as lazy.map
+static const int    CAMERA_VEL            = 8;      // Pixels per frame
+static const int    PARTICLE_SIZE         = 5;
+static const int    PARTICLES_PER_EMITTER = 20;     // 38's TOTAL_PARTICLES
+static const int    PARTICLE_LIFE         = 10;     // Frames
+static const int    FONT_SIZE             = 28;     // 16's font
+static const int    TEXT_LINE_H           = 32;
+static const int    TEXT_COLUMNS          = 3;
+static const int    EXTRA_WINDOW_W        = 320;
+static const int    EXTRA_WINDOW_H        = 240;
+static const int    WINDOW_RECTS          = 64;     // Drawn in each window besides the clear
+static const double FRAME_STEP_S          = 1.0 / 60.0;
+static const size_t DEFAULT_FRAMES        = 300;
+static const size_t DEFAULT_WARMUP        = 30;
+static const double DEFAULT_MAX_FRAME_MS  = 100.0;
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+/**
+ * @brief A scene swept from First to Last, doubling. SetUp builds it at a size and may fail, Frame
+ * updates, draws and presents it once, TearDown frees what SetUp built.
+ **/
+struct SweepScene
+{
+  const char* Name;
+  const char* Parameter;   // What the size counts
+  int         First;
+  int         Last;
+  bool        NeedsFont;
+  bool      (*SetUp)   ( int );
+  void      (*Frame)   ( void );
+  void      (*TearDown)( void );
+};
+
+/**
+ * @brief The measures of one step. Times are in milliseconds, per frame.
+ **/
+struct StepResult
+{
+  int    Value;
+  size_t Frames;
+  double Frame_ms;
+  double FrameP50_ms;
+  double FrameP95_ms;
+  double FrameMax_ms;
+  double Cpu_ms;
+  double Present_ms;
+  size_t Resident_KiB;
+  size_t PeakResident_KiB;
+};
+
+struct Tile
+{
+  SDL_Rect Box;
+  int      Type;
+};
+
+struct Particle
+{
+  float x;
+  float y;
+  int   Frame;
+  int   Type;
+};
+
+
+/***************************************************************************************************
+* Private global variables
+****************************************************************************************************/
+
+static SDL_Window*   g_Window   = NULL;
+static SDL_Renderer* g_Renderer = NULL;
+static TTF_Font*     g_Font     = NULL;
+
+static LTexture      g_Dot;
+static LTexture      g_TileSheet;
+static LTexture      g_Particle;
+static LSpriteBatch  g_Batch;
+static LJobSystem    g_Jobs;
+
+static Uint64        g_PresentTicks = 0;       // Spent in SDL_RenderPresent since the step started
+static Uint32        g_FrameCount   = 0;       // Frames of the current step, warm-up included
+static bool          g_IsQuitting   = false; // A window was closed: the sweep stops
+
+// entities
+static LEntityStore               g_Entities;
+static LComponentArray<LPosition> g_Positions;
+static LComponentArray<LVelocity> g_Velocities;
+static LComponentArray<LBox>      g_Boxes;
+static LComponentArray<LSprite>   g_Sprites;
+
+// tiles
+static std::vector<Tile>          g_Tiles;
+static SDL_Rect                   g_Camera{ 0, 0, WINDOW_W, WINDOW_H };
+static int                        g_MapSize = 0;       // Pixels, per side
+static int                        g_CameraVelX = CAMERA_VEL;
+static int                        g_CameraVelY = CAMERA_VEL;
+
+// particles
+static std::vector<SDL_Point>     g_Emitters;
+static std::vector<Particle>      g_Particles;
+
+// text
+static std::vector<LTexture>      g_Texts;
+
+// windows
+static std::vector<SDL_Window*>   g_ExtraWindows;
+static std::vector<SDL_Renderer*> g_ExtraRenderers;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return a pseudo-random number: the same sequence at every run, on every platform.
+ **/
+static Uint32 nextRandom( void )
+{
+  static Uint32 s_State = 12345u;
+
+  s_State = s_State * 1664525u + 1013904223u;
+
+  return s_State >> 8;
+}
+
+
+static int randomIn( int Min, int Max )
+{
+  return Min + static_cast<int>( nextRandom() % static_cast<Uint32>( Max - Min + 1 ) );
+}
+
+
+/**
+ * @return the CPU time used so far by every thread of the process, in seconds. std::clock gives the
+ * wall time on Windows, so each platform is asked directly.
+ **/
+static double processCpuTime_s( void )
+{
+#if defined(_WIN32)
+  FILETIME Creation;
+  FILETIME Exit;
+  FILETIME Kernel;
+  FILETIME User;
+
+  if ( !GetProcessTimes( GetCurrentProcess(), &Creation, &Exit, &Kernel, &User ) )
+  {
+    return 0.0;
+  }
+  else
+  {;}
+
+  const ULONGLONG KernelTicks = ( static_cast<ULONGLONG>( Kernel.dwHighDateTime ) << 32 ) | Kernel.dwLowDateTime;
+  const ULONGLONG UserTicks   = ( static_cast<ULONGLONG>( User.dwHighDateTime   ) << 32 ) | User.dwLowDateTime;
+
+  return static_cast<double>( KernelTicks + UserTicks ) * 1e-7; // 100 ns ticks
+#else
+  timespec Now;
+
+  if ( clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &Now ) != 0 )
+  {
+    return 0.0;
+  }
+  else
+  {;}
+
+  return static_cast<double>( Now.tv_sec ) + static_cast<double>( Now.tv_nsec ) * 1e-9;
+#endif
+}
+
+
+/**
+ * @brief Reads the memory of the process in RAM, now and at its peak, in bytes. Where the current
+ * size cannot be read (not Windows nor Linux) it is reported as the peak.
+ **/
+static void readResidentMemory( size_t& Resident, size_t& Peak )
+{
+  Resident = 0;
+  Peak     = 0;
+
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS Counters;
+
+  if ( GetProcessMemoryInfo( GetCurrentProcess(), &Counters, sizeof(Counters) ) )
+  {
+    Resident = Counters.WorkingSetSize;
+    Peak     = Counters.PeakWorkingSetSize;
+  }
+  else
+  {;}
+#else
+  rusage Usage;
+
+  if ( getrusage( RUSAGE_SELF, &Usage ) == 0 )
+  {
+  #if defined(__APPLE__)
+    Peak = static_cast<size_t>( Usage.ru_maxrss );          // Bytes
+  #else
+    Peak = static_cast<size_t>( Usage.ru_maxrss ) * 1024;   // KiB
+  #endif
+  }
+  else
+  {;}
+
+  Resident = Peak;
+
+  #if defined(__linux__)
+  FILE*         File_Ptr = fopen( "/proc/self/statm", "r" );
+  unsigned long Size     = 0;
+  unsigned long Pages    = 0;
+
+  if ( File_Ptr != NULL )
+  {
+    if ( fscanf( File_Ptr, "%lu %lu", &Size, &Pages ) == 2 )
+    {
+      Resident = static_cast<size_t>( Pages ) * static_cast<size_t>( sysconf( _SC_PAGESIZE ) );
+    }
+    else
+    {;}
+
+    fclose( File_Ptr );
+  }
+  else
+  {;}
+  #endif
+#endif
+}
+
+
+/**
+ * @brief Presents a renderer, adding the time it took to the step's present time.
+ **/
+static void timedPresent( SDL_Renderer* Renderer_Ptr )
+{
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  SDL_RenderPresent( Renderer_Ptr );
+
+  g_PresentTicks += SDL_GetPerformanceCounter() - Start;
+}
+
+
+static void clearWindow( SDL_Renderer* Renderer_Ptr )
+{
+  SDL_SetRenderDrawColor( Renderer_Ptr, 0xFF, 0xFF, 0xFF, 0xFF );
+  SDL_RenderClear( Renderer_Ptr );
+}
+
+
+/**
+ * @brief A filled circle of DOT_SIZE pixels, transparent around it, as the dot image.
+ **/
+static SDL_Surface* createDotSurface( void )
+{
+  SDL_Surface* Dot = SDL_CreateRGBSurfaceWithFormat( 0, DOT_SIZE, DOT_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+
+  if ( Dot == NULL )
+  {
+    return NULL;
+  }
+  else
+  {;}
+
+  const int Radius = DOT_SIZE / 2;
+
+  for ( int y = 0; y != DOT_SIZE; ++y )
+  {
+    Uint32* Row = reinterpret_cast<Uint32*>( static_cast<Uint8*>( Dot->pixels ) + y * Dot->pitch );
+
+    for ( int x = 0; x != DOT_SIZE; ++x )
+    {
+      const int Dx = 2 * x + 1 - DOT_SIZE;
+      const int Dy = 2 * y + 1 - DOT_SIZE;
+
+      Row[x] = ( Dx * Dx + Dy * Dy <= 4 * Radius * Radius ) ? 0xFFFF0000u : 0x00000000u;
+    }
+  }
+
+  return Dot;
+}
+
+
+/**
+ * @brief The images of the scenes, made in memory: the dot, a sheet of TILE_TYPES tiles side by
+ * side and a white particle, tinted per sprite by the batch.
+ **/
+static bool createTextures( void )
+{
+  SDL_Surface* Dot      = createDotSurface();
+  SDL_Surface* Sheet    = SDL_CreateRGBSurfaceWithFormat( 0, TILE_SIZE * TILE_TYPES, TILE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+  SDL_Surface* Particle = SDL_CreateRGBSurfaceWithFormat( 0, PARTICLE_SIZE, PARTICLE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888 );
+  bool         IsMade   = ( Dot != NULL && Sheet != NULL && Particle != NULL );
+
+  if ( IsMade )
+  {
+    static const Uint32 TileColours[TILE_TYPES] = { 0xFFC03030u, 0xFF30C030u, 0xFF3030C0u };
+
+    for ( int i = 0; i != TILE_TYPES; ++i )
+    {
+      const SDL_Rect Box{ i * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE };
+
+      SDL_FillRect( Sheet, &Box, TileColours[i] );
+    }
+
+    SDL_FillRect( Particle, NULL, 0xFFFFFFFFu );
+
+    IsMade = g_Dot.loadFromSurface( Dot ) && g_TileSheet.loadFromSurface( Sheet ) && g_Particle.loadFromSurface( Particle );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Dot );
+  SDL_FreeSurface( Sheet );
+  SDL_FreeSurface( Particle );
+
+  if ( !IsMade )
+  {
+    printf( "\nUnable to create the test images! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  g_Particle.setBlendMode( SDL_BLENDMODE_BLEND );
+
+  return true;
+}
+
+
+/*
+ * entities: 44's crowd. The store keeps its capacity between steps.
+ */
+
+static bool setUpEntities( int Count )
+{
+  g_Entities.reserve( static_cast<size_t>( Count ) );
+
+  for ( int i = 0; i != Count; ++i )
+  {
+    const LEntity Dot = g_Entities.create();
+
+    g_Positions .add( Dot, LPosition{ static_cast<float>( randomIn( 0, WINDOW_W - DOT_SIZE ) ), static_cast<float>( randomIn( 0, WINDOW_H - DOT_SIZE ) ) } );
+    g_Velocities.add( Dot, LVelocity{ static_cast<float>( randomIn( -CROWD_MAX_VEL, CROWD_MAX_VEL ) ), static_cast<float>( randomIn( -CROWD_MAX_VEL, CROWD_MAX_VEL ) ) } );
+    g_Boxes     .add( Dot, LBox{ DOT_SIZE, DOT_SIZE } );
+    g_Sprites   .add( Dot, LSprite{ &g_Dot, SDL_Rect{ 0, 0, 0, 0 }, SDL_Color{ 0xFF, 0xFF, 0xFF, 0xFF } } );
+  }
+
+  return true;
+}
+
+
+static void frameEntities( void )
+{
+  StepEntities( g_Positions, g_Velocities, g_Boxes, SDL_Rect{ 0, 0, WINDOW_W, WINDOW_H }, FRAME_STEP_S, &g_Jobs );
+
+  clearWindow( g_Renderer );
+  g_Batch.begin();
+  DrawEntities( g_Positions, g_Sprites, g_Batch );
+  g_Batch.flush( g_Renderer );
+  timedPresent( g_Renderer );
+}
+
+
+static void tearDownEntities( void )
+{
+  g_Entities.clear();
+}
+
+
+/*
+ * tiles: 39's map, Side x Side tiles of random types, seen by a camera bouncing across it. Every
+ * tile is tested against the camera, so the cost grows with the map, not with the view.
+ */
+
+static bool setUpTiles( int Side )
+{
+  g_MapSize = Side * TILE_SIZE;
+  g_Camera  = SDL_Rect{ 0, 0, WINDOW_W, WINDOW_H };
+
+  g_Tiles.reserve( static_cast<size_t>( Side ) * static_cast<size_t>( Side ) );
+
+  for ( int y = 0; y != Side; ++y )
+  {
+    for ( int x = 0; x != Side; ++x )
+    {
+      g_Tiles.push_back( Tile{ SDL_Rect{ x * TILE_SIZE, y * TILE_SIZE, TILE_SIZE, TILE_SIZE }, randomIn( 0, TILE_TYPES - 1 ) } );
+    }
+  }
+
+  return true;
+}
+
+
+static void frameTiles( void )
+{
+  g_Camera.x += g_CameraVelX;
+  g_Camera.y += g_CameraVelY;
+
+  if ( g_Camera.x < 0 || g_Camera.x > g_MapSize - g_Camera.w )
+  {
+    g_CameraVelX = -g_CameraVelX;
+    g_Camera.x   = std::max( 0, std::min( g_Camera.x, g_MapSize - g_Camera.w ) );
+  }
+  else
+  {;}
+
+  if ( g_Camera.y < 0 || g_Camera.y > g_MapSize - g_Camera.h )
+  {
+    g_CameraVelY = -g_CameraVelY;
+    g_Camera.y   = std::max( 0, std::min( g_Camera.y, g_MapSize - g_Camera.h ) );
+  }
+  else
+  {;}
+
+  clearWindow( g_Renderer );
+  g_Batch.begin();
+
+  for ( const Tile& Cell : g_Tiles )
+  {
+    if ( SDL_HasIntersection( &Cell.Box, &g_Camera ) )
+    {
+      const SDL_Rect Clip{ Cell.Type * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE };
+
+      g_Batch.add( g_TileSheet, Cell.Box.x - g_Camera.x, Cell.Box.y - g_Camera.y, &Clip );
+    }
+    else
+    {;}
+  }
+
+  g_Batch.flush( g_Renderer );
+  timedPresent( g_Renderer );
+}
+
+
+static void tearDownTiles( void )
+{
+  g_Tiles.clear();
+  g_Tiles.shrink_to_fit(); // The memory column is the point of this scene
+}
+
+
+/*
+ * particles: 38's, PARTICLES_PER_EMITTER per emitter, each living PARTICLE_LIFE frames and born
+ * again around its emitter, with the shimmer drawn over them every other frame.
+ */
+
+static void spawnParticle( Particle& Spark, const SDL_Point& Emitter )
+{
+  Spark.x     = static_cast<float>( Emitter.x - 5 + randomIn( 0, 24 ) );
+  Spark.y     = static_cast<float>( Emitter.y - 5 + randomIn( 0, 24 ) );
+  Spark.Frame = randomIn( 0, 4 );
+  Spark.Type  = randomIn( 0, 2 );
+}
+
+
+static bool setUpParticles( int Count )
+{
+  const int Emitters = std::max( 1, Count / PARTICLES_PER_EMITTER );
+
+  for ( int i = 0; i != Emitters; ++i )
+  {
+    g_Emitters.push_back( SDL_Point{ randomIn( 0, WINDOW_W - DOT_SIZE ), randomIn( 0, WINDOW_H - DOT_SIZE ) } );
+  }
+
+  g_Particles.resize( static_cast<size_t>( Count ) );
+
+  for ( size_t i = 0; i != g_Particles.size(); ++i )
+  {
+    spawnParticle( g_Particles[i], g_Emitters[i % g_Emitters.size()] );
+  }
+
+  return true;
+}
+
+
+static void frameParticles( void )
+{
+  static const SDL_Color Colours[3] = { { 0xFF, 0x40, 0x40, 0xFF }, { 0x40, 0xFF, 0x40, 0xFF }, { 0x40, 0x40, 0xFF, 0xFF } };
+  static const SDL_Color Shimmer    = { 0xFF, 0xFF, 0xFF, 0xC0 };
+
+  const bool IsShimmering = ( g_FrameCount % 2 ) == 0;
+
+  clearWindow( g_Renderer );
+  g_Batch.begin();
+
+  for ( size_t i = 0; i != g_Particles.size(); ++i )
+  {
+    Particle& Spark = g_Particles[i];
+
+    if ( ++Spark.Frame > PARTICLE_LIFE )
+    {
+      spawnParticle( Spark, g_Emitters[i % g_Emitters.size()] );
+    }
+    else
+    {;}
+
+    const SDL_FRect Clip{ 0.f, 0.f, static_cast<float>( PARTICLE_SIZE ), static_cast<float>( PARTICLE_SIZE ) };
+    const SDL_FRect Where{ Spark.x, Spark.y, static_cast<float>( PARTICLE_SIZE ), static_cast<float>( PARTICLE_SIZE ) };
+
+    g_Batch.add( g_Particle, Clip, Where, Colours[Spark.Type] );
+
+    if ( IsShimmering )
+    {
+      g_Batch.add( g_Particle, Clip, Where, Shimmer );
+    }
+    else
+    {;}
+  }
+
+  g_Batch.flush( g_Renderer );
+  timedPresent( g_Renderer );
+}
+
+
+static void tearDownParticles( void )
+{
+  g_Emitters.clear();
+  g_Particles.clear();
+  g_Particles.shrink_to_fit();
+}
+
+
+/*
+ * text: Count strings whose values change every frame, each rendered with SDL_ttf into its own
+ * texture and drawn, as 16 does for its one line: the worst case, no string is drawn twice.
+ */
+
+static bool setUpText( int Count )
+{
+  g_Texts.resize( static_cast<size_t>( Count ) );
+
+  return true;
+}
+
+
+static void frameText( void )
+{
+  const SDL_Color Black{ 0, 0, 0, 0xFF };
+  const int       Rows = WINDOW_H / TEXT_LINE_H;
+  char            Text[32];
+
+  clearWindow( g_Renderer );
+
+  for ( size_t i = 0; i != g_Texts.size(); ++i )
+  {
+    const int Line = static_cast<int>( i );
+
+    snprintf( Text, sizeof(Text), "Line %zu: %u", i, static_cast<unsigned>( g_FrameCount ) );
+
+    if ( g_Texts[i].loadFromRenderedText( g_Font, Text, Black ) )
+    {
+      g_Texts[i].render( ( ( Line / Rows ) % TEXT_COLUMNS ) * ( WINDOW_W / TEXT_COLUMNS ), ( Line % Rows ) * TEXT_LINE_H );
+    }
+    else
+    {;}
+  }
+
+  timedPresent( g_Renderer );
+}
+
+
+static void tearDownText( void )
+{
+  g_Texts.clear();
+}
+
+
+/*
+ * windows: the main one and Count - 1 more, each cleared to its own colour, with WINDOW_RECTS
+ * rectangles, and presented every frame.
+ */
+
+static void tearDownWindows( void );
+
+static bool setUpWindows( int Count )
+{
+  for ( int i = 1; i != Count; ++i )
+  {
+    SDL_Window*   Window_Ptr   = SDL_CreateWindow( "SceneBench", 40 + 24 * i, 40 + 24 * i, EXTRA_WINDOW_W, EXTRA_WINDOW_H, SDL_WINDOW_SHOWN );
+    SDL_Renderer* Renderer_Ptr = ( Window_Ptr != NULL ) ? SDL_CreateRenderer( Window_Ptr, -1, 0 ) : NULL;
+
+    if ( Renderer_Ptr == NULL )
+    {
+      printf( "\nUnable to create window %d! SDL Error: %s", i + 1, SDL_GetError() );
+
+      if ( Window_Ptr != NULL )
+      {
+        SDL_DestroyWindow( Window_Ptr );
+      }
+      else
+      {;}
+
+      tearDownWindows();
+      return false;
+    }
+    else
+    {;}
+
+    g_ExtraWindows  .push_back( Window_Ptr );
+    g_ExtraRenderers.push_back( Renderer_Ptr );
+  }
+
+  return true;
+}
+
+
+static void drawWindow( SDL_Renderer* Renderer_Ptr, int Index, int Width, int Height )
+{
+  SDL_SetRenderDrawColor( Renderer_Ptr, static_cast<Uint8>( 0x40 * ( Index % 4 ) ), 0x80, static_cast<Uint8>( 0xFF - 0x10 * ( Index % 16 ) ), 0xFF );
+  SDL_RenderClear( Renderer_Ptr );
+  SDL_SetRenderDrawColor( Renderer_Ptr, 0xFF, 0xFF, 0xFF, 0xFF );
+
+  const int Columns = 8;
+  const int CellW   = Width / Columns;
+  const int CellH   = Height / ( WINDOW_RECTS / Columns );
+
+  for ( int i = 0; i != WINDOW_RECTS; ++i )
+  {
+    const SDL_Rect Box{ ( i % Columns ) * CellW + 2, ( i / Columns ) * CellH + 2, CellW - 4, CellH - 4 };
+
+    SDL_RenderFillRect( Renderer_Ptr, &Box );
+  }
+}
+
+
+static void frameWindows( void )
+{
+  drawWindow( g_Renderer, 0, WINDOW_W, WINDOW_H );
+  timedPresent( g_Renderer );
+
+  for ( size_t i = 0; i != g_ExtraRenderers.size(); ++i )
+  {
+    drawWindow( g_ExtraRenderers[i], static_cast<int>( i ) + 1, EXTRA_WINDOW_W, EXTRA_WINDOW_H );
+    timedPresent( g_ExtraRenderers[i] );
+  }
+}
+
+
+static void tearDownWindows( void )
+{
+  for ( SDL_Renderer* Renderer_Ptr : g_ExtraRenderers )
+  {
+    SDL_DestroyRenderer( Renderer_Ptr );
+  }
+
+  for ( SDL_Window* Window_Ptr : g_ExtraWindows )
+  {
+    SDL_DestroyWindow( Window_Ptr );
+  }
+
+  g_ExtraRenderers.clear();
+  g_ExtraWindows.clear();
+}
+
+
+static const SweepScene SCENES[]
+{
+  { "entities" , "entities" , 250, 256000, false, setUpEntities , frameEntities , tearDownEntities  },
+  { "tiles"    , "map_side" , 16 , 2048  , false, setUpTiles    , frameTiles    , tearDownTiles     },
+  { "particles", "particles", 500, 512000, false, setUpParticles, frameParticles, tearDownParticles },
+  { "text"     , "strings"  , 1  , 256   , true , setUpText     , frameText     , tearDownText      },
+  { "windows"  , "windows"  , 1  , 16    , false, setUpWindows  , frameWindows  , tearDownWindows   },
+};
+
+
+/**
+ * @brief Lets the windows live: the events are read and dropped, but closing one stops the sweep.
+ **/
+static void pumpEvents( void )
+{
+  SDL_Event Event;
+
+  while ( SDL_PollEvent( &Event ) != 0 )
+  {
+    if ( Event.type == SDL_QUIT || ( Event.type == SDL_WINDOWEVENT && Event.window.event == SDL_WINDOWEVENT_CLOSE ) )
+    {
+      g_IsQuitting = true;
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Builds the scene at Value, runs the warm-up frames and then the measured ones.
+ *
+ * @return false if the scene could not be built or the user quit; Result is then not filled.
+ **/
+static bool runStep( const SweepScene& Scene, int Value, size_t Frames, size_t Warmup, StepResult& Result )
+{
+  if ( !Scene.SetUp( Value ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const double        Frequency = static_cast<double>( SDL_GetPerformanceFrequency() );
+  std::vector<double> Times;
+
+  Times.reserve( Frames );
+  g_FrameCount = 0;
+
+  for ( size_t i = 0; i != Warmup && !g_IsQuitting; ++i )
+  {
+    pumpEvents();
+    Scene.Frame();
+    ++g_FrameCount;
+  }
+
+  g_PresentTicks = 0;
+
+  const double CpuStart = processCpuTime_s();
+
+  for ( size_t i = 0; i != Frames && !g_IsQuitting; ++i )
+  {
+    pumpEvents();
+
+    const Uint64 Start = SDL_GetPerformanceCounter();
+
+    Scene.Frame();
+    ++g_FrameCount;
+
+    Times.push_back( static_cast<double>( SDL_GetPerformanceCounter() - Start ) * 1000.0 / Frequency );
+  }
+
+  const double Cpu_s = processCpuTime_s() - CpuStart;
+  size_t       Resident;
+  size_t       Peak;
+
+  // Before TearDown, with the scene still in memory
+  readResidentMemory( Resident, Peak );
+
+  Scene.TearDown();
+
+  if ( g_IsQuitting || Times.empty() )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const double Count = static_cast<double>( Times.size() );
+  double       Total = 0.0;
+
+  for ( double Time : Times )
+  {
+    Total += Time;
+  }
+
+  std::sort( Times.begin(), Times.end() );
+
+  Result.Value            = Value;
+  Result.Frames           = Times.size();
+  Result.Frame_ms         = Total / Count;
+  Result.FrameP50_ms      = Times[Times.size() / 2];
+  Result.FrameP95_ms      = Times[std::min( Times.size() - 1, static_cast<size_t>( Count * 0.95 ) )];
+  Result.FrameMax_ms      = Times.back();
+  Result.Cpu_ms           = Cpu_s * 1000.0 / Count;
+  Result.Present_ms       = static_cast<double>( g_PresentTicks ) * 1000.0 / Frequency / Count;
+  Result.Resident_KiB     = Resident / 1024;
+  Result.PeakResident_KiB = Peak / 1024;
+
+  return true;
+}
+
+
+static void writeCsvRow( FILE* File_Ptr, const SweepScene& Scene, const StepResult& Result )
+{
+  fprintf( File_Ptr, "%s,%s,%d,%zu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%zu,%zu\n", Scene.Name, Scene.Parameter, Result.Value, Result.Frames,
+           Result.Frame_ms, Result.FrameP50_ms, Result.FrameP95_ms, Result.FrameMax_ms, Result.Cpu_ms, Result.Present_ms,
+           Result.Resident_KiB, Result.PeakResident_KiB );
+}
+
+
+/***************************************************************************************************
+* Main function
+****************************************************************************************************/
+
+int main( int argc, char* args[] )
+{
+  const char* Filter       = "";
+  const char* FontPath     = NULL;
+  const char* CsvPath      = NULL;
+  size_t      Frames       = DEFAULT_FRAMES;
+  size_t      Warmup       = DEFAULT_WARMUP;
+  double      MaxFrame_ms  = DEFAULT_MAX_FRAME_MS;
+  bool        IsHeadless   = false;
+
+  for ( int i = 1; i != argc; ++i )
+  {
+    if ( strncmp( args[i], "--scene=", strlen("--scene=") ) == 0 )
+    {
+      Filter = args[i] + strlen("--scene=");
+    }
+    else if ( strncmp( args[i], "--frames=", strlen("--frames=") ) == 0 )
+    {
+      Frames = std::max<size_t>( 1, strtoul( args[i] + strlen("--frames="), NULL, 10 ) );
+    }
+    else if ( strncmp( args[i], "--warmup=", strlen("--warmup=") ) == 0 )
+    {
+      Warmup = strtoul( args[i] + strlen("--warmup="), NULL, 10 );
+    }
+    else if ( strncmp( args[i], "--max-frame-ms=", strlen("--max-frame-ms=") ) == 0 )
+    {
+      MaxFrame_ms = atof( args[i] + strlen("--max-frame-ms=") );
+    }
+    else if ( strncmp( args[i], "--font=", strlen("--font=") ) == 0 )
+    {
+      FontPath = args[i] + strlen("--font=");
+    }
+    else if ( strncmp( args[i], "--csv=", strlen("--csv=") ) == 0 )
+    {
+      CsvPath = args[i] + strlen("--csv=");
+    }
+    else if ( strcmp( args[i], "--headless" ) == 0 )
+    {
+      IsHeadless = true;
+    }
+    else
+    {
+      printf( "\nUsage: SceneBench [--scene=<name>] [--frames=<n>] [--warmup=<n>] [--max-frame-ms=<ms>] [--font=<ttf>] [--headless] [--csv=<file>]\n" );
+      return 1;
+    }
+  }
+
+  if ( IsHeadless )
+  {
+    SDL_setenv( "SDL_VIDEODRIVER", "dummy", 1 );
+    SDL_SetHint( SDL_HINT_RENDER_DRIVER, "software" );
+  }
+  else
+  {;}
+
+  // Unpaced: the hint wins over SDL_RENDERER_PRESENTVSYNC and the driver's default
+  SDL_SetHint( SDL_HINT_RENDER_VSYNC, "0" );
+
+  if ( SDL_Init( SDL_INIT_VIDEO ) < 0 || TTF_Init() == -1 )
+  {
+    printf( "\nSDL could not initialise! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  g_Window   = SDL_CreateWindow( "SceneBench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WINDOW_W, WINDOW_H, SDL_WINDOW_SHOWN );
+  g_Renderer = ( g_Window != NULL ) ? SDL_CreateRenderer( g_Window, -1, IsHeadless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED ) : NULL;
+
+  bool IsReady = ( g_Renderer != NULL );
+
+  if ( !IsReady )
+  {
+    printf( "\nUnable to create the window and its renderer! SDL Error: %s", SDL_GetError() );
+  }
+  else if ( FontPath != NULL && ( g_Font = TTF_OpenFont( FontPath, FONT_SIZE ) ) == NULL )
+  {
+    printf( "\nUnable to open \"%s\"! SDL_ttf Error: %s", FontPath, TTF_GetError() );
+    IsReady = false;
+  }
+  else
+  {
+    LTexture::SetDefaultRenderer( g_Renderer );
+
+    IsReady = createTextures() && g_Jobs.init();
+  }
+
+  FILE* Csv_Ptr = ( IsReady && CsvPath != NULL ) ? fopen( CsvPath, "w" ) : NULL;
+
+  if ( IsReady && CsvPath != NULL && Csv_Ptr == NULL )
+  {
+    printf( "\nUnable to write \"%s\"!", CsvPath );
+    IsReady = false;
+  }
+  else if ( Csv_Ptr != NULL )
+  {
+    fprintf( Csv_Ptr, "scene,parameter,value,frames,frame_ms,frame_p50_ms,frame_p95_ms,frame_max_ms,cpu_ms,present_ms,resident_kib,peak_resident_kib\n" );
+  }
+  else
+  {;}
+
+  if ( IsReady )
+  {
+    SDL_RendererInfo Info;
+
+    SDL_GetRendererInfo( g_Renderer, &Info );
+
+    printf( "\nRenderer: %s, %d job workers, %s movement kernel", Info.name, g_Jobs.GetWorkerCount(), GetEntityKernel() );
+    printf( "\n%-10s %-10s %8s %10s %10s %10s %10s %10s %12s\n", "Scene", "Parameter", "Value", "Frame ms", "p95 ms", "CPU ms", "Present ms", "RSS KiB", "Peak KiB" );
+
+    g_Entities.attach( g_Positions  );
+    g_Entities.attach( g_Velocities );
+    g_Entities.attach( g_Boxes      );
+    g_Entities.attach( g_Sprites    );
+  }
+  else
+  {;}
+
+  for ( const auto& Scene : SCENES )
+  {
+    if ( !IsReady || g_IsQuitting || strstr( Scene.Name, Filter ) == NULL )
+    {
+      continue;
+    }
+    else if ( Scene.NeedsFont && g_Font == NULL )
+    {
+      printf( "%-10s %-10s %8s\n", Scene.Name, Scene.Parameter, "skipped: no --font" );
+      continue;
+    }
+    else
+    {;}
+
+    for ( int Value = Scene.First; Value <= Scene.Last; Value *= 2 )
+    {
+      StepResult Result;
+
+      if ( !runStep( Scene, Value, Frames, Warmup, Result ) )
+      {
+        break;
+      }
+      else
+      {;}
+
+      printf( "%-10s %-10s %8d %10.3f %10.3f %10.3f %10.3f %10zu %12zu\n", Scene.Name, Scene.Parameter, Result.Value, Result.Frame_ms,
+              Result.FrameP95_ms, Result.Cpu_ms, Result.Present_ms, Result.Resident_KiB, Result.PeakResident_KiB );
+
+      if ( Csv_Ptr != NULL )
+      {
+        writeCsvRow( Csv_Ptr, Scene, Result );
+        fflush( Csv_Ptr ); // A sweep can be long: keep what was measured if it is stopped
+      }
+      else
+      {;}
+
+      if ( Result.Frame_ms > MaxFrame_ms )
+      {
+        printf( "%-10s stopped: frames over %.1f ms\n", Scene.Name, MaxFrame_ms );
+        break;
+      }
+      else
+      {;}
+    }
+  }
+
+  const bool IsWritten = ( Csv_Ptr == NULL || fclose( Csv_Ptr ) == 0 );
+
+  g_Entities.clear();
+  g_Texts.clear();
+  g_Dot.free();
+  g_TileSheet.free();
+  g_Particle.free();
+  g_Jobs.shutdown();
+
+  if ( g_Font != NULL )
+  {
+    TTF_CloseFont( g_Font );
+  }
+  else
+  {;}
+
+  SDL_DestroyRenderer( g_Renderer );
+  SDL_DestroyWindow( g_Window );
+  TTF_Quit();
+  SDL_Quit();
+
+  return ( IsReady && IsWritten ) ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file SliceChunks.cpp
+ *
+ * @brief Offline level slicer: cuts a large level image into square chunks and writes the chunk
+ * map that LChunkStreamer streams them from, so that only the chunks around the camera are loaded.
+ *
+ * Usage:
+ *   SliceChunks [--chunk-size=<px>] <image> [<map>]
+ *
+ * The chunks are <px> pixels a side (512 by default); those of the last column and row hold what is
+ * left of the image. They are written next to <map> as "<map name>_<column>_<row>.png", except the
+ * fully transparent ones, which are only marked as absent in the map. <map> defaults to the image
+ * with the ".chunks" extension.
+ **/
+
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include <SDL.h>
+#include <SDL_image.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "LChunkStreamer.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const int DEFAULT_CHUNK_SIZE = 512;
+static const int MIN_CHUNK_SIZE     = 16;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return the path without its extension.
+ **/
+static std::string withoutExtension( const std::string& Path )
+{
+  const size_t Separator = Path.find_last_of( "/\\" );
+  const size_t Dot       = Path.find_last_of( '.' );
+
+  return ( Dot != std::string::npos && ( Separator == std::string::npos || Dot > Separator ) ) ? Path.substr( 0, Dot ) : Path;
+}
+
+
+/**
+ * @return true if every pixel of an ARGB8888 surface is fully transparent.
+ **/
+static bool isTransparent( const SDL_Surface* Surface_Ptr )
+{
+  for ( int y = 0; y != Surface_Ptr->h; ++y )
+  {
+    const Uint32* Row = reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( Surface_Ptr->pixels ) + y * Surface_Ptr->pitch );
+
+    for ( int x = 0; x != Surface_Ptr->w; ++x )
+    {
+      if ( ( Row[x] & 0xFF000000u ) != 0 )
+      {
+        return false;
+      }
+      else
+      {;}
+    }
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Copies one chunk of the level and writes it, unless it is fully transparent.
+ *
+ * @param Present Set to 1 if the chunk was written, 0 if it was left out.
+ * @return false if the chunk could not be written.
+ **/
+static bool writeChunk( SDL_Surface* Level_Ptr, const SDL_Rect& Area, const std::string& Path, Uint8& Present )
+{
+  SDL_Surface* Chunk_Ptr = SDL_CreateRGBSurfaceWithFormat( 0, Area.w, Area.h, 32, SDL_PIXELFORMAT_ARGB8888 );
+
+  if ( Chunk_Ptr == NULL )
+  {
+    printf( "\nUnable to create a %dx%d chunk! SDL Error: %s", Area.w, Area.h, SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Rect Source = Area;
+  bool     Success = SDL_BlitSurface( Level_Ptr, &Source, Chunk_Ptr, NULL ) == 0;
+
+  if ( Success && isTransparent( Chunk_Ptr ) )
+  {
+    Present = 0;
+  }
+  else if ( Success )
+  {
+    Present = 1;
+    Success = IMG_SavePNG( Chunk_Ptr, Path.c_str() ) == 0;
+  }
+  else
+  {;}
+
+  if ( !Success )
+  {
+    printf( "\nUnable to write \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Chunk_Ptr );
+
+  return Success;
+}
+
+
+/***************************************************************************************************
+* Main function
+****************************************************************************************************/
+
+int main( int argc, char* argv[] )
+{
+  int         ChunkSize = DEFAULT_CHUNK_SIZE;
+  std::string ImagePath;
+  std::string MapPath;
+
+  static const char ChunkSizeOption[] = "--chunk-size=";
+
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], ChunkSizeOption, strlen( ChunkSizeOption ) ) == 0 )
+    {
+      ChunkSize = atoi( argv[i] + strlen( ChunkSizeOption ) );
+    }
+    else if ( ImagePath.empty() )
+    {
+      ImagePath = argv[i];
+    }
+    else
+    {
+      MapPath = argv[i];
+    }
+  }
+
+  if ( ImagePath.empty() || ChunkSize < MIN_CHUNK_SIZE )
+  {
+    printf( "Usage: SliceChunks [--chunk-size=<px>] <image> [<map>]\n"
+            "       <px> of --chunk-size is %d or more\n", MIN_CHUNK_SIZE );
+    return 1;
+  }
+  else
+  {;}
+
+  MapPath = MapPath.empty() ? withoutExtension( ImagePath ) + LCHUNKS_EXTENSION : MapPath;
+
+  if ( SDL_Init( 0 ) < 0 )
+  {
+    printf( "\nSDL could not initialize! SDL Error: %s\n", SDL_GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  IMG_Init( IMG_INIT_PNG | IMG_INIT_JPG );
+
+  SDL_Surface* Loaded = IMG_Load( ImagePath.c_str() );
+  SDL_Surface* Level  = ( Loaded != NULL ) ? SDL_ConvertSurfaceFormat( Loaded, SDL_PIXELFORMAT_ARGB8888, 0 ) : NULL;
+
+  SDL_FreeSurface( Loaded );
+
+  bool Success = Level != NULL;
+
+  if ( !Success )
+  {
+    printf( "\nUnable to load \"%s\"! SDL_image Error: %s", ImagePath.c_str(), IMG_GetError() );
+  }
+  else
+  {
+    // Copied as they are, alpha included
+    SDL_SetSurfaceBlendMode( Level, SDL_BLENDMODE_NONE );
+  }
+
+  LChunkMapHeader    Header;
+  std::vector<Uint8> Present;
+  int                Written = 0;
+
+  memset( &Header, 0, sizeof(Header) );
+
+  if ( Success )
+  {
+    memcpy( Header.Magic, LCHUNKS_MAGIC, sizeof(Header.Magic) );
+    Header.Version   = LCHUNKS_VERSION;
+    Header.LevelW    = Level->w;
+    Header.LevelH    = Level->h;
+    Header.ChunkSize = ChunkSize;
+    Header.Columns   = ( Level->w + ChunkSize - 1 ) / ChunkSize;
+    Header.Rows      = ( Level->h + ChunkSize - 1 ) / ChunkSize;
+
+    Present.resize( static_cast<size_t>( Header.Columns ) * static_cast<size_t>( Header.Rows ) );
+  }
+  else
+  {;}
+
+  const std::string Stem = withoutExtension( MapPath );
+
+  for ( int Row = 0; Success && Row != Header.Rows; ++Row )
+  {
+    for ( int Column = 0; Success && Column != Header.Columns; ++Column )
+    {
+      const SDL_Rect    Area{ Column * ChunkSize, Row * ChunkSize, SDL_min( ChunkSize, Level->w - Column * ChunkSize ), SDL_min( ChunkSize, Level->h - Row * ChunkSize ) };
+      const std::string Path = Stem + "_" + std::to_string( Column ) + "_" + std::to_string( Row ) + ".png";
+      Uint8&            Flag = Present[ static_cast<size_t>( Row ) * static_cast<size_t>( Header.Columns ) + static_cast<size_t>( Column ) ];
+
+      Success  = writeChunk( Level, Area, Path, Flag );
+      Written += Flag;
+    }
+  }
+
+  if ( Success )
+  {
+    SDL_RWops* Output = SDL_RWFromFile( MapPath.c_str(), "wb" );
+
+    Success = ( Output != NULL )
+              && SDL_RWwrite( Output, &Header, sizeof(Header), 1 ) == 1
+              && SDL_RWwrite( Output, Present.data(), 1, Present.size() ) == Present.size();
+
+    if ( Output != NULL )
+    {
+      Success = ( SDL_RWclose( Output ) == 0 ) && Success;
+    }
+    else
+    {;}
+
+    if ( Success )
+    {
+      printf( "%s: %dx%d chunks of %d pixels, %d written\n", MapPath.c_str(), Header.Columns, Header.Rows, ChunkSize, Written );
+    }
+    else
+    {
+      printf( "\nUnable to write \"%s\"! SDL Error: %s", MapPath.c_str(), SDL_GetError() );
+    }
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Level );
+
+  IMG_Quit();
+  SDL_Quit();
+
+  return Success ? 0 : 1;
+}
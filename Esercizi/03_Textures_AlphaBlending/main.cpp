@@ -28,6 +28,14 @@
  * - Aggiornamento della finestra con "SDL_RenderPresent"
  * - Liberazione risorse mediante metodi "SDL_Destroy"
  * - Liberazione sottosistemi mediante metodi "_Quit"
+ *
+ * Aggiunta GS: con "USE_PREMULTIPLIED_ALPHA" a true le immagini e i testi con canale alpha vengono
+ * premoltiplicati al caricamento, con i kernel SIMD di "PremultiplyAlpha" (Engine_Lib/LPixelOps),
+ * e disegnati con un blending mode premoltiplicato ("SDL_ComposeCustomBlendMode"); l'alpha
+ * modulation va allora applicata anche ai colori, con "SDL_SetTextureColorMod". I disegni non
+ * vengono più eseguiti subito, ma accodati con "QueueDraw" e ordinati da "FlushDraws": livello per
+ * livello, prima quelli opachi, senza blending, poi quelli trasparenti. La texture senza canale
+ * alpha, con alpha modulation al massimo, non viene quindi miscelata affatto.
  **/
 
 /***************************************************************************************************
@@ -37,9 +45,12 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
+#include <algorithm>
 #include <cstdio>
 #include <string>
+#include <vector>
 #include "colours.hpp"
+#include "LPixelOps.hpp"
 
 
 /**************************************************************************************************
@@ -75,6 +86,37 @@ static const std::string FontPath               ("RachelBrown.ttf");
 static const std::string Prompt_1("\nPress UP or DOWN arrow keys");
 static const std::string Prompt_2("\nPress any other key to reset");
 
+// true: textures with an alpha channel are premultiplied at load time and drawn with a premultiplied
+// blend mode. false: straight alpha and SDL_BLENDMODE_BLEND
+static constexpr bool USE_PREMULTIPLIED_ALPHA = true;
+
+// Draws of the same layer must not overlap: within a layer, the opaque ones are drawn first
+static constexpr int LAYER_IMAGES = 0;
+static constexpr int LAYER_TEXT   = 1;
+
+/**
+ * @brief A texture, its size and whether it has an alpha channel.
+ **/
+struct Asset
+{
+  SDL_Texture* Texture_Ptr;
+  int          W;
+  int          H;
+  bool         HasAlpha;
+};
+
+/**
+ * @brief A queued SDL_RenderCopy.
+ **/
+struct DrawCommand
+{
+  const Asset* Asset_Ptr;
+  SDL_Rect     Dest;
+  Uint8        Alpha;    // Alpha modulation
+  int          Layer;    // Lower layers are drawn first
+  bool         IsOpaque; // Drawn without blending
+};
+
 
 /***************************************************************************************************
 * Private global variables
@@ -83,22 +125,15 @@ static const std::string Prompt_2("\nPress any other key to reset");
 static SDL_Window*   g_Window   (NULL); // The window we'll be rendering to
 static SDL_Renderer* g_Renderer (NULL); // The window renderer
 
-static SDL_Texture*  g_RedDotCyanBG_Tex  (NULL);
-static SDL_Texture*  g_RedDotAlphaBG_Tex (NULL);
-static SDL_Texture*  g_Text1_Tex         (NULL);
-static SDL_Texture*  g_Text2_Tex         (NULL);
+static Asset         g_RedDotCyanBG  {NULL, 0, 0, false};
+static Asset         g_RedDotAlphaBG {NULL, 0, 0, false};
+static Asset         g_Text1         {NULL, 0, 0, false};
+static Asset         g_Text2         {NULL, 0, 0, false};
 
 static TTF_Font*     g_Font (NULL); // Globally used font
 
-static int g_RedDotCyanBG_W  (0);
-static int g_RedDotCyanBG_H  (0);
-static int g_RedDotAlphaBG_W (0);
-static int g_RedDotAlphaBG_H (0);
-
-static int g_Text1_Tex_W (0);
-static int g_Text1_Tex_H (0);
-static int g_Text2_Tex_W (0);
-static int g_Text2_Tex_H (0);
+static SDL_BlendMode            g_BlendedMode (SDL_BLENDMODE_BLEND); // Used by the draws that are not opaque
+static std::vector<DrawCommand> g_DrawList;                          // Filled every frame, its storage kept
 
 
 /***************************************************************************************************
@@ -116,6 +151,101 @@ static void PressEnter(void)
 }
 
 
+/**
+ * @brief Creates the texture of an asset from a surface, which is freed. With USE_PREMULTIPLIED_ALPHA,
+ * a surface with an alpha channel is converted to ARGB8888 and premultiplied first.
+ *
+ * @return bool false if the surface is NULL or the texture could not be created.
+ **/
+static bool LoadAsset( SDL_Surface* Surface_Ptr, Asset& Target )
+{
+  if ( Surface_Ptr == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Target.HasAlpha = SDL_ISPIXELFORMAT_ALPHA( Surface_Ptr->format->format );
+
+  if ( USE_PREMULTIPLIED_ALPHA && Target.HasAlpha )
+  {
+    SDL_Surface* Converted_Ptr = SDL_ConvertSurfaceFormat( Surface_Ptr, SDL_PIXELFORMAT_ARGB8888, 0 );
+
+    SDL_FreeSurface( Surface_Ptr );
+    Surface_Ptr = Converted_Ptr;
+
+    if ( Surface_Ptr == NULL )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    SDL_LockSurface( Surface_Ptr );
+    PremultiplyAlpha( static_cast<Uint32*>( Surface_Ptr->pixels ),
+                      static_cast<size_t>( Surface_Ptr->pitch / 4 ) * static_cast<size_t>( Surface_Ptr->h ),
+                      Surface_Ptr->format->format );
+    SDL_UnlockSurface( Surface_Ptr );
+  }
+  else
+  {;}
+
+  Target.Texture_Ptr = SDL_CreateTextureFromSurface( g_Renderer, Surface_Ptr );
+  Target.W           = Surface_Ptr->w;
+  Target.H           = Surface_Ptr->h;
+
+  SDL_FreeSurface( Surface_Ptr );
+
+  return Target.Texture_Ptr != NULL;
+}
+
+
+/**
+ * @brief Queues a copy of a whole asset, drawn by the next "FlushDraws".
+ **/
+static void QueueDraw( const Asset& Source, int X, int Y, Uint8 Alpha, int Layer )
+{
+  const bool IsOpaque = !Source.HasAlpha && Alpha == MAX_ALPHA;
+
+  g_DrawList.push_back( DrawCommand{ &Source, SDL_Rect{ X, Y, Source.W, Source.H }, Alpha, Layer, IsOpaque } );
+}
+
+
+/**
+ * @brief Draws the queued copies layer by layer: in each layer the opaque ones first, without
+ * blending, then the others, in the order they were queued. The draws of a layer do not overlap, so
+ * the picture is the same as in queue order, but the blend mode changes at most twice per layer and
+ * opaque pixels are written without reading the frame.
+ *
+ * Without a depth buffer, drawing the opaque copies front to back would not spare any pixel: the
+ * order within a layer only groups the blend modes.
+ **/
+static void FlushDraws( void )
+{
+  std::stable_sort( g_DrawList.begin(), g_DrawList.end(),
+                    []( const DrawCommand& A, const DrawCommand& B )
+                    {
+                      return ( A.Layer != B.Layer ) ? ( A.Layer < B.Layer ) : ( A.IsOpaque && !B.IsOpaque );
+                    } );
+
+  for ( const auto& Command : g_DrawList )
+  {
+    SDL_Texture* Texture_Ptr = Command.Asset_Ptr->Texture_Ptr;
+
+    // Premultiplied colours are faded together with alpha
+    const Uint8 ColourMod = USE_PREMULTIPLIED_ALPHA ? Command.Alpha : MAX_ALPHA;
+
+    SDL_SetTextureBlendMode( Texture_Ptr, Command.IsOpaque ? SDL_BLENDMODE_NONE : g_BlendedMode );
+    SDL_SetTextureAlphaMod ( Texture_Ptr, Command.Alpha );
+    SDL_SetTextureColorMod ( Texture_Ptr, ColourMod, ColourMod, ColourMod );
+    SDL_RenderCopy( g_Renderer, Texture_Ptr, NULL, &Command.Dest );
+  }
+
+  g_DrawList.clear();
+}
+
+
 /***************************************************************************************************
 * Main function
 ****************************************************************************************************/
@@ -239,17 +369,24 @@ int main( int argc, char* args[] )
     printf( "\nOK: \"%s\" font loaded", FontPath.c_str() );
   }
 
-  /* Load textures from PNG */
+  /* Blending mode of the textures that are not opaque */
 
-  g_RedDotCyanBG_Tex  = IMG_LoadTexture( g_Renderer, PNGImageWithCyanBGPath.c_str() );
-  g_RedDotAlphaBG_Tex = IMG_LoadTexture( g_Renderer, PNGImageWithAlphaBGPath.c_str() );
+  if ( USE_PREMULTIPLIED_ALPHA )
+  {
+    g_BlendedMode = SDL_ComposeCustomBlendMode( SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+                                                SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD );
+  }
+  else
+  {;}
+
+  /* Load textures from PNG */
 
-  if( g_RedDotCyanBG_Tex == NULL )
+  if( !LoadAsset( IMG_Load( PNGImageWithCyanBGPath.c_str() ), g_RedDotCyanBG ) )
   {
     printf( "\nUnable to create texture from \"%s\"! SDL Error: \"%s\"\n", PNGImageWithCyanBGPath.c_str(), SDL_GetError() );
     HasProgramSucceeded = false;
   }
-  else if (  g_RedDotAlphaBG_Tex == NULL )
+  else if ( !LoadAsset( IMG_Load( PNGImageWithAlphaBGPath.c_str() ), g_RedDotAlphaBG ) )
   {
     printf( "\nUnable to create texture from \"%s\"! SDL Error: \"%s\"\n", PNGImageWithAlphaBGPath.c_str(), SDL_GetError() );
     HasProgramSucceeded = false;
@@ -262,51 +399,32 @@ int main( int argc, char* args[] )
 
   /* Caricamento texture da font */
 
-  SDL_Color    TextColour_FG{BLACK_R, BLACK_G, BLACK_B, BLACK_A};
-  SDL_Surface* TempSurface_1 = TTF_RenderText_Blended( g_Font, Prompt_1.c_str(), TextColour_FG );
-  SDL_Surface* TempSurface_2 = TTF_RenderText_Blended( g_Font, Prompt_2.c_str(), TextColour_FG );
+  SDL_Color TextColour_FG{BLACK_R, BLACK_G, BLACK_B, BLACK_A};
 
-  if( TempSurface_1 == NULL || TempSurface_2 == NULL )
+  if( !LoadAsset( TTF_RenderText_Blended( g_Font, Prompt_1.c_str(), TextColour_FG ), g_Text1 ) ||
+      !LoadAsset( TTF_RenderText_Blended( g_Font, Prompt_2.c_str(), TextColour_FG ), g_Text2 )    )
   {
-    printf( "\nUnable to render text surfaces! SDL_ttf Error: \"%s\"", TTF_GetError() );
+    printf( "\nUnable to create textures from rendered text! SDL Error: \"%s\"", SDL_GetError() );
     HasProgramSucceeded = false;
   }
   else
   {
-    printf( "\nOK: text surfaces loaded" );
+    printf( "\nOK: text textures created" );
   }
 
-  // Create texture from surface pixels
-  g_Text1_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface_1 );
-  g_Text2_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface_2 );
+  /* Verifica del blending mode delle textures */
 
-  if( g_Text1_Tex == NULL || g_Text2_Tex == NULL )
+  if ( g_RedDotAlphaBG.Texture_Ptr != NULL && SDL_SetTextureBlendMode( g_RedDotAlphaBG.Texture_Ptr, g_BlendedMode ) != 0 )
   {
-    printf( "\nUnable to create textures from rendered text! SDL Error: \"%s\"", SDL_GetError() );
+    printf( "\nBlending mode not supported by the renderer! SDL Error: \"%s\"", SDL_GetError() );
     HasProgramSucceeded = false;
   }
   else
   {
-    printf( "\nOK: text textures created" );
+    printf( "\nOK: blending mode set" );
   }
 
-  // Get rid of old surfaces
-  SDL_FreeSurface( TempSurface_1 );
-  SDL_FreeSurface( TempSurface_2 );
-  TempSurface_1 = NULL;
-  TempSurface_2 = NULL;
-
-  /* Ottenimento delle dimensioni delle textures */
-
-  SDL_QueryTexture( g_RedDotAlphaBG_Tex, NULL, NULL, &g_RedDotAlphaBG_W, &g_RedDotAlphaBG_H );
-  SDL_QueryTexture( g_RedDotCyanBG_Tex , NULL, NULL, &g_RedDotCyanBG_W , &g_RedDotCyanBG_H  );
-  SDL_QueryTexture( g_Text1_Tex        , NULL, NULL, &g_Text1_Tex_W    , &g_Text1_Tex_H     );
-  SDL_QueryTexture( g_Text2_Tex        , NULL, NULL, &g_Text2_Tex_W    , &g_Text2_Tex_H     );
-
-  /* Impostazione del blending mode delle textures */
-
-  SDL_SetTextureBlendMode( g_RedDotCyanBG_Tex,  SDL_BLENDMODE_BLEND );
-  SDL_SetTextureBlendMode( g_RedDotAlphaBG_Tex, SDL_BLENDMODE_BLEND );
+  g_DrawList.reserve( 4 );
 
   /* Preparing for main loop */
 
@@ -370,19 +488,12 @@ int main( int argc, char* args[] )
     SDL_RenderClear( g_Renderer );
 
     // Render textures to screen
-    SDL_Rect CyanDest {   0                             , 0            , g_RedDotCyanBG_W , g_RedDotCyanBG_H  };
-    SDL_Rect AlphaDest{   WINDOW_W - g_RedDotAlphaBG_W  , 0            , g_RedDotAlphaBG_W, g_RedDotAlphaBG_H };
-    SDL_Rect Text1Dest{ ( WINDOW_W - g_Text1_Tex_W ) / 2, 0            , g_Text1_Tex_W    , g_Text1_Tex_H     };
-    SDL_Rect Text2Dest{ ( WINDOW_W - g_Text2_Tex_W ) / 2, g_Text1_Tex_H, g_Text2_Tex_W    , g_Text2_Tex_H     };
-
-    SDL_RenderCopy( g_Renderer, g_RedDotCyanBG_Tex , NULL, &CyanDest  );
-    SDL_RenderCopy( g_Renderer, g_RedDotAlphaBG_Tex, NULL, &AlphaDest );
-    SDL_RenderCopy( g_Renderer, g_Text1_Tex        , NULL, &Text1Dest );
-    SDL_RenderCopy( g_Renderer, g_Text2_Tex        , NULL, &Text2Dest );
+    QueueDraw( g_RedDotCyanBG ,   0                           , 0        , Alpha    , LAYER_IMAGES );
+    QueueDraw( g_RedDotAlphaBG,   WINDOW_W - g_RedDotAlphaBG.W, 0        , Alpha    , LAYER_IMAGES );
+    QueueDraw( g_Text1        , ( WINDOW_W - g_Text1.W ) / 2  , 0        , MAX_ALPHA, LAYER_TEXT   );
+    QueueDraw( g_Text2        , ( WINDOW_W - g_Text2.W ) / 2  , g_Text1.H, MAX_ALPHA, LAYER_TEXT   );
 
-    // Set alpha
-    SDL_SetTextureAlphaMod( g_RedDotCyanBG_Tex , Alpha );
-    SDL_SetTextureAlphaMod( g_RedDotAlphaBG_Tex, Alpha );
+    FlushDraws();
 
     // Update screen
     SDL_RenderPresent( g_Renderer );
@@ -390,14 +501,14 @@ int main( int argc, char* args[] )
 
   /* Free resources and close SDL */
 
-  SDL_DestroyTexture ( g_RedDotCyanBG_Tex );
-  SDL_DestroyTexture ( g_RedDotAlphaBG_Tex );
-  SDL_DestroyTexture ( g_Text1_Tex );
-  SDL_DestroyTexture ( g_Text2_Tex );
+  SDL_DestroyTexture ( g_RedDotCyanBG.Texture_Ptr );
+  SDL_DestroyTexture ( g_RedDotAlphaBG.Texture_Ptr );
+  SDL_DestroyTexture ( g_Text1.Texture_Ptr );
+  SDL_DestroyTexture ( g_Text2.Texture_Ptr );
   SDL_DestroyRenderer( g_Renderer );
   SDL_DestroyWindow  ( g_Window );
-  g_RedDotCyanBG_Tex  = NULL;
-  g_RedDotAlphaBG_Tex = NULL;
+  g_RedDotCyanBG.Texture_Ptr  = NULL;
+  g_RedDotAlphaBG.Texture_Ptr = NULL;
   g_Renderer          = NULL;
   g_Window            = NULL;
 
@@ -25,6 +25,12 @@
  *   texture centrale, per cambiare il testo
  * - Liberazione risorse mediante metodi "SDL_Destroy"
  * - Liberazione sottosistemi mediante metodi "_Quit"
+ *
+ * Aggiunta GS: con "USE_PROMPT_ATLAS" a true lo sprite sheet descritto sopra viene costruito
+ * all'avvio: tutti i testi di "Prompts_Vec" sono renderizzati in bianco, uno sotto l'altro, in
+ * un'unica texture, e il colore viene dato al momento del disegno con "SDL_SetTextureColorMod".
+ * Cambiare testo significa solo cambiare il rettangolo sorgente: nel main loop non viene più creata
+ * alcuna superficie o texture.
  **/
 
 /***************************************************************************************************
@@ -53,6 +59,10 @@ static constexpr int FONT_SIZE =  50;
 // static const std::string FontPath ("RachelBrown.ttf");
 static const std::string FontPath ("georgia.ttf");
 
+// true: every prompt is rasterised once, at start-up, into one texture, and switching prompt only
+// changes the source rectangle. false: the third text is rendered again at every change
+static constexpr bool USE_PROMPT_ATLAS = true;
+
 enum class PromptMessages
 {
   Press_UP_or_DOWN_arrow_keys,
@@ -91,6 +101,9 @@ static SDL_Rect      g_Text3_Size{0, 0, 0, 0};
 
 static TTF_Font*     g_Font (NULL); // Globally used font
 
+static SDL_Texture*  g_Prompts_Tex (NULL); // Every prompt, in white, one below the other
+static SDL_Rect      g_Prompts_Clips[static_cast<size_t>(PromptMessages::HOW_MANY)]; // Where each prompt is in g_Prompts_Tex
+
 
 /***************************************************************************************************
 * Private functions definitions
@@ -107,6 +120,88 @@ static void PressEnter(void)
 }
 
 
+/**
+ * @brief Renders every prompt in white and copies them, one below the other, into a single texture.
+ * The clip of each prompt is stored in g_Prompts_Clips.
+ *
+ * @return SDL_Texture* The texture, or NULL on failure.
+ **/
+static SDL_Texture* CreatePromptAtlas( TTF_Font* Font_Ptr, SDL_Renderer* Renderer_Ptr )
+{
+  const SDL_Color White{ WHITE_R, WHITE_G, WHITE_B, WHITE_A };
+
+  std::vector<SDL_Surface*> Lines_Vec;
+  int AtlasW = 0;
+  int AtlasH = 0;
+
+  for ( size_t i = 0; i != static_cast<size_t>(PromptMessages::HOW_MANY); ++i )
+  {
+    SDL_Surface* Line = TTF_RenderText_Blended( Font_Ptr, Prompts_Vec[i].c_str(), White );
+
+    if ( Line == NULL )
+    {
+      printf( "\nUnable to render \"%s\"! SDL_ttf Error: \"%s\"", Prompts_Vec[i].c_str(), TTF_GetError() );
+      break;
+    }
+    else
+    {;}
+
+    g_Prompts_Clips[i] = SDL_Rect{ 0, AtlasH, Line->w, Line->h };
+    AtlasW  = ( Line->w > AtlasW ) ? Line->w : AtlasW;
+    AtlasH += Line->h;
+    Lines_Vec.push_back( Line );
+  }
+
+  SDL_Texture* Atlas_Tex = NULL;
+
+  if ( Lines_Vec.size() == static_cast<size_t>(PromptMessages::HOW_MANY) )
+  {
+    SDL_Surface* Atlas = SDL_CreateRGBSurfaceWithFormat( 0, AtlasW, AtlasH, 32, SDL_PIXELFORMAT_RGBA32 );
+
+    if ( Atlas != NULL )
+    {
+      for ( size_t i = 0; i != Lines_Vec.size(); ++i )
+      {
+        SDL_Rect Dest = g_Prompts_Clips[i]; // SDL_BlitSurface may change it
+
+        SDL_SetSurfaceBlendMode( Lines_Vec[i], SDL_BLENDMODE_NONE ); // Copy the alpha as it is
+        SDL_BlitSurface( Lines_Vec[i], NULL, Atlas, &Dest );
+      }
+
+      Atlas_Tex = SDL_CreateTextureFromSurface( Renderer_Ptr, Atlas );
+      SDL_SetTextureBlendMode( Atlas_Tex, SDL_BLENDMODE_BLEND );
+      SDL_FreeSurface( Atlas );
+    }
+    else
+    {
+      printf( "\nUnable to create the prompt atlas surface! SDL Error: \"%s\"", SDL_GetError() );
+    }
+  }
+  else
+  {;}
+
+  for ( auto Line : Lines_Vec )
+  {
+    SDL_FreeSurface( Line );
+  }
+
+  return Atlas_Tex;
+}
+
+
+/**
+ * @brief Draws a prompt of the atlas, horizontally centred, with its top at Y.
+ **/
+static void RenderPrompt( size_t Index, SDL_Color Colour, int Y )
+{
+  const SDL_Rect& Clip = g_Prompts_Clips[Index];
+  SDL_Rect        Dest{ ( WINDOW_W - Clip.w ) / 2, Y, Clip.w, Clip.h };
+
+  SDL_SetTextureColorMod( g_Prompts_Tex, Colour.r, Colour.g, Colour.b );
+  SDL_RenderCopy( g_Renderer, g_Prompts_Tex, &Clip, &Dest );
+}
+
+
 /***************************************************************************************************
 * Main function
 ****************************************************************************************************/
@@ -240,48 +335,67 @@ int main( int argc, char* args[] )
   size_t Index2 = static_cast<size_t>(PromptMessages::Press_any_other_key_to_reset);
   size_t Index3 = static_cast<size_t>(PromptMessages::Waiting_for_UP_or_DOWN);
 
-  SDL_Surface* TempSurface1 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index1].c_str(), Text1_Colour );
-  SDL_Surface* TempSurface2 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index2].c_str(), Text2_Colour );
-  SDL_Surface* TempSurface3 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index3].c_str(), Text3_Colour );
+  SDL_Surface* TempSurface3 = NULL;
 
-  if( TempSurface1 == NULL || TempSurface2 == NULL || TempSurface3 == NULL )
+  if ( USE_PROMPT_ATLAS )
   {
-    printf( "\nUnable to render text surfaces! SDL_ttf Error: \"%s\"", TTF_GetError() );
-    HasProgramSucceeded = false;
+    g_Prompts_Tex = CreatePromptAtlas( g_Font, g_Renderer );
+
+    if ( g_Prompts_Tex == NULL )
+    {
+      printf( "\nUnable to create the prompt atlas! SDL Error: \"%s\"", SDL_GetError() );
+      HasProgramSucceeded = false;
+    }
+    else
+    {
+      printf( "\nOK: prompt atlas created" );
+    }
   }
   else
   {
-    printf( "\nOK: text surfaces loaded" );
-  }
+    SDL_Surface* TempSurface1 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index1].c_str(), Text1_Colour );
+    SDL_Surface* TempSurface2 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index2].c_str(), Text2_Colour );
+    TempSurface3              = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index3].c_str(), Text3_Colour );
+
+    if( TempSurface1 == NULL || TempSurface2 == NULL || TempSurface3 == NULL )
+    {
+      printf( "\nUnable to render text surfaces! SDL_ttf Error: \"%s\"", TTF_GetError() );
+      HasProgramSucceeded = false;
+    }
+    else
+    {
+      printf( "\nOK: text surfaces loaded" );
+    }
 
-  // Create texture from surface pixels
-  g_Text1_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface1 );
-  g_Text2_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface2 );
-  g_Text3_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface3 );
+    // Create texture from surface pixels
+    g_Text1_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface1 );
+    g_Text2_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface2 );
+    g_Text3_Tex = SDL_CreateTextureFromSurface( g_Renderer, TempSurface3 );
 
-  if( g_Text1_Tex == NULL || g_Text2_Tex == NULL || g_Text3_Tex == NULL )
-  {
-    printf( "\nUnable to create textures from rendered text! SDL Error: \"%s\"", SDL_GetError() );
-    HasProgramSucceeded = false;
-  }
-  else
-  {
-    printf( "\nOK: text textures created" );
-  }
+    if( g_Text1_Tex == NULL || g_Text2_Tex == NULL || g_Text3_Tex == NULL )
+    {
+      printf( "\nUnable to create textures from rendered text! SDL Error: \"%s\"", SDL_GetError() );
+      HasProgramSucceeded = false;
+    }
+    else
+    {
+      printf( "\nOK: text textures created" );
+    }
 
-  // Get rid of old surfaces
-  SDL_FreeSurface( TempSurface1 );
-  SDL_FreeSurface( TempSurface2 );
-  SDL_FreeSurface( TempSurface3 );
-  TempSurface1 = NULL;
-  TempSurface2 = NULL;
-  TempSurface3 = NULL;
+    // Get rid of old surfaces
+    SDL_FreeSurface( TempSurface1 );
+    SDL_FreeSurface( TempSurface2 );
+    SDL_FreeSurface( TempSurface3 );
+    TempSurface1 = NULL;
+    TempSurface2 = NULL;
+    TempSurface3 = NULL;
 
-  /* Ottenimento delle dimensioni delle textures */
+    /* Ottenimento delle dimensioni delle textures */
 
-  SDL_QueryTexture( g_Text1_Tex, NULL, NULL, &g_Text1_Size.w, &g_Text1_Size.h );
-  SDL_QueryTexture( g_Text2_Tex, NULL, NULL, &g_Text2_Size.w, &g_Text2_Size.h );
-  SDL_QueryTexture( g_Text3_Tex, NULL, NULL, &g_Text3_Size.w, &g_Text3_Size.h );
+    SDL_QueryTexture( g_Text1_Tex, NULL, NULL, &g_Text1_Size.w, &g_Text1_Size.h );
+    SDL_QueryTexture( g_Text2_Tex, NULL, NULL, &g_Text2_Size.w, &g_Text2_Size.h );
+    SDL_QueryTexture( g_Text3_Tex, NULL, NULL, &g_Text3_Size.w, &g_Text3_Size.h );
+  }
 
   /* Preparing for main loop */
 
@@ -317,11 +431,17 @@ int main( int argc, char* args[] )
             break;
         }
 
-        TempSurface3 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index3].c_str(), Text3_Colour );
-        g_Text3_Tex   = SDL_CreateTextureFromSurface( g_Renderer, TempSurface3 );
-        SDL_FreeSurface(TempSurface3);
-        TempSurface3 = NULL;
-        SDL_QueryTexture( g_Text3_Tex, NULL, NULL, &g_Text3_Size.w, &g_Text3_Size.h );
+        if ( !USE_PROMPT_ATLAS )
+        {
+          SDL_DestroyTexture( g_Text3_Tex );
+          TempSurface3 = TTF_RenderText_Blended( g_Font, Prompts_Vec[Index3].c_str(), Text3_Colour );
+          g_Text3_Tex   = SDL_CreateTextureFromSurface( g_Renderer, TempSurface3 );
+          SDL_FreeSurface(TempSurface3);
+          TempSurface3 = NULL;
+          SDL_QueryTexture( g_Text3_Tex, NULL, NULL, &g_Text3_Size.w, &g_Text3_Size.h );
+        }
+        else
+        {;} // The next frame takes another clip of the atlas
       }
       else
       { /* Wait for events */ }
@@ -332,13 +452,22 @@ int main( int argc, char* args[] )
     SDL_RenderClear( g_Renderer );
 
     // Render textures to screen
-    SDL_Rect Text1Dest{ ( WINDOW_W - g_Text1_Size.w ) / 2, 0             , g_Text1_Size.w, g_Text1_Size.h };
-    SDL_Rect Text2Dest{ ( WINDOW_W - g_Text2_Size.w ) / 2, g_Text1_Size.h, g_Text2_Size.w, g_Text2_Size.h };
-    SDL_Rect Text3Dest{ ( WINDOW_W - g_Text3_Size.w ) / 2, WINDOW_H / 2  , g_Text3_Size.w, g_Text3_Size.h };
+    if ( USE_PROMPT_ATLAS )
+    {
+      RenderPrompt( Index1, Text1_Colour, 0                         );
+      RenderPrompt( Index2, Text2_Colour, g_Prompts_Clips[Index1].h );
+      RenderPrompt( Index3, Text3_Colour, WINDOW_H / 2              );
+    }
+    else
+    {
+      SDL_Rect Text1Dest{ ( WINDOW_W - g_Text1_Size.w ) / 2, 0             , g_Text1_Size.w, g_Text1_Size.h };
+      SDL_Rect Text2Dest{ ( WINDOW_W - g_Text2_Size.w ) / 2, g_Text1_Size.h, g_Text2_Size.w, g_Text2_Size.h };
+      SDL_Rect Text3Dest{ ( WINDOW_W - g_Text3_Size.w ) / 2, WINDOW_H / 2  , g_Text3_Size.w, g_Text3_Size.h };
 
-    SDL_RenderCopy( g_Renderer, g_Text1_Tex, NULL, &Text1Dest );
-    SDL_RenderCopy( g_Renderer, g_Text2_Tex, NULL, &Text2Dest );
-    SDL_RenderCopy( g_Renderer, g_Text3_Tex, NULL, &Text3Dest );
+      SDL_RenderCopy( g_Renderer, g_Text1_Tex, NULL, &Text1Dest );
+      SDL_RenderCopy( g_Renderer, g_Text2_Tex, NULL, &Text2Dest );
+      SDL_RenderCopy( g_Renderer, g_Text3_Tex, NULL, &Text3Dest );
+    }
 
     // Update screen
     SDL_RenderPresent( g_Renderer );
@@ -349,6 +478,7 @@ int main( int argc, char* args[] )
   SDL_DestroyTexture ( g_Text1_Tex );
   SDL_DestroyTexture ( g_Text2_Tex );
   SDL_DestroyTexture ( g_Text3_Tex );
+  SDL_DestroyTexture ( g_Prompts_Tex );
   SDL_DestroyRenderer( g_Renderer );
   SDL_DestroyWindow  ( g_Window );
   g_Renderer          = NULL;
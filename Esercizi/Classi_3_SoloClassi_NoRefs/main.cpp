@@ -8,6 +8,13 @@
  * dell'SDL_Initialiser manda il programma in crash subito dopo averlo avviato. Rimuovere tutte le
  * references statiche (usate come costanti private) e usare le "::Get()" al loro posto ha risolto il
  * problema.
+ *
+ * Aggiunta GS: le references statiche erano inizializzate prima di "main", in un ordine fra i file
+ * che il linguaggio non stabilisce, e potevano chiamare un "Get()" che creava un singleton a sua
+ * volta dipendente da uno non ancora pronto. In Progetti/Calcolatrice_Classi i servizi sono ora
+ * creati da un "ServiceRegistry" in "main", in un ordine scritto una volta sola e distrutti in
+ * ordine inverso, e ogni "Get()" legge un puntatore senza la guardia di una static locale. Questo
+ * esercizio resta com'era, come passo del percorso.
  **/
 
 
@@ -21,6 +21,16 @@
  * argomento a "SDL_BlitScaled", l'immagine BMP originale viene stirata fino a riempire tutta la
  * finestra.
  *
+ * Aggiunta GS: "SDL_BlitScaled" stirava l'immagine sulla CPU a ogni frame, un costo che a 4K è di
+ * decine di millisecondi. Ora l'immagine è caricata una sola volta in una texture e ogni frame la
+ * stira la GPU, con "SDL_RenderCopy" e il filtro lineare. La finestra si può ridimensionare.
+ *
+ * Aggiunta GS: con l'argomento "--software" (o se non c'è un renderer) l'immagine resta una
+ * superficie, stirata da "ScalePixels" di Engine_Lib/LPixelOps, bilineare con SSE2 o NEON, in una
+ * superficie della dimensione della finestra tenuta da parte: la si stira di nuovo solo quando la
+ * finestra cambia dimensione, e a ogni frame la si copia soltanto. Con "--nearest" lo stiramento è
+ * al pixel più vicino, su entrambe le strade.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -33,8 +43,12 @@
 // Using SDL, standard IO, and strings
 #include <SDL.h>
 #include <stdio.h>
+#include <string.h>
 #include <string>
 
+// Software scaling
+#include "LPixelOps.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -45,6 +59,9 @@ static constexpr int     WINDOW_W = 1024;
 static constexpr int     WINDOW_H = 768;
 static const std::string Img("stretch.bmp");
 
+static constexpr char SOFTWARE_ARGUMENT[] = "--software";
+static constexpr char NEAREST_ARGUMENT[]  = "--nearest";
+
 
 /***************************************************************************************************
 * Private prototypes
@@ -56,15 +73,22 @@ static void close(void);
 static void PressEnter(void);
 
 static SDL_Surface* loadSurface_Optimised( const std::string& path );
+static bool         stretchToWindow( void );
 
 
 /***************************************************************************************************
 * Private global variables
 ****************************************************************************************************/
 
-static SDL_Window*  gWindow           = NULL; // The window we'll be rendering to
-static SDL_Surface* gWindowSurface    = NULL; // The surface contained by the window
-static SDL_Surface* gStretchedSurface = NULL; // Current displayed image
+static SDL_Window*   gWindow           = NULL; // The window we'll be rendering to
+static SDL_Surface*  gWindowSurface    = NULL; // The surface contained by the window; NULL after a resize
+static SDL_Surface*  gStretchedSurface = NULL; // Current displayed image
+static SDL_Surface*  gScaledSurface    = NULL; // The image stretched to the window, in software mode
+static SDL_Renderer* gRenderer         = NULL; // Not used in software mode
+static SDL_Texture*  gTexture          = NULL; // The image, uploaded once, stretched by the GPU
+
+static bool gSoftware = false; // Stretched on the CPU into gScaledSurface
+static bool gNearest  = false; // Nearest pixel instead of bilinear, on both paths
 
 
 /***************************************************************************************************
@@ -93,8 +117,11 @@ bool init(void)
   {
     printf( "\nSDL initialised" );
 
+    // Filtering of the stretched texture
+    SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, gNearest ? "0" : "1" );
+
     // Create window
-    gWindow = SDL_CreateWindow( "SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WINDOW_W, WINDOW_H, SDL_WINDOW_SHOWN );
+    gWindow = SDL_CreateWindow( "SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, WINDOW_W, WINDOW_H, SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE );
 
     if( gWindow == NULL )
     {
@@ -102,10 +129,23 @@ bool init(void)
       success = false;
       PressEnter();
     }
+    else if( !gSoftware && ( gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC ) ) != NULL )
+    {
+      printf( "\nWindow and renderer created: the GPU stretches the image" );
+    }
     else
     {
       printf( "\nWindow created" );
 
+      // No renderer: the window's surface is used instead
+      if( !gSoftware )
+      {
+        printf( "\nRenderer could not be created, stretching in software! SDL Error: \"%s\"", SDL_GetError() );
+        gSoftware = true;
+      }
+      else
+      {;}
+
       // Get window surface
       gWindowSurface = SDL_GetWindowSurface( gWindow );
 
@@ -147,10 +187,29 @@ static bool loadMedia(void)
     success = false;
     PressEnter();
   }
-  else
+  else if( gSoftware )
   {
     printf( "\nOptimised surface \"%s\" loaded, ready to be stretched", Img.c_str() );
   }
+  else
+  {
+    // Uploaded once: from here on the GPU stretches it
+    gTexture = SDL_CreateTextureFromSurface( gRenderer, gStretchedSurface );
+
+    SDL_FreeSurface( gStretchedSurface );
+    gStretchedSurface = NULL;
+
+    if( gTexture == NULL )
+    {
+      printf( "\nUnable to create texture from \"%s\"! SDL Error: \"%s\"", Img.c_str(), SDL_GetError() );
+      success = false;
+      PressEnter();
+    }
+    else
+    {
+      printf( "\nTexture \"%s\" created, ready to be stretched", Img.c_str() );
+    }
+  }
 
   return success;
 }
@@ -161,11 +220,20 @@ static bool loadMedia(void)
  **/
 static void close(void)
 {
-  // Free loaded image
+  // Free loaded images
   SDL_FreeSurface( gStretchedSurface );
   gStretchedSurface = NULL;
 
+  SDL_FreeSurface( gScaledSurface );
+  gScaledSurface = NULL;
+
+  SDL_DestroyTexture( gTexture );
+  gTexture = NULL;
+
   // Destroy window
+  SDL_DestroyRenderer( gRenderer );
+  gRenderer = NULL;
+
   SDL_DestroyWindow( gWindow );
   gWindow = NULL;
 
@@ -197,8 +265,15 @@ static SDL_Surface* loadSurface_Optimised( const std::string& path )
   {
     printf( "\nImage \"%s\" loaded", path.c_str() );
 
-    // Convert surface to screen format
-    optimizedSurface = SDL_ConvertSurface( loadedSurface, gWindowSurface->format, 0 );
+    // Convert surface to screen format, or to the usual texture format
+    if( gSoftware )
+    {
+      optimizedSurface = SDL_ConvertSurface( loadedSurface, gWindowSurface->format, 0 );
+    }
+    else
+    {
+      optimizedSurface = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0 );
+    }
 
     if( optimizedSurface == NULL )
     {
@@ -218,6 +293,69 @@ static SDL_Surface* loadSurface_Optimised( const std::string& path )
 }
 
 
+/**
+ * @brief Software mode: stretches the image to the size of the window into gScaledSurface, once
+ * for each size. ScalePixels scales 32-bit pixels; other window formats fall back to SDL_BlitScaled,
+ * cached all the same.
+ *
+ * @return false if the window's surface or the cache could not be created.
+ **/
+static bool stretchToWindow( void )
+{
+  // After a resize the old window surface is gone
+  gWindowSurface = SDL_GetWindowSurface( gWindow );
+
+  if( gWindowSurface == NULL )
+  {
+    printf( "\nWindow's surface could not be created! SDL Error: \"%s\"", SDL_GetError() );
+    return false;
+  }
+  else if( gScaledSurface != NULL && gScaledSurface->w == gWindowSurface->w && gScaledSurface->h == gWindowSurface->h
+           && gScaledSurface->format->format == gWindowSurface->format->format )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( gScaledSurface );
+  gScaledSurface = SDL_CreateRGBSurfaceWithFormat( 0, gWindowSurface->w, gWindowSurface->h, gWindowSurface->format->BitsPerPixel, gWindowSurface->format->format );
+
+  if( gScaledSurface == NULL )
+  {
+    printf( "\nUnable to create the stretched surface! SDL Error: \"%s\"", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  // The image was converted to the window's format, so it has the same pixel size
+  if( gScaledSurface->format->BytesPerPixel == 4 && gStretchedSurface->format->BytesPerPixel == 4
+      && SDL_LockSurface( gStretchedSurface ) == 0 )
+  {
+    SDL_LockSurface( gScaledSurface );
+
+    ScalePixels( gStretchedSurface->pixels, gStretchedSurface->w, gStretchedSurface->h, gStretchedSurface->pitch,
+                 gScaledSurface->pixels, gScaledSurface->w, gScaledSurface->h, gScaledSurface->pitch, !gNearest );
+
+    SDL_UnlockSurface( gScaledSurface );
+    SDL_UnlockSurface( gStretchedSurface );
+  }
+  else
+  {
+    SDL_BlitScaled( gStretchedSurface, NULL, gScaledSurface, NULL );
+  }
+
+  printf( "\nImage stretched to %dx%d in %.2f ms (%s)", gScaledSurface->w, gScaledSurface->h,
+          1000.0 * static_cast<double>( SDL_GetPerformanceCounter() - Start ) / static_cast<double>( SDL_GetPerformanceFrequency() ),
+          GetPixelOpsKernel() );
+
+  return true;
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -239,6 +377,21 @@ int main( int argc, char* args[] )
 
   printf("\n*** Debugging console ***\n");
 
+  for (int i = 1; i != argc; ++i)
+  {
+    // Stretched on the CPU, with the result cached, instead of by the GPU
+    if( strcmp( args[i], SOFTWARE_ARGUMENT ) == 0 )
+    {
+      gSoftware = true;
+    }
+    else if( strcmp( args[i], NEAREST_ARGUMENT ) == 0 )
+    {
+      gNearest = true;
+    }
+    else
+    {;}
+  }
+
   // Start up SDL and create window
   if( !init() )
   {
@@ -272,18 +425,35 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          // The window surface must be fetched again, and the image stretched to its new size
+          else if( e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED )
+          {
+            gWindowSurface = NULL;
+          }
+          else
+          {;}
         }
 
-        // Apply the image stretched
-        SDL_Rect stretchRect;
-        stretchRect.x = 0;
-        stretchRect.y = 0;
-        stretchRect.w = WINDOW_W;
-        stretchRect.h = WINDOW_H;
-        SDL_BlitScaled( gStretchedSurface, NULL, gWindowSurface, &stretchRect );
+        if( !gSoftware )
+        {
+          // Apply the image stretched by the GPU to the whole window
+          SDL_RenderClear( gRenderer );
+          SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
+          SDL_RenderPresent( gRenderer );
+        }
+        else if( ( gWindowSurface != NULL && gScaledSurface != NULL ) || stretchToWindow() )
+        {
+          // Apply the image already stretched: a plain copy
+          SDL_BlitSurface( gScaledSurface, NULL, gWindowSurface, NULL );
 
-        // Update the surface
-        SDL_UpdateWindowSurface( gWindow );
+          // Update the surface
+          SDL_UpdateWindowSurface( gWindow );
+        }
+        else
+        {
+          HasProgramSucceeded = false;
+          quit                = true;
+        }
       }
     }
   }
@@ -6,9 +6,13 @@ echo.
 
 @REM Set temporary environment variables
 set SDL2_PROJECT_NAME=05_optimized_surface_loading_and_soft_stretching
+
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..\..\Engine_Lib
+
 set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
 set SDL2_LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2
 
 @REM Assign global variables from TXT file (not used any more)
 @REM for /f "delims== tokens=1,2 skip=2" %%G in (..\Global_Variables_For_Batch_Files.txt) do set %%G=%%H
@@ -30,7 +34,7 @@ if exist %SDL2_PROJECT_NAME%.exe (
 echo Building executable...
 echo.
 
-g++ %SDL2_PROJECT_NAME%.cpp -I%SDL2_INCLUDE_PATH% -L%SDL2_LIB_PATH% %SDL2_LINKER_OPTIONS% %SDL2_LIBRARIES% -o %SDL2_PROJECT_NAME%.exe
+g++ %SDL2_PROJECT_NAME%.cpp -I%SDL2_INCLUDE_PATH% -I%ENGINE_LIB_PATH% -L%SDL2_LIB_PATH% -L%ENGINE_LIB_PATH% %SDL2_LINKER_OPTIONS% %SDL2_LIBRARIES% -o %SDL2_PROJECT_NAME%.exe
 
 IF %ERRORLEVEL% EQU 0 (
   echo.
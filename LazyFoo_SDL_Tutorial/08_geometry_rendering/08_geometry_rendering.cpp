@@ -51,6 +51,15 @@
  * that wasn't there, the screen would be cleared with whatever color was last set with
  * SDL_SetRenderDrawColor, resulting in a yellow background in this case.
  *
+ * Aggiunta GS: le forme non sono più disegnate una chiamata alla volta (e i punti uno per uno), ma
+ * accodate in "LPrimitiveBatch" di Engine_Lib/LPrimitiveBatch e disegnate tutte insieme da "flush".
+ * Con un renderer accelerato diventano triangoli colorati, disegnati con una sola
+ * "SDL_RenderGeometry", nell'ordine in cui sono state accodate; altrimenti, o con l'argomento
+ * "--draw-calls", sono raggruppate per colore e disegnate con "SDL_RenderFillRects",
+ * "SDL_RenderDrawRects", "SDL_RenderDrawLines" e "SDL_RenderDrawPoints" (le linee orizzontali e
+ * verticali come rettangoli pieni larghi un pixel). Il tasto G mostra una griglia di debug con un
+ * box e un punto per cella, qualche migliaio di forme disegnate con una o poche chiamate.
+ *
  * Sunto:
  *
  * main
@@ -88,8 +97,12 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <cmath>
+#include <string.h>
 #include <string>
 
+// Shapes queued and drawn together
+#include "LPrimitiveBatch.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -129,6 +142,19 @@ static constexpr int BLUE_G(0x00);
 static constexpr int BLUE_B(0xFF);
 static constexpr int BLUE_A(0xFF);
 
+static const SDL_Color RedColour   { RED_R,    RED_G,    RED_B,    RED_A };
+static const SDL_Color GreenColour { GREEN_R,  GREEN_G,  GREEN_B,  GREEN_A };
+static const SDL_Color BlueColour  { BLUE_R,   BLUE_G,   BLUE_B,   BLUE_A };
+static const SDL_Color YellowColour{ YELLOW_R, YELLOW_G, YELLOW_B, YELLOW_A };
+
+// Debug grid: lines every GRID_STEP pixels, and a box and a point in every cell
+static constexpr int       GRID_STEP = 16;
+static const     SDL_Color GridColour{ 0xC0, 0xC0, 0xC0, 0xFF };
+static const     SDL_Color BoxColour { 0x00, 0x80, 0x80, 0xFF };
+static const     SDL_Color DotColour { 0x00, 0x00, 0x00, 0xFF };
+
+static constexpr char DRAW_CALLS_ARGUMENT[] = "--draw-calls";
+
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
@@ -138,6 +164,8 @@ static bool loadMedia(void);
 static void close(void);
 static void PressEnter(void);
 
+static void addDebugGrid(void);
+
 // static SDL_Texture* loadTexture( std::string path );
 
 
@@ -148,6 +176,11 @@ static void PressEnter(void);
 static SDL_Window*   gWindow   = NULL; // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL; // The window renderer
 
+static LPrimitiveBatch gPrimitives;             // Every shape of a frame
+static bool            gUseDrawCalls = false;   // DrawCalls path even with an accelerated renderer
+static bool            gShowGrid     = false;
+static bool            gReportFrame  = false;   // Print what the next frame drew
+
 
 /***************************************************************************************************
 * Private functions definitions
@@ -308,6 +341,32 @@ static void close(void)
 // }
 
 
+/**
+ * @brief Queues the debug grid: as many shapes as a debug overlay of collision boxes.
+ **/
+static void addDebugGrid(void)
+{
+  for( int x = 0; x < SCREEN_WIDTH; x += GRID_STEP )
+  {
+    gPrimitives.addLine( x, 0, x, SCREEN_HEIGHT - 1, GridColour );
+  }
+
+  for( int y = 0; y < SCREEN_HEIGHT; y += GRID_STEP )
+  {
+    gPrimitives.addLine( 0, y, SCREEN_WIDTH - 1, y, GridColour );
+  }
+
+  for( int y = 0; y < SCREEN_HEIGHT; y += GRID_STEP )
+  {
+    for( int x = 0; x < SCREEN_WIDTH; x += GRID_STEP )
+    {
+      gPrimitives.addRect( SDL_Rect{ x + 3, y + 3, GRID_STEP - 5, GRID_STEP - 5 }, BoxColour );
+      gPrimitives.addPoint( x + GRID_STEP / 2, y + GRID_STEP / 2, DotColour );
+    }
+  }
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -333,6 +392,13 @@ int main( int argc, char* args[] )
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    if( strcmp( args[i], DRAW_CALLS_ARGUMENT ) == 0 )
+    {
+      gUseDrawCalls = true;
+    }
+    else
+    {;}
   }
 
   // Start up SDL and create window
@@ -355,6 +421,10 @@ int main( int argc, char* args[] )
     {
       printf( "\nAll media loaded" );
 
+      // One geometry call on the GPU, a few calls per colour otherwise
+      gPrimitives.setPath( gUseDrawCalls ? LPrimitivePath::DrawCalls : LPrimitiveBatch::GetBestPath( gRenderer ) );
+      printf( "\nPrimitives drawn with %s", ( gPrimitives.GetPath() == LPrimitivePath::Geometry ) ? "a single geometry call" : "draw calls per colour" );
+
       // Main loop flag
       bool quit = false;
 
@@ -372,6 +442,11 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_g )
+          {
+            gShowGrid    = !gShowGrid;
+            gReportFrame = true;
+          }
           else
           {;} // Wait for events
         }
@@ -383,27 +458,41 @@ int main( int argc, char* args[] )
         // Clear screen
         SDL_RenderClear( gRenderer );
 
-        // Render red filled quad
-        SDL_Rect fillRect = { SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 };
-        SDL_SetRenderDrawColor( gRenderer, RED_R, RED_G, RED_B, RED_A );
-        SDL_RenderFillRect( gRenderer, &fillRect );
+        // Debug grid behind the shapes
+        if( gShowGrid )
+        {
+          addDebugGrid();
+        }
+        else
+        {;}
 
-        // Render green outlined quad
-        SDL_Rect outlineRect = { SCREEN_WIDTH / 6, SCREEN_HEIGHT / 6, SCREEN_WIDTH * 2 / 3, SCREEN_HEIGHT * 2 / 3 };
-        SDL_SetRenderDrawColor( gRenderer, GREEN_R, GREEN_G, GREEN_B, GREEN_A );
-        SDL_RenderDrawRect( gRenderer, &outlineRect );
+        // Red filled quad
+        gPrimitives.addFillRect( SDL_Rect{ SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 }, RedColour );
 
-        // Draw blue horizontal line
-        SDL_SetRenderDrawColor( gRenderer, BLUE_R, BLUE_G, BLUE_B, BLUE_A );
-        SDL_RenderDrawLine( gRenderer, 0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2 );
+        // Green outlined quad
+        gPrimitives.addRect( SDL_Rect{ SCREEN_WIDTH / 6, SCREEN_HEIGHT / 6, SCREEN_WIDTH * 2 / 3, SCREEN_HEIGHT * 2 / 3 }, GreenColour );
 
-        // Draw vertical line of yellow dots
-        SDL_SetRenderDrawColor( gRenderer, YELLOW_R, YELLOW_G, YELLOW_B, YELLOW_A );
+        // Blue horizontal line
+        gPrimitives.addLine( 0, SCREEN_HEIGHT / 2, SCREEN_WIDTH, SCREEN_HEIGHT / 2, BlueColour );
+
+        // Vertical line of yellow dots
         for( int i = 0; i != SCREEN_HEIGHT; i += 4 )
         {
-          SDL_RenderDrawPoint( gRenderer, SCREEN_WIDTH / 2, i );
+          gPrimitives.addPoint( SCREEN_WIDTH / 2, i, YellowColour );
         }
 
+        // Render all of them
+        const size_t Shapes = gPrimitives.GetShapeCount();
+        gPrimitives.flush( gRenderer );
+
+        if( gReportFrame )
+        {
+          printf( "\n%u shapes in %d draw calls", static_cast<unsigned>( Shapes ), gPrimitives.GetDrawCalls() );
+          gReportFrame = false;
+        }
+        else
+        {;}
+
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
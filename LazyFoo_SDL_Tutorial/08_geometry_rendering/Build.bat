@@ -6,18 +6,21 @@ echo.
 @REM Set temporary environment variables
 set SDL2_PROJECT_NAME=08_geometry_rendering
 
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..\..\Engine_Lib
+
 @REM Static libraries
 set SDL2_LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
 set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
 @REM set SDL2_TTF_LIB_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\lib\
-set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH%
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 -lSDL2_image
+set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% -L%ENGINE_LIB_PATH%
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2 -lSDL2_image
 
 @REM Header files
 set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
 set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
 @REM set SDL2_TTF_INCLUDE_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\include\SDL2
-set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH%
+set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%ENGINE_LIB_PATH%
 
 @REM C++ compilation options
 set COMPILATION_OPTIONS=-Wall -Wextra -Wpedantic -Wconversion
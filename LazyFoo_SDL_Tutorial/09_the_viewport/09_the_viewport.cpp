@@ -26,6 +26,16 @@
  * the same coordinate system as the window it is used in, so the image will appear squished since
  * the viewport is half the height.
  *
+ * Aggiunta GS: tasto 's' per passare allo split screen a quattro giocatori, e tornare indietro. La
+ * scena è un mondo di WORLD_W x WORLD_H pixel con SCENE_SPRITES copie rimpicciolite dell'immagine,
+ * vista da quattro telecamere in movimento, una per quarto di finestra (l'ultima, da più lontano).
+ * Invece di un SDL_RenderSetViewport e di un disegno dell'intera scena per ogni telecamera, se ne
+ * occupa "LMultiView" di Engine_Lib: l'indice spaziale della scena ("LSpatialGrid") è costruito una
+ * volta sola e interrogato da ogni vista per i soli sprite che vede, già tagliati sul bordo del
+ * proprio viewport; poi tutte le viste finiscono nello stesso "LSpriteBatch", con una sola chiamata
+ * di disegno per texture, qualunque sia il numero delle viste. Il titolo della finestra riporta gli
+ * sprite disegnati e le chiamate di disegno.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -39,8 +49,14 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
 #include <string>
 
+#include "LMultiView.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -51,6 +67,20 @@ static constexpr int         WINDOW_W = 640;
 static constexpr int         WINDOW_H = 480;
 static const     std::string TexturePath("viewport.png");
 
+// Split screen
+static constexpr int    WORLD_W        = 4096;
+static constexpr int    WORLD_H        = 4096;
+static constexpr int    WORLD_CELL_px  = 128;    // Lato di una cella dell'indice spaziale
+static constexpr int    SCENE_SPRITES  = 20000;
+static constexpr int    SPRITE_W       = 64;
+static constexpr int    SPRITE_H       = 48;
+static constexpr int    VIEW_COUNT     = 4;
+static constexpr int    FAR_VIEW_ZOOM  = 3;      // L'ultima vista mostra un'area tre volte più grande
+static constexpr double ORBIT_RADIUS   = 1200.0;
+static constexpr double ORBIT_SPEED    = 0.0002; // Radianti al millisecondo
+static constexpr double PI             = 3.14159265358979323846;
+static constexpr Uint32 TITLE_EVERY_ms = 1000;
+
 
 /***************************************************************************************************
 * Private prototypes
@@ -58,6 +88,8 @@ static const     std::string TexturePath("viewport.png");
 
 static bool init(void);
 static bool loadMedia(void);
+static void buildSplitScreen(void);
+static void renderSplitScreen( Uint32 Now_ms );
 static void close(void);
 static void PressEnter(void);
 
@@ -72,6 +104,11 @@ static SDL_Window*   gWindow   = NULL; // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL; // The window renderer
 static SDL_Texture*  gTexture  = NULL; // Currently displayed texture
 
+// Split screen: la stessa immagine come LTexture di Engine_Lib, per LSpriteBatch
+static LTexture     gSceneTexture;
+static LSpriteBatch gBatch;
+static LMultiView   gSplitScreen( SDL_Rect{ 0, 0, WORLD_W, WORLD_H }, WORLD_CELL_px );
+
 
 /***************************************************************************************************
 * Private functions definitions
@@ -181,10 +218,91 @@ static bool loadMedia(void)
     printf( "\nTexture image \"%s\" loaded", TexturePath.c_str() );
   }
 
+  if( !gSceneTexture.loadFromFile( TexturePath, gRenderer ) )
+  {
+    printf( "\nFailed to load the split screen texture \"%s\"!", TexturePath.c_str() );
+    success = false;
+  }
+  else
+  {
+    buildSplitScreen();
+  }
+
   return success;
 }
 
 
+/**
+ * @brief Scatters the sprites over the world, once: the scene does not move, so its spatial index
+ * is built by the first render and reused by the following ones. The four views split the window
+ * in quarters; their cameras are moved by renderSplitScreen.
+ **/
+static void buildSplitScreen(void)
+{
+  const SDL_Rect Clip{ 0, 0, gSceneTexture.getWidth(), gSceneTexture.getHeight() };
+
+  for( int i = 0; i != SCENE_SPRITES; ++i )
+  {
+    const SDL_Rect Bounds{ rand() % ( WORLD_W - SPRITE_W ), rand() % ( WORLD_H - SPRITE_H ), SPRITE_W, SPRITE_H };
+
+    gSplitScreen.addSprite( gSceneTexture, Clip, Bounds );
+  }
+
+  for( int View = 0; View != VIEW_COUNT; ++View )
+  {
+    const int      Zoom = ( View == VIEW_COUNT - 1 ) ? FAR_VIEW_ZOOM : 1;
+    const SDL_Rect Viewport{ ( View % 2 ) * WINDOW_W / 2, ( View / 2 ) * WINDOW_H / 2, WINDOW_W / 2, WINDOW_H / 2 };
+    const SDL_Rect Camera{ 0, 0, Viewport.w * Zoom, Viewport.h * Zoom };
+
+    gSplitScreen.addView( Camera, Viewport );
+  }
+}
+
+
+/**
+ * @brief Moves each camera along its own orbit around the centre of the world, then draws all the
+ * views with one pass of LMultiView.
+ **/
+static void renderSplitScreen( Uint32 Now_ms )
+{
+  static Uint32 LastTitle_ms = 0;
+
+  for( int View = 0; View != gSplitScreen.GetViewCount(); ++View )
+  {
+    SDL_Rect     Camera = gSplitScreen.GetView( View ).Camera;
+    const double Angle  = Now_ms * ORBIT_SPEED * ( 1 + View ) + View * PI / 2.0;
+
+    Camera.x = static_cast<int>( WORLD_W / 2 + ORBIT_RADIUS * cos( Angle ) ) - Camera.w / 2;
+    Camera.y = static_cast<int>( WORLD_H / 2 + ORBIT_RADIUS * sin( Angle ) ) - Camera.h / 2;
+
+    gSplitScreen.setCamera( View, Camera );
+  }
+
+  // Le viste sono tagliate sulla CPU: il viewport del renderer resta l'intera finestra
+  SDL_RenderSetViewport( gRenderer, NULL );
+  gSplitScreen.render( gBatch, gRenderer );
+
+  if( Now_ms - LastTitle_ms >= TITLE_EVERY_ms )
+  {
+    size_t Visible = 0;
+
+    for( int View = 0; View != gSplitScreen.GetViewCount(); ++View )
+    {
+      Visible += gSplitScreen.GetVisible( View );
+    }
+
+    char Title[128];
+    snprintf( Title, sizeof(Title), "Split screen: %d views, %u of %d sprites drawn, %d draw calls",
+              gSplitScreen.GetViewCount(), static_cast<unsigned>( Visible ), SCENE_SPRITES, gBatch.GetDrawCalls() );
+    SDL_SetWindowTitle( gWindow, Title );
+
+    LastTitle_ms = Now_ms;
+  }
+  else
+  {;}
+}
+
+
 /**
  * @brief Frees media and shuts down SDL
  **/
@@ -193,6 +311,7 @@ static void close(void)
   // Free loaded image
   SDL_DestroyTexture( gTexture );
   gTexture = NULL;
+  gSceneTexture.free();
 
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
@@ -275,6 +394,9 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // Tasto 's': split screen, oppure i tre viewport del tutorial
+      bool IsSplitScreen = false;
+
       // While application is running
       while( !quit )
       {
@@ -286,6 +408,11 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_s )
+          {
+            IsSplitScreen = !IsSplitScreen;
+            SDL_SetWindowTitle( gWindow, "SDL Tutorial" );
+          }
           else
           {;} // Wait for events
         }
@@ -294,42 +421,48 @@ int main( int argc, char* args[] )
         SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
         SDL_RenderClear( gRenderer );
 
-        // Top left corner viewport
-        SDL_Rect topLeftViewport;
-        topLeftViewport.x = 0;
-        topLeftViewport.y = 0;
-        topLeftViewport.w = WINDOW_W / 2;
-        topLeftViewport.h = WINDOW_H / 2;
-        SDL_RenderSetViewport( gRenderer, &topLeftViewport );
-
-        // Render texture to screen
-        SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
+        if( IsSplitScreen )
+        {
+          renderSplitScreen( SDL_GetTicks() );
+        }
+        else
+        {
+          // Top left corner viewport
+          SDL_Rect topLeftViewport;
+          topLeftViewport.x = 0;
+          topLeftViewport.y = 0;
+          topLeftViewport.w = WINDOW_W / 2;
+          topLeftViewport.h = WINDOW_H / 2;
+          SDL_RenderSetViewport( gRenderer, &topLeftViewport );
 
+          // Render texture to screen
+          SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
 
-        // Top right viewport
-        SDL_Rect topRightViewport;
-        topRightViewport.x = WINDOW_W / 2;
-        topRightViewport.y = 0;
-        topRightViewport.w = WINDOW_W / 2;
-        topRightViewport.h = WINDOW_H / 2;
-        SDL_RenderSetViewport( gRenderer, &topRightViewport );
 
-        // Render texture to screen
-        SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
+          // Top right viewport
+          SDL_Rect topRightViewport;
+          topRightViewport.x = WINDOW_W / 2;
+          topRightViewport.y = 0;
+          topRightViewport.w = WINDOW_W / 2;
+          topRightViewport.h = WINDOW_H / 2;
+          SDL_RenderSetViewport( gRenderer, &topRightViewport );
 
+          // Render texture to screen
+          SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
 
-        // Bottom viewport
-        SDL_Rect bottomViewport;
-        bottomViewport.x = 0;
-        bottomViewport.y = WINDOW_H / 2;
-        bottomViewport.w = WINDOW_W;
-        bottomViewport.h = WINDOW_H / 2;
-        SDL_RenderSetViewport( gRenderer, &bottomViewport );
 
+          // Bottom viewport
+          SDL_Rect bottomViewport;
+          bottomViewport.x = 0;
+          bottomViewport.y = WINDOW_H / 2;
+          bottomViewport.w = WINDOW_W;
+          bottomViewport.h = WINDOW_H / 2;
+          SDL_RenderSetViewport( gRenderer, &bottomViewport );
 
-        // Render texture to screen
-        SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
 
+          // Render texture to screen
+          SDL_RenderCopy( gRenderer, gTexture, NULL, NULL );
+        }
 
         // Update screen
         SDL_RenderPresent( gRenderer );
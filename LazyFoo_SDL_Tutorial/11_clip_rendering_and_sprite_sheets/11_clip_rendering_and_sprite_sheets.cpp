@@ -41,6 +41,12 @@
  *    renderizzata (NULL in caso di renderizzazione completa). L'idea è di renderizzare un cerchio
  *    per ciascuno dei quattro angoli della finestra.
  *
+ * Aggiunta GS: i cerchi possono venire da un atlante, invece che da clip piazzate a mano. Le
+ * immagini sciolte della cartella "dots" si impacchettano con Engine_Lib/Tools/PackAtlas:
+ *   PackAtlas dots.atlas dots/red.png dots/green.png dots/yellow.png dots/blue.png
+ * che scrive la pagina dots_0.png e la tabella delle clip dots.atlas. Se dots.atlas c'è,
+ * "LTextureAtlas" la legge e le clip si cercano per nome; altrimenti si usa dots.png come prima.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -55,6 +61,8 @@
 #include <stdio.h>
 #include <string>
 
+#include "LTextureAtlas.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -64,6 +72,10 @@
 static constexpr int SCREEN_WIDTH  = 640;
 static constexpr int SCREEN_HEIGHT = 480;
 static const std::string FilePath("dots.png");
+static const std::string AtlasPath("dots.atlas");   // Da PackAtlas, se è stato lanciato
+
+// Nomi delle clip nell'atlante (i file in "dots", senza estensione), nell'ordine di gSpriteClips
+static const char* const AtlasClipNames[ 4 ] = { "red", "green", "yellow", "blue" };
 
 
 /***************************************************************************************************
@@ -108,6 +120,7 @@ class LTexture
 
 static bool init(void);
 static bool loadMedia(void);
+static bool loadFromAtlas(void);
 static void close(void);
 static void PressEnter(void);
 
@@ -122,6 +135,7 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene sprites
 static SDL_Rect gSpriteClips[ 4 ];   // Singoli clip, riuniti in un array per comodità. Sono degli SDL_Rect perché servono solo a definire la posizione e la dimensione dei clip
 static LTexture gSpriteSheetTexture; // Immagine completa, da clippare
+static LTextureAtlas gAtlas;         // Tabella delle clip, se i cerchi vengono da dots.atlas
 
 
 /***************************************************************************************************
@@ -329,8 +343,12 @@ static bool loadMedia(void)
   // Loading success flag
   bool success = true;
 
-  // Load sprite sheet texture
-  if( !gSpriteSheetTexture.loadFromFile( FilePath ) )
+  // Load the packed atlas, if there is one, otherwise the hand-made sprite sheet
+  if( loadFromAtlas() )
+  {
+    printf( "\nSprite clips taken from the atlas \"%s\"", AtlasPath.c_str() );
+  }
+  else if( !gSpriteSheetTexture.loadFromFile( FilePath ) )
   {
     printf( "\nFailed to load sprite sheet texture \"%s\"!", FilePath.c_str() );
     success = false;
@@ -369,6 +387,43 @@ static bool loadMedia(void)
 }
 
 
+/**
+ * @brief Loads the sprites from the atlas packed by PackAtlas: the page holding them, and their
+ * clips, looked up by name.
+ *
+ * @return true if the atlas is there and has every sprite on one page; false to use dots.png.
+ **/
+static bool loadFromAtlas(void)
+{
+  if( !gAtlas.load( AtlasPath ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  int Page = -1;
+
+  for( int i = 0; i != 4; ++i )
+  {
+    const int Index = gAtlas.find( AtlasClipNames[ i ] );
+
+    if( Index == -1 || ( Page != -1 && gAtlas.GetPage( Index ) != Page ) )
+    {
+      printf( "\nThe atlas \"%s\" has no sprite \"%s\" on the page of the others", AtlasPath.c_str(), AtlasClipNames[ i ] );
+      return false;
+    }
+    else
+    {;}
+
+    Page              = gAtlas.GetPage( Index );
+    gSpriteClips[ i ] = gAtlas.GetClip( Index );
+  }
+
+  return gSpriteSheetTexture.loadFromFile( gAtlas.GetPagePath( Page ) );
+}
+
+
 static void close(void)
 {
   // Free loaded images
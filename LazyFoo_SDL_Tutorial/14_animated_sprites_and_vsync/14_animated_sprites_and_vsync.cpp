@@ -12,6 +12,23 @@
  * second and that's the assumption we're making here. If you have a different monitor refresh rate,
  * that would explain why the animation is running too fast or slow.
  *
+ * Aggiunta GS: l'animazione non dipende più dalla frequenza dello schermo. Le clip stanno in
+ * "LAnimationSet" di Engine_Lib/LAnimation, una tabella unica per tutte le animazioni, e ogni
+ * frame dura WALK_FRAME_TIME_s secondi, misurati da "LHighResTimer": quanto prima facevano
+ * SLOWING_FACTOR aggiornamenti a 60 Hz, ma a qualsiasi frequenza. "LAnimator" tiene le istanze
+ * animate in array separati (animazione, tempo, velocità, clip) e le fa avanzare tutte con un solo
+ * ciclo: qui, oltre all'omino al centro, una folla di CROWD_SIZE omini rimpiccioliti, ognuno con la
+ * propria velocità e fase. Tasto 'c' per mostrare/nascondere la folla.
+ *
+ * Aggiunta GS: il renderer si sceglie da riga di comando con "--driver=<nome>" (direct3d11, opengl,
+ * software...); con "--benchmark" "LRendererSelect" di Engine_Lib/LRendererSelect prova tutti i
+ * driver disponibili disegnando qualche migliaio di sprite semitrasparenti e tiene il più veloce.
+ * "--vsync=on|off|adaptive" sceglie la modalità di presentazione iniziale, il tasto 'v' la cambia
+ * durante l'esecuzione: "LPresentControl" misura per ciascuna la durata dei frame e la latenza,
+ * dalla lettura dell'input alla fine del present, e le stampa a ogni cambio e all'uscita. In
+ * "adaptive" il VSync si spegne quando i frame non stanno più nel periodo dello schermo, invece di
+ * scendere a metà frequenza, e si riaccende quando tornano a starci.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -24,16 +41,29 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <stdio.h>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <vector>
+#include "LAnimation.hpp"
+#include "LRendererSelect.hpp"
+#include "LTimer.hpp"
 
 
 /**************************************************************************************************
 * Private constants
 ***************************************************************************************************/
 
-static constexpr int INITIALISE_FIRST_ONE_AVAILABLE = -1;
 static constexpr int WALKING_ANIMATION_FRAMES       =  4;
-static constexpr int SLOWING_FACTOR                 =  5; // Fattore di rallentamento dell'animazione. Cambia sprite ogni SLOWING_FACTOR aggiornamenti dello schermo.
+static constexpr double WALK_FRAME_TIME_s          = 5.0 / 60.0; // Ogni sprite resta per 5 aggiornamenti di uno schermo a 60 Hz, qualunque sia la frequenza
+static constexpr int    SPRITE_W                   = 64;
+static constexpr int    SPRITE_H                   = 205;
+
+// Folla: quanti omini, quanto più piccoli, e la loro velocità rispetto all'animazione
+static constexpr int   CROWD_SIZE      = 2000;
+static constexpr int   CROWD_SHRINK    = 4;
+static constexpr float CROWD_MIN_SPEED = 0.5f;
+static constexpr float CROWD_MAX_SPEED = 1.5f;
 
 static constexpr int WINDOW_W = 640;
 static constexpr int WINDOW_H = 480;
@@ -51,6 +81,10 @@ static constexpr int CYAN_B = 0xFF;
 
 static const std::string SpriteSheetPath("foo.png");
 
+static constexpr char DRIVER_ARGUMENT[]    = "--driver=";
+static constexpr char BENCHMARK_ARGUMENT[] = "--benchmark";
+static constexpr char VSYNC_ARGUMENT[]     = "--vsync=";
+
 
 /***************************************************************************************************
 * Classes
@@ -84,6 +118,9 @@ class LTexture
 		// Renders texture at given point
 		void render( int x, int y, SDL_Rect* clip = NULL );
 
+		// Renders a portion of the texture stretched over a rectangle
+		void render( const SDL_Rect& destination, const SDL_Rect& clip );
+
 		// Gets image dimensions
     int getWidth(void) const;
     int getHeight(void) const;
@@ -115,9 +152,22 @@ static void PressEnter(void);
 static SDL_Window*   gWindow   = NULL;   // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL;   // The window renderer
 
-// Walking animation
-static SDL_Rect gSpriteClips[ WALKING_ANIMATION_FRAMES ]; // Ogni sprite è largo 64 px e alto 205 px
-static LTexture gSpriteSheetTexture;
+// Renderer driver and present mode, from the command line; 'v' switches the mode
+static std::string     gDriver;
+static bool            gBenchmark   = false;
+static LPresentMode    gPresentMode = LPresentMode::VSYNC_ON;
+static LPresentControl gPresent;
+
+// Walking animation: instance 0 is the walker in the middle, the others the crowd
+static LAnimationSet gAnimations;
+static LAnimator     gWalkers( gAnimations );
+static int           gWalking = -1;
+static LTexture      gSpriteSheetTexture;
+
+// Crowd positions, one entry per walker after the first
+static std::vector<int> gCrowdX;
+static std::vector<int> gCrowdY;
+static bool             gShowCrowd = true;
 
 
 /***************************************************************************************************
@@ -257,6 +307,18 @@ void LTexture::render( int x, int y, SDL_Rect* clip )
 }
 
 
+/**
+ * @brief Renders a portion of the texture stretched over a rectangle of the screen.
+ *
+ * @param destination Where, and how large.
+ * @param clip Portion of the texture.
+ **/
+void LTexture::render( const SDL_Rect& destination, const SDL_Rect& clip )
+{
+	SDL_RenderCopy( gRenderer, mTexture, &clip, &destination );
+}
+
+
 int LTexture::getWidth(void) const
 {
 	return mWidth;
@@ -310,8 +372,8 @@ static bool init(void)
 		{
       printf( "\nWindow created" );
 
-			// Create accelerated and vsynced renderer for window
-			gRenderer = SDL_CreateRenderer( gWindow, INITIALISE_FIRST_ONE_AVAILABLE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+			// Create renderer for window: the driver asked for or the fastest one, vsynced unless asked otherwise
+			gRenderer = LRendererSelect::create( gWindow, gDriver, gBenchmark, gPresentMode );
 
       if( gRenderer == NULL )
 			{
@@ -322,6 +384,8 @@ static bool init(void)
 			{
         printf( "\nRenderer created" );
 
+        gPresent.attach( gRenderer, gWindow, gPresentMode );
+
 				// Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -368,26 +432,23 @@ static bool loadMedia(void)
 	{
     printf( "\nWalking animation texture loaded" );
 
-		// Set sprite clips
-		gSpriteClips[ 0 ].x =   0;
-		gSpriteClips[ 0 ].y =   0;
-		gSpriteClips[ 0 ].w =  64;
-		gSpriteClips[ 0 ].h = 205;
-
-		gSpriteClips[ 1 ].x =  64;
-		gSpriteClips[ 1 ].y =   0;
-		gSpriteClips[ 1 ].w =  64;
-		gSpriteClips[ 1 ].h = 205;
-
-		gSpriteClips[ 2 ].x = 128;
-		gSpriteClips[ 2 ].y =   0;
-		gSpriteClips[ 2 ].w =  64;
-		gSpriteClips[ 2 ].h = 205;
-
-		gSpriteClips[ 3 ].x = 192;
-		gSpriteClips[ 3 ].y =   0;
-		gSpriteClips[ 3 ].w =  64;
-		gSpriteClips[ 3 ].h = 205;
+		// Set sprite clips: the frames are side by side on the first row
+		gWalking = gAnimations.addStrip( SDL_Rect{ 0, 0, SPRITE_W, SPRITE_H }, WALKING_ANIMATION_FRAMES, WALK_FRAME_TIME_s );
+
+		// The walker in the middle, then the crowd, each one out of step with the others
+		gWalkers.spawn( gWalking );
+
+		const float duration = static_cast<float>( gAnimations.GetDuration( gWalking ) );
+
+		for( int i = 0; i != CROWD_SIZE; ++i )
+		{
+			const float phase = static_cast<float>( rand() ) / static_cast<float>( RAND_MAX );
+			const float speed = CROWD_MIN_SPEED + ( CROWD_MAX_SPEED - CROWD_MIN_SPEED ) * static_cast<float>( rand() ) / static_cast<float>( RAND_MAX );
+
+			gWalkers.spawn( gWalking, phase * duration, speed );
+			gCrowdX.push_back( rand() % ( WINDOW_W - SPRITE_W / CROWD_SHRINK ) );
+			gCrowdY.push_back( rand() % ( WINDOW_H - SPRITE_H / CROWD_SHRINK ) );
+		}
 	}
 
 	return success;
@@ -396,9 +457,21 @@ static bool loadMedia(void)
 
 static void close(void)
 {
-	// Free loaded images
+	// Free loaded images and animations
+	gWalkers.clear();
+	gAnimations.clear();
+	gCrowdX.clear();
+	gCrowdY.clear();
 	gSpriteSheetTexture.free();
 
+	// Frame time and latency of each present mode used
+	if( gRenderer != NULL )
+	{
+		gPresent.report();
+	}
+	else
+	{;}
+
 	// Destroy window
 	SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow( gWindow );
@@ -436,6 +509,27 @@ int main( int argc, char* args[] )
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    // Renderer driver by name, or the fastest one, and present mode
+    if( strncmp( args[i], DRIVER_ARGUMENT, strlen( DRIVER_ARGUMENT ) ) == 0 )
+    {
+      gDriver = args[i] + strlen( DRIVER_ARGUMENT );
+    }
+    else if( strcmp( args[i], BENCHMARK_ARGUMENT ) == 0 )
+    {
+      gBenchmark = true;
+    }
+    else if( strncmp( args[i], VSYNC_ARGUMENT, strlen( VSYNC_ARGUMENT ) ) == 0 )
+    {
+      if( !LPresentControl::GetModeOf( args[i] + strlen( VSYNC_ARGUMENT ), gPresentMode ) )
+      {
+        printf( "\nUnknown present mode \"%s\": on, off or adaptive", args[i] + strlen( VSYNC_ARGUMENT ) );
+      }
+      else
+      {;}
+    }
+    else
+    {;}
   }
 
 	// Start up SDL and create window
@@ -458,12 +552,16 @@ int main( int argc, char* args[] )
 			// Event handler
 			SDL_Event e;
 
-			// Current animation frame
-			int CurrentFrame = 0;
+			// Time elapsed between two frames
+			LHighResTimer stepTimer;
+			stepTimer.start();
 
 			// While application is running
 			while( !quit )
 			{
+				// The input read from here on is shown by this frame's present
+				gPresent.beginFrame();
+
 				// Handle events on queue
 				while( SDL_PollEvent( &e ) != 0 )
 				{
@@ -472,6 +570,17 @@ int main( int argc, char* args[] )
 					{
 						quit = true;
 					}
+					// Show or hide the crowd
+					else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_c )
+					{
+						gShowCrowd = !gShowCrowd;
+					}
+					// Next present mode, with the figures of the one left
+					else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_v )
+					{
+						gPresent.report();
+						gPresent.nextMode();
+					}
           else
           {;}
 				}
@@ -480,25 +589,31 @@ int main( int argc, char* args[] )
 				SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 				SDL_RenderClear( gRenderer );
 
-				// Render current frame
-				SDL_Rect* currentClip     = &gSpriteClips[ CurrentFrame / SLOWING_FACTOR ];
-        int CENTERED_HORIZONTALLY = ( WINDOW_W  - currentClip->w ) / 2;
-        int CENTERED_VERTICALLY   = ( WINDOW_H - currentClip->h ) / 2;
-				gSpriteSheetTexture.render( CENTERED_HORIZONTALLY, CENTERED_VERTICALLY, currentClip );
-
-				// Update screen
-				SDL_RenderPresent( gRenderer );
-
-				// Go to next frame
-				++CurrentFrame;
+				// Advance every walker by the time elapsed since the last frame
+				gWalkers.update( stepTimer.lap() );
 
-				// Cycle animation
-				if( CurrentFrame / SLOWING_FACTOR >= WALKING_ANIMATION_FRAMES )
+				// Render the crowd, behind
+				if( gShowCrowd )
 				{
-					CurrentFrame = 0;
+					const Uint32* clipIndices = gWalkers.GetClipIndices();
+
+					for( size_t i = 0; i != gCrowdX.size(); ++i )
+					{
+						const SDL_Rect destination = { gCrowdX[ i ], gCrowdY[ i ], SPRITE_W / CROWD_SHRINK, SPRITE_H / CROWD_SHRINK };
+						gSpriteSheetTexture.render( destination, gAnimations.GetClip( clipIndices[ i + 1 ] ) );
+					}
 				}
         else
         {;}
+
+				// Render current frame
+				SDL_Rect currentClip      = gWalkers.GetClip( 0 );
+        int CENTERED_HORIZONTALLY = ( WINDOW_W  - currentClip.w ) / 2;
+        int CENTERED_VERTICALLY   = ( WINDOW_H - currentClip.h ) / 2;
+				gSpriteSheetTexture.render( CENTERED_HORIZONTALLY, CENTERED_VERTICALLY, &currentClip );
+
+				// Update screen, timing it
+				gPresent.present();
 			}
 		}
 	}
@@ -5,9 +5,13 @@ echo.
 
 @REM Set temporary environment variables
 set SDL2_PROJECT_NAME=14_animated_sprites_and_vsync
+
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..\..\Engine_Lib
+
 set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
 set SDL2_LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 -lSDL2_image
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2 -lSDL2_image
 
 set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
 set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
@@ -30,7 +34,7 @@ if exist %SDL2_PROJECT_NAME%.exe (
 echo Building executable...
 echo.
 
-g++ %COMPILATION_OPTIONS% %SDL2_PROJECT_NAME%.cpp -I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% %SDL2_LIBRARIES% -o %SDL2_PROJECT_NAME%.exe
+g++ %COMPILATION_OPTIONS% %SDL2_PROJECT_NAME%.cpp -I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%ENGINE_LIB_PATH% -L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% -L%ENGINE_LIB_PATH% %SDL2_LIBRARIES% -o %SDL2_PROJECT_NAME%.exe
 
 IF %ERRORLEVEL% EQU 0 (
   echo.
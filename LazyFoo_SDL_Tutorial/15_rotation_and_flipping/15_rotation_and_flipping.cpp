@@ -11,6 +11,11 @@
  * SDL_RenderCopyEx works the same as the original SDL_RenderCopy, but with additional arguments for
  * rotation and flipping.
  *
+ * Aggiunta GS: con l'argomento "--software" (o se non c'è un renderer) la freccia è disegnata sulla
+ * superficie della finestra da "LSoftRenderer" di Engine_Lib, senza GPU: ruotata, ribaltata e
+ * filtrata in modo bilineare dalla CPU, con SSE2, AVX2 o NEON, a riquadri di 64 pixel distribuiti
+ * sui core dal sistema di job. "SDL_UpdateWindowSurface" mostra poi il frame.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -24,8 +29,13 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <string.h>
 #include <cmath>
 
+// Software rendering
+#include "LJobSystem.hpp"
+#include "LSoftRenderer.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -51,6 +61,8 @@ static const std::string FilePath("arrow.png");
 
 static constexpr double ROTATION_ANGLE = 15.0;
 
+static constexpr char SOFTWARE_ARGUMENT[] = "--software";
+
 /***************************************************************************************************
 * Classes
 ****************************************************************************************************/
@@ -91,6 +103,9 @@ class LTexture
     // The actual hardware texture
     SDL_Texture* mTexture;
 
+    // Its pixels in software mode
+    LSoftTexture mSoftTexture;
+
     // Image dimensions
     int mWidth;
     int mHeight;
@@ -112,7 +127,12 @@ static void PressEnter(void);
 ****************************************************************************************************/
 
 static SDL_Window*   gWindow   = NULL;   // The window we'll be rendering to
-static SDL_Renderer* gRenderer = NULL;   // The window renderer
+static SDL_Renderer* gRenderer = NULL;   // The window renderer, not used in software mode
+
+// Software mode: drawn on the window's surface by the CPU
+static bool          gSoftware = false;
+static LSoftRenderer gSoftRenderer;
+static LJobSystem    gJobs;
 
 // Scene texture
 LTexture gArrowTexture;
@@ -160,6 +180,24 @@ bool LTexture::loadFromFile( const std::string& path )
     // Color key image
     SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
 
+    // Software mode: the pixels are kept, premultiplied, with the colour key as transparency
+    if( gSoftware )
+    {
+      if( mSoftTexture.loadFromSurface( loadedSurface ) )
+      {
+        mWidth  = loadedSurface->w;
+        mHeight = loadedSurface->h;
+      }
+      else
+      {;}
+
+      SDL_FreeSurface( loadedSurface );
+
+      return mSoftTexture.GetWidth() != 0;
+    }
+    else
+    {;}
+
     // Create texture from surface pixels
     newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
 
@@ -189,6 +227,8 @@ bool LTexture::loadFromFile( const std::string& path )
 
 void LTexture::free(void)
 {
+  mSoftTexture.free();
+
   // Free texture if it exists
   if( mTexture != NULL )
   {
@@ -211,6 +251,7 @@ void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
 {
   // Modulate texture
   SDL_SetTextureColorMod( mTexture, red, green, blue );
+  mSoftTexture.setColorMod( red, green, blue );
 }
 
 
@@ -218,6 +259,7 @@ void LTexture::setBlendMode( SDL_BlendMode blending )
 {
   // Set blending function
   SDL_SetTextureBlendMode( mTexture, blending );
+  mSoftTexture.setBlendMode( blending );
 }
 
 
@@ -225,6 +267,7 @@ void LTexture::setAlpha( Uint8 alpha )
 {
   // Modulate texture alpha
   SDL_SetTextureAlphaMod( mTexture, alpha );
+  mSoftTexture.setAlphaMod( alpha );
 }
 
 
@@ -253,7 +296,14 @@ void LTexture::render( int x, int y, SDL_Rect* SourceClip, double angle, SDL_Poi
   {;}
 
   // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, SourceClip, &Destination, angle, center, flip );
+  if( gSoftware )
+  {
+    gSoftRenderer.copyEx( mSoftTexture, SourceClip, &Destination, angle, center, flip );
+  }
+  else
+  {
+    SDL_RenderCopyEx( gRenderer, mTexture, SourceClip, &Destination, angle, center, flip );
+  }
 }
 
 
@@ -310,19 +360,38 @@ static bool init(void)
       printf( "\nWindow created" );
 
       // Create accelerated and vsynced renderer for window
-      gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+      if( !gSoftware )
+      {
+        gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
 
-      if( gRenderer == NULL )
+        if( gRenderer == NULL )
+        {
+          printf( "\nRenderer could not be created, drawing in software! SDL Error: %s", SDL_GetError() );
+          gSoftware = true;
+        }
+        else
+        {;}
+      }
+      else
+      {;}
+
+      // No renderer: the arrow is drawn on the window's surface, the tiles on all cores
+      if( gSoftware && ( !gJobs.init() || !gSoftRenderer.setTarget( SDL_GetWindowSurface( gWindow ), &gJobs ) ) )
       {
-        printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
+        printf( "\nSoftware renderer could not be created! SDL Error: %s", SDL_GetError() );
         success = false;
       }
       else
       {
-        printf( "\nRenderer created" );
+        printf( gSoftware ? "\nSoftware renderer created" : "\nRenderer created" );
 
         // Initialize renderer color
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+        if( !gSoftware )
+        {
+          SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+        }
+        else
+        {;}
 
         // Initialize PNG loading
         int imgFlags = IMG_INIT_PNG;
@@ -377,6 +446,9 @@ static void close(void)
   // Free loaded images
   gArrowTexture.free();
 
+  // Stop the workers of the software renderer
+  gJobs.shutdown();
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -414,6 +486,14 @@ int main( int argc, char* args[] )
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    // Drawn by the CPU instead of the GPU
+    if( strcmp( args[i], SOFTWARE_ARGUMENT ) == 0 )
+    {
+      gSoftware = true;
+    }
+    else
+    {;}
   }
 
   // Start up SDL and create window
@@ -485,8 +565,16 @@ int main( int argc, char* args[] )
         }
 
         // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
-        SDL_RenderClear( gRenderer );
+        if( gSoftware )
+        {
+          gSoftRenderer.setDrawColor( WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+          gSoftRenderer.clear();
+        }
+        else
+        {
+          SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+          SDL_RenderClear( gRenderer );
+        }
 
         // Render arrow
         int CENTERED_HORIZONTALLY = ( WINDOW_W - gArrowTexture.getWidth()  ) / 2;
@@ -494,7 +582,15 @@ int main( int argc, char* args[] )
         gArrowTexture.render( CENTERED_HORIZONTALLY, CENTERED_VERTICALLY, NULL, degrees, NULL, flipType );
 
         // Update screen
-        SDL_RenderPresent( gRenderer );
+        if( gSoftware )
+        {
+          gSoftRenderer.flush();
+          SDL_UpdateWindowSurface( gWindow );
+        }
+        else
+        {
+          SDL_RenderPresent( gRenderer );
+        }
       }
     }
   }
@@ -50,6 +50,18 @@
  * There are also mouse wheel events which weren't covered here, but if you look at the
  * documentation and play around with it it shouldn't be too hard to figure out.
  *
+ * Aggiunta GS: con l'argomento "--late-latch" ogni frame parte, e legge gli eventi, il più tardi
+ * possibile prima del prossimo refresh ("LLateLatch" di Engine_Lib/LLateLatch), e subito prima di
+ * disegnare i pulsanti la posizione del mouse viene riletta, così l'evidenziazione segue il cursore
+ * con il frame in cui viene mostrata e non con quello precedente. All'uscita si stampa la latenza
+ * media, dalla lettura dell'input alla fine del present, misurata anche senza l'argomento.
+ *
+ * Aggiunta GS: gli eventi passano da "LEventFilter" di Engine_Lib/LEventFilter. Un filtro SDL
+ * scarta già in coda i tipi che il programma non gestisce (qui restano l'uscita e il mouse), e a
+ * ogni frame i movimenti del mouse consecutivi diventano uno solo, l'ultimo: con un mouse a 1000 Hz
+ * i pulsanti ricevono un evento di movimento per frame invece di decine. Un frame gestisce al più
+ * LEventFilter::s_DEFAULT_BUDGET eventi, gli altri restano in coda per il successivo.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -62,7 +74,10 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <stdio.h>
+#include <cstring>
 #include <string>
+#include "LEventFilter.hpp"
+#include "LLateLatch.hpp"
 
 
 /**************************************************************************************************
@@ -71,6 +86,8 @@
 
 static constexpr int INIT_FIRST_ONE_AVAILABLE = -1;
 
+static constexpr char LATE_LATCH_ARGUMENT[] = "--late-latch";
+
 static constexpr int SCREEN_W = 640; // Screen's width
 static constexpr int SCREEN_H = 480; // Screen's heigth
 
@@ -175,10 +192,16 @@ class LButton
     // Handles mouse event
     void handleEvent( SDL_Event* );
 
+    // Moves the highlight in or out with a mouse position read just before drawing
+    void latch( int, int );
+
     // Shows button sprite
     void render(void);
 
   private:
+    // Whether a point is over the button
+    bool isInside( int, int ) const;
+
     // Top left position
     SDL_Point mPosition;
 
@@ -211,6 +234,12 @@ static LTexture gButtonSpriteSheetTexture;
 // Buttons objects
 static LButton gButtons[ TOTAL_BUTTONS ];
 
+// Start of each frame, and reading of the mouse, as late as the next refresh allows ("--late-latch")
+static LLateLatch gLatch;
+
+// The events handled, the mouse motion merged once per frame
+static LEventFilter gEvents;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -426,34 +455,8 @@ void LButton::handleEvent( SDL_Event* e )
     int x, y;
     SDL_GetMouseState( &x, &y );
 
-    // Check if mouse is inside button
-    bool inside = true;
-
-    // Mouse is left of the button
-    if( x < mPosition.x )
-    {
-      inside = false;
-    }
-    // Mouse is right of the button
-    else if( x > mPosition.x + BUTTON_W )
-    {
-      inside = false;
-    }
-    // Mouse above the button
-    else if( y < mPosition.y )
-    {
-      inside = false;
-    }
-    // Mouse below the button
-    else if( y > mPosition.y + BUTTON_H )
-    {
-      inside = false;
-    }
-    else
-    {;} // Mouse is inside the button
-
     // Mouse is outside button
-    if( !inside )
+    if( !isInside( x, y ) )
     {
       mCurrentSprite = BUTTON_SPRITE_MOUSE_OUT;
     }
@@ -482,6 +485,55 @@ void LButton::handleEvent( SDL_Event* e )
 }
 
 
+void LButton::latch( int x, int y )
+{
+  // Mouse is outside button
+  if( !isInside( x, y ) )
+  {
+    mCurrentSprite = BUTTON_SPRITE_MOUSE_OUT;
+  }
+  // Mouse has just come in: a press or a release waits for its event
+  else if( mCurrentSprite == BUTTON_SPRITE_MOUSE_OUT )
+  {
+    mCurrentSprite = BUTTON_SPRITE_MOUSE_OVER_MOTION;
+  }
+  else
+  {;} // Mouse is still inside button
+}
+
+
+bool LButton::isInside( int x, int y ) const
+{
+  // Check if mouse is inside button
+  bool inside = true;
+
+  // Mouse is left of the button
+  if( x < mPosition.x )
+  {
+    inside = false;
+  }
+  // Mouse is right of the button
+  else if( x > mPosition.x + BUTTON_W )
+  {
+    inside = false;
+  }
+  // Mouse above the button
+  else if( y < mPosition.y )
+  {
+    inside = false;
+  }
+  // Mouse below the button
+  else if( y > mPosition.y + BUTTON_H )
+  {
+    inside = false;
+  }
+  else
+  {;} // Mouse is inside the button
+
+  return inside;
+}
+
+
 void LButton::render(void)
 {
   // Show current button sprite
@@ -508,6 +560,11 @@ static bool init(void)
   {
     printf( "\nSDL initialised" );
 
+    // Only the events the buttons and the main loop handle are queued
+    gEvents.subscribe( SDL_QUIT );
+    gEvents.subscribe( SDL_MOUSEMOTION, SDL_MOUSEBUTTONUP );
+    gEvents.install();
+
     // Set texture filtering to linear
     if( !SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "1" ) )
     {
@@ -611,6 +668,14 @@ static void close(void)
   // Free loaded images
   gButtonSpriteSheetTexture.free();
 
+  // Input-to-present latency, with the latch or without
+  gLatch.report();
+
+  // How many events never reached the buttons
+  printf( "\nEvents: %u dropped by the filter, %llu mouse motions merged", gEvents.GetDropped(),
+          static_cast<unsigned long long>( gEvents.GetCoalesced() ) );
+  gEvents.uninstall();
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -644,6 +709,17 @@ int main( int argc, char* args[] )
 
   printf("\n*** Debugging console ***\n");
 
+  // Frames started just in time for the next refresh
+  for( int i = 1; i != argc; ++i )
+  {
+    if( strcmp( args[i], LATE_LATCH_ARGUMENT ) == 0 )
+    {
+      gLatch.setEnabled( true );
+    }
+    else
+    {;}
+  }
+
   // Start up SDL and create window
   if( !init() )
   {
@@ -664,11 +740,17 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // Refresh period of the display the window is on
+      gLatch.matchDisplay( gWindow );
+
       // While application is running
       while( !quit )
       {
+        // Wait for the latest start that makes the next refresh, if late latching
+        gLatch.wait();
+
         // Handle events on queue
-        while( SDL_PollEvent( &e ) != 0 )
+        while( gEvents.poll( e ) )
         {
           // User requests quit
           if( e.type == SDL_QUIT )
@@ -689,14 +771,28 @@ int main( int argc, char* args[] )
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
+        // Read the mouse again right before the buttons follow it
+        if( gLatch.IsEnabled() )
+        {
+          int x, y;
+          gLatch.latchMouse( x, y );
+
+          for( int i = 0; i < TOTAL_BUTTONS; ++i )
+          {
+            gButtons[ i ].latch( x, y );
+          }
+        }
+        else
+        {;}
+
         // Render buttons
         for( int i = 0; i < TOTAL_BUTTONS; ++i )
         {
           gButtons[ i ].render();
         }
 
-        // Update screen
-        SDL_RenderPresent( gRenderer );
+        // Update screen, timing it
+        gLatch.present( gRenderer );
       }
     }
   }
@@ -25,6 +25,15 @@
  * key is down we set the current texture to the corresponding texture. If none of the keys are
  * down, we set the default texture.
  *
+ * Aggiunta GS: lo stato dei tasti non è più chiesto a SDL con "SDL_GetKeyboardState", ma letto da
+ * "LInput" di Engine_Lib/LInput. Una volta per frame "poll" svuota la coda degli eventi in
+ * un'istantanea (tasti in bitset, assi e pulsanti del primo joystick, mouse) e aggiorna le azioni
+ * "Up", "Down", "Left" e "Right", legate alle frecce, a WASD e alla levetta del primo joystick:
+ * chiedere se un'azione è attiva è un test su un bit. "poll" è chiamato subito prima di scegliere
+ * la texture, per leggere l'input il più tardi possibile; dopo "SDL_RenderPresent", "presented"
+ * misura il tempo dal primo evento di input del frame alla sua presentazione, e alla chiusura il
+ * programma stampa media, 99° percentile e massimo di questa latenza.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -38,6 +47,7 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include "LInput.hpp"
 
 
 /**************************************************************************************************
@@ -123,6 +133,7 @@ class LTexture
 ****************************************************************************************************/
 
 static bool init(void);
+static void initInput(void);
 static bool loadMedia(void);
 static void close(void);
 static void PressEnter(void);
@@ -142,6 +153,13 @@ LTexture gDownTexture;
 LTexture gLeftTexture;
 LTexture gRightTexture;
 
+// Input, read once per frame, and its actions
+static LInput gInput;
+static int    gUpAction    = -1;
+static int    gDownAction  = -1;
+static int    gLeftAction  = -1;
+static int    gRightAction = -1;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -337,7 +355,7 @@ static bool init(void)
   bool success = true;
 
   // Initialize SDL
-  if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+  if( SDL_Init( SDL_INIT_VIDEO | SDL_INIT_JOYSTICK ) < 0 )
   {
     printf( "\nSDL could not initialize! SDL Error: %s", SDL_GetError() );
     success = false;
@@ -406,6 +424,33 @@ static bool init(void)
 }
 
 
+/**
+ * @brief Binds every direction to its arrow key, to WASD, and to the first joystick's stick.
+ **/
+static void initInput(void)
+{
+  gUpAction    = gInput.addAction( "Up" );
+  gDownAction  = gInput.addAction( "Down" );
+  gLeftAction  = gInput.addAction( "Left" );
+  gRightAction = gInput.addAction( "Right" );
+
+  gInput.bind( gUpAction,    LInput::Source::KEY, SDL_SCANCODE_UP );
+  gInput.bind( gDownAction,  LInput::Source::KEY, SDL_SCANCODE_DOWN );
+  gInput.bind( gLeftAction,  LInput::Source::KEY, SDL_SCANCODE_LEFT );
+  gInput.bind( gRightAction, LInput::Source::KEY, SDL_SCANCODE_RIGHT );
+
+  gInput.bind( gUpAction,    LInput::Source::KEY, SDL_SCANCODE_W );
+  gInput.bind( gDownAction,  LInput::Source::KEY, SDL_SCANCODE_S );
+  gInput.bind( gLeftAction,  LInput::Source::KEY, SDL_SCANCODE_A );
+  gInput.bind( gRightAction, LInput::Source::KEY, SDL_SCANCODE_D );
+
+  gInput.bind( gUpAction,    LInput::Source::JOY_AXIS_MINUS, 1 );
+  gInput.bind( gDownAction,  LInput::Source::JOY_AXIS_PLUS,  1 );
+  gInput.bind( gLeftAction,  LInput::Source::JOY_AXIS_MINUS, 0 );
+  gInput.bind( gRightAction, LInput::Source::JOY_AXIS_PLUS,  0 );
+}
+
+
 /**
  * @brief Loads all necessary media for this project.
  *
@@ -470,6 +515,9 @@ static void close(void)
   gRenderer = NULL;
   gWindow   = NULL;
 
+  // Let go of the joystick
+  gInput.close();
+
   // Quit SDL subsystems
   IMG_Quit();
   SDL_Quit();
@@ -511,46 +559,38 @@ int main( int argc, char* args[] )
     }
     else
     {
+      // Directions
+      initInput();
+
       // Main loop flag
       bool quit = false;
 
-      // Event handler
-      SDL_Event e;
-
       // Current rendered texture
       LTexture* currentTexture = NULL;
 
       // While application is running
       while( !quit )
       {
-        // Handle events on queue. IMPORTANTE: l'event loop è richiesto anche se usiamo gli stati anziché gli eventi!
-        while( SDL_PollEvent( &e ) != 0 )
-        {
-          // User requests quit
-          if( e.type == SDL_QUIT )
-          {
-            quit = true;
-          }
-          else
-          {;} // No events to process
-        }
+        // Drain the events on queue into the input snapshot. IMPORTANTE: la coda va svuotata anche se usiamo gli stati anziché gli eventi!
+        gInput.poll();
 
-        // Set texture based on current keystate
-        const Uint8* currentKeyStates = SDL_GetKeyboardState( NULL );
+        // User requests quit
+        quit = gInput.GetSnapshot().Quit;
 
-        if( currentKeyStates[ SDL_SCANCODE_UP ] )
+        // Set texture based on current actions
+        if( gInput.IsDown( gUpAction ) )
         {
           currentTexture = &gUpTexture;
         }
-        else if( currentKeyStates[ SDL_SCANCODE_DOWN ] )
+        else if( gInput.IsDown( gDownAction ) )
         {
           currentTexture = &gDownTexture;
         }
-        else if( currentKeyStates[ SDL_SCANCODE_LEFT ] )
+        else if( gInput.IsDown( gLeftAction ) )
         {
           currentTexture = &gLeftTexture;
         }
-        else if( currentKeyStates[ SDL_SCANCODE_RIGHT ] )
+        else if( gInput.IsDown( gRightAction ) )
         {
           currentTexture = &gRightTexture;
         }
@@ -568,7 +608,21 @@ int main( int argc, char* args[] )
 
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        // From the first input of the frame to here
+        gInput.presented();
       }
+
+      const LFrameStats& latency = gInput.GetLatency();
+
+      if( latency.GetCount() > 0 )
+      {
+        printf( "\nInput to present over the last %u inputs: %.1f ms average, %.1f ms 99%%, %.1f ms max",
+                static_cast<unsigned>( latency.GetCount() ), latency.GetAverage() * 1000.0,
+                latency.GetPercentile( 0.99 ) * 1000.0, latency.GetMax() * 1000.0 );
+      }
+      else
+      { /* No input at all */ }
     }
   }
 
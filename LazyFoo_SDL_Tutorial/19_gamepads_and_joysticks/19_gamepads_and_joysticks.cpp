@@ -3,6 +3,18 @@
  *
  * @brief
  *
+ * Aggiunta GS: gli eventi SDL_JOYAXISMOTION non sono più confrontati a uno a uno con la zona morta
+ * nel ciclo degli eventi. "LInput" di Engine_Lib/LInput svuota la coda una volta per frame e tiene
+ * gli assi del primo joystick in un'istantanea, già a zero entro JOYSTICK_DEAD_ZONE: la direzione è
+ * il segno dei primi due assi. LInput apre da sé il primo joystick collegato, anche dopo l'avvio, e
+ * ne apre un altro se viene scollegato.
+ *
+ * Aggiunta GS: con l'argomento "--pump" il joystick è letto da "LInputPump" di
+ * Engine_Lib/LInputPump, su un thread suo, ogni millisecondo: ogni cambiamento di un asse o di un
+ * pulsante diventa un evento con l'istante in cui è stato letto, in una coda senza lock da cui
+ * LInput lo prende al frame successivo. Un frame lento ritarda ancora la risposta, ma non più la
+ * lettura: la latenza stampata all'uscita parte dal movimento vero. SDL_HINT_JOYSTICK_THREAD
+ * sposta anche i messaggi del joystick di SDL fuori dal thread principale, su Windows.
  *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
@@ -18,6 +30,9 @@
 #include <stdio.h>
 #include <string>
 #include <cmath>
+#include <cstring>
+#include "LInput.hpp"
+#include "LInputPump.hpp"
 
 
 /**************************************************************************************************
@@ -32,6 +47,8 @@ static constexpr int SCREEN_H = 480; // Screen's heigth
 // Analog joystick dead zone
 static const int JOYSTICK_DEAD_ZONE = 8000;
 
+static constexpr char PUMP_ARGUMENT[] = "--pump";
+
 // Colore bianco
 static constexpr int WHITE_R = 0xFF; // Amount of red   needed to compose white
 static constexpr int WHITE_G = 0xFF; // Amount of green needed to compose white
@@ -116,7 +133,10 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 static LTexture gArrowTexture; // Scene textures
 
-static SDL_Joystick* gGameController = NULL; // Game Controller 1 handler
+static LInput gInput; // Input of the frame, first joystick included
+
+static LInputPump gPump;             // Joystick read on a thread of its own
+static bool       gUsePump = false;  // PUMP_ARGUMENT given
 
 
 /***************************************************************************************************
@@ -298,6 +318,14 @@ static bool init(void)
 	// Initialization flag
 	bool success = true;
 
+	// SDL's joystick messages off the main thread too, where the backend allows it
+	if( gUsePump )
+	{
+		SDL_SetHint( SDL_HINT_JOYSTICK_THREAD, "1" );
+	}
+	else
+	{;}
+
 	// Initialize SDL
 	if( SDL_Init( SDL_INIT_VIDEO | SDL_INIT_JOYSTICK ) < 0 )
 	{
@@ -318,20 +346,23 @@ static bool init(void)
 			printf( "\nLinear texture filtering enabled" );
 		}
 
-		// Check for joysticks
+		// Check for joysticks; LInput opens the first one, now or when it is plugged in
 		if( SDL_NumJoysticks() < 1 )
 		{
 			printf( "\nWarning: No joysticks connected!" );
 		}
 		else
+		{;}
+
+		gInput.setDeadZone( JOYSTICK_DEAD_ZONE );
+
+		if( gUsePump && gPump.start() )
 		{
-			// Load joystick
-			gGameController = SDL_JoystickOpen( 0 );
-			if( gGameController == NULL )
-			{
-				printf( "\nWarning: Unable to open game controller! SDL Error: %s", SDL_GetError() );
-			}
+			printf( "\nJoystick read by the input thread" );
+			gInput.setPump( &gPump );
 		}
+		else
+		{;}
 
 		// Create window
 		gWindow = SDL_CreateWindow( "SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_W, SCREEN_H, SDL_WINDOW_SHOWN );
@@ -408,9 +439,10 @@ static void close(void)
 	// Free loaded images
 	gArrowTexture.free();
 
-	// Close game controller
-	SDL_JoystickClose( gGameController );
-	gGameController = NULL;
+	// Stop the input thread, then close game controller
+	gInput.setPump( nullptr );
+	gPump.stop();
+	gInput.close();
 
 	// Destroy window
 	SDL_DestroyRenderer( gRenderer );
@@ -445,6 +477,17 @@ int main( int argc, char* args[] )
 
   printf("\n*** Debugging console ***\n");
 
+  for (int i = 1; i != argc; ++i)
+  {
+    // Joystick read on its own thread, instead of at every poll
+    if( strcmp( args[i], PUMP_ARGUMENT ) == 0 )
+    {
+      gUsePump = true;
+    }
+    else
+    {;}
+  }
+
 	// Start up SDL and create window
 	if( !init() )
 	{
@@ -462,9 +505,6 @@ int main( int argc, char* args[] )
 			// Main loop flag
 			bool quit = false;
 
-			// Event handler
-			SDL_Event e;
-
 			// Normalized direction
 			int xDir = 0;
 			int yDir = 0;
@@ -472,58 +512,17 @@ int main( int argc, char* args[] )
 			// While application is running
 			while( !quit )
 			{
-				// Handle events on queue
-				while( SDL_PollEvent( &e ) != 0 )
-				{
-					// User requests quit
-					if( e.type == SDL_QUIT )
-					{
-						quit = true;
-					}
-					else if( e.type == SDL_JOYAXISMOTION )
-					{
-						// Motion on controller 0
-						if( e.jaxis.which == 0 )
-						{
-							// X axis motion
-							if( e.jaxis.axis == 0 )
-							{
-								// Left of dead zone
-								if( e.jaxis.value < -JOYSTICK_DEAD_ZONE )
-								{
-									xDir = -1;
-								}
-								// Right of dead zone
-								else if( e.jaxis.value > JOYSTICK_DEAD_ZONE )
-								{
-									xDir = 1;
-								}
-								else
-								{
-									xDir = 0;
-								}
-							}
-							// Y axis motion
-							else if( e.jaxis.axis == 1 )
-							{
-								// Below of dead zone
-								if( e.jaxis.value < -JOYSTICK_DEAD_ZONE )
-								{
-									yDir = -1;
-								}
-								// Above of dead zone
-								else if( e.jaxis.value > JOYSTICK_DEAD_ZONE )
-								{
-									yDir =  1;
-								}
-								else
-								{
-									yDir = 0;
-								}
-							}
-						}
-					}
-				}
+				// Drain the events on queue into the input snapshot
+				gInput.poll();
+
+				const LInputSnapshot& input = gInput.GetSnapshot();
+
+				// User requests quit
+				quit = input.Quit;
+
+				// Axes of controller 0 are already 0 inside the dead zone
+				xDir = ( input.Axes[ 0 ] > 0 ) - ( input.Axes[ 0 ] < 0 );
+				yDir = ( input.Axes[ 1 ] > 0 ) - ( input.Axes[ 1 ] < 0 );
 
 				// Clear screen
 				SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
@@ -547,7 +546,19 @@ int main( int argc, char* args[] )
 
 				// Update screen
 				SDL_RenderPresent( gRenderer );
+				gInput.presented();
+			}
+
+			const LFrameStats& latency = gInput.GetLatency();
+
+			if( latency.GetCount() > 0 )
+			{
+				printf( "\nInput latency: %.2f ms average, %.2f ms 99th percentile, %.2f ms max (%u events dropped)",
+				        latency.GetAverage() * 1000.0, latency.GetPercentile( 0.99 ) * 1000.0, latency.GetMax() * 1000.0,
+				        gPump.GetDropped() );
 			}
+			else
+			{;}
 		}
 	}
 
@@ -3,6 +3,13 @@
  *
  * @brief
  *
+ * Aggiunta GS: il game controller, o il joystick con il suo dispositivo aptico, non è più aperto e
+ * fatto vibrare dal thread principale. "LInputPump" di Engine_Lib/LInputPump legge il primo
+ * joystick su un thread suo, ogni millisecondo, e ne mette i pulsanti premuti in una coda senza lock
+ * con l'istante della lettura; "rumble" accoda il comando di vibrazione allo stesso thread, che lo
+ * esegue con SDL_JoystickRumble (valida anche per i game controller) o, se il joystick ha solo
+ * quella, con l'API aptica. Il ciclo principale non aspetta mai il dispositivo, e la vibrazione non
+ * dipende più da quanto dura un frame per essere letta dal joystick.
  *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
@@ -18,6 +25,7 @@
 #include <stdio.h>
 #include <string>
 #include <cmath>
+#include "LInputPump.hpp"
 
 
 /**************************************************************************************************
@@ -42,6 +50,10 @@ static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
 
 static const std::string FilePath("splash.png");
 
+// Rumble at 75% strength for 500 milliseconds
+static constexpr Uint16 RUMBLE_STRENGTH    = 0xFFFF * 3 / 4;
+static constexpr Uint32 RUMBLE_DURATION_ms = 500;
+
 
 /***************************************************************************************************
 * Classes
@@ -113,11 +125,7 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 static LTexture gSplashTexture; // Scene texture
 
-static SDL_GameController* gGameController = NULL; // Game controller handler with force feedback
-
-// Joystick handler with haptic
-static SDL_Joystick* gJoystick  = NULL;
-static SDL_Haptic*   gJoyHaptic = NULL;
+static LInputPump gPump; // First joystick read, and made to rumble, on a thread of its own
 
 
 /***************************************************************************************************
@@ -319,63 +327,21 @@ static bool init(void)
 			printf( "\nLinear texture filtering enabled" );
 		}
 
-    // Check for joysticks
+    // Check for joysticks; the input thread opens the first one, now or when it is plugged in
     if( SDL_NumJoysticks() < 1 )
     {
 			printf( "\nWarning: No joysticks connected!" );
     }
     else
-    {
-      // Check if first joystick is game controller interface compatible
-      if( !SDL_IsGameController( 0 ) )
-      {
-        printf( "Warning: Joystick is not game controller interface compatible! SDL Error: %s\n", SDL_GetError() );
-      }
-      else
-      {
-        // Open game controller and check if it supports rumble
-        gGameController = SDL_GameControllerOpen( 0 );
-        if( !SDL_GameControllerHasRumble( gGameController ) )
-        {
-          printf( "Warning: Game controller does not have rumble! SDL Error: %s\n", SDL_GetError() );
-        }
-      }
+    {;}
 
-      // Load joystick if game controller could not be loaded
-      if( gGameController == NULL )
-      {
-        // Open first joystick
-        gJoystick = SDL_JoystickOpen( 0 );
-        if( gJoystick == NULL )
-        {
-          printf( "Warning: Unable to open joystick! SDL Error: %s\n", SDL_GetError() );
-        }
-        else
-        {
-          // Check if joystick supports haptic
-          if( !SDL_JoystickIsHaptic( gJoystick ) )
-          {
-            printf( "Warning: Controller does not support haptics! SDL Error: %s\n", SDL_GetError() );
-          }
-          else
-          {
-            // Get joystick haptic device
-            gJoyHaptic = SDL_HapticOpenFromJoystick( gJoystick );
-            if( gJoyHaptic == NULL )
-            {
-              printf( "Warning: Unable to get joystick haptics! SDL Error: %s\n", SDL_GetError() );
-            }
-            else
-            {
-              // Initialize rumble
-              if( SDL_HapticRumbleInit( gJoyHaptic ) < 0 )
-              {
-                printf( "Warning: Unable to initialize haptic rumble! SDL Error: %s\n", SDL_GetError() );
-              }
-            }
-          }
-        }
-      }
+    if( !gPump.start() )
+    {
+      printf( "\nWarning: Unable to start the input thread: no rumble!" );
+    }
+    else
+    {
+      printf( "\nInput thread started" );
     }
 
     // Create window
@@ -453,22 +419,15 @@ static void close(void)
   // Free loaded images
   gSplashTexture.free();
 
-  // Close game controller or joystick with haptics
-  if( gGameController != NULL )
-  {
-    SDL_GameControllerClose( gGameController );
-  }
-  if( gJoyHaptic != NULL )
-  {
-    SDL_HapticClose( gJoyHaptic );
-  }
-  if( gJoystick != NULL )
+  // Stop the input thread, which stops the rumble and closes the joystick
+  gPump.stop();
+
+  if( gPump.GetRumbleFailures() > 0 )
   {
-    SDL_JoystickClose( gJoystick );
+    printf( "\nWarning: %u rumbles could not be played!", gPump.GetRumbleFailures() );
   }
-  gGameController = NULL;
-  gJoystick = NULL;
-  gJoyHaptic = NULL;
+  else
+  {;}
 
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
@@ -523,6 +482,9 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // When the input thread read the joystick event
+      Uint64 readCounts = 0;
+
       // While application is running
       while( !quit )
       {
@@ -534,28 +496,18 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
-          // Joystick button press
-          else if( e.type == SDL_JOYBUTTONDOWN )
+        }
+
+        // Joystick button presses, read by the input thread; SDL's own are not handled above
+        while( gPump.popEvent( e, readCounts ) )
+        {
+          if( e.type == SDL_JOYBUTTONDOWN )
           {
-            // Use game controller
-            if( gGameController != NULL )
-            {
-              // Play rumble at 75% strength for 500 milliseconds
-              if( SDL_GameControllerRumble( gGameController, 0xFFFF * 3 / 4, 0xFFFF * 3 / 4, 500 ) != 0 )
-              {
-                printf( "Warning: Unable to play game contoller rumble! %s\n", SDL_GetError() );
-              }
-            }
-            // Use haptics
-            else if( gJoyHaptic != NULL )
-            {
-              // Play rumble at 75% strength for 500 milliseconds
-              if( SDL_HapticRumblePlay( gJoyHaptic, 0.75, 500 ) != 0 )
-              {
-                printf( "Warning: Unable to play haptic rumble! %s\n", SDL_GetError() );
-              }
-            }
+            // Played by the input thread: never waits for the device
+            gPump.rumble( RUMBLE_STRENGTH, RUMBLE_STRENGTH, RUMBLE_DURATION_ms );
           }
+          else
+          {;}
         }
 
         // Clear screen
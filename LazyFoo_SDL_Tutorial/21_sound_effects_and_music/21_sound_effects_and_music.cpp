@@ -50,6 +50,34 @@
  * Mix_ResumeMusic. If the music is not paused we pause it using Mix_PauseMusic. When 0 is pressed,
  * we stop music if it's playing using Mix_HaltMusic.
  *
+ * Aggiunta GS: gli effetti sonori non passano più da Mix_PlayChannel, il cui ritardo dipende da
+ * CHUNK_SIZE, ma da "LAudioMixer" di Engine_Lib. Il mixer apre un proprio dispositivo audio, con un
+ * buffer di MIXER_FRAMES frame (fino a 128, cioè meno di 3 ms a 48 kHz), e mescola i suoni nella
+ * callback di SDL: le voci sono allocate una volta sola, i campioni vengono sommati due frame alla
+ * volta con SSE2, e ogni variazione di volume (anche l'inizio e la fine di un suono) è una rampa
+ * lunga un buffer, così non ci sono click. Il main loop non attende mai la callback: le richieste
+ * passano da una coda senza lock. Tasto 5 per suonare 200 voci insieme; il titolo della finestra
+ * mostra le voci attive.
+ *
+ * Aggiunta GS: anche la musica è passata al mixer, e SDL_mixer non serve più. "LMusicStream" non
+ * decodifica tutto il brano al caricamento, come Mix_LoadMUS: "open" decodifica solo il primo
+ * blocco, e un thread dedicato tiene pronto circa un secondo di campioni in un ring buffer senza
+ * lock, da cui legge la callback del mixer. La memoria occupata non dipende dalla durata del brano
+ * ed è stampata al caricamento, insieme al numero di buffer rimasti senza campioni in chiusura. I
+ * tasti 9 e 0 funzionano come prima; pausa, ripresa e stop sono dissolvenze lunghe un buffer.
+ *
+ * Aggiunta GS: il mixer suona fino a 256 voci ma ne mescola al massimo 48, le più udibili: le altre
+ * diventano virtuali, cioè avanzano nel tempo senza essere lette, e rientrano in dissolvenza nel
+ * punto in cui sarebbero arrivate quando tornano fra le più udibili. La priorità è il volume, ridotto
+ * dalla distanza dall'ascoltatore, per il peso della categoria: le 200 voci del tasto 5 sono sparse
+ * a distanze crescenti, e i suoni dei tasti da 1 a 4 hanno una categoria con peso KEYS_WEIGHT, così
+ * si sentono anche durante la raffica. Il titolo della finestra mostra le voci mescolate e quelle
+ * virtuali.
+ *
+ * Aggiunta GS: con "--trace=<file>" il programma registra in un file Chrome trace (da aprire con
+ * chrome://tracing o https://ui.perfetto.dev) i frame del ciclo principale, le voci attive e ogni
+ * esecuzione della callback audio, sulla riga del thread audio (Engine_Lib/LTrace).
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -58,12 +86,15 @@
 * Includes
 ****************************************************************************************************/
 
-//  Using SDL, SDL_image, SDL_ttf, SDL_mixer, standard IO, math, and strings
+//  Using SDL, SDL_image, SDL_ttf, standard IO, math, and strings
 #include <SDL.h>
 #include <SDL_image.h>
-#include <SDL_mixer.h>
 #include <stdio.h>
 #include <string>
+#include "LAssetPack.hpp"
+#include "LAudioMixer.hpp"
+#include "LMusicStream.hpp"
+#include "LTrace.hpp"
 
 /**************************************************************************************************
 * Private constants
@@ -85,10 +116,17 @@ static constexpr int CYAN_R = 0x00; // Amount of red   needed to compose cyan
 static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
 static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
 
-static constexpr int SAMPLING_FREQ   = 44100;
-static constexpr int NUM_OF_CHANNELS = 2;
-static constexpr int CHUNK_SIZE      = 2048;
+// Sound effects and music: frames per buffer of the mixer, down to LAudioMixer::s_MIN_FRAMES
+static constexpr int   MIXER_FRAMES = 256;
+static constexpr int   BURST_VOICES = 200;
+static constexpr float BURST_VOLUME = 0.1f;
+static constexpr float BURST_FAR    = 10.f;  // Distance of the last voice of the burst
 
+// Voices beyond the real ones of the mixer are virtual: the keys win over the burst
+static constexpr int   KEYS_CATEGORY = 1;
+static constexpr float KEYS_WEIGHT   = 8.f;
+
+static const std::string PackPath   ("assets.lpak"); // Optional: see loadMedia
 static const std::string PromptPath ("prompt.png");
 static const std::string BeatPath   ("beat.wav");
 static const std::string ScratchPath("scratch.wav");
@@ -167,13 +205,14 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 static LTexture gPromptTexture; // Scene texture
 
-static Mix_Music *gMusic = NULL; // The music that will be played
-
-// The sound effects that will be used
-static Mix_Chunk *gScratch = NULL;
-static Mix_Chunk *gHigh    = NULL;
-static Mix_Chunk *gMedium  = NULL;
-static Mix_Chunk *gLow     = NULL;
+// The music and the sound effects that will be used, played by the engine mixer
+static LAssetPack   gAssets;
+static LAudioMixer  gMixer;
+static LMusicStream gMusic;
+static LSound      gScratch;
+static LSound      gHigh;
+static LSound      gMedium;
+static LSound      gLow;
 
 
 /***************************************************************************************************
@@ -205,7 +244,7 @@ bool LTexture::loadFromFile( const std::string& path )
   SDL_Texture* newTexture = NULL;
 
   // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
+  SDL_Surface* loadedSurface = IMG_Load_RW( LOpenAsset( path ), 1 );
 
   if( loadedSurface == NULL )
   {
@@ -413,15 +452,16 @@ static bool init(void)
           success = false;
         }
 
-         // Initialize SDL_mixer
-        if( Mix_OpenAudio( SAMPLING_FREQ, MIX_DEFAULT_FORMAT, NUM_OF_CHANNELS, CHUNK_SIZE ) < 0 )
+        // Initialize the mixer
+        if( !gMixer.open( MIXER_FRAMES ) )
         {
-          printf( "\nSDL_mixer could not initialize! SDL_mixer Error: %s", Mix_GetError() );
+          printf( "\nThe sound effects mixer could not be opened!" );
           success = false;
         }
         else
         {
-          printf( "\nSDL_mixer initialised" );
+          printf( "\nSound effects mixer opened: %d frames at %d Hz, %.1f ms per buffer", gMixer.GetFrames(), gMixer.GetFrequency(), gMixer.GetLatency_ms() );
+          gMixer.setCategoryWeight( KEYS_CATEGORY, KEYS_WEIGHT );
         }
 
       } // Renderer created
@@ -444,6 +484,17 @@ static bool loadMedia(void)
   // Loading success flag
   bool success = true;
 
+  // With a pack ("PackAssets assets.lpak prompt.png *.wav"), everything below comes from a single
+  // open, decompressed in the background while the first assets are read; without, from the files
+  if( gAssets.open( PackPath ) )
+  {
+    LAssetPack::SetDefault( &gAssets );
+    gAssets.prefetchAll();
+    printf( "\nAsset pack loaded: %zu entries", gAssets.GetNumOfEntries() );
+  }
+  else
+  {;}
+
   // Load prompt texture
   if( !gPromptTexture.loadFromFile( PromptPath ) )
   {
@@ -455,25 +506,21 @@ static bool loadMedia(void)
     printf( "\nPrompt texture loaded" );;
   }
 
-  // Load music
-  gMusic = Mix_LoadMUS( BeatPath.c_str() );
-
-  if( gMusic == NULL )
+  // Open the music: only its first chunk is decoded now, the rest while it plays
+  if( !gMusic.open( BeatPath, gMixer.GetFrequency() ) )
   {
-    printf( "\nFailed to load beat music! SDL_mixer Error: %s", Mix_GetError() );
+    printf( "\nFailed to load beat music!" );
     success = false;
   }
   else
   {
-    printf( "\nBeat music loaded" );
+    printf( "\nBeat music streamed: %zu bytes in memory", gMusic.GetMemoryBytes() );
   }
 
   // Load sound effects
-  gScratch = Mix_LoadWAV( ScratchPath.c_str() );
-
-  if( gScratch == NULL )
+  if( !gMixer.load( ScratchPath, gScratch ) )
   {
-    printf( "\nFailed to load scratch sound effect! SDL_mixer Error: %s", Mix_GetError() );
+    printf( "\nFailed to load scratch sound effect!" );
     success = false;
   }
   else
@@ -481,10 +528,9 @@ static bool loadMedia(void)
     printf( "\nScratch sound effect loaded" );
   }
 
-  gHigh = Mix_LoadWAV( HighPath.c_str() );
-  if( gHigh == NULL )
+  if( !gMixer.load( HighPath, gHigh ) )
   {
-    printf( "\nFailed to load high sound effect! SDL_mixer Error: %s", Mix_GetError() );
+    printf( "\nFailed to load high sound effect!" );
     success = false;
   }
   else
@@ -492,10 +538,9 @@ static bool loadMedia(void)
     printf( "High sound effect loaded" );
   }
 
-  gMedium = Mix_LoadWAV( MediumPath.c_str() );
-  if( gMedium == NULL )
+  if( !gMixer.load( MediumPath, gMedium ) )
   {
-    printf( "\nFailed to load medium sound effect! SDL_mixer Error: %s", Mix_GetError() );
+    printf( "\nFailed to load medium sound effect!" );
     success = false;
   }
   else
@@ -503,10 +548,9 @@ static bool loadMedia(void)
     printf( "Medium sound effect loaded" );
   }
 
-  gLow = Mix_LoadWAV( LowPath.c_str() );
-  if( gLow == NULL )
+  if( !gMixer.load( LowPath, gLow ) )
   {
-    printf( "\nFailed to load low sound effect! SDL_mixer Error: %s", Mix_GetError() );
+    printf( "\nFailed to load low sound effect!" );
     success = false;
   }
   else
@@ -523,19 +567,18 @@ static void close(void)
   // Free loaded images
   gPromptTexture.free();
 
-  // Free the sound effects
-  Mix_FreeChunk( gScratch );
-  Mix_FreeChunk( gHigh );
-  Mix_FreeChunk( gMedium );
-  Mix_FreeChunk( gLow );
-  gScratch = NULL;
-  gHigh = NULL;
-  gMedium = NULL;
-  gLow = NULL;
+  // Stop the mixer, then close the music and free the sound effects
+  gMixer.close();
+  printf( "\nMusic underruns: %llu", static_cast<unsigned long long>( gMusic.GetUnderruns() ) );
+  gMusic.close();
+  gScratch = LSound();
+  gHigh    = LSound();
+  gMedium  = LSound();
+  gLow     = LSound();
 
-  // Free the music
-  Mix_FreeMusic( gMusic );
-  gMusic = NULL;
+  // Then the pack
+  LAssetPack::SetDefault( nullptr );
+  gAssets.close();
 
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
@@ -544,7 +587,6 @@ static void close(void)
   gWindow   = NULL;
 
   // Quit SDL subsystems
-  Mix_Quit();
   IMG_Quit();
   SDL_Quit();
 }
@@ -571,8 +613,13 @@ int main( int argc, char* args[] )
 
   printf("\n*** Debugging console ***\n");
 
+  // "--trace=<file>" records a timeline of the main loop and of the audio callback
+  if( !LTrace::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   // Start up SDL and create window
-  if( !init() )
+  else if( !init() )
   {
     printf( "Failed to initialize!\n" );
   }
@@ -591,9 +638,17 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // Voices in the window title
+      int shownVoices  = -1;
+      int shownVirtual = -1;
+
+      LTrace::nameThread( "Main" );
+
       // While application is running
       while( !quit )
       {
+        LTrace::frameMark();
+
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
         {
@@ -609,57 +664,83 @@ int main( int argc, char* args[] )
             {
               // Play high sound effect
               case SDLK_1:
-              Mix_PlayChannel( -1, gHigh, 0 ); // ATTENZIONE: in questo caso, il "canale" non è il canale fisico (sinistro / destro)!, bensì un concetto software!
+              gMixer.play( gHigh, 1.f, 0.f, false, KEYS_CATEGORY );
               break;
 
               // Play medium sound effect
               case SDLK_2:
-              Mix_PlayChannel( -1, gMedium, 0 );
+              gMixer.play( gMedium, 1.f, 0.f, false, KEYS_CATEGORY );
               break;
 
               // Play low sound effect
               case SDLK_3:
-              Mix_PlayChannel( -1, gLow, 0 );
+              gMixer.play( gLow, 1.f, 0.f, false, KEYS_CATEGORY );
               break;
 
               // Play scratch sound effect
               case SDLK_4:
-              Mix_PlayChannel( -1, gScratch, 0 );
+              gMixer.play( gScratch, 1.f, 0.f, false, KEYS_CATEGORY );
+              break;
+
+              // Play many sound effects at once, spread from left to right
+              case SDLK_5:
+              for( int i = 0; i != BURST_VOICES; ++i )
+              {
+                const float Spread = static_cast<float>( i ) / ( BURST_VOICES - 1 );
+
+                gMixer.play( gLow, BURST_VOLUME, 2.f * Spread - 1.f, false, 0, 1.f + Spread * ( BURST_FAR - 1.f ) );
+              }
               break;
 
               case SDLK_9:
               // If there is no music playing
-              if( Mix_PlayingMusic() == 0 )
+              if( !gMixer.IsMusicPlaying() )
               {
-                // Play the music
-                Mix_PlayMusic( gMusic, -1 );
+                // Play the music from its start; it loops until it is stopped
+                gMusic.restart();
+                gMixer.playMusic( gMusic );
               }
               // If music is being played
               else
               {
                 // If the music is paused
-                if( Mix_PausedMusic() == 1 )
+                if( gMixer.IsMusicPaused() )
                 {
                   // Resume the music
-                  Mix_ResumeMusic();
+                  gMixer.resumeMusic();
                 }
                 // If the music is playing
                 else
                 {
                   // Pause the music
-                  Mix_PauseMusic();
+                  gMixer.pauseMusic();
                 }
               }
               break;
 
               case SDLK_0:
               // Stop the music
-              Mix_HaltMusic();
+              gMixer.stopMusic();
               break;
             }
           }
         }
 
+        // Show the voices being mixed and the virtual ones, when they change
+        if( gMixer.GetActiveVoices() != shownVoices || gMixer.GetVirtualVoices() != shownVirtual )
+        {
+          char title[ 64 ];
+
+          shownVoices  = gMixer.GetActiveVoices();
+          shownVirtual = gMixer.GetVirtualVoices();
+          SDL_snprintf( title, sizeof(title), "SDL Tutorial - %d voices, %d virtual", shownVoices, shownVirtual );
+          SDL_SetWindowTitle( gWindow, title );
+        }
+        else { /* Same as before */ }
+
+        LTrace::counter( "Voices", gMixer.GetActiveVoices() );
+        LTrace::counter( "Virtual voices", gMixer.GetVirtualVoices() );
+
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
         SDL_RenderClear( gRenderer );
@@ -673,6 +754,9 @@ int main( int argc, char* args[] )
     }
   }
 
+  // Write what is left of the trace while SDL is still up
+  LTrace::close();
+
   // Free resources and close SDL
   close();
 
@@ -6,18 +6,19 @@ echo.
 @REM Set temporary environment variables
 set SDL2_PROJECT_NAME=21_sound_effects_and_music
 
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..\..\Engine_Lib
+
 @REM Static libraries
 set SDL2_______LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
 set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
 set SDL2_TTF___LIB_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\lib\
-set SDL2_MIXER_LIB_PATH=D:\Dati\SDL2\SDL2_mixer-2.6.1\x86_64-w64-mingw32\lib\
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf -lSDL2_mixer
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf
 
 @REM Header files
 set SDL2_______INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
 set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
 set SDL2_TTF___INCLUDE_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\include\SDL2
-set SDL2_MIXER_INCLUDE_PATH=D:\Dati\SDL2\SDL2_mixer-2.6.1\x86_64-w64-mingw32\include\SDL2\
 
 @REM C++ compilation options
 set COMPILATION_OPTIONS=-Wall -Wextra -Wpedantic -Wconversion
@@ -39,7 +40,7 @@ if exist %SDL2_PROJECT_NAME%.exe (
 echo Building executable...
 echo.
 
-g++ %COMPILATION_OPTIONS% %SDL2_PROJECT_NAME%.cpp -I%SDL2_______INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF___INCLUDE_PATH% -I%SDL2_MIXER_INCLUDE_PATH% -L%SDL2_MIXER_LIB_PATH% -L%SDL2_______LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% %SDL2_LIBRARIES% -L%SDL2_TTF___LIB_PATH% -o %SDL2_PROJECT_NAME%.exe
+g++ %COMPILATION_OPTIONS% %SDL2_PROJECT_NAME%.cpp -I%SDL2_______INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF___INCLUDE_PATH% -I%ENGINE_LIB_PATH% -L%ENGINE_LIB_PATH% -L%SDL2_______LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% %SDL2_LIBRARIES% -L%SDL2_TTF___LIB_PATH% -o %SDL2_PROJECT_NAME%.exe
 
 IF %ERRORLEVEL% EQU 0 (
   echo.
@@ -37,6 +37,13 @@
  * the time in a string stream, we can get a string from it and use it to render the current time to
  * a texture. Finally we render the prompt texture and the time texture to the screen.
  *
+ * Aggiunta GS: il testo del tempo cambia a ogni frame, e TTF_RenderText_Solid lo rasterizzava sul
+ * thread principale prima di ogni disegno. Ora è un LAsyncText dell'Engine: la stringa viene
+ * rasterizzata su un worker di LJobSystem, con un font aperto per ogni thread, e la texture viene
+ * creata dal thread principale al frame successivo (gTimeRasteriser.update); nel frattempo si
+ * disegna il tempo precedente. Mentre una stringa è in lavorazione le successive non si accodano:
+ * al termine si rasterizza solo l'ultima.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022) and may not be
  * redistributed without written permission.
  **/
@@ -50,6 +57,8 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
+#include <LAsyncText.hpp>
+#include <LJobSystem.hpp>
 #include <string>
 #include <sstream>
 
@@ -81,6 +90,7 @@ static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
 
 // static const std::string FontPath("lazy.ttf");
 static const std::string FontPath("RachelBrown.ttf");
+static constexpr int      FontSize = 28;
 
 
 /***************************************************************************************************
@@ -154,8 +164,12 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 static TTF_Font *gFont = NULL; // Globally used font
 
 // Scene textures
-static LTexture gTimeTextTexture;
-static LTexture gPromptTextTexture;
+static LAsyncText gTimeText;
+static LTexture   gPromptTextTexture;
+
+// Workers rasterising the time text
+static LJobSystem      gJobs;
+static LTextRasteriser gTimeRasteriser;
 
 
 /***************************************************************************************************
@@ -431,7 +445,7 @@ static bool loadMedia(void)
   bool success = true;
 
   // Open the font
-  gFont = TTF_OpenFont( FontPath.c_str(), 28 );
+  gFont = TTF_OpenFont( FontPath.c_str(), FontSize );
 
   if( gFont == NULL )
   {
@@ -455,6 +469,17 @@ static bool loadMedia(void)
     {
       printf( "\nPrompt texture rendered" );
     }
+
+    // Open the font once per worker
+    if( !gJobs.init() || !gTimeRasteriser.open( gJobs, FontPath.c_str(), FontSize ) )
+    {
+      printf( "\nUnable to start the time text rasteriser!" );
+      success = false;
+    }
+    else
+    {
+      printf( "\nTime text rasterised on %d workers", gJobs.GetWorkerCount() );
+    }
   }
 
   return success;
@@ -464,9 +489,13 @@ static bool loadMedia(void)
 static void close(void)
 {
   // Free loaded images
-  gTimeTextTexture.free();
+  gTimeText.free();
   gPromptTextTexture.free();
 
+  // Wait for the text still being rasterised, then stop the workers
+  gTimeRasteriser.close();
+  gJobs.shutdown();
+
   // Free global font
   TTF_CloseFont( gFont );
   gFont = NULL;
@@ -554,17 +583,15 @@ int main( int argc, char* args[] )
           {;} // Unrecognised event
         }
 
+        // Upload the text rasterised since the last frame
+        gTimeRasteriser.update( gRenderer );
+
         // Set text to be rendered
         timeText.str( "" ); // Svuota lo stringstream prima di riempirlo con la nuova stringa da renderizzare
         timeText << "Milliseconds since start: " << SDL_GetTicks64() - startTime;
 
-        // Render text
-        if( !gTimeTextTexture.loadFromRenderedText( timeText.str().c_str(), textColor ) )
-        {
-          printf( "\nUnable to render time texture!" );
-        }
-        else
-        {;} // Time texture rendered
+        // Rasterised on a worker, shown from a later frame
+        gTimeText.setText( gTimeRasteriser, timeText.str(), textColor );
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
@@ -574,7 +601,7 @@ int main( int argc, char* args[] )
         int CENTERED_HORIZONTALLY = ( SCREEN_W - gPromptTextTexture.getWidth()  ) / 2;
         int CENTERED_VERTICALLY   = ( SCREEN_H - gPromptTextTexture.getHeight() ) / 2;
         gPromptTextTexture.render( CENTERED_HORIZONTALLY, 0 );
-        gTimeTextTexture.render  ( CENTERED_HORIZONTALLY, CENTERED_VERTICALLY );
+        gTimeText.render         ( gRenderer, CENTERED_HORIZONTALLY, CENTERED_VERTICALLY );
 
         // Update screen
         SDL_RenderPresent( gRenderer );
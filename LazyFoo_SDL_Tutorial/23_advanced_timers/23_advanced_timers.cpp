@@ -39,6 +39,15 @@
  *
  * After that, we render the text to a texture and then finally draw all the textures to the screen.
  *
+ * Aggiunta GS: la classe LTimer qui descritta è ora "LHighResTimer" di Engine_Lib/LTimer, con la
+ * stessa logica ma basata su "SDL_GetPerformanceCounter": "getTicks" restituisce nanosecondi su 64
+ * bit e "getSeconds" i secondi in double, senza la divisione per 1000.
+ *
+ * Aggiunta GS: il testo del tempo non passa più da uno stringstream, che a ogni frame allocava la
+ * sua stringa e la copia restituita da "str", ma è scritto con "format" nell'arena del frame di
+ * Engine_Lib/LFrameArena, svuotata da "PresentFrame" al posto di "SDL_RenderPresent". Alla chiusura
+ * il programma stampa quanti frame hanno comunque allocato dallo heap (solo senza NDEBUG).
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -47,13 +56,14 @@
 * Includes
 ****************************************************************************************************/
 
-// Using SDL, SDL_image, SDL_ttf, standard IO, strings, and string streams
+// Using SDL, SDL_image, SDL_ttf, standard IO, and strings
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include "LFrameArena.hpp"
+#include "LTimer.hpp"
 
 
 /**************************************************************************************************
@@ -105,7 +115,7 @@ class LTexture
 
   #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
+  bool loadFromRenderedText( const char*, SDL_Color );
   #endif
 
   // Deallocates texture
@@ -137,39 +147,6 @@ class LTexture
 };
 
 
-// The application time based timer
-class LTimer
-{
-  public:
-  // Initializes variables
-  LTimer(void);
-
-  // The various clock actions
-  void start(void);
-  void stop(void);
-  void pause(void);
-  void unpause(void);
-
-  // Gets the timer's time
-  Uint32 getTicks(void);
-
-  // Checks the status of the timer
-  bool isStarted(void);
-  bool isPaused(void);
-
-  private:
-  // The clock time when the timer started
-  Uint32 mStartTicks;
-
-  // The ticks stored when the timer was paused
-  Uint32 mPausedTicks;
-
-  // The timer status
-  bool mIsPaused;
-  bool mIsStarted;
-};
-
-
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
@@ -265,13 +242,13 @@ bool LTexture::loadFromFile( const std::string& path )
 
 
 #if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
+bool LTexture::loadFromRenderedText( const char* textureText, SDL_Color textColor )
 {
   // Get rid of preexisting texture
   free();
 
   // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
+  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText, textColor );
 
   if( textSurface != NULL )
   {
@@ -370,128 +347,6 @@ int LTexture::getHeight(void) const
 }
 
 
-LTimer::LTimer(void)
-{
-  // Initialize the variables
-  mStartTicks  = (Uint32)0;
-  mPausedTicks = (Uint32)0;
-
-  mIsPaused  = false;
-  mIsStarted = false;
-}
-
-
-/**
- * @brief Sets the "mIsStarted" and "mIsPaused" flags, gets the timer's start time and initializes
- * the pause time to 0. For this timer, if we want to restart it we just call start again. Since we
- * can start the timer if it is paused and/or running, we should make sure to clear out the paused
- * data.
- **/
-void LTimer::start(void)
-{
-  // Start the timer
-  mIsStarted = true;
-
-  // Unpause the timer
-  mIsPaused = false;
-
-  // Get the current clock time
-  mStartTicks  = static_cast<Uint32>(SDL_GetTicks64());
-  mPausedTicks = (Uint32)0;
-}
-
-
-void LTimer::stop(void)
-{
-  // Stop the timer
-  mIsStarted = false;
-
-  // Unpause the timer
-  mIsPaused = false;
-
-  // Clear tick variables
-  mStartTicks  = (Uint32)0;
-  mPausedTicks = (Uint32)0;
-}
-
-
-void LTimer::pause(void)
-{
-  // If the timer is running and isn't already paused
-  if( mIsStarted && !mIsPaused )
-  {
-    // Pause the timer
-    mIsPaused = true;
-
-    // Calculate the paused ticks
-    mPausedTicks = static_cast<Uint32>(SDL_GetTicks64()) - mStartTicks;
-    mStartTicks  = (Uint32)0;
-  }
-  else
-  {;}
-}
-
-
-void LTimer::unpause(void)
-{
-  // If the timer is running and paused
-  if( mIsStarted && mIsPaused )
-  {
-    // Unpause the timer
-    mIsPaused = false;
-
-    // Reset the starting ticks
-    mStartTicks = static_cast<Uint32>(SDL_GetTicks64()) - mPausedTicks;
-
-    // Reset the paused ticks
-    mPausedTicks = (Uint32)0;
-  }
-  else
-  {;}
-}
-
-
-Uint32 LTimer::getTicks(void)
-{
-  // The actual timer time
-  Uint32 time = (Uint32)0;
-
-  // If the timer is running
-  if( mIsStarted )
-  {
-    // If the timer is paused
-    if( mIsPaused )
-    {
-      // Return the number of ticks when the timer was paused
-      time = mPausedTicks;
-    }
-    else
-    {
-      // Return the current time minus the start time
-      time = static_cast<Uint32>(SDL_GetTicks64()) - mStartTicks;
-    }
-  }
-  else
-  {;}
-
-  return time;
-}
-
-
-bool LTimer::isStarted(void)
-{
-  // Timer is running and paused or unpaused
-  return mIsStarted;
-}
-
-
-bool LTimer::isPaused(void)
-{
-  // Timer is running and paused
-  return mIsPaused && mIsStarted;
-}
-
-
 /***************************************************************************************************
 * Private functions definitions
 ****************************************************************************************************/
@@ -645,6 +500,10 @@ static void close(void)
   TTF_CloseFont( gFont );
   gFont = NULL;
 
+  const LFrameArena& Frame = LFrameArena::GetFrame();
+
+  printf( "\nFrames that allocated from the heap: %" SDL_PRIu64 " of %" SDL_PRIu64, Frame.GetHeapFrames(), Frame.GetFrames() );
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -713,10 +572,7 @@ int main( int argc, char* args[] )
       SDL_Color textColor = { 0, 0, 0, 255 };
 
       // The application timer
-      LTimer timer;
-
-      // In memory text stream
-      std::stringstream timeText;
+      LHighResTimer timer;
 
       // While application is running
       while( !quit )
@@ -759,13 +615,12 @@ int main( int argc, char* args[] )
           }
         }
 
-        // Set text to be rendered
-        timeText.str( "" );
-        timeText << "Seconds since start: " << ( static_cast<double>(timer.getTicks()) / 1000.0 );
+        // Set text to be rendered, in the frame arena until PresentFrame
+        const char* timeText = LFrameArena::GetFrame().format( "Seconds since start: %g", timer.getSeconds() );
         // timeText << "Seconds since start time " << ( timer.getTicks() / 1000.f ); // Istruzione originale
 
         // Render text
-        if( !gTimeTextTexture.loadFromRenderedText( timeText.str().c_str(), textColor ) )
+        if( !gTimeTextTexture.loadFromRenderedText( timeText, textColor ) )
         {
           printf( "Unable to render time texture!\n" );
         }
@@ -781,8 +636,8 @@ int main( int argc, char* args[] )
         gPausePromptTexture.render( ( SCREEN_W - gPausePromptTexture.getWidth() ) / 2, gStartPromptTexture.getHeight()                 );
         gTimeTextTexture.render   ( ( SCREEN_W - gTimeTextTexture.getWidth() )    / 2, ( SCREEN_H - gTimeTextTexture.getHeight() ) / 2 );
 
-        // Update screen
-        SDL_RenderPresent( gRenderer );
+        // Update screen, and free the frame's text
+        PresentFrame( gRenderer );
       }
 
     } // Media loaded
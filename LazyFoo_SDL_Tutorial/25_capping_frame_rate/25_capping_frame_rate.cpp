@@ -26,17 +26,36 @@
  * as opposed to the exact 16 2/3ms. This solution is more of a stop gap in case you have to deal
  * with hardware that does not support VSync.
  *
+ * Aggiunta GS: il limite è ora "LFramePacer" di Engine_Lib/LFramePacer, che misura il tempo con
+ * "SDL_GetPerformanceCounter" invece che in millisecondi interi. "SDL_Delay" da solo si sveglia in
+ * ritardo di quanto vuole lo scheduler, e i frame escono irregolari; il pacer dorme solo fino a un
+ * margine dalla scadenza, misurato sui ritardi dei "SDL_Delay" precedenti, e attende il resto
+ * controllando il contatore ad alta risoluzione. Le scadenze sono a intervalli fissi, alla
+ * frequenza di aggiornamento del display su cui si trova la finestra (SCREEN_FPS se il display non
+ * la riporta); i frame che finiscono oltre la loro scadenza sono contati e mostrati come "missed".
+ *
+ * Aggiunta GS: come in 24, la media su tutta l'esecuzione è sostituita da "LFrameStats", con minimo,
+ * media, massimo e 99° percentile dei tempi degli ultimi 240 frame, presi dal pacer; il testo è
+ * ridisegnato quattro volte al secondo, e il tasto H salva l'istogramma in "frame_times.csv".
+ *
+ * Aggiunta GS: le righe delle statistiche non passano più da stringstream, che allocavano a ogni
+ * aggiornamento, ma sono scritte con "format" nell'arena del frame di Engine_Lib/LFrameArena,
+ * svuotata da "PresentFrame" al posto di "SDL_RenderPresent". Alla chiusura il programma stampa
+ * quanti frame hanno comunque allocato dallo heap (solo senza NDEBUG).
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
 
-// Using SDL, SDL_image, SDL_ttf, standard IO, strings, and string streams
+// Using SDL, SDL_image, SDL_ttf, standard IO, and strings
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <string>
-#include <sstream>
+#include "LFrameArena.hpp"
+#include "LFramePacer.hpp"
+#include "LFrameStats.hpp"
 
 
 /**************************************************************************************************
@@ -44,10 +63,12 @@
 ***************************************************************************************************/
 
 static constexpr int INIT_FIRST_ONE_AVAILABLE = -1;
-static constexpr int MS_IN_A_S = 1000;
+static constexpr int SCREEN_FPS = 60; // When the display does not report its refresh rate
 
-static constexpr int SCREEN_FPS 	= 60;
-static constexpr int MS_PER_FRAME = MS_IN_A_S / SCREEN_FPS;
+static constexpr int    STATS_LINES     = 3;      // Lines of frame statistics on screen
+static constexpr double MS_IN_A_S       = 1000.0;
+static constexpr double HISTOGRAM_BIN_S = 0.0005; // Frame time histogram bins, half a millisecond
+static const std::string HistogramPath( "frame_times.csv" );
 
 static constexpr int SCREEN_W = 640; // Screen's width
 static constexpr int SCREEN_H = 480; // Screen's heigth
@@ -92,7 +113,7 @@ class LTexture
 
 #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
+  bool loadFromRenderedText( const char*, SDL_Color );
 #endif
 
     // Deallocates texture
@@ -124,41 +145,6 @@ class LTexture
 };
 
 
-// The application time based timer
-class LTimer
-{
-  public:
-
-  // Initializes variables
-  LTimer(void);
-
-  // The various clock actions
-  void start(void);
-  void stop(void);
-  void pause(void);
-  void unpause(void);
-
-  // Gets the timer's time
-  Uint32 getTicks(void) const;
-
-  // Checks the status of the timer
-  bool isStarted(void) const;
-  bool isPaused(void)  const;
-
-  private:
-
-  // The clock time when the timer started
-  Uint32 mStartTicks;
-
-  // The ticks stored when the timer was paused
-  Uint32 mPausedTicks;
-
-  // The timer status
-  bool mIsPaused;
-  bool mIsStarted;
-};
-
-
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
@@ -167,6 +153,7 @@ static bool init(void);
 static bool loadMedia(void);
 static void close(void);
 static void PressEnter(void);
+static void renderStatsText( const LFrameStats&, Uint64, SDL_Color );
 
 
 /***************************************************************************************************
@@ -179,7 +166,7 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 static TTF_Font* gFont = NULL; // Globally used font
 
 // Scene textures
-static LTexture gFPSTextTexture;
+static LTexture gStatsTextTextures[STATS_LINES];
 
 
 /***************************************************************************************************
@@ -252,13 +239,13 @@ bool LTexture::loadFromFile( const std::string& path )
 
 
 #if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
+bool LTexture::loadFromRenderedText( const char* textureText, SDL_Color textColor )
 {
   // Get rid of preexisting texture
   free();
 
   // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
+  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText, textColor );
 
   if( textSurface != NULL )
   {
@@ -357,143 +344,6 @@ int LTexture::getHeight(void) const
 }
 
 
-LTimer::LTimer(void)
-{
-    // Initialize the variables
-  mStartTicks  = (Uint32)0;
-  mPausedTicks = (Uint32)0;
-
-  mIsPaused  = false;
-  mIsStarted = false;
-}
-
-
-/**
- * @brief Starts the timer. Sets "mIsStarted" to true and "mIsPaused" to false. Initialises
- * the pause time to 0.
- **/
-void LTimer::start(void)
-{
-  // Start the timer
-  mIsStarted = true;
-
-  // Unpause the timer
-  mIsPaused = false;
-
-  // Get the current clock time
-  mStartTicks  = static_cast<Uint32>(SDL_GetTicks64());
-  mPausedTicks = (Uint32)0;
-}
-
-
-/**
- * @brief Stops the timer. Sets "mIsStarted" and "mIsPaused" to false. Initialises the start and
- * pause times to 0.
- **/
-void LTimer::stop(void)
-{
-  // Stop the timer
-  mIsStarted = false;
-
-  // Unpause the timer
-  mIsPaused = false;
-
-  // Clear tick variables
-  mStartTicks  = (Uint32)0;
-  mPausedTicks = (Uint32)0;
-}
-
-
-/**
- * @brief Pauses the timer, but only if it is currently running. Sets "mIsPaused" to true.
- * Initialises the start time to 0.
- **/
-void LTimer::pause(void)
-{
-  // If the timer is running and isn't already paused
-  if( mIsStarted && !mIsPaused )
-  {
-    // Pause the timer
-    mIsPaused = true;
-
-    // Calculate the paused ticks
-    mPausedTicks = static_cast<Uint32>(SDL_GetTicks64()) - mStartTicks;
-    mStartTicks  = (Uint32)0;
-  }
-  else
-  {;}
-}
-
-
-/**
- * @brief Unpauses the timer, but only if it is currently paused. Sets "mIsPaused" to false.
- * Initialises the pause time to 0.
- **/
-void LTimer::unpause(void)
-{
-    // If the timer is running and paused
-  if( mIsStarted && mIsPaused )
-  {
-    // Unpause the timer
-    mIsPaused = false;
-
-    // Reset the starting ticks
-    mStartTicks = static_cast<Uint32>(SDL_GetTicks64()) - mPausedTicks;
-
-    // Reset the paused ticks
-    mPausedTicks = (Uint32)0;
-  }
-  else
-  {;}
-}
-
-
-/**
- * @brief Returns time in milliseconds since start
- * 
- * @return Uint32 time in milliseconds since start
- **/
-Uint32 LTimer::getTicks(void) const
-{
-  // The actual timer time
-  Uint32 time = (Uint32)0;
-
-  // If the timer is running
-  if( mIsStarted )
-  {
-    // If the timer is paused
-    if( mIsPaused )
-    {
-      // Return the number of ticks when the timer was paused
-      time = mPausedTicks;
-    }
-    else
-    {
-      // Return the current time minus the start time
-      time = static_cast<Uint32>(SDL_GetTicks64()) - mStartTicks;
-    }
-  }
-  else
-  {;}
-
-  return time;
-}
-
-
-bool LTimer::isStarted(void) const
-{
-  // Timer is running and paused or unpaused
-  return mIsStarted;
-}
-
-
-bool LTimer::isPaused(void) const
-{
-  // Timer is running and paused
-  return mIsPaused && mIsStarted;
-}
-
-
 /***************************************************************************************************
 * Private functions definitions
 ****************************************************************************************************/
@@ -614,12 +464,19 @@ static bool loadMedia(void)
 static void close(void)
 {
   // Free loaded images
-  gFPSTextTexture.free();
+  for( LTexture& statsTexture : gStatsTextTextures )
+  {
+    statsTexture.free();
+  }
 
   // Free global font
   TTF_CloseFont( gFont );
   gFont = NULL;
 
+  const LFrameArena& Frame = LFrameArena::GetFrame();
+
+  printf( "\nFrames that allocated from the heap: %" SDL_PRIu64 " of %" SDL_PRIu64, Frame.GetHeapFrames(), Frame.GetFrames() );
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -644,6 +501,35 @@ static void PressEnter(void)
 }
 
 
+/**
+ * @brief Renders the statistics of the last frames into the HUD textures, one line each
+ *
+ * @param stats Frame times of the last frames
+ * @param missedFrames Frames that ended after their deadline
+ * @param textColor Colour of the text
+ **/
+static void renderStatsText( const LFrameStats& stats, Uint64 missedFrames, SDL_Color textColor )
+{
+  // In the frame arena, until PresentFrame
+  LFrameArena& frame = LFrameArena::GetFrame();
+  const char*  statsText[STATS_LINES];
+
+  statsText[0] = frame.format( "Frames Per Second (With Cap) %.1f, missed %" SDL_PRIu64, stats.GetAverageFPS(), missedFrames );
+  statsText[1] = frame.format( "avg %.2f ms, p99 %.2f ms", stats.GetAverage() * MS_IN_A_S, stats.GetPercentile( 0.99 ) * MS_IN_A_S );
+  statsText[2] = frame.format( "min %.2f ms, max %.2f ms", stats.GetMin() * MS_IN_A_S, stats.GetMax() * MS_IN_A_S );
+
+  for( int i = 0; i != STATS_LINES; ++i )
+  {
+    if( !gStatsTextTextures[i].loadFromRenderedText( statsText[i], textColor ) )
+    {
+      printf( "Unable to render FPS texture!\n" );
+    }
+    else
+    {;}
+  }
+}
+
+
 /***************************************************************************************************
 * Main function
 ****************************************************************************************************/
@@ -687,25 +573,20 @@ int main( int argc, char* args[] )
       // Set text color as black
       SDL_Color textColor = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 
-      // The frames per second timer
-      LTimer FPSTimer;
-
-      // The frames per second cap timer
-      LTimer capTimer;
+      // The frames per second cap, at the refresh rate of the display
+      LFramePacer framePacer;
+      framePacer.setTargetRate( SCREEN_FPS );
+      framePacer.matchDisplay( gWindow );
 
-      // In memory text stream
-      std::stringstream timeText;
+      // Times of the last frames
+      LFrameStats frameStats;
 
-      // Start counting frames per second
-      int countedFrames = 0;
-      FPSTimer.start();
+      renderStatsText( frameStats, framePacer.GetMissedFrames(), textColor );
+      framePacer.start();
 
       // While application is running
       while( !quit )
       {
-        // Start cap timer
-        capTimer.start();
-
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
         {
@@ -714,50 +595,49 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          // Save the histogram of the last frame times
+          else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_h )
+          {
+            if( frameStats.saveHistogram( HistogramPath, HISTOGRAM_BIN_S ) )
+            {
+              printf( "\nFrame time histogram saved to %s", HistogramPath.c_str() );
+            }
+            else
+            {;}
+          }
+          // Pace to the new display when the window moves to another one
+          else if( e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_DISPLAY_CHANGED )
+          {
+            framePacer.matchDisplay( gWindow );
+          }
           else
           {;}
         }
 
-        // Calculate and correct FPS
-        double avgFPS = countedFrames / ( static_cast<double>(FPSTimer.getTicks()) / 1000.0 );
-
-        if( avgFPS > 2'000'000 )
-        {
-          avgFPS = 0.0;
-        }
-        else
-        {;}
+        // Clear screen
+        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+        SDL_RenderClear( gRenderer );
 
-        // Set text to be rendered
-        timeText.str( "" );
-        timeText << "Average Frames Per Second (With Cap) " << avgFPS;
+        // Render textures, one line of statistics under the other
+        const int statsY = ( SCREEN_H - STATS_LINES * gStatsTextTextures[0].getHeight() ) / 2;
 
-        // Render text
-        if( !gFPSTextTexture.loadFromRenderedText( timeText.str().c_str(), textColor ) )
+        for( int i = 0; i != STATS_LINES; ++i )
         {
-          printf( "Unable to render FPS texture!\n" );
+          gStatsTextTextures[i].render( ( SCREEN_W - gStatsTextTextures[i].getWidth() ) / 2, statsY + i * gStatsTextTextures[0].getHeight() );
         }
-        else
-        {;}
-
-        // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
-        SDL_RenderClear( gRenderer );
 
-        // Render textures
-        gFPSTextTexture.render( ( SCREEN_W - gFPSTextTexture.getWidth() ) / 2, ( SCREEN_H - gFPSTextTexture.getHeight() ) / 2 );
+        // Update screen, and free the frame's temporaries
+        PresentFrame( gRenderer );
 
-        // Update screen
-        SDL_RenderPresent( gRenderer );
-        ++countedFrames;
+        // Wait until the end of the frame, if it finished early
+        framePacer.wait();
 
-        int frameTicks_ms = capTimer.getTicks();
+        // Time this frame, waiting included, and refresh the text a few times per second
+        frameStats.addFrame( framePacer.GetFrameTime() );
 
-        // If frame finished early
-        if( frameTicks_ms < MS_PER_FRAME )
+        if( frameStats.isReportDue() )
         {
-          // Wait remaining time
-          SDL_Delay( MS_PER_FRAME - frameTicks_ms );
+          renderStatsText( frameStats, framePacer.GetMissedFrames(), textColor );
         }
         else
         {;}
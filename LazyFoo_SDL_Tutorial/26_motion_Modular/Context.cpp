@@ -0,0 +1,155 @@
+/**
+ * @file Context.cpp
+ * 
+ * @brief Context class implementation
+ * 
+ * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
+ * and may not be redistributed without written permission.
+ **/
+
+#include <stdio.h>
+#include "Context.h"
+
+
+Context::Context(void)
+  : m_Window(NULL), m_Surface(NULL), m_Renderer(NULL), m_DotTexture(), m_Width(0), m_Height(0)
+{ /* Initialise all non-static private members */ }
+
+
+Context::~Context(void)
+{
+  close();
+}
+
+
+bool Context::createWindow( const char* Title, int Width, int Height )
+{
+  close();
+
+  //Create window
+  m_Window = SDL_CreateWindow( Title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, Width, Height, SDL_WINDOW_SHOWN );
+  if( m_Window == NULL )
+  {
+    printf( "Window could not be created! SDL Error: %s\n", SDL_GetError() );
+    return false;
+  }
+
+  //Create vsynced renderer for window
+  m_Renderer = SDL_CreateRenderer( m_Window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+  if( m_Renderer == NULL )
+  {
+    printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
+    close();
+    return false;
+  }
+
+  m_Width  = Width;
+  m_Height = Height;
+
+  //Initialize renderer color
+  SDL_SetRenderDrawColor( m_Renderer, 0xFF, 0xFF, 0xFF, 0xFF );
+
+  return true;
+}
+
+
+bool Context::createOffscreen( int Width, int Height )
+{
+  close();
+
+  //Create the surface drawn on
+  m_Surface = SDL_CreateRGBSurfaceWithFormat( 0, Width, Height, 32, SDL_PIXELFORMAT_ARGB8888 );
+  if( m_Surface == NULL )
+  {
+    printf( "Surface could not be created! SDL Error: %s\n", SDL_GetError() );
+    return false;
+  }
+
+  //Create software renderer for the surface
+  m_Renderer = SDL_CreateSoftwareRenderer( m_Surface );
+  if( m_Renderer == NULL )
+  {
+    printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
+    close();
+    return false;
+  }
+
+  m_Width  = Width;
+  m_Height = Height;
+
+  //Initialize renderer color
+  SDL_SetRenderDrawColor( m_Renderer, 0xFF, 0xFF, 0xFF, 0xFF );
+
+  return true;
+}
+
+
+bool Context::loadMedia(void)
+{
+  //Load dot texture, for this context's renderer
+  if( !m_DotTexture.loadFromFile( "dot.bmp", m_Renderer ) )
+  {
+    printf( "Failed to load dot texture!\n" );
+    return false;
+  }
+
+  return true;
+}
+
+
+void Context::close(void)
+{
+  //Free loaded images, before their renderer
+  m_DotTexture.free();
+
+  if( m_Renderer != NULL )
+  {
+    SDL_DestroyRenderer( m_Renderer );
+    m_Renderer = NULL;
+  }
+
+  if( m_Window != NULL )
+  {
+    SDL_DestroyWindow( m_Window );
+    m_Window = NULL;
+  }
+
+  if( m_Surface != NULL )
+  {
+    SDL_FreeSurface( m_Surface );
+    m_Surface = NULL;
+  }
+
+  m_Width  = 0;
+  m_Height = 0;
+}
+
+
+SDL_Renderer* Context::GetRenderer(void) const
+{
+  return m_Renderer;
+}
+
+
+SDL_Surface* Context::GetSurface(void) const
+{
+  return m_Surface;
+}
+
+
+const LTexture& Context::GetDotTexture(void) const
+{
+  return m_DotTexture;
+}
+
+
+int Context::GetWidth(void) const
+{
+  return m_Width;
+}
+
+
+int Context::GetHeight(void) const
+{
+  return m_Height;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file Context.h
+ * 
+ * @brief What the program draws with: a window and its renderer, or an offscreen surface and a
+ * software renderer, and the textures loaded for that renderer.
+ * 
+ * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
+ * and may not be redistributed without written permission.
+ **/
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <SDL.h>
+#include "LTexture.hpp" // From Engine_Lib
+
+/**
+ * @brief Owns a render target, its renderer and the textures of the scene, in place of the global
+ * window, renderer and textures. Nothing is shared between two contexts: each can be used by its
+ * own thread, e.g. several offscreen contexts rendering at once. A renderer must only be used by
+ * the thread that created it, so a context is created, used and closed by the same thread; a
+ * window context by the main thread.
+ *
+ * SDL and SDL_image are started once per process, before the first context (see Util.h).
+ **/
+class Context
+{
+public:
+
+  Context(void);
+  ~Context(void);
+
+  Context( const Context& ) = delete;
+  Context& operator=( const Context& ) = delete;
+
+  // Creates a window and a vsynced renderer for it
+  bool createWindow( const char* Title, int Width, int Height );
+
+  // Creates a surface in memory and a software renderer drawing on it, no window needed
+  bool createOffscreen( int Width, int Height );
+
+  // Loads the textures of the scene for the renderer
+  bool loadMedia(void);
+
+  // Frees the textures, the renderer and the window or surface
+  void close(void);
+
+  SDL_Renderer*   GetRenderer  (void) const;
+  SDL_Surface*    GetSurface   (void) const; // Offscreen contexts only
+  const LTexture& GetDotTexture(void) const;
+  int             GetWidth     (void) const;
+  int             GetHeight    (void) const;
+
+private:
+
+  SDL_Window*   m_Window;     // NULL offscreen
+  SDL_Surface*  m_Surface;    // NULL with a window
+  SDL_Renderer* m_Renderer;
+  LTexture      m_DotTexture;
+  int           m_Width;
+  int           m_Height;
+};
+
+#endif
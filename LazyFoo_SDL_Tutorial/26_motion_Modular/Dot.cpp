@@ -8,8 +8,7 @@
  **/
 
 #include "Dot.h"
-#include "Globals.h"
-#include "Constants.h"
+#include "Context.h"
 
 
 Dot::Dot(void)
@@ -53,13 +52,13 @@ void Dot::handleEvent( SDL_Event& e )
 }
 
 
-void Dot::move(void)
+void Dot::move( const Context& ctx )
 {
   // Move the dot left or right
   mPosX += mVelX;
 
   // If the dot went too far to the left or right
-  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > SCREEN_WIDTH ) )
+  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > ctx.GetWidth() ) )
   {
     // Move back
     mPosX -= mVelX;
@@ -69,7 +68,7 @@ void Dot::move(void)
   mPosY += mVelY;
 
   // If the dot went too far up or down
-  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > SCREEN_HEIGHT ) )
+  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > ctx.GetHeight() ) )
   {
     // Move back
     mPosY -= mVelY;
@@ -77,8 +76,8 @@ void Dot::move(void)
 }
 
 
-void Dot::render(void)
+void Dot::render( const Context& ctx ) const
 {
   // Show the dot
-  gDotTexture.render( mPosX, mPosY );
+  ctx.GetDotTexture().render( mPosX, mPosY );
 }
\ No newline at end of file
@@ -6,6 +6,8 @@ and may not be redistributed without written permission.*/
 
 #include <SDL.h>
 
+class Context;
+
 // The dot that will move around on the screen
 class Dot
 {
@@ -23,11 +25,11 @@ public:
 	// Takes key presses and adjusts the dot's velocity
 	void handleEvent( SDL_Event& e );
 
-	// Moves the dot
-	void move(void);
+	// Moves the dot, within the area of the context
+	void move( const Context& ctx );
 
-	// Shows the dot on the screen
-	void render(void);
+	// Shows the dot with the context's renderer
+	void render( const Context& ctx ) const;
 
 private:
 	// The X and Y offsets of the dot
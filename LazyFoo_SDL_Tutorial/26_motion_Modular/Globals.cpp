@@ -1,21 +0,0 @@
-/**
- * @file Globals.cpp
- * 
- * @brief 
- * 
- * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
- * and may not be redistributed without written permission.
- **/
-
-#include "Globals.h"
-#include "LTexture.h"
-
-//The window we'll be rendering to
-SDL_Window* gWindow = NULL;
-
-//The window renderer
-SDL_Renderer* gRenderer = NULL;
-
-//Scene textures
-LTexture gDotTexture;
-
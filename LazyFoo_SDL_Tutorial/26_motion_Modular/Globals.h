@@ -1,25 +0,0 @@
-/**
- * @file Globals.h
- * 
- * @brief 
- * 
- * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
- * and may not be redistributed without written permission.
- **/
-
-#ifndef GLOBALS_H
-#define GLOBALS_H
-
-#include "LTexture.h"
-
-//The window we'll be rendering to
-extern SDL_Window* gWindow;
-
-//The window renderer
-extern SDL_Renderer* gRenderer;
-
-//Scene textures
-extern LTexture gDotTexture;
-
-#endif 
-
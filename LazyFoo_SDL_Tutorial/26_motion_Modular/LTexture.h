@@ -1,66 +0,0 @@
-/**
- * @file LTexture
- * 
- * @brief 
- * 
- * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
- * and may not be redistributed without written permission.
- **/
-
-#ifndef LTEXTURE_H
-#define LTEXTURE_H
-
-//Using SDL, SDL_image, standard IO, and strings
-#include <SDL.h>
-#include <SDL_image.h>
-#include <stdio.h>
-#include <string>
-
-//Texture wrapper class
-class LTexture
-{
-public:
-	//Initializes variables
-	LTexture();
-
-	//Deallocates memory
-	~LTexture();
-
-	//Loads image at specified path
-	bool loadFromFile( std::string path );
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-	//Creates image from font string
-	bool loadFromRenderedText( std::string textureText, SDL_Color textColor );
-#endif
-
-	//Deallocates texture
-	void free();
-
-	//Set color modulation
-	void setColor( Uint8 red, Uint8 green, Uint8 blue );
-
-	//Set blending
-	void setBlendMode( SDL_BlendMode blending );
-
-	//Set alpha modulation
-	void setAlpha( Uint8 alpha );
-
-	//Renders texture at given point
-	void render( int x, int y, SDL_Rect* clip = NULL, double angle = 0.0, SDL_Point* center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE );
-
-	//Gets image dimensions
-	int getWidth();
-	int getHeight();
-
-private:
-	//The actual hardware texture
-	SDL_Texture* mTexture;
-
-	//Image dimensions
-	int mWidth;
-	int mHeight;
-};
-
-#endif 
-
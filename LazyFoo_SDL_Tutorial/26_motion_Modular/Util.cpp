@@ -7,9 +7,9 @@
  * and may not be redistributed without written permission.
  **/
 
+#include <SDL_image.h>
+#include <stdio.h>
 #include "Util.h"
-#include "Globals.h"
-#include "Constants.h"
 
 bool init(void)
 {
@@ -30,52 +30,13 @@ bool init(void)
       printf( "Warning: Linear texture filtering not enabled!" );
     }
 
-    //Create window
-    gWindow = SDL_CreateWindow( "SDL Tutorial", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN );
-    if( gWindow == NULL )
+    //Initialize PNG loading
+    int imgFlags = IMG_INIT_PNG;
+    if( !( IMG_Init( imgFlags ) & imgFlags ) )
     {
-      printf( "Window could not be created! SDL Error: %s\n", SDL_GetError() );
+      printf( "SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError() );
       success = false;
     }
-    else
-    {
-      //Create vsynced renderer for window
-      gRenderer = SDL_CreateRenderer( gWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
-      if( gRenderer == NULL )
-      {
-        printf( "Renderer could not be created! SDL Error: %s\n", SDL_GetError() );
-        success = false;
-      }
-      else
-      {
-        //Initialize renderer color
-        SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-
-        //Initialize PNG loading
-        int imgFlags = IMG_INIT_PNG;
-        if( !( IMG_Init( imgFlags ) & imgFlags ) )
-        {
-          printf( "SDL_image could not initialize! SDL_image Error: %s\n", IMG_GetError() );
-          success = false;
-        }
-      }
-    }
-  }
-
-  return success;
-}
-
-
-bool loadMedia(void)
-{
-  //Loading success flag
-  bool success = true;
-
-  //Load dot texture
-  if( !gDotTexture.loadFromFile( "dot.bmp" ) )
-  {
-    printf( "Failed to load dot texture!\n" );
-    success = false;
   }
 
   return success;
@@ -84,15 +45,6 @@ bool loadMedia(void)
 
 void close(void)
 {
-  //Free loaded images
-  gDotTexture.free();
-
-  //Destroy window
-  SDL_DestroyRenderer( gRenderer );
-  SDL_DestroyWindow( gWindow );
-  gWindow = NULL;
-  gRenderer = NULL;
-
   //Quit SDL subsystems
   IMG_Quit();
   SDL_Quit();
@@ -10,13 +10,10 @@
 #ifndef UTIL_H
 #define UTIL_H
 
-//Starts up SDL and creates window
+//Starts up SDL and SDL_image, once for all the contexts
 bool init(void);
 
-//Loads media
-bool loadMedia(void);
-
-//Frees media and shuts down SDL
+//Shuts down SDL, after the last context is closed
 void close(void);
 
 void PressEnter(void);
@@ -5,37 +5,151 @@
  * 
  * Come l'esempio 26, ma suddiviso in sorgenti multipli.
  * 
+ * Aggiunta GS: finestra, renderer e texture non sono più variabili globali (l'ex "Globals.h") ma
+ * appartengono a un "Context", passato esplicitamente a chi disegna o muove il punto. Più contesti
+ * possono esistere insieme, ciascuno sul proprio thread: con "--offscreen=<N>" il programma non apre
+ * alcuna finestra e fa disegnare N contesti fuori schermo (superficie in memoria e renderer
+ * software) da N thread in parallelo, salvando l'ultimo frame di ciascuno in "Offscreen_<i>.bmp".
+ * 
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
 #include "Util.h"
 #include "Dot.h"
-#include "Globals.h"
+#include "Context.h"
+#include "Constants.h"
+
+// Offscreen runs: frames drawn by each context
+constexpr int OFFSCREEN_FRAMES = 60;
+
+// What an offscreen thread is given, and what it reports
+struct OffscreenRun
+{
+  int  Index;
+  bool HasSucceeded;
+};
+
+
+/**
+ * @brief Body of an offscreen thread: creates its own context, moves and draws the dot for
+ * OFFSCREEN_FRAMES frames, and saves the last one. The dot of each thread goes its own way.
+ **/
+static int renderOffscreen( void* data )
+{
+  OffscreenRun* run = static_cast<OffscreenRun*>( data );
+
+  static const SDL_Keycode Directions[] = { SDLK_RIGHT, SDLK_DOWN, SDLK_LEFT, SDLK_UP };
+
+  Context ctx;
+  run->HasSucceeded = ctx.createOffscreen( SCREEN_WIDTH, SCREEN_HEIGHT ) && ctx.loadMedia();
+
+  if( !run->HasSucceeded )
+  {
+    return 1;
+  }
+
+  Dot dot;
+
+  SDL_Event e;
+  memset( &e, 0, sizeof(e) );
+  e.type = SDL_KEYDOWN;
+  e.key.keysym.sym = Directions[run->Index % 4];
+  dot.handleEvent( e );
+
+  for( int frame = 0; frame != OFFSCREEN_FRAMES; ++frame )
+  {
+    dot.move( ctx );
+
+    SDL_SetRenderDrawColor( ctx.GetRenderer(), 0xFF, 0xFF, 0xFF, 0xFF );
+    SDL_RenderClear( ctx.GetRenderer() );
+
+    dot.render( ctx );
+
+    SDL_RenderPresent( ctx.GetRenderer() );
+  }
+
+  char path[32];
+  snprintf( path, sizeof(path), "Offscreen_%d.bmp", run->Index );
+
+  if( SDL_SaveBMP( ctx.GetSurface(), path ) != 0 )
+  {
+    printf( "Unable to save %s! SDL Error: %s\n", path, SDL_GetError() );
+    run->HasSucceeded = false;
+  }
+
+  return 0;
+}
+
 
 int main( int argc, char* args[] )
 {
   bool HasProgramSucceeded = true;
 
+  // "--offscreen=<N>" renders N contexts without window, one thread each
+  int NumOfOffscreen = 0;
+
   printf("\n*** Debugging console ***\n");
   printf("\nProgram started with %d additional arguments.", argc - 1); //  Il primo argomento è il nome dell'eseguibile
 
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    if ( strncmp( args[i], "--offscreen=", strlen("--offscreen=") ) == 0 )
+    {
+      NumOfOffscreen = atoi( args[i] + strlen("--offscreen=") );
+    }
   }
 
-  // Start up SDL and create window
+  // Start up SDL
   if( !init() )
   {
     printf( "Failed to initialize!\n" );
+    HasProgramSucceeded = false;
+  }
+  else if( NumOfOffscreen > 0 )
+  {
+    std::vector<OffscreenRun> runs( static_cast<size_t>( NumOfOffscreen ) );
+    std::vector<SDL_Thread*>  threads( runs.size(), NULL );
+
+    for( size_t i = 0; i != runs.size(); ++i )
+    {
+      runs[i].Index        = static_cast<int>( i );
+      runs[i].HasSucceeded = false;
+      threads[i]           = SDL_CreateThread( renderOffscreen, "Offscreen", &runs[i] );
+
+      if( threads[i] == NULL )
+      {
+        printf( "Unable to create thread %zu! SDL Error: %s\n", i, SDL_GetError() );
+      }
+    }
+
+    for( size_t i = 0; i != runs.size(); ++i )
+    {
+      if( threads[i] != NULL )
+      {
+        SDL_WaitThread( threads[i], NULL );
+      }
+
+      HasProgramSucceeded = HasProgramSucceeded && runs[i].HasSucceeded;
+    }
+
+    printf( "\n%d offscreen contexts rendered %d frames each\n", NumOfOffscreen, OFFSCREEN_FRAMES );
   }
   else
   {
-    // Load media
-    if( !loadMedia() )
+    // The window, its renderer and the textures
+    Context ctx;
+
+    // Create window and load media
+    if( !ctx.createWindow( "SDL Tutorial", SCREEN_WIDTH, SCREEN_HEIGHT ) || !ctx.loadMedia() )
     {
-      printf( "Failed to load media!\n" );
+      printf( "Failed to create the window or load media!\n" );
     }
     else
     {
@@ -65,22 +179,25 @@ int main( int argc, char* args[] )
         }
 
         // Move the dot
-        dot.move();
+        dot.move( ctx );
 
         // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, 0xFF, 0xFF, 0xFF, 0xFF );
-        SDL_RenderClear( gRenderer );
+        SDL_SetRenderDrawColor( ctx.GetRenderer(), 0xFF, 0xFF, 0xFF, 0xFF );
+        SDL_RenderClear( ctx.GetRenderer() );
 
         // Render objects
-        dot.render();
+        dot.render( ctx );
 
         // Update screen
-        SDL_RenderPresent( gRenderer );
+        SDL_RenderPresent( ctx.GetRenderer() );
       }
     }
+
+    // Free the textures, the renderer and the window, before SDL is shut down
+    ctx.close();
   }
 
-  // Free resources and close SDL
+  // Shut down SDL
   close();
 
   // Integrity check
@@ -93,7 +210,10 @@ int main( int argc, char* args[] )
     printf("\nThere was a problem during the execution of the program!\n");
   }
 
-  PressEnter();
+  if ( NumOfOffscreen <= 0 )
+  {
+    PressEnter();
+  }
 
   return 0;
-}
\ No newline at end of file
+}
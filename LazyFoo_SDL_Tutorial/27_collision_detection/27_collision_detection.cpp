@@ -79,6 +79,23 @@
  * along each of the polygon's axis to see if there is any separation. This all involves vector math
  * and this as mentioned before is beyond the scope of this tutorial set.
  *
+ * Aggiunta GS: il test degli assi separatori è ora in "CheckCollision" di Engine_Lib/LCollision,
+ * condiviso con 28, 29 e State_Machines insieme ai test per cerchi e insiemi di box e a una broad
+ * phase "sweep-and-prune" (LBroadPhase) che restituisce le coppie in collisione di un'intera scena.
+ *
+ * Aggiunta GS: il dot non torna più indietro quando urta: "SweepCollision" trova in quale frazione
+ * del passo il box incontra il muro, e il dot avanza fino al contatto. Un dot veloce non può così
+ * attraversare un muro più sottile del suo passo, senza suddividere il movimento in sotto-passi.
+ * Anche i bordi dello schermo fermano il dot a contatto, con un "clamp".
+ *
+ * Aggiunta GS: F3 mostra i box di collisione del dot e del muro, disegnati da LDebugDraw sopra il
+ * frame. Nelle build con NDEBUG le sue chiamate sono funzioni vuote e il compilatore le elimina.
+ *
+ * Aggiunta GS: al posto di un solo muro c'è un livello, una mappa di tile i cui tile solidi sono
+ * uniti in pochi box e messi in un LStaticTree al caricamento. A ogni passo il dot chiede all'albero
+ * solo i muri che l'area spazzata tocca, visitando O(log n) nodi anche con migliaia di muri, e si
+ * ferma contro il primo che incontra. Con F3 si vedono anche i box dei nodi dell'albero.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -88,6 +105,9 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
+#include "LCollision.hpp"
+#include "LDebugDraw.hpp"
 
 /**************************************************************************************************
 * Private constants
@@ -116,11 +136,30 @@ static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
 static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
 static constexpr int CYAN_A = 0xFF; // Alpha component
 
-// Muro
-static constexpr int WALL_x = 300;
-static constexpr int WALL_y = 40;
-static constexpr int WALL_w = 40;
-static constexpr int WALL_h = 400;
+// Livello: '#' è un tile solido
+static constexpr int TILE_SIZE     = 40;
+static constexpr int LEVEL_COLUMNS = SCREEN_W / TILE_SIZE;
+
+static const char* const LEVEL_MAP[] =
+{
+  "................",
+  ".......#........",
+  ".......#...###..",
+  "..##...#........",
+  "..##...#........",
+  ".......#....#...",
+  ".......#....#...",
+  "...#...#....#...",
+  "...#...#........",
+  "...#...#..####..",
+  ".......#........",
+  "................",
+};
+
+// Overlay di debug (F3): i box di collisione
+static constexpr SDL_Color DotColliderColour { 0x00, 0xC0, 0x00, 0xFF };
+static constexpr SDL_Color WallColliderColour{ 0xFF, 0x00, 0x00, 0x60 };
+static constexpr SDL_Color NodeColour        { 0x00, 0x00, 0xFF, 0x80 };
 
 static const std::string FilePath("dot.bmp");
 
@@ -188,7 +227,7 @@ class Dot
   void handleEvent( SDL_Event& );
 
   // Moves the dot and checks collision
-  void move( SDL_Rect& Wall );
+  void move( const LStaticTree& Level );
 
   // Shows the dot on the screen
   void render(void);
@@ -210,6 +249,12 @@ class Dot
 
   // Dot's collision box
   SDL_Rect mCollider;
+
+  // Walls near the dot, found by the last sweep
+  std::vector<int> mNear;
+
+  // First wall met moving by a velocity
+  LSweepHit sweep( int VelX, int VelY, const LStaticTree& Level );
 };
 
 
@@ -221,7 +266,7 @@ static bool init(void);
 static bool loadMedia(void);
 static void close(void);
 static void PressEnter(void);
-static bool checkCollision( SDL_Rect a, SDL_Rect b ); // Box collision detector
+static void loadLevel( LStaticTree& Level );
 
 
 /***************************************************************************************************
@@ -459,33 +504,37 @@ void Dot::handleEvent( SDL_Event& e )
   {;}
 }
 
-void Dot::move( SDL_Rect& Wall )
+void Dot::move( const LStaticTree& Level )
 {
-  // Move the dot left or right
-  mPosX      += mVelX;
+  // Move the dot left or right, up to the wall if it is in the way
+  mPosX      += sweep( mVelX, 0, Level ).Travel( mVelX );
+  mPosX       = SDL_clamp( mPosX, 0, SCREEN_W - DOT_WIDTH );
   mCollider.x = mPosX;
 
-  // If the dot collided or went too far to the left or right
-  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > SCREEN_W ) || checkCollision( mCollider, Wall ) )
-  {
-    // Move back
-    mPosX      -= mVelX;
-    mCollider.x = mPosX;
-  }
-  else { /* OK */ }
-
-  // Move the dot up or down
-  mPosY      += mVelY;
+  // Move the dot up or down, up to the wall if it is in the way
+  mPosY      += sweep( 0, mVelY, Level ).Travel( mVelY );
+  mPosY       = SDL_clamp( mPosY, 0, SCREEN_H - DOT_HEIGHT );
   mCollider.y = mPosY;
+}
+
 
-  // If the dot collided or went too far up or down
-  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > SCREEN_H ) || checkCollision( mCollider, Wall ) )
+LSweepHit Dot::sweep( int VelX, int VelY, const LStaticTree& Level )
+{
+  // The area the collider sweeps over the step: only the walls in it can be met
+  const SDL_Rect Swept = { SDL_min( mCollider.x, mCollider.x + VelX ), SDL_min( mCollider.y, mCollider.y + VelY ),
+                           mCollider.w + SDL_abs( VelX ), mCollider.h + SDL_abs( VelY ) };
+
+  mNear.clear();
+  Level.query( Swept, mNear );
+
+  LSweepHit Hit;
+
+  for ( int Wall : mNear )
   {
-    // Move back
-    mPosY      -= mVelY;
-    mCollider.y = mPosY;
+    Hit = EarliestSweep( Hit, SweepCollision( mCollider, VelX, VelY, Level.GetRect( Wall ) ) );
   }
-  else { /* OK */ }
+
+  return Hit;
 }
 
 
@@ -493,6 +542,8 @@ void Dot::render(void)
 {
     // Show the dot
   gDotTexture.render( mPosX, mPosY );
+
+  LDebugDraw::rect( mCollider, DotColliderColour );
 }
 
 
@@ -618,55 +669,6 @@ static void close(void)
   SDL_Quit();
 }
 
-bool checkCollision( SDL_Rect a, SDL_Rect b )
-{
-  bool Result;
-
-  // The sides (vertices) of the rectangles
-  int leftA  , leftB;
-  int rightA , rightB;
-  int topA   , topB;
-  int bottomA, bottomB;
-
-  // Calculate the sides (vertices) of rect A
-  leftA   = a.x;
-  rightA  = a.x + a.w;
-  topA    = a.y;
-  bottomA = a.y + a.h;
-
-  // Calculate the sides (vertices) of rect B
-  leftB   = b.x;
-  rightB  = b.x + b.w;
-  topB    = b.y;
-  bottomB = b.y + b.h;
-
-  // Separating axis test: check whether any of the sides (vertices) from A are outside of B
-  if( bottomA <= topB )
-  {
-    Result = false;
-  }
-  else if( topA >= bottomB )
-  {
-    Result = false;
-  }
-  else if( rightA <= leftB )
-  {
-    Result = false;
-  }
-  else if( leftA >= rightB )
-  {
-    Result = false;
-  }
-  else
-  {
-    // None of the sides from A are outside B: collision detected!
-    Result = true;
-  }
-
-  return Result;
-}
-
-
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -678,6 +680,27 @@ static void PressEnter(void)
 }
 
 
+/**
+ * @brief Reads the tile map of the level into the tree of its walls
+ **/
+static void loadLevel( LStaticTree& Level )
+{
+  std::vector<int> Tiles;
+
+  for ( const char* Row : LEVEL_MAP )
+  {
+    for ( int Column = 0; Column != LEVEL_COLUMNS; ++Column )
+    {
+      Tiles.push_back( ( Row[Column] == '#' ) ? 1 : 0 );
+    }
+  }
+
+  Level.buildFromTiles( Tiles, LEVEL_COLUMNS, TILE_SIZE, TILE_SIZE );
+
+  printf( "\nLevel loaded: %d walls in %d nodes", static_cast<int>( Level.GetCount() ), static_cast<int>( Level.GetNodeCount() ) );
+}
+
+
 /***************************************************************************************************
 * Main function
 ****************************************************************************************************/
@@ -721,12 +744,9 @@ int main( int argc, char* args[] )
       // The dot that will be moving around on the screen
       Dot dot;
 
-      // Set the wall
-      SDL_Rect Wall;
-      Wall.x = WALL_x;
-      Wall.y = WALL_y;
-      Wall.w = WALL_w;
-      Wall.h = WALL_h;
+      // Set the walls
+      LStaticTree Level;
+      loadLevel( Level );
 
       // While application is running
       while( !quit )
@@ -743,22 +763,38 @@ int main( int argc, char* args[] )
 
           // Handle input for the dot
           dot.handleEvent( e );
+
+          // F3 shows the collision boxes
+          LDebugDraw::handleEvent( e );
         }
 
         // Move the dot and check collision
-        dot.move( Wall );
+        dot.move( Level );
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
-        // Render wall
+        // Render walls
         SDL_SetRenderDrawColor( gRenderer, BLACK_R, BLACK_G, BLACK_B, BLACK_A);
-        SDL_RenderDrawRect( gRenderer, &Wall );
+
+        for ( int Wall = 0; Wall != static_cast<int>( Level.GetCount() ); ++Wall )
+        {
+          SDL_RenderDrawRect( gRenderer, &Level.GetRect( Wall ) );
+          LDebugDraw::fillRect( Level.GetRect( Wall ), WallColliderColour );
+        }
+
+        for ( int Node = 0; Node != static_cast<int>( Level.GetNodeCount() ); ++Node )
+        {
+          LDebugDraw::rect( Level.GetNodeBounds( Node ), NodeColour );
+        }
 
         // Render dot
         dot.render();
 
+        // Draw the debug overlay over everything
+        LDebugDraw::render( gRenderer );
+
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
@@ -55,6 +55,20 @@
  * detail to allow for early outs to prevent unneeded checks at the per-pixel level. Like in
  * previous tutorials, tree structures are outside the scope of these tutorials.
  *
+ * Aggiunta GS: il confronto fra insiemi di box è ora in "CheckCollision" di Engine_Lib/LCollision,
+ * che si ferma alla prima coppia di box in collisione.
+ *
+ * Aggiunta GS: i box del punto sono disposti una volta sola, relativi all'angolo in alto a sinistra,
+ * e impacchettati in un "LPackedRects": i lati in array separati, a gruppi di quattro confrontati
+ * con una sola istruzione SSE2/NEON, e un bounding box per ogni gruppo e per tutto l'insieme, che
+ * scarta subito i casi senza collisione (l'ottimizzazione descritta sopra). Muovere il punto non
+ * ricalcola più i box: il test riceve la posizione di ciascun insieme. Con il tasto P si passa alla
+ * collisione al pixel, con una maschera di bit ("LCollisionMask") ricavata dalla trasparenza
+ * dell'immagine: 64 pixel per ogni AND.
+ *
+ * Aggiunta GS: F3 mostra i box di collisione dei due punti, disegnati da LDebugDraw sopra il frame.
+ * Nelle build con NDEBUG il ciclo che li passa all'overlay è eliminato dal compilatore.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -65,6 +79,8 @@
 #include <stdio.h>
 #include <string>
 #include <vector>
+#include "LCollision.hpp"
+#include "LDebugDraw.hpp"
 
 /**************************************************************************************************
 * Private constants
@@ -93,6 +109,9 @@ static constexpr int WALL_y = 40;
 static constexpr int WALL_w = 40;
 static constexpr int WALL_h = 400;
 
+// Overlay di debug (F3): i box di collisione
+static constexpr SDL_Color ColliderColour{ 0x00, 0xC0, 0x00, 0xFF };
+
 static const std::string FilePath("dot.bmp");
 
 
@@ -159,13 +178,13 @@ class Dot
   void handleEvent( SDL_Event& );
 
   // Moves the dot and checks collision
-  void move( const std::vector<SDL_Rect>& otherColliders );
+  void move( const Dot& other );
 
   // Shows the dot on the screen
   void render(void);
 
-  // Gets the collision boxes
-  std::vector<SDL_Rect>& getColliders();
+  // Checks collision against another dot
+  bool touches( const Dot& other ) const;
 
   private:
 
@@ -182,10 +201,13 @@ class Dot
   // The velocity of the dot
   int mVelX, mVelY;
 
-  // Dot's collision boxes
+  // Dot's collision boxes, relative to the dot's offset
   std::vector<SDL_Rect> mColliders;
 
-  // Moves the collision boxes relative to the dot's offset
+  // The same boxes, packed for batch tests
+  LPackedRects mPackedColliders;
+
+  // Places the collision boxes relative to the dot's offset
   void shiftColliders();
 };
 
@@ -198,7 +220,6 @@ static bool init(void);
 static bool loadMedia(void);
 static void close(void);
 static void PressEnter(void);
-static bool checkCollision( const std::vector<SDL_Rect>& a, const std::vector<SDL_Rect>& b ); // Box set collision detector
 
 
 /***************************************************************************************************
@@ -211,6 +232,10 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gDotTexture;
 
+// Opaque pixels of the dot, and whether they are used instead of the boxes
+static LCollisionMask gDotMask;
+static bool           gPixelCollision = false;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -442,6 +467,7 @@ Dot::Dot( int x, int y )
 
   // Initialize colliders relative to position
   shiftColliders();
+  mPackedColliders.assign( mColliders );
 }
 
 
@@ -479,37 +505,33 @@ void Dot::handleEvent( SDL_Event& e )
 
 
 /**
- * @brief Calculates new coordinates of the dot based on the current velocity. Whenever we move the
- * dot, we also move the collider(s) with it. After we move the dot, we check if it went off screen
- * or hit something. If it did, we move the dot back and move its colliders with it.
- * 
- * @param otherColliders 
+ * @brief Calculates new coordinates of the dot based on the current velocity. The colliders are
+ * relative to the dot, so they follow it without being moved. After we move the dot, we check if it
+ * went off screen or hit something. If it did, we move the dot back.
+ *
+ * @param other
  **/
-void Dot::move( const std::vector<SDL_Rect>& otherColliders )
+void Dot::move( const Dot& other )
 {
   // Move the dot left or right
   mPosX += mVelX;
-  shiftColliders();
 
   // If the dot collided or went too far to the left or right
-  if ( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > SCREEN_W ) || checkCollision( mColliders, otherColliders ) )
+  if ( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > SCREEN_W ) || touches( other ) )
   {
     // Move back
     mPosX -= mVelX;
-    shiftColliders();
   }
   else { /* No collision detected */ }
 
   // Move the dot up or down
   mPosY += mVelY;
-  shiftColliders();
 
   // If the dot collided or went too far up or down
-  if ( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > SCREEN_H ) || checkCollision( mColliders, otherColliders ) )
+  if ( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > SCREEN_H ) || touches( other ) )
   {
     // Move back
     mPosY -= mVelY;
-    shiftColliders();
   }
   else { /* No collision detected */ }
 }
@@ -519,6 +541,36 @@ void Dot::render(void)
 {
   // Show the dot
   gDotTexture.render( mPosX, mPosY );
+
+  // The boxes are relative to the dot's top left corner
+  if ( LDebugDraw::isVisible() )
+  {
+    for ( const SDL_Rect& Box : mColliders )
+    {
+      LDebugDraw::rect( SDL_Rect{ mPosX + Box.x, mPosY + Box.y, Box.w, Box.h }, ColliderColour );
+    }
+  }
+  else {;}
+}
+
+
+/**
+ * @brief Checks collision against another dot, with the per-pixel boxes or, if enabled, the pixel
+ * mask.
+ *
+ * @param other
+ * @return true if a collision has happened; false otherwise
+ **/
+bool Dot::touches( const Dot& other ) const
+{
+  if( gPixelCollision )
+  {
+    return CheckCollision( gDotMask, mPosX, mPosY, gDotMask, other.mPosX, other.mPosY );
+  }
+  else
+  {
+    return CheckCollision( mPackedColliders, mPosX, mPosY, other.mPackedColliders, other.mPosX, other.mPosY );
+  }
 }
 
 
@@ -531,10 +583,10 @@ void Dot::shiftColliders(void)
   for( int set = 0; set != static_cast<int>(mColliders.size()); ++set )
   {
     // Center the collision box
-    mColliders[ set ].x = mPosX + ( DOT_WIDTH - mColliders[ set ].w ) / 2;
+    mColliders[ set ].x = ( DOT_WIDTH - mColliders[ set ].w ) / 2;
 
     // Set the collision box at its row offset
-    mColliders[ set ].y = mPosY + r;
+    mColliders[ set ].y = r;
 
     // Move the row offset down the height of the collision box
     r += mColliders[ set ].h;
@@ -542,12 +594,6 @@ void Dot::shiftColliders(void)
 }
 
 
-std::vector<SDL_Rect>& Dot::getColliders(void)
-{
-  return mColliders;
-}
-
-
 /**
  * @brief Starts up SDL and creates window
  *
@@ -650,6 +696,24 @@ static bool loadMedia(void)
     printf( "\nDot texture loaded" );
   }
 
+  // Build the collision mask of the dot, with the same colour key as the texture
+  SDL_Surface* dotSurface = IMG_Load( FilePath.c_str() );
+
+  if( dotSurface != NULL )
+  {
+    SDL_SetColorKey( dotSurface, SDL_TRUE, SDL_MapRGB( dotSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+  }
+  else { /* Reported below */ }
+
+  if( !gDotMask.loadFromSurface( dotSurface ) )
+  {
+    printf( "\nFailed to build the collision mask of the dot!" );
+    success = false;
+  }
+  else { /* Mask ready */ }
+
+  SDL_FreeSurface( dotSurface );
+
   return success;
 }
 
@@ -671,56 +735,6 @@ static void close(void)
 }
 
 
-/**
- * @brief A for loop calculates the top/bottom/left/right of each collision box in object a.
- * 
- * @param a The oject to check with b.
- * @param b The oject to check with a.
- * @return true if a collision has happened; false otherwise
- **/
-bool checkCollision( const std::vector<SDL_Rect>& a, const std::vector<SDL_Rect>& b )
-{
-  bool Result = false;
-
-  // The sides of the rectangles
-  int leftA  , leftB;
-  int rightA , rightB;
-  int topA   , topB;
-  int bottomA, bottomB;
-
-  // Go through the A boxes
-  for( size_t Abox = 0; Abox != a.size(); Abox++ )
-  {
-    // Calculate the sides of rect A
-    leftA   = a[ Abox ].x;
-    rightA  = a[ Abox ].x + a[ Abox ].w;
-    topA    = a[ Abox ].y;
-    bottomA = a[ Abox ].y + a[ Abox ].h;
-
-    // Go through the B boxes
-    for( size_t Bbox = 0; Bbox != b.size(); Bbox++ )
-    {
-      // Calculate the sides of rect B
-      leftB   = b[ Bbox ].x;
-      rightB  = b[ Bbox ].x + b[ Bbox ].w;
-      topB    = b[ Bbox ].y;
-      bottomB = b[ Bbox ].y + b[ Bbox ].h;
-
-      // If no sides from A are outside of B
-      if( ( ( bottomA <= topB ) || ( topA >= bottomB ) || ( rightA <= leftB ) || ( leftA >= rightB ) ) == false )
-      {
-        // A collision is detected
-        Result = true;
-      }
-      else { /* No collision detected */ }
-    }
-  }
-
-  // If neither set of collision boxes touched
-  return Result;
-}
-
-
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -789,14 +803,23 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          // Switch between boxes and pixel mask
+          else if( ( e.type == SDL_KEYDOWN ) && ( e.key.repeat == 0 ) && ( e.key.keysym.sym == SDLK_p ) )
+          {
+            gPixelCollision = !gPixelCollision;
+            printf( "\nCollision: %s", gPixelCollision ? "pixel mask" : "boxes" );
+          }
           else { /* ignore event */ }
 
           // Handle input for the dot
           dot.handleEvent( e );
+
+          // F3 shows the collision boxes
+          LDebugDraw::handleEvent( e );
         }
 
         // Move the dot and check collision
-        dot.move( otherDot.getColliders() );
+        dot.move( otherDot );
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
@@ -806,6 +829,9 @@ int main( int argc, char* args[] )
         dot.render();
         otherDot.render();
 
+        // Draw the debug overlay over everything
+        LDebugDraw::render( gRenderer );
+
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
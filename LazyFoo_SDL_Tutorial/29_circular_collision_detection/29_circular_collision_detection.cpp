@@ -59,6 +59,22 @@
  * Before we enter the main loop we define the scene objects. Finally, in our main loop we handle
  * input, move the dot with collision check and render the scene objects to the screen.
  *
+ * Aggiunta GS: i test cerchio/cerchio e cerchio/box sono ora in "CheckCollision" di
+ * Engine_Lib/LCollision, e "Circle" è la struttura "LCircle" della libreria.
+ *
+ * Aggiunta GS: il dot avanza fino al primo contatto invece di annullare il passo: "SweepCollision"
+ * dà la frazione del passo in cui il cerchio incontra il quadrato o l'altro cerchio, e vale la
+ * prima delle due. Nessun passo, per quanto lungo, attraversa un ostacolo.
+ *
+ * Aggiunta GS: F3 mostra i cerchi di collisione e il muro, disegnati da LDebugDraw sopra il frame;
+ * un cerchio è un poligono di 24 lati uniti, passati al renderer con una sola chiamata.
+ *
+ * Aggiunta GS: sullo schermo rimbalzano 2000 proiettili, come in uno "bullet hell", e a ogni frame
+ * il dot è confrontato con tutti insieme da LPackedCircles: centri e raggi stanno in array separati
+ * di float e quattro proiettili alla volta sono provati con SSE2 o NEON, confrontando le distanze al
+ * quadrato senza radici né salti. Il risultato è una maschera di bit, da cui si leggono i proiettili
+ * colpiti, disegnati in rosso; il loro numero è nel titolo della finestra.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022) and may not be
  * redistributed without written permission.
  **/
@@ -68,6 +84,9 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
+#include "LCollision.hpp"
+#include "LDebugDraw.hpp"
 
 
 /**************************************************************************************************
@@ -103,6 +122,18 @@ static constexpr int WALL_y = 40;
 static constexpr int WALL_w = 40;
 static constexpr int WALL_h = 400;
 
+// Proiettili
+static constexpr int NUM_OF_BULLETS = 2000;
+static constexpr int BULLET_RADIUS  = 3;
+static constexpr int BULLET_SPEED   = 3;     // Massima, per asse
+
+static constexpr SDL_Color BulletColour{ 0x60, 0x60, 0x60, 0xFF };
+static constexpr SDL_Color HitColour   { 0xFF, 0x00, 0x00, 0xFF };
+
+// Overlay di debug (F3): le forme di collisione
+static constexpr SDL_Color DotColliderColour { 0x00, 0xC0, 0x00, 0xFF };
+static constexpr SDL_Color WallColliderColour{ 0xFF, 0x00, 0x00, 0x60 };
+
 static const std::string FilePath("dot.bmp");
 
 
@@ -111,11 +142,7 @@ static const std::string FilePath("dot.bmp");
 ****************************************************************************************************/
 
 // A circle stucture
-struct Circle
-{
-  int x, y;
-  int r;
-};
+using Circle = LCircle;
 
 
 // Texture wrapper class
@@ -210,6 +237,34 @@ class Dot
 };
 
 
+// Bullets bouncing around the screen, all tested against one circle at once
+class BulletSwarm
+{
+  public:
+
+  // Spreads the bullets over the screen
+  BulletSwarm(void);
+
+  // Moves the bullets, bouncing off the edges of the screen
+  void move(void);
+
+  // Finds the bullets overlapping a circle
+  size_t test( const Circle& );
+
+  // Shows the bullets, the ones hit in red
+  void render(void);
+
+  private:
+
+  std::vector<Circle>    mBullets;
+  std::vector<SDL_Point> mVelocities;
+  LPackedCircles         mPacked;     // The same circles, packed for the batch test
+  std::vector<Uint32>    mHits;       // One bit per bullet, from the last test
+  std::vector<SDL_Rect>  mQuads;      // Storage kept between frames
+  std::vector<SDL_Rect>  mHitQuads;
+};
+
+
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
@@ -218,9 +273,6 @@ static bool   init           ( void );
 static bool   loadMedia      ( void );
 static void   close          ( void );
 static void   PressEnter     ( void );
-static bool   checkCollision ( Circle&, Circle& );   // Circle/Circle collision detector
-static bool   checkCollision ( Circle&, SDL_Rect& ); // Circle/Box    collision detector
-static double distanceSquared( int x1, int y1, int x2, int y2 ); // Calculates distance squared between two points
 
 
 /***************************************************************************************************
@@ -233,6 +285,9 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gDotTexture;
 
+// Window title, updated when the number of bullets hit changes
+static char gTitle[64] = "";
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -459,38 +514,22 @@ void Dot::handleEvent( SDL_Event& e )
 
 
 /**
- * @brief Move object - Check for collision - Undo move if collision detected
+ * @brief Move object, one axis at a time, up to the first scene object in the way
  *
  * @param square Square to check collision against
  * @param circle Circle to check collision against
  **/
 void Dot::move( SDL_Rect& square, Circle& circle )
 {
-  // Move the dot left or right
-  mPosX += mVelX;
+  // Move the dot left or right, up to the earliest contact
+  mPosX += EarliestSweep( SweepCollision( mCollider, mVelX, 0, square ), SweepCollision( mCollider, mVelX, 0, circle ) ).Travel( mVelX );
+  mPosX  = SDL_clamp( mPosX, mCollider.r, SCREEN_W - mCollider.r );
   shiftColliders();
 
-  // If the dot collided or went too far to the left or right
-  if( ( mPosX - mCollider.r < 0 ) || ( mPosX + mCollider.r > SCREEN_W ) || checkCollision( mCollider, square ) || checkCollision( mCollider, circle ) )
-  {
-    // Move back
-    mPosX -= mVelX;
-    shiftColliders();
-  }
-  else { /* No collision detected */ }
-
-  // Move the dot up or down
-  mPosY += mVelY;
+  // Move the dot up or down, up to the earliest contact
+  mPosY += EarliestSweep( SweepCollision( mCollider, 0, mVelY, square ), SweepCollision( mCollider, 0, mVelY, circle ) ).Travel( mVelY );
+  mPosY  = SDL_clamp( mPosY, mCollider.r, SCREEN_H - mCollider.r );
   shiftColliders();
-
-  // If the dot collided or went too far up or down
-  if( ( mPosY - mCollider.r < 0 ) || ( mPosY + mCollider.r > SCREEN_H ) || checkCollision( mCollider, square ) || checkCollision( mCollider, circle ) )
-  {
-    // Move back
-    mPosY -= mVelY;
-    shiftColliders();
-  }
-  else { /* No collision detected */ }
 }
 
 
@@ -502,6 +541,8 @@ void Dot::render(void)
 
   // Show the dot
   gDotTexture.render( mPosX - mCollider.r, mPosY - mCollider.r );
+
+  LDebugDraw::circle( mCollider.x, mCollider.y, mCollider.r, DotColliderColour );
 }
 
 
@@ -519,6 +560,83 @@ Circle& Dot::getCollider(void)
 }
 
 
+BulletSwarm::BulletSwarm(void)
+{
+  // A fixed scatter: the same swarm at every run
+  for ( int Bullet = 0; Bullet != NUM_OF_BULLETS; ++Bullet )
+  {
+    const Circle Spawn = { ( Bullet * 7919 ) % SCREEN_W, ( Bullet * 104729 ) % SCREEN_H, BULLET_RADIUS };
+
+    mBullets.push_back( Spawn );
+    mVelocities.push_back( SDL_Point{ Bullet % ( 2 * BULLET_SPEED + 1 ) - BULLET_SPEED,
+                                      ( Bullet / 7 ) % ( 2 * BULLET_SPEED + 1 ) - BULLET_SPEED } );
+    mPacked.add( Spawn );
+  }
+}
+
+
+void BulletSwarm::move(void)
+{
+  for ( size_t Bullet = 0; Bullet != mBullets.size(); ++Bullet )
+  {
+    Circle&    Shape    = mBullets[Bullet];
+    SDL_Point& Velocity = mVelocities[Bullet];
+
+    Shape.x += Velocity.x;
+    Shape.y += Velocity.y;
+
+    if ( Shape.x < 0 || Shape.x >= SCREEN_W )
+    {
+      Velocity.x = -Velocity.x;
+    }
+    else
+    {;}
+
+    if ( Shape.y < 0 || Shape.y >= SCREEN_H )
+    {
+      Velocity.y = -Velocity.y;
+    }
+    else
+    {;}
+
+    mPacked.set( Bullet, Shape );
+  }
+}
+
+
+/**
+ * @brief Tests all the bullets against a circle, four at a time
+ *
+ * @return The number of bullets hit
+ **/
+size_t BulletSwarm::test( const Circle& Target )
+{
+  return mPacked.findHits( Target, mHits );
+}
+
+
+void BulletSwarm::render(void)
+{
+  mQuads.clear();
+  mHitQuads.clear();
+
+  for ( size_t Bullet = 0; Bullet != mBullets.size(); ++Bullet )
+  {
+    const Circle&  Shape = mBullets[Bullet];
+    const SDL_Rect Quad  = { Shape.x - Shape.r, Shape.y - Shape.r, 2 * Shape.r, 2 * Shape.r };
+    const bool     IsHit = ( ( mHits[ Bullet / 32 ] >> ( Bullet % 32 ) ) & 1 ) != 0;
+
+    ( IsHit ? mHitQuads : mQuads ).push_back( Quad );
+  }
+
+  SDL_SetRenderDrawColor( gRenderer, BulletColour.r, BulletColour.g, BulletColour.b, BulletColour.a );
+  SDL_RenderFillRects( gRenderer, mQuads.data(), static_cast<int>( mQuads.size() ) );
+
+  SDL_SetRenderDrawColor( gRenderer, HitColour.r, HitColour.g, HitColour.b, HitColour.a );
+  SDL_RenderFillRects( gRenderer, mHitQuads.data(), static_cast<int>( mHitQuads.size() ) );
+}
+
+
 /**
  * @brief Starts up SDL and creates window
  *
@@ -642,94 +760,6 @@ static void close(void)
 }
 
 
-/**
- * @brief Circle-to-circle collision check.
- *
- * @param a Circle
- * @param b Circle
- * @return true if collision happened; false otherwise
- **/
-bool checkCollision( Circle& a, Circle& b )
-{
-  // Calculate total radius squared
-  int totalRadiusSquared = a.r + b.r;
-      totalRadiusSquared = totalRadiusSquared * totalRadiusSquared;
-
-  // If the distance between the centers of the circles is less than the sum of their radii
-  if( distanceSquared( a.x, a.y, b.x, b.y ) < ( totalRadiusSquared ) )
-  {
-    // The circles have collided
-    return true;
-  }
-  else { /* No collision detected */ }
-
-  // If not
-  return false;
-}
-
-
-/**
- * @brief Circle-to-Rect collision check.
- *
- * @param a Circle
- * @param b Rect
- * @return true if collision happened; false otherwise
- **/
-bool checkCollision( Circle& a, SDL_Rect& b )
-{
-  // Closest point on collision box
-  int cX, cY;
-
-  // Find closest x offset
-  if ( a.x < b.x )
-  {
-    cX = b.x;
-  }
-  else if ( a.x > b.x + b.w )
-  {
-    cX = b.x + b.w;
-  }
-  else
-  {
-    cX = a.x;
-  }
-
-  // Find closest y offset
-  if ( a.y < b.y )
-  {
-    cY = b.y;
-  }
-  else if ( a.y > b.y + b.h )
-  {
-    cY = b.y + b.h;
-  }
-  else
-  {
-    cY = a.y;
-  }
-
-  // If the closest point is inside the circle
-  if ( distanceSquared( a.x, a.y, cX, cY ) < ( a.r * a.r ) )
-  {
-    // This box and the circle have collided
-    return true;
-  }
-  else { /* No collision detected */ }
-
-  // If the shapes have not collided
-  return false;
-}
-
-
-double distanceSquared( int x1, int y1, int x2, int y2 )
-{
-  int deltaX = x2 - x1;
-  int deltaY = y2 - y1;
-
-  return deltaX * deltaX + deltaY * deltaY;
-}
-
-
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -785,6 +815,10 @@ int main( int argc, char* args[] )
       Dot dot( Dot::DOT_WIDTH / 2, Dot::DOT_HEIGHT / 2 );
       Dot otherDot( SCREEN_W / 4, SCREEN_H / 4 );
 
+      // The bullets, and how many hit the dot in the last frame
+      BulletSwarm bullets;
+      size_t      lastHits = static_cast<size_t>( -1 );
+
       // Set the wall
       SDL_Rect wall;
       wall.x = WALL_x;
@@ -807,11 +841,28 @@ int main( int argc, char* args[] )
 
           // Handle input for the dot
           dot.handleEvent( e );
+
+          // F3 shows the collision shapes
+          LDebugDraw::handleEvent( e );
         }
 
         // Move the dot and check collision both with the wall and the other (static) circle
         dot.move( wall, otherDot.getCollider() );
 
+        // Move the bullets and find the ones on the dot
+        bullets.move();
+
+        const size_t hits = bullets.test( dot.getCollider() );
+
+        if ( hits != lastHits )
+        {
+          SDL_snprintf( gTitle, sizeof( gTitle ), "SDL Tutorial - %d bullets on the dot", static_cast<int>( hits ) );
+          SDL_SetWindowTitle( gWindow, gTitle );
+          lastHits = hits;
+        }
+        else
+        {;}
+
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
@@ -819,11 +870,18 @@ int main( int argc, char* args[] )
         // Render wall
         SDL_SetRenderDrawColor( gRenderer, BLACK_R, BLACK_G, BLACK_B, BLACK_A );
         SDL_RenderDrawRect( gRenderer, &wall );
+        LDebugDraw::fillRect( wall, WallColliderColour );
 
         // Render dots
         dot.render();
         otherDot.render();
 
+        // Render bullets
+        bullets.render();
+
+        // Draw the debug overlay over everything
+        LDebugDraw::render( gRenderer );
+
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
@@ -41,6 +41,21 @@
  * questo modo, se l'inquadratura è bloccata ai lati, vedremo il punto muoversi a sfondo fermo;
  * altrimenti, il punto sarà fisso al centro dello schermo, e vedremo lo sfondo muoversi.
  *
+ * Aggiunta GS: se accanto all'eseguibile c'è "bg.chunks", lo sfondo non è più una sola texture.
+ * Engine_Lib/LChunkStreamer lo legge a blocchi, tagliati dallo strumento SliceChunks: a ogni frame
+ * vuole i blocchi visibili e quelli attorno all'inquadratura e lungo la sua velocità, li fa
+ * decodificare ai thread di LJobSystem e li carica sulla GPU pochi per frame, mentre quelli rimasti
+ * indietro sono scartati oltre RESIDENT_CHUNKS. Solo il primo frame attende i blocchi visibili:
+ * dopo, un blocco non ancora pronto è contato come "miss" (scritto sulla console alla chiusura),
+ * senza fermare il gioco. Così il livello può essere molto più grande della memoria video.
+ *
+ * Aggiunta GS: clear, sfondo e punto passano da una lista di disegno (Engine_Lib/LDrawList), lo
+ * sfondo nello strato sotto e il punto in quello sopra. Lo sfondo intero copre tutta la finestra ed è
+ * opaco (dichiarato con "setOpaque", perché il colour key rende la texture trasparente anche se non
+ * ha pixel ciano): la lista salta la clear, che riempirebbe di bianco pixel subito coperti, e ogni
+ * pixel della finestra è scritto una volta per lo sfondo più quelli del punto. Con i blocchi, che
+ * possono mancare, la clear resta.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -50,6 +65,10 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include "LChunkStreamer.hpp"
+#include "LDrawList.hpp"
+#include "LJobSystem.hpp"
+#include "LTexture.hpp"
 
 
 /**************************************************************************************************
@@ -71,15 +90,20 @@ static constexpr int WHITE_G = 0xFF; // Amount of green needed to compose white
 static constexpr int WHITE_B = 0xFF; // Amount of blue  needed to compose white
 static constexpr int WHITE_A = 0xFF; // Alpha component
 
-// Colore ciano
-static constexpr int CYAN_R = 0x00; // Amount of red   needed to compose cyan
-static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
-static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
-static constexpr int CYAN_A = 0xFF; // Alpha component
-
 static const std::string DotPath("dot.bmp");
 static const std::string BackGroundPath("bg.png");
 
+// Mappa dei blocchi dello sfondo, preparata con "SliceChunks --chunk-size=256 bg.png"
+static const std::string ChunkMapPath("bg.chunks");
+
+static constexpr int   RESIDENT_CHUNKS  = 24;   // Blocchi al massimo sulla GPU
+static constexpr int   PREFETCH_RADIUS  = 128;  // Pixel attorno all'inquadratura caricati in anticipo
+static constexpr float PREFETCH_FRAMES  = 30.0f; // Frame di movimento dell'inquadratura caricati in anticipo
+
+// Strati della lista di disegno: lo sfondo sotto, il punto sopra
+static constexpr Uint8 LAYER_BACKGROUND = 0;
+static constexpr Uint8 LAYER_OBJECTS    = 1;
+
 
 /***************************************************************************************************
 * Classes
@@ -95,53 +119,6 @@ struct Circle
 };
 
 
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
-
-  // Loads image at specified path
-  bool loadFromFile( const std::string& );
-
-  #if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-  #endif
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-  void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Gets image dimensions
-  int getWidth (void) const;
-  int getHeight(void) const;
-
-  private:
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
-
-
 /**
  * @brief The dot that will move around on the screen.
  **/
@@ -162,7 +139,7 @@ class Dot
   // Moves the dot
   void move(void);
 
-  // Shows the dot on the screen relative to the camera
+  // Queues the dot in the draw list relative to the camera
   void render( int, int );
 
   // Position accessors
@@ -186,9 +163,10 @@ class Dot
 * Private prototypes
 ****************************************************************************************************/
 
-static bool init      ( void );
-static bool loadMedia ( void );
-static void close     ( void );
+static bool init        ( void );
+static bool loadMedia   ( void );
+static void close       ( void );
+static void renderWorld ( SDL_Renderer*, void* );
 
 
 /***************************************************************************************************
@@ -200,195 +178,23 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 // Scene textures
 static LTexture gDotTexture;
-static LTexture gBGTexture;
-
-
-/***************************************************************************************************
-* Methods definitions
-****************************************************************************************************/
-
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", path.c_str() );
+static LTexture gBGTexture;     // Whole background, only without a chunk map
 
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+// Background streamed by chunks, decoded by the job workers
+static LJobSystem     gJobs;
+static LChunkStreamer gWorld;
 
-    // Create texture from surface pixels
-    newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
+// Frame draws, sorted by layer: the clear and whatever the background hides are skipped
+static LDrawList gDrawList;
 
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", path.c_str() );
-
-      // Get image dimensions
-      mWidth  = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
+// Level size: the chunk map's, if there is one
+static int gLevelW = LEVEL_W;
+static int gLevelH = LEVEL_H;
 
 
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-        mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-void LTexture::free(void)
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
-
+/***************************************************************************************************
+* Methods definitions
+****************************************************************************************************/
 
 Dot::Dot(void)
 {
@@ -441,7 +247,7 @@ void Dot::move(void)
   mPosX += mVelX;
 
   // If the dot went too far to the left or right
-  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > LEVEL_W ) )
+  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > gLevelW ) )
   {
     // Move back
     mPosX -= mVelX;
@@ -452,7 +258,7 @@ void Dot::move(void)
   mPosY += mVelY;
 
   // If the dot went too far up or down
-  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > LEVEL_H ) )
+  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > gLevelH ) )
   {
     // Move back
     mPosY -= mVelY;
@@ -463,8 +269,8 @@ void Dot::move(void)
 
 void Dot::render( int camX, int camY )
 {
-  // Show the dot relative to the camera
-  gDotTexture.render( mPosX - camX, mPosY - camY );
+  // Show the dot relative to the camera, above the background
+  gDrawList.add( LAYER_OBJECTS, 0.0f, gDotTexture.getSDLTexture(), mPosX - camX, mPosY - camY );
 }
 
 
@@ -535,6 +341,9 @@ static bool init(void)
       {
         printf( "\nRenderer created" );
 
+        // Renderer of the textures of Engine_Lib
+        LTexture::SetDefaultRenderer( gRenderer );
+
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -551,6 +360,16 @@ static bool init(void)
           printf( "\nSDL_image initialised" );
         }
 
+        // Start the job workers: if they cannot start, the chunks are decoded on this thread
+        if( !gJobs.init() )
+        {
+          printf( "\nUnable to start the job workers!" );
+        }
+        else
+        {
+          printf( "\n%d job workers started", gJobs.GetWorkerCount() );
+        }
+
       } // Renderer created
 
     } // Window created
@@ -582,8 +401,16 @@ static bool loadMedia(void)
     printf( "\nDot texture loaded" );
   }
 
-  // Load background texture
-  if ( !gBGTexture.loadFromFile( BackGroundPath.c_str() ) )
+  // Stream the background by chunks if it was sliced, otherwise load it whole
+  if ( gWorld.open( ChunkMapPath, gJobs, RESIDENT_CHUNKS ) )
+  {
+    printf( "\nBackground chunk map opened" );
+
+    gWorld.setPrefetch( PREFETCH_RADIUS, PREFETCH_FRAMES );
+    gLevelW = gWorld.GetLevelWidth();
+    gLevelH = gWorld.GetLevelHeight();
+  }
+  else if ( !gBGTexture.loadFromFile( BackGroundPath.c_str() ) )
   {
     printf( "\nFailed to load background texture!\n" );
     success = false;
@@ -591,18 +418,38 @@ static bool loadMedia(void)
   else
   {
     printf( "\nBackground texture loaded" );
+
+    // Il colour key rende la texture trasparente, ma lo sfondo non ha pixel ciano: copre tutto ciò che ha sotto
+    gDrawList.setOpaque( gBGTexture.getSDLTexture(), true );
   }
 
   return success;
 }
 
 
+/**
+ * @brief Draws the visible chunks of the background, in the draw list's turn.
+ *
+ * @param Camera_Ptr The camera of the frame.
+ **/
+static void renderWorld( SDL_Renderer*, void* Camera_Ptr )
+{
+  gWorld.render( *static_cast<SDL_Rect*>( Camera_Ptr ) ); // Solo i blocchi visibili, ognuno tagliato all'inquadratura
+}
+
+
 static void close(void)
 {
   // Free loaded images
   gDotTexture.free();
   gBGTexture.free();
 
+  // Wait for the chunks being decoded, then stop the workers
+  printf( "\nChunks: %u loaded, %u evicted, %u missed", static_cast<unsigned>( gWorld.GetLoads() ),
+          static_cast<unsigned>( gWorld.GetEvictions() ), static_cast<unsigned>( gWorld.GetMisses() ) );
+  gWorld.close();
+  gJobs.shutdown();
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -692,6 +539,10 @@ int main( int argc, char* args[] )
         // Move the dot
         dot.move();
 
+        // Where the camera was, for its velocity
+        const int previousX = camera.x;
+        const int previousY = camera.y;
+
         // Center the camera over the dot
         camera.x = ( dot.getPosX() + Dot::DOT_WIDTH  / 2 ) - SCREEN_W / 2;
         camera.y = ( dot.getPosY() + Dot::DOT_HEIGHT / 2 ) - SCREEN_H / 2;
@@ -709,29 +560,40 @@ int main( int argc, char* args[] )
         }
         else { /* Camera's position is OK */ }
 
-        if( camera.x > LEVEL_W - camera.w )
+        if( camera.x > gLevelW - camera.w )
         {
-          camera.x = LEVEL_W - camera.w;
+          camera.x = gLevelW - camera.w;
         }
         else { /* Camera's position is OK */ }
 
-        if( camera.y > LEVEL_H - camera.h )
+        if( camera.y > gLevelH - camera.h )
         {
-          camera.y = LEVEL_H - camera.h;
+          camera.y = gLevelH - camera.h;
         }
         else { /* Camera's position is OK */ }
 
+        // Load the chunks around the camera and ahead of it, evict those left behind
+        gWorld.update( camera, static_cast<float>( camera.x - previousX ), static_cast<float>( camera.y - previousY ) );
 
-        // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
-        SDL_RenderClear( gRenderer );
+        // Clear screen: skipped by the draw list when the background covers the window
+        gDrawList.clear( SDL_Color{ WHITE_R, WHITE_G, WHITE_B, WHITE_A } );
 
         // Render background
-        gBGTexture.render( 0, 0, &camera ); // x = 0, y = 0 --> Il background va sempre agganciato all'origine della finestra
+        if( gWorld.isOpen() )
+        {
+          gDrawList.addCall( LAYER_BACKGROUND, 0.0f, renderWorld, &camera ); // I blocchi possono mancare: la clear resta
+        }
+        else
+        {
+          gDrawList.add( LAYER_BACKGROUND, 0.0f, gBGTexture.getSDLTexture(), 0, 0, &camera ); // x = 0, y = 0 --> Il background va sempre agganciato all'origine della finestra
+        }
 
         // Render objects
         dot.render( camera.x, camera.y );
 
+        // Sorted by layer, the hidden draws skipped
+        gDrawList.flush( gRenderer );
+
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
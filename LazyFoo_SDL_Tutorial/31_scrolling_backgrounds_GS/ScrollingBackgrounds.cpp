@@ -12,6 +12,13 @@
  * andata completamente fuori dallo schermo. Sarà necessario renderizzare contemporaneamente anche
  * una copia della texture, affiancata alla destra dell'originale, in modo che l'effetto di
  * scorrimento sia completo.
+ *
+ * Aggiunta GS: lo sfondo non è più disegnato due volte per intero. Engine_Lib/LScrollingLayers
+ * tiene per ogni livello l'offset in virgola mobile, già ridotto alla dimensione dell'immagine, e
+ * taglia il livello nei pochi pezzi dell'immagine che coprono la sua area una volta sola (due
+ * colonne, per un'immagine grande quanto la finestra); i pezzi di tutti i livelli sono disegnati
+ * con un solo LSpriteBatch. Ci sono due livelli: l'immagine intera, lontana, che scorre di mezzo
+ * pixel per frame, e la sua fascia inferiore, vicina, che scorre di un pixel per frame (parallasse).
  **/
 
 /**************************************************************************************************
@@ -23,6 +30,9 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include "LScrollingLayers.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
 
 
 /**************************************************************************************************
@@ -40,64 +50,13 @@ static constexpr int WHITE_G = 0xFF; // Amount of green needed to compose white
 static constexpr int WHITE_B = 0xFF; // Amount of blue  needed to compose white
 static constexpr int WHITE_A = 0xFF; // Alpha component
 
-// Colore ciano
-static constexpr int CYAN_R = 0x00; // Amount of red   needed to compose cyan
-static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
-static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
-static constexpr int CYAN_A = 0xFF; // Alpha component
-
 static const std::string BackGroundPath("bg.png");
 
-
-/***************************************************************************************************
-* Classes
-****************************************************************************************************/
-
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
-
-  // Loads image at specified path
-  bool loadFromFile( const std::string& );
-
-  #if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-  #endif
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-  void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Gets image dimensions
-  int getWidth (void) const;
-  int getHeight(void) const;
-
-// private:
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
+// Scorrimento dello sfondo, in pixel per frame: il livello lontano ne percorre la metà
+static constexpr float BG_SCROLL_SPEED = 1.0f;
+static constexpr float BG_FAR_FACTOR   = 0.5f;
+static constexpr float BG_NEAR_FACTOR  = 1.0f;
+static constexpr int   BG_NEAR_H       = WINDOW_H / 4; // Altezza della fascia in primo piano
 
 
 /***************************************************************************************************
@@ -118,204 +77,15 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 static LTexture gBGTexture; // Background texture
 
+// Livelli dello sfondo, disegnati con un solo batch
+static LScrollingLayers gBackground;
+static LSpriteBatch     gBatch;
+
 
 /***************************************************************************************************
-* Methods definitions
+* Functions definitions
 ****************************************************************************************************/
 
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", path.c_str() );
-
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
-
-    // Create texture from surface pixels
-        newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
-
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", path.c_str() );
-
-      // Get image dimensions
-      mWidth  = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
-
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-        mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-void LTexture::free(void)
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-/**
- * @brief Render a texture.
- *
- * @param x Horizontal rendering position relative to the window.
- * @param y Vertical rendering position relative to the window.
- * @param clip The portion of the texture to be rendered. Defaults to NULL (i.e. render the whole texture).
- * @param angle Rotation of the texture around the centre. Defaults to 0.0 (i.e. no rotation).
- * @param center Centre of rotation. Defaults to NULL (i.e. top left corner).
- * @param flip Texture flipping. Defaults to SDL_FLIP_NONE (i.e. no flipping).
- **/
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
-
-
 /**
  * @brief Starts up SDL and creates window
  *
@@ -371,6 +141,9 @@ static bool init(void)
       {
         printf( "\nRenderer created" );
 
+        // Renderer of the textures of Engine_Lib
+        LTexture::SetDefaultRenderer( gRenderer );
+
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -415,6 +188,14 @@ static bool loadMedia(void)
   else
   {
     printf( "\nBackground texture loaded" );
+
+    // Far layer: the whole image, over the whole window
+    gBackground.addLayer( gBGTexture, SDL_Rect{ 0, 0, WINDOW_W, WINDOW_H }, BG_FAR_FACTOR );
+
+    // Near layer: the bottom of the same image, over the bottom of the window, scrolling faster
+    const SDL_Rect NearClip{ 0, gBGTexture.getHeight() - BG_NEAR_H, gBGTexture.getWidth(), BG_NEAR_H };
+
+    gBackground.addLayer( gBGTexture, SDL_Rect{ 0, WINDOW_H - BG_NEAR_H, WINDOW_W, BG_NEAR_H }, BG_NEAR_FACTOR, 0.0f, &NearClip );
   }
 
   return success;
@@ -424,6 +205,7 @@ static bool loadMedia(void)
 static void close(void)
 {
   // Free loaded images
+  gBackground.clear();
   gBGTexture.free();
 
   // Destroy window
@@ -489,9 +271,6 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
-      // The background scrolling offset
-      int scrollingOffset = 0;
-
       // While application is running
       while( !quit )
       {
@@ -506,22 +285,15 @@ int main( int argc, char* args[] )
           else { /* ignore event */ }
         }
 
-        // Scroll background and reset when completely off screen
-        --scrollingOffset;
-
-        if( scrollingOffset < -gBGTexture.getWidth() )
-        {
-          scrollingOffset = 0;
-        }
-        else { /* Not completely off screen yet */ }
+        // Scroll background: the layers keep their offsets wrapped, with the fractions of a pixel
+        gBackground.scroll( BG_SCROLL_SPEED );
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
-        // Render background
-        gBGTexture.render( scrollingOffset                        , 0 );
-        gBGTexture.render( scrollingOffset + gBGTexture.getWidth(), 0 );
+        // Render background: each layer is cut into the pieces of the image that cover it once
+        gBackground.render( gBatch, gRenderer );
 
         // Update screen
         SDL_RenderPresent( gRenderer );
@@ -33,6 +33,21 @@
  * At the end of the main loop we render the prompt text and the input text. Once we're done with
  * text input we disable it, since enabling text input introduces some overhead.
  *
+ * Aggiunta GS: il prompt passa da "LTextCache" di Engine_Lib, che tiene la texture di ogni stringa
+ * già disegnata; è statico, quindi non viene mai scartato. Il testo inserito è un "LTextField" di
+ * Engine_Lib, che non rasterizza più l'intera stringa a ogni tasto: ogni glifo viene rasterizzato
+ * una sola volta, la prima volta che compare, in un "LGlyphAtlas", e ogni riga tiene la posizione
+ * dei suoi glifi. Un carattere scritto o cancellato aggiunge o toglie un glifo in fondo all'ultima
+ * riga, e un incollaggio dispone solo il testo che aggiunge, in tempo lineare anche per testi di
+ * molti KB; vengono disegnate, con una sola chiamata, solo le righe che entrano nella finestra. Il
+ * flag "renderText" e il trucco dello spazio per la stringa vuota non servono più.
+ *
+ * Aggiunta GS: l'atlante accetta qualsiasi carattere Unicode, non solo Latin-1, e lo dispone con un
+ * "skyline" su più pagine, create quando servono fino a un massimo; quando sono tutte piene, la
+ * pagina usata meno di recente viene svuotata e i suoi glifi vengono rasterizzati di nuovo se
+ * ricompaiono. Così un testo CJK occupa al più le pagine previste. "nextFrame", a ogni frame,
+ * protegge dallo svuotamento le pagine dei glifi già disegnati nel frame.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -49,6 +64,9 @@
 #include <string>
 #include <sstream>
 
+#include "LTextCache.hpp"
+#include "LTextField.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -80,57 +98,6 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 static const std::string FontPath("lazy.ttf");
 
 
-/***************************************************************************************************
-* Classes
-****************************************************************************************************/
-
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
-
-  // Loads image at specified path
-  bool loadFromFile( const std::string& );
-
-  #if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-  #endif
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-  void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Gets image dimensions
-  int getWidth (void) const;
-  int getHeight(void) const;
-
-  private:
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
-
-
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
@@ -150,198 +117,19 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Globally used font
 static TTF_Font *gFont = NULL;
 
-// Scene textures
-static LTexture gPromptTextTexture;
-static LTexture gInputTextTexture;
+// The prompt is rendered once and kept
+static LTextCache         gTextCache;
+static const LCachedText* gPromptText = NULL;
+
+// The input text, laid out glyph by glyph from an atlas of the font
+static LGlyphAtlas gInputAtlas;
+static LTextField  gInputField( gInputAtlas );
 
 
 /***************************************************************************************************
-* Methods definitions
+* Private functions definitions
 ****************************************************************************************************/
 
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", path.c_str() );
-
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
-
-    // Create texture from surface pixels
-    newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
-
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", path.c_str() );
-
-      // Get image dimensions
-      mWidth  = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
-
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-    mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-void LTexture::free(void)
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
-
-
 /**
  * @brief Starts up SDL and creates window
  *
@@ -397,6 +185,9 @@ static bool init(void)
       {
         printf( "\nRenderer created" );
 
+        // Text textures are created for this renderer
+        gTextCache.setRenderer( gRenderer );
+
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -459,7 +250,9 @@ static bool loadMedia(void)
     // Render the prompt
     SDL_Color textColor = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 
-    if( !gPromptTextTexture.loadFromRenderedText( "Enter Text:", textColor ) )
+    gPromptText = gTextCache.get( gFont, "Enter Text:", textColor, true );
+
+    if( gPromptText == NULL )
     {
       printf( "\nFailed to render prompt text!\n" );
       success = false;
@@ -468,6 +261,17 @@ static bool loadMedia(void)
     {
       printf( "\nPrompt text rendered\n" );
     }
+
+    // Glyphs of the input text are rasterised as they are first typed
+    if( !gInputAtlas.create( gFont, gRenderer ) )
+    {
+      printf( "\nFailed to create the glyph atlas!\n" );
+      success = false;
+    }
+    else
+    {
+      printf( "\nGlyph atlas created\n" );
+    }
   }
 
   return success;
@@ -476,9 +280,12 @@ static bool loadMedia(void)
 
 static void close(void)
 {
-  // Free loaded images
-  gPromptTextTexture.free();
-  gInputTextTexture.free();
+  // Free text textures
+  gTextCache.clear();
+  gPromptText = NULL;
+  gInputField.clear();
+  printf( "\nGlyph atlas: %zu glyphs in %d pages, %zu pages evicted", gInputAtlas.GetCount(), gInputAtlas.GetPageCount(), gInputAtlas.GetEvictions() );
+  gInputAtlas.free();
 
   // Free global font
   TTF_CloseFont( gFont );
@@ -551,9 +358,11 @@ int main( int argc, char* args[] )
       // Set text color as black
       SDL_Color textColor = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 
-      // The current input text
-      std::string inputText = "Some Text";
-      gInputTextTexture.loadFromRenderedText( inputText.c_str(), textColor );
+      // The current input text, centred below the prompt
+      gInputField.setArea( SDL_Rect{ 0, gPromptText->Height, SCREEN_W, SCREEN_H - gPromptText->Height } );
+      gInputField.setColour( textColor );
+      gInputField.setCentered( true );
+      gInputField.setText( "Some Text" );
 
       // Enable text input
       SDL_StartTextInput();
@@ -561,8 +370,8 @@ int main( int argc, char* args[] )
       // While application is running
       while( !quit )
       {
-        // The rerender text flag
-        bool renderText = false;
+        // The glyphs not drawn since the last frame can be evicted
+        gInputAtlas.nextFrame();
 
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
@@ -576,22 +385,23 @@ int main( int argc, char* args[] )
           else if( e.type == SDL_KEYDOWN )
           {
             // Handle backspace
-            if( e.key.keysym.sym == SDLK_BACKSPACE && inputText.length() > 0 )
+            if( e.key.keysym.sym == SDLK_BACKSPACE )
             {
               // lop off character
-              inputText.pop_back();
-              renderText = true;
+              gInputField.backspace();
             }
             // Handle copy
             else if( e.key.keysym.sym == SDLK_c && SDL_GetModState() & KMOD_CTRL )
             {
-              SDL_SetClipboardText( inputText.c_str() );
+              SDL_SetClipboardText( gInputField.getText().c_str() );
             }
             // Handle paste
             else if( e.key.keysym.sym == SDLK_v && SDL_GetModState() & KMOD_CTRL )
             {
-              inputText = SDL_GetClipboardText();
-              renderText = true;
+              char* clipboardText = SDL_GetClipboardText();
+
+              gInputField.setText( clipboardText );
+              SDL_free( clipboardText );
             }
           }
           // Special text input event
@@ -601,37 +411,19 @@ int main( int argc, char* args[] )
             if( !( SDL_GetModState() & KMOD_CTRL && ( e.text.text[ 0 ] == 'c' || e.text.text[ 0 ] == 'C' || e.text.text[ 0 ] == 'v' || e.text.text[ 0 ] == 'V' ) ) )
             {
               // Append character
-              inputText += e.text.text;
-              renderText = true;
+              gInputField.append( e.text.text );
             }
           }
         }
 
-        // Rerender text if needed
-        if( renderText )
-        {
-          // Text is not empty
-          if( inputText != "" )
-          {
-            // Render new text
-            gInputTextTexture.loadFromRenderedText( inputText.c_str(), textColor );
-          }
-          // Text is empty
-          else
-          {
-            // Render space texture
-            gInputTextTexture.loadFromRenderedText( " ", textColor );
-          }
-        }
-        else { /* No need to render text */ }
-
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
         // Render text textures
-        gPromptTextTexture.render( ( SCREEN_W - gPromptTextTexture.getWidth() ) / 2, 0 );
-        gInputTextTexture.render(  ( SCREEN_W - gInputTextTexture.getWidth()  ) / 2, gPromptTextTexture.getHeight() );
+        gPromptText->render( gRenderer, ( SCREEN_W - gPromptText->Width ) / 2, 0 );
+
+        gInputField.render( gRenderer );
 
         // Update screen
         SDL_RenderPresent( gRenderer );
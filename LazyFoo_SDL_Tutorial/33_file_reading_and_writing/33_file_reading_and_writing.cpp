@@ -45,6 +45,25 @@
  *
  * At the end of the main loop we render all the textures to the screen.
  *
+ * Aggiunta GS: i dati non sono più scritti e letti un intero alla volta, ma con "LSaveWriter" e
+ * "LSaveReader" di Engine_Lib: un'intestazione con versione dello schema e CRC-32, seguita dai dati,
+ * scritti con una sola scrittura in "nums.bin.tmp", portato su disco e poi rinominato al posto di
+ * "nums.bin". Se il programma si interrompe durante il salvataggio, resta il salvataggio
+ * precedente; un file danneggiato, o scritto nel vecchio formato senza intestazione, viene scartato
+ * e i dati ripartono da zero.
+ *
+ * Aggiunta GS: il salvataggio non avviene più in "close", sul thread principale, ma con "LAutosave"
+ * di Engine_Lib: quando i dati cambiano, al più ogni AUTOSAVE_INTERVAL_ms il ciclo principale ne
+ * copia un'istantanea in un buffer suo e la passa al thread di salvataggio, senza mai attendere il
+ * disco. In uscita resta da scrivere solo ciò che è cambiato dopo l'ultimo salvataggio automatico.
+ *
+ * Aggiunta GS: i testi passano da "LTextCache" di Engine_Lib, che tiene la texture di ogni stringa
+ * già disegnata, per font, colore e testo, scartando quella usata meno di recente quando è piena.
+ * Ogni frame chiede alla cache i valori da mostrare, nel colore giusto: i tasti cambiano solo i
+ * dati, e un valore già visto (es. tornando indietro con LEFT e RIGHT, o spostando l'evidenziazione
+ * con UP e DOWN) non viene più rasterizzato né caricato sulla GPU. Il prompt è statico, quindi non
+ * viene mai scartato.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -61,6 +80,10 @@
 #include <string>
 #include <sstream>
 
+#include "LAutosave.hpp"
+#include "LSaveFile.hpp"
+#include "LTextCache.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -98,60 +121,10 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 static const std::string FontPath("lazy.ttf");
 static const std::string BinaryFileName("nums.bin");
 
-static constexpr int TOTAL_DATA       = 10; // Number of data integers
-static constexpr int WRITE_ONE_OBJECT = 1;  // Number of objects to write in SDL_RWwrite
-static constexpr int READ_ONE_OBJECT  = 1;  // Number of objects to read  in SDL_RWread
-
-
-/***************************************************************************************************
-* Classes
-****************************************************************************************************/
-
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
+static constexpr int    TOTAL_DATA  = 10; // Number of data integers
+static constexpr Uint32 SAVE_SCHEMA = 1;  // Version of the saved data: raise it when the layout changes
 
-  // Loads image at specified path
-  bool loadFromFile( const std::string& );
-
-  #if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-  #endif
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-  void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Gets image dimensions
-  int getWidth (void) const;
-  int getHeight(void) const;
-
-  private:
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
+static constexpr Uint32 AUTOSAVE_INTERVAL_ms = 2000; // Least time between two snapshots
 
 
 /***************************************************************************************************
@@ -160,6 +133,7 @@ class LTexture
 
 static bool init      ( void );
 static bool loadMedia ( void );
+static void saveData  ( void );
 static void close     ( void );
 
 
@@ -173,199 +147,16 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Globally used font
 static TTF_Font* gFont = NULL;
 
-// Scene textures
-static LTexture gPromptTextTexture;
-static LTexture gDataTextures[ TOTAL_DATA ];
+// Every string drawn is kept, so that values seen before are not rendered again
+static LTextCache         gTextCache;
+static const LCachedText* gPromptText = NULL;
 
 // Data points
 static Sint32 gData[ TOTAL_DATA ];
+static bool   gIsDataChanged = false; // Since the last snapshot
 
-
-/***************************************************************************************************
-* Methods definitions
-****************************************************************************************************/
-
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", path.c_str() );
-
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
-
-    // Create texture from surface pixels
-        newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
-
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", path.c_str() );
-
-      // Get image dimensions
-      mWidth  = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
-
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-    mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-void LTexture::free(void)
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
+// Saves snapshots of gData on a thread of its own; not started if gData may not be saved
+static LAutosave gAutosave;
 
 
 /***************************************************************************************************
@@ -427,6 +218,9 @@ static bool init(void)
       {
         printf( "\nRenderer created" );
 
+        // Text textures are created for this renderer
+        gTextCache.setRenderer( gRenderer );
+
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -472,8 +266,7 @@ static bool init(void)
 static bool loadMedia(void)
 {
   // Text rendering color
-  SDL_Color textColor      = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
-  SDL_Color highlightColor = { RED_R, RED_G, RED_B, RED_A };
+  SDL_Color textColor = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 
   // Loading success flag
   bool success = true;
@@ -490,8 +283,10 @@ static bool loadMedia(void)
   {
     printf( "\nLazy font loaded" );
 
-    // Render the prompt
-    if( !gPromptTextTexture.loadFromRenderedText( "Enter Data:", textColor ) )
+    // Render the prompt, once for the whole program
+    gPromptText = gTextCache.get( gFont, "Enter Data:", textColor, true );
+
+    if( gPromptText == NULL )
     {
       printf( "\nFailed to render prompt text!\n" );
       success = false;
@@ -502,93 +297,78 @@ static bool loadMedia(void)
     }
   }
 
-  // Open file for reading in binary
-  SDL_RWops* file = SDL_RWFromFile( BinaryFileName.c_str(), "r+b" );
+  // Load data: a missing file just means this is the first run
+  LSaveReader reader;
+  bool        isSavable = true;
 
-  // File does not exist
-  if( file == NULL )
+  switch( reader.load( BinaryFileName, SAVE_SCHEMA ) )
   {
-    // printf( "\nWarning: Unable to open file! SDL Error: %s", SDL_GetError() ); // Originale
-    printf( "\nCreating new \"%s\" file...", BinaryFileName.c_str() );
-
-    // Create file for writing
-    file = SDL_RWFromFile( BinaryFileName.c_str(), "w+b" );
+    case LSaveReader::Status::LOADED:
+      printf( "\nReading file..." );
 
-    if( file != NULL )
-    {
-      printf( "\nNew file created" );
-
-      // Initialize data
-      for( int i = 0; i < TOTAL_DATA; ++i )
+      if( !reader.readArray( gData, TOTAL_DATA ) )
       {
-        gData[ i ] = 0;
-        SDL_RWwrite( file, &gData[ i ], sizeof(Sint32), WRITE_ONE_OBJECT );
+        printf( "\nWarning: \"%s\" is too short! Starting from zero", BinaryFileName.c_str() );
+        SDL_memset( gData, 0, sizeof(gData) );
       }
-
-      // Close file handler
-      SDL_RWclose( file );
-    }
-    else
-    {
-      printf( "\nError: Unable to create file! SDL Error: %s", SDL_GetError() );
-      success = false;
-    }
-  }
-  // File exists
-  else
-  {
-    // Load data
-    printf( "\nReading file..." );
-
-    for( int i = 0; i != TOTAL_DATA; ++i )
-    {
-      SDL_RWread( file, &gData[ i ], sizeof(Sint32), READ_ONE_OBJECT );
-    }
-
-    // Close file handler
-    SDL_RWclose( file );
+      else
+      {;}
+      break;
+
+    case LSaveReader::Status::NEWER:
+      // Keep it as it is: saving over it would lose what the newer version stored
+      printf( "\nError: Unable to use \"%s\"!", BinaryFileName.c_str() );
+      isSavable = false;
+      success   = false;
+      break;
+
+    default:
+      // Created by the first autosave
+      printf( "\nCreating new \"%s\" file...", BinaryFileName.c_str() );
+      SDL_memset( gData, 0, sizeof(gData) );
+      gIsDataChanged = true;
+      break;
   }
 
-  // Initialize data textures. All'avvio, la prima riga p "highlightColor"; tutte le altre sono "textColor"
-  gDataTextures[ 0 ].loadFromRenderedText( std::to_string( gData[ 0 ] ), highlightColor );
-
-  for( int i = 1; i != TOTAL_DATA; ++i )
+  if( isSavable && !gAutosave.start( BinaryFileName, SAVE_SCHEMA, AUTOSAVE_INTERVAL_ms ) )
   {
-    gDataTextures[ i ].loadFromRenderedText( std::to_string( gData[ i ] ), textColor );
+    printf( "\nError: Unable to start autosaving!" );
+    success = false;
   }
+  else
+  {;}
 
   return success;
 }
 
 
-static void close(void)
+/**
+ * @brief Hands a snapshot of all the data points to the autosave thread, which saves them with a
+ * single write, replacing the file only once the new one is complete. Never waits for the disk.
+ **/
+static void saveData(void)
 {
-  // Open data for writing
-  SDL_RWops* file = SDL_RWFromFile( BinaryFileName.c_str(), "w+b" );
+  gAutosave.GetSnapshot().writeArray( gData, TOTAL_DATA );
+  gAutosave.submit();
+  gIsDataChanged = false;
+}
 
-  if( file != NULL )
-  {
-    // Save data
-    for( int i = 0; i < TOTAL_DATA; ++i )
-    {
-      SDL_RWwrite( file, &gData[ i ], sizeof(Sint32), 1 );
-    }
 
-    // Close file handler
-    SDL_RWclose( file );
-  }
-  else
+static void close(void)
+{
+  // Save what changed since the last autosave, if anything, and wait for it
+  if( gAutosave.IsRunning() && gIsDataChanged )
   {
-    printf( "\nError: Unable to save file! %s", SDL_GetError() );
+    saveData();
   }
+  else
+  {;}
 
-  // Free loaded images
-  gPromptTextTexture.free();
+  gAutosave.stop();
 
-  for( int i = 0; i < TOTAL_DATA; ++i )
-  {
-    gDataTextures[ i ].free();
-  }
+  // Free text textures
+  gTextCache.clear();
+  gPromptText = NULL;
 
   // Free global font
   TTF_CloseFont( gFont );
@@ -682,8 +462,6 @@ int main( int argc, char* args[] )
             {
               // Previous data entry
               case SDLK_UP:
-              // Rerender previous entry input point
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), textColor );
               --currentDataIndex;
 
               if( currentDataIndex < 0 )
@@ -691,15 +469,10 @@ int main( int argc, char* args[] )
                 currentDataIndex = TOTAL_DATA - 1;
               }
               else { /* No wrap-around necessary */ }
-
-              // Re-render current entry input point
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), highlightColor );
               break;
 
               // Next data entry
               case SDLK_DOWN:
-              // Rerender previous entry input point
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), textColor );
               ++currentDataIndex;
 
               if( currentDataIndex == TOTAL_DATA )
@@ -707,36 +480,54 @@ int main( int argc, char* args[] )
                 currentDataIndex = 0;
               }
               else { /* No wrap-around necessary */ }
-
-              // Rerender current entry input point
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), highlightColor );
               break;
 
               // Decrement input point
               case SDLK_LEFT:
               --gData[ currentDataIndex ];
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), highlightColor );
+              gIsDataChanged = true;
               break;
 
               // Increment input point
               case SDLK_RIGHT:
               ++gData[ currentDataIndex ];
-              gDataTextures[ currentDataIndex ].loadFromRenderedText( std::to_string( gData[ currentDataIndex ] ), highlightColor );
+              gIsDataChanged = true;
               break;
             }
           }
         }
 
+        // Snapshot the data once it has changed, at most every AUTOSAVE_INTERVAL_ms
+        if( gIsDataChanged && gAutosave.IsRunning() && gAutosave.IsDue() )
+        {
+          saveData();
+        }
+        else
+        {;}
+
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
         // Render text textures
-        gPromptTextTexture.render( ( SCREEN_W - gPromptTextTexture.getWidth() ) / 2, 0 );
+        gPromptText->render( gRenderer, ( SCREEN_W - gPromptText->Width ) / 2, 0 );
+
+        // The current entry is highlighted. Only values not drawn recently are rendered again
+        int yOffset = gPromptText->Height;
 
         for( int i = 0; i < TOTAL_DATA; ++i )
         {
-          gDataTextures[ i ].render( ( SCREEN_W - gDataTextures[ i ].getWidth() ) / 2, gPromptTextTexture.getHeight() + gDataTextures[ 0 ].getHeight() * i );
+          char dataText[ 16 ];
+          SDL_snprintf( dataText, sizeof( dataText ), "%d", static_cast<int>( gData[ i ] ) );
+
+          const LCachedText* data = gTextCache.get( gFont, dataText, ( i == currentDataIndex ) ? highlightColor : textColor );
+
+          if( data != NULL )
+          {
+            data->render( gRenderer, ( SCREEN_W - data->Width ) / 2, yOffset );
+            yOffset += data->Height;
+          }
+          else { /* The value could not be rendered */ }
         }
 
         // Update screen
@@ -12,6 +12,31 @@
  * why we are going to store the specification we get back from the driver for recording and
  * playback.
  *
+ * Aggiunta GS: i testi passano da "LTextCache" di Engine_Lib, che tiene la texture di ogni stringa
+ * già disegnata, per font, colore e testo. I prompt e i nomi dei dispositivi sono marcati come
+ * statici, quindi non vengono mai scartati: passando da "Recording..." a "Press 1 to play back..."
+ * e viceversa la stringa non viene più né rasterizzata né caricata di nuovo sulla GPU.
+ *
+ * Aggiunta GS: la registrazione non finisce più in un buffer di 6 secondi allocato sullo heap, ma
+ * passa da "LAudioRecorder" di Engine_Lib: la callback copia i campioni in un ring buffer lock-free
+ * senza mai attendere, e un thread li scrive a blocchi in "recording.wav". La registrazione dura
+ * finché non si preme di nuovo 1, con memoria costante; "LAudioPlayer" la riproduce leggendo il file
+ * allo stesso modo. Il titolo della finestra mostra la durata e i byte persi.
+ *
+ * Aggiunta GS: durante la registrazione e la riproduzione, "LAudioAnalyser" di Engine_Lib misura il
+ * livello RMS e di picco dei due canali e lo spettro in 32 bande, su un thread suo. I campioni gli
+ * arrivano dal thread di scrittura o di lettura, mai dalle callback audio, che restano come sono; in
+ * riproduzione l'analisi segue ciò che si sente, non ciò che è stato letto dal file. Le barre sono
+ * disegnate con due sole chiamate a SDL_RenderFillRects.
+ *
+ * Aggiunta GS: il thread di scrittura comprime la registrazione mentre la scrive, nella codifica
+ * RECORDING_ENCODING: IMA ADPCM, 4 bit per campione, occupa un ottavo dei float a 32 bit catturati
+ * (circa 160 MB l'ora in stereo a 44,1 kHz invece di 1,3 GB), PCM a 16 bit la metà, senza perdite
+ * per un microfono a 16 bit. La callback non cambia: copia i float nel ring buffer, e se il thread
+ * resta indietro i campioni che non ci stanno sono scartati e contati, senza mai attenderlo. Il
+ * titolo della finestra mostra anche i byte già scritti nel file; "LAudioPlayer" decodifica il file
+ * mentre lo legge.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -28,6 +53,10 @@
 #include <string>
 #include <sstream>
 
+#include "LAudioAnalyser.hpp"
+#include "LAudioStream.hpp"
+#include "LTextCache.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -64,9 +93,22 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 
 static const std::string FontPath("lazy.ttf");
 
-static const int MAX_RECORDING_DEVICES    = 10; // Maximum number of supported recording devices
-static const int MAX_RECORDING_SECONDS    = 5;  // Maximum recording time
-static const int RECORDING_BUFFER_SECONDS = MAX_RECORDING_SECONDS + 1; // Maximum recording time plus padding
+static const int MAX_RECORDING_DEVICES = 10; // Maximum number of supported recording devices
+
+static const std::string RecordingPath("recording.wav"); // Streamed to while recording, read back while playing
+
+static constexpr LWavEncoding RECORDING_ENCODING = LWavEncoding::IMA_ADPCM; // Compressed by the writer thread
+
+// Level meters and spectrum, below the prompt
+static constexpr int METERS_X       = 20;   // Left edge of the meters and of the spectrum
+static constexpr int METERS_Y       = 80;   // Top of the left meter; the right one is below it
+static constexpr int METER_H        = 20;
+static constexpr int METER_GAP      = 10;
+static constexpr int PEAK_W         = 3;    // Width of the peak mark
+static constexpr int SPECTRUM_BASE  = SCREEN_H - 20;   // Bottom of the spectrum bars
+static constexpr int SPECTRUM_H     = 260;
+static constexpr int BAR_GAP        = 2;    // Between two bands
+static constexpr int NUM_OF_RECTS   = static_cast<int>( LAudioAnalyser::s_NUM_OF_BANDS ) + 2; // Bands and two meters
 
 // The various recording actions we can take
 enum RecordingState
@@ -80,68 +122,14 @@ enum RecordingState
 };
 
 
-/***************************************************************************************************
-* Classes
-****************************************************************************************************/
-
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
-
-  // Loads image at specified path
-  bool loadFromFile( const std::string& );
-
-    #if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-    #endif
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-  void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Gets image dimensions
-  int getWidth (void) const;
-  int getHeight(void) const;
-
-private:
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
-
-
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
 
-static bool init      ( void );
-static bool loadMedia ( void );
-static void close     ( void );
-
-// Recording/playback callbacks
-static void audioRecordingCallback( void* userdata, Uint8* stream, int len );
-static void audioPlaybackCallback ( void* userdata, Uint8* stream, int len );
+static bool init          ( void );
+static bool loadMedia     ( void );
+static void close         ( void );
+static void renderAnalysis( void );
 
 
 /***************************************************************************************************
@@ -155,208 +143,26 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 static TTF_Font* gFont = NULL;
 static SDL_Color gTextColor = { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 
-static LTexture gPromptTexture; // Prompt texture
-static LTexture gDeviceTextures[ MAX_RECORDING_DEVICES ]; // The text textures that specify recording device names
+// Every string is rendered once and kept: the prompts come back at each recording
+static LTextCache         gTextCache;
+static const LCachedText* gPromptText = NULL; // Prompt text
+static const LCachedText* gDeviceTexts[ MAX_RECORDING_DEVICES ] = {}; // The texts that specify recording device names
 
 // Number of available devices
 static int gRecordingDeviceCount = 0;
 
-// Received audio spec
-static SDL_AudioSpec gReceivedRecordingSpec;
-static SDL_AudioSpec gReceivedPlaybackSpec;
+// Recording streamed to disk, and played back from it
+static LAudioRecorder gRecorder;
+static LAudioPlayer   gPlayer;
 
-static Uint8* gRecordingBuffer         = NULL; // Recording data buffer
-static Uint32 gBufferSize_Bytes        = 0;    // Size of data buffer
-static Uint32 gBufferPosition_Bytes    = 0;    // Position in data buffer
-static Uint32 gBufferMaxPosition_Bytes = 0;    // Maximum position in data buffer for recording
+// Fed by the recorder's writer and the player's reader
+static LAudioAnalyser gAnalyser;
 
 
 /***************************************************************************************************
-* Methods definitions
+* Private functions definitions
 ****************************************************************************************************/
 
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", path.c_str() );
-
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
-
-    // Create texture from surface pixels
-    newTexture = SDL_CreateTextureFromSurface( gRenderer, loadedSurface );
-
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", path.c_str() );
-
-      // Get image dimensions
-      mWidth  = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
-
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-    mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-void LTexture::free(void)
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth = 0;
-    mHeight = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
-
-
 /**
  * @brief Starts up SDL and creates window
  *
@@ -412,6 +218,9 @@ static bool init(void)
       {
         printf( "\nRenderer created" );
 
+        // Text textures are created for this renderer
+        gTextCache.setRenderer( gRenderer );
+
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
@@ -472,7 +281,7 @@ static bool loadMedia(void)
     printf( "\nLazy font loaded" );
 
     // Set starting prompt
-    gPromptTexture.loadFromRenderedText( "Select your recording device:", gTextColor );
+    gPromptText = gTextCache.get( gFont, "Select your recording device:", gTextColor, true );
 
     // Get capture device count
     gRecordingDeviceCount = SDL_GetNumAudioDevices( SDL_TRUE );
@@ -503,7 +312,7 @@ static bool loadMedia(void)
         promptText << i << ": " << SDL_GetAudioDeviceName( i, SDL_TRUE );
 
         // Set texture from name
-        gDeviceTextures[ i ].loadFromRenderedText( promptText.str().c_str(), gTextColor );
+        gDeviceTexts[ i ] = gTextCache.get( gFont, promptText.str().c_str(), gTextColor, true );
       }
     }
   }
@@ -515,11 +324,8 @@ static bool loadMedia(void)
 static void close(void)
 {
   // Free textures
-  gPromptTexture.free();
-  for( int i = 0; i != MAX_RECORDING_DEVICES; ++i )
-  {
-    gDeviceTextures[ i ].free();
-  }
+  gTextCache.clear();
+  gPromptText = NULL;
 
   // Free global font
   TTF_CloseFont( gFont );
@@ -531,14 +337,10 @@ static void close(void)
   gRenderer = NULL;
   gWindow   = NULL;
 
-  // Free playback audio
-  if( gRecordingBuffer != NULL )
-  {
-    delete[] gRecordingBuffer;
-    gRecordingBuffer = NULL;
-  }
-  else
-  { /* Nothing to free */ }
+  // Finish the recording, if any, and close the audio devices; then nothing feeds the analyser
+  gRecorder.close();
+  gPlayer.stop();
+  gAnalyser.stop();
 
   // Quit SDL subsystems
   TTF_Quit();
@@ -547,27 +349,41 @@ static void close(void)
 }
 
 
-/***************************************************************************************************
-* Private functions definitions
-****************************************************************************************************/
-
-void audioRecordingCallback([[maybe_unused]] void* userdata, Uint8* stream, int len )
+/**
+ * @brief Draws the level meters and the spectrum of the latest analysis: the bars in one call, the
+ * peak marks in another.
+ **/
+static void renderAnalysis(void)
 {
-  // Copy audio from stream
-  memcpy( &gRecordingBuffer[ gBufferPosition_Bytes ], stream, len );
+  const LAudioAnalyser::Analysis& Latest = gAnalyser.GetLatest();
 
-  // Move along buffer
-  gBufferPosition_Bytes += len;
-}
+  SDL_Rect Bars [ NUM_OF_RECTS ];
+  SDL_Rect Peaks[ 2 ];
 
+  const int MeterW = SCREEN_W - 2 * METERS_X;
 
-void audioPlaybackCallback([[maybe_unused]] void* userdata, Uint8* stream, int len )
-{
-  // Copy audio to stream
-  memcpy( stream, &gRecordingBuffer[ gBufferPosition_Bytes ], len );
+  for( int Channel = 0; Channel != 2; ++Channel )
+  {
+    const int y = METERS_Y + Channel * ( METER_H + METER_GAP );
+
+    Bars [ Channel ] = { METERS_X, y, static_cast<int>( Latest.Rms[ Channel ] * MeterW ), METER_H };
+    Peaks[ Channel ] = { METERS_X + static_cast<int>( Latest.Peak[ Channel ] * ( MeterW - PEAK_W ) ), y, PEAK_W, METER_H };
+  }
+
+  const int BandW = MeterW / static_cast<int>( LAudioAnalyser::s_NUM_OF_BANDS );
+
+  for( size_t Band = 0; Band != LAudioAnalyser::s_NUM_OF_BANDS; ++Band )
+  {
+    const int h = static_cast<int>( Latest.Bands[ Band ] * SPECTRUM_H );
 
-  // Move along buffer
-  gBufferPosition_Bytes += len;
+    Bars[ 2 + Band ] = { METERS_X + static_cast<int>( Band ) * BandW, SPECTRUM_BASE - h, BandW - BAR_GAP, h };
+  }
+
+  SDL_SetRenderDrawColor( gRenderer, CYAN_R, CYAN_G, CYAN_B, CYAN_A );
+  SDL_RenderFillRects( gRenderer, Bars, NUM_OF_RECTS );
+
+  SDL_SetRenderDrawColor( gRenderer, RED_R, RED_G, RED_B, RED_A );
+  SDL_RenderFillRects( gRenderer, Peaks, 2 );
 }
 
 
@@ -627,10 +443,6 @@ int main( int argc, char* args[] )
       // Set the default recording state
       RecordingState currentState = SELECTING_DEVICE;
 
-      // Audio device IDs
-      SDL_AudioDeviceID recordingDeviceId = 0;
-      SDL_AudioDeviceID playbackDeviceId = 0;
-
       // While application is running
       while( !quit )
       {
@@ -661,74 +473,26 @@ int main( int argc, char* args[] )
                   // Index is valid
                   if( index != gRecordingDeviceCount )
                   {
-                    // Default audio spec
-                    SDL_AudioSpec desiredRecordingSpec;
-                    SDL_zero(desiredRecordingSpec);
-                    desiredRecordingSpec.freq     = 44100;
-                    desiredRecordingSpec.format   = AUDIO_F32;
-                    desiredRecordingSpec.channels = 2;
-                    desiredRecordingSpec.samples  = 4096;
-                    desiredRecordingSpec.callback = audioRecordingCallback;
-
-                    // Open recording device
-                    recordingDeviceId = SDL_OpenAudioDevice( SDL_GetAudioDeviceName( index, SDL_TRUE ), SDL_TRUE, &desiredRecordingSpec, &gReceivedRecordingSpec, SDL_AUDIO_ALLOW_FORMAT_CHANGE );
-
-                    // Device failed to open
-                    if( recordingDeviceId == 0 )
+                    // Open recording device, float stereo as it goes in the file. The playback
+                    // device is opened by the player, for each playback
+                    if( !gRecorder.open( SDL_GetAudioDeviceName( index, SDL_TRUE ) ) )
                     {
                       // Report error
-                      printf( "\nFailed to open recording device! SDL Error: \"%s\"", SDL_GetError() );
-                      gPromptTexture.loadFromRenderedText( "Failed to open recording device!", gTextColor );
+                      gPromptText = gTextCache.get( gFont, "Failed to open recording device!", gTextColor, true );
                       currentState = ERROR;
                       HasProgramSucceeded = false;
                     }
                     // Device opened successfully
                     else
                     {
-                      // Default audio spec
-                      SDL_AudioSpec desiredPlaybackSpec;
-                      SDL_zero(desiredPlaybackSpec);
-                      desiredPlaybackSpec.freq     = 44100;
-                      desiredPlaybackSpec.format   = AUDIO_F32;
-                      desiredPlaybackSpec.channels = 2;
-                      desiredPlaybackSpec.samples  = 4096;
-                      desiredPlaybackSpec.callback = audioPlaybackCallback;
-
-                      // Open playback device
-                      playbackDeviceId = SDL_OpenAudioDevice( NULL, SDL_FALSE, &desiredPlaybackSpec, &gReceivedPlaybackSpec, SDL_AUDIO_ALLOW_FORMAT_CHANGE );
-
-                      // Device failed to open
-                      if( playbackDeviceId == 0 )
-                      {
-                        // Report error
-                        printf( "\nFailed to open playback device! SDL Error: \"%s\"", SDL_GetError() );
-                        gPromptTexture.loadFromRenderedText( "Failed to open playback device!", gTextColor );
-                        currentState = ERROR;
-                        HasProgramSucceeded = false;
-                      }
-                      // Device opened successfully
-                      else
-                      {
-                        // Calculate per sample bytes
-                        int bytesPerSample = gReceivedRecordingSpec.channels * ( SDL_AUDIO_BITSIZE( gReceivedRecordingSpec.format ) / 8 );
-
-                        // Calculate bytes per second
-                        int bytesPerSecond = gReceivedRecordingSpec.freq * bytesPerSample;
-
-                        // Calculate buffer size
-                        gBufferSize_Bytes = RECORDING_BUFFER_SECONDS * bytesPerSecond;
-
-                        // Calculate max buffer use
-                        gBufferMaxPosition_Bytes = MAX_RECORDING_SECONDS * bytesPerSecond;
-
-                        // Allocate and initialize byte buffer
-                        gRecordingBuffer = new Uint8[ gBufferSize_Bytes ];
-                        memset( gRecordingBuffer, 0, gBufferSize_Bytes );
-
-                        // Go on to next state
-                        gPromptTexture.loadFromRenderedText("Press 1 to record for 5 seconds.", gTextColor);
-                        currentState = STOPPED;
-                      }
+                      // Both feed the analyser from their own threads, never from the callbacks
+                      gRecorder.setAnalyser( &gAnalyser );
+                      gPlayer.setAnalyser( &gAnalyser );
+                      gAnalyser.start();
+
+                      // Go on to next state
+                      gPromptText = gTextCache.get( gFont, "Press 1 to record.", gTextColor, true );
+                      currentState = STOPPED;
                     }
                   }
                   else
@@ -749,17 +513,40 @@ int main( int argc, char* args[] )
                 // Start recording
                 if( e.key.keysym.sym == SDLK_1 )
                 {
-                  // Go back to beginning of buffer
-                  gBufferPosition_Bytes = 0;
+                  if( gRecorder.start( RecordingPath, RECORDING_ENCODING ) )
+                  {
+                    // Go on to next state
+                    gPromptText = gTextCache.get( gFont, "Recording... Press 1 to stop.", gTextColor, true );
+                    currentState = RECORDING;
+                  }
+                  else
+                  {
+                    gPromptText = gTextCache.get( gFont, "Failed to start recording!", gTextColor, true );
+                    currentState = ERROR;
+                    HasProgramSucceeded = false;
+                  }
+                }
+                else {;}
+              }
+              else {;}
+              break;
 
-                  // Start recording
-                  SDL_PauseAudioDevice( recordingDeviceId, SDL_FALSE );
+            // User is recording, for as long as they like
+            case RECORDING:
 
-                  // Go on to next state
-                  gPromptTexture.loadFromRenderedText( "Recording...", gTextColor );
-                  currentState = RECORDING;
+              // On key press
+              if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_1 )
+              {
+                // Stop recording: the writer thread flushes what is left and completes the file
+                if( !gRecorder.stop() )
+                {
+                  HasProgramSucceeded = false;
                 }
                 else {;}
+
+                // Go on to next state
+                gPromptText = gTextCache.get( gFont, "Press 1 to play back. Press 2 to record again.", gTextColor, true );
+                currentState = RECORDED;
               }
               else {;}
               break;
@@ -773,34 +560,39 @@ int main( int argc, char* args[] )
                 // Start playback
                 if( e.key.keysym.sym == SDLK_1 )
                 {
-                  // Go back to beginning of buffer
-                  gBufferPosition_Bytes = 0;
-
-                  // Start playback
-                  SDL_PauseAudioDevice( playbackDeviceId, SDL_FALSE );
-
-                  // Go on to next state
-                  gPromptTexture.loadFromRenderedText( "Playing...", gTextColor );
-                  currentState = PLAYBACK;
+                  if( gPlayer.start( RecordingPath ) )
+                  {
+                    // Go on to next state
+                    gPromptText = gTextCache.get( gFont, "Playing...", gTextColor, true );
+                    currentState = PLAYBACK;
+                  }
+                  else
+                  {
+                    gPromptText = gTextCache.get( gFont, "Failed to play back!", gTextColor, true );
+                    currentState = ERROR;
+                    HasProgramSucceeded = false;
+                  }
                 }
-                // Record again
-                if( e.key.keysym.sym == SDLK_2 )
+                // Record again, over the same file
+                else if( e.key.keysym.sym == SDLK_2 )
                 {
-                  // Reset the buffer
-                  gBufferPosition_Bytes = 0;
-                  memset( gRecordingBuffer, 0, gBufferSize_Bytes );
-
-                  // Start recording
-                  SDL_PauseAudioDevice( recordingDeviceId, SDL_FALSE );
-
-                  // Go on to next state
-                  gPromptTexture.loadFromRenderedText( "Recording...", gTextColor );
-                  currentState = RECORDING;
+                  if( gRecorder.start( RecordingPath, RECORDING_ENCODING ) )
+                  {
+                    // Go on to next state
+                    gPromptText = gTextCache.get( gFont, "Recording... Press 1 to stop.", gTextColor, true );
+                    currentState = RECORDING;
+                  }
+                  else
+                  {
+                    gPromptText = gTextCache.get( gFont, "Failed to start recording!", gTextColor, true );
+                    currentState = ERROR;
+                    HasProgramSucceeded = false;
+                  }
                 }
+                else {;}
               }
               break;
 
-            case RECORDING:
             case PLAYBACK:
             case ERROR:
             default:
@@ -809,47 +601,30 @@ int main( int argc, char* args[] )
           }
         }
 
-        // Updating recording
+        // Updating recording: length and losses in the title, since the text changes every frame
         if( currentState == RECORDING )
         {
-          // Lock callback
-          SDL_LockAudioDevice( recordingDeviceId );
+          char Title[ 128 ];
 
-          // Finished recording
-          if( gBufferPosition_Bytes > gBufferMaxPosition_Bytes )
-          {
-            // Stop recording audio
-            SDL_PauseAudioDevice( recordingDeviceId, SDL_TRUE );
-
-            // Go on to next state
-            gPromptTexture.loadFromRenderedText( "Press 1 to play back. Press 2 to record again.", gTextColor );
-            currentState = RECORDED;
-          }
-          else { /* Not finished recording yet */ }
-
-          // Unlock callback
-          SDL_UnlockAudioDevice( recordingDeviceId );
+          snprintf( Title, sizeof( Title ), "SDL Tutorial - Recording %.1f s, %llu KB written, %llu bytes dropped",
+                    gRecorder.GetSeconds(), static_cast<unsigned long long>( gRecorder.GetFileBytes() / 1024 ),
+                    static_cast<unsigned long long>( gRecorder.GetDropped() ) );
+          SDL_SetWindowTitle( gWindow, Title );
         }
         // Updating playback
         else if( currentState == PLAYBACK )
         {
-          // Lock callback
-          SDL_LockAudioDevice( playbackDeviceId );
-
           // Finished playback
-          if( gBufferPosition_Bytes > gBufferMaxPosition_Bytes )
+          if( gPlayer.IsFinished() )
           {
             // Stop playing audio
-            SDL_PauseAudioDevice( playbackDeviceId, SDL_TRUE );
+            gPlayer.stop();
 
             // Go on to next state
-            gPromptTexture.loadFromRenderedText( "Press 1 to play back. Press 2 to record again.", gTextColor );
+            gPromptText = gTextCache.get( gFont, "Press 1 to play back. Press 2 to record again.", gTextColor, true );
             currentState = RECORDED;
           }
           else { /* Still playing back */ }
-
-          // Unlock callback
-          SDL_UnlockAudioDevice( playbackDeviceId );
         }
 
         // Clear screen
@@ -857,20 +632,34 @@ int main( int argc, char* args[] )
         SDL_RenderClear( gRenderer );
 
         // Render prompt centered at the top of the screen
-        gPromptTexture.render( ( SCREEN_W - gPromptTexture.getWidth() ) / 2, 0 );
+        if( gPromptText != NULL )
+        {
+          gPromptText->render( gRenderer, ( SCREEN_W - gPromptText->Width ) / 2, 0 );
+        }
+        else { /* The prompt could not be rendered */ }
 
         // User is selecting
-        if( currentState == SELECTING_DEVICE )
+        if( currentState == SELECTING_DEVICE && gPromptText != NULL )
         {
           // Render device names
-          int yOffset = gPromptTexture.getHeight() * 2;
+          int yOffset = gPromptText->Height * 2;
 
           for( int i = 0; i != gRecordingDeviceCount; ++i )
           {
-            gDeviceTextures[ i ].render( 0, yOffset );
-            yOffset += gDeviceTextures[ i ].getHeight() + 1;
+            if( gDeviceTexts[ i ] != NULL )
+            {
+              gDeviceTexts[ i ]->render( gRenderer, 0, yOffset );
+              yOffset += gDeviceTexts[ i ]->Height + 1;
+            }
+            else { /* The name could not be rendered */ }
           }
         }
+        // Meters and spectrum of what is being recorded or played
+        else if( currentState == RECORDING || currentState == PLAYBACK )
+        {
+          renderAnalysis();
+        }
+        else {;}
 
         // Update screen
         SDL_RenderPresent( gRenderer );
@@ -28,6 +28,12 @@
  *   prestiamo attenzione a non renderizzare quando la finestre è minimizzata, perché ciò può
  *   provocare dei bachi.
  *
+ * Aggiunta GS: la decisione se disegnare passa da "LWindowManager" di Engine_Lib, che segue gli
+ * eventi della finestra: niente disegno né present da nascosta, minimizzata o di dimensione nulla,
+ * BACKGROUND_RATE frame al secondo senza il focus della tastiera, ogni frame con il focus, e subito
+ * dopo un EXPOSED o un ridimensionamento. Da minimizzata, il ciclo principale non gira più a vuoto:
+ * dorme in "waitEvent" fino all'evento successivo.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -44,6 +50,8 @@
 #include <string>
 #include <sstream>
 
+#include "LWindowManager.hpp"
+
 
 /**************************************************************************************************
 * Private constants
@@ -54,6 +62,8 @@ static constexpr int FIRST_ONE = -1;
 static constexpr int WINDOW_W = 640; // Screen's width
 static constexpr int WINDOW_H = 480; // Screen's heigth
 
+static constexpr double BACKGROUND_RATE = 5.0; // Frames per second without keyboard focus
+
 // Colore bianco
 static constexpr int WHITE_R = 0xFF; // Amount of red   needed to compose white
 static constexpr int WHITE_G = 0xFF; // Amount of green needed to compose white
@@ -161,6 +171,9 @@ class LWindow
   bool hasKeyboardFocus(void) const;
   bool isMinimized(void) const;
 
+  // Whether to render this frame
+  bool shouldRender(void);
+
   private:
 
   // Window data
@@ -191,8 +204,9 @@ static void close     ( void );
 * Private global variables
 ****************************************************************************************************/
 
-static LWindow       gWindow;          // Our custom window
-static SDL_Renderer* gRenderer = NULL; // The window renderer
+static LWindow        gWindow;          // Our custom window
+static LWindowManager gWindowManager;   // When the window is worth a frame
+static SDL_Renderer*  gRenderer = NULL; // The window renderer
 
 // Scene textures
 static LTexture gSceneTexture;
@@ -415,6 +429,9 @@ bool LWindow::init(void)
     mWidth          = WINDOW_W;
     mHeight         = WINDOW_H;
     printf("\nOK: window initialised");
+
+    // Rendered only when visible from now on
+    gWindowManager.add( mWindow );
   }
   else
   {
@@ -441,16 +458,11 @@ void LWindow::handleEvent( SDL_Event& e )
 
     switch( e.window.event )
     {
-      // Get new dimensions and repaint on window size change
+      // Get new dimensions on window size change; the window manager repaints on the next frame,
+      // as on exposure
       case SDL_WINDOWEVENT_SIZE_CHANGED:
         mWidth  = e.window.data1;
         mHeight = e.window.data2;
-        SDL_RenderPresent( gRenderer );
-        break;
-
-      // Repaint on exposure
-      case SDL_WINDOWEVENT_EXPOSED:
-        SDL_RenderPresent( gRenderer );
         break;
 
       // Mouse entered window
@@ -528,6 +540,7 @@ void LWindow::free(void)
 {
   if( mWindow != NULL )
   {
+    gWindowManager.remove( mWindow );
     SDL_DestroyWindow( mWindow );
   }
 
@@ -568,6 +581,12 @@ bool LWindow::isMinimized(void) const
 }
 
 
+bool LWindow::shouldRender(void)
+{
+  return gWindowManager.shouldRender( mWindow );
+}
+
+
 /***************************************************************************************************
 * Private functions definitions
 ****************************************************************************************************/
@@ -733,6 +752,8 @@ int main( int argc, char* args[] )
     {
       printf( "\nOK: all media loaded" );
 
+      gWindowManager.setBackgroundRate( BACKGROUND_RATE );
+
       // Main loop flag
       bool quit = false;
 
@@ -742,8 +763,8 @@ int main( int argc, char* args[] )
       // While application is running
       while( !quit )
       {
-        // Handle events on queue
-        while( SDL_PollEvent( &e ) != 0 )
+        // Handle events on queue, sleeping first while the window needs no frame
+        for( bool hasEvent = gWindowManager.waitEvent( e ); hasEvent; hasEvent = ( SDL_PollEvent( &e ) != 0 ) )
         {
           // User requests quit
           if( e.type == SDL_QUIT )
@@ -754,10 +775,11 @@ int main( int argc, char* args[] )
           { /* Continue until QUIT event */ }
 
           // Handle window events
+          gWindowManager.handleEvent( e );
           gWindow.handleEvent( e );
         }
 
-        if( !gWindow.isMinimized() )
+        if( gWindow.shouldRender() )
         {
           // Clear screen
           SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
@@ -770,7 +792,7 @@ int main( int argc, char* args[] )
           // Update screen
           SDL_RenderPresent( gRenderer );
         }
-        else { /* Only draw when not minimised */ }
+        else { /* Only draw when visible, and in the background only at BACKGROUND_RATE */ }
       }
 
     } // All media loaded
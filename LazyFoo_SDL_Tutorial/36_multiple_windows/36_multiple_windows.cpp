@@ -42,6 +42,23 @@
  * - Next we render all the windows and then go through all the windows to check if any of them are
  *   shown. If all of them have been closed out we set the quit flag to true to end the program.
  *
+ * Aggiunta GS: le finestre non vengono più ridisegnate tutte a ogni ciclo. "LWindowManager" di
+ * Engine_Lib segue i loro eventi e decide quali disegnare: nessun disegno né present per quelle
+ * nascoste, minimizzate o di dimensione nulla; ogni frame per quella con il focus della tastiera;
+ * BACKGROUND_RATE frame al secondo per le altre; subito per quelle da ridisegnare (EXPOSED,
+ * ridimensionate, ripristinate). Quando nessuna finestra ha bisogno di un frame, il ciclo principale
+ * dorme in "waitEvent" invece di girare a vuoto.
+ *
+ * Aggiunta GS: ogni finestra disegna al centro la stessa texture, una scacchiera generata all'avvio.
+ * Di norma ogni finestra ha il suo SDL_Renderer, e la texture va caricata una volta per renderer:
+ * la memoria video cresce con il numero di finestre. Con l'argomento "--shared" le finestre sono
+ * invece create con SDL_WINDOW_OPENGL e condividono un solo contesto OpenGL, creato sulla prima:
+ * la texture è caricata una volta sola e campionata da tutte. Ogni finestra ha comunque la sua
+ * superficie di presentazione: "render" rende corrente il contesto sulla finestra con
+ * "SDL_GL_MakeCurrent", imposta viewport e proiezione sulle sue dimensioni, disegna e chiama
+ * "SDL_GL_SwapWindow" per quella finestra. Alla chiusura il programma stampa quante volte la
+ * texture è stata caricata.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022) and may not be
  * redistributed without written permission.
  **/
@@ -53,9 +70,14 @@
 
 // Using SDL, standard I/O, strings, and string streams
 #include <SDL.h>
+#include <SDL_opengl.h>
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <string.h>
+#include <vector>
+
+#include "LWindowManager.hpp"
 
 
 /**************************************************************************************************
@@ -94,6 +116,15 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 // Total windows
 static constexpr int TOTAL_WINDOWS = 3;
 
+static constexpr double BACKGROUND_RATE = 5.0; // Frames per second of the windows without focus
+
+// Texture shown by every window
+static constexpr int CHECKER_SIZE   = 64;  // Pixels per side
+static constexpr int CHECKER_SQUARE = 8;   // Pixels per side of a square
+static constexpr int CHECKER_SCALE  = 4;   // Drawn this many times bigger
+
+static constexpr char SHARED_CONTEXT_ARGUMENT[] = "--shared";
+
 /***************************************************************************************************
 * Classes
 ****************************************************************************************************/
@@ -121,6 +152,9 @@ class LWindow
   // Deallocates internals
   void free(void);
 
+  // Window handle
+  SDL_Window* getWindow(void) const;
+
   // Window dimensions
   int getWidth(void) const;
   int getHeight(void) const;
@@ -135,7 +169,8 @@ class LWindow
 
   // Window data
   SDL_Window*   mWindow;
-  SDL_Renderer* mRenderer;
+  SDL_Renderer* mRenderer;   // NULL with the shared context
+  SDL_Texture*  mTexture;    // This renderer's copy of the checkerboard
   Uint32        mWindowID;
 
   // Window dimensions
@@ -155,8 +190,10 @@ class LWindow
 * Private prototypes
 ****************************************************************************************************/
 
-static bool init (void);
-static void close(void);
+static bool init    (void);
+static bool initGL  (void);
+static void close   (void);
+static void makeCheckerboard(void);
 
 
 /***************************************************************************************************
@@ -165,6 +202,15 @@ static void close(void);
 
 LWindow gWindows[ TOTAL_WINDOWS ]; // Our custom windows
 
+static LWindowManager gWindowManager; // Which windows to render, and when to sleep
+
+// Shared resources
+static bool               gUseSharedContext = false; // One OpenGL context for all windows
+static SDL_GLContext      gContext          = NULL;  // Created on the first window
+static GLuint             gTexture          = 0;     // The checkerboard, in the shared context
+static std::vector<Uint8> gCheckerboard;             // RGBA pixels
+static int                gTextureUploads   = 0;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -176,6 +222,7 @@ LWindow gWindows[ TOTAL_WINDOWS ]; // Our custom windows
 LWindow::LWindow(void)
   : mWindow(NULL),
     mRenderer(NULL),
+    mTexture(NULL),
     mWindowID (1),
     mWidth(0),
     mHeight(0),
@@ -193,7 +240,10 @@ bool LWindow::init(void)
   mWindow = SDL_CreateWindow(  "SDL Tutorial",
                                 SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
                                 WINDOW_W, WINDOW_H,
-                                SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE );
+                                SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | ( gUseSharedContext ? SDL_WINDOW_OPENGL : 0 ) );
+
+  // Whether the window can be drawn to
+  bool isReady = false;
 
   if( mWindow != NULL )
   {
@@ -203,27 +253,73 @@ bool LWindow::init(void)
     mHeight         = WINDOW_H;
     printf("\nOK: window initialised");
 
-    // Create renderer for window
-    mRenderer = SDL_CreateRenderer( mWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
-
-    if( mRenderer == NULL )
+    if( gUseSharedContext )
     {
-      printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
-      SDL_DestroyWindow( mWindow );
-      mWindow = NULL;
+      // The first window creates the context; the others draw with it
+      if( gContext == NULL )
+      {
+        gContext = SDL_GL_CreateContext( mWindow );
+
+        if( gContext == NULL )
+        {
+          printf( "\nOpenGL context could not be created! SDL Error: %s", SDL_GetError() );
+        }
+        else
+        {
+          printf( "\nOK: shared OpenGL context created" );
+          isReady = initGL();
+        }
+      }
+      else
+      {
+        isReady = true;
+      }
     }
     else
     {
-      printf( "\nOK: renderer created" );
+      // Create renderer for window
+      mRenderer = SDL_CreateRenderer( mWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
 
-      // Initialize renderer color
-      SDL_SetRenderDrawColor( mRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+      if( mRenderer == NULL )
+      {
+        printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
+      }
+      else
+      {
+        printf( "\nOK: renderer created" );
 
+        // Initialize renderer color
+        SDL_SetRenderDrawColor( mRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+
+        // Every renderer needs its own copy of the texture
+        mTexture = SDL_CreateTexture( mRenderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, CHECKER_SIZE, CHECKER_SIZE );
+
+        if( mTexture == NULL || SDL_UpdateTexture( mTexture, NULL, gCheckerboard.data(), CHECKER_SIZE * 4 ) != 0 )
+        {
+          printf( "\nTexture could not be uploaded! SDL Error: %s", SDL_GetError() );
+        }
+        else
+        {
+          ++gTextureUploads;
+          isReady = true;
+        }
+      }
+    }
+
+    if( !isReady )
+    {
+      free();
+    }
+    else
+    {
       // Grab window identifier
       mWindowID = SDL_GetWindowID( mWindow );
 
       // Flag as opened
       mShown = true;
+
+      // Rendered only when visible from now on
+      gWindowManager.add( mWindow );
     }
   }
   else
@@ -231,7 +327,7 @@ bool LWindow::init(void)
     printf( "\nWindow could not be created! SDL Error: \"%s\"\n", SDL_GetError() );
   }
 
-  return mWindow != NULL && mRenderer != NULL;
+  return isReady;
 }
 
 
@@ -255,16 +351,10 @@ void LWindow::handleEvent( SDL_Event& e )
       mShown = false;
       break;
 
-      // Get new dimensions and repaint
+      // Get new dimensions; the window manager repaints on the next frame, as on expose
       case SDL_WINDOWEVENT_SIZE_CHANGED:
       mWidth = e.window.data1;
       mHeight = e.window.data2;
-      SDL_RenderPresent( mRenderer );
-      break;
-
-      // Repaint on expose
-      case SDL_WINDOWEVENT_EXPOSED:
-      SDL_RenderPresent( mRenderer );
       break;
 
       // Mouse enter
@@ -341,24 +431,83 @@ void LWindow::focus(void)
 
 void LWindow::render(void)
 {
-  if( !mMinimized )
+  if( !gWindowManager.shouldRender( mWindow ) )
+  { /* Window is not visible, or in the background and not due yet: do not render it */ }
+  else if( gUseSharedContext )
+  {
+    // Draw into this window with the shared context
+    SDL_GL_MakeCurrent( mWindow, gContext );
+
+    int drawableW = 0;
+    int drawableH = 0;
+
+    SDL_GL_GetDrawableSize( mWindow, &drawableW, &drawableH );
+
+    glViewport( 0, 0, drawableW, drawableH );
+    glMatrixMode( GL_PROJECTION );
+    glLoadIdentity();
+    glOrtho( 0.0, mWidth, mHeight, 0.0, -1.0, 1.0 );
+
+    // Clear screen
+    glClear( GL_COLOR_BUFFER_BIT );
+
+    // Checkerboard in the middle
+    const GLfloat side = CHECKER_SIZE * CHECKER_SCALE;
+    const GLfloat x    = static_cast<GLfloat>( mWidth  - CHECKER_SIZE * CHECKER_SCALE ) / 2.0f;
+    const GLfloat y    = static_cast<GLfloat>( mHeight - CHECKER_SIZE * CHECKER_SCALE ) / 2.0f;
+
+    glBegin( GL_QUADS );
+      glTexCoord2f( 0.0f, 0.0f ); glVertex2f( x,        y        );
+      glTexCoord2f( 1.0f, 0.0f ); glVertex2f( x + side, y        );
+      glTexCoord2f( 1.0f, 1.0f ); glVertex2f( x + side, y + side );
+      glTexCoord2f( 0.0f, 1.0f ); glVertex2f( x,        y + side );
+    glEnd();
+
+    // Update screen: each window has a back buffer of its own
+    SDL_GL_SwapWindow( mWindow );
+  }
+  else
   {
     // Clear screen
     SDL_SetRenderDrawColor( mRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
     SDL_RenderClear( mRenderer );
 
+    // Checkerboard in the middle
+    const SDL_Rect quad = { ( mWidth  - CHECKER_SIZE * CHECKER_SCALE ) / 2,
+                            ( mHeight - CHECKER_SIZE * CHECKER_SCALE ) / 2,
+                            CHECKER_SIZE * CHECKER_SCALE, CHECKER_SIZE * CHECKER_SCALE };
+
+    SDL_RenderCopy( mRenderer, mTexture, NULL, &quad );
+
     // Update screen
     SDL_RenderPresent( mRenderer );
   }
-  else { /* Window is minimised: do not render it */ }
 }
 
 
 void LWindow::free(void)
 {
+  if( mTexture != NULL )
+  {
+    SDL_DestroyTexture( mTexture );
+    mTexture = NULL;
+  }
+  else
+  {;}
+
+  if( mRenderer != NULL )
+  {
+    SDL_DestroyRenderer( mRenderer );
+    mRenderer = NULL;
+  }
+  else
+  {;}
+
   if( mWindow != NULL )
   {
+    gWindowManager.remove( mWindow );
     SDL_DestroyWindow( mWindow );
+    mWindow = NULL;
   }
 
   mMouseFocus = false;
@@ -368,6 +517,12 @@ void LWindow::free(void)
 }
 
 
+SDL_Window* LWindow::getWindow(void) const
+{
+  return mWindow;
+}
+
+
 int LWindow::getWidth(void) const
 {
   return mWidth;
@@ -439,6 +594,18 @@ static bool init(void)
       printf( "\nOK: linear texture filtering enabled" );
     }
 
+    // Pixels of the texture every window shows
+    makeCheckerboard();
+
+    if( gUseSharedContext )
+    {
+      // Use OpenGL 2.1
+      SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 2 );
+      SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 1 );
+    }
+    else
+    {;}
+
     // Create window
     if( !gWindows[ 0 ].init() )
     {
@@ -456,8 +623,95 @@ static bool init(void)
 
 
 
+/**
+ * @brief Sets up the shared context, current on the first window, and uploads the checkerboard
+ * into it: the only upload, whatever the number of windows.
+ *
+ * @return bool
+ **/
+static bool initGL(void)
+{
+  // Use Vsync
+  if( SDL_GL_SetSwapInterval( 1 ) < 0 )
+  {
+    printf( "\nWarning: Unable to set VSync! SDL Error: %s", SDL_GetError() );
+  }
+  else
+  {
+    printf( "\nOK: VSync set" );
+  }
+
+  glMatrixMode( GL_MODELVIEW );
+  glLoadIdentity();
+  glClearColor( WHITE_R / 255.0f, WHITE_G / 255.0f, WHITE_B / 255.0f, WHITE_A / 255.0f );
+
+  glGenTextures( 1, &gTexture );
+  glBindTexture( GL_TEXTURE_2D, gTexture );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, CHECKER_SIZE, CHECKER_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, gCheckerboard.data() );
+  glEnable( GL_TEXTURE_2D );
+
+  const GLenum error = glGetError();
+
+  if( error != GL_NO_ERROR )
+  {
+    printf( "\nUnable to upload the texture! OpenGL error: 0x%X", static_cast<unsigned>( error ) );
+    return false;
+  }
+  else
+  {
+    ++gTextureUploads;
+    printf( "\nOK: texture uploaded to the shared context" );
+    return true;
+  }
+}
+
+
+/**
+ * @brief Fills the RGBA pixels of a red and cyan checkerboard.
+ **/
+static void makeCheckerboard(void)
+{
+  gCheckerboard.resize( CHECKER_SIZE * CHECKER_SIZE * 4 );
+
+  for( int y = 0; y != CHECKER_SIZE; ++y )
+  {
+    for( int x = 0; x != CHECKER_SIZE; ++x )
+    {
+      const bool  isRed = ( ( x / CHECKER_SQUARE + y / CHECKER_SQUARE ) % 2 ) == 0;
+      const Uint8 rgba[4] = { static_cast<Uint8>( isRed ? RED_R : CYAN_R ), static_cast<Uint8>( isRed ? RED_G : CYAN_G ),
+                              static_cast<Uint8>( isRed ? RED_B : CYAN_B ), static_cast<Uint8>( isRed ? RED_A : CYAN_A ) };
+
+      memcpy( &gCheckerboard[ ( y * CHECKER_SIZE + x ) * 4 ], rgba, sizeof(rgba) );
+    }
+  }
+}
+
+
 static void close(void)
 {
+  printf( "\nTexture uploads: %d, for %d windows", gTextureUploads, TOTAL_WINDOWS );
+
+  // The texture goes with the context, while a window is still there to make it current on
+  if( gContext != NULL )
+  {
+    if( gWindows[ 0 ].getWindow() != NULL && SDL_GL_MakeCurrent( gWindows[ 0 ].getWindow(), gContext ) == 0 )
+    {
+      glDeleteTextures( 1, &gTexture );
+    }
+    else
+    { /* The texture goes with the context anyway */ }
+
+    gTexture = 0;
+
+    SDL_GL_MakeCurrent( NULL, NULL );
+    SDL_GL_DeleteContext( gContext );
+    gContext = NULL;
+  }
+  else
+  {;}
+
   // Destroy windows
   for( int i = 0; i < TOTAL_WINDOWS; ++i )
   {
@@ -494,6 +748,14 @@ int main( int argc, char* args[] )
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    // All windows in one OpenGL context, instead of a renderer each
+    if( strcmp( args[i], SHARED_CONTEXT_ARGUMENT ) == 0 )
+    {
+      gUseSharedContext = true;
+    }
+    else
+    {;}
   }
 
   // Start up SDL and create first window
@@ -511,6 +773,8 @@ int main( int argc, char* args[] )
       gWindows[ i ].init();
     }
 
+    gWindowManager.setBackgroundRate( BACKGROUND_RATE );
+
     // Main loop flag
     bool quit = false;
 
@@ -520,8 +784,8 @@ int main( int argc, char* args[] )
     // While application is running
     while( !quit )
     {
-      // Handle events on queue
-      while( SDL_PollEvent( &e ) != 0 )
+      // Handle events on queue, sleeping first while no window needs a frame
+      for( bool hasEvent = gWindowManager.waitEvent( e ); hasEvent; hasEvent = ( SDL_PollEvent( &e ) != 0 ) )
       {
         // User requests quit
         if( e.type == SDL_QUIT )
@@ -532,6 +796,8 @@ int main( int argc, char* args[] )
         { /* Continue until QUIT event */ }
 
         // Handle window events
+        gWindowManager.handleEvent( e );
+
         for( int i = 0; i != TOTAL_WINDOWS; ++i )
         {
           gWindows[ i ].handleEvent( e );
@@ -6,18 +6,23 @@ echo.
 @REM Project's name
 set SDL2_PROJECT_NAME=36_multiple_windows
 
+@REM Shared engine library (build it first with Engine_Lib\Build.bat)
+set ENGINE_LIB_PATH=..\..\Engine_Lib
+
 @REM Static libraries
 set SDL2_LIB_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\lib
 set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
 set SDL2_TTF_LIB_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\lib\
-set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% &:: -L%SDL2_IMAGE_LIB_PATH% -L%SDL2_TTF_LIB_PATH% 
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 &:: -lSDL2_image -lSDL2_ttf
+set OPENGL32_LIB_PATH="C:\Program Files (x86)\Windows Kits\10\Lib\10.0.19041.0\um\x64"
+set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% -L%ENGINE_LIB_PATH% -L%OPENGL32_LIB_PATH% &:: -L%SDL2_IMAGE_LIB_PATH% -L%SDL2_TTF_LIB_PATH% 
+set SDL2_LIBRARIES=-lmingw32 -lEngine -lSDL2main -lSDL2 -lOpenGL32 &:: -lSDL2_image -lSDL2_ttf
 
 @REM Header files
 set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
 set SDL2_IMAGE_INCLUDE_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\include\SDL2\
 set SDL2_TTF_INCLUDE_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\include\SDL2
-set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% &:: -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF_INCLUDE_PATH%
+set OPENGL32_INCLUDE_PATH=D:\MSYS64\mingw64\include\GL
+set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%ENGINE_LIB_PATH% -I%OPENGL32_INCLUDE_PATH% &:: -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF_INCLUDE_PATH%
 
 @REM C++ compilation options
 set COMPILATION_OPTIONS=-Wall -Wextra -Wpedantic -Wconversion
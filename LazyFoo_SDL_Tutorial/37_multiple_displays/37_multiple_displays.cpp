@@ -20,6 +20,17 @@
  *   get the bounds for each one using "SDL_GetDisplayBounds". After this, we initialize our window.
  * - Il main loop è quasi identico al precedente, perché tutte le variazioni sono state incapsulate
  *   nella classe LWindow.
+ *
+ * Aggiunta GS: per ogni display sono letti anche la frequenza di aggiornamento, con
+ * "SDL_GetCurrentDisplayMode", e la scala, dai DPI di "SDL_GetDisplayDPI" (96 DPI valgono 1), e
+ * sono letti di nuovo a ogni SDL_DISPLAYEVENT. Quando la finestra passa a un altro display
+ * (SDL_WINDOWEVENT_DISPLAY_CHANGED), il suo "LFramePacer" di Engine_Lib/LFramePacer prende la
+ * frequenza del nuovo display, e il backbuffer ne segue la scala: se il sistema dà già alla finestra
+ * più pixel che punti (SDL_WINDOW_ALLOW_HIGHDPI, su macOS e Wayland) la scala è quella, altrimenti
+ * la finestra è ridimensionata secondo i DPI del display. "SDL_RenderSetScale" fa sì che il disegno
+ * resti in unità logiche. Il pacer attende solo se il renderer non ha ottenuto il VSync, o se la
+ * finestra è minimizzata, quando SDL_RenderPresent non attende nulla; il titolo mostra frequenza e
+ * scala del display corrente.
  **/
 
 
@@ -32,6 +43,8 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <vector>
+#include "LFramePacer.hpp"
 
 
 /**************************************************************************************************
@@ -70,6 +83,23 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 // Total windows
 static constexpr int TOTAL_WINDOWS = 3;
 
+// Displays
+static constexpr float BASE_DPI             = 96.0f; // DPI of a display with scale 1
+static constexpr int   DEFAULT_REFRESH_RATE = 60;    // Hz, for the displays that do not report it
+
+/***************************************************************************************************
+* Types
+****************************************************************************************************/
+
+// What the windows need to know of a display
+struct DisplayInfo
+{
+  SDL_Rect Bounds;        // Position and dimensions on the desktop
+  int      RefreshRate;   // Hz
+  float    Scale;         // Pixels per logical unit, from the display's DPI
+};
+
+
 /***************************************************************************************************
 * Classes
 ****************************************************************************************************/
@@ -91,6 +121,9 @@ class LWindow
   // Focuses on window
   void focus(void);
 
+  // Follows the display the window is on: frame rate and scale
+  void updateDisplay(void);
+
   // Shows windows contents
   void render(void);
 
@@ -115,6 +148,11 @@ class LWindow
   Uint32        mWindowID;
   int           mWindowDisplayID;
 
+  // Display data
+  LFramePacer   mPacer;      // At the refresh rate of the display
+  bool          mHasVSync;   // Presents already wait for the display
+  float         mScale;      // Pixels per logical unit
+
   // Window dimensions
   int mWidth;
   int mHeight;
@@ -134,6 +172,7 @@ class LWindow
 
 static bool init (void);
 static void close(void);
+static void queryDisplays(void);
 
 
 /***************************************************************************************************
@@ -143,8 +182,7 @@ static void close(void);
 LWindow gWindow; // Our custom window
 
 // Display data
-int       gTotalDisplays = 0;
-SDL_Rect* gDisplayBounds = NULL;
+std::vector<DisplayInfo> gDisplays;
 
 
 /***************************************************************************************************
@@ -159,6 +197,8 @@ LWindow::LWindow(void)
     mRenderer(NULL),
     mWindowID(-1),
     mWindowDisplayID(-1),
+    mHasVSync(false),
+    mScale(1.0f),
     mWidth(0),
     mHeight(0),
     mMouseFocus(false),
@@ -175,7 +215,7 @@ bool LWindow::init(void)
   mWindow = SDL_CreateWindow(  "SDL Tutorial",
                                 SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
                                 WINDOW_W, WINDOW_H,
-                                SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE );
+                                SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI );
 
   if( mWindow != NULL )
   {
@@ -201,9 +241,16 @@ bool LWindow::init(void)
       // Initialize renderer color
       SDL_SetRenderDrawColor( mRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
+      // The driver may not grant VSync: then the pacer waits instead
+      SDL_RendererInfo info;
+      mHasVSync = SDL_GetRendererInfo( mRenderer, &info ) == 0 && ( info.flags & SDL_RENDERER_PRESENTVSYNC ) != 0;
+
       // Grab window identifier
-      mWindowID        = SDL_GetWindowID( mWindow );
-      mWindowDisplayID = SDL_GetWindowDisplayIndex( mWindow );
+      mWindowID = SDL_GetWindowID( mWindow );
+
+      // Take the rate and scale of the display the window opened on
+      updateDisplay();
+      mPacer.start();
 
       // Flag as opened
       mShown = true;
@@ -230,7 +277,12 @@ void LWindow::handleEvent( SDL_Event& e )
     {
       // Window moved
       case SDL_WINDOWEVENT_MOVED:
-      mWindowDisplayID = SDL_GetWindowDisplayIndex( mWindow );
+      updateCaption = true;
+      break;
+
+      // Window moved to another display
+      case SDL_WINDOWEVENT_DISPLAY_CHANGED:
+      updateDisplay();
       updateCaption = true;
       break;
 
@@ -324,18 +376,24 @@ void LWindow::handleEvent( SDL_Event& e )
     if( switchDisplay )
     {
       // Bound display index
+      const int totalDisplays = static_cast<int>( gDisplays.size() );
+
       if( mWindowDisplayID < 0 )
       {
-        mWindowDisplayID = gTotalDisplays - 1;
+        mWindowDisplayID = totalDisplays - 1;
       }
-      else if( mWindowDisplayID >= gTotalDisplays )
+      else if( mWindowDisplayID >= totalDisplays )
       {
         mWindowDisplayID = 0;
       }
 
       // Move window to center of next display
-      SDL_SetWindowPosition( mWindow, gDisplayBounds[ mWindowDisplayID ].x + ( gDisplayBounds[ mWindowDisplayID ].w - mWidth  ) / 2,
-                                      gDisplayBounds[ mWindowDisplayID ].y + ( gDisplayBounds[ mWindowDisplayID ].h - mHeight ) / 2 );
+      const SDL_Rect& bounds = gDisplays[ mWindowDisplayID ].Bounds;
+
+      SDL_SetWindowPosition( mWindow, bounds.x + ( bounds.w - mWidth  ) / 2,
+                                      bounds.y + ( bounds.h - mHeight ) / 2 );
+
+      // Its rate and scale come with SDL_WINDOWEVENT_DISPLAY_CHANGED, if the window got there
       updateCaption = true;
     }
   }
@@ -346,6 +404,7 @@ void LWindow::handleEvent( SDL_Event& e )
   {
     std::stringstream caption;
     caption << "SDL Tutorial - ID: " << mWindowID << " Display: " << mWindowDisplayID
+            << " (" << mPacer.GetTargetRate() << " Hz, x" << mScale << ")"
             << " MouseFocus:"    << ( ( mMouseFocus )    ? "On" : "Off" )
             << " KeyboardFocus:" << ( ( mKeyboardFocus ) ? "On" : "Off" );
     SDL_SetWindowTitle( mWindow, caption.str().c_str() );
@@ -369,6 +428,59 @@ void LWindow::focus(void)
 }
 
 
+/**
+ * @brief Paces the window to the refresh rate of its display, and sizes its backbuffer by the
+ * display's DPI. Called when the window changes display and when the displays change.
+ **/
+void LWindow::updateDisplay(void)
+{
+  mWindowDisplayID = SDL_GetWindowDisplayIndex( mWindow );
+
+  if( mWindowDisplayID < 0 || mWindowDisplayID >= static_cast<int>( gDisplays.size() ) )
+  {
+    printf( "\nUnable to tell the display of window %u! SDL Error: %s", mWindowID, SDL_GetError() );
+    return;
+  }
+  else
+  {;}
+
+  const DisplayInfo& display = gDisplays[ mWindowDisplayID ];
+
+  mPacer.setTargetRate( display.RefreshRate );
+
+  // Points and pixels of the window
+  int windowW = 0;
+  int windowH = 0;
+  int outputW = 0;
+  int outputH = 0;
+
+  SDL_GetWindowSize( mWindow, &windowW, &windowH );
+  SDL_GetRendererOutputSize( mRenderer, &outputW, &outputH );
+
+  if( windowW > 0 && outputW > windowW )
+  {
+    // The system scales the window already (SDL_WINDOW_ALLOW_HIGHDPI): its pixels tell the scale
+    mScale = static_cast<float>( outputW ) / static_cast<float>( windowW );
+  }
+  else if( display.Scale != mScale )
+  {
+    // One pixel per point: grow or shrink the window to keep its size on the new display
+    const float resize = display.Scale / mScale;
+
+    SDL_SetWindowSize( mWindow, static_cast<int>( static_cast<float>( windowW ) * resize + 0.5f ),
+                                static_cast<int>( static_cast<float>( windowH ) * resize + 0.5f ) );
+    mScale = display.Scale;
+  }
+  else
+  { /* Same scale as the previous display */ }
+
+  // Draw in logical units whatever the pixels
+  SDL_RenderSetScale( mRenderer, mScale, mScale );
+
+  printf( "\nOK: window %u on display %d, %d Hz, scale %.2f", mWindowID, mWindowDisplayID, display.RefreshRate, static_cast<double>( mScale ) );
+}
+
+
 void LWindow::render(void)
 {
   if( !mMinimized )
@@ -381,6 +493,14 @@ void LWindow::render(void)
     SDL_RenderPresent( mRenderer );
   }
   else { /* Window is minimised: do not render it */ }
+
+  // Without VSync, or with nothing presented, nothing else waits for the display
+  if( !mHasVSync || mMinimized )
+  {
+    mPacer.wait();
+  }
+  else
+  { /* SDL_RenderPresent waited for the display */ }
 }
 
 
@@ -469,10 +589,10 @@ static bool init(void)
       printf( "\nOK: linear texture filtering enabled" );
     }
 
-    // Get number of displays
-    gTotalDisplays = SDL_GetNumVideoDisplays();
+    // Get bounds, refresh rate and scale of each display
+    queryDisplays();
 
-    if( gTotalDisplays < 2 )
+    if( gDisplays.size() < 2 )
     {
       printf( "\nWarning: only one display connected!" );
     }
@@ -481,14 +601,6 @@ static bool init(void)
       printf( "\nOK: multiple displays connected" );
     }
 
-    // Get bounds of each display
-    gDisplayBounds = new SDL_Rect[ gTotalDisplays ];
-
-    for( int i = 0; i != gTotalDisplays; ++i )
-    {
-      SDL_GetDisplayBounds( i, &gDisplayBounds[ i ] );
-    }
-
     // Create window
     if( !gWindow.init() )
     {
@@ -511,15 +623,46 @@ static void close(void)
   // Destroy window
   gWindow.free();
 
-  // Deallocate bounds
-  delete[] gDisplayBounds;
-  gDisplayBounds = NULL;
+  // Deallocate display data
+  gDisplays.clear();
 
   // Quit SDL subsystems
   SDL_Quit();
 }
 
 
+/**
+ * @brief Reads bounds, refresh rate and scale of every display, at start and whenever the displays
+ * change.
+ **/
+static void queryDisplays(void)
+{
+  const int totalDisplays = SDL_GetNumVideoDisplays();
+
+  gDisplays.resize( ( totalDisplays > 0 ) ? static_cast<size_t>( totalDisplays ) : 0 );
+
+  for( int i = 0; i < totalDisplays; ++i )
+  {
+    DisplayInfo&    display = gDisplays[ static_cast<size_t>( i ) ];
+    SDL_DisplayMode mode;
+    float           dpi     = 0.0f;
+
+    SDL_GetDisplayBounds( i, &display.Bounds );
+
+    display.RefreshRate = ( SDL_GetCurrentDisplayMode( i, &mode ) == 0 && mode.refresh_rate > 0 )
+                          ? mode.refresh_rate : DEFAULT_REFRESH_RATE;
+
+    // Rounded to a quarter, the step of the system scale settings; never below 1, as some systems
+    // report 72 DPI for a display they know nothing of
+    display.Scale = ( SDL_GetDisplayDPI( i, NULL, &dpi, NULL ) == 0 && dpi > BASE_DPI )
+                    ? SDL_roundf( dpi / BASE_DPI * 4.0f ) / 4.0f : 1.0f;
+
+    printf( "\nDisplay %d: %dx%d at %d,%d, %d Hz, scale %.2f", i, display.Bounds.w, display.Bounds.h,
+            display.Bounds.x, display.Bounds.y, display.RefreshRate, static_cast<double>( display.Scale ) );
+  }
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -575,6 +718,15 @@ int main( int argc, char* args[] )
         else
         { /* Continue until QUIT event */ }
 
+        // Displays connected, disconnected or rotated: read them again
+        if( e.type == SDL_DISPLAYEVENT )
+        {
+          queryDisplays();
+          gWindow.updateDisplay();
+        }
+        else
+        {;}
+
         // Handle window events
         gWindow.handleEvent( e );
       }
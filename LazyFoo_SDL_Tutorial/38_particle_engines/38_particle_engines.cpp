@@ -34,6 +34,32 @@
  *   function checks if there are any particles that are dead and replaces them. After the dead
  *   particles are replaced we render all the current particles to the screen.
  * - Again, since our code is well encapsulated the code in the main loop hardly changes.
+ * - Modifica GS: la classe "Particle" allocata con new/delete è sostituita da "ParticleEmitter",
+ *   un pool di capacità configurabile allocato una sola volta, con i dati di ogni particella in
+ *   array separati (SoA), una free list per riciclare le particelle morte e un generatore xorshift
+ *   al posto di "rand()". A regime nessuna allocazione avviene durante il frame.
+ * - Modifica GS: le texture rossa, verde, blu e shimmer vengono copiate, dopo il caricamento, in
+ *   un'unica texture atlante (render to texture). Le particelle non vengono più disegnate una per
+ *   una, ma accodate in "ParticleBatch" come coppie di triangoli e inviate con un solo
+ *   "SDL_RenderGeometry" per frame, qualunque sia il numero di particelle e di emettitori.
+ * - Modifica GS: l'aggiornamento delle particelle è separato dal disegno. "ParticleWorkers" divide
+ *   gli emettitori in blocchi e li aggiorna in parallelo su un pool di thread (SDL_CreateThread,
+ *   come nel 46, e semafori, come nel 47); il frame attende tutti i blocchi (barriera) prima di
+ *   disegnare. Ogni emettitore è aggiornato da un solo thread, quindi non servono lock.
+ * - Aggiunta GS: con "--perf-frames=<N>" il programma gira senza finestra per N frame, con l'input
+ *   di "--perf-script", e fallisce se i tempi, le allocazioni o le draw call per frame superano
+ *   "--perf-budget" (Engine_Lib/LPerfHarness; PerfScript.txt e PerfBudget.txt sono quelli usati
+ *   da PerfCheck.bat).
+ * - Aggiunta GS: la scena non è più la sola finestra. Il pallino si muove in un livello di
+ *   LEVEL_W x LEVEL_H, seguito dalla telecamera, e il livello ha un emettitore fermo per ogni cella
+ *   di SCENE_CELL di lato, centinaia in tutto. Ogni frame "cullEmitters" confronta il riquadro che
+ *   le particelle di ogni emettitore possono occupare con la lista delle viste (qui una sola, la
+ *   telecamera): gli emettitori fuori vista vengono addormentati e né aggiornati né disegnati; al
+ *   risveglio recuperano il tempo perso con al massimo PARTICLE_MAX_FRAME + 1 passi, dopo i quali
+ *   nessuna particella di prima è ancora viva. Quelli in vista hanno un livello di dettaglio che
+ *   dipende dalla distanza dal centro della vista più vicina: vicino tutte le particelle, più
+ *   lontano la metà o un quarto, con meno particelle nuove per frame. Il costo del frame dipende
+ *   così dagli emettitori visibili, non da quanti ne ha il livello.
  *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
@@ -50,6 +76,8 @@
 #include <stdio.h>
 #include <string>
 #include <vector> // Aggiunto da GS
+#include <cstdint>
+#include "LPerfHarness.hpp"
 
 
 /**************************************************************************************************
@@ -110,6 +138,37 @@ static const std::vector<std::string> Paths_Vec
 // Particle count
 static constexpr int TOTAL_PARTICLES = 20;
 
+// The level the dot moves in, with a particle emitter in every cell of the scene
+static constexpr int LEVEL_W    = 2560;
+static constexpr int LEVEL_H    = 1920;
+static constexpr int SCENE_CELL = 128;
+static constexpr int SCENE_EMITTERS = ( LEVEL_W / SCENE_CELL ) * ( LEVEL_H / SCENE_CELL );
+
+// Level of detail of the emitters in view, by the distance from the centre of the nearest view:
+// every particle up to LOD_NEAR, half of them up to LOD_FAR, a quarter beyond, spawned more slowly
+static constexpr int LOD_NEAR = 240;
+static constexpr int LOD_FAR  = 400;
+
+// Particle life, in frames, and spawn area around the emitter
+static constexpr Uint8 PARTICLE_MAX_FRAME = 10;
+static constexpr int   PARTICLE_SPAWN_OFFSET = -5;
+static constexpr Uint32 PARTICLE_SPAWN_RANGE = 25;
+static constexpr Uint32 PARTICLE_TYPES = 3;
+static constexpr int   PARTICLE_SIZE = 5; // Of the particle and shimmer sprites
+
+// Emitters in view at once, at most: the cells the window and a margin of a cell can touch, and the dot
+static constexpr int MAX_VISIBLE_EMITTERS = ( WINDOW_W / SCENE_CELL + 3 ) * ( WINDOW_H / SCENE_CELL + 3 ) + 1;
+
+// Sprites of the particle atlas, left to right; the first PARTICLE_TYPES are the particle colours
+enum class AtlasSprite
+{
+  red,
+  green,
+  blue,
+  shimmer,
+  count
+};
+
 
 /***************************************************************************************************
 * Classes
@@ -163,29 +222,184 @@ public:
 };
 
 
-class Particle
+/**
+ * @brief Xorshift32 pseudo-random generator: a few shifts per number, and its state is private to
+ * each emitter, unlike the hidden global state of rand().
+ **/
+class FastRandom
+{
+  public:
+
+  explicit FastRandom( Uint32 seed ) : mState( seed != 0 ? seed : 0x9E3779B9u ) {;}
+
+  // Uniform number in [0, range), by multiply-shift instead of a division
+  Uint32 next( Uint32 range )
+  {
+    mState ^= mState << 13;
+    mState ^= mState >> 17;
+    mState ^= mState << 5;
+
+    return static_cast<Uint32>( ( static_cast<Uint64>( mState ) * range ) >> 32 );
+  }
+
+  private:
+
+  Uint32 mState;
+};
+
+
+/**
+ * @brief Collects the particles of a frame, from any number of emitters, and draws them all with a
+ * single SDL_RenderGeometry call. Every particle sprite lives in one atlas texture, so no sorting by
+ * texture is needed and the drawing order, hence the look, is the same as drawing them one by one.
+ **/
+class ParticleBatch
+{
+  public:
+
+  ParticleBatch(void);
+  ~ParticleBatch(void);
+
+  // Copies the particle textures into the atlas. To be called once they are loaded
+  bool buildAtlas(void);
+
+  // Frees the atlas
+  void free(void);
+
+  // Queues a sprite of the atlas at the given position
+  void add( AtlasSprite, int, int );
+
+  // Draws and discards all the queued sprites
+  void flush(void);
+
+  private:
+
+  static constexpr int RESERVED_SPRITES = 2 * TOTAL_PARTICLES * MAX_VISIBLE_EMITTERS;
+
+  SDL_Texture* mAtlas;
+  SDL_Rect     mClips[ static_cast<int>( AtlasSprite::count ) ];
+  int          mAtlasWidth;
+  int          mAtlasHeight;
+
+  std::vector<SDL_Vertex> mVertices;
+  std::vector<int>        mIndices;
+};
+
+
+/**
+ * @brief A pool of particles. All the storage is allocated by the constructor: the particles live in
+ * parallel arrays (structure of arrays) and dead ones go back to a free list, from which "emit"
+ * takes the slots of the new ones.
+ **/
+class ParticleEmitter
 {
   public:
 
-  // Initialize position and animation
-  Particle( int, int );
+  // Allocates room for the given number of particles
+  explicit ParticleEmitter( int capacity );
 
-  // Shows the particle
-  void render(void);
+  // Sets where new particles spawn
+  void setOrigin( int, int );
 
-  // Checks if particle is dead
-  bool isDead(void);
+  // Level of detail: how many particles are kept alive, and how many spawn in a frame at most
+  void setDetail( int, int );
+
+  // Stops the updates while out of view, and catches up with the frames missed on waking
+  void sleep   ( Uint32 );
+  void wake    ( Uint32 );
+  bool isAsleep( void ) const;
+
+  // The box the particles can cover, in level coordinates
+  SDL_Rect getBounds(void) const;
+
+  // Animates the live particles, recycling the dead ones and spawning new ones until the pool is
+  // full, once per frame plus the frames missed asleep. Touches only this emitter, so different
+  // emitters can be updated by different threads
+  void update(void);
+
+  // Queues the live particles, relative to the camera
+  void render( ParticleBatch&, int, int ) const;
 
   private:
 
+  // A frame of animation
+  void step(void);
+
   // Offsets
-  int mPosX, mPosY;
+  std::vector<int> mPosX, mPosY;
 
   // Current frame of animation
-  int mFrame;
+  std::vector<Uint8> mFrame;
+
+  // Type of particle: index in the colour textures
+  std::vector<Uint8> mType;
+
+  // Whether the slot holds a live particle
+  std::vector<bool> mAlive;
+
+  // Indices of the free slots
+  std::vector<int> mFreeList;
+
+  // Spawn point
+  int mOriginX, mOriginY;
+
+  // Detail: live particles now, kept at most, and spawned per frame at most
+  int mLiveCount;
+  int mMaxLive;
+  int mMaxSpawns;
 
-  // Type of particle
-  LTexture* mTexture;
+  // Sleep: since which frame, and the frames the next update has to catch up with
+  bool   mIsAsleep;
+  Uint32 mAsleepSince;
+  int    mCatchUpFrames;
+
+  FastRandom mRandom;
+};
+
+
+/**
+ * @brief Pool of worker threads updating particle emitters in parallel. Each frame the emitters are
+ * split into contiguous blocks; workers and the calling thread take blocks until none is left, and
+ * "update" returns only once every block is done, so rendering never sees a half updated emitter.
+ **/
+class ParticleWorkers
+{
+  public:
+
+  ParticleWorkers(void);
+  ~ParticleWorkers(void);
+
+  // Starts one worker per additional core. Without workers, "update" runs on the calling thread
+  void start(void);
+
+  // Joins the workers
+  void stop(void);
+
+  // Updates the given emitters; returns when all of them are updated (frame barrier)
+  void update( ParticleEmitter* const*, int );
+
+  private:
+
+  // Blocks per thread: more than one, so that a slow thread does not hold the whole frame
+  static constexpr int BLOCKS_PER_THREAD = 4;
+  static constexpr int MAX_WORKERS       = 63;
+
+  static int workerThread( void* );
+
+  // Updates blocks until none is left
+  void runBlocks(void);
+
+  std::vector<SDL_Thread*> mThreads;
+
+  SDL_sem* mStartSemaphore; // Posted once per worker when a frame's blocks are ready
+  SDL_sem* mDoneSemaphore;  // Posted by each worker when it finds no more blocks
+
+  // Work of the current frame, written before posting mStartSemaphore
+  ParticleEmitter* const* mEmitters;
+  int                     mEmitterCount;
+  int                     mBlockCount;
+  SDL_atomic_t            mNextBlock;
+  bool                    mQuit;
 };
 
 
@@ -204,24 +418,25 @@ class Dot
   // Initializes the variables and allocates particles
   Dot(void);
 
-  // Deallocates particles
-  ~Dot(void);
-
   // Takes key presses and adjusts the dot's velocity
   void handleEvent( SDL_Event& );
 
   // Moves the dot
   void move(void);
 
-  // Shows the dot on the screen
-  void render(void);
+  // Shows the dot on the screen relative to the camera
+  void render( const SDL_Rect& );
+
+  // Position accessors
+  int getPosX(void) const;
+  int getPosY(void) const;
+
+  // The particles trailing the dot, updated and drawn with those of the scene
+  ParticleEmitter* getParticles(void);
 
   private:
   // The particles
-  Particle* mParticles[ TOTAL_PARTICLES ];
-
-  // Shows the particles
-  void renderParticles(void);
+  ParticleEmitter mParticles;
 
   // The X and Y offsets of the dot
   int mPosX, mPosY;
@@ -239,6 +454,9 @@ static bool init      ( void );
 static bool loadMedia ( void );
 static void close     ( void );
 
+static void buildScene   ( ParticleEmitter* );
+static void cullEmitters ( const SDL_Rect*, int, Uint32 );
+
 
 /***************************************************************************************************
 * Private global variables
@@ -254,6 +472,17 @@ LTexture gGreenTexture;
 LTexture gBlueTexture;
 LTexture gShimmerTexture;
 
+// All the particles of a frame
+ParticleBatch gParticleBatch;
+
+// Particle update threads
+ParticleWorkers gParticleWorkers;
+
+// The emitters of the level, every one of them, and those in view this frame
+static std::vector<ParticleEmitter>  gSceneEmitters;
+static std::vector<ParticleEmitter*> gEmitters;
+static std::vector<ParticleEmitter*> gAwakeEmitters;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -428,6 +657,7 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 
   // Render to screen
   SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
+  LPerfHarness::countDrawCalls( 1 );
 }
 
 
@@ -443,79 +673,434 @@ int LTexture::getHeight(void) const
 }
 
 
-Particle::Particle( int x, int y )
+ParticleBatch::ParticleBatch(void)
+  : mAtlas( NULL ), mClips(), mAtlasWidth( 0 ), mAtlasHeight( 0 )
 {
-  // Set offsets
-  mPosX = x - 5 + ( rand() % 25 );
-  mPosY = y - 5 + ( rand() % 25 );
+  mVertices.reserve( 4 * RESERVED_SPRITES );
+  mIndices.reserve ( 6 * RESERVED_SPRITES );
+}
+
+
+ParticleBatch::~ParticleBatch(void)
+{
+  free();
+}
 
-  // Initialize animation (randomizzazione di mFrame per migliorare l'effetto scintillio)
-  mFrame = rand() % 5;
 
-  // Set type
-  switch( rand() % 3 )
+/**
+ * @brief Renders the red, green, blue and shimmer textures side by side into a target texture. They
+ * are copied without blending and without alpha modulation, so that the atlas keeps their exact
+ * transparency; the semi transparent look is applied per vertex instead.
+ *
+ * @return true if successful; false otherwise
+ **/
+bool ParticleBatch::buildAtlas(void)
+{
+  LTexture* const sources[] = { &gRedTexture, &gGreenTexture, &gBlueTexture, &gShimmerTexture };
+
+  free();
+
+  for( int i = 0; i != static_cast<int>( AtlasSprite::count ); ++i )
+  {
+    mClips[ i ] = { mAtlasWidth, 0, sources[ i ]->getWidth(), sources[ i ]->getHeight() };
+
+    mAtlasWidth += sources[ i ]->getWidth();
+    mAtlasHeight = SDL_max( mAtlasHeight, sources[ i ]->getHeight() );
+  }
+
+  mAtlas = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, mAtlasWidth, mAtlasHeight );
+
+  if( mAtlas == NULL )
+  {
+    printf( "\nUnable to create particle atlas! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else { /* Atlas created */ }
+
+  SDL_SetRenderTarget( gRenderer, mAtlas );
+  SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, SDL_ALPHA_TRANSPARENT );
+  SDL_RenderClear( gRenderer );
+
+  for( int i = 0; i != static_cast<int>( AtlasSprite::count ); ++i )
   {
-    case 0: mTexture = &gRedTexture;   break;
-    case 1: mTexture = &gGreenTexture; break;
-    case 2: mTexture = &gBlueTexture;  break;
+    sources[ i ]->setBlendMode( SDL_BLENDMODE_NONE );
+    sources[ i ]->setAlpha( SDL_ALPHA_OPAQUE );
+    sources[ i ]->render( mClips[ i ].x, mClips[ i ].y );
+    sources[ i ]->setBlendMode( SDL_BLENDMODE_BLEND );
+    sources[ i ]->setAlpha( ALPHA );
   }
+
+  SDL_SetRenderTarget( gRenderer, NULL );
+  SDL_SetTextureBlendMode( mAtlas, SDL_BLENDMODE_BLEND );
+
+  return true;
 }
 
 
-void Particle::render(void)
+void ParticleBatch::free(void)
 {
-  // Show image
-  mTexture->render( mPosX, mPosY );
+  if( mAtlas != NULL )
+  {
+    SDL_DestroyTexture( mAtlas );
+    mAtlas = NULL;
+  }
+  else { /* Nothing to free */ }
+
+  mAtlasWidth  = 0;
+  mAtlasHeight = 0;
+}
+
+
+void ParticleBatch::add( AtlasSprite sprite, int x, int y )
+{
+  const SDL_Rect& clip = mClips[ static_cast<int>( sprite ) ];
+
+  const float u0 = static_cast<float>( clip.x          ) / static_cast<float>( mAtlasWidth  );
+  const float v0 = static_cast<float>( clip.y          ) / static_cast<float>( mAtlasHeight );
+  const float u1 = static_cast<float>( clip.x + clip.w ) / static_cast<float>( mAtlasWidth  );
+  const float v1 = static_cast<float>( clip.y + clip.h ) / static_cast<float>( mAtlasHeight );
+
+  const float x0 = static_cast<float>( x          );
+  const float y0 = static_cast<float>( y          );
+  const float x1 = static_cast<float>( x + clip.w );
+  const float y1 = static_cast<float>( y + clip.h );
+
+  // Same modulation the textures get from setAlpha( ALPHA )
+  const SDL_Color modulation = { WHITE_R, WHITE_G, WHITE_B, ALPHA };
 
-  // Show shimmer
-  if( mFrame % 2 == 0 )
+  const int first = static_cast<int>( mVertices.size() );
+
+  mVertices.push_back( SDL_Vertex{ SDL_FPoint{ x0, y0 }, modulation, SDL_FPoint{ u0, v0 } } );
+  mVertices.push_back( SDL_Vertex{ SDL_FPoint{ x1, y0 }, modulation, SDL_FPoint{ u1, v0 } } );
+  mVertices.push_back( SDL_Vertex{ SDL_FPoint{ x1, y1 }, modulation, SDL_FPoint{ u1, v1 } } );
+  mVertices.push_back( SDL_Vertex{ SDL_FPoint{ x0, y1 }, modulation, SDL_FPoint{ u0, v1 } } );
+
+  // Two triangles per sprite
+  const int corners[] = { 0, 1, 2, 2, 3, 0 };
+
+  for( int corner : corners )
   {
-    gShimmerTexture.render( mPosX, mPosY );
+    mIndices.push_back( first + corner );
   }
-  else { /* No shimmer to show */ }
+}
 
-  // Animate
-  mFrame++;
+
+void ParticleBatch::flush(void)
+{
+  if( mAtlas != NULL && !mIndices.empty() )
+  {
+    SDL_RenderGeometry( gRenderer, mAtlas, mVertices.data(), static_cast<int>( mVertices.size() ),
+                        mIndices.data(), static_cast<int>( mIndices.size() ) );
+    LPerfHarness::countDrawCalls( 1 );
+  }
+  else { /* Nothing to draw */ }
+
+  // The storage is kept for the next frame
+  mVertices.clear();
+  mIndices.clear();
+}
+
+
+ParticleEmitter::ParticleEmitter( int capacity )
+  : mPosX( capacity ), mPosY( capacity ), mFrame( capacity ), mType( capacity ), mAlive( capacity, false ),
+    mOriginX( 0 ), mOriginY( 0 ), mLiveCount( 0 ), mMaxLive( capacity ), mMaxSpawns( capacity ),
+    mIsAsleep( false ), mAsleepSince( 0 ), mCatchUpFrames( 0 ),
+    mRandom( static_cast<Uint32>( reinterpret_cast<uintptr_t>( this ) ) ) // Distinct sequence per emitter
+{
+  mFreeList.reserve( capacity );
+
+  // Every slot is free; popped in increasing order
+  for( int i = capacity - 1; i >= 0; --i )
+  {
+    mFreeList.push_back( i );
+  }
+}
+
+
+void ParticleEmitter::setOrigin( int x, int y )
+{
+  mOriginX = x;
+  mOriginY = y;
+}
+
+
+/**
+ * @brief Sets the level of detail. Lowering it spawns fewer particles: those alive above the new
+ * count die as usual, none is taken away.
+ *
+ * @param maxLive   Particles kept alive, up to the capacity
+ * @param maxSpawns Particles spawned in a frame at most
+ **/
+void ParticleEmitter::setDetail( int maxLive, int maxSpawns )
+{
+  mMaxLive   = SDL_min( maxLive, static_cast<int>( mAlive.size() ) );
+  mMaxSpawns = maxSpawns;
+}
+
+
+void ParticleEmitter::sleep( Uint32 frame )
+{
+  mIsAsleep    = true;
+  mAsleepSince = frame;
 }
 
 
 /**
- * @brief Once the particle has rendered for a max of 10 frames, we mark it as dead.
+ * @brief Wakes the emitter: its next update catches up with the frames it slept, but no more than
+ * PARTICLE_MAX_FRAME + 1 of them, the longest a particle lives. After those no particle of before
+ * is alive, as after any longer sleep, so a long sleep costs the same as a short one.
  **/
-bool Particle::isDead(void)
+void ParticleEmitter::wake( Uint32 frame )
 {
-  return mFrame > 10;
+  mIsAsleep      = false;
+  mCatchUpFrames = static_cast<int>( SDL_min( frame - mAsleepSince, static_cast<Uint32>( PARTICLE_MAX_FRAME + 1 ) ) );
 }
 
 
-Dot::Dot(void)
+bool ParticleEmitter::isAsleep(void) const
 {
-  // Initialize the offsets
-  mPosX = 0;
-  mPosY = 0;
+  return mIsAsleep;
+}
 
-  // Initialize the velocity
-  mVelX = 0;
-  mVelY = 0;
 
-  // Initialize particles
-  for( int i = 0; i != TOTAL_PARTICLES; ++i )
+/**
+ * @brief The box of the spawn area, grown by the size of a sprite: the particles never leave it.
+ **/
+SDL_Rect ParticleEmitter::getBounds(void) const
+{
+  return SDL_Rect{ mOriginX + PARTICLE_SPAWN_OFFSET, mOriginY + PARTICLE_SPAWN_OFFSET,
+                   static_cast<int>( PARTICLE_SPAWN_RANGE ) + PARTICLE_SIZE, static_cast<int>( PARTICLE_SPAWN_RANGE ) + PARTICLE_SIZE };
+}
+
+
+void ParticleEmitter::update(void)
+{
+  const int steps = SDL_max( mCatchUpFrames, 1 );
+
+  mCatchUpFrames = 0;
+
+  for( int i = 0; i != steps; ++i )
   {
-    mParticles[ i ] = new Particle( mPosX, mPosY );
+    step();
   }
 }
 
 
-Dot::~Dot(void)
+/**
+ * @brief Once a particle has rendered for a max of 10 frames, it is dead and its slot goes back to
+ * the free list; free slots are then filled with new particles around the origin, as many as the
+ * level of detail allows.
+ **/
+void ParticleEmitter::step(void)
 {
-  // Delete particles
-  for( int i = 0; i != TOTAL_PARTICLES; ++i )
+  const int capacity = static_cast<int>( mAlive.size() );
+
+  // Animate
+  for( int i = 0; i != capacity; ++i )
+  {
+    if( mAlive[ i ] && ++mFrame[ i ] > PARTICLE_MAX_FRAME )
+    {
+      mAlive[ i ] = false;
+      mFreeList.push_back( i );
+      --mLiveCount;
+    }
+    else { /* Free slot, or particle not dead yet */ }
+  }
+
+  // Replace dead particles
+  for( int spawned = 0; !mFreeList.empty() && mLiveCount < mMaxLive && spawned != mMaxSpawns; ++spawned )
   {
-    delete mParticles[ i ];
+    const int i = mFreeList.back();
+    mFreeList.pop_back();
+
+    // Set offsets
+    mPosX[ i ] = mOriginX + PARTICLE_SPAWN_OFFSET + static_cast<int>( mRandom.next( PARTICLE_SPAWN_RANGE ) );
+    mPosY[ i ] = mOriginY + PARTICLE_SPAWN_OFFSET + static_cast<int>( mRandom.next( PARTICLE_SPAWN_RANGE ) );
+
+    // Initialize animation (randomizzazione di mFrame per migliorare l'effetto scintillio)
+    mFrame[ i ] = static_cast<Uint8>( mRandom.next( 5 ) );
+
+    // Set type
+    mType[ i ] = static_cast<Uint8>( mRandom.next( PARTICLE_TYPES ) );
+
+    mAlive[ i ] = true;
+    ++mLiveCount;
   }
 }
 
 
+void ParticleEmitter::render( ParticleBatch& batch, int camX, int camY ) const
+{
+  const int capacity = static_cast<int>( mAlive.size() );
+
+  for( int i = 0; i != capacity; ++i )
+  {
+    if( !mAlive[ i ] )
+    {
+      continue;
+    }
+    else { /* Live particle */ }
+
+    // Show image
+    batch.add( static_cast<AtlasSprite>( mType[ i ] ), mPosX[ i ] - camX, mPosY[ i ] - camY );
+
+    // Show shimmer
+    if( mFrame[ i ] % 2 == 0 )
+    {
+      batch.add( AtlasSprite::shimmer, mPosX[ i ] - camX, mPosY[ i ] - camY );
+    }
+    else { /* No shimmer to show */ }
+  }
+}
+
+
+ParticleWorkers::ParticleWorkers(void)
+  : mStartSemaphore( NULL ), mDoneSemaphore( NULL ), mEmitters( NULL ), mEmitterCount( 0 ),
+    mBlockCount( 0 ), mNextBlock(), mQuit( false )
+{;}
+
+
+ParticleWorkers::~ParticleWorkers(void)
+{
+  stop();
+}
+
+
+void ParticleWorkers::start(void)
+{
+  stop();
+
+  const int workers = SDL_min( SDL_GetCPUCount() - 1, MAX_WORKERS );
+
+  mStartSemaphore = SDL_CreateSemaphore( 0 );
+  mDoneSemaphore  = SDL_CreateSemaphore( 0 );
+
+  if( workers <= 0 || mStartSemaphore == NULL || mDoneSemaphore == NULL )
+  {
+    return; // Single core, or no semaphores: update on the calling thread
+  }
+  else { /* Start the workers */ }
+
+  mQuit = false;
+
+  for( int i = 0; i != workers; ++i )
+  {
+    SDL_Thread* thread = SDL_CreateThread( workerThread, "ParticleWorker", this );
+
+    if( thread == NULL )
+    {
+      printf( "\nUnable to create particle worker! SDL Error: %s", SDL_GetError() );
+      break;
+    }
+    else
+    {
+      mThreads.push_back( thread );
+    }
+  }
+
+  printf( "\nOK: %d particle workers started", static_cast<int>( mThreads.size() ) );
+}
+
+
+void ParticleWorkers::stop(void)
+{
+  mQuit = true;
+
+  for( size_t i = 0; i != mThreads.size(); ++i )
+  {
+    SDL_SemPost( mStartSemaphore );
+  }
+
+  for( SDL_Thread* thread : mThreads )
+  {
+    SDL_WaitThread( thread, NULL );
+  }
+
+  mThreads.clear();
+
+  if( mStartSemaphore != NULL ) { SDL_DestroySemaphore( mStartSemaphore ); mStartSemaphore = NULL; } else { /*  */ }
+  if( mDoneSemaphore  != NULL ) { SDL_DestroySemaphore( mDoneSemaphore  ); mDoneSemaphore  = NULL; } else { /*  */ }
+}
+
+
+void ParticleWorkers::update( ParticleEmitter* const* emitters, int count )
+{
+  const int threads = static_cast<int>( mThreads.size() ) + 1;
+
+  mEmitters     = emitters;
+  mEmitterCount = count;
+  mBlockCount   = SDL_min( count, threads * BLOCKS_PER_THREAD );
+  SDL_AtomicSet( &mNextBlock, 0 );
+
+  // Wake the workers; the semaphore also publishes the fields above to them
+  for( size_t i = 0; i != mThreads.size(); ++i )
+  {
+    SDL_SemPost( mStartSemaphore );
+  }
+
+  // Help with the blocks
+  runBlocks();
+
+  // Frame barrier: wait for every worker to run out of blocks
+  for( size_t i = 0; i != mThreads.size(); ++i )
+  {
+    SDL_SemWait( mDoneSemaphore );
+  }
+}
+
+
+int ParticleWorkers::workerThread( void* data )
+{
+  ParticleWorkers* workers = static_cast<ParticleWorkers*>( data );
+
+  for( ;; )
+  {
+    SDL_SemWait( workers->mStartSemaphore );
+
+    if( workers->mQuit )
+    {
+      break;
+    }
+    else { /* A new frame */ }
+
+    workers->runBlocks();
+
+    SDL_SemPost( workers->mDoneSemaphore );
+  }
+
+  return 0;
+}
+
+
+void ParticleWorkers::runBlocks(void)
+{
+  for( int block = SDL_AtomicAdd( &mNextBlock, 1 ); block < mBlockCount; block = SDL_AtomicAdd( &mNextBlock, 1 ) )
+  {
+    // Contiguous range of emitters, sizes differing by one at most
+    const int first = block       * mEmitterCount / mBlockCount;
+    const int last  = ( block + 1 ) * mEmitterCount / mBlockCount;
+
+    for( int i = first; i != last; ++i )
+    {
+      mEmitters[ i ]->update();
+    }
+  }
+}
+
+
+Dot::Dot(void)
+  : mParticles( TOTAL_PARTICLES )
+{
+  // Initialize the offsets
+  mPosX = 0;
+  mPosY = 0;
+
+  // Initialize the velocity
+  mVelX = 0;
+  mVelY = 0;
+}
+
+
 void Dot::handleEvent( SDL_Event& e )
 {
     // If a key was pressed
@@ -551,7 +1136,7 @@ void Dot::move(void)
   mPosX += mVelX;
 
   // If the dot went too far to the left or right
-  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > WINDOW_W ) )
+  if( ( mPosX < 0 ) || ( mPosX + DOT_WIDTH > LEVEL_W ) )
   {
     // Move back
     mPosX -= mVelX;
@@ -561,43 +1146,42 @@ void Dot::move(void)
   mPosY += mVelY;
 
   // If the dot went too far up or down
-  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > WINDOW_H ) )
+  if( ( mPosY < 0 ) || ( mPosY + DOT_HEIGHT > LEVEL_H ) )
   {
     // Move back
     mPosY -= mVelY;
   }
+
+  // New particles spawn where the dot is now
+  mParticles.setOrigin( mPosX, mPosY );
 }
 
 
-void Dot::render(void)
+ParticleEmitter* Dot::getParticles(void)
 {
-  // Show the dot
-  gDotTexture.render( mPosX, mPosY );
+  return &mParticles;
+}
+
 
-  // Show particles on top of dot
-  renderParticles();
+/**
+ * @brief Shows the dot; its particles are queued with those of the scene and drawn on top of it by
+ * the batch flush, after every object has been rendered.
+ **/
+void Dot::render( const SDL_Rect& camera )
+{
+  gDotTexture.render( mPosX - camera.x, mPosY - camera.y );
 }
 
 
-void Dot::renderParticles(void)
+int Dot::getPosX(void) const
 {
-  // Go through particles
-  for( int i = 0; i != TOTAL_PARTICLES; ++i )
-  {
-    // Delete and replace dead particles
-    if( mParticles[ i ]->isDead() )
-    {
-      delete mParticles[ i ];
-      mParticles[ i ] = new Particle( mPosX, mPosY );
-    }
-    else { /* Particle not dead yet */ }
-  }
+  return mPosX;
+}
 
-  // Show particles
-  for( int i = 0; i != TOTAL_PARTICLES; ++i )
-  {
-    mParticles[ i ]->render();
-  }
+
+int Dot::getPosY(void) const
+{
+  return mPosY;
 }
 
 
@@ -652,7 +1236,7 @@ static bool init(void)
       printf( "\nOK: window created" );
 
       // Create renderer for window
-      gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+      gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE );
 
       if( gRenderer == NULL )
       {
@@ -746,13 +1330,25 @@ static bool loadMedia(void)
   gBlueTexture.setAlpha( ALPHA );
   gShimmerTexture.setAlpha( ALPHA );
 
+  // Pack the particle textures into a single one
+  if( success && !gParticleBatch.buildAtlas() )
+  {
+    printf( "Failed to build the particle atlas!\n" );
+    success = false;
+  }
+  else { /* Atlas ready, or textures missing */ }
+
   return success;
 }
 
 
 static void close(void)
 {
+  // Join the particle workers
+  gParticleWorkers.stop();
+
   // Free loaded images
+  gParticleBatch.free();
   gDotTexture.free();
   gRedTexture.free();
   gGreenTexture.free();
@@ -771,6 +1367,100 @@ static void close(void)
 }
 
 
+/**
+ * @brief Fills the level with emitters, one in each cell of the scene at a random spot of the cell,
+ * the same at every run. The list of all the emitters starts with the dot's.
+ **/
+static void buildScene( ParticleEmitter* dotParticles )
+{
+  FastRandom layout( 38 );
+
+  // Reserved in full: the emitters are not moved once their addresses are in the lists
+  gSceneEmitters.reserve( SCENE_EMITTERS );
+  gEmitters.reserve( SCENE_EMITTERS + 1 );
+  gAwakeEmitters.reserve( SCENE_EMITTERS + 1 );
+
+  gEmitters.push_back( dotParticles );
+
+  for( int y = 0; y != LEVEL_H / SCENE_CELL; ++y )
+  {
+    for( int x = 0; x != LEVEL_W / SCENE_CELL; ++x )
+    {
+      gSceneEmitters.emplace_back( TOTAL_PARTICLES );
+      gSceneEmitters.back().setOrigin( x * SCENE_CELL + static_cast<int>( layout.next( SCENE_CELL ) ),
+                                       y * SCENE_CELL + static_cast<int>( layout.next( SCENE_CELL ) ) );
+      gEmitters.push_back( &gSceneEmitters.back() );
+    }
+  }
+}
+
+
+/**
+ * @brief Finds the emitters in view: those whose bounds touch a view are woken, if asleep, and
+ * given a level of detail by their distance from the centre of the nearest view; the others are
+ * put to sleep. The awake ones end up in gAwakeEmitters, the only ones updated and drawn.
+ *
+ * @param views     The areas of the level seen this frame
+ * @param viewCount How many
+ * @param frame     The current frame, for the sleeping time
+ **/
+static void cullEmitters( const SDL_Rect* views, int viewCount, Uint32 frame )
+{
+  gAwakeEmitters.clear();
+
+  for( ParticleEmitter* emitter : gEmitters )
+  {
+    const SDL_Rect bounds = emitter->getBounds();
+
+    // Squared distance from the nearest view it is in; negative if in none
+    int distance2 = -1;
+
+    for( int v = 0; v != viewCount; ++v )
+    {
+      if( SDL_HasIntersection( &bounds, &views[ v ] ) )
+      {
+        const int dx = bounds.x + bounds.w / 2 - ( views[ v ].x + views[ v ].w / 2 );
+        const int dy = bounds.y + bounds.h / 2 - ( views[ v ].y + views[ v ].h / 2 );
+
+        distance2 = ( distance2 < 0 ) ? dx * dx + dy * dy : SDL_min( distance2, dx * dx + dy * dy );
+      }
+      else { /* Not in this view */ }
+    }
+
+    if( distance2 < 0 )
+    {
+      if( !emitter->isAsleep() )
+      {
+        emitter->sleep( frame );
+      }
+      else { /* Asleep already */ }
+
+      continue;
+    }
+    else if( emitter->isAsleep() )
+    {
+      emitter->wake( frame );
+    }
+    else { /* Awake already */ }
+
+    if( distance2 <= LOD_NEAR * LOD_NEAR )
+    {
+      emitter->setDetail( TOTAL_PARTICLES, TOTAL_PARTICLES );
+    }
+    else if( distance2 <= LOD_FAR * LOD_FAR )
+    {
+      emitter->setDetail( TOTAL_PARTICLES / 2, TOTAL_PARTICLES / 4 );
+    }
+    else
+    {
+      emitter->setDetail( TOTAL_PARTICLES / 4, 1 );
+    }
+
+    gAwakeEmitters.push_back( emitter );
+  }
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -798,8 +1488,13 @@ int main( int argc, char* args[] )
     printf("\nArgument #%d: %s\n", i, args[i]);
   }
 
+  // "--perf-frames=<N>" runs a scripted, headless performance check
+  if( !LPerfHarness::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   // Start up SDL and create window
-  if( !init() )
+  else if( !init() )
   {
     printf( "\nFailed to initialize!" );
   }
@@ -825,9 +1520,23 @@ int main( int argc, char* args[] )
       // The dot that will be moving around on the screen
       Dot dot;
 
+      // Every particle emitter of the scene, the dot's first
+      buildScene( dot.getParticles() );
+
+      gParticleWorkers.start();
+
+      // The area of the level in view, following the dot
+      SDL_Rect camera{ 0, 0, WINDOW_W, WINDOW_H };
+
+      Uint32 frame        = 0;
+      Uint64 awakeInTotal = 0;
+
       // While application is running
       while( !quit )
       {
+        // Scripted input of this frame, if any
+        LPerfHarness::beginFrame();
+
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
         {
@@ -844,21 +1553,48 @@ int main( int argc, char* args[] )
         // Move the dot
         dot.move();
 
+        // Centre the camera over the dot, inside the level
+        camera.x = SDL_clamp( dot.getPosX() + Dot::DOT_WIDTH  / 2 - WINDOW_W / 2, 0, LEVEL_W - WINDOW_W );
+        camera.y = SDL_clamp( dot.getPosY() + Dot::DOT_HEIGHT / 2 - WINDOW_H / 2, 0, LEVEL_H - WINDOW_H );
+
+        // Only the emitters in view are updated and drawn
+        cullEmitters( &camera, 1, ++frame );
+        awakeInTotal += gAwakeEmitters.size();
+
+        // Update the particles on all cores; returns once all of them are done
+        gParticleWorkers.update( gAwakeEmitters.data(), static_cast<int>( gAwakeEmitters.size() ) );
+
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
         // Render objects
-        dot.render();
+        dot.render( camera );
+
+        for( const ParticleEmitter* emitter : gAwakeEmitters )
+        {
+          emitter->render( gParticleBatch, camera.x, camera.y );
+        }
+
+        // Draw all the particles at once
+        gParticleBatch.flush();
 
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        LPerfHarness::endFrame();
       }
+
+      printf( "\nParticle emitters: %d, %.1f awake per frame on average", static_cast<int>( gEmitters.size() ),
+              ( frame > 0 ) ? static_cast<double>( awakeInTotal ) / frame : 0.0 );
     }
   }
 
   close(); // Free resources and close SDL
 
+  // Frame times, allocations and draw calls against the budget, if it was a performance run
+  HasProgramSucceeded = LPerfHarness::finish() && HasProgramSucceeded;
+
   // Integrity check
   if ( HasProgramSucceeded == true )
   {
@@ -869,7 +1605,12 @@ int main( int argc, char* args[] )
     printf("\nThere was a problem during the execution of the program!\n");
   }
 
-  PressEnter();
+  // Nobody to press ENTER during a performance run
+  if( !LPerfHarness::isActive() )
+  {
+    PressEnter();
+  }
+  else { /* Headless */ }
 
-  return 0;
+  return HasProgramSucceeded ? 0 : 1;
 }
\ No newline at end of file
@@ -42,6 +42,60 @@
  *   the type is between TILE_CENTER and TILE_TOPLEFT. If the given collision box collides with any
  *   tile that is a wall, this function returns true.
  * - In the main function right before we load the media we declare our array of tile pointers.
+ * - Modifica GS: le tile non sono più 192 oggetti allocati con new, ma un unico array piatto di
+ *   uint8_t in "TileMap". La mappa si carica dal formato binario "lazy.tmap" (header più tipi delle
+ *   tile a blocchi di TILE_MAP_CHUNK x TILE_MAP_CHUNK), mappato in memoria; il vecchio "lazy.map"
+ *   testuale si usa solo se manca il binario, che in quel caso viene generato.
+ * - Modifica GS: il rendering non controlla più tutte le tile contro la telecamera. L'intervallo di
+ *   tile visibili si calcola direttamente dal rettangolo della telecamera, e la mappa si disegna a
+ *   blocchi di RENDER_CHUNK x RENDER_CHUNK tile, ognuno pre-renderizzato una volta in una texture
+ *   target (come in 43_render_to_texture) e ridisegnato solo quando cambia: ogni frame costa
+ *   qualche SDL_RenderCopy per i blocchi visibili, qualunque sia la dimensione del mondo.
+ * - Modifica GS: "touchesWall" non scorre più tutte le tile: controlla solo quelle sotto il box,
+ *   calcolate da TILE_W/TILE_H, in un bitset dei muri costruito al caricamento della mappa.
+ * - Modifica GS: la mappa si modifica mentre il programma gira, con "TileMapEditor": clic sinistro
+ *   per un muro, destro per il pavimento (anche trascinando), S per salvare "lazy.tmap". I muri
+ *   scelgono da soli lo sprite (bordo, angolo o centro) secondo i quattro vicini, che vengono
+ *   ricalcolati a ogni modifica; si invalidano solo i blocchi di rendering e i bit dei muri delle
+ *   tile cambiate.
+ * - Modifica GS: la mappa non è più un array denso di un byte per tile, che per i livelli più grandi
+ *   occupava gigabyte: "TileMap" la divide in blocchi di TILE_MAP_CHUNK x TILE_MAP_CHUNK tile, e un
+ *   blocco di un solo tipo (pavimento, interno di un muro) è un solo valore, mentre gli altri sono
+ *   righe di "run" (tipo, colonna di fine). La memoria cresce con quanto la mappa varia, più 4 byte
+ *   per blocco, non con la sua area. Il bitset dei muri non c'è più: un muro si riconosce dal tipo.
+ *   "lazy.tmap" si salva nella versione 2 del formato, con i blocchi così come sono in memoria; la
+ *   versione 1, densa, si legge ancora, un blocco alla volta senza una copia densa della mappa.
+ * - Aggiunta GS: F3 mostra l'overlay di debug di Engine_Lib/LDebugDraw: la griglia delle tile in
+ *   vista, i blocchi disegnati, e le tile che "touchesWall" controlla sotto il dot, piene se muri.
+ *   Le forme sono in coordinate del livello, spostate dalla telecamera passata a "setCamera".
+ * - Aggiunta GS: NPC_COUNT NPC ("NpcCrowd") camminano verso la tile del dot, disegnati tutti con una
+ *   sola SDL_RenderFillRects. I percorsi vengono da Engine_Lib/LPathfinder, A* con jump point search
+ *   su una griglia di un bit per tile, riempita da "TileMap::markWalls" al caricamento e tenuta
+ *   allineata da "TileMapEditor" a ogni muro messo o tolto. Ogni frame le richieste degli NPC che
+ *   hanno bisogno di un nuovo percorso (il dot ha cambiato tile, o la mappa è cambiata) partono in un
+ *   solo blocco, risolto dai thread di LJobSystem mentre il frame continua, e i risultati si
+ *   raccolgono al frame dopo; NPC sulla stessa tile riusano il percorso dalla cache, che una modifica
+ *   della mappa svuota solo dove le ricerche hanno letto. Con F3 l'overlay mostra i percorsi.
+ * - Aggiunta GS: il livello è illuminato da Engine_Lib/LLightMap. Le torce, una ogni TORCH_STRIDE
+ *   tile di pavimento, sono luci statiche: si disegnano una volta nel loro layer, grande quanto il
+ *   livello a un quarto della risoluzione, e di nuovo solo quando L le spegne o le riaccende. Il dot
+ *   e le lanterne dei primi NPC_LANTERNS NPC sono luci dinamiche, aggiunte ogni frame fra "begin" e
+ *   "render". Il buffer delle luci, anch'esso ridotto, parte dal colore ambiente, riceve la parte in
+ *   vista del layer statico e tutte le luci dinamiche con una sola SDL_RenderGeometry, e si stende
+ *   sulla scena con una sola copia in modalità SDL_BLENDMODE_MOD: qualche draw call per frame
+ *   invece di una passata a schermo intero per luce.
+ * - Aggiunta GS: con "--perf-frames=<N>" il programma gira senza finestra per N frame, con l'input
+ *   di "--perf-script" (anche clic e trascinamenti sull'editor), e fallisce se i tempi, le
+ *   allocazioni o le draw call per frame superano "--perf-budget" (Engine_Lib/LPerfHarness).
+ * - Aggiunta GS: all'uscita il programma salva un'istantanea, "lazy.snap" (Engine_Lib/LSnapshot),
+ *   dell'intero stato: mappa, muri del pathfinder, torce, dot e NPC. Le sezioni sono dati semplici,
+ *   senza puntatori (indici al loro posto), allineate per essere usate dove sono mappate. All'avvio
+ *   seguente, se l'istantanea è valida, "loadMedia" carica solo le texture e salta "setTiles" e
+ *   "markWalls": "TileMap::adoptImage" legge le voci dei blocchi e le run direttamente dal file
+ *   mappato, e LPathfinder usa i bit dei muri sul posto. Si copia solo alla prima modifica: le voci
+ *   dei blocchi (4 byte per blocco), le run dei soli blocchi cambiati, la griglia del pathfinder.
+ *   Anche "TileChunkCache" non tiene più una tabella di tutti i blocchi, così la ripresa costa lo
+ *   stesso qualunque sia la dimensione del mondo; il tempo è stampato all'avvio.
  * - Our main loop is pretty much the same, with some adjustments. When we move the dot, we pass in
  *   the tile set and then set the camera over the dot after it moved. We then render the tile set
  *   and finally render the dot over the level.
@@ -61,6 +115,28 @@
 #include <stdio.h>
 #include <string>
 #include <fstream>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include "LDebugDraw.hpp"
+#include "LJobSystem.hpp"
+#include "LLightMap.hpp"
+#include "LPathfinder.hpp"
+#include "LPerfHarness.hpp"
+#include "LRenderTargets.hpp"
+#include "LSnapshot.hpp"
+
+// Memory mapped files
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
 
 
 /**************************************************************************************************
@@ -72,9 +148,10 @@ static constexpr int FIRST_ONE = -1;
 static constexpr int WINDOW_W = 800; // Screen's width
 static constexpr int WINDOW_H = 600; // Screen's heigth
 
-// The dimensions of the level
-static constexpr int LEVEL_W = 1280;
-static constexpr int LEVEL_H = 960;
+// The dimensions of lazy.map, in tiles: the text format has no header. The binary maps store their
+// own dimensions, and the level is as large as the loaded map
+static constexpr int LAZY_MAP_W = 16;
+static constexpr int LAZY_MAP_H = 12;
 
 // Colore bianco
 static constexpr int WHITE_R = 0xFF; // Amount of red   needed to compose white
@@ -88,12 +165,64 @@ static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
 static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
 static constexpr int CYAN_A = 0xFF; // Alpha component
 
+// Overlay di debug (F3)
+static constexpr SDL_Color TileGridColour   { 0x00, 0x00, 0x00, 0x60 };
+static constexpr SDL_Color ChunkColour      { 0x00, 0x00, 0xFF, 0xFF };
+static constexpr SDL_Color CheckedTileColour{ 0xFF, 0xD7, 0x00, 0xFF };
+static constexpr SDL_Color HitWallColour    { 0xFF, 0x00, 0x00, 0x60 };
+static constexpr SDL_Color DotBoxColour     { 0x00, 0xC0, 0x00, 0xFF };
+static constexpr SDL_Color NpcPathColour    { 0xFF, 0x00, 0xFF, 0xFF };
+
+// Colore degli NPC
+static constexpr SDL_Color NpcColour{ 0x80, 0x00, 0x80, 0xFF };
+
+// Luci: la penombra dove non arrivano, le torce fisse sul pavimento, il dot e le lanterne degli NPC
+static constexpr SDL_Color AmbientColour{ 0x30, 0x30, 0x50, 0xFF };
+static constexpr SDL_Color TorchColour  { 0xFF, 0xB0, 0x60, 0xFF };
+static constexpr SDL_Color DotLightColour{ 0xFF, 0xFF, 0xE0, 0xFF };
+static constexpr SDL_Color LanternColour{ 0xA0, 0xC0, 0xFF, 0xC0 };
+
 // Tile constants
 static constexpr int TILE_W = 80;
 static constexpr int TILE_H = 80;
-static constexpr int TOTAL_TILES = 192;
+static constexpr int TOTAL_TILES = LAZY_MAP_W * LAZY_MAP_H;
 static constexpr int TOTAL_TILE_SPRITES = 12;
 
+// Lights, radii in pixels
+static constexpr int   TORCH_STRIDE     = 4;    // A torch every TORCH_STRIDE tiles, on floor tiles
+static constexpr int   MAX_TORCHES      = 64;
+static constexpr float TORCH_RADIUS     = 2.5f * TILE_W;
+static constexpr float DOT_LIGHT_RADIUS = 3.0f * TILE_W;
+static constexpr float LANTERN_RADIUS   = 1.0f * TILE_W;
+
+// Binary tile map format
+static constexpr char   TILE_MAP_MAGIC[ 4 ] = { 'L', 'T', 'M', 'P' };
+static constexpr Uint32 TILE_MAP_VERSION    = 2;    // Sparse chunks; version 1, dense, is still read
+static constexpr Uint32 TILE_MAP_DENSE      = 1;
+static constexpr int    TILE_MAP_CHUNK      = 16;   // Chunk side, in tiles, in memory and when saving
+static constexpr Uint8  TILE_MAP_RLE        = 0xFF; // Marks a chunk saved as runs
+static constexpr size_t TILE_MAP_WRITE_BLOCK = 64 * 1024;
+
+// Snapshot of the whole program, and the tags of its sections
+static constexpr Uint32 SNAPSHOT_VERSION       = 1;
+static constexpr Uint32 SNAPSHOT_MAP           = LSnapshotTag( 'T', 'M', 'A', 'P' );  // TileMapHeader
+static constexpr Uint32 SNAPSHOT_CHUNKS        = LSnapshotTag( 'T', 'C', 'H', 'K' );  // Entries of the chunks
+static constexpr Uint32 SNAPSHOT_RUN_CHUNKS    = LSnapshotTag( 'T', 'R', 'C', 'K' );
+static constexpr Uint32 SNAPSHOT_RUNS          = LSnapshotTag( 'T', 'R', 'U', 'N' );
+static constexpr Uint32 SNAPSHOT_WALLS         = LSnapshotTag( 'W', 'A', 'L', 'L' );  // Cells of the pathfinder
+static constexpr Uint32 SNAPSHOT_TORCHES       = LSnapshotTag( 'T', 'O', 'R', 'C' );
+static constexpr Uint32 SNAPSHOT_SCENE         = LSnapshotTag( 'S', 'C', 'N', 'E' );  // SceneImage
+static constexpr Uint32 SNAPSHOT_NPCS          = LSnapshotTag( 'N', 'P', 'C', 'S' );
+static constexpr Uint32 SNAPSHOT_NPC_PATHS     = LSnapshotTag( 'N', 'P', 'T', 'H' );
+
+// Render chunks: side in tiles and in pixels, and how many chunk textures are kept. At most
+// ( WINDOW / CHUNK + 2 ) chunks per axis can be on screen at once; the rest of the cache lets
+// chunks just scrolled off the screen come back without being redrawn
+static constexpr int RENDER_CHUNK        = 8;
+static constexpr int RENDER_CHUNK_W      = RENDER_CHUNK * TILE_W;
+static constexpr int RENDER_CHUNK_H      = RENDER_CHUNK * TILE_H;
+static constexpr int RENDER_CHUNK_SLOTS  = 2 * ( WINDOW_W / RENDER_CHUNK_W + 2 ) * ( WINDOW_H / RENDER_CHUNK_H + 2 );
+
 // The different tile sprites
 enum TileTypes
 {
@@ -111,11 +240,19 @@ enum TileTypes
   TILE_TOPLEFT
 };
 
+// Wall tiles are TILE_CENTER to TILE_TOPLEFT
+static constexpr bool isWallType( int type )
+{
+  return ( type >= TILE_CENTER ) && ( type <= TILE_TOPLEFT );
+}
+
 /* Paths */
 
 static const std::string g_DotPath  ( "dot.bmp" );
 static const std::string g_TilesPath( "tiles.png" );
 static const std::string g_LazyMap  ( "lazy.map" );
+static const std::string g_LazyTMap ( "lazy.tmap" );
+static const std::string g_LazySnap ( "lazy.snap" );
 
 
 /***************************************************************************************************
@@ -135,6 +272,9 @@ class LTexture
   // Loads image at specified path
   bool loadFromFile( const std::string& );
 
+  // Creates blank texture
+  bool createBlank( int, int, SDL_TextureAccess = SDL_TEXTUREACCESS_STREAMING );
+
     #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
   bool loadFromRenderedText( const std::string&, SDL_Color );
@@ -155,6 +295,9 @@ class LTexture
   // Renders texture at given point
   void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
 
+  // Set self as render target
+  void setAsRenderTarget(void);
+
   // Gets image dimensions
   int getWidth (void) const;
   int getHeight(void) const;
@@ -171,30 +314,271 @@ class LTexture
 
 
 /**
- * @brief The tile
+ * @brief Header of a binary tile map. It is followed by its chunks of ChunkW x ChunkH tiles, row by
+ * row. Fields are in the byte order of the machine that saved the map.
+ *
+ * Version 2 (TILE_MAP_VERSION) has chunks of TILE_MAP_CHUNK tiles and stores them as in TileMap: a
+ * uniform chunk is the byte of its tile type; any other one is TILE_MAP_RLE and then its rows, each
+ * one the number of its runs followed by the runs as (type, end column) pairs. Chunks on the right
+ * and bottom edges only hold the tiles inside the map.
+ *
+ * Version 1 (TILE_MAP_DENSE) has the tile types of each chunk, one byte each, row by row, with the
+ * edge chunks padded to full size.
+ **/
+struct TileMapHeader
+{
+  char   Magic[ 4 ]; // TILE_MAP_MAGIC
+  Uint32 Version;    // TILE_MAP_VERSION
+  Uint32 Width;      // In tiles
+  Uint32 Height;     // In tiles
+  Uint32 ChunkW;     // In tiles
+  Uint32 ChunkH;     // In tiles
+};
+
+static_assert( sizeof(TileMapHeader) == 24, "The tile map header must have no padding" );
+
+
+/**
+ * @brief The level, in chunks of TILE_MAP_CHUNK x TILE_MAP_CHUNK tiles. A chunk of one tile type
+ * only, such as the inside of a wall or a stretch of floor, is that type, in the entry the chunk has
+ * in a flat array; any other chunk is a list of runs of tiles of the same type, row by row. Memory
+ * grows with how much the map changes from tile to tile, plus 4 bytes a chunk, rather than with its
+ * area: a map of 32768 x 32768 tiles of plain floor takes 16 MB.
+ *
+ * A tile's box follows from its column and row, and whether it is a wall from its type, so nothing
+ * else is stored per tile. Reading a tile looks at its chunk and at most the runs of its row; a
+ * change decodes its chunk and encodes it again.
+ *
+ * A map resumed from a snapshot ("adoptImage") holds no tile: it reads the entries and the runs
+ * where the snapshot is mapped, and only copies what it changes.
+ **/
+class TileMap
+{
+  public:
+
+  TileMap(void);
+
+  // Loads a binary map, mapping the file in memory
+  bool loadBinary( const std::string& );
+
+  // Loads a text map of the given size in tiles, like lazy.map
+  bool loadText( const std::string&, int, int );
+
+  // Saves the map in the binary format
+  bool saveBinary( const std::string& ) const;
+
+  // Dimensions, in tiles
+  int getWidth (void) const;
+  int getHeight(void) const;
+
+  // Dimensions, in pixels
+  int getLevelWidth (void) const;
+  int getLevelHeight(void) const;
+
+  // Type and collision box of the tile at the given column and row
+  int      getType( int, int ) const;
+  SDL_Rect getBox ( int, int ) const;
+
+  // Columns and rows of the tiles overlapping an area of the level
+  SDL_Rect getTileRange( const SDL_Rect& ) const;
+
+  // Whether the tile at the given column and row is a wall
+  bool isWall( int, int ) const;
+
+  // Whether the given column and row are inside the map
+  bool contains( int, int ) const;
+
+  // Changes the type of a tile; false if it was already that type
+  bool setType( int, int, int );
+
+  // Wall sprite that fits the walls around the given tile
+  int getWallAutotile( int, int ) const;
+
+  // Chunks of a single type, and the bytes taken by the tiles
+  size_t getUniformChunks(void) const;
+  size_t getMemoryBytes  (void) const;
+
+  // Blocks the cells of the walls in a pathfinder of the map's size
+  void markWalls( LPathfinder& ) const;
+
+  // Saves the map into sections of a snapshot, and resumes it from them in place
+  void saveImage ( LSnapshotWriter& ) const;
+  bool adoptImage( const LSnapshotImage& );
+
+  private:
+
+  // Tiles of the same type next to each other in a row of a chunk, up to column End excluded
+  struct Run
+  {
+    Uint8 Type;
+    Uint8 End;
+  };
+
+  // A chunk of several types: the runs of its rows, row r from Runs[ RowStarts[ r ] ]
+  struct RunChunk
+  {
+    Uint16           RowStarts[ TILE_MAP_CHUNK + 1 ];
+    std::vector<Run> Runs;
+  };
+
+  // A run chunk in a snapshot: its runs are those of the pool from FirstRun on
+  struct ImageRunChunk
+  {
+    Uint16 RowStarts[ TILE_MAP_CHUNK + 1 ];
+    Uint16 Padding;
+    Uint32 FirstRun;
+  };
+
+  static_assert( sizeof(ImageRunChunk) == 40, "The run chunks of a snapshot must have no padding" );
+
+  // Where the runs of a chunk stored as runs are, in memory or in a snapshot
+  struct RunsView
+  {
+    const Uint16* RowStarts;
+    const Run*    Runs;
+  };
+
+  // Set in the entry of a chunk stored as runs, whose index in mRunChunks is in the other bits
+  static constexpr Uint32 RUN_CHUNK = 0x80000000u;
+
+  // Set too when the runs are in the snapshot, the index being in mImageRunChunks
+  static constexpr Uint32 IMAGE_CHUNK = 0x40000000u;
+
+  // Empties the map and sizes it, every chunk TILE_RED
+  void reset( int, int );
+
+  bool loadDense ( const TileMapHeader&, const Uint8*, size_t, const std::string& );
+  bool loadSparse( const TileMapHeader&, const Uint8*, size_t, const std::string& );
+
+  // Tiles of a chunk inside the map, and its index
+  int getChunkW( int ) const;
+  int getChunkH( int ) const;
+  int getChunk ( int, int ) const;
+
+  // Stores the tiles of a chunk, TILE_MAP_CHUNK to a row, uniform or as runs
+  void encodeChunk( int, const Uint8* );
+
+  // Writes the tiles of a chunk, TILE_MAP_CHUNK to a row
+  void decodeChunk( int, Uint8* ) const;
+
+  // Entry of a chunk, and the runs of an entry with RUN_CHUNK
+  Uint32   getEntry( int ) const;
+  RunsView getRuns ( Uint32 ) const;
+
+  // Copies the entries of a resumed map out of the snapshot, before the first change
+  void ownEntries(void);
+
+  // Per chunk, row by row: its tile type if uniform, or RUN_CHUNK and its index in mRunChunks.
+  // Empty while a resumed map reads the entries of the snapshot
+  std::vector<Uint32> mChunks;
+
+  // The chunks stored as runs, and those freed by chunks that became uniform, to be reused
+  std::vector<RunChunk> mRunChunks;
+  std::vector<Uint32>   mFreeRunChunks;
+
+  // Of a map resumed from a snapshot: its entries until the first change, its run chunks and their
+  // runs for as long as a chunk uses them
+  const Uint32*        mImageChunks;
+  const ImageRunChunk* mImageRunChunks;
+  const Run*           mImageRuns;
+
+  // Dimensions, in tiles and in chunks
+  int mWidth, mHeight;
+  int mChunksX, mChunksY;
+};
+
+
+/**
+ * @brief Draws a TileMap in chunks of RENDER_CHUNK x RENDER_CHUNK tiles, each one rendered once into
+ * a target texture and then drawn with a single copy. A fixed set of textures is shared among the
+ * chunks in view, recycling the one unused for the longest time; a chunk is redrawn only when it
+ * gets a texture or is invalidated.
+ **/
+class TileChunkCache
+{
+  public:
+
+  TileChunkCache(void);
+
+  // Sizes the cache for a map; the textures are created on first use
+  void init( const TileMap& );
+
+  // Marks the chunk holding the given tile as changed
+  void invalidate( int, int );
+
+  // Marks every cached chunk as changed, e.g. when the renderer lost its targets
+  void invalidateAll(void);
+
+  // Renders the chunks seen by the camera
+  void render( const TileMap&, const SDL_Rect& );
+
+  // Deallocates the chunk textures
+  void free(void);
+
+  private:
+
+  // Chunk texture and the chunk it last held
+  struct Slot
+  {
+    LTexture Texture;
+    int      Chunk    = -1;
+    Uint32   LastUsed = 0;
+    bool     Dirty    = true;
+  };
+
+  // Slot holding a chunk, -1 if not cached
+  int findSlot( int ) const;
+
+  // Gets the slot of a chunk, recycling the least recently used one if it has none
+  int acquireSlot( int );
+
+  // Draws the tiles of a chunk into its slot
+  bool redrawChunk( const TileMap&, int, Slot& );
+
+  // Looked up by chunk, rather than kept in a table of every chunk of the map: the cache costs the
+  // same whatever the size of the world
+  Slot mSlots[ RENDER_CHUNK_SLOTS ];
+
+  // Dimensions, in chunks
+  int mChunksX, mChunksY;
+
+  // Frame counter, for recycling
+  Uint32 mFrame;
+
+  // Set when render targets are not available: the visible tiles are drawn directly
+  bool mDirect;
+};
+
+
+/**
+ * @brief Live editing of a TileMap. Walls are autotiled: each wall takes the edge, corner or centre
+ * sprite that matches which of its four neighbours are walls, so placing or removing one also
+ * updates its neighbours. Only the render chunks of the tiles that actually changed are invalidated,
+ * and only the cells of the pathfinder whose tile became or stopped being a wall.
  **/
-class Tile
+class TileMapEditor
 {
-    public:
+  public:
 
-    Tile( int, int, int );
+  TileMapEditor( TileMap&, TileChunkCache&, LPathfinder& );
 
-    // Shows the tile
-    void render( SDL_Rect& );
+  // Puts a wall at the given column and row
+  bool setWall( int, int );
 
-    // Get the tile type
-    int getType(void) const;
+  // Puts a floor tile of the given type at the given column and row
+  bool setFloor( int, int, int );
 
-    // Get the collision box
-    SDL_Rect getBox(void) const;
+  private:
 
-    private:
+  // Sets a tile and refreshes the autotiling around it
+  bool setTile( int, int, int );
 
-    // The attributes of the tile
-    SDL_Rect mBox;
+  // Sets a tile, invalidating its chunk if it changed
+  bool apply( int, int, int );
 
-    // The tile type
-    int mType;
+  TileMap&        mMap;
+  TileChunkCache& mChunks;
+  LPathfinder&    mPaths;
 };
 
 
@@ -216,12 +600,18 @@ class Dot
   // Takes key presses and adjusts the dot's velocity
   void handleEvent( SDL_Event& );
 
-  void move( Tile* [] );
+  void move( const TileMap& );
 
-  void setCamera( SDL_Rect& );
+  void setCamera( SDL_Rect&, const TileMap& );
 
   void render( SDL_Rect& );
 
+  // Collision box
+  const SDL_Rect& getBox(void) const;
+
+  // Puts the dot, at rest, at the given position
+  void place( int, int );
+
   private:
 
   // Collision box of the dot
@@ -232,16 +622,101 @@ class Dot
 };
 
 
+/**
+ * @brief A crowd of NPCs walking to the tile of the dot. Their paths come from the LPathfinder, in
+ * one batch a frame solved on the job system: an NPC asks for a new one when the dot changes tile
+ * or the map is edited, at most NPC_REQUESTS_PER_FRAME NPCs a frame, and keeps walking the old one
+ * until the answer comes. NPCs on the same tile share the cached path.
+ **/
+class NpcCrowd
+{
+  public:
+
+  static constexpr int NPC_COUNT              = 300;
+  static constexpr int NPC_SIZE               = 10;
+  static constexpr int NPC_VEL                = 3;
+  static constexpr int NPC_REQUESTS_PER_FRAME = 64;
+  static constexpr int NPC_LANTERNS           = 24;   // The first ones carry a light
+
+  NpcCrowd(void);
+
+  // Puts the NPCs on floor tiles spread over the map
+  void spawn( const TileMap& );
+
+  // Makes every NPC ask for a new path: the map changed
+  void repath(void);
+
+  // Hands out the paths found, asks for the missing ones and moves the NPCs along theirs
+  void update( const SDL_Rect& );
+
+  // Shows the NPCs in view with a single call, and their paths in the debug overlay
+  void render( const SDL_Rect& );
+
+  // Adds the lanterns of the NPCs that carry one to the lights of this frame
+  void addLights( LLightMap& ) const;
+
+  // Saves the NPCs into sections of a snapshot, and resumes them from those
+  void saveImage( LSnapshotWriter& ) const;
+  bool loadImage( const LSnapshotImage& );
+
+  private:
+
+  struct Npc
+  {
+    SDL_Point              Position;  // Centre, in pixels
+    SDL_Point              Goal;      // Tile its path leads to, or was asked for
+    std::vector<SDL_Point> Path;      // Tiles, from LPathfinder::Result::Points
+    size_t                 Next;      // Point of the path it walks to
+    bool                   IsWaiting; // For a path
+  };
+
+  // An NPC in a snapshot: its path is Points points of the pool from FirstPoint on
+  struct NpcImage
+  {
+    SDL_Point Position;
+    SDL_Point Goal;
+    Uint32    FirstPoint;
+    Uint32    Points;
+    Uint32    Next;
+    Uint32    IsWaiting;
+  };
+
+  std::vector<Npc>                  mNpcs;
+  std::vector<LPathfinder::Request> mRequests;
+  std::vector<LPathfinder::Result>  mResults;
+  std::vector<SDL_Rect>             mBoxes;
+
+  // Where the next frame starts looking for NPCs that need a path
+  size_t mNextRequest;
+};
+
+
+/**
+ * @brief The rest of the program in a snapshot: where the dot is, and whether the torches are lit.
+ **/
+struct SceneImage
+{
+  SDL_Point DotPosition;
+  Uint32    TorchesLit;
+  Uint32    Padding;
+};
+
+
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
 
 static bool init          ( void );
-static bool loadMedia     ( Tile* [] );
-static void close         ( Tile* [] );
-static bool checkCollision( SDL_Rect, SDL_Rect );
-static bool touchesWall   ( SDL_Rect, Tile* [] );
-static bool setTiles      ( Tile *[] );
+static bool loadMedia     ( TileMap&, bool& );
+static void close         ( void );
+static bool touchesWall   ( SDL_Rect, const TileMap& );
+static bool setTiles      ( TileMap& );
+static bool resumeLevel   ( TileMap& );
+static void resumeScene   ( const TileMap&, Dot&, NpcCrowd&, bool& );
+static bool saveSnapshot  ( const TileMap&, const Dot&, const NpcCrowd&, bool );
+static void setTileClips  ( void );
+static void renderTiles   ( const TileMap&, const SDL_Rect&, const SDL_Rect& );
+static void drawDebugOverlay( const TileMap&, const Dot&, const SDL_Rect& );
 
 
 /***************************************************************************************************
@@ -256,6 +731,20 @@ static LTexture gDotTexture;
 static LTexture gTileTexture;
 static SDL_Rect gTileClips[ TOTAL_TILE_SPRITES ];
 
+// Pre-rendered chunks of the level
+static TileChunkCache gTileChunks;
+
+// Worker threads, and the paths of the NPCs solved on them
+static LJobSystem  gJobs;
+static LPathfinder gPaths;
+
+// The light over the level, drawn into targets of the pool
+static LRenderTargetPool gTargets;
+static LLightMap         gLights;
+
+// The snapshot the program resumed from: the level and the walls of the pathfinder read it in place
+static LSnapshotImage gSnapshot;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -366,6 +855,28 @@ bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color t
 #endif
 
 
+bool LTexture::createBlank( int width, int height, SDL_TextureAccess access )
+{
+  // Get rid of preexisting texture
+  free();
+
+  // Create uninitialized texture
+  mTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, access, width, height );
+
+  if( mTexture == NULL )
+  {
+    printf( "\nUnable to create blank texture! SDL Error: \"%s\"", SDL_GetError() );
+  }
+  else
+  {
+    mWidth = width;
+    mHeight = height;
+  }
+
+  return mTexture != NULL;
+}
+
+
 void LTexture::free(void)
 {
   // Free texture if it exists
@@ -430,6 +941,14 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 
   // Render to screen
   SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+void LTexture::setAsRenderTarget(void)
+{
+  // Make self render target
+  SDL_SetRenderTarget( gRenderer, mTexture );
 }
 
 
@@ -446,140 +965,1407 @@ int LTexture::getHeight(void) const
 
 
 /**
- * @brief Initializes position and type
- *
- * @param x
- * @param y
- * @param tileType
+ * @brief Read-only memory mapping of a whole file, released on destruction.
  **/
-Tile::Tile( int x, int y, int tileType )
+class MappedFile
 {
-  // Get the offsets
-  mBox.x = x;
-  mBox.y = y;
+  public:
 
-  // Set the collision box
-  mBox.w = TILE_W;
-  mBox.h = TILE_H;
+  explicit MappedFile( const std::string& path )
+    : mData( NULL ), mSize( 0 )
+  {
+#if defined(_WIN32)
+    mFile    = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    mMapping = NULL;
 
-  // Get the tile type
-  mType = tileType;
-}
+    LARGE_INTEGER fileSize;
 
+    if( mFile != INVALID_HANDLE_VALUE && GetFileSizeEx( mFile, &fileSize ) && fileSize.QuadPart > 0 )
+    {
+      mMapping = CreateFileMappingA( mFile, NULL, PAGE_READONLY, 0, 0, NULL );
+      mData    = ( mMapping != NULL ) ? static_cast<const Uint8*>( MapViewOfFile( mMapping, FILE_MAP_READ, 0, 0, 0 ) ) : NULL;
+      mSize    = ( mData != NULL ) ? static_cast<size_t>( fileSize.QuadPart ) : 0;
+    }
+    else { /* Missing or empty file */ }
+#else
+    mFile = open( path.c_str(), O_RDONLY );
 
-void Tile::render( SDL_Rect& camera )
-{
-  // If the tile is on screen
-  if( checkCollision( camera, mBox ) )
-  {
-      // Show the tile
-      gTileTexture.render( mBox.x - camera.x, mBox.y - camera.y, &gTileClips[ mType ] );
-  }
-  else { /* Tile not on screen */ }
-}
+    struct stat fileStatus;
 
+    if( mFile >= 0 && fstat( mFile, &fileStatus ) == 0 && fileStatus.st_size > 0 )
+    {
+      void* data = mmap( NULL, static_cast<size_t>( fileStatus.st_size ), PROT_READ, MAP_PRIVATE, mFile, 0 );
 
-int Tile::getType(void) const
-{
-  return mType;
-}
+      if( data != MAP_FAILED )
+      {
+        mData = static_cast<const Uint8*>( data );
+        mSize = static_cast<size_t>( fileStatus.st_size );
+      }
+      else { /* Mapping failed */ }
+    }
+    else { /* Missing or empty file */ }
+#endif
+  }
 
+  ~MappedFile(void)
+  {
+#if defined(_WIN32)
+    if( mData != NULL )                 { UnmapViewOfFile( mData ); } else { /*  */ }
+    if( mMapping != NULL )              { CloseHandle( mMapping ); }  else { /*  */ }
+    if( mFile != INVALID_HANDLE_VALUE ) { CloseHandle( mFile ); }     else { /*  */ }
+#else
+    if( mData != NULL ) { munmap( const_cast<Uint8*>( mData ), mSize ); } else { /*  */ }
+    if( mFile >= 0 )    { close( mFile ); }                              else { /*  */ }
+#endif
+  }
 
-SDL_Rect Tile::getBox(void) const
-{
-  return mBox;
-}
+  MappedFile( const MappedFile& ) = delete;
+  MappedFile& operator=( const MappedFile& ) = delete;
 
+  const Uint8* getData(void) const { return mData; }
+  size_t       getSize(void) const { return mSize; }
 
-Dot::Dot(void)
-{
-  // Initialize the collision box
-  mBox.x = 0;
-  mBox.y = 0;
-  mBox.w = DOT_WIDTH;
-  mBox.h = DOT_HEIGHT;
+  private:
 
-  // Initialize the velocity
-  mVelX = 0;
-  mVelY = 0;
-}
+#if defined(_WIN32)
+  HANDLE mFile;
+  HANDLE mMapping;
+#else
+  int    mFile;
+#endif
+  const Uint8* mData;
+  size_t       mSize;
+};
 
 
-void Dot::handleEvent( SDL_Event& e )
-{
-  // If a key was pressed
-  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
-  {
-    // Adjust the velocity
-    switch( e.key.keysym.sym )
-    {
-      case SDLK_UP:     mVelY -= DOT_MAX_VEL; break;
-      case SDLK_DOWN:   mVelY += DOT_MAX_VEL; break;
-      case SDLK_LEFT:   mVelX -= DOT_MAX_VEL; break;
-      case SDLK_RIGHT:  mVelX += DOT_MAX_VEL; break;
-    }
-  }
-  // If a key was released
-  else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
-  {
-    // Adjust the velocity
-    switch( e.key.keysym.sym )
-    {
-      case SDLK_UP:     mVelY += DOT_MAX_VEL; break;
-      case SDLK_DOWN:   mVelY -= DOT_MAX_VEL; break;
-      case SDLK_LEFT:   mVelX += DOT_MAX_VEL; break;
-      case SDLK_RIGHT:  mVelX -= DOT_MAX_VEL; break;
-    }
-  }
-}
+TileMap::TileMap(void)
+  : mImageChunks( NULL ), mImageRunChunks( NULL ), mImageRuns( NULL ), mWidth( 0 ), mHeight( 0 ), mChunksX( 0 ), mChunksY( 0 )
+{;}
 
 
 /**
- * @brief Moves the dot and check collision against tiles
+ * @brief Loads a binary map, of either version. The file is mapped and validated, and its chunks
+ * are stored one at a time: the memory taken is that of the map stored sparsely, never that of a
+ * dense copy, whatever the size of the world.
  *
- * @param tiles
+ * @param path
+ * @return true if successful; false otherwise (the map is left empty)
  **/
-void Dot::move( Tile *tiles[] )
+bool TileMap::loadBinary( const std::string& path )
 {
-  // Move the dot left or right
-  mBox.x += mVelX;
+  reset( 0, 0 );
 
-  // If the dot went too far to the left or right or touched a wall
-  if( ( mBox.x < 0 ) || ( mBox.x + DOT_WIDTH > LEVEL_W ) || touchesWall( mBox, tiles ) )
+  const MappedFile file( path );
+
+  if( file.getData() == NULL || file.getSize() < sizeof(TileMapHeader) )
   {
-    // move back
-    mBox.x -= mVelX;
+    return false;
   }
-  else { /* Movement OK */ }
+  else { /* Mapped */ }
 
-  // Move the dot up or down
-  mBox.y += mVelY;
+  TileMapHeader header;
+  memcpy( &header, file.getData(), sizeof(header) );
 
-  // If the dot went too far up or down or touched a wall
-  if( ( mBox.y < 0 ) || ( mBox.y + DOT_HEIGHT > LEVEL_H ) || touchesWall( mBox, tiles ) )
+  if( memcmp( header.Magic, TILE_MAP_MAGIC, sizeof(header.Magic) ) != 0 ||
+      ( header.Version != TILE_MAP_VERSION && header.Version != TILE_MAP_DENSE ) ||
+      header.Width == 0 || header.Height == 0 || header.ChunkW == 0 || header.ChunkH == 0 ||
+      header.Width > 0x8000 || header.Height > 0x8000 )
   {
-    // move back
-    mBox.y -= mVelY;
+    printf( "\nError loading map: \"%s\" is not a valid tile map!", path.c_str() );
+    return false;
   }
-  else { /* Movement OK */ }
+  else { /* Valid header */ }
+
+  reset( static_cast<int>( header.Width ), static_cast<int>( header.Height ) );
+
+  const Uint8* data = file.getData() + sizeof(header);
+  const size_t size = file.getSize() - sizeof(header);
+
+  const bool loaded = ( header.Version == TILE_MAP_DENSE ) ? loadDense ( header, data, size, path )
+                                                           : loadSparse( header, data, size, path );
+
+  if( !loaded )
+  {
+    reset( 0, 0 );
+  }
+  else { /* Map loaded */ }
+
+  return loaded;
 }
 
 
 /**
- * @brief Centers the camera over the dot
+ * @brief Loads a text map: whitespace separated tile types, row by row.
  *
- * @param camera
+ * @param path
+ * @param width Width of the map, in tiles.
+ * @param height Height of the map, in tiles.
+ * @return true if successful; false otherwise (the map is left empty)
  **/
-void Dot::setCamera( SDL_Rect& camera )
+bool TileMap::loadText( const std::string& path, int width, int height )
 {
-  // Center the camera over the dot
-  camera.x = ( mBox.x + DOT_WIDTH  / 2 ) - WINDOW_W / 2;
-  camera.y = ( mBox.y + DOT_HEIGHT / 2 ) - WINDOW_H / 2;
+  // Success flag
+  bool tilesLoaded = true;
 
-  // Keep the camera in bounds
-  if( camera.x < 0 )
+  // Text maps are small: read whole, then stored in chunks
+  std::vector<Uint8> types( static_cast<size_t>( width ) * static_cast<size_t>( height ), TILE_RED );
+
+  // Open the map
+  std::ifstream MapFile( path );
+
+  // If the map couldn't be loaded
+  if( MapFile.fail() )
   {
-    camera.x = 0;
+    printf( "\nUnable to load map file!" );
+    tilesLoaded = false;
+  }
+  else
+  {
+    // Initialize the tiles
+    for( size_t i = 0; i != types.size(); ++i )
+    {
+      // Determines what kind of tile will be made
+      int tileType = -1;
+
+      // Read tile from map file
+      MapFile >> tileType;
+
+      // If the was a problem in reading the map
+      if( MapFile.fail() )
+      {
+        // Stop loading map
+        printf( "\nError loading map: Unexpected end of file!\n" );
+        tilesLoaded = false;
+        break;
+      }
+      else
+      { /* Reading was OK */ }
+
+      // If the number is a valid tile number
+      if( ( tileType >= 0 ) && ( tileType < TOTAL_TILE_SPRITES ) )
+      {
+        types[ i ] = static_cast<Uint8>( tileType );
+      }
+      // If we don't recognize the tile type
+      else
+      {
+        // Stop loading map
+        printf( "\nError loading map: Invalid tile type at %d!\n", static_cast<int>( i ) );
+        tilesLoaded = false;
+        break;
+      }
+    }
+  }
+
+  if( !tilesLoaded )
+  {
+    reset( 0, 0 );
+    return false;
+  }
+  else { /* Map read */ }
+
+  reset( width, height );
+
+  Uint8 tiles[ TILE_MAP_CHUNK * TILE_MAP_CHUNK ];
+
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    const size_t x0 = static_cast<size_t>( chunk % mChunksX ) * TILE_MAP_CHUNK;
+    const size_t y0 = static_cast<size_t>( chunk / mChunksX ) * TILE_MAP_CHUNK;
+
+    for( int row = 0; row != getChunkH( chunk ); ++row )
+    {
+      memcpy( &tiles[ row * TILE_MAP_CHUNK ], &types[ ( y0 + static_cast<size_t>( row ) ) * static_cast<size_t>( width ) + x0 ],
+              static_cast<size_t>( getChunkW( chunk ) ) );
+    }
+
+    encodeChunk( chunk, tiles );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Saves the map in version 2, the chunks as they are stored: the file is as sparse as the
+ * map in memory. The chunks are written TILE_MAP_WRITE_BLOCK bytes at a time.
+ *
+ * @param path
+ * @return true if successful; false otherwise
+ **/
+bool TileMap::saveBinary( const std::string& path ) const
+{
+  TileMapHeader header;
+  memcpy( header.Magic, TILE_MAP_MAGIC, sizeof(header.Magic) );
+  header.Version = TILE_MAP_VERSION;
+  header.Width   = static_cast<Uint32>( mWidth  );
+  header.Height  = static_cast<Uint32>( mHeight );
+  header.ChunkW  = TILE_MAP_CHUNK;
+  header.ChunkH  = TILE_MAP_CHUNK;
+
+  SDL_RWops* file = SDL_RWFromFile( path.c_str(), "wb" );
+
+  if( file == NULL )
+  {
+    printf( "\nUnable to save map \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else { /* File open */ }
+
+  bool success = SDL_RWwrite( file, &header, sizeof(header), 1 ) == 1;
+
+  std::vector<Uint8> block;
+  block.reserve( TILE_MAP_WRITE_BLOCK + 1 + TILE_MAP_CHUNK * ( 1 + 2 * TILE_MAP_CHUNK ) );
+
+  const int chunks = mChunksX * mChunksY;
+
+  for( int chunk = 0; success && chunk != chunks; ++chunk )
+  {
+    const Uint32 entry = getEntry( chunk );
+
+    if( ( entry & RUN_CHUNK ) == 0 )
+    {
+      block.push_back( static_cast<Uint8>( entry ) );
+    }
+    else
+    {
+      const RunsView runs = getRuns( entry );
+
+      block.push_back( TILE_MAP_RLE );
+
+      for( int row = 0; row != getChunkH( chunk ); ++row )
+      {
+        block.push_back( static_cast<Uint8>( runs.RowStarts[ row + 1 ] - runs.RowStarts[ row ] ) );
+
+        for( int run = runs.RowStarts[ row ]; run != runs.RowStarts[ row + 1 ]; ++run )
+        {
+          block.push_back( runs.Runs[ run ].Type );
+          block.push_back( runs.Runs[ run ].End );
+        }
+      }
+    }
+
+    if( block.size() >= TILE_MAP_WRITE_BLOCK || chunk + 1 == chunks )
+    {
+      success = SDL_RWwrite( file, block.data(), block.size(), 1 ) == 1;
+      block.clear();
+    }
+    else { /* Filling the block */ }
+  }
+
+  success = ( SDL_RWclose( file ) == 0 ) && success;
+
+  return success;
+}
+
+
+int TileMap::getWidth(void) const
+{
+  return mWidth;
+}
+
+
+int TileMap::getHeight(void) const
+{
+  return mHeight;
+}
+
+
+int TileMap::getLevelWidth(void) const
+{
+  return mWidth * TILE_W;
+}
+
+
+int TileMap::getLevelHeight(void) const
+{
+  return mHeight * TILE_H;
+}
+
+
+/**
+ * @brief Type of a tile: the entry of its chunk, if uniform, or the run covering its column among
+ * those of its row.
+ **/
+int TileMap::getType( int column, int row ) const
+{
+  const Uint32 entry = getEntry( getChunk( column, row ) );
+
+  if( ( entry & RUN_CHUNK ) == 0 )
+  {
+    return static_cast<int>( entry );
+  }
+  else { /* Stored as runs */ }
+
+  const RunsView runs = getRuns( entry );
+  const int      x    = column % TILE_MAP_CHUNK;
+
+  // The last run of a row reaches the edge of the chunk
+  int run = runs.RowStarts[ row % TILE_MAP_CHUNK ];
+
+  while( runs.Runs[ run ].End <= x )
+  {
+    ++run;
+  }
+
+  return runs.Runs[ run ].Type;
+}
+
+
+SDL_Rect TileMap::getBox( int column, int row ) const
+{
+  return SDL_Rect{ column * TILE_W, row * TILE_H, TILE_W, TILE_H };
+}
+
+
+/**
+ * @brief Columns and rows of the tiles overlapping an area, clipped to the map: computed from the
+ * corners of the area, without looking at any tile.
+ *
+ * @param area In level coordinates.
+ * @return First column and row in x/y, number of columns and rows in w/h (0 if outside the map).
+ **/
+SDL_Rect TileMap::getTileRange( const SDL_Rect& area ) const
+{
+  if( area.w <= 0 || area.h <= 0 )
+  {
+    return SDL_Rect{ 0, 0, 0, 0 };
+  }
+  else { /* Non-empty area */ }
+
+  // Tiles holding the first and the last pixel of the area
+  const int firstColumn = SDL_max( area.x / TILE_W, 0 );
+  const int firstRow    = SDL_max( area.y / TILE_H, 0 );
+  const int lastColumn  = SDL_min( ( area.x + area.w - 1 ) / TILE_W, mWidth  - 1 );
+  const int lastRow     = SDL_min( ( area.y + area.h - 1 ) / TILE_H, mHeight - 1 );
+
+  return SDL_Rect{ firstColumn, firstRow, SDL_max( lastColumn - firstColumn + 1, 0 ), SDL_max( lastRow - firstRow + 1, 0 ) };
+}
+
+
+bool TileMap::isWall( int column, int row ) const
+{
+  return isWallType( getType( column, row ) );
+}
+
+
+bool TileMap::contains( int column, int row ) const
+{
+  return ( column >= 0 ) && ( row >= 0 ) && ( column < mWidth ) && ( row < mHeight );
+}
+
+
+/**
+ * @brief Changes the type of a tile: its chunk is decoded, changed and encoded again, so it may
+ * become uniform, or stop being so.
+ *
+ * @param column
+ * @param row
+ * @param type One of TileTypes.
+ * @return true if the tile changed; false if it already had that type
+ **/
+bool TileMap::setType( int column, int row, int type )
+{
+  if( getType( column, row ) == type )
+  {
+    return false;
+  }
+  else { /* New type */ }
+
+  const int chunk = getChunk( column, row );
+  Uint8     tiles[ TILE_MAP_CHUNK * TILE_MAP_CHUNK ];
+
+  ownEntries();
+  decodeChunk( chunk, tiles );
+  tiles[ ( row % TILE_MAP_CHUNK ) * TILE_MAP_CHUNK + column % TILE_MAP_CHUNK ] = static_cast<Uint8>( type );
+  encodeChunk( chunk, tiles );
+
+  return true;
+}
+
+
+/**
+ * @brief Wall sprite for a tile, from which of its four neighbours are walls: a side without a wall
+ * is an edge, two adjacent ones a corner. Outside the map counts as no wall, so the walls along the
+ * border of the map get an edge too.
+ *
+ * @param column
+ * @param row
+ * @return TILE_CENTER to TILE_TOPLEFT
+ **/
+int TileMap::getWallAutotile( int column, int row ) const
+{
+  const bool up    = contains( column, row - 1 ) && isWall( column, row - 1 );
+  const bool down  = contains( column, row + 1 ) && isWall( column, row + 1 );
+  const bool left  = contains( column - 1, row ) && isWall( column - 1, row );
+  const bool right = contains( column + 1, row ) && isWall( column + 1, row );
+
+  if( !up )
+  {
+    return !left ? TILE_TOPLEFT : ( !right ? TILE_TOPRIGHT : TILE_TOP );
+  }
+  else if( !down )
+  {
+    return !left ? TILE_BOTTOMLEFT : ( !right ? TILE_BOTTOMRIGHT : TILE_BOTTOM );
+  }
+  else if( !left )
+  {
+    return TILE_LEFT;
+  }
+  else if( !right )
+  {
+    return TILE_RIGHT;
+  }
+  else
+  {
+    return TILE_CENTER;
+  }
+}
+
+size_t TileMap::getUniformChunks(void) const
+{
+  size_t uniform = 0;
+
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    uniform += ( ( getEntry( chunk ) & RUN_CHUNK ) == 0 ) ? 1 : 0;
+  }
+
+  return uniform;
+}
+
+
+/**
+ * @brief Bytes taken by the tiles: the chunk entries, and the runs of the chunks that are not
+ * uniform. What a resumed map still reads from the snapshot is not counted: those are pages of the
+ * file, which the OS loads when touched and can drop.
+ **/
+size_t TileMap::getMemoryBytes(void) const
+{
+  size_t bytes = mChunks.capacity() * sizeof(Uint32) + mRunChunks.capacity() * sizeof(RunChunk) +
+                 mFreeRunChunks.capacity() * sizeof(Uint32);
+
+  for( const RunChunk& runs : mRunChunks )
+  {
+    bytes += runs.Runs.capacity() * sizeof(Run);
+  }
+
+  return bytes;
+}
+
+
+/**
+ * @brief Blocks the cells of the walls in a pathfinder: a whole chunk at once if it is a wall, and
+ * the wall runs of the others. Floor chunks cost nothing.
+ *
+ * @param paths Created with the width and height of the map, all free.
+ **/
+void TileMap::markWalls( LPathfinder& paths ) const
+{
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    const Uint32 entry  = getEntry( chunk );
+    const int    left   = ( chunk % mChunksX ) * TILE_MAP_CHUNK;
+    const int    top    = ( chunk / mChunksX ) * TILE_MAP_CHUNK;
+    const int    chunkW = getChunkW( chunk );
+    const int    chunkH = getChunkH( chunk );
+
+    for( int row = 0; row != chunkH; ++row )
+    {
+      if( ( entry & RUN_CHUNK ) == 0 )
+      {
+        for( int column = 0; isWallType( static_cast<int>( entry ) ) && column != chunkW; ++column )
+        {
+          paths.setBlocked( left + column, top + row, true );
+        }
+
+        continue;
+      }
+      else { /* Stored as runs */ }
+
+      const RunsView runs  = getRuns( entry );
+      int            start = 0;
+
+      for( int run = runs.RowStarts[ row ]; run != runs.RowStarts[ row + 1 ]; ++run )
+      {
+        const Run& tiles = runs.Runs[ run ];
+        const int  end   = SDL_min( static_cast<int>( tiles.End ), chunkW );
+
+        for( int column = start; isWallType( tiles.Type ) && column < end; ++column )
+        {
+          paths.setBlocked( left + column, top + row, true );
+        }
+
+        start = tiles.End;
+      }
+    }
+  }
+}
+
+
+/**
+ * @brief Saves the map into sections of a snapshot, laid out to be used where they are mapped: the
+ * header, the entries of the chunks, the run chunks with the index of their first run instead of a
+ * vector, and all the runs in one pool. Run chunks are numbered again in the order of the chunks,
+ * wherever their runs are, and flagged IMAGE_CHUNK.
+ *
+ * @param snapshot
+ **/
+void TileMap::saveImage( LSnapshotWriter& snapshot ) const
+{
+  TileMapHeader header;
+  memcpy( header.Magic, TILE_MAP_MAGIC, sizeof(header.Magic) );
+  header.Version = TILE_MAP_VERSION;
+  header.Width   = static_cast<Uint32>( mWidth  );
+  header.Height  = static_cast<Uint32>( mHeight );
+  header.ChunkW  = TILE_MAP_CHUNK;
+  header.ChunkH  = TILE_MAP_CHUNK;
+
+  snapshot.beginSection( SNAPSHOT_MAP );
+  snapshot.writeValue( header );
+
+  std::vector<ImageRunChunk> runChunks;
+  std::vector<Run>           runs;
+
+  snapshot.beginSection( SNAPSHOT_CHUNKS );
+
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    const Uint32 entry = getEntry( chunk );
+
+    if( ( entry & RUN_CHUNK ) == 0 )
+    {
+      snapshot.writeValue( entry );
+      continue;
+    }
+    else { /* Stored as runs */ }
+
+    const RunsView      chunkRuns = getRuns( entry );
+    const int           chunkH    = getChunkH( chunk );
+    const ImageRunChunk image     = { {}, 0, static_cast<Uint32>( runs.size() ) };
+
+    runChunks.push_back( image );
+    std::copy( chunkRuns.RowStarts, chunkRuns.RowStarts + chunkH + 1, runChunks.back().RowStarts );
+    runs.insert( runs.end(), chunkRuns.Runs, chunkRuns.Runs + chunkRuns.RowStarts[ chunkH ] );
+
+    snapshot.writeValue( RUN_CHUNK | IMAGE_CHUNK | static_cast<Uint32>( runChunks.size() - 1 ) );
+  }
+
+  snapshot.beginSection( SNAPSHOT_RUN_CHUNKS );
+  snapshot.writeArray( runChunks.data(), runChunks.size() );
+
+  snapshot.beginSection( SNAPSHOT_RUNS );
+  snapshot.writeArray( runs.data(), runs.size() );
+}
+
+
+/**
+ * @brief Resumes the map from the sections of a snapshot, in place: only the header is read, and
+ * the map reads its entries and runs where they are mapped, so that resuming costs the same
+ * whatever the size of the map. The first change copies the entries, 4 bytes a chunk, and each
+ * chunk changed gets runs of its own; the runs in the snapshot are never copied.
+ *
+ * The sizes of the sections are checked, not what they hold: the snapshot is trusted.
+ *
+ * @param snapshot Must stay open for as long as the map is used, or until it is loaded again.
+ * @return true if successful; false otherwise (the map is left empty)
+ **/
+bool TileMap::adoptImage( const LSnapshotImage& snapshot )
+{
+  reset( 0, 0 );
+
+  size_t count = 0;
+  const TileMapHeader* header = snapshot.GetArray<TileMapHeader>( SNAPSHOT_MAP, count );
+
+  if( header == NULL || count != 1 || memcmp( header->Magic, TILE_MAP_MAGIC, sizeof(header->Magic) ) != 0 ||
+      header->Version != TILE_MAP_VERSION || header->ChunkW != TILE_MAP_CHUNK || header->ChunkH != TILE_MAP_CHUNK ||
+      header->Width == 0 || header->Height == 0 || header->Width > 0x8000 || header->Height > 0x8000 )
+  {
+    printf( "\nError resuming map: no valid map in the snapshot!" );
+    return false;
+  }
+  else { /* Valid header */ }
+
+  const int    width     = static_cast<int>( header->Width );
+  const int    height    = static_cast<int>( header->Height );
+  const size_t chunks    = static_cast<size_t>( ( width + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK ) *
+                           static_cast<size_t>( ( height + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK );
+  size_t       runChunks = 0;
+  size_t       runs      = 0;
+
+  const Uint32*        imageChunks    = snapshot.GetArray<Uint32>( SNAPSHOT_CHUNKS, count );
+  const ImageRunChunk* imageRunChunks = snapshot.GetArray<ImageRunChunk>( SNAPSHOT_RUN_CHUNKS, runChunks );
+  const Run*           imageRuns      = snapshot.GetArray<Run>( SNAPSHOT_RUNS, runs );
+
+  if( imageChunks == NULL || count != chunks || imageRunChunks == NULL || imageRuns == NULL )
+  {
+    printf( "\nError resuming map: the snapshot has %d of %d chunks!", static_cast<int>( count ), static_cast<int>( chunks ) );
+    return false;
+  }
+  else { /* All sections present */ }
+
+  // Sized without entries of its own: they are read where they are mapped until the first change
+  std::vector<Uint32>().swap( mChunks );
+
+  mWidth   = width;
+  mHeight  = height;
+  mChunksX = ( width  + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK;
+  mChunksY = ( height + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK;
+
+  mImageChunks    = imageChunks;
+  mImageRunChunks = imageRunChunks;
+  mImageRuns      = imageRuns;
+
+  return true;
+}
+
+
+/**
+ * @brief Empties the map and sizes it, all its chunks uniform TILE_RED.
+ *
+ * @param width In tiles.
+ * @param height In tiles.
+ **/
+void TileMap::reset( int width, int height )
+{
+  mWidth   = width;
+  mHeight  = height;
+  mChunksX = ( width  + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK;
+  mChunksY = ( height + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK;
+
+  mChunks.assign( static_cast<size_t>( mChunksX ) * static_cast<size_t>( mChunksY ), TILE_RED );
+  mRunChunks.clear();
+  mFreeRunChunks.clear();
+
+  mImageChunks    = NULL;
+  mImageRunChunks = NULL;
+  mImageRuns      = NULL;
+}
+
+
+/**
+ * @brief Stores the chunks of a version 1 map: each chunk of the map gathers its tiles from those
+ * of the file, whatever their size, and is encoded.
+ *
+ * @param header
+ * @param data The chunks of the file.
+ * @param size Of the chunks, in bytes.
+ * @param path For the errors.
+ * @return true if successful; false otherwise
+ **/
+bool TileMap::loadDense( const TileMapHeader& header, const Uint8* data, size_t size, const std::string& path )
+{
+  const size_t chunksX   = ( header.Width  + header.ChunkW - 1 ) / header.ChunkW;
+  const size_t chunksY   = ( header.Height + header.ChunkH - 1 ) / header.ChunkH;
+  const size_t chunkSize = static_cast<size_t>( header.ChunkW ) * header.ChunkH;
+
+  if( size < chunksX * chunksY * chunkSize )
+  {
+    printf( "\nError loading map: \"%s\" is truncated!", path.c_str() );
+    return false;
+  }
+  else { /* All chunks present */ }
+
+  Uint8 tiles[ TILE_MAP_CHUNK * TILE_MAP_CHUNK ];
+
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    const size_t x0 = static_cast<size_t>( chunk % mChunksX ) * TILE_MAP_CHUNK;
+    const size_t y0 = static_cast<size_t>( chunk / mChunksX ) * TILE_MAP_CHUNK;
+
+    for( int row = 0; row != getChunkH( chunk ); ++row )
+    {
+      for( int column = 0; column != getChunkW( chunk ); ++column )
+      {
+        // The chunk of the file holding the tile, and the tile in it
+        const size_t x    = x0 + static_cast<size_t>( column );
+        const size_t y    = y0 + static_cast<size_t>( row );
+        const Uint8  type = data[ ( ( y / header.ChunkH ) * chunksX + x / header.ChunkW ) * chunkSize +
+                                  ( y % header.ChunkH ) * header.ChunkW + x % header.ChunkW ];
+
+        if( type >= TOTAL_TILE_SPRITES )
+        {
+          printf( "\nError loading map: invalid tile type %d in \"%s\"!", type, path.c_str() );
+          return false;
+        }
+        else { /* Valid type */ }
+
+        tiles[ row * TILE_MAP_CHUNK + column ] = type;
+      }
+    }
+
+    encodeChunk( chunk, tiles );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Stores the chunks of a version 2 map, checking every run: a chunk read is decoded and
+ * encoded again, so that what is in memory is valid whatever the file holds.
+ *
+ * @param header
+ * @param data The chunks of the file.
+ * @param size Of the chunks, in bytes.
+ * @param path For the errors.
+ * @return true if successful; false otherwise
+ **/
+bool TileMap::loadSparse( const TileMapHeader& header, const Uint8* data, size_t size, const std::string& path )
+{
+  if( header.ChunkW != TILE_MAP_CHUNK || header.ChunkH != TILE_MAP_CHUNK )
+  {
+    printf( "\nError loading map: \"%s\" has chunks of %ux%u tiles rather than %d!", path.c_str(),
+            static_cast<unsigned>( header.ChunkW ), static_cast<unsigned>( header.ChunkH ), TILE_MAP_CHUNK );
+    return false;
+  }
+  else { /* Chunks as in memory */ }
+
+  const auto corrupt = [ &path ]( void )
+  {
+    printf( "\nError loading map: \"%s\" is truncated or corrupt!", path.c_str() );
+    return false;
+  };
+
+  Uint8  tiles[ TILE_MAP_CHUNK * TILE_MAP_CHUNK ];
+  size_t at = 0;
+
+  for( int chunk = 0; chunk != mChunksX * mChunksY; ++chunk )
+  {
+    if( at == size )
+    {
+      return corrupt();
+    }
+    else { /* Chunk present */ }
+
+    const Uint8 kind = data[ at++ ];
+
+    if( kind != TILE_MAP_RLE )
+    {
+      if( kind >= TOTAL_TILE_SPRITES )
+      {
+        return corrupt();
+      }
+      else { /* Uniform chunk */ }
+
+      memset( tiles, kind, sizeof(tiles) );
+    }
+    else
+    {
+      for( int row = 0; row != getChunkH( chunk ); ++row )
+      {
+        const size_t runs = ( at != size ) ? data[ at++ ] : 0;
+        int          end  = 0;
+
+        if( size - at < 2 * runs )
+        {
+          return corrupt();
+        }
+        else { /* Runs present */ }
+
+        for( size_t run = 0; run != runs; ++run, at += 2 )
+        {
+          const Uint8 type = data[ at ];
+          const int   next = data[ at + 1 ];
+
+          if( type >= TOTAL_TILE_SPRITES || next <= end || next > getChunkW( chunk ) )
+          {
+            return corrupt();
+          }
+          else { /* Valid run */ }
+
+          memset( &tiles[ row * TILE_MAP_CHUNK + end ], type, static_cast<size_t>( next - end ) );
+          end = next;
+        }
+
+        // The runs of a row cover it
+        if( end != getChunkW( chunk ) )
+        {
+          return corrupt();
+        }
+        else { /* Row complete */ }
+      }
+    }
+
+    encodeChunk( chunk, tiles );
+  }
+
+  return true;
+}
+
+
+int TileMap::getChunkW( int chunk ) const
+{
+  return SDL_min( TILE_MAP_CHUNK, mWidth - ( chunk % mChunksX ) * TILE_MAP_CHUNK );
+}
+
+
+int TileMap::getChunkH( int chunk ) const
+{
+  return SDL_min( TILE_MAP_CHUNK, mHeight - ( chunk / mChunksX ) * TILE_MAP_CHUNK );
+}
+
+
+int TileMap::getChunk( int column, int row ) const
+{
+  return ( row / TILE_MAP_CHUNK ) * mChunksX + column / TILE_MAP_CHUNK;
+}
+
+
+/**
+ * @brief Stores the tiles of a chunk. A chunk of one type is just that type, and gives the runs it
+ * had to the chunks that may need them; any other one is encoded in runs, row by row. Runs in a
+ * snapshot are never changed: a chunk that had them gets runs of its own.
+ *
+ * @param chunk
+ * @param tiles TILE_MAP_CHUNK to a row; only those inside the map are read.
+ **/
+void TileMap::encodeChunk( int chunk, const Uint8* tiles )
+{
+  const int chunkW = getChunkW( chunk );
+  const int chunkH = getChunkH( chunk );
+  Uint32&   entry  = mChunks[ static_cast<size_t>( chunk ) ];
+
+  bool isUniform = true;
+
+  for( int row = 0; isUniform && row != chunkH; ++row )
+  {
+    for( int column = 0; isUniform && column != chunkW; ++column )
+    {
+      isUniform = ( tiles[ row * TILE_MAP_CHUNK + column ] == tiles[ 0 ] );
+    }
+  }
+
+  if( isUniform )
+  {
+    if( ( entry & ( RUN_CHUNK | IMAGE_CHUNK ) ) == RUN_CHUNK )
+    {
+      std::vector<Run>().swap( mRunChunks[ entry & ~RUN_CHUNK ].Runs );
+      mFreeRunChunks.push_back( entry & ~RUN_CHUNK );
+    }
+    else { /* Was uniform too */ }
+
+    entry = tiles[ 0 ];
+    return;
+  }
+  else { /* Several types */ }
+
+  if( ( entry & ( RUN_CHUNK | IMAGE_CHUNK ) ) != RUN_CHUNK )
+  {
+    if( mFreeRunChunks.empty() )
+    {
+      entry = RUN_CHUNK | static_cast<Uint32>( mRunChunks.size() );
+      mRunChunks.emplace_back();
+    }
+    else
+    {
+      entry = RUN_CHUNK | mFreeRunChunks.back();
+      mFreeRunChunks.pop_back();
+    }
+  }
+  else { /* Its own runs are replaced */ }
+
+  RunChunk& runs = mRunChunks[ entry & ~RUN_CHUNK ];
+  runs.Runs.clear();
+
+  for( int row = 0; row != chunkH; ++row )
+  {
+    const Uint8* line = &tiles[ row * TILE_MAP_CHUNK ];
+
+    runs.RowStarts[ row ] = static_cast<Uint16>( runs.Runs.size() );
+
+    // A run ends at the edge of the chunk, or where the next tile differs
+    for( int column = 1; column <= chunkW; ++column )
+    {
+      if( column == chunkW || line[ column ] != line[ column - 1 ] )
+      {
+        runs.Runs.push_back( Run{ line[ column - 1 ], static_cast<Uint8>( column ) } );
+      }
+      else { /* Same run */ }
+    }
+  }
+
+  runs.RowStarts[ chunkH ] = static_cast<Uint16>( runs.Runs.size() );
+}
+
+
+/**
+ * @brief Writes the tiles of a chunk, TILE_MAP_CHUNK to a row; those outside the map are left as
+ * they are, unless the chunk is uniform.
+ *
+ * @param chunk
+ * @param tiles
+ **/
+void TileMap::decodeChunk( int chunk, Uint8* tiles ) const
+{
+  const Uint32 entry = getEntry( chunk );
+
+  if( ( entry & RUN_CHUNK ) == 0 )
+  {
+    memset( tiles, static_cast<int>( entry ), TILE_MAP_CHUNK * TILE_MAP_CHUNK );
+    return;
+  }
+  else { /* Stored as runs */ }
+
+  const RunsView runs = getRuns( entry );
+
+  for( int row = 0; row != getChunkH( chunk ); ++row )
+  {
+    int column = 0;
+
+    for( int run = runs.RowStarts[ row ]; run != runs.RowStarts[ row + 1 ]; ++run )
+    {
+      const Run& next = runs.Runs[ run ];
+
+      memset( &tiles[ row * TILE_MAP_CHUNK + column ], next.Type, static_cast<size_t>( next.End - column ) );
+      column = next.End;
+    }
+  }
+}
+
+
+Uint32 TileMap::getEntry( int chunk ) const
+{
+  return ( mImageChunks != NULL ) ? mImageChunks[ chunk ] : mChunks[ static_cast<size_t>( chunk ) ];
+}
+
+
+/**
+ * @brief Row starts and runs of a chunk stored as runs, from mRunChunks or from the snapshot.
+ *
+ * @param entry With RUN_CHUNK.
+ **/
+TileMap::RunsView TileMap::getRuns( Uint32 entry ) const
+{
+  if( ( entry & IMAGE_CHUNK ) != 0 )
+  {
+    const ImageRunChunk& runs = mImageRunChunks[ entry & ~( RUN_CHUNK | IMAGE_CHUNK ) ];
+
+    return RunsView{ runs.RowStarts, mImageRuns + runs.FirstRun };
+  }
+  else { /* Runs of its own */ }
+
+  const RunChunk& runs = mRunChunks[ entry & ~RUN_CHUNK ];
+
+  return RunsView{ runs.RowStarts, runs.Runs.data() };
+}
+
+
+/**
+ * @brief Copies the entries of a resumed map out of the snapshot, so that they can change. The run
+ * chunks stay there, and are read for as long as an entry refers to them.
+ **/
+void TileMap::ownEntries(void)
+{
+  if( mImageChunks != NULL )
+  {
+    mChunks.assign( mImageChunks, mImageChunks + static_cast<size_t>( mChunksX ) * static_cast<size_t>( mChunksY ) );
+    mImageChunks = NULL;
+  }
+  else { /* Already owned */ }
+}
+
+
+TileMapEditor::TileMapEditor( TileMap& map, TileChunkCache& chunks, LPathfinder& paths )
+  : mMap( map ), mChunks( chunks ), mPaths( paths )
+{;}
+
+
+/**
+ * @brief Puts a wall at a tile; its sprite, and those of the walls next to it, follow from the
+ * neighbours.
+ *
+ * @param column
+ * @param row
+ * @return true if the map changed
+ **/
+bool TileMapEditor::setWall( int column, int row )
+{
+  // Any wall type marks the tile as a wall, the autotiling picks the sprite
+  return mMap.contains( column, row ) && !mMap.isWall( column, row ) && setTile( column, row, TILE_CENTER );
+}
+
+
+/**
+ * @brief Puts a floor tile at a tile, updating the sprites of the walls next to it.
+ *
+ * @param column
+ * @param row
+ * @param type TILE_RED, TILE_GREEN or TILE_BLUE.
+ * @return true if the map changed
+ **/
+bool TileMapEditor::setFloor( int column, int row, int type )
+{
+  return mMap.contains( column, row ) && !isWallType( type ) && setTile( column, row, type );
+}
+
+
+/**
+ * @brief Sets a tile, then the sprites of the walls among it and its four neighbours: they are the
+ * only tiles whose autotile depends on it.
+ **/
+bool TileMapEditor::setTile( int column, int row, int type )
+{
+  if( !apply( column, row, type ) )
+  {
+    return false;
+  }
+  else { /* Changed: refresh the autotiles around it */ }
+
+  static constexpr int NEIGHBOURS[ 5 ][ 2 ] = { { 0, 0 }, { 0, -1 }, { 0, 1 }, { -1, 0 }, { 1, 0 } };
+
+  for( const auto& offset : NEIGHBOURS )
+  {
+    const int x = column + offset[ 0 ];
+    const int y = row    + offset[ 1 ];
+
+    if( mMap.contains( x, y ) && mMap.isWall( x, y ) )
+    {
+      apply( x, y, mMap.getWallAutotile( x, y ) );
+    }
+    else { /* Outside the map or not a wall */ }
+  }
+
+  return true;
+}
+
+
+bool TileMapEditor::apply( int column, int row, int type )
+{
+  if( mMap.setType( column, row, type ) )
+  {
+    mChunks.invalidate( column, row );
+
+    // Walls changing sprite stay blocked, and leave the cached paths alone
+    mPaths.setBlocked( column, row, isWallType( type ) );
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+
+TileChunkCache::TileChunkCache(void)
+  : mChunksX( 0 ), mChunksY( 0 ), mFrame( 0 ), mDirect( false )
+{;}
+
+
+/**
+ * @brief Sizes the cache for a map and forgets what it held.
+ *
+ * @param map
+ **/
+void TileChunkCache::init( const TileMap& map )
+{
+  mChunksX = ( map.getWidth()  + RENDER_CHUNK - 1 ) / RENDER_CHUNK;
+  mChunksY = ( map.getHeight() + RENDER_CHUNK - 1 ) / RENDER_CHUNK;
+
+  for( Slot& slot : mSlots )
+  {
+    slot.Chunk    = -1;
+    slot.LastUsed = 0;
+    slot.Dirty    = true;
+  }
+
+  // Without render targets every frame draws the visible tiles one by one
+  mDirect = ( SDL_RenderTargetSupported( gRenderer ) == SDL_FALSE );
+
+  if( mDirect )
+  {
+    printf( "\nWarning: render targets not supported, tiles are drawn one by one" );
+  }
+  else { /* Chunked rendering */ }
+}
+
+
+/**
+ * @brief Marks the chunk holding a tile as changed: it is redrawn the next time it is rendered.
+ *
+ * @param column
+ * @param row
+ **/
+void TileChunkCache::invalidate( int column, int row )
+{
+  const int chunkX = column / RENDER_CHUNK;
+  const int chunkY = row    / RENDER_CHUNK;
+
+  if( column < 0 || row < 0 || chunkX >= mChunksX || chunkY >= mChunksY )
+  {
+    return;
+  }
+  else { /* Inside the map */ }
+
+  const int slot = findSlot( chunkY * mChunksX + chunkX );
+
+  if( slot >= 0 )
+  {
+    mSlots[ slot ].Dirty = true;
+  }
+  else { /* Not cached: drawn from scratch when it comes into view */ }
+}
+
+
+void TileChunkCache::invalidateAll(void)
+{
+  for( Slot& slot : mSlots )
+  {
+    slot.Dirty = true;
+  }
+}
+
+
+/**
+ * @brief Renders the chunks seen by the camera, redrawing the ones that changed or were not
+ * cached.
+ *
+ * @param map
+ * @param camera
+ **/
+void TileChunkCache::render( const TileMap& map, const SDL_Rect& camera )
+{
+  const SDL_Rect tiles = map.getTileRange( camera );
+
+  if( mDirect )
+  {
+    renderTiles( map, tiles, camera );
+    return;
+  }
+  else { /* Chunked rendering */ }
+
+  ++mFrame;
+
+  // Chunks holding the visible tiles
+  const int firstChunkX = tiles.x / RENDER_CHUNK;
+  const int firstChunkY = tiles.y / RENDER_CHUNK;
+  const int lastChunkX  = ( tiles.x + tiles.w - 1 ) / RENDER_CHUNK;
+  const int lastChunkY  = ( tiles.y + tiles.h - 1 ) / RENDER_CHUNK;
+
+  for( int chunkY = firstChunkY; tiles.h > 0 && chunkY <= lastChunkY; ++chunkY )
+  {
+    for( int chunkX = firstChunkX; tiles.w > 0 && chunkX <= lastChunkX; ++chunkX )
+    {
+      const int chunk = chunkY * mChunksX + chunkX;
+      Slot&     slot  = mSlots[ acquireSlot( chunk ) ];
+
+      if( slot.Dirty )
+      {
+        slot.Dirty = !redrawChunk( map, chunk, slot );
+      }
+      else { /* Cached */ }
+
+      // Show the chunk, the edge chunks are only partially used
+      SDL_Rect clip = { 0, 0, SDL_min( RENDER_CHUNK, map.getWidth()  - chunkX * RENDER_CHUNK ) * TILE_W,
+                              SDL_min( RENDER_CHUNK, map.getHeight() - chunkY * RENDER_CHUNK ) * TILE_H };
+
+      slot.Texture.render( chunkX * RENDER_CHUNK_W - camera.x, chunkY * RENDER_CHUNK_H - camera.y, &clip );
+
+      LDebugDraw::rect( SDL_Rect{ chunkX * RENDER_CHUNK_W, chunkY * RENDER_CHUNK_H, clip.w, clip.h }, ChunkColour );
+    }
+  }
+}
+
+
+void TileChunkCache::free(void)
+{
+  for( Slot& slot : mSlots )
+  {
+    slot.Texture.free();
+    slot.Chunk = -1;
+    slot.Dirty = true;
+  }
+}
+
+
+/**
+ * @brief Slot holding a chunk: a look at the RENDER_CHUNK_SLOTS slots, which is less than a table
+ * of every chunk of the map would take to fill.
+ *
+ * @param chunk
+ * @return The slot index, -1 if the chunk is not cached.
+ **/
+int TileChunkCache::findSlot( int chunk ) const
+{
+  for( int slot = 0; slot != RENDER_CHUNK_SLOTS; ++slot )
+  {
+    if( mSlots[ slot ].Chunk == chunk )
+    {
+      return slot;
+    }
+    else { /* Another chunk */ }
+  }
+
+  return -1;
+}
+
+
+/**
+ * @brief Gets the slot of a chunk. A chunk without one takes the slot unused for the longest time:
+ * since the cache holds more chunks than fit on screen, that is never a chunk drawn this frame.
+ *
+ * @param chunk
+ * @return The slot index.
+ **/
+int TileChunkCache::acquireSlot( int chunk )
+{
+  int slot = findSlot( chunk );
+
+  if( slot < 0 )
+  {
+    slot = 0;
+
+    for( int i = 1; i != RENDER_CHUNK_SLOTS; ++i )
+    {
+      if( mSlots[ i ].LastUsed < mSlots[ slot ].LastUsed )
+      {
+        slot = i;
+      }
+      else { /* Used more recently */ }
+    }
+
+    // Evicts the previous chunk, if any
+    mSlots[ slot ].Chunk = chunk;
+    mSlots[ slot ].Dirty = true;
+  }
+  else { /* Already cached */ }
+
+  mSlots[ slot ].LastUsed = mFrame;
+
+  return slot;
+}
+
+
+/**
+ * @brief Draws the tiles of a chunk into the texture of its slot.
+ *
+ * @param map
+ * @param chunk
+ * @param slot
+ * @return true if successful; false otherwise (tried again next frame)
+ **/
+bool TileChunkCache::redrawChunk( const TileMap& map, int chunk, Slot& slot )
+{
+  if( slot.Texture.getWidth() == 0 )
+  {
+    if( !slot.Texture.createBlank( RENDER_CHUNK_W, RENDER_CHUNK_H, SDL_TEXTUREACCESS_TARGET ) )
+    {
+      return false;
+    }
+    else { /* Created */ }
+
+    // Tiles are opaque: no blending when the chunk is copied to the screen
+    slot.Texture.setBlendMode( SDL_BLENDMODE_NONE );
+  }
+  else { /* Reused */ }
+
+  const int chunkX = chunk % mChunksX;
+  const int chunkY = chunk / mChunksX;
+
+  // Tiles of the chunk, in tiles and in pixels
+  const SDL_Rect tiles = { chunkX * RENDER_CHUNK, chunkY * RENDER_CHUNK,
+                           SDL_min( RENDER_CHUNK, map.getWidth()  - chunkX * RENDER_CHUNK ),
+                           SDL_min( RENDER_CHUNK, map.getHeight() - chunkY * RENDER_CHUNK ) };
+  const SDL_Rect origin = { chunkX * RENDER_CHUNK_W, chunkY * RENDER_CHUNK_H, RENDER_CHUNK_W, RENDER_CHUNK_H };
+
+  slot.Texture.setAsRenderTarget();
+  renderTiles( map, tiles, origin );
+  SDL_SetRenderTarget( gRenderer, NULL );
+
+  return true;
+}
+
+
+Dot::Dot(void)
+{
+  // Initialize the collision box
+  mBox.x = 0;
+  mBox.y = 0;
+  mBox.w = DOT_WIDTH;
+  mBox.h = DOT_HEIGHT;
+
+  // Initialize the velocity
+  mVelX = 0;
+  mVelY = 0;
+}
+
+
+void Dot::handleEvent( SDL_Event& e )
+{
+  // If a key was pressed
+  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP:     mVelY -= DOT_MAX_VEL; break;
+      case SDLK_DOWN:   mVelY += DOT_MAX_VEL; break;
+      case SDLK_LEFT:   mVelX -= DOT_MAX_VEL; break;
+      case SDLK_RIGHT:  mVelX += DOT_MAX_VEL; break;
+    }
+  }
+  // If a key was released
+  else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP:     mVelY += DOT_MAX_VEL; break;
+      case SDLK_DOWN:   mVelY -= DOT_MAX_VEL; break;
+      case SDLK_LEFT:   mVelX += DOT_MAX_VEL; break;
+      case SDLK_RIGHT:  mVelX -= DOT_MAX_VEL; break;
+    }
+  }
+}
+
+
+/**
+ * @brief Moves the dot and check collision against tiles
+ *
+ * @param map
+ **/
+void Dot::move( const TileMap& map )
+{
+  // Move the dot left or right
+  mBox.x += mVelX;
+
+  // If the dot went too far to the left or right or touched a wall
+  if( ( mBox.x < 0 ) || ( mBox.x + DOT_WIDTH > map.getLevelWidth() ) || touchesWall( mBox, map ) )
+  {
+    // move back
+    mBox.x -= mVelX;
+  }
+  else { /* Movement OK */ }
+
+  // Move the dot up or down
+  mBox.y += mVelY;
+
+  // If the dot went too far up or down or touched a wall
+  if( ( mBox.y < 0 ) || ( mBox.y + DOT_HEIGHT > map.getLevelHeight() ) || touchesWall( mBox, map ) )
+  {
+    // move back
+    mBox.y -= mVelY;
+  }
+  else { /* Movement OK */ }
+}
+
+
+/**
+ * @brief Centers the camera over the dot
+ *
+ * @param camera
+ * @param map
+ **/
+void Dot::setCamera( SDL_Rect& camera, const TileMap& map )
+{
+  // Center the camera over the dot
+  camera.x = ( mBox.x + DOT_WIDTH  / 2 ) - WINDOW_W / 2;
+  camera.y = ( mBox.y + DOT_HEIGHT / 2 ) - WINDOW_H / 2;
+
+  // Keep the camera in bounds
+  if( camera.x < 0 )
+  {
+    camera.x = 0;
   }
   else {;}
 
@@ -587,31 +2373,307 @@ void Dot::setCamera( SDL_Rect& camera )
   {
     camera.y = 0;
   }
-  else {;}
+  else {;}
+
+  if( camera.x > map.getLevelWidth() - camera.w )
+  {
+    camera.x = map.getLevelWidth() - camera.w;
+  }
+  else {;}
+
+  if( camera.y > map.getLevelHeight() - camera.h )
+  {
+    camera.y = map.getLevelHeight() - camera.h;
+  }
+  else {;}
+}
+
+
+/**
+ * @brief Shows the dot on the screen
+ *
+ * @param camera
+ **/
+void Dot::render( SDL_Rect& camera )
+{
+    // Show the dot
+  gDotTexture.render( mBox.x - camera.x, mBox.y - camera.y );
+}
+
+
+const SDL_Rect& Dot::getBox(void) const
+{
+  return mBox;
+}
+
+
+void Dot::place( int x, int y )
+{
+  mBox.x = x;
+  mBox.y = y;
+  mVelX  = 0;
+  mVelY  = 0;
+}
+
+
+NpcCrowd::NpcCrowd(void)
+  : mNextRequest( 0 )
+{;}
+
+
+/**
+ * @brief Puts the NPCs at the centre of floor tiles, spread over the map by a fixed stride, so that
+ * every run starts the same.
+ *
+ * @param map
+ **/
+void NpcCrowd::spawn( const TileMap& map )
+{
+  const Sint64 tiles = static_cast<Sint64>( map.getWidth() ) * map.getHeight();
+
+  mNpcs.clear();
+  mNextRequest = 0;
+
+  for( int npc = 0; npc != NPC_COUNT; ++npc )
+  {
+    // A prime stride visits every tile before coming back
+    Sint64 tile = ( static_cast<Sint64>( npc ) * 7919 ) % tiles;
+
+    for( Sint64 tried = 0; tried != tiles && map.isWall( static_cast<int>( tile % map.getWidth() ), static_cast<int>( tile / map.getWidth() ) ); ++tried )
+    {
+      tile = ( tile + 1 ) % tiles;
+    }
+
+    const int column = static_cast<int>( tile % map.getWidth() );
+    const int row    = static_cast<int>( tile / map.getWidth() );
+
+    if( map.isWall( column, row ) )
+    {
+      printf( "\nNo floor tile for the NPCs!" );
+      break;
+    }
+    else { /* Floor */ }
+
+    mNpcs.push_back( Npc{ SDL_Point{ column * TILE_W + TILE_W / 2, row * TILE_H + TILE_H / 2 }, SDL_Point{ -1, -1 },
+                          std::vector<SDL_Point>(), 0, false } );
+  }
+}
+
+
+/**
+ * @brief Saves the NPCs into two sections of a snapshot: their records, and the points of all their
+ * paths in one pool.
+ *
+ * @param snapshot
+ **/
+void NpcCrowd::saveImage( LSnapshotWriter& snapshot ) const
+{
+  Uint32 points = 0;
+
+  snapshot.beginSection( SNAPSHOT_NPCS );
+
+  for( const Npc& npc : mNpcs )
+  {
+    snapshot.writeValue( NpcImage{ npc.Position, npc.Goal, points, static_cast<Uint32>( npc.Path.size() ),
+                                   static_cast<Uint32>( npc.Next ), npc.IsWaiting ? 1u : 0u } );
+
+    points += static_cast<Uint32>( npc.Path.size() );
+  }
+
+  snapshot.beginSection( SNAPSHOT_NPC_PATHS );
+
+  for( const Npc& npc : mNpcs )
+  {
+    snapshot.writeArray( npc.Path.data(), npc.Path.size() );
+  }
+}
+
+
+/**
+ * @brief Resumes the NPCs from a snapshot, where they were and on the paths they walked. An NPC
+ * that was waiting for a path asks for it again: the search was lost with the program.
+ *
+ * @param snapshot
+ * @return true if successful; false otherwise (no NPC is left)
+ **/
+bool NpcCrowd::loadImage( const LSnapshotImage& snapshot )
+{
+  size_t count  = 0;
+  size_t points = 0;
+
+  const NpcImage*  images = snapshot.GetArray<NpcImage>( SNAPSHOT_NPCS, count );
+  const SDL_Point* pool   = snapshot.GetArray<SDL_Point>( SNAPSHOT_NPC_PATHS, points );
+
+  mNpcs.clear();
+  mNextRequest = 0;
+
+  if( images == NULL || pool == NULL || count > NPC_COUNT )
+  {
+    printf( "\nError resuming NPCs: none in the snapshot!" );
+    return false;
+  }
+  else { /* NPCs present */ }
+
+  for( size_t i = 0; i != count; ++i )
+  {
+    const NpcImage& image = images[ i ];
+
+    if( image.FirstPoint > points || image.Points > points - image.FirstPoint )
+    {
+      printf( "\nError resuming NPCs: path %d out of the snapshot!", static_cast<int>( i ) );
+      mNpcs.clear();
+      return false;
+    }
+    else { /* Path present */ }
+
+    const bool wasWaiting = ( image.IsWaiting != 0 );
+
+    mNpcs.push_back( Npc{ image.Position, wasWaiting ? SDL_Point{ -1, -1 } : image.Goal,
+                          std::vector<SDL_Point>( pool + image.FirstPoint, pool + image.FirstPoint + image.Points ),
+                          image.Next, false } );
+  }
+
+  return true;
+}
+
+
+void NpcCrowd::repath(void)
+{
+  for( Npc& npc : mNpcs )
+  {
+    npc.Goal = SDL_Point{ -1, -1 };
+  }
+}
+
+
+/**
+ * @brief Takes the paths that came back, asks in one batch for those of the NPCs whose goal is not
+ * the tile of the target any more, then moves each NPC towards the next point of its path.
+ *
+ * @param target Box the NPCs walk to, in pixels.
+ **/
+void NpcCrowd::update( const SDL_Rect& target )
+{
+  gPaths.collect( mResults );
+
+  for( LPathfinder::Result& result : mResults )
+  {
+    Npc& npc = mNpcs[ static_cast<size_t>( result.Id ) ];
+
+    // Not found: it stays where it is until the target moves or the map changes
+    npc.Path.swap( result.Points );
+    npc.Next      = 1;
+    npc.IsWaiting = false;
+  }
+
+  const SDL_Point goal = { ( target.x + target.w / 2 ) / TILE_W, ( target.y + target.h / 2 ) / TILE_H };
+
+  mRequests.clear();
+
+  for( size_t checked = 0; checked != mNpcs.size() && mRequests.size() != NPC_REQUESTS_PER_FRAME; ++checked )
+  {
+    const size_t index = ( mNextRequest + checked ) % mNpcs.size();
+    Npc&         npc   = mNpcs[ index ];
+
+    if( !npc.IsWaiting && ( npc.Goal.x != goal.x || npc.Goal.y != goal.y ) )
+    {
+      const SDL_Point start = { npc.Position.x / TILE_W, npc.Position.y / TILE_H };
+
+      mRequests.push_back( LPathfinder::Request{ static_cast<int>( index ), start, goal } );
+
+      npc.Goal      = goal;
+      npc.IsWaiting = true;
+    }
+    else { /* Has its path, or is waiting for it */ }
+  }
 
-  if( camera.x > LEVEL_W - camera.w )
+  if( !mNpcs.empty() )
   {
-    camera.x = LEVEL_W - camera.w;
+    mNextRequest = ( mNextRequest + NPC_REQUESTS_PER_FRAME ) % mNpcs.size();
   }
-  else {;}
+  else { /* Nobody to move */ }
+
+  gPaths.request( mRequests );
 
-  if( camera.y > LEVEL_H - camera.h )
+  for( Npc& npc : mNpcs )
   {
-    camera.y = LEVEL_H - camera.h;
+    if( npc.Next >= npc.Path.size() )
+    {
+      continue;
+    }
+    else { /* Walking */ }
+
+    const SDL_Point& tile = npc.Path[ npc.Next ];
+    const int        dx   = tile.x * TILE_W + TILE_W / 2 - npc.Position.x;
+    const int        dy   = tile.y * TILE_H + TILE_H / 2 - npc.Position.y;
+
+    // Same speed on both axes: the diagonal stretches of a path stay diagonal
+    npc.Position.x += SDL_clamp( dx, -NPC_VEL, NPC_VEL );
+    npc.Position.y += SDL_clamp( dy, -NPC_VEL, NPC_VEL );
+
+    if( ( SDL_abs( dx ) <= NPC_VEL ) && ( SDL_abs( dy ) <= NPC_VEL ) )
+    {
+      ++npc.Next;
+    }
+    else { /* Not there yet */ }
   }
-  else {;}
 }
 
 
 /**
- * @brief Shows the dot on the screen
+ * @brief Shows the NPCs in view as squares, all with one SDL_RenderFillRects, and in the debug
+ * overlay the path still ahead of each.
  *
  * @param camera
  **/
-void Dot::render( SDL_Rect& camera )
+void NpcCrowd::render( const SDL_Rect& camera )
 {
-    // Show the dot
-  gDotTexture.render( mBox.x - camera.x, mBox.y - camera.y );
+  mBoxes.clear();
+
+  for( const Npc& npc : mNpcs )
+  {
+    const SDL_Rect box = { npc.Position.x - NPC_SIZE / 2, npc.Position.y - NPC_SIZE / 2, NPC_SIZE, NPC_SIZE };
+
+    if( SDL_HasIntersection( &box, &camera ) == SDL_TRUE )
+    {
+      mBoxes.push_back( SDL_Rect{ box.x - camera.x, box.y - camera.y, box.w, box.h } );
+    }
+    else { /* Out of view */ }
+
+    if( LDebugDraw::isVisible() && ( npc.Next < npc.Path.size() ) )
+    {
+      SDL_Point from = npc.Position;
+
+      for( size_t point = npc.Next; point != npc.Path.size(); ++point )
+      {
+        const SDL_Point to = { npc.Path[ point ].x * TILE_W + TILE_W / 2, npc.Path[ point ].y * TILE_H + TILE_H / 2 };
+
+        LDebugDraw::line( from.x, from.y, to.x, to.y, NpcPathColour );
+        from = to;
+      }
+    }
+    else { /* Overlay hidden, or arrived */ }
+  }
+
+  if( !mBoxes.empty() )
+  {
+    SDL_SetRenderDrawColor( gRenderer, NpcColour.r, NpcColour.g, NpcColour.b, NpcColour.a );
+    SDL_RenderFillRects( gRenderer, mBoxes.data(), static_cast<int>( mBoxes.size() ) );
+  }
+  else { /* None in view */ }
+}
+
+
+void NpcCrowd::addLights( LLightMap& lights ) const
+{
+  const size_t lanterns = SDL_min( mNpcs.size(), static_cast<size_t>( NPC_LANTERNS ) );
+
+  for( size_t npc = 0; npc != lanterns; ++npc )
+  {
+    const SDL_FPoint centre = { static_cast<float>( mNpcs[ npc ].Position.x ), static_cast<float>( mNpcs[ npc ].Position.y ) };
+
+    lights.add( LLightMap::Light{ centre, LANTERN_RADIUS, LanternColour } );
+  }
 }
 
 
@@ -666,7 +2728,7 @@ static bool init(void)
       printf( "\nOK: window created" );
 
       // Create renderer for window
-      gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+      gRenderer = SDL_CreateRenderer( gWindow, FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_TARGETTEXTURE );
 
       if( gRenderer == NULL )
       {
@@ -680,6 +2742,17 @@ static bool init(void)
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
 
+        // Workers for the paths of the NPCs
+        if( !gJobs.init() )
+        {
+          printf( "\nThe job system could not start!" );
+          success = false;
+        }
+        else
+        {
+          printf( "\nOK: %d job workers started", gJobs.GetWorkerCount() );
+        }
+
         // Initialize PNG loading
         int imgFlags = IMG_INIT_PNG;
 
@@ -704,11 +2777,14 @@ static bool init(void)
 
 
 /**
- * @brief Loads all necessary media for this project.
+ * @brief Loads all necessary media for this project. The level is resumed from the snapshot of the
+ * last run, if there is a valid one, and built from the map files otherwise.
  *
+ * @param map
+ * @param resumed Set if the level was resumed: the scene is in the snapshot too.
  * @return true if loading was successful; false otherwise
  **/
-static bool loadMedia( Tile* tiles[] )
+static bool loadMedia( TileMap& map, bool& resumed )
 {
   // Loading success flag
   bool success = true;
@@ -731,34 +2807,107 @@ static bool loadMedia( Tile* tiles[] )
   else
   { /* Texture loaded correctly */ }
 
-  // Load tile map
-  if( !setTiles( tiles ) )
+  // Load tile map: resumed in place from the snapshot, whatever its size, or built. Performance
+  // runs always build it, to start the same every time
+  const Uint64 levelStart = SDL_GetPerformanceCounter();
+
+  resumed = !LPerfHarness::isActive() && resumeLevel( map );
+
+  if( !resumed && !setTiles( map ) )
   {
     printf( "\nFailed to load tile set!" );
     success = false;
   }
   else
-  { /* Tiles loaded correctly */ }
+  {
+    // Tiles loaded correctly
+    if( resumed )
+    {
+      setTileClips();
+    }
+    else { /* Clipped by setTiles */ }
+
+    gTileChunks.init( map );
+
+    // The walls, as the NPCs see them: made on the cells of the snapshot, or marked tile by tile
+    if( resumed )
+    {
+      printf( "\nOK: walls read from \"%s\"", g_LazySnap.c_str() );
+    }
+    else if( gPaths.create( map.getWidth(), map.getHeight(), &gJobs ) )
+    {
+      map.markWalls( gPaths );
+    }
+    else
+    {
+      success = false;
+    }
+
+    // Torches on the floor, lit once into the static layer of the light map
+    gTargets.setRenderer( gRenderer );
+
+    if( gLights.create( gTargets, WINDOW_W, WINDOW_H, map.getLevelWidth(), map.getLevelHeight() ) )
+    {
+      gLights.setAmbient( AmbientColour );
+
+      // Those of the snapshot, as they were left, or placed looking for floor
+      size_t                  saved   = 0;
+      const LLightMap::Light* torches = resumed ? gSnapshot.GetArray<LLightMap::Light>( SNAPSHOT_TORCHES, saved ) : NULL;
+
+      for( size_t torch = 0; torches != NULL && torch != saved && torch != MAX_TORCHES; ++torch )
+      {
+        gLights.addStatic( torches[ torch ] );
+      }
+
+      for( int row = TORCH_STRIDE / 2; torches == NULL && row < map.getHeight() && gLights.GetStaticCount() != MAX_TORCHES; row += TORCH_STRIDE )
+      {
+        for( int column = TORCH_STRIDE / 2; column < map.getWidth() && gLights.GetStaticCount() != MAX_TORCHES; column += TORCH_STRIDE )
+        {
+          if( !map.isWall( column, row ) )
+          {
+            const SDL_FPoint centre = { static_cast<float>( column * TILE_W + TILE_W / 2 ), static_cast<float>( row * TILE_H + TILE_H / 2 ) };
+
+            gLights.addStatic( LLightMap::Light{ centre, TORCH_RADIUS, TorchColour } );
+          }
+          else { /* No torch in a wall */ }
+        }
+      }
+
+      printf( "\nOK: %d torches", static_cast<int>( gLights.GetStaticCount() ) );
+    }
+    else
+    {
+      // The level is drawn unlit
+      printf( "\nWarning: no light map!" );
+    }
+
+    const double levelMs = static_cast<double>( SDL_GetPerformanceCounter() - levelStart ) * 1000.0 /
+                           static_cast<double>( SDL_GetPerformanceFrequency() );
+
+    printf( resumed ? "\nOK: level resumed in %.2f ms" : "\nOK: level built in %.2f ms", levelMs );
+  }
 
   return success;
 }
 
 
-static void close( Tile* tiles[] )
+static void close( void )
 {
-  // Deallocate tiles
-  for( int i = 0; i < TOTAL_TILES; ++i )
-  {
-     if( tiles[ i ] != NULL )
-     {
-      delete tiles[ i ];
-      tiles[ i ] = NULL;
-     }
-  }
-
   // Free loaded images
   gDotTexture.free();
   gTileTexture.free();
+  gTileChunks.free();
+
+  // Wait for the paths still being searched, then stop the workers
+  gPaths.free();
+  gJobs.shutdown();
+
+  // Nothing reads the snapshot any more
+  gSnapshot.close();
+
+  // The light map's targets go back to the pool, which destroys them
+  gLights.free();
+  gTargets.clear();
 
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
@@ -773,237 +2922,278 @@ static void close( Tile* tiles[] )
 
 
 /**
- * @brief Box collision detector
+ * @brief Sets tiles from tile map: the binary map if present, otherwise the text one, which is then
+ * saved in the binary format for the next runs.
  *
- * @param a
- * @param b
+ * @param map
  * @return true
  * @return false
  **/
-bool checkCollision( SDL_Rect a, SDL_Rect b )
+bool setTiles( TileMap& map )
 {
-  // The sides of the rectangles
-  int leftA, leftB;
-  int rightA, rightB;
-  int topA, topB;
-  int bottomA, bottomB;
+  bool tilesLoaded = map.loadBinary( g_LazyTMap );
 
-  // Calculate the sides of rect A
-  leftA   = a.x;
-  rightA  = a.x + a.w;
-  topA    = a.y;
-  bottomA = a.y + a.h;
+  if( !tilesLoaded )
+  {
+    tilesLoaded = map.loadText( g_LazyMap, LAZY_MAP_W, LAZY_MAP_H );
 
-  // Calculate the sides of rect B
-  leftB   = b.x;
-  rightB  = b.x + b.w;
-  topB    = b.y;
-  bottomB = b.y + b.h;
+    if( tilesLoaded && map.saveBinary( g_LazyTMap ) )
+    {
+      printf( "\nOK: \"%s\" converted to \"%s\"", g_LazyMap.c_str(), g_LazyTMap.c_str() );
+    }
+    else { /* Loading or conversion failed: the text map is used again next time */ }
+  }
+  else { /* Binary map loaded */ }
 
-  // If any of the sides from A are outside of B
-  if( bottomA <= topB )
+  // Clip the sprite sheet
+  if( tilesLoaded )
   {
-    return false;
+    printf( "\nMap of %dx%d tiles: %d of %d chunks uniform, %d bytes", map.getWidth(), map.getHeight(),
+            static_cast<int>( map.getUniformChunks() ),
+            ( ( map.getWidth() + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK ) * ( ( map.getHeight() + TILE_MAP_CHUNK - 1 ) / TILE_MAP_CHUNK ),
+            static_cast<int>( map.getMemoryBytes() ) );
+
+    setTileClips();
   }
-  else {;}
+  else{ /* Error loading tiles */ }
+
+  // If the map was loaded fine
+  return tilesLoaded;
+}
 
-  if( topA >= bottomB )
+
+/**
+ * @brief Resumes the level from the snapshot of the last run: the map and the walls of the
+ * pathfinder read it where it is mapped, so nothing is loaded or converted, whatever the size of the
+ * world. A missing, older or damaged snapshot is not an error: the level is built as on a first run.
+ *
+ * @param map
+ * @return true if resumed; false otherwise (the snapshot is closed)
+ **/
+bool resumeLevel( TileMap& map )
+{
+  if( gSnapshot.open( g_LazySnap, SNAPSHOT_VERSION ) != LSaveReader::Status::LOADED )
   {
     return false;
   }
-  else {;}
+  else { /* Mapped */ }
 
-  if( rightA <= leftB )
+  size_t        words = 0;
+  const Uint64* walls = gSnapshot.GetArray<Uint64>( SNAPSHOT_WALLS, words );
+
+  if( map.adoptImage( gSnapshot ) && walls != NULL &&
+      gPaths.create( map.getWidth(), map.getHeight(), walls, words, &gJobs ) )
   {
-    return false;
+    printf( "\nOK: map of %dx%d tiles resumed from \"%s\"", map.getWidth(), map.getHeight(), g_LazySnap.c_str() );
+    return true;
   }
-  else {;}
+  else { /* Incomplete snapshot */ }
+
+  // The map read from it is loaded again by setTiles, before any use
+  gPaths.free();
+  gSnapshot.close();
 
-  if( leftA >= rightB )
+  return false;
+}
+
+
+/**
+ * @brief Resumes the dot, the NPCs and the torches switch from the snapshot the level was resumed
+ * from; what it lacks starts as on a first run.
+ *
+ * @param map
+ * @param dot
+ * @param npcs
+ * @param torchesLit
+ **/
+void resumeScene( const TileMap& map, Dot& dot, NpcCrowd& npcs, bool& torchesLit )
+{
+  size_t            count = 0;
+  const SceneImage* scene = gSnapshot.GetArray<SceneImage>( SNAPSHOT_SCENE, count );
+
+  if( scene != NULL && count == 1 )
   {
-    return false;
+    dot.place( scene->DotPosition.x, scene->DotPosition.y );
+    torchesLit = ( scene->TorchesLit != 0 );
   }
-  else {;}
+  else { /* The dot starts at the corner, torches lit */ }
 
-  // If none of the sides from A are outside B
-  return true;
+  if( !npcs.loadImage( gSnapshot ) )
+  {
+    npcs.spawn( map );
+  }
+  else { /* Walking where they were */ }
 }
 
 
 /**
- * @brief Sets tiles from tile map
+ * @brief Saves the whole program into the snapshot the next run resumes from: the level as it is in
+ * memory, the walls of the pathfinder, the torches, the dot and the NPCs.
  *
- * @param tiles
- * @return true
- * @return false
+ * Called on exit: the pathfinder is freed and the snapshot resumed from is closed, so that the new
+ * one can replace it, and neither may be used afterwards.
+ *
+ * @param map
+ * @param dot
+ * @param npcs
+ * @param torchesLit
+ * @return true if successful; false otherwise (the previous snapshot is left)
  **/
-bool setTiles( Tile* tiles[] )
+bool saveSnapshot( const TileMap& map, const Dot& dot, const NpcCrowd& npcs, bool torchesLit )
 {
-  // Success flag
-  bool tilesLoaded = true;
+  LSnapshotWriter snapshot;
 
-  // The tile offsets
-  int x = 0, y = 0;
+  map.saveImage( snapshot );
 
-  // Open the map
-  std::ifstream MapFile( g_LazyMap );
+  size_t        words = 0;
+  const Uint64* walls = gPaths.GetCells( words );
 
-  // If the map couldn't be loaded
-  if( MapFile.fail() )
+  snapshot.beginSection( SNAPSHOT_WALLS );
+  snapshot.writeArray( walls, words );
+
+  snapshot.beginSection( SNAPSHOT_TORCHES );
+
+  for( int torch = 0; torch != static_cast<int>( gLights.GetStaticCount() ); ++torch )
   {
-    printf( "\nUnable to load map file!" );
-    tilesLoaded = false;
+    snapshot.writeValue( gLights.GetStatic( torch ) );
   }
-  else
-  {
-    // Initialize the tiles
-    for( int i = 0; i != TOTAL_TILES; ++i )
-    {
-      // Determines what kind of tile will be made
-      int tileType = -1;
 
-      // Read tile from map file
-      MapFile >> tileType;
+  snapshot.beginSection( SNAPSHOT_SCENE );
+  snapshot.writeValue( SceneImage{ SDL_Point{ dot.getBox().x, dot.getBox().y }, torchesLit ? 1u : 0u, 0 } );
 
-      // If the was a problem in reading the map
-      if( MapFile.fail() )
-      {
-        // Stop loading map
-        printf( "\nError loading map: Unexpected end of file!\n" );
-        tilesLoaded = false;
-        break;
-      }
-      else
-      { /* Reading was OK */ }
+  npcs.saveImage( snapshot );
 
-      // If the number is a valid tile number
-      if( ( tileType >= 0 ) && ( tileType < TOTAL_TILE_SPRITES ) )
-      {
-        tiles[ i ] = new Tile( x, y, tileType );
-      }
-      // If we don't recognize the tile type
-      else
-      {
-        // Stop loading map
-        printf( "\nError loading map: Invalid tile type at %d!\n", i );
-        tilesLoaded = false;
-        break;
-      }
+  // Everything is copied: the old snapshot can go, which Windows requires to replace it
+  gPaths.free();
+  gSnapshot.close();
 
-      // Move to next tile spot
-      x += TILE_W;
+  const bool saved = snapshot.commit( g_LazySnap, SNAPSHOT_VERSION );
 
-      // If we've gone too far
-      if( x >= LEVEL_W )
-      {
-        // Move back
-        x = 0;
+  if( saved )
+  {
+    printf( "\nOK: snapshot saved to \"%s\"", g_LazySnap.c_str() );
+  }
+  else { /* Error already reported */ }
+
+  return saved;
+}
 
-        // Move to the next row
-        y += TILE_H;
-      }
-      else
-      { /* Position was OK */ }
-    }
 
-    // Clip the sprite sheet
-    if( tilesLoaded )
+/**
+ * @brief Sets the clip rectangles of the tile sprites
+ **/
+void setTileClips( void )
+{
+  gTileClips[ TILE_RED ].x = 0;
+  gTileClips[ TILE_RED ].y = 0;
+  gTileClips[ TILE_RED ].w = TILE_W;
+  gTileClips[ TILE_RED ].h = TILE_H;
+
+  gTileClips[ TILE_GREEN ].x = 0;
+  gTileClips[ TILE_GREEN ].y = 80;
+  gTileClips[ TILE_GREEN ].w = TILE_W;
+  gTileClips[ TILE_GREEN ].h = TILE_H;
+
+  gTileClips[ TILE_BLUE ].x = 0;
+  gTileClips[ TILE_BLUE ].y = 160;
+  gTileClips[ TILE_BLUE ].w = TILE_W;
+  gTileClips[ TILE_BLUE ].h = TILE_H;
+
+  gTileClips[ TILE_TOPLEFT ].x = 80;
+  gTileClips[ TILE_TOPLEFT ].y = 0;
+  gTileClips[ TILE_TOPLEFT ].w = TILE_W;
+  gTileClips[ TILE_TOPLEFT ].h = TILE_H;
+
+  gTileClips[ TILE_LEFT ].x = 80;
+  gTileClips[ TILE_LEFT ].y = 80;
+  gTileClips[ TILE_LEFT ].w = TILE_W;
+  gTileClips[ TILE_LEFT ].h = TILE_H;
+
+  gTileClips[ TILE_BOTTOMLEFT ].x = 80;
+  gTileClips[ TILE_BOTTOMLEFT ].y = 160;
+  gTileClips[ TILE_BOTTOMLEFT ].w = TILE_W;
+  gTileClips[ TILE_BOTTOMLEFT ].h = TILE_H;
+
+  gTileClips[ TILE_TOP ].x = 160;
+  gTileClips[ TILE_TOP ].y = 0;
+  gTileClips[ TILE_TOP ].w = TILE_W;
+  gTileClips[ TILE_TOP ].h = TILE_H;
+
+  gTileClips[ TILE_CENTER ].x = 160;
+  gTileClips[ TILE_CENTER ].y = 80;
+  gTileClips[ TILE_CENTER ].w = TILE_W;
+  gTileClips[ TILE_CENTER ].h = TILE_H;
+
+  gTileClips[ TILE_BOTTOM ].x = 160;
+  gTileClips[ TILE_BOTTOM ].y = 160;
+  gTileClips[ TILE_BOTTOM ].w = TILE_W;
+  gTileClips[ TILE_BOTTOM ].h = TILE_H;
+
+  gTileClips[ TILE_TOPRIGHT ].x = 240;
+  gTileClips[ TILE_TOPRIGHT ].y = 0;
+  gTileClips[ TILE_TOPRIGHT ].w = TILE_W;
+  gTileClips[ TILE_TOPRIGHT ].h = TILE_H;
+
+  gTileClips[ TILE_RIGHT ].x = 240;
+  gTileClips[ TILE_RIGHT ].y = 80;
+  gTileClips[ TILE_RIGHT ].w = TILE_W;
+  gTileClips[ TILE_RIGHT ].h = TILE_H;
+
+  gTileClips[ TILE_BOTTOMRIGHT ].x = 240;
+  gTileClips[ TILE_BOTTOMRIGHT ].y = 160;
+  gTileClips[ TILE_BOTTOMRIGHT ].w = TILE_W;
+  gTileClips[ TILE_BOTTOMRIGHT ].h = TILE_H;
+}
+
+
+/**
+ * @brief Renders a range of tiles one by one.
+ *
+ * @param map
+ * @param tiles Columns and rows to render, as returned by TileMap::getTileRange.
+ * @param view Area of the level seen by the render target.
+ **/
+void renderTiles( const TileMap& map, const SDL_Rect& tiles, const SDL_Rect& view )
+{
+  for( int row = tiles.y; row != tiles.y + tiles.h; ++row )
+  {
+    for( int column = tiles.x; column != tiles.x + tiles.w; ++column )
     {
-      gTileClips[ TILE_RED ].x = 0;
-      gTileClips[ TILE_RED ].y = 0;
-      gTileClips[ TILE_RED ].w = TILE_W;
-      gTileClips[ TILE_RED ].h = TILE_H;
-
-      gTileClips[ TILE_GREEN ].x = 0;
-      gTileClips[ TILE_GREEN ].y = 80;
-      gTileClips[ TILE_GREEN ].w = TILE_W;
-      gTileClips[ TILE_GREEN ].h = TILE_H;
-
-      gTileClips[ TILE_BLUE ].x = 0;
-      gTileClips[ TILE_BLUE ].y = 160;
-      gTileClips[ TILE_BLUE ].w = TILE_W;
-      gTileClips[ TILE_BLUE ].h = TILE_H;
-
-      gTileClips[ TILE_TOPLEFT ].x = 80;
-      gTileClips[ TILE_TOPLEFT ].y = 0;
-      gTileClips[ TILE_TOPLEFT ].w = TILE_W;
-      gTileClips[ TILE_TOPLEFT ].h = TILE_H;
-
-      gTileClips[ TILE_LEFT ].x = 80;
-      gTileClips[ TILE_LEFT ].y = 80;
-      gTileClips[ TILE_LEFT ].w = TILE_W;
-      gTileClips[ TILE_LEFT ].h = TILE_H;
-
-      gTileClips[ TILE_BOTTOMLEFT ].x = 80;
-      gTileClips[ TILE_BOTTOMLEFT ].y = 160;
-      gTileClips[ TILE_BOTTOMLEFT ].w = TILE_W;
-      gTileClips[ TILE_BOTTOMLEFT ].h = TILE_H;
-
-      gTileClips[ TILE_TOP ].x = 160;
-      gTileClips[ TILE_TOP ].y = 0;
-      gTileClips[ TILE_TOP ].w = TILE_W;
-      gTileClips[ TILE_TOP ].h = TILE_H;
-
-      gTileClips[ TILE_CENTER ].x = 160;
-      gTileClips[ TILE_CENTER ].y = 80;
-      gTileClips[ TILE_CENTER ].w = TILE_W;
-      gTileClips[ TILE_CENTER ].h = TILE_H;
-
-      gTileClips[ TILE_BOTTOM ].x = 160;
-      gTileClips[ TILE_BOTTOM ].y = 160;
-      gTileClips[ TILE_BOTTOM ].w = TILE_W;
-      gTileClips[ TILE_BOTTOM ].h = TILE_H;
-
-      gTileClips[ TILE_TOPRIGHT ].x = 240;
-      gTileClips[ TILE_TOPRIGHT ].y = 0;
-      gTileClips[ TILE_TOPRIGHT ].w = TILE_W;
-      gTileClips[ TILE_TOPRIGHT ].h = TILE_H;
-
-      gTileClips[ TILE_RIGHT ].x = 240;
-      gTileClips[ TILE_RIGHT ].y = 80;
-      gTileClips[ TILE_RIGHT ].w = TILE_W;
-      gTileClips[ TILE_RIGHT ].h = TILE_H;
-
-      gTileClips[ TILE_BOTTOMRIGHT ].x = 240;
-      gTileClips[ TILE_BOTTOMRIGHT ].y = 160;
-      gTileClips[ TILE_BOTTOMRIGHT ].w = TILE_W;
-      gTileClips[ TILE_BOTTOMRIGHT ].h = TILE_H;
+      const SDL_Rect box = map.getBox( column, row );
+
+      // Show the tile
+      gTileTexture.render( box.x - view.x, box.y - view.y, &gTileClips[ map.getType( column, row ) ] );
     }
-    else{ /* Error loading tiles */ }
   }
-
-  // Close the file
-  MapFile.close();
-
-  // If the map was loaded fine
-  return tilesLoaded;
 }
 
 
 /**
- * @brief Checks collision box against set of tiles
+ * @brief Checks collision box against set of tiles. Only the tiles under the box are looked at:
+ * their range follows from TILE_W/TILE_H, so the cost depends on the size of the box and not on the
+ * size of the level.
  *
  * @param box
- * @param tiles
+ * @param map
  * @return true
  * @return false
  **/
-bool touchesWall( SDL_Rect box, Tile* tiles[] )
+bool touchesWall( SDL_Rect box, const TileMap& map )
 {
-  // Go through the tiles
-  for( int i = 0; i != TOTAL_TILES; ++i )
+  // Tiles the box overlaps; touching a tile's edge is not a collision
+  const SDL_Rect tiles = map.getTileRange( box );
+
+  for( int row = tiles.y; row != tiles.y + tiles.h; ++row )
   {
-    // If the tile is a wall type tile
-    if( ( tiles[ i ]->getType() >= TILE_CENTER ) && ( tiles[ i ]->getType() <= TILE_TOPLEFT ) )
+    for( int column = tiles.x; column != tiles.x + tiles.w; ++column )
     {
-      // If the collision box touches the wall tile
-      if( checkCollision( box, tiles[ i ]->getBox() ) )
+      // If the collision box touches a wall tile
+      if( map.isWall( column, row ) )
       {
         return true;
       }
-      else { /* No collision */ }
+      else { /* Tile is not a wall type */ }
     }
-    else { /* Tile is not a wall type */ }
   }
 
   // If no wall tiles were touched
@@ -1011,6 +3201,45 @@ bool touchesWall( SDL_Rect box, Tile* tiles[] )
 }
 
 
+/**
+ * @brief Pushes to the debug overlay what the frame works on: the grid of the tiles in view, and
+ * the tiles "touchesWall" checks under the dot, filled where they are walls. The chunks drawn are
+ * outlined by TileChunkCache::render.
+ *
+ * @param camera Area of the level in view, already set with LDebugDraw::setCamera.
+ **/
+void drawDebugOverlay( const TileMap& map, const Dot& dot, const SDL_Rect& camera )
+{
+  if( LDebugDraw::isVisible() )
+  {
+    const SDL_Rect visible = map.getTileRange( camera );
+
+    LDebugDraw::grid( SDL_Rect{ visible.x * TILE_W, visible.y * TILE_H, visible.w * TILE_W, visible.h * TILE_H }, TILE_W, TILE_H, TileGridColour );
+
+    const SDL_Rect checked = map.getTileRange( dot.getBox() );
+
+    for( int row = checked.y; row != checked.y + checked.h; ++row )
+    {
+      for( int column = checked.x; column != checked.x + checked.w; ++column )
+      {
+        const SDL_Rect box = map.getBox( column, row );
+
+        if( map.isWall( column, row ) )
+        {
+          LDebugDraw::fillRect( box, HitWallColour );
+        }
+        else { /* Floor */ }
+
+        LDebugDraw::rect( box, CheckedTileColour );
+      }
+    }
+
+    LDebugDraw::rect( dot.getBox(), DotBoxColour );
+  }
+  else { /* Overlay hidden, or compiled out */ }
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -1038,8 +3267,13 @@ int main( int argc, char* args[] )
     printf("\nArgument #%d: %s\n", i, args[i]);
   }
 
+  // "--perf-frames=<N>" runs a scripted, headless performance check
+  if( !LPerfHarness::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   // Start up SDL and create window
-  if( !init() )
+  else if( !init() )
   {
     printf( "\nFailed to initialize!" );
   }
@@ -1048,10 +3282,13 @@ int main( int argc, char* args[] )
     printf( "\nOK: all systems initialised" );
 
     // The level tiles
-    Tile* tileSet[ TOTAL_TILES ];
+    TileMap tileMap;
+
+    // Whether the level was resumed from the snapshot of the last run
+    bool resumed = false;
 
     // Load media
-    if( !loadMedia( tileSet ) )
+    if( !loadMedia( tileMap, resumed ) )
     {
       printf( "\nFailed to load media!" );
     }
@@ -1071,9 +3308,32 @@ int main( int argc, char* args[] )
       // Level camera
       SDL_Rect camera = { 0, 0, WINDOW_W, WINDOW_H };
 
+      // Live map editing
+      TileMapEditor editor( tileMap, gTileChunks, gPaths );
+
+      // NPCs following the dot
+      NpcCrowd npcs;
+
+      // L switches the torches
+      bool torchesLit = true;
+
+      if( resumed )
+      {
+        resumeScene( tileMap, dot, npcs, torchesLit );
+      }
+      else
+      {
+        npcs.spawn( tileMap );
+      }
+
+      printf( "\nLeft click: wall, right click: floor, S: save \"%s\", L: torches", g_LazyTMap.c_str() );
+
       // While application is running
       while( !quit )
       {
+        // Scripted input of this frame, if any
+        LPerfHarness::beginFrame();
+
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
         {
@@ -1082,38 +3342,131 @@ int main( int argc, char* args[] )
           {
             quit = true;
           }
+          // The content of the chunk textures was lost
+          else if( e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET )
+          {
+            gTileChunks.invalidateAll();
+            gLights.invalidate();
+          }
+          // Edit the tile under the mouse, also while dragging
+          else if( ( e.type == SDL_MOUSEBUTTONDOWN ) || ( ( e.type == SDL_MOUSEMOTION ) && ( e.motion.state != 0 ) ) )
+          {
+            const int  x    = ( ( e.type == SDL_MOUSEBUTTONDOWN ) ? e.button.x : e.motion.x ) + camera.x;
+            const int  y    = ( ( e.type == SDL_MOUSEBUTTONDOWN ) ? e.button.y : e.motion.y ) + camera.y;
+            const bool wall = ( e.type == SDL_MOUSEBUTTONDOWN ) ? ( e.button.button == SDL_BUTTON_LEFT )
+                                                                : ( ( e.motion.state & SDL_BUTTON_LMASK ) != 0 );
+
+            const int column = x / TILE_W;
+            const int row    = y / TILE_H;
+            const SDL_Rect box = tileMap.getBox( column, row );
+
+            if( !wall )
+            {
+              // Same red, green, blue pattern as lazy.map
+              if( editor.setFloor( column, row, ( column + row ) % 3 ) )
+              {
+                npcs.repath();
+              }
+              else { /* Already that floor */ }
+            }
+            // Do not wall the dot in
+            else if( SDL_HasIntersection( &box, &dot.getBox() ) == SDL_FALSE )
+            {
+              if( editor.setWall( column, row ) )
+              {
+                npcs.repath();
+              }
+              else { /* Already a wall */ }
+            }
+            else { /* The dot is on that tile */ }
+          }
+          // Turn the torches off or on: their layer is drawn again once
+          else if( ( e.type == SDL_KEYDOWN ) && ( e.key.repeat == 0 ) && ( e.key.keysym.sym == SDLK_l ) )
+          {
+            torchesLit = !torchesLit;
+
+            for( int torch = 0; torch != static_cast<int>( gLights.GetStaticCount() ); ++torch )
+            {
+              LLightMap::Light light = gLights.GetStatic( torch );
+
+              light.Colour.a = torchesLit ? TorchColour.a : 0x00;
+              gLights.setStatic( torch, light );
+            }
+          }
+          // Save the edited map
+          else if( ( e.type == SDL_KEYDOWN ) && ( e.key.repeat == 0 ) && ( e.key.keysym.sym == SDLK_s ) )
+          {
+            if( tileMap.saveBinary( g_LazyTMap ) )
+            {
+              printf( "\nOK: map saved to \"%s\"", g_LazyTMap.c_str() );
+            }
+            else { /* Error already reported */ }
+          }
           else { /* Event not managed here */ }
 
           // Handle input for the dot
           dot.handleEvent( e );
+
+          // F3 shows the debug overlay
+          LDebugDraw::handleEvent( e );
         }
 
         // Move the dot
-        dot.move( tileSet );
-        dot.setCamera( camera );
+        dot.move( tileMap );
+        dot.setCamera( camera, tileMap );
+
+        // Move the NPCs towards it
+        npcs.update( dot.getBox() );
+
+        // The overlay's shapes are in level coordinates
+        LDebugDraw::setCamera( camera.x, camera.y );
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
         // Render level
-        for( int i = 0; i != TOTAL_TILES; ++i )
-        {
-          tileSet[ i ]->render( camera );
-        }
+        gTileChunks.render( tileMap, camera );
 
-        // Render dot
+        // Render NPCs, then the dot over them
+        npcs.render( camera );
         dot.render( camera );
 
+        // Light the scene: torches, the dot and the lanterns
+        const SDL_FPoint dotCentre = { static_cast<float>( dot.getBox().x + Dot::DOT_WIDTH / 2 ), static_cast<float>( dot.getBox().y + Dot::DOT_HEIGHT / 2 ) };
+
+        gLights.begin( camera );
+        gLights.add( LLightMap::Light{ dotCentre, DOT_LIGHT_RADIUS, DotLightColour } );
+        npcs.addLights( gLights );
+        gLights.render();
+
+        // Draw the debug overlay over everything
+        drawDebugOverlay( tileMap, dot, camera );
+        LDebugDraw::render( gRenderer );
+
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        LPerfHarness::endFrame();
+      }
+
+      printf( "\nPaths: %d searched, %d from the cache", static_cast<int>( gPaths.GetSearches() ), static_cast<int>( gPaths.GetCacheHits() ) );
+
+      // The next run resumes from here; performance runs leave no trace
+      if( !LPerfHarness::isActive() )
+      {
+        saveSnapshot( tileMap, dot, npcs, torchesLit );
       }
+      else { /* Headless */ }
     }
 
     // Free resources and close SDL
-    close( tileSet );
+    close();
   }
 
+  // Frame times, allocations and draw calls against the budget, if it was a performance run
+  HasProgramSucceeded = LPerfHarness::finish() && HasProgramSucceeded;
+
   // Integrity check
   if ( HasProgramSucceeded == true )
   {
@@ -1124,7 +3477,12 @@ int main( int argc, char* args[] )
     printf("\nThere was a problem during the execution of the program!\n");
   }
 
-  PressEnter();
+  // Nobody to press ENTER during a performance run
+  if( !LPerfHarness::isActive() )
+  {
+    PressEnter();
+  }
+  else { /* Headless */ }
 
-  return 0;
+  return HasProgramSucceeded ? 0 : 1;
 }
\ No newline at end of file
@@ -19,6 +19,11 @@
  *  - Una volta caricata la texture streamabile, la modifichiamo in "loadMedia". In sostanza, è un
  *    colour-keying manuale.
  *
+ * Aggiunta GS: il colour key non è più applicato un pixel alla volta, ma da "ApplyColourKey" di
+ * Engine_Lib/LPixelOps, che confronta e sostituisce quattro o otto pixel per istruzione (SSE2, AVX2
+ * o NEON, scelti a runtime secondo la CPU). I pixel sono divisi in fasce di righe, con i bordi
+ * allineati alle linee di cache, ripartite fra i thread di "LJobSystem".
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -33,6 +38,9 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include "colour_palette.hpp"
+#include "LJobSystem.hpp"
+#include "LPixelOps.hpp"
 
 
 /**************************************************************************************************
@@ -44,17 +52,9 @@ static constexpr int FIRST_ONE = -1;
 static constexpr int WINDOW_W = 800; // Screen's width
 static constexpr int WINDOW_H = 600; // Screen's heigth
 
-// Colore bianco
-static constexpr int WHITE_R = 0xFF; // Amount of red   needed to compose white
-static constexpr int WHITE_G = 0xFF; // Amount of green needed to compose white
-static constexpr int WHITE_B = 0xFF; // Amount of blue  needed to compose white
-static constexpr int WHITE_A = 0xFF; // Alpha component
-
-// Colore ciano
-static constexpr int CYAN_R = 0x00; // Amount of red   needed to compose cyan
-static constexpr int CYAN_G = 0xFF; // Amount of green needed to compose cyan
-static constexpr int CYAN_B = 0xFF; // Amount of blue  needed to compose cyan
-static constexpr int CYAN_A = 0xFF; // Alpha component
+// Colour key of the sprite sheet and the colour replacing it, from Colours_Lib
+static constexpr Colour COLOUR_KEY  = Palette::ColourKey;
+static constexpr Colour TRANSPARENT = Palette::Transparent;
 
 
 /* Paths */
@@ -141,6 +141,9 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gFooTexture;
 
+// Workers for the pixel processing at load time
+static LJobSystem gJobs;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -482,7 +485,7 @@ static bool init(void)
         printf( "\nOK: renderer created" );
 
         // Initialize renderer color
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+        SetRenderDrawColour( gRenderer, Palette::White );
 
         // Initialize PNG loading
         int imgFlags = IMG_INIT_PNG;
@@ -497,6 +500,16 @@ static bool init(void)
           printf( "\nOK: SDL_image initialised" );
         }
 
+        // Start the job workers: if they cannot start, the bands run on this thread
+        if( !gJobs.init() )
+        {
+          printf( "\nUnable to start the job workers!" );
+        }
+        else
+        {
+          printf( "\nOK: %d job workers started", gJobs.GetWorkerCount() );
+        }
+
       } // Renderer created
 
     } // Window created
@@ -537,33 +550,16 @@ static bool loadMedia( void )
     {
       printf( "\nOK: Foo texture locked" );
 
-      // Allocate format from window
-      Uint32           format        = SDL_GetWindowPixelFormat( gWindow );
-      SDL_PixelFormat* mappingFormat = SDL_AllocFormat( format );
+      // Color key pixels, four or eight at a time with the SIMD kernels of Engine_Lib/LPixelOps, in
+      // row bands shared by the job workers (a texture as small as this one stays on this thread)
+      Uint32 format = SDL_GetWindowPixelFormat( gWindow );
 
-      // Get pixel data
-      Uint32* pixels     = (Uint32*)gFooTexture.getPixels();
-      int     pixelCount = ( gFooTexture.getPitch() / 4 ) * gFooTexture.getHeight();
-
-      // Map colors
-      Uint32 colorKey    = SDL_MapRGB ( mappingFormat, CYAN_R , CYAN_G , CYAN_B );
-      Uint32 transparent = SDL_MapRGBA( mappingFormat, WHITE_R, WHITE_G, WHITE_B, 0x00 );
-
-      // Color key pixels
-      for( int i = 0; i != pixelCount; ++i )
-      {
-        if( pixels[ i ] == colorKey )
-        {
-          pixels[ i ] = transparent;
-        }
-        else { /*  */ }
-      }
+      ApplyColourKey( gJobs, gFooTexture.getPixels(), gFooTexture.getPitch(), gFooTexture.getHeight(),
+                      COLOUR_KEY.Pack( format ), TRANSPARENT.Pack( format ) );
+      printf( "\nOK: colour key applied by the %s kernel", GetPixelOpsKernel() );
 
       // Unlock texture
       gFooTexture.unlockTexture();
-
-      // Free format
-      SDL_FreeFormat( mappingFormat );
     }
   }
 
@@ -576,6 +572,9 @@ static void close(void)
   // Free loaded images
   gFooTexture.free();
 
+  // Stop the job workers
+  gJobs.shutdown();
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow  ( gWindow );
@@ -654,7 +653,7 @@ int main( int argc, char* args[] )
         }
 
         // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+        SetRenderDrawColour( gRenderer, Palette::White );
         SDL_RenderClear( gRenderer );
 
         // Render stick figure
@@ -23,6 +23,13 @@
  *    cui basare il posizionamento geometrico di tutti gli altri caratteri.
  *  - Il metodo "renderText" renderizza il testo a partire da una
  *
+ * Aggiunta GS: le metriche dei glifi (clip, spazio e a capo) si possono preparare offline con
+ * "BakeTextures --glyphs lazyfont.png", che scrive "lazyfont.png.glyphs": "buildFont" le legge da
+ * lì senza bloccare la texture né leggerne i pixel. Se il file manca, le misura
+ * "ComputeGlyphMetrics" di Engine_Lib, leggendo ogni pixel una sola volta invece delle quattro
+ * scansioni con "getPixel32". "renderText" accumula i quadrilateri di tutti i caratteri e li
+ * disegna con una sola chiamata a "SDL_RenderGeometry", invece di una "render" per carattere.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -37,6 +44,9 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
+
+#include "LGlyphMetrics.hpp"
 
 
 /**************************************************************************************************
@@ -62,8 +72,6 @@ static constexpr int CYAN_A = 0xFF; // Alpha component
 
 static constexpr int PADDING_px      = 10; // Amount of padding (lateral spacing) between characters
 static constexpr int BYTES_PER_PIXEL = 4;
-static constexpr int GLYPHS_PER_ROW  = 16; // Numero di glifi contenuti in ogni riga    dello sprite sheet
-static constexpr int GLYPHS_PER_COL  = 16; // Numero di glifi contenuti in ogni colonna dello sprite sheet
 
 /* Paths */
 
@@ -118,6 +126,9 @@ class LTexture
   int    getPitch      ( void ) const;
   Uint32 getPixel32    ( unsigned int, unsigned int );
 
+  // The texture, for SDL_RenderGeometry
+  SDL_Texture* getTexture( void ) const;
+
 private:
 
   // The actual hardware texture
@@ -141,20 +152,24 @@ class LBitmapFont
     LBitmapFont(void);
 
     // Generates the font
-    bool buildFont( LTexture* );
+    bool buildFont( LTexture*, const std::string& );
 
     // Shows the text
     void renderText( int x, int y, const std::string& );
 
     private:
+    // Adds a character to the geometry of the text
+    void addGlyph( const SDL_Rect&, int, int );
+
     // The font texture
     LTexture* mBitmap;
 
-    // The individual characters in the surface
-    SDL_Rect mChars[ 256 ];
+    // The individual characters in the surface, and the spacing
+    LGlyphMetrics mMetrics;
 
-    // Spacing Variables
-    int mNewLine, mSpace;
+    // Geometry of the text being rendered
+    std::vector<SDL_Vertex> mVertices;
+    std::vector<int>        mIndices;
 };
 
 
@@ -398,6 +413,12 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 }
 
 
+SDL_Texture* LTexture::getTexture(void) const
+{
+  return mTexture;
+}
+
+
 int LTexture::getWidth(void) const
 {
   return mWidth;
@@ -496,21 +517,31 @@ Uint32 LTexture::getPixel32( unsigned int x, unsigned int y )
 
 
 LBitmapFont::LBitmapFont(void)
-  : mBitmap(NULL), mNewLine(0), mSpace(0)
-{;}
+  : mBitmap(NULL), mMetrics()
+{
+  // Room for a few lines of text
+  mVertices.reserve( 4 * 256 );
+  mIndices.reserve ( 6 * 256 );
+}
 
 
 /**
  * @brief Generate a font from a bitmap texture.
  *
  * @param bitmap Source bitmap texture
+ * @param metricsPath Glyph metrics baked offline with "BakeTextures --glyphs"
  **/
-bool LBitmapFont::buildFont( LTexture* bitmap )
+bool LBitmapFont::buildFont( LTexture* bitmap, const std::string& metricsPath )
 {
   bool success = true;
 
+  // Baked metrics: no pixel has to be read
+  if( LoadGlyphMetrics( metricsPath, mMetrics ) )
+  {
+    printf( "\nOK: glyph metrics loaded from \"%s\"", metricsPath.c_str() );
+  }
   // Lock pixels for access
-  if( !bitmap->lockTexture() )
+  else if( !bitmap->lockTexture() )
   {
     printf( "\nUnable to lock bitmap font texture!" );
     success = false;
@@ -519,169 +550,51 @@ bool LBitmapFont::buildFont( LTexture* bitmap )
   {
     printf( "\nOK: bitmap font texture locked" );
 
-    // Set the background color
-    Uint32 bgColor = bitmap->getPixel32( 0, 0 ); // Il pixel in posizione (0, 0) è di colore ciano
-
-    // Set the cell dimensions
-    int cellW = bitmap->getWidth()  / GLYPHS_PER_ROW;
-    int cellH = bitmap->getHeight() / GLYPHS_PER_COL;
-
-    // New line variables
-    int top   = cellH;
-    int baseA = cellH;
+    // Il pixel in posizione (0, 0), di colore ciano, è lo sfondo
+    success = ComputeGlyphMetrics( static_cast<const Uint32*>( bitmap->getPixels() ), bitmap->getPitch(),
+                                   bitmap->getWidth(), bitmap->getHeight(), mMetrics );
 
-    // The current character we're setting
-    int currentChar = 0;
-
-    // Go through the cell rows
-    for( int rows = 0; rows != GLYPHS_PER_ROW; ++rows )
-    {
-      // Go through the cell columns
-      for( int cols = 0; cols != GLYPHS_PER_COL; ++cols )
-      {
-        // Set the character initial offset
-        mChars[ currentChar ].x = cellW * cols;
-        mChars[ currentChar ].y = cellH * rows;
-
-        // Set the initial dimensions of the character
-        mChars[ currentChar ].w = cellW;
-        mChars[ currentChar ].h = cellH;
+    bitmap->unlockTexture();
+  }
 
-        /* Restringimento delle dimensioni del clip da utilizzare per ricavare dallo sprite sheet il
-        carattere attualmente analizzato ("currentChar") */
+  mBitmap = success ? bitmap : NULL;
 
-        // Find Left Side
-        // Go through pixel columns. ATTENZIONE: l'ordine di ricerca qui utilizzato (prima cols e
-        // poi rows) è rovesciato rispetto al consueto (prima rows e poi cols)
-        for( int pCol = 0; pCol < cellW; ++pCol )
-        {
-          // Go through pixel rows
-          for( int pRow = 0; pRow < cellH; ++pRow )
-          {
-            // Get the pixel offsets
-            int pX = ( cellW * cols ) + pCol;
-            int pY = ( cellH * rows ) + pRow;
-
-            // If a non colorkey pixel is found
-            if( bitmap->getPixel32( pX, pY ) != bgColor )
-            {
-              // Set the x offset
-              mChars[ currentChar ].x = pX;
-
-              // Break the loops
-              pCol = cellW;
-              pRow = cellH;
-            }
-            else { /* Colorkey pixel found */ }
-          }
-        }
-
-        // Find Right Side
-        // Go through pixel columns
-        for( int pColW = cellW - 1; pColW >= 0; --pColW )
-        {
-          // Go through pixel rows
-          for( int pRowW = 0; pRowW < cellH; ++pRowW )
-          {
-            // Get the pixel offsets
-            int pX = ( cellW * cols ) + pColW;
-            int pY = ( cellH * rows ) + pRowW;
-
-            // If a non colorkey pixel is found
-            if( bitmap->getPixel32( pX, pY ) != bgColor )
-            {
-              // Set the width
-              mChars[ currentChar ].w = ( pX - mChars[ currentChar ].x ) + 1;
-
-              // Break the loops
-              pColW = -1;
-              pRowW = cellH;
-            }
-            else { /* Colorkey pixel found */ }
-          }
-        }
+  return success;
+}
 
-        // Find Top
-        // Go through pixel rows
-        for( int pRow = 0; pRow < cellH; ++pRow )
-        {
-          // Go through pixel columns
-          for( int pCol = 0; pCol < cellW; ++pCol )
-          {
-            // Get the pixel offsets
-            int pX = ( cellW * cols ) + pCol;
-            int pY = ( cellH * rows ) + pRow;
-
-            // If a non colorkey pixel is found
-            if( bitmap->getPixel32( pX, pY ) != bgColor )
-            {
-              // If new top is found
-              if( pRow < top )
-              {
-                top = pRow;
-              }
-
-              // Break the loops
-              pCol = cellW;
-              pRow = cellH;
-            }
-            else { /* Colorkey pixel found */ }
-          }
-        }
 
-        // Find Bottom of 'A'. Serve per definire la baseline dei caratteri
-        if( currentChar == 'A' )
-        {
-          // Go through pixel rows
-          for( int pRow = cellH - 1; pRow >= 0; --pRow )
-          {
-            // Go through pixel columns
-            for( int pCol = 0; pCol < cellW; ++pCol )
-            {
-              // Get the pixel offsets
-              int pX = ( cellW * cols ) + pCol;
-              int pY = ( cellH * rows ) + pRow;
-
-              // If a non colorkey pixel is found
-              if( bitmap->getPixel32( pX, pY ) != bgColor )
-              {
-                // Bottom of a is found
-                baseA = pRow;
-
-                // Break the loops
-                pCol = cellW;
-                pRow = -1;
-              }
-              else { /* Colorkey pixel found */ }
-            }
-          }
-        }
+/**
+ * @brief Queues a textured quad for a glyph, two triangles sharing the diagonal.
+ **/
+void LBitmapFont::addGlyph( const SDL_Rect& clip, int x, int y )
+{
+  const float texW = static_cast<float>( mBitmap->getWidth() );
+  const float texH = static_cast<float>( mBitmap->getHeight() );
 
-        // Go to the next character
-        ++currentChar;
-      }
-    }
+  const float left   = static_cast<float>( x );
+  const float top    = static_cast<float>( y );
+  const float right  = static_cast<float>( x + clip.w );
+  const float bottom = static_cast<float>( y + clip.h );
 
-    /* Defining space & new line + post-processing */
+  const float u0 = static_cast<float>( clip.x )          / texW;
+  const float v0 = static_cast<float>( clip.y )          / texH;
+  const float u1 = static_cast<float>( clip.x + clip.w ) / texW;
+  const float v1 = static_cast<float>( clip.y + clip.h ) / texH;
 
-    // Calculate space
-    mSpace = cellW / 2;
+  const SDL_Color white = { WHITE_R, WHITE_G, WHITE_B, WHITE_A };
+  const int       first = static_cast<int>( mVertices.size() );
 
-    // Calculate new line
-    mNewLine = baseA - top;
+  mVertices.push_back( { { left , top    }, white, { u0, v0 } } );
+  mVertices.push_back( { { right, top    }, white, { u1, v0 } } );
+  mVertices.push_back( { { right, bottom }, white, { u1, v1 } } );
+  mVertices.push_back( { { left , bottom }, white, { u0, v1 } } );
 
-    // Lop off excess top pixels
-    for( int i = 0; i != 256; ++i )
-    {
-      mChars[ i ].y += top;
-      mChars[ i ].h -= top;
-    }
+  const int corners[] = { 0, 1, 2, 0, 2, 3 };
 
-    bitmap->unlockTexture();
-    mBitmap = bitmap;
+  for( int corner : corners )
+  {
+    mIndices.push_back( first + corner );
   }
-
-  return success;
 }
 
 
@@ -693,6 +606,10 @@ void LBitmapFont::renderText( int x, int y, const std::string& text )
     // Temp offsets
     int curX = x, curY = y;
 
+    // The buffers keep their capacity: once grown to the longest text, nothing is allocated
+    mVertices.clear();
+    mIndices.clear();
+
     // Go through the text
     for( size_t i = 0; i != text.length(); ++i )
     {
@@ -700,13 +617,13 @@ void LBitmapFont::renderText( int x, int y, const std::string& text )
       if( text[ i ] == ' ' )
       {
         // Move over
-        curX += mSpace;
+        curX += mMetrics.Space;
       }
       // If the current character is a newline
       else if( text[ i ] == '\n' )
       {
         // Move down
-        curY += mNewLine;
+        curY += mMetrics.NewLine;
 
         // Move back
         curX = x;
@@ -714,15 +631,24 @@ void LBitmapFont::renderText( int x, int y, const std::string& text )
       else
       {
         // Get the ASCII value of the character
-        int ascii = (unsigned char)text[ i ];
+        const SDL_Rect& clip = mMetrics.Glyphs[ (unsigned char)text[ i ] ];
 
-        // Show the character
-        mBitmap->render( curX, curY, &mChars[ ascii ] );
+        // Queue the character
+        addGlyph( clip, curX, curY );
 
         // Move over the width of the character with padding
-        curX += mChars[ ascii ].w + PADDING_px;
+        curX += clip.w + PADDING_px;
       }
     }
+
+    // All the characters in a single draw call
+    if( !mIndices.empty() )
+    {
+      SDL_RenderGeometry( gRenderer, mBitmap->getTexture(),
+                          mVertices.data(), static_cast<int>( mVertices.size() ),
+                          mIndices.data() , static_cast<int>( mIndices.size() ) );
+    }
+    else { /* Nothing to draw */ }
   }
 }
 
@@ -839,7 +765,7 @@ static bool loadMedia( void )
     printf( "\nOK: corner texture loaded" );
 
     // Build font from texture
-    gBitmapFont.buildFont( &gBitmapTexture );
+    gBitmapFont.buildFont( &gBitmapTexture, g_LazyFontPath + LBAKED_GLYPHS_EXTENSION );
   }
 
   return success;
@@ -31,6 +31,22 @@
  * to another, but ultimately all we need is a means to get the pixel data and copy it to the
  * screen.
  *
+ * Aggiunta GS: lo stream non è più copiato nella texture dal thread principale, con lock, "memcpy" e
+ * unlock a ogni frame, ma da un thread produttore in un "LStreamingTexture" di Engine_Lib: una
+ * texture streaming con due buffer di appoggio in memoria di sistema. Il produttore scrive il frame
+ * successivo in un buffer libero ("beginWrite" / "endWrite"), mentre il ciclo principale carica
+ * nella texture quelli già pronti con "SDL_UpdateTexture" ("upload") e disegna: la copia non blocca
+ * più il frame. "endWrite" accetta anche il rettangolo cambiato, e allora si carica solo quello.
+ * La classe LTexture, con "createBlank", "lockTexture" e "copyPixels", resta come nel tutorial
+ * originale, ma non è più usata per lo stream.
+ *
+ * Aggiunta GS: "DataStream::getBuffer" è sostituito da "DataStream::writeFrame", che scrive il
+ * frame corrente direttamente nella memoria indicata dal chiamante (con il suo pitch e il suo
+ * formato): il buffer di appoggio della texture, oppure i pixel della texture stessa bloccata con
+ * "LStreamingTexture::lockTexture", come per il primo frame. I frame sono tenuti nel formato in cui
+ * li ha decodificati SDL_image, e la conversione in RGBA8888 avviene durante la scrittura: niente
+ * più copie convertite in memoria, e una copia in meno per frame.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -46,6 +62,8 @@
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include "LPixelOps.hpp"
+#include "LStreamingTexture.hpp"
 
 
 /**************************************************************************************************
@@ -75,6 +93,8 @@ static constexpr int NUM_OF_FRAMES = 4; // I quattro "foo_walk"
 
 static constexpr int BYTES_PER_PIXEL = 4;
 
+static constexpr Uint32 STREAM_FRAME_MS = 1000 / 60; // The stream's frame period
+
 
 /***************************************************************************************************
 * Classes
@@ -156,8 +176,8 @@ class DataStream
   // Deallocator
   void free(void);
 
-  // Gets current frame data
-  void* getBuffer(void);
+  // Writes the current frame into pixels of the given pitch and format
+  bool writeFrame( void*, int, Uint32 = SDL_PIXELFORMAT_RGBA8888 );
 
   int GetWidth (void) const;
   int GetHeigth(void) const;
@@ -178,6 +198,9 @@ static bool init      (void);
 static bool loadMedia (void);
 static void close     (void);
 
+// The thread writing the stream into the texture
+static int streamProducer( void* );
+
 
 /***************************************************************************************************
 * Private global variables
@@ -187,11 +210,14 @@ static SDL_Window*   gWindow   = NULL; // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 // Scene textures
-static LTexture gStreamingTexture;
+static LStreamingTexture gStreamingTexture;
 
 // Animation stream
 static DataStream gDataStream;
 
+// Tells the producer thread to stop
+static SDL_atomic_t gQuitStream{ 0 };
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -273,15 +299,8 @@ bool LTexture::loadFromFile( const std::string& path )
         Uint32 colorKey    = SDL_MapRGB ( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B );
         Uint32 transparent = SDL_MapRGBA( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B, TRANSPARENCY );
 
-        // Color key pixels
-        for( int i = 0; i != pixelCount; ++i )
-        {
-          if( pixels[ i ] == colorKey )
-          {
-            pixels[ i ] = transparent;
-          }
-          else { /* Skip this pixel */ }
-        }
+        // Color key pixels, with the SIMD kernels of LPixelOps
+        ApplyColourKey( pixels, static_cast<size_t>( pixelCount ), colorKey, transparent );
 
         // Unlock texture to update
         SDL_UnlockTexture( newTexture );
@@ -574,12 +593,17 @@ bool DataStream::loadMedia(void)
       printf( "\nUnable to load \"%s\"! SDL_image error: \"%s\"", path.str().c_str(), IMG_GetError() );
       success = false;
     }
-    else
+    else if( SDL_ISPIXELFORMAT_INDEXED( loadedSurface->format->format ) )
     {
+      // SDL_ConvertPixels cannot read palettes: these are converted once here
       mImages[ i ] = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_RGBA8888, 0 );
+      SDL_FreeSurface( loadedSurface );
+    }
+    else
+    {
+      // Kept as decoded: "writeFrame" converts while writing
+      mImages[ i ] = loadedSurface;
     }
-
-    SDL_FreeSurface( loadedSurface );
   }
 
   return success;
@@ -596,7 +620,16 @@ void DataStream::free(void)
 }
 
 
-void* DataStream::getBuffer(void)
+/**
+ * @brief GS: moves to the next frame of the animation and writes it straight into the caller's
+ * memory, converting its format on the way: no intermediate buffer to copy from.
+ *
+ * @param pixels Destination, as big as a frame.
+ * @param pitch  Bytes per row of the destination.
+ * @param format Pixel format of the destination.
+ * @return false if the frame could not be written
+ **/
+bool DataStream::writeFrame( void* pixels, int pitch, Uint32 format )
 {
   --mDelayFrames;
 
@@ -613,7 +646,10 @@ void* DataStream::getBuffer(void)
   }
   else { /*  */ }
 
-  return mImages[ mCurrentImage ]->pixels;
+  const SDL_Surface* Frame = mImages[ mCurrentImage ];
+
+  return SDL_ConvertPixels( Frame->w, Frame->h, Frame->format->format, Frame->pixels, Frame->pitch,
+                            format, pixels, pitch ) == 0;
 }
 
 
@@ -758,7 +794,7 @@ static bool loadMedia( void )
   // printf( "\nWidth: %i; Heigth: %i", gDataStream.GetWidth(), gDataStream.GetHeigth() ); // GS: debugging
 
   // Load blank texture
-  if( !gStreamingTexture.createBlank( gDataStream.GetWidth(), gDataStream.GetHeigth() ) )
+  if( !gStreamingTexture.create( gRenderer, gDataStream.GetWidth(), gDataStream.GetHeigth() ) )
   {
     printf( "\nFailed to create streaming texture!" );
     success = false;
@@ -790,6 +826,41 @@ static void close(void)
 }
 
 
+/**
+ * @brief Producer thread: writes a frame of the stream into a free staging buffer of the texture
+ * every STREAM_FRAME_MS, waiting when the renderer has not uploaded the previous ones yet.
+ **/
+static int streamProducer( [[maybe_unused]] void* data )
+{
+  while( SDL_AtomicGet( &gQuitStream ) == 0 )
+  {
+    int   Pitch      = 0;
+    void* Pixels_Ptr = gStreamingTexture.beginWrite( Pitch );
+
+    if( Pixels_Ptr == NULL )
+    {
+      // Every buffer is waiting for upload
+      SDL_Delay(1);
+      continue;
+    }
+    else { /* A buffer is free */ }
+
+    // The frame is written straight into the staging buffer
+    if( !gDataStream.writeFrame( Pixels_Ptr, Pitch ) )
+    {
+      printf( "\nUnable to write a frame! SDL Error: \"%s\"", SDL_GetError() );
+    }
+    else { /* Frame written */ }
+
+    gStreamingTexture.endWrite();
+
+    SDL_Delay( STREAM_FRAME_MS );
+  }
+
+  return 0;
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -841,6 +912,28 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // First frame, written straight into the texture before the producer starts
+      int   Pitch      = 0;
+      void* Pixels_Ptr = gStreamingTexture.lockTexture( Pitch );
+
+      if( Pixels_Ptr != NULL )
+      {
+        gDataStream.writeFrame( Pixels_Ptr, Pitch );
+        gStreamingTexture.unlockTexture();
+      }
+      else { /* Blank until the producer's first frame */ }
+
+      // Start streaming
+      SDL_Thread* ProducerThread = SDL_CreateThread( streamProducer, "Stream producer", NULL );
+
+      if( ProducerThread == NULL )
+      {
+        printf( "\nUnable to create the producer thread! SDL Error: \"%s\"", SDL_GetError() );
+        HasProgramSucceeded = false;
+        quit                = true;
+      }
+      else { /* Streaming */ }
+
       // While application is running
       while( !quit )
       {
@@ -859,17 +952,23 @@ int main( int argc, char* args[] )
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear       ( gRenderer );
 
-        // Copy frame from buffer
-        gStreamingTexture.lockTexture();
-        gStreamingTexture.copyPixels( gDataStream.getBuffer() );
-        gStreamingTexture.unlockTexture();
+        // Upload the frames the producer has written since the last loop
+        gStreamingTexture.upload();
 
         // Render frame
-        gStreamingTexture.render( ( WINDOW_W - gStreamingTexture.getWidth() ) / 2, ( WINDOW_H - gStreamingTexture.getHeight() ) / 2 );
+        gStreamingTexture.render( ( WINDOW_W - gStreamingTexture.GetWidth() ) / 2, ( WINDOW_H - gStreamingTexture.GetHeight() ) / 2 );
 
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
+
+      // Stop streaming before the texture is freed
+      if( ProducerThread != NULL )
+      {
+        SDL_AtomicSet( &gQuitStream, 1 );
+        SDL_WaitThread( ProducerThread, NULL );
+      }
+      else { /* Never started */ }
     }
   }
 
@@ -5,6 +5,20 @@
  * @brief For some effects, being able to render a scene to texture is needed. Here we'll be
  * rendering a scene to a texture to achieve a spinning scene effect.
  *
+ * Aggiunta GS: la scena non è più ridisegnata nella texture a ogni frame. È un "LCachedLayer" di
+ * Engine_Lib/LRenderTargets, disegnato in una texture target presa da un "LRenderTargetPool" (che
+ * riusa le texture per dimensioni e formato) solo quando viene invalidato: all'avvio, premendo la
+ * barra spaziatrice (cambia il colore del quadrato) o su SDL_RENDER_TARGETS_RESET. Ruotare la scena
+ * costa così una sola copia per frame.
+ *
+ * Aggiunta GS: con "--thumbnails=<lista>" il programma non apre alcuna finestra e genera le anteprime
+ * delle mappe elencate nella lista (una per riga, mappe di testo come "lazy.map" o binarie come
+ * "lazy.tmap" di 39_tiling), ognuna disegnata in una texture target delle dimensioni richieste
+ * ("--size=<L>x<A>", o "<mappa> <L>x<A>" nella riga) e salvata in PNG nella cartella "--out=<dir>".
+ * Le disegna un gruppo di contesti fuori schermo (renderer software, "--workers=<N>", di default uno
+ * per core), ciascuno sul proprio thread, che si dividono la lista e scrivono i file in parallelo:
+ * non serve un display, come sui server di build.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -18,8 +32,12 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <string>
 #include "../../Colours_Lib/colours.hpp"
+#include "LRenderTargets.hpp"
+#include "Thumbnails.hpp"
 
 
 /**************************************************************************************************
@@ -35,6 +53,10 @@ static constexpr int TRANSPARENCY = 0x00;
 
 static constexpr int BYTES_PER_PIXEL = 4;
 
+// Previews of "--thumbnails", unless set otherwise
+static constexpr int THUMBNAIL_W = 320;
+static constexpr int THUMBNAIL_H = 240;
+
 
 /***************************************************************************************************
 * Classes
@@ -111,6 +133,8 @@ private:
 static bool init      (void);
 static bool loadMedia (void);
 static void close     (void);
+static bool runThumbnails( const char*, const ThumbnailSettings& );
+static void drawScene ( SDL_Renderer*, void* );
 
 
 /***************************************************************************************************
@@ -120,8 +144,12 @@ static void close     (void);
 static SDL_Window*   gWindow   = NULL; // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL; // The window renderer
 
-// Scene textures
-static LTexture gTargetTexture;
+// Render targets, and the scene cached in one of them
+static LRenderTargetPool gTargets;
+static LCachedLayer      gSceneLayer;
+
+// Colour of the filled quad: changing it invalidates the scene
+static bool gBlueQuad = false;
 
 
 /***************************************************************************************************
@@ -566,6 +594,50 @@ static bool init(void)
 }
 
 
+/**
+ * @brief Draws the scene into the target of its cached layer. It runs only when the layer was
+ * invalidated, not every frame.
+ *
+ * @param renderer The renderer, whose target is the layer's.
+ **/
+static void drawScene( SDL_Renderer* renderer, void* )
+{
+  // Clear the layer
+  SDL_SetRenderDrawColor( renderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
+  SDL_RenderClear( renderer );
+
+  // Render red (or blue) filled quad
+  SDL_Rect fillRect = { WINDOW_W / 4, WINDOW_H / 4, WINDOW_W / 2, WINDOW_H / 2 };
+
+  if( gBlueQuad )
+  {
+    SDL_SetRenderDrawColor( renderer, BLUE_R, BLUE_G, BLUE_B, ALPHA_MAX );
+  }
+  else
+  {
+    SDL_SetRenderDrawColor( renderer, RED_R, RED_G, RED_B, ALPHA_MAX );
+  }
+
+  SDL_RenderFillRect( renderer, &fillRect );
+
+  // Render green outlined quad
+  SDL_Rect outlineRect = { WINDOW_W / 6, WINDOW_H / 6, WINDOW_W * 2 / 3, WINDOW_H * 2 / 3 };
+  SDL_SetRenderDrawColor( renderer, GREEN_R, GREEN_G, GREEN_B, ALPHA_MAX );
+  SDL_RenderDrawRect( renderer, &outlineRect );
+
+  // Draw blue horizontal line
+  SDL_SetRenderDrawColor( renderer, BLUE_R, BLUE_G, BLUE_B, ALPHA_MAX );
+  SDL_RenderDrawLine( renderer, 0, WINDOW_H / 2, WINDOW_W, WINDOW_H / 2 );
+
+  // Draw vertical line of yellow dots
+  SDL_SetRenderDrawColor( renderer, YELLOW_R, YELLOW_G, YELLOW_B, ALPHA_MAX );
+  for( int i = 0; i < WINDOW_H; i += 4 )
+  {
+    SDL_RenderDrawPoint( renderer, WINDOW_W / 2, i );
+  }
+}
+
+
 /**
  * @brief Loads all necessary media for this project.
  *
@@ -576,8 +648,10 @@ static bool loadMedia( void )
 	// Loading success flag
 	bool success = true;
 
-	// Load texture target
-	if( !gTargetTexture.createBlank( WINDOW_W, WINDOW_H, SDL_TEXTUREACCESS_TARGET ) )
+	// Take the target of the scene layer from the pool
+	gTargets.setRenderer( gRenderer );
+
+	if( !gSceneLayer.create( gTargets, WINDOW_W, WINDOW_H, drawScene, NULL ) )
 	{
 		printf( "\nFailed to create target texture!" );
 		success = false;
@@ -593,8 +667,10 @@ static bool loadMedia( void )
 
 static void close(void)
 {
-	// Free loaded images
-	gTargetTexture.free();
+	// Give the layer's target back, and destroy the targets of the pool
+	printf( "\nThe scene was drawn %d times", gSceneLayer.GetDrawCount() );
+	gSceneLayer.free();
+	gTargets.clear();
 
 	// Destroy window
 	SDL_DestroyRenderer( gRenderer );
@@ -608,6 +684,40 @@ static void close(void)
 }
 
 
+/**
+ * @brief Headless mode: starts SDL without video, as the contexts draw in software with no window,
+ * and renders the previews of the maps listed.
+ *
+ * @return true if every preview was written.
+ **/
+static bool runThumbnails( const char* listPath, const ThumbnailSettings& settings )
+{
+	bool success = false;
+
+	if( SDL_Init( 0 ) < 0 )
+	{
+    printf( "\nSDL could not initialize! SDL Error: \"%s\"\n", SDL_GetError() );
+	}
+	else if( !( IMG_Init( IMG_INIT_PNG ) & IMG_INIT_PNG ) )
+	{
+    printf( "\nSDL_image could not initialise! SDL_image Error: %s", IMG_GetError() );
+    SDL_Quit();
+	}
+	else
+	{
+    // Previews are scaled down: filter them
+    SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "1" );
+
+    success = renderThumbnails( listPath, settings );
+
+    IMG_Quit();
+    SDL_Quit();
+	}
+
+	return success;
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -630,11 +740,53 @@ int main( int argc, char* args[] )
   printf("\n*** Debugging console ***\n");
   printf("\nProgram started with %d additional arguments.", argc - 1); // Il primo argomento è il nome dell'eseguibile
 
+  // "--thumbnails=<file>" renders the previews of the maps listed, without window
+  const char*       thumbnailList = NULL;
+  ThumbnailSettings thumbnails{ THUMBNAIL_W, THUMBNAIL_H, 0, "tiles.png", "." };
+
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    if ( strncmp( args[i], "--thumbnails=", strlen("--thumbnails=") ) == 0 )
+    {
+      thumbnailList = args[i] + strlen("--thumbnails=");
+    }
+    else if ( strncmp( args[i], "--size=", strlen("--size=") ) == 0 )
+    {
+      if ( sscanf( args[i] + strlen("--size="), "%dx%d", &thumbnails.Width, &thumbnails.Height ) != 2 )
+      {
+        printf( "\nInvalid size \"%s\", expected <width>x<height>", args[i] + strlen("--size=") );
+        HasProgramSucceeded = false;
+      }
+      else {;}
+    }
+    else if ( strncmp( args[i], "--workers=", strlen("--workers=") ) == 0 )
+    {
+      thumbnails.NumOfWorkers = atoi( args[i] + strlen("--workers=") );
+    }
+    else if ( strncmp( args[i], "--tiles=", strlen("--tiles=") ) == 0 )
+    {
+      thumbnails.TilesPath = args[i] + strlen("--tiles=");
+    }
+    else if ( strncmp( args[i], "--out=", strlen("--out=") ) == 0 )
+    {
+      thumbnails.OutDir = args[i] + strlen("--out=");
+    }
+    else {;}
   }
 
+  // Headless: no window, and nobody to press ENTER
+  if( thumbnailList != NULL )
+  {
+    HasProgramSucceeded = HasProgramSucceeded && runThumbnails( thumbnailList, thumbnails );
+
+    printf( HasProgramSucceeded ? "\nProgram ended successfully!\n" : "\nThere was a problem during the execution of the program!\n" );
+
+    return HasProgramSucceeded ? 0 : 1;
+  }
+  else {;}
+
   // Start up SDL and create window
 	if( !init() )
 	{
@@ -674,6 +826,17 @@ int main( int argc, char* args[] )
 					{
 						quit = true;
 					}
+          // Space changes the colour of the quad: the scene is drawn again, once
+          else if( e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_SPACE )
+          {
+            gBlueQuad = !gBlueQuad;
+            gSceneLayer.invalidate();
+          }
+          // Some renderers lose the contents of their targets
+          else if( e.type == SDL_RENDER_TARGETS_RESET )
+          {
+            gSceneLayer.invalidate();
+          }
           else { /* Event not managed here */ }
 				}
 
@@ -686,39 +849,8 @@ int main( int argc, char* args[] )
 				}
 				else { /* Proceed */ }
 
-				// Set self as render target
-				gTargetTexture.setAsRenderTarget();
-
-				// Clear screen
-				SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
-				SDL_RenderClear( gRenderer );
-
-				// Render red filled quad
-				SDL_Rect fillRect = { WINDOW_W / 4, WINDOW_H / 4, WINDOW_W / 2, WINDOW_H / 2 };
-				SDL_SetRenderDrawColor( gRenderer, RED_R, RED_G, RED_B, ALPHA_MAX );
-				SDL_RenderFillRect( gRenderer, &fillRect );
-
-				// Render green outlined quad
-				SDL_Rect outlineRect = { WINDOW_W / 6, WINDOW_H / 6, WINDOW_W * 2 / 3, WINDOW_H * 2 / 3 };
-				SDL_SetRenderDrawColor( gRenderer, GREEN_R, GREEN_G, GREEN_B, ALPHA_MAX );
-				SDL_RenderDrawRect( gRenderer, &outlineRect );
-
-				// Draw blue horizontal line
-				SDL_SetRenderDrawColor( gRenderer, BLUE_R, BLUE_G, BLUE_B, ALPHA_MAX );
-				SDL_RenderDrawLine( gRenderer, 0, WINDOW_H / 2, WINDOW_W, WINDOW_H / 2 );
-
-				// Draw vertical line of yellow dots
-				SDL_SetRenderDrawColor( gRenderer, YELLOW_R, YELLOW_G, YELLOW_B, ALPHA_MAX );
-				for( int i = 0; i < WINDOW_H; i += 4 )
-				{
-					SDL_RenderDrawPoint( gRenderer, WINDOW_W / 2, i );
-				}
-
-				// Reset render target
-				SDL_SetRenderTarget( gRenderer, NULL );
-
-				// Show rendered to texture
-				gTargetTexture.render( 0, 0, NULL, angle, &screenCenter );
+				// Show the scene, rotated: a single copy, unless it was invalidated since the last frame
+				gSceneLayer.render( 0, 0, angle, &screenCenter );
 
 				// Update screen
 				SDL_RenderPresent( gRenderer );
@@ -0,0 +1,708 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "Thumbnails.hpp"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../../Colours_Lib/colours.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// The tiles of 39_tiling: TOTAL_TILE_SPRITES sprites of TILE_W x TILE_H in "tiles.png"
+static constexpr int TILE_W             = 80;
+static constexpr int TILE_H             = 80;
+static constexpr int TOTAL_TILE_SPRITES = 12;
+
+// Column and row of each tile type in the sprite sheet, in the order of 39_tiling's types: red,
+// green, blue, centre, top, top right, right, bottom right, bottom, bottom left, left, top left
+static constexpr int TILE_SPRITE_COL[ TOTAL_TILE_SPRITES ] = { 0, 0, 0, 2, 2, 3, 3, 3, 2, 1, 1, 1 };
+static constexpr int TILE_SPRITE_ROW[ TOTAL_TILE_SPRITES ] = { 0, 1, 2, 1, 0, 0, 1, 2, 2, 2, 1, 0 };
+
+// Binary maps, as saved by 39_tiling
+static constexpr char   TILE_MAP_MAGIC[ 4 ]  = { 'L', 'T', 'M', 'P' };
+static constexpr Uint32 TILE_MAP_VERSION     = 1;
+static constexpr size_t TILE_MAP_HEADER_SIZE = 24;     // Magic, version, width, height, chunk width and height
+static constexpr Uint32 MAX_MAP_SIDE         = 0x8000; // In tiles
+
+static constexpr Uint32 PREVIEW_FORMAT = SDL_PIXELFORMAT_ARGB8888;
+static constexpr int    MAX_PREVIEW_px = 8192;         // Per side
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+/**
+ * @brief A map to preview, and where and how large.
+ **/
+struct ThumbnailJob
+{
+  std::string MapPath;
+  std::string OutPath;
+  int         Width;
+  int         Height;
+};
+
+
+/**
+ * @brief Shared by the workers: each takes the next job of the list until none is left.
+ **/
+struct ThumbnailQueue
+{
+  const std::vector<ThumbnailJob>* Jobs_Ptr;
+  const std::string*               TilesPath_Ptr;
+  SDL_atomic_t                     Next;
+  SDL_atomic_t                     Written;
+};
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static bool readFile( const std::string& Path, std::vector<Uint8>& Bytes )
+{
+  SDL_RWops* File_Ptr = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( File_Ptr == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Sint64 Size = SDL_RWsize( File_Ptr );
+  bool         IsRead = ( Size >= 0 );
+
+  if ( IsRead )
+  {
+    Bytes.resize( static_cast<size_t>( Size ) );
+    IsRead = ( Size == 0 || SDL_RWread( File_Ptr, Bytes.data(), Bytes.size(), 1 ) == 1 );
+  }
+  else
+  {;}
+
+  SDL_RWclose( File_Ptr );
+
+  return IsRead;
+}
+
+
+/**
+ * @brief The PNG of a map: its path with the directory separators and dots turned into '_', e.g.
+ * "maps/a/lazy.tmap" into "maps_a_lazy_tmap.png", so that maps of the same name in different
+ * directories, or in both formats, do not overwrite each other.
+ **/
+static std::string getOutPath( const std::string& OutDir, const std::string& MapPath )
+{
+  std::string Name( MapPath );
+
+  while ( !Name.empty() && ( Name[0] == '.' || Name[0] == '/' || Name[0] == '\\' ) )
+  {
+    Name.erase( 0, 1 );
+  }
+
+  std::replace( Name.begin(), Name.end(), '/' , '_' );
+  std::replace( Name.begin(), Name.end(), '\\', '_' );
+  std::replace( Name.begin(), Name.end(), ':' , '_' );
+  std::replace( Name.begin(), Name.end(), '.' , '_' );
+
+  return OutDir.empty() ? Name + ".png" : OutDir + "/" + Name + ".png";
+}
+
+
+/**
+ * @brief Reads the list of maps: one per line, optionally followed by the size of its preview, e.g.
+ * "maps/level1.map 640x480". Empty lines and lines starting with '#' are skipped.
+ **/
+static bool loadJobs( const std::string& ListPath, const ThumbnailSettings& Settings, std::vector<ThumbnailJob>& Jobs )
+{
+  std::vector<Uint8> Bytes;
+
+  if ( !readFile( ListPath, Bytes ) )
+  {
+    printf( "\nUnable to read the list of maps \"%s\"!", ListPath.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  const std::string Text( Bytes.begin(), Bytes.end() );
+  size_t            Start = 0;
+
+  while ( Start < Text.size() )
+  {
+    size_t End = Text.find( '\n', Start );
+
+    if ( End == std::string::npos )
+    {
+      End = Text.size();
+    }
+    else
+    {;}
+
+    std::string Line = Text.substr( Start, End - Start );
+    Start = End + 1;
+
+    while ( !Line.empty() && ( Line.back() == '\r' || Line.back() == ' ' || Line.back() == '\t' ) )
+    {
+      Line.pop_back();
+    }
+
+    if ( Line.empty() || Line[0] == '#' )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    ThumbnailJob Job{ Line, std::string(), Settings.Width, Settings.Height };
+
+    const size_t Space = Line.find_last_of( " \t" );
+    int          W     = 0;
+    int          H     = 0;
+
+    if ( Space != std::string::npos && sscanf( Line.c_str() + Space + 1, "%dx%d", &W, &H ) == 2 )
+    {
+      Job.MapPath = Line.substr( 0, Line.find_last_not_of( " \t", Space ) + 1 );
+      Job.Width   = W;
+      Job.Height  = H;
+    }
+    else
+    {;}
+
+    if ( Job.Width <= 0 || Job.Height <= 0 || Job.Width > MAX_PREVIEW_px || Job.Height > MAX_PREVIEW_px )
+    {
+      printf( "\nInvalid preview size %dx%d for \"%s\", skipped!", Job.Width, Job.Height, Job.MapPath.c_str() );
+      continue;
+    }
+    else
+    {;}
+
+    Job.OutPath = getOutPath( Settings.OutDir, Job.MapPath );
+    Jobs.push_back( Job );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Body of a worker: creates its own context, then previews the maps of the queue one after
+ * the other. A worker whose context cannot be created leaves the jobs to the others.
+ **/
+static int thumbnailWorker( void* Data )
+{
+  ThumbnailQueue&                  Queue = *static_cast<ThumbnailQueue*>( Data );
+  const std::vector<ThumbnailJob>& Jobs  = *Queue.Jobs_Ptr;
+
+  ThumbnailContext Context;
+
+  if ( !Context.create( *Queue.TilesPath_Ptr ) )
+  {
+    return 1;
+  }
+  else
+  {;}
+
+  PreviewMap Map;
+
+  for ( size_t i = static_cast<size_t>( SDL_AtomicAdd( &Queue.Next, 1 ) ); i < Jobs.size();
+        i = static_cast<size_t>( SDL_AtomicAdd( &Queue.Next, 1 ) ) )
+  {
+    const ThumbnailJob& Job = Jobs[i];
+
+    if ( Map.load( Job.MapPath ) && Context.render( Map, Job.Width, Job.Height, Job.OutPath ) )
+    {
+      SDL_AtomicAdd( &Queue.Written, 1 );
+    }
+    else
+    {;}
+  }
+
+  return 0;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+PreviewMap::PreviewMap( void )
+  : m_Types(), m_Width(0), m_Height(0)
+{;}
+
+
+/**
+ * @brief Loads a text or a binary map, telling them by the magic at the start of the binary ones.
+ *
+ * @return true if successful; false otherwise (the map is left empty)
+ **/
+bool PreviewMap::load( const std::string& Path )
+{
+  std::vector<Uint8> Bytes;
+
+  m_Types.clear();
+  m_Width  = 0;
+  m_Height = 0;
+
+  if ( !readFile( Path, Bytes ) )
+  {
+    printf( "\nUnable to read map \"%s\"!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  const bool IsBinary = ( Bytes.size() >= sizeof(TILE_MAP_MAGIC) && memcmp( Bytes.data(), TILE_MAP_MAGIC, sizeof(TILE_MAP_MAGIC) ) == 0 );
+  const bool IsLoaded = IsBinary ? LoadBinary_Pvt( Bytes ) : LoadText_Pvt( std::string( Bytes.begin(), Bytes.end() ) );
+
+  // Every type must have a sprite
+  const bool IsValid = IsLoaded && std::all_of( m_Types.begin(), m_Types.end(), []( Uint8 Type ) { return Type < TOTAL_TILE_SPRITES; } );
+
+  if ( !IsValid )
+  {
+    printf( "\n\"%s\" is not a valid tile map!", Path.c_str() );
+    m_Types.clear();
+    m_Width  = 0;
+    m_Height = 0;
+  }
+  else
+  {;}
+
+  return IsValid;
+}
+
+
+int PreviewMap::GetWidth( void ) const
+{
+  return m_Width;
+}
+
+
+int PreviewMap::GetHeight( void ) const
+{
+  return m_Height;
+}
+
+
+int PreviewMap::GetType( int Column, int Row ) const
+{
+  return m_Types[static_cast<size_t>( Row ) * static_cast<size_t>( m_Width ) + static_cast<size_t>( Column )];
+}
+
+
+/**
+ * @brief Whitespace separated tile types, row by row; the first line is the first row.
+ **/
+bool PreviewMap::LoadText_Pvt( const std::string& Text )
+{
+  const char* Next_Ptr     = Text.c_str();
+  const char* FirstEnd_Ptr = strchr( Next_Ptr, '\n' );
+
+  for ( ; ; )
+  {
+    char*      End_Ptr = NULL;
+    const long Type    = strtol( Next_Ptr, &End_Ptr, 10 );
+
+    if ( End_Ptr == Next_Ptr )
+    {
+      break;
+    }
+    else
+    {;}
+
+    if ( FirstEnd_Ptr == NULL || End_Ptr <= FirstEnd_Ptr )
+    {
+      ++m_Width;
+    }
+    else
+    {;}
+
+    m_Types.push_back( static_cast<Uint8>( ( Type >= 0 && Type < TOTAL_TILE_SPRITES ) ? Type : TOTAL_TILE_SPRITES ) );
+    Next_Ptr = End_Ptr;
+  }
+
+  if ( m_Width == 0 || m_Types.size() % static_cast<size_t>( m_Width ) != 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Height = static_cast<int>( m_Types.size() / static_cast<size_t>( m_Width ) );
+
+  return true;
+}
+
+
+/**
+ * @brief The header, then the tile types in chunks of ChunkW x ChunkH, chunks and the tiles in them
+ * row by row, the chunks on the right and bottom edges padded to full size (see 39_tiling).
+ **/
+bool PreviewMap::LoadBinary_Pvt( const std::vector<Uint8>& Bytes )
+{
+  Uint32 Header[ TILE_MAP_HEADER_SIZE / sizeof(Uint32) ];
+
+  if ( Bytes.size() < TILE_MAP_HEADER_SIZE )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  memcpy( Header, Bytes.data(), TILE_MAP_HEADER_SIZE );
+
+  const Uint32 Version = Header[1];
+  const Uint32 Width   = Header[2];
+  const Uint32 Height  = Header[3];
+  const Uint32 ChunkW  = Header[4];
+  const Uint32 ChunkH  = Header[5];
+
+  if ( Version != TILE_MAP_VERSION || Width == 0 || Height == 0 || ChunkW == 0 || ChunkH == 0 ||
+       Width > MAX_MAP_SIDE || Height > MAX_MAP_SIDE || ChunkW > MAX_MAP_SIDE || ChunkH > MAX_MAP_SIDE )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const size_t ChunksX   = ( Width  + ChunkW - 1 ) / ChunkW;
+  const size_t ChunksY   = ( Height + ChunkH - 1 ) / ChunkH;
+  const size_t ChunkSize = static_cast<size_t>( ChunkW ) * ChunkH;
+
+  if ( Bytes.size() < TILE_MAP_HEADER_SIZE + ChunksX * ChunksY * ChunkSize )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Width  = static_cast<int>( Width );
+  m_Height = static_cast<int>( Height );
+  m_Types.resize( static_cast<size_t>( Width ) * Height );
+
+  const Uint8* Chunk_Ptr = Bytes.data() + TILE_MAP_HEADER_SIZE;
+
+  for ( size_t cy = 0; cy != ChunksY; ++cy )
+  {
+    for ( size_t cx = 0; cx != ChunksX; ++cx, Chunk_Ptr += ChunkSize )
+    {
+      const size_t X0   = cx * ChunkW;
+      const size_t Y0   = cy * ChunkH;
+      const size_t Cols = std::min( static_cast<size_t>( ChunkW ), Width  - X0 );
+      const size_t Rows = std::min( static_cast<size_t>( ChunkH ), Height - Y0 );
+
+      for ( size_t Row = 0; Row != Rows; ++Row )
+      {
+        memcpy( &m_Types[( Y0 + Row ) * Width + X0], Chunk_Ptr + Row * ChunkW, Cols );
+      }
+    }
+  }
+
+  return true;
+}
+
+
+ThumbnailContext::ThumbnailContext( void )
+  : m_Surface(NULL), m_Renderer(NULL), m_Tiles(NULL), m_Targets(), m_Pixels()
+{;}
+
+
+ThumbnailContext::~ThumbnailContext( void )
+{
+  close();
+}
+
+
+/**
+ * @brief Creates the software renderer and loads the tiles for it. Its own surface is one pixel:
+ * every preview is drawn into a target texture of the preview's size.
+ *
+ * @param TilesPath The sprite sheet of the tiles.
+ **/
+bool ThumbnailContext::create( const std::string& TilesPath )
+{
+  close();
+
+  m_Surface = SDL_CreateRGBSurfaceWithFormat( 0, 1, 1, 32, PREVIEW_FORMAT );
+
+  if ( m_Surface == NULL )
+  {
+    printf( "\nSurface could not be created! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  m_Renderer = SDL_CreateSoftwareRenderer( m_Surface );
+
+  if ( m_Renderer == NULL )
+  {
+    printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Surface* Loaded_Ptr = IMG_Load( TilesPath.c_str() );
+
+  if ( Loaded_Ptr == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", TilesPath.c_str(), IMG_GetError() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  // Color key image
+  SDL_SetColorKey( Loaded_Ptr, SDL_TRUE, SDL_MapRGB( Loaded_Ptr->format, CYAN_R, CYAN_G, CYAN_B ) );
+
+  m_Tiles = SDL_CreateTextureFromSurface( m_Renderer, Loaded_Ptr );
+  SDL_FreeSurface( Loaded_Ptr );
+
+  if ( m_Tiles == NULL )
+  {
+    printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", TilesPath.c_str(), SDL_GetError() );
+    close();
+    return false;
+  }
+  else
+  {;}
+
+  m_Targets.setRenderer( m_Renderer );
+
+  return true;
+}
+
+
+/**
+ * @brief Draws the preview of a map into a target of the given size, reads it back and saves it.
+ *
+ * @param Width, Height Size of the preview, in pixels.
+ * @param OutPath The PNG file written.
+ * @return true if the file was written.
+ **/
+bool ThumbnailContext::render( const PreviewMap& Map, int Width, int Height, const std::string& OutPath )
+{
+  SDL_Texture* Target_Ptr = m_Targets.acquire( Width, Height, PREVIEW_FORMAT );
+
+  if ( Target_Ptr == NULL || SDL_SetRenderTarget( m_Renderer, Target_Ptr ) != 0 )
+  {
+    printf( "\nUnable to render the preview of size %dx%d! SDL Error: %s", Width, Height, SDL_GetError() );
+    m_Targets.release( Target_Ptr );
+    return false;
+  }
+  else
+  {;}
+
+  DrawMap_Pvt( Map, Width, Height );
+
+  const int Pitch = Width * SDL_BYTESPERPIXEL( PREVIEW_FORMAT );
+
+  m_Pixels.resize( static_cast<size_t>( Pitch ) * static_cast<size_t>( Height ) );
+
+  const bool IsRead = ( SDL_RenderReadPixels( m_Renderer, NULL, PREVIEW_FORMAT, m_Pixels.data(), Pitch ) == 0 );
+
+  SDL_SetRenderTarget( m_Renderer, NULL );
+  m_Targets.release( Target_Ptr );
+
+  if ( !IsRead )
+  {
+    printf( "\nUnable to read the preview back! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Surface* Preview_Ptr = SDL_CreateRGBSurfaceWithFormatFrom( m_Pixels.data(), Width, Height, 32, Pitch, PREVIEW_FORMAT );
+  const bool   IsSaved     = ( Preview_Ptr != NULL && IMG_SavePNG( Preview_Ptr, OutPath.c_str() ) == 0 );
+
+  if ( !IsSaved )
+  {
+    printf( "\nUnable to save \"%s\"! SDL Error: %s", OutPath.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( Preview_Ptr );
+
+  return IsSaved;
+}
+
+
+void ThumbnailContext::close( void )
+{
+  // Textures before their renderer
+  m_Targets.clear();
+  m_Targets.setRenderer( NULL );
+
+  if ( m_Tiles != NULL )
+  {
+    SDL_DestroyTexture( m_Tiles );
+    m_Tiles = NULL;
+  }
+  else
+  {;}
+
+  if ( m_Renderer != NULL )
+  {
+    SDL_DestroyRenderer( m_Renderer );
+    m_Renderer = NULL;
+  }
+  else
+  {;}
+
+  if ( m_Surface != NULL )
+  {
+    SDL_FreeSurface( m_Surface );
+    m_Surface = NULL;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Draws the whole level scaled to fit the preview, keeping its proportions, centred on
+ * black. The edges of the tiles are rounded once per column and row, so that the tiles cover the
+ * level without gaps whatever the scale; tiles narrower than a pixel are left to their neighbours.
+ **/
+void ThumbnailContext::DrawMap_Pvt( const PreviewMap& Map, int Width, int Height )
+{
+  SDL_SetRenderDrawColor( m_Renderer, BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX );
+  SDL_RenderClear( m_Renderer );
+
+  const Sint64 LevelW = static_cast<Sint64>( Map.GetWidth()  ) * TILE_W;
+  const Sint64 LevelH = static_cast<Sint64>( Map.GetHeight() ) * TILE_H;
+
+  // The level's size in the preview: the side that fits first sets the scale
+  Sint64 DrawnW = Width;
+  Sint64 DrawnH = Height;
+
+  if ( LevelW * Height > LevelH * Width )
+  {
+    DrawnH = std::max<Sint64>( 1, LevelH * Width / LevelW );
+  }
+  else
+  {
+    DrawnW = std::max<Sint64>( 1, LevelW * Height / LevelH );
+  }
+
+  const Sint64 OffsetX = ( Width  - DrawnW ) / 2;
+  const Sint64 OffsetY = ( Height - DrawnH ) / 2;
+
+  for ( int Row = 0; Row != Map.GetHeight(); ++Row )
+  {
+    const int Top    = static_cast<int>( OffsetY + DrawnH *   Row       / Map.GetHeight() );
+    const int Bottom = static_cast<int>( OffsetY + DrawnH * ( Row + 1 ) / Map.GetHeight() );
+
+    if ( Bottom == Top )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    for ( int Column = 0; Column != Map.GetWidth(); ++Column )
+    {
+      const int Left  = static_cast<int>( OffsetX + DrawnW *   Column       / Map.GetWidth() );
+      const int Right = static_cast<int>( OffsetX + DrawnW * ( Column + 1 ) / Map.GetWidth() );
+
+      if ( Right == Left )
+      {
+        continue;
+      }
+      else
+      {;}
+
+      const int      Type = Map.GetType( Column, Row );
+      const SDL_Rect Clip{ TILE_SPRITE_COL[Type] * TILE_W, TILE_SPRITE_ROW[Type] * TILE_H, TILE_W, TILE_H };
+      const SDL_Rect Quad{ Left, Top, Right - Left, Bottom - Top };
+
+      SDL_RenderCopy( m_Renderer, m_Tiles, &Clip, &Quad );
+    }
+  }
+}
+
+
+/***************************************************************************************************
+* Functions
+****************************************************************************************************/
+
+/**
+ * @brief Renders the preview of every map of a list, with a pool of contexts. Each worker takes the
+ * next map of the list when it is done with one, so that a large map does not hold back the rest,
+ * and saves its previews itself: loading, drawing and writing all run in parallel.
+ *
+ * SDL and SDL_image (PNG) must be initialised; no window, and no display, is needed.
+ *
+ * @param ListPath One map per line, see loadJobs.
+ * @return true if every preview was written.
+ **/
+bool renderThumbnails( const std::string& ListPath, const ThumbnailSettings& Settings )
+{
+  std::vector<ThumbnailJob> Jobs;
+
+  if ( !loadJobs( ListPath, Settings, Jobs ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const int NumOfWorkers = std::max( 1, std::min( ( Settings.NumOfWorkers > 0 ) ? Settings.NumOfWorkers : SDL_GetCPUCount(),
+                                                  static_cast<int>( std::min<size_t>( Jobs.size(), 1024 ) ) ) );
+
+  ThumbnailQueue Queue;
+  Queue.Jobs_Ptr      = &Jobs;
+  Queue.TilesPath_Ptr = &Settings.TilesPath;
+  SDL_AtomicSet( &Queue.Next,    0 );
+  SDL_AtomicSet( &Queue.Written, 0 );
+
+  printf( "\nRendering %zu previews with %d contexts...", Jobs.size(), NumOfWorkers );
+
+  const Uint64 Start = SDL_GetPerformanceCounter();
+
+  std::vector<SDL_Thread*> Workers( static_cast<size_t>( NumOfWorkers ), NULL );
+
+  for ( size_t i = 0; i != Workers.size(); ++i )
+  {
+    Workers[i] = SDL_CreateThread( thumbnailWorker, "Thumbnails", &Queue );
+
+    if ( Workers[i] == NULL )
+    {
+      printf( "\nUnable to create worker %zu! SDL Error: %s", i, SDL_GetError() );
+    }
+    else
+    {;}
+  }
+
+  for ( SDL_Thread* Worker_Ptr : Workers )
+  {
+    if ( Worker_Ptr != NULL )
+    {
+      SDL_WaitThread( Worker_Ptr, NULL );
+    }
+    else
+    {;}
+  }
+
+  const double Elapsed_s = static_cast<double>( SDL_GetPerformanceCounter() - Start ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+  const size_t Written   = static_cast<size_t>( SDL_AtomicGet( &Queue.Written ) );
+
+  printf( "\n%zu of %zu previews written in %.2f s (%.1f per second)", Written, Jobs.size(), Elapsed_s,
+          ( Elapsed_s > 0.0 ) ? static_cast<double>( Written ) / Elapsed_s : 0.0 );
+
+  return Written == Jobs.size();
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Thumbnails.hpp
+ *
+ * @brief Previews of tile maps (the "lazy.map" text maps and "lazy.tmap" binary maps of 39_tiling)
+ * rendered without a window, by a pool of offscreen contexts working in parallel.
+ **/
+
+#ifndef THUMBNAILS_HPP
+#define THUMBNAILS_HPP
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include "LRenderTargets.hpp"
+
+/**
+ * @brief The settings of a batch of previews.
+ **/
+struct ThumbnailSettings
+{
+  int         Width;        // Default size of a preview, in pixels; a line of the list may set its own
+  int         Height;
+  int         NumOfWorkers; // Contexts, one thread each; 0 for one per core
+  std::string TilesPath;    // Sprite sheet of the tiles
+  std::string OutDir;       // Where the PNG files are written
+};
+
+
+/**
+ * @brief The tile types of a map, row by row. Text maps ("lazy.map") have no header: the tiles of
+ * the first line give the width, the number of tiles the height. Binary maps start with "LTMP".
+ **/
+class PreviewMap
+{
+public:
+
+  PreviewMap( void );
+
+  bool load     ( const std::string& );
+
+  int  GetWidth ( void ) const;
+  int  GetHeight( void ) const;
+  int  GetType  ( int, int ) const;
+
+private:
+
+  bool LoadText_Pvt  ( const std::string& );
+  bool LoadBinary_Pvt( const std::vector<Uint8>& );
+
+  std::vector<Uint8> m_Types;
+  int                m_Width;   // In tiles
+  int                m_Height;
+};
+
+
+/**
+ * @brief What a worker thread draws with: a software renderer on a surface in memory, no window
+ * needed, the tiles loaded for it and a pool of target textures. The preview of a map is drawn into
+ * a target of its size, read back and saved as PNG by the same thread.
+ *
+ * A renderer must only be used by the thread that created it: a context is created, used and closed
+ * by its worker. Nothing is shared between two contexts.
+ **/
+class ThumbnailContext
+{
+public:
+
+  ThumbnailContext( void );
+  ~ThumbnailContext( void );
+
+  ThumbnailContext( const ThumbnailContext& )            = delete;
+  ThumbnailContext& operator=( const ThumbnailContext& ) = delete;
+
+  bool create( const std::string& );
+  bool render( const PreviewMap&, int, int, const std::string& );
+  void close ( void );
+
+private:
+
+  void DrawMap_Pvt( const PreviewMap&, int, int );
+
+  SDL_Surface*       m_Surface;   // Output of the renderer; the previews go to targets
+  SDL_Renderer*      m_Renderer;
+  SDL_Texture*       m_Tiles;
+  LRenderTargetPool  m_Targets;   // Reused while the previews keep the same size
+  std::vector<Uint8> m_Pixels;    // Read back from a target
+};
+
+
+bool renderThumbnails( const std::string&, const ThumbnailSettings& );
+
+#endif // THUMBNAILS_HPP
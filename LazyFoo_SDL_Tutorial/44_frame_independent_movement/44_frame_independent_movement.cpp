@@ -16,6 +16,36 @@
  * apposito timer, e garantisce che il pallino si muova nella posizione corretta a prescindere dal
  * frame rate.
  *
+ * Aggiunta GS: il timer è "LHighResTimer" di Engine_Lib/LTimer, basato su
+ * "SDL_GetPerformanceCounter": l'intervallo ha la risoluzione del contatore invece del millisecondo
+ * di "SDL_GetTicks", che a 144 Hz e oltre fa oscillare "timeStep" di più del 10%. "lap" legge il
+ * contatore una sola volta per calcolare l'intervallo e far ripartire il timer.
+ *
+ * Aggiunta GS: la classe "Dot" non c'è più. Il pallino è un'entità di "LEntityStore" (Engine_Lib),
+ * cioè un semplice handle, con i suoi componenti in array compatti, uno per tipo: posizione,
+ * velocità, box di collisione e sprite. Il moto, il confinamento nella finestra, l'indice spaziale
+ * per le collisioni e il disegno sono "sistemi" di Engine_Lib/LEntitySystems, che scorrono ognuno i
+ * propri array dall'inizio alla fine in un solo ciclo, invece di chiamare "move" e "render" su ogni
+ * oggetto, sparso in memoria. Il tasto 'c' aggiunge (o toglie) una folla di CROWD_SIZE pallini che
+ * rimbalzano sui bordi: sono aggiornati dagli stessi sistemi, disegnati con una sola chiamata per
+ * "LSpriteBatch", e quelli toccati dal pallino guidato dall'utente si colorano di rosso, trovati
+ * interrogando l'"LSpatialGrid" costruito dai box delle entità. La velocità del pallino dipende dai
+ * tasti, come prima, ed è copiata nel suo componente a ogni frame, così il rimbalzo della folla non
+ * la altera.
+ *
+ * Aggiunta GS: moto e confinamento sono un unico passaggio, "StepEntities": posizioni, velocità e box
+ * sono letti come sequenze di float (e di interi), quattro o otto per istruzione con SSE2, AVX o
+ * NEON, in virgola mobile singola invece che doppia, e il confinamento nella finestra usa min / max
+ * invece dei rami. Le folle grandi sono divise in intervalli eseguiti anche dai thread di
+ * "LJobSystem".
+ *
+ * Aggiunta GS: con "--fixed" il pallino guidato dall'utente non segue più "StepEntities" in virgola
+ * mobile, ma si muove a passi fissi di 1/FIXED_STEP_HZ di secondo in virgola fissa 16.16 ("LFixed"
+ * di Engine_Lib/LFixed), con sole operazioni su interi: data la stessa sequenza di tasti e di passi,
+ * la posizione finale ha gli stessi bit con ogni compilatore e su ogni piattaforma, anche senza FPU.
+ * All'uscita sono scritti i passi eseguiti e la posizione in virgola fissa, da confrontare fra le
+ * macchine. La folla resta in virgola mobile.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -30,7 +60,18 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
 #include "colours.hpp"
+#include "LCollision.hpp"
+#include "LEntityStore.hpp"
+#include "LEntitySystems.hpp"
+#include "LFixed.hpp"
+#include "LJobSystem.hpp"
+#include "LSpriteBatch.hpp"
+#include "LTexture.hpp"
+#include "LTimer.hpp"
 
 
 /**************************************************************************************************
@@ -40,138 +81,26 @@
 static constexpr int FIRST_ONE       = -1;
 static constexpr int WINDOW_W        = 640; // Screen's width
 static constexpr int WINDOW_H        = 480; // Screen's heigth
-static constexpr int TRANSPARENCY    = 0x00;
-static constexpr int NUM_OF_FRAMES   = 4; // I quattro "foo_walk"
-static constexpr int BYTES_PER_PIXEL = 4;
-
-static constexpr double MS_IN_S = 1000.0; // Milliseconds in a second
-
-static std::string Path("dot.bmp");
-
-
-/***************************************************************************************************
-* Classes
-****************************************************************************************************/
-
-// Texture wrapper class
-class LTexture
-{
-  public:
-  // Initializes variables
-  LTexture(void);
-
-  // Deallocates memory
-  ~LTexture(void);
 
-  // Loads image at specified path
-	bool loadFromFile( const std::string& );
+// The dimensions of the dot
+static constexpr int DOT_WIDTH  = 20;
+static constexpr int DOT_HEIGHT = 20;
 
-#if defined(SDL_TTF_MAJOR_VERSION)
-  // Creates image from font string
-  bool loadFromRenderedText( const std::string&, SDL_Color );
-#endif
+// Maximum axis velocity of the dot
+static constexpr int DOT_MAX_VEL_pxPerSec = 640;
 
-  // Creates blank texture
-	bool createBlank( int, int, SDL_TextureAccess = SDL_TEXTUREACCESS_STREAMING );
-
-  // Deallocates texture
-  void free(void);
-
-  // Set color modulation
-  void setColor( Uint8, Uint8, Uint8 );
-
-  // Set blending
-  void setBlendMode( SDL_BlendMode );
-
-  // Set alpha modulation
-  void setAlpha( Uint8 );
-
-  // Renders texture at given point
-	void render( int, int, SDL_Rect* = NULL, double = 0.0, SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE );
-
-  // Set self as render target
-  void setAsRenderTarget(void);
-
-  // Gets image dimensions
-  int getWidth ( void ) const;
-  int getHeight( void ) const;
-
-  // Pixel manipulators
-  bool   lockTexture   ( void  );
-  bool   unlockTexture ( void  );
-  void*  getPixels     ( void  ) const;
-  void   copyPixels    ( void* );
-  int    getPitch      ( void  ) const;
-  Uint32 getPixel32    ( unsigned int, unsigned int );
-
-  private:
-
-  // The actual hardware texture
-  SDL_Texture* mTexture;
-  void*        mPixels;
-  int          mPitch;
-
-  // Image dimensions
-  int mWidth;
-  int mHeight;
-};
-
-
-// The application time based timer
-class LTimer
-{
-  public:
-  LTimer(void);
+// La folla di pallini (tasto 'c')
+static constexpr int CROWD_SIZE             = 20000;
+static constexpr int CROWD_MAX_VEL_pxPerSec = 200;
+static constexpr int GRID_CELL_px           = 40;     // Lato di una cella dell'indice spaziale
 
-  // The various clock actions
-  void start  (void);
-  void stop   (void);
-  void pause  (void);
-  void unpause(void);
+// Passi al secondo del pallino in virgola fissa ("--fixed")
+static constexpr int FIXED_STEP_HZ = 240;
 
-  // Gets the timer's time
-  Uint32 getTicks(void);
+static constexpr SDL_Color DOT_COLOUR = { WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+static constexpr SDL_Color HIT_COLOUR = { RED_R, RED_G, RED_B, ALPHA_MAX };
 
-  // Checks the status of the timer
-  bool isStarted(void) const;
-  bool isPaused (void) const;
-
-  private:
-  // The clock time when the timer started
-  Uint32 mStartTicks;
-
-  // The ticks stored when the timer was paused
-  Uint32 mPausedTicks;
-
-  // The timer status
-  bool mPaused;
-  bool mStarted;
-};
-
-
-// The dot that will move around on the screen
-class Dot
-{
-  public:
-
-  // The dimensions of the dot
-  static const int DOT_WIDTH  = 20;
-  static const int DOT_HEIGHT = 20;
-
-  // Maximum axis velocity of the dot
-  static const int DOT_MAX_VEL_pxPerSec = 640;
-
-  Dot();
-
-  void handleEvent( SDL_Event& e );
-  void move       ( double timeStep );
-  void render     ( void );
-
-  private:
-
-  double mPosX, mPosY;
-  double mVelX, mVelY;
-};
+static std::string Path("dot.bmp");
 
 
 /***************************************************************************************************
@@ -182,6 +111,12 @@ static bool init      (void);
 static bool loadMedia (void);
 static void close     (void);
 
+static LEntity spawnDot       ( float, float, float, float );
+static void    handleDotEvent ( const SDL_Event& );
+static void    toggleCrowd    ( void );
+static void    markHits       ( void );
+static void    stepFixedDot   ( double );
+
 
 /***************************************************************************************************
 * Private global variables
@@ -191,573 +126,30 @@ static SDL_Window*   gWindow   = NULL; // The window we'll be rendering to
 static SDL_Renderer* gRenderer = NULL; // The window renderer
 
 // Scene textures
-static LTexture gDotTexture;
-
-
-/***************************************************************************************************
-* Methods definitions
-****************************************************************************************************/
-
-LTexture::LTexture(void)
-{
-  // Initialize
-  mTexture = NULL;
-  mWidth   = 0;
-  mHeight  = 0;
-  mPixels  = NULL;
-  mPitch   = 0;
-}
-
-
-LTexture::~LTexture(void)
-{
-  // Deallocate
-  free();
-}
-
-
-bool LTexture::loadFromFile( const std::string& path )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // The final texture
-  SDL_Texture* newTexture = NULL;
-
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
-
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nOK: image \"%s\" loaded", path.c_str() );
-
-    // Convert surface to display format
-    SDL_Surface* formattedSurface = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_RGBA8888, 0 );
-
-    if( formattedSurface == NULL )
-    {
-      printf( "\nUnable to convert loaded surface to display format! SDL Error: %s\n", SDL_GetError() );
-    }
-    else
-    {
-      // Create blank streamable texture
-      newTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, formattedSurface->w, formattedSurface->h );
-
-      if( newTexture == NULL )
-      {
-        printf( "\nUnable to create blank texture! SDL Error: %s\n", SDL_GetError() );
-      }
-      else
-      {
-        // Enable blending on texture
-        SDL_SetTextureBlendMode( newTexture, SDL_BLENDMODE_BLEND );
-
-        // Lock texture for manipulation
-        SDL_LockTexture( newTexture, &formattedSurface->clip_rect, &mPixels, &mPitch );
-
-        // Copy loaded/formatted surface pixels
-        memcpy( mPixels, formattedSurface->pixels, formattedSurface->pitch * formattedSurface->h );
-
-        // Get image dimensions
-        mWidth  = formattedSurface->w;
-        mHeight = formattedSurface->h;
-
-        // Get pixel data in editable format
-        Uint32* pixels = (Uint32*)mPixels;
-        int pixelCount = ( mPitch / BYTES_PER_PIXEL ) * mHeight;
-
-        // Map colors
-        Uint32 colorKey    = SDL_MapRGB ( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B );
-        Uint32 transparent = SDL_MapRGBA( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B, TRANSPARENCY );
-
-        // Color key pixels
-        for( int i = 0; i != pixelCount; ++i )
-        {
-          if( pixels[ i ] == colorKey )
-          {
-            pixels[ i ] = transparent;
-          }
-          else { /* Skip this pixel */ }
-        }
-
-        // Unlock texture to update
-        SDL_UnlockTexture( newTexture );
-        mPixels = NULL;
-      }
-
-      // Get rid of old formatted surface
-      SDL_FreeSurface( formattedSurface );
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
-  }
-
-  // Return success
-  mTexture = newTexture;
-
-  return mTexture != NULL;
-}
-
-
-#if defined(SDL_TTF_MAJOR_VERSION)
-bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
-{
-  // Get rid of preexisting texture
-  free();
-
-  // Render text surface
-  SDL_Surface* textSurface = TTF_RenderText_Solid( gFont, textureText.c_str(), textColor );
-
-  if( textSurface != NULL )
-  {
-    // Create texture from surface pixels
-        mTexture = SDL_CreateTextureFromSurface( gRenderer, textSurface );
-
-    if( mTexture == NULL )
-    {
-      printf( "\nUnable to create texture from rendered text! SDL Error: %s", SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nOK: texture created from rendered text" );
-
-      // Get image dimensions
-      mWidth  = textSurface->w;
-      mHeight = textSurface->h;
-    }
-
-    // Get rid of old surface
-    SDL_FreeSurface( textSurface );
-  }
-  else
-  {
-    printf( "\nUnable to render text surface! SDL_ttf Error: %s", TTF_GetError() );
-  }
-
-  // Return success
-  return mTexture != NULL;
-}
-#endif
-
-
-bool LTexture::createBlank( int width, int height, SDL_TextureAccess access )
-{
-  // Create uninitialized texture
-  mTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, access, width, height );
-
-  if( mTexture == NULL )
-  {
-    printf( "\nUnable to create blank texture! SDL Error: \"%s\"", SDL_GetError() );
-  }
-  else
-  {
-    printf( "\nOK: blank texture created" );
-    mWidth = width;
-    mHeight = height;
-  }
-
-  return mTexture != NULL;
-}
-
-
-void LTexture::free( void )
-{
-  // Free texture if it exists
-  if( mTexture != NULL )
-  {
-    SDL_DestroyTexture( mTexture );
-    mTexture = NULL;
-    mWidth   = 0;
-    mHeight  = 0;
-    mPixels  = NULL;
-    mPitch   = 0;
-  }
-  else { /* Nothing to destroy */ }
-}
-
-
-/**
- * @brief Modulate texture rgb
- *
- * @param red
- * @param green
- * @param blue
- **/
-void LTexture::setColor( Uint8 red, Uint8 green, Uint8 blue )
-{
-  SDL_SetTextureColorMod( mTexture, red, green, blue );
-}
-
-
-/**
- * @brief Set blending function
- *
- * @param blending
- **/
-void LTexture::setBlendMode( SDL_BlendMode blending )
-{
-  SDL_SetTextureBlendMode( mTexture, blending );
-}
-
-
-/**
- * @brief Modulate texture alpha
- *
- * @param alpha
- **/
-void LTexture::setAlpha( Uint8 alpha )
-{
-  SDL_SetTextureAlphaMod( mTexture, alpha );
-}
-
-
-void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* center, SDL_RendererFlip flip )
-{
-  // Set rendering space and render to screen
-  SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-
-  // Set clip rendering dimensions
-  if( clip != NULL )
-  {
-    renderQuad.w = clip->w;
-    renderQuad.h = clip->h;
-  }
-  else { /* Render the whole texture */ }
-
-  // Render to screen
-  SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
-}
-
-
-void LTexture::setAsRenderTarget(void)
-{
-  // Make self render target
-  SDL_SetRenderTarget( gRenderer, mTexture );
-}
-
-
-int LTexture::getWidth(void) const
-{
-  return mWidth;
-}
-
-
-int LTexture::getHeight(void) const
-{
-  return mHeight;
-}
-
-
-bool LTexture::lockTexture(void)
-{
-  bool success = true;
-
-  // Texture is already locked
-  if( mPixels != NULL )
-  {
-    printf( "\nTexture is already locked!" );
-    success = false;
-  }
-  // Lock texture
-  else
-  {
-    if( SDL_LockTexture( mTexture, NULL, &mPixels, &mPitch ) != 0 )
-    {
-      printf( "\nUnable to lock texture! %s\n", SDL_GetError() );
-      success = false;
-    }
-		else {;}
-  }
-
-  return success;
-}
-
-
-bool LTexture::unlockTexture(void)
-{
-  bool success = true;
-
-  // Texture is not locked
-  if( mPixels == NULL )
-  {
-    printf( "\nTexture is not locked!" );
-    success = false;
-  }
-  // Unlock texture
-  else
-  {
-    SDL_UnlockTexture( mTexture );
-    mPixels = NULL;
-    mPitch = 0;
-  }
-
-  return success;
-}
-
-
-void* LTexture::getPixels(void) const
-{
-  return mPixels;
-}
-
-
-/**
- * @brief Copy the pixels from the stream into the texture
- *
- * @param pixels
- **/
-void LTexture::copyPixels( void* pixels )
-{
-  // Texture is locked
-  if( mPixels != NULL )
-  {
-    // Copy to locked pixels
-    memcpy( mPixels, pixels, mPitch * mHeight );
-  }
-  else { /* Cannot copy */ }
-}
-
-
-int LTexture::getPitch(void) const
-{
-  return mPitch;
-}
-
-
-/**
- * @brief I pixel di una texture bidimensionale vengono memorizzati come un'unica, singola sequenza
- * di bytes. Quindi, è necessario "trasformare" una matrice bidimensionale in un vettore
- * monodimensionale.
- *
- * @param x Coordinata x del pixel da ricavare
- * @param y Coordinata y del pixel da ricavare
- * @return Uint32
- **/
-Uint32 LTexture::getPixel32( unsigned int x, unsigned int y )
-{
-  // Convert the pixels to 32 bit
-  Uint32* pixels = (Uint32*)mPixels;
-
-  // Get the pixel requested
-  return pixels[ ( y * ( mPitch / 4 ) ) + x ];
-}
-
-
-/**
- * @brief Initializes variables
- **/
-LTimer::LTimer(void)
-{
-  // Initialize the variables
-  mStartTicks  = static_cast<Uint32>(0);
-  mPausedTicks = static_cast<Uint32>(0);
-
-  mPaused  = false;
-  mStarted = false;
-}
-
-
-void LTimer::start(void)
-{
-  // Start the timer
-  mStarted = true;
-
-  // Unpause the timer
-  mPaused = false;
-
-  // Get the current clock time
-  mStartTicks  = SDL_GetTicks();
-  mPausedTicks = 0;
-}
-
-
-void LTimer::stop(void)
-{
-  // Stop the timer
-  mStarted = false;
-
-  // Unpause the timer
-  mPaused = false;
-
-  // Clear tick variables
-  mStartTicks = 0;
-  mPausedTicks = 0;
-}
-
-
-void LTimer::pause(void)
-{
-  // If the timer is running and isn't already paused
-  if( mStarted && !mPaused )
-  {
-    // Pause the timer
-    mPaused = true;
-
-    // Calculate the paused ticks
-    mPausedTicks = SDL_GetTicks() - mStartTicks;
-    mStartTicks  = 0;
-  }
-  else { /* Not started or already paused */ }
-}
-
-
-void LTimer::unpause(void)
-{
-  // If the timer is running and paused
-  if( mStarted && mPaused )
-  {
-    // Unpause the timer
-    mPaused = false;
-
-    // Reset the starting ticks
-    mStartTicks = SDL_GetTicks() - mPausedTicks;
-
-    // Reset the paused ticks
-    mPausedTicks = 0;
-  }
-  else { /* Not started or already running */ }
-}
-
-
-Uint32 LTimer::getTicks(void)
-{
-  // The actual timer time
-  Uint32 time = 0;
-
-  // If the timer is running
-  if( mStarted )
-  {
-    // If the timer is paused
-    if( mPaused )
-    {
-      // Return the number of ticks when the timer was paused
-      time = mPausedTicks;
-    }
-    else
-    {
-      // Return the current time minus the start time
-      time = SDL_GetTicks() - mStartTicks;
-    }
-  }
-  else { /* Timer not running */ }
-
-  return time;
-}
-
-
-bool LTimer::isStarted(void) const
-{
-  // Timer is running and paused or unpaused
-  return mStarted;
-}
-
-
-bool LTimer::isPaused(void) const
-{
-  // Timer is running and paused
-  return mPaused && mStarted;
-}
-
-
-/**
- * @brief Construct a new Dot:: Dot object
- **/
-Dot::Dot(void)
-{
-  // Initialize the position
-  mPosX = 0;
-  mPosY = 0;
-
-  // Initialize the velocity
-  mVelX = 0;
-  mVelY = 0;
-}
-
-
-/**
- * @brief Takes key presses and adjusts the dot's velocity.
- *
- * @param e SDL_Event to manage
- **/
-void Dot::handleEvent( SDL_Event& e )
-{
-  // If a key was pressed
-  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
-    {
-      // Adjust the velocity
-      switch( e.key.keysym.sym )
-      {
-        case SDLK_UP: mVelY -= DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_DOWN: mVelY += DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_LEFT: mVelX -= DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_RIGHT: mVelX += DOT_MAX_VEL_pxPerSec; break;
-      }
-    }
-    // If a key was released
-    else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
-    {
-      // Adjust the velocity
-      switch( e.key.keysym.sym )
-      {
-        case SDLK_UP: mVelY += DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_DOWN: mVelY -= DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_LEFT: mVelX += DOT_MAX_VEL_pxPerSec; break;
-        case SDLK_RIGHT: mVelX -= DOT_MAX_VEL_pxPerSec; break;
-      }
-    }
-}
-
-
-/**
- * @brief Moves the dot based on a time step.
- *
- * @param timeStep
- **/
-void Dot::move( double timeStep )
-{
-  // Move the dot left or right
-  mPosX += mVelX * timeStep;
-
-  // If the dot went too far to the left or right
-  if( mPosX < 0 )
-  {
-    mPosX = 0;
-  }
-  else if( mPosX > WINDOW_W - DOT_WIDTH )
-  {
-    mPosX = WINDOW_W - DOT_WIDTH;
-  }
-  else { /* Movement was OK */ }
-
-  // Move the dot up or down
-  mPosY += mVelY * timeStep;
-
-  // If the dot went too far up or down
-  if( mPosY < 0 )
-  {
-    mPosY = 0;
-  }
-  else if( mPosY > WINDOW_H - DOT_HEIGHT )
-  {
-    mPosY = WINDOW_H - DOT_HEIGHT;
-  }
-  else { /* Movement was OK */ }
-}
-
-
-/**
- * @brief Shows the dot on the screen.
- **/
-void Dot::render(void)
-{
-  // Show the dot
-  gDotTexture.render( static_cast<int>(mPosX), static_cast<int>(mPosY) );
-}
+static LTexture     gDotTexture;
+static LSpriteBatch gBatch;
+static LJobSystem   gJobs;
+
+// Le entità e i loro componenti
+static LEntityStore               gEntities;
+static LComponentArray<LPosition> gPositions;
+static LComponentArray<LVelocity> gVelocities;
+static LComponentArray<LBox>      gBoxes;
+static LComponentArray<LSprite>   gSprites;
+static LSpatialGrid               gGrid( SDL_Rect{ 0, 0, WINDOW_W, WINDOW_H }, GRID_CELL_px );
+
+static LEntity              gDot;           // Il pallino guidato dall'utente
+static LVelocity            gDotVelocity;   // Data dai tasti premuti
+static std::vector<LEntity> gCrowd;
+static std::vector<LEntity> gHits;          // Pallini colorati dall'ultimo contatto
+static std::vector<int>     gFound;         // Risultato delle ricerche nella griglia
+
+// Il pallino in virgola fissa, con "--fixed"
+static bool   gIsFixedPoint     = false;
+static LFixed gDotFixedX        = LFixed::FromInt( 0 );
+static LFixed gDotFixedY        = LFixed::FromInt( 0 );
+static double gFixedAccumulator = 0.0;   // Tempo non ancora simulato, in secondi
+static Uint64 gFixedSteps       = 0;
 
 
 /***************************************************************************************************
@@ -838,6 +230,16 @@ static bool init(void)
           printf( "\nOK: SDL_image initialised" );
         }
 
+        // Start the job workers: if they cannot start, the crowd moves on this thread
+        if( !gJobs.init() )
+        {
+          printf( "\nUnable to start the job workers!" );
+        }
+        else
+        {
+          printf( "\nOK: %d job workers started, %s movement kernel", gJobs.GetWorkerCount(), GetEntityKernel() );
+        }
+
       } // Renderer created
 
     } // Window created
@@ -859,7 +261,7 @@ static bool loadMedia( void )
   bool success = true;
 
   // Load dot texture
-  if( !gDotTexture.loadFromFile( Path ) )
+  if( !gDotTexture.loadFromFile( Path, gRenderer ) )
   {
     printf( "\nFailed to load dot texture!" );
     success = false;
@@ -878,6 +280,9 @@ static void close(void)
   // Free loaded images
   gDotTexture.free();
 
+  // Stop the job workers
+  gJobs.shutdown();
+
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
 	SDL_DestroyWindow	 ( gWindow );
@@ -890,6 +295,175 @@ static void close(void)
 }
 
 
+/**
+ * @brief A dot: an entity with position, velocity, collision box and sprite.
+ **/
+static LEntity spawnDot( float x, float y, float VelX, float VelY )
+{
+  const LEntity Dot = gEntities.create();
+
+  gPositions.add ( Dot, LPosition{ x, y } );
+  gVelocities.add( Dot, LVelocity{ VelX, VelY } );
+  gBoxes.add     ( Dot, LBox{ DOT_WIDTH, DOT_HEIGHT } );
+  gSprites.add   ( Dot, LSprite{ &gDotTexture, SDL_Rect{ 0, 0, 0, 0 }, DOT_COLOUR } );
+
+  return Dot;
+}
+
+
+/**
+ * @brief Takes key presses and adjusts the dot's velocity.
+ *
+ * @param e SDL_Event to manage
+ **/
+static void handleDotEvent( const SDL_Event& e )
+{
+  const float Delta = static_cast<float>( DOT_MAX_VEL_pxPerSec );
+
+  // If a key was pressed
+  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP:    gDotVelocity.y -= Delta; break;
+      case SDLK_DOWN:  gDotVelocity.y += Delta; break;
+      case SDLK_LEFT:  gDotVelocity.x -= Delta; break;
+      case SDLK_RIGHT: gDotVelocity.x += Delta; break;
+      case SDLK_c:     toggleCrowd();           break;
+      default:                                  break;
+    }
+  }
+  // If a key was released
+  else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP:    gDotVelocity.y += Delta; break;
+      case SDLK_DOWN:  gDotVelocity.y -= Delta; break;
+      case SDLK_LEFT:  gDotVelocity.x += Delta; break;
+      case SDLK_RIGHT: gDotVelocity.x -= Delta; break;
+      default:                                  break;
+    }
+  }
+  else { /* Event not managed here */ }
+}
+
+
+/**
+ * @brief Adds the crowd of dots, or removes it. The dots removed free their entities, whose indices
+ * the next crowd reuses.
+ **/
+static void toggleCrowd( void )
+{
+  if( gCrowd.empty() )
+  {
+    for( int i = 0; i != CROWD_SIZE; ++i )
+    {
+      const float x    = static_cast<float>( rand() % ( WINDOW_W - DOT_WIDTH ) );
+      const float y    = static_cast<float>( rand() % ( WINDOW_H - DOT_HEIGHT ) );
+      const float VelX = static_cast<float>( rand() % ( 2 * CROWD_MAX_VEL_pxPerSec + 1 ) - CROWD_MAX_VEL_pxPerSec );
+      const float VelY = static_cast<float>( rand() % ( 2 * CROWD_MAX_VEL_pxPerSec + 1 ) - CROWD_MAX_VEL_pxPerSec );
+
+      gCrowd.push_back( spawnDot( x, y, VelX, VelY ) );
+    }
+  }
+  else
+  {
+    for( const LEntity& Dot : gCrowd )
+    {
+      gEntities.destroy( Dot );
+    }
+
+    gCrowd.clear();
+    gHits.clear();
+  }
+
+  printf( "\n%u entities", static_cast<unsigned>( gEntities.GetCount() ) );
+}
+
+
+/**
+ * @brief Colours red the dots the user's dot touches, and back to white those it has left.
+ **/
+static void markHits( void )
+{
+  for( const LEntity& Dot : gHits )
+  {
+    LSprite* Sprite_Ptr = gSprites.get( Dot );
+
+    if( Sprite_Ptr != NULL )
+    {
+      Sprite_Ptr->Colour = DOT_COLOUR;
+    }
+    else { /* Destroyed meanwhile */ }
+  }
+
+  gHits.clear();
+
+  const LPosition* Position_Ptr = gPositions.get( gDot );
+
+  if( Position_Ptr == NULL )
+  {
+    return;
+  }
+  else { /* Look for the dots it touches */ }
+
+  const SDL_Rect DotBox{ static_cast<int>( Position_Ptr->x ), static_cast<int>( Position_Ptr->y ), DOT_WIDTH, DOT_HEIGHT };
+
+  gGrid.query( DotBox, gFound );
+
+  for( int Index : gFound )
+  {
+    const LEntity   Other    = gBoxes.GetOwner( static_cast<size_t>( Index ) );
+    const SDL_Rect& OtherBox = gGrid.GetBounds( Index );
+
+    if( Other != gDot && CheckCollision( DotBox, OtherBox ) )
+    {
+      gSprites.get( Other )->Colour = HIT_COLOUR;
+      gHits.push_back( Other );
+    }
+    else { /* Only a neighbour in the grid */ }
+  }
+}
+
+
+/**
+ * @brief Moves the user's dot by the whole fixed steps the elapsed time covers, in fixed point, and
+ * keeps it inside the window. Its velocity is in whole pixels per second, so each step moves it by
+ * the same raw amount on every machine; what is left of the time waits for the next frame.
+ *
+ * @param timeStep Seconds since the last call
+ **/
+static void stepFixedDot( double timeStep )
+{
+  const LFixed StepX = LFixed::FromInt( static_cast<int>( gDotVelocity.x ) ) / FIXED_STEP_HZ;
+  const LFixed StepY = LFixed::FromInt( static_cast<int>( gDotVelocity.y ) ) / FIXED_STEP_HZ;
+  const LFixed MaxX  = LFixed::FromInt( WINDOW_W - DOT_WIDTH );
+  const LFixed MaxY  = LFixed::FromInt( WINDOW_H - DOT_HEIGHT );
+  const LFixed Zero  = LFixed::FromInt( 0 );
+
+  gFixedAccumulator += timeStep;
+
+  while( gFixedAccumulator >= 1.0 / FIXED_STEP_HZ )
+  {
+    gDotFixedX += StepX;
+    gDotFixedY += StepY;
+
+    gDotFixedX = ( gDotFixedX < Zero ) ? Zero : ( ( gDotFixedX > MaxX ) ? MaxX : gDotFixedX );
+    gDotFixedY = ( gDotFixedY < Zero ) ? Zero : ( ( gDotFixedY > MaxY ) ? MaxY : gDotFixedY );
+
+    gFixedAccumulator -= 1.0 / FIXED_STEP_HZ;
+    ++gFixedSteps;
+  }
+
+  // Drawn, and collided, where the fixed point says; the systems leave it alone
+  *gPositions.get( gDot )  = LPosition{ static_cast<float>( gDotFixedX.ToDouble() ), static_cast<float>( gDotFixedY.ToDouble() ) };
+  *gVelocities.get( gDot ) = LVelocity{ 0.f, 0.f };
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -915,6 +489,13 @@ int main( int argc, char* args[] )
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    // "--fixed" moves the user's dot in fixed point
+    if( strcmp( args[i], "--fixed" ) == 0 )
+    {
+      gIsFixedPoint = true;
+    }
+    else { /* Unknown argument */ }
   }
 
   // Start up SDL and create window
@@ -941,11 +522,19 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // Ogni array toglie i componenti delle entità distrutte
+      gEntities.attach( gPositions  );
+      gEntities.attach( gVelocities );
+      gEntities.attach( gBoxes      );
+      gEntities.attach( gSprites    );
+
       // The dot that will be moving around on the screen
-      Dot dot;
+      gDot = spawnDot( 0.f, 0.f, 0.f, 0.f );
+
+      const SDL_Rect WindowArea{ 0, 0, WINDOW_W, WINDOW_H };
 
       // Keeps track of time between steps
-      LTimer stepTimer;
+      LHighResTimer stepTimer;
 
       // While application is running
       while( !quit )
@@ -961,28 +550,47 @@ int main( int argc, char* args[] )
           else { /* Event not managed here */ }
 
           // Handle input for the dot
-          dot.handleEvent( e );
+          handleDotEvent( e );
         }
 
-        // Calculate time step
-        double timeStep = static_cast<double>(stepTimer.getTicks()) / MS_IN_S;
+        // Calculate time step and restart step timer
+        double timeStep = stepTimer.lap();
 
-        // Move for time step
-        dot.move( timeStep );
+        // The user's dot goes where the keys say, in fixed point with "--fixed"
+        if( gIsFixedPoint )
+        {
+          stepFixedDot( timeStep );
+        }
+        else
+        {
+          *gVelocities.get( gDot ) = gDotVelocity;
+        }
+
+        // Move for time step and keep inside the window: the crowd bounces off the edges
+        StepEntities( gPositions, gVelocities, gBoxes, WindowArea, timeStep, &gJobs );
 
-        // Restart step timer
-        stepTimer.start();
+        GridEntities( gPositions, gBoxes, gGrid );
+        markHits();
 
         // Clear screen
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
         SDL_RenderClear( gRenderer );
 
-        // Render dot
-        dot.render();
+        // Render dots
+        gBatch.begin();
+        DrawEntities( gPositions, gSprites, gBatch );
+        gBatch.flush( gRenderer );
 
         // Update screen
         SDL_RenderPresent( gRenderer );
       }
+
+      if( gIsFixedPoint )
+      {
+        printf( "\nFixed point dot: %llu steps, raw position (%ld, %ld)", static_cast<unsigned long long>( gFixedSteps ),
+                static_cast<long>( gDotFixedX.Raw ), static_cast<long>( gDotFixedY.Raw ) );
+      }
+      else { /* Floating point dot */ }
     }
   }
 
@@ -19,6 +19,19 @@
  *
  * Do make sure to "SDL_Init" with "SDL_INIT_TIMER" to use timer callbacks.
  *
+ * Aggiunta GS: i timer non sono più di SDL, che esegue ogni callback sul proprio thread, uno per
+ * volta, ma di un "LTimerWheel" di Engine_Lib: una ruota gerarchica di timer al millisecondo, che il
+ * ciclo principale fa avanzare una volta per frame con "advance", eseguendo in blocco le callback
+ * scadute nel frattempo, sul thread principale. Aggiungere e cancellare un timer costa O(1)
+ * qualunque sia il loro numero: oltre al messaggio dei 3 secondi, il programma crea GAMEPLAY_TIMERS
+ * timer con ritardi casuali, ne cancella uno ogni CANCEL_EVERY, e ogni REPORT_MS millisecondi un
+ * timer periodico stampa quanti ne sono scaduti e quanti restano. Le callback hanno la stessa firma
+ * di quelle di SDL: restituiscono l'intervallo dopo cui ripetersi, o 0.
+ *
+ * Aggiunta GS: con "--trace=<file>" il programma registra in un file Chrome trace (da aprire con
+ * chrome://tracing o https://ui.perfetto.dev) i frame del ciclo principale e, dentro ciascuno, il
+ * tempo passato nelle callback dei timer (Engine_Lib/LTrace).
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -33,7 +46,10 @@
 #include <SDL_image.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 #include "colours.hpp"
+#include "LTimerWheel.hpp"
+#include "LTrace.hpp"
 
 
 /**************************************************************************************************
@@ -46,6 +62,11 @@ static constexpr int WINDOW_H        = 480; // Screen's heigth
 static constexpr int TRANSPARENCY    = 0x00;
 static constexpr int BYTES_PER_PIXEL = 4;
 
+static constexpr int    GAMEPLAY_TIMERS = 20000; // Timers scheduled at start
+static constexpr int    MAX_DELAY_MS    = 10000; // Longest delay of a gameplay timer
+static constexpr int    CANCEL_EVERY    = 10;    // One gameplay timer in CANCEL_EVERY is cancelled
+static constexpr Uint32 REPORT_MS       = 1000;  // Period of the report timer
+
 static std::string Path("splash.bmp");
 
 /***************************************************************************************************
@@ -124,7 +145,9 @@ static bool init      (void);
 static bool loadMedia (void);
 static void close     (void);
 
-static Uint32 callback( Uint32, void* );
+static Uint32 callback        ( Uint32, void* );
+static Uint32 gameplayCallback( Uint32, void* );
+static Uint32 reportCallback  ( Uint32, void* );
 
 
 /***************************************************************************************************
@@ -137,6 +160,9 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 LTexture gSplashTexture;
 
+// Gameplay timers run so far
+static int gGameplayFired = 0;
+
 
 /***************************************************************************************************
 * Methods definitions
@@ -640,6 +666,33 @@ static Uint32 callback( [[maybe_unused]] Uint32 interval, void* param )
 }
 
 
+/**
+ * @brief Stands for the timers of the game objects: it only counts itself.
+ **/
+static Uint32 gameplayCallback( [[maybe_unused]] Uint32 interval, [[maybe_unused]] void* param )
+{
+  ++gGameplayFired;
+
+  return 0;
+}
+
+
+/**
+ * @brief Prints how many gameplay timers have run and how many are pending, every "interval"
+ * milliseconds, until it is the only timer left.
+ *
+ * @param param The LTimerWheel it runs on
+ **/
+static Uint32 reportCallback( Uint32 interval, void* param )
+{
+  const LTimerWheel* Timers_Ptr = static_cast<LTimerWheel*>(param);
+
+  printf( "\n%d gameplay timers fired, %zu timers pending", gGameplayFired, Timers_Ptr->GetPendingCount() );
+
+  return ( Timers_Ptr->GetPendingCount() > 1 ) ? interval : 0;
+}
+
+
 static void PressEnter(void)
 {
   int UserChoice = '\0';
@@ -667,8 +720,13 @@ int main( int argc, char* args[] )
     printf("\nArgument #%d: %s\n", i, args[i]);
   }
 
+  // "--trace=<file>" records a timeline of the main loop and of the timers
+  if( !LTrace::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   // Start up SDL and create window
-  if( !init() )
+  else if( !init() )
   {
     printf( "\nFailed to initialise!" );
   }
@@ -691,13 +749,35 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
+      // Timers run by the main loop
+      LTimerWheel Timers( SDL_GetTicks() );
+
       // Set callback
       //  SDL_TimerID timerID = SDL_AddTimer( 3 * 1000, callback, reinterpret_cast<void*>( "3 seconds waited!" ) ); // Istruzione originale: solleva errore "reinterpret_cast from type 'const char*' to type 'void*' casts away qualifiers"
-      SDL_TimerID timerID = SDL_AddTimer( 3 * 1000, callback, (void*)( "3 seconds waited!" ) );
+      LTimerHandle timerID = Timers.add( 3 * 1000, callback, (void*)( "3 seconds waited!" ) );
+
+      // Gameplay timers, a few of them cancelled before they run, and their report
+      std::vector<LTimerHandle> GameplayTimers( GAMEPLAY_TIMERS );
+
+      for( int i = 0; i != GAMEPLAY_TIMERS; ++i )
+      {
+        GameplayTimers[i] = Timers.add( static_cast<Uint32>( rand() % MAX_DELAY_MS ), gameplayCallback, NULL );
+      }
+
+      for( int i = 0; i < GAMEPLAY_TIMERS; i += CANCEL_EVERY )
+      {
+        Timers.cancel( GameplayTimers[i] );
+      }
+
+      Timers.add( REPORT_MS, reportCallback, &Timers );
+
+      LTrace::nameThread( "Main" );
 
       // While application is running
       while( !quit )
       {
+        LTrace::frameMark();
+
         // Handle events on queue
         while( SDL_PollEvent( &e ) != 0 )
         {
@@ -717,13 +797,19 @@ int main( int argc, char* args[] )
 
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        // Run the timers due since the last frame
+        Timers.advance( SDL_GetTicks() );
       }
 
       // Remove timer in case the call back was not called
-      SDL_RemoveTimer( timerID );
+      Timers.cancel( timerID );
     }
   }
 
+  // Write what is left of the trace while SDL is still up
+  LTrace::close();
+
   // Free resources and close SDL
   close();
 
@@ -10,6 +10,13 @@
  * Just like with callback functions, thread functions need to be declared a certain way. They need
  * to take in a void pointer as an argument and return an integer.
  *
+ * Aggiunta GS: al posto di un thread creato apposta c'è "LJobSystem" di Engine_Lib/LJobSystem, un
+ * pool fisso di thread (uno per core, escluso quello principale) a cui si passano piccoli lavori:
+ * creare un thread per ogni compito costa troppo per le fasi di un frame. Ogni thread ha la sua
+ * coda e, quando è vuota, "ruba" il lavoro più vecchio dalle code degli altri. Un "LJobCounter"
+ * conta i lavori di un gruppo ancora da finire: "runAfter" fa partire un lavoro quando un gruppo è
+ * finito, e "wait" aspetta un gruppo eseguendo nel frattempo i lavori in coda.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -26,6 +33,7 @@
 #include <stdio.h>
 #include <string>
 #include "colours.hpp"
+#include "LJobSystem.hpp"
 
 
 /**************************************************************************************************
@@ -38,6 +46,8 @@ static constexpr int WINDOW_H        = 480; // Screen's heigth
 static constexpr int TRANSPARENCY    = 0x00;
 static constexpr int BYTES_PER_PIXEL = 4;
 
+static constexpr int JOBS_COUNT = 8; // Jobs fanned out to the pool
+
 static std::string Path("splash.png");
 
 /***************************************************************************************************
@@ -116,7 +126,8 @@ static bool init      (void);
 static bool loadMedia (void);
 static void close     (void);
 
-static int threadFunction( void* );
+static void jobFunction   ( void* );
+static void reportFunction( void* );
 
 
 /***************************************************************************************************
@@ -618,19 +629,23 @@ static void close(void)
 
 
 /**
- * @brief Our test thread function.
+ * @brief Our test job, run by a worker of the pool.
  *
- * @param data
- * @return int
+ * @param data The value to print
  **/
-static int threadFunction( void* data )
+static void jobFunction( void* data )
 {
-	// Print incoming data
+	// Print incoming data, and the thread running the job
+	printf( "\nRunning job with value = %d on thread %lu", *static_cast<int*>( data ), SDL_ThreadID() );
+}
 
-	// printf( "Running thread with value = %d\n", (int)data );
-	printf( "\nRunning thread with value = %llu", (intptr_t)data );
 
-	return 0;
+/**
+ * @brief Runs after every test job is done.
+ **/
+static void reportFunction( void* )
+{
+	printf( "\nAll %d jobs done", JOBS_COUNT );
 }
 
 
@@ -685,9 +700,22 @@ int main( int argc, char* args[] )
 			// Event handler
 			SDL_Event e;
 
-			// Run the thread
-			int 				data 		 = 101;
-			SDL_Thread* threadID = SDL_CreateThread( threadFunction, "LazyThread", (void*)data );
+			// Start a worker per core, and fan out the jobs, then one that reports when they are done
+			LJobSystem  jobs;
+			LJobCounter jobsDone;
+			LJobCounter reportDone;
+			int         data[JOBS_COUNT];
+
+			jobs.init();
+			printf( "\n%d job workers", jobs.GetWorkerCount() );
+
+			for( int i = 0; i != JOBS_COUNT; ++i )
+			{
+				data[i] = 101 + i;
+				jobs.run( jobFunction, &data[i], &jobsDone );
+			}
+
+			jobs.runAfter( jobsDone, reportFunction, NULL, &reportDone );
 
 			// While application is running
 			while( !quit )
@@ -714,8 +742,9 @@ int main( int argc, char* args[] )
 				SDL_RenderPresent( gRenderer );
 			}
 
-			// Make sure the thread finishes before the application closes
-			SDL_WaitThread( threadID, NULL );
+			// Make sure the jobs finish before the application closes
+			jobs.wait( reportDone );
+			jobs.shutdown();
 		}
 	}
 
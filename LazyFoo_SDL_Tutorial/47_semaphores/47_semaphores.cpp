@@ -15,6 +15,11 @@
  * Osservare il rimpallo del dato "gData" da un thread all'altro: un thread lo riceve, lo modifica
  * in modalità protetta, e lo passa all'altro thread.
  *
+ * Aggiunta GS: il semaforo è un "LSemaphore" di Engine_Lib/LLockStats, che conta le acquisizioni,
+ * quelle che hanno dovuto aspettare, il tempo passato in attesa e l'ultimo thread che l'ha preso. Il
+ * ciclo principale ne stampa le statistiche ogni LOCK_REPORT_MS millisecondi, e un'ultima volta alla
+ * fine.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -31,6 +36,7 @@
 #include <stdio.h>
 #include <string>
 #include "colours.hpp"
+#include "LLockStats.hpp"
 
 
 /**************************************************************************************************
@@ -43,6 +49,8 @@ static constexpr int WINDOW_H        = 480; // Screen's heigth
 static constexpr int TRANSPARENCY    = 0x00;
 static constexpr int BYTES_PER_PIXEL = 4;
 
+static constexpr Uint32 LOCK_REPORT_MS = 1000; // Milliseconds between two lock reports
+
 static std::string Path("splash.png");
 
 /***************************************************************************************************
@@ -136,7 +144,7 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gSplashTexture;
 
-static SDL_sem* gDataLock = NULL; // Data access semaphore
+static LSemaphore* gDataLock = NULL; // Data access semaphore, instrumented
 static int      gData     = -1;   // The "data buffer"
 
 
@@ -589,11 +597,11 @@ static bool init(void)
  **/
 static bool loadMedia( void )
 {
-  gDataLock = SDL_CreateSemaphore( 1 ); // Initialize semaphore
+  gDataLock = new LSemaphore( 1, "gData semaphore" ); // Initialize semaphore
 
   bool success = true; // Loading success flag
 
-  if( gDataLock == NULL )
+  if( !gDataLock->isValid() )
   {
     printf( "\nFailed to create semaphore! SDL error: \"%s\"", SDL_GetError() );
     success = false;
@@ -624,7 +632,7 @@ static void close(void)
   gSplashTexture.free();
 
   // Free semaphore
-  SDL_DestroySemaphore( gDataLock );
+  delete gDataLock;
   gDataLock = NULL;
 
   // Destroy window
@@ -653,7 +661,7 @@ static int worker( void* data )
     SDL_Delay( 16 + rand() % 32 );
 
     // Lock
-    SDL_SemWait( gDataLock );
+    gDataLock->wait();
 
     // Print pre work data
     printf( "%s gets %d\n", static_cast<char*>(data), gData );
@@ -665,7 +673,7 @@ static int worker( void* data )
     printf( "%s sets %d\n\n", static_cast<char*>(data), gData );
 
     // Unlock
-    SDL_SemPost( gDataLock );
+    gDataLock->post();
 
     // Wait randomly
     SDL_Delay( 16 + rand() % 640 );
@@ -725,6 +733,9 @@ int main( int argc, char* args[] )
       // Main loop flag
       bool quit = false;
 
+      // Time of the last lock report
+      Uint32 LastReport = SDL_GetTicks();
+
       // Event handler
       SDL_Event e;
 
@@ -757,11 +768,22 @@ int main( int argc, char* args[] )
 
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        // Periodic report of the lock's contention
+        if( SDL_GetTicks() - LastReport >= LOCK_REPORT_MS )
+        {
+          gDataLock->logStats();
+          LastReport = SDL_GetTicks();
+        }
+        else { /* Not yet */ }
       }
 
       // Wait for threads to finish
       SDL_WaitThread( threadA, NULL );
       SDL_WaitThread( threadB, NULL );
+
+      // Final report
+      gDataLock->logStats();
     }
   }
 
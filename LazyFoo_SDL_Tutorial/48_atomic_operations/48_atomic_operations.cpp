@@ -14,6 +14,12 @@
  * semaphores can allow access beyond a single thread. Atomic operations are for when you want a
  * strict locked/unlocked state.
  *
+ * Aggiunta GS: il lock è un "LSpinLock" di Engine_Lib/LLockStats: uno spin lock con attesa
+ * esponenziale (1, 2, 4... istruzioni "pause" fra un tentativo e l'altro, poi cede il core), che
+ * conta le acquisizioni, quelle che hanno trovato il lock occupato, i tentativi falliti, il tempo
+ * passato ad aspettare e l'ultimo thread che l'ha preso. Il ciclo principale ne stampa le
+ * statistiche ogni LOCK_REPORT_MS millisecondi, e un'ultima volta alla fine.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -30,6 +36,7 @@
 #include <stdio.h>
 #include <string>
 #include "colours.hpp"
+#include "LLockStats.hpp"
 
 
 /**************************************************************************************************
@@ -42,6 +49,8 @@ static constexpr int WINDOW_H        = 480; // Screen's heigth
 static constexpr int TRANSPARENCY    = 0x00;
 static constexpr int BYTES_PER_PIXEL = 4;
 
+static constexpr Uint32 LOCK_REPORT_MS = 1000; // Milliseconds between two lock reports
+
 static std::string Path("splash.png");
 
 /***************************************************************************************************
@@ -135,8 +144,8 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gSplashTexture;
 
-static SDL_SpinLock gDataLock = 0;  // Data access spin lock
-static int          gData     = -1; // The "data buffer"
+static LSpinLock gDataLock( "gData spin lock" ); // Data access spin lock, instrumented
+static int       gData = -1;                     // The "data buffer"
 
 
 /***************************************************************************************************
@@ -637,7 +646,7 @@ static int worker( void* data )
     SDL_Delay( 16 + rand() % 32 );
 
     // Lock
-    SDL_AtomicLock( &gDataLock );
+    gDataLock.lock();
 
     // Print pre work data
     printf( "%s gets %d\n", static_cast<char*>(data), gData );
@@ -649,7 +658,7 @@ static int worker( void* data )
     printf( "%s sets %d\n\n", static_cast<char*>(data), gData );
 
     // Unlock
-    SDL_AtomicUnlock( &gDataLock );
+    gDataLock.unlock();
 
     // Wait randomly
     SDL_Delay( 16 + rand() % 640 );
@@ -709,6 +718,9 @@ int main( int argc, char* args[] )
       // Main loop flag
       bool quit = false;
 
+      // Time of the last lock report
+      Uint32 LastReport = SDL_GetTicks();
+
       // Event handler
       SDL_Event e;
 
@@ -741,11 +753,22 @@ int main( int argc, char* args[] )
 
         // Update screen
         SDL_RenderPresent( gRenderer );
+
+        // Periodic report of the lock's contention
+        if( SDL_GetTicks() - LastReport >= LOCK_REPORT_MS )
+        {
+          gDataLock.logStats();
+          LastReport = SDL_GetTicks();
+        }
+        else { /* Not yet */ }
       }
 
       // Wait for threads to finish
       SDL_WaitThread( threadA, NULL );
       SDL_WaitThread( threadB, NULL );
+
+      // Final report
+      gDataLock.logStats();
     }
   }
 
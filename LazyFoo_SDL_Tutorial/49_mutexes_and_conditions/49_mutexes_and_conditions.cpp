@@ -22,6 +22,13 @@
  * l'esecuzione. Ora il consumatore trova il mutex libero, e può finalmente consumare. Inoltre, può
  * inviare il segnale di via libera con "SDL_CondSignal".
  *
+ * Aggiunta GS: il buffer di un solo "int", con il suo mutex e le due condizioni, è sostituito da
+ * "LBlockingRing< LSpscRing<int> >" di Engine_Lib/LRingBuffer.hpp: una coda circolare lock-free per
+ * un produttore e un consumatore, con BUFFER_SIZE posti. Finché c'è posto (o ci sono dati) nessuno
+ * prende un lock; mutex e condizioni restano dentro la coda e servono solo al thread che deve
+ * davvero aspettare. Il consumatore preleva in un colpo tutti i dati pronti ("popBatch"), e il
+ * produttore, finito, chiude la coda ("close"): il consumatore esce quando l'ha svuotata.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022) and may not be
  * redistributed without written permission.
  **/
@@ -38,6 +45,7 @@
 #include <stdio.h>
 #include <string>
 #include "colours.hpp"
+#include "LRingBuffer.hpp"
 
 
 /**************************************************************************************************
@@ -50,6 +58,7 @@ static constexpr int WINDOW_H        = 480; // Screen's heigth
 static constexpr int TRANSPARENCY    = 0x00;
 static constexpr int BYTES_PER_PIXEL = 4;
 static constexpr int SCREEN_FPS      = 60;
+static constexpr int BUFFER_SIZE     = 4;   // Slots of the data buffer
 
 static std::string Path("splash.png");
 
@@ -134,7 +143,7 @@ static void close     (void);
 static int  Producer( void* data );
 static int  Consumer( void* data );
 static void Produce ( void );
-static void Consume ( void );
+static bool Consume ( void );
 
 
 /***************************************************************************************************
@@ -147,12 +156,8 @@ static SDL_Renderer* gRenderer = NULL; // The window renderer
 // Scene textures
 static LTexture gSplashTexture;
 
-static SDL_mutex* gBufferLock = NULL; // The protective mutex
-static int        gData       = -1;   // The "data buffer"
-
-// The conditions
-static SDL_cond* gCanProduce = NULL;
-static SDL_cond* gCanConsume = NULL;
+// The "data buffer": lock-free, blocking only when full or empty
+static LBlockingRing< LSpscRing<int> >* gBuffer = NULL;
 
 
 /***************************************************************************************************
@@ -604,12 +609,8 @@ static bool init(void)
  **/
 static bool loadMedia( void )
 {
-  // Create the mutex
-  gBufferLock = SDL_CreateMutex();
-
-  // Create conditions
-  gCanProduce = SDL_CreateCond();
-  gCanConsume = SDL_CreateCond();
+  // Create the buffer, with its mutex and conditions
+  gBuffer = new LBlockingRing< LSpscRing<int> >( BUFFER_SIZE );
 
   // Loading success flag
   bool success = true;
@@ -634,15 +635,9 @@ static void close(void)
   // Free loaded images
   gSplashTexture.free();
 
-  // Destroy the mutex
-  SDL_DestroyMutex( gBufferLock );
-  gBufferLock = NULL;
-
-  // Destroy conditions
-  SDL_DestroyCond( gCanProduce );
-  SDL_DestroyCond( gCanConsume );
-  gCanProduce = NULL;
-  gCanConsume = NULL;
+  // Destroy the buffer
+  delete gBuffer;
+  gBuffer = NULL;
 
   // Destroy window
   SDL_DestroyRenderer( gRenderer );
@@ -678,6 +673,9 @@ static int Producer( [[maybe_unused]] void *data )
     Produce();
   }
 
+  // Nothing more to come: lets the consumer finish
+  gBuffer->close();
+
   printf( "\nProducer finished!\n" );
 
   return 0;
@@ -697,14 +695,13 @@ static int Consumer( [[maybe_unused]] void *data )
   // Seed thread random
   srand( SDL_GetTicks() );
 
-  for( int i = 0; i != 5; ++i )
+  // Until the producer has closed the buffer and it is empty
+  do
   {
     // Wait
     SDL_Delay( rand() % 1000 );
-
-    // (Try to) consume
-    Consume();
   }
+  while( Consume() );
 
   printf( "\nConsumer finished!\n" );
 
@@ -714,53 +711,45 @@ static int Consumer( [[maybe_unused]] void *data )
 
 static void Produce(void)
 {
-  // Lock
-  SDL_LockMutex( gBufferLock );
+  const int Data = rand() % 255;
 
   // If the buffer is full
-  if( gData != -1 )
+  if( !gBuffer->tryPush( Data ) )
   {
-    // Wait for buffer to be cleared
-    printf( "\nProducer encountered full buffer. Wwaiting for consumer to empty buffer...\n" );
-    SDL_CondWait( gCanProduce, gBufferLock );
+    // Wait for the consumer to make room
+    printf( "\nProducer encountered full buffer. Waiting for consumer to empty buffer...\n" );
+    gBuffer->push( Data );
   }
-  else { /* Buffer is empty: proceed */ }
+  else { /* There was room: done */ }
 
-  // Fill and show buffer
-  gData = rand() % 255;
-  printf( "\nProduced %d\n", gData );
-
-  // Unlock
-  SDL_UnlockMutex( gBufferLock );
-
-  // Signal consumer
-  SDL_CondSignal( gCanConsume );
+  printf( "\nProduced %d\n", Data );
 }
 
 
-static void Consume(void)
+/**
+ * @brief Takes all the data in the buffer at once, waiting for some if it is empty.
+ *
+ * @return false once the buffer is closed and empty
+ **/
+static bool Consume(void)
 {
-  // Lock
-  SDL_LockMutex( gBufferLock );
+  int Data[ BUFFER_SIZE ];
 
   // If the buffer is empty
-  if( gData == -1 )
+  if( gBuffer->GetRing().GetSize() == 0 && !gBuffer->isClosed() )
   {
-    // Wait for buffer to be filled
     printf( "\nConsumer encountered empty buffer. Waiting for producer to fill buffer...\n" );
-    SDL_CondWait( gCanConsume, gBufferLock );
   }
-  else { /* Buffer is full: proceed */ }
+  else { /* Buffer has data: proceed */ }
 
-  // Show and empty buffer
-  printf( "\nConsumed %d\n", gData );
-  gData = -1;
+  const size_t Count = gBuffer->popBatch( Data, BUFFER_SIZE );
 
-  // Unlock
-  SDL_UnlockMutex( gBufferLock );
+  for( size_t i = 0; i != Count; ++i )
+  {
+    printf( "\nConsumed %d\n", Data[i] );
+  }
 
-  // Signal producer
-  SDL_CondSignal( gCanProduce );
+  return Count != 0;
 }
 
 
@@ -3,6 +3,11 @@
  *
  * @brief https://lazyfoo.net/tutorials/SDL/50_SDL_and_opengl_2/index.php
  *
+ * Aggiunta GS: la quad è registrata una sola volta, in "initGL", in una display list (gQuadList), e
+ * "render" la disegna con un solo glCallList invece di ripetere glBegin, i quattro vertici e glEnd a
+ * ogni frame: il driver la conserva già pronta. Matrici e colore di sfondo erano e restano impostati
+ * solo in "initGL".
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022) and may not be
  * redistributed without written permission.
  **/
@@ -49,6 +54,7 @@ static void close     (void); // Frees media and shuts down SDL
 static SDL_Window*   gWindow = NULL; // The window we'll be rendering to
 static SDL_GLContext gContext; // OpenGL context
 static bool          gRenderQuad = true; // Render flag
+static GLuint        gQuadList = 0; // Display list drawing the quad, compiled once
 
 
 /***************************************************************************************************
@@ -181,6 +187,28 @@ static bool initGL(void)
     printf( "\nOK: clear colour initialised" );
   }
 
+  // Compile the quad once
+  gQuadList = glGenLists( 1 );
+
+  if( gQuadList == 0 )
+  {
+    printf( "Error initializing OpenGL! %s\n", gluErrorString( glGetError() ) );
+    success = false;
+  }
+  else
+  {
+    glNewList( gQuadList, GL_COMPILE );
+      glBegin( GL_QUADS );
+        glVertex2f( -0.5f, -0.5f );
+        glVertex2f(  0.5f, -0.5f );
+        glVertex2f(  0.5f,  0.5f );
+        glVertex2f( -0.5f,  0.5f );
+      glEnd();
+    glEndList();
+
+    printf( "\nOK: quad display list compiled" );
+  }
+
   return success;
 }
 
@@ -213,18 +241,21 @@ static void render(void)
   // Render quad
   if( gRenderQuad )
   {
-    glBegin( GL_QUADS );
-      glVertex2f( -0.5f, -0.5f );
-      glVertex2f(  0.5f, -0.5f );
-      glVertex2f(  0.5f,  0.5f );
-      glVertex2f( -0.5f,  0.5f );
-    glEnd();
+    glCallList( gQuadList );
   }
 }
 
 
 static void close(void)
 {
+  // Free the display list, while the context is still there
+  if( gQuadList != 0 )
+  {
+    glDeleteLists( gQuadList, 1 );
+    gQuadList = 0;
+  }
+  else { /* Never compiled */ }
+
   // Destroy window
   SDL_DestroyWindow( gWindow );
   gWindow = NULL;
@@ -20,6 +20,94 @@
  * After we get the shader program working, we create the VBO and IBO. The VBO has the same
  * positions as the quad from the last tutorial.
  *
+ * Aggiunta GS: simulazione di particelle interamente su GPU. Lo stato delle particelle vive in due
+ * buffer object usati a ping-pong; ogni frame un vertex shader lo fa avanzare con il transform
+ * feedback (senza rasterizzazione), e un secondo programma lo legge come texture buffer e disegna
+ * una quad per particella con una sola chiamata instanced. La CPU non tocca mai i dati delle
+ * singole particelle: passa solo il tempo trascorso e la posizione del mouse (l'emettitore).
+ * Tasto 'p' per mostrare/nascondere le particelle.
+ *
+ * Aggiunta GS: testo scalabile con un campo di distanze ("LSdfFont" di Engine_Lib). Il font viene
+ * aperto una sola volta, a una dimensione base, e ogni glifo viene salvato nell'atlante come
+ * distanza dal proprio contorno anziché come copertura; dopodiché il font si chiude. Uno shader
+ * confronta la distanza con la soglia del contorno, sfumando su un pixel dello schermo, così lo
+ * stesso atlante disegna testo nitido a qualsiasi dimensione, senza riaprire il font né
+ * rasterizzare di nuovo. Tutto il testo del frame viene disegnato con una sola chiamata. Tasto 't'
+ * per mostrare/nascondere il testo, '+' e '-' per ingrandirlo e rimpicciolirlo.
+ *
+ * Aggiunta GS: sprite disegnati in OpenGL anziché con SDL_Renderer, che costa una chiamata per
+ * ogni copia e si ferma a qualche migliaio di sprite. "LGLTexture" (LGLSpriteRenderer.hpp, in questa
+ * cartella) ha gli stessi metodi di LTexture, "render" compreso, ma copia l'immagine in una pagina
+ * di atlante condivisa e si limita ad accodare lo sprite. "LGLSpriteRenderer" alla fine del frame
+ * ordina la coda per livello, blend mode e pagina, e disegna ogni gruppo con una sola chiamata, da
+ * un buffer mappato una volta per tutte (persistent mapping, se il driver lo permette) e diviso in
+ * tre parti, una per frame, protette da fence. Dove il driver ha gli instanced arrays, ogni sprite
+ * occupa nel buffer una sola istanza (posizione, clip, colore, rotazione) e glDrawElementsInstanced
+ * ripete la stessa quad per tutte, ruotata e ritagliata dal vertex shader; altrimenti la CPU scrive
+ * i quattro vertici. Qui i tile di 39 su un livello inferiore, più 20000 sprite, metà con blending
+ * normale e metà additivo, richiedono tre chiamate. Tasto 's' per mostrare/nascondere gli sprite,
+ * 'i' per passare da instanced a quad e viceversa.
+ *
+ * Aggiunta GS: minimappa dei tile, quattro volte più piccola, nell'angolo in basso a destra (tasto
+ * 'm'). Disegnata a piena risoluzione, ogni pixel leggerebbe un texel ogni quattro, saltando gli
+ * altri: più memoria letta del necessario e tile che tremolano. Le pagine dell'atlante hanno ora tre
+ * livelli di mipmap, ciascuno metà del precedente, e la GPU campiona quello più vicino alla dimensione
+ * a schermo (filtro trilineare). I livelli sono calcolati sulla CPU quando l'immagine entra
+ * nell'atlante ("HalvePixels" di Engine_Lib/LPixelOps, con i colori pesati dall'alfa, così il ciano
+ * trasparente non sbava sui bordi), e ogni immagine occupa un blocco allineato a un texel del
+ * livello più piccolo, con un bordo altrettanto largo, perché nessun livello mescoli due immagini.
+ *
+ * Aggiunta GS: texture compresse a blocchi. "BakeTextures --compress=bc" (desktop) o "--compress=etc2"
+ * (OpenGL ES) scrive accanto all'immagine un file ".ltc" con i blocchi di 4x4 texel già nel formato
+ * che la GPU campiona direttamente: BC1/ETC2 RGB per le immagini opache o con trasparenza a colore
+ * chiave, BC3/ETC2 RGBA per quelle con alfa sfumato, con i livelli di mipmap se "--mips". Se il
+ * driver supporta il formato, "LGLTexture::loadFromFile" carica i blocchi così come sono in una
+ * pagina a parte (glCompressedTexImage2D): da un quarto a un ottavo della memoria video e nessuna
+ * decodifica al caricamento. Altrimenti, o senza ".ltc", l'immagine è decodificata come prima. La
+ * memoria delle pagine è stampata all'avvio.
+ *
+ * Aggiunta GS: texture a colori indicizzati. "LGLTexture::loadIndexedFromFile" tiene l'immagine come
+ * indici di 8 bit in una tavolozza dei suoi colori ("IndexPixels" di Engine_Lib/LPixelOps, fino a
+ * 256 colori): la pagina è a un solo canale (GL_R8), un quarto della memoria, e il fragment shader
+ * legge il colore nella riga della tavolozza scelta dallo sprite, in una texture di 256 tavolozze.
+ * Cambiare tavolozza non ricarica nulla: qui il punto usa la sua o una copia ricolorata in arancione
+ * (ORANGE di colours.hpp), tasto 'c', e gli sprite delle due tavolozze restano nella stessa chiamata.
+ *
+ * Aggiunta GS: gli shader non sono più stringhe nel sorgente ma file nella cartella "shaders",
+ * caricati da "LGLShaderManager" (LGLShaderManager.hpp, in questa cartella). Dove il driver lo
+ * permette, il binario di ogni programma linkato viene salvato accanto agli shader, con una chiave
+ * calcolata da driver e sorgenti, e riusato agli avvii successivi al posto di compilazione e link.
+ * Durante l'esecuzione i file vengono riletti ogni mezzo secondo: un programma modificato viene
+ * ricostruito al volo, e "takePrograms" ne riprende locazioni e uniform. Se non compila, il log
+ * viene stampato e resta in uso il programma precedente.
+ *
+ * Aggiunta GS: tempo GPU per passata, misurato da "LGLGpuProfiler" (LGLGpuProfiler.hpp, in questa
+ * cartella) con query GL_TIME_ELAPSED attorno a quad, aggiornamento e disegno delle particelle,
+ * tile e sprite (un solo flush, quindi una sola passata) e testo, che fa da interfaccia. Le query
+ * sono doppie: i risultati vengono letti due frame dopo, quando la GPU li ha già pronti, senza mai
+ * fermare la CPU. Accanto, in "LFrameStats", il tempo CPU di update e render, swap escluso. Una
+ * riga di testo confronta i due (99° percentile): se il tempo GPU si avvicina a quello del frame,
+ * il collo di bottiglia è la GPU. Tasto 'g' per salvare in "gpu_profile.csv" minimo, media,
+ * 99° percentile e massimo di CPU, di ogni passata e del totale GPU.
+ *
+ * Aggiunta GS: registrazione dei frame con "--capture=<file>", per le sessioni di QA. Dopo il disegno
+ * "LGLFrameCapture" (LGLFrameCapture.hpp, in questa cartella) avvia la copia del back buffer in un
+ * pixel buffer object, senza attenderla, e copia quello riempito al frame precedente, ormai pronto,
+ * in un buffer di "LFrameEncoder" (Engine_Lib), che su un thread a parte scrive una sequenza di PNG
+ * ("<file>_000000.png", ...) o, se il nome finisce in ".raw", un unico file video grezzo. Se il disco
+ * resta indietro i frame vengono scartati e contati, mai attesi: il render thread non si ferma.
+ *
+ * Aggiunta GS: stato OpenGL in cache. Ogni passata prima impostava programma, vertex attribute e
+ * buffer, e alla fine li azzerava, anche quando la passata successiva rimetteva gli stessi valori.
+ * "LGLStateCache" (LGLStateCache.hpp, in questa cartella) ricorda programma, vertex array, array
+ * buffer, texture delle prime unità e blending impostati per ultimi, e salta le chiamate che non
+ * cambierebbero nulla; le passate non azzerano più niente. La quad ha ora un VAO, creato una volta in
+ * "initGL" con VBO, IBO e attributo, e l'aggiornamento delle particelle un VAO per buffer di stato:
+ * a ogni frame resta solo il bind. Anche "LGLSpriteRenderer" usa la stessa cache ("setStateCache").
+ * Quando un programma viene ricostruito la cache viene invalidata, perché il nome di quello
+ * cancellato può essere riassegnato. Una riga di testo mostra le chiamate fatte e saltate nel frame
+ * precedente.
+ *
  * @copyright This source code copyrighted by Lazy Foo' Productions (2004-2022)
  * and may not be redistributed without written permission.
  **/
@@ -31,12 +119,26 @@
 
 // Using SDL, SDL OpenGL, GLEW, standard I/O, and strings
 #include <SDL.h>
+#include <SDL_ttf.h>
 #include <glew.h>
 #include <SDL_opengl.h>
 #include <GL/glu.h>
 #include <stdio.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <vector>
 #include "colours.hpp"
+#include "LSdfFont.hpp"
+#include "LGLSpriteRenderer.hpp"
+#include "LGLShaderManager.hpp"
+#include "LGLGpuProfiler.hpp"
+#include "LGLFrameCapture.hpp"
+#include "LGLStateCache.hpp"
+#include "LFrameStats.hpp"
+#include "LTimer.hpp"
 
 
 /**************************************************************************************************
@@ -46,6 +148,65 @@
 static constexpr int WINDOW_W = 640;
 static constexpr int WINDOW_H = 480;
 
+// GPU particles: count, and floats of state per particle (two vec4: position / velocity, then
+// age / lifetime / seed / unused)
+static constexpr GLsizei GPU_PARTICLES      = 1 << 20;
+static constexpr GLsizei PARTICLE_FLOATS    = 8;
+static constexpr GLsizei PARTICLE_STRIDE    = PARTICLE_FLOATS * sizeof(GLfloat);
+static constexpr float   MAX_FRAME_TIME_s   = 0.1f; // Longer frames are clamped, e.g. while dragging the window
+
+// Shaders, loaded by gShaders from these files; their linked binaries are cached next to them
+static const std::string QuadVertexPath           ( "shaders/quad.vert" );
+static const std::string QuadFragmentPath         ( "shaders/quad.frag" );
+static const std::string ParticleUpdatePath       ( "shaders/particle_update.vert" );
+static const std::string ParticleDrawVertexPath   ( "shaders/particle_draw.vert" );
+static const std::string ParticleDrawFragmentPath ( "shaders/particle_draw.frag" );
+static const std::string TextVertexPath           ( "shaders/text.vert" );
+static const std::string TextFragmentPath         ( "shaders/text.frag" );
+
+// SDF text: the font is opened once, at the base size, to bake the atlas
+static const std::string FontPath ( "lazy.ttf" );
+
+static constexpr int   SDF_BASE_SIZE   = 48;    // Points
+static constexpr float TEXT_SCALE_STEP = 1.25f; // '+' and '-'
+static constexpr float MIN_TEXT_SCALE  = 0.25f;
+static constexpr float MAX_TEXT_SCALE  = 4.f;
+
+
+// Sprites: the same image twice, blended normally and additively, bouncing in the window
+static const std::string SpritePath ( "dot.bmp" );
+
+static constexpr int   SPRITE_COUNT     = 20000;
+static constexpr int   GLOW_SIZE        = 32;      // Texels a side of the generated glow
+static constexpr float SPRITE_MAX_SPEED = 200.f;   // Pixels per second
+static constexpr float SPRITE_SPIN      = 90.f;    // Degrees per second, glows only
+
+// Tiles: 39's tileset, walls round the window and floor inside, under the sprites
+static const std::string TilesPath ( "tiles.png" );
+
+static constexpr int TILE_SIZE = 80;               // Pixels a side, in the tileset and on screen
+
+// Minimap: the same tile map, MINIMAP_SCALE times smaller, in the bottom right corner; sampled from
+// the mip levels of the atlas pages
+static constexpr int SPRITE_MIP_LEVELS = 3;
+static constexpr int MINIMAP_SCALE     = 4;
+static constexpr int MINIMAP_MARGIN    = 8;        // Pixels from the edges of the window
+
+// GPU and CPU times, saved by 'g'
+static const std::string GpuProfilePath ( "gpu_profile.csv" );
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+struct SpriteState
+{
+  float X, Y;
+  float VelX, VelY;
+  float Angle;
+};
+
 
 /***************************************************************************************************
 * Private prototypes
@@ -58,9 +219,29 @@ static void update    (void); // Per frame update
 static void render    (void); // Renders quad to the screen
 static void close     (void); // Frees media and shuts down SDL
 
-// Shader loading utility programs
-static void printProgramLog( GLuint program );
-static void printShaderLog ( GLuint shader );
+// Shaders
+static void   takePrograms     (void);
+static void   takeQuadProgram  (void);
+
+// GPU particles
+static bool   initParticlesGL  (void);
+static void   takeParticlePrograms(void);
+static void   updateParticles  ( float deltaTime );
+static void   renderParticles  (void);
+static void   closeParticlesGL (void);
+
+// SDF text
+static bool   initTextGL       (void);
+static void   takeTextProgram  (void);
+static void   renderText       (void);
+static void   closeTextGL      (void);
+
+// Sprites
+static bool   initSpritesGL    (void);
+static void   updateSprites    ( float deltaTime );
+static void   renderSprites    (void);
+static void   closeSpritesGL   (void);
+static void   renderTiles      ( Sint16 layer, int left, int top, int tileSize );
 
 
 /***************************************************************************************************
@@ -71,12 +252,74 @@ static SDL_Window*   gWindow = NULL; // The window we'll be rendering to
 static SDL_GLContext gContext; // OpenGL context
 static bool          gRenderQuad = true; // Render flag
 
+// Bindings and blending set by every pass, the sprites included: each pass skips what the previous left
+static LGLStateCache gState;
+static Uint32        gStateIssued  = 0; // Calls of the previous frame, for the text
+static Uint32        gStateSkipped = 0;
+
+// Shaders: every program, rebuilt when its files change, and the handles of ours
+static LGLShaderManager gShaders;
+static int              gQuadShaders           = -1;
+static int              gParticleUpdateShaders = -1;
+static int              gParticleDrawShaders   = -1;
+static int              gTextShaders           = -1;
+
 // Graphics program
 static GLuint gProgramID           =  0;
 static GLint  gVertexPos2DLocation = -1;
+static GLuint gQuadVAO             =  0; // Buffers and layout of the quad, set once
 static GLuint gVBO                 =  0;
 static GLuint gIBO                 =  0;
 
+// GPU particles: two state buffers, read and written alternately, each with its texture buffer view
+// and a vertex array reading it for the update
+static GLuint gParticleVAO                     = 0; // Drawing, without attributes
+static GLuint gParticleUpdateVAOs     [ 2 ]    = { 0, 0 };
+static GLuint gParticleBuffers        [ 2 ]    = { 0, 0 };
+static GLuint gParticleTextures       [ 2 ]    = { 0, 0 };
+static int    gParticleCurrent                 = 0; // Buffer holding the latest state
+static GLuint gParticleUpdateProgramID         = 0;
+static GLuint gParticleDrawProgramID           = 0;
+static GLint  gParticlePosVelLocation          = -1;
+static GLint  gParticleAgeLifeSeedLocation     = -1;
+static GLint  gParticleDeltaTimeLocation       = -1;
+static GLint  gParticleEmitterLocation         = -1;
+static bool   gRenderParticles                 = true;
+
+// SDF text: the baked atlas, its texture, and the quads of the frame, all drawn by one call
+static LSdfFont                gSdfFont;
+static GLuint                  gTextProgramID         = 0;
+static GLuint                  gTextVAO               = 0;
+static GLuint                  gTextVBO               = 0;
+static GLuint                  gTextTexture           = 0;
+static GLint                   gTextVertexPosLocation = -1;
+static GLint                   gTextTexCoordLocation  = -1;
+static std::vector<LSdfVertex> gTextVertices; // Reused every frame
+static float                   gTextScale             = 1.f;
+static bool                    gRenderText            = true;
+
+// Sprites: the renderer with its atlas, the textures in it, and where every sprite is
+static LGLSpriteRenderer        gSprites;
+static LGLTexture               gDotTexture;
+static LGLTexture               gGlowTexture;
+static LGLTexture               gTilesTexture;
+static int                      gDotPalettes[ 2 ]      = { 0, 0 }; // Its own colours, and recoloured
+static std::vector<SpriteState> gSpriteStates;
+static bool                     gRenderSprites         = true;
+static bool                     gRenderMinimap         = true;
+
+// GPU time of every pass, and CPU time of update and render
+static LGLGpuProfiler gGpuProfiler;
+static int            gQuadPass           = -1;
+static int            gParticleUpdatePass = -1;
+static int            gParticlePass       = -1;
+static int            gSpritePass         = -1;
+static int            gTextPass           = -1;
+static LFrameStats    gCpuStats;
+
+// Frames recorded with "--capture=<file>"
+static LGLFrameCapture gCapture;
+
 
 /***************************************************************************************************
 * Private functions definitions
@@ -93,9 +336,14 @@ static bool init(void)
     printf( "SDL could not initialize! SDL Error: %s\n", SDL_GetError() );
     success = false;
   }
+  else if( TTF_Init() == -1 )
+  {
+    printf( "SDL_ttf could not initialize! SDL_ttf Error: %s\n", TTF_GetError() );
+    success = false;
+  }
   else
   {
-    printf( "\nOK: SDL initialised" );
+    printf( "\nOK: SDL and SDL_ttf initialised" );
 
     // Use OpenGL 3.1 core
     SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 3 );
@@ -172,127 +420,114 @@ static bool initGL(void)
   // Success flag
   bool success = true;
 
-  // Generate shader program
-  gProgramID = glCreateProgram();
-
-  // Create vertex shader
-  GLuint vertexShader = glCreateShader( GL_VERTEX_SHADER );
+  // Programs come from the files under "shaders", or from their binaries cached by an earlier launch
+  gShaders.init();
+  gQuadShaders = gShaders.add( "quad", QuadVertexPath, QuadFragmentPath );
 
-  // Get vertex source
-  const GLchar* vertexShaderSource[] =
+  if( gQuadShaders == -1 )
   {
-    "#version 140\nin vec2 LVertexPos2D; void main() { gl_Position = vec4( LVertexPos2D.x, LVertexPos2D.y, 0, 1 ); }"
-  };
-
-  // Set vertex source
-  glShaderSource( vertexShader, 1, vertexShaderSource, NULL );
-
-  // Compile vertex source
-  glCompileShader( vertexShader );
-
-  // Check vertex shader for errors
-  GLint vShaderCompiled = GL_FALSE;
-  glGetShaderiv( vertexShader, GL_COMPILE_STATUS, &vShaderCompiled );
-
-  if( vShaderCompiled != GL_TRUE )
-  {
-    printf( "\nUnable to compile vertex shader %d!", vertexShader );
-    printShaderLog( vertexShader );
+    printf( "\nUnable to build the quad program!" );
     success = false;
   }
   else
   {
-    printf( "\nOK: vertex shader compiled" );
-
-    // Attach vertex shader to program
-    glAttachShader( gProgramID, vertexShader );
-
-    // Create fragment shader
-    GLuint fragmentShader = glCreateShader( GL_FRAGMENT_SHADER );
-
-    // Get fragment source
-    const GLchar* fragmentShaderSource[] =
-    {
-      "#version 140\nout vec4 LFragment; void main() { LFragment = vec4( 1.0, 1.0, 1.0, 1.0 ); }"
-    };
+    printf( "\nOK: program linked, program binaries %s", gShaders.IsCaching() ? "cached" : "not available" );
 
-    // Set fragment source
-    glShaderSource( fragmentShader, 1, fragmentShaderSource, NULL );
+    // Get vertex attribute location
+    takePrograms();
 
-    // Compile fragment source
-    glCompileShader( fragmentShader );
-
-    // Check fragment shader for errors
-    GLint fShaderCompiled = GL_FALSE;
-    glGetShaderiv( fragmentShader, GL_COMPILE_STATUS, &fShaderCompiled );
-
-    if( fShaderCompiled != GL_TRUE )
+    if( gVertexPos2DLocation == -1 )
     {
-      printf( "\nUnable to compile fragment shader %d!", fragmentShader );
-      printShaderLog( fragmentShader );
+      printf( "LVertexPos2D is not a valid glsl program variable!\n" );
       success = false;
     }
     else
     {
-      printf( "\nOK: fragment shader compiled" );
+      printf( "\nOK: LVertexPos2D is a valid glsl program variable" );
 
-      // Attach fragment shader to program
-      glAttachShader( gProgramID, fragmentShader );
+      // Initialize clear color
+      glClearColor( 0.f, 0.f, 0.f, 1.f );
 
-      // Link program
-      glLinkProgram( gProgramID );
+      // VBO data
+      GLfloat vertexData[] =
+      {
+        -0.5f, -0.5f,
+         0.5f, -0.5f,
+         0.5f,  0.5f,
+        -0.5f,  0.5f
+      };
+
+      // IBO data
+      GLuint indexData[] = { 0, 1, 2, 3 };
+
+      // Create VAO: it keeps the IBO and the vertex layout, so that drawing only binds it
+      glGenVertexArrays( 1, &gQuadVAO );
+      gState.bindVertexArray( gQuadVAO );
+
+      // Create VBO
+      glGenBuffers( 1, &gVBO );
+      gState.bindArrayBuffer( gVBO );
+      glBufferData( GL_ARRAY_BUFFER, 2 * 4 * sizeof(GLfloat), vertexData, GL_STATIC_DRAW );
+
+      // Create IBO
+      glGenBuffers( 1, &gIBO );
+      glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, gIBO );
+      glBufferData( GL_ELEMENT_ARRAY_BUFFER, 4 * sizeof(GLuint), indexData, GL_STATIC_DRAW );
+
+      // Enable vertex position, and set vertex data
+      glEnableVertexAttribArray( gVertexPos2DLocation );
+      glVertexAttribPointer( gVertexPos2DLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), NULL );
+
+      // The quad works without particles
+      if( !initParticlesGL() )
+      {
+        printf( "\nGPU particles not available" );
+      }
+      else
+      {
+        printf( "\nOK: %d GPU particles ready", GPU_PARTICLES );
+      }
 
-      // Check for errors
-      GLint programSuccess = GL_TRUE;
-      glGetProgramiv( gProgramID, GL_LINK_STATUS, &programSuccess );
+      // The quad works without text
+      if( !initTextGL() )
+      {
+        printf( "\nSDF text not available" );
+      }
+      else
+      {
+        printf( "\nOK: SDF atlas baked, %dx%d texels", gSdfFont.GetWidth(), gSdfFont.GetHeight() );
+      }
 
-      if( programSuccess != GL_TRUE )
+      // The quad works without sprites
+      if( !initSpritesGL() )
       {
-        printf( "\nError linking program %d!", gProgramID );
-        printProgramLog( gProgramID );
-        success = false;
+        printf( "\nSprites not available" );
       }
       else
       {
-        printf( "\nOK: program linked" );
+        printf( "\nOK: %d sprites ready, vertex buffer %s, %s, %u KB of pages, block compression%s%s", SPRITE_COUNT,
+                gSprites.IsPersistent() ? "persistently mapped" : "mapped every frame",
+                gSprites.IsInstanced() ? "instanced" : "quads only",
+                static_cast<unsigned>( gSprites.GetTextureBytes() / 1024 ),
+                gSprites.IsBlockFormatSupported( LBlockFormat::BC1 ) ? " BC" : "",
+                gSprites.IsBlockFormatSupported( LBlockFormat::ETC2_RGB ) ? " ETC2" : "" );
+      }
 
-        // Get vertex attribute location
-        gVertexPos2DLocation = glGetAttribLocation( gProgramID, "LVertexPos2D" );
+      printf( "\nOK: %d programs loaded from their cached binaries", gShaders.GetCacheHits() );
 
-        if( gVertexPos2DLocation == -1 )
-        {
-          printf( "LVertexPos2D is not a valid glsl program variable!\n" );
-          success = false;
-        }
-        else
-        {
-          printf( "\nOK: LVertexPos2D is a valid glsl program variable" );
-
-          // Initialize clear color
-          glClearColor( 0.f, 0.f, 0.f, 1.f );
-
-          // VBO data
-          GLfloat vertexData[] =
-          {
-            -0.5f, -0.5f,
-             0.5f, -0.5f,
-             0.5f,  0.5f,
-            -0.5f,  0.5f
-          };
-
-          // IBO data
-          GLuint indexData[] = { 0, 1, 2, 3 };
-
-          // Create VBO
-          glGenBuffers( 1, &gVBO );
-          glBindBuffer( GL_ARRAY_BUFFER, gVBO );
-          glBufferData( GL_ARRAY_BUFFER, 2 * 4 * sizeof(GLfloat), vertexData, GL_STATIC_DRAW );
-
-          // Create IBO
-          glGenBuffers( 1, &gIBO );
-          glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, gIBO );
-          glBufferData( GL_ELEMENT_ARRAY_BUFFER, 4 * sizeof(GLuint), indexData, GL_STATIC_DRAW );
-        }
+      // Everything works without GPU times
+      if( !gGpuProfiler.init() )
+      {
+        printf( "\nGPU timer queries not available" );
+      }
+      else
+      {
+        gQuadPass           = gGpuProfiler.addPass( "quad" );
+        gParticleUpdatePass = gGpuProfiler.addPass( "particle update" );
+        gParticlePass       = gGpuProfiler.addPass( "particles" );
+        gSpritePass         = gGpuProfiler.addPass( "tiles and sprites" );
+        gTextPass           = gGpuProfiler.addPass( "text" );
+        printf( "\nOK: GPU profiler ready, %u passes", static_cast<unsigned>( gGpuProfiler.GetPassCount() ) );
       }
     }
   }
@@ -301,6 +536,59 @@ static bool initGL(void)
 }
 
 
+/**
+ * @brief Takes the programs from gShaders, with their locations and the uniforms that never change:
+ * at start-up, and every time a shader file is edited, as a rebuilt program starts afresh.
+ **/
+static void takePrograms(void)
+{
+  // The programs replaced are deleted, and a new object may get the name of one still in use
+  gState.invalidate();
+
+  takeQuadProgram();
+
+  if( gParticleVAO != 0 )
+  {
+    takeParticlePrograms();
+  }
+  else { /* Particles not available */ }
+
+  if( gTextVAO != 0 )
+  {
+    takeTextProgram();
+  }
+  else { /* Text not available */ }
+}
+
+
+/**
+ * @brief Takes the quad program, and points the quad's vertex array at its position once the array
+ * exists: a rebuilt program may have placed it elsewhere.
+ **/
+static void takeQuadProgram(void)
+{
+  gProgramID = gShaders.GetProgram( gQuadShaders );
+
+  if( gQuadVAO != 0 && gVertexPos2DLocation != -1 )
+  {
+    gState.bindVertexArray( gQuadVAO );
+    glDisableVertexAttribArray( gVertexPos2DLocation );
+  }
+  else { /* Set up by initGL */ }
+
+  gVertexPos2DLocation = glGetAttribLocation( gProgramID, "LVertexPos2D" );
+
+  if( gQuadVAO != 0 && gVertexPos2DLocation != -1 )
+  {
+    gState.bindVertexArray( gQuadVAO );
+    gState.bindArrayBuffer( gVBO );
+    glEnableVertexAttribArray( gVertexPos2DLocation );
+    glVertexAttribPointer( gVertexPos2DLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), NULL );
+  }
+  else { /*  */ }
+}
+
+
 static void handleKeys( unsigned char key, [[maybe_unused]] int x, [[maybe_unused]] int y )
 {
   // Toggle quad
@@ -308,127 +596,696 @@ static void handleKeys( unsigned char key, [[maybe_unused]] int x, [[maybe_unuse
   {
     gRenderQuad = !gRenderQuad;
   }
+  else if( key == 'p' )
+  {
+    gRenderParticles = !gRenderParticles;
+  }
+  else if( key == 't' )
+  {
+    gRenderText = !gRenderText;
+  }
+  else if( key == 's' )
+  {
+    gRenderSprites = !gRenderSprites;
+  }
+  else if( key == 'i' )
+  {
+    gSprites.setInstanced( !gSprites.IsInstanced() );
+  }
+  else if( key == 'm' )
+  {
+    gRenderMinimap = !gRenderMinimap;
+  }
+  else if( key == 'c' )
+  {
+    gDotTexture.setPalette( ( gDotTexture.getPalette() == gDotPalettes[ 0 ] ) ? gDotPalettes[ 1 ] : gDotPalettes[ 0 ] );
+  }
+  else if( key == 'g' )
+  {
+    if( gGpuProfiler.save( GpuProfilePath, gCpuStats ) )
+    {
+      printf( "\nGPU and CPU times saved to %s, %u results not ready in time", GpuProfilePath.c_str(), gGpuProfiler.GetMissed() );
+    }
+    else { /*  */ }
+  }
+  else if( key == '+' )
+  {
+    gTextScale = SDL_min( gTextScale * TEXT_SCALE_STEP, MAX_TEXT_SCALE );
+  }
+  else if( key == '-' )
+  {
+    gTextScale = SDL_max( gTextScale / TEXT_SCALE_STEP, MIN_TEXT_SCALE );
+  }
   else { /*  */ }
 }
 
 
 /**
- * @brief the update handler is just there for compatibility's sake
+ * @brief Rebuilds the programs whose shader files changed, and advances the GPU particles by the
+ * time elapsed since the previous frame.
  **/
 static void update(void)
 {
-  // No per frame update needed
+  static Uint64 previousCounter = SDL_GetPerformanceCounter();
+
+  const Uint64 counter = SDL_GetPerformanceCounter();
+  float deltaTime = static_cast<float>( counter - previousCounter ) / static_cast<float>( SDL_GetPerformanceFrequency() );
+  previousCounter = counter;
+
+  deltaTime = SDL_min( deltaTime, MAX_FRAME_TIME_s );
+
+  // Shader files edited since the last look
+  if( gShaders.poll() )
+  {
+    takePrograms();
+  }
+  else { /* Same programs */ }
+
+  if( gParticleUpdateProgramID != 0 )
+  {
+    gGpuProfiler.begin( gParticleUpdatePass );
+    updateParticles( deltaTime );
+    gGpuProfiler.end();
+  }
+  else { /* Particles not available */ }
+
+  updateSprites( deltaTime );
 }
 
 
 static void render(void)
 {
+  // State calls of the previous frame, shown by the text of this one
+  gStateIssued  = gState.GetIssued();
+  gStateSkipped = gState.GetSkipped();
+  gState.resetCounters();
+
   // Clear color buffer
   glClear( GL_COLOR_BUFFER_BIT );
 
   // Render quad
   if( gRenderQuad )
   {
-    // Bind program
-    glUseProgram( gProgramID );
+    gGpuProfiler.begin( gQuadPass );
 
-    // Enable vertex position
-    glEnableVertexAttribArray( gVertexPos2DLocation );
+    // Bind program and VAO, which holds vertex and index data; the text left blending on
+    gState.useProgram( gProgramID );
+    gState.bindVertexArray( gQuadVAO );
+    gState.setBlend( false );
 
-    // Set vertex data
-    glBindBuffer( GL_ARRAY_BUFFER, gVBO );
-    glVertexAttribPointer( gVertexPos2DLocation, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), NULL );
-
-    // Set index data and render
-    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, gIBO );
+    // Render
     glDrawElements( GL_TRIANGLE_FAN, 4, GL_UNSIGNED_INT, NULL );
 
-    // Disable vertex position
-    glDisableVertexAttribArray( gVertexPos2DLocation );
+    gGpuProfiler.end();
+  }
 
-    // Unbind program
-    glUseProgram( NULL );
+  // Render particles
+  if( gRenderParticles && gParticleDrawProgramID != 0 )
+  {
+    gGpuProfiler.begin( gParticlePass );
+    renderParticles();
+    gGpuProfiler.end();
   }
+  else { /*  */ }
+
+  // Render sprites
+  if( gRenderSprites )
+  {
+    gGpuProfiler.begin( gSpritePass );
+    renderSprites();
+    gGpuProfiler.end();
+  }
+  else { /*  */ }
+
+  // Render text, over everything else
+  if( gRenderText && gTextProgramID != 0 )
+  {
+    gGpuProfiler.begin( gTextPass );
+    renderText();
+    gGpuProfiler.end();
+  }
+  else { /*  */ }
 }
 
 
 static void close(void)
 {
-  // Deallocate program
-  glDeleteProgram( gProgramID );
+  // Write the last frames captured, while the context is still there
+  gCapture.stop();
+
+  // Deallocate particles, text and sprites
+  closeParticlesGL();
+  closeTextGL();
+  closeSpritesGL();
+  gGpuProfiler.free();
+
+  // Deallocate quad and programs
+  glDeleteBuffers( 1, &gVBO );
+  glDeleteBuffers( 1, &gIBO );
+  glDeleteVertexArrays( 1, &gQuadVAO );
+  gVBO     = 0;
+  gIBO     = 0;
+  gQuadVAO = 0;
+
+  gShaders.free();
+  gProgramID = 0;
 
   // Destroy window
   SDL_DestroyWindow( gWindow );
   gWindow = NULL;
 
   // Quit SDL subsystems
+  TTF_Quit();
   SDL_Quit();
 }
 
 
-void printProgramLog( GLuint program )
+/**
+ * @brief Creates the particle programs and state buffers. The update program only has a vertex
+ * shader, whose outputs are captured by transform feedback; the draw program reads the state through
+ * a texture buffer, as OpenGL 3.1 has no per-instance vertex attributes.
+ *
+ * @return true if successful; false otherwise (everything is released).
+ **/
+static bool initParticlesGL(void)
 {
-  // Make sure name is shader
-  if( glIsProgram( program ) )
+  // The update program only has a vertex shader, whose outputs are captured
+  gParticleUpdateShaders = gShaders.add( "particle_update", ParticleUpdatePath, "", { "OutPosVel", "OutAgeLifeSeed" } );
+  gParticleDrawShaders   = gShaders.add( "particle_draw", ParticleDrawVertexPath, ParticleDrawFragmentPath );
+
+  if( gParticleUpdateShaders == -1 || gParticleDrawShaders == -1 )
   {
-    // Program log length
-    int infoLogLength = 0;
-    int maxLength = infoLogLength;
+    return false;
+  }
+  else { /* Linked */ }
+
+  // Initial state, uploaded once: every particle waits for its first spawn, at evenly spread times
+  std::vector<GLfloat> initialState( static_cast<size_t>( GPU_PARTICLES ) * PARTICLE_FLOATS, 0.f );
+
+  for( GLsizei i = 0; i != GPU_PARTICLES; ++i )
+  {
+    GLfloat* particle = &initialState[ static_cast<size_t>( i ) * PARTICLE_FLOATS ];
+
+    particle[ 4 ] = -2.f * static_cast<float>( i ) / static_cast<float>( GPU_PARTICLES ); // Age
+    particle[ 5 ] = 0.f;                                                                    // Lifetime
+    particle[ 6 ] = std::fmod( static_cast<float>( i ) * 0.618034f, 1.f ) * 1000.f;        // Seed, as the shader keeps it
+  }
+
+  glGenVertexArrays( 1, &gParticleVAO );
+  glGenVertexArrays( 2, gParticleUpdateVAOs );
+  glGenBuffers ( 2, gParticleBuffers  );
+  glGenTextures( 2, gParticleTextures );
+
+  for( int i = 0; i != 2; ++i )
+  {
+    gState.bindArrayBuffer( gParticleBuffers[ i ] );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( initialState.size() * sizeof(GLfloat) ), initialState.data(), GL_DYNAMIC_COPY );
+
+    gState.bindTexture( 0, GL_TEXTURE_BUFFER, gParticleTextures[ i ] );
+    glTexBuffer( GL_TEXTURE_BUFFER, GL_RGBA32F, gParticleBuffers[ i ] );
+  }
 
-    // Get info string length
-    glGetProgramiv( program, GL_INFO_LOG_LENGTH, &maxLength );
+  gParticleCurrent = 0;
 
-    // Allocate string
-    char* infoLog = new char[ maxLength ];
+  takeParticlePrograms();
+
+  return true;
+}
+
+
+/**
+ * @brief Takes the particle programs, and points the update vertex arrays, one per state buffer, at
+ * their attributes: a rebuilt program may have placed them elsewhere.
+ **/
+static void takeParticlePrograms(void)
+{
+  gParticleUpdateProgramID = gShaders.GetProgram( gParticleUpdateShaders );
+  gParticleDrawProgramID   = gShaders.GetProgram( gParticleDrawShaders );
+
+  for( int i = 0; i != 2; ++i )
+  {
+    gState.bindVertexArray( gParticleUpdateVAOs[ i ] );
+
+    if( gParticlePosVelLocation      != -1 ) { glDisableVertexAttribArray( gParticlePosVelLocation      ); } else { /*  */ }
+    if( gParticleAgeLifeSeedLocation != -1 ) { glDisableVertexAttribArray( gParticleAgeLifeSeedLocation ); } else { /*  */ }
+  }
+
+  gParticlePosVelLocation      = glGetAttribLocation ( gParticleUpdateProgramID, "InPosVel" );
+  gParticleAgeLifeSeedLocation = glGetAttribLocation ( gParticleUpdateProgramID, "InAgeLifeSeed" );
+  gParticleDeltaTimeLocation   = glGetUniformLocation( gParticleUpdateProgramID, "DeltaTime" );
+  gParticleEmitterLocation     = glGetUniformLocation( gParticleUpdateProgramID, "Emitter" );
+
+  for( int i = 0; i != 2; ++i )
+  {
+    gState.bindVertexArray( gParticleUpdateVAOs[ i ] );
+    gState.bindArrayBuffer( gParticleBuffers[ i ] );
+    glEnableVertexAttribArray( gParticlePosVelLocation );
+    glEnableVertexAttribArray( gParticleAgeLifeSeedLocation );
+    glVertexAttribPointer( gParticlePosVelLocation     , 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, NULL );
+    glVertexAttribPointer( gParticleAgeLifeSeedLocation, 4, GL_FLOAT, GL_FALSE, PARTICLE_STRIDE, reinterpret_cast<const void*>( 4 * sizeof(GLfloat) ) );
+  }
+
+  gState.useProgram( gParticleDrawProgramID );
+  glUniform1i( glGetUniformLocation( gParticleDrawProgramID, "ParticleState" ), 0 );
+  glUniform2f( glGetUniformLocation( gParticleDrawProgramID, "HalfSize" ), 3.f / WINDOW_W, 3.f / WINDOW_H );
+}
+
+
+/**
+ * @brief Runs the update program over the current state, capturing the new state in the other
+ * buffer, which then becomes the current one.
+ **/
+static void updateParticles( float deltaTime )
+{
+  const int next = 1 - gParticleCurrent;
 
-    // Get info log
-    glGetProgramInfoLog( program, maxLength, &infoLogLength, infoLog );
-    if( infoLogLength > 0 )
+  // Emitter under the mouse, in normalised device coordinates
+  int mouseX = 0, mouseY = 0;
+  SDL_GetMouseState( &mouseX, &mouseY );
+
+  gState.useProgram( gParticleUpdateProgramID );
+  glUniform1f( gParticleDeltaTimeLocation, deltaTime );
+  glUniform2f( gParticleEmitterLocation, 2.f * static_cast<float>( mouseX ) / WINDOW_W - 1.f,
+                                         1.f - 2.f * static_cast<float>( mouseY ) / WINDOW_H );
+
+  // Reads the current buffer, as set up by takeParticlePrograms
+  gState.bindVertexArray( gParticleUpdateVAOs[ gParticleCurrent ] );
+
+  glBindBufferBase( GL_TRANSFORM_FEEDBACK_BUFFER, 0, gParticleBuffers[ next ] );
+
+  // Simulation only: nothing reaches the rasteriser
+  glEnable( GL_RASTERIZER_DISCARD );
+  glBeginTransformFeedback( GL_POINTS );
+  glDrawArrays( GL_POINTS, 0, GPU_PARTICLES );
+  glEndTransformFeedback();
+  glDisable( GL_RASTERIZER_DISCARD );
+
+  glBindBufferBase( GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0 );
+
+  gParticleCurrent = next;
+}
+
+
+/**
+ * @brief Draws every particle with one instanced call, blending additively.
+ **/
+static void renderParticles(void)
+{
+  gState.useProgram( gParticleDrawProgramID );
+  gState.bindVertexArray( gParticleVAO );
+  gState.bindTexture( 0, GL_TEXTURE_BUFFER, gParticleTextures[ gParticleCurrent ] );
+
+  gState.setBlend( true );
+  gState.blendFuncSeparate( GL_ONE, GL_ONE, GL_ONE, GL_ONE );
+
+  glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, GPU_PARTICLES );
+}
+
+
+static void closeParticlesGL(void)
+{
+  glDeleteTextures( 2, gParticleTextures );
+  glDeleteBuffers ( 2, gParticleBuffers  );
+  glDeleteVertexArrays( 1, &gParticleVAO );
+  glDeleteVertexArrays( 2, gParticleUpdateVAOs );
+
+  // The programs belong to gShaders
+
+  gParticleTextures  [ 0 ] = gParticleTextures  [ 1 ] = 0;
+  gParticleBuffers   [ 0 ] = gParticleBuffers   [ 1 ] = 0;
+  gParticleUpdateVAOs[ 0 ] = gParticleUpdateVAOs[ 1 ] = 0;
+  gParticleVAO             = 0;
+  gParticleUpdateProgramID = 0;
+  gParticleDrawProgramID   = 0;
+}
+
+
+/**
+ * @brief Bakes the distance field atlas from the font, which is then closed, uploads it to a
+ * single-channel texture, and creates the text program and vertex buffer.
+ *
+ * @return true if successful; false otherwise (everything is released).
+ **/
+static bool initTextGL(void)
+{
+  TTF_Font* font = TTF_OpenFont( FontPath.c_str(), SDF_BASE_SIZE );
+
+  if( font == NULL )
+  {
+    printf( "\nFailed to load %s! SDL_ttf Error: %s", FontPath.c_str(), TTF_GetError() );
+    return false;
+  }
+  else { /* Loaded */ }
+
+  const bool isBaked = gSdfFont.bake( font, SDF_BASE_SIZE );
+
+  // Every size is drawn from the atlas from now on
+  TTF_CloseFont( font );
+
+  if( !isBaked )
+  {
+    return false;
+  }
+  else { /* Baked */ }
+
+  gTextShaders = gShaders.add( "text", TextVertexPath, TextFragmentPath );
+
+  if( gTextShaders == -1 )
+  {
+    closeTextGL();
+    return false;
+  }
+  else { /* Linked */ }
+
+  // Atlas, one byte per texel; filtered, since the distances interpolate linearly
+  glGenTextures( 1, &gTextTexture );
+  gState.bindTexture( 0, GL_TEXTURE_2D, gTextTexture );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+  glTexImage2D( GL_TEXTURE_2D, 0, GL_R8, gSdfFont.GetWidth(), gSdfFont.GetHeight(), 0, GL_RED, GL_UNSIGNED_BYTE, gSdfFont.GetPixels() );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+
+  // Only the texture is needed from now on
+  gSdfFont.releasePixels();
+
+  glGenVertexArrays( 1, &gTextVAO );
+  glGenBuffers( 1, &gTextVBO );
+
+  takeTextProgram();
+
+  return true;
+}
+
+
+/**
+ * @brief Takes the text program, and points the vertex array at its attributes: a rebuilt program
+ * may have placed them elsewhere.
+ **/
+static void takeTextProgram(void)
+{
+  gTextProgramID = gShaders.GetProgram( gTextShaders );
+
+  gState.bindVertexArray( gTextVAO );
+  gState.bindArrayBuffer( gTextVBO );
+
+  if( gTextVertexPosLocation != -1 ) { glDisableVertexAttribArray( gTextVertexPosLocation ); } else { /*  */ }
+  if( gTextTexCoordLocation  != -1 ) { glDisableVertexAttribArray( gTextTexCoordLocation  ); } else { /*  */ }
+
+  gTextVertexPosLocation = glGetAttribLocation( gTextProgramID, "LVertexPos" );
+  gTextTexCoordLocation  = glGetAttribLocation( gTextProgramID, "LTexCoord" );
+
+  glEnableVertexAttribArray( gTextVertexPosLocation );
+  glEnableVertexAttribArray( gTextTexCoordLocation );
+  glVertexAttribPointer( gTextVertexPosLocation, 2, GL_FLOAT, GL_FALSE, sizeof(LSdfVertex), reinterpret_cast<const void*>( offsetof( LSdfVertex, X ) ) );
+  glVertexAttribPointer( gTextTexCoordLocation , 2, GL_FLOAT, GL_FALSE, sizeof(LSdfVertex), reinterpret_cast<const void*>( offsetof( LSdfVertex, U ) ) );
+
+  gState.useProgram( gTextProgramID );
+  glUniform1i( glGetUniformLocation( gTextProgramID, "Atlas" ), 0 );
+  glUniform2f( glGetUniformLocation( gTextProgramID, "ScreenSize" ), WINDOW_W, WINDOW_H );
+  glUniform4f( glGetUniformLocation( gTextProgramID, "Colour" ), 1.f, 1.f, 1.f, 1.f );
+}
+
+
+/**
+ * @brief Lays out the text of the frame, the same lines at several sizes, and draws it with one
+ * call from the atlas.
+ **/
+static void renderText(void)
+{
+  static const float sizes[] = { 10.f, 14.f, 20.f, 28.f, 40.f, 56.f };
+
+  gTextVertices.clear();
+
+  float y = 8.f;
+  char  line[ 64 ];
+
+  for( const float baseSize : sizes )
+  {
+    const float size = baseSize * gTextScale;
+
+    SDL_snprintf( line, sizeof(line), "SDF text, %.1f pt", static_cast<double>( size ) );
+    gSdfFont.layout( line, 8.f, y, size, gTextVertices );
+    y += gSdfFont.getLineHeight( size );
+  }
+
+  // As drawn by the flush just before the text
+  if( gRenderSprites )
+  {
+    SDL_snprintf( line, sizeof(line), "%u sprites, %d draw calls, %s", static_cast<unsigned>( gSprites.GetSprites() ), gSprites.GetDrawCalls(),
+                  gSprites.IsInstanced() ? "instanced" : "quads" );
+    gSdfFont.layout( line, 8.f, y, 20.f * gTextScale, gTextVertices );
+    y += gSdfFont.getLineHeight( 20.f * gTextScale );
+  }
+  else { /*  */ }
+
+  SDL_snprintf( line, sizeof(line), "GL state: %u calls, %u skipped", gStateIssued, gStateSkipped );
+  gSdfFont.layout( line, 8.f, y, 20.f * gTextScale, gTextVertices );
+  y += gSdfFont.getLineHeight( 20.f * gTextScale );
+
+  // Of the frames already collected, this one's come two frames later
+  if( gGpuProfiler.IsAvailable() )
+  {
+    SDL_snprintf( line, sizeof(line), "GPU %.2f ms, CPU %.2f ms (99th percentile)",
+                  gGpuProfiler.GetFrameStats().GetPercentile( 0.99 ) * 1000.0, gCpuStats.GetPercentile( 0.99 ) * 1000.0 );
+    gSdfFont.layout( line, 8.f, y, 20.f * gTextScale, gTextVertices );
+  }
+  else { /*  */ }
+
+  if( gTextVertices.empty() )
+  {
+    return;
+  }
+  else { /* Something to draw */ }
+
+  gState.useProgram( gTextProgramID );
+  gState.bindVertexArray( gTextVAO );
+
+  // Orphaned and refilled every frame
+  gState.bindArrayBuffer( gTextVBO );
+  glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( gTextVertices.size() * sizeof(LSdfVertex) ), gTextVertices.data(), GL_STREAM_DRAW );
+
+  gState.bindTexture( 0, GL_TEXTURE_2D, gTextTexture );
+
+  gState.setBlend( true );
+  gState.blendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+  glDrawArrays( GL_TRIANGLES, 0, static_cast<GLsizei>( gTextVertices.size() ) );
+}
+
+
+static void closeTextGL(void)
+{
+  glDeleteTextures( 1, &gTextTexture );
+  glDeleteBuffers( 1, &gTextVBO );
+  glDeleteVertexArrays( 1, &gTextVAO );
+
+  // The program belongs to gShaders
+
+  gTextTexture   = 0;
+  gTextVBO       = 0;
+  gTextVAO       = 0;
+  gTextProgramID = 0;
+
+  gSdfFont.free();
+}
+
+
+/**
+ * @brief Creates the sprite renderer and its atlas: the dot and the tileset loaded from file and a
+ * glow generated here, all on the same page. Every sprite starts at a random place with a random velocity.
+ *
+ * @return true if successful; false otherwise (everything is released).
+ **/
+static bool initSpritesGL(void)
+{
+  // Binds through the shared cache, so the flush leaves its state for the text to skip
+  gSprites.setStateCache( &gState );
+
+  if( !gSprites.init( WINDOW_W, WINDOW_H, SPRITE_MIP_LEVELS ) )
+  {
+    return false;
+  }
+  else { /* Ready */ }
+
+  LGLSpriteRenderer::SetDefault( &gSprites );
+
+  // Glow: white, fading out from the centre
+  SDL_Surface* glow = SDL_CreateRGBSurfaceWithFormat( 0, GLOW_SIZE, GLOW_SIZE, 32, SDL_PIXELFORMAT_RGBA32 );
+
+  if( glow != NULL )
+  {
+    Uint32* pixels = static_cast<Uint32*>( glow->pixels );
+
+    for( int y = 0; y != GLOW_SIZE; ++y )
     {
-      // Print Log
-      printf( "%s\n", infoLog );
+      for( int x = 0; x != GLOW_SIZE; ++x )
+      {
+        const float dx      = ( static_cast<float>( x ) + 0.5f ) / GLOW_SIZE * 2.f - 1.f;
+        const float dy      = ( static_cast<float>( y ) + 0.5f ) / GLOW_SIZE * 2.f - 1.f;
+        const float falloff = SDL_max( 1.f - ( dx * dx + dy * dy ), 0.f );
+        const Uint8 alpha   = static_cast<Uint8>( falloff * falloff * 255.f );
+
+        pixels[ y * glow->pitch / 4 + x ] = SDL_MapRGBA( glow->format, 0xFF, 0xFF, 0xFF, alpha );
+      }
     }
+  }
+  else { /*  */ }
 
-    // Deallocate string
-    delete[] infoLog;
+  // The dot has two colours: kept as indices into its palette
+  const bool isLoaded = gDotTexture.loadIndexedFromFile( SpritePath ) && gTilesTexture.loadFromFile( TilesPath ) &&
+                        glow != NULL && gGlowTexture.loadFromSurface( glow );
+
+  SDL_FreeSurface( glow );
+
+  if( !isLoaded )
+  {
+    closeSpritesGL();
+    return false;
   }
-  else
+  else { /* All in the atlas */ }
+
+  // Recoloured copy of the dot's palette: every colour becomes orange as bright as it was
+  gDotPalettes[ 0 ] = gDotTexture.getPalette();
+  gDotPalettes[ 1 ] = gDotPalettes[ 0 ];
+
+  const SDL_Color* dotColours = gSprites.GetPalette( gDotPalettes[ 0 ] );
+
+  if( dotColours != NULL )
+  {
+    std::vector<SDL_Color> recoloured( dotColours, dotColours + LGLSpriteRenderer::s_PALETTE_COLOURS );
+
+    for( SDL_Color& colour : recoloured )
+    {
+      const int brightness = ( colour.r * 77 + colour.g * 150 + colour.b * 29 ) >> 8;
+
+      colour.r = static_cast<Uint8>( ORANGE_R * brightness / 255 );
+      colour.g = static_cast<Uint8>( ORANGE_G * brightness / 255 );
+      colour.b = static_cast<Uint8>( ORANGE_B * brightness / 255 );
+    }
+
+    gDotPalettes[ 1 ] = SDL_max( gSprites.addPalette( recoloured.data(), static_cast<int>( recoloured.size() ) ), gDotPalettes[ 0 ] );
+  }
+  else { /* Not indexed: more than 256 colours */ }
+
+  gGlowTexture.setBlendMode( SDL_BLENDMODE_ADD );
+  gGlowTexture.setColor( 0x40, 0xA0, 0xFF );
+
+  gSpriteStates.resize( SPRITE_COUNT );
+
+  for( SpriteState& sprite : gSpriteStates )
   {
-    printf( "\nName \"%d\" is not a program", program );
+    sprite.X     = static_cast<float>( rand() % WINDOW_W );
+    sprite.Y     = static_cast<float>( rand() % WINDOW_H );
+    sprite.VelX  = ( static_cast<float>( rand() % 2001 ) / 1000.f - 1.f ) * SPRITE_MAX_SPEED;
+    sprite.VelY  = ( static_cast<float>( rand() % 2001 ) / 1000.f - 1.f ) * SPRITE_MAX_SPEED;
+    sprite.Angle = static_cast<float>( rand() % 360 );
   }
+
+  return true;
 }
 
 
-void printShaderLog( GLuint shader )
+/**
+ * @brief Moves every sprite, bouncing it off the edges of the window.
+ **/
+static void updateSprites( float deltaTime )
 {
-  // Make sure name is shader
-  if( glIsShader( shader ) )
+  for( SpriteState& sprite : gSpriteStates )
   {
-    // Shader log length
-    int infoLogLength = 0;
-    int maxLength = infoLogLength;
+    sprite.X     += sprite.VelX * deltaTime;
+    sprite.Y     += sprite.VelY * deltaTime;
+    sprite.Angle += SPRITE_SPIN * deltaTime;
 
-    // Get info string length
-    glGetShaderiv( shader, GL_INFO_LOG_LENGTH, &maxLength );
-
-    // Allocate string
-    char* infoLog = new char[ maxLength ];
+    if( ( sprite.X < 0.f && sprite.VelX < 0.f ) || ( sprite.X > WINDOW_W && sprite.VelX > 0.f ) )
+    {
+      sprite.VelX = -sprite.VelX;
+    }
+    else { /*  */ }
 
-    // Get info log
-    glGetShaderInfoLog( shader, maxLength, &infoLogLength, infoLog );
-    if( infoLogLength > 0 )
+    if( ( sprite.Y < 0.f && sprite.VelY < 0.f ) || ( sprite.Y > WINDOW_H && sprite.VelY > 0.f ) )
     {
-      // Print Log
-      printf( "%s\n", infoLog );
+      sprite.VelY = -sprite.VelY;
     }
+    else { /*  */ }
+  }
+}
+
 
-    // Deallocate string
-    delete[] infoLog;
+/**
+ * @brief Queues every sprite with the same call LTexture uses, then draws them all: one draw call
+ * for the tiles, under the rest, one for the dots and one for the glows, whatever their order here,
+ * and one for the minimap, over them.
+ **/
+static void renderSprites(void)
+{
+  renderTiles( -1, 0, 0, TILE_SIZE );
+
+  if( gRenderMinimap )
+  {
+    const int tileSize = TILE_SIZE / MINIMAP_SCALE;
+
+    renderTiles( 1, WINDOW_W - WINDOW_W / TILE_SIZE * tileSize - MINIMAP_MARGIN, WINDOW_H - WINDOW_H / TILE_SIZE * tileSize - MINIMAP_MARGIN, tileSize );
   }
-  else
+  else { /*  */ }
+
+  for( size_t i = 0; i != gSpriteStates.size(); ++i )
   {
-    printf( "\nName \"%d\" is not a shader", shader );
+    const SpriteState& sprite  = gSpriteStates[ i ];
+    const LGLTexture&  texture = ( i % 2 == 0 ) ? gDotTexture : gGlowTexture;
+
+    texture.render( static_cast<int>( sprite.X ) - texture.getWidth() / 2, static_cast<int>( sprite.Y ) - texture.getHeight() / 2,
+                    NULL, ( i % 2 == 0 ) ? 0.0 : static_cast<double>( sprite.Angle ) );
   }
+
+  gSprites.flush();
+}
+
+
+/**
+ * @brief Queues a tile map the size of the window, on its own layer: walls round the edge, the floor
+ * colours in diagonal stripes inside. Every tile is a clip of the same texture, so all of them are
+ * one instanced draw call. Tiles smaller than in the tileset, as those of the minimap, are sampled
+ * from the mip levels of its page.
+ **/
+static void renderTiles( Sint16 layer, int left, int top, int tileSize )
+{
+  const int columns = WINDOW_W / TILE_SIZE;
+  const int rows    = WINDOW_H / TILE_SIZE;
+
+  gSprites.setLayer( layer );
+
+  for( int y = 0; y != rows; ++y )
+  {
+    for( int x = 0; x != columns; ++x )
+    {
+      const bool isWall = ( x == 0 ) || ( y == 0 ) || ( x == columns - 1 ) || ( y == rows - 1 );
+
+      // Floors are in the first column of the tileset; walls in the other three, by which edge they are on
+      const int      clipX = isWall ? ( ( x == 0 ) ? 1 : ( x == columns - 1 ) ? 3 : 2 ) : 0;
+      const int      clipY = isWall ? ( ( y == 0 ) ? 0 : ( y == rows - 1 ) ? 2 : 1 ) : ( x + y ) % 3;
+      const SDL_Rect clip  = { clipX * TILE_SIZE, clipY * TILE_SIZE, TILE_SIZE, TILE_SIZE };
+
+      const SDL_Rect tile  = { left + x * tileSize, top + y * tileSize, tileSize, tileSize };
+
+      gTilesTexture.renderScaled( tile, &clip );
+    }
+  }
+
+  gSprites.setLayer( 0 );
+}
+
+
+static void closeSpritesGL(void)
+{
+  gDotTexture.free();
+  gGlowTexture.free();
+  gTilesTexture.free();
+  gSprites.free();
+  gSpriteStates.clear();
+
+  LGLSpriteRenderer::SetDefault( nullptr );
 }
 
 
@@ -454,9 +1311,18 @@ int main( int argc, char* args[] )
   printf("\n*** Debugging console ***\n");
   printf("\nProgram started with %d additional arguments.", argc - 1); // Il primo argomento è il nome dell'eseguibile
 
+  // "--capture=<file>" records the frames, see LFrameEncoder
+  const char* capturePath = NULL;
+
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    if ( strncmp( args[i], "--capture=", strlen("--capture=") ) == 0 )
+    {
+      capturePath = args[i] + strlen("--capture=");
+    }
+    else {;}
   }
 
   // Start up SDL and create window
@@ -468,12 +1334,28 @@ int main( int argc, char* args[] )
   {
     printf( "\nOK: all systems initialised" );
 
+    if( capturePath != NULL )
+    {
+      int drawableW = 0, drawableH = 0;
+      SDL_GL_GetDrawableSize( gWindow, &drawableW, &drawableH );
+
+      if( !gCapture.start( drawableW, drawableH, capturePath, LFrameCapture::GetFormatOf( capturePath ) ) )
+      {
+        printf( "\nCapture not available" );
+      }
+      else {;}
+    }
+    else {;}
+
     // Main loop flag
     bool quit = false;
 
     // Event handler
     SDL_Event e;
 
+    // CPU time of update and render, the swap excluded
+    LHighResTimer cpuTimer;
+
     // Enable text input
     SDL_StartTextInput();
 
@@ -498,9 +1380,22 @@ int main( int argc, char* args[] )
         else { /* Event not managed here */ }
       }
 
+      // Collect the GPU times of two frames ago
+      gGpuProfiler.beginFrame();
+      cpuTimer.start();
+
+      // Advance particles
+      update();
+
       // Render quad
       render();
 
+      // Read back the frame, and hand the previous one to the encoder
+      gCapture.capture();
+
+      gCpuStats.addFrame( cpuTimer.getSeconds() );
+      gGpuProfiler.endFrame();
+
       // Update screen
       SDL_GL_SwapWindow( gWindow );
     }
@@ -0,0 +1,215 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGLFrameCapture.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32   ENCODED_FORMAT = SDL_PIXELFORMAT_RGB888; // GL_BGRA with GL_UNSIGNED_INT_8_8_8_8_REV
+static constexpr GLuint64 STOP_WAIT_ns   = 1000000000;             // For the last copies, at stop
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LGLFrameCapture::LGLFrameCapture( void )
+  : m_Encoder(), m_Buffers{}, m_Fences{}, m_IsIssued{}, m_Slot(0), m_HasFences(false), m_Missed(0)
+{;}
+
+
+LGLFrameCapture::~LGLFrameCapture( void )
+{
+  stop();
+}
+
+
+/**
+ * @brief Creates the pixel buffer objects and starts the encoder.
+ *
+ * @param Width, Height Size of the back buffer, in pixels.
+ * @param Path See LFrameEncoder.
+ * @return true if capturing.
+ **/
+bool LGLFrameCapture::start( int Width, int Height, const std::string& Path, LFrameEncoder::Format Written )
+{
+  stop();
+
+  if ( !m_Encoder.start( Path, Written, Width, Height, ENCODED_FORMAT ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const GLsizeiptr FrameBytes = static_cast<GLsizeiptr>( m_Encoder.GetPitch() ) * Height;
+
+  glGenBuffers( s_BUFFERED_FRAMES, m_Buffers );
+
+  for ( int i = 0; i != s_BUFFERED_FRAMES; ++i )
+  {
+    glBindBuffer( GL_PIXEL_PACK_BUFFER, m_Buffers[i] );
+    glBufferData( GL_PIXEL_PACK_BUFFER, FrameBytes, nullptr, GL_STREAM_READ );
+    m_Fences[i]   = 0;
+    m_IsIssued[i] = false;
+  }
+
+  glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+  m_Slot      = 0;
+  m_HasFences = GLEW_VERSION_3_2 || GLEW_ARB_sync;
+  m_Missed    = 0;
+
+  return true;
+}
+
+
+/**
+ * @brief Copies out the frames read and not copied yet, waits for the encoder to write them, and
+ * deletes the buffers.
+ **/
+void LGLFrameCapture::stop( void )
+{
+  if ( !m_Encoder.IsRunning() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  // Oldest first: the buffer of the next frame was read into first
+  for ( int i = 0; i != s_BUFFERED_FRAMES; ++i )
+  {
+    ReadBack_Pvt( ( m_Slot + i ) % s_BUFFERED_FRAMES, true );
+  }
+
+  m_Encoder.stop();
+
+  glDeleteBuffers( s_BUFFERED_FRAMES, m_Buffers );
+
+  for ( int i = 0; i != s_BUFFERED_FRAMES; ++i )
+  {
+    m_Buffers[i] = 0;
+  }
+
+  printf( "\nCapture stopped: %u frames written, %u dropped, %u not ready in time, %u failed",
+          m_Encoder.GetEncoded(), m_Encoder.GetDropped(), m_Missed, m_Encoder.GetFailures() );
+}
+
+
+/**
+ * @brief Starts reading the back buffer into this frame's buffer, and copies out the one read the
+ * frame before. Call after drawing, before SDL_GL_SwapWindow.
+ **/
+void LGLFrameCapture::capture( void )
+{
+  if ( !m_Encoder.IsRunning() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  glBindBuffer( GL_PIXEL_PACK_BUFFER, m_Buffers[m_Slot] );
+  glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+  glReadPixels( 0, 0, m_Encoder.GetWidth(), m_Encoder.GetHeight(), GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr );
+  glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+
+  m_Fences[m_Slot]   = m_HasFences ? glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ) : 0;
+  m_IsIssued[m_Slot] = true;
+  m_Slot             = ( m_Slot + 1 ) % s_BUFFERED_FRAMES;
+
+  ReadBack_Pvt( m_Slot, false );
+}
+
+
+bool LGLFrameCapture::IsRunning( void ) const
+{
+  return m_Encoder.IsRunning();
+}
+
+
+const LFrameEncoder& LGLFrameCapture::GetEncoder( void ) const
+{
+  return m_Encoder;
+}
+
+
+Uint32 LGLFrameCapture::GetMissed( void ) const
+{
+  return m_Missed;
+}
+
+
+/**
+ * @brief Copies a buffer into a buffer of the encoder, bottom row first, and submits it.
+ *
+ * @param IsWaiting Wait for the copy into the buffer to finish, rather than dropping the frame.
+ **/
+void LGLFrameCapture::ReadBack_Pvt( int Slot, bool IsWaiting )
+{
+  if ( !m_IsIssued[Slot] )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_IsIssued[Slot] = false;
+
+  if ( m_Fences[Slot] != 0 )
+  {
+    const GLenum Result = glClientWaitSync( m_Fences[Slot], GL_SYNC_FLUSH_COMMANDS_BIT, IsWaiting ? STOP_WAIT_ns : 0 );
+
+    glDeleteSync( m_Fences[Slot] );
+    m_Fences[Slot] = 0;
+
+    if ( Result != GL_ALREADY_SIGNALED && Result != GL_CONDITION_SATISFIED )
+    {
+      ++m_Missed;
+      return;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  Uint8* Pixels_Ptr = m_Encoder.acquire();
+
+  if ( Pixels_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const size_t Pitch  = static_cast<size_t>( m_Encoder.GetPitch() );
+  const int    Height = m_Encoder.GetHeight();
+
+  glBindBuffer( GL_PIXEL_PACK_BUFFER, m_Buffers[Slot] );
+
+  const Uint8* Read_Ptr = static_cast<const Uint8*>( glMapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY ) );
+
+  if ( Read_Ptr != nullptr )
+  {
+    for ( int Row = 0; Row != Height; ++Row )
+    {
+      memcpy( Pixels_Ptr + static_cast<size_t>( Row ) * Pitch, Read_Ptr + static_cast<size_t>( Height - 1 - Row ) * Pitch, Pitch );
+    }
+
+    glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+    m_Encoder.submit( Pixels_Ptr );
+  }
+  else
+  {;} // The buffer is handed out again with the next frame
+
+  glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+}
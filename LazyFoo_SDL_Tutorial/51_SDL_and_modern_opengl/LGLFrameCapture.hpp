@@ -0,0 +1,63 @@
+/**
+ * @file LGLFrameCapture.hpp
+ *
+ * @brief Capture of the frames drawn with OpenGL, read back through pixel buffer objects a frame
+ * late and written by Engine_Lib's LFrameEncoder, without stalling the render thread.
+ **/
+
+#ifndef LGLFRAMECAPTURE_HPP
+#define LGLFRAMECAPTURE_HPP
+
+#include "LFrameCapture.hpp"
+
+#include <SDL.h>
+#include <glew.h>
+#include <string>
+
+/**
+ * @brief "capture", after the frame is drawn and before the swap, starts copying the back buffer
+ * into a pixel buffer object: glReadPixels returns at once, and the GPU does the copy when it gets
+ * there. The buffers are used in turn, and the one filled the frame before, finished by now, is
+ * mapped and copied into a buffer of the encoder, turned upside down as OpenGL reads from the
+ * bottom row.
+ *
+ * Where the driver has fences (OpenGL 3.2 or ARB_sync), a copy not finished yet is dropped and
+ * counted by GetMissed instead of waited for; "stop" waits for the last ones. Pixels are read as
+ * packed 32 bit xRGB, SDL_PIXELFORMAT_RGB888, the layout of most back buffers.
+ *
+ * The OpenGL context must be current for every call but the getters.
+ **/
+class LGLFrameCapture
+{
+public:
+
+  static constexpr int s_BUFFERED_FRAMES = 2;
+
+  LGLFrameCapture( void );
+  ~LGLFrameCapture( void );
+
+  LGLFrameCapture( const LGLFrameCapture& )            = delete;
+  LGLFrameCapture& operator=( const LGLFrameCapture& ) = delete;
+
+  bool start  ( int, int, const std::string&, LFrameEncoder::Format );
+  void stop   ( void );
+  void capture( void );
+
+  bool                 IsRunning ( void ) const;
+  const LFrameEncoder& GetEncoder( void ) const;
+  Uint32               GetMissed ( void ) const;
+
+private:
+
+  void ReadBack_Pvt( int, bool );
+
+  LFrameEncoder m_Encoder;
+  GLuint        m_Buffers[s_BUFFERED_FRAMES];
+  GLsync        m_Fences[s_BUFFERED_FRAMES];
+  bool          m_IsIssued[s_BUFFERED_FRAMES];  // Read into and not copied out yet
+  int           m_Slot;                         // Buffer of the current frame
+  bool          m_HasFences;
+  Uint32        m_Missed;                       // Copies not finished when read back
+};
+
+#endif // LGLFRAMECAPTURE_HPP
@@ -0,0 +1,278 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGLGpuProfiler.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr double MS_IN_A_S = 1000.0;
+static constexpr double S_IN_A_NS = 1e-9;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Writes one CSV row of statistics, in milliseconds.
+ **/
+static bool writeRow( SDL_RWops* File_Ptr, const char* Name, const LFrameStats& Stats )
+{
+  char      Line[160];
+  const int Length = snprintf( Line, sizeof( Line ), "%s,%u,%.3f,%.3f,%.3f,%.3f\n", Name, static_cast<unsigned>( Stats.GetCount() ),
+                               Stats.GetMin() * MS_IN_A_S, Stats.GetAverage() * MS_IN_A_S,
+                               Stats.GetPercentile( 0.99 ) * MS_IN_A_S, Stats.GetMax() * MS_IN_A_S );
+
+  return Length > 0 && static_cast<size_t>( Length ) < sizeof( Line )
+         && SDL_RWwrite( File_Ptr, Line, static_cast<size_t>( Length ), 1 ) == 1;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LGLGpuProfiler::LGLGpuProfiler( void )
+  : m_Passes(), m_Frame(), m_Slot(0), m_Current(-1), m_IsAvailable(false), m_Missed(0)
+{;}
+
+
+LGLGpuProfiler::~LGLGpuProfiler( void )
+{
+  free();
+}
+
+
+/**
+ * @return true if the driver has timer queries; false otherwise, and the profiler does nothing.
+ **/
+bool LGLGpuProfiler::init( void )
+{
+  free();
+
+  m_IsAvailable = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+
+  return m_IsAvailable;
+}
+
+
+/**
+ * @brief Deletes the queries and forgets the passes and their statistics.
+ **/
+void LGLGpuProfiler::free( void )
+{
+  for ( Pass& Each : m_Passes )
+  {
+    glDeleteQueries( s_BUFFERED_FRAMES, Each.Queries );
+  }
+
+  m_Passes.clear();
+  m_Frame.clear();
+  m_Slot        = 0;
+  m_Current     = -1;
+  m_IsAvailable = false;
+  m_Missed      = 0;
+}
+
+
+/**
+ * @brief Adds a pass, with its queries.
+ *
+ * @return the index of the pass for begin; -1 if timer queries are not available.
+ **/
+int LGLGpuProfiler::addPass( const std::string& Name )
+{
+  if ( !m_IsAvailable )
+  {
+    return -1;
+  }
+  else
+  {;}
+
+  m_Passes.push_back( Pass{ Name, {}, {}, LFrameStats() } );
+  glGenQueries( s_BUFFERED_FRAMES, m_Passes.back().Queries );
+
+  return static_cast<int>( m_Passes.size() ) - 1;
+}
+
+
+/**
+ * @brief Collects the times of the frame that last used this frame's queries, if the GPU is done
+ * with them.
+ **/
+void LGLGpuProfiler::beginFrame( void )
+{
+  GLuint64 Total_ns   = 0;
+  bool     IsMeasured = false;
+
+  for ( Pass& Each : m_Passes )
+  {
+    if ( !Each.IsIssued[m_Slot] )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const GLuint Query     = Each.Queries[m_Slot];
+    GLint        Available = GL_FALSE;
+
+    Each.IsIssued[m_Slot] = false;
+    glGetQueryObjectiv( Query, GL_QUERY_RESULT_AVAILABLE, &Available );
+
+    if ( Available != GL_TRUE )
+    {
+      ++m_Missed;
+      continue;
+    }
+    else
+    {;}
+
+    GLuint64 Elapsed_ns = 0;
+
+    glGetQueryObjectui64v( Query, GL_QUERY_RESULT, &Elapsed_ns );
+    Each.Stats.addFrame( static_cast<double>( Elapsed_ns ) * S_IN_A_NS );
+
+    Total_ns   += Elapsed_ns;
+    IsMeasured  = true;
+  }
+
+  if ( IsMeasured )
+  {
+    m_Frame.addFrame( static_cast<double>( Total_ns ) * S_IN_A_NS );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Starts timing a pass; the pass begun before, if any, must have ended.
+ **/
+void LGLGpuProfiler::begin( int Index )
+{
+  if ( Index < 0 || static_cast<size_t>( Index ) >= m_Passes.size() || m_Current != -1 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_Current = Index;
+  glBeginQuery( GL_TIME_ELAPSED, m_Passes[Index].Queries[m_Slot] );
+}
+
+
+void LGLGpuProfiler::end( void )
+{
+  if ( m_Current == -1 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  glEndQuery( GL_TIME_ELAPSED );
+  m_Passes[m_Current].IsIssued[m_Slot] = true;
+  m_Current = -1;
+}
+
+
+/**
+ * @brief Moves on to the other set of queries; call once per frame, after the last pass.
+ **/
+void LGLGpuProfiler::endFrame( void )
+{
+  end();
+  m_Slot = ( m_Slot + 1 ) % s_BUFFERED_FRAMES;
+}
+
+
+/**
+ * @brief Writes the statistics as CSV, one row each for the CPU frame, every pass and the GPU frame:
+ * frames measured, then minimum, average, 99th percentile and maximum, in milliseconds.
+ *
+ * @param Path The file to write.
+ * @param Cpu The CPU frame times, shown first for comparison.
+ * @return false if the file could not be written.
+ **/
+bool LGLGpuProfiler::save( const std::string& Path, const LFrameStats& Cpu ) const
+{
+  SDL_RWops* File_Ptr = SDL_RWFromFile( Path.c_str(), "w" );
+
+  if ( File_Ptr == NULL )
+  {
+    printf( "\nUnable to save %s! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  static const char Header[] = "pass,frames,min_ms,avg_ms,p99_ms,max_ms\n";
+
+  bool Success = SDL_RWwrite( File_Ptr, Header, sizeof( Header ) - 1, 1 ) == 1
+                 && writeRow( File_Ptr, "cpu frame", Cpu );
+
+  for ( size_t i = 0; Success && i != m_Passes.size(); ++i )
+  {
+    Success = writeRow( File_Ptr, m_Passes[i].Name.c_str(), m_Passes[i].Stats );
+  }
+
+  Success = Success && writeRow( File_Ptr, "gpu frame", m_Frame );
+
+  SDL_RWclose( File_Ptr );
+
+  return Success;
+}
+
+
+bool LGLGpuProfiler::IsAvailable( void ) const
+{
+  return m_IsAvailable;
+}
+
+
+size_t LGLGpuProfiler::GetPassCount( void ) const
+{
+  return m_Passes.size();
+}
+
+
+const std::string& LGLGpuProfiler::GetName( int Index ) const
+{
+  static const std::string None;
+
+  return ( Index >= 0 && static_cast<size_t>( Index ) < m_Passes.size() ) ? m_Passes[Index].Name : None;
+}
+
+
+/**
+ * @return the GPU times of a pass over the last frames; empty statistics for an invalid index.
+ **/
+const LFrameStats& LGLGpuProfiler::GetStats( int Index ) const
+{
+  static const LFrameStats None;
+
+  return ( Index >= 0 && static_cast<size_t>( Index ) < m_Passes.size() ) ? m_Passes[Index].Stats : None;
+}
+
+
+/**
+ * @return the GPU times of the last frames, as the sum of their passes.
+ **/
+const LFrameStats& LGLGpuProfiler::GetFrameStats( void ) const
+{
+  return m_Frame;
+}
+
+
+Uint32 LGLGpuProfiler::GetMissed( void ) const
+{
+  return m_Missed;
+}
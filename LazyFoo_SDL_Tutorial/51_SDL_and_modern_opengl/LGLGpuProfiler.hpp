@@ -0,0 +1,77 @@
+/**
+ * @file LGLGpuProfiler.hpp
+ *
+ * @brief GPU time of the render passes of a frame, measured with OpenGL timer queries, for telling
+ * GPU-bound frames from CPU-bound ones.
+ **/
+
+#ifndef LGLGPUPROFILER_HPP
+#define LGLGPUPROFILER_HPP
+
+#include "LFrameStats.hpp"
+
+#include <SDL.h>
+#include <glew.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Wraps every named pass in a GL_TIME_ELAPSED query, and keeps the GPU times of the last
+ * frames of each pass, and of their sum, in an LFrameStats: the same minimum, average, maximum and
+ * percentile as the CPU frame times.
+ *
+ * The queries are double-buffered: "beginFrame" collects the results of two frames before, which
+ * the GPU has normally finished by then, and never waits for them. A result not ready yet is
+ * dropped and counted by GetMissed; a pass not drawn in a frame adds nothing to its statistics.
+ * Time elapsed queries cannot nest: a pass ends before the next one begins.
+ *
+ * Timer queries need OpenGL 3.3 or ARB_timer_query; without them "init" fails, and every other
+ * call does nothing. The OpenGL context must be current for every call but the getters.
+ **/
+class LGLGpuProfiler
+{
+public:
+
+  static constexpr int s_BUFFERED_FRAMES = 2;
+
+  LGLGpuProfiler( void );
+  ~LGLGpuProfiler( void );
+
+  LGLGpuProfiler( const LGLGpuProfiler& )            = delete;
+  LGLGpuProfiler& operator=( const LGLGpuProfiler& ) = delete;
+
+  bool   init          ( void );
+  void   free          ( void );
+  int    addPass       ( const std::string& );
+  void   beginFrame    ( void );
+  void   begin         ( int );
+  void   end           ( void );
+  void   endFrame      ( void );
+  bool   save          ( const std::string&, const LFrameStats& ) const;
+
+  bool               IsAvailable  ( void ) const;
+  size_t             GetPassCount ( void ) const;
+  const std::string& GetName      ( int ) const;
+  const LFrameStats& GetStats     ( int ) const;
+  const LFrameStats& GetFrameStats( void ) const;
+  Uint32             GetMissed    ( void ) const;
+
+private:
+
+  struct Pass
+  {
+    std::string Name;
+    GLuint      Queries[s_BUFFERED_FRAMES];
+    bool        IsIssued[s_BUFFERED_FRAMES];   // Begun and ended in the frame that used the slot
+    LFrameStats Stats;
+  };
+
+  std::vector<Pass> m_Passes;
+  LFrameStats       m_Frame;         // Sum of the passes of each frame
+  int               m_Slot;          // Queries of the current frame
+  int               m_Current;       // Pass between begin and end, or -1
+  bool              m_IsAvailable;
+  Uint32            m_Missed;        // Results not ready when collected
+};
+
+#endif // LGLGPUPROFILER_HPP
@@ -0,0 +1,553 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGLShaderManager.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint64 HASH_OFFSET = 14695981039346656037ULL;  // FNV-1a
+static constexpr Uint64 HASH_PRIME  = 1099511628211ULL;
+
+static constexpr char   CACHE_MAGIC[4]  = { 'L', 'G', 'L', 'B' };
+static constexpr Uint32 CACHE_VERSION   = 1;
+static const char*      CACHE_EXTENSION = ".glbin";
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+// Start of a ".glbin" file, followed by Length bytes of binary in the driver's format
+struct CacheHeader
+{
+  char   Magic[4];   // CACHE_MAGIC
+  Uint32 Version;    // CACHE_VERSION
+  Uint64 Key;        // Driver and sources the binary was linked from
+  Uint32 Format;
+  Uint32 Length;
+};
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static Uint64 HashBytes( Uint64 Hash, const void* Data_Ptr, size_t Size )
+{
+  const Uint8* Byte_Ptr = static_cast<const Uint8*>( Data_Ptr );
+
+  for ( size_t i = 0; i != Size; ++i )
+  {
+    Hash = ( Hash ^ Byte_Ptr[i] ) * HASH_PRIME;
+  }
+
+  return Hash;
+}
+
+
+// The terminator is hashed too, so that "ab" + "c" and "a" + "bc" differ
+static Uint64 HashString( Uint64 Hash, const std::string& Text )
+{
+  return HashBytes( Hash, Text.c_str(), Text.size() + 1 );
+}
+
+
+/**
+ * @brief Reads a whole text file.
+ *
+ * @return false if it cannot be read.
+ **/
+static bool readFile( const std::string& Path, std::string& Text )
+{
+  SDL_RWops* File_Ptr = SDL_RWFromFile( Path.c_str(), "rb" );
+
+  if ( File_Ptr == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const Sint64 Size    = SDL_RWsize( File_Ptr );
+  bool         Success = Size >= 0;
+
+  if ( Success )
+  {
+    Text.resize( static_cast<size_t>( Size ) );
+    Success = ( Size == 0 ) || SDL_RWread( File_Ptr, &Text[0], static_cast<size_t>( Size ), 1 ) == 1;
+  }
+  else
+  {;}
+
+  SDL_RWclose( File_Ptr );
+
+  return Success;
+}
+
+
+/**
+ * @return the cache file of a program: "<Name>.glbin", in the folder of its vertex shader.
+ **/
+static std::string getCachePath( const std::string& VertexPath, const std::string& Name )
+{
+  const size_t Slash = VertexPath.find_last_of( "/\\" );
+
+  return ( ( Slash != std::string::npos ) ? VertexPath.substr( 0, Slash + 1 ) : std::string() ) + Name + CACHE_EXTENSION;
+}
+
+
+static GLuint compileShader( GLenum Type, const std::string& Source, const std::string& Path )
+{
+  const GLchar* Source_Ptr = Source.c_str();
+  GLuint        Shader     = glCreateShader( Type );
+  GLint         Compiled   = GL_FALSE;
+
+  glShaderSource( Shader, 1, &Source_Ptr, NULL );
+  glCompileShader( Shader );
+  glGetShaderiv( Shader, GL_COMPILE_STATUS, &Compiled );
+
+  if ( Compiled != GL_TRUE )
+  {
+    char Log[1024] = {};
+
+    glGetShaderInfoLog( Shader, sizeof(Log), NULL, Log );
+    printf( "\nUnable to compile \"%s\"! %s", Path.c_str(), Log );
+    glDeleteShader( Shader );
+    return 0;
+  }
+  else
+  {;}
+
+  return Shader;
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LGLShaderManager::LGLShaderManager( void )
+  : m_Programs(), m_DriverHash(HASH_OFFSET), m_CanCache(false), m_NextPoll_ms(0), m_CacheHits(0)
+{;}
+
+
+LGLShaderManager::~LGLShaderManager( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Identifies the driver the binaries are cached for, and finds out whether it can hand them
+ * out at all. Call after glewInit.
+ **/
+void LGLShaderManager::init( void )
+{
+  free();
+
+  const GLenum Names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+
+  m_DriverHash = HASH_OFFSET;
+
+  for ( const GLenum Name : Names )
+  {
+    const GLubyte* Text_Ptr = glGetString( Name );
+
+    m_DriverHash = HashString( m_DriverHash, ( Text_Ptr != NULL ) ? reinterpret_cast<const char*>( Text_Ptr ) : "" );
+  }
+
+  GLint NumOfFormats = 0;
+
+  if ( GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary )
+  {
+    glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &NumOfFormats );
+  }
+  else
+  {;}
+
+  m_CanCache    = NumOfFormats > 0;
+  m_NextPoll_ms = SDL_GetTicks64() + s_POLL_ms;
+}
+
+
+/**
+ * @brief Deletes every program; their names given out so far become invalid.
+ **/
+void LGLShaderManager::free( void )
+{
+  for ( Program& Each : m_Programs )
+  {
+    glDeleteProgram( Each.ID );
+  }
+
+  m_Programs.clear();
+  m_CacheHits = 0;
+}
+
+
+/**
+ * @brief Builds a program, from its cached binary if it matches, from its sources otherwise.
+ *
+ * @param Name The name of the cache file, without extension; unique among the programs.
+ * @param VertexPath The path of the vertex shader.
+ * @param FragmentPath The path of the fragment shader; empty for a program without one.
+ * @param Varyings The outputs of the vertex shader captured by transform feedback, interleaved.
+ * @return the handle of the program for GetProgram; -1 if it could not be built.
+ **/
+int LGLShaderManager::add( const std::string& Name, const std::string& VertexPath, const std::string& FragmentPath,
+                           const std::vector<std::string>& Varyings )
+{
+  m_Programs.push_back( Program{ Name, VertexPath, FragmentPath, Varyings, 0, 0 } );
+
+  if ( !Build_Pvt( m_Programs.back() ) )
+  {
+    m_Programs.pop_back();
+    return -1;
+  }
+  else
+  {;}
+
+  return static_cast<int>( m_Programs.size() ) - 1;
+}
+
+
+/**
+ * @brief Every s_POLL_ms, reads the sources again and rebuilds the programs whose sources changed.
+ *
+ * @return true if a program was replaced: its name, uniform locations and values are new.
+ **/
+bool LGLShaderManager::poll( void )
+{
+  const Uint64 Now_ms = SDL_GetTicks64();
+
+  if ( Now_ms < m_NextPoll_ms )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_NextPoll_ms = Now_ms + s_POLL_ms;
+
+  bool IsReloaded = false;
+
+  for ( Program& Each : m_Programs )
+  {
+    if ( Build_Pvt( Each ) )
+    {
+      printf( "\nShaders of \"%s\" reloaded", Each.Name.c_str() );
+      IsReloaded = true;
+    }
+    else
+    {;}
+  }
+
+  return IsReloaded;
+}
+
+
+/**
+ * @return the program of a handle given by add; 0 for an invalid handle.
+ **/
+GLuint LGLShaderManager::GetProgram( int Handle ) const
+{
+  return ( Handle >= 0 && static_cast<size_t>( Handle ) < m_Programs.size() ) ? m_Programs[Handle].ID : 0;
+}
+
+
+/**
+ * @return true if the driver hands out program binaries, which are then cached.
+ **/
+bool LGLShaderManager::IsCaching( void ) const
+{
+  return m_CanCache;
+}
+
+
+/**
+ * @return the programs loaded from their cached binary since init.
+ **/
+int LGLShaderManager::GetCacheHits( void ) const
+{
+  return m_CacheHits;
+}
+
+
+/**
+ * @brief Builds the program again if its sources are not the ones last built, and replaces it if
+ * that succeeds.
+ *
+ * @return true if the program was replaced.
+ **/
+bool LGLShaderManager::Build_Pvt( Program& Each )
+{
+  std::string VertexSource;
+  std::string FragmentSource;
+
+  if ( !readFile( Each.VertexPath, VertexSource ) || ( !Each.FragmentPath.empty() && !readFile( Each.FragmentPath, FragmentSource ) ) )
+  {
+    // While running, a file is missing for a moment as some editors save it
+    if ( Each.ID == 0 )
+    {
+      printf( "\nUnable to read the shaders of \"%s\"! SDL Error: %s", Each.Name.c_str(), SDL_GetError() );
+    }
+    else
+    {;}
+
+    return false;
+  }
+  else
+  {;}
+
+  const Uint64 Key = GetKey_Pvt( Each, VertexSource, FragmentSource );
+
+  if ( Each.ID != 0 && Key == Each.Key )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Tried once per change: a failure waits for the next edit
+  Each.Key = Key;
+
+  GLuint ID = m_CanCache ? LoadBinary_Pvt( Each, Key ) : 0;
+
+  if ( ID != 0 )
+  {
+    ++m_CacheHits;
+  }
+  else
+  {
+    ID = Link_Pvt( Each, VertexSource, FragmentSource );
+
+    if ( ID == 0 )
+    {
+      return false;
+    }
+    else if ( m_CanCache )
+    {
+      SaveBinary_Pvt( Each, ID );
+    }
+    else
+    {;}
+  }
+
+  glDeleteProgram( Each.ID );
+  Each.ID = ID;
+
+  return true;
+}
+
+
+/**
+ * @brief Compiles and links the sources of a program.
+ *
+ * @return the program; 0 if it failed, with the log printed.
+ **/
+GLuint LGLShaderManager::Link_Pvt( const Program& Each, const std::string& VertexSource, const std::string& FragmentSource ) const
+{
+  const GLuint VertexShader   = compileShader( GL_VERTEX_SHADER, VertexSource, Each.VertexPath );
+  const GLuint FragmentShader = Each.FragmentPath.empty() ? 0 : compileShader( GL_FRAGMENT_SHADER, FragmentSource, Each.FragmentPath );
+
+  if ( VertexShader == 0 || ( FragmentShader == 0 && !Each.FragmentPath.empty() ) )
+  {
+    glDeleteShader( VertexShader );
+    glDeleteShader( FragmentShader );
+    return 0;
+  }
+  else
+  {;}
+
+  GLuint ID     = glCreateProgram();
+  GLint  Linked = GL_FALSE;
+
+  glAttachShader( ID, VertexShader );
+
+  if ( FragmentShader != 0 )
+  {
+    glAttachShader( ID, FragmentShader );
+  }
+  else
+  {;}
+
+  if ( !Each.Varyings.empty() )
+  {
+    std::vector<const GLchar*> Names;
+
+    for ( const std::string& Varying : Each.Varyings )
+    {
+      Names.push_back( Varying.c_str() );
+    }
+
+    glTransformFeedbackVaryings( ID, static_cast<GLsizei>( Names.size() ), Names.data(), GL_INTERLEAVED_ATTRIBS );
+  }
+  else
+  {;}
+
+  if ( m_CanCache )
+  {
+    glProgramParameteri( ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+  }
+  else
+  {;}
+
+  glLinkProgram( ID );
+  glGetProgramiv( ID, GL_LINK_STATUS, &Linked );
+
+  // Flagged for deletion: freed together with the program
+  glDeleteShader( VertexShader );
+  glDeleteShader( FragmentShader );
+
+  if ( Linked != GL_TRUE )
+  {
+    char Log[1024] = {};
+
+    glGetProgramInfoLog( ID, sizeof(Log), NULL, Log );
+    printf( "\nUnable to link \"%s\"! %s", Each.Name.c_str(), Log );
+    glDeleteProgram( ID );
+    return 0;
+  }
+  else
+  {;}
+
+  return ID;
+}
+
+
+/**
+ * @brief Hands the cached binary of a program to the driver, if it was linked from the same sources
+ * by the same driver.
+ *
+ * @return the program; 0 if there is no such binary, or the driver refuses it.
+ **/
+GLuint LGLShaderManager::LoadBinary_Pvt( const Program& Each, Uint64 Key ) const
+{
+  SDL_RWops* File_Ptr = SDL_RWFromFile( getCachePath( Each.VertexPath, Each.Name ).c_str(), "rb" );
+
+  if ( File_Ptr == NULL )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  CacheHeader        Header;
+  std::vector<Uint8> Binary;
+
+  bool Success = SDL_RWread( File_Ptr, &Header, sizeof(Header), 1 ) == 1
+                 && memcmp( Header.Magic, CACHE_MAGIC, sizeof(Header.Magic) ) == 0
+                 && Header.Version == CACHE_VERSION
+                 && Header.Key == Key
+                 && Header.Length > 0;
+
+  if ( Success )
+  {
+    Binary.resize( Header.Length );
+    Success = SDL_RWread( File_Ptr, Binary.data(), Binary.size(), 1 ) == 1;
+  }
+  else
+  {;}
+
+  SDL_RWclose( File_Ptr );
+
+  if ( !Success )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  GLuint ID     = glCreateProgram();
+  GLint  Linked = GL_FALSE;
+
+  glProgramBinary( ID, Header.Format, Binary.data(), static_cast<GLsizei>( Binary.size() ) );
+  glGetProgramiv( ID, GL_LINK_STATUS, &Linked );
+
+  if ( Linked != GL_TRUE )
+  {
+    glDeleteProgram( ID );
+    return 0;
+  }
+  else
+  {;}
+
+  return ID;
+}
+
+
+/**
+ * @brief Writes the binary of a freshly linked program to its cache file. A failure only costs
+ * the next launch a compilation.
+ **/
+void LGLShaderManager::SaveBinary_Pvt( const Program& Each, GLuint ID ) const
+{
+  GLint Length = 0;
+
+  glGetProgramiv( ID, GL_PROGRAM_BINARY_LENGTH, &Length );
+
+  if ( Length <= 0 )
+  {
+    return;
+  }
+  else
+  {;}
+
+  std::vector<Uint8> Binary( static_cast<size_t>( Length ) );
+  GLenum             Format  = 0;
+  GLsizei            Written = 0;
+
+  glGetProgramBinary( ID, Length, &Written, &Format, Binary.data() );
+
+  CacheHeader Header;
+  memcpy( Header.Magic, CACHE_MAGIC, sizeof(Header.Magic) );
+  Header.Version = CACHE_VERSION;
+  Header.Key     = Each.Key;
+  Header.Format  = Format;
+  Header.Length  = static_cast<Uint32>( Written );
+
+  const std::string Path     = getCachePath( Each.VertexPath, Each.Name );
+  SDL_RWops*        File_Ptr = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  bool Success = ( File_Ptr != NULL ) && Written > 0
+                 && SDL_RWwrite( File_Ptr, &Header, sizeof(Header), 1 ) == 1
+                 && SDL_RWwrite( File_Ptr, Binary.data(), static_cast<size_t>( Written ), 1 ) == 1;
+
+  if ( File_Ptr != NULL )
+  {
+    Success = ( SDL_RWclose( File_Ptr ) == 0 ) && Success;
+  }
+  else
+  {;}
+
+  if ( !Success )
+  {
+    printf( "\nUnable to cache the program in \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @return the key of a program's binary: the driver, the sources and the captured varyings.
+ **/
+Uint64 LGLShaderManager::GetKey_Pvt( const Program& Each, const std::string& VertexSource, const std::string& FragmentSource ) const
+{
+  Uint64 Key = HashString( m_DriverHash, VertexSource );
+  Key = HashString( Key, FragmentSource );
+
+  for ( const std::string& Varying : Each.Varyings )
+  {
+    Key = HashString( Key, Varying );
+  }
+
+  return Key;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file LGLShaderManager.hpp
+ *
+ * @brief GLSL programs loaded from files, their linked binaries cached on disk, and rebuilt while
+ * running when their files change.
+ **/
+
+#ifndef LGLSHADERMANAGER_HPP
+#define LGLSHADERMANAGER_HPP
+
+#include <SDL.h>
+#include <glew.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Owns the programs of the application, each built from a vertex shader file and, unless it
+ * only feeds transform feedback, a fragment shader file.
+ *
+ * Where the driver has ARB_get_program_binary (core in OpenGL 4.1), every linked program is saved
+ * next to its shaders as "<name>.glbin", keyed by a hash of the driver (vendor, renderer and
+ * version) and of the sources: the next launch hands the binary back to the driver instead of
+ * compiling and linking, which on some drivers is most of the start-up time. A key that does not
+ * match, because the sources changed or the driver was updated, or a binary the driver refuses,
+ * falls back to compiling, and the file is written again.
+ *
+ * "poll", called once per frame, reads the sources again every s_POLL_ms and rebuilds the programs
+ * whose sources changed. A program that fails to compile keeps the previous one, and its log is
+ * printed; fixing the file is enough to try again. A rebuilt program has a new name, and uniform
+ * values and locations of its own: poll returns true so that the caller takes them again.
+ *
+ * The OpenGL context must be current for every call but GetProgram, and still current when the
+ * manager is freed.
+ **/
+class LGLShaderManager
+{
+public:
+
+  static constexpr Uint32 s_POLL_ms = 500;
+
+  LGLShaderManager( void );
+  ~LGLShaderManager( void );
+
+  LGLShaderManager( const LGLShaderManager& )            = delete;
+  LGLShaderManager& operator=( const LGLShaderManager& ) = delete;
+
+  void   init          ( void );
+  void   free          ( void );
+  int    add           ( const std::string&, const std::string&, const std::string&, const std::vector<std::string>& = {} );
+  bool   poll          ( void );
+
+  GLuint GetProgram    ( int ) const;
+  bool   IsCaching     ( void ) const;
+  int    GetCacheHits  ( void ) const;
+
+private:
+
+  struct Program
+  {
+    std::string              Name;           // Of the cache file, "<Name>.glbin" in the shaders' folder
+    std::string              VertexPath;
+    std::string              FragmentPath;   // Empty for transform feedback only
+    std::vector<std::string> Varyings;       // Captured by transform feedback, interleaved
+    Uint64                   Key;            // Of the sources last built, successfully or not
+    GLuint                   ID;
+  };
+
+  bool   Build_Pvt      ( Program& );
+  GLuint Link_Pvt       ( const Program&, const std::string&, const std::string& ) const;
+  GLuint LoadBinary_Pvt ( const Program&, Uint64 ) const;
+  void   SaveBinary_Pvt ( const Program&, GLuint ) const;
+  Uint64 GetKey_Pvt     ( const Program&, const std::string&, const std::string& ) const;
+
+  std::vector<Program> m_Programs;
+  Uint64               m_DriverHash;
+  bool                 m_CanCache;
+  Uint64               m_NextPoll_ms;
+  int                  m_CacheHits;         // Programs loaded from their binary
+};
+
+#endif // LGLSHADERMANAGER_HPP
@@ -0,0 +1,1656 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGLSpriteRenderer.hpp"
+#include "colours.hpp"
+#include "LAssetPack.hpp"
+#include "LBakedTexture.hpp"
+#include "LMappedFile.hpp"
+#include "LPixelOps.hpp"
+
+#include <SDL_image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 LAYER_SHIFT    = 16;
+static constexpr Uint32 BLEND_SHIFT    = 12;
+static constexpr Uint32 MAX_PAGES      = 1 << BLEND_SHIFT;
+static constexpr Uint64 FENCE_WAIT_ns  = 1000000000;         // Per try; a fence is retried until signalled
+static constexpr double DEGREES_TO_RAD = 3.14159265358979323846 / 180.0;
+
+// The blend modes of SDL_Renderer, in the order of their index in the sort key
+static const SDL_BlendMode BLEND_MODES[] =
+{
+  SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD, SDL_BLENDMODE_MUL
+};
+
+// The internal format of each LBlockFormat, by its value
+static const GLenum BLOCK_FORMATS[] =
+{
+  0,
+  GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,   // BC1, with its punch-through alpha
+  GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,   // BC3
+  GL_COMPRESSED_RGB8_ETC2,
+  GL_COMPRESSED_RGBA8_ETC2_EAC,
+};
+
+// Attribute indices, bound before linking so that the vertex arrays need no lookup
+enum QuadAttribute      { QUAD_POSITION, QUAD_TEX_COORD, QUAD_COLOUR, QUAD_PALETTE };
+enum InstanceAttribute  { INSTANCE_CORNER, INSTANCE_RECT, INSTANCE_CENTER_ANGLE, INSTANCE_TEX_RECT, INSTANCE_COLOUR, INSTANCE_PALETTE };
+
+static const GLchar* QuadAttributeNames[]     = { "LVertexPos", "LTexCoord", "LColour", "LPalette" };
+static const GLchar* InstanceAttributeNames[] = { "LCorner", "LRect", "LCenterAngle", "LTexRect", "LColour", "LPalette" };
+
+// The unit quad, in the order of the corners of a sprite: top left, top right, bottom right, bottom left
+static const GLfloat QuadCorners[] = { 0.0f, 0.0f,  1.0f, 0.0f,  1.0f, 1.0f,  0.0f, 1.0f };
+
+// Window pixels, y down, turned into normalised device coordinates
+static const GLchar* QuadVertexSource =
+  "#version 140\n"
+  "in vec2 LVertexPos; in vec2 LTexCoord; in vec4 LColour; in float LPalette;\n"
+  "uniform vec2 ScreenSize;\n"
+  "out vec2 TexCoord; out vec4 Colour; flat out float Palette;\n"
+  "void main() {\n"
+  "  TexCoord = LTexCoord; Colour = LColour; Palette = LPalette;\n"
+  "  gl_Position = vec4( LVertexPos.x / ScreenSize.x * 2.0 - 1.0, 1.0 - LVertexPos.y / ScreenSize.y * 2.0, 0.0, 1.0 );\n"
+  "}\n";
+
+// The corner of the unit quad scaled to the sprite, rotated about its centre, and placed; the same
+// maths as Write_Pvt does on the CPU for the quads
+static const GLchar* InstancedVertexSource =
+  "#version 140\n"
+  "in vec2 LCorner; in vec4 LRect; in vec3 LCenterAngle; in vec4 LTexRect; in vec4 LColour; in float LPalette;\n"
+  "uniform vec2 ScreenSize;\n"
+  "out vec2 TexCoord; out vec4 Colour; flat out float Palette;\n"
+  "void main() {\n"
+  "  vec2  Local = LCorner * LRect.zw - LCenterAngle.xy;\n"
+  "  float Cos   = cos( LCenterAngle.z ); float Sin = sin( LCenterAngle.z );\n"
+  "  vec2  Pos   = LRect.xy + LCenterAngle.xy + vec2( Local.x * Cos - Local.y * Sin, Local.x * Sin + Local.y * Cos );\n"
+  "  TexCoord = mix( LTexRect.xy, LTexRect.zw, LCorner ); Colour = LColour; Palette = LPalette;\n"
+  "  gl_Position = vec4( Pos.x / ScreenSize.x * 2.0 - 1.0, 1.0 - Pos.y / ScreenSize.y * 2.0, 0.0, 1.0 );\n"
+  "}\n";
+
+// The texel of an indexed page is the column of its colour in the sprite's row of the palettes
+static const GLchar* SpriteFragmentSource =
+  "#version 140\n"
+  "in vec2 TexCoord; in vec4 Colour; flat in float Palette; out vec4 LFragment;\n"
+  "uniform sampler2D Page; uniform sampler2D Palettes; uniform bool IsIndexed;\n"
+  "void main() {\n"
+  "  vec4 Texel = texture( Page, TexCoord );\n"
+  "  if ( IsIndexed ) { Texel = texelFetch( Palettes, ivec2( int( Texel.r * 255.0 + 0.5 ), int( Palette ) ), 0 ); }\n"
+  "  LFragment = Texel * Colour;\n"
+  "}\n";
+
+
+/***************************************************************************************************
+* Private variables
+****************************************************************************************************/
+
+static LGLSpriteRenderer* g_DefaultRenderer = nullptr;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @return the index of the blend mode in BLEND_MODES; that of SDL_BLENDMODE_BLEND for the custom
+ * ones, which the sprites do not support.
+ **/
+static Uint32 getBlendIndex( SDL_BlendMode Mode )
+{
+  const SDL_BlendMode* Found = std::find( std::begin( BLEND_MODES ), std::end( BLEND_MODES ), Mode );
+
+  return ( Found != std::end( BLEND_MODES ) ) ? static_cast<Uint32>( Found - BLEND_MODES ) : 1;
+}
+
+
+/**
+ * @return the side of the block of an image in a page: the image and a gutter on both sides, rounded
+ * up to a multiple of the gutter, which is the texel of the smallest mip level.
+ **/
+static int getBlockSize( int ImageSize, int Gutter )
+{
+  return ( ImageSize + 3 * Gutter - 1 ) / Gutter * Gutter;
+}
+
+
+static Uint32 getFormatBit( LBlockFormat Format )
+{
+  return 1u << static_cast<Uint32>( Format );
+}
+
+
+static GLuint compileShader( GLenum Type, const GLchar* Source )
+{
+  GLuint Shader   = glCreateShader( Type );
+  GLint  Compiled = GL_FALSE;
+
+  glShaderSource( Shader, 1, &Source, NULL );
+  glCompileShader( Shader );
+  glGetShaderiv( Shader, GL_COMPILE_STATUS, &Compiled );
+
+  if ( Compiled != GL_TRUE )
+  {
+    char Log[512] = {};
+
+    glGetShaderInfoLog( Shader, sizeof(Log), NULL, Log );
+    printf( "\nUnable to compile the sprite shader! %s", Log );
+    glDeleteShader( Shader );
+    return 0;
+  }
+  else
+  {;}
+
+  return Shader;
+}
+
+
+/**
+ * @brief Builds a sprite program, its attributes bound to their index in Names, and points its page
+ * sampler at texture unit 0 and its palettes at unit 1. The program is left in use.
+ *
+ * @return the program, or 0 if it failed to build.
+ **/
+static GLuint linkProgram( LGLStateCache& State, const GLchar* VertexSource, const GLchar* const* Names, GLuint NumOfNames )
+{
+  const GLuint VertexShader   = compileShader( GL_VERTEX_SHADER  , VertexSource         );
+  const GLuint FragmentShader = compileShader( GL_FRAGMENT_SHADER, SpriteFragmentSource );
+  GLuint       Program        = glCreateProgram();
+  GLint        Linked         = GL_FALSE;
+
+  if ( VertexShader   != 0 ) { glAttachShader( Program, VertexShader   ); } else {;}
+  if ( FragmentShader != 0 ) { glAttachShader( Program, FragmentShader ); } else {;}
+
+  for ( GLuint i = 0; i != NumOfNames; ++i )
+  {
+    glBindAttribLocation( Program, i, Names[i] );
+  }
+
+  if ( VertexShader != 0 && FragmentShader != 0 )
+  {
+    glLinkProgram( Program );
+    glGetProgramiv( Program, GL_LINK_STATUS, &Linked );
+  }
+  else
+  {;}
+
+  // Flagged for deletion: freed together with the program
+  glDeleteShader( VertexShader );
+  glDeleteShader( FragmentShader );
+
+  if ( Linked != GL_TRUE )
+  {
+    printf( "\nUnable to link the sprite program!" );
+    glDeleteProgram( Program );
+    return 0;
+  }
+  else
+  {;}
+
+  State.useProgram( Program );
+  glUniform1i( glGetUniformLocation( Program, "Page" ), 0 );
+  glUniform1i( glGetUniformLocation( Program, "Palettes" ), 1 );
+
+  return Program;
+}
+
+
+/***************************************************************************************************
+* LGLTexture methods
+****************************************************************************************************/
+
+LGLTexture::LGLTexture( void )
+  : m_Renderer_Ptr(nullptr), m_Page(-1), m_Area(), m_Colour{ 0xFF, 0xFF, 0xFF, 0xFF }, m_BlendMode(SDL_BLENDMODE_BLEND),
+    m_Palette(0)
+{;}
+
+
+LGLTexture::~LGLTexture( void )
+{
+  free();
+}
+
+
+/**
+ * @brief Loads an image into the atlas, or its block compressed copy ("<Path>.ltc") into a page of
+ * its own if the driver samples its format. Cyan is transparent, as for LTexture.
+ *
+ * @param Path The path of the image.
+ * @param Renderer_Ptr The renderer that will draw this texture; the default one if omitted.
+ * @return true if successful; false otherwise.
+ **/
+bool LGLTexture::loadFromFile( const std::string& Path, LGLSpriteRenderer* Renderer_Ptr )
+{
+  free();
+
+  LGLSpriteRenderer* Renderer = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : g_DefaultRenderer;
+
+  // The block compressed copy baked next to the image, if any and if the driver samples it
+  if ( Renderer != nullptr && Renderer->AddCompressed_Pvt( Path + LBAKED_BLOCKS_EXTENSION, m_Page, m_Area ) )
+  {
+    m_Renderer_Ptr = Renderer;
+    return true;
+  }
+  else
+  {;}
+
+  SDL_Surface* LoadedSurface = IMG_Load( Path.c_str() );
+
+  if ( LoadedSurface == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_SetColorKey( LoadedSurface, SDL_TRUE, SDL_MapRGB( LoadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+
+  const bool Success = loadFromSurface( LoadedSurface, Renderer_Ptr );
+
+  if ( !Success )
+  {
+    printf( "\nUnable to add \"%s\" to the sprite atlas!", Path.c_str() );
+  }
+  else
+  {;}
+
+  SDL_FreeSurface( LoadedSurface );
+
+  return Success;
+}
+
+
+/**
+ * @brief Copies a surface into the atlas. The colour key of the surface, if any, becomes
+ * transparency.
+ *
+ * @param Surface_Ptr The source pixels. Still owned by the caller.
+ * @param Renderer_Ptr The renderer that will draw this texture; the default one if omitted.
+ * @return true if successful; false otherwise.
+ **/
+bool LGLTexture::loadFromSurface( SDL_Surface* Surface_Ptr, LGLSpriteRenderer* Renderer_Ptr )
+{
+  free();
+
+  LGLSpriteRenderer* Renderer = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : g_DefaultRenderer;
+
+  if ( Renderer == nullptr || !Renderer->Add_Pvt( Surface_Ptr, m_Page, m_Area ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_Renderer_Ptr = Renderer;
+
+  return true;
+}
+
+
+/**
+ * @brief Loads an image as 8-bit indices into a palette of its colours, added to the renderer's
+ * palettes and selected for the texture. Cyan is transparent, as for loadFromFile. An image of more
+ * than 256 colours is loaded as loadFromFile would.
+ *
+ * @param Path The path of the image.
+ * @param Renderer_Ptr The renderer that will draw this texture; the default one if omitted.
+ * @return true if successful; false otherwise.
+ **/
+bool LGLTexture::loadIndexedFromFile( const std::string& Path, LGLSpriteRenderer* Renderer_Ptr )
+{
+  free();
+
+  LGLSpriteRenderer* Renderer      = ( Renderer_Ptr != nullptr ) ? Renderer_Ptr : g_DefaultRenderer;
+  SDL_Surface*       LoadedSurface = IMG_Load( Path.c_str() );
+
+  if ( LoadedSurface == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  SDL_SetColorKey( LoadedSurface, SDL_TRUE, SDL_MapRGB( LoadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( LoadedSurface, SDL_PIXELFORMAT_RGBA32, 0 );
+  SDL_FreeSurface( LoadedSurface );
+
+  if ( Converted == NULL || Renderer == nullptr )
+  {
+    SDL_FreeSurface( Converted );
+    return false;
+  }
+  else
+  {;}
+
+  std::vector<Uint8> Indices( static_cast<size_t>( Converted->w ) * static_cast<size_t>( Converted->h ) );
+  SDL_Color          Palette[LGLSpriteRenderer::s_PALETTE_COLOURS];
+
+  SDL_LockSurface( Converted );
+  const int Colours = IndexPixels( Converted->pixels, Converted->w, Converted->h, Converted->pitch, SDL_PIXELFORMAT_RGBA32,
+                                   Indices.data(), Converted->w, Palette );
+  SDL_UnlockSurface( Converted );
+
+  bool Success = false;
+
+  if ( Colours == 0 )
+  {
+    printf( "\n\"%s\" has more than %d colours: loaded unindexed.", Path.c_str(), LGLSpriteRenderer::s_PALETTE_COLOURS );
+    Success = loadFromSurface( Converted, Renderer );
+  }
+  else
+  {
+    m_Palette = Renderer->addPalette( Palette, Colours );
+    Success   = m_Palette >= 0 && Renderer->AddIndexed_Pvt( Indices.data(), Converted->w, Converted->h, m_Page, m_Area );
+  }
+
+  if ( !Success )
+  {
+    printf( "\nUnable to add \"%s\" to the sprite atlas!", Path.c_str() );
+    free();
+  }
+  else
+  {
+    m_Renderer_Ptr = Renderer;
+  }
+
+  SDL_FreeSurface( Converted );
+
+  return Success;
+}
+
+
+void LGLTexture::free( void )
+{
+  m_Renderer_Ptr = nullptr;
+  m_Page         = -1;
+  m_Area         = SDL_Rect{ 0, 0, 0, 0 };
+  m_Palette      = 0;
+}
+
+
+void LGLTexture::setColor( Uint8 Red, Uint8 Green, Uint8 Blue )
+{
+  m_Colour.r = Red;
+  m_Colour.g = Green;
+  m_Colour.b = Blue;
+}
+
+
+void LGLTexture::setBlendMode( SDL_BlendMode Blending )
+{
+  m_BlendMode = Blending;
+}
+
+
+void LGLTexture::setAlpha( Uint8 Alpha )
+{
+  m_Colour.a = Alpha;
+}
+
+
+/**
+ * @brief Draws an indexed texture with another palette of its renderer, from now on; the sprites
+ * already queued keep theirs. Ignored by the other textures.
+ *
+ * @param Palette A row returned by LGLSpriteRenderer::addPalette.
+ **/
+void LGLTexture::setPalette( int Palette )
+{
+  m_Palette = std::min( std::max( Palette, 0 ), LGLSpriteRenderer::s_MAX_PALETTES - 1 );
+}
+
+
+/**
+ * @brief Queues the texture, or the clip of it, stretched to a rectangle, as LTexture::renderScaled
+ * draws it. The GPU picks the mip levels, if the renderer has them, by the size on screen.
+ **/
+void LGLTexture::renderScaled( const SDL_Rect& Destination, const SDL_Rect* Clip ) const
+{
+  if ( !isValid() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Source = ( Clip != NULL ) ? *Clip : SDL_Rect{ 0, 0, m_Area.w, m_Area.h };
+
+  m_Renderer_Ptr->Queue_Pvt( *this, Source, Destination, 0.0, NULL, SDL_FLIP_NONE );
+}
+
+
+/**
+ * @brief Queues the texture, or the clip of it, at the given point, as LTexture::render draws it.
+ **/
+void LGLTexture::render( int x, int y, const SDL_Rect* Clip, double Angle, const SDL_Point* Center, SDL_RendererFlip Flip ) const
+{
+  if ( !isValid() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Source      = ( Clip != NULL ) ? *Clip : SDL_Rect{ 0, 0, m_Area.w, m_Area.h };
+  const SDL_Rect Destination = { x, y, Source.w, Source.h };
+
+  m_Renderer_Ptr->Queue_Pvt( *this, Source, Destination, Angle, Center, Flip );
+}
+
+
+int LGLTexture::getWidth( void ) const
+{
+  return m_Area.w;
+}
+
+
+int LGLTexture::getHeight( void ) const
+{
+  return m_Area.h;
+}
+
+
+bool LGLTexture::isValid( void ) const
+{
+  return m_Renderer_Ptr != nullptr;
+}
+
+
+int LGLTexture::getPalette( void ) const
+{
+  return m_Palette;
+}
+
+
+/***************************************************************************************************
+* LGLSpriteRenderer methods
+****************************************************************************************************/
+
+LGLSpriteRenderer::LGLSpriteRenderer( void )
+  : m_Pages(), m_Sprites(), m_Order(), m_QuadProgram(0), m_InstancedProgram(0), m_QuadScreenSize(-1),
+    m_InstancedScreenSize(-1), m_QuadIsIndexed(-1), m_InstancedIsIndexed(-1), m_QuadVAO(0), m_InstancedVAO(0), m_VBO(0), m_IBO(0), m_CornerVBO(0),
+    m_Mapped_Ptr(nullptr), m_Fences(), m_Frame(0), m_Layer(1u << 15), m_ScreenW(1), m_ScreenH(1),
+    m_CanInstance(false), m_IsInstanced(false), m_LastDrawCalls(0), m_LastSprites(0), m_Dropped(0), m_MipLevels(1),
+    m_Gutter(1), m_BlockFormats(0), m_PaletteTexture(0), m_Palettes(0),
+    m_PaletteColours(), m_OwnState(), m_State_Ptr(&m_OwnState)
+{;}
+
+
+LGLSpriteRenderer::~LGLSpriteRenderer( void )
+{
+  free();
+}
+
+
+void LGLSpriteRenderer::SetDefault( LGLSpriteRenderer* Renderer_Ptr )
+{
+  g_DefaultRenderer = Renderer_Ptr;
+}
+
+
+LGLSpriteRenderer* LGLSpriteRenderer::GetDefault( void )
+{
+  return g_DefaultRenderer;
+}
+
+
+/**
+ * @brief Creates the programs and the buffers, and draws instanced from now on if the driver can.
+ * The OpenGL context must be current.
+ *
+ * @param ScreenW The width of the drawable, in the pixels the sprites are placed in.
+ * @param ScreenH Its height.
+ * @param MipLevels Of the pages, the full size included: 1 (the default) for none, up to
+ * s_MAX_MIP_LEVELS. More levels widen the gutter around the images.
+ * @return true if successful; false otherwise (everything is released).
+ **/
+bool LGLSpriteRenderer::init( int ScreenW, int ScreenH, int MipLevels )
+{
+  free();
+  setScreenSize( ScreenW, ScreenH );
+
+  m_MipLevels = std::min( std::max( MipLevels, 1 ), s_MAX_MIP_LEVELS );
+  m_Gutter    = 1 << ( m_MipLevels - 1 );
+
+  // Errors left by earlier calls, such as glewInit's, are not the renderer's
+  while ( glGetError() != GL_NO_ERROR )
+  {;}
+
+  m_CanInstance = GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays;
+
+  m_BlockFormats = 0;
+
+  if ( GLEW_EXT_texture_compression_s3tc )
+  {
+    m_BlockFormats |= getFormatBit( LBlockFormat::BC1 ) | getFormatBit( LBlockFormat::BC3 );
+  }
+  else
+  {;}
+
+  if ( GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility )
+  {
+    m_BlockFormats |= getFormatBit( LBlockFormat::ETC2_RGB ) | getFormatBit( LBlockFormat::ETC2_RGBA );
+  }
+  else
+  {;}
+
+  if ( !InitPrograms_Pvt() || !InitBuffers_Pvt() )
+  {
+    free();
+    return false;
+  }
+  else
+  {;}
+
+  m_IsInstanced = m_CanInstance;
+
+  return true;
+}
+
+
+/**
+ * @brief Releases the pages, buffers and programs; the textures loaded into them become invalid
+ * for drawing. The OpenGL context must be current.
+ **/
+void LGLSpriteRenderer::free( void )
+{
+  for ( GLsync& Fence : m_Fences )
+  {
+    if ( Fence != 0 )
+    {
+      glDeleteSync( Fence );
+      Fence = 0;
+    }
+    else
+    {;}
+  }
+
+  for ( Page& Each : m_Pages )
+  {
+    glDeleteTextures( 1, &Each.Texture );
+  }
+
+  if ( m_Mapped_Ptr != nullptr )
+  {
+    m_State_Ptr->bindArrayBuffer( m_VBO );
+    glUnmapBuffer( GL_ARRAY_BUFFER );
+    m_Mapped_Ptr = nullptr;
+  }
+  else
+  {;}
+
+  // Names 0 are ignored by the deletions
+  glDeleteBuffers( 1, &m_VBO );
+  glDeleteBuffers( 1, &m_IBO );
+  glDeleteBuffers( 1, &m_CornerVBO );
+  glDeleteVertexArrays( 1, &m_QuadVAO );
+  glDeleteVertexArrays( 1, &m_InstancedVAO );
+  glDeleteProgram( m_QuadProgram );
+  glDeleteProgram( m_InstancedProgram );
+  glDeleteTextures( 1, &m_PaletteTexture );
+
+  // The names just deleted may be bound, and the next objects created may get them
+  m_State_Ptr->invalidate();
+
+  m_Pages.clear();
+  m_Sprites.clear();
+  m_QuadProgram      = 0;
+  m_InstancedProgram = 0;
+  m_QuadVAO          = 0;
+  m_InstancedVAO     = 0;
+  m_VBO              = 0;
+  m_IBO              = 0;
+  m_CornerVBO        = 0;
+  m_PaletteTexture   = 0;
+  m_Palettes         = 0;
+  m_PaletteColours.clear();
+  m_Frame            = 0;
+  m_CanInstance      = false;
+  m_IsInstanced      = false;
+}
+
+
+/**
+ * @brief Sets the size of the area the sprites are placed in, in pixels; call when the drawable is
+ * resized.
+ **/
+void LGLSpriteRenderer::setScreenSize( int ScreenW, int ScreenH )
+{
+  m_ScreenW = std::max( ScreenW, 1 );
+  m_ScreenH = std::max( ScreenH, 1 );
+}
+
+
+/**
+ * @brief Sets the layer of the sprites queued from now on: lower layers are drawn first. Within a
+ * layer, sprites are grouped by blend mode and page.
+ **/
+void LGLSpriteRenderer::setLayer( Sint16 Layer )
+{
+  m_Layer = static_cast<Uint32>( Layer + 32768 );
+}
+
+
+/**
+ * @brief Chooses how the next flushes draw: instanced, one instance of a quad per sprite, or as
+ * quads whose corners the CPU computes. The sprites and draw calls are the same either way.
+ *
+ * @return false if instancing was asked for and the driver does not have it; the quads are kept.
+ **/
+bool LGLSpriteRenderer::setInstanced( bool IsInstanced )
+{
+  m_IsInstanced = IsInstanced && m_CanInstance;
+
+  return m_IsInstanced == IsInstanced;
+}
+
+
+/**
+ * @brief Draws every sprite queued since the last flush, with one call per run of sprites sharing
+ * layer, blend mode and page, then empties the queue. Leaves blending disabled and no program,
+ * vertex array or texture bound.
+ **/
+void LGLSpriteRenderer::flush( void )
+{
+  m_LastDrawCalls = 0;
+  m_LastSprites   = m_Sprites.size();
+
+  if ( m_Sprites.empty() || m_QuadProgram == 0 )
+  {
+    m_Sprites.clear();
+    return;
+  }
+  else
+  {;}
+
+  // The queue index in the low half keeps the call order among equal keys
+  m_Order.resize( m_Sprites.size() );
+
+  for ( size_t i = 0; i != m_Sprites.size(); ++i )
+  {
+    m_Order[i] = ( static_cast<Uint64>( m_Sprites[i].Key ) << 32 ) | i;
+  }
+
+  std::sort( m_Order.begin(), m_Order.end() );
+
+  const size_t SpriteBytes = m_IsInstanced ? sizeof(Instance) : s_VERTICES_PER_SPRITE * sizeof(Vertex);
+
+  // Code around the renderer's own cache may have changed anything since the last flush
+  if ( m_State_Ptr == &m_OwnState )
+  {
+    m_OwnState.invalidate();
+  }
+  else
+  {;}
+
+  m_State_Ptr->bindArrayBuffer( m_VBO );
+
+  Uint8* Data_Ptr = Map_Pvt( m_Sprites.size() * SpriteBytes );
+
+  if ( Data_Ptr == nullptr )
+  {
+    m_Sprites.clear();
+    return;
+  }
+  else
+  {;}
+
+  Write_Pvt( Data_Ptr );
+
+  if ( m_Mapped_Ptr == nullptr )
+  {
+    glUnmapBuffer( GL_ARRAY_BUFFER );
+  }
+  else
+  {;}
+
+  // The sprites of this frame start at the part of the buffer it wrote
+  const size_t Base = ( m_Mapped_Ptr != nullptr ) ? m_Frame * s_MAX_SPRITES * s_BYTES_PER_SPRITE : 0;
+
+  if ( m_IsInstanced )
+  {
+    m_State_Ptr->useProgram( m_InstancedProgram );
+    glUniform2f( m_InstancedScreenSize, static_cast<GLfloat>( m_ScreenW ), static_cast<GLfloat>( m_ScreenH ) );
+    m_State_Ptr->bindVertexArray( m_InstancedVAO );
+  }
+  else
+  {
+    m_State_Ptr->useProgram( m_QuadProgram );
+    glUniform2f( m_QuadScreenSize, static_cast<GLfloat>( m_ScreenW ), static_cast<GLfloat>( m_ScreenH ) );
+    m_State_Ptr->bindVertexArray( m_QuadVAO );
+    glVertexAttribPointer( QUAD_POSITION , 2, GL_FLOAT        , GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>( Base + offsetof( Vertex, X ) ) );
+    glVertexAttribPointer( QUAD_TEX_COORD, 2, GL_FLOAT        , GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>( Base + offsetof( Vertex, U ) ) );
+    glVertexAttribPointer( QUAD_COLOUR   , 4, GL_UNSIGNED_BYTE, GL_TRUE , sizeof(Vertex), reinterpret_cast<const void*>( Base + offsetof( Vertex, R ) ) );
+    glVertexAttribPointer( QUAD_PALETTE  , 1, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>( Base + offsetof( Vertex, Palette ) ) );
+  }
+
+  // The palettes stay on unit 1 for the whole flush; only whether the page is indexed changes
+  const GLint IsIndexedUniform = m_IsInstanced ? m_InstancedIsIndexed : m_QuadIsIndexed;
+  bool        IsIndexed        = false;
+
+  m_State_Ptr->bindTexture( 1, GL_TEXTURE_2D, m_PaletteTexture );
+  glUniform1i( IsIndexedUniform, 0 );
+
+  for ( size_t First = 0; First != m_Order.size(); )
+  {
+    const Uint32 Key  = static_cast<Uint32>( m_Order[First] >> 32 );
+    size_t       Last = First + 1;
+
+    while ( Last != m_Order.size() && static_cast<Uint32>( m_Order[Last] >> 32 ) == Key )
+    {
+      ++Last;
+    }
+
+    const Page& OnPage = m_Pages[ Key & ( MAX_PAGES - 1 ) ];
+
+    if ( OnPage.IsIndexed != IsIndexed )
+    {
+      IsIndexed = OnPage.IsIndexed;
+      glUniform1i( IsIndexedUniform, IsIndexed ? 1 : 0 );
+    }
+    else
+    {;}
+
+    SetBlendMode_Pvt( BLEND_MODES[ ( Key >> BLEND_SHIFT ) & 0xF ] );
+    m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, OnPage.Texture );
+    Draw_Pvt( Base, First, Last );
+
+    ++m_LastDrawCalls;
+    First = Last;
+  }
+
+  // The GPU reads this part of the buffer until the fence; the next frames write the others
+  if ( m_Mapped_Ptr != nullptr )
+  {
+    m_Fences[m_Frame] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    m_Frame           = ( m_Frame + 1 ) % s_FRAMES_IN_FLIGHT;
+  }
+  else
+  {;}
+
+  // With a shared cache the next pass binds only what it needs differently
+  if ( m_State_Ptr == &m_OwnState )
+  {
+    m_OwnState.setBlend( false );
+    m_OwnState.bindTexture( 1, GL_TEXTURE_2D, 0 );
+    m_OwnState.bindTexture( 0, GL_TEXTURE_2D, 0 );
+    m_OwnState.bindVertexArray( 0 );
+    m_OwnState.bindArrayBuffer( 0 );
+    m_OwnState.useProgram( 0 );
+  }
+  else
+  {;}
+
+  m_Sprites.clear();
+}
+
+
+/**
+ * @brief Adds a palette for the indexed textures, e.g. a recoloured copy of one of theirs; the first
+ * creates the palette texture. The OpenGL context must be current.
+ *
+ * @param Colours_Ptr Count colours, for indices 0 to Count - 1; the others are transparent.
+ * @return the row of the palette, for LGLTexture::setPalette; -1 if all s_MAX_PALETTES are taken.
+ **/
+int LGLSpriteRenderer::addPalette( const SDL_Color* Colours_Ptr, int Count )
+{
+  if ( m_QuadProgram == 0 || m_Palettes == s_MAX_PALETTES )
+  {
+    printf( "\nNo room for another sprite palette: %d palettes!", m_Palettes );
+    return -1;
+  }
+  else if ( m_PaletteTexture == 0 )
+  {
+    glGenTextures( 1, &m_PaletteTexture );
+    m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, m_PaletteTexture );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, s_PALETTE_COLOURS, s_MAX_PALETTES, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+  }
+  else
+  {;}
+
+  ++m_Palettes;
+  m_PaletteColours.resize( static_cast<size_t>( m_Palettes ) * s_PALETTE_COLOURS );
+
+  return updatePalette( m_Palettes - 1, Colours_Ptr, Count ) ? m_Palettes - 1 : -1;
+}
+
+
+/**
+ * @brief Rewrites a palette: every sprite drawn with it changes colour from the next flush, and
+ * nothing else is uploaded. The OpenGL context must be current.
+ *
+ * @param Palette A row returned by addPalette.
+ * @param Colours_Ptr Count colours, for indices 0 to Count - 1; the others are transparent.
+ * @return false if the row was never added.
+ **/
+bool LGLSpriteRenderer::updatePalette( int Palette, const SDL_Color* Colours_Ptr, int Count )
+{
+  if ( Palette < 0 || Palette >= m_Palettes || Colours_Ptr == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  // Copied first: the colours may be those of GetPalette
+  SDL_Color Row[s_PALETTE_COLOURS] = {};
+
+  std::copy( Colours_Ptr, Colours_Ptr + std::min( std::max( Count, 0 ), s_PALETTE_COLOURS ), Row );
+  std::copy( Row, Row + s_PALETTE_COLOURS, &m_PaletteColours[ static_cast<size_t>( Palette ) * s_PALETTE_COLOURS ] );
+
+  m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, m_PaletteTexture );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+  glTexSubImage2D( GL_TEXTURE_2D, 0, 0, Palette, s_PALETTE_COLOURS, 1, GL_RGBA, GL_UNSIGNED_BYTE, Row );
+
+  return true;
+}
+
+
+/**
+ * @brief Sets the state cache the renderer binds through, shared with the rest of the application
+ * so that the passes around the flush skip the bindings it leaves; nullptr goes back to the
+ * renderer's own. The new cache starts invalid for what the renderer is concerned: it is not told
+ * what the old one bound.
+ **/
+void LGLSpriteRenderer::setStateCache( LGLStateCache* State_Ptr )
+{
+  m_State_Ptr = ( State_Ptr != nullptr ) ? State_Ptr : &m_OwnState;
+  m_State_Ptr->invalidate();
+}
+
+
+/**
+ * @return the draw calls issued by the last flush.
+ **/
+int LGLSpriteRenderer::GetDrawCalls( void ) const
+{
+  return m_LastDrawCalls;
+}
+
+
+/**
+ * @return the sprites drawn by the last flush.
+ **/
+size_t LGLSpriteRenderer::GetSprites( void ) const
+{
+  return m_LastSprites;
+}
+
+
+/**
+ * @return the sprites not drawn since init, queued past s_MAX_SPRITES in a frame.
+ **/
+Uint32 LGLSpriteRenderer::GetDropped( void ) const
+{
+  return m_Dropped;
+}
+
+
+/**
+ * @return true if the vertex buffer is mapped persistently, false if it is mapped every frame.
+ **/
+bool LGLSpriteRenderer::IsPersistent( void ) const
+{
+  return m_Mapped_Ptr != nullptr;
+}
+
+
+/**
+ * @return true if the flushes draw instanced, false if they draw quads.
+ **/
+bool LGLSpriteRenderer::IsInstanced( void ) const
+{
+  return m_IsInstanced;
+}
+
+
+/**
+ * @return the levels of the mip chain of the pages, the full size included.
+ **/
+int LGLSpriteRenderer::GetMipLevels( void ) const
+{
+  return m_MipLevels;
+}
+
+
+/**
+ * @return whether the driver samples the block compressed format, so that the ".ltc" files baked in
+ * it are used; known once "init" succeeded.
+ **/
+bool LGLSpriteRenderer::IsBlockFormatSupported( LBlockFormat Format ) const
+{
+  return ( m_BlockFormats & getFormatBit( Format ) ) != 0;
+}
+
+
+/**
+ * @return the rows of the palette texture in use.
+ **/
+int LGLSpriteRenderer::GetPalettes( void ) const
+{
+  return m_Palettes;
+}
+
+
+/**
+ * @return the s_PALETTE_COLOURS colours of a palette, as last added or updated, to make recoloured
+ * copies of it; NULL if the row was never added.
+ **/
+const SDL_Color* LGLSpriteRenderer::GetPalette( int Palette ) const
+{
+  return ( Palette >= 0 && Palette < m_Palettes ) ? &m_PaletteColours[ static_cast<size_t>( Palette ) * s_PALETTE_COLOURS ] : NULL;
+}
+
+
+/**
+ * @return the memory of the pages, every mip level included, in bytes.
+ **/
+size_t LGLSpriteRenderer::GetTextureBytes( void ) const
+{
+  size_t Bytes = 0;
+
+  for ( const Page& Each : m_Pages )
+  {
+    Bytes += Each.Bytes;
+  }
+
+  return Bytes;
+}
+
+
+/**
+ * @brief Copies a surface into a page, with its edge texels repeated around it, and its smaller
+ * levels into those of the page.
+ *
+ * @return true, with the page and the area of the image in it, if successful.
+ **/
+bool LGLSpriteRenderer::Add_Pvt( SDL_Surface* Surface_Ptr, int& PageIndex, SDL_Rect& Area )
+{
+  if ( m_QuadProgram == 0 || Surface_Ptr == NULL || Surface_Ptr->w <= 0 || Surface_Ptr->h <= 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  SDL_Surface* Converted = SDL_ConvertSurfaceFormat( Surface_Ptr, SDL_PIXELFORMAT_RGBA32, 0 );
+
+  if ( Converted == NULL )
+  {
+    printf( "\nUnable to convert the image for the sprite atlas! SDL Error: %s", SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  const int Width  = Converted->w;
+  const int Height = Converted->h;
+
+  if ( !Place_Pvt( Width, Height, false, PageIndex, Area ) )
+  {
+    SDL_FreeSurface( Converted );
+    return false;
+  }
+  else
+  {;}
+
+  // The block of the image, gutter and alignment included, rows packed: row y and column x of the
+  // copy come from the nearest ones of the image
+  const int           PaddedW = getBlockSize( Width, m_Gutter );
+  const int           PaddedH = getBlockSize( Height, m_Gutter );
+  std::vector<Uint32> Padded( static_cast<size_t>( PaddedW ) * PaddedH );
+
+  SDL_LockSurface( Converted );
+
+  for ( int y = 0; y != PaddedH; ++y )
+  {
+    const int     SourceY = std::min( std::max( y - m_Gutter, 0 ), Height - 1 );
+    const Uint32* Row_Ptr = reinterpret_cast<const Uint32*>( static_cast<const Uint8*>( Converted->pixels ) + SourceY * Converted->pitch );
+
+    for ( int x = 0; x != PaddedW; ++x )
+    {
+      Padded[ static_cast<size_t>( y ) * PaddedW + x ] = Row_Ptr[ std::min( std::max( x - m_Gutter, 0 ), Width - 1 ) ];
+    }
+  }
+
+  SDL_UnlockSurface( Converted );
+  SDL_FreeSurface( Converted );
+
+  m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, m_Pages[PageIndex].Texture );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+  glTexSubImage2D( GL_TEXTURE_2D, 0, Area.x - m_Gutter, Area.y - m_Gutter, PaddedW, PaddedH, GL_RGBA, GL_UNSIGNED_BYTE, Padded.data() );
+
+  // Each level halved from the previous one; the block is a multiple of the smallest level's texel
+  std::vector<Uint32> Level;
+
+  for ( int i = 1; i < m_MipLevels; ++i )
+  {
+    const int LevelW = PaddedW >> i;
+    const int LevelH = PaddedH >> i;
+
+    Level.resize( static_cast<size_t>( LevelW ) * LevelH );
+    HalvePixels( Padded.data(), LevelW * 2, LevelH * 2, LevelW * 2 * 4, Level.data(), LevelW * 4, SDL_PIXELFORMAT_RGBA32 );
+    glTexSubImage2D( GL_TEXTURE_2D, i, ( Area.x - m_Gutter ) >> i, ( Area.y - m_Gutter ) >> i, LevelW, LevelH, GL_RGBA, GL_UNSIGNED_BYTE, Level.data() );
+
+    Padded.swap( Level );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Uploads a block compressed image baked by BakeTextures into a page of its own, full from
+ * the start: the blocks cannot be padded with a gutter, and the page is the image, clamped at its
+ * edges. The mapped blocks go to the driver as they are, the levels the file and the renderer both
+ * have.
+ *
+ * @param Path The path of the ".ltc" file; a missing file is not an error, as most images have none.
+ * @return true, with the page and the area of the image in it, if successful; false if the image
+ * has to be loaded decoded instead.
+ **/
+bool LGLSpriteRenderer::AddCompressed_Pvt( const std::string& Path, int& PageIndex, SDL_Rect& Area )
+{
+  LMappedFile  File;
+  LAssetPack*  Pack_Ptr = LAssetPack::GetDefault();
+  const Uint8* Data_Ptr = nullptr;
+  size_t       Size     = 0;
+
+  if ( m_QuadProgram == 0 )
+  {
+    return false;
+  }
+  else if ( Pack_Ptr == nullptr || !Pack_Ptr->IsOpen() || !Pack_Ptr->view( Path, Data_Ptr, Size ) )
+  {
+    File.open( Path.c_str() );
+    Data_Ptr = File.GetData();
+    Size     = File.GetSize();
+  }
+  else
+  {;}
+
+  LBakedBlocksHeader Header;
+
+  if ( Data_Ptr == nullptr )
+  {
+    return false;
+  }
+  else if ( Size < sizeof(Header) )
+  {
+    printf( "\nCompressed texture \"%s\" is truncated!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  memcpy( &Header, Data_Ptr, sizeof(Header) );
+
+  const LBlockFormat Format  = static_cast<LBlockFormat>( Header.Format );
+  const bool         IsKnown = Header.Format >= static_cast<Uint32>( LBlockFormat::BC1 ) && Header.Format <= static_cast<Uint32>( LBlockFormat::ETC2_RGBA );
+  size_t             Bytes   = 0;
+
+  for ( Uint32 i = 0; IsKnown && Header.Width > 0 && Header.Height > 0 && i < Header.Levels && i < LBAKED_TEXTURE_MAX_LEVELS; ++i )
+  {
+    const SDL_Point LevelSize = LBakedMipSize( Header.Width, Header.Height, static_cast<int>( i ) );
+
+    Bytes += GetCompressedSize( Format, LevelSize.x, LevelSize.y );
+  }
+
+  if ( memcmp( Header.Magic, LBAKED_BLOCKS_MAGIC, sizeof(Header.Magic) ) != 0 || Header.Version != LBAKED_BLOCKS_VERSION || !IsKnown ||
+       Header.Width <= 0 || Header.Height <= 0 || Header.Levels == 0 || Header.Levels > LBAKED_TEXTURE_MAX_LEVELS ||
+       Size < sizeof(Header) + Bytes )
+  {
+    printf( "\nCompressed texture \"%s\" is not valid!", Path.c_str() );
+    return false;
+  }
+  else if ( !IsBlockFormatSupported( Format ) )
+  {
+    printf( "\nCompressed texture \"%s\" is in %s, which the driver does not support: decoding the image instead.",
+            Path.c_str(), GetBlockFormatName( Format ) );
+    return false;
+  }
+  else if ( m_Pages.size() == MAX_PAGES )
+  {
+    printf( "\nThe sprite atlas is full: %u pages!", MAX_PAGES );
+    return false;
+  }
+  else
+  {;}
+
+  const int Levels  = std::min( static_cast<int>( Header.Levels ), m_MipLevels );
+  Page      NewPage = { 0, Header.Width, Header.Height, Header.Width, Header.Height, 0, 0, false };
+
+  // Blocks are read whole rows of bytes at a time: no unpack alignment applies to them
+  const Uint8* Level_Ptr = Data_Ptr + sizeof(Header);
+
+  glGenTextures( 1, &NewPage.Texture );
+  m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, NewPage.Texture );
+
+  for ( int i = 0; i != Levels; ++i )
+  {
+    const SDL_Point LevelSize  = LBakedMipSize( Header.Width, Header.Height, i );
+    const size_t    LevelBytes = GetCompressedSize( Format, LevelSize.x, LevelSize.y );
+
+    glCompressedTexImage2D( GL_TEXTURE_2D, i, BLOCK_FORMATS[ Header.Format ], LevelSize.x, LevelSize.y, 0,
+                            static_cast<GLsizei>( LevelBytes ), Level_Ptr );
+    Level_Ptr     += LevelBytes;
+    NewPage.Bytes += LevelBytes;
+  }
+
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, Levels - 1 );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ( Levels > 1 ) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+  glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+
+  if ( NewPage.Texture == 0 || glGetError() != GL_NO_ERROR )
+  {
+    printf( "\nUnable to upload compressed texture \"%s\": decoding the image instead.", Path.c_str() );
+    glDeleteTextures( 1, &NewPage.Texture );
+    return false;
+  }
+  else
+  {;}
+
+  m_Pages.push_back( NewPage );
+
+  PageIndex = static_cast<int>( m_Pages.size() ) - 1;
+  Area      = SDL_Rect{ 0, 0, Header.Width, Header.Height };
+
+  return true;
+}
+
+
+/**
+ * @brief Copies the indices of an image into an indexed page, with its edge texels repeated around
+ * it as for the other images.
+ *
+ * @return true, with the page and the area of the image in it, if successful.
+ **/
+bool LGLSpriteRenderer::AddIndexed_Pvt( const Uint8* Indices_Ptr, int Width, int Height, int& PageIndex, SDL_Rect& Area )
+{
+  if ( m_QuadProgram == 0 || Indices_Ptr == nullptr || Width <= 0 || Height <= 0 || !Place_Pvt( Width, Height, true, PageIndex, Area ) )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  const int          PaddedW = getBlockSize( Width, m_Gutter );
+  const int          PaddedH = getBlockSize( Height, m_Gutter );
+  std::vector<Uint8> Padded( static_cast<size_t>( PaddedW ) * PaddedH );
+
+  for ( int y = 0; y != PaddedH; ++y )
+  {
+    const Uint8* Row_Ptr = Indices_Ptr + static_cast<size_t>( std::min( std::max( y - m_Gutter, 0 ), Height - 1 ) ) * Width;
+
+    for ( int x = 0; x != PaddedW; ++x )
+    {
+      Padded[ static_cast<size_t>( y ) * PaddedW + x ] = Row_Ptr[ std::min( std::max( x - m_Gutter, 0 ), Width - 1 ) ];
+    }
+  }
+
+  m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, m_Pages[PageIndex].Texture );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+  glTexSubImage2D( GL_TEXTURE_2D, 0, Area.x - m_Gutter, Area.y - m_Gutter, PaddedW, PaddedH, GL_RED, GL_UNSIGNED_BYTE, Padded.data() );
+  glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+  return true;
+}
+
+
+/**
+ * @brief Finds room for an image of the given size, in a block with its gutter, on the current row
+ * of the last page of its kind, on a new row, or on a new page. Blocks are multiples of the gutter,
+ * so all of them start on a texel of the smallest mip level.
+ *
+ * @param IsIndexed Whether the image goes into a page of indices: one level of GL_R8, read at the
+ * nearest texel, as indices cannot be filtered; else into one of RGBA8, with the mip levels.
+ * @return true, with the page and the area of the image without its gutter, if successful.
+ **/
+bool LGLSpriteRenderer::Place_Pvt( int ImageW, int ImageH, bool IsIndexed, int& PageIndex, SDL_Rect& Area )
+{
+  const int Width    = getBlockSize( ImageW, m_Gutter );
+  const int Height   = getBlockSize( ImageH, m_Gutter );
+  Page*     Last_Ptr = nullptr;
+
+  for ( size_t i = m_Pages.size(); i != 0 && Last_Ptr == nullptr; --i )
+  {
+    Last_Ptr = ( m_Pages[ i - 1 ].IsIndexed == IsIndexed ) ? &m_Pages[ i - 1 ] : nullptr;
+  }
+
+  if ( Last_Ptr != nullptr && Last_Ptr->RowX + Width > Last_Ptr->Width )
+  {
+    Last_Ptr->RowY     += Last_Ptr->RowHeight;
+    Last_Ptr->RowX      = 0;
+    Last_Ptr->RowHeight = 0;
+  }
+  else
+  {;}
+
+  if ( Last_Ptr == nullptr || Last_Ptr->RowX + Width > Last_Ptr->Width || Last_Ptr->RowY + Height > Last_Ptr->Height )
+  {
+    if ( m_Pages.size() == MAX_PAGES )
+    {
+      printf( "\nThe sprite atlas is full: %u pages!", MAX_PAGES );
+      return false;
+    }
+    else
+    {;}
+
+    const int Size    = std::max( s_PAGE_SIZE, std::max( Width, Height ) );
+    const int Levels  = IsIndexed ? 1 : m_MipLevels;
+    Page      NewPage = { 0, Size, Size, 0, 0, 0, 0, IsIndexed };
+
+    glGenTextures( 1, &NewPage.Texture );
+    m_State_Ptr->bindTexture( 0, GL_TEXTURE_2D, NewPage.Texture );
+
+    for ( int i = 0; i != Levels; ++i )
+    {
+      if ( IsIndexed )
+      {
+        glTexImage2D( GL_TEXTURE_2D, i, GL_R8, Size >> i, Size >> i, 0, GL_RED, GL_UNSIGNED_BYTE, NULL );
+      }
+      else
+      {
+        glTexImage2D( GL_TEXTURE_2D, i, GL_RGBA8, Size >> i, Size >> i, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+      }
+
+      NewPage.Bytes += static_cast<size_t>( Size >> i ) * static_cast<size_t>( Size >> i ) * ( IsIndexed ? 1 : 4 );
+    }
+
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, Levels - 1 );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, IsIndexed ? GL_NEAREST : ( m_MipLevels > 1 ) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, IsIndexed ? GL_NEAREST : GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+
+    if ( NewPage.Texture == 0 )
+    {
+      printf( "\nUnable to create a %dx%d sprite page!", Size, Size );
+      return false;
+    }
+    else
+    {;}
+
+    m_Pages.push_back( NewPage );
+    Last_Ptr = &m_Pages.back();
+  }
+  else
+  {;}
+
+  PageIndex = static_cast<int>( m_Pages.size() ) - 1;
+  Area      = SDL_Rect{ Last_Ptr->RowX + m_Gutter, Last_Ptr->RowY + m_Gutter, ImageW, ImageH };
+
+  Last_Ptr->RowX      += Width;
+  Last_Ptr->RowHeight  = std::max( Last_Ptr->RowHeight, Height );
+
+  return true;
+}
+
+
+/**
+ * @brief Writes a sprite, flipped and rotated about Center, into the queue.
+ **/
+void LGLSpriteRenderer::Queue_Pvt( const LGLTexture& Texture, const SDL_Rect& Source, const SDL_Rect& Destination,
+                                   double Angle, const SDL_Point* Center, SDL_RendererFlip Flip )
+{
+  if ( Texture.m_Page < 0 || static_cast<size_t>( Texture.m_Page ) >= m_Pages.size() )
+  {
+    return; // Loaded before the renderer was freed
+  }
+  else if ( m_Sprites.size() == s_MAX_SPRITES )
+  {
+    ++m_Dropped;
+    return;
+  }
+  else
+  {;}
+
+  const Page&     OnPage = m_Pages[Texture.m_Page];
+  const float     ScaleU = 1.0f / static_cast<float>( OnPage.Width );
+  const float     ScaleV = 1.0f / static_cast<float>( OnPage.Height );
+  const SDL_Rect& Area   = Texture.m_Area;
+
+  m_Sprites.emplace_back();
+
+  Sprite&   Queued = m_Sprites.back();
+  Instance& Data   = Queued.Data;
+
+  Queued.Key = ( m_Layer << LAYER_SHIFT ) | ( getBlendIndex( Texture.m_BlendMode ) << BLEND_SHIFT ) | static_cast<Uint32>( Texture.m_Page );
+
+  Data.X       = static_cast<float>( Destination.x );
+  Data.Y       = static_cast<float>( Destination.y );
+  Data.W       = static_cast<float>( Destination.w );
+  Data.H       = static_cast<float>( Destination.h );
+  Data.CenterX = ( Center != NULL ) ? static_cast<float>( Center->x ) : Data.W * 0.5f;
+  Data.CenterY = ( Center != NULL ) ? static_cast<float>( Center->y ) : Data.H * 0.5f;
+  Data.Angle   = static_cast<float>( Angle * DEGREES_TO_RAD );
+  Data.U0      = static_cast<float>( Area.x + Source.x ) * ScaleU;
+  Data.V0      = static_cast<float>( Area.y + Source.y ) * ScaleV;
+  Data.U1      = static_cast<float>( Area.x + Source.x + Source.w ) * ScaleU;
+  Data.V1      = static_cast<float>( Area.y + Source.y + Source.h ) * ScaleV;
+  Data.R       = Texture.m_Colour.r;
+  Data.G       = Texture.m_Colour.g;
+  Data.B       = Texture.m_Colour.b;
+  Data.A       = Texture.m_Colour.a;
+  Data.Palette = static_cast<Uint8>( Texture.m_Palette );
+
+  if ( ( Flip & SDL_FLIP_HORIZONTAL ) != 0 )
+  {
+    std::swap( Data.U0, Data.U1 );
+  }
+  else
+  {;}
+
+  if ( ( Flip & SDL_FLIP_VERTICAL ) != 0 )
+  {
+    std::swap( Data.V0, Data.V1 );
+  }
+  else
+  {;}
+}
+
+
+bool LGLSpriteRenderer::InitPrograms_Pvt( void )
+{
+  m_QuadProgram = linkProgram( *m_State_Ptr, QuadVertexSource, QuadAttributeNames, std::size( QuadAttributeNames ) );
+
+  if ( m_QuadProgram == 0 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  m_QuadScreenSize = glGetUniformLocation( m_QuadProgram, "ScreenSize" );
+  m_QuadIsIndexed  = glGetUniformLocation( m_QuadProgram, "IsIndexed" );
+
+  if ( !m_CanInstance )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  // A driver that cannot build it draws quads
+  m_InstancedProgram = linkProgram( *m_State_Ptr, InstancedVertexSource, InstanceAttributeNames, std::size( InstanceAttributeNames ) );
+  m_CanInstance      = m_InstancedProgram != 0;
+
+  if ( m_CanInstance )
+  {
+    m_InstancedScreenSize = glGetUniformLocation( m_InstancedProgram, "ScreenSize" );
+    m_InstancedIsIndexed  = glGetUniformLocation( m_InstancedProgram, "IsIndexed" );
+  }
+  else
+  {;}
+
+  return true;
+}
+
+
+/**
+ * @brief Creates the buffer of the sprites, persistently mapped if the driver allows it, the index
+ * buffer, the same two triangles per sprite for the whole frame, written once, and the vertex arrays
+ * of both ways of drawing. The instanced one reads the unit quad per vertex and the rest per
+ * instance, from where flush points it.
+ **/
+bool LGLSpriteRenderer::InitBuffers_Pvt( void )
+{
+  const size_t FrameBytes = s_MAX_SPRITES * s_BYTES_PER_SPRITE;
+
+  glGenVertexArrays( 1, &m_QuadVAO );
+  glGenBuffers( 1, &m_VBO );
+  glGenBuffers( 1, &m_IBO );
+
+  m_State_Ptr->bindVertexArray( m_QuadVAO );
+  m_State_Ptr->bindArrayBuffer( m_VBO );
+
+  if ( GLEW_ARB_buffer_storage && GLEW_ARB_sync )
+  {
+    const GLbitfield Flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glBufferStorage( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( FrameBytes * s_FRAMES_IN_FLIGHT ), NULL, Flags );
+    m_Mapped_Ptr = static_cast<Uint8*>( glMapBufferRange( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>( FrameBytes * s_FRAMES_IN_FLIGHT ), Flags ) );
+  }
+  else
+  {;}
+
+  if ( m_Mapped_Ptr == nullptr )
+  {
+    // Either no buffer storage, or a failed mapping: the buffer is then recreated, as storage is immutable
+    glDeleteBuffers( 1, &m_VBO );
+    glGenBuffers( 1, &m_VBO );
+    m_State_Ptr->invalidate();    // The new buffer may have the name of the old one
+    m_State_Ptr->bindArrayBuffer( m_VBO );
+    glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( FrameBytes ), NULL, GL_STREAM_DRAW );
+  }
+  else
+  {;}
+
+  std::vector<GLuint> Indices( s_MAX_SPRITES * s_INDICES_PER_SPRITE );
+
+  for ( size_t i = 0; i != s_MAX_SPRITES; ++i )
+  {
+    const GLuint Corner = static_cast<GLuint>( i * s_VERTICES_PER_SPRITE );
+    GLuint*      Quad   = &Indices[ i * s_INDICES_PER_SPRITE ];
+
+    Quad[0] = Corner;
+    Quad[1] = Corner + 1;
+    Quad[2] = Corner + 2;
+    Quad[3] = Corner + 2;
+    Quad[4] = Corner + 3;
+    Quad[5] = Corner;
+  }
+
+  glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_IBO );
+  glBufferData( GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>( Indices.size() * sizeof(GLuint) ), Indices.data(), GL_STATIC_DRAW );
+
+  glEnableVertexAttribArray( QUAD_POSITION );
+  glEnableVertexAttribArray( QUAD_TEX_COORD );
+  glEnableVertexAttribArray( QUAD_COLOUR );
+  glEnableVertexAttribArray( QUAD_PALETTE );
+
+  if ( m_CanInstance )
+  {
+    // The first sprite's six indices draw the unit quad
+    glGenVertexArrays( 1, &m_InstancedVAO );
+    glGenBuffers( 1, &m_CornerVBO );
+
+    m_State_Ptr->bindVertexArray( m_InstancedVAO );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_IBO );
+    m_State_Ptr->bindArrayBuffer( m_CornerVBO );
+    glBufferData( GL_ARRAY_BUFFER, sizeof(QuadCorners), QuadCorners, GL_STATIC_DRAW );
+    glVertexAttribPointer( INSTANCE_CORNER, 2, GL_FLOAT, GL_FALSE, 0, NULL );
+    glEnableVertexAttribArray( INSTANCE_CORNER );
+
+    for ( GLuint Attribute = INSTANCE_RECT; Attribute <= INSTANCE_PALETTE; ++Attribute )
+    {
+      glEnableVertexAttribArray( Attribute );
+
+      if ( GLEW_VERSION_3_3 )
+      {
+        glVertexAttribDivisor( Attribute, 1 );
+      }
+      else
+      {
+        glVertexAttribDivisorARB( Attribute, 1 );
+      }
+    }
+  }
+  else
+  {;}
+
+  // Unbound, so that no later element buffer binding lands in them
+  m_State_Ptr->bindVertexArray( 0 );
+
+  return glGetError() == GL_NO_ERROR;
+}
+
+
+/**
+ * @brief The buffer bound, returns where the sprites of this frame go: the part of the persistent
+ * mapping the GPU finished reading, waited for if it has not yet, or a fresh mapping of Bytes whose
+ * old contents the driver may discard.
+ **/
+Uint8* LGLSpriteRenderer::Map_Pvt( size_t Bytes )
+{
+  if ( m_Mapped_Ptr == nullptr )
+  {
+    return static_cast<Uint8*>( glMapBufferRange( GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>( Bytes ),
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT ) );
+  }
+  else
+  {;}
+
+  GLsync& Fence = m_Fences[m_Frame];
+
+  if ( Fence != 0 )
+  {
+    GLenum Result = GL_TIMEOUT_EXPIRED;
+
+    while ( Result == GL_TIMEOUT_EXPIRED )
+    {
+      Result = glClientWaitSync( Fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_ns );
+    }
+
+    glDeleteSync( Fence );
+    Fence = 0;
+  }
+  else
+  {;}
+
+  return m_Mapped_Ptr + m_Frame * s_MAX_SPRITES * s_BYTES_PER_SPRITE;
+}
+
+
+/**
+ * @brief Writes the queue, in sorted order, as the current way of drawing reads it: the instances as
+ * they are, or the four corners of each, rotated about its centre, clockwise on screen as for
+ * SDL_RenderCopyEx.
+ **/
+void LGLSpriteRenderer::Write_Pvt( Uint8* Data_Ptr ) const
+{
+  if ( m_IsInstanced )
+  {
+    Instance* Instances_Ptr = reinterpret_cast<Instance*>( Data_Ptr );
+
+    for ( size_t i = 0; i != m_Order.size(); ++i )
+    {
+      Instances_Ptr[i] = m_Sprites[ m_Order[i] & 0xFFFFFFFF ].Data;
+    }
+
+    return;
+  }
+  else
+  {;}
+
+  Vertex* Vertices_Ptr = reinterpret_cast<Vertex*>( Data_Ptr );
+
+  for ( size_t i = 0; i != m_Order.size(); ++i )
+  {
+    const Instance& Data  = m_Sprites[ m_Order[i] & 0xFFFFFFFF ].Data;
+    const float     Cos   = std::cos( Data.Angle );
+    const float     Sin   = std::sin( Data.Angle );
+    const float     Xs[4] = { -Data.CenterX, Data.W - Data.CenterX, Data.W - Data.CenterX, -Data.CenterX };
+    const float     Ys[4] = { -Data.CenterY, -Data.CenterY, Data.H - Data.CenterY, Data.H - Data.CenterY };
+    const float     Us[4] = { Data.U0, Data.U1, Data.U1, Data.U0 };
+    const float     Vs[4] = { Data.V0, Data.V0, Data.V1, Data.V1 };
+
+    for ( size_t Corner = 0; Corner != s_VERTICES_PER_SPRITE; ++Corner )
+    {
+      Vertex& Written = Vertices_Ptr[ i * s_VERTICES_PER_SPRITE + Corner ];
+
+      Written.X = Data.X + Data.CenterX + Xs[Corner] * Cos - Ys[Corner] * Sin;
+      Written.Y = Data.Y + Data.CenterY + Xs[Corner] * Sin + Ys[Corner] * Cos;
+      Written.U = Us[Corner];
+      Written.V = Vs[Corner];
+      Written.R = Data.R;
+      Written.G = Data.G;
+      Written.B = Data.B;
+      Written.A = Data.A;
+      Written.Palette = Data.Palette;
+    }
+  }
+}
+
+
+/**
+ * @brief Draws the sorted sprites from First to Last, excluded, of the frame written at Base. The
+ * instanced way points the per instance attributes at the first of them, as OpenGL 3.x has no base
+ * instance to draw from.
+ **/
+void LGLSpriteRenderer::Draw_Pvt( size_t Base, size_t First, size_t Last ) const
+{
+  const GLsizei Count = static_cast<GLsizei>( Last - First );
+
+  if ( m_IsInstanced )
+  {
+    const size_t Start = Base + First * sizeof(Instance);
+
+    glVertexAttribPointer( INSTANCE_RECT        , 4, GL_FLOAT        , GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>( Start + offsetof( Instance, X ) ) );
+    glVertexAttribPointer( INSTANCE_CENTER_ANGLE, 3, GL_FLOAT        , GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>( Start + offsetof( Instance, CenterX ) ) );
+    glVertexAttribPointer( INSTANCE_TEX_RECT    , 4, GL_FLOAT        , GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>( Start + offsetof( Instance, U0 ) ) );
+    glVertexAttribPointer( INSTANCE_COLOUR      , 4, GL_UNSIGNED_BYTE, GL_TRUE , sizeof(Instance), reinterpret_cast<const void*>( Start + offsetof( Instance, R ) ) );
+    glVertexAttribPointer( INSTANCE_PALETTE     , 1, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>( Start + offsetof( Instance, Palette ) ) );
+    glDrawElementsInstanced( GL_TRIANGLES, s_INDICES_PER_SPRITE, GL_UNSIGNED_INT, NULL, Count );
+  }
+  else
+  {
+    glDrawElements( GL_TRIANGLES, Count * static_cast<GLsizei>( s_INDICES_PER_SPRITE ), GL_UNSIGNED_INT,
+                    reinterpret_cast<const void*>( First * s_INDICES_PER_SPRITE * sizeof(GLuint) ) );
+  }
+}
+
+
+/**
+ * @brief Sets the blend functions SDL_Renderer uses for the blend mode.
+ **/
+void LGLSpriteRenderer::SetBlendMode_Pvt( SDL_BlendMode Mode ) const
+{
+  if ( Mode == SDL_BLENDMODE_NONE )
+  {
+    m_State_Ptr->setBlend( false );
+    return;
+  }
+  else
+  {;}
+
+  m_State_Ptr->setBlend( true );
+
+  switch ( Mode )
+  {
+    case SDL_BLENDMODE_ADD:
+    m_State_Ptr->blendFuncSeparate( GL_SRC_ALPHA, GL_ONE, GL_ZERO, GL_ONE );
+    break;
+
+    case SDL_BLENDMODE_MOD:
+    m_State_Ptr->blendFuncSeparate( GL_ZERO, GL_SRC_COLOR, GL_ZERO, GL_ONE );
+    break;
+
+    case SDL_BLENDMODE_MUL:
+    m_State_Ptr->blendFuncSeparate( GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA, GL_DST_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+    break;
+
+    default:
+    m_State_Ptr->blendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+    break;
+  }
+}
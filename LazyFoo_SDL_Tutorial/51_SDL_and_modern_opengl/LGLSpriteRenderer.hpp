@@ -0,0 +1,274 @@
+/**
+ * @file LGLSpriteRenderer.hpp
+ *
+ * @brief Sprite backend on modern OpenGL: textures packed into atlas pages, and every sprite of the
+ * frame drawn with one call per page and blend mode, instanced where the driver allows it, out of a
+ * buffer that stays mapped.
+ **/
+
+#ifndef LGLSPRITERENDERER_HPP
+#define LGLSPRITERENDERER_HPP
+
+#include <SDL.h>
+#include <glew.h>
+#include <string>
+#include <vector>
+
+#include "LBlockCompress.hpp"
+#include "LGLStateCache.hpp"
+
+class LGLSpriteRenderer;
+
+/**
+ * @brief A texture drawn by an LGLSpriteRenderer. Its methods are those of LTexture, so that code
+ * written against LTexture switches backend by switching type: "render" takes the same arguments,
+ * rotation and flipping included, but only queues the sprite, which is drawn by the next "flush".
+ *
+ * The image is copied into an atlas page of the renderer, shared with other textures; "free" lets
+ * the texture go, but its space in the page is only given back when the renderer is freed. An image
+ * baked block compressed ("<image>.ltc", BakeTextures --compress) gets a page of its own instead,
+ * uploaded as it is, when the driver samples its format.
+ *
+ * "loadIndexedFromFile" keeps the image as 8-bit indices into a palette of its colours, resolved by
+ * the fragment shader: a fourth of the memory, for images of up to 256 colours such as the dot and
+ * the tilesets. "setPalette" draws it with any other palette of the renderer, e.g. a recoloured
+ * copy of its own, at no cost: nothing is uploaded again, and the sprites of each palette still
+ * share their draw calls.
+ **/
+class LGLTexture
+{
+public:
+
+   LGLTexture( void );
+  ~LGLTexture( void );
+
+  bool loadFromFile       ( const std::string&, LGLSpriteRenderer* = nullptr );
+  bool loadFromSurface    ( SDL_Surface*, LGLSpriteRenderer* = nullptr );
+  bool loadIndexedFromFile( const std::string&, LGLSpriteRenderer* = nullptr );
+
+  void free        ( void );
+  void setColor    ( Uint8, Uint8, Uint8 );
+  void setBlendMode( SDL_BlendMode );
+  void setAlpha    ( Uint8 );
+  void setPalette  ( int );
+  void render      ( int, int, const SDL_Rect* = NULL, double = 0.0, const SDL_Point* = NULL, SDL_RendererFlip = SDL_FLIP_NONE ) const;
+  void renderScaled( const SDL_Rect&, const SDL_Rect* = NULL ) const;
+
+  int  getWidth ( void ) const;
+  int  getHeight( void ) const;
+  bool isValid  ( void ) const;
+  int  getPalette( void ) const;
+
+private:
+
+  friend class LGLSpriteRenderer;
+
+  LGLSpriteRenderer* m_Renderer_Ptr;   // The renderer whose atlas holds the image
+  int                m_Page;
+  SDL_Rect           m_Area;           // In the page, in texels
+  SDL_Colour         m_Colour;         // Colour and alpha modulation
+  SDL_BlendMode      m_BlendMode;
+  int                m_Palette;        // Row of the renderer's palettes; only read for indexed images
+};
+
+
+/**
+ * @brief Collects the sprites of a frame and draws them in as few calls as possible.
+ *
+ * Images are packed into pages of s_PAGE_SIZE texels a side, in rows, with their edge texels
+ * repeated around them so that linear filtering never reads a neighbour; an image larger than a
+ * page gets a page of its own.
+ *
+ * Mip levels: with more than one (see "init"), the pages have a mip chain, sampled trilinearly, so
+ * that sprites drawn smaller than they are ("renderScaled"), as in a zoomed out view or a minimap,
+ * read texels near their size on screen instead of skipping most of the full size ones. Each level
+ * is halved on the CPU from the previous one as the image is added, weighting the colours by their
+ * alpha (HalvePixels, Engine_Lib/LPixelOps), rather than by glGenerateMipmap: the colour key would
+ * bleed into the edges, and the whole page would be filtered again for every image. So that a level
+ * never mixes two images, each image with its gutter takes a block aligned to, and a multiple of,
+ * the size of a texel of the smallest level, and the gutter is as wide as that texel: with 4 levels,
+ * 8 texels around every image.
+ *
+ * Every "render" writes one instance into a queue: where the sprite goes, its size, centre and
+ * angle of rotation, its area of the page, flipped, its colour and palette. "flush" sorts the queue by
+ * layer, blend mode and page, in this order and keeping the order of the calls within each, and
+ * draws every run of sprites sharing all three with a single call: sprites of different pages or
+ * blend modes in the same layer are not drawn in call order, so put on separate layers the ones
+ * that must overlap in order. A tileset is a page, so a tile map costs one call per frame.
+ *
+ * The run is drawn in one of two ways:
+ * - instanced (the default where ARB_instanced_arrays, core in OpenGL 3.3, is available): the
+ *   instances go into the buffer as they are, 52 bytes each, and glDrawElementsInstanced draws
+ *   the same quad once per instance, placed, rotated and clipped by the vertex shader;
+ * - as quads: the CPU turns every instance into its four corners, 96 bytes, drawn by glDrawElements.
+ *
+ * The buffer holds s_FRAMES_IN_FLIGHT frames of s_MAX_SPRITES each. With ARB_buffer_storage it is
+ * mapped once, persistently, and each frame writes the part the GPU finished reading, as told by a
+ * fence: no map, copy or synchronisation by the driver per frame. Without it, the buffer is mapped
+ * every frame with its old contents discarded.
+ *
+ * Block compressed images: "loadFromFile" looks for a "<image>.ltc" next to the image first. If the
+ * driver samples its format (BCn with EXT_texture_compression_s3tc on desktops, ETC2 with OpenGL
+ * 4.3 or ARB_ES3_compatibility, core on OpenGL ES 3.0), the blocks are uploaded as they are, with
+ * glCompressedTexImage2D and their baked mip levels, into a page of their own: a fourth (BC3, ETC2
+ * RGBA) to an eighth (BC1, ETC2 RGB) of the memory of RGBA8, and no decoding at load time. Bake with
+ * "--compress=bc" for desktops and "--compress=etc2" for OpenGL ES devices. Otherwise the image is
+ * decoded and packed as usual: the ".ltc" is only a faster path, never required. "GetTextureBytes"
+ * reports the memory of all the pages.
+ *
+ * Indexed images: their pages hold one byte per texel (GL_R8), sampled at the nearest texel, without
+ * mip levels, and the fragment shader looks the index up in a palette texture of s_MAX_PALETTES rows
+ * of 256 colours. Every sprite carries the row of its palette, so that sprites of the same page with
+ * different palettes are still drawn together. "addPalette" adds a row, "updatePalette" rewrites
+ * one: all the sprites using it change colour with a single upload of 1 KB. Palettes are kept until
+ * the renderer is freed.
+ *
+ * OpenGL state: the program, vertex array, buffer, textures and blending are set through an
+ * LGLStateCache, so that the runs of a flush only change what differs from the previous run. The
+ * renderer has a cache of its own, which it invalidates before every flush and leaves everything
+ * unbound after it, as code around it may use OpenGL directly. "setStateCache" shares the cache of
+ * the application instead: the flush then neither forgets nor resets the state, and the passes
+ * drawn before and after it skip whatever it left as they need it. The shared cache must outlive
+ * the renderer, or be replaced before it goes.
+ *
+ * The renderer needs a current OpenGL 3.1 context and GLEW initialised for "init", and the same
+ * context when it is freed. "SetDefault" sets the renderer that textures load into when none is
+ * given, as LTexture::SetDefaultRenderer does.
+ **/
+class LGLSpriteRenderer
+{
+public:
+
+  static constexpr int    s_PAGE_SIZE         = 2048;
+  static constexpr size_t s_MAX_SPRITES       = 1 << 16;   // Per frame; more are dropped
+  static constexpr int    s_FRAMES_IN_FLIGHT  = 3;
+
+  LGLSpriteRenderer( void );
+  ~LGLSpriteRenderer( void );
+
+  LGLSpriteRenderer( const LGLSpriteRenderer& )            = delete;
+  LGLSpriteRenderer& operator=( const LGLSpriteRenderer& ) = delete;
+
+  static void               SetDefault( LGLSpriteRenderer* );
+  static LGLSpriteRenderer* GetDefault( void );
+
+  static constexpr int    s_MAX_MIP_LEVELS    = 4;
+  static constexpr int    s_MAX_PALETTES      = 256;
+  static constexpr int    s_PALETTE_COLOURS   = 256;
+
+  bool   init          ( int, int, int = 1 );
+  void   free          ( void );
+  void   setScreenSize ( int, int );
+  void   setLayer      ( Sint16 );
+  bool   setInstanced  ( bool );
+  void   flush         ( void );
+  int    addPalette    ( const SDL_Color*, int );
+  bool   updatePalette ( int, const SDL_Color*, int );
+  void   setStateCache ( LGLStateCache* );
+
+  int    GetDrawCalls  ( void ) const;
+  size_t GetSprites    ( void ) const;
+  Uint32 GetDropped    ( void ) const;
+  bool   IsPersistent  ( void ) const;
+  bool   IsInstanced   ( void ) const;
+  int    GetMipLevels  ( void ) const;
+  int    GetPalettes   ( void ) const;
+  const SDL_Color* GetPalette( int ) const;
+  bool   IsBlockFormatSupported( LBlockFormat ) const;
+  size_t GetTextureBytes       ( void ) const;
+
+private:
+
+  friend class LGLTexture;
+
+  struct Instance
+  {
+    GLfloat X, Y, W, H;         // Destination, window pixels, y down
+    GLfloat CenterX, CenterY;   // Of rotation, from the top left corner
+    GLfloat Angle;              // Radians, clockwise on screen
+    GLfloat U0, V0, U1, V1;     // Area of the page, swapped by the flips
+    Uint8   R, G, B, A;
+    Uint8   Palette;            // Row of the palette texture, for indexed pages
+    Uint8   Padding[3];
+  };
+
+  struct Vertex
+  {
+    GLfloat X, Y;               // Window pixels, y down
+    GLfloat U, V;
+    Uint8   R, G, B, A;
+    Uint8   Palette;
+    Uint8   Padding[3];
+  };
+
+  struct Sprite
+  {
+    Uint32   Key;               // Layer, blend mode and page, in sort order
+    Instance Data;
+  };
+
+  struct Page
+  {
+    GLuint Texture;
+    int    Width;
+    int    Height;
+    int    RowX;                // Where the next image goes on the current row; Width when full
+    int    RowY;
+    int    RowHeight;
+    size_t Bytes;               // Of all its levels, as stored by the GPU
+    bool   IsIndexed;           // Palette indices, one byte a texel
+  };
+
+  static constexpr size_t s_VERTICES_PER_SPRITE = 4;
+  static constexpr size_t s_INDICES_PER_SPRITE  = 6;
+  static constexpr size_t s_BYTES_PER_SPRITE    = ( s_VERTICES_PER_SPRITE * sizeof(Vertex) > sizeof(Instance) )
+                                                  ? s_VERTICES_PER_SPRITE * sizeof(Vertex) : sizeof(Instance);
+
+  bool   Add_Pvt          ( SDL_Surface*, int&, SDL_Rect& );
+  bool   AddCompressed_Pvt( const std::string&, int&, SDL_Rect& );
+  bool   AddIndexed_Pvt   ( const Uint8*, int, int, int&, SDL_Rect& );
+  bool   Place_Pvt        ( int, int, bool, int&, SDL_Rect& );
+  void   Queue_Pvt        ( const LGLTexture&, const SDL_Rect&, const SDL_Rect&, double, const SDL_Point*, SDL_RendererFlip );
+  bool   InitPrograms_Pvt ( void );
+  bool   InitBuffers_Pvt  ( void );
+  Uint8* Map_Pvt          ( size_t );
+  void   Write_Pvt        ( Uint8* ) const;
+  void   Draw_Pvt         ( size_t, size_t, size_t ) const;
+  void   SetBlendMode_Pvt ( SDL_BlendMode ) const;
+
+  std::vector<Page>   m_Pages;
+  std::vector<Sprite> m_Sprites;           // Queued since the last flush
+  std::vector<Uint64> m_Order;             // Key and queue index of every sprite, sorted by flush
+  GLuint              m_QuadProgram;
+  GLuint              m_InstancedProgram;
+  GLint               m_QuadScreenSize;    // Uniform locations
+  GLint               m_InstancedScreenSize;
+  GLint               m_QuadIsIndexed;
+  GLint               m_InstancedIsIndexed;
+  GLuint              m_QuadVAO;
+  GLuint              m_InstancedVAO;
+  GLuint              m_VBO;               // Vertices or instances, s_FRAMES_IN_FLIGHT frames of them
+  GLuint              m_IBO;               // Two triangles per sprite
+  GLuint              m_CornerVBO;         // The unit quad every instance is drawn from
+  Uint8*              m_Mapped_Ptr;        // Whole buffer, when persistently mapped
+  GLsync              m_Fences[s_FRAMES_IN_FLIGHT];
+  int                 m_Frame;             // Part of the buffer this frame writes
+  Uint32              m_Layer;             // Of the sprites queued from now on, biased to be unsigned
+  int                 m_ScreenW;
+  int                 m_ScreenH;
+  bool                m_CanInstance;       // ARB_instanced_arrays available
+  bool                m_IsInstanced;
+  int                 m_LastDrawCalls;
+  size_t              m_LastSprites;
+  Uint32              m_Dropped;
+  int                 m_MipLevels;         // Of every page, the full size included
+  int                 m_Gutter;            // Texels repeated around every image
+  Uint32              m_BlockFormats;      // Bit n set if the driver samples LBlockFormat n
+  GLuint              m_PaletteTexture;    // s_MAX_PALETTES rows of s_PALETTE_COLOURS, made by the first addPalette
+  int                 m_Palettes;          // Rows in use
+  std::vector<SDL_Color> m_PaletteColours; // A copy of the rows in use, s_PALETTE_COLOURS each
+  LGLStateCache       m_OwnState;
+  LGLStateCache*      m_State_Ptr;         // m_OwnState, or the application's
+};
+
+#endif // LGLSPRITERENDERER_HPP
@@ -0,0 +1,199 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LGLStateCache.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+LGLStateCache::LGLStateCache( void )
+  : m_Program(s_UNKNOWN), m_VertexArray(s_UNKNOWN), m_ArrayBuffer(s_UNKNOWN), m_ActiveUnit(s_UNKNOWN), m_Textures(),
+    m_Blend(s_UNKNOWN), m_BlendFunc(), m_Issued(0), m_Skipped(0)
+{
+  invalidate();
+}
+
+
+/**
+ * @brief Forgets the state: the next call of every kind reaches OpenGL. For after state was changed
+ * without the cache, or bound objects were deleted.
+ **/
+void LGLStateCache::invalidate( void )
+{
+  m_Program     = s_UNKNOWN;
+  m_VertexArray = s_UNKNOWN;
+  m_ArrayBuffer = s_UNKNOWN;
+  m_ActiveUnit  = s_UNKNOWN;
+  m_Blend       = s_UNKNOWN;
+
+  for ( GLuint ( &Unit )[TARGET_COUNT] : m_Textures )
+  {
+    std::fill( std::begin( Unit ), std::end( Unit ), s_UNKNOWN );
+  }
+
+  std::fill( std::begin( m_BlendFunc ), std::end( m_BlendFunc ), s_UNKNOWN );
+}
+
+
+void LGLStateCache::useProgram( GLuint Program )
+{
+  if ( Update_Pvt( m_Program, Program ) )
+  {
+    glUseProgram( Program );
+  }
+  else
+  {;}
+}
+
+
+void LGLStateCache::bindVertexArray( GLuint VertexArray )
+{
+  if ( Update_Pvt( m_VertexArray, VertexArray ) )
+  {
+    glBindVertexArray( VertexArray );
+  }
+  else
+  {;}
+}
+
+
+void LGLStateCache::bindArrayBuffer( GLuint Buffer )
+{
+  if ( Update_Pvt( m_ArrayBuffer, Buffer ) )
+  {
+    glBindBuffer( GL_ARRAY_BUFFER, Buffer );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Binds a texture to a unit, making the unit active first if it is not.
+ *
+ * @param Unit   0 to s_MAX_UNITS - 1; the others are bound without the cache, and forget the active
+ * unit.
+ * @param Target GL_TEXTURE_2D or GL_TEXTURE_BUFFER; the others are bound without the cache.
+ **/
+void LGLStateCache::bindTexture( GLuint Unit, GLenum Target, GLuint Texture )
+{
+  if ( Unit >= s_MAX_UNITS )
+  {
+    glActiveTexture( GL_TEXTURE0 + Unit );
+    glBindTexture( Target, Texture );
+    m_ActiveUnit = s_UNKNOWN;
+    m_Issued    += 2;
+    return;
+  }
+  else if ( Update_Pvt( m_ActiveUnit, Unit ) )
+  {
+    glActiveTexture( GL_TEXTURE0 + Unit );
+  }
+  else
+  {;}
+
+  if ( Target != GL_TEXTURE_2D && Target != GL_TEXTURE_BUFFER )
+  {
+    glBindTexture( Target, Texture );
+    ++m_Issued;
+  }
+  else if ( Update_Pvt( m_Textures[Unit][ ( Target == GL_TEXTURE_2D ) ? TARGET_2D : TARGET_BUFFER ], Texture ) )
+  {
+    glBindTexture( Target, Texture );
+  }
+  else
+  {;}
+}
+
+
+void LGLStateCache::setBlend( bool IsEnabled )
+{
+  if ( Update_Pvt( m_Blend, IsEnabled ? GL_TRUE : GL_FALSE ) )
+  {
+    if ( IsEnabled )
+    {
+      glEnable( GL_BLEND );
+    }
+    else
+    {
+      glDisable( GL_BLEND );
+    }
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Sets the blend factors, colour and alpha; glBlendFunc( Source, Destination ) is the same
+ * factors twice.
+ **/
+void LGLStateCache::blendFuncSeparate( GLenum SourceRGB, GLenum DestinationRGB, GLenum SourceAlpha, GLenum DestinationAlpha )
+{
+  const GLuint Factors[4] = { SourceRGB, DestinationRGB, SourceAlpha, DestinationAlpha };
+
+  if ( std::equal( std::begin( Factors ), std::end( Factors ), m_BlendFunc ) )
+  {
+    ++m_Skipped;
+    return;
+  }
+  else
+  {;}
+
+  std::copy( std::begin( Factors ), std::end( Factors ), m_BlendFunc );
+  glBlendFuncSeparate( SourceRGB, DestinationRGB, SourceAlpha, DestinationAlpha );
+  ++m_Issued;
+}
+
+
+void LGLStateCache::resetCounters( void )
+{
+  m_Issued  = 0;
+  m_Skipped = 0;
+}
+
+
+/**
+ * @return the state changes passed on to OpenGL since resetCounters.
+ **/
+Uint32 LGLStateCache::GetIssued( void ) const
+{
+  return m_Issued;
+}
+
+
+/**
+ * @return the calls skipped since resetCounters, as they set what was already set.
+ **/
+Uint32 LGLStateCache::GetSkipped( void ) const
+{
+  return m_Skipped;
+}
+
+
+/**
+ * @brief Counts the call, and records the value if it changes the state.
+ *
+ * @return true if OpenGL has to be called.
+ **/
+bool LGLStateCache::Update_Pvt( GLuint& Cached, GLuint Value )
+{
+  if ( Cached == Value )
+  {
+    ++m_Skipped;
+    return false;
+  }
+  else
+  {;}
+
+  Cached = Value;
+  ++m_Issued;
+
+  return true;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file LGLStateCache.hpp
+ *
+ * @brief The OpenGL bindings and blend state last set, so that the calls setting them again to the
+ * same values are skipped instead of reaching the driver.
+ **/
+
+#ifndef LGLSTATECACHE_HPP
+#define LGLSTATECACHE_HPP
+
+#include <SDL.h>
+#include <glew.h>
+
+/**
+ * @brief Shadow of the state the passes of a frame change most: the program, the vertex array, the
+ * array buffer, the textures of the first s_MAX_UNITS units (2D and buffer targets) and blending.
+ * Each setter compares with what it set last and calls OpenGL only if it differs, so a pass sets all
+ * it needs without knowing what the previous pass left bound, and without resetting it afterwards.
+ * The element array buffer is not tracked: it belongs to the vertex array, which records it once.
+ *
+ * The cache only knows the calls made through it. After code outside it changes any of this state,
+ * or deletes an object that may be bound (its name can be given to the next one created), call
+ * "invalidate": the next call of every kind then reaches OpenGL again. A freshly made cache is
+ * invalid too, as it cannot know the state of the context.
+ *
+ * One cache per context; the context must be current for every call but the getters.
+ **/
+class LGLStateCache
+{
+public:
+
+  static constexpr GLuint s_MAX_UNITS = 4;
+
+  LGLStateCache( void );
+
+  void   invalidate        ( void );
+  void   useProgram        ( GLuint );
+  void   bindVertexArray   ( GLuint );
+  void   bindArrayBuffer   ( GLuint );
+  void   bindTexture       ( GLuint, GLenum, GLuint );
+  void   setBlend          ( bool );
+  void   blendFuncSeparate ( GLenum, GLenum, GLenum, GLenum );
+  void   resetCounters     ( void );
+
+  Uint32 GetIssued         ( void ) const;
+  Uint32 GetSkipped        ( void ) const;
+
+private:
+
+  static constexpr GLuint s_UNKNOWN = ~0u;    // Never a name or enum OpenGL returns
+
+  enum TextureTarget { TARGET_2D, TARGET_BUFFER, TARGET_COUNT };
+
+  bool   Update_Pvt        ( GLuint&, GLuint );
+
+  GLuint m_Program;
+  GLuint m_VertexArray;
+  GLuint m_ArrayBuffer;
+  GLuint m_ActiveUnit;                        // Index, not GL_TEXTUREi
+  GLuint m_Textures[s_MAX_UNITS][TARGET_COUNT];
+  GLuint m_Blend;                             // GL_TRUE or GL_FALSE
+  GLuint m_BlendFunc[4];                      // Source and destination colour, then alpha
+  Uint32 m_Issued;                            // Calls made since resetCounters
+  Uint32 m_Skipped;                           // Calls saved
+};
+
+#endif // LGLSTATECACHE_HPP
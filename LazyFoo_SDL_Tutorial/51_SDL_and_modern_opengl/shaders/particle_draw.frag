@@ -0,0 +1,6 @@
+#version 140
+in vec2 Corner; in float Fade; out vec4 LFragment;
+void main() {
+  float falloff = max( 1.0 - dot( Corner, Corner ), 0.0 );
+  LFragment = vec4( 1.0, 0.6, 0.2, 1.0 ) * falloff * Fade;
+}
@@ -0,0 +1,12 @@
+#version 140
+// One instance per particle: the state is fetched from the texture buffer by instance, and the four
+// vertices of the triangle strip are the corners of its quad
+uniform samplerBuffer ParticleState; uniform vec2 HalfSize;
+out vec2 Corner; out float Fade;
+void main() {
+  vec4 posVel = texelFetch( ParticleState, 2 * gl_InstanceID );
+  vec4 als    = texelFetch( ParticleState, 2 * gl_InstanceID + 1 );
+  Corner = vec2( float( gl_VertexID & 1 ), float( gl_VertexID >> 1 ) ) * 2.0 - 1.0;
+  Fade = ( als.x < 0.0 ) ? 0.0 : 1.0 - als.x / als.y;
+  gl_Position = ( als.x < 0.0 ) ? vec4( 2.0, 2.0, 2.0, 1.0 ) : vec4( posVel.xy + Corner * HalfSize, 0.0, 1.0 );
+}
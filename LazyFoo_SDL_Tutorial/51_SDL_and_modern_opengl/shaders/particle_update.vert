@@ -0,0 +1,20 @@
+#version 140
+// Advances the state: expired particles respawn at the emitter with a pseudo-random velocity and
+// lifetime, live ones fall under gravity. Particles with negative age are waiting for their first
+// spawn, so that the initial emission is spread over time
+in vec4 InPosVel; in vec4 InAgeLifeSeed;
+out vec4 OutPosVel; out vec4 OutAgeLifeSeed;
+uniform float DeltaTime; uniform vec2 Emitter;
+float hash( float n ) { return fract( sin( n ) * 43758.5453 ); }
+void main() {
+  vec4 posVel = InPosVel; vec4 als = InAgeLifeSeed;
+  als.x += DeltaTime;
+  if( als.x >= als.y ) {
+    float angle = hash( als.z ) * 6.2831853; float speed = 0.1 + 0.5 * hash( als.z + 0.37 );
+    posVel = vec4( Emitter, cos( angle ) * speed, sin( angle ) * speed + 0.6 );
+    als = vec4( als.x - als.y, 0.5 + 1.5 * hash( als.z + 0.71 ), hash( als.z + 0.13 ) * 1000.0, 0.0 );
+  } else if( als.x >= 0.0 ) {
+    posVel.w -= 0.98 * DeltaTime; posVel.xy += posVel.zw * DeltaTime;
+  }
+  OutPosVel = posVel; OutAgeLifeSeed = als;
+}
@@ -0,0 +1,3 @@
+#version 140
+out vec4 LFragment;
+void main() { LFragment = vec4( 1.0, 1.0, 1.0, 1.0 ); }
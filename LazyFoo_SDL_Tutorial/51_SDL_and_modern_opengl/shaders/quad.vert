@@ -0,0 +1,4 @@
+#version 140
+// The quad of the tutorial, already in normalised device coordinates
+in vec2 LVertexPos2D;
+void main() { gl_Position = vec4( LVertexPos2D.x, LVertexPos2D.y, 0, 1 ); }
@@ -0,0 +1,11 @@
+#version 140
+// The outline is where the distance crosses one half; the edge is smoothed over one screen pixel,
+// whatever the size the text is drawn at
+in vec2 TexCoord; out vec4 LFragment;
+uniform sampler2D Atlas; uniform vec4 Colour;
+void main() {
+  float distance = texture( Atlas, TexCoord ).r;
+  float smoothing = max( fwidth( distance ) * 0.5, 0.001 );
+  float coverage = smoothstep( 0.5 - smoothing, 0.5 + smoothing, distance );
+  LFragment = vec4( Colour.rgb, Colour.a * coverage );
+}
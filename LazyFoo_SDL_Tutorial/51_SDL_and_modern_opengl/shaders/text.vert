@@ -0,0 +1,9 @@
+#version 140
+// Quads in window pixels, y down, turned into normalised device coordinates
+in vec2 LVertexPos; in vec2 LTexCoord;
+uniform vec2 ScreenSize;
+out vec2 TexCoord;
+void main() {
+  TexCoord = LTexCoord;
+  gl_Position = vec4( LVertexPos.x / ScreenSize.x * 2.0 - 1.0, 1.0 - LVertexPos.y / ScreenSize.y * 2.0, 0.0, 1.0 );
+}
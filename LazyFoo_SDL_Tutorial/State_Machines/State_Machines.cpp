@@ -22,6 +22,61 @@
  *
  * In this example, the ExitState is a dummy state, but in larger games it's not uncommon to have an
  * exit state that cleans up things before the game terminates.
+ *
+ * Aggiunta GS: le collisioni usano Engine_Lib/LCollision al posto di "HasCollisionHappened".
+ *
+ * Aggiunta GS: le case del mondo esterno e le porte delle stanze sono volumi trigger (LTriggerSet),
+ * indicizzati una sola volta, all'enter(), in una griglia uniforme (LSpatialGrid). A ogni frame si
+ * controllano solo i trigger nelle celle occupate dal punto, qualunque sia il loro numero, e il
+ * cambio di stato parte dall'evento Enter, una sola volta, invece che dal test di sovrapposizione
+ * ripetuto a ogni frame contro ogni porta. Gli eventi Stay ed Exit sono disponibili per altri usi.
+ *
+ * Aggiunta GS: il colour key delle texture caricate da ogni stato è applicato da "ApplyColourKey"
+ * di Engine_Lib/LPixelOps, con i kernel SIMD, in fasce di righe ripartite fra i thread di
+ * "LJobSystem"; i bordi delle fasce cadono su linee di cache diverse.
+ *
+ * Aggiunta GS: i cambi di stato non caricano più le immagini dal disco. Ogni stato dichiara quali
+ * stati probabilmente verranno dopo di lui ("getLikelyNextStates": dal mondo esterno le due stanze,
+ * dalle stanze il mondo esterno) e quali immagini carica la sua enter() ("getImagePaths"). Dopo ogni
+ * cambio di stato, i thread di "LJobSystem" decodificano le immagini dei prossimi stati probabili
+ * (lettura, conversione e colour key), e il ciclo principale le carica sulla GPU una per frame,
+ * perché il renderer si usa solo dal thread principale: la enter() le trova già pronte. La durata di
+ * ogni cambio è scritta sulla console.
+ *
+ * Aggiunta GS: le immagini non appartengono più agli stati. "AssetResidency" le conta: ogni stato le
+ * acquisisce nella enter() e le rilascia nella exit(), anche il punto, acquisito una volta per tutte;
+ * un'immagine rilasciata da tutti resta in memoria finché le immagini residenti stanno nel budget
+ * RESIDENCY_BUDGET_BYTES, poi viene scartata per prima quella rilasciata da più tempo. Rientrare in
+ * una stanza visitata di recente non carica nulla; il prefetch dei prossimi stati probabili passa
+ * dalla stessa residenza. Gli stati stanno in una pila: un cambio di stato sostituisce l'intera pila,
+ * mentre pushState/popState aggiungono e tolgono stati in cima, come la pausa ("PauseState", tasto
+ * 'p' nel mondo esterno e nelle stanze). Uno stato "overlay" è disegnato sopra quelli sotto di lui,
+ * che restano fermi ma non vengono usciti, e non perdono quindi le loro immagini.
+ *
+ * Aggiunta GS: con "--perf-frames=<N>" il programma gira senza finestra per N frame, con l'input di
+ * "--perf-script" che lo porta attraverso gli stati, e fallisce se i tempi, le allocazioni o le draw
+ * call per frame superano "--perf-budget" (Engine_Lib/LPerfHarness).
+ *
+ * Aggiunta GS: con "--trace=<file>" il programma registra in un file Chrome trace (da aprire con
+ * chrome://tracing o https://ui.perfetto.dev) l'inizio di ogni frame, le fasi del ciclo principale,
+ * le draw call per frame e i lavori eseguiti dai thread di "LJobSystem", ognuno sulla riga del suo
+ * thread (Engine_Lib/LTrace).
+ *
+ * Aggiunta GS: il mondo esterno non si disegna più nell'ordine delle chiamate a render. Sfondo, case
+ * e punto vanno in una lista di disegno (Engine_Lib/LDrawList) in qualunque ordine, ognuno con uno
+ * strato e una profondità; a fine frame la lista ordina le chiavi a 64 bit (strato, blend mode,
+ * texture, profondità) con un radix sort e disegna ogni sequenza di sprite della stessa texture con
+ * una sola SDL_RenderGeometry. Lo sfondo sta nello strato sotto, le case e il punto in quello sopra,
+ * ordinati per la base: il punto passa davanti a una casa quando le sta sotto, dietro quando le sta
+ * sopra.
+ *
+ * Aggiunta GS: il programma non carica più le immagini dell'intro prima del primo frame. Parte da
+ * una schermata di caricamento ("LoadingState"), disegnata solo con il punto e il font già caricati
+ * da loadMedia, mentre "AssetResidency::stream" fa decodificare ai thread di "LJobSystem" le
+ * immagini dell'intro e poi quelle del titolo, in quest'ordine e poche alla volta; la barra mostra
+ * i byte dei file pronti, il testo le immagini pronte. Quando sono tutte caricate si passa all'intro.
+ * La console riporta dopo quanto è apparsa la schermata e quanto è durato il caricamento. Le
+ * esecuzioni "--perf-frames" partono ancora dall'intro, perché i loro script contano i frame da lì.
  **/
 
 // Using SDL, SDL_image, standard IO, and strings
@@ -29,15 +84,39 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <stdio.h>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include "colours.hpp"
+#include "LCollision.hpp"
+#include "LDrawList.hpp"
+#include "LJobSystem.hpp"
+#include "LPerfHarness.hpp"
+#include "LPixelOps.hpp"
+#include "LTimer.hpp"
+#include "LTrace.hpp"
 
 // Screen attributes
 static constexpr int WINDOW_W = 800;
 static constexpr int WINDOW_H = 600;
 
+// Memoria per le immagini residenti: basta per mondo esterno, case e stanze, non anche per intro e titolo
+static constexpr size_t RESIDENCY_BUDGET_BYTES = 16 * 1024 * 1024;
+
 static constexpr int FIRST_AVAILABLE_ONE = -1;
 
+// Images decoded at the same time by the stream of the loading screen, in their order
+static constexpr int STREAM_DECODES = 2;
+
+// Progress bar of the loading screen
+static constexpr int LOADING_BAR_W = 400;
+static constexpr int LOADING_BAR_H = 20;
+
+// Layers of the overworld draw list: the ground below, then the objects sorted by depth
+static constexpr Uint8 LAYER_GROUND  = 0;
+static constexpr Uint8 LAYER_OBJECTS = 1;
+
 static const std::string DotPath      ("dot.bmp");
 static const std::string LazyFontPath ("lazy.ttf");
 static const std::string BGPath       ("introbg.png");
@@ -68,6 +147,15 @@ public:
   // Loads image at specified path
   bool loadFromFile( const std::string& );
 
+  // Reads and prepares an image without the renderer, e.g. on a job worker
+  static SDL_Surface* decodeFile( const std::string& );
+
+  // Creates the texture from a surface made by decodeFile
+  bool loadFromSurface( SDL_Surface* );
+
+  // Exchanges textures with another object
+  void swap( LTexture& );
+
 #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
   bool loadFromRenderedText( const std::string&, SDL_Color );
@@ -98,6 +186,12 @@ public:
   int getWidth  ( void ) const;
   int getHeight ( void ) const;
 
+  // Whether there is a texture
+  bool isLoaded ( void ) const;
+
+  // The hardware texture, for the draw list
+  SDL_Texture* getSDLTexture( void ) const;
+
   // Pixel manipulators
   bool    lockTexture   ( void );
   bool    unlockTexture ( void );
@@ -146,6 +240,9 @@ public:
   // Shows the dot on the screen relative to the camera
   void render( SDL_Rect );
 
+  // Queues the dot in a draw list relative to the camera, sorted by its feet
+  void queue( LDrawList&, Uint8, SDL_Rect );
+
   // Gets the collision box
   SDL_Rect getCollider(void);
 
@@ -172,6 +269,9 @@ public:
   // Renders house relative to the camera
   void render( SDL_Rect );
 
+  // Queues the house in a draw list relative to the camera, sorted by its base
+  void queue( LDrawList&, Uint8, SDL_Rect );
+
   // Gets the collision box
   SDL_Rect getCollider(void);
 
@@ -204,6 +304,86 @@ private:
 };
 
 
+/**
+ * @brief Residency of the images shared by the states, counted by reference. A state acquires the
+ * images it uses in enter() and releases them in exit(); an image stays resident while it is held,
+ * and after that too, as long as the resident images fit the budget: the least recently used ones
+ * not held by anyone are evicted first. Re-entering a recently visited room loads nothing.
+ *
+ * The images of the states likely to come next are prefetched: decoded on the job workers (reading,
+ * conversion and colour key) and uploaded by "update" on the main thread, which alone may use the
+ * renderer, one per frame.
+ *
+ * The images of the loading screen are streamed instead: decoded in the order given, a few at a time,
+ * so that the first ones are ready first, with the progress reported in images and in bytes.
+ **/
+class AssetResidency
+{
+public:
+
+  // How far the streamed images got; bytes are those of the files
+  struct Progress
+  {
+    int    ItemsDone  = 0;
+    int    ItemsTotal = 0;
+    size_t BytesDone  = 0;
+    size_t BytesTotal = 0;
+  };
+
+  explicit AssetResidency( size_t );
+
+  LTexture* acquire ( const std::string& );
+  void      release ( const std::string& );
+  void      prefetch( const std::vector<std::string>& );
+  void      stream  ( const std::vector<std::string>& );
+  void      update  ( void );
+  void      clear   ( void );
+
+  size_t   getResidentBytes( void ) const;
+  int      getLoads        ( void ) const;
+  Progress getProgress     ( void ) const;
+
+private:
+
+  struct Entry
+  {
+    std::string  Path;
+    SDL_Surface* Surface    = NULL;   // Decoded by a worker, until uploaded
+    LTexture     Texture;
+    LJobCounter  Decoding;
+    int          References = 0;
+    Uint64       LastUsed   = 0;      // mTick of the last acquire, release or prefetch
+  };
+
+  struct StreamItem
+  {
+    std::string Path;
+    size_t      Bytes    = 0;       // Of the file
+    bool        Launched = false;   // Its decoding was started, or it was resident already
+  };
+
+  static void   decodeJob( void* );
+  static size_t getBytes ( const Entry& );
+
+  size_t findEntry    ( const std::string& ) const;
+  Entry& addEntry     ( const std::string& );
+  void   finishDecode ( Entry& );
+  void   launchStream ( void );
+  bool   isStreamed   ( const StreamItem& ) const;
+  void   evict        ( void );
+
+  // Held by pointer: the decoding jobs, and the states, keep the address of an entry
+  std::vector<std::unique_ptr<Entry>> mEntries;
+
+  // The images of the last stream, in the order they are decoded
+  std::vector<StreamItem> mStream;
+
+  size_t mBudgetBytes;
+  Uint64 mTick;    // Counts the uses, for the least recently used order
+  int    mLoads;   // Images read from the disk by acquire, in the middle of a transition
+};
+
+
 /**
  * @brief Game state base (abstract) class
  **/
@@ -221,12 +401,62 @@ public:
   virtual void update     ( void )       = 0;
   virtual void render     ( void )       = 0;
 
+  /* Prefetch hints */
+
+  // The states likely to follow this one: their images are decoded while this one runs
+  virtual void getLikelyNextStates( std::vector<GameState*>& ) const {}
+
+  // The images enter() loads
+  virtual void getImagePaths( std::vector<std::string>& ) const {}
+
+  /* Stacking */
+
+  // An overlay is drawn over the states below it in the stack, which stay entered but are not updated
+  virtual bool isOverlay( void ) const { return false; }
+
   /* Make sure to call child destructors */
 
   virtual ~GameState(){};
 };
 
 
+/**
+ * @brief The first state: shows a progress bar, drawn with the dot loaded by loadMedia, while the
+ * images of the intro, then those of the title, are streamed by the residency. Goes on to the intro
+ * once they are all ready.
+ **/
+class LoadingState : public GameState
+{
+public:
+  // Static accessor
+  static LoadingState* get( void );
+
+  // Transitions
+  bool enter( void ) override;
+  bool exit ( void ) override;
+
+  // Main loop functions
+  void handleEvent( SDL_Event& ) override;
+  void update     ( void )       override;
+  void render     ( void )       override;
+
+private:
+  // Static instance
+  static LoadingState sLoadingState;
+
+  // Private constructor
+  LoadingState( void );
+
+  // Since enter, for the time to the first frame and to the end of the loading
+  LHighResTimer mTimer;
+  bool          mHasRendered = false;
+
+  // Progress text, rendered again only when the images done change
+  LTexture mMessageTexture;
+  int      mMessageItems = -1;
+};
+
+
 class IntroState : public GameState
 {
 public:
@@ -242,6 +472,10 @@ public:
   void update     ( void )       override;
   void render     ( void )       override;
 
+  // Prefetch hints
+  void getLikelyNextStates( std::vector<GameState*>& ) const override;
+  void getImagePaths      ( std::vector<std::string>& ) const override;
+
 private:
   // Static instance
   static IntroState sIntroState;
@@ -249,8 +483,8 @@ private:
   // Private constructor
   IntroState( void );
 
-  // Intro background
-  LTexture mBackgroundTexture;
+  // Intro background, held in the residency
+  LTexture* mBackgroundTexture = NULL;
 
   // Intro message
   LTexture mMessageTexture;
@@ -272,6 +506,10 @@ public:
   void update     ( void )       override;
   void render     ( void )       override;
 
+  // Prefetch hints
+  void getLikelyNextStates( std::vector<GameState*>& ) const override;
+  void getImagePaths      ( std::vector<std::string>& ) const override;
+
 private:
   // Static instance
   static TitleState sTitleState;
@@ -279,8 +517,8 @@ private:
   // Private constructor
   TitleState( void );
 
-  // Intro background
-  LTexture mBackgroundTexture;
+  // Intro background, held in the residency
+  LTexture* mBackgroundTexture = NULL;
 
   // Intro message
   LTexture mMessageTexture;
@@ -302,6 +540,10 @@ public:
   void update     ( void )         override;
   void render     ( void )         override;
 
+  // Prefetch hints
+  void getLikelyNextStates( std::vector<GameState*>& ) const override;
+  void getImagePaths      ( std::vector<std::string>& ) const override;
+
 private:
   // Level dimensions
   static constexpr int LEVEL_W = WINDOW_W * 2;
@@ -313,14 +555,19 @@ private:
   // Private constructor
   OverWorldState( void );
 
-  // Overworld textures
-  LTexture mBackgroundTexture;
-  LTexture mRedHouseTexture;
-  LTexture mBlueHouseTexture;
+  // Overworld textures, held in the residency
+  LTexture* mBackgroundTexture = NULL;
+  LTexture* mRedHouseTexture   = NULL;
+  LTexture* mBlueHouseTexture  = NULL;
 
   // Game objects
   House mRedHouse;
   House mBlueHouse;
+
+  // Doors into the rooms, as trigger volumes
+  LTriggerSet mDoors;
+  int         mRedHouseDoor  = -1;
+  int         mBlueHouseDoor = -1;
 };
 
 
@@ -339,6 +586,10 @@ public:
   void update( void )            override;
   void render( void )            override;
 
+  // Prefetch hints
+  void getLikelyNextStates( std::vector<GameState*>& ) const override;
+  void getImagePaths      ( std::vector<std::string>& ) const override;
+
 private:
   // Level dimensions
   const static int LEVEL_W = WINDOW_W;
@@ -350,11 +601,15 @@ private:
   // Private constructor
   RedRoomState( void );
 
-  // Room textures
-  LTexture mBackgroundTexture;
+  // Room textures, held in the residency
+  LTexture* mBackgroundTexture = NULL;
 
   // Game objects
   Door mExitDoor;
+
+  // The exit door, as a trigger volume
+  LTriggerSet mTriggers;
+  int         mExitTrigger = -1;
 };
 
 class BlueRoomState : public GameState
@@ -372,6 +627,10 @@ public:
   void update     ( void )         override;
   void render     ( void )         override;
 
+  // Prefetch hints
+  void getLikelyNextStates( std::vector<GameState*>& ) const override;
+  void getImagePaths      ( std::vector<std::string>& ) const override;
+
 private:
   // Level dimensions
   static constexpr int LEVEL_W = WINDOW_W;
@@ -383,11 +642,45 @@ private:
   // Private constructor
   BlueRoomState( void );
 
-  // Room textures
-  LTexture mBackgroundTexture;
+  // Room textures, held in the residency
+  LTexture* mBackgroundTexture = NULL;
 
   // Game objects
   Door mExitDoor;
+
+  // The exit door, as a trigger volume
+  LTriggerSet mTriggers;
+  int         mExitTrigger = -1;
+};
+
+
+class PauseState : public GameState
+{
+public:
+  // Static accessor
+  static PauseState* get( void );
+
+  // Transitions
+  bool enter( void ) override;
+  bool exit ( void ) override;
+
+  // Main loop functions
+  void handleEvent( SDL_Event& ) override;
+  void update     ( void )       override;
+  void render     ( void )       override;
+
+  // Stacking
+  bool isOverlay( void ) const override;
+
+private:
+  // Static instance
+  static PauseState sPauseState;
+
+  // Private constructor
+  PauseState( void );
+
+  // Pause message
+  LTexture mMessageTexture;
 };
 
 
@@ -422,13 +715,16 @@ private:
 static bool init          ( void );
 static bool loadMedia     ( void );
 static void close         ( void );
-
-static bool HasCollisionHappened( SDL_Rect, SDL_Rect );
+static bool isPauseKey    ( const SDL_Event& );
 
 /* State managers */
 
-static void setNextState( GameState* );
-static void changeState ( void );
+static void setNextState    ( GameState* );
+static void pushState       ( GameState* );
+static void popState        ( void );
+static void changeState     ( void );
+static void warmUpNextStates( void );
+static void renderStates    ( void );
 
 
 /***************************************************************************************************
@@ -442,15 +738,28 @@ static SDL_Window* gWindow = NULL;
 static SDL_Renderer* gRenderer = NULL;
 
 /* Global assets - Sia il punto sia il font vengono mantenuti nella transizione fra stati */
-static LTexture  gDotTexture;
+static LTexture* gDotTexture = NULL;   // Held in the residency until close
 static TTF_Font* gFont = NULL;
 
 // Global game objects
 static Dot gDot;
 
-// Game state object
-static GameState* gCurrentState = NULL;
-static GameState* gNextState = NULL;
+// Draws of the overworld, sorted by layer and, among the objects, by how low they stand
+static LDrawList gDrawList;
+
+// Workers for the pixel processing of the textures loaded by each state
+static LJobSystem gJobs;
+
+// Images shared by the states, and those of the likely next states, decoded ahead of the transitions
+static AssetResidency gResidency( RESIDENCY_BUDGET_BYTES );
+
+// Game state objects: the stack, whose top one runs, and the change to make to it at the end of the frame
+enum class StateChange { None, Replace, Push, Pop };
+
+static std::vector<GameState*> gStateStack;
+static StateChange             gStateChange   = StateChange::None;
+static GameState*              gNextState     = NULL;   // For Replace and Push
+static GameState*              gPreviousState = NULL;   // The bottom state replaced by the last Replace
 
 
 /***************************************************************************************************
@@ -482,8 +791,34 @@ bool LTexture::loadFromFile( const std::string& path )
   // Get rid of preexisting texture
   free();
 
-  // The final texture
-  SDL_Texture* newTexture = NULL;
+  // Load and prepare the image, then upload it
+  SDL_Surface* formattedSurface = decodeFile( path );
+
+  if( formattedSurface == NULL )
+  {
+    return false;
+  }
+  else { /* Decoding OK */ }
+
+  const bool success = loadFromSurface( formattedSurface );
+
+  // Get rid of old formatted surface
+  SDL_FreeSurface( formattedSurface );
+
+  return success;
+}
+
+
+/**
+ * @brief Reads an image into a surface ready for loadFromSurface: converted to RGBA8888, with the
+ * colour key already turned into transparency. It does not use the renderer, so it can run on a job
+ * worker.
+ *
+ * @return the surface, to be freed by the caller; NULL if the image could not be loaded.
+ **/
+SDL_Surface* LTexture::decodeFile( const std::string& path )
+{
+  SDL_Surface* formattedSurface = NULL;
 
   // Load image at specified path
   SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
@@ -497,7 +832,7 @@ bool LTexture::loadFromFile( const std::string& path )
     SDL_Log( "OK: image \"%s\" loaded\n", path.c_str() );
 
     // Convert surface to display format
-    SDL_Surface* formattedSurface = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_RGBA8888, 0 );
+    formattedSurface = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_RGBA8888, 0 );
 
     if( formattedSurface == NULL )
     {
@@ -505,58 +840,63 @@ bool LTexture::loadFromFile( const std::string& path )
     }
     else
     {
-      // Create blank streamable texture
-      newTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, formattedSurface->w, formattedSurface->h );
+      // Map colors
+      Uint32 colorKey    = SDL_MapRGB ( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B );
+      Uint32 transparent = SDL_MapRGBA( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B, ALPHA_MIN );
 
-      if( newTexture == NULL )
-      {
-        SDL_Log( "Unable to create blank texture! SDL Error: %s\n", SDL_GetError() );
-      }
-      else
-      {
-        SDL_Log( "OK: blank texture created\n" );
+      // Color key pixels, in row bands shared by the job workers
+      ApplyColourKey( gJobs, formattedSurface->pixels, formattedSurface->pitch, formattedSurface->h, colorKey, transparent );
+    }
 
-        // Enable blending on texture
-        SDL_SetTextureBlendMode( newTexture, SDL_BLENDMODE_BLEND );
+    // Get rid of old loaded surface
+    SDL_FreeSurface( loadedSurface );
+  }
 
-        // Lock texture for manipulation
-        SDL_LockTexture( newTexture, &formattedSurface->clip_rect, &mPixels, &mPitch );
+  return formattedSurface;
+}
 
-        // Copy loaded/formatted surface pixels
-        memcpy( mPixels, formattedSurface->pixels, formattedSurface->pitch * formattedSurface->h );
 
-        // Get image dimensions
-        mWidth  = formattedSurface->w;
-        mHeight = formattedSurface->h;
+/**
+ * @brief Creates a streaming texture with the pixels of a surface made by decodeFile. Uses the
+ * renderer: main thread only.
+ **/
+bool LTexture::loadFromSurface( SDL_Surface* formattedSurface )
+{
+  // Get rid of preexisting texture
+  free();
 
-        // Get pixel data in editable format
-        Uint32* pixels = (Uint32*)mPixels;
-        int pixelCount = ( mPitch / 4 ) * mHeight;
+  // Create blank streamable texture
+  SDL_Texture* newTexture = SDL_CreateTexture( gRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING, formattedSurface->w, formattedSurface->h );
 
-        // Map colors
-        Uint32 colorKey    = SDL_MapRGB ( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B );
-        Uint32 transparent = SDL_MapRGBA( formattedSurface->format, CYAN_R, CYAN_G, CYAN_B, ALPHA_MIN );
+  if( newTexture == NULL )
+  {
+    SDL_Log( "Unable to create blank texture! SDL Error: %s\n", SDL_GetError() );
+  }
+  else
+  {
+    SDL_Log( "OK: blank texture created\n" );
 
-        // Color key pixels
-        for( int i = 0; i != pixelCount; ++i )
-        {
-          if( pixels[ i ] == colorKey )
-          {
-            pixels[ i ] = transparent;
-          }
-        }
+    // Enable blending on texture
+    SDL_SetTextureBlendMode( newTexture, SDL_BLENDMODE_BLEND );
 
-        // Unlock texture to update
-        SDL_UnlockTexture( newTexture );
-        mPixels = NULL;
-      }
+    // Lock texture for manipulation
+    SDL_LockTexture( newTexture, &formattedSurface->clip_rect, &mPixels, &mPitch );
 
-      // Get rid of old formatted surface
-      SDL_FreeSurface( formattedSurface );
+    // Copy formatted surface pixels, row by row: the pitches may differ
+    for( int row = 0; row != formattedSurface->h; ++row )
+    {
+      memcpy( static_cast<Uint8*>( mPixels ) + row * mPitch,
+              static_cast<const Uint8*>( formattedSurface->pixels ) + row * formattedSurface->pitch,
+              static_cast<size_t>( formattedSurface->w ) * formattedSurface->format->BytesPerPixel );
     }
 
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
+    // Get image dimensions
+    mWidth  = formattedSurface->w;
+    mHeight = formattedSurface->h;
+
+    // Unlock texture to update
+    SDL_UnlockTexture( newTexture );
+    mPixels = NULL;
   }
 
   // Return success
@@ -565,6 +905,16 @@ bool LTexture::loadFromFile( const std::string& path )
 }
 
 
+void LTexture::swap( LTexture& other )
+{
+  std::swap( mTexture, other.mTexture );
+  std::swap( mPixels , other.mPixels  );
+  std::swap( mPitch  , other.mPitch   );
+  std::swap( mWidth  , other.mWidth   );
+  std::swap( mHeight , other.mHeight  );
+}
+
+
 #if defined(SDL_TTF_MAJOR_VERSION)
 bool LTexture::loadFromRenderedText( const std::string& textureText, SDL_Color textColor )
 {
@@ -673,6 +1023,7 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 
   // Render to screen
   SDL_RenderCopyEx( gRenderer, mTexture, clip, &renderQuad, angle, center, flip );
+  LPerfHarness::countDrawCalls( 1 );
 }
 
 
@@ -695,6 +1046,18 @@ int LTexture::getHeight(void) const
 }
 
 
+bool LTexture::isLoaded(void) const
+{
+  return mTexture != NULL;
+}
+
+
+SDL_Texture* LTexture::getSDLTexture(void) const
+{
+  return mTexture;
+}
+
+
 bool LTexture::lockTexture(void)
 {
   bool success = true;
@@ -854,7 +1217,12 @@ void Dot::move( int levelWidth, int levelHeight )
 void Dot::render( SDL_Rect camera )
 {
   // Show the dot relative to the camera
-  gDotTexture.render( mBox.x - camera.x, mBox.y - camera.y );
+  gDotTexture->render( mBox.x - camera.x, mBox.y - camera.y );
+}
+
+void Dot::queue( LDrawList& drawList, Uint8 layer, SDL_Rect camera )
+{
+  drawList.add( layer, static_cast<float>( mBox.y + mBox.h ), gDotTexture->getSDLTexture(), mBox.x - camera.x, mBox.y - camera.y );
 }
 
 SDL_Rect Dot::getCollider()
@@ -894,6 +1262,11 @@ void House::render( SDL_Rect camera )
   mHouseTexture->render( mBox.x - camera.x, mBox.y - camera.y );
 }
 
+void House::queue( LDrawList& drawList, Uint8 layer, SDL_Rect camera )
+{
+  drawList.add( layer, static_cast<float>( mBox.y + mBox.h ), mHouseTexture->getSDLTexture(), mBox.x - camera.x, mBox.y - camera.y );
+}
+
 SDL_Rect House::getCollider()
 {
   // Get collision box
@@ -938,6 +1311,7 @@ void Door::render(void)
   // Draw rectangle for door
   SDL_SetRenderDrawColor( gRenderer, BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX );
   SDL_RenderFillRect( gRenderer, &mBox );
+  LPerfHarness::countDrawCalls( 1 );
 }
 
 
@@ -952,89 +1326,592 @@ SDL_Rect Door::getCollider(void)
 }
 
 
-/* IntroState */
+/* AssetResidency */
 
-IntroState* IntroState::get(void)
-{
-  return &sIntroState; // Get static instance
-}
+/**
+ * @param budgetBytes How much the images not held by any state may take, together with those held.
+ **/
+AssetResidency::AssetResidency( size_t budgetBytes )
+  : mEntries(), mStream(), mBudgetBytes( budgetBytes ), mTick( 0 ), mLoads( 0 )
+{;}
 
 
-bool IntroState::enter(void)
+/**
+ * @brief Holds an image: resident already, or prefetched (waiting for its decoding, if still going),
+ * or else loaded from the disk now.
+ *
+ * @return its texture, valid until the image is released; check isLoaded for a failed load.
+ **/
+LTexture* AssetResidency::acquire( const std::string& path )
 {
-  // Loading success flag
-  bool success = true;
+  size_t index = findEntry( path );
 
-  // Load background
-  if( !mBackgroundTexture.loadFromFile( BGPath ) )
+  if( index == mEntries.size() )
   {
-    printf( "Failed to intro background!\n" );
-    success = false;
-  }
-  else { /* Loading OK */ }
-
-  // Load text
-  SDL_Color textColor{ BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX};
+    Entry& loaded = addEntry( path );
+    loaded.Surface = LTexture::decodeFile( path );
+    ++mLoads;
 
-  if( !mMessageTexture.loadFromRenderedText( "Lazy Foo' Productions Presents...", textColor ) )
-  {
-    printf( "Failed to render intro text!\n" );
-    success = false;
+    index = findEntry( path );
   }
-  else { /* Loading OK */ }
+  else { /* Resident or prefetched */ }
 
-  return success;
-}
+  Entry& entry = *mEntries[index];
 
+  gJobs.wait( entry.Decoding );
+  finishDecode( entry );
 
-bool IntroState::exit(void)
-{
-  // Free background and text
-  mBackgroundTexture.free();
-  mMessageTexture.free();
+  ++entry.References;
+  entry.LastUsed = ++mTick;
 
-  return true;
+  evict();
+
+  return &entry.Texture;
 }
 
 
-void IntroState::handleEvent( SDL_Event& e )
+/**
+ * @brief Lets go of an image: it stays resident until the budget needs its memory.
+ **/
+void AssetResidency::release( const std::string& path )
 {
-  // If the user pressed enter
-  if( ( e.type == SDL_KEYDOWN ) && ( e.key.keysym.sym == SDLK_RETURN ) )
+  const size_t index = findEntry( path );
+
+  if( index != mEntries.size() && mEntries[index]->References > 0 )
   {
-    // Move onto title state
-    setNextState( TitleState::get() );
+    --mEntries[index]->References;
+    mEntries[index]->LastUsed = ++mTick;
+
+    evict();
   }
   else
-  { /* Event not managed here */ }
+  {
+    printf( "Image \"%s\" released but not held!\n", path.c_str() );
+  }
 }
 
 
-void IntroState::update(void)
-{;}
+/**
+ * @brief Starts decoding the images not resident yet, and marks all of them as just used, so that
+ * they are the last to be evicted.
+ *
+ * @param paths The images of the likely next states.
+ **/
+void AssetResidency::prefetch( const std::vector<std::string>& paths )
+{
+  for( const std::string& path : paths )
+  {
+    const size_t index = findEntry( path );
+
+    if( index != mEntries.size() )
+    {
+      mEntries[index]->LastUsed = ++mTick;
+    }
+    else
+    {
+      Entry& entry = addEntry( path );
+      entry.LastUsed = ++mTick;
+
+      gJobs.run( decodeJob, &entry, &entry.Decoding );
+    }
+  }
+}
 
 
-void IntroState::render(void)
+/**
+ * @brief Replaces the stream with the given images, which are decoded in that order, at most
+ * STREAM_DECODES at a time, as update goes: the first are ready first, and the workers are not
+ * flooded with jobs the loading screen would wait behind. The size of every file is read now, for
+ * the progress in bytes; a missing file counts as empty, and as done when its decoding fails.
+ *
+ * @param paths The images by priority, the most needed first.
+ **/
+void AssetResidency::stream( const std::vector<std::string>& paths )
 {
-  // Show the background
-  mBackgroundTexture.render( 0, 0 );
+  mStream.clear();
 
-  // Show the message
-  mMessageTexture.render( ( WINDOW_W - mMessageTexture.getWidth() ) / 2, ( WINDOW_H - mMessageTexture.getHeight() ) / 2 );
-}
+  for( const std::string& path : paths )
+  {
+    StreamItem item;
+    item.Path = path;
 
+    SDL_RWops* file = SDL_RWFromFile( path.c_str(), "rb" );
 
-IntroState IntroState::sIntroState; // Declare static instance
+    if( file != NULL )
+    {
+      const Sint64 size = SDL_RWsize( file );
+      item.Bytes = ( size > 0 ) ? static_cast<size_t>( size ) : 0;
+      SDL_RWclose( file );
+    }
+    else { /* Reported by the decoding */ }
 
+    mStream.push_back( item );
+  }
 
-IntroState::IntroState(void)
-{
-  // No public instantiation
+  launchStream();
 }
 
 
-/* TitleState */
-
+/**
+ * @brief Called once per frame: starts the next streamed decodings, if there is room, and uploads at
+ * most one decoded image, the first in line, so that the uploads are spread over several frames;
+ * then evicts what no longer fits the budget.
+ **/
+void AssetResidency::update( void )
+{
+  launchStream();
+
+  for( std::unique_ptr<Entry>& entry : mEntries )
+  {
+    if( entry->Surface != NULL && entry->Decoding.isDone() )
+    {
+      finishDecode( *entry );
+      break;
+    }
+    else { /* Already uploaded, or still decoding */ }
+  }
+
+  evict();
+}
+
+
+/**
+ * @brief Waits for the workers and frees every image. Before the renderer is destroyed.
+ **/
+void AssetResidency::clear( void )
+{
+  for( std::unique_ptr<Entry>& entry : mEntries )
+  {
+    gJobs.wait( entry->Decoding );
+    SDL_FreeSurface( entry->Surface );
+  }
+
+  mEntries.clear();
+}
+
+
+/**
+ * @return the memory taken by the images, uploaded or decoded.
+ **/
+size_t AssetResidency::getResidentBytes( void ) const
+{
+  size_t bytes = 0;
+
+  for( const std::unique_ptr<Entry>& entry : mEntries )
+  {
+    bytes += getBytes( *entry );
+  }
+
+  return bytes;
+}
+
+
+/**
+ * @return how many images acquire had to read from the disk itself.
+ **/
+int AssetResidency::getLoads( void ) const
+{
+  return mLoads;
+}
+
+
+/**
+ * @return how many of the streamed images, and how many bytes of their files, are ready: uploaded,
+ * or failed.
+ **/
+AssetResidency::Progress AssetResidency::getProgress( void ) const
+{
+  Progress progress;
+
+  for( const StreamItem& item : mStream )
+  {
+    ++progress.ItemsTotal;
+    progress.BytesTotal += item.Bytes;
+
+    if( isStreamed( item ) )
+    {
+      ++progress.ItemsDone;
+      progress.BytesDone += item.Bytes;
+    }
+    else { /* Waiting, decoding or not uploaded yet */ }
+  }
+
+  return progress;
+}
+
+
+void AssetResidency::decodeJob( void* data )
+{
+  Entry* entry = static_cast<Entry*>( data );
+
+  entry->Surface = LTexture::decodeFile( entry->Path );
+}
+
+
+/**
+ * @brief The memory of an image: its RGBA8888 texture, or its decoded surface while not uploaded.
+ * An entry still decoding counts as nothing until it is done.
+ **/
+size_t AssetResidency::getBytes( const Entry& entry )
+{
+  const size_t textureBytes = static_cast<size_t>( entry.Texture.getWidth() ) * static_cast<size_t>( entry.Texture.getHeight() ) * 4;
+  const size_t surfaceBytes = ( entry.Surface != NULL ) ? static_cast<size_t>( entry.Surface->pitch ) * static_cast<size_t>( entry.Surface->h ) : 0;
+
+  return textureBytes + surfaceBytes;
+}
+
+
+/**
+ * @return the index of the entry of an image; mEntries.size() if there is none.
+ **/
+size_t AssetResidency::findEntry( const std::string& path ) const
+{
+  size_t index = 0;
+
+  while( index != mEntries.size() && mEntries[index]->Path != path )
+  {
+    ++index;
+  }
+
+  return index;
+}
+
+
+AssetResidency::Entry& AssetResidency::addEntry( const std::string& path )
+{
+  mEntries.push_back( std::make_unique<Entry>() );
+  mEntries.back()->Path = path;
+
+  return *mEntries.back();
+}
+
+
+/**
+ * @brief Uploads the decoded surface of an entry, if it has one. Main thread only.
+ **/
+void AssetResidency::finishDecode( Entry& entry )
+{
+  if( entry.Surface != NULL )
+  {
+    entry.Texture.loadFromSurface( entry.Surface );
+    SDL_FreeSurface( entry.Surface );
+    entry.Surface = NULL;
+  }
+  else { /* Nothing decoded, or already uploaded */ }
+}
+
+
+/**
+ * @brief Starts decoding the next streamed images not resident yet, in their order, while fewer than
+ * STREAM_DECODES images are decoding. Each image is started once: one evicted later is not streamed
+ * again.
+ **/
+void AssetResidency::launchStream( void )
+{
+  int decoding = 0;
+
+  for( const std::unique_ptr<Entry>& entry : mEntries )
+  {
+    decoding += entry->Decoding.isDone() ? 0 : 1;
+  }
+
+  for( StreamItem& item : mStream )
+  {
+    if( item.Launched )
+    {
+      continue;
+    }
+    else if( decoding >= STREAM_DECODES )
+    {
+      break;
+    }
+    else { /* Room for one more */ }
+
+    item.Launched = true;
+
+    if( findEntry( item.Path ) == mEntries.size() )
+    {
+      Entry& entry = addEntry( item.Path );
+      entry.LastUsed = ++mTick;
+
+      gJobs.run( decodeJob, &entry, &entry.Decoding );
+      ++decoding;
+    }
+    else { /* Resident or prefetched already */ }
+  }
+}
+
+
+/**
+ * @return true if a streamed image was started and is uploaded, or failed, or was evicted since.
+ **/
+bool AssetResidency::isStreamed( const StreamItem& item ) const
+{
+  if( !item.Launched )
+  {
+    return false;
+  }
+  else { /* Started */ }
+
+  const size_t index = findEntry( item.Path );
+
+  return ( index == mEntries.size() ) || ( mEntries[index]->Decoding.isDone() && mEntries[index]->Surface == NULL );
+}
+
+
+/**
+ * @brief While over the budget, drops the least recently used image that no state holds and no
+ * worker is decoding. Held images are never dropped, even over the budget.
+ **/
+void AssetResidency::evict( void )
+{
+  size_t residentBytes = getResidentBytes();
+
+  while( residentBytes > mBudgetBytes )
+  {
+    size_t oldest = mEntries.size();
+
+    for( size_t index = 0; index != mEntries.size(); ++index )
+    {
+      const Entry& entry = *mEntries[index];
+
+      if( entry.References == 0 && entry.Decoding.isDone()
+          && ( oldest == mEntries.size() || entry.LastUsed < mEntries[oldest]->LastUsed ) )
+      {
+        oldest = index;
+      }
+      else { /* Held, decoding, or more recent */ }
+    }
+
+    if( oldest == mEntries.size() )
+    {
+      break;
+    }
+    else { /* Something to evict */ }
+
+    printf( "Image \"%s\" evicted\n", mEntries[oldest]->Path.c_str() );
+
+    residentBytes -= getBytes( *mEntries[oldest] );
+    SDL_FreeSurface( mEntries[oldest]->Surface );
+    mEntries.erase( mEntries.begin() + static_cast<std::ptrdiff_t>( oldest ) );
+  }
+}
+
+
+/* LoadingState */
+
+LoadingState* LoadingState::get(void)
+{
+  return &sLoadingState; // Get static instance
+}
+
+
+bool LoadingState::enter(void)
+{
+  mTimer.start();
+  mHasRendered  = false;
+  mMessageItems = -1;
+
+  // The intro first, as it is shown first, then the states likely to follow it
+  std::vector<GameState*>  nextStates;
+  std::vector<std::string> paths;
+
+  IntroState::get()->getImagePaths( paths );
+  IntroState::get()->getLikelyNextStates( nextStates );
+
+  for( GameState* state : nextStates )
+  {
+    state->getImagePaths( paths );
+  }
+
+  gResidency.stream( paths );
+
+  return true;
+}
+
+
+bool LoadingState::exit(void)
+{
+  // Free text
+  mMessageTexture.free();
+
+  return true;
+}
+
+
+void LoadingState::handleEvent( [[maybe_unused]] SDL_Event& e )
+{;}
+
+
+void LoadingState::update(void)
+{
+  const AssetResidency::Progress progress = gResidency.getProgress();
+
+  if( progress.ItemsDone == progress.ItemsTotal )
+  {
+    printf( "Loaded %d images, %u KiB, in %.3f ms\n", progress.ItemsTotal, static_cast<unsigned>( progress.BytesTotal / 1024 ),
+            mTimer.getSeconds() * 1000.0 );
+
+    setNextState( IntroState::get() );
+  }
+  else { /* Still streaming */ }
+}
+
+
+void LoadingState::render(void)
+{
+  const AssetResidency::Progress progress = gResidency.getProgress();
+
+  if( !mHasRendered )
+  {
+    printf( "Loading screen shown in %.3f ms\n", mTimer.getSeconds() * 1000.0 );
+    mHasRendered = true;
+  }
+  else { /* Shown already */ }
+
+  // Bar, filled by the bytes of the files ready
+  const int filled = ( progress.BytesTotal > 0 ) ? static_cast<int>( static_cast<Uint64>( LOADING_BAR_W ) * progress.BytesDone / progress.BytesTotal ) : 0;
+
+  SDL_Rect outline{ ( WINDOW_W - LOADING_BAR_W ) / 2, ( WINDOW_H - LOADING_BAR_H ) / 2, LOADING_BAR_W, LOADING_BAR_H };
+  SDL_Rect fill   { outline.x, outline.y, filled, LOADING_BAR_H };
+
+  SDL_SetRenderDrawColor( gRenderer, BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX );
+  SDL_RenderFillRect( gRenderer, &fill );
+  SDL_RenderDrawRect( gRenderer, &outline );
+  LPerfHarness::countDrawCalls( 2 );
+
+  // The dot at the tip of the bar
+  gDotTexture->render( outline.x + filled - Dot::DOT_WIDTH / 2, outline.y - Dot::DOT_HEIGHT - LOADING_BAR_H / 2 );
+
+  // Images done, rendered again only when they change
+  if( progress.ItemsDone != mMessageItems )
+  {
+    SDL_Color textColor{ BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX };
+    const std::string text = "Loading " + std::to_string( progress.ItemsDone ) + "/" + std::to_string( progress.ItemsTotal ) + " images, "
+                           + std::to_string( progress.BytesDone / 1024 ) + "/" + std::to_string( progress.BytesTotal / 1024 ) + " KiB";
+
+    if( mMessageTexture.loadFromRenderedText( text, textColor ) )
+    {
+      mMessageItems = progress.ItemsDone;
+    }
+    else
+    {
+      printf( "Failed to render loading text!\n" );
+    }
+  }
+  else { /* Same text as the last frame */ }
+
+  mMessageTexture.render( ( WINDOW_W - mMessageTexture.getWidth() ) / 2, outline.y + LOADING_BAR_H * 2 );
+}
+
+
+LoadingState LoadingState::sLoadingState; // Declare static instance
+
+
+LoadingState::LoadingState(void)
+{
+  // No public instantiation
+}
+
+
+/* IntroState */
+
+IntroState* IntroState::get(void)
+{
+  return &sIntroState; // Get static instance
+}
+
+
+bool IntroState::enter(void)
+{
+  // Loading success flag
+  bool success = true;
+
+  // Load background
+  mBackgroundTexture = gResidency.acquire( BGPath );
+
+  if( !mBackgroundTexture->isLoaded() )
+  {
+    printf( "Failed to intro background!\n" );
+    success = false;
+  }
+  else { /* Loading OK */ }
+
+  // Load text
+  SDL_Color textColor{ BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX};
+
+  if( !mMessageTexture.loadFromRenderedText( "Lazy Foo' Productions Presents...", textColor ) )
+  {
+    printf( "Failed to render intro text!\n" );
+    success = false;
+  }
+  else { /* Loading OK */ }
+
+  return success;
+}
+
+
+bool IntroState::exit(void)
+{
+  // Release the background, free text
+  gResidency.release( BGPath );
+  mBackgroundTexture = NULL;
+  mMessageTexture.free();
+
+  return true;
+}
+
+
+void IntroState::getLikelyNextStates( std::vector<GameState*>& next ) const
+{
+  next.push_back( TitleState::get() );
+}
+
+
+void IntroState::getImagePaths( std::vector<std::string>& paths ) const
+{
+  paths.push_back( BGPath );
+}
+
+
+void IntroState::handleEvent( SDL_Event& e )
+{
+  // If the user pressed enter
+  if( ( e.type == SDL_KEYDOWN ) && ( e.key.keysym.sym == SDLK_RETURN ) )
+  {
+    // Move onto title state
+    setNextState( TitleState::get() );
+  }
+  else
+  { /* Event not managed here */ }
+}
+
+
+void IntroState::update(void)
+{;}
+
+
+void IntroState::render(void)
+{
+  // Show the background
+  mBackgroundTexture->render( 0, 0 );
+
+  // Show the message
+  mMessageTexture.render( ( WINDOW_W - mMessageTexture.getWidth() ) / 2, ( WINDOW_H - mMessageTexture.getHeight() ) / 2 );
+}
+
+
+IntroState IntroState::sIntroState; // Declare static instance
+
+
+IntroState::IntroState(void)
+{
+  // No public instantiation
+}
+
+
+/* TitleState */
+
 TitleState* TitleState::get(void)
 {
   // Get static instance
@@ -1048,7 +1925,9 @@ bool TitleState::enter(void)
   bool success = true;
 
   // Load background
-  if( !mBackgroundTexture.loadFromFile( TitlePath ) )
+  mBackgroundTexture = gResidency.acquire( TitlePath );
+
+  if( !mBackgroundTexture->isLoaded() )
   {
     printf( "Failed to title background!\n" );
     success = false;
@@ -1071,14 +1950,27 @@ bool TitleState::enter(void)
 
 bool TitleState::exit(void)
 {
-  // Free background and text
-  mBackgroundTexture.free();
+  // Release the background, free text
+  gResidency.release( TitlePath );
+  mBackgroundTexture = NULL;
   mMessageTexture.free();
 
   return true;
 }
 
 
+void TitleState::getLikelyNextStates( std::vector<GameState*>& next ) const
+{
+  next.push_back( OverWorldState::get() );
+}
+
+
+void TitleState::getImagePaths( std::vector<std::string>& paths ) const
+{
+  paths.push_back( TitlePath );
+}
+
+
 void TitleState::handleEvent( SDL_Event& e )
 {
   // If the user pressed enter
@@ -1099,7 +1991,7 @@ void TitleState::update(void)
 void TitleState::render(void)
 {
   // Show the background
-  mBackgroundTexture.render( 0, 0 );
+  mBackgroundTexture->render( 0, 0 );
 
   // Show the message
   mMessageTexture.render( ( WINDOW_W - mMessageTexture.getWidth() ) / 2, ( WINDOW_H - mMessageTexture.getHeight() ) / 2 );
@@ -1130,38 +2022,49 @@ bool OverWorldState::enter(void)
   bool success = true;
 
   // Load background
-  if( !mBackgroundTexture.loadFromFile( GreenOWPath ) )
+  mBackgroundTexture = gResidency.acquire( GreenOWPath );
+
+  if( !mBackgroundTexture->isLoaded() )
   {
     printf( "Failed to load overworld background!\n" );
     success = false;
   }
 
   // Load house texture
-  if( !mBlueHouseTexture.loadFromFile( BlueHousePath ) )
+  mBlueHouseTexture = gResidency.acquire( BlueHousePath );
+
+  if( !mBlueHouseTexture->isLoaded() )
   {
     printf( "Failed to load blue house texture!\n" );
     success = false;
   }
 
   // Load house texture
-  if( !mRedHouseTexture.loadFromFile( RedHousePath ) )
+  mRedHouseTexture = gResidency.acquire( RedHousePath );
+
+  if( !mRedHouseTexture->isLoaded() )
   {
     printf( "Failed to load red house texture!\n" );
     success = false;
   }
 
   // Position houses with graphics
-   mRedHouse.set( 0                           , 0                            , &mRedHouseTexture  );
-  mBlueHouse.set( LEVEL_W - House::HOUSE_WIDTH, LEVEL_H - House::HOUSE_HEIGHT, &mBlueHouseTexture );
+   mRedHouse.set( 0                           , 0                            , mRedHouseTexture  );
+  mBlueHouse.set( LEVEL_W - House::HOUSE_WIDTH, LEVEL_H - House::HOUSE_HEIGHT, mBlueHouseTexture );
+
+  // The whole house is the door into its room
+  mDoors.clear();
+  mRedHouseDoor  = mDoors.add( mRedHouse.getCollider() );
+  mBlueHouseDoor = mDoors.add( mBlueHouse.getCollider() );
 
   // Came from red room state
-  if( gCurrentState == RedRoomState::get() )
+  if( gPreviousState == RedRoomState::get() )
   {
     // Position below red house
     gDot.set( mRedHouse.getCollider().x + ( House::HOUSE_WIDTH - Dot::DOT_WIDTH ) / 2, mRedHouse.getCollider().y + mRedHouse.getCollider().h + Dot::DOT_HEIGHT );
   }
   // Came from blue room state
-  else if( gCurrentState == BlueRoomState::get() )
+  else if( gPreviousState == BlueRoomState::get() )
   {
     // Position above blue house
     gDot.set( mBlueHouse.getCollider().x + ( House::HOUSE_WIDTH - Dot::DOT_WIDTH ) / 2, mBlueHouse.getCollider().y - Dot::DOT_HEIGHT * 2 );
@@ -1179,19 +2082,45 @@ bool OverWorldState::enter(void)
 
 bool OverWorldState::exit(void)
 {
-  // Free textures
-  mBackgroundTexture.free();
-  mRedHouseTexture.free();
-  mBlueHouseTexture.free();
+  // Release the textures: the houses keep pointers to theirs, but are not drawn until the next enter
+  gResidency.release( GreenOWPath   );
+  gResidency.release( RedHousePath  );
+  gResidency.release( BlueHousePath );
+
+  mBackgroundTexture = NULL;
+  mRedHouseTexture   = NULL;
+  mBlueHouseTexture  = NULL;
 
   return true;
 }
 
 
+void OverWorldState::getLikelyNextStates( std::vector<GameState*>& next ) const
+{
+  next.push_back( RedRoomState::get() );
+  next.push_back( BlueRoomState::get() );
+}
+
+
+void OverWorldState::getImagePaths( std::vector<std::string>& paths ) const
+{
+  paths.push_back( GreenOWPath );
+  paths.push_back( RedHousePath );
+  paths.push_back( BlueHousePath );
+}
+
+
 void OverWorldState::handleEvent( SDL_Event& e )
 {
   // Handle dot input
   gDot.handleEvent( e );
+
+  // Pause over the current state, which keeps its assets
+  if( isPauseKey( e ) )
+  {
+    pushState( PauseState::get() );
+  }
+  else { /* Event not managed here */ }
 }
 
 
@@ -1200,20 +2129,24 @@ void OverWorldState::update(void)
   // Move dot
   gDot.move( LEVEL_W, LEVEL_H );
 
-  // On red room collision
-  if( HasCollisionHappened( gDot.getCollider(), mRedHouse.getCollider() ) )
+  // Only the doors near the dot are tested
+  for( const LTriggerHit& hit : mDoors.update( gDot.getCollider() ) )
   {
-    // Got to red room
-    setNextState( RedRoomState::get() );
-  }
-  // On blue room collision
-  else if( HasCollisionHappened( gDot.getCollider(), mBlueHouse.getCollider() ) )
-  {
-    // Go to blue room
-    setNextState( BlueRoomState::get() );
+    // On entering the red house
+    if( ( hit.Event == LTriggerEvent::Enter ) && ( hit.Trigger == mRedHouseDoor ) )
+    {
+      // Got to red room
+      setNextState( RedRoomState::get() );
+    }
+    // On entering the blue house
+    else if( ( hit.Event == LTriggerEvent::Enter ) && ( hit.Trigger == mBlueHouseDoor ) )
+    {
+      // Go to blue room
+      setNextState( BlueRoomState::get() );
+    }
+    else
+    { /* Staying in or leaving a door. Continue */ }
   }
-  else
-  { /* No collision happened. Continue */ }
 }
 
 
@@ -1249,13 +2182,15 @@ void OverWorldState::render(void)
     camera.y = LEVEL_H - camera.h;
   }
 
-  // Render background
-  mBackgroundTexture.render( 0, 0, &camera );
+  // Queue the objects in any order: the draw list puts what stands lower on the screen in front,
+  // and the background below all of them
+        gDot.queue( gDrawList, LAYER_OBJECTS, camera );
+   mRedHouse.queue( gDrawList, LAYER_OBJECTS, camera );
+  mBlueHouse.queue( gDrawList, LAYER_OBJECTS, camera );
 
-  // Render objects
-   mRedHouse.render( camera );
-  mBlueHouse.render( camera );
-        gDot.render( camera );
+  gDrawList.add( LAYER_GROUND, 0.0f, mBackgroundTexture->getSDLTexture(), 0, 0, &camera );
+
+  gDrawList.flush( gRenderer );
 }
 
 
@@ -1263,6 +2198,7 @@ OverWorldState OverWorldState::sOverWorldState; // Declare static instance
 
 
 OverWorldState::OverWorldState(void)
+  : mDoors( SDL_Rect{ 0, 0, LEVEL_W, LEVEL_H }, House::HOUSE_WIDTH )
 {
   // No public instantiation
 }
@@ -1282,7 +2218,9 @@ bool RedRoomState::enter(void)
   bool success = true;
 
   // Load background
-  if( !mBackgroundTexture.loadFromFile( RedRoomPath ) )
+  mBackgroundTexture = gResidency.acquire( RedRoomPath );
+
+  if( !mBackgroundTexture->isLoaded() )
   {
     printf( "Failed to load blue room background!\n" );
     success = false;
@@ -1293,23 +2231,46 @@ bool RedRoomState::enter(void)
   mExitDoor.set( ( LEVEL_W - Door::DOOR_WIDTH ) / 2, LEVEL_H - Door::DOOR_HEIGHT );
        gDot.set( ( LEVEL_W - Dot::DOT_WIDTH )   / 2, LEVEL_H - Door::DOOR_HEIGHT - Dot::DOT_HEIGHT * 2 );
 
+  mTriggers.clear();
+  mExitTrigger = mTriggers.add( mExitDoor.getCollider() );
+
   return success;
 }
 
 
 bool RedRoomState::exit(void)
 {
-  // Free background
-  mBackgroundTexture.free();
+  // Release the background
+  gResidency.release( RedRoomPath );
+  mBackgroundTexture = NULL;
 
   return true;
 }
 
 
+void RedRoomState::getLikelyNextStates( std::vector<GameState*>& next ) const
+{
+  next.push_back( OverWorldState::get() );
+}
+
+
+void RedRoomState::getImagePaths( std::vector<std::string>& paths ) const
+{
+  paths.push_back( RedRoomPath );
+}
+
+
 void RedRoomState::handleEvent( SDL_Event& e )
 {
   // Handle dot input
   gDot.handleEvent( e );
+
+  // Pause over the current state, which keeps its assets
+  if( isPauseKey( e ) )
+  {
+    pushState( PauseState::get() );
+  }
+  else { /* Event not managed here */ }
 }
 
 
@@ -1318,14 +2279,17 @@ void RedRoomState::update(void)
   // Move dot
   gDot.move( LEVEL_W, LEVEL_H );
 
-  // On exit collision
-  if( HasCollisionHappened( gDot.getCollider(), mExitDoor.getCollider() ) )
+  // On reaching the exit door
+  for( const LTriggerHit& hit : mTriggers.update( gDot.getCollider() ) )
   {
-    // Go back to overworld
-    setNextState( OverWorldState::get() );
+    if( ( hit.Event == LTriggerEvent::Enter ) && ( hit.Trigger == mExitTrigger ) )
+    {
+      // Go back to overworld
+      setNextState( OverWorldState::get() );
+    }
+    else
+    { /* Staying in or leaving the door. Continue */ }
   }
-  else
-  { /* No collision happened. Continue */ }
 }
 
 
@@ -1335,7 +2299,7 @@ void RedRoomState::render(void)
   SDL_Rect camera = { 0, 0, LEVEL_W, LEVEL_H };
 
   // Render background
-  mBackgroundTexture.render( 0, 0, &camera );
+  mBackgroundTexture->render( 0, 0, &camera );
 
   // Render objects
   mExitDoor.render();
@@ -1347,6 +2311,7 @@ RedRoomState RedRoomState::sRedRoomState; // Declare static instance
 
 
 RedRoomState::RedRoomState(void)
+  : mTriggers( SDL_Rect{ 0, 0, LEVEL_W, LEVEL_H }, Door::DOOR_HEIGHT )
 {
   // No public instantiation
 }
@@ -1367,7 +2332,9 @@ bool BlueRoomState::enter(void)
   bool success = true;
 
   // Load background
-  if( !mBackgroundTexture.loadFromFile( BlueRoomPath ) )
+  mBackgroundTexture = gResidency.acquire( BlueRoomPath );
+
+  if( !mBackgroundTexture->isLoaded() )
   {
     printf( "Failed to load blue room background!\n" );
     success = false;
@@ -1378,23 +2345,46 @@ bool BlueRoomState::enter(void)
   mExitDoor.set( ( LEVEL_W - Door::DOOR_WIDTH ) / 2, 0 );
        gDot.set( ( LEVEL_W - Dot::DOT_WIDTH )   / 2, Door::DOOR_HEIGHT + Dot::DOT_HEIGHT * 2 );
 
+  mTriggers.clear();
+  mExitTrigger = mTriggers.add( mExitDoor.getCollider() );
+
   return success;
 }
 
 
 bool BlueRoomState::exit(void)
 {
-  // Free background
-  mBackgroundTexture.free();
+  // Release the background
+  gResidency.release( BlueRoomPath );
+  mBackgroundTexture = NULL;
 
   return true;
 }
 
 
+void BlueRoomState::getLikelyNextStates( std::vector<GameState*>& next ) const
+{
+  next.push_back( OverWorldState::get() );
+}
+
+
+void BlueRoomState::getImagePaths( std::vector<std::string>& paths ) const
+{
+  paths.push_back( BlueRoomPath );
+}
+
+
 void BlueRoomState::handleEvent( SDL_Event& e )
 {
   // Handle dot input
   gDot.handleEvent( e );
+
+  // Pause over the current state, which keeps its assets
+  if( isPauseKey( e ) )
+  {
+    pushState( PauseState::get() );
+  }
+  else { /* Event not managed here */ }
 }
 
 
@@ -1403,14 +2393,17 @@ void BlueRoomState::update(void)
   // Move dot
   gDot.move( LEVEL_W, LEVEL_H );
 
-  // On exit collision
-  if( HasCollisionHappened( gDot.getCollider(), mExitDoor.getCollider() ) )
+  // On reaching the exit door
+  for( const LTriggerHit& hit : mTriggers.update( gDot.getCollider() ) )
   {
-    // Back to overworld
-    setNextState( OverWorldState::get() );
+    if( ( hit.Event == LTriggerEvent::Enter ) && ( hit.Trigger == mExitTrigger ) )
+    {
+      // Back to overworld
+      setNextState( OverWorldState::get() );
+    }
+    else
+    { /* Staying in or leaving the door. Continue */ }
   }
-  else
-  { /* No collision happened. Continue */ }
 }
 
 
@@ -1420,7 +2413,7 @@ void BlueRoomState::render(void)
   SDL_Rect camera = { 0, 0, LEVEL_W, LEVEL_H };
 
   // Render background
-  mBackgroundTexture.render( 0, 0, &camera );
+  mBackgroundTexture->render( 0, 0, &camera );
 
   // Render objects
   mExitDoor.render();
@@ -1432,10 +2425,93 @@ BlueRoomState BlueRoomState::sBlueRoomState; // Declare static instance
 
 
 BlueRoomState::BlueRoomState(void)
+  : mTriggers( SDL_Rect{ 0, 0, LEVEL_W, LEVEL_H }, Door::DOOR_HEIGHT )
 {
   // No public instantiation
 }
 
+/* PauseState */
+
+PauseState* PauseState::get(void)
+{
+  return &sPauseState; // Get static instance
+}
+
+
+bool PauseState::enter(void)
+{
+  // Load text
+  SDL_Color textColor{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+  if( !mMessageTexture.loadFromRenderedText( "Paused - press P to resume", textColor ) )
+  {
+    printf( "Failed to render pause text!\n" );
+    return false;
+  }
+  else { /* Text rendering OK */ }
+
+  return true;
+}
+
+
+bool PauseState::exit(void)
+{
+  // Free text
+  mMessageTexture.free();
+
+  return true;
+}
+
+
+void PauseState::handleEvent( SDL_Event& e )
+{
+  // The dot is not moved while paused, but keeps track of the keys, not to drift on resume
+  gDot.handleEvent( e );
+
+  // Back to the state below
+  if( isPauseKey( e ) )
+  {
+    popState();
+  }
+  else { /* Event not managed here */ }
+}
+
+
+void PauseState::update(void)
+{;}
+
+
+void PauseState::render(void)
+{
+  // Darken the states below
+  SDL_Rect screen{ 0, 0, WINDOW_W, WINDOW_H };
+
+  SDL_SetRenderDrawBlendMode( gRenderer, SDL_BLENDMODE_BLEND );
+  SDL_SetRenderDrawColor( gRenderer, BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX / 2 );
+  SDL_RenderFillRect( gRenderer, &screen );
+  LPerfHarness::countDrawCalls( 1 );
+  SDL_SetRenderDrawBlendMode( gRenderer, SDL_BLENDMODE_NONE );
+
+  // Show the message
+  mMessageTexture.render( ( WINDOW_W - mMessageTexture.getWidth() ) / 2, ( WINDOW_H - mMessageTexture.getHeight() ) / 2 );
+}
+
+
+bool PauseState::isOverlay(void) const
+{
+  return true;
+}
+
+
+PauseState PauseState::sPauseState; // Declare static instance
+
+
+PauseState::PauseState(void)
+{
+  // No public instantiation
+}
+
+
 /* Hollow exit state */
 
 ExitState* ExitState::get(void)
@@ -1536,6 +2612,9 @@ static bool init(void)
         // Initialize renderer color
         SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
 
+        // The objects of the overworld overlap back to front, whatever their texture
+        gDrawList.setOrder( LAYER_OBJECTS, LDrawOrder::Depth );
+
         // Initialize PNG loading
         int imgFlags = IMG_INIT_PNG;
 
@@ -1559,6 +2638,16 @@ static bool init(void)
         {
           printf( "OK: SDL_ttf initialised\n" );
         }
+
+        // Start the job workers: if they cannot start, the bands run on this thread
+        if( !gJobs.init() )
+        {
+          printf( "Unable to start the job workers!\n" );
+        }
+        else
+        {
+          printf( "OK: %d job workers started\n", gJobs.GetWorkerCount() );
+        }
       }
     }
   }
@@ -1580,7 +2669,9 @@ static bool loadMedia(void)
 
   /* Load dot texture */
 
-  if( !gDotTexture.loadFromFile( DotPath ) )
+  gDotTexture = gResidency.acquire( DotPath );
+
+  if( !gDotTexture->isLoaded() )
   {
     printf( "Failed to load dot texture! SDL Error: \"%s\"\n", SDL_GetError() );
     success = false;
@@ -1608,12 +2699,22 @@ static bool loadMedia(void)
 static void close(void)
 {
   // Free the surfaces
-  gDotTexture.free();
+  if( gDotTexture != NULL )
+  {
+    gResidency.release( DotPath );
+    gDotTexture = NULL;
+  }
+  else { /* Media never loaded */ }
+
+  gResidency.clear();
 
   // Close the font that was used
   TTF_CloseFont( gFont );
   gFont = NULL;
 
+  // Stop the job workers
+  gJobs.shutdown();
+
   // Destroy windows
   SDL_DestroyRenderer( gRenderer );
   SDL_DestroyWindow( gWindow );
@@ -1628,101 +2729,154 @@ static void close(void)
 
 
 /**
- * @brief Used to mark our state machine for state transition. Gives priority to quit requests by
- * the user.
+ * @return true for a press of the pause key, 'p', not repeated.
+ **/
+static bool isPauseKey( const SDL_Event& e )
+{
+  return ( e.type == SDL_KEYDOWN ) && ( e.key.repeat == 0 ) && ( e.key.keysym.sym == SDLK_p );
+}
+
+
+/**
+ * @brief Used to mark our state machine for state transition: the whole stack will be replaced by
+ * the new state. Gives priority to quit requests by the user.
  *
  * @param newState
  **/
 static void setNextState( GameState* newState )
 {
   // If the user doesn't want to exit
-  if( gNextState != ExitState::get() )
+  if( !( ( gStateChange == StateChange::Replace ) && ( gNextState == ExitState::get() ) ) )
   {
     // Set the next state
-    gNextState = newState;
+    gStateChange = StateChange::Replace;
+    gNextState   = newState;
   }
   else { /* Continue */ }
 }
 
 
 /**
- * @brief Calls the state exit/enter functions and does the actual state change
+ * @brief Marks a state to go on top of the stack, over the current one, which stays entered.
  **/
-static void changeState(void)
+static void pushState( GameState* newState )
 {
-  // If the state needs to be changed
-
-  if( gNextState != NULL )
+  if( gStateChange == StateChange::None )
   {
-    gCurrentState->exit();
-    gNextState->enter();
+    gStateChange = StateChange::Push;
+    gNextState   = newState;
+  }
+  else { /* Another change is pending */ }
+}
 
-    // Change the current state ID
 
-    gCurrentState = gNextState;
-    gNextState    = NULL;
+/**
+ * @brief Marks the top state to leave, back to the one below.
+ **/
+static void popState(void)
+{
+  if( ( gStateChange == StateChange::None ) && ( gStateStack.size() > 1 ) )
+  {
+    gStateChange = StateChange::Pop;
   }
-  else { /* No need to change state */ }
+  else { /* Another change is pending, or nothing below */ }
 }
 
 
 /**
- * @brief Check collisions
- *
- * @param a
- * @param b
- * @return true
- * @return false
+ * @brief Calls the state exit/enter functions and does the actual state change
  **/
-static bool HasCollisionHappened( SDL_Rect a, SDL_Rect b )
+static void changeState(void)
 {
-  bool Result = true;
+  // If the state needs to be changed
 
-  // The sides of the rectangles
-  int leftA  , leftB;
-  int rightA , rightB;
-  int topA   , topB;
-  int bottomA, bottomB;
+  if( gStateChange == StateChange::None )
+  {
+    return;
+  }
+  else { /* Change the stack */ }
 
-  // Calculate the sides of rect A
-  leftA   = a.x;
-  rightA  = a.x + a.w;
-  topA    = a.y;
-  bottomA = a.y + a.h;
+  LHighResTimer transitionTimer;
+  transitionTimer.start();
 
-  // Calculate the sides of rect B
-  leftB   = b.x;
-  rightB  = b.x + b.w;
-  topB    = b.y;
-  bottomB = b.y + b.h;
+  const int loads = gResidency.getLoads();
 
-  // If any of the sides from A are outside of B
-  if( bottomA <= topB )
+  switch( gStateChange )
   {
-    Result = false;
+    case StateChange::Replace:
+      // Every state of the stack is left, top first; the next one may check where the game came from
+      gPreviousState = gStateStack.front();
+
+      while( !gStateStack.empty() )
+      {
+        gStateStack.back()->exit();
+        gStateStack.pop_back();
+      }
+
+      gNextState->enter();
+      gStateStack.push_back( gNextState );
+      break;
+
+    case StateChange::Push:
+      gNextState->enter();
+      gStateStack.push_back( gNextState );
+      break;
+
+    case StateChange::Pop:
+      gStateStack.back()->exit();
+      gStateStack.pop_back();
+      break;
+
+    case StateChange::None:
+      break;
   }
-  else {;}
 
-  if( topA >= bottomB )
+  gStateChange = StateChange::None;
+  gNextState   = NULL;
+
+  printf( "State changed in %.3f ms, %d images loaded from disk, %u KiB resident\n", transitionTimer.getSeconds() * 1000.0,
+          gResidency.getLoads() - loads, static_cast<unsigned>( gResidency.getResidentBytes() / 1024 ) );
+
+  // Start decoding where the game is likely to go from here
+  warmUpNextStates();
+}
+
+
+/**
+ * @brief Prefetches the images of the states likely to follow the one on top of the stack.
+ **/
+static void warmUpNextStates(void)
+{
+  std::vector<GameState*>  nextStates;
+  std::vector<std::string> paths;
+
+  gStateStack.back()->getLikelyNextStates( nextStates );
+
+  for( GameState* state : nextStates )
   {
-    Result = false;
+    state->getImagePaths( paths );
   }
-  else {;}
 
-  if( rightA <= leftB )
+  gResidency.prefetch( paths );
+}
+
+
+/**
+ * @brief Renders the top state and, bottom first, the states below that its overlays let show.
+ **/
+static void renderStates(void)
+{
+  size_t first = gStateStack.size() - 1;
+
+  while( ( first > 0 ) && gStateStack[first]->isOverlay() )
   {
-    Result = false;
+    --first;
   }
-  else {;}
 
-  if( leftA >= rightB )
+  for( size_t index = first; index != gStateStack.size(); ++index )
   {
-    Result = false;
+    gStateStack[index]->render();
   }
-  else {;}
-
-  // If none of the sides from A are outside B
-  return Result;
 }
 
 
@@ -1753,9 +2907,18 @@ int main( int argc, char* args[] )
     printf("\nArgument #%d: %s\n", i, args[i]);
   }
 
+  // "--perf-frames=<N>" runs a scripted, headless performance check
+  if( !LPerfHarness::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
+  // "--trace=<file>" records a timeline of every thread
+  else if( !LTrace::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   /* Start up SDL and create window */
-
-  if( !init() )
+  else if( !init() )
   {
   printf( "\nFailed to initialise!" );
   }
@@ -1775,49 +2938,87 @@ int main( int argc, char* args[] )
       // Event handler
       SDL_Event e;
 
-      // Set the current game state object
-      gCurrentState = IntroState::get();
-      gCurrentState->enter();
+      LTrace::nameThread( "Main" );
+
+      // Set the current game state object: the loading screen, but in the performance runs, whose
+      // scripts count the frames from the intro
+      gStateStack.push_back( LPerfHarness::isActive() ? static_cast<GameState*>( IntroState::get() ) : LoadingState::get() );
+      gStateStack.back()->enter();
+      warmUpNextStates();
 
       // While the user hasn't quit
-      while( gCurrentState != ExitState::get() )
+      while( gStateStack.back() != ExitState::get() )
       {
-        // Do state event handling
-        while( SDL_PollEvent( &e ) != 0 )
+        // Scripted input of this frame, if any
+        LPerfHarness::beginFrame();
+        LTrace::frameMark();
+
+        const Uint64 DrawCallsAtStart = LPerfHarness::GetDrawCalls();
+
         {
-          // Handle state events
-          gCurrentState->handleEvent( e );
+          LTrace::Zone Traced( "Events" );
 
-          // Exit on quit
-          if( e.type == SDL_QUIT )
+          // Do state event handling
+          while( SDL_PollEvent( &e ) != 0 )
           {
-            setNextState( ExitState::get() );
+            // Handle state events
+            gStateStack.back()->handleEvent( e );
+
+            // Exit on quit
+            if( e.type == SDL_QUIT )
+            {
+              setNextState( ExitState::get() );
+            }
+            else { /* Event not managed here */ }
           }
-          else { /* Event not managed here */ }
         }
 
-        // Do state logic (with polymorphism)
-        gCurrentState->update();
+        {
+          LTrace::Zone Traced( "Update" );
 
-        // Change state if needed
-        changeState();
+          // Do state logic (with polymorphism)
+          gStateStack.back()->update();
 
-        // Clear screen
-        SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
-        SDL_RenderClear( gRenderer );
+          // Change state if needed
+          changeState();
+
+          // Upload an image decoded ahead of time, if any, and keep to the memory budget
+          gResidency.update();
+        }
+
+        {
+          LTrace::Zone Traced( "Render" );
+
+          // Clear screen
+          SDL_SetRenderDrawColor( gRenderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
+          SDL_RenderClear( gRenderer );
 
-        // Do state rendering
-        gCurrentState->render();
+          // Do state rendering, with the states below the overlays
+          renderStates();
+        }
 
-        // Update screen
-        SDL_RenderPresent( gRenderer );
+        {
+          LTrace::Zone Traced( "Present" );
+
+          // Update screen
+          SDL_RenderPresent( gRenderer );
+        }
+
+        LTrace::counter( "Draw calls", static_cast<double>( LPerfHarness::GetDrawCalls() - DrawCallsAtStart ) );
+        LPerfHarness::endFrame();
       }
     }
   }
 
+  // Write what is left of the trace while SDL is still up
+  LTrace::close();
+
   // Free resources and close SDL
   close();
 
+  // Frame times, allocations and draw calls against the budget, if it was a performance run
+  HasProgramSucceeded = LPerfHarness::finish() && HasProgramSucceeded;
+
   // Integrity check
   if ( HasProgramSucceeded == true )
   {
@@ -1828,7 +3029,12 @@ int main( int argc, char* args[] )
     printf("\nThere was a problem during the execution of the program!\n");
   }
 
-  PressEnter();
+  // Nobody to press ENTER during a performance run
+  if( !LPerfHarness::isActive() )
+  {
+    PressEnter();
+  }
+  else { /* Headless */ }
 
-  return 0;
+  return HasProgramSucceeded ? 0 : 1;
 }
@@ -0,0 +1,64 @@
+@echo off
+
+cls
+echo Performance check: every program runs headless with its PerfScript.txt and PerfBudget.txt
+echo.
+
+@REM Frames run by each program
+set PERF_FRAMES=600
+
+@REM Programs to check, built first with their Build.bat
+set PERF_PROGRAMS=LazyFoo_SDL_Tutorial\38_particle_engines\38_particle_engines LazyFoo_SDL_Tutorial\39_tiling\39_tiling LazyFoo_SDL_Tutorial\State_Machines\State_Machines Progetti\Pallina\Pallina
+
+@REM Set temporary environment variables
+set SDL2_DLL=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\bin
+set SDL2_IMAGE_DLL=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\bin
+set SDL2_TTF_DLL=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\bin\
+set SDL2_DLL_PATHS=%SDL2_DLL%;%SDL2_IMAGE_DLL%;%SDL2_TTF_DLL%
+
+if not defined PATH_TO_DLL_IS_PRESENT (
+  SET PATH=%PATH%;%SDL2_DLL_PATHS%;
+  SET PATH_TO_DLL_IS_PRESENT=1
+)
+
+set PERF_FAILURES=0
+
+for %%P in (%PERF_PROGRAMS%) do call :Check %%P
+
+echo.
+if %PERF_FAILURES% EQU 0 (
+  echo [32mEvery program is within its budget![0m
+  echo.
+  exit /b 0
+) else (
+  echo [31m*** Error ***[0m
+  echo.
+  echo %PERF_FAILURES% programs failed their performance check.
+  echo.
+  exit /b 1
+)
+
+
+@REM Runs one program from its directory, where its assets, script and budget are
+:Check
+  pushd %~dp1
+
+  if not exist %~n1.exe (
+    echo Executable [31m%~n1.exe[0m not found. Compile with [32mBuild.bat[0m first.
+    set /a PERF_FAILURES+=1
+    popd
+    exit /b
+  )
+
+  echo Checking %~n1...
+  %~n1.exe --perf-frames=%PERF_FRAMES% --perf-script=PerfScript.txt --perf-budget=PerfBudget.txt --perf-csv=Perf.csv
+
+  if %ERRORLEVEL% NEQ 0 (
+    echo.
+    echo [31m%~n1 failed, see %~dp1Perf.csv[0m
+    set /a PERF_FAILURES+=1
+  )
+  echo.
+
+  popd
+  exit /b
@@ -16,8 +16,8 @@ set SDL2_IMAGE_LIB_PATH=D:\Dati\SDL2\SDL2_image-2.6.0\x86_64-w64-mingw32\lib\
 set SDL2_TTF_LIB_PATH=D:\Dati\SDL2\SDL2_ttf-2.20.0\x86_64-w64-mingw32\lib\
 set SDL2_LIB_PATHS=-L%SDL2_LIB_PATH% -L%SDL2_IMAGE_LIB_PATH% -L%SDL2_TTF_LIB_PATH%
 
-@REM Static libraries
-set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf
+@REM Static libraries. ws2_32 is Winsock, for the telemetry of Classes\TelemetrySink
+set SDL2_LIBRARIES=-lmingw32 -lSDL2main -lSDL2 -lSDL2_image -lSDL2_ttf -lws2_32
 
 @REM Header files
 set SDL2_INCLUDE_PATH=D:\Dati\SDL2\SDL2-2.0.22\x86_64-w64-mingw32\include\SDL2
@@ -28,8 +28,9 @@ set INTERFACES_INCLUDE_PATH=.\Interfaces
 set COLOURS_LIB_INCLUDE_PATH=D:\Dati\Versionamento\Git\Esercizi_Programmazione\SDL_2.0\Colours_Lib
 set SDL2_INCLUDE_PATHS=-I%SDL2_INCLUDE_PATH% -I%SDL2_IMAGE_INCLUDE_PATH% -I%SDL2_TTF_INCLUDE_PATH% -I%CLASSES_INCLUDE_PATH% -I%INTERFACES_INCLUDE_PATH% -I%COLOURS_LIB_INCLUDE_PATH%
 
-@REM C++ compilation options
-set COMPILATION_OPTIONS=-Wall -Wextra -Wpedantic -Wconversion
+@REM C++ compilation options. TRACK_ALLOCATIONS counts the heap allocations of every frame (see
+@REM Classes\AllocationTracker.hpp): remove it to build without the global operator new hook
+set COMPILATION_OPTIONS=-Wall -Wextra -Wpedantic -Wconversion -DTRACK_ALLOCATIONS
 
 
 if %1.==-c. goto Clean
@@ -8,23 +8,137 @@ AbstractGraphicElement::AbstractGraphicElement(void)
   m_Height_px             = 0;
   m_CurrentPosition_pt.x  = 0;
   m_CurrentPosition_pt.y  = 0;
+  m_IsDirty               = true;
+  m_DirtyArea_Rect        = GetBounds();
+  m_LocalPosition_pt      = m_CurrentPosition_pt;
+  m_Parent_Ptr            = nullptr;
+  m_SubtreeBounds_Rect    = GetBounds();
+  m_IsTransformDirty      = false;
+  m_HasDirtyDescendant    = false;
 }
 
 
 AbstractGraphicElement::AbstractGraphicElement( const SDL_Point& Point = SDL_Point{0, 0}, int Width = 0, int Height = 0 )
-  : m_Width_px(Width), m_Height_px(Height), m_CurrentPosition_pt(Point)
+  : m_Width_px(Width), m_Height_px(Height), m_CurrentPosition_pt(Point),
+    m_IsDirty(true), m_DirtyArea_Rect{Point.x, Point.y, Width, Height},
+    m_LocalPosition_pt(Point), m_Parent_Ptr(nullptr), m_Children_Vec(), m_SubtreeBounds_Rect{Point.x, Point.y, Width, Height},
+    m_IsTransformDirty(false), m_HasDirtyDescendant(false)
 {;}
 
 
 /**
- * @brief Sets the position of the graphical element.
+ * @brief Makes an element a child of this one: its position becomes relative to this element's, and
+ * it is drawn after it and after the children added before.
  *
- * @param Point The upper left corner of the element.
+ * @param Child Removed from its previous parent, if any.
+ **/
+void AbstractGraphicElement::addChild( AbstractGraphicElement& Child )
+{
+  if ( Child.m_Parent_Ptr != nullptr )
+  {
+    Child.m_Parent_Ptr->removeChild( Child );
+  }
+  else
+  {;}
+
+  m_Children_Vec.push_back( &Child );
+
+  Child.m_Parent_Ptr       = this;
+  Child.m_IsTransformDirty = true;
+  Child.FlagAncestors_Pvt();
+}
+
+
+/**
+ * @brief Detaches a child: its position becomes relative to the window.
+ **/
+void AbstractGraphicElement::removeChild( AbstractGraphicElement& Child )
+{
+  for ( auto Iter = m_Children_Vec.begin(); Iter != m_Children_Vec.end(); ++Iter )
+  {
+    if ( *Iter == &Child )
+    {
+      m_Children_Vec.erase( Iter );
+
+      // This subtree's bounds shrink, the child's position changes meaning
+      m_IsTransformDirty = true;
+      FlagAncestors_Pvt();
+
+      Child.m_Parent_Ptr       = nullptr;
+      Child.m_IsTransformDirty = true;
+      return;
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Brings the window positions and the subtree bounds up to date, visiting only the branches
+ * flagged by a change. Every element that moves is marked dirty, over the area it leaves and the one
+ * it reaches. Call it on the root, once per frame, before the dirty areas are collected.
+ *
+ * @return The number of elements that moved.
+ **/
+int AbstractGraphicElement::updateTransforms(void)
+{
+  const SDL_Point Origin = ( m_Parent_Ptr != nullptr ) ? m_Parent_Ptr->m_CurrentPosition_pt : SDL_Point{ 0, 0 };
+  int             Moved  = 0;
+
+  Update_Pvt( Origin, false, Moved );
+
+  return Moved;
+}
+
+
+/**
+ * @brief Queues the elements of the subtree that touch an area, in drawing order: parents before
+ * their children. A subtree whose bounds miss the area is skipped whole.
+ *
+ * @param Area The area being composited, in window coordinates.
+ **/
+void AbstractGraphicElement::renderSubtree( const SDL_Rect& Area )
+{
+  if ( !SDL_HasIntersection( &m_SubtreeBounds_Rect, &Area ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const SDL_Rect Bounds = GetBounds();
+
+  if ( SDL_HasIntersection( &Bounds, &Area ) )
+  {
+    render();
+  }
+  else
+  {;}
+
+  for ( auto Child_Ptr : m_Children_Vec )
+  {
+    Child_Ptr->renderSubtree( Area );
+  }
+}
+
+
+/**
+ * @brief Sets the position of the graphical element. It takes effect at the next updateTransforms.
+ *
+ * @param Point The upper left corner of the element, relative to its parent.
  **/
 void AbstractGraphicElement::setPosition( const SDL_Point& Point )
 {
-  m_CurrentPosition_pt.x = Point.x;
-  m_CurrentPosition_pt.y = Point.y;
+  if ( Point.x != m_LocalPosition_pt.x || Point.y != m_LocalPosition_pt.y )
+  {
+    m_LocalPosition_pt = Point;
+    m_IsTransformDirty = true;
+
+    FlagAncestors_Pvt();
+  }
+  else
+  {;}
 }
 
 
@@ -36,8 +150,30 @@ void AbstractGraphicElement::setPosition( const SDL_Point& Point )
  **/
 void AbstractGraphicElement::setSize( int const Width_px, int const Height_px)
 {
-  m_Width_px  = Width_px;
-  m_Height_px = Height_px;
+  if ( Width_px != m_Width_px || Height_px != m_Height_px )
+  {
+    MarkDirty();
+
+    m_Width_px  = Width_px;
+    m_Height_px = Height_px;
+
+    MarkDirty();
+
+    // The bounds of the subtrees above have to be recomputed
+    m_IsTransformDirty = true;
+    FlagAncestors_Pvt();
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Position relative to the parent, as last set.
+ **/
+SDL_Point AbstractGraphicElement::GetPosition(void) const
+{
+  return m_LocalPosition_pt;
 }
 
 
@@ -50,4 +186,167 @@ int AbstractGraphicElement::GetWidth(void) const
 int AbstractGraphicElement::GetHeight(void) const
 {
   return m_Height_px;
-}
\ No newline at end of file
+}
+
+
+/**
+ * @brief Area currently covered by the element in the main window.
+ **/
+SDL_Rect AbstractGraphicElement::GetBounds(void) const
+{
+  return SDL_Rect{ m_CurrentPosition_pt.x, m_CurrentPosition_pt.y, m_Width_px, m_Height_px };
+}
+
+
+/**
+ * @brief Area covered by the element and all its descendants in the main window.
+ **/
+SDL_Rect AbstractGraphicElement::GetSubtreeBounds(void) const
+{
+  return m_SubtreeBounds_Rect;
+}
+
+
+AbstractGraphicElement* AbstractGraphicElement::GetParent(void) const
+{
+  return m_Parent_Ptr;
+}
+
+
+/**
+ * @brief Whether this element or one below it was moved or resized since the last updateTransforms.
+ **/
+bool AbstractGraphicElement::HasPendingTransforms(void) const
+{
+  return m_IsTransformDirty || m_HasDirtyDescendant;
+}
+
+
+/**
+ * @brief Whether the element changed since it was last composited.
+ **/
+bool AbstractGraphicElement::IsDirty(void) const
+{
+  return m_IsDirty;
+}
+
+
+/**
+ * @brief Area to be re-composited. It includes the areas covered by the element before it was
+ * moved or resized. Meaningful only if the element is dirty.
+ **/
+SDL_Rect AbstractGraphicElement::GetDirtyArea(void) const
+{
+  return m_DirtyArea_Rect;
+}
+
+
+/**
+ * @brief Call this method once the element has been composited.
+ **/
+void AbstractGraphicElement::ClearDirty(void)
+{
+  m_IsDirty = false;
+}
+
+
+/**
+ * @brief Flags the element as changed, extending the dirty area to its current bounds.
+ **/
+void AbstractGraphicElement::MarkDirty(void)
+{
+  MarkDirty( GetBounds() );
+}
+
+
+/**
+ * @brief Flags only a part of the element as changed, e.g. a character of a display.
+ *
+ * @param Area The changed area, in window coordinates.
+ **/
+void AbstractGraphicElement::MarkDirty(const SDL_Rect& Area)
+{
+  if ( m_IsDirty )
+  {
+    SDL_UnionRect( &m_DirtyArea_Rect, &Area, &m_DirtyArea_Rect );
+  }
+  else
+  {
+    m_DirtyArea_Rect = Area;
+    m_IsDirty        = true;
+  }
+}
+
+
+/**
+ * @brief Flags the ancestors as having a changed descendant. An ancestor already flagged has its own
+ * ancestors flagged too, so the walk stops there.
+ **/
+void AbstractGraphicElement::FlagAncestors_Pvt(void)
+{
+  for ( AbstractGraphicElement* Ancestor_Ptr = m_Parent_Ptr;
+        Ancestor_Ptr != nullptr && !Ancestor_Ptr->m_HasDirtyDescendant;
+        Ancestor_Ptr = Ancestor_Ptr->m_Parent_Ptr )
+  {
+    Ancestor_Ptr->m_HasDirtyDescendant = true;
+  }
+}
+
+
+/**
+ * @brief Updates the element's window position and, if anything below changed, its subtree.
+ *
+ * @param Origin Window position of the parent.
+ * @param IsForced Whether the parent moved, moving this element too.
+ * @param Moved Incremented for each element that moves.
+ **/
+void AbstractGraphicElement::Update_Pvt( const SDL_Point& Origin, bool IsForced, int& Moved )
+{
+  const bool IsChanged = IsForced || m_IsTransformDirty;
+  bool       HasMoved  = false;
+
+  if ( IsChanged )
+  {
+    const SDL_Point World{ Origin.x + m_LocalPosition_pt.x, Origin.y + m_LocalPosition_pt.y };
+
+    if ( World.x != m_CurrentPosition_pt.x || World.y != m_CurrentPosition_pt.y )
+    {
+      MarkDirty(); // The area being left must be re-composited too
+
+      m_CurrentPosition_pt = World;
+
+      MarkDirty();
+
+      HasMoved = true;
+      ++Moved;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  if ( !IsChanged && !m_HasDirtyDescendant )
+  {
+    return; // Nothing changed in this subtree
+  }
+  else
+  {;}
+
+  m_SubtreeBounds_Rect = GetBounds();
+
+  for ( auto Child_Ptr : m_Children_Vec )
+  {
+    if ( HasMoved || Child_Ptr->HasPendingTransforms() )
+    {
+      Child_Ptr->Update_Pvt( m_CurrentPosition_pt, HasMoved, Moved );
+    }
+    else
+    {;}
+
+    SDL_UnionRect( &m_SubtreeBounds_Rect, &Child_Ptr->m_SubtreeBounds_Rect, &m_SubtreeBounds_Rect );
+  }
+
+  m_IsTransformDirty   = false;
+  m_HasDirtyDescendant = false;
+}
@@ -5,7 +5,14 @@
 #include <vector>
 
 /**
- * @brief This class represents a generic abstract graphic element to be drawn by the renderer. 
+ * @brief This class represents a generic abstract graphic element to be drawn by the renderer.
+ *
+ * Elements form a tree: the position of an element is relative to its parent, so that moving a
+ * group, e.g. the keypad, moves all of its elements. The position in the window and the bounds of
+ * the whole subtree are cached, and recomputed by "updateTransforms", called on the root, only along
+ * the subtrees changed since the last call: an element that moves flags itself and its ancestors,
+ * and the walk skips every branch not flagged. Until then, GetBounds returns where the element was
+ * last composited. Link the elements once they are in place: the tree keeps their addresses.
  **/
 class AbstractGraphicElement
 {
@@ -14,18 +21,49 @@ public:
   AbstractGraphicElement( void );
   AbstractGraphicElement( const SDL_Point&, int, int );
 
-  void setPosition( const SDL_Point& );
-  void setSize    ( int const, int const );
-  int  GetWidth   ( void ) const;
-  int  GetHeight  ( void ) const;
+  void                    addChild            ( AbstractGraphicElement& );
+  void                    removeChild         ( AbstractGraphicElement& );
+  int                     updateTransforms    ( void );
+  void                    renderSubtree       ( const SDL_Rect& );
+
+  void                    setPosition         ( const SDL_Point& );
+  void                    setSize             ( int const, int const );
+  SDL_Point               GetPosition         ( void ) const;
+  int                     GetWidth            ( void ) const;
+  int                     GetHeight           ( void ) const;
+  SDL_Rect                GetBounds           ( void ) const;
+  SDL_Rect                GetSubtreeBounds    ( void ) const;
+  AbstractGraphicElement* GetParent           ( void ) const;
+  bool                    HasPendingTransforms( void ) const;
+  bool                    IsDirty             ( void ) const;
+  SDL_Rect                GetDirtyArea        ( void ) const;
+  void                    ClearDirty          ( void );
 
   virtual void render ( void ) = 0;
 
 protected:
-  
+
+  void MarkDirty( void );
+  void MarkDirty( const SDL_Rect& );
+
   int       m_Width_px;
   int       m_Height_px;
-  SDL_Point m_CurrentPosition_pt; // Top left position
+  SDL_Point m_CurrentPosition_pt; // Top left position in the window, as of the last updateTransforms
+
+private:
+
+  void FlagAncestors_Pvt ( void );
+  void Update_Pvt        ( const SDL_Point&, bool, int& );
+
+  bool     m_IsDirty;        // Whether the element has to be re-composited
+  SDL_Rect m_DirtyArea_Rect; // Area covered by the element since it was last composited
+
+  SDL_Point                            m_LocalPosition_pt;    // Top left position, relative to the parent
+  AbstractGraphicElement*              m_Parent_Ptr;
+  std::vector<AbstractGraphicElement*> m_Children_Vec;        // In drawing order
+  SDL_Rect                             m_SubtreeBounds_Rect;  // Of the element and all its descendants
+  bool                                 m_IsTransformDirty;    // Own position or size changed
+  bool                                 m_HasDirtyDescendant;  // Some element below has to be updated
 };
 
-#endif // ABSTRACTGRAPHICELEMENT_HPP
\ No newline at end of file
+#endif // ABSTRACTGRAPHICELEMENT_HPP
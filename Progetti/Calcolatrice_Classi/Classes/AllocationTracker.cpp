@@ -0,0 +1,314 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "AllocationTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const char* TagNames[] = { "Other", "Input", "Render", "Textures", "Logging" };
+
+static_assert( sizeof(TagNames) / sizeof(TagNames[0]) == static_cast<size_t>( AllocationTracker::Tag::HOW_MANY ),
+               "A name is needed for each tag" );
+
+static constexpr size_t NUM_OF_TAGS = static_cast<size_t>( AllocationTracker::Tag::HOW_MANY );
+
+// Bytes kept in front of each block, for its size. Keeps the block aligned as "new" must
+static constexpr size_t HEADER_SIZE_B = alignof(std::max_align_t);
+
+static constexpr double BYTES_IN_A_MiB = 1024.0 * 1024.0;
+
+
+/***************************************************************************************************
+* Private variables
+****************************************************************************************************/
+
+// Running totals since the start of the program, from every thread. Constant-initialised, so they
+// are usable by allocations made before "main"
+static std::atomic<Uint64> AllocationCount[NUM_OF_TAGS];
+static std::atomic<Uint64> AllocationBytes[NUM_OF_TAGS];
+static std::atomic<size_t> HeapInUse_B( 0 );
+static std::atomic<size_t> PeakHeapInUse_B( 0 );
+static std::atomic<size_t> TextureMemory_B( 0 );
+static std::atomic<size_t> PeakTextureMemory_B( 0 );
+
+static thread_local AllocationTracker::Tag CurrentTag = AllocationTracker::Tag::OTHER;
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static void RaisePeak( std::atomic<size_t>& Peak, size_t Value )
+{
+  size_t Current = Peak.load( std::memory_order_relaxed );
+
+  while ( Value > Current && !Peak.compare_exchange_weak( Current, Value, std::memory_order_relaxed ) )
+  {;}
+}
+
+
+#if defined(TRACK_ALLOCATIONS)
+struct BlockHeader
+{
+  size_t Size_B;
+};
+
+static_assert( sizeof(BlockHeader) <= HEADER_SIZE_B, "The header must fit in front of the block" );
+
+
+/*
+ * Replacements of the global allocation functions. The array, nothrow and sized forms of the
+ * standard library end up here as well; the aligned ones are left alone.
+ */
+void* operator new( size_t Size_B )
+{
+  void* Memory_Ptr = std::malloc( HEADER_SIZE_B + Size_B );
+
+  if ( Memory_Ptr == nullptr )
+  {
+    throw std::bad_alloc();
+  }
+  else
+  {;}
+
+  const size_t Tag = static_cast<size_t>( CurrentTag );
+
+  static_cast<BlockHeader*>( Memory_Ptr )->Size_B = Size_B;
+
+  AllocationCount[Tag].fetch_add( 1, std::memory_order_relaxed );
+  AllocationBytes[Tag].fetch_add( Size_B, std::memory_order_relaxed );
+  RaisePeak( PeakHeapInUse_B, HeapInUse_B.fetch_add( Size_B, std::memory_order_relaxed ) + Size_B );
+
+  return static_cast<char*>( Memory_Ptr ) + HEADER_SIZE_B;
+}
+
+
+void operator delete( void* Memory_Ptr ) noexcept
+{
+  if ( Memory_Ptr == nullptr )
+  {
+    return;
+  }
+  else
+  {;}
+
+  BlockHeader* Header = reinterpret_cast<BlockHeader*>( static_cast<char*>( Memory_Ptr ) - HEADER_SIZE_B );
+
+  HeapInUse_B.fetch_sub( Header->Size_B, std::memory_order_relaxed );
+  std::free( Header );
+}
+
+
+void operator delete( void* Memory_Ptr, size_t ) noexcept
+{
+  operator delete( Memory_Ptr );
+}
+#endif
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+AllocationTracker::ScopedTag::ScopedTag( Tag Charged_Tag )
+  : m_Previous(CurrentTag)
+{
+  CurrentTag = Charged_Tag;
+}
+
+
+AllocationTracker::ScopedTag::~ScopedTag( void )
+{
+  CurrentTag = m_Previous;
+}
+
+
+AllocationTracker::AllocationTracker( void )
+  : m_NumOfFrames(0), m_FramesWithAllocations(0), m_MaxFrameCount(0), m_MaxFrameBytes(0),
+    m_IsFrameOpen(false)
+{;}
+
+
+/**
+ * @brief Whether the heap is being counted, i.e. the program was built with TRACK_ALLOCATIONS.
+ **/
+bool AllocationTracker::IsEnabled( void )
+{
+#if defined(TRACK_ALLOCATIONS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+/**
+ * @brief Call at the top of the main loop.
+ **/
+void AllocationTracker::BeginFrame( void )
+{
+  m_AtFrameStart = Snapshot_Pvt();
+  m_IsFrameOpen  = true;
+}
+
+
+/**
+ * @brief Call at the bottom of the main loop. The frame's allocations become part of the figures.
+ **/
+void AllocationTracker::EndFrame( void )
+{
+  if ( !m_IsFrameOpen )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const TagTotals Now = Snapshot_Pvt();
+  Totals          Frame;
+
+  for ( size_t i = 0; i != s_NUM_OF_TAGS; ++i )
+  {
+    m_LastFrame[i].Count = Now[i].Count - m_AtFrameStart[i].Count;
+    m_LastFrame[i].Bytes = Now[i].Bytes - m_AtFrameStart[i].Bytes;
+
+    m_InFrames[i].Count += m_LastFrame[i].Count;
+    m_InFrames[i].Bytes += m_LastFrame[i].Bytes;
+
+    Frame.Count += m_LastFrame[i].Count;
+    Frame.Bytes += m_LastFrame[i].Bytes;
+  }
+
+  ++m_NumOfFrames;
+  m_FramesWithAllocations += ( Frame.Count != 0 ) ? 1 : 0;
+  m_MaxFrameCount          = std::max( m_MaxFrameCount, Frame.Count );
+  m_MaxFrameBytes          = std::max( m_MaxFrameBytes, Frame.Bytes );
+  m_IsFrameOpen            = false;
+}
+
+
+/**
+ * @brief Call when a texture is created, with its estimated video memory footprint.
+ **/
+void AllocationTracker::AddTextureMemory( size_t Size_B )
+{
+  RaisePeak( PeakTextureMemory_B, TextureMemory_B.fetch_add( Size_B, std::memory_order_relaxed ) + Size_B );
+}
+
+
+/**
+ * @brief Call when a texture is destroyed, with the size it was added with.
+ **/
+void AllocationTracker::RemoveTextureMemory( size_t Size_B )
+{
+  TextureMemory_B.fetch_sub( Size_B, std::memory_order_relaxed );
+}
+
+
+size_t AllocationTracker::GetTextureMemory( void )
+{
+  return TextureMemory_B.load( std::memory_order_relaxed );
+}
+
+
+size_t AllocationTracker::GetPeakTextureMemory( void )
+{
+  return PeakTextureMemory_B.load( std::memory_order_relaxed );
+}
+
+
+/**
+ * @return Allocations of the last whole frame, every tag and thread together.
+ **/
+Uint64 AllocationTracker::GetLastFrameAllocations( void ) const
+{
+  Uint64 Count = 0;
+
+  for ( const Totals& Each : m_LastFrame )
+  {
+    Count += Each.Count;
+  }
+
+  return Count;
+}
+
+
+/**
+ * @brief Writes a one-line counter for the screen, e.g. for the window title.
+ *
+ * @param Buffer Destination.
+ * @param Size Size of the destination, terminator included.
+ **/
+void AllocationTracker::FormatCounter( char* Buffer, size_t Size ) const
+{
+  const double Texture_MiB = static_cast<double>( GetTextureMemory() ) / BYTES_IN_A_MiB;
+
+  if ( IsEnabled() )
+  {
+    snprintf( Buffer, Size, "%llu allocs/frame | tex %.1f MiB",
+              static_cast<unsigned long long>( GetLastFrameAllocations() ), Texture_MiB );
+  }
+  else
+  {
+    snprintf( Buffer, Size, "tex %.1f MiB", Texture_MiB );
+  }
+}
+
+
+/**
+ * @brief Prints the allocations made during the frames, by tag, and the peaks of heap and texture
+ * memory. Called by the integrity check at shutdown.
+ **/
+void AllocationTracker::PrintSummary( void ) const
+{
+  if ( IsEnabled() )
+  {
+    const TagTotals Total = Snapshot_Pvt();
+
+    printf( "\nHeap allocations:" );
+    printf( "\n\t%llu frames, %llu of which allocated; at most %llu allocations and %llu bytes in a frame.",
+            static_cast<unsigned long long>( m_NumOfFrames ), static_cast<unsigned long long>( m_FramesWithAllocations ),
+            static_cast<unsigned long long>( m_MaxFrameCount ), static_cast<unsigned long long>( m_MaxFrameBytes ) );
+
+    for ( size_t i = 0; i != s_NUM_OF_TAGS; ++i )
+    {
+      printf( "\n\t%-8s: %8llu allocations, %10llu bytes in frames; %8llu allocations, %10llu bytes in all.", TagNames[i],
+              static_cast<unsigned long long>( m_InFrames[i].Count ), static_cast<unsigned long long>( m_InFrames[i].Bytes ),
+              static_cast<unsigned long long>( Total[i].Count ), static_cast<unsigned long long>( Total[i].Bytes ) );
+    }
+
+    printf( "\n\tHeap in use: %zu bytes, at most %zu.",
+            HeapInUse_B.load( std::memory_order_relaxed ), PeakHeapInUse_B.load( std::memory_order_relaxed ) );
+  }
+  else
+  {
+    printf( "\nHeap allocations are not tracked: build with -DTRACK_ALLOCATIONS to count them." );
+  }
+
+  printf( "\nTexture memory: at most %.2f MiB, %.2f MiB still in use.\n",
+          static_cast<double>( GetPeakTextureMemory() ) / BYTES_IN_A_MiB, static_cast<double>( GetTextureMemory() ) / BYTES_IN_A_MiB );
+}
+
+
+AllocationTracker::TagTotals AllocationTracker::Snapshot_Pvt( void )
+{
+  TagTotals Now;
+
+  for ( size_t i = 0; i != s_NUM_OF_TAGS; ++i )
+  {
+    Now[i].Count = AllocationCount[i].load( std::memory_order_relaxed );
+    Now[i].Bytes = AllocationBytes[i].load( std::memory_order_relaxed );
+  }
+
+  return Now;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file AllocationTracker.hpp
+ *
+ * @brief Heap and texture memory accounting, per frame and per subsystem. Owned by the Supervisor.
+ **/
+
+#ifndef ALLOCATIONTRACKER_HPP
+#define ALLOCATIONTRACKER_HPP
+
+#include <SDL.h>
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Counts the heap allocations of the whole program and the bytes they request, split by the
+ * subsystem that made them, and keeps the texture memory in use and its peak.
+ *
+ * The counting is done by a replacement of the global "operator new", compiled in only when
+ * TRACK_ALLOCATIONS is defined; without it the heap numbers stay at zero, and only the texture
+ * memory is tracked. Each thread charges its allocations to the tag of the innermost "ScopedTag"
+ * alive on it, OTHER if there is none.
+ *
+ * "BeginFrame" and "EndFrame" bracket the frames of the main loop: the allocations in between, by
+ * any thread, make up the frame's figures. Once the program has warmed up, a frame that allocates
+ * is a regression in the hot path.
+ **/
+class AllocationTracker
+{
+public:
+
+  enum class Tag
+  {
+    OTHER = 0,
+    INPUT,
+    RENDER,
+    TEXTURES,
+    LOGGING,
+
+    HOW_MANY
+  };
+
+  /**
+   * @brief Charges the allocations of the calling thread to a tag, for the enclosing scope.
+   **/
+  class ScopedTag
+  {
+  public:
+
+     ScopedTag( Tag );
+    ~ScopedTag( void );
+
+    ScopedTag( const ScopedTag& ) = delete;
+    ScopedTag& operator=( const ScopedTag& ) = delete;
+
+  private:
+
+    Tag m_Previous;
+  };
+
+  AllocationTracker( void );
+
+  static bool IsEnabled( void );
+
+  void   BeginFrame   ( void );
+  void   EndFrame     ( void );
+
+  static void AddTextureMemory   ( size_t );
+  static void RemoveTextureMemory( size_t );
+  static size_t GetTextureMemory    ( void );
+  static size_t GetPeakTextureMemory( void );
+
+  Uint64 GetLastFrameAllocations( void ) const;
+  void   FormatCounter          ( char*, size_t ) const;
+  void   PrintSummary           ( void ) const;
+
+private:
+
+  static constexpr size_t s_NUM_OF_TAGS = static_cast<size_t>( Tag::HOW_MANY );
+
+  struct Totals
+  {
+    Uint64 Count = 0; // Allocations
+    Uint64 Bytes = 0; // Bytes requested by them
+  };
+
+  using TagTotals = std::array<Totals, s_NUM_OF_TAGS>;
+
+  static TagTotals Snapshot_Pvt( void );
+
+  TagTotals m_AtFrameStart;  // Running totals when the current frame began
+  TagTotals m_LastFrame;     // Allocations of the last whole frame
+  TagTotals m_InFrames;      // Sum of every frame, i.e. without the start-up and shutdown
+  Uint64    m_NumOfFrames;
+  Uint64    m_FramesWithAllocations;
+  Uint64    m_MaxFrameCount; // Most allocations in a single frame
+  Uint64    m_MaxFrameBytes;
+  bool      m_IsFrameOpen;
+};
+
+#endif // ALLOCATIONTRACKER_HPP
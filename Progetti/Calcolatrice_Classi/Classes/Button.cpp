@@ -5,7 +5,7 @@
 Button::Button(void)
 {
   m_CurrentSprite = ButtonSprite::BUTTON_SPRITE_NORMAL;
-  m_Clips_RectVec.resize(ButtonSprite::BUTTON_SPRITE_HOWMANY);
+  m_Clips_RectVec.fill(SDL_Rect{0, 0, 0, 0});
 }
 
 
@@ -18,6 +18,13 @@ Button::Button(void)
 void Button::setClip(const SDL_Rect& Clip, ButtonSprite Button_Sprite)
 {
   m_Clips_RectVec[Button_Sprite] = Clip;
+
+  if ( Button_Sprite == m_CurrentSprite )
+  {
+    MarkDirty();
+  }
+  else
+  {;}
 }
 
 
@@ -31,9 +38,11 @@ void Button::handleMouseEvent( SDL_Event* Event )
   // If mouse event happened
   if( /* Event->type == SDL_MOUSEMOTION || */ Event->type == SDL_MOUSEBUTTONDOWN || Event->type == SDL_MOUSEBUTTONUP )
   {
-    // Get mouse position
-    int x, y;
-    SDL_GetMouseState( &x, &y );
+    // Mouse position at the time of the event
+    int x = Event->button.x;
+    int y = Event->button.y;
+
+    const ButtonSprite PreviousSprite = m_CurrentSprite;
 
     // Check if mouse is inside button
     bool inside = true;
@@ -91,6 +100,13 @@ void Button::handleMouseEvent( SDL_Event* Event )
           break;
       }
     }
+
+    if ( m_CurrentSprite != PreviousSprite )
+    {
+      MarkDirty();
+    }
+    else
+    {;}
   }
   else
   {;} // No mouse event happened
@@ -98,9 +114,30 @@ void Button::handleMouseEvent( SDL_Event* Event )
 
 
 /**
- * @brief Renders current button sprite.
+ * @brief Shows the button pressed or released without the mouse, e.g. while its key is held down on
+ * the keyboard.
+ **/
+void Button::setPressed(bool IsPressed)
+{
+  const ButtonSprite Sprite = IsPressed ? BUTTON_SPRITE_PRESSED : BUTTON_SPRITE_NORMAL;
+
+  if ( Sprite != m_CurrentSprite )
+  {
+    m_CurrentSprite = Sprite;
+    MarkDirty();
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Queues current button sprite into the renderer's sprite batch.
  **/
 void Button::render(void)
 {
-  Renderer::Get().GetSpriteSheet().render( m_CurrentPosition_pt.x, m_CurrentPosition_pt.y, &m_Clips_RectVec[m_CurrentSprite] );
+  const SDL_Rect& Clip = m_Clips_RectVec[m_CurrentSprite];
+
+  Renderer::Get().GetSpriteBatch().add( Renderer::Get().GetSpriteSheet(), Clip,
+                                        SDL_Rect{ m_CurrentPosition_pt.x, m_CurrentPosition_pt.y, Clip.w, Clip.h } );
 }
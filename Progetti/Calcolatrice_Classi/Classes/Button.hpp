@@ -2,6 +2,7 @@
 #define BUTTON_HPP
 
 #include <SDL.h>
+#include <array>
 #include "AbstractGraphicElement.hpp"
 #include "I_Clickable.hpp"
 
@@ -29,11 +30,12 @@ public:
   virtual void render           ( void )       override;
 
           void setClip          ( const SDL_Rect&, ButtonSprite );
+          void setPressed       ( bool );
 
 private:
 
-  ButtonSprite          m_CurrentSprite; // Currently used sprite
-  std::vector<SDL_Rect> m_Clips_RectVec; // All the usable clips for this element
+  ButtonSprite                                m_CurrentSprite; // Currently used sprite
+  std::array<SDL_Rect, BUTTON_SPRITE_HOWMANY> m_Clips_RectVec; // All the usable clips for this element; no heap storage
 };
 
 #endif // BUTTON_HPP
\ No newline at end of file
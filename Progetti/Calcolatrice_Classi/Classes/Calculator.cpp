@@ -0,0 +1,367 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "Calculator.hpp"
+#include "Supervisor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// Text of each key, in the order of Expression::Key
+static const char* const KeyTexts[] =
+{
+  "0", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+  "MRC", "M-", "M+", "+", "-", "/", "*", ".", "=", "+/-", "^", "DEL", "%",
+  "x", "R", "(", ")"
+};
+
+static_assert( sizeof(KeyTexts) / sizeof(KeyTexts[0]) == static_cast<size_t>( Expression::Key::HOW_MANY ),
+               "A text for each key" );
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+Calculator::Calculator( void )
+  : m_Keys(), m_Recalled(), m_NumOfKeys(0), m_NumOfRecalled(0), m_Answer(), m_Memory(),
+    m_HasAnswer(false), m_WasMrcPressed(false), m_Memo(), m_Expression(), m_DisplayText()
+{
+  m_Expression.SetMemo( &m_Memo );
+  Show_Pvt( "0" );
+}
+
+
+/**
+ * @brief Handles one key of the keypad.
+ **/
+void Calculator::press( Expression::Key Pressed )
+{
+  using Key = Expression::Key;
+
+  const bool HadAnswer     = m_HasAnswer;
+  const bool WasMrcPressed = m_WasMrcPressed;
+
+  m_HasAnswer     = false;
+  m_WasMrcPressed = false;
+
+  switch ( Pressed )
+  {
+    case Key::KEY_EQUALS:
+    {
+      Decimal Result;
+
+      if ( Evaluate_Pvt( Result ) )
+      {
+        m_Answer    = Result;
+        m_HasAnswer = true;
+        Clear_Pvt();
+        Show_Pvt( Result );
+      }
+      else
+      {
+        Show_Pvt( "Error" );
+      }
+      break;
+    }
+
+    case Key::KEY_DEL:
+      if ( m_NumOfKeys != 0 )
+      {
+        --m_NumOfKeys;
+        m_NumOfRecalled -= ( m_Keys[m_NumOfKeys] == Key::KEY_RECALL ) ? 1 : 0;
+      }
+      else
+      {;}
+
+      ShowTyped_Pvt();
+      break;
+
+    case Key::KEY_MRC:
+      if ( WasMrcPressed )
+      {
+        m_Memory = Decimal();
+        Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "\nM = 0" );
+        Show_Pvt( "0" );
+      }
+      else
+      {
+        m_WasMrcPressed = true;
+        Append_Pvt( Key::KEY_RECALL, m_Memory );
+        Show_Pvt( m_Memory );
+      }
+      break;
+
+    case Key::KEY_MEMPLUS:
+    case Key::KEY_MEMMINUS:
+    {
+      Decimal Result;
+
+      if ( HadAnswer && m_NumOfKeys == 0 )
+      {
+        Append_Pvt( Key::KEY_RECALL, m_Answer ); // "= M+" adds the result
+      }
+      else
+      {;}
+
+      if ( Evaluate_Pvt( Result ) )
+      {
+        m_Memory    = ( Pressed == Key::KEY_MEMPLUS ) ? m_Memory + Result : m_Memory - Result;
+        m_Answer    = Result;
+        m_HasAnswer = true;
+        Clear_Pvt();
+
+        char Text[Decimal::s_MAX_SCALE + s_DISPLAY_DIGITS + 8];
+        m_Memory.format( Text, sizeof(Text), s_DISPLAY_DIGITS );
+
+        Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "\nM = %s", Text );
+        Show_Pvt( Result );
+      }
+      else
+      {
+        Show_Pvt( "Error" );
+      }
+      break;
+    }
+
+    default:
+      if ( HadAnswer )
+      {
+        const bool IsDigit = ( Pressed <= Key::KEY_9 || Pressed == Key::KEY_POINT );
+
+        if ( !IsDigit && Pressed != Key::KEY_OPEN )
+        {
+          Append_Pvt( Key::KEY_RECALL, m_Answer ); // "= + 1" goes on from the result
+        }
+        else
+        {;}
+      }
+      else
+      {;}
+
+      Append_Pvt( Pressed );
+      ShowTyped_Pvt();
+      break;
+  }
+}
+
+
+const Decimal& Calculator::GetAnswer( void ) const
+{
+  return m_Answer;
+}
+
+
+const Decimal& Calculator::GetMemory( void ) const
+{
+  return m_Memory;
+}
+
+
+const char* Calculator::GetDisplayText( void ) const
+{
+  return m_DisplayText;
+}
+
+
+/**
+ * @brief Writes the keys as text, e.g. "12+3*R".
+ *
+ * @return The length written, without the terminator.
+ **/
+size_t Calculator::FormatKeys( const Expression::Key* Keys_Ptr, size_t NumOfKeys, char* Text, size_t Size )
+{
+  size_t Length = 0;
+
+  if ( Size == 0 )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  Text[0] = '\0';
+
+  for ( size_t i = 0; i != NumOfKeys && Length + 1 < Size; ++i )
+  {
+    const int Written = snprintf( Text + Length, Size - Length, "%s", KeyTexts[static_cast<size_t>( Keys_Ptr[i] )] );
+
+    Length += ( Written > 0 ) ? std::min( static_cast<size_t>( Written ), Size - Length - 1 ) : 0;
+  }
+
+  return Length;
+}
+
+
+/**
+ * @brief Compiles and evaluates the keys typed so far, printing the result or the error.
+ **/
+bool Calculator::Evaluate_Pvt( Decimal& Result )
+{
+  char Text[Expression::s_MAX_KEYS * 4];
+  FormatKeys( m_Keys.data(), m_NumOfKeys, Text, sizeof(Text) );
+
+  // Keys only: the expression folds to its exact result while compiling
+  if ( !m_Expression.compile( m_Keys.data(), m_NumOfKeys, m_Recalled.data() ) || !m_Expression.evaluateExact( Result ) )
+  {
+    Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::WARNING, "\n%s: %s", Text, m_Expression.GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  char Display[Decimal::s_MAX_SCALE + s_DISPLAY_DIGITS + 8];
+  Result.format( Display, sizeof(Display), s_DISPLAY_DIGITS );
+
+  Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "\n%s = %s", Text, Display );
+
+  return true;
+}
+
+
+/**
+ * @brief Adds a key to the expression. The keypad ignores keys beyond the buffer, as the display
+ * beyond its digits: a second point or a digit past Expression::s_MAX_DIGITS in the same number.
+ **/
+void Calculator::Append_Pvt( Expression::Key Pressed, const Decimal& Recalled )
+{
+  using Key = Expression::Key;
+
+  if ( m_NumOfKeys == Expression::s_MAX_KEYS )
+  {
+    return;
+  }
+  else
+  {;}
+
+  if ( Pressed <= Key::KEY_9 || Pressed == Key::KEY_POINT )
+  {
+    bool   HasPoint = false;
+    size_t Digits   = 0;
+
+    for ( size_t i = m_NumOfKeys; i != 0 && ( m_Keys[i - 1] <= Key::KEY_9 || m_Keys[i - 1] == Key::KEY_POINT ); --i )
+    {
+      HasPoint = HasPoint || ( m_Keys[i - 1] == Key::KEY_POINT );
+      Digits  += ( m_Keys[i - 1] != Key::KEY_POINT ) ? 1 : 0;
+    }
+
+    if ( ( Pressed == Key::KEY_POINT ) ? HasPoint : ( Digits == Expression::s_MAX_DIGITS ) )
+    {
+      return;
+    }
+    else
+    {;}
+  }
+  else
+  {;}
+
+  if ( Pressed == Key::KEY_RECALL )
+  {
+    m_Recalled[m_NumOfRecalled++] = Recalled;
+  }
+  else
+  {;}
+
+  m_Keys[m_NumOfKeys++] = Pressed;
+}
+
+
+void Calculator::Clear_Pvt( void )
+{
+  m_NumOfKeys     = 0;
+  m_NumOfRecalled = 0;
+}
+
+
+/**
+ * @brief Shows a number, with as many significant digits as fit the display.
+ **/
+void Calculator::Show_Pvt( const Decimal& Number )
+{
+  char Text[Decimal::s_MAX_SCALE + s_DISPLAY_DIGITS + 8];
+
+  for ( size_t Digits = s_DISPLAY_DIGITS; ; --Digits )
+  {
+    Number.format( Text, sizeof(Text), Digits );
+
+    // The display has no '+': "1.5e+40" is shown "1.5e40"
+    char* Plus_Ptr = strchr( Text, '+' );
+
+    if ( Plus_Ptr != nullptr )
+    {
+      memmove( Plus_Ptr, Plus_Ptr + 1, strlen( Plus_Ptr ) );
+    }
+    else
+    {;}
+
+    if ( strlen( Text ) <= s_DISPLAY_LENGTH || Digits == 1 )
+    {
+      break;
+    }
+    else
+    {;}
+  }
+
+  Show_Pvt( Text );
+}
+
+
+void Calculator::Show_Pvt( const char* Text )
+{
+  snprintf( m_DisplayText, sizeof(m_DisplayText), "%s", Text );
+}
+
+
+/**
+ * @brief Shows the number being typed, i.e. the digits at the end of the keys, or the value just
+ * recalled. After an operator the display keeps what it was showing.
+ **/
+void Calculator::ShowTyped_Pvt( void )
+{
+  using Key = Expression::Key;
+
+  size_t First = m_NumOfKeys;
+
+  while ( First != 0 && ( m_Keys[First - 1] <= Key::KEY_9 || m_Keys[First - 1] == Key::KEY_POINT ) )
+  {
+    --First;
+  }
+
+  if ( First != m_NumOfKeys )
+  {
+    char   Text[s_DISPLAY_LENGTH + 1];
+    size_t Length = 0;
+
+    if ( m_Keys[First] == Key::KEY_POINT )
+    {
+      Text[Length++] = '0'; // ".5" is shown "0.5"
+    }
+    else
+    {;}
+
+    for ( size_t i = First; i != m_NumOfKeys && Length != s_DISPLAY_LENGTH; ++i )
+    {
+      Text[Length++] = ( m_Keys[i] == Key::KEY_POINT ) ? '.' : static_cast<char>( '0' + static_cast<int>( m_Keys[i] ) );
+    }
+
+    Text[Length] = '\0';
+    Show_Pvt( Text );
+  }
+  else if ( m_NumOfKeys != 0 && m_Keys[m_NumOfKeys - 1] == Key::KEY_RECALL )
+  {
+    Show_Pvt( m_Recalled[m_NumOfRecalled - 1] );
+  }
+  else if ( m_NumOfKeys == 0 )
+  {
+    Show_Pvt( "0" );
+  }
+  else
+  {;}
+}
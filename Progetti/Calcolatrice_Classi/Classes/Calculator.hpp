@@ -0,0 +1,70 @@
+/**
+ * @file Calculator.hpp
+ *
+ * @brief The keypad logic: keys pressed on the buttons, memory and last result.
+ **/
+
+#ifndef CALCULATOR_HPP
+#define CALCULATOR_HPP
+
+#include <SDL.h>
+#include <array>
+#include <cstddef>
+#include "Expression.hpp"
+#include "Decimal.hpp"
+#include "DecimalMemo.hpp"
+
+/**
+ * @brief Collects the keys pressed into a fixed buffer and evaluates them on EQUALS through an
+ * Expression, printing "keys = result" on the console.
+ *
+ * Results, the last answer and the memory are exact Decimal numbers: "0.1 + 0.2" is 0.3, and a
+ * long chain of M+ adds no rounding error. The display shows s_DISPLAY_DIGITS significant digits;
+ * the folding of repeated sub-expressions is cached in a DecimalMemo.
+ *
+ * After a result, an operator continues from it and a digit starts a new expression. DEL removes
+ * the last key; MRC recalls the memory, and clears it when pressed twice in a row; M+ and M-
+ * evaluate what was typed and add it to the memory or subtract it.
+ *
+ * "GetDisplayText" is what the display shows, at most s_DISPLAY_LENGTH characters: the number being
+ * typed, the last result or recalled value, or "Error".
+ **/
+class Calculator
+{
+public:
+
+  static constexpr size_t s_DISPLAY_DIGITS = 20;  // Fewer than Decimal::s_MAX_SCALE: 1/3*3 shows 1
+  static constexpr size_t s_DISPLAY_LENGTH = 22;  // The digits, sign and point
+
+  Calculator( void );
+
+  void           press     ( Expression::Key );
+  const Decimal& GetAnswer ( void ) const;
+  const Decimal& GetMemory ( void ) const;
+  const char*    GetDisplayText( void ) const;
+
+  static size_t FormatKeys( const Expression::Key*, size_t, char*, size_t );
+
+private:
+
+  bool Evaluate_Pvt  ( Decimal& );
+  void Append_Pvt    ( Expression::Key, const Decimal& = Decimal() );
+  void Clear_Pvt     ( void );
+  void Show_Pvt      ( const Decimal& );
+  void Show_Pvt      ( const char* );
+  void ShowTyped_Pvt ( void );
+
+  std::array<Expression::Key, Expression::s_MAX_KEYS> m_Keys;
+  std::array<Decimal, Expression::s_MAX_KEYS>         m_Recalled;  // Values of the KEY_RECALL keys
+  size_t      m_NumOfKeys;
+  size_t      m_NumOfRecalled;
+  Decimal     m_Answer;          // Last result
+  Decimal     m_Memory;
+  bool        m_HasAnswer;       // The last key was EQUALS
+  bool        m_WasMrcPressed;   // The last key was MRC
+  DecimalMemo m_Memo;
+  Expression  m_Expression;
+  char        m_DisplayText[s_DISPLAY_LENGTH + 1];
+};
+
+#endif // CALCULATOR_HPP
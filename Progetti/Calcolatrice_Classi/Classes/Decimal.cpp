@@ -0,0 +1,937 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "Decimal.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const Uint32 Base         = 1000000000;  // One limb
+static const Uint32 LimbDigits   = 9;
+static const Uint32 MaxExponent  = 4096;        // Larger integer powers go through double
+static const size_t DoubleDigits = 15;          // Significant digits taken from a double
+
+static const Uint32 PowersOfTen[LimbDigits + 1] =
+{
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Every digit of the longest number, the point, the sign and the zeros of a long division
+static const size_t MaxText = Decimal::s_MAX_LIMBS * LimbDigits + 2 * Decimal::s_MAX_SCALE + 8;
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+Decimal::Decimal( void )
+  : m_Inline(), m_Limbs_Ptr(m_Inline), m_Size(0), m_Capacity(s_INLINE_LIMBS), m_Scale(0),
+    m_IsNegative(false), m_IsValid(true)
+{;}
+
+
+Decimal::Decimal( Sint64 Value )
+  : Decimal()
+{
+  m_IsNegative = ( Value < 0 );
+
+  Uint64 Magnitude = m_IsNegative ? ( ~static_cast<Uint64>( Value ) + 1 ) : static_cast<Uint64>( Value );
+
+  while ( Magnitude != 0 )
+  {
+    m_Limbs_Ptr[m_Size++] = static_cast<Uint32>( Magnitude % Base );
+    Magnitude /= Base;
+  }
+}
+
+
+Decimal::Decimal( const Decimal& Other )
+  : Decimal()
+{
+  *this = Other;
+}
+
+
+Decimal::Decimal( Decimal&& Other ) noexcept
+  : Decimal()
+{
+  *this = std::move( Other );
+}
+
+
+Decimal::~Decimal( void )
+{
+  Release_Pvt();
+}
+
+
+Decimal& Decimal::operator=( const Decimal& Other )
+{
+  if ( this != &Other )
+  {
+    Reserve_Pvt( Other.m_Size );
+    std::copy( Other.m_Limbs_Ptr, Other.m_Limbs_Ptr + Other.m_Size, m_Limbs_Ptr );
+
+    m_Size       = Other.m_Size;
+    m_Scale      = Other.m_Scale;
+    m_IsNegative = Other.m_IsNegative;
+    m_IsValid    = Other.m_IsValid;
+  }
+  else
+  {;}
+
+  return *this;
+}
+
+
+Decimal& Decimal::operator=( Decimal&& Other ) noexcept
+{
+  if ( this == &Other )
+  {
+    return *this;
+  }
+  else if ( Other.m_Limbs_Ptr != Other.m_Inline )
+  {
+    // Takes the heap limbs over
+    Release_Pvt();
+
+    m_Limbs_Ptr = Other.m_Limbs_Ptr;
+    m_Capacity  = Other.m_Capacity;
+
+    Other.m_Limbs_Ptr = Other.m_Inline;
+    Other.m_Capacity  = s_INLINE_LIMBS;
+  }
+  else
+  {
+    Reserve_Pvt( Other.m_Size );
+    std::copy( Other.m_Limbs_Ptr, Other.m_Limbs_Ptr + Other.m_Size, m_Limbs_Ptr );
+  }
+
+  m_Size       = Other.m_Size;
+  m_Scale      = Other.m_Scale;
+  m_IsNegative = Other.m_IsNegative;
+  m_IsValid    = Other.m_IsValid;
+
+  Other.m_Size = 0;
+
+  return *this;
+}
+
+
+/**
+ * @brief The number Mantissa / 10^Scale, e.g. (254, 2) for 2.54.
+ **/
+Decimal Decimal::FromDigits( Uint64 Mantissa, Uint32 Scale )
+{
+  Decimal Result;
+
+  Result.Reserve_Pvt( 3 );
+
+  while ( Mantissa != 0 )
+  {
+    Result.m_Limbs_Ptr[Result.m_Size++] = static_cast<Uint32>( Mantissa % Base );
+    Mantissa /= Base;
+  }
+
+  Result.m_Scale = Scale;
+  Result.Round_Pvt( s_MAX_SCALE );
+
+  return Result;
+}
+
+
+/**
+ * @brief The decimal nearest to a double, to its 15 significant digits: 0.1 is 0.1, not
+ * 0.1000000000000000055511151231257827.
+ *
+ * @return Invalid for infinities and NaN.
+ **/
+Decimal Decimal::FromDouble( double Value )
+{
+  if ( !std::isfinite( Value ) )
+  {
+    return Invalid();
+  }
+  else if ( Value == 0.0 )
+  {
+    return Decimal();
+  }
+  else
+  {;}
+
+  // "d.dddddddddddddde+XX"
+  char Text[32];
+  snprintf( Text, sizeof(Text), "%.*e", static_cast<int>( DoubleDigits - 1 ), std::fabs( Value ) );
+
+  Uint64      Mantissa = 0;
+  const char* Char_Ptr = Text;
+
+  for ( ; *Char_Ptr != 'e'; ++Char_Ptr )
+  {
+    Mantissa = ( *Char_Ptr == '.' ) ? Mantissa : Mantissa * 10 + static_cast<Uint64>( *Char_Ptr - '0' );
+  }
+
+  const long Exponent = strtol( Char_Ptr + 1, nullptr, 10 ) - static_cast<long>( DoubleDigits - 1 );
+
+  Decimal Result;
+
+  if ( Exponent >= 0 )
+  {
+    Result = FromDigits( Mantissa, 0 );
+    Result.ShiftLeft_Pvt( static_cast<Uint32>( Exponent ) );
+  }
+  else
+  {
+    Result = FromDigits( Mantissa, static_cast<Uint32>( -Exponent ) );
+  }
+
+  Result.m_IsNegative = ( Value < 0.0 ) && !Result.IsZero();
+
+  return Result;
+}
+
+
+/**
+ * @brief The result of a division by zero or of an overflow.
+ **/
+Decimal Decimal::Invalid( void )
+{
+  Decimal Result;
+  Result.m_IsValid = false;
+
+  return Result;
+}
+
+
+Decimal Decimal::operator-( void ) const
+{
+  Decimal Result( *this );
+  Result.m_IsNegative = !m_IsNegative && !IsZero();
+
+  return Result;
+}
+
+
+Decimal operator+( const Decimal& Left, const Decimal& Right )
+{
+  if ( !Left.m_IsValid || !Right.m_IsValid )
+  {
+    return Decimal::Invalid();
+  }
+  else
+  {;}
+
+  const Uint32  Scale        = std::max( Left.m_Scale, Right.m_Scale );
+  const Decimal AlignedLeft  = Decimal::Align( Left,  Scale );
+  const Decimal AlignedRight = Decimal::Align( Right, Scale );
+
+  Decimal Result;
+
+  if ( Left.m_IsNegative == Right.m_IsNegative )
+  {
+    Result = Decimal::AddMagnitudes( AlignedLeft, AlignedRight, false );
+    Result.m_IsNegative = Left.m_IsNegative;
+  }
+  else if ( Decimal::CompareMagnitudes( AlignedLeft, AlignedRight ) >= 0 )
+  {
+    Result = Decimal::AddMagnitudes( AlignedLeft, AlignedRight, true );
+    Result.m_IsNegative = Left.m_IsNegative;
+  }
+  else
+  {
+    Result = Decimal::AddMagnitudes( AlignedRight, AlignedLeft, true );
+    Result.m_IsNegative = Right.m_IsNegative;
+  }
+
+  Result.Normalise_Pvt();
+
+  return Result;
+}
+
+
+Decimal operator-( const Decimal& Left, const Decimal& Right )
+{
+  return Left + ( -Right );
+}
+
+
+Decimal operator*( const Decimal& Left, const Decimal& Right )
+{
+  if ( !Left.m_IsValid || !Right.m_IsValid )
+  {
+    return Decimal::Invalid();
+  }
+  else if ( Left.m_Size + Right.m_Size > Decimal::s_MAX_LIMBS + 1 )
+  {
+    return Decimal::Invalid();
+  }
+  else
+  {;}
+
+  Decimal Result;
+
+  Result.Reserve_Pvt( Left.m_Size + Right.m_Size );
+  std::fill( Result.m_Limbs_Ptr, Result.m_Limbs_Ptr + Left.m_Size + Right.m_Size, 0u );
+
+  for ( Uint32 i = 0; i != Left.m_Size; ++i )
+  {
+    Uint64 Carry = 0;
+
+    for ( Uint32 j = 0; j != Right.m_Size; ++j )
+    {
+      const Uint64 Current = Result.m_Limbs_Ptr[i + j] + static_cast<Uint64>( Left.m_Limbs_Ptr[i] ) * Right.m_Limbs_Ptr[j] + Carry;
+
+      Result.m_Limbs_Ptr[i + j] = static_cast<Uint32>( Current % Base );
+      Carry                     = Current / Base;
+    }
+
+    Result.m_Limbs_Ptr[i + Right.m_Size] = static_cast<Uint32>( Carry );
+  }
+
+  Result.m_Size       = Left.m_Size + Right.m_Size;
+  Result.m_Scale      = Left.m_Scale + Right.m_Scale;
+  Result.m_IsNegative = ( Left.m_IsNegative != Right.m_IsNegative );
+  Result.Trim_Pvt();
+  Result.Round_Pvt( Decimal::s_MAX_SCALE );
+
+  if ( Result.m_Size > Decimal::s_MAX_LIMBS )
+  {
+    Result.Overflow_Pvt();
+  }
+  else
+  {;}
+
+  return Result;
+}
+
+
+Decimal operator/( const Decimal& Left, const Decimal& Right )
+{
+  if ( !Left.m_IsValid || !Right.m_IsValid || Right.IsZero() )
+  {
+    return Decimal::Invalid();
+  }
+  else
+  {;}
+
+  // Quotient of the integers with one decimal more than kept, for the rounding
+  const Uint32 Scale = Decimal::s_MAX_SCALE + 1;
+  const Uint32 Shift = Scale + Right.m_Scale - Left.m_Scale;  // Scales are at most s_MAX_SCALE
+
+  Decimal Quotient;
+
+  if ( Right.m_Size == 1 )
+  {
+    Quotient = Left;
+    Quotient.ShiftLeft_Pvt( Shift );
+    Quotient.DivideSmall_Pvt( Right.m_Limbs_Ptr[0] );
+  }
+  else
+  {
+    // Long division, a decimal digit at a time: the quotient has few digits, each found by at
+    // most nine subtractions
+    char Digits[MaxText];
+    size_t Length = Left.FormatDigits_Pvt( Digits, sizeof(Digits) );
+
+    Decimal Divisor( Right );
+    Divisor.m_Scale      = 0;
+    Divisor.m_IsNegative = false;
+
+    Decimal Remainder;
+
+    for ( size_t i = 0; i != Length + Shift; ++i )
+    {
+      const Uint32 Digit = ( i < Length ) ? static_cast<Uint32>( Digits[i] - '0' ) : 0;
+      Uint32       Times = 0;
+
+      Remainder.MultiplySmall_Pvt( 10, Digit );
+
+      while ( Decimal::CompareMagnitudes( Remainder, Divisor ) >= 0 )
+      {
+        Remainder = Decimal::AddMagnitudes( Remainder, Divisor, true );
+        ++Times;
+      }
+
+      Quotient.MultiplySmall_Pvt( 10, Times );
+    }
+  }
+
+  if ( !Quotient.m_IsValid )
+  {
+    return Quotient;
+  }
+  else
+  {;}
+
+  Quotient.m_Scale      = Scale;
+  Quotient.m_IsNegative = ( Left.m_IsNegative != Right.m_IsNegative );
+  Quotient.Round_Pvt( Decimal::s_MAX_SCALE );
+
+  return Quotient;
+}
+
+
+/**
+ * @brief Equal values; invalid ones are equal to nothing, as NaN.
+ **/
+bool Decimal::operator==( const Decimal& Other ) const
+{
+  return m_IsValid && Other.m_IsValid && m_Size == Other.m_Size && m_Scale == Other.m_Scale &&
+         m_IsNegative == Other.m_IsNegative && std::equal( m_Limbs_Ptr, m_Limbs_Ptr + m_Size, Other.m_Limbs_Ptr );
+}
+
+
+bool Decimal::operator!=( const Decimal& Other ) const
+{
+  return !( *this == Other );
+}
+
+
+/**
+ * @brief The number divided by 100, as the '%' key.
+ **/
+Decimal Decimal::percent( void ) const
+{
+  Decimal Result( *this );
+
+  Result.m_Scale += 2;
+  Result.Round_Pvt( s_MAX_SCALE );
+
+  return Result;
+}
+
+
+/**
+ * @brief The number raised to an exponent: by repeated squaring if the exponent is an integer up to
+ * 4096, through double otherwise.
+ **/
+Decimal Decimal::power( const Decimal& Exponent ) const
+{
+  if ( !m_IsValid || !Exponent.m_IsValid )
+  {
+    return Invalid();
+  }
+  else if ( !Exponent.IsInteger() || Exponent.m_Size > 1 || ( Exponent.m_Size == 1 && Exponent.m_Limbs_Ptr[0] > MaxExponent ) )
+  {
+    return FromDouble( std::pow( toDouble(), Exponent.toDouble() ) );
+  }
+  else
+  {;}
+
+  Uint32  Remaining = ( Exponent.m_Size == 1 ) ? Exponent.m_Limbs_Ptr[0] : 0;
+  Decimal Result( 1 );
+  Decimal Factor( *this );
+
+  while ( Remaining != 0 && Result.m_IsValid )
+  {
+    if ( ( Remaining & 1u ) != 0 )
+    {
+      Result = Result * Factor;
+    }
+    else
+    {;}
+
+    Remaining >>= 1;
+
+    if ( Remaining != 0 )
+    {
+      Factor = Factor * Factor;
+    }
+    else
+    {;}
+  }
+
+  return Exponent.m_IsNegative ? Decimal( 1 ) / Result : Result;
+}
+
+
+/**
+ * @brief The nearest double.
+ **/
+double Decimal::toDouble( void ) const
+{
+  if ( !m_IsValid )
+  {
+    return NAN;
+  }
+  else
+  {;}
+
+  char Text[MaxText];
+  format( Text, sizeof(Text) );
+
+  return strtod( Text, nullptr );
+}
+
+
+/**
+ * @brief Writes the number, e.g. "-1234.5". With MaxDigits, the number is rounded to that many
+ * significant digits, and numbers whose integer part is longer are written as "1.2345e+40".
+ * Invalid numbers are written "Error".
+ *
+ * @param Text Where the text goes, truncated to Size.
+ * @param MaxDigits 0 for every digit.
+ * @return The length of the text, without the terminator.
+ **/
+size_t Decimal::format( char* Text, size_t Size, size_t MaxDigits ) const
+{
+  if ( !m_IsValid )
+  {
+    return static_cast<size_t>( std::max( snprintf( Text, Size, "Error" ), 0 ) );
+  }
+  else
+  {;}
+
+  char   Digits[MaxText];
+  size_t Length    = FormatDigits_Pvt( Digits, sizeof(Digits) );
+  size_t IntDigits = ( Length > m_Scale ) ? Length - m_Scale : 0;
+
+  if ( MaxDigits != 0 && IntDigits > MaxDigits )
+  {
+    // Mantissa of MaxDigits digits: the integer digits beyond them are dropped as decimals
+    const Uint32 Dropped = static_cast<Uint32>( IntDigits - MaxDigits );
+
+    Decimal Mantissa( *this );
+    Mantissa.m_Scale += Dropped;
+    Mantissa.Round_Pvt( 0 );
+
+    const size_t MantissaLength = Mantissa.FormatDigits_Pvt( Digits, sizeof(Digits) );
+    size_t       Last           = MantissaLength;
+
+    while ( Last > 1 && Digits[Last - 1] == '0' )
+    {
+      --Last;
+    }
+
+    Digits[Last] = '\0';
+
+    const int Written = snprintf( Text, Size, "%s%c%s%se+%u", m_IsNegative ? "-" : "", Digits[0],
+                                  ( Last > 1 ) ? "." : "", Digits + 1, static_cast<unsigned>( Dropped + MantissaLength - 1 ) );
+
+    return std::min( static_cast<size_t>( std::max( Written, 0 ) ), Size - 1 );
+  }
+  else if ( MaxDigits != 0 && Length > MaxDigits )
+  {
+    // Fewer decimals: after the leading zeros of a number below 1, MaxDigits significant ones
+    const size_t Decimals = ( IntDigits != 0 ) ? MaxDigits - IntDigits : m_Scale - Length + MaxDigits;
+
+    Decimal Rounded( *this );
+    Rounded.Round_Pvt( static_cast<Uint32>( std::min( Decimals, static_cast<size_t>( s_MAX_SCALE ) ) ) );
+
+    return Rounded.format( Text, Size );
+  }
+  else
+  {;}
+
+  // Integer part, point, then the decimals with their leading zeros
+  char   Full[MaxText + s_MAX_SCALE];
+  size_t Position = 0;
+
+  if ( m_IsNegative )
+  {
+    Full[Position++] = '-';
+  }
+  else
+  {;}
+
+  if ( IntDigits == 0 )
+  {
+    Full[Position++] = '0';
+  }
+  else
+  {
+    memcpy( Full + Position, Digits, IntDigits );
+    Position += IntDigits;
+  }
+
+  if ( m_Scale != 0 )
+  {
+    Full[Position++] = '.';
+
+    for ( size_t i = Length; i < m_Scale; ++i )
+    {
+      Full[Position++] = '0';
+    }
+
+    memcpy( Full + Position, Digits + IntDigits, Length - IntDigits );
+    Position += Length - IntDigits;
+  }
+  else
+  {;}
+
+  Full[Position] = '\0';
+
+  return static_cast<size_t>( std::max( snprintf( Text, Size, "%s", Full ), 0 ) );
+}
+
+
+bool Decimal::IsValid( void ) const
+{
+  return m_IsValid;
+}
+
+
+bool Decimal::IsZero( void ) const
+{
+  return m_IsValid && m_Size == 0;
+}
+
+
+bool Decimal::IsInteger( void ) const
+{
+  return m_IsValid && m_Scale == 0;
+}
+
+
+/**
+ * @brief Hash of the value, the same for equal numbers (FNV-1a).
+ **/
+Uint32 Decimal::GetHash( void ) const
+{
+  Uint32 Hash = 2166136261u;
+
+  auto Mix = [&Hash] ( Uint32 Value )
+  {
+    Hash = ( Hash ^ Value ) * 16777619u;
+  };
+
+  Mix( m_Scale );
+  Mix( ( m_IsNegative ? 1u : 0u ) | ( m_IsValid ? 2u : 0u ) );
+
+  for ( Uint32 i = 0; i != m_Size; ++i )
+  {
+    Mix( m_Limbs_Ptr[i] );
+  }
+
+  return Hash;
+}
+
+
+/**
+ * @brief Makes room for a number of limbs, keeping those in use. Grows by doubling.
+ **/
+void Decimal::Reserve_Pvt( size_t NumOfLimbs )
+{
+  if ( NumOfLimbs <= m_Capacity )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint32 Capacity  = static_cast<Uint32>( std::max( NumOfLimbs, static_cast<size_t>( m_Capacity ) * 2 ) );
+  Uint32*      Limbs_Ptr = new Uint32[Capacity];
+
+  std::copy( m_Limbs_Ptr, m_Limbs_Ptr + m_Size, Limbs_Ptr );
+  Release_Pvt();
+
+  m_Limbs_Ptr = Limbs_Ptr;
+  m_Capacity  = Capacity;
+}
+
+
+void Decimal::Release_Pvt( void )
+{
+  if ( m_Limbs_Ptr != m_Inline )
+  {
+    delete[] m_Limbs_Ptr;
+
+    m_Limbs_Ptr = m_Inline;
+    m_Capacity  = s_INLINE_LIMBS;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Drops the leading zero limbs.
+ **/
+void Decimal::Trim_Pvt( void )
+{
+  while ( m_Size != 0 && m_Limbs_Ptr[m_Size - 1] == 0 )
+  {
+    --m_Size;
+  }
+}
+
+
+/**
+ * @brief Drops the trailing zeros after the point; zero is positive, with no decimals.
+ **/
+void Decimal::Normalise_Pvt( void )
+{
+  Trim_Pvt();
+
+  while ( m_Size != 0 && m_Scale != 0 )
+  {
+    if ( m_Scale >= LimbDigits && m_Limbs_Ptr[0] == 0 )
+    {
+      std::copy( m_Limbs_Ptr + 1, m_Limbs_Ptr + m_Size, m_Limbs_Ptr );
+      --m_Size;
+      m_Scale -= LimbDigits;
+    }
+    else if ( m_Limbs_Ptr[0] % 10 == 0 )
+    {
+      DivideSmall_Pvt( 10 );
+      --m_Scale;
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  if ( m_Size == 0 )
+  {
+    m_Scale      = 0;
+    m_IsNegative = false;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Rounds half away from zero to at most Scale decimals.
+ **/
+void Decimal::Round_Pvt( Uint32 Scale )
+{
+  if ( m_Scale > Scale )
+  {
+    // All the dropped digits but the last, then the last one decides
+    for ( Uint32 Dropped = m_Scale - Scale - 1; Dropped != 0; )
+    {
+      const Uint32 Digits = std::min( Dropped, LimbDigits );
+
+      DivideSmall_Pvt( PowersOfTen[Digits] );
+      Dropped -= Digits;
+    }
+
+    if ( DivideSmall_Pvt( 10 ) >= 5 )
+    {
+      MultiplySmall_Pvt( 1, 1 );
+    }
+    else
+    {;}
+
+    m_Scale = Scale;
+  }
+  else
+  {;}
+
+  Normalise_Pvt();
+}
+
+
+void Decimal::Overflow_Pvt( void )
+{
+  m_IsValid = false;
+  m_Size    = 0;
+}
+
+
+/**
+ * @brief Magnitude = Magnitude * Factor + Addend, with Factor up to 10^9.
+ **/
+void Decimal::MultiplySmall_Pvt( Uint32 Factor, Uint32 Addend )
+{
+  if ( !m_IsValid )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Uint64 Carry = Addend;
+
+  for ( Uint32 i = 0; i != m_Size; ++i )
+  {
+    const Uint64 Current = static_cast<Uint64>( m_Limbs_Ptr[i] ) * Factor + Carry;
+
+    m_Limbs_Ptr[i] = static_cast<Uint32>( Current % Base );
+    Carry          = Current / Base;
+  }
+
+  while ( Carry != 0 )
+  {
+    if ( m_Size == s_MAX_LIMBS )
+    {
+      Overflow_Pvt();
+      return;
+    }
+    else
+    {;}
+
+    Reserve_Pvt( m_Size + 1 );
+    m_Limbs_Ptr[m_Size++] = static_cast<Uint32>( Carry % Base );
+    Carry /= Base;
+  }
+}
+
+
+/**
+ * @brief Magnitude = Magnitude / Divisor, with Divisor up to 10^9.
+ *
+ * @return The remainder.
+ **/
+Uint32 Decimal::DivideSmall_Pvt( Uint32 Divisor )
+{
+  Uint64 Remainder = 0;
+
+  for ( Uint32 i = m_Size; i-- != 0; )
+  {
+    const Uint64 Current = Remainder * Base + m_Limbs_Ptr[i];
+
+    m_Limbs_Ptr[i] = static_cast<Uint32>( Current / Divisor );
+    Remainder      = Current % Divisor;
+  }
+
+  Trim_Pvt();
+
+  return static_cast<Uint32>( Remainder );
+}
+
+
+/**
+ * @brief Magnitude = Magnitude * 10^Digits.
+ **/
+void Decimal::ShiftLeft_Pvt( Uint32 Digits )
+{
+  while ( Digits != 0 && m_IsValid )
+  {
+    const Uint32 Step = std::min( Digits, LimbDigits );
+
+    MultiplySmall_Pvt( PowersOfTen[Step] );
+    Digits -= Step;
+  }
+}
+
+
+/**
+ * @brief Writes every digit of the magnitude, as an integer: "254" for 2.54.
+ **/
+size_t Decimal::FormatDigits_Pvt( char* Text, size_t Size ) const
+{
+  if ( m_Size == 0 )
+  {
+    return static_cast<size_t>( std::max( snprintf( Text, Size, "0" ), 0 ) );
+  }
+  else
+  {;}
+
+  size_t Length = static_cast<size_t>( std::max( snprintf( Text, Size, "%u", static_cast<unsigned>( m_Limbs_Ptr[m_Size - 1] ) ), 0 ) );
+
+  for ( Uint32 i = m_Size - 1; i-- != 0 && Length + LimbDigits < Size; )
+  {
+    Length += static_cast<size_t>( std::max( snprintf( Text + Length, Size - Length, "%09u", static_cast<unsigned>( m_Limbs_Ptr[i] ) ), 0 ) );
+  }
+
+  return Length;
+}
+
+
+/**
+ * @brief Compares |Left| and |Right|, with the same scale.
+ *
+ * @return Less than, equal to or greater than 0.
+ **/
+int Decimal::CompareMagnitudes( const Decimal& Left, const Decimal& Right )
+{
+  if ( Left.m_Size != Right.m_Size )
+  {
+    return ( Left.m_Size < Right.m_Size ) ? -1 : 1;
+  }
+  else
+  {;}
+
+  for ( Uint32 i = Left.m_Size; i-- != 0; )
+  {
+    if ( Left.m_Limbs_Ptr[i] != Right.m_Limbs_Ptr[i] )
+    {
+      return ( Left.m_Limbs_Ptr[i] < Right.m_Limbs_Ptr[i] ) ? -1 : 1;
+    }
+    else
+    {;}
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief |Left| + |Right|, or |Left| - |Right| with |Left| >= |Right|, with the scale of Left;
+ * positive.
+ **/
+Decimal Decimal::AddMagnitudes( const Decimal& Left, const Decimal& Right, bool IsSubtraction )
+{
+  Decimal Result;
+
+  const Uint32 Size = std::max( Left.m_Size, Right.m_Size );
+
+  if ( Size + 1 > s_MAX_LIMBS )
+  {
+    return Invalid();
+  }
+  else
+  {;}
+
+  Result.Reserve_Pvt( Size + 1 );
+
+  Sint64 Carry = 0;
+
+  for ( Uint32 i = 0; i != Size; ++i )
+  {
+    const Sint64 LeftLimb  = ( i < Left.m_Size  ) ? Left.m_Limbs_Ptr[i]  : 0;
+    const Sint64 RightLimb = ( i < Right.m_Size ) ? Right.m_Limbs_Ptr[i] : 0;
+    Sint64       Current   = LeftLimb + ( IsSubtraction ? -RightLimb : RightLimb ) + Carry;
+
+    Carry = 0;
+
+    if ( Current < 0 )
+    {
+      Current += Base;
+      Carry    = -1;
+    }
+    else if ( Current >= Base )
+    {
+      Current -= Base;
+      Carry    = 1;
+    }
+    else
+    {;}
+
+    Result.m_Limbs_Ptr[i] = static_cast<Uint32>( Current );
+  }
+
+  Result.m_Limbs_Ptr[Size] = static_cast<Uint32>( Carry );  // 0 or 1: never negative here
+  Result.m_Size  = Size + 1;
+  Result.m_Scale = Left.m_Scale;
+  Result.Trim_Pvt();
+
+  return Result;
+}
+
+
+/**
+ * @brief The same number with more decimals, for additions.
+ **/
+Decimal Decimal::Align( const Decimal& Number, Uint32 Scale )
+{
+  Decimal Result( Number );
+
+  Result.ShiftLeft_Pvt( Scale - Number.m_Scale );
+  Result.m_Scale = Scale;
+
+  return Result;
+}
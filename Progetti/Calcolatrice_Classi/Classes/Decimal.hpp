@@ -0,0 +1,95 @@
+/**
+ * @file Decimal.hpp
+ *
+ * @brief Exact decimal numbers for the calculator's results and memory.
+ **/
+
+#ifndef DECIMAL_HPP
+#define DECIMAL_HPP
+
+#include <SDL.h>
+#include <cstddef>
+
+/**
+ * @brief A signed decimal number of any length, with up to s_MAX_SCALE digits after the point.
+ *
+ * The digits are kept as an integer in base 10^9 "limbs" (9 digits each), least significant first,
+ * with the number of digits after the point: 2.54 is 254 with scale 2. Additions, subtractions and
+ * integer powers are exact; products are exact up to s_MAX_SCALE decimals, divisions and
+ * percentages are rounded (half away from zero) to s_MAX_SCALE decimals. Only non-integer powers go
+ * through double. Values are kept without trailing zeros after the point, so that equal numbers
+ * have equal digits.
+ *
+ * Up to s_INLINE_LIMBS limbs (36 digits, every number a key sequence can type and most results)
+ * live inside the object: the heap is only used by longer numbers. A division by zero, or a number
+ * beyond s_MAX_LIMBS, gives an invalid value, which propagates as NaN does.
+ **/
+class Decimal
+{
+public:
+
+  static constexpr size_t s_INLINE_LIMBS = 4;
+  static constexpr size_t s_MAX_LIMBS    = 128;  // 1152 digits
+  static constexpr Uint32 s_MAX_SCALE    = 30;   // Digits after the point
+
+  Decimal( void );
+  Decimal( Sint64 );
+  Decimal( const Decimal& );
+  Decimal( Decimal&& ) noexcept;
+  ~Decimal( void );
+
+  Decimal& operator=( const Decimal& );
+  Decimal& operator=( Decimal&& ) noexcept;
+
+  static Decimal FromDigits( Uint64, Uint32 );
+  static Decimal FromDouble( double );
+  static Decimal Invalid   ( void );
+
+  Decimal operator-( void ) const;
+
+  friend Decimal operator+( const Decimal&, const Decimal& );
+  friend Decimal operator-( const Decimal&, const Decimal& );
+  friend Decimal operator*( const Decimal&, const Decimal& );
+  friend Decimal operator/( const Decimal&, const Decimal& );
+
+  bool    operator==( const Decimal& ) const;
+  bool    operator!=( const Decimal& ) const;
+
+  Decimal percent  ( void ) const;
+  Decimal power    ( const Decimal& ) const;
+
+  double  toDouble ( void ) const;
+  size_t  format   ( char*, size_t, size_t = 0 ) const;
+
+  bool    IsValid  ( void ) const;
+  bool    IsZero   ( void ) const;
+  bool    IsInteger( void ) const;
+  Uint32  GetHash  ( void ) const;
+
+private:
+
+  void   Reserve_Pvt       ( size_t );
+  void   Release_Pvt       ( void );
+  void   Trim_Pvt          ( void );
+  void   Normalise_Pvt     ( void );
+  void   Round_Pvt         ( Uint32 );
+  void   Overflow_Pvt      ( void );
+  void   MultiplySmall_Pvt ( Uint32, Uint32 = 0 );
+  Uint32 DivideSmall_Pvt   ( Uint32 );
+  void   ShiftLeft_Pvt     ( Uint32 );
+  size_t FormatDigits_Pvt  ( char*, size_t ) const;
+
+  static int     CompareMagnitudes( const Decimal&, const Decimal& );
+  static Decimal AddMagnitudes    ( const Decimal&, const Decimal&, bool );
+  static Decimal Align            ( const Decimal&, Uint32 );
+
+  Uint32  m_Inline[s_INLINE_LIMBS];
+  Uint32* m_Limbs_Ptr;      // m_Inline, or the heap beyond s_INLINE_LIMBS
+  Uint32  m_Size;           // Limbs used; zero has none
+  Uint32  m_Capacity;
+  Uint32  m_Scale;          // Digits after the point
+  bool    m_IsNegative;
+  bool    m_IsValid;
+};
+
+#endif // DECIMAL_HPP
@@ -0,0 +1,56 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "DecimalMemo.hpp"
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+DecimalMemo::DecimalMemo( void )
+  : m_Entries(), m_Hits(0), m_Misses(0)
+{;}
+
+
+/**
+ * @brief The result of an operation, from the cache if it was computed recently.
+ **/
+Decimal DecimalMemo::apply( Operation Op, const Decimal& Left, const Decimal& Right )
+{
+  const Uint32 Hash    = ( Left.GetHash() * 31u + Right.GetHash() ) * 3u + static_cast<Uint32>( Op );
+  Entry&       Current = m_Entries[Hash % s_SIZE];
+
+  if ( Current.IsUsed && Current.Op == Op && Current.Left == Left && Current.Right == Right )
+  {
+    ++m_Hits;
+    return Current.Result;
+  }
+  else
+  {;}
+
+  ++m_Misses;
+
+  Current.IsUsed = true;
+  Current.Op     = Op;
+  Current.Left   = Left;
+  Current.Right  = Right;
+  Current.Result = ( Op == Operation::MULTIPLY ) ? Left * Right
+                 : ( Op == Operation::DIVIDE   ) ? Left / Right
+                 :                                 Left.power( Right );
+
+  return Current.Result;
+}
+
+
+Uint32 DecimalMemo::GetHits( void ) const
+{
+  return m_Hits;
+}
+
+
+Uint32 DecimalMemo::GetMisses( void ) const
+{
+  return m_Misses;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file DecimalMemo.hpp
+ *
+ * @brief Cache of the recent products, quotients and powers of Decimal numbers.
+ **/
+
+#ifndef DECIMALMEMO_HPP
+#define DECIMALMEMO_HPP
+
+#include <SDL.h>
+#include <array>
+#include <cstddef>
+#include "Decimal.hpp"
+
+/**
+ * @brief Remembers the last results of the costly Decimal operations, so that the sub-expressions a
+ * user repeats, e.g. "1.05^12" in every step of a chain, are not computed again.
+ *
+ * The cache has s_SIZE entries, one per hash of the operation and its operands: a new result
+ * replaces the one with the same hash. Its Decimal numbers are inline, so storing a result only
+ * copies digits.
+ **/
+class DecimalMemo
+{
+public:
+
+  static constexpr size_t s_SIZE = 64;
+
+  enum class Operation : Uint8
+  {
+    MULTIPLY = 0,
+    DIVIDE,
+    POWER
+  };
+
+  DecimalMemo( void );
+
+  Decimal apply    ( Operation, const Decimal&, const Decimal& );
+
+  Uint32  GetHits  ( void ) const;
+  Uint32  GetMisses( void ) const;
+
+private:
+
+  struct Entry
+  {
+    bool      IsUsed = false;
+    Operation Op     = Operation::MULTIPLY;
+    Decimal   Left;
+    Decimal   Right;
+    Decimal   Result;
+  };
+
+  std::array<Entry, s_SIZE> m_Entries;
+  Uint32                    m_Hits;
+  Uint32                    m_Misses;
+};
+
+#endif // DECIMALMEMO_HPP
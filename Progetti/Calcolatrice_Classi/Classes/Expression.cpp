@@ -0,0 +1,825 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "Expression.hpp"
+#include "DecimalMemo.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+// Operators waiting, while compiling, for their right operand. The first five are in the order of
+// the binary OpCodes from ADD
+enum class Pending : Uint8
+{
+  ADD = 0,
+  SUBTRACT,
+  MULTIPLY,
+  DIVIDE,
+  POWER,
+  NEGATE,  // '-' where an operand was expected
+  OPEN
+};
+
+static const int PendingPrecedence[] = { 1, 1, 2, 2, 4, 3, 0 }; // NEGATE below POWER: -2^2 is -4
+
+static const char* Error_NotCompiled    = "No expression compiled";
+static const char* Error_Empty          = "Empty expression";
+static const char* Error_TooLong        = "Expression too long";
+static const char* Error_TooManyDigits  = "Too many digits";
+static const char* Error_TwoPoints      = "Two decimal points in a number";
+static const char* Error_OperatorNeeded = "An operator is missing";
+static const char* Error_OperandNeeded  = "An operand is missing";
+static const char* Error_Unbalanced     = "Closing bracket without an opening one";
+static const char* Error_NoRecall       = "No value to recall";
+static const char* Error_Command        = "Not part of an expression";
+static const char* Error_UnknownChar    = "Unknown character";
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+Expression::Expression( void )
+  : m_Code(), m_Constants(), m_Exact(), m_Memo_Ptr(nullptr), m_Length(0), m_NumOfConstants(0),
+    m_Depth(0), m_MaxDepth(0), m_UsesInput(false), m_Error(Error_NotCompiled)
+{;}
+
+
+/**
+ * @brief Compiles keys, in the order they were pressed. The previous code is discarded, even if the
+ * new one does not compile.
+ *
+ * @param Keys_Ptr The keys.
+ * @param NumOfKeys How many, at most s_MAX_KEYS.
+ * @param Recalled_Ptr The values of the KEY_RECALL keys, in the same order; may be nullptr if none.
+ * @return true if compiled; otherwise "GetError" tells why.
+ **/
+bool Expression::compile( const Key* Keys_Ptr, size_t NumOfKeys, const Decimal* Recalled_Ptr )
+{
+  m_Length         = 0;
+  m_NumOfConstants = 0;
+  m_Depth          = 0;
+  m_MaxDepth       = 0;
+  m_UsesInput      = false;
+  m_Error          = nullptr;
+
+  if ( NumOfKeys == 0 )
+  {
+    return Fail_Pvt( Error_Empty );
+  }
+  else if ( NumOfKeys > s_MAX_KEYS )
+  {
+    return Fail_Pvt( Error_TooLong );
+  }
+  else
+  {;}
+
+  std::array<Pending, s_MAX_KEYS> Operators;
+  size_t NumOfOperators = 0;
+  size_t NextRecalled   = 0;
+  bool   ExpectOperand  = true;
+
+  // The number being typed
+  bool   IsInNumber     = false;
+  bool   HasPoint       = false;
+  Uint64 Mantissa       = 0;
+  size_t Digits         = 0;
+  size_t Decimals       = 0;
+
+  auto EndNumber = [&] ()
+  {
+    if ( !IsInNumber )
+    {
+      return true;
+    }
+    else
+    {;}
+
+    IsInNumber    = false;
+    ExpectOperand = false;
+
+    return EmitValue_Pvt( OpCode::CONSTANT, Decimal::FromDigits( Mantissa, static_cast<Uint32>( Decimals ) ) );
+  };
+
+  auto PopOperator = [&] ()
+  {
+    const Pending Top = Operators[--NumOfOperators];
+
+    return ( Top == Pending::NEGATE ) ? EmitUnary_Pvt( OpCode::NEGATE )
+                                      : EmitBinary_Pvt( static_cast<OpCode>( static_cast<int>( OpCode::ADD ) + static_cast<int>( Top ) ) );
+  };
+
+  for ( size_t i = 0; i != NumOfKeys; ++i )
+  {
+    const Key Current = Keys_Ptr[i];
+
+    if ( Current <= Key::KEY_9 || Current == Key::KEY_POINT )
+    {
+      if ( !IsInNumber )
+      {
+        if ( !ExpectOperand )
+        {
+          return Fail_Pvt( Error_OperatorNeeded );
+        }
+        else
+        {;}
+
+        IsInNumber = true;
+        HasPoint   = false;
+        Mantissa   = 0;
+        Digits     = 0;
+        Decimals   = 0;
+      }
+      else
+      {;}
+
+      if ( Current == Key::KEY_POINT )
+      {
+        if ( HasPoint )
+        {
+          return Fail_Pvt( Error_TwoPoints );
+        }
+        else
+        {;}
+
+        HasPoint = true;
+      }
+      else if ( Digits == s_MAX_DIGITS )
+      {
+        return Fail_Pvt( Error_TooManyDigits );
+      }
+      else
+      {
+        // Kept as an integer: "2.54" is 254 with 2 decimals, exactly
+        Mantissa = Mantissa * 10 + static_cast<Uint64>( Current );
+        Digits   += 1;
+        Decimals += HasPoint ? 1 : 0;
+      }
+
+      continue;
+    }
+    else if ( !EndNumber() )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    switch ( Current )
+    {
+      case Key::KEY_INPUT:
+      case Key::KEY_RECALL:
+        if ( !ExpectOperand )
+        {
+          return Fail_Pvt( Error_OperatorNeeded );
+        }
+        else if ( Current == Key::KEY_INPUT )
+        {
+          m_UsesInput = true;
+
+          if ( !EmitValue_Pvt( OpCode::INPUT, Decimal() ) )
+          {
+            return false;
+          }
+          else
+          {;}
+        }
+        else if ( Recalled_Ptr == nullptr )
+        {
+          return Fail_Pvt( Error_NoRecall );
+        }
+        else if ( !EmitValue_Pvt( OpCode::CONSTANT, Recalled_Ptr[NextRecalled++] ) )
+        {
+          return false;
+        }
+        else
+        {;}
+
+        ExpectOperand = false;
+        break;
+
+      case Key::KEY_OPEN:
+        if ( !ExpectOperand )
+        {
+          return Fail_Pvt( Error_OperatorNeeded ); // No implicit multiplication
+        }
+        else
+        {;}
+
+        Operators[NumOfOperators++] = Pending::OPEN;
+        break;
+
+      case Key::KEY_CLOSE:
+        if ( ExpectOperand )
+        {
+          return Fail_Pvt( Error_OperandNeeded );
+        }
+        else
+        {;}
+
+        while ( NumOfOperators != 0 && Operators[NumOfOperators - 1] != Pending::OPEN )
+        {
+          if ( !PopOperator() )
+          {
+            return false;
+          }
+          else
+          {;}
+        }
+
+        if ( NumOfOperators == 0 )
+        {
+          return Fail_Pvt( Error_Unbalanced );
+        }
+        else
+        {;}
+
+        --NumOfOperators;
+        break;
+
+      case Key::KEY_SIGN:
+      case Key::KEY_PERCENT:
+        if ( ExpectOperand )
+        {
+          if ( Current == Key::KEY_SIGN )
+          {
+            Operators[NumOfOperators++] = Pending::NEGATE; // Before the number, as '-'
+            break;
+          }
+          else
+          {
+            return Fail_Pvt( Error_OperandNeeded );
+          }
+        }
+        else
+        {;}
+
+        // Applies to the operand just typed, which is on top of the stack
+        if ( !EmitUnary_Pvt( ( Current == Key::KEY_SIGN ) ? OpCode::NEGATE : OpCode::PERCENT ) )
+        {
+          return false;
+        }
+        else
+        {;}
+        break;
+
+      case Key::KEY_PLUS:
+      case Key::KEY_MINUS:
+      case Key::KEY_MULTIPLY:
+      case Key::KEY_DIVIDE:
+      case Key::KEY_POWER:
+      {
+        if ( ExpectOperand )
+        {
+          if ( Current == Key::KEY_MINUS )
+          {
+            Operators[NumOfOperators++] = Pending::NEGATE;
+            break;
+          }
+          else if ( Current == Key::KEY_PLUS )
+          {
+            break; // Unary plus
+          }
+          else
+          {
+            return Fail_Pvt( Error_OperandNeeded );
+          }
+        }
+        else
+        {;}
+
+        const Pending Incoming = ( Current == Key::KEY_PLUS     ) ? Pending::ADD
+                               : ( Current == Key::KEY_MINUS    ) ? Pending::SUBTRACT
+                               : ( Current == Key::KEY_MULTIPLY ) ? Pending::MULTIPLY
+                               : ( Current == Key::KEY_DIVIDE   ) ? Pending::DIVIDE
+                               :                                    Pending::POWER;
+
+        const int  Precedence    = PendingPrecedence[static_cast<int>( Incoming )];
+        const bool IsRightAssoc  = ( Incoming == Pending::POWER );
+
+        while ( NumOfOperators != 0 )
+        {
+          const int TopPrecedence = PendingPrecedence[static_cast<int>( Operators[NumOfOperators - 1] )];
+
+          if ( TopPrecedence > Precedence || ( TopPrecedence == Precedence && !IsRightAssoc ) )
+          {
+            if ( !PopOperator() )
+            {
+              return false;
+            }
+            else
+            {;}
+          }
+          else
+          {
+            break;
+          }
+        }
+
+        Operators[NumOfOperators++] = Incoming;
+        ExpectOperand = true;
+        break;
+      }
+
+      default:
+        return Fail_Pvt( Error_Command );
+    }
+  }
+
+  if ( !EndNumber() )
+  {
+    return false;
+  }
+  else if ( ExpectOperand )
+  {
+    return Fail_Pvt( Error_OperandNeeded );
+  }
+  else
+  {;}
+
+  // Brackets left open are closed at the end, as on a pocket calculator
+  while ( NumOfOperators != 0 )
+  {
+    if ( Operators[NumOfOperators - 1] == Pending::OPEN )
+    {
+      --NumOfOperators;
+    }
+    else if ( !PopOperator() )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief Compiles a text, e.g. "x*2.54+1": digits, '.', '+', '-', '*', '/', '^', '%', 'x' for the
+ * input, brackets and spaces.
+ *
+ * @return true if compiled; otherwise "GetError" tells why.
+ **/
+bool Expression::compile( const char* Text )
+{
+  std::array<Key, s_MAX_KEYS> Keys;
+  size_t NumOfKeys = 0;
+
+  for ( const char* Char_Ptr = Text; *Char_Ptr != '\0'; ++Char_Ptr )
+  {
+    Key Mapped;
+
+    switch ( *Char_Ptr )
+    {
+      case ' ': case '\t': case '\r': case '\n':
+        continue;
+
+      case '.':           Mapped = Key::KEY_POINT;    break;
+      case '+':           Mapped = Key::KEY_PLUS;     break;
+      case '-':           Mapped = Key::KEY_MINUS;    break;
+      case '*':           Mapped = Key::KEY_MULTIPLY; break;
+      case '/':           Mapped = Key::KEY_DIVIDE;   break;
+      case '^':           Mapped = Key::KEY_POWER;    break;
+      case '%':           Mapped = Key::KEY_PERCENT;  break;
+      case 'x': case 'X': Mapped = Key::KEY_INPUT;    break;
+      case '(':           Mapped = Key::KEY_OPEN;     break;
+      case ')':           Mapped = Key::KEY_CLOSE;    break;
+
+      default:
+        if ( *Char_Ptr >= '0' && *Char_Ptr <= '9' )
+        {
+          Mapped = static_cast<Key>( *Char_Ptr - '0' );
+        }
+        else
+        {
+          m_Length = 0;
+          return Fail_Pvt( Error_UnknownChar );
+        }
+        break;
+    }
+
+    if ( NumOfKeys == s_MAX_KEYS )
+    {
+      m_Length = 0;
+      return Fail_Pvt( Error_TooLong );
+    }
+    else
+    {;}
+
+    Keys[NumOfKeys++] = Mapped;
+  }
+
+  return compile( Keys.data(), NumOfKeys );
+}
+
+
+/**
+ * @brief Evaluates the expression for one value of the input.
+ *
+ * @return The result; NaN if the expression is not valid.
+ **/
+double Expression::evaluate( double Input ) const
+{
+  if ( !IsValid() )
+  {
+    return NAN;
+  }
+  else
+  {;}
+
+  std::array<double, s_MAX_STACK> Stack;
+  size_t Top = 0;
+
+  for ( size_t i = 0; i != m_Length; ++i )
+  {
+    const Instruction& Current = m_Code[i];
+
+    switch ( Current.Op )
+    {
+      case OpCode::CONSTANT:
+        Stack[Top++] = m_Constants[Current.Constant];
+        break;
+
+      case OpCode::INPUT:
+        Stack[Top++] = Input;
+        break;
+
+      case OpCode::ADD:
+      case OpCode::SUBTRACT:
+      case OpCode::MULTIPLY:
+      case OpCode::DIVIDE:
+      case OpCode::POWER:
+        --Top;
+        Stack[Top - 1] = Apply_Pvt( Current.Op, Stack[Top - 1], Stack[Top] );
+        break;
+
+      case OpCode::ADD_CONSTANT:
+      case OpCode::SUBTRACT_CONSTANT:
+      case OpCode::MULTIPLY_CONSTANT:
+      case OpCode::DIVIDE_CONSTANT:
+      case OpCode::POWER_CONSTANT:
+        Stack[Top - 1] = Apply_Pvt( Current.Op, Stack[Top - 1], m_Constants[Current.Constant] );
+        break;
+
+      case OpCode::NEGATE:
+      case OpCode::PERCENT:
+        Stack[Top - 1] = Apply_Pvt( Current.Op, Stack[Top - 1], 0.0 );
+        break;
+    }
+  }
+
+  return Stack[0];
+}
+
+
+/**
+ * @brief Evaluates the expression for every input of a column, a block of s_LANES values at a time:
+ * each instruction runs over the whole block before the next one.
+ *
+ * @param Inputs_Ptr The values of "x"; may be nullptr if the expression does not use it.
+ * @param Outputs_Ptr Where the results go; may be the same array as the inputs.
+ * @param Count How many values. Invalid expressions give NaN for each.
+ **/
+void Expression::evaluate( const double* Inputs_Ptr, double* Outputs_Ptr, size_t Count ) const
+{
+  if ( !IsValid() )
+  {
+    std::fill( Outputs_Ptr, Outputs_Ptr + Count, NAN );
+    return;
+  }
+  else if ( !m_UsesInput )
+  {
+    std::fill( Outputs_Ptr, Outputs_Ptr + Count, evaluate( 0.0 ) ); // Folded to one constant
+    return;
+  }
+  else
+  {;}
+
+  double Stack[s_MAX_STACK][s_LANES];
+
+  for ( size_t Start = 0; Start < Count; Start += s_LANES )
+  {
+    const size_t Lanes = std::min( s_LANES, Count - Start );
+    size_t       Top   = 0;
+
+    for ( size_t i = 0; i != m_Length; ++i )
+    {
+      const Instruction& Current  = m_Code[i];
+      const double       Constant = m_Constants[Current.Constant];
+      double* const      Out_Ptr  = ( Top != 0 ) ? Stack[Top - 1] : nullptr; // The operand the unary and *_CONSTANT forms update
+
+      switch ( Current.Op )
+      {
+        case OpCode::CONSTANT:
+          std::fill( Stack[Top], Stack[Top] + Lanes, Constant );
+          ++Top;
+          break;
+
+        case OpCode::INPUT:
+          std::copy( Inputs_Ptr + Start, Inputs_Ptr + Start + Lanes, Stack[Top] );
+          ++Top;
+          break;
+
+        case OpCode::ADD:
+          --Top;
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Stack[Top - 1][Lane] += Stack[Top][Lane]; }
+          break;
+
+        case OpCode::SUBTRACT:
+          --Top;
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Stack[Top - 1][Lane] -= Stack[Top][Lane]; }
+          break;
+
+        case OpCode::MULTIPLY:
+          --Top;
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Stack[Top - 1][Lane] *= Stack[Top][Lane]; }
+          break;
+
+        case OpCode::DIVIDE:
+          --Top;
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Stack[Top - 1][Lane] /= Stack[Top][Lane]; }
+          break;
+
+        case OpCode::POWER:
+          --Top;
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Stack[Top - 1][Lane] = std::pow( Stack[Top - 1][Lane], Stack[Top][Lane] ); }
+          break;
+
+        case OpCode::ADD_CONSTANT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] += Constant; }
+          break;
+
+        case OpCode::SUBTRACT_CONSTANT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] -= Constant; }
+          break;
+
+        case OpCode::MULTIPLY_CONSTANT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] *= Constant; }
+          break;
+
+        case OpCode::DIVIDE_CONSTANT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] /= Constant; }
+          break;
+
+        case OpCode::POWER_CONSTANT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] = std::pow( Out_Ptr[Lane], Constant ); }
+          break;
+
+        case OpCode::NEGATE:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] = -Out_Ptr[Lane]; }
+          break;
+
+        case OpCode::PERCENT:
+          for ( size_t Lane = 0; Lane != Lanes; ++Lane ) { Out_Ptr[Lane] /= 100.0; }
+          break;
+      }
+    }
+
+    std::copy( Stack[0], Stack[0] + Lanes, Outputs_Ptr + Start );
+  }
+}
+
+
+/**
+ * @brief The exact result of an expression without "x", folded while compiling.
+ *
+ * @return false if the expression is not valid or uses "x".
+ **/
+bool Expression::evaluateExact( Decimal& Result ) const
+{
+  if ( !IsValid() || m_UsesInput )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Result = m_Exact[m_Code[0].Constant]; // A constant expression is one CONSTANT
+
+  return true;
+}
+
+
+/**
+ * @brief Sets the cache of the products, quotients and powers folded by "compile".
+ *
+ * @param Memo_Ptr nullptr to compute them every time.
+ **/
+void Expression::SetMemo( DecimalMemo* Memo_Ptr )
+{
+  m_Memo_Ptr = Memo_Ptr;
+}
+
+
+bool Expression::IsValid( void ) const
+{
+  return m_Error == nullptr;
+}
+
+
+/**
+ * @brief Whether the expression depends on "x"; if not, every batch result is the same.
+ **/
+bool Expression::UsesInput( void ) const
+{
+  return m_UsesInput;
+}
+
+
+/**
+ * @brief Instructions in the compiled code.
+ **/
+size_t Expression::GetLength( void ) const
+{
+  return m_Length;
+}
+
+
+/**
+ * @brief Why the last "compile" failed.
+ *
+ * @return nullptr if it succeeded.
+ **/
+const char* Expression::GetError( void ) const
+{
+  return m_Error;
+}
+
+
+/**
+ * @brief One instruction on scalars, for evaluation and constant folding. The *_CONSTANT forms take
+ * their constant as Right; the unary ones ignore it.
+ **/
+double Expression::Apply_Pvt( OpCode Op, double Left, double Right )
+{
+  switch ( Op )
+  {
+    case OpCode::ADD:      case OpCode::ADD_CONSTANT:      return Left + Right;
+    case OpCode::SUBTRACT: case OpCode::SUBTRACT_CONSTANT: return Left - Right;
+    case OpCode::MULTIPLY: case OpCode::MULTIPLY_CONSTANT: return Left * Right;
+    case OpCode::DIVIDE:   case OpCode::DIVIDE_CONSTANT:   return Left / Right;
+    case OpCode::POWER:    case OpCode::POWER_CONSTANT:    return std::pow( Left, Right );
+    case OpCode::NEGATE:                                   return -Left;
+    case OpCode::PERCENT:                                  return Left / 100.0;
+    default:                                               return Left;
+  }
+}
+
+
+/**
+ * @brief The exact counterpart of "Apply_Pvt", for the folding.
+ **/
+Decimal Expression::ApplyExact_Pvt( OpCode Op, const Decimal& Left, const Decimal& Right )
+{
+  switch ( Op )
+  {
+    case OpCode::ADD:      case OpCode::ADD_CONSTANT:      return Left + Right;
+    case OpCode::SUBTRACT: case OpCode::SUBTRACT_CONSTANT: return Left - Right;
+    case OpCode::NEGATE:                                   return -Left;
+    case OpCode::PERCENT:                                  return Left.percent();
+    default:                                               break;
+  }
+
+  const DecimalMemo::Operation Operation = ( Op == OpCode::MULTIPLY || Op == OpCode::MULTIPLY_CONSTANT ) ? DecimalMemo::Operation::MULTIPLY
+                                         : ( Op == OpCode::DIVIDE   || Op == OpCode::DIVIDE_CONSTANT   ) ? DecimalMemo::Operation::DIVIDE
+                                         :                                                              DecimalMemo::Operation::POWER;
+
+  if ( m_Memo_Ptr != nullptr )
+  {
+    return m_Memo_Ptr->apply( Operation, Left, Right );
+  }
+  else
+  {;}
+
+  return ( Operation == DecimalMemo::Operation::MULTIPLY ) ? Left * Right
+       : ( Operation == DecimalMemo::Operation::DIVIDE   ) ? Left / Right
+       :                                                     Left.power( Right );
+}
+
+
+bool Expression::Fail_Pvt( const char* Error )
+{
+  m_Error  = Error;
+  m_Length = 0;
+
+  return false;
+}
+
+
+/**
+ * @brief Pushes a constant or the input.
+ **/
+bool Expression::EmitValue_Pvt( OpCode Op, const Decimal& Value )
+{
+  size_t Constant = 0;
+
+  if ( Op == OpCode::CONSTANT )
+  {
+    if ( m_NumOfConstants == s_MAX_CONSTANTS )
+    {
+      return Fail_Pvt( Error_TooLong );
+    }
+    else
+    {;}
+
+    Constant = m_NumOfConstants++;
+    m_Exact[Constant]     = Value;
+    m_Constants[Constant] = Value.toDouble();
+  }
+  else
+  {;}
+
+  if ( ++m_Depth > s_MAX_STACK )
+  {
+    return Fail_Pvt( Error_TooLong );
+  }
+  else
+  {;}
+
+  m_MaxDepth = std::max( m_MaxDepth, m_Depth );
+
+  return Emit_Pvt( Op, Constant );
+}
+
+
+/**
+ * @brief Negates or takes the percent of the operand on top; a constant is changed in place,
+ * exactly.
+ **/
+bool Expression::EmitUnary_Pvt( OpCode Op )
+{
+  if ( m_Length != 0 && m_Code[m_Length - 1].Op == OpCode::CONSTANT )
+  {
+    const Uint8 Constant = m_Code[m_Length - 1].Constant;
+
+    m_Exact[Constant]     = ApplyExact_Pvt( Op, m_Exact[Constant], Decimal() );
+    m_Constants[Constant] = m_Exact[Constant].toDouble();
+
+    return true;
+  }
+  else
+  {;}
+
+  return Emit_Pvt( Op, 0 );
+}
+
+
+/**
+ * @brief Combines the two operands on top. Two constants are folded into one, exactly; a constant right
+ * operand is carried by the instruction instead of being pushed.
+ *
+ * @param Op From ADD to POWER.
+ **/
+bool Expression::EmitBinary_Pvt( OpCode Op )
+{
+  --m_Depth;
+
+  if ( m_Length != 0 && m_Code[m_Length - 1].Op == OpCode::CONSTANT )
+  {
+    const Uint8 Right = m_Code[m_Length - 1].Constant;
+
+    if ( m_Length >= 2 && m_Code[m_Length - 2].Op == OpCode::CONSTANT )
+    {
+      // The right constant is the last one added: its slot is given back
+      const Uint8 Left = m_Code[m_Length - 2].Constant;
+
+      m_Exact[Left]     = ApplyExact_Pvt( Op, m_Exact[Left], m_Exact[Right] );
+      m_Constants[Left] = m_Exact[Left].toDouble();
+      m_NumOfConstants  = Right;
+      m_Length         -= 1;
+    }
+    else
+    {
+      m_Code[m_Length - 1].Op = static_cast<OpCode>( static_cast<int>( Op ) + static_cast<int>( OpCode::ADD_CONSTANT ) - static_cast<int>( OpCode::ADD ) );
+    }
+
+    return true;
+  }
+  else
+  {;}
+
+  return Emit_Pvt( Op, 0 );
+}
+
+
+bool Expression::Emit_Pvt( OpCode Op, size_t Constant )
+{
+  if ( m_Length == s_MAX_INSTRUCTIONS )
+  {
+    return Fail_Pvt( Error_TooLong );
+  }
+  else
+  {;}
+
+  m_Code[m_Length++] = Instruction{ Op, static_cast<Uint8>( Constant ) };
+
+  return true;
+}
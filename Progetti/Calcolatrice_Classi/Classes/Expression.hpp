@@ -0,0 +1,153 @@
+/**
+ * @file Expression.hpp
+ *
+ * @brief Arithmetic expressions typed on the calculator's keys, compiled once into a compact
+ * bytecode and evaluated without heap allocation, one value at a time or over whole columns.
+ **/
+
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <SDL.h>
+#include <array>
+#include <cstddef>
+#include "Decimal.hpp"
+
+class DecimalMemo;
+
+/**
+ * @brief A compiled expression of the calculator's operators over numbers, recalled values and one
+ * input "x", the variable of the batch evaluation.
+ *
+ * "compile" takes the keys in the order they were pressed (or a text such as "x*2.54+1", mapped to
+ * the same keys) and turns them, with the usual precedence ('^' first and right-associative, then
+ * '*' '/', then '+' '-'), into postfix instructions. Constant sub-expressions are folded, and an
+ * operator whose right operand is a constant carries it instead of pushing it first: "x*2.54+1" is
+ * two instructions after loading x. Everything lives in fixed arrays inside the object, and
+ * "evaluate" uses a stack array: neither allocates.
+ *
+ * Constants are kept as Decimal numbers too, and folded exactly: an expression without "x", which
+ * is every one typed on the keypad, compiles to its exact result, read by "evaluateExact". The
+ * products, quotients and powers of the folding go through the DecimalMemo given to "SetMemo", if
+ * any.
+ *
+ * The batch "evaluate" runs every instruction over a block of s_LANES inputs before the next one,
+ * on columns of a stack array, so that each instruction is a plain loop the compiler vectorises
+ * (SSE2 or AVX, with the optimised builds); the cost of decoding the bytecode is paid once per
+ * block rather than once per value.
+ *
+ * SIGN changes the sign of the operand just typed, '%' divides it by 100, and '-' where an operand
+ * is expected negates what follows. Division by zero gives an infinity or NaN, as in IEEE 754.
+ **/
+class Expression
+{
+public:
+
+  /**
+   * @brief The keys of the calculator, in the order of Renderer::ButtonsClips_Enum, then those only
+   * a text or the calculator itself produce. MRC, MEMMINUS, MEMPLUS, EQUALS and DEL are commands of
+   * the Calculator, not part of an expression.
+   **/
+  enum class Key : Uint8
+  {
+    KEY_0 = 0,
+    KEY_1,
+    KEY_2,
+    KEY_3,
+    KEY_4,
+    KEY_5,
+    KEY_6,
+    KEY_7,
+    KEY_8,
+    KEY_9,
+    KEY_MRC,
+    KEY_MEMMINUS,
+    KEY_MEMPLUS,
+    KEY_PLUS,
+    KEY_MINUS,
+    KEY_DIVIDE,
+    KEY_MULTIPLY,
+    KEY_POINT,
+    KEY_EQUALS,
+    KEY_SIGN,
+    KEY_POWER,
+    KEY_DEL,
+    KEY_PERCENT,
+
+    KEY_INPUT,   // "x", the value of the batch evaluation
+    KEY_RECALL,  // The next of the recalled values given to "compile" (last result, memory)
+    KEY_OPEN,
+    KEY_CLOSE,
+
+    HOW_MANY
+  };
+
+  static constexpr size_t s_MAX_KEYS         = 128;
+  static constexpr size_t s_MAX_INSTRUCTIONS = 64;
+  static constexpr size_t s_MAX_CONSTANTS    = 32;
+  static constexpr size_t s_MAX_STACK        = 16;
+  static constexpr size_t s_MAX_DIGITS       = 15;  // Significant digits of a number, as the display
+  static constexpr size_t s_LANES            = 64;  // Values evaluated together by the batch
+
+  Expression( void );
+
+  bool        compile       ( const Key*, size_t, const Decimal* = nullptr );
+  bool        compile       ( const char* );
+  double      evaluate      ( double = 0.0 ) const;
+  void        evaluate      ( const double*, double*, size_t ) const;
+  bool        evaluateExact ( Decimal& ) const;
+  void        SetMemo       ( DecimalMemo* );
+
+  bool        IsValid       ( void ) const;
+  bool        UsesInput     ( void ) const;
+  size_t      GetLength     ( void ) const;
+  const char* GetError      ( void ) const;
+
+private:
+
+  enum class OpCode : Uint8
+  {
+    CONSTANT = 0,
+    INPUT,
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE,
+    POWER,
+    ADD_CONSTANT,       // The right operand is a constant, not on the stack
+    SUBTRACT_CONSTANT,
+    MULTIPLY_CONSTANT,
+    DIVIDE_CONSTANT,
+    POWER_CONSTANT,
+    NEGATE,
+    PERCENT
+  };
+
+  struct Instruction
+  {
+    OpCode Op;
+    Uint8  Constant;  // Index into m_Constants, for CONSTANT and the *_CONSTANT forms
+  };
+
+  static double Apply_Pvt( OpCode, double, double );
+
+  Decimal ApplyExact_Pvt ( OpCode, const Decimal&, const Decimal& );
+  bool    Fail_Pvt       ( const char* );
+  bool    EmitValue_Pvt  ( OpCode, const Decimal& );
+  bool    EmitUnary_Pvt  ( OpCode );
+  bool    EmitBinary_Pvt ( OpCode );
+  bool    Emit_Pvt       ( OpCode, size_t );
+
+  std::array<Instruction, s_MAX_INSTRUCTIONS> m_Code;
+  std::array<double, s_MAX_CONSTANTS>         m_Constants;
+  std::array<Decimal, s_MAX_CONSTANTS>        m_Exact;      // The same constants, exactly
+  DecimalMemo*  m_Memo_Ptr;       // Used by the folding; may be nullptr
+  size_t        m_Length;         // Instructions in m_Code
+  size_t        m_NumOfConstants;
+  size_t        m_Depth;          // Stack while compiling
+  size_t        m_MaxDepth;       // Stack needed by the code
+  bool          m_UsesInput;
+  const char*   m_Error;          // nullptr once compiled successfully
+};
+
+#endif // EXPRESSION_HPP
@@ -0,0 +1,527 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "FrameProfiler.hpp"
+#include "Supervisor.hpp"
+#include "colours.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const char* SectionNames[] = { "Wait", "Input", "Update", "Render", "Present" };
+
+static_assert( sizeof(SectionNames) / sizeof(SectionNames[0]) == static_cast<size_t>( FrameProfiler::Section::HOW_MANY ),
+               "A name is needed for each section" );
+
+static const char* CounterNames[] = { "DrawCalls", "TextureBinds", "BlendChanges", "TargetSwitches", "Uploaded_B" };
+
+static_assert( sizeof(CounterNames) / sizeof(CounterNames[0]) == static_cast<size_t>( FrameProfiler::Counter::HOW_MANY ),
+               "A name is needed for each counter" );
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+FrameProfiler::ScopedTimer::ScopedTimer( Section Timed_Section )
+  : m_Section(Timed_Section), m_Start(SDL_GetPerformanceCounter())
+{;}
+
+
+FrameProfiler::ScopedTimer::~ScopedTimer( void )
+{
+  Supervisor::Get().GetProfiler().AddSample( m_Section, m_Start, SDL_GetPerformanceCounter() );
+}
+
+
+FrameProfiler::FrameProfiler( void )
+  : m_NextFrame(0), m_NumOfFrames(0), m_IsFrameOpen(false), m_IsOverlayVisible(false),
+    m_Frequency(SDL_GetPerformanceFrequency()), m_FirstStart(0), m_LastTexture(nullptr),
+    m_LastBlendMode(SDL_BLENDMODE_INVALID), m_LastTarget(nullptr)
+{
+  m_Counts.fill( 0 );
+}
+
+
+/**
+ * @brief Call at the top of the main loop.
+ **/
+void FrameProfiler::BeginFrame( void )
+{
+  FrameSample& Current = m_History[m_NextFrame];
+
+  Current.Start    = SDL_GetPerformanceCounter();
+  Current.Duration = 0;
+  Current.SectionStart.fill( 0 );
+  Current.SectionDuration.fill( 0 );
+
+  if ( m_NumOfFrames == 0 )
+  {
+    m_FirstStart = Current.Start;
+  }
+  else
+  {;}
+
+  m_IsFrameOpen = true;
+}
+
+
+/**
+ * @brief Call at the bottom of the main loop. The frame becomes part of the statistics.
+ **/
+void FrameProfiler::EndFrame( void )
+{
+  if ( !m_IsFrameOpen )
+  {
+    return;
+  }
+  else
+  {;}
+
+  FrameSample& Current = m_History[m_NextFrame];
+  Current.Duration = SDL_GetPerformanceCounter() - Current.Start;
+  Current.Counts   = m_Counts;
+
+  m_Counts.fill( 0 );
+
+  m_NextFrame   = ( m_NextFrame + 1 ) % s_HISTORY_LENGTH;
+  m_NumOfFrames = std::min( m_NumOfFrames + 1, s_HISTORY_LENGTH );
+  m_IsFrameOpen = false;
+}
+
+
+/**
+ * @brief Adds a timed interval to a section of the current frame. Intervals outside a frame are
+ * ignored.
+ *
+ * @param Timed_Section
+ * @param Start Performance counter at the start of the interval.
+ * @param End Performance counter at the end of the interval.
+ **/
+void FrameProfiler::AddSample( Section Timed_Section, Uint64 Start, Uint64 End )
+{
+  if ( !m_IsFrameOpen )
+  {
+    return;
+  }
+  else
+  {;}
+
+  FrameSample& Current = m_History[m_NextFrame];
+  size_t const Index   = static_cast<size_t>( Timed_Section );
+
+  if ( Current.SectionDuration[Index] == 0 )
+  {
+    Current.SectionStart[Index] = Start;
+  }
+  else
+  {;}
+
+  Current.SectionDuration[Index] += End - Start;
+}
+
+
+/**
+ * @brief Busy frame time at a given percentile, over the frames in the ring buffer.
+ *
+ * @param Percentile From 0 to 100.
+ * @return double Milliseconds; 0 if no frame has been recorded yet.
+ **/
+double FrameProfiler::GetPercentile_ms( double Percentile )
+{
+  if ( m_NumOfFrames == 0 )
+  {
+    return 0.0;
+  }
+  else
+  {;}
+
+  for ( size_t i = 0; i != m_NumOfFrames; ++i )
+  {
+    m_Scratch[i] = GetBusyTime_Pvt( m_History[i] );
+  }
+
+  size_t Rank = static_cast<size_t>( Percentile / 100.0 * static_cast<double>( m_NumOfFrames - 1 ) + 0.5 );
+  Rank = std::min( Rank, m_NumOfFrames - 1 );
+
+  std::nth_element( m_Scratch.begin(), m_Scratch.begin() + static_cast<std::ptrdiff_t>( Rank ), m_Scratch.begin() + static_cast<std::ptrdiff_t>( m_NumOfFrames ) );
+
+  return ToMilliseconds_Pvt( m_Scratch[Rank] );
+}
+
+
+void FrameProfiler::SetOverlayVisible( bool IsVisible )
+{
+  m_IsOverlayVisible = IsVisible;
+}
+
+
+bool FrameProfiler::IsOverlayVisible( void ) const
+{
+  return m_IsOverlayVisible;
+}
+
+
+/**
+ * @brief Draws the busy time of the recorded frames as a bar graph, oldest on the left, with the
+ * p50 (green) and p99 (red) levels as horizontal lines. A full-height bar is "s_OVERLAY_RANGE_ms".
+ *
+ * @param Renderer_Ptr
+ * @param x Left edge of the overlay.
+ * @param y Top edge of the overlay.
+ **/
+void FrameProfiler::DrawOverlay( SDL_Renderer* Renderer_Ptr, int x, int y )
+{
+  if ( !m_IsOverlayVisible )
+  {
+    return;
+  }
+  else
+  {;}
+
+  auto ToHeight = [] ( double Time_ms )
+  {
+    return static_cast<int>( std::min( Time_ms / s_OVERLAY_RANGE_ms, 1.0 ) * s_OVERLAY_H_px );
+  };
+
+  const int      Bottom = y + s_OVERLAY_H_px;
+  const SDL_Rect Background{ x, y, static_cast<int>( s_HISTORY_LENGTH ), s_OVERLAY_H_px };
+
+  SDL_SetRenderDrawColor( Renderer_Ptr, BLACK_R, BLACK_G, BLACK_B, ALPHA_MAX );
+  SDL_RenderFillRect( Renderer_Ptr, &Background );
+
+  const size_t Oldest = ( m_NumOfFrames == s_HISTORY_LENGTH ) ? m_NextFrame : 0;
+
+  for ( size_t i = 0; i != m_NumOfFrames; ++i )
+  {
+    const int Height = ToHeight( ToMilliseconds_Pvt( GetBusyTime_Pvt( m_History[( Oldest + i ) % s_HISTORY_LENGTH] ) ) );
+    m_OverlayBars[i] = SDL_Rect{ x + static_cast<int>( i ), Bottom - Height, 1, Height };
+  }
+
+  SDL_SetRenderDrawColor( Renderer_Ptr, YELLOW_R, YELLOW_G, YELLOW_B, ALPHA_MAX );
+  SDL_RenderFillRects( Renderer_Ptr, m_OverlayBars.data(), static_cast<int>( m_NumOfFrames ) );
+
+  const int p50 = Bottom - ToHeight( GetPercentile_ms( 50.0 ) );
+  const int p99 = Bottom - ToHeight( GetPercentile_ms( 99.0 ) );
+
+  SDL_SetRenderDrawColor( Renderer_Ptr, GREEN_R, GREEN_G, GREEN_B, ALPHA_MAX );
+  SDL_RenderDrawLine( Renderer_Ptr, x, p50, x + Background.w - 1, p50 );
+
+  SDL_SetRenderDrawColor( Renderer_Ptr, RED_R, RED_G, RED_B, ALPHA_MAX );
+  SDL_RenderDrawLine( Renderer_Ptr, x, p99, x + Background.w - 1, p99 );
+}
+
+
+/**
+ * @brief Writes a one-line summary of the frame times, e.g. for the window title.
+ *
+ * @param Buffer Destination.
+ * @param Size Size of the destination, terminator included.
+ **/
+void FrameProfiler::FormatSummary( char* Buffer, size_t Size )
+{
+  snprintf( Buffer, Size, "p50 %.2f ms | p99 %.2f ms", GetPercentile_ms( 50.0 ), GetPercentile_ms( 99.0 ) );
+}
+
+
+/**
+ * @brief Counts draw calls, and the texture bind and blend mode change they need when their state
+ * differs from the previous draw's. Call it next to the SDL_Render call.
+ *
+ * @param Renderer_Ptr Renderer drawn with; its draw blend mode applies to untextured draws.
+ * @param Texture_Ptr Texture sampled, or NULL for fills, lines and points.
+ * @param Calls Draw calls made with this same state.
+ **/
+void FrameProfiler::CountDraw( SDL_Renderer* Renderer_Ptr, SDL_Texture* Texture_Ptr, int Calls )
+{
+  SDL_BlendMode BlendMode = SDL_BLENDMODE_NONE;
+
+  if ( Texture_Ptr != NULL )
+  {
+    SDL_GetTextureBlendMode( Texture_Ptr, &BlendMode );
+
+    if ( Texture_Ptr != m_LastTexture )
+    {
+      ++m_Counts[static_cast<size_t>( Counter::TEXTURE_BINDS )];
+    }
+    else
+    {;}
+  }
+  else
+  {
+    SDL_GetRenderDrawBlendMode( Renderer_Ptr, &BlendMode );
+  }
+
+  if ( BlendMode != m_LastBlendMode )
+  {
+    ++m_Counts[static_cast<size_t>( Counter::BLEND_CHANGES )];
+  }
+  else
+  {;}
+
+  m_Counts[static_cast<size_t>( Counter::DRAW_CALLS )] += static_cast<Uint64>( Calls );
+  m_LastTexture   = Texture_Ptr;
+  m_LastBlendMode = BlendMode;
+}
+
+
+/**
+ * @brief Counts a render target switch, unless the target is already the current one.
+ *
+ * @param Target_Ptr New target, or NULL for the window.
+ **/
+void FrameProfiler::CountTargetSwitch( SDL_Texture* Target_Ptr )
+{
+  if ( Target_Ptr != m_LastTarget )
+  {
+    ++m_Counts[static_cast<size_t>( Counter::TARGET_SWITCHES )];
+    m_LastTarget = Target_Ptr;
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Counts the bytes of pixels sent to a texture.
+ **/
+void FrameProfiler::CountUpload( size_t Size_B )
+{
+  m_Counts[static_cast<size_t>( Counter::UPLOADED_BYTES )] += static_cast<Uint64>( Size_B );
+}
+
+
+/**
+ * @brief A counter of the last whole frame.
+ *
+ * @return Uint64 0 if no frame has been recorded yet.
+ **/
+Uint64 FrameProfiler::GetLastCount( Counter Which ) const
+{
+  if ( m_NumOfFrames == 0 )
+  {
+    return 0;
+  }
+  else
+  {;}
+
+  const size_t Last = ( m_NextFrame + s_HISTORY_LENGTH - 1 ) % s_HISTORY_LENGTH;
+
+  return m_History[Last].Counts[static_cast<size_t>( Which )];
+}
+
+
+/**
+ * @brief The busy time of the last whole frame, i.e. without the wait for events.
+ *
+ * @return double 0 if no frame has been recorded yet.
+ **/
+double FrameProfiler::GetLastBusy_ms( void ) const
+{
+  if ( m_NumOfFrames == 0 )
+  {
+    return 0.0;
+  }
+  else
+  {;}
+
+  const size_t Last = ( m_NextFrame + s_HISTORY_LENGTH - 1 ) % s_HISTORY_LENGTH;
+
+  return ToMilliseconds_Pvt( GetBusyTime_Pvt( m_History[Last] ) );
+}
+
+
+/**
+ * @brief Writes the counters of the last whole frame on one line, e.g. for the window title.
+ *
+ * @param Buffer Destination.
+ * @param Size Size of the destination, terminator included.
+ **/
+void FrameProfiler::FormatCounters( char* Buffer, size_t Size ) const
+{
+  snprintf( Buffer, Size, "%llu draws, %llu binds, %llu blends, %llu targets, %llu KiB up",
+            static_cast<unsigned long long>( GetLastCount( Counter::DRAW_CALLS      ) ),
+            static_cast<unsigned long long>( GetLastCount( Counter::TEXTURE_BINDS   ) ),
+            static_cast<unsigned long long>( GetLastCount( Counter::BLEND_CHANGES   ) ),
+            static_cast<unsigned long long>( GetLastCount( Counter::TARGET_SWITCHES ) ),
+            static_cast<unsigned long long>( GetLastCount( Counter::UPLOADED_BYTES  ) / 1024 ) );
+}
+
+
+/**
+ * @brief Enables the CSV dump at exit.
+ **/
+void FrameProfiler::SetCSVPath( const std::string& Path )
+{
+  m_CSVPath = Path;
+}
+
+
+/**
+ * @brief Enables the Chrome trace (chrome://tracing, Perfetto) dump at exit.
+ **/
+void FrameProfiler::SetChromeTracePath( const std::string& Path )
+{
+  m_ChromeTracePath = Path;
+}
+
+
+/**
+ * @brief Writes the traces which have been enabled.
+ **/
+void FrameProfiler::SaveTraces( void )
+{
+  if ( !m_CSVPath.empty() && !SaveCSV_Pvt( m_CSVPath ) )
+  {
+    Supervisor::Get().PrintMessage( "Could not write the CSV frame trace to \"" + m_CSVPath + "\".", Supervisor::FaultLevel::WARNING );
+  }
+  else
+  {;}
+
+  if ( !m_ChromeTracePath.empty() && !SaveChromeTrace_Pvt( m_ChromeTracePath ) )
+  {
+    Supervisor::Get().PrintMessage( "Could not write the Chrome trace to \"" + m_ChromeTracePath + "\".", Supervisor::FaultLevel::WARNING );
+  }
+  else
+  {;}
+}
+
+
+double FrameProfiler::ToMilliseconds_Pvt( Uint64 Ticks ) const
+{
+  return static_cast<double>( Ticks ) * 1000.0 / static_cast<double>( m_Frequency );
+}
+
+
+Uint64 FrameProfiler::GetBusyTime_Pvt( const FrameSample& Sample ) const
+{
+  const Uint64 Wait = Sample.SectionDuration[static_cast<size_t>( Section::WAIT )];
+
+  return ( Sample.Duration > Wait ) ? Sample.Duration - Wait : 0;
+}
+
+
+/**
+ * @brief One row per frame, oldest first: frame start and duration, then the time of each section,
+ * all in milliseconds, then the render counters.
+ **/
+bool FrameProfiler::SaveCSV_Pvt( const std::string& Path ) const
+{
+  FILE* File = fopen( Path.c_str(), "w" );
+
+  if ( File == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  fprintf( File, "Frame,Start_ms,Frame_ms,Busy_ms" );
+
+  for ( const char* Name : SectionNames )
+  {
+    fprintf( File, ",%s_ms", Name );
+  }
+
+  for ( const char* Name : CounterNames )
+  {
+    fprintf( File, ",%s", Name );
+  }
+
+  fprintf( File, "\n" );
+
+  const size_t Oldest = ( m_NumOfFrames == s_HISTORY_LENGTH ) ? m_NextFrame : 0;
+
+  for ( size_t i = 0; i != m_NumOfFrames; ++i )
+  {
+    const FrameSample& Sample = m_History[( Oldest + i ) % s_HISTORY_LENGTH];
+
+    fprintf( File, "%zu,%.4f,%.4f,%.4f", i, ToMilliseconds_Pvt( Sample.Start - m_FirstStart ),
+             ToMilliseconds_Pvt( Sample.Duration ), ToMilliseconds_Pvt( GetBusyTime_Pvt( Sample ) ) );
+
+    for ( Uint64 Duration : Sample.SectionDuration )
+    {
+      fprintf( File, ",%.4f", ToMilliseconds_Pvt( Duration ) );
+    }
+
+    for ( Uint64 Count : Sample.Counts )
+    {
+      fprintf( File, ",%llu", static_cast<unsigned long long>( Count ) );
+    }
+
+    fprintf( File, "\n" );
+  }
+
+  return fclose( File ) == 0;
+}
+
+
+/**
+ * @brief Chrome trace event format: one complete ("X") event per frame and per section, with the
+ * sections starting at their first marker, and one counter ("C") event per frame and per render
+ * counter, each counter drawn as its own track.
+ **/
+bool FrameProfiler::SaveChromeTrace_Pvt( const std::string& Path ) const
+{
+  FILE* File = fopen( Path.c_str(), "w" );
+
+  if ( File == NULL )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  auto ToMicroseconds = [this] ( Uint64 Ticks ) { return ToMilliseconds_Pvt( Ticks ) * 1000.0; };
+
+  bool IsFirst = true;
+
+  auto WriteEvent = [&] ( const char* Name, Uint64 Start, Uint64 Duration )
+  {
+    fprintf( File, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+             IsFirst ? "" : ",", Name, ToMicroseconds( Start - m_FirstStart ), ToMicroseconds( Duration ) );
+    IsFirst = false;
+  };
+
+  auto WriteCounter = [&] ( const char* Name, Uint64 Start, Uint64 Value )
+  {
+    fprintf( File, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"value\":%llu}}",
+             Name, ToMicroseconds( Start - m_FirstStart ), static_cast<unsigned long long>( Value ) );
+  };
+
+  fprintf( File, "[" );
+
+  const size_t Oldest = ( m_NumOfFrames == s_HISTORY_LENGTH ) ? m_NextFrame : 0;
+
+  for ( size_t i = 0; i != m_NumOfFrames; ++i )
+  {
+    const FrameSample& Sample = m_History[( Oldest + i ) % s_HISTORY_LENGTH];
+
+    WriteEvent( "Frame", Sample.Start, Sample.Duration );
+
+    for ( size_t Index = 0; Index != s_NUM_OF_SECTIONS; ++Index )
+    {
+      if ( Sample.SectionDuration[Index] != 0 )
+      {
+        WriteEvent( SectionNames[Index], Sample.SectionStart[Index], Sample.SectionDuration[Index] );
+      }
+      else
+      {;}
+    }
+
+    for ( size_t Index = 0; Index != s_NUM_OF_COUNTERS; ++Index )
+    {
+      WriteCounter( CounterNames[Index], Sample.Start, Sample.Counts[Index] );
+    }
+  }
+
+  fprintf( File, "\n]\n" );
+
+  return fclose( File ) == 0;
+}
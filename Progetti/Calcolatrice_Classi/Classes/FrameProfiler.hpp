@@ -0,0 +1,134 @@
+/**
+ * @file FrameProfiler.hpp
+ *
+ * @brief Per-frame timing and render-submission instrumentation. Owned by the Supervisor.
+ **/
+
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <SDL.h>
+#include <array>
+#include <string>
+
+/**
+ * @brief Collects how long each section of the main loop takes, for the last "s_HISTORY_LENGTH"
+ * frames. Sections are timed with "ScopedTimer" markers between "BeginFrame" and "EndFrame". The
+ * time spent blocked waiting for events is tracked separately, so that an idle UI does not look
+ * like a slow one: percentiles are computed on the busy time, i.e. frame time minus wait time.
+ * The traces saved at exit contain the frames still held in the ring buffer.
+ *
+ * Each frame also holds what the rendering wrappers submitted: draw calls, texture binds and blend
+ * mode changes (a draw whose texture or blend mode differs from the previous draw's), render target
+ * switches and bytes uploaded to textures. SDL tells none of this, so the wrappers report it through
+ * "CountDraw", "CountTargetSwitch" and "CountUpload"; the overlay's own draws are left out. Work done
+ * between two frames, e.g. the uploads of the start-up, goes to the next frame.
+ **/
+class FrameProfiler
+{
+public:
+
+  enum class Section
+  {
+    WAIT = 0, // Blocked waiting for events
+    INPUT,
+    UPDATE,
+    RENDER,
+    PRESENT,
+
+    HOW_MANY
+  };
+
+  enum class Counter
+  {
+    DRAW_CALLS = 0,  // Copies, geometry and fills submitted to the renderer
+    TEXTURE_BINDS,   // Draws sampling another texture than the previous draw
+    BLEND_CHANGES,   // Draws with another blend mode than the previous draw
+    TARGET_SWITCHES,
+    UPLOADED_BYTES,
+
+    HOW_MANY
+  };
+
+  /**
+   * @brief Times the enclosing scope and adds it to a section of the current frame.
+   **/
+  class ScopedTimer
+  {
+  public:
+
+     ScopedTimer( Section );
+    ~ScopedTimer( void );
+
+    ScopedTimer( const ScopedTimer& ) = delete;
+    ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+  private:
+
+    Section m_Section;
+    Uint64  m_Start;
+  };
+
+  FrameProfiler( void );
+
+  void   BeginFrame    ( void );
+  void   EndFrame      ( void );
+  void   AddSample     ( Section, Uint64, Uint64 );
+
+  double GetPercentile_ms ( double );
+  void   SetOverlayVisible( bool );
+  bool   IsOverlayVisible ( void ) const;
+  void   DrawOverlay      ( SDL_Renderer*, int, int );
+  void   FormatSummary    ( char*, size_t );
+
+  void   CountDraw        ( SDL_Renderer*, SDL_Texture*, int = 1 );
+  void   CountTargetSwitch( SDL_Texture* );
+  void   CountUpload      ( size_t );
+  Uint64 GetLastCount     ( Counter ) const;
+  double GetLastBusy_ms   ( void ) const;
+  void   FormatCounters   ( char*, size_t ) const;
+
+  void   SetCSVPath        ( const std::string& );
+  void   SetChromeTracePath( const std::string& );
+  void   SaveTraces        ( void );
+
+private:
+
+  static constexpr size_t s_HISTORY_LENGTH   = 256; // Frames kept in the ring buffer
+  static constexpr size_t s_NUM_OF_SECTIONS  = static_cast<size_t>( Section::HOW_MANY );
+  static constexpr size_t s_NUM_OF_COUNTERS  = static_cast<size_t>( Counter::HOW_MANY );
+  static constexpr int    s_OVERLAY_H_px     = 100;
+  static constexpr double s_OVERLAY_RANGE_ms = 33.3; // Busy time drawn as a full-height bar
+
+  struct FrameSample
+  {
+    Uint64 Start;                                     // Performance counter at BeginFrame
+    Uint64 Duration;                                  // Whole frame, in counter ticks
+    std::array<Uint64, s_NUM_OF_SECTIONS> SectionStart;    // First marker of each section
+    std::array<Uint64, s_NUM_OF_SECTIONS> SectionDuration; // Sum of the markers of each section
+    std::array<Uint64, s_NUM_OF_COUNTERS> Counts;
+  };
+
+  double ToMilliseconds_Pvt( Uint64 ) const;
+  Uint64 GetBusyTime_Pvt   ( const FrameSample& ) const;
+  bool   SaveCSV_Pvt       ( const std::string& ) const;
+  bool   SaveChromeTrace_Pvt( const std::string& ) const;
+
+  std::array<FrameSample, s_HISTORY_LENGTH> m_History;
+  std::array<Uint64, s_HISTORY_LENGTH>      m_Scratch;     // Sorting space for the percentiles
+  std::array<SDL_Rect, s_HISTORY_LENGTH>    m_OverlayBars;
+  std::array<Uint64, s_NUM_OF_COUNTERS>     m_Counts;      // Since the previous EndFrame
+  size_t        m_NextFrame;     // Ring buffer slot of the frame being measured
+  size_t        m_NumOfFrames;   // Valid slots, up to s_HISTORY_LENGTH
+  bool          m_IsFrameOpen;
+  bool          m_IsOverlayVisible;
+  Uint64        m_Frequency;     // Performance counter ticks per second
+  Uint64        m_FirstStart;    // Start of the first recorded frame, origin of the traces
+  SDL_Texture*  m_LastTexture;   // State of the previous draw, to tell binds and blend changes
+  SDL_BlendMode m_LastBlendMode;
+  SDL_Texture*  m_LastTarget;    // NULL for the window
+  std::string   m_CSVPath;
+  std::string   m_ChromeTracePath;
+};
+
+#endif // FRAMEPROFILER_HPP
@@ -14,13 +14,16 @@ GenericGraphicElement::GenericGraphicElement(void)
 void GenericGraphicElement::setClip(const SDL_Rect& Clip)
 {
   m_Clip_Rect = Clip;
+
+  MarkDirty();
 }
 
 
 /**
- * @brief Renders current button sprite.
+ * @brief Queues the element's sprite into the renderer's sprite batch.
  **/
 void GenericGraphicElement::render(void)
 {
-  Renderer::Get().GetSpriteSheet().render( m_CurrentPosition_pt.x, m_CurrentPosition_pt.y, &m_Clip_Rect );
+  Renderer::Get().GetSpriteBatch().add( Renderer::Get().GetSpriteSheet(), m_Clip_Rect,
+                                        SDL_Rect{ m_CurrentPosition_pt.x, m_CurrentPosition_pt.y, m_Clip_Rect.w, m_Clip_Rect.h } );
 }
@@ -0,0 +1,12 @@
+#include "GraphicGroup.hpp"
+
+
+GraphicGroup::GraphicGroup(void)
+{;}
+
+
+/**
+ * @brief A group has no sprite of its own: its children are drawn by renderSubtree.
+ **/
+void GraphicGroup::render(void)
+{;}
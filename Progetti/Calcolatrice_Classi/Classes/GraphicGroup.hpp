@@ -0,0 +1,22 @@
+#ifndef GRAPHICGROUP_HPP
+#define GRAPHICGROUP_HPP
+
+#include <SDL.h>
+#include "AbstractGraphicElement.hpp"
+
+/**
+ * @brief This class represents a group of graphic elements, e.g. the keypad: it draws nothing, and
+ * its position is the origin of its children, which move with it.
+ **/
+class GraphicGroup : public AbstractGraphicElement
+{
+private:
+
+public:
+
+  GraphicGroup(void);
+
+  virtual void render ( void ) override;
+};
+
+#endif // GRAPHICGROUP_HPP
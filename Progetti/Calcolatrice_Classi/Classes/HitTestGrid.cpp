@@ -0,0 +1,154 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "HitTestGrid.hpp"
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+HitTestGrid::HitTestGrid( void )
+  : m_Columns(0), m_Rows(0), m_CellSize_px(s_DEFAULT_CELL_SIZE_px)
+{;}
+
+
+/**
+ * @brief Removes all the elements. "build" has to be called again before querying.
+ **/
+void HitTestGrid::clear( void )
+{
+  m_Entries.clear();
+  m_CellStart.clear();
+  m_CellEntries.clear();
+  m_Columns = 0;
+  m_Rows    = 0;
+}
+
+
+/**
+ * @brief Adds a clickable element. Elements inserted later are considered on top of the previous
+ * ones.
+ *
+ * @param Bounds The area covered by the element.
+ * @param Target The element which will receive the events.
+ **/
+void HitTestGrid::insert( const SDL_Rect& Bounds, I_Clickable* Target )
+{
+  m_Entries.push_back( Entry{ Bounds, Target } );
+}
+
+
+/**
+ * @brief Distributes the inserted elements into the cells. Call it after all the elements have been
+ * inserted and whenever any of them is moved or resized.
+ *
+ * @param Width_px Width of the area covered by the grid.
+ * @param Height_px Height of the area covered by the grid.
+ * @param CellSize_px Side of a cell.
+ **/
+void HitTestGrid::build( int Width_px, int Height_px, int CellSize_px )
+{
+  m_CellSize_px = ( CellSize_px > 0 ) ? CellSize_px : s_DEFAULT_CELL_SIZE_px;
+  m_Columns     = ( Width_px  + m_CellSize_px - 1 ) / m_CellSize_px;
+  m_Rows        = ( Height_px + m_CellSize_px - 1 ) / m_CellSize_px;
+
+  const size_t NumOfCells = static_cast<size_t>( m_Columns * m_Rows );
+
+  m_CellStart.assign( NumOfCells + 1, 0 );
+
+  // Visits the cells overlapped by an element, clamped to the grid
+  auto ForEachCell = [this]( const SDL_Rect& Bounds, auto&& Visit )
+  {
+    const int FirstCol = SDL_max( 0            , Bounds.x                / m_CellSize_px );
+    const int LastCol  = SDL_min( m_Columns - 1, ( Bounds.x + Bounds.w ) / m_CellSize_px );
+    const int FirstRow = SDL_max( 0            , Bounds.y                / m_CellSize_px );
+    const int LastRow  = SDL_min( m_Rows - 1   , ( Bounds.y + Bounds.h ) / m_CellSize_px );
+
+    for ( int Row = FirstRow; Row <= LastRow; ++Row )
+    {
+      for ( int Col = FirstCol; Col <= LastCol; ++Col )
+      {
+        Visit( static_cast<size_t>( Row * m_Columns + Col ) );
+      }
+    }
+  };
+
+  /* First pass: count the entries of each cell */
+
+  for ( const auto& CurrentEntry : m_Entries )
+  {
+    ForEachCell( CurrentEntry.Bounds, [this]( size_t Cell ) { ++m_CellStart[Cell + 1]; } );
+  }
+
+  for ( size_t Cell = 0; Cell != NumOfCells; ++Cell )
+  {
+    m_CellStart[Cell + 1] += m_CellStart[Cell];
+  }
+
+  /* Second pass: fill the cells, preserving insertion order */
+
+  m_CellEntries.assign( m_CellStart[NumOfCells], 0 );
+
+  std::vector<size_t> FillPosition( m_CellStart.begin(), m_CellStart.end() - 1 );
+
+  for ( size_t i = 0; i != m_Entries.size(); ++i )
+  {
+    ForEachCell( m_Entries[i].Bounds, [&]( size_t Cell ) { m_CellEntries[FillPosition[Cell]++] = i; } );
+  }
+}
+
+
+/**
+ * @brief Finds the topmost element containing a point.
+ *
+ * @param x
+ * @param y
+ * @return I_Clickable* The element under the point, or nullptr if there is none.
+ **/
+I_Clickable* HitTestGrid::query( int x, int y ) const
+{
+  if ( x < 0 || y < 0 || m_Columns == 0 || m_Rows == 0 )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  const int Col = x / m_CellSize_px;
+  const int Row = y / m_CellSize_px;
+
+  if ( Col >= m_Columns || Row >= m_Rows )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  const size_t Cell = static_cast<size_t>( Row * m_Columns + Col );
+
+  // Walk backwards: the last inserted element is on top
+  for ( size_t i = m_CellStart[Cell + 1]; i != m_CellStart[Cell]; --i )
+  {
+    const Entry& Candidate = m_Entries[m_CellEntries[i - 1]];
+
+    if ( IsInside_Pvt( Candidate.Bounds, x, y ) )
+    {
+      return Candidate.Target;
+    }
+    else
+    {;}
+  }
+
+  return nullptr;
+}
+
+
+/**
+ * @brief Same convention as the buttons: the right and bottom edges belong to the element.
+ **/
+bool HitTestGrid::IsInside_Pvt( const SDL_Rect& Bounds, int x, int y ) const
+{
+  return x >= Bounds.x && x <= Bounds.x + Bounds.w && y >= Bounds.y && y <= Bounds.y + Bounds.h;
+}
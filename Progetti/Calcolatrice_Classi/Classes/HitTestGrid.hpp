@@ -0,0 +1,51 @@
+/**
+ * @file HitTestGrid.hpp
+ *
+ * @brief Uniform grid used to find the clickable element under a point.
+ **/
+
+#ifndef HITTESTGRID_HPP
+#define HITTESTGRID_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "I_Clickable.hpp"
+
+/**
+ * @brief Spatial index over the bounds of the clickable elements. The covered area is split into
+ * square cells, each one listing the elements overlapping it, so that a query only tests the few
+ * elements sharing the cell of the point. Cells are stored contiguously: the entries of cell "i"
+ * are m_CellEntries[m_CellStart[i]] ... m_CellEntries[m_CellStart[i + 1] - 1].
+ **/
+class HitTestGrid
+{
+public:
+
+  HitTestGrid( void );
+
+  void         clear ( void );
+  void         insert( const SDL_Rect&, I_Clickable* );
+  void         build ( int, int, int = s_DEFAULT_CELL_SIZE_px );
+  I_Clickable* query ( int, int ) const;
+
+private:
+
+  struct Entry
+  {
+    SDL_Rect     Bounds;
+    I_Clickable* Target;
+  };
+
+  static constexpr int s_DEFAULT_CELL_SIZE_px = 50;
+
+  bool IsInside_Pvt( const SDL_Rect&, int, int ) const;
+
+  std::vector<Entry>  m_Entries;     // In insertion (i.e. drawing) order
+  std::vector<size_t> m_CellStart;   // Begin of each cell in m_CellEntries, plus one past the end
+  std::vector<size_t> m_CellEntries; // Indices into m_Entries
+  int                 m_Columns;
+  int                 m_Rows;
+  int                 m_CellSize_px;
+};
+
+#endif // HITTESTGRID_HPP
@@ -3,9 +3,10 @@
 ****************************************************************************************************/
 
 #include "InputManager.hpp"
-#include "Supervisor.hpp" // TODO: test fault
+#include "Supervisor.hpp"
 #include "Renderer.hpp"
 
+#include <array>
 #include <iostream>
 #include <cstdio>
 
@@ -13,6 +14,105 @@
 * Private constants
 ****************************************************************************************************/
 
+// A button is pressed as the key of the same index
+static_assert( static_cast<int>( Expression::Key::KEY_PERCENT ) == static_cast<int>( Renderer::ButtonsClips_Enum::KEY_PERCENT ) &&
+               static_cast<int>( Expression::Key::KEY_INPUT )   == static_cast<int>( Renderer::ButtonsClips_Enum::HOW_MANY ),
+               "Expression::Key must follow the order of Renderer::ButtonsClips_Enum" );
+
+static_assert( Calculator::s_DISPLAY_LENGTH <= SegmentDisplay::s_CELLS, "The display text must fit the display" );
+
+static constexpr Sint8 NO_BUTTON = -1;
+
+using Buttons = Renderer::ButtonsClips_Enum;
+
+/* Button of each key, looked up directly by keycode: the character keys by their ASCII code, the
+   keypad and the function keys by their scancode. A character that needs Shift on the keyboard layout
+   (e.g. '+' on a US keyboard) is typed with the keypad. */
+
+static constexpr std::array<Sint8, 128> CharacterButtons = []()
+{
+  std::array<Sint8, 128> Table{};
+
+  for ( Sint8& Entry : Table ) // std::array::fill is not constexpr before C++20
+  {
+    Entry = NO_BUTTON;
+  }
+
+  for ( int Digit = 0; Digit != 10; ++Digit )
+  {
+    Table[static_cast<size_t>( '0' + Digit )] = static_cast<Sint8>( Digit );
+  }
+
+  Table['+']            = static_cast<Sint8>( Buttons::KEY_PLUS );
+  Table['-']            = static_cast<Sint8>( Buttons::KEY_MINUS );
+  Table['*']            = static_cast<Sint8>( Buttons::KEY_MULTIPLY );
+  Table['/']            = static_cast<Sint8>( Buttons::KEY_DIVIDE );
+  Table['.']            = static_cast<Sint8>( Buttons::KEY_POINT );
+  Table[',']            = static_cast<Sint8>( Buttons::KEY_POINT );
+  Table['=']            = static_cast<Sint8>( Buttons::KEY_EQUALS );
+  Table['\r']           = static_cast<Sint8>( Buttons::KEY_EQUALS );
+  Table['^']            = static_cast<Sint8>( Buttons::KEY_POWER );
+  Table['%']            = static_cast<Sint8>( Buttons::KEY_PERCENT );
+  Table['\b']           = static_cast<Sint8>( Buttons::KEY_DEL );
+  Table[SDLK_DELETE]    = static_cast<Sint8>( Buttons::KEY_DEL );
+
+  return Table;
+}();
+
+static constexpr std::array<Sint8, SDL_NUM_SCANCODES> ScancodeButtons = []()
+{
+  std::array<Sint8, SDL_NUM_SCANCODES> Table{};
+
+  for ( Sint8& Entry : Table ) // std::array::fill is not constexpr before C++20
+  {
+    Entry = NO_BUTTON;
+  }
+
+  Table[SDL_SCANCODE_KP_0]        = static_cast<Sint8>( Buttons::KEY_0 );
+  for ( int Digit = 1; Digit != 10; ++Digit ) // KP_1 ... KP_9 are consecutive, KP_0 follows them
+  {
+    Table[static_cast<size_t>( SDL_SCANCODE_KP_1 + Digit - 1 )] = static_cast<Sint8>( Digit );
+  }
+
+  Table[SDL_SCANCODE_KP_PLUS]     = static_cast<Sint8>( Buttons::KEY_PLUS );
+  Table[SDL_SCANCODE_KP_MINUS]    = static_cast<Sint8>( Buttons::KEY_MINUS );
+  Table[SDL_SCANCODE_KP_MULTIPLY] = static_cast<Sint8>( Buttons::KEY_MULTIPLY );
+  Table[SDL_SCANCODE_KP_DIVIDE]   = static_cast<Sint8>( Buttons::KEY_DIVIDE );
+  Table[SDL_SCANCODE_KP_PERIOD]   = static_cast<Sint8>( Buttons::KEY_POINT );
+  Table[SDL_SCANCODE_KP_COMMA]    = static_cast<Sint8>( Buttons::KEY_POINT );
+  Table[SDL_SCANCODE_KP_ENTER]    = static_cast<Sint8>( Buttons::KEY_EQUALS );
+  Table[SDL_SCANCODE_KP_EQUALS]   = static_cast<Sint8>( Buttons::KEY_EQUALS );
+  Table[SDL_SCANCODE_KP_POWER]    = static_cast<Sint8>( Buttons::KEY_POWER );
+  Table[SDL_SCANCODE_KP_PERCENT]  = static_cast<Sint8>( Buttons::KEY_PERCENT );
+  Table[SDL_SCANCODE_F9]          = static_cast<Sint8>( Buttons::KEY_SIGN ); // As most desktop calculators
+
+  return Table;
+}();
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief The button of a key, or NO_BUTTON. Two array reads, whatever the key.
+ **/
+static Sint8 ButtonOfKey( SDL_Keycode Code )
+{
+  if ( Code >= 0 && Code < static_cast<SDL_Keycode>( CharacterButtons.size() ) )
+  {
+    return CharacterButtons[static_cast<size_t>( Code )];
+  }
+  else if ( ( Code & SDLK_SCANCODE_MASK ) != 0 && ( Code & ~SDLK_SCANCODE_MASK ) < SDL_NUM_SCANCODES )
+  {
+    return ScancodeButtons[static_cast<size_t>( Code & ~SDLK_SCANCODE_MASK )];
+  }
+  else
+  {
+    return NO_BUTTON;
+  }
+}
+
 
 /***************************************************************************************************
 * Methods
@@ -21,6 +121,10 @@
 InputManager::InputManager( void )
 {
   std::cout << "\nInitialising Input Manager...\n";
+
+  // Only the events handled below are queued from now on
+  SDL_SetEventFilter( FilterEvent_Pvt, nullptr );
+
   std::cout << "\tOK: Input Manager initialised.\n";
 }
 
@@ -28,53 +132,282 @@ InputManager::InputManager( void )
 InputManager::~InputManager( void )
 {
   std::cout << "InputManager's destructor called\n";
+
+  SDL_SetEventFilter( nullptr, nullptr );
+}
+
+
+/**
+ * @brief Processes the pending events, up to s_MAX_EVENTS_PER_FRAME. In idle mode, when the renderer
+ * has nothing left to draw, it blocks until an event arrives or the next scheduled wake-up is due,
+ * so that no CPU time is spent while the UI is static.
+ **/
+void InputManager::ManageInput( void )
+{
+  if ( m_IsIdleModeEnabled && !Renderer::Get().HasPendingChanges() )
+  {
+    int HasEvent;
+
+    {
+      FrameProfiler::ScopedTimer Timer( FrameProfiler::Section::WAIT ); // Not counted as busy time
+      HasEvent = SDL_WaitEventTimeout( &m_Event, static_cast<int>( GetIdleTimeout_Pvt() ) );
+    }
+
+    if ( HasEvent != 0 )
+    {
+      HandleEvent_Pvt();
+    }
+    else
+    {;} // Timed out: a wake-up may be due
+  }
+  else
+  {;}
+
+  for ( int Handled = 0; Handled != s_MAX_EVENTS_PER_FRAME && SDL_PollEvent( &m_Event ) != 0; ++Handled )
+  {
+    HandleEvent_Pvt();
+  }
+
+  if ( m_IsWakeUpScheduled && SDL_TICKS_PASSED( SDL_GetTicks(), m_WakeUpTime_ms ) )
+  {
+    m_IsWakeUpScheduled = false;
+  }
+  else
+  {;}
 }
 
 
 /**
- * @brief Creates instance of singleton in static memory
+ * @brief Enables or disables blocking waits for events. Disable it to run the main loop at full
+ * speed, e.g. while an animation is playing.
+ **/
+void InputManager::SetIdleMode( bool IsEnabled )
+{
+  m_IsIdleModeEnabled = IsEnabled;
+}
+
+
+/**
+ * @brief Makes sure that the main loop wakes up after a given delay, even if no event arrives.
+ * Whoever schedules the wake-up is responsible for marking as dirty what has to be redrawn.
  *
- * @return InputManager&
+ * @param Delay_ms Delay after which ManageInput has to return.
  **/
-InputManager& InputManager::Get(void)
+void InputManager::ScheduleWakeUp( Uint32 Delay_ms )
 {
-  static InputManager Instance;
-  return Instance;
+  Uint32 const Requested_ms = SDL_GetTicks() + Delay_ms;
+
+  if ( !m_IsWakeUpScheduled || SDL_TICKS_PASSED( m_WakeUpTime_ms, Requested_ms ) )
+  {
+    m_WakeUpTime_ms     = Requested_ms; // Keep the earliest one
+    m_IsWakeUpScheduled = true;
+  }
+  else
+  {;}
 }
 
 
-void InputManager::ManageInput( void )
+/**
+ * @brief How long ManageInput may block waiting for the next event.
+ **/
+Uint32 InputManager::GetIdleTimeout_Pvt( void ) const
 {
-  while( SDL_PollEvent( &m_Event ) != 0 )
+  Uint32 Timeout_ms = s_MAX_IDLE_WAIT_ms;
+
+  if ( m_IsWakeUpScheduled )
   {
-    if ( m_Event.type == SDL_QUIT )
+    Uint32 const Now_ms = SDL_GetTicks();
+
+    if ( SDL_TICKS_PASSED( Now_ms, m_WakeUpTime_ms ) )
     {
-      m_WasQuitRequested = true;
+      Timeout_ms = 0;
     }
-    else if ( m_Event.type == SDL_KEYDOWN ) // User presses a key
+    else if ( m_WakeUpTime_ms - Now_ms < Timeout_ms )
     {
-      switch( m_Event.key.keysym.sym )
-      {
-        case SDLK_UP: // TODO: test fault
-          Supervisor::Get().RaiseFault();
-          break;
-
-        default:
-          break;
-      }
+      Timeout_ms = m_WakeUpTime_ms - Now_ms;
     }
     else
-    { /* User did not request to quit the program. */ }
+    {;}
+  }
+  else
+  {;}
+
+  return Timeout_ms;
+}
 
-    /* Handle button events */
 
-    size_t NumOfButtons(static_cast<size_t>(Renderer::ButtonsClips_Enum::HOW_MANY));
+/**
+ * @brief The SDL event filter: keeps (1) the events HandleEvent_Pvt handles, those the renderer
+ * watches (window, display and render resets) and those of the application's life cycle, drops (0)
+ * the others as they are queued. It may be called on any thread.
+ **/
+int SDLCALL InputManager::FilterEvent_Pvt( void*, SDL_Event* Event_Ptr )
+{
+  switch ( Event_Ptr->type )
+  {
+    case SDL_QUIT:
+    case SDL_APP_TERMINATING:
+    case SDL_APP_LOWMEMORY:
+    case SDL_APP_WILLENTERBACKGROUND:
+    case SDL_APP_DIDENTERBACKGROUND:
+    case SDL_APP_WILLENTERFOREGROUND:
+    case SDL_APP_DIDENTERFOREGROUND:
+    case SDL_DISPLAYEVENT:
+    case SDL_WINDOWEVENT:
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+    case SDL_RENDER_TARGETS_RESET:
+    case SDL_RENDER_DEVICE_RESET:
+      return 1;
 
-    for ( size_t i = 0; i != NumOfButtons; ++i )
+    default:
+      return 0; // Mouse motion and wheel, text input, joysticks...
+  }
+}
+
+
+/**
+ * @brief Dispatches the event currently stored in m_Event.
+ **/
+void InputManager::HandleEvent_Pvt( void )
+{
+  if ( m_Event.type == SDL_QUIT )
+  {
+    m_WasQuitRequested = true;
+  }
+  else if ( ( m_Event.type == SDL_KEYDOWN || m_Event.type == SDL_KEYUP ) && ButtonOfKey( m_Event.key.keysym.sym ) != NO_BUTTON )
+  {
+    HandleKey_Pvt(); // A key of the calculator
+  }
+  else if ( m_Event.type == SDL_KEYDOWN ) // User presses a key
+  {
+    switch( m_Event.key.keysym.sym )
     {
-      Renderer::Get().GetButtonVector()[ i ].handleMouseEvent( &m_Event );
+      case SDLK_UP: // TODO: test fault
+        Supervisor::Get().RaiseFault();
+        break;
+
+      case SDLK_F3: // Frame-time overlay
+        Supervisor::Get().GetProfiler().SetOverlayVisible( !Supervisor::Get().GetProfiler().IsOverlayVisible() );
+        Renderer::Get().Invalidate(); // Remove it from the screen
+        break;
+
+      default:
+        break;
     }
   }
+  else if ( m_Event.type == SDL_RENDER_TARGETS_RESET || m_Event.type == SDL_RENDER_DEVICE_RESET ||
+          ( m_Event.type == SDL_WINDOWEVENT && m_Event.window.event == SDL_WINDOWEVENT_EXPOSED ) )
+  {
+    Renderer::Get().Invalidate(); // Window content or canvas was lost
+  }
+  else
+  { /* User did not request to quit the program. */ }
+
+  /* Handle button events */
+
+  if ( m_Event.type == SDL_MOUSEBUTTONDOWN || m_Event.type == SDL_MOUSEBUTTONUP )
+  {
+    DispatchMouse_Pvt();
+  }
+  else
+  {;} // Buttons only react to clicks
+}
+
+
+/**
+ * @brief Forwards a mouse button event only to the element under the cursor, found through the
+ * renderer's hit-test grid. The element which received the previous click gets the event as well,
+ * so that it can be released when the mouse has moved away from it. A button released where it was
+ * pressed is a key for the calculator.
+ **/
+void InputManager::DispatchMouse_Pvt( void )
+{
+  I_Clickable* Target_Ptr = Renderer::Get().GetHitTestGrid().query( m_Event.button.x, m_Event.button.y );
+
+  if ( m_Event.type == SDL_MOUSEBUTTONUP && Target_Ptr != nullptr && Target_Ptr == m_LastClicked_Ptr )
+  {
+    PressButton_Pvt( Target_Ptr );
+  }
+  else
+  {;}
+
+  if ( m_LastClicked_Ptr != nullptr && m_LastClicked_Ptr != Target_Ptr )
+  {
+    m_LastClicked_Ptr->handleMouseEvent( &m_Event );
+  }
+  else
+  {;}
+
+  if ( Target_Ptr != nullptr )
+  {
+    Target_Ptr->handleMouseEvent( &m_Event );
+  }
+  else
+  {;}
+
+  m_LastClicked_Ptr = Target_Ptr;
+}
+
+
+/**
+ * @brief Passes the key of a clicked button to the calculator. The hit-test grid only indexes the
+ * buttons, so the key is the position of the button in the renderer's vector.
+ **/
+void InputManager::PressButton_Pvt( const I_Clickable* Clicked_Ptr )
+{
+  const std::vector<Button>& ButtonVector = Renderer::Get().GetButtonVector();
+  const Button*              Clicked      = static_cast<const Button*>( Clicked_Ptr );
+
+  if ( !ButtonVector.empty() && Clicked >= ButtonVector.data() && Clicked < ButtonVector.data() + ButtonVector.size() )
+  {
+    PressKey_Pvt( static_cast<Expression::Key>( Clicked - ButtonVector.data() ) );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Presses or releases the button of a calculator key on the keyboard: the button is shown
+ * pressed, and the calculator gets the key, in the frame of the event. Repeats of a key held down
+ * are ignored, as on the real keypad.
+ **/
+void InputManager::HandleKey_Pvt( void )
+{
+  const size_t         Index        = static_cast<size_t>( ButtonOfKey( m_Event.key.keysym.sym ) );
+  std::vector<Button>& ButtonVector = Renderer::Get().GetButtonVector();
+
+  if ( Index >= ButtonVector.size() )
+  {
+    return; // No graphic elements yet
+  }
+  else
+  {;}
+
+  if ( m_Event.type == SDL_KEYUP )
+  {
+    ButtonVector[Index].setPressed( false );
+  }
+  else if ( m_Event.key.repeat == 0 )
+  {
+    ButtonVector[Index].setPressed( true );
+    PressKey_Pvt( static_cast<Expression::Key>( Index ) );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Passes a key to the calculator, and its display text to the display.
+ **/
+void InputManager::PressKey_Pvt( Expression::Key Pressed )
+{
+  m_Calculator.press( Pressed );
+  Renderer::Get().GetSegmentDisplay().setText( m_Calculator.GetDisplayText() );
 }
 
 
@@ -8,9 +8,16 @@
 #define INPUTMANAGER_HPP
 
 #include <SDL.h>
+#include "I_Clickable.hpp"
+#include "Calculator.hpp"
+#include "ServiceRegistry.hpp"
 
 /**
  * @brief Singleton input manager class.
+ *
+ * While it exists an SDL event filter keeps out of the queue the events nobody handles, mouse
+ * motion first: a high-rate mouse would queue hundreds per frame, and wake the idle wait for each.
+ * A frame handles at most s_MAX_EVENTS_PER_FRAME events, the others wait for the next one.
  **/
 class InputManager
 {
@@ -22,20 +29,42 @@ public:
   InputManager& operator=( const InputManager&  ) = delete;
   InputManager& operator=(       InputManager&& ) = delete;
 
-  static InputManager& Get( void );
+  static InputManager& Get( void ) { return Service<InputManager>::Get(); } // Created by the ServiceRegistry in main
 
   void ManageInput      ( void );
   bool WasInitSuccessful( void );
   bool WasQuitRequested ( void );
+  void SetIdleMode      ( bool );
+  void ScheduleWakeUp   ( Uint32 );
 
 private:
 
+  friend class ServiceSlot<InputManager>;
+
    InputManager( void );
   ~InputManager( void );
 
+  void   HandleEvent_Pvt    ( void );
+  void   DispatchMouse_Pvt  ( void );
+  void   PressButton_Pvt    ( const I_Clickable* );
+  void   PressKey_Pvt       ( Expression::Key );
+  void   HandleKey_Pvt      ( void );
+  Uint32 GetIdleTimeout_Pvt ( void ) const;
+
+  static int SDLCALL FilterEvent_Pvt( void*, SDL_Event* );
+
+  static constexpr Uint32 s_MAX_IDLE_WAIT_ms     = 1000; // Upper bound to a single blocking wait
+  static constexpr int    s_MAX_EVENTS_PER_FRAME = 64;   // Upper bound to the events handled by ManageInput
+
   bool      m_WasInitSuccessful;
   bool      m_WasQuitRequested;
+  bool      m_IsIdleModeEnabled = true;  // Block waiting for events when nothing has to be drawn
+  bool      m_IsWakeUpScheduled = false;
+  Uint32    m_WakeUpTime_ms     = 0;     // When the scheduled wake-up is due (SDL ticks)
   SDL_Event m_Event;
+
+  I_Clickable* m_LastClicked_Ptr = nullptr; // Receives the next mouse event too, to be released
+  Calculator   m_Calculator;              // Gets the keys of the buttons released
 };
 
 #endif // INPUTMANAGER_HPP
\ No newline at end of file
@@ -0,0 +1,237 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "LogQueue.hpp"
+#include "AllocationTracker.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static constexpr Uint32 IDLE_WAIT_ms = 100; // Upper bound on the latency of a missed wake-up
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief Starts the background thread. Nothing is allocated after this point.
+ **/
+LogQueue::LogQueue( void )
+  : m_EnqueuePos(0), m_DequeuePos(0), m_Dropped(0), m_IsDrainerIdle(false), m_IsQuitting(false),
+    m_WakeUp(SDL_CreateSemaphore(0)), m_Drainer(NULL)
+{
+  for ( size_t i = 0; i != s_CAPACITY; ++i )
+  {
+    m_Slots[i].Sequence.store( i, std::memory_order_relaxed );
+  }
+
+  if ( m_WakeUp != NULL )
+  {
+    m_Drainer = SDL_CreateThread( Drainer_Pvt, "LogDrainer", this );
+  }
+  else
+  {;}
+
+  if ( m_Drainer == NULL )
+  {
+    printf( "\nLog thread could not be created, messages are written synchronously. SDL Error: %s", SDL_GetError() );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Writes the pending records and stops the background thread.
+ **/
+LogQueue::~LogQueue( void )
+{
+  if ( m_Drainer != NULL )
+  {
+    m_IsQuitting.store( true );
+    SDL_SemPost( m_WakeUp );
+    SDL_WaitThread( m_Drainer, NULL );
+  }
+  else
+  {;}
+
+  SDL_DestroySemaphore( m_WakeUp );
+}
+
+
+/**
+ * @brief Queues a record. Never blocks and never allocates; safe to call from any thread.
+ *
+ * @param Text The record, already formatted.
+ * @param IsError true to write it to stderr; false for stdout.
+ * @return true if the record was queued (or written); false if it was dropped because the ring is
+ * full.
+ **/
+bool LogQueue::push( const char* Text, bool IsError )
+{
+  if ( m_Drainer == NULL )
+  {
+    Write_Pvt( Text, IsError );
+    return true;
+  }
+  else
+  {;}
+
+  size_t Position = m_EnqueuePos.load( std::memory_order_relaxed );
+  Slot*  Slot_Ptr = nullptr;
+
+  for (;;)
+  {
+    Slot_Ptr = &m_Slots[Position & ( s_CAPACITY - 1 )];
+
+    const size_t    Sequence   = Slot_Ptr->Sequence.load( std::memory_order_acquire );
+    const ptrdiff_t Difference = static_cast<ptrdiff_t>( Sequence ) - static_cast<ptrdiff_t>( Position );
+
+    if ( Difference == 0 )
+    {
+      if ( m_EnqueuePos.compare_exchange_weak( Position, Position + 1, std::memory_order_relaxed ) )
+      {
+        break; // Slot claimed
+      }
+      else
+      {;} // Another producer got there first: "Position" has been reloaded
+    }
+    else if ( Difference < 0 )
+    {
+      m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+      return false; // The drainer is a whole ring behind
+    }
+    else
+    {
+      Position = m_EnqueuePos.load( std::memory_order_relaxed );
+    }
+  }
+
+  strncpy( Slot_Ptr->Text, Text, s_RECORD_LENGTH - 1 );
+  Slot_Ptr->Text[s_RECORD_LENGTH - 1] = '\0';
+  Slot_Ptr->IsError = IsError;
+  Slot_Ptr->Sequence.store( Position + 1, std::memory_order_release );
+
+  if ( m_IsDrainerIdle.exchange( false ) )
+  {
+    SDL_SemPost( m_WakeUp );
+  }
+  else
+  {;} // Already awake: it will find the record
+
+  return true;
+}
+
+
+/**
+ * @brief Waits until every record queued so far has been written. Must not be called by the
+ * background thread.
+ **/
+void LogQueue::flush( void )
+{
+  if ( m_Drainer == NULL )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const size_t Target = m_EnqueuePos.load();
+
+  m_IsDrainerIdle.store( false );
+  SDL_SemPost( m_WakeUp );
+
+  while ( m_DequeuePos.load() < Target )
+  {
+    SDL_Delay( 1 );
+  }
+}
+
+
+/**
+ * @brief Background thread: writes the records as they arrive and sleeps while the ring is empty.
+ **/
+int LogQueue::Drainer_Pvt( void* Data )
+{
+  LogQueue* This = static_cast<LogQueue*>( Data );
+
+  AllocationTracker::ScopedTag Tag( AllocationTracker::Tag::LOGGING ); // For the whole thread
+
+  for (;;)
+  {
+    while ( This->Pop_Pvt() )
+    {;}
+
+    const unsigned Dropped = This->m_Dropped.exchange( 0 );
+
+    if ( Dropped != 0 )
+    {
+      fprintf( stderr, "\nSupervisor WARNING: %u log messages were dropped.", Dropped );
+    }
+    else
+    {;}
+
+    fflush( stdout );
+    fflush( stderr );
+
+    if ( This->m_IsQuitting.load() )
+    {
+      while ( This->Pop_Pvt() ) // Records pushed while quitting
+      {;}
+
+      break;
+    }
+    else
+    {;}
+
+    This->m_IsDrainerIdle.store( true );
+
+    if ( !This->Pop_Pvt() ) // A record may have been pushed just before going idle
+    {
+      SDL_SemWaitTimeout( This->m_WakeUp, IDLE_WAIT_ms );
+    }
+    else
+    {;}
+
+    This->m_IsDrainerIdle.store( false );
+  }
+
+  return 0;
+}
+
+
+/**
+ * @brief Writes the oldest record, if it has been completely pushed.
+ **/
+bool LogQueue::Pop_Pvt( void )
+{
+  const size_t Position = m_DequeuePos.load( std::memory_order_relaxed );
+  Slot&        Current  = m_Slots[Position & ( s_CAPACITY - 1 )];
+
+  if ( Current.Sequence.load( std::memory_order_acquire ) != Position + 1 )
+  {
+    return false;
+  }
+  else
+  {;}
+
+  Write_Pvt( Current.Text, Current.IsError );
+
+  Current.Sequence.store( Position + s_CAPACITY, std::memory_order_release ); // Free for the next lap
+  m_DequeuePos.store( Position + 1 );
+
+  return true;
+}
+
+
+void LogQueue::Write_Pvt( const char* Text, bool IsError )
+{
+  fputs( Text, IsError ? stderr : stdout );
+}
@@ -0,0 +1,73 @@
+/**
+ * @file LogQueue.hpp
+ *
+ * @brief Fixed-capacity, lock-free queue of log records, drained by a background thread.
+ **/
+
+#ifndef LOGQUEUE_HPP
+#define LOGQUEUE_HPP
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Multi-producer, single-consumer ring of pre-formatted records. Any thread can "push"
+ * without locking or allocating; a background thread writes the records to stdout / stderr, so
+ * that callers never wait for the console. When the ring is full, records are dropped and counted
+ * rather than blocking the caller. If the background thread cannot be started, records are
+ * written right away by the calling thread.
+ **/
+class LogQueue
+{
+public:
+
+  static constexpr size_t s_RECORD_LENGTH = 256; // Longer records are truncated
+
+   LogQueue( void );
+  ~LogQueue( void );
+
+  LogQueue( const LogQueue&  ) = delete;
+  LogQueue(       LogQueue&& ) = delete;
+
+  LogQueue& operator=( const LogQueue&  ) = delete;
+  LogQueue& operator=(       LogQueue&& ) = delete;
+
+  bool push ( const char*, bool );
+  void flush( void );
+
+private:
+
+  static constexpr size_t s_CAPACITY = 256; // Must be a power of 2
+
+  static_assert( ( s_CAPACITY & ( s_CAPACITY - 1 ) ) == 0, "Capacity must be a power of 2" );
+
+  /**
+   * @brief A record and its position in the ring. "Sequence" tells whether the slot is free for
+   * the producer claiming position "Sequence", or holds the record of position "Sequence - 1".
+   **/
+  struct Slot
+  {
+    std::atomic<size_t> Sequence;
+    bool                IsError;
+    char                Text[s_RECORD_LENGTH];
+  };
+
+  static int Drainer_Pvt( void* );
+
+  bool Pop_Pvt  ( void );
+  void Write_Pvt( const char*, bool );
+
+  std::array<Slot, s_CAPACITY> m_Slots;
+  std::atomic<size_t>          m_EnqueuePos;       // Next position claimed by a producer
+  std::atomic<size_t>          m_DequeuePos;       // Next position written by the drainer
+  std::atomic<unsigned>        m_Dropped;          // Records lost because the ring was full
+  std::atomic<bool>            m_IsDrainerIdle;    // The drainer is about to sleep on m_WakeUp
+  std::atomic<bool>            m_IsQuitting;
+  SDL_sem*                     m_WakeUp;
+  SDL_Thread*                  m_Drainer;
+};
+
+#endif // LOGQUEUE_HPP
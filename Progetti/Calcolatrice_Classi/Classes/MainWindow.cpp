@@ -29,7 +29,7 @@ MainWindow::MainWindow(void)
   {
     printf( "\nInitialising Main Window...\n" );
 
-    m_Window = SDL_CreateWindow( "Handheld Calculator"   ,
+    m_Window = SDL_CreateWindow( s_WINDOW_TITLE         ,
                                   SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
                                   s_WINDOW_W             , s_WINDOW_H             ,
                                   SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI );
@@ -58,18 +58,6 @@ MainWindow::~MainWindow(void)
 {;}
 
 
-/**
- * @brief Creates instance of singleton in static memory
- *
- * @return MainWindow&
- **/
-MainWindow& MainWindow::Get(void)
-{
-  static MainWindow Instance;
-  return Instance;
-}
-
-
 SDL_Window* MainWindow::GetSDLWindowPtr(void)
 {
   return m_Window;
@@ -88,6 +76,12 @@ int MainWindow::GetWindowHeight(void)
 }
 
 
+const char* MainWindow::GetTitle(void)
+{
+  return s_WINDOW_TITLE;
+}
+
+
 void MainWindow::DestroyWindow(void)
 {
   printf( "\nDestroying Main Window...\n" );
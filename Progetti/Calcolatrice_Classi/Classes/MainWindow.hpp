@@ -8,6 +8,7 @@
 #define MAINWINDOW_HPP
 
 #include <SDL.h>
+#include "ServiceRegistry.hpp"
 
 /**
  * @brief Singleton main window class.
@@ -22,22 +23,27 @@ class MainWindow
   MainWindow& operator=( const MainWindow&  ) = delete;
   MainWindow& operator=(       MainWindow&& ) = delete;
 
-  static MainWindow& Get( void );
+  static MainWindow& Get( void ) { return Service<MainWindow>::Get(); } // Created by the ServiceRegistry in main
 
   SDL_Window* GetSDLWindowPtr  ( void );
   bool        WasInitSuccessful( void );
   int         GetWindowWidth   ( void );
   int         GetWindowHeight  ( void );
+  const char* GetTitle         ( void );
   void        DestroyWindow    ( void );
 
   private:
 
+  friend class ServiceSlot<MainWindow>;
+
    MainWindow( void );
   ~MainWindow( void );
 
   static constexpr int s_WINDOW_W = 600;
   static constexpr int s_WINDOW_H = 800;
 
+  static constexpr const char* s_WINDOW_TITLE = "Handheld Calculator";
+
   SDL_Window* m_Window;
   bool        m_WasInitSuccessful;
 };
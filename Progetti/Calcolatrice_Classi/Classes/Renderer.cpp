@@ -2,11 +2,11 @@
 * Includes
 ****************************************************************************************************/
 
-#include <sstream>
 #include <cstdio>
 #include "MainWindow.hpp"
 #include "Supervisor.hpp"
 #include "Renderer.hpp"
+#include "TextureCache.hpp"
 #include "colours.hpp"
 
 
@@ -14,213 +14,25 @@
 * Private constants
 ****************************************************************************************************/
 
-static std::stringstream Msg;
-
 static const char* AllComponents_Path  ("./Sprites/AllComponents_800x750.png");
+static const char* AtlasBinary_Path    ("./Sprites/AllComponents_800x750.atlas");
+static const char* AtlasText_Path      ("./Sprites/AllComponents_800x750.atlas.txt");
+
+static constexpr int    FIRST_ONE_AVAILABLE    = -1;
+static constexpr Uint32 TITLE_UPDATE_PERIOD_ms = 1000;
 
-static constexpr int FIRST_ONE_AVAILABLE = -1;
-
-static constexpr int ScaleFactor = 1; // Used if the sprite sheet is upscaled
-
-/* Various sizes */
-
-static constexpr int NormalButtonW_px(100 / ScaleFactor);
-static constexpr int NormalButtonH_px( 80 / ScaleFactor);
-
-static constexpr int KeyPlusW_px(100 / ScaleFactor);
-static constexpr int KeyPlusH_px(180 / ScaleFactor);
-
-static constexpr int SolarCellW_px(100 / ScaleFactor);
-static constexpr int SolarCellH_px( 50 / ScaleFactor);
-
-static constexpr int DisplayW_px(425 / ScaleFactor);
-static constexpr int DisplayH_px(125 / ScaleFactor);
-
-/* Positions of rows and columns in pixels in the sprite sheet */
-
-static constexpr int RowHeight_SS_px(100);
-static constexpr int Row0_SS_px     (150);
-static constexpr int Row1_SS_px     (Row0_SS_px + RowHeight_SS_px);
-static constexpr int Row2_SS_px     (Row1_SS_px + RowHeight_SS_px);
-static constexpr int Row3_SS_px     (Row2_SS_px + RowHeight_SS_px);
-static constexpr int Row4_SS_px     (Row3_SS_px + RowHeight_SS_px);
-static constexpr int Row5_SS_px     (Row4_SS_px + RowHeight_SS_px);
-
-static constexpr int ColWidth_SS_px (100);
-static constexpr int OffsetCol_SS_px(400); // Offset to get to the pressed buttons in the sprite sheet
-static constexpr int Col0_SS_px     (0);
-static constexpr int Col1_SS_px     (Col0_SS_px + ColWidth_SS_px);
-static constexpr int Col2_SS_px     (Col1_SS_px + ColWidth_SS_px);
-static constexpr int Col3_SS_px     (Col2_SS_px + ColWidth_SS_px);
-
-static constexpr int Key0_Normal_xSS_px(Col0_SS_px);
-static constexpr int Key0_Normal_ySS_px(Row5_SS_px);
-static constexpr int Key0_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int Key0_Pressed_ySS_px(Row5_SS_px);
-
-static constexpr int KeyPoint_Normal_xSS_px(Col1_SS_px);
-static constexpr int KeyPoint_Normal_ySS_px(Row5_SS_px);
-static constexpr int KeyPoint_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int KeyPoint_Pressed_ySS_px(Row5_SS_px);
-
-static constexpr int KeyEquals_Normal_xSS_px(Col2_SS_px);
-static constexpr int KeyEquals_Normal_ySS_px(Row5_SS_px);
-static constexpr int KeyEquals_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int KeyEquals_Pressed_ySS_px(Row5_SS_px);
-
-static constexpr int Key1_Normal_xSS_px(Col0_SS_px);
-static constexpr int Key1_Normal_ySS_px(Row4_SS_px);
-static constexpr int Key1_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int Key1_Pressed_ySS_px(Row4_SS_px);
-
-static constexpr int Key2_Normal_xSS_px(Col1_SS_px);
-static constexpr int Key2_Normal_ySS_px(Row4_SS_px);
-static constexpr int Key2_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int Key2_Pressed_ySS_px(Row4_SS_px);
-
-static constexpr int Key3_Normal_xSS_px(Col2_SS_px);
-static constexpr int Key3_Normal_ySS_px(Row4_SS_px);
-static constexpr int Key3_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int Key3_Pressed_ySS_px(Row4_SS_px);
-
-static constexpr int Key4_Normal_xSS_px(Col0_SS_px);
-static constexpr int Key4_Normal_ySS_px(Row3_SS_px);
-static constexpr int Key4_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int Key4_Pressed_ySS_px(Row3_SS_px);
-
-static constexpr int Key5_Normal_xSS_px(Col1_SS_px);
-static constexpr int Key5_Normal_ySS_px(Row3_SS_px);
-static constexpr int Key5_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int Key5_Pressed_ySS_px(Row3_SS_px);
-
-static constexpr int Key6_Normal_xSS_px(Col2_SS_px);
-static constexpr int Key6_Normal_ySS_px(Row3_SS_px);
-static constexpr int Key6_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int Key6_Pressed_ySS_px(Row3_SS_px);
-
-static constexpr int Key7_Normal_xSS_px(Col0_SS_px);
-static constexpr int Key7_Normal_ySS_px(Row2_SS_px);
-static constexpr int Key7_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int Key7_Pressed_ySS_px(Row2_SS_px);
-
-static constexpr int Key8_Normal_xSS_px(Col1_SS_px);
-static constexpr int Key8_Normal_ySS_px(Row2_SS_px);
-static constexpr int Key8_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int Key8_Pressed_ySS_px(Row2_SS_px);
-
-static constexpr int Key9_Normal_xSS_px(Col2_SS_px);
-static constexpr int Key9_Normal_ySS_px(Row2_SS_px);
-static constexpr int Key9_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int Key9_Pressed_ySS_px(Row2_SS_px);
-
-static constexpr int KeyMRC_Normal_xSS_px(Col0_SS_px);
-static constexpr int KeyMRC_Normal_ySS_px(Row1_SS_px);
-static constexpr int KeyMRC_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int KeyMRC_Pressed_ySS_px(Row1_SS_px);
-
-static constexpr int KeyMemMinus_Normal_xSS_px(Col1_SS_px);
-static constexpr int KeyMemMinus_Normal_ySS_px(Row1_SS_px);
-static constexpr int KeyMemMinus_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int KeyMemMinus_Pressed_ySS_px(Row1_SS_px);
-
-static constexpr int KeyMemPlus_Normal_xSS_px(Col2_SS_px);
-static constexpr int KeyMemPlus_Normal_ySS_px(Row1_SS_px);
-static constexpr int KeyMemPlus_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int KeyMemPlus_Pressed_ySS_px(Row1_SS_px);
-
-static constexpr int KeyPlus_Normal_xSS_px(Col3_SS_px);
-static constexpr int KeyPlus_Normal_ySS_px(Row4_SS_px);
-static constexpr int KeyPlus_Pressed_xSS_px(Col3_SS_px + OffsetCol_SS_px);
-static constexpr int KeyPlus_Pressed_ySS_px(Row4_SS_px);
-
-static constexpr int KeyMinus_Normal_xSS_px(Col3_SS_px);
-static constexpr int KeyMinus_Normal_ySS_px(Row3_SS_px);
-static constexpr int KeyMinus_Pressed_xSS_px(Col3_SS_px + OffsetCol_SS_px);
-static constexpr int KeyMinus_Pressed_ySS_px(Row3_SS_px);
-
-static constexpr int KeyMult_Normal_xSS_px(Col3_SS_px);
-static constexpr int KeyMult_Normal_ySS_px(Row2_SS_px);
-static constexpr int KeyMult_Pressed_xSS_px(Col3_SS_px + OffsetCol_SS_px);
-static constexpr int KeyMult_Pressed_ySS_px(Row2_SS_px);
-
-static constexpr int KeyDiv_Normal_xSS_px(Col3_SS_px);
-static constexpr int KeyDiv_Normal_ySS_px(Row1_SS_px);
-static constexpr int KeyDiv_Pressed_xSS_px(Col3_SS_px + OffsetCol_SS_px);
-static constexpr int KeyDiv_Pressed_ySS_px(Row1_SS_px);
-
-static constexpr int KeySign_Normal_xSS_px(Col3_SS_px);
-static constexpr int KeySign_Normal_ySS_px(Row0_SS_px);
-static constexpr int KeySign_Pressed_xSS_px(Col3_SS_px + OffsetCol_SS_px);
-static constexpr int KeySign_Pressed_ySS_px(Row0_SS_px);
-
-static constexpr int KeyPower_Normal_xSS_px(Col0_SS_px);
-static constexpr int KeyPower_Normal_ySS_px(Row0_SS_px);
-static constexpr int KeyPower_Pressed_xSS_px(Col0_SS_px + OffsetCol_SS_px);
-static constexpr int KeyPower_Pressed_ySS_px(Row0_SS_px);
-
-static constexpr int KeyDel_Normal_xSS_px(Col1_SS_px);
-static constexpr int KeyDel_Normal_ySS_px(Row0_SS_px);
-static constexpr int KeyDel_Pressed_xSS_px(Col1_SS_px + OffsetCol_SS_px);
-static constexpr int KeyDel_Pressed_ySS_px(Row0_SS_px);
-
-static constexpr int KeyPct_Normal_xSS_px(Col2_SS_px);
-static constexpr int KeyPct_Normal_ySS_px(Row0_SS_px);
-static constexpr int KeyPct_Pressed_xSS_px(Col2_SS_px + OffsetCol_SS_px);
-static constexpr int KeyPct_Pressed_ySS_px(Row0_SS_px);
-
-/* Positions of display and photovoltaic cell in pixels in the sprite sheets */
-
-static constexpr int SolarCell_xSS_px(0 / ScaleFactor);
-static constexpr int SolarCell_ySS_px(0 / ScaleFactor);
-
-static constexpr int Display_xSS_px(110 / ScaleFactor);
-static constexpr int Display_ySS_px(0   / ScaleFactor);
-
-/* Positions of elements in the Main Window (MW) */
-
-static constexpr int RowHeight_MW_px(NormalButtonH_px + 20);
-static constexpr int Row0_MW_px     (200);
-static constexpr int Row1_MW_px     (Row0_MW_px + RowHeight_MW_px);
-static constexpr int Row2_MW_px     (Row1_MW_px + RowHeight_MW_px);
-static constexpr int Row3_MW_px     (Row2_MW_px + RowHeight_MW_px);
-static constexpr int Row4_MW_px     (Row3_MW_px + RowHeight_MW_px);
-static constexpr int Row5_MW_px     (Row4_MW_px + RowHeight_MW_px);
-
-static constexpr int ColWidth_MW_px(NormalButtonW_px + 10);
-static constexpr int Col0_MW_px    (0);
-static constexpr int Col1_MW_px    (Col0_MW_px + ColWidth_MW_px);
-static constexpr int Col2_MW_px    (Col1_MW_px + ColWidth_MW_px);
-static constexpr int Col3_MW_px    (Col2_MW_px + ColWidth_MW_px);
-
-static const SDL_Point Key0_MWPos       {Col0_MW_px, Row5_MW_px};
-static const SDL_Point KeyPoint_MWPos   {Col1_MW_px, Row5_MW_px};
-static const SDL_Point KeyEquals_MWPos  {Col2_MW_px, Row5_MW_px};
-static const SDL_Point Key1_MWPos       {Col0_MW_px, Row4_MW_px};
-static const SDL_Point Key2_MWPos       {Col1_MW_px, Row4_MW_px};
-static const SDL_Point Key3_MWPos       {Col2_MW_px, Row4_MW_px};
-static const SDL_Point Key4_MWPos       {Col0_MW_px, Row3_MW_px};
-static const SDL_Point Key5_MWPos       {Col1_MW_px, Row3_MW_px};
-static const SDL_Point Key6_MWPos       {Col2_MW_px, Row3_MW_px};
-static const SDL_Point Key7_MWPos       {Col0_MW_px, Row2_MW_px};
-static const SDL_Point Key8_MWPos       {Col1_MW_px, Row2_MW_px};
-static const SDL_Point Key9_MWPos       {Col2_MW_px, Row2_MW_px};
-static const SDL_Point KeyMRC_MWPos     {Col0_MW_px, Row1_MW_px};
-static const SDL_Point KeyMemMinus_MWPos{Col1_MW_px, Row1_MW_px};
-static const SDL_Point KeyMemPlus_MWPos {Col2_MW_px, Row1_MW_px};
-static const SDL_Point KeyPlus_MWPos    {Col3_MW_px, Row4_MW_px};
-static const SDL_Point KeyMinus_MWPos   {Col3_MW_px, Row3_MW_px};
-static const SDL_Point KeyMult_MWPos    {Col3_MW_px, Row2_MW_px};
-static const SDL_Point KeyDiv_MWPos     {Col3_MW_px, Row1_MW_px};
-static const SDL_Point KeySign_MWPos    {Col3_MW_px, Row0_MW_px};
-static const SDL_Point KeyPower_MWPos   {Col0_MW_px, Row0_MW_px};
-static const SDL_Point KeyDel_MWPos     {Col1_MW_px, Row0_MW_px};
-static const SDL_Point KeyPct_MWPos     {Col2_MW_px, Row0_MW_px};
-
-static constexpr int SolarCell_xMW_px(5);
-static constexpr int SolarCell_yMW_px(5);
-
-static constexpr int Display_xMW_px(5);
-static constexpr int Display_yMW_px(SolarCell_yMW_px + SolarCellH_px + 5);
+/* Names used in the text atlas. Buttons come first, in the order of ButtonsClips_Enum, followed by
+   the other components, in the order of ComponentsClips_Enum. */
+
+static const std::vector<std::string> AtlasNames
+{
+  "KEY_0", "KEY_1", "KEY_2", "KEY_3", "KEY_4", "KEY_5", "KEY_6", "KEY_7", "KEY_8", "KEY_9",
+  "KEY_MRC", "KEY_MEMMINUS", "KEY_MEMPLUS",
+  "KEY_PLUS", "KEY_MINUS", "KEY_DIVIDE", "KEY_MULTIPLY",
+  "KEY_POINT", "KEY_EQUALS", "KEY_SIGN", "KEY_POWER", "KEY_DEL", "KEY_PERCENT",
+
+  "DISPLAY", "PHOTOVOLTAIC_CELL", "DISPLAY_GLYPHS"
+};
 
 
 /***************************************************************************************************
@@ -228,7 +40,9 @@ static constexpr int Display_yMW_px(SolarCell_yMW_px + SolarCellH_px + 5);
 ****************************************************************************************************/
 
 /**
- * @brief Constructor
+ * @brief Constructor. The sprite sheet and the graphic elements are set afterwards, by the start-up
+ * stages of main, from the image and the atlas loaded meanwhile on other threads; until then the
+ * renderer draws nothing.
  **/
 Renderer::Renderer( void )
 {
@@ -236,9 +50,7 @@ Renderer::Renderer( void )
 
   CreateRenderer_Pvt();
 
-  LoadMedia_Pvt();
-
-  CreateGraphicElements_Pvt();
+  CreateCanvas_Pvt();
 }
 
 
@@ -253,258 +65,243 @@ Renderer::~Renderer(void)
 
 void Renderer::CreateRenderer_Pvt(void)
 {
-  m_Renderer = SDL_CreateRenderer( MainWindow::Get().GetSDLWindowPtr(), FIRST_ONE_AVAILABLE, SDL_RENDERER_ACCELERATED );
+  m_Renderer = SDL_CreateRenderer( MainWindow::Get().GetSDLWindowPtr(), FIRST_ONE_AVAILABLE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE );
 
   if( m_Renderer == NULL )
   {
-    Msg.str(std::string());
-    Msg << "Renderer could not be created! SDL Error: \"" << SDL_GetError()
-        << "\nMainWindow::Get() = " << static_cast<void*>( MainWindow::Get().GetSDLWindowPtr());
     Supervisor::Get().RaiseFault();
-    Supervisor::Get().PrintMessage(Msg.str(), Supervisor::FaultLevel::BLOCKING);
+    Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::BLOCKING, "Renderer could not be created! SDL Error: \"%s\"\nMainWindow::Get() = %p",
+                                     SDL_GetError(), static_cast<void*>( MainWindow::Get().GetSDLWindowPtr()));
   }
   else
   {
-    Msg.str(std::string());
-    Msg << "Renderer created. Address: " << static_cast<void*>( m_Renderer );
-    Supervisor::Get().PrintMessage(Msg.str());
+    Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::NO_FAULT, "Renderer created. Address: %p", static_cast<void*>( m_Renderer ));
   }
 }
 
 
 /**
- * @brief Loads all media needed for this project.
+ * @brief Decodes the sprite sheet. Safe on any thread: it does not touch the renderer.
+ *
+ * @return SDL_Surface* The image, to be passed to "UploadSpriteSheet", or nullptr on failure.
+ **/
+SDL_Surface* Renderer::DecodeSpriteSheet( void )
+{
+  return TextureCache::decode(AllComponents_Path);
+}
+
+
+/**
+ * @brief Uploads the decoded sprite sheet, which is then freed. Called by the main thread, which
+ * owns the renderer. If it fails, the elements are drawn as placeholders.
  **/
-void Renderer::LoadMedia_Pvt( void )
+bool Renderer::UploadSpriteSheet( SDL_Surface* Decoded_Ptr )
 {
-  if ( m_SpriteSheet.loadFromFile(AllComponents_Path, m_Renderer) )
+  m_MediaLoaded = ( Decoded_Ptr != nullptr && m_SpriteSheet.loadFromSurface(AllComponents_Path, Decoded_Ptr, m_Renderer) );
+
+  if ( m_MediaLoaded )
   {
-    Msg.str(std::string());
-    Msg << "Sprite sheet properly created.";
-    Supervisor::Get().PrintMessage(Msg.str());
+    Supervisor::Get().PrintMessage("Sprite sheet properly created.");
   }
   else
   {
-    Msg.str(std::string());
-    Msg << "Sprite sheet could not be loaded!";
-    Supervisor::Get().PrintMessage(Msg.str(), Supervisor::FaultLevel::BLOCKING);
+    Supervisor::Get().PrintMessage("Sprite sheet could not be loaded!", Supervisor::FaultLevel::WARNING);
   }
+
+  SDL_FreeSurface(Decoded_Ptr);
+  Invalidate();
+
+  return m_MediaLoaded;
 }
 
 
-void Renderer::CreateGraphicElements_Pvt(void)
+/**
+ * @brief Loads the sprite atlas, preferring its binary form. Safe on any thread.
+ **/
+bool Renderer::LoadAtlas( SpriteAtlas& Atlas )
 {
-  /* Create Buttons */
+  if ( Atlas.loadFromBinaryFile(AtlasBinary_Path) )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  if ( Atlas.loadFromTextFile(AtlasText_Path, AtlasNames) )
+  {
+    if ( Atlas.saveToBinaryFile(AtlasBinary_Path) )
+    {
+      Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::NO_FAULT, "Text atlas compiled into \"%s\".", AtlasBinary_Path);
+    }
+    else
+    {
+      Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::NO_FAULT, "Text atlas could not be compiled into \"%s\".", AtlasBinary_Path);
+    }
+
+    return true;
+  }
+  else
+  {
+    Supervisor::Get().PrintMessage("Sprite atlas could not be loaded!", Supervisor::FaultLevel::WARNING);
+    return false;
+  }
+}
+
 
+/**
+ * @brief Places the buttons and the other components as described by the atlas.
+ **/
+void Renderer::CreateGraphicElements( const SpriteAtlas& Atlas )
+{
   size_t NumOfCreatedButtons(0);
   size_t NumOfExpectedButtons(static_cast<size_t>(ButtonsClips_Enum::HOW_MANY));
 
+  size_t NumOfCreatedComponents(0);
+  size_t NumOfExpectedComponents(static_cast<size_t>(ComponentsClips_Enum::HOW_MANY));
+
   m_Button_Vec.resize(static_cast<size_t>(ButtonsClips_Enum::HOW_MANY));
 
-  size_t Key0(static_cast<size_t>(ButtonsClips_Enum::KEY_0));
-  m_Button_Vec[Key0].setPosition(Key0_MWPos);
-  m_Button_Vec[Key0].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key0].setClip(SDL_Rect{Key0_Normal_xSS_px , Key0_Normal_ySS_px , m_Button_Vec[Key0].GetWidth(), m_Button_Vec[Key0].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key0].setClip(SDL_Rect{Key0_Pressed_xSS_px, Key0_Pressed_ySS_px, m_Button_Vec[Key0].GetWidth(), m_Button_Vec[Key0].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyPoint(static_cast<size_t>(ButtonsClips_Enum::KEY_POINT));
-  m_Button_Vec[KeyPoint].setPosition(KeyPoint_MWPos);
-  m_Button_Vec[KeyPoint].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyPoint].setClip(SDL_Rect{KeyPoint_Normal_xSS_px , KeyPoint_Normal_ySS_px , m_Button_Vec[KeyPoint].GetWidth(), m_Button_Vec[KeyPoint].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyPoint].setClip(SDL_Rect{KeyPoint_Pressed_xSS_px, KeyPoint_Pressed_ySS_px, m_Button_Vec[KeyPoint].GetWidth(), m_Button_Vec[KeyPoint].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyEquals(static_cast<size_t>(ButtonsClips_Enum::KEY_EQUALS));
-  m_Button_Vec[KeyEquals].setPosition(KeyEquals_MWPos);
-  m_Button_Vec[KeyEquals].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyEquals].setClip(SDL_Rect{KeyEquals_Normal_xSS_px , KeyEquals_Normal_ySS_px , m_Button_Vec[KeyEquals].GetWidth(), m_Button_Vec[KeyEquals].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyEquals].setClip(SDL_Rect{KeyEquals_Pressed_xSS_px, KeyEquals_Pressed_ySS_px, m_Button_Vec[KeyEquals].GetWidth(), m_Button_Vec[KeyEquals].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key1(static_cast<size_t>(ButtonsClips_Enum::KEY_1));
-  m_Button_Vec[Key1].setPosition(Key1_MWPos);
-  m_Button_Vec[Key1].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key1].setClip(SDL_Rect{Key1_Normal_xSS_px , Key1_Normal_ySS_px , m_Button_Vec[Key1].GetWidth(), m_Button_Vec[Key1].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key1].setClip(SDL_Rect{Key1_Pressed_xSS_px, Key1_Pressed_ySS_px, m_Button_Vec[Key1].GetWidth(), m_Button_Vec[Key1].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key2(static_cast<size_t>(ButtonsClips_Enum::KEY_2));
-  m_Button_Vec[Key2].setPosition(Key2_MWPos);
-  m_Button_Vec[Key2].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key2].setClip(SDL_Rect{Key2_Normal_xSS_px , Key2_Normal_ySS_px , m_Button_Vec[Key2].GetWidth(), m_Button_Vec[Key2].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key2].setClip(SDL_Rect{Key2_Pressed_xSS_px, Key2_Pressed_ySS_px, m_Button_Vec[Key2].GetWidth(), m_Button_Vec[Key2].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key3(static_cast<size_t>(ButtonsClips_Enum::KEY_3));
-  m_Button_Vec[Key3].setPosition(Key3_MWPos);
-  m_Button_Vec[Key3].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key3].setClip(SDL_Rect{Key3_Normal_xSS_px , Key3_Normal_ySS_px , m_Button_Vec[Key3].GetWidth(), m_Button_Vec[Key3].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key3].setClip(SDL_Rect{Key3_Pressed_xSS_px, Key3_Pressed_ySS_px, m_Button_Vec[Key3].GetWidth(), m_Button_Vec[Key3].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key4(static_cast<size_t>(ButtonsClips_Enum::KEY_4));
-  m_Button_Vec[Key4].setPosition(Key4_MWPos);
-  m_Button_Vec[Key4].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key4].setClip(SDL_Rect{Key4_Normal_xSS_px , Key4_Normal_ySS_px , m_Button_Vec[Key4].GetWidth(), m_Button_Vec[Key4].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key4].setClip(SDL_Rect{Key4_Pressed_xSS_px, Key4_Pressed_ySS_px, m_Button_Vec[Key4].GetWidth(), m_Button_Vec[Key4].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key5(static_cast<size_t>(ButtonsClips_Enum::KEY_5));
-  m_Button_Vec[Key5].setPosition(Key5_MWPos);
-  m_Button_Vec[Key5].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key5].setClip(SDL_Rect{Key5_Normal_xSS_px , Key5_Normal_ySS_px , m_Button_Vec[Key5].GetWidth(), m_Button_Vec[Key5].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key5].setClip(SDL_Rect{Key5_Pressed_xSS_px, Key5_Pressed_ySS_px, m_Button_Vec[Key5].GetWidth(), m_Button_Vec[Key5].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key6(static_cast<size_t>(ButtonsClips_Enum::KEY_6));
-  m_Button_Vec[Key6].setPosition(Key6_MWPos);
-  m_Button_Vec[Key6].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key6].setClip(SDL_Rect{Key6_Normal_xSS_px , Key6_Normal_ySS_px , m_Button_Vec[Key6].GetWidth(), m_Button_Vec[Key6].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key6].setClip(SDL_Rect{Key6_Pressed_xSS_px, Key6_Pressed_ySS_px, m_Button_Vec[Key6].GetWidth(), m_Button_Vec[Key6].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key7(static_cast<size_t>(ButtonsClips_Enum::KEY_7));
-  m_Button_Vec[Key7].setPosition(Key7_MWPos);
-  m_Button_Vec[Key7].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key7].setClip(SDL_Rect{Key7_Normal_xSS_px , Key7_Normal_ySS_px , m_Button_Vec[Key7].GetWidth(), m_Button_Vec[Key7].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key7].setClip(SDL_Rect{Key7_Pressed_xSS_px, Key7_Pressed_ySS_px, m_Button_Vec[Key7].GetWidth(), m_Button_Vec[Key7].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key8(static_cast<size_t>(ButtonsClips_Enum::KEY_8));
-  m_Button_Vec[Key8].setPosition(Key8_MWPos);
-  m_Button_Vec[Key8].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key8].setClip(SDL_Rect{Key8_Normal_xSS_px , Key8_Normal_ySS_px , m_Button_Vec[Key8].GetWidth(), m_Button_Vec[Key8].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key8].setClip(SDL_Rect{Key8_Pressed_xSS_px, Key8_Pressed_ySS_px, m_Button_Vec[Key8].GetWidth(), m_Button_Vec[Key8].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t Key9(static_cast<size_t>(ButtonsClips_Enum::KEY_9));
-  m_Button_Vec[Key9].setPosition(Key9_MWPos);
-  m_Button_Vec[Key9].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[Key9].setClip(SDL_Rect{Key9_Normal_xSS_px , Key9_Normal_ySS_px , m_Button_Vec[Key9].GetWidth(), m_Button_Vec[Key9].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[Key9].setClip(SDL_Rect{Key9_Pressed_xSS_px, Key9_Pressed_ySS_px, m_Button_Vec[Key9].GetWidth(), m_Button_Vec[Key9].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyMRC(static_cast<size_t>(ButtonsClips_Enum::KEY_MRC));
-  m_Button_Vec[KeyMRC].setPosition(KeyMRC_MWPos);
-  m_Button_Vec[KeyMRC].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyMRC].setClip(SDL_Rect{KeyMRC_Normal_xSS_px , KeyMRC_Normal_ySS_px , m_Button_Vec[KeyMRC].GetWidth(), m_Button_Vec[KeyMRC].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyMRC].setClip(SDL_Rect{KeyMRC_Pressed_xSS_px, KeyMRC_Pressed_ySS_px, m_Button_Vec[KeyMRC].GetWidth(), m_Button_Vec[KeyMRC].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyMemMinus(static_cast<size_t>(ButtonsClips_Enum::KEY_MEMMINUS));
-  m_Button_Vec[KeyMemMinus].setPosition(KeyMemMinus_MWPos);
-  m_Button_Vec[KeyMemMinus].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyMemMinus].setClip(SDL_Rect{KeyMemMinus_Normal_xSS_px , KeyMemMinus_Normal_ySS_px , m_Button_Vec[KeyMemMinus].GetWidth(), m_Button_Vec[KeyMemMinus].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyMemMinus].setClip(SDL_Rect{KeyMemMinus_Pressed_xSS_px, KeyMemMinus_Pressed_ySS_px, m_Button_Vec[KeyMemMinus].GetWidth(), m_Button_Vec[KeyMemMinus].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyMemPlus(static_cast<size_t>(ButtonsClips_Enum::KEY_MEMPLUS));
-  m_Button_Vec[KeyMemPlus].setPosition(KeyMemPlus_MWPos);
-  m_Button_Vec[KeyMemPlus].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyMemPlus].setClip(SDL_Rect{KeyMemPlus_Normal_xSS_px , KeyMemPlus_Normal_ySS_px , m_Button_Vec[KeyMemPlus].GetWidth(), m_Button_Vec[KeyMemPlus].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyMemPlus].setClip(SDL_Rect{KeyMemPlus_Pressed_xSS_px, KeyMemPlus_Pressed_ySS_px, m_Button_Vec[KeyMemPlus].GetWidth(), m_Button_Vec[KeyMemPlus].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyPlus(static_cast<size_t>(ButtonsClips_Enum::KEY_PLUS));
-  m_Button_Vec[KeyPlus].setPosition(KeyPlus_MWPos);
-  m_Button_Vec[KeyPlus].setSize(KeyPlusW_px, KeyPlusH_px);
-  m_Button_Vec[KeyPlus].setClip(SDL_Rect{KeyPlus_Normal_xSS_px , KeyPlus_Normal_ySS_px , m_Button_Vec[KeyPlus].GetWidth(), m_Button_Vec[KeyPlus].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyPlus].setClip(SDL_Rect{KeyPlus_Pressed_xSS_px, KeyPlus_Pressed_ySS_px, m_Button_Vec[KeyPlus].GetWidth(), m_Button_Vec[KeyPlus].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyMinus(static_cast<size_t>(ButtonsClips_Enum::KEY_MINUS));
-  m_Button_Vec[KeyMinus].setPosition(KeyMinus_MWPos);
-  m_Button_Vec[KeyMinus].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyMinus].setClip(SDL_Rect{KeyMinus_Normal_xSS_px , KeyMinus_Normal_ySS_px , m_Button_Vec[KeyMinus].GetWidth(), m_Button_Vec[KeyMinus].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyMinus].setClip(SDL_Rect{KeyMinus_Pressed_xSS_px, KeyMinus_Pressed_ySS_px, m_Button_Vec[KeyMinus].GetWidth(), m_Button_Vec[KeyMinus].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyMult(static_cast<size_t>(ButtonsClips_Enum::KEY_MULTIPLY));
-  m_Button_Vec[KeyMult].setPosition(KeyMult_MWPos);
-  m_Button_Vec[KeyMult].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyMult].setClip(SDL_Rect{KeyMult_Normal_xSS_px , KeyMult_Normal_ySS_px , m_Button_Vec[KeyMult].GetWidth(), m_Button_Vec[KeyMult].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyMult].setClip(SDL_Rect{KeyMult_Pressed_xSS_px, KeyMult_Pressed_ySS_px, m_Button_Vec[KeyMult].GetWidth(), m_Button_Vec[KeyMult].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyDiv(static_cast<size_t>(ButtonsClips_Enum::KEY_DIVIDE));
-  m_Button_Vec[KeyDiv].setPosition(KeyDiv_MWPos);
-  m_Button_Vec[KeyDiv].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyDiv].setClip(SDL_Rect{KeyDiv_Normal_xSS_px , KeyDiv_Normal_ySS_px , m_Button_Vec[KeyDiv].GetWidth(), m_Button_Vec[KeyDiv].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyDiv].setClip(SDL_Rect{KeyDiv_Pressed_xSS_px, KeyDiv_Pressed_ySS_px, m_Button_Vec[KeyDiv].GetWidth(), m_Button_Vec[KeyDiv].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeySign(static_cast<size_t>(ButtonsClips_Enum::KEY_SIGN));
-  m_Button_Vec[KeySign].setPosition(KeySign_MWPos);
-  m_Button_Vec[KeySign].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeySign].setClip(SDL_Rect{KeySign_Normal_xSS_px , KeySign_Normal_ySS_px , m_Button_Vec[KeySign].GetWidth(), m_Button_Vec[KeySign].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeySign].setClip(SDL_Rect{KeySign_Pressed_xSS_px, KeySign_Pressed_ySS_px, m_Button_Vec[KeySign].GetWidth(), m_Button_Vec[KeySign].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyPower(static_cast<size_t>(ButtonsClips_Enum::KEY_POWER));
-  m_Button_Vec[KeyPower].setPosition(KeyPower_MWPos);
-  m_Button_Vec[KeyPower].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyPower].setClip(SDL_Rect{KeyPower_Normal_xSS_px , KeyPower_Normal_ySS_px , m_Button_Vec[KeyPower].GetWidth(), m_Button_Vec[KeyPower].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyPower].setClip(SDL_Rect{KeyPower_Pressed_xSS_px, KeyPower_Pressed_ySS_px, m_Button_Vec[KeyPower].GetWidth(), m_Button_Vec[KeyPower].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyDel(static_cast<size_t>(ButtonsClips_Enum::KEY_DEL));
-  m_Button_Vec[KeyDel].setPosition(KeyDel_MWPos);
-  m_Button_Vec[KeyDel].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyDel].setClip(SDL_Rect{KeyDel_Normal_xSS_px , KeyDel_Normal_ySS_px , m_Button_Vec[KeyDel].GetWidth(), m_Button_Vec[KeyDel].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyDel].setClip(SDL_Rect{KeyDel_Pressed_xSS_px, KeyDel_Pressed_ySS_px, m_Button_Vec[KeyDel].GetWidth(), m_Button_Vec[KeyDel].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
-
-  size_t KeyPct(static_cast<size_t>(ButtonsClips_Enum::KEY_PERCENT));
-  m_Button_Vec[KeyPct].setPosition(KeyPct_MWPos);
-  m_Button_Vec[KeyPct].setSize(NormalButtonW_px, NormalButtonH_px);
-  m_Button_Vec[KeyPct].setClip(SDL_Rect{KeyPct_Normal_xSS_px , KeyPct_Normal_ySS_px , m_Button_Vec[KeyPct].GetWidth(), m_Button_Vec[KeyPct].GetHeight()}, Button::BUTTON_SPRITE_NORMAL);
-  m_Button_Vec[KeyPct].setClip(SDL_Rect{KeyPct_Pressed_xSS_px, KeyPct_Pressed_ySS_px, m_Button_Vec[KeyPct].GetWidth(), m_Button_Vec[KeyPct].GetHeight()}, Button::BUTTON_SPRITE_PRESSED);
-  ++NumOfCreatedButtons;
+  for ( const auto& Entry : Atlas.GetEntries() )
+  {
+    size_t Id(static_cast<size_t>(Entry.Id));
+
+    if ( Id < NumOfExpectedButtons )
+    {
+      /* Create Buttons */
+
+      Button& CurrentButton = m_Button_Vec[Id];
+      CurrentButton.setPosition(Entry.Position);
+      CurrentButton.setSize(Entry.Normal.w, Entry.Normal.h);
+      CurrentButton.setClip(Entry.Normal , Button::BUTTON_SPRITE_NORMAL);
+      CurrentButton.setClip(Entry.Pressed, Button::BUTTON_SPRITE_PRESSED);
+      ++NumOfCreatedButtons;
+    }
+    else if ( Id - NumOfExpectedButtons < NumOfExpectedComponents )
+    {
+      /* Create other components */
+
+      const ComponentsClips_Enum Kind = static_cast<ComponentsClips_Enum>(Id - NumOfExpectedButtons);
+
+      if ( Kind == ComponentsClips_Enum::DISPLAY_GLYPHS )
+      {
+        m_Digits.setPosition(Entry.Position);
+        m_Digits.setGlyphs(Entry.Normal);
+      }
+      else
+      {
+        GenericGraphicElement& Component = ( Kind == ComponentsClips_Enum::DISPLAY ) ? m_Display : m_SolarCell;
+
+        Component.setPosition(Entry.Position);
+        Component.setSize(Entry.Normal.w, Entry.Normal.h);
+        Component.setClip(Entry.Normal);
+      }
+
+      ++NumOfCreatedComponents;
+    }
+    else
+    {
+      Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::WARNING, "Unknown atlas entry: %d", static_cast<int>(Entry.Id));
+    }
+  }
 
   /* Check number of buttons */
 
   if ( NumOfCreatedButtons == NumOfExpectedButtons )
   {
-    Msg.str(std::string());
-    Msg << "Number of created buttons OK.";
-    Supervisor::Get().PrintMessage(Msg.str());
+    Supervisor::Get().PrintMessage("Number of created buttons OK.");
   }
   else
   {
-    Msg.str(std::string());
-    Msg << "Number of created buttons: " << NumOfCreatedButtons << ". Expected: " << NumOfExpectedButtons;
-    Supervisor::Get().PrintMessage(Msg.str(), Supervisor::FaultLevel::WARNING);
+    Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::WARNING, "Number of created buttons: %zu. Expected: %zu", NumOfCreatedButtons, NumOfExpectedButtons);
   }
 
-  /* Create other components */
+  /* Check number of other components */
 
-  size_t NumOfCreatedComponents(0);
-  size_t NumOfExpectedComponents(static_cast<size_t>(ComponentsClips_Enum::HOW_MANY));
+  if ( NumOfCreatedComponents == NumOfExpectedComponents )
+  {
+    Supervisor::Get().PrintMessage("Number of created components OK.");
+  }
+  else
+  {
+    Supervisor::Get().PrintFormatted(Supervisor::FaultLevel::WARNING, "Number of created components: %zu. Expected: %zu", NumOfCreatedComponents, NumOfExpectedComponents);
+  }
 
-  m_SolarCell.setPosition(SDL_Point{SolarCell_xMW_px, SolarCell_yMW_px});
-  m_SolarCell.setSize(SolarCellW_px, SolarCellH_px);
-  m_SolarCell.setClip(SDL_Rect{SolarCell_xSS_px, SolarCell_ySS_px, m_SolarCell.GetWidth(), m_SolarCell.GetHeight()});
-  ++NumOfCreatedComponents;
+  /* The keypad is placed at the top left corner of its keys, which are placed relative to it */
 
-  m_Display.setPosition(SDL_Point{Display_xMW_px, Display_yMW_px});
-  m_Display.setSize(DisplayW_px, DisplayH_px);
-  m_Display.setClip(SDL_Rect{Display_xSS_px, Display_ySS_px, m_Display.GetWidth(), m_Display.GetHeight()});
-  ++NumOfCreatedComponents;
+  SDL_Point KeypadOrigin{ 0, 0 };
 
-  /* Check number of other components */
+  for (size_t i = 0; i != m_Button_Vec.size(); ++i)
+  {
+    const SDL_Point Position = m_Button_Vec[i].GetPosition();
 
-  if ( NumOfCreatedComponents == NumOfExpectedComponents )
+    KeypadOrigin.x = ( i == 0 ) ? Position.x : SDL_min( KeypadOrigin.x, Position.x );
+    KeypadOrigin.y = ( i == 0 ) ? Position.y : SDL_min( KeypadOrigin.y, Position.y );
+  }
+
+  m_Keypad.setPosition(KeypadOrigin);
+
+  for (auto& Button : m_Button_Vec)
   {
-    Msg.str(std::string());
-    Msg << "Number of created components OK.";
-    Supervisor::Get().PrintMessage(Msg.str());
+    const SDL_Point Position = Button.GetPosition();
+
+    Button.setPosition(SDL_Point{ Position.x - KeypadOrigin.x, Position.y - KeypadOrigin.y });
+    m_Keypad.addChild(Button);
+  }
+
+  /* The scene, in drawing order; the display's digits over the display */
+
+  m_Scene.addChild(m_Keypad);
+  m_Scene.addChild(m_SolarCell);
+  m_Scene.addChild(m_Display);
+  m_Scene.addChild(m_Digits);
+  m_Scene.updateTransforms();
+
+  /* Every drawn element, in the same drawing order, for the dirty areas */
+
+  for (auto& Button : m_Button_Vec)
+  {
+    m_AllElements_Vec.push_back(&Button);
+  }
+
+  m_AllElements_Vec.push_back(&m_SolarCell);
+  m_AllElements_Vec.push_back(&m_Display);
+  m_AllElements_Vec.push_back(&m_Digits);
+
+  m_DirtyRegions_Vec.reserve(m_AllElements_Vec.size());
+
+  RebuildHitTestGrid_Pvt();
+}
+
+
+/**
+ * @brief Indexes the clickable elements for mouse dispatching, where they are drawn.
+ **/
+void Renderer::RebuildHitTestGrid_Pvt(void)
+{
+  m_HitTestGrid.clear();
+
+  for (auto& Button : m_Button_Vec)
+  {
+    m_HitTestGrid.insert(Button.GetBounds(), &Button);
+  }
+
+  m_HitTestGrid.build(MainWindow::Get().GetWindowWidth(), MainWindow::Get().GetWindowHeight());
+}
+
+
+/**
+ * @brief Creates the persistent texture the graphic elements are composited into. Without it,
+ * every change causes a redraw of the whole window.
+ **/
+void Renderer::CreateCanvas_Pvt(void)
+{
+  if ( m_Canvas.createBlank(MainWindow::Get().GetWindowWidth(), MainWindow::Get().GetWindowHeight(), m_Renderer, SDL_TEXTUREACCESS_TARGET) )
+  {
+    Supervisor::Get().PrintMessage("Canvas created.");
   }
   else
   {
-    Msg.str(std::string());
-    Msg << "Number of created components: " << NumOfCreatedComponents << ". Expected: " << NumOfExpectedComponents;
-    Supervisor::Get().PrintMessage(Msg.str(), Supervisor::FaultLevel::WARNING);
+    Supervisor::Get().PrintMessage("Canvas could not be created. Falling back to full redraws.", Supervisor::FaultLevel::WARNING);
   }
 }
 
@@ -515,36 +312,258 @@ Texture& Renderer::GetSpriteSheet( void )
 }
 
 
+SpriteBatch& Renderer::GetSpriteBatch( void )
+{
+  return m_SpriteBatch;
+}
+
+
 /**
- * @brief Performs all the rendering.
+ * @brief Performs all the rendering. Only the regions covered by dirty elements are re-composited
+ * into the canvas, which is then presented. When nothing changed, nothing is drawn nor presented.
+ *
+ * Elements moved since the last frame, alone or with their group, get their window positions first;
+ * they become dirty where they were and where they are, and the hit-test grid follows them, so that
+ * clicks always reach what is on the screen.
  **/
 void Renderer::Render(void)
 {
-  SDL_SetRenderDrawColor( m_Renderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
+  FrameProfiler& Profiler = Supervisor::Get().GetProfiler();
 
-  SDL_RenderClear( m_Renderer );
+  if ( m_Scene.updateTransforms() != 0 )
+  {
+    RebuildHitTestGrid_Pvt();
+  }
+  else
+  {;}
 
-  for (auto& Button : m_Button_Vec)
+  CollectDirtyRegions_Pvt();
+
+  if ( m_DirtyRegions_Vec.empty() && !Profiler.IsOverlayVisible() )
+  {
+    return; // Nothing changed since last frame
+  }
+  else
+  {;}
+
+  FrameProfiler::ScopedTimer RenderTimer( FrameProfiler::Section::RENDER );
+
+  if ( m_Canvas.isValid() )
   {
-    Button.render();
+    m_Canvas.setAsRenderTarget( m_Renderer );
   }
+  else
+  {;} // Compositing directly into the back buffer
+
+  for ( const auto& Region : m_DirtyRegions_Vec )
+  {
+    CompositeRegion_Pvt( Region );
+  }
+
+  SDL_RenderSetClipRect( m_Renderer, NULL );
+
+  if ( m_Canvas.isValid() )
+  {
+    SDL_SetRenderTarget( m_Renderer, NULL );
+    SDL_RenderCopy( m_Renderer, m_Canvas.GetSDLTexturePtr(), NULL, NULL );
+
+    Profiler.CountTargetSwitch( NULL );
+    Profiler.CountDraw( m_Renderer, m_Canvas.GetSDLTexturePtr() );
+  }
+  else
+  {;}
+
+  if ( Profiler.IsOverlayVisible() )
+  {
+    DrawProfilerOverlay_Pvt(); // On the back buffer only, so that the canvas stays clean
+  }
+  else
+  {;}
+
+  {
+    FrameProfiler::ScopedTimer PresentTimer( FrameProfiler::Section::PRESENT );
+    SDL_RenderPresent( m_Renderer ); // Update screen
+  }
+
+  for ( auto Element_Ptr : m_AllElements_Vec )
+  {
+    Element_Ptr->ClearDirty();
+  }
+
+  m_NeedsFullRedraw = false;
+}
+
+
+/**
+ * @brief Draws the frame-time graph in the top-left corner and, about once per second, shows the
+ * percentiles, the allocation counter and the draw calls and state changes of the last frame in the
+ * window title.
+ **/
+void Renderer::DrawProfilerOverlay_Pvt(void)
+{
+  FrameProfiler& Profiler = Supervisor::Get().GetProfiler();
+
+  Profiler.DrawOverlay( m_Renderer, 0, 0 );
+
+  Uint32 const Now_ms = SDL_GetTicks();
+
+  if ( SDL_TICKS_PASSED( Now_ms, m_LastTitleUpdate_ms + TITLE_UPDATE_PERIOD_ms ) )
+  {
+    char Summary[64];
+    Profiler.FormatSummary( Summary, sizeof(Summary) );
+
+    char Counter[64];
+    Supervisor::Get().GetAllocations().FormatCounter( Counter, sizeof(Counter) );
 
-  m_SolarCell.render();
-  m_Display.render();
+    char Submitted[96];
+    Profiler.FormatCounters( Submitted, sizeof(Submitted) );
 
-  SDL_RenderPresent( m_Renderer ); // Update screen
+    char Title[288];
+    snprintf( Title, sizeof(Title), "%s - %s | %s | %s", MainWindow::Get().GetTitle(), Summary, Counter, Submitted );
+    SDL_SetWindowTitle( MainWindow::Get().GetSDLWindowPtr(), Title );
+
+    m_LastTitleUpdate_ms = Now_ms;
+  }
+  else
+  {;}
 }
 
 
 /**
- * @brief Use this function to invoke the Renderer when needed.
+ * @brief Forces the next call to Render to re-composite the whole window, e.g. after the window
+ * has been exposed or the render targets have been reset.
+ **/
+void Renderer::Invalidate(void)
+{
+  m_NeedsFullRedraw = true;
+}
+
+
+/**
+ * @brief Whether the next call to Render would draw something.
+ **/
+bool Renderer::HasPendingChanges(void)
+{
+  if ( m_NeedsFullRedraw || m_Scene.HasPendingTransforms() || Supervisor::Get().GetProfiler().IsOverlayVisible() )
+  {
+    return true;
+  }
+  else
+  {;}
+
+  for ( auto Element_Ptr : m_AllElements_Vec )
+  {
+    if ( Element_Ptr->IsDirty() )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Gathers the areas of the dirty elements, merging the overlapping ones.
+ **/
+void Renderer::CollectDirtyRegions_Pvt(void)
+{
+  m_DirtyRegions_Vec.clear();
+
+  // Without a persistent canvas the back buffer content is undefined after presenting, so any
+  // change requires a full redraw
+  bool const IsFullRedraw = m_NeedsFullRedraw || !m_Canvas.isValid();
+
+  for ( auto Element_Ptr : m_AllElements_Vec )
+  {
+    if ( !Element_Ptr->IsDirty() )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    SDL_Rect Region = Element_Ptr->GetDirtyArea();
+
+    if ( IsFullRedraw )
+    {
+      m_DirtyRegions_Vec.push_back( Region );
+      break; // Just needs to know that something changed
+    }
+    else
+    {;}
+
+    bool WasMerged = false;
+
+    for ( auto& Existing : m_DirtyRegions_Vec )
+    {
+      if ( SDL_HasIntersection( &Existing, &Region ) )
+      {
+        SDL_UnionRect( &Existing, &Region, &Existing );
+        WasMerged = true;
+        break;
+      }
+      else
+      {;}
+    }
+
+    if ( !WasMerged )
+    {
+      m_DirtyRegions_Vec.push_back( Region );
+    }
+    else
+    {;}
+  }
+
+  if ( m_NeedsFullRedraw || ( IsFullRedraw && !m_DirtyRegions_Vec.empty() ) )
+  {
+    m_DirtyRegions_Vec.clear();
+    m_DirtyRegions_Vec.push_back( SDL_Rect{ 0, 0, MainWindow::Get().GetWindowWidth(), MainWindow::Get().GetWindowHeight() } );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Clears a region of the current render target and redraws every element touching it.
  *
- * @return Renderer&
+ * @param Region The area to be re-composited.
  **/
-Renderer& Renderer::Get(void)
+void Renderer::CompositeRegion_Pvt(const SDL_Rect& Region)
 {
-  static Renderer Instance; // Creates instance of singleton in static memory.
-  return Instance;
+  SDL_RenderSetClipRect( m_Renderer, &Region );
+
+  SDL_SetRenderDrawColor( m_Renderer, WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX );
+  SDL_RenderFillRect( m_Renderer, &Region );
+  Supervisor::Get().GetProfiler().CountDraw( m_Renderer, NULL );
+
+  if ( !m_MediaLoaded )
+  {
+    /* Placeholders, if the sprite sheet could not be loaded */
+
+    SDL_SetRenderDrawColor( m_Renderer, LIGHT_GREY_R, LIGHT_GREY_G, LIGHT_GREY_B, ALPHA_MAX );
+
+    for ( auto Element_Ptr : m_AllElements_Vec )
+    {
+      const SDL_Rect Bounds = Element_Ptr->GetBounds();
+      SDL_RenderFillRect( m_Renderer, &Bounds );
+      Supervisor::Get().GetProfiler().CountDraw( m_Renderer, NULL );
+    }
+
+    return;
+  }
+  else
+  {;}
+
+  m_SpriteBatch.begin();
+
+  // Groups missing the region, e.g. the keypad under the display, are skipped whole
+  m_Scene.renderSubtree( Region );
+
+  m_SpriteBatch.flush( m_Renderer );
 }
 
 
@@ -557,4 +576,31 @@ SDL_Renderer* Renderer::GetSDLRendererPtr(void)
 std::vector<Button>& Renderer::GetButtonVector ( void )
 {
   return m_Button_Vec;
-}
\ No newline at end of file
+}
+
+
+/**
+ * @brief The group of the buttons: moving it moves them all, and their clicks with them.
+ **/
+GraphicGroup& Renderer::GetKeypad( void )
+{
+  return m_Keypad;
+}
+
+
+/**
+ * @brief The digits shown on the display.
+ **/
+SegmentDisplay& Renderer::GetSegmentDisplay( void )
+{
+  return m_Digits;
+}
+
+
+/**
+ * @brief The index of the clickable elements, where they were last drawn.
+ **/
+const HitTestGrid& Renderer::GetHitTestGrid( void ) const
+{
+  return m_HitTestGrid;
+}
@@ -13,6 +13,12 @@
 #include "Texture.hpp"
 #include "Button.hpp"
 #include "GenericGraphicElement.hpp"
+#include "GraphicGroup.hpp"
+#include "SegmentDisplay.hpp"
+#include "SpriteBatch.hpp"
+#include "HitTestGrid.hpp"
+#include "SpriteAtlas.hpp"
+#include "ServiceRegistry.hpp"
 
 /**
  * @brief Singleton renderer class.
@@ -25,6 +31,7 @@ public:
   {
     DISPLAY = 0,
     PHOTOVOLTAIC_CELL,
+    DISPLAY_GLYPHS,    // The glyph strip, and where the first character goes
 
     HOW_MANY
   };
@@ -65,30 +72,58 @@ public:
   Renderer& operator=( const Renderer&  ) = delete; // Singleton
   Renderer& operator=(       Renderer&& ) = delete; // Singleton
 
-  static Renderer& Get( void );
+  static Renderer& Get( void ) { return Service<Renderer>::Get(); } // Created by the ServiceRegistry in main
 
   SDL_Renderer*        GetSDLRendererPtr( void );
   Texture&             GetSpriteSheet   ( void );
+  SpriteBatch&         GetSpriteBatch   ( void );
   std::vector<Button>& GetButtonVector  ( void );
+  GraphicGroup&        GetKeypad        ( void );
+  SegmentDisplay&      GetSegmentDisplay( void );
+  const HitTestGrid&   GetHitTestGrid   ( void ) const;
   void                 Render           ( void );
+  void                 Invalidate       ( void );
+  bool                 HasPendingChanges( void );
+
+  // Start-up, in the stages of main: decode and atlas off the main thread, the rest on it
+  static SDL_Surface*  DecodeSpriteSheet    ( void );
+  static bool          LoadAtlas            ( SpriteAtlas& );
+  bool                 UploadSpriteSheet    ( SDL_Surface* );
+  void                 CreateGraphicElements( const SpriteAtlas& );
 
 private:
 
+  friend class ServiceSlot<Renderer>;
+
    Renderer( void );
   ~Renderer( void );
 
-  void LoadMedia_Pvt            ( void );
   void CreateRenderer_Pvt       ( void );
-  void CreateGraphicElements_Pvt( void );
+  void CreateCanvas_Pvt         ( void );
+  void CollectDirtyRegions_Pvt  ( void );
+  void CompositeRegion_Pvt      ( const SDL_Rect& );
+  void RebuildHitTestGrid_Pvt   ( void );
+  void DrawProfilerOverlay_Pvt  ( void );
 
   SDL_Renderer* m_Renderer          = nullptr; // The actual window renderer
   bool          m_WasInitSuccessful = true;
   bool          m_MediaLoaded       = false;
+  bool          m_NeedsFullRedraw   = true;  // Set at start-up and whenever the canvas is lost
+  Uint32        m_LastTitleUpdate_ms = 0;    // Last time the profiler summary was shown
 
   Texture               m_SpriteSheet;
+  SpriteBatch           m_SpriteBatch; // Collects the sprites of the current frame
+  GraphicGroup          m_Scene;       // Root of the elements, in drawing order
+  GraphicGroup          m_Keypad;      // The buttons, moved as a unit
   std::vector<Button>   m_Button_Vec;
   GenericGraphicElement m_SolarCell;
   GenericGraphicElement m_Display;
+  SegmentDisplay        m_Digits;      // Drawn over m_Display
+
+  Texture                              m_Canvas;           // Persistent, retained copy of the window
+  std::vector<AbstractGraphicElement*> m_AllElements_Vec;  // Every element, in drawing order
+  std::vector<SDL_Rect>                m_DirtyRegions_Vec; // Regions to re-composite this frame
+  HitTestGrid                          m_HitTestGrid;      // Finds the button under the mouse
 };
 
 
@@ -40,33 +40,34 @@ SDL_Initialiser::SDL_Initialiser(void)
   {
     printf( "\tOK: linear texture filtering enabled.\n" );
   }
+}
+
+
+SDL_Initialiser::~SDL_Initialiser(void)
+{;}
+
 
-  // Initialize PNG loading
+/**
+ * @brief Initialises PNG loading. Separate from the constructor, and static, so that it can run on
+ * a worker thread while the window is created: it needs neither SDL_Init nor the video subsystem.
+ **/
+bool SDL_Initialiser::InitImageLoading(void)
+{
   constexpr int imgFlags( static_cast<int>(IMG_INIT_PNG) );
 
   if( !( IMG_Init( imgFlags ) & imgFlags ) )
   {
     printf( "\tWarning: SDL_image could not initialise! SDL_Image Error: %s", IMG_GetError() );
-    m_WasInitSuccessful = false;
+    return false;
   }
   else
   {
     printf( "\tOK: SDL_image initialised.\n" );
+    return true;
   }
 }
 
 
-SDL_Initialiser::~SDL_Initialiser(void)
-{;}
-
-
-SDL_Initialiser& SDL_Initialiser::Get(void)
-{
-  static SDL_Initialiser Instance;
-  return Instance;
-}
-
-
 bool SDL_Initialiser::isSDLInitialised(void)
 {
   // printf("\nm_isSDLInitialised: %d", m_WasInitSuccessful); // TODO: debug
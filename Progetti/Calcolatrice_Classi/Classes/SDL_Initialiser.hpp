@@ -7,6 +7,8 @@
 #ifndef SDL_INITIALISER_HPP
 #define SDL_INITIALISER_HPP
 
+#include "ServiceRegistry.hpp"
+
 /**
  * @brief
  **/
@@ -20,13 +22,17 @@ public:
   SDL_Initialiser& operator=(const SDL_Initialiser&)  = delete;
   SDL_Initialiser& operator=(      SDL_Initialiser&&) = delete;
 
-  static SDL_Initialiser& Get(void);
+  static SDL_Initialiser& Get( void ) { return Service<SDL_Initialiser>::Get(); } // Created by the ServiceRegistry in main
 
   bool isSDLInitialised     (void);
   void QuitSDL              (void);
 
+  static bool InitImageLoading(void);
+
 private:
 
+  friend class ServiceSlot<SDL_Initialiser>;
+
    SDL_Initialiser(void);
   ~SDL_Initialiser(void);
 
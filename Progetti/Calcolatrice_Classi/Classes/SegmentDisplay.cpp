@@ -0,0 +1,101 @@
+#include "SegmentDisplay.hpp"
+#include "Renderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+// Characters of the glyph strip, in order
+static const char Glyphs[] = "0123456789-.Ero";
+
+
+SegmentDisplay::SegmentDisplay(void)
+  : m_FirstGlyph_Rect{0, 0, 0, 0}
+{
+  m_Cells.fill( s_BLANK );
+  m_Cells.back() = 0; // "0", as the calculator when switched on
+}
+
+
+/**
+ * @brief Sets the glyph strip and the size of the cells.
+ *
+ * @param FirstGlyph The clip of '0' in the sprite sheet; every glyph is as large.
+ **/
+void SegmentDisplay::setGlyphs(const SDL_Rect& FirstGlyph)
+{
+  m_FirstGlyph_Rect = FirstGlyph;
+
+  setSize( static_cast<int>( s_CELLS ) * FirstGlyph.w, FirstGlyph.h );
+  MarkDirty();
+}
+
+
+/**
+ * @brief Shows a text, right-aligned; if it is longer than the display, its first s_CELLS
+ * characters. Only the cells that change are redrawn.
+ **/
+void SegmentDisplay::setText(const char* Text)
+{
+  const size_t Length = std::min( strlen( Text ), s_CELLS );
+  const size_t First  = s_CELLS - Length;
+
+  for ( size_t Cell = 0; Cell != s_CELLS; ++Cell )
+  {
+    Sint8 Glyph = s_BLANK;
+
+    if ( Cell >= First )
+    {
+      const char  Character = ( Text[Cell - First] == 'e' ) ? 'E' : Text[Cell - First]; // Exponents
+      const char* Found_Ptr = strchr( Glyphs, Character );
+      Glyph = ( Found_Ptr != nullptr && *Found_Ptr != '\0' ) ? static_cast<Sint8>( Found_Ptr - Glyphs ) : s_BLANK;
+    }
+    else
+    {;}
+
+    if ( Glyph != m_Cells[Cell] )
+    {
+      m_Cells[Cell] = Glyph;
+      MarkDirty( GetCell_Pvt( Cell ) );
+    }
+    else
+    {;}
+  }
+}
+
+
+/**
+ * @brief Queues the glyphs of the cells inside the area being composited into the renderer's
+ * sprite batch. Blank cells show the display face, drawn before.
+ **/
+void SegmentDisplay::render(void)
+{
+  SDL_Rect Clip;
+  SDL_RenderGetClipRect( Renderer::Get().GetSDLRendererPtr(), &Clip );
+
+  const bool IsClipped = !SDL_RectEmpty( &Clip );
+
+  for ( size_t Cell = 0; Cell != s_CELLS; ++Cell )
+  {
+    const SDL_Rect Destination = GetCell_Pvt( Cell );
+
+    if ( m_Cells[Cell] == s_BLANK || ( IsClipped && !SDL_HasIntersection( &Destination, &Clip ) ) )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    const SDL_Rect Glyph{ m_FirstGlyph_Rect.x + m_Cells[Cell] * m_FirstGlyph_Rect.w, m_FirstGlyph_Rect.y,
+                          m_FirstGlyph_Rect.w, m_FirstGlyph_Rect.h };
+
+    Renderer::Get().GetSpriteBatch().add( Renderer::Get().GetSpriteSheet(), Glyph, Destination );
+  }
+}
+
+
+SDL_Rect SegmentDisplay::GetCell_Pvt(size_t Cell) const
+{
+  return SDL_Rect{ m_CurrentPosition_pt.x + static_cast<int>( Cell ) * m_FirstGlyph_Rect.w, m_CurrentPosition_pt.y,
+                   m_FirstGlyph_Rect.w, m_FirstGlyph_Rect.h };
+}
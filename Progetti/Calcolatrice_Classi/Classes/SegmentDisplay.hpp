@@ -0,0 +1,42 @@
+#ifndef SEGMENTDISPLAY_HPP
+#define SEGMENTDISPLAY_HPP
+
+#include <SDL.h>
+#include <array>
+#include "AbstractGraphicElement.hpp"
+
+/**
+ * @brief This class represents the digits of the calculator's display: a row of s_CELLS character
+ * cells, each drawn with a glyph of the seven-segment strip of the sprite sheet ("0123456789-.Ero",
+ * side by side). The text is right-aligned; unknown characters are left blank.
+ *
+ * Only the cells whose glyph changed are marked dirty, and only the glyphs inside the area being
+ * composited are queued: a key press re-composites the changed characters, over the display face,
+ * in the same sprite batch, with one draw call.
+ **/
+class SegmentDisplay : public AbstractGraphicElement
+{
+private:
+
+public:
+
+  static constexpr size_t s_CELLS = 22; // 20 digits, sign and point
+
+  SegmentDisplay(void);
+
+  virtual void render ( void ) override;
+
+  void setGlyphs ( const SDL_Rect& );
+  void setText   ( const char* );
+
+private:
+
+  static constexpr Sint8 s_BLANK = -1;
+
+  SDL_Rect GetCell_Pvt( size_t ) const;
+
+  std::array<Sint8, s_CELLS> m_Cells;           // Glyph of each cell, or s_BLANK
+  SDL_Rect                   m_FirstGlyph_Rect; // Clip of '0'; the others follow it
+};
+
+#endif // SEGMENTDISPLAY_HPP
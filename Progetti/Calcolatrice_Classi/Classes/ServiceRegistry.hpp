@@ -0,0 +1,133 @@
+/**
+ * @file ServiceRegistry.hpp
+ *
+ * @brief The program-wide services (window, renderer, input...) created in a fixed order by one
+ * object in "main", instead of one function-local static per singleton.
+ **/
+
+#ifndef SERVICEREGISTRY_HPP
+#define SERVICEREGISTRY_HPP
+
+#include <type_traits>
+
+template <typename> class ServiceSlot;
+
+
+/**
+ * @brief Where the running instance of a service is found: a plain pointer, set while the service
+ * exists. Unlike a function-local static it needs no thread-safe initialisation guard, so "Get" is
+ * a single load, inlined at the call site.
+ **/
+template <typename T>
+class Service
+{
+public:
+
+  static T& Get( void )
+  {
+    return *s_Instance_Ptr;
+  }
+
+  static bool IsAvailable( void )
+  {
+    return s_Instance_Ptr != nullptr;
+  }
+
+private:
+
+  friend class ServiceSlot<T>;
+
+  static inline T* s_Instance_Ptr = nullptr; // Constant-initialised: no guard, no static init order
+};
+
+
+/**
+ * @brief Owns a service and publishes it for the time it exists. The service is built before it
+ * is published and unpublished before it is destroyed. Services keep their constructor private and
+ * befriend their own slot, so that the registry is the only place creating them.
+ **/
+template <typename T>
+class ServiceSlot
+{
+public:
+
+  ServiceSlot( void )
+    : m_Service()
+  {
+    Service<T>::s_Instance_Ptr = &m_Service;
+  }
+
+  ~ServiceSlot( void )
+  {
+    Service<T>::s_Instance_Ptr = nullptr;
+  }
+
+  ServiceSlot( const ServiceSlot&  ) = delete;
+  ServiceSlot(       ServiceSlot&& ) = delete;
+
+  ServiceSlot& operator=( const ServiceSlot&  ) = delete;
+  ServiceSlot& operator=(       ServiceSlot&& ) = delete;
+
+  T& Get( void )
+  {
+    return m_Service;
+  }
+
+private:
+
+  T m_Service;
+};
+
+
+/**
+ * @brief Creates the listed services in the order given, each one available to the constructors of
+ * those after it, and destroys them in reverse order when it goes out of scope: startup and
+ * shutdown are written down in one place, not decided by the first call of each "Get". The order is
+ * resolved at compile time, as nested members.
+ *
+ * "Get<T>" returns the instance directly, for the code that holds the registry: hot loops resolve
+ * their services once into references.
+ **/
+template <typename... Services>
+class ServiceRegistry;
+
+
+template <>
+class ServiceRegistry<>
+{
+};
+
+
+template <typename First, typename... Rest>
+class ServiceRegistry<First, Rest...>
+{
+public:
+
+  ServiceRegistry( void ) = default;
+
+  ServiceRegistry( const ServiceRegistry&  ) = delete;
+  ServiceRegistry(       ServiceRegistry&& ) = delete;
+
+  ServiceRegistry& operator=( const ServiceRegistry&  ) = delete;
+  ServiceRegistry& operator=(       ServiceRegistry&& ) = delete;
+
+  template <typename T>
+  T& Get( void )
+  {
+    if constexpr ( std::is_same_v<T, First> )
+    {
+      return m_First.Get();
+    }
+    else
+    {
+      return m_Rest.template Get<T>();
+    }
+  }
+
+private:
+
+  ServiceSlot<First>       m_First; // Built first, destroyed last
+  ServiceRegistry<Rest...> m_Rest;
+};
+
+#endif // SERVICEREGISTRY_HPP
@@ -0,0 +1,229 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "SpriteAtlas.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static_assert( sizeof(SpriteAtlas::AtlasEntry) == 11 * sizeof(Sint32), "AtlasEntry must match the binary layout" );
+
+
+/***************************************************************************************************
+* Private prototypes
+****************************************************************************************************/
+
+static void SwapFromLittleEndian( Uint32*, size_t );
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+SpriteAtlas::SpriteAtlas( void )
+{;}
+
+
+/**
+ * @brief Loads the atlas from its binary form. The whole file is read at once and the entries are
+ * copied straight into the packed array.
+ *
+ * @param Path The path of the binary atlas.
+ * @return true if successful; false otherwise.
+ **/
+bool SpriteAtlas::loadFromBinaryFile( const std::string& Path )
+{
+  m_Entries.clear();
+
+  size_t FileSize = 0;
+  void*  FileData = SDL_LoadFile( Path.c_str(), &FileSize );
+
+  if ( FileData == NULL )
+  {
+    printf( "\nUnable to open atlas \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  bool IsValid = false;
+
+  Header FileHeader;
+
+  if ( FileSize >= sizeof(Header) )
+  {
+    std::memcpy( &FileHeader, FileData, sizeof(Header) );
+    SwapFromLittleEndian( reinterpret_cast<Uint32*>( &FileHeader ), sizeof(Header) / sizeof(Uint32) );
+
+    IsValid = FileHeader.Magic   == s_MAGIC   &&
+              FileHeader.Version == s_VERSION &&
+              FileSize == sizeof(Header) + FileHeader.NumOfEntries * sizeof(AtlasEntry);
+  }
+  else
+  {;}
+
+  if ( IsValid )
+  {
+    m_Entries.resize( FileHeader.NumOfEntries );
+    std::memcpy( m_Entries.data(), static_cast<const Uint8*>( FileData ) + sizeof(Header), m_Entries.size() * sizeof(AtlasEntry) );
+    SwapFromLittleEndian( reinterpret_cast<Uint32*>( m_Entries.data() ), m_Entries.size() * sizeof(AtlasEntry) / sizeof(Uint32) );
+
+    printf( "\nAtlas \"%s\" loaded: %zu entries", Path.c_str(), m_Entries.size() );
+  }
+  else
+  {
+    printf( "\nAtlas \"%s\" is corrupted or has an unsupported version!", Path.c_str() );
+  }
+
+  SDL_free( FileData );
+
+  return IsValid;
+}
+
+
+/**
+ * @brief Loads the atlas from its text form.
+ *
+ * @param Path The path of the text atlas.
+ * @param Names The names used in the file; the position of a name in the vector is its Id.
+ * @return true if successful; false otherwise.
+ **/
+bool SpriteAtlas::loadFromTextFile( const std::string& Path, const std::vector<std::string>& Names )
+{
+  m_Entries.clear();
+
+  std::ifstream AtlasFile( Path );
+
+  if ( !AtlasFile.is_open() )
+  {
+    printf( "\nUnable to open atlas \"%s\"!", Path.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  std::string Line;
+  size_t      LineNumber = 0;
+
+  while ( std::getline( AtlasFile, Line ) )
+  {
+    ++LineNumber;
+
+    Line = Line.substr( 0, Line.find('#') );
+
+    std::istringstream Fields( Line );
+    std::string        Name;
+
+    if ( !( Fields >> Name ) )
+    {
+      continue; // Empty line or comment
+    }
+    else
+    {;}
+
+    AtlasEntry NewEntry;
+
+    Fields >> NewEntry.Position.x >> NewEntry.Position.y
+           >> NewEntry.Normal.x   >> NewEntry.Normal.y   >> NewEntry.Normal.w  >> NewEntry.Normal.h
+           >> NewEntry.Pressed.x  >> NewEntry.Pressed.y  >> NewEntry.Pressed.w >> NewEntry.Pressed.h;
+
+    size_t Id = 0;
+
+    while ( Id != Names.size() && Names[Id] != Name )
+    {
+      ++Id;
+    }
+
+    if ( Fields.fail() || Id == Names.size() )
+    {
+      printf( "\nAtlas \"%s\", line %zu: invalid entry \"%s\"!", Path.c_str(), LineNumber, Name.c_str() );
+      m_Entries.clear();
+      return false;
+    }
+    else
+    {;}
+
+    NewEntry.Id = static_cast<Sint32>( Id );
+    m_Entries.push_back( NewEntry );
+  }
+
+  printf( "\nAtlas \"%s\" loaded: %zu entries", Path.c_str(), m_Entries.size() );
+
+  return true;
+}
+
+
+/**
+ * @brief Writes the atlas in its binary form.
+ *
+ * @param Path Destination file.
+ * @return true if successful; false otherwise.
+ **/
+bool SpriteAtlas::saveToBinaryFile( const std::string& Path ) const
+{
+  SDL_RWops* File = SDL_RWFromFile( Path.c_str(), "wb" );
+
+  if ( File == NULL )
+  {
+    printf( "\nUnable to write atlas \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else
+  {;}
+
+  bool Success = SDL_WriteLE32( File, s_MAGIC                               ) == 1 &&
+                 SDL_WriteLE32( File, s_VERSION                             ) == 1 &&
+                 SDL_WriteLE32( File, static_cast<Uint32>( m_Entries.size() ) ) == 1 &&
+                 SDL_WriteLE32( File, 0                                     ) == 1;
+
+  for ( const auto& Entry : m_Entries )
+  {
+    const Sint32 Values[] = { Entry.Id, Entry.Position.x, Entry.Position.y,
+                              Entry.Normal.x , Entry.Normal.y , Entry.Normal.w , Entry.Normal.h ,
+                              Entry.Pressed.x, Entry.Pressed.y, Entry.Pressed.w, Entry.Pressed.h };
+
+    for ( Sint32 Value : Values )
+    {
+      Success = Success && SDL_WriteLE32( File, static_cast<Uint32>( Value ) ) == 1;
+    }
+  }
+
+  SDL_RWclose( File );
+
+  return Success;
+}
+
+
+const std::vector<SpriteAtlas::AtlasEntry>& SpriteAtlas::GetEntries( void ) const
+{
+  return m_Entries;
+}
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Converts little-endian words read from file into the native byte order.
+ **/
+static void SwapFromLittleEndian( Uint32* Words, size_t NumOfWords )
+{
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+  for ( size_t i = 0; i != NumOfWords; ++i )
+  {
+    Words[i] = SDL_SwapLE32( Words[i] );
+  }
+#else
+  (void)Words;
+  (void)NumOfWords;
+#endif
+}
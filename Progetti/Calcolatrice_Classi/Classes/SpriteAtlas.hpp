@@ -0,0 +1,69 @@
+/**
+ * @file SpriteAtlas.hpp
+ *
+ * @brief Describes where each graphic element is found in the sprite sheet and where it is placed in
+ * the main window.
+ **/
+
+#ifndef SPRITEATLAS_HPP
+#define SPRITEATLAS_HPP
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sprite atlas descriptor. It can be loaded from two formats:
+ *
+ * - binary (preferred), loaded with a single read and copied as-is into the packed entry array.
+ *   All values are little-endian 32-bit integers:
+ *   Magic ("SATL"), Version, NumOfEntries, Reserved, followed by NumOfEntries entries laid out as
+ *   "AtlasEntry" (Id, Position x y, Normal clip x y w h, Pressed clip x y w h);
+ *
+ * - text, one entry per line, with '#' starting a comment:
+ *   Name PositionX PositionY NormalX NormalY NormalW NormalH PressedX PressedY PressedW PressedH
+ *   The name is translated into the entry Id through the table given to the loader.
+ *
+ * When only the text form exists, the renderer writes the binary form next to it. Delete the binary
+ * file after editing the text one to have it regenerated.
+ **/
+class SpriteAtlas
+{
+public:
+
+  /**
+   * @brief A single element of the atlas. Elements without a pressed variant repeat the normal clip.
+   **/
+  struct AtlasEntry
+  {
+    Sint32    Id;       // Which element this entry describes
+    SDL_Point Position; // Top left corner in the main window
+    SDL_Rect  Normal;   // Normal clip in the sprite sheet
+    SDL_Rect  Pressed;  // Pressed clip in the sprite sheet
+  };
+
+  SpriteAtlas( void );
+
+  bool loadFromBinaryFile( const std::string& );
+  bool loadFromTextFile  ( const std::string&, const std::vector<std::string>& );
+  bool saveToBinaryFile  ( const std::string& ) const;
+
+  const std::vector<AtlasEntry>& GetEntries( void ) const;
+
+private:
+
+  static constexpr Uint32 s_MAGIC   = 0x4C544153; // "SATL", little-endian
+  static constexpr Uint32 s_VERSION = 1;
+
+  struct Header
+  {
+    Uint32 Magic;
+    Uint32 Version;
+    Uint32 NumOfEntries;
+    Uint32 Reserved;
+  };
+
+  std::vector<AtlasEntry> m_Entries;
+};
+
+#endif // SPRITEATLAS_HPP
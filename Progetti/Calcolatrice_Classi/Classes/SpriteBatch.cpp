@@ -0,0 +1,171 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "SpriteBatch.hpp"
+#include "Supervisor.hpp"
+#include "colours.hpp"
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const SDL_Color NoModulation{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+SpriteBatch::SpriteBatch( void )
+  : m_ActiveBatches(0), m_LastDrawCalls(0)
+{;}
+
+
+/**
+ * @brief Starts a new frame. Queued geometry is discarded, but the allocated storage is kept, so
+ * that steady-state frames do not allocate.
+ **/
+void SpriteBatch::begin( void )
+{
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    m_Batches[i].Vertices.clear();
+    m_Batches[i].Indices.clear();
+  }
+
+  m_ActiveBatches = 0;
+}
+
+
+/**
+ * @brief Queues a sprite.
+ *
+ * @param Source_Texture The texture to sample from.
+ * @param Clip Portion of the texture to draw.
+ * @param Destination Where to draw the clip in the render target.
+ **/
+void SpriteBatch::add( const Texture& Source_Texture, const SDL_Rect& Clip, const SDL_Rect& Destination )
+{
+  if ( !Source_Texture.isValid() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Batch& CurrentBatch = FindBatch_Pvt( Source_Texture );
+
+  const float InvW = 1.0f / static_cast<float>( CurrentBatch.Width_px  );
+  const float InvH = 1.0f / static_cast<float>( CurrentBatch.Height_px );
+
+  const float u0 = static_cast<float>( Clip.x          ) * InvW;
+  const float v0 = static_cast<float>( Clip.y          ) * InvH;
+  const float u1 = static_cast<float>( Clip.x + Clip.w ) * InvW;
+  const float v1 = static_cast<float>( Clip.y + Clip.h ) * InvH;
+
+  const float x0 = static_cast<float>( Destination.x                 );
+  const float y0 = static_cast<float>( Destination.y                 );
+  const float x1 = static_cast<float>( Destination.x + Destination.w );
+  const float y1 = static_cast<float>( Destination.y + Destination.h );
+
+  const int First = static_cast<int>( CurrentBatch.Vertices.size() );
+
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y0}, NoModulation, SDL_FPoint{u0, v0} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y0}, NoModulation, SDL_FPoint{u1, v0} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y1}, NoModulation, SDL_FPoint{u1, v1} } );
+  CurrentBatch.Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y1}, NoModulation, SDL_FPoint{u0, v1} } );
+
+  // Two triangles: top-left, top-right, bottom-right and bottom-right, bottom-left, top-left
+  CurrentBatch.Indices.push_back( First     );
+  CurrentBatch.Indices.push_back( First + 1 );
+  CurrentBatch.Indices.push_back( First + 2 );
+  CurrentBatch.Indices.push_back( First + 2 );
+  CurrentBatch.Indices.push_back( First + 3 );
+  CurrentBatch.Indices.push_back( First     );
+}
+
+
+/**
+ * @brief Submits all the queued sprites, one draw call per texture.
+ *
+ * @param Renderer_Ptr The SDL renderer to draw with.
+ **/
+void SpriteBatch::flush( SDL_Renderer* Renderer_Ptr )
+{
+  m_LastDrawCalls = 0;
+
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    Batch& CurrentBatch = m_Batches[i];
+
+    if ( CurrentBatch.Indices.empty() )
+    {
+      continue;
+    }
+    else
+    {;}
+
+    if ( SDL_RenderGeometry( Renderer_Ptr, CurrentBatch.Texture_Ptr,
+                             CurrentBatch.Vertices.data(), static_cast<int>( CurrentBatch.Vertices.size() ),
+                             CurrentBatch.Indices.data() , static_cast<int>( CurrentBatch.Indices.size()  ) ) != 0 )
+    {
+      Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::WARNING, "Sprite batch could not be drawn! SDL Error: %s", SDL_GetError() );
+    }
+    else
+    {
+      ++m_LastDrawCalls;
+      Supervisor::Get().GetProfiler().CountDraw( Renderer_Ptr, CurrentBatch.Texture_Ptr );
+    }
+  }
+
+  begin();
+}
+
+
+/**
+ * @brief Number of draw calls issued by the last flush.
+ **/
+int SpriteBatch::GetDrawCalls( void ) const
+{
+  return m_LastDrawCalls;
+}
+
+
+/**
+ * @brief Returns the batch associated to a texture, activating a new one if needed. The textures
+ * used in a frame are few, so a linear search is enough.
+ **/
+SpriteBatch::Batch& SpriteBatch::FindBatch_Pvt( const Texture& Source_Texture )
+{
+  SDL_Texture* Texture_Ptr = Source_Texture.GetSDLTexturePtr();
+
+  for ( size_t i = 0; i != m_ActiveBatches; ++i )
+  {
+    if ( m_Batches[i].Texture_Ptr == Texture_Ptr )
+    {
+      return m_Batches[i];
+    }
+    else
+    {;}
+  }
+
+  if ( m_ActiveBatches == m_Batches.size() )
+  {
+    m_Batches.emplace_back();
+    m_Batches.back().Vertices.reserve( s_RESERVED_SPRITES * s_VERTICES_PER_SPRITE );
+    m_Batches.back().Indices.reserve ( s_RESERVED_SPRITES * s_INDICES_PER_SPRITE  );
+  }
+  else
+  {;}
+
+  Batch& NewBatch = m_Batches[m_ActiveBatches];
+  ++m_ActiveBatches;
+
+  NewBatch.Texture_Ptr = Texture_Ptr;
+  NewBatch.Width_px    = Source_Texture.getWidth();
+  NewBatch.Height_px   = Source_Texture.getHeight();
+
+  return NewBatch;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file SpriteBatch.hpp
+ *
+ * @brief Collects sprite draws for one frame and submits them with as few draw calls as possible.
+ **/
+
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+
+#include <SDL.h>
+#include <vector>
+#include "Texture.hpp"
+
+/**
+ * @brief Sprite batch. Every clip / destination pair queued between "begin" and "flush" is
+ * converted into two triangles of a contiguous vertex array; "flush" then issues a single
+ * SDL_RenderGeometry call for each texture. Sprites sampling different textures are drawn in
+ * order of first appearance of their texture.
+ **/
+class SpriteBatch
+{
+public:
+
+  SpriteBatch( void );
+
+  void begin        ( void );
+  void add          ( const Texture&, const SDL_Rect&, const SDL_Rect& );
+  void flush        ( SDL_Renderer* );
+  int  GetDrawCalls ( void ) const;
+
+private:
+
+  /**
+   * @brief All the geometry queued for a single texture.
+   **/
+  struct Batch
+  {
+    SDL_Texture*            Texture_Ptr = nullptr;
+    int                     Width_px    = 0;
+    int                     Height_px   = 0;
+    std::vector<SDL_Vertex> Vertices;
+    std::vector<int>        Indices;
+  };
+
+  Batch& FindBatch_Pvt( const Texture& );
+
+  static constexpr size_t s_VERTICES_PER_SPRITE = 4;
+  static constexpr size_t s_INDICES_PER_SPRITE  = 6;
+  static constexpr size_t s_RESERVED_SPRITES    = 32; // Enough for the whole calculator
+
+  std::vector<Batch> m_Batches;         // One entry per texture; storage is kept between frames
+  size_t             m_ActiveBatches;   // Entries of m_Batches used in the current frame
+  int                m_LastDrawCalls;   // Draw calls issued by the last flush
+};
+
+#endif // SPRITEBATCH_HPP
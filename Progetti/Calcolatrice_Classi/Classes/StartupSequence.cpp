@@ -0,0 +1,313 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "StartupSequence.hpp"
+#include "Supervisor.hpp"
+
+#include <cstdio>
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const char* ThreadNames[] { "main", "worker" };
+static const char* StatusNames[] { "pending", "running", "ok", "FAILED", "skipped" };
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+/**
+ * @brief Without a mutex or a condition variable every stage runs on the calling thread.
+ **/
+StartupSequence::StartupSequence( void )
+  : m_Mutex(SDL_CreateMutex()), m_Changed(SDL_CreateCond()), m_IsSerial(false),
+    m_Frequency(SDL_GetPerformanceFrequency()), m_Begin(0), m_End(0)
+{
+  if ( m_Mutex == NULL || m_Changed == NULL )
+  {
+    printf( "\nStart-up stages will run serially. SDL Error: %s", SDL_GetError() );
+    m_IsSerial = true;
+  }
+  else
+  {;}
+}
+
+
+StartupSequence::~StartupSequence( void )
+{
+  if ( m_Changed != NULL )
+  {
+    SDL_DestroyCond( m_Changed );
+  }
+  else
+  {;}
+
+  if ( m_Mutex != NULL )
+  {
+    SDL_DestroyMutex( m_Mutex );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Adds a stage. Call it before "Run".
+ *
+ * @param Name Shown in the report and given to the worker thread; it must outlive the sequence.
+ * @param Where The thread the stage must run on.
+ * @param Function The work of the stage. It returns false when the stage failed.
+ * @param DependsOn Stages that must be done before this one starts, as returned by "AddStage".
+ *
+ * @return int The index of the stage, or -1 if a dependency is not an earlier stage.
+ **/
+int StartupSequence::AddStage( const char* Name, Thread Where, StageFunction Function, std::initializer_list<int> DependsOn )
+{
+  const int Index = static_cast<int>( m_Stages.size() );
+
+  for ( int Dependency : DependsOn )
+  {
+    if ( Dependency < 0 || Dependency >= Index )
+    {
+      printf( "\nStart-up stage \"%s\" depends on %d, which is not an earlier stage.", Name, Dependency );
+      return -1;
+    }
+    else
+    {;}
+  }
+
+  m_Stages.push_back( Stage{ Name, Where, std::move( Function ), std::vector<int>( DependsOn ), Status::PENDING, 0, 0, NULL, this } );
+
+  return Index;
+}
+
+
+/**
+ * @brief True runs every stage on the calling thread, in the order they were added.
+ **/
+void StartupSequence::SetSerial( bool IsSerial )
+{
+  m_IsSerial = IsSerial || m_Mutex == NULL || m_Changed == NULL;
+}
+
+
+/**
+ * @brief Runs all the stages and waits for the worker threads.
+ *
+ * After each MAIN stage the worker stages it unblocked are started first, so that they overlap the
+ * next MAIN stage; with no MAIN stage ready, the calling thread sleeps until a worker ends. Since
+ * dependencies point to earlier stages, there is always a stage ready or running until all are
+ * over. If a worker thread cannot be created, that stage and the following ones run serially.
+ *
+ * @return bool True if every stage succeeded.
+ **/
+bool StartupSequence::Run( void )
+{
+  m_Begin = SDL_GetPerformanceCounter();
+
+  SDL_LockMutex( m_Mutex );
+
+  while ( true )
+  {
+    Stage* Inline_Ptr   = nullptr; // The next stage for the calling thread
+    bool   IsAnyRunning = false;
+
+    for ( auto& Current : m_Stages )
+    {
+      if ( Current.State == Status::PENDING && MustBeSkipped_Pvt( Current ) )
+      {
+        Current.State = Status::SKIPPED;
+      }
+      else if ( Current.State == Status::PENDING && IsReady_Pvt( Current ) )
+      {
+        if ( Current.Where == Thread::WORKER && !m_IsSerial )
+        {
+          Current.State      = Status::RUNNING;
+          Current.Worker_Ptr = SDL_CreateThread( WorkerThread_Pvt, Current.Name, &Current );
+
+          if ( Current.Worker_Ptr == NULL )
+          {
+            printf( "\nStart-up thread \"%s\" could not be created, running serially. SDL Error: %s", Current.Name, SDL_GetError() );
+            Current.State = Status::PENDING;
+            m_IsSerial    = true;
+          }
+          else
+          {;}
+        }
+        else
+        {;}
+
+        if ( Current.State == Status::PENDING && Inline_Ptr == nullptr && ( Current.Where == Thread::MAIN || m_IsSerial ) )
+        {
+          Inline_Ptr = &Current;
+        }
+        else
+        {;}
+      }
+      else
+      {;}
+
+      IsAnyRunning = IsAnyRunning || Current.State == Status::RUNNING;
+    }
+
+    if ( Inline_Ptr != nullptr )
+    {
+      Inline_Ptr->State = Status::RUNNING;
+
+      SDL_UnlockMutex( m_Mutex );
+      Execute_Pvt( *Inline_Ptr );
+      SDL_LockMutex( m_Mutex );
+    }
+    else if ( IsAnyRunning )
+    {
+      SDL_CondWait( m_Changed, m_Mutex );
+    }
+    else
+    {
+      break;
+    }
+  }
+
+  SDL_UnlockMutex( m_Mutex );
+
+  bool AllSucceeded = true;
+
+  for ( auto& Current : m_Stages )
+  {
+    if ( Current.Worker_Ptr != NULL )
+    {
+      SDL_WaitThread( Current.Worker_Ptr, NULL );
+      Current.Worker_Ptr = NULL;
+    }
+    else
+    {;}
+
+    AllSucceeded = AllSucceeded && Current.State == Status::DONE;
+  }
+
+  m_End = SDL_GetPerformanceCounter();
+
+  return AllSucceeded;
+}
+
+
+/**
+ * @brief Prints, for each stage, its thread, when it started from the beginning of "Run", how long
+ * it took and how it ended; then the whole start-up against the sum of the stages, whose difference
+ * is the time saved by running them in parallel.
+ **/
+void StartupSequence::PrintReport( void ) const
+{
+  Supervisor& TheSupervisor = Supervisor::Get();
+  Uint64      StagesTotal   = 0;
+
+  TheSupervisor.PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "Start-up (%s):", m_IsSerial ? "serial" : "parallel" );
+
+  for ( const auto& Current : m_Stages )
+  {
+    const bool HasRun = Current.State == Status::DONE || Current.State == Status::FAILED;
+
+    if ( HasRun )
+    {
+      StagesTotal += Current.End - Current.Start;
+
+      TheSupervisor.PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "  %-22s %-6s at %8.2f ms, %8.2f ms  %s",
+                                    Current.Name, ThreadNames[static_cast<int>( Current.Where )],
+                                    ToMilliseconds_Pvt( Current.Start - m_Begin ), ToMilliseconds_Pvt( Current.End - Current.Start ),
+                                    StatusNames[static_cast<int>( Current.State )] );
+    }
+    else
+    {
+      TheSupervisor.PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "  %-22s %-6s %33s",
+                                    Current.Name, ThreadNames[static_cast<int>( Current.Where )],
+                                    StatusNames[static_cast<int>( Current.State )] );
+    }
+  }
+
+  TheSupervisor.PrintFormatted( Supervisor::FaultLevel::NO_FAULT, "Start-up took %.2f ms; the stages alone %.2f ms.",
+                                ToMilliseconds_Pvt( m_End - m_Begin ), ToMilliseconds_Pvt( StagesTotal ) );
+}
+
+
+/**
+ * @brief Body of the worker threads: runs one stage.
+ **/
+int StartupSequence::WorkerThread_Pvt( void* Stage_Ptr )
+{
+  Stage& Current = *static_cast<Stage*>( Stage_Ptr );
+
+  Current.Owner_Ptr->Execute_Pvt( Current );
+
+  return 0;
+}
+
+
+/**
+ * @brief True when all the dependencies are done. Call it with the mutex locked.
+ **/
+bool StartupSequence::IsReady_Pvt( const Stage& Current ) const
+{
+  for ( int Dependency : Current.DependsOn )
+  {
+    if ( m_Stages[static_cast<size_t>( Dependency )].State != Status::DONE )
+    {
+      return false;
+    }
+    else
+    {;}
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief True when a dependency failed or was skipped. Call it with the mutex locked.
+ **/
+bool StartupSequence::MustBeSkipped_Pvt( const Stage& Current ) const
+{
+  for ( int Dependency : Current.DependsOn )
+  {
+    const Status State = m_Stages[static_cast<size_t>( Dependency )].State;
+
+    if ( State == Status::FAILED || State == Status::SKIPPED )
+    {
+      return true;
+    }
+    else
+    {;}
+  }
+
+  return false;
+}
+
+
+/**
+ * @brief Runs and times a stage, then wakes up the calling thread of "Run". Call it with the mutex
+ * unlocked.
+ **/
+void StartupSequence::Execute_Pvt( Stage& Current )
+{
+  const Uint64 Start     = SDL_GetPerformanceCounter();
+  const bool   Succeeded = Current.Function ? Current.Function() : false;
+  const Uint64 End       = SDL_GetPerformanceCounter();
+
+  SDL_LockMutex( m_Mutex );
+
+  Current.Start = Start;
+  Current.End   = End;
+  Current.State = Succeeded ? Status::DONE : Status::FAILED;
+
+  SDL_CondBroadcast( m_Changed );
+  SDL_UnlockMutex( m_Mutex );
+}
+
+
+double StartupSequence::ToMilliseconds_Pvt( Uint64 Ticks ) const
+{
+  return static_cast<double>( Ticks ) * 1000.0 / static_cast<double>( m_Frequency );
+}
@@ -0,0 +1,94 @@
+/**
+ * @file StartupSequence.hpp
+ *
+ * @brief The start-up of the program as a list of stages with dependencies, run in parallel where
+ * the dependencies allow it, and timed.
+ **/
+
+#ifndef STARTUPSEQUENCE_HPP
+#define STARTUPSEQUENCE_HPP
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+/**
+ * @brief Start-up orchestrator. Each stage is a function returning whether it succeeded, the thread
+ * it must run on and the earlier stages it needs. "Run" starts every WORKER stage on its own thread
+ * as soon as its dependencies are done, and meanwhile runs the MAIN stages, in the order they were
+ * added, on the calling thread: whatever touches the window or the renderer must be a MAIN stage,
+ * because SDL wants them on the thread that initialised video.
+ *
+ * A stage whose dependency failed, or was skipped, is skipped. "PrintReport" shows when each stage
+ * started and how long it took; with "SetSerial" every stage runs on the calling thread, one after
+ * the other, so that the two start-ups can be compared.
+ **/
+class StartupSequence
+{
+public:
+
+  enum class Thread
+  {
+    MAIN = 0,
+    WORKER
+  };
+
+  using StageFunction = std::function<bool( void )>;
+
+   StartupSequence( void );
+  ~StartupSequence( void );
+
+  StartupSequence( const StartupSequence&  ) = delete;
+  StartupSequence(       StartupSequence&& ) = delete;
+
+  StartupSequence& operator=( const StartupSequence&  ) = delete;
+  StartupSequence& operator=(       StartupSequence&& ) = delete;
+
+  int  AddStage   ( const char*, Thread, StageFunction, std::initializer_list<int> = {} );
+  void SetSerial  ( bool );
+  bool Run        ( void );
+  void PrintReport( void ) const;
+
+private:
+
+  enum class Status
+  {
+    PENDING = 0,
+    RUNNING,
+    DONE,
+    FAILED,
+    SKIPPED
+  };
+
+  struct Stage
+  {
+    const char*       Name;
+    Thread            Where;
+    StageFunction     Function;
+    std::vector<int>  DependsOn;   // Indices of earlier stages
+    Status            State;
+    Uint64            Start;       // Performance counter when the function was called
+    Uint64            End;         // Performance counter when it returned
+    SDL_Thread*       Worker_Ptr;  // NULL for the stages run on the calling thread
+    StartupSequence*  Owner_Ptr;   // Lets the worker thread reach the mutex
+  };
+
+  static int WorkerThread_Pvt( void* );
+
+  bool   IsReady_Pvt      ( const Stage& ) const;
+  bool   MustBeSkipped_Pvt( const Stage& ) const;
+  void   Execute_Pvt      ( Stage& );
+  double ToMilliseconds_Pvt( Uint64 ) const;
+
+  std::vector<Stage> m_Stages;     // Not resized while "Run" is in progress
+  SDL_mutex*         m_Mutex;      // Guards the State of the stages
+  SDL_cond*          m_Changed;    // Signalled whenever a worker stage ends
+  bool               m_IsSerial;
+  Uint64             m_Frequency;  // Performance counter ticks per second
+  Uint64             m_Begin;      // Performance counter when "Run" was called
+  Uint64             m_End;        // Performance counter when it returned
+};
+
+#endif // STARTUPSEQUENCE_HPP
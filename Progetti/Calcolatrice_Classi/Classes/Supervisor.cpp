@@ -3,9 +3,27 @@
 ****************************************************************************************************/
 
 #include <iostream>
+#include <cstring>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
 #include "Supervisor.hpp"
 
 
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+static const char* ProfileCSV_Option     ("--profile-csv=");
+static const char* ProfileTrace_Option   ("--profile-trace=");
+static const char* LogLevel_Option       ("--log-level=");
+static const char* SerialStartup_Option  ("--serial-startup");
+static const char* Telemetry_Option      ("--telemetry=");
+static const char* TelemetryPeriod_Option("--telemetry-period=");
+
+static const Uint32 DefaultTelemetryPeriod_ms = 1000;
+
+
 /***************************************************************************************************
 * Methods
 ****************************************************************************************************/
@@ -14,7 +32,7 @@
  * @brief Constructor
  **/
 Supervisor::Supervisor(void)
-  : m_isThereAnyFault(false)
+  : m_isThereAnyFault(false), m_IsStartupSerial(false), m_MinimumLevel(FaultLevel::NO_FAULT)
 {
   std::cout << "\nInitialising Supervisor...\n";
   std::cout << "\tOK: Supervisor initialised.\n";
@@ -28,18 +46,6 @@ Supervisor::~Supervisor(void)
 {;}
 
 
-/**
- * @brief Creates instance of singleton in static memory
- *
- * @return Supervisor&
- **/
-Supervisor& Supervisor::Get(void)
-{
-  static Supervisor Instance;
-  return Instance;
-}
-
-
 void Supervisor::PressEnter(void)
 {
   int UserChoice = '\0';
@@ -51,20 +57,88 @@ void Supervisor::PressEnter(void)
 }
 
 
+/**
+ * @brief Prints the command line. "--profile-csv=<path>" and "--profile-trace=<path>" make the
+ * frame profiler save its traces at exit; "--log-level=warning" or "--log-level=blocking" hides
+ * the less severe messages; "--serial-startup" runs the start-up stages one after the other, to be
+ * compared with the parallel start-up. "--telemetry=<udp|tcp>:<host>:<port>" sends a report of the
+ * frames and faults to a collector every "--telemetry-period=<ms>" (1000 by default).
+ **/
 void Supervisor::StartDebuggingConsole( int argc, char* argv[] )
 {
+  const char* TelemetryAddress   = nullptr;
+  Uint32      TelemetryPeriod_ms = DefaultTelemetryPeriod_ms;
+
   printf( "\n*** Debugging console ***\n" );
   printf( "\tProgram \"%s\" started with %d additional arguments.\n", argv[0], argc - 1 ); // Il primo argomento è il nome dell'eseguibile
 
   for ( int i = 1; i != argc; ++i )
   {
     printf( "\tArgument #%d: %s\n", i, argv[i] );
+
+    if ( strncmp( argv[i], ProfileCSV_Option, strlen( ProfileCSV_Option ) ) == 0 )
+    {
+      m_Profiler.SetCSVPath( argv[i] + strlen( ProfileCSV_Option ) );
+    }
+    else if ( strncmp( argv[i], ProfileTrace_Option, strlen( ProfileTrace_Option ) ) == 0 )
+    {
+      m_Profiler.SetChromeTracePath( argv[i] + strlen( ProfileTrace_Option ) );
+    }
+    else if ( strncmp( argv[i], LogLevel_Option, strlen( LogLevel_Option ) ) == 0 )
+    {
+      const char* Level = argv[i] + strlen( LogLevel_Option );
+
+      if ( strcmp( Level, "warning" ) == 0 )
+      {
+        SetMinimumLevel( FaultLevel::WARNING );
+      }
+      else if ( strcmp( Level, "blocking" ) == 0 )
+      {
+        SetMinimumLevel( FaultLevel::BLOCKING );
+      }
+      else
+      {
+        SetMinimumLevel( FaultLevel::NO_FAULT );
+      }
+    }
+    else if ( strcmp( argv[i], SerialStartup_Option ) == 0 )
+    {
+      m_IsStartupSerial = true;
+    }
+    else if ( strncmp( argv[i], Telemetry_Option, strlen( Telemetry_Option ) ) == 0 )
+    {
+      TelemetryAddress = argv[i] + strlen( Telemetry_Option );
+    }
+    else if ( strncmp( argv[i], TelemetryPeriod_Option, strlen( TelemetryPeriod_Option ) ) == 0 )
+    {
+      TelemetryPeriod_ms = static_cast<Uint32>( strtoul( argv[i] + strlen( TelemetryPeriod_Option ), nullptr, 10 ) );
+    }
+    else
+    {;}
   }
+
+  // After the loop, so that the period may follow the address
+  if ( TelemetryAddress != nullptr )
+  {
+    m_Telemetry.Start( TelemetryAddress, TelemetryPeriod_ms );
+  }
+  else
+  {;}
 }
 
 
+/**
+ * @brief Sends the last telemetry report, prints the allocation summary, then whether a fault was
+ * raised.
+ **/
 void Supervisor::PerformIntegrityCheck( void )
 {
+  m_Telemetry.Stop(); // Before waiting for ENTER, which nobody presses on a kiosk
+
+  FlushMessages(); // Keep the console in order
+
+  m_Allocations.PrintSummary();
+
   if ( m_isThereAnyFault  )
   {
     printf( "\nThere was a problem during the execution of the program!\n" );
@@ -82,28 +156,112 @@ void Supervisor::PerformIntegrityCheck( void )
 void Supervisor::RaiseFault( void )
 {
   m_isThereAnyFault = true;
+  m_Telemetry.RecordEvent( TelemetrySink::Event::FAULT, "Fault raised" );
 }
 
 
+/**
+ * @brief Queues a message for the console. The calling thread never waits for the console, but a
+ * BLOCKING message is written before the program exits.
+ *
+ * @param Msg The message.
+ * @param Level Messages below the minimum level are discarded.
+ **/
 void Supervisor::PrintMessage ( const std::string& Msg, FaultLevel Level)
 {
+  if ( !IsLevelEnabled( Level ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  Enqueue_Pvt( Level, Msg.c_str() );
+}
+
+
+/**
+ * @brief Like PrintMessage, but formats printf-style into a stack buffer. Use it on hot paths:
+ * nothing is allocated, and nothing is formatted if the level is disabled.
+ *
+ * @param Level Messages below the minimum level are discarded.
+ * @param Format printf format string; the message is truncated to LogQueue::s_RECORD_LENGTH.
+ **/
+void Supervisor::PrintFormatted( FaultLevel Level, const char* Format, ... )
+{
+  if ( !IsLevelEnabled( Level ) )
+  {
+    return;
+  }
+  else
+  {;}
+
+  char Msg[LogQueue::s_RECORD_LENGTH];
+
+  va_list Args;
+  va_start( Args, Format );
+  vsnprintf( Msg, sizeof(Msg), Format, Args );
+  va_end( Args );
+
+  Enqueue_Pvt( Level, Msg );
+}
+
+
+/**
+ * @brief Waits until every queued message has been written to the console.
+ **/
+void Supervisor::FlushMessages( void )
+{
+  m_LogQueue.flush();
+}
+
+
+/**
+ * @brief Messages below "Level" are discarded. BLOCKING messages are always printed.
+ **/
+void Supervisor::SetMinimumLevel( FaultLevel Level )
+{
+  m_MinimumLevel = ( Level > FaultLevel::BLOCKING ) ? FaultLevel::BLOCKING : Level;
+}
+
+
+bool Supervisor::IsLevelEnabled( FaultLevel Level ) const
+{
+  return Level >= m_MinimumLevel;
+}
+
+
+/**
+ * @brief Adds the severity prefix and hands the record to the log queue.
+ **/
+void Supervisor::Enqueue_Pvt( FaultLevel Level, const char* Msg )
+{
+  char Record[LogQueue::s_RECORD_LENGTH];
+
   switch ( Level )
   {
   case FaultLevel::NO_FAULT:
-    std::cout << "\nSupervisor OK: " << Msg;
+    snprintf( Record, sizeof(Record), "\nSupervisor OK: %s", Msg );
+    m_LogQueue.push( Record, false );
     break;
 
   case FaultLevel::WARNING:
-    std::cerr << "\nSupervisor WARNING: " << Msg;
+    snprintf( Record, sizeof(Record), "\nSupervisor WARNING: %s", Msg );
+    m_LogQueue.push( Record, true );
+    m_Telemetry.RecordEvent( TelemetrySink::Event::WARNING, Msg );
     break;
 
   case FaultLevel::BLOCKING:
-    std::cerr << "\nSupervisor BLOCKING FAULT: "  << Msg;
+    snprintf( Record, sizeof(Record), "\nSupervisor BLOCKING FAULT: %s", Msg );
+    m_LogQueue.push( Record, true );
+    m_Telemetry.RecordEvent( TelemetrySink::Event::BLOCKING, Msg );
+    m_Telemetry.Flush(); // The collector learns why the kiosk went down
+    m_LogQueue.flush();
     std::exit(EXIT_FAILURE); // TODO: GS solo per test. Non va bene uscire così in caso di errore!
     break;
 
   default:
-    std::cerr << "\nUnexpected error.";
+    m_LogQueue.push( "\nUnexpected error.", true );
     break;
   }
 }
@@ -112,4 +270,28 @@ void Supervisor::PrintMessage ( const std::string& Msg, FaultLevel Level)
 bool Supervisor::IsThereAnyFault( void )
 {
   return m_isThereAnyFault;
+}
+
+
+bool Supervisor::IsStartupSerial( void ) const
+{
+  return m_IsStartupSerial;
+}
+
+
+FrameProfiler& Supervisor::GetProfiler( void )
+{
+  return m_Profiler;
+}
+
+
+AllocationTracker& Supervisor::GetAllocations( void )
+{
+  return m_Allocations;
+}
+
+
+TelemetrySink& Supervisor::GetTelemetry( void )
+{
+  return m_Telemetry;
 }
\ No newline at end of file
@@ -8,6 +8,11 @@
 #define SUPERVISOR_HPP
 
 #include <string>
+#include "AllocationTracker.hpp"
+#include "FrameProfiler.hpp"
+#include "LogQueue.hpp"
+#include "ServiceRegistry.hpp"
+#include "TelemetrySink.hpp"
 
 
 /**
@@ -32,18 +37,37 @@ public:
   Supervisor& operator=( const Supervisor&  ) = delete;
   Supervisor& operator=(       Supervisor&& ) = delete;
 
-  static Supervisor& Get(void);
+  static Supervisor& Get( void ) { return Service<Supervisor>::Get(); } // Created by the ServiceRegistry in main
 
   void StartDebuggingConsole( int, char* [] );
   void PressEnter           ( void );
   void PerformIntegrityCheck( void );
   void RaiseFault           ( void );
   void PrintMessage         ( const std::string&, FaultLevel = FaultLevel::NO_FAULT);
+  void PrintFormatted       ( FaultLevel, const char*, ... );
+  void FlushMessages        ( void );
+  void SetMinimumLevel      ( FaultLevel );
+  bool IsLevelEnabled       ( FaultLevel ) const;
   bool IsThereAnyFault      ( void );
+  bool IsStartupSerial      ( void ) const;
+
+  FrameProfiler&     GetProfiler   ( void );
+  AllocationTracker& GetAllocations( void );
+  TelemetrySink&     GetTelemetry  ( void );
 
 private:
 
-  bool m_isThereAnyFault; // Raised when there is a problem during execution
+  friend class ServiceSlot<Supervisor>;
+
+  bool          m_isThereAnyFault; // Raised when there is a problem during execution
+  bool          m_IsStartupSerial; // "--serial-startup": no start-up stage runs in parallel
+  FaultLevel    m_MinimumLevel;    // Messages below this level are discarded before formatting
+  FrameProfiler     m_Profiler;     // Times every frame of the main loop
+  AllocationTracker m_Allocations;  // Counts the heap allocations of every frame
+  LogQueue          m_LogQueue;     // Messages are written to the console by a background thread
+  TelemetrySink     m_Telemetry;    // "--telemetry=": reports sent to a remote collector
+
+  void Enqueue_Pvt( FaultLevel, const char* );
 
    Supervisor( void );
   ~Supervisor( void );
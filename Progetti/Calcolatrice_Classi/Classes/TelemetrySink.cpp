@@ -0,0 +1,633 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "TelemetrySink.hpp"
+#include "AllocationTracker.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+#else
+  #include <netdb.h>
+  #include <sys/socket.h>
+  #include <unistd.h>
+#endif
+
+
+/***************************************************************************************************
+* Private types
+****************************************************************************************************/
+
+#if defined(_WIN32)
+  typedef SOCKET    SocketHandle;
+  typedef int       AddressLength;
+  typedef int       SendLength;
+#else
+  typedef int       SocketHandle;
+  typedef socklen_t AddressLength;
+  typedef size_t    SendLength;
+#endif
+
+
+/***************************************************************************************************
+* Private constants
+****************************************************************************************************/
+
+#if defined(_WIN32)
+  static const SocketHandle NO_SOCKET  = INVALID_SOCKET;
+  static const int          SEND_FLAGS = 0;
+#elif defined(MSG_NOSIGNAL)
+  static const SocketHandle NO_SOCKET  = -1;
+  static const int          SEND_FLAGS = MSG_NOSIGNAL; // A lost TCP connection must not raise SIGPIPE
+#else
+  static const SocketHandle NO_SOCKET  = -1;
+  static const int          SEND_FLAGS = 0;
+#endif
+
+static constexpr Uint32 IDLE_WAIT_ms = 100; // Upper bound on the latency of a missed wake-up
+
+// Upper edges of the buckets of busy time, the last bucket taking the rest: 1 to 8 ms, then 1, 2,
+// 4 and 8 frames at 60 Hz
+static const double BucketEdges_ms[] = { 1.0, 2.0, 4.0, 8.0, 16.7, 33.3, 66.7, 133.3 };
+
+static const char* EventNames[] = { "warning", "blocking", "fault" };
+
+static_assert( sizeof(EventNames) / sizeof(EventNames[0]) == static_cast<size_t>( TelemetrySink::Event::HOW_MANY ),
+               "A name is needed for each event" );
+
+static const char* Address_Usage( "expected udp:<host>:<port> or tcp:<host>:<port>" );
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+static void CloseSocket( SocketHandle Socket )
+{
+#if defined(_WIN32)
+  closesocket( Socket );
+#else
+  close( Socket );
+#endif
+}
+
+
+/**
+ * @brief Resolves the collector and connects to the first of its addresses that accepts. A UDP
+ * socket is connected too, so that both are written with "send".
+ *
+ * @return NO_SOCKET if the host is unknown or nobody accepts.
+ **/
+static SocketHandle OpenSocket( const char* Host, const char* Port, bool IsTCP )
+{
+  addrinfo  Hints;
+  addrinfo* Found_Ptr = nullptr;
+
+  memset( &Hints, 0, sizeof(Hints) );
+  Hints.ai_family   = AF_UNSPEC;
+  Hints.ai_socktype = IsTCP ? SOCK_STREAM : SOCK_DGRAM;
+
+  if ( getaddrinfo( Host, Port, &Hints, &Found_Ptr ) != 0 )
+  {
+    return NO_SOCKET;
+  }
+  else
+  {;}
+
+  SocketHandle Socket = NO_SOCKET;
+
+  for ( addrinfo* Each_Ptr = Found_Ptr; Each_Ptr != nullptr && Socket == NO_SOCKET; Each_Ptr = Each_Ptr->ai_next )
+  {
+    Socket = socket( Each_Ptr->ai_family, Each_Ptr->ai_socktype, Each_Ptr->ai_protocol );
+
+    if ( Socket != NO_SOCKET && connect( Socket, Each_Ptr->ai_addr, static_cast<AddressLength>( Each_Ptr->ai_addrlen ) ) != 0 )
+    {
+      CloseSocket( Socket );
+      Socket = NO_SOCKET;
+    }
+    else
+    {;}
+  }
+
+  freeaddrinfo( Found_Ptr );
+
+  return Socket;
+}
+
+
+/**
+ * @return true if the whole packet was sent: TCP may take it in several pieces.
+ **/
+static bool SendAll( SocketHandle Socket, const char* Data, size_t Size )
+{
+  while ( Size != 0 )
+  {
+    const int Sent = static_cast<int>( send( Socket, Data, static_cast<SendLength>( Size ), SEND_FLAGS ) );
+
+    if ( Sent <= 0 )
+    {
+      return false;
+    }
+    else
+    {;}
+
+    Data += Sent;
+    Size -= static_cast<size_t>( Sent );
+  }
+
+  return true;
+}
+
+
+/**
+ * @brief printf-style append to a buffer; what does not fit is cut, and Length stops at the end.
+ **/
+static void Append( char* Buffer, size_t Size, size_t& Length, const char* Format, ... )
+{
+  if ( Length + 1 >= Size )
+  {
+    return;
+  }
+  else
+  {;}
+
+  va_list Args;
+  va_start( Args, Format );
+  const int Written = vsnprintf( Buffer + Length, Size - Length, Format, Args );
+  va_end( Args );
+
+  if ( Written > 0 )
+  {
+    Length = std::min( Size - 1, Length + static_cast<size_t>( Written ) );
+  }
+  else
+  {;}
+}
+
+
+/**
+ * @brief Appends Text as the body of a JSON string: quotes, backslashes and control characters are
+ * escaped.
+ **/
+static void AppendEscaped( char* Buffer, size_t Size, size_t& Length, const char* Text )
+{
+  for ( ; *Text != '\0'; ++Text )
+  {
+    const unsigned char Character = static_cast<unsigned char>( *Text );
+
+    if ( Character == '"' || Character == '\\' )
+    {
+      Append( Buffer, Size, Length, "\\%c", Character );
+    }
+    else if ( Character < 0x20 )
+    {
+      Append( Buffer, Size, Length, "\\u%04x", static_cast<unsigned>( Character ) );
+    }
+    else
+    {
+      Append( Buffer, Size, Length, "%c", Character );
+    }
+  }
+}
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+TelemetrySink::TelemetrySink( void )
+  : m_Current(), m_Queue(), m_Head(0), m_NumOfQueued(0), m_IsSending(false), m_Dropped(0), m_Sequence(0),
+    m_Period_ms(0), m_IsTCP(false), m_IsQuitting(false), m_Lock(NULL), m_WakeUp(NULL), m_Sender(NULL)
+{;}
+
+
+TelemetrySink::~TelemetrySink( void )
+{
+  Stop();
+}
+
+
+/**
+ * @brief Starts sending a report every Period_ms to a collector.
+ *
+ * @param Address "udp:<host>:<port>" or "tcp:<host>:<port>"; an IPv6 host goes in brackets.
+ * @param Period_ms Length of a period, at least 100 ms.
+ * @return false if the address is not valid, the sink was already started or the thread could not
+ * be created: the sink stays disabled.
+ **/
+bool TelemetrySink::Start( const char* Address, Uint32 Period_ms )
+{
+  if ( m_Sender != NULL )
+  {
+    printf( "\nTelemetry is already being sent to %s:%s.", m_Host.c_str(), m_Port.c_str() );
+    return false;
+  }
+  else
+  {;}
+
+  const std::string Text( Address );
+  const size_t      HostStart = Text.find( ':' ) + 1;
+  const size_t      PortStart = Text.rfind( ':' ) + 1;
+
+  m_IsTCP = ( Text.compare( 0, HostStart, "tcp:" ) == 0 );
+  m_Host  = Text.substr( HostStart, ( PortStart > HostStart ) ? PortStart - 1 - HostStart : 0 );
+  m_Port  = Text.substr( PortStart );
+
+  if ( m_Host.size() > 2 && m_Host.front() == '[' && m_Host.back() == ']' )
+  {
+    m_Host = m_Host.substr( 1, m_Host.size() - 2 );
+  }
+  else
+  {;}
+
+  if ( ( !m_IsTCP && Text.compare( 0, HostStart, "udp:" ) != 0 ) || m_Host.empty() || m_Port.empty() )
+  {
+    printf( "\nInvalid telemetry address \"%s\": %s.", Address, Address_Usage );
+    return false;
+  }
+  else
+  {;}
+
+#if defined(_WIN32)
+  WSADATA Data;
+
+  if ( WSAStartup( MAKEWORD( 2, 2 ), &Data ) != 0 )
+  {
+    printf( "\nTelemetry disabled: Winsock could not be initialised." );
+    return false;
+  }
+  else
+  {;}
+#endif
+
+  char Name[64] = {}; // The last character stays the terminator
+
+  m_Device    = ( gethostname( Name, sizeof(Name) - 1 ) == 0 ) ? Name : "unknown";
+  m_Period_ms = std::max<Uint32>( Period_ms, 100 );
+  m_Lock      = SDL_CreateMutex();
+  m_WakeUp    = SDL_CreateSemaphore( 0 );
+
+  m_Current          = Report();
+  m_Current.Start_ms = SDL_GetTicks64();
+  m_IsQuitting.store( false );
+
+  if ( m_Lock != NULL && m_WakeUp != NULL )
+  {
+    m_Sender = SDL_CreateThread( Sender_Pvt, "TelemetrySender", this );
+  }
+  else
+  {;}
+
+  if ( m_Sender == NULL )
+  {
+    printf( "\nTelemetry thread could not be created, telemetry disabled. SDL Error: %s", SDL_GetError() );
+
+    SDL_DestroySemaphore( m_WakeUp );
+    SDL_DestroyMutex( m_Lock );
+    m_WakeUp = NULL;
+    m_Lock   = NULL;
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+    return false;
+  }
+  else
+  {;}
+
+  printf( "\nTelemetry of \"%s\" sent every %u ms to %s:%s over %s.", m_Device.c_str(), m_Period_ms, m_Host.c_str(), m_Port.c_str(),
+          m_IsTCP ? "TCP" : "UDP" );
+
+  return true;
+}
+
+
+/**
+ * @brief Sends the period in progress and the queued reports, then stops the thread. The sink is
+ * disabled until the next "Start".
+ **/
+void TelemetrySink::Stop( void )
+{
+  if ( m_Sender == NULL )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_LockMutex( m_Lock );
+  ClosePeriod_Pvt( SDL_GetTicks64() );
+  SDL_UnlockMutex( m_Lock );
+
+  m_IsQuitting.store( true );
+  SDL_SemPost( m_WakeUp );
+  SDL_WaitThread( m_Sender, NULL );
+
+  SDL_DestroySemaphore( m_WakeUp );
+  SDL_DestroyMutex( m_Lock );
+
+  m_Sender      = NULL;
+  m_WakeUp      = NULL;
+  m_Lock        = NULL;
+  m_Head        = 0;
+  m_NumOfQueued = 0;
+
+#if defined(_WIN32)
+  WSACleanup();
+#endif
+}
+
+
+/**
+ * @brief Sends the period in progress now, and waits up to s_FLUSH_ms for the queue to be sent:
+ * for before the program exits on a blocking fault. Must not be called by the sender thread.
+ **/
+void TelemetrySink::Flush( void )
+{
+  if ( m_Sender == NULL )
+  {
+    return;
+  }
+  else
+  {;}
+
+  const Uint64 Deadline = SDL_GetTicks64() + s_FLUSH_ms;
+
+  SDL_LockMutex( m_Lock );
+  ClosePeriod_Pvt( SDL_GetTicks64() );
+
+  while ( ( m_NumOfQueued != 0 || m_IsSending ) && SDL_GetTicks64() < Deadline )
+  {
+    SDL_UnlockMutex( m_Lock );
+    SDL_Delay( 1 );
+    SDL_LockMutex( m_Lock );
+  }
+
+  SDL_UnlockMutex( m_Lock );
+}
+
+
+/**
+ * @brief Counts a fault in the current period, with its message if the period has room for it. Safe
+ * to call from any thread.
+ **/
+void TelemetrySink::RecordEvent( Event Kind, const char* Text )
+{
+  if ( m_Sender == NULL )
+  {
+    return;
+  }
+  else
+  {;}
+
+  SDL_LockMutex( m_Lock );
+
+  ++m_Current.Events[static_cast<size_t>( Kind )];
+
+  if ( m_Current.NumOfMessages != s_MAX_MESSAGES )
+  {
+    Message& Slot = m_Current.Messages[m_Current.NumOfMessages++];
+
+    Slot.Kind = Kind;
+    strncpy( Slot.Text, Text, s_MESSAGE_LENGTH - 1 );
+    Slot.Text[s_MESSAGE_LENGTH - 1] = '\0';
+  }
+  else
+  {;}
+
+  SDL_UnlockMutex( m_Lock );
+}
+
+
+void TelemetrySink::RecordFrame_Pvt( double Busy_ms, Uint64 Allocations, Uint64 DrawCalls )
+{
+  size_t Bucket = 0;
+
+  while ( Bucket != s_NUM_OF_BUCKETS - 1 && Busy_ms > BucketEdges_ms[Bucket] )
+  {
+    ++Bucket;
+  }
+
+  const Uint64 Now = SDL_GetTicks64();
+
+  SDL_LockMutex( m_Lock );
+
+  ++m_Current.Frames;
+  ++m_Current.Histogram[Bucket];
+  m_Current.MaxBusy_ms             = std::max( m_Current.MaxBusy_ms, Busy_ms );
+  m_Current.Allocations           += Allocations;
+  m_Current.FramesWithAllocations += ( Allocations != 0 ) ? 1 : 0;
+  m_Current.DrawCalls             += DrawCalls;
+  m_Current.MaxDrawCalls           = std::max( m_Current.MaxDrawCalls, DrawCalls );
+
+  if ( Now - m_Current.Start_ms >= m_Period_ms )
+  {
+    ClosePeriod_Pvt( Now );
+  }
+  else
+  {;}
+
+  SDL_UnlockMutex( m_Lock );
+}
+
+
+/**
+ * @brief Queues the current period, if it saw any frame or event, and starts the next one at Now.
+ * The caller holds the lock.
+ **/
+void TelemetrySink::ClosePeriod_Pvt( Uint64 Now )
+{
+  if ( m_Current.Frames == 0 && m_Current.NumOfMessages == 0 && m_Current.Events == decltype( m_Current.Events )() )
+  {
+    return;
+  }
+  else
+  {;}
+
+  m_Current.Sequence     = m_Sequence++;
+  m_Current.Duration_ms  = Now - m_Current.Start_ms;
+  m_Current.TextureBytes = AllocationTracker::GetTextureMemory();
+  m_Current.Dropped      = m_Dropped;
+  m_Dropped              = 0;
+
+  if ( m_NumOfQueued == s_QUEUE_LENGTH )
+  {
+    m_Head = ( m_Head + 1 ) % s_QUEUE_LENGTH; // The oldest makes room
+    --m_NumOfQueued;
+    ++m_Dropped;
+  }
+  else
+  {;}
+
+  m_Queue[( m_Head + m_NumOfQueued ) % s_QUEUE_LENGTH] = m_Current;
+  ++m_NumOfQueued;
+
+  m_Current          = Report();
+  m_Current.Start_ms = Now;
+
+  SDL_SemPost( m_WakeUp );
+}
+
+
+/**
+ * @brief Takes the oldest queued report; the sender holds it until EndSend_Pvt.
+ **/
+bool TelemetrySink::Pop_Pvt( Report& Oldest )
+{
+  SDL_LockMutex( m_Lock );
+
+  const bool IsFound = ( m_NumOfQueued != 0 );
+
+  if ( IsFound )
+  {
+    Oldest      = m_Queue[m_Head];
+    m_Head      = ( m_Head + 1 ) % s_QUEUE_LENGTH;
+    m_IsSending = true;
+    --m_NumOfQueued;
+  }
+  else
+  {;}
+
+  SDL_UnlockMutex( m_Lock );
+
+  return IsFound;
+}
+
+
+void TelemetrySink::EndSend_Pvt( bool IsSent )
+{
+  SDL_LockMutex( m_Lock );
+
+  m_IsSending = false;
+  m_Dropped  += IsSent ? 0 : 1;
+
+  SDL_UnlockMutex( m_Lock );
+}
+
+
+/**
+ * @brief Writes a report as one line of JSON.
+ *
+ * @return The length of the line, newline included.
+ **/
+size_t TelemetrySink::Format_Pvt( const Report& Sent, char* Buffer, size_t Size ) const
+{
+  size_t Length = 0;
+
+  Append( Buffer, Size, Length, "{\"device\":\"" );
+  AppendEscaped( Buffer, Size, Length, m_Device.c_str() );
+  Append( Buffer, Size, Length, "\",\"seq\":%llu,\"start_ms\":%llu,\"period_ms\":%llu,\"frames\":%u,\"busy_ms_edges\":[",
+          static_cast<unsigned long long>( Sent.Sequence ), static_cast<unsigned long long>( Sent.Start_ms ),
+          static_cast<unsigned long long>( Sent.Duration_ms ), Sent.Frames );
+
+  for ( size_t i = 0; i != s_NUM_OF_BUCKETS - 1; ++i )
+  {
+    Append( Buffer, Size, Length, ( i == 0 ) ? "%.1f" : ",%.1f", BucketEdges_ms[i] );
+  }
+
+  Append( Buffer, Size, Length, "],\"busy_ms_histogram\":[" );
+
+  for ( size_t i = 0; i != s_NUM_OF_BUCKETS; ++i )
+  {
+    Append( Buffer, Size, Length, ( i == 0 ) ? "%u" : ",%u", Sent.Histogram[i] );
+  }
+
+  Append( Buffer, Size, Length, "],\"busy_ms_max\":%.3f,\"allocations\":%llu,\"frames_with_allocations\":%u,\"draw_calls\":%llu,"
+          "\"draw_calls_max\":%llu,\"texture_bytes\":%llu,\"events\":{", Sent.MaxBusy_ms, static_cast<unsigned long long>( Sent.Allocations ),
+          Sent.FramesWithAllocations, static_cast<unsigned long long>( Sent.DrawCalls ), static_cast<unsigned long long>( Sent.MaxDrawCalls ),
+          static_cast<unsigned long long>( Sent.TextureBytes ) );
+
+  for ( size_t i = 0; i != s_NUM_OF_EVENTS; ++i )
+  {
+    Append( Buffer, Size, Length, ( i == 0 ) ? "\"%s\":%u" : ",\"%s\":%u", EventNames[i], Sent.Events[i] );
+  }
+
+  Append( Buffer, Size, Length, "},\"messages\":[" );
+
+  for ( Uint32 i = 0; i != Sent.NumOfMessages; ++i )
+  {
+    Append( Buffer, Size, Length, ( i == 0 ) ? "{\"level\":\"%s\",\"text\":\"" : ",{\"level\":\"%s\",\"text\":\"",
+            EventNames[static_cast<size_t>( Sent.Messages[i].Kind )] );
+    AppendEscaped( Buffer, Size, Length, Sent.Messages[i].Text );
+    Append( Buffer, Size, Length, "\"}" );
+  }
+
+  Append( Buffer, Size, Length, "],\"dropped_reports\":%u}\n", Sent.Dropped );
+
+  return Length;
+}
+
+
+/**
+ * @brief Background thread: sends the reports as they are queued, connecting when it has one to send
+ * and no connection, at most every s_RETRY_ms. Sends what is left in the queue before quitting.
+ **/
+int TelemetrySink::Sender_Pvt( void* Data )
+{
+  TelemetrySink* This = static_cast<TelemetrySink*>( Data );
+
+  AllocationTracker::ScopedTag Tag( AllocationTracker::Tag::LOGGING ); // For the whole thread
+
+  SocketHandle Socket         = NO_SOCKET;
+  Uint64       LastAttempt_ms = 0;
+  bool         HasAttempted   = false;
+  Report       Pending;
+  char         Packet[s_PACKET_LENGTH];
+
+  for (;;)
+  {
+    const bool IsQuitting = This->m_IsQuitting.load(); // Read before the queue, so nothing is left behind
+
+    while ( This->Pop_Pvt( Pending ) )
+    {
+      const Uint64 Now = SDL_GetTicks64();
+
+      if ( Socket == NO_SOCKET && ( !HasAttempted || Now - LastAttempt_ms >= s_RETRY_ms ) )
+      {
+        Socket         = OpenSocket( This->m_Host.c_str(), This->m_Port.c_str(), This->m_IsTCP );
+        LastAttempt_ms = Now;
+        HasAttempted   = true;
+      }
+      else
+      {;}
+
+      const size_t Length = This->Format_Pvt( Pending, Packet, sizeof(Packet) );
+      const bool   IsSent = ( Socket != NO_SOCKET && SendAll( Socket, Packet, Length ) );
+
+      if ( !IsSent && Socket != NO_SOCKET )
+      {
+        CloseSocket( Socket ); // Connected again for a later report
+        Socket = NO_SOCKET;
+      }
+      else
+      {;}
+
+      This->EndSend_Pvt( IsSent );
+    }
+
+    if ( IsQuitting )
+    {
+      break;
+    }
+    else
+    {;}
+
+    SDL_SemWaitTimeout( This->m_WakeUp, IDLE_WAIT_ms );
+  }
+
+  if ( Socket != NO_SOCKET )
+  {
+    CloseSocket( Socket );
+  }
+  else
+  {;}
+
+  return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file TelemetrySink.hpp
+ *
+ * @brief Periodic performance reports sent to a remote collector over UDP or TCP. Owned by the
+ * Supervisor.
+ **/
+
+#ifndef TELEMETRYSINK_HPP
+#define TELEMETRYSINK_HPP
+
+#include <SDL.h>
+#include <SDL_thread.h>
+#include <array>
+#include <atomic>
+#include <string>
+
+/**
+ * @brief Sums up the frames of every period of "Period_ms" (a histogram of the busy times, the heap
+ * allocations and the draw calls), with the texture memory at its end and the faults raised during
+ * it, and sends each period as one line of JSON to a collector, for machines nobody watches.
+ *
+ * Disabled until "Start": no thread, no socket, and "RecordFrame" is a single test. Once started,
+ * the main loop only adds to the current period, under a lock nobody else holds for long; a period
+ * is closed by the first frame ending after it, so an idle program sends nothing until its next
+ * frame, and the report tells the actual length. Closed reports wait in a queue of s_QUEUE_LENGTH;
+ * when the collector is slower, the oldest one is dropped and counted in the next report.
+ *
+ * A background thread resolves the collector, connects and sends: the main loop never waits for the
+ * network. UDP sends each report as a datagram, TCP as a stream of lines; a TCP connection that is
+ * refused or lost is tried again every s_RETRY_ms, losing the reports in between.
+ **/
+class TelemetrySink
+{
+public:
+
+  enum class Event
+  {
+    WARNING = 0, // A warning message
+    BLOCKING,    // A blocking fault: the program is about to exit
+    FAULT,       // A fault raised without a message
+
+    HOW_MANY
+  };
+
+   TelemetrySink( void );
+  ~TelemetrySink( void );
+
+  TelemetrySink( const TelemetrySink&  ) = delete;
+  TelemetrySink(       TelemetrySink&& ) = delete;
+
+  TelemetrySink& operator=( const TelemetrySink&  ) = delete;
+  TelemetrySink& operator=(       TelemetrySink&& ) = delete;
+
+  bool Start      ( const char*, Uint32 );
+  void Stop       ( void );
+  void Flush      ( void );
+  void RecordEvent( Event, const char* );
+
+  bool IsEnabled  ( void ) const { return m_Sender != NULL; }
+
+  /**
+   * @brief Adds a frame to the current period, and sends the period if it is over. A mere test when
+   * the sink was not started.
+   **/
+  void RecordFrame( double Busy_ms, Uint64 Allocations, Uint64 DrawCalls )
+  {
+    if ( m_Sender != NULL )
+    {
+      RecordFrame_Pvt( Busy_ms, Allocations, DrawCalls );
+    }
+    else
+    {;}
+  }
+
+private:
+
+  static constexpr size_t s_QUEUE_LENGTH   = 16;   // Reports waiting for the network
+  static constexpr size_t s_NUM_OF_BUCKETS = 9;    // Of the histogram of busy times
+  static constexpr size_t s_NUM_OF_EVENTS  = static_cast<size_t>( Event::HOW_MANY );
+  static constexpr size_t s_MAX_MESSAGES   = 8;    // Per report; the others are only counted
+  static constexpr size_t s_MESSAGE_LENGTH = 96;   // Longer messages are truncated
+  static constexpr Uint32 s_RETRY_ms       = 5000;
+  static constexpr Uint32 s_FLUSH_ms       = 1000; // Longest wait for the queue to be sent
+  static constexpr size_t s_PACKET_LENGTH  = 4096; // Of a formatted report
+
+  struct Message
+  {
+    Event Kind;
+    char  Text[s_MESSAGE_LENGTH];
+  };
+
+  struct Report
+  {
+    Uint64 Sequence;
+    Uint64 Start_ms;               // SDL_GetTicks64 at the start of the period
+    Uint64 Duration_ms;
+    Uint32 Frames;
+    std::array<Uint32, s_NUM_OF_BUCKETS> Histogram;
+    double MaxBusy_ms;
+    Uint64 Allocations;
+    Uint32 FramesWithAllocations;
+    Uint64 DrawCalls;
+    Uint64 MaxDrawCalls;
+    size_t TextureBytes;           // At the end of the period
+    std::array<Uint32, s_NUM_OF_EVENTS> Events;
+    std::array<Message, s_MAX_MESSAGES> Messages;
+    Uint32 NumOfMessages;
+    Uint32 Dropped;                // Reports lost since the previous one was queued
+  };
+
+  static int Sender_Pvt( void* );
+
+  void   RecordFrame_Pvt( double, Uint64, Uint64 );
+  void   ClosePeriod_Pvt( Uint64 );
+  bool   Pop_Pvt        ( Report& );
+  void   EndSend_Pvt    ( bool );
+  size_t Format_Pvt     ( const Report&, char*, size_t ) const;
+
+  // Guarded by m_Lock
+  Report                             m_Current;     // The period being summed up
+  std::array<Report, s_QUEUE_LENGTH> m_Queue;       // Closed periods, oldest at m_Head
+  size_t                             m_Head;
+  size_t                             m_NumOfQueued;
+  bool                               m_IsSending;   // The sender holds a report out of the queue
+  Uint32                             m_Dropped;     // Reports lost since the last one was queued
+  Uint64                             m_Sequence;
+
+  // Set by Start
+  Uint32                             m_Period_ms;
+  bool                               m_IsTCP;
+  std::string                        m_Host;
+  std::string                        m_Port;
+  std::string                        m_Device;      // Host name of this machine
+  std::atomic<bool>                  m_IsQuitting;
+  SDL_mutex*                         m_Lock;
+  SDL_sem*                           m_WakeUp;
+  SDL_Thread*                        m_Sender;
+};
+
+#endif // TELEMETRYSINK_HPP
@@ -1,7 +1,17 @@
 #include "Texture.hpp"
+#include "AllocationTracker.hpp"
 #include "Renderer.hpp"
-#include "colours.hpp"
-#include <SDL_Image.h>
+#include "Supervisor.hpp"
+#include "TextureCache.hpp"
+
+
+/**
+ * @brief Estimated video memory of a texture, as counted by the allocation tracker.
+ **/
+static size_t GetFootprint_B( int Width_px, int Height_px )
+{
+  return static_cast<size_t>( Width_px ) * static_cast<size_t>( Height_px ) * 4;
+}
 
 
 Texture::Texture(void)
@@ -11,6 +21,43 @@ Texture::Texture(void)
 }
 
 
+/**
+ * @brief Takes over the SDL texture of another instance, which is left empty.
+ **/
+Texture::Texture(Texture&& Other) noexcept
+  : m_Texture( Other.m_Texture ), m_Width( Other.m_Width ), m_Height( Other.m_Height )
+{
+  Other.m_Texture = NULL;
+  Other.m_Width   = 0;
+  Other.m_Height  = 0;
+}
+
+
+/**
+ * @brief Frees the current SDL texture, then takes over the one of another instance, which is left
+ * empty.
+ **/
+Texture& Texture::operator=(Texture&& Other) noexcept
+{
+  if ( this != &Other )
+  {
+    free();
+
+    m_Texture = Other.m_Texture;
+    m_Width   = Other.m_Width;
+    m_Height  = Other.m_Height;
+
+    Other.m_Texture = NULL;
+    Other.m_Width   = 0;
+    Other.m_Height  = 0;
+  }
+  else
+  {;}
+
+  return *this;
+}
+
+
 /**
  * @brief Deallocates dynamic memory.
  **/
@@ -22,8 +69,10 @@ Texture::~Texture(void)
 
 
 /**
- * @brief Loads an image to be used as a texture.
- * 
+ * @brief Loads an image to be used as a texture. The image is shared, through the texture cache,
+ * with every other texture loaded from the same path for the same renderer; as a consequence, colour
+ * modulation, alpha and blending set on it apply to all of them.
+ *
  * @param Path The path of the source image.
  * @param Renderer_Ptr The SDL renderer that will render this texture.
  * @return true if successful; false otherwise.
@@ -33,45 +82,60 @@ bool Texture::loadFromFile( const std::string& Path, SDL_Renderer* Renderer_Ptr
   // Get rid of preexisting texture
   free();
 
-  // The final texture
-  SDL_Texture* newTexture = NULL;
+  m_Texture = TextureCache::Get().acquire( Path, Renderer_Ptr, &m_Width, &m_Height );
 
-  // Load image at specified path
-  SDL_Surface* loadedSurface = IMG_Load( Path.c_str() );
+  return m_Texture != NULL;
+}
 
-  if( loadedSurface == NULL )
-  {
-    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
-  }
-  else
-  {
-    printf( "\nImage \"%s\" loaded", Path.c_str() );
 
-    // Color key image
-    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+/**
+ * @brief Same as "loadFromFile", but uploads an image which has already been decoded (e.g. by a
+ * worker thread). If the image is already in the texture cache, the surface is not used.
+ *
+ * @param Path The path the image was decoded from, identifying it in the texture cache.
+ * @param Decoded_Ptr The decoded image. It remains owned by the caller.
+ * @param Renderer_Ptr The SDL renderer that will render this texture.
+ * @return true if successful; false otherwise.
+ **/
+bool Texture::loadFromSurface( const std::string& Path, SDL_Surface* Decoded_Ptr, SDL_Renderer* Renderer_Ptr )
+{
+  // Get rid of preexisting texture
+  free();
 
-    // Create texture from surface pixels
-    newTexture = SDL_CreateTextureFromSurface( Renderer_Ptr, loadedSurface );
+  m_Texture = TextureCache::Get().acquire( Path, Renderer_Ptr, &m_Width, &m_Height, Decoded_Ptr );
 
-    if( newTexture == NULL )
-    {
-      printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
-    }
-    else
-    {
-      printf( "\nTexture created from \"%s\"", Path.c_str() );
+  return m_Texture != NULL;
+}
 
-      // Get image dimensions
-      m_Width  = loadedSurface->w;
-      m_Height = loadedSurface->h;
-    }
 
-    // Get rid of old loaded surface
-    SDL_FreeSurface( loadedSurface );
+/**
+ * @brief Creates an uninitialised texture, e.g. to be used as a render target.
+ *
+ * @param Width_px
+ * @param Height_px
+ * @param Renderer_Ptr The SDL renderer that will render this texture.
+ * @param Access SDL_TEXTUREACCESS_TARGET to be able to render into the texture.
+ * @return true if successful; false otherwise.
+ **/
+bool Texture::createBlank( int Width_px, int Height_px, SDL_Renderer* Renderer_Ptr, SDL_TextureAccess Access )
+{
+  // Get rid of preexisting texture
+  free();
+
+  m_Texture = SDL_CreateTexture( Renderer_Ptr, SDL_PIXELFORMAT_RGBA8888, Access, Width_px, Height_px );
+
+  if( m_Texture == NULL )
+  {
+    printf( "\nUnable to create blank texture! SDL Error: \"%s\"", SDL_GetError() );
   }
+  else
+  {
+    printf( "\nBlank texture created" );
+    m_Width  = Width_px;
+    m_Height = Height_px;
 
-  // Return success
-  m_Texture = newTexture;
+    AllocationTracker::AddTextureMemory( GetFootprint_B( m_Width, m_Height ) );
+  }
 
   return m_Texture != NULL;
 }
@@ -108,6 +172,9 @@ bool Texture::loadFromRenderedText( const std::string& textureText, SDL_Color te
       // Get image dimensions
       m_Width  = textSurface->w;
       m_Height = textSurface->h;
+
+      AllocationTracker::AddTextureMemory( GetFootprint_B( m_Width, m_Height ) );
+      Supervisor::Get().GetProfiler().CountUpload( static_cast<size_t>( textSurface->pitch ) * static_cast<size_t>( textSurface->h ) );
     }
 
     // Get rid of old surface
@@ -128,7 +195,16 @@ void Texture::free(void)
   // Free texture if it exists
   if( m_Texture != NULL )
   {
-    SDL_DestroyTexture( m_Texture );
+    if ( TextureCache::Get().owns( m_Texture ) )
+    {
+      TextureCache::Get().release( m_Texture ); // Shared: the cache decides when to destroy it
+    }
+    else
+    {
+      SDL_DestroyTexture( m_Texture );
+      AllocationTracker::RemoveTextureMemory( GetFootprint_B( m_Width, m_Height ) );
+    }
+
     m_Texture = NULL;
     m_Width   = 0;
     m_Height  = 0;
@@ -192,7 +268,10 @@ void Texture::render( int x, int y, SDL_Rect* SourceClip, double angle, SDL_Poin
   {;}
 
   // Render to screen
-  SDL_RenderCopyEx( Renderer::Get().GetSDLRendererPtr(), m_Texture, SourceClip, &Destination, angle, center, flip );
+  SDL_Renderer* Renderer_Ptr = Renderer::Get().GetSDLRendererPtr();
+
+  SDL_RenderCopyEx( Renderer_Ptr, m_Texture, SourceClip, &Destination, angle, center, flip );
+  Supervisor::Get().GetProfiler().CountDraw( Renderer_Ptr, m_Texture );
 }
 
 
@@ -217,3 +296,27 @@ bool Texture::isValid(void) const
 {
   return !(m_Texture == nullptr);
 }
+
+
+/**
+ * @brief Makes this texture the target of all subsequent rendering. The texture must have been
+ * created with SDL_TEXTUREACCESS_TARGET.
+ *
+ * @param Renderer_Ptr The SDL renderer to be redirected.
+ **/
+void Texture::setAsRenderTarget( SDL_Renderer* Renderer_Ptr )
+{
+  SDL_SetRenderTarget( Renderer_Ptr, m_Texture );
+  Supervisor::Get().GetProfiler().CountTargetSwitch( m_Texture );
+}
+
+
+/**
+ * @brief Gives access to the underlying SDL texture, e.g. for batched submission.
+ *
+ * @return SDL_Texture*
+ **/
+SDL_Texture* Texture::GetSDLTexturePtr(void) const
+{
+  return m_Texture;
+}
@@ -6,7 +6,8 @@
 
 
 /**
- * @brief A texture.
+ * @brief A texture. It owns its SDL texture (or its reference into the texture cache), so it can be
+ * moved but not copied.
  **/
 class Texture
 {
@@ -15,7 +16,15 @@ public:
    Texture(void);
   ~Texture(void);
 
-  bool loadFromFile( const std::string&, SDL_Renderer* );
+  Texture( const Texture&  ) = delete;
+  Texture(       Texture&& ) noexcept;
+
+  Texture& operator=( const Texture&  ) = delete;
+  Texture& operator=(       Texture&& ) noexcept;
+
+  bool loadFromFile   ( const std::string&, SDL_Renderer* );
+  bool loadFromSurface( const std::string&, SDL_Surface*, SDL_Renderer* );
+  bool createBlank ( int, int, SDL_Renderer*, SDL_TextureAccess = SDL_TEXTUREACCESS_STREAMING );
 
 #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
@@ -30,6 +39,9 @@ public:
   int   getWidth    ( void ) const;
   int   getHeight   ( void ) const;
   bool  isValid     ( void ) const;
+  void  setAsRenderTarget( SDL_Renderer* );
+
+  SDL_Texture* GetSDLTexturePtr( void ) const;
 
 private:
 
@@ -0,0 +1,300 @@
+/***************************************************************************************************
+* Includes
+****************************************************************************************************/
+
+#include "TextureCache.hpp"
+#include "AllocationTracker.hpp"
+#include "Supervisor.hpp"
+#include "colours.hpp"
+
+#include <SDL_image.h>
+#include <cstdio>
+#include <iterator>
+
+
+/***************************************************************************************************
+* Methods
+****************************************************************************************************/
+
+TextureCache::TextureCache( void )
+  : m_Budget_B(s_DEFAULT_BUDGET_B), m_MemoryUsage_B(0), m_UseCounter(0)
+{
+  printf( "\nInitialising Texture Cache..." );
+}
+
+
+/**
+ * @brief The remaining textures are not destroyed here: at this point SDL has already been shut
+ * down, which frees them anyway.
+ **/
+TextureCache::~TextureCache( void )
+{
+  printf( "TextureCache's destructor called\n" );
+}
+
+
+/**
+ * @brief Gets the texture created from an image, loading it only if it is not resident yet.
+ *
+ * @param Path The path of the source image.
+ * @param Renderer_Ptr The SDL renderer that will render the texture.
+ * @param Width_px Returns the width of the texture.
+ * @param Height_px Returns the height of the texture.
+ * @param Decoded_Ptr The image already decoded with "decode", if available. It is only read, and it
+ * remains owned by the caller.
+ * @return SDL_Texture* The texture, or nullptr if it could not be loaded.
+ **/
+SDL_Texture* TextureCache::acquire( const std::string& Path, SDL_Renderer* Renderer_Ptr, int* Width_px, int* Height_px, SDL_Surface* Decoded_Ptr )
+{
+  AllocationTracker::ScopedTag Tag( AllocationTracker::Tag::TEXTURES );
+
+  const Key_t Key( Renderer_Ptr, Path );
+
+  auto Found = m_Entries.find( Key );
+
+  if ( Found == m_Entries.end() )
+  {
+    Entry NewEntry;
+
+    if ( Load_Pvt( Path, Renderer_Ptr, Decoded_Ptr, NewEntry ) == nullptr )
+    {
+      return nullptr;
+    }
+    else
+    {;}
+
+    Found = m_Entries.emplace( Key, NewEntry ).first;
+    m_KeyOf.emplace( NewEntry.Texture_Ptr, Key );
+    m_MemoryUsage_B += NewEntry.Size_B;
+    AllocationTracker::AddTextureMemory( NewEntry.Size_B );
+  }
+  else
+  {
+    printf( "\nTexture \"%s\" found in cache", Path.c_str() );
+  }
+
+  Entry& CurrentEntry = Found->second;
+
+  ++CurrentEntry.RefCount;
+  CurrentEntry.LastUse = ++m_UseCounter;
+
+  *Width_px  = CurrentEntry.Width_px;
+  *Height_px = CurrentEntry.Height_px;
+
+  Evict_Pvt(); // The new texture might have pushed the cache over budget
+
+  return CurrentEntry.Texture_Ptr;
+}
+
+
+/**
+ * @brief Gives back a texture obtained through "acquire". The texture stays resident until it is
+ * evicted.
+ **/
+void TextureCache::release( SDL_Texture* Texture_Ptr )
+{
+  auto KeyFound = m_KeyOf.find( Texture_Ptr );
+
+  if ( KeyFound == m_KeyOf.end() )
+  {
+    Supervisor::Get().PrintMessage( "Released a texture not owned by the cache.", Supervisor::FaultLevel::WARNING );
+    return;
+  }
+  else
+  {;}
+
+  Entry& CurrentEntry = m_Entries[KeyFound->second];
+
+  if ( CurrentEntry.RefCount > 0 )
+  {
+    --CurrentEntry.RefCount;
+  }
+  else
+  {;}
+
+  CurrentEntry.LastUse = ++m_UseCounter;
+
+  Evict_Pvt();
+}
+
+
+/**
+ * @brief Whether a texture was created by the cache.
+ **/
+bool TextureCache::owns( SDL_Texture* Texture_Ptr ) const
+{
+  return m_KeyOf.find( Texture_Ptr ) != m_KeyOf.end();
+}
+
+
+/**
+ * @brief Destroys all the textures which are not referenced anymore, regardless of the budget.
+ * Call it before destroying a renderer.
+ **/
+void TextureCache::purge( void )
+{
+  for ( auto It = m_Entries.begin(); It != m_Entries.end(); )
+  {
+    auto Next = std::next( It );
+
+    if ( It->second.RefCount == 0 )
+    {
+      Destroy_Pvt( It );
+    }
+    else
+    {;}
+
+    It = Next;
+  }
+}
+
+
+/**
+ * @brief Sets how much video memory unreferenced textures may keep occupied.
+ *
+ * @param Budget_B The budget in bytes.
+ **/
+void TextureCache::SetBudget( size_t Budget_B )
+{
+  m_Budget_B = Budget_B;
+  Evict_Pvt();
+}
+
+
+size_t TextureCache::GetBudget( void ) const
+{
+  return m_Budget_B;
+}
+
+
+/**
+ * @brief Estimated video memory used by the resident textures, in bytes.
+ **/
+size_t TextureCache::GetMemoryUsage( void ) const
+{
+  return m_MemoryUsage_B;
+}
+
+
+size_t TextureCache::GetNumOfEntries( void ) const
+{
+  return m_Entries.size();
+}
+
+
+/**
+ * @brief Decodes an image into a surface, applying the cyan colour key used by every sprite sheet
+ * of this project. It touches no shared state, so it can be called from any thread.
+ *
+ * @param Path The path of the source image.
+ * @return SDL_Surface* The decoded image, to be freed by the caller, or nullptr on failure.
+ **/
+SDL_Surface* TextureCache::decode( const std::string& Path )
+{
+  SDL_Surface* loadedSurface = IMG_Load( Path.c_str() );
+
+  if( loadedSurface == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", Path.c_str(), IMG_GetError() );
+  }
+  else
+  {
+    printf( "\nImage \"%s\" loaded", Path.c_str() );
+
+    // Color key image
+    SDL_SetColorKey( loadedSurface, SDL_TRUE, SDL_MapRGB( loadedSurface->format, CYAN_R, CYAN_G, CYAN_B ) );
+  }
+
+  return loadedSurface;
+}
+
+
+/**
+ * @brief Uploads an image, decoding it first if needed.
+ *
+ * @return SDL_Texture* The new texture, or nullptr on failure.
+ **/
+SDL_Texture* TextureCache::Load_Pvt( const std::string& Path, SDL_Renderer* Renderer_Ptr, SDL_Surface* Decoded_Ptr, Entry& NewEntry )
+{
+  SDL_Surface* loadedSurface = ( Decoded_Ptr != nullptr ) ? Decoded_Ptr : decode( Path );
+
+  if( loadedSurface == NULL )
+  {
+    return nullptr;
+  }
+  else
+  {;}
+
+  // Create texture from surface pixels
+  NewEntry.Texture_Ptr = SDL_CreateTextureFromSurface( Renderer_Ptr, loadedSurface );
+
+  if( NewEntry.Texture_Ptr == NULL )
+  {
+    printf( "\nUnable to create texture from \"%s\"! SDL Error: %s", Path.c_str(), SDL_GetError() );
+  }
+  else
+  {
+    printf( "\nTexture created from \"%s\"", Path.c_str() );
+
+    NewEntry.Width_px  = loadedSurface->w;
+    NewEntry.Height_px = loadedSurface->h;
+    NewEntry.Size_B    = static_cast<size_t>( loadedSurface->w ) * static_cast<size_t>( loadedSurface->h ) * s_BYTES_PER_PIXEL;
+
+    Supervisor::Get().GetProfiler().CountUpload( static_cast<size_t>( loadedSurface->pitch ) * static_cast<size_t>( loadedSurface->h ) );
+  }
+
+  // Get rid of old loaded surface, unless it belongs to the caller
+  if ( loadedSurface != Decoded_Ptr )
+  {
+    SDL_FreeSurface( loadedSurface );
+  }
+  else
+  {;}
+
+  return NewEntry.Texture_Ptr;
+}
+
+
+/**
+ * @brief Destroys unreferenced textures, least recently used first, until the memory in use fits
+ * the budget or only referenced textures are left.
+ **/
+void TextureCache::Evict_Pvt( void )
+{
+  while ( m_MemoryUsage_B > m_Budget_B )
+  {
+    auto Oldest = m_Entries.end();
+
+    for ( auto It = m_Entries.begin(); It != m_Entries.end(); ++It )
+    {
+      if ( It->second.RefCount == 0 && ( Oldest == m_Entries.end() || It->second.LastUse < Oldest->second.LastUse ) )
+      {
+        Oldest = It;
+      }
+      else
+      {;}
+    }
+
+    if ( Oldest == m_Entries.end() )
+    {
+      Supervisor::Get().PrintFormatted( Supervisor::FaultLevel::WARNING, "Texture cache over budget: %zu B in use, %zu B allowed.", m_MemoryUsage_B, m_Budget_B );
+      break; // Everything left is in use
+    }
+    else
+    {
+      Destroy_Pvt( Oldest );
+    }
+  }
+}
+
+
+void TextureCache::Destroy_Pvt( std::map<Key_t, Entry>::iterator It )
+{
+  printf( "\nTexture \"%s\" evicted from cache", It->first.second.c_str() );
+
+  m_MemoryUsage_B -= It->second.Size_B;
+  AllocationTracker::RemoveTextureMemory( It->second.Size_B );
+  m_KeyOf.erase( It->second.Texture_Ptr );
+  SDL_DestroyTexture( It->second.Texture_Ptr );
+  m_Entries.erase( It );
+}
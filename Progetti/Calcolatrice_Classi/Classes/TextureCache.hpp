@@ -0,0 +1,79 @@
+/**
+ * @file TextureCache.hpp
+ *
+ * @brief Process-wide cache of the textures loaded from file. It is a singleton class.
+ **/
+
+#ifndef TEXTURECACHE_HPP
+#define TEXTURECACHE_HPP
+
+#include <SDL.h>
+#include <map>
+#include <string>
+#include <utility>
+#include "ServiceRegistry.hpp"
+
+/**
+ * @brief Singleton texture cache. Textures are identified by source path and renderer, so the same
+ * image is decoded and uploaded only once per renderer. Every "acquire" must be balanced by a
+ * "release"; textures no longer referenced stay resident and are evicted, least recently used
+ * first, only when the memory in use exceeds the budget.
+ **/
+class TextureCache
+{
+public:
+
+  TextureCache( const TextureCache&  ) = delete;
+  TextureCache(       TextureCache&& ) = delete;
+
+  TextureCache& operator=( const TextureCache&  ) = delete;
+  TextureCache& operator=(       TextureCache&& ) = delete;
+
+  static TextureCache& Get( void ) { return Service<TextureCache>::Get(); } // Created by the ServiceRegistry in main
+
+  SDL_Texture* acquire       ( const std::string&, SDL_Renderer*, int*, int*, SDL_Surface* = nullptr );
+  void         release       ( SDL_Texture* );
+  bool         owns          ( SDL_Texture* ) const;
+  void         purge         ( void );
+
+  void         SetBudget     ( size_t );
+  size_t       GetBudget     ( void ) const;
+  size_t       GetMemoryUsage( void ) const;
+  size_t       GetNumOfEntries( void ) const;
+
+  static SDL_Surface* decode ( const std::string& );
+
+private:
+
+  friend class ServiceSlot<TextureCache>;
+
+   TextureCache( void );
+  ~TextureCache( void );
+
+  using Key_t = std::pair<SDL_Renderer*, std::string>;
+
+  struct Entry
+  {
+    SDL_Texture* Texture_Ptr = nullptr;
+    int          Width_px    = 0;
+    int          Height_px   = 0;
+    size_t       Size_B      = 0; // Estimated video memory footprint
+    unsigned     RefCount    = 0;
+    Uint64       LastUse     = 0; // Value of m_UseCounter when last acquired or released
+  };
+
+  SDL_Texture* Load_Pvt     ( const std::string&, SDL_Renderer*, SDL_Surface*, Entry& );
+  void         Evict_Pvt    ( void );
+  void         Destroy_Pvt  ( std::map<Key_t, Entry>::iterator );
+
+  static constexpr size_t s_DEFAULT_BUDGET_B = 64 * 1024 * 1024;
+  static constexpr size_t s_BYTES_PER_PIXEL  = 4;
+
+  std::map<Key_t, Entry>        m_Entries;
+  std::map<SDL_Texture*, Key_t> m_KeyOf;        // Reverse lookup, used by "release"
+  size_t                        m_Budget_B;
+  size_t                        m_MemoryUsage_B;
+  Uint64                        m_UseCounter;   // Logical clock for the LRU policy
+};
+
+#endif // TEXTURECACHE_HPP
@@ -2,6 +2,24 @@
  * @file main.cpp
  *
  * @brief
+ *
+ * The services are created before the main loop, in the order of the registries below, and
+ * destroyed in reverse order at the end of "main": each "X::Get()" is a plain pointer load, with no
+ * guard of a function-local static, and the loop uses references resolved once.
+ *
+ * The start-up is a "StartupSequence": SDL_image, the decoding of the sprite sheet and the loading
+ * of the atlas run on worker threads while SDL video, the window and the renderer are created on the
+ * main thread. Its report shows the time of each stage; "--serial-startup" runs them one at a time.
+ *
+ * "--telemetry=<udp|tcp>:<host>:<port>" sends a line of JSON every "--telemetry-period=<ms>" to a
+ * collector, for the machines nobody watches: a histogram of the busy frame times, the allocations,
+ * the draw calls, the texture memory and the faults of the period ("TelemetrySink").
+ *
+ * Aggiunta GS: "--convert=<espressione>" non apre la finestra: legge da stdin una colonna di numeri,
+ * uno per riga, e scrive su stdout il risultato dell'espressione per ognuno, con "x" al posto del
+ * valore, ad es. "--convert=x*2.54" per convertire pollici in centimetri. Le righe che non sono
+ * numeri (le intestazioni) vengono ricopiate. L'espressione è compilata una volta sola in bytecode
+ * ed eseguita a blocchi ("Expression").
  **/
 
 
@@ -9,23 +27,48 @@
 * Includes
 ****************************************************************************************************/
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <optional>
+#include <utility>
+#include "Expression.hpp"
 #include "Supervisor.hpp"
 #include "SDL_Initialiser.hpp"
 #include "MainWindow.hpp"
 #include "Renderer.hpp"
 #include "InputManager.hpp"
+#include "TextureCache.hpp"
+#include "SpriteAtlas.hpp"
+#include "ServiceRegistry.hpp"
+#include "StartupSequence.hpp"
 
 
 /***************************************************************************************************
 * Private prototypes
 ****************************************************************************************************/
 
+static int ConvertColumn( const char* );
+
 
 /***************************************************************************************************
 * Private constants
 ****************************************************************************************************/
 
+// Creation order: each service may use those before it. The supervisor comes alone, so that the
+// command line configures it before the others log their start-up; the texture cache outlives the
+// renderer, whose textures are released into it when it is destroyed. The other registries are
+// created by the start-up stages, one stage each
+using CoreServices     = ServiceRegistry< Supervisor >;
+using PlatformServices = ServiceRegistry< SDL_Initialiser, TextureCache >;
+using WindowServices   = ServiceRegistry< MainWindow >;
+using GraphicsServices = ServiceRegistry< Renderer, InputManager >;
+
+static const char*  Convert_Option ( "--convert=" );
+static const size_t Convert_Block  = 4096;  // Values read before each batch evaluation
+static const size_t Convert_Line   = 256;
+
 
 /***************************************************************************************************
 * Main function
@@ -33,29 +76,194 @@
 
 int main( int argc, char* argv[] )
 {
+  for ( int i = 1; i < argc; ++i )
+  {
+    if ( strncmp( argv[i], Convert_Option, strlen( Convert_Option ) ) == 0 )
+    {
+      return ConvertColumn( argv[i] + strlen( Convert_Option ) ); // No window nor services
+    }
+    else
+    {;}
+  }
+
   std::cout << "\n\n*********************************** INIZIO ***********************************\n";
 
-  if ( SDL_Initialiser::Get().isSDLInitialised() )
-    std::cout << "\nSDL initialised.";
-  else
-    std::cout << "\nSDL not yet initialised.";
+  CoreServices Core;
+  Supervisor&  TheSupervisor = Core.Get<Supervisor>();
+
+  TheSupervisor.StartDebuggingConsole( argc, argv );
+
+  // Declared in creation order, so that they are destroyed in reverse order
+  std::optional<PlatformServices> Platform;
+  std::optional<WindowServices>   Window;
+  std::optional<GraphicsServices> Graphics;
+
+  // Produced by the worker stages, consumed by the main ones
+  SDL_Surface* SpriteSheet_Ptr = nullptr;
+  SpriteAtlas  Atlas;
+
+  StartupSequence Startup;
+  Startup.SetSerial( TheSupervisor.IsStartupSerial() );
+
+  const int VideoStage = Startup.AddStage( "SDL video", StartupSequence::Thread::MAIN,
+    [&Platform]() { Platform.emplace(); return Platform->Get<SDL_Initialiser>().isSDLInitialised(); } );
+
+  const int ImageStage = Startup.AddStage( "SDL_image", StartupSequence::Thread::WORKER,
+    []() { return SDL_Initialiser::InitImageLoading(); } );
 
-  Supervisor::Get().StartDebuggingConsole( argc, argv );
+  const int DecodeStage = Startup.AddStage( "Sprite sheet decode", StartupSequence::Thread::WORKER,
+    [&SpriteSheet_Ptr]() { SpriteSheet_Ptr = Renderer::DecodeSpriteSheet(); return SpriteSheet_Ptr != nullptr; }, { ImageStage } );
 
-  while( !InputManager::Get().WasQuitRequested() && !Supervisor::Get().IsThereAnyFault() )
+  const int AtlasStage = Startup.AddStage( "Sprite atlas", StartupSequence::Thread::WORKER,
+    [&Atlas]() { return Renderer::LoadAtlas( Atlas ); } );
+
+  const int WindowStage = Startup.AddStage( "Main window", StartupSequence::Thread::MAIN,
+    [&Window]() { Window.emplace(); return Window->Get<MainWindow>().GetSDLWindowPtr() != NULL; }, { VideoStage } );
+
+  const int RendererStage = Startup.AddStage( "Renderer", StartupSequence::Thread::MAIN,
+    [&Graphics]() { Graphics.emplace(); return Graphics->Get<Renderer>().GetSDLRendererPtr() != NULL; }, { WindowStage } );
+
+  Startup.AddStage( "Sprite sheet upload", StartupSequence::Thread::MAIN,
+    [&Graphics, &SpriteSheet_Ptr]() { return Graphics->Get<Renderer>().UploadSpriteSheet( std::exchange( SpriteSheet_Ptr, nullptr ) ); },
+    { DecodeStage, RendererStage } );
+
+  Startup.AddStage( "Graphic elements", StartupSequence::Thread::MAIN,
+    [&Graphics, &Atlas]() { Graphics->Get<Renderer>().CreateGraphicElements( Atlas ); return true; },
+    { AtlasStage, RendererStage } );
+
+  const bool IsStarted = Startup.Run();
+
+  Startup.PrintReport();
+  SDL_FreeSurface( SpriteSheet_Ptr ); // Still here only if the upload was skipped
+
+  if ( IsStarted )
   {
-    InputManager::Get().ManageInput();
+    // Resolved once for the whole loop
+    Renderer&     TheRenderer = Graphics->Get<Renderer>();
+    InputManager& TheInput    = Graphics->Get<InputManager>();
+
+    FrameProfiler&     Profiler    = TheSupervisor.GetProfiler();
+    AllocationTracker& Allocations = TheSupervisor.GetAllocations();
+    TelemetrySink&     Telemetry   = TheSupervisor.GetTelemetry();
+
+    while( !TheInput.WasQuitRequested() && !TheSupervisor.IsThereAnyFault() )
+    {
+      Profiler.BeginFrame();
+      Allocations.BeginFrame();
 
-    Renderer::Get().Render();
+      {
+        FrameProfiler::ScopedTimer   Timer( FrameProfiler::Section::INPUT );
+        AllocationTracker::ScopedTag Tag  ( AllocationTracker::Tag::INPUT );
+        TheInput.ManageInput();
+      }
+
+      {
+        AllocationTracker::ScopedTag Tag( AllocationTracker::Tag::RENDER );
+        TheRenderer.Render();
+      }
+
+      Allocations.EndFrame();
+      Profiler.EndFrame();
+
+      // A single test without "--telemetry="
+      Telemetry.RecordFrame( Profiler.GetLastBusy_ms(), Allocations.GetLastFrameAllocations(),
+                             Profiler.GetLastCount( FrameProfiler::Counter::DRAW_CALLS ) );
+    }
+
+    Profiler.SaveTraces();
+  }
+  else
+  {
+    TheSupervisor.RaiseFault();
+    TheSupervisor.PrintMessage( "Start-up failed, see the report above.", Supervisor::FaultLevel::WARNING );
   }
 
-  MainWindow::Get().DestroyWindow();
-  SDL_Initialiser::Get().QuitSDL();
+  if ( Window.has_value() )
+  {
+    Window->Get<MainWindow>().DestroyWindow();
+  }
+  else
+  {;}
+
+  if ( Platform.has_value() )
+  {
+    Platform->Get<SDL_Initialiser>().QuitSDL();
+  }
+  else
+  {;}
 
   std::cout << "\n***********************************  FINE  ***********************************\n\n";
 
-  Supervisor::Get().PerformIntegrityCheck();
-  Supervisor::Get().PressEnter();
+  TheSupervisor.PerformIntegrityCheck();
+  TheSupervisor.PressEnter();
+
+  return 0;
+}
+
+
+/***************************************************************************************************
+* Private functions
+****************************************************************************************************/
+
+/**
+ * @brief Evaluates an expression of "x" for each number read from stdin, writing the results to
+ * stdout in the same order. The numbers are evaluated a block at a time; a line that is not a number
+ * ends the block and is copied as it is.
+ *
+ * @return 0, or 1 if the expression does not compile.
+ **/
+static int ConvertColumn( const char* Text )
+{
+  Expression Converter;
+
+  if ( !Converter.compile( Text ) )
+  {
+    fprintf( stderr, "\nInvalid expression \"%s\": %s\n", Text, Converter.GetError() );
+    return 1;
+  }
+  else
+  {;}
+
+  static double Values[Convert_Block]; // Not on the stack: 32 KiB
+  size_t NumOfValues = 0;
+  char   Line[Convert_Line];
+
+  auto Flush = [&] ()
+  {
+    Converter.evaluate( Values, Values, NumOfValues );
+
+    for ( size_t i = 0; i != NumOfValues; ++i )
+    {
+      printf( "%.15g\n", Values[i] );
+    }
+
+    NumOfValues = 0;
+  };
+
+  while ( fgets( Line, sizeof(Line), stdin ) != nullptr )
+  {
+    char*        End_Ptr;
+    const double Value = strtod( Line, &End_Ptr );
+
+    if ( End_Ptr != Line && strspn( End_Ptr, " \t\r\n" ) == strlen( End_Ptr ) )
+    {
+      Values[NumOfValues++] = Value;
+
+      if ( NumOfValues == Convert_Block )
+      {
+        Flush();
+      }
+      else
+      {;}
+    }
+    else
+    {
+      Flush();
+      fputs( Line, stdout );
+    }
+  }
+
+  Flush();
 
   return 0;
 }
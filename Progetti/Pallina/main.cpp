@@ -8,11 +8,28 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_ttf.h>
+#include <algorithm>
 #include <cstdio>
 #include <string>
-#include <sstream>
-#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
 #include "colours.hpp"
+#include "LDebugDraw.hpp"
+#include "LDynamicResolution.hpp"
+#include "LFrameArena.hpp"
+#include "LFixed.hpp"
+#include "LFrameCapture.hpp"
+#include "LJobSystem.hpp"
+#include "LLateLatch.hpp"
+#include "LPerfHarness.hpp"
+#include "LRingBuffer.hpp"
+#include "LTripleBuffer.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PALLINA_USE_SSE2
+#endif
 
 
 /**************************************************************************************************
@@ -28,6 +45,51 @@ static constexpr double GRAVITY       (0.5);
 static constexpr double BOUNCE_FACTOR (0.8);
 static constexpr double BRAKING_FACTOR(1.0);
 
+/**
+ * @brief The constants of the physics, per simulation: the game uses the ones above, the batch runs
+ * ("--batch") try others.
+ **/
+struct PhysicsParams
+{
+  double Gravity;
+  double BounceFactor;
+  double BrakingFactor;
+};
+
+static constexpr PhysicsParams DEFAULT_PHYSICS{ GRAVITY, BOUNCE_FACTOR, BRAKING_FACTOR };
+
+// Physics runs at a fixed rate, independent of the display's. The constants above (and the dot's
+// velocities) are expressed per reference frame, the rate they were tuned at
+static constexpr double REFERENCE_HZ   (60.0);
+static constexpr double PHYSICS_HZ     (240.0);
+static constexpr double PHYSICS_STEP_s (1.0 / PHYSICS_HZ);
+static constexpr double MAX_FRAME_s    (0.25); // Longer frames (e.g. window dragging) are not caught up
+
+/**
+ * @brief The physics of a step in 16.16 fixed point ("--fixed"): the constants, and how long the
+ * step is in reference frames, converted once, so that the steps use no floating point at all.
+ **/
+struct FixedPhysics
+{
+  LFixed StepScale;
+  LFixed Gravity;
+  LFixed BounceFactor;
+  LFixed BrakingFactor;
+};
+
+static constexpr FixedPhysics DEFAULT_FIXED_PHYSICS{ LFixed::FromDouble( REFERENCE_HZ / PHYSICS_HZ ), LFixed::FromDouble( GRAVITY ),
+                                                     LFixed::FromDouble( BOUNCE_FACTOR ), LFixed::FromDouble( BRAKING_FACTOR ) };
+
+// Threaded pipeline: key events queued from the main thread to the simulation thread
+static constexpr size_t INPUT_QUEUE_SIZE = 256;
+
+// Batch runs: scenarios per job, so that a worker held up elsewhere leaves its share to the others
+static constexpr size_t BATCH_JOBS_PER_THREAD = 8;
+
+static const char* const BatchResultsPath("BatchResults.csv"); // Default output of "--batch"
+static const char        BatchMagic[4] = { 'P', 'L', 'B', 'R' };  // Binary output header
+static constexpr Uint32  BATCH_FORMAT_VERSION = 1;
+
 // The dimensions of the level
 static constexpr int LEVEL_W_px = 3200;
 static constexpr int LEVEL_H_px = 2000;
@@ -35,16 +97,38 @@ static constexpr int LEVEL_H_px = 2000;
 static constexpr int WALL_W_px = 64;
 static constexpr int WALL_H_px = 64;
 
+static constexpr int NUM_OF_WALL_TILES = LEVEL_W_px / WALL_W_px; // Tiles of the lower wall
+
 // static const SDL_Color g_TextColorBlack { BLACK_R, BLACK_G, BLACK_B, BLACK_A };
 // static const SDL_Color g_TextColorRed   { RED_R  , RED_G  , RED_B  , RED_A   };
 // static const SDL_Color g_TextColorWhite { WHITE_R, WHITE_G, WHITE_B, WHITE_A };
 static const SDL_Color g_TextColorGold  { GOLD_R , GOLD_G , GOLD_B , GOLD_A  };
 
+// Debug overlay (F3): the balls that passed the culling, and a map of the level with the camera on it
+static const SDL_Color g_DebugVisibleBall{ GREEN_R , GREEN_G , GREEN_B , ALPHA_MAX };
+static const SDL_Color g_DebugMapBack    { BLACK_R , BLACK_G , BLACK_B , 0x80      };
+static const SDL_Color g_DebugMapBorder  { WHITE_R , WHITE_G , WHITE_B , ALPHA_MAX };
+static const SDL_Color g_DebugCamera     { ORANGE_R, ORANGE_G, ORANGE_B, ALPHA_MAX };
+static const SDL_Color g_DebugDot        { RED_R   , RED_G   , RED_B   , ALPHA_MAX };
+
+static constexpr int DEBUG_MAP_SCALE = 10; // Level pixels per map pixel
+static constexpr int DEBUG_MAP_X_px  = 16; // Map's top-left corner, in the window
+static constexpr int DEBUG_MAP_Y_px  = 16;
+
 static const std::string DotPath         ("WhiteDot.bmp");  // Dot        texture's path
-static const std::string BackGroundPath  ("Sfondo.png");    // Background texture's path
+// Background layers, from the farthest to the nearest. The parallax factor is how fast a layer
+// scrolls compared to the level: 1.0 for the layer the dot moves on, less for farther layers
+static const struct { const char* Path; double Parallax; } BackgroundLayers[] =
+{
+  { "Sfondo.png", 1.0 },
+};
+
+static constexpr size_t NUM_OF_BG_LAYERS = sizeof(BackgroundLayers) / sizeof(BackgroundLayers[0]);
 static const std::string SpriteSheetPath ("SpriteSheet.png");
 static const std::string FontPath        ("lazy.ttf");
 
+static constexpr int FONT_SIZE_pt = 28;
+
 
 /***************************************************************************************************
 * Classes
@@ -86,6 +170,9 @@ class LTexture
   int getWidth (void) const;
   int getHeight(void) const;
 
+  // Gets the actual hardware texture, e.g. for batched geometry
+  SDL_Texture* getSDLTexture(void) const;
+
   private:
   // The actual hardware texture
   SDL_Texture* m_Texture;
@@ -96,6 +183,59 @@ class LTexture
 };
 
 
+/**
+ * @brief Text renderer backed by a glyph atlas. The printable ASCII glyphs of a font are rasterized
+ * once into a single texture; strings are then drawn as textured quads, all the strings queued
+ * since the last flush in a single SDL_RenderGeometry call. Glyphs are rasterized in white and
+ * tinted per string through the vertex colour.
+ **/
+class GlyphAtlas
+{
+  public:
+
+  GlyphAtlas(void);
+  ~GlyphAtlas(void);
+
+  bool loadFromFont( TTF_Font* );
+  void free(void);
+
+  // Queues a string; characters outside the atlas are skipped
+  void queue( int, int, const char*, SDL_Color );
+
+  // Draws all the queued strings
+  void flush(void);
+
+  int getTextWidth ( const char* ) const;
+  int getLineHeight( void ) const;
+
+  private:
+
+  static constexpr char FIRST_GLYPH = ' ';
+  static constexpr char LAST_GLYPH  = '~';
+  static constexpr int  NUM_OF_GLYPHS = LAST_GLYPH - FIRST_GLYPH + 1;
+
+  static constexpr int ATLAS_W_px = 512; // Glyphs are packed in rows of this width
+
+  struct Glyph
+  {
+    SDL_Rect Clip;    // Position in the atlas; empty if the font has no such glyph
+    int      Advance; // Horizontal pen movement
+  };
+
+  const Glyph* getGlyph( char ) const;
+
+  SDL_Texture* m_Texture;
+  int          m_Width;
+  int          m_Height;
+  int          m_LineHeight;
+  Glyph        m_Glyphs[NUM_OF_GLYPHS];
+
+  // Geometry queued since the last flush. Storage is kept, so steady-state frames do not allocate
+  std::vector<SDL_Vertex> m_Vertices;
+  std::vector<int>        m_Indices;
+};
+
+
 /**
  * @brief The dot that will move around on the screen.
  **/
@@ -109,15 +249,27 @@ class Dot
   // Takes key presses and adjusts the dot's velocity
   void handleEvent( SDL_Event& );
 
-  void ProcessMovement(void);
+  // Advances the simulation by one step, lasting the given fraction of a reference frame
+  void ProcessMovement( double, const PhysicsParams& = DEFAULT_PHYSICS );
 
-  // Shows the dot on the screen relative to the camera
-  void render( int, int );
+  // The same in 16.16 fixed point, bit-identical on every platform, for a dot in fixed point mode
+  void ProcessMovement( const FixedPhysics& = DEFAULT_FIXED_PHYSICS );
+
+  // Switches between floating and fixed point physics, from the initial state
+  void setFixedPoint( bool );
+  bool isFixedPoint ( void ) const;
+
+  // Shows the dot on the screen relative to the camera, interpolated between the last two steps
+  void render( int, int, double );
 
   // Position accessors
   int getPosX(void) const;
   int getPosY(void) const;
 
+  // Position between the last two steps (0.0 = previous, 1.0 = current)
+  int getRenderPosX( double ) const;
+  int getRenderPosY( double ) const;
+
   // Velocity accessors
   double getVelX_Debug(void) const;
   double getVelY_Debug(void) const;
@@ -126,9 +278,19 @@ class Dot
   int getWidth (void) const;
   int getHeigth(void) const;
 
+  // Hash of the whole physical state, for regression checks
+  Uint64 getChecksum( Uint64 ) const;
+
   // Number of decimal digits used in the acceleration m_DOT_ACC
   static constexpr size_t NUM_OF_DIGITS = 1;
 
+  // The dimensions (width and height) of the dot
+  static constexpr int DOT_W_px = 20;
+  static constexpr int DOT_H_px = 20;
+
+  // Maximum axis velocity of the dot
+  static constexpr int m_DOT_MAX_VEL = 20;
+
 
   private:
 
@@ -145,48 +307,233 @@ class Dot
     HOW_MANY
   };
 
-  // The dimensions (width and height) of the dot
-  static constexpr int DOT_W_px = 20;
-  static constexpr int DOT_H_px = 20;
-
   void AccelReq   ( ACCEL_DIR );
   void AccelStop  ( ACCEL_DIR );
 
-  // Maximum axis velocity of the dot
-  static constexpr int m_DOT_MAX_VEL = 20;
-
   // Acceleration addition
   static constexpr double m_DOT_ACC = 0.4;
 
+  // The same accelerations, in fixed point
+  static constexpr LFixed m_DOT_ACC_FX    = LFixed::FromDouble( m_DOT_ACC );
+  static constexpr LFixed m_DOT_ACC_UP_FX = LFixed::FromInt( 1 );
+
   // The X and Y offsets of the dot
-  int m_PosX, m_PosY;
+  double m_PosX, m_PosY;
+
+  // The X and Y offsets of the dot before the last step, for interpolation
+  double m_PrevPosX, m_PrevPosY;
 
   // The velocity of the dot
   double m_VelX, m_VelY;
 
+  // The state of the dot in fixed point mode, in place of the three above
+  bool   m_IsFixedPoint;
+  LFixed m_FxPosX, m_FxPosY;
+  LFixed m_FxPrevPosX, m_FxPrevPosY;
+  LFixed m_FxVelX, m_FxVelY;
+
   // Used to set the direction of the acceleration
   bool m_IsAccelUp, m_IsAccelDown, m_IsAccelLeft, m_IsAccelRight, m_isBrakingRequested;
 };
 
 
+/**
+ * @brief Many bouncing balls, for stress-testing the update path. They follow the same physics as
+ * the Dot (gravity, velocity saturation, bounces on the level bounds) without user input. The state
+ * is stored as structure of arrays and updated by branch-free kernels, 4 balls per SSE2 operation
+ * where available. Arrays are padded to a multiple of the vector width.
+ **/
+class BallSwarm
+{
+  public:
+
+  BallSwarm(void);
+
+  // Scatters the given number of balls over the level, with random velocities
+  void spawn( size_t );
+
+  // Advances the simulation by one step, lasting the given fraction of a reference frame
+  void ProcessMovement( double, const PhysicsParams& = DEFAULT_PHYSICS );
+
+  // Shows the visible balls relative to the camera, interpolated between the last two steps
+  void render( const SDL_Rect&, double );
+
+  size_t getNumOfBalls(void) const;
+
+  // Copies what "render" needs from another swarm, keeping the storage already allocated
+  void copyPositions( const BallSwarm& );
+
+  // Hash of the whole physical state, for regression checks
+  Uint64 getChecksum( Uint64 ) const;
+
+  private:
+
+  static constexpr size_t LANES = 4; // Floats per SSE2 register
+
+  void ProcessMovement_Scalar( size_t, size_t, float, const PhysicsParams& );
+
+  size_t m_NumOfBalls;
+
+  // Structure of arrays, "m_NumOfBalls" rounded up to a multiple of LANES
+  std::vector<float> m_PosX, m_PosY;
+  std::vector<float> m_PrevPosX, m_PrevPosY;
+  std::vector<float> m_VelX, m_VelY;
+
+  // Quads of the visible balls; storage is kept between frames
+  std::vector<SDL_Vertex> m_Vertices;
+  std::vector<int>        m_Indices;
+};
+
+
+/**
+ * @brief Background layer streamed to the GPU in chunks. The image is kept in system memory and
+ * split into CHUNK_px x CHUNK_px tiles, well below the maximum texture size of any GPU; only the
+ * chunks under the camera, plus a margin of RESIDENT_MARGIN chunks around it, are resident as
+ * textures. Visible chunks are uploaded as soon as they are needed, the ones in the margin at most
+ * MAX_PREFETCH_PER_FRAME per frame; chunks leaving the margin are destroyed.
+ **/
+class StreamedBackground
+{
+  public:
+
+  StreamedBackground(void);
+  ~StreamedBackground(void);
+
+  // Loads the image at the specified path, scrolling at the given parallax factor
+  bool loadFromFile( const std::string&, double );
+
+  void free(void);
+
+  // Renders the part of the layer seen by the camera, streaming chunks in and out
+  void render( const SDL_Rect& );
+
+  // Number of chunks currently uploaded
+  int getResidentChunks(void) const;
+
+  private:
+
+  static constexpr int CHUNK_px               = 512;
+  static constexpr int RESIDENT_MARGIN        = 1;
+  static constexpr int MAX_PREFETCH_PER_FRAME = 1;
+
+  SDL_Texture* upload( int, int );
+
+  // Source pixels, kept in a format that can be uploaded as is
+  SDL_Surface* m_Pixels;
+
+  double m_Parallax;
+  int    m_NumOfCols, m_NumOfRows;
+
+  // Row-major; NULL for the chunks which are not resident
+  std::vector<SDL_Texture*> m_Chunks;
+};
+
+
+/**
+ * @brief What the renderer needs of a simulation step: the bodies, and how far the time is between
+ * their last two steps.
+ **/
+struct FrameState
+{
+  Dot       ScreenDot;
+  BallSwarm Swarm;
+  double    Alpha          = 0.0;
+  double    SwarmUpdate_ms = 0.0; // Time spent updating the swarm, for the debug text
+};
+
+
+/**
+ * @brief Threaded pipeline: the simulation thread owns the bodies, gets the key events through
+ * "Input" and publishes a FrameState after each batch of steps; the main thread renders the latest.
+ **/
+struct Simulation
+{
+  Dot                       ScreenDot;
+  BallSwarm                 Swarm;
+  LSpscRing<SDL_Event>      Input{ INPUT_QUEUE_SIZE };
+  LTripleBuffer<FrameState> Frames;
+  SDL_atomic_t              Quit{ 0 };
+};
+
+
 /***************************************************************************************************
 * Private global variables
 ****************************************************************************************************/
 
+/**
+ * @brief A key event of a recording, and the simulation step it happens at.
+ **/
+struct RecordedEvent
+{
+  unsigned long Step;
+  SDL_Event     Event;
+};
+
+
+/**
+ * @brief One simulation of a batch run: its physics constants and how many steps it lasts.
+ **/
+struct BatchScenario
+{
+  PhysicsParams Physics;
+  unsigned long NumOfSteps;
+};
+
+
+/**
+ * @brief The final state of the dot in a simulation of a batch run, and a checksum of the whole
+ * physical state.
+ **/
+struct BatchResult
+{
+  int    PosX;
+  int    PosY;
+  double VelX;
+  double VelY;
+  Uint64 Checksum;
+};
+
+
+/**
+ * @brief The scenarios, from "First" to "Last" excluded, that a job of a batch run simulates,
+ * and what they share, read only.
+ **/
+struct BatchJob
+{
+  const std::vector<RecordedEvent>* Recording_Ptr;
+  const BallSwarm*                  Swarm_Ptr;
+  const BatchScenario*              Scenarios_Ptr;
+  BatchResult*                      Results_Ptr;
+  size_t                            First;
+  size_t                            Last;
+  bool                              IsFixedPoint;
+};
+
+
 static SDL_Window*   g_Window   = NULL; // The window we'll be rendering to
 static SDL_Renderer* g_Renderer = NULL; // The window renderer
 
 // Globally used font
 static TTF_Font* g_Font = NULL;
 
+// Glyphs of the globally used font
+static GlyphAtlas g_TextAtlas;
+
+// Background layers
+static StreamedBackground g_BGLayers[NUM_OF_BG_LAYERS];
+
 // Textures
 static LTexture g_DotTexture;
-static LTexture g_BGTexture;
 static LTexture g_SSTexture;
-static LTexture g_xPosText_Debug;
-static LTexture g_yPosText_Debug;
-static LTexture g_xVelText_Debug;
-static LTexture g_yVelText_Debug;
+
+// Recording of the frames, if "--capture" is given
+static LFrameCapture g_Capture;
+
+// The scene drawn at the resolution the frame time allows, unless "--native" is given
+static LDynamicResolution g_Resolution;
+
+// With "--late-latch" each frame starts, and reads its input, as late as the next refresh allows
+static LLateLatch g_Latch;
 
 
 /***************************************************************************************************
@@ -196,6 +543,13 @@ static LTexture g_yVelText_Debug;
 static bool init      ( void );
 static bool loadMedia ( void );
 static void close     ( void );
+static void renderLowerWall( const SDL_Rect&, const SDL_Rect& );
+static void renderFrame( Dot&, BallSwarm&, double, double );
+static double stepSimulation( Dot&, BallSwarm&, double&, Uint64& );
+static int  runSimulation( void* );
+static bool runReplay ( const char*, unsigned long, size_t, bool );
+static bool runBatch  ( const char*, const char*, unsigned long, size_t, const char*, bool );
+static Uint64 hashBytes( Uint64, const void*, size_t );
 
 
 /***************************************************************************************************
@@ -376,6 +730,7 @@ void LTexture::render( int x, int y, SDL_Rect* clip, double angle, SDL_Point* ce
 
   // Render to screen
   SDL_RenderCopyEx( g_Renderer, m_Texture, clip, &renderQuad, angle, centre, flip );
+  LPerfHarness::countDrawCalls( 1 );
 }
 
 
@@ -391,129 +746,386 @@ int LTexture::getHeight(void) const
 }
 
 
-Dot::Dot(void)
-  : m_PosX(0), m_PosY(0), m_VelX(0.0), m_VelY(0.0),
-    m_IsAccelUp(false), m_IsAccelDown(false), m_IsAccelLeft(false), m_IsAccelRight(false), m_isBrakingRequested(false)
-{ /* Initialise all non-static private members */ }
+SDL_Texture* LTexture::getSDLTexture(void) const
+{
+  return m_Texture;
+}
 
 
-void Dot::handleEvent( SDL_Event& e )
+GlyphAtlas::GlyphAtlas(void)
+  : m_Texture(NULL), m_Width(0), m_Height(0), m_LineHeight(0), m_Glyphs()
+{ /* Initialize members */ }
+
+
+GlyphAtlas::~GlyphAtlas(void)
 {
-  // If a key was pressed (e.key.repeat == 0 serve per ignorare la ripetizione automatica in caso di
-  // tasto tenuto premuto)
-  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
-  {
-    // Adjust the velocity
-    switch( e.key.keysym.sym )
-    {
-      case SDLK_UP    : AccelReq  (Dot::ACCEL_DIR::UP);    break;
-      case SDLK_DOWN  : AccelReq  (Dot::ACCEL_DIR::DOWN);  break;
-      case SDLK_LEFT  : AccelReq  (Dot::ACCEL_DIR::LEFT);  break;
-      case SDLK_RIGHT : AccelReq  (Dot::ACCEL_DIR::RIGHT); break;
-      case SDLK_RETURN: m_isBrakingRequested = true;       break;
-      default         :                                    break;
-    }
-  }
-  // If a key was released
-  else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
-  {
-    // Adjust the velocity
-    switch( e.key.keysym.sym )
-    {
-      case SDLK_UP    : AccelStop(Dot::ACCEL_DIR::UP);    break;
-      case SDLK_DOWN  : AccelStop(Dot::ACCEL_DIR::DOWN);  break;
-      case SDLK_LEFT  : AccelStop(Dot::ACCEL_DIR::LEFT);  break;
-      case SDLK_RIGHT : AccelStop(Dot::ACCEL_DIR::RIGHT); break;
-      case SDLK_RETURN: m_isBrakingRequested = false;     break;
-      default         :                                   break;
-    }
-  }
-  else { /* Ignore this event */ }
+  free();
 }
 
 
 /**
- * @brief Processes the movement of the dot.
+ * @brief Rasterizes the printable ASCII glyphs of a font into the atlas texture.
+ *
+ * @param font The font to rasterize. It can be closed afterwards.
+ * @return true if the atlas was created; false otherwise.
  **/
-void Dot::ProcessMovement(void)
+bool GlyphAtlas::loadFromFont( TTF_Font* font )
 {
- /******************************************************************
- * Process the acceleration of the dot, based on the user's request
- *******************************************************************/
+  // Get rid of preexisting atlas
+  free();
 
-  if ( m_IsAccelUp )
-  {
-    m_VelY = m_VelY - 1.0;
-  }
-  else { /* No upwards acceleration requested */ }
+  m_LineHeight = TTF_FontHeight( font );
 
-  m_VelY = m_VelY + GRAVITY;
+  // Render every glyph and lay them out in rows
+  SDL_Surface* glyphSurfaces[NUM_OF_GLYPHS] = {};
+  int penX = 0;
+  int penY = 0;
 
-  if ( m_IsAccelLeft )
+  for ( int i = 0; i != NUM_OF_GLYPHS; ++i )
   {
-    m_VelX = m_VelX - m_DOT_ACC;
-  }
-  else { /* No upwards acceleration requested */ }
+    const Uint16 ch = static_cast<Uint16>( FIRST_GLYPH + i );
+    int minX, maxX, minY, maxY, advance;
 
-  if ( m_IsAccelRight )
-  {
-    m_VelX = m_VelX + m_DOT_ACC;
-  }
-  else { /* No downwards acceleration requested */ }
+    m_Glyphs[i] = Glyph{ SDL_Rect{ 0, 0, 0, 0 }, 0 };
 
+    if ( TTF_GlyphMetrics( font, ch, &minX, &maxX, &minY, &maxY, &advance ) != 0 )
+    {
+      continue; // Glyph not provided by the font
+    }
+    else {;}
 
-  /****************************
-  * Speed check and saturation
-  *****************************/
+    m_Glyphs[i].Advance = advance;
+    glyphSurfaces[i]    = TTF_RenderGlyph_Blended( font, ch, SDL_Color{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX } );
 
-  if ( m_VelY < -m_DOT_MAX_VEL )
-  {
-    m_VelY = -m_DOT_MAX_VEL;
-  }
-  else { /* Max speed on negative y axis not yet reached */ }
+    if ( glyphSurfaces[i] == NULL )
+    {
+      continue; // E.g. the space: nothing to draw
+    }
+    else {;}
 
-  if ( m_VelY > m_DOT_MAX_VEL )
-  {
-    m_VelY = m_DOT_MAX_VEL;
-  }
-  else { /* Max speed on positive y axis not yet reached */ }
+    if ( penX + glyphSurfaces[i]->w > ATLAS_W_px )
+    {
+      penX  = 0;
+      penY += m_LineHeight;
+    }
+    else {;}
 
-  if ( m_VelX > m_DOT_MAX_VEL )
-  {
-    m_VelX = m_DOT_MAX_VEL;
+    m_Glyphs[i].Clip = SDL_Rect{ penX, penY, glyphSurfaces[i]->w, glyphSurfaces[i]->h };
+    penX += glyphSurfaces[i]->w;
   }
-  else { /* Max speed on positive x axis not yet reached */ }
 
-  if ( m_VelX < -m_DOT_MAX_VEL )
+  // Copy them into a single surface, keeping their alpha
+  SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat( 0, ATLAS_W_px, penY + m_LineHeight, 32, SDL_PIXELFORMAT_RGBA32 );
+
+  if ( atlasSurface == NULL )
   {
-    m_VelX = -m_DOT_MAX_VEL;
+    printf( "\nUnable to create glyph atlas surface! SDL Error: %s", SDL_GetError() );
   }
-  else { /* Max speed on negative x axis not yet reached */ }
-
-
-  /* Process braking */
-
-  if ( m_isBrakingRequested )
+  else
   {
-    if ( m_VelX > 0.0 )
+    for ( int i = 0; i != NUM_OF_GLYPHS; ++i )
     {
-      m_VelX -= BRAKING_FACTOR;
-
-      if ( m_VelX < 0.0 )
+      if ( glyphSurfaces[i] != NULL )
       {
-        m_VelX = 0.0;
+        SDL_SetSurfaceBlendMode( glyphSurfaces[i], SDL_BLENDMODE_NONE );
+        SDL_BlitSurface( glyphSurfaces[i], NULL, atlasSurface, &m_Glyphs[i].Clip );
       }
       else {;}
     }
-    else if ( m_VelX < 0.0 )
-    {
-      m_VelX += BRAKING_FACTOR;
 
-      if ( m_VelX > 0.0 )
-      {
-        m_VelX = 0.0;
-      }
-      else {;}
+    m_Texture = SDL_CreateTextureFromSurface( g_Renderer, atlasSurface );
+
+    if ( m_Texture == NULL )
+    {
+      printf( "\nUnable to create glyph atlas texture! SDL Error: %s", SDL_GetError() );
+    }
+    else
+    {
+      SDL_SetTextureBlendMode( m_Texture, SDL_BLENDMODE_BLEND );
+      m_Width  = atlasSurface->w;
+      m_Height = atlasSurface->h;
+    }
+
+    SDL_FreeSurface( atlasSurface );
+  }
+
+  for ( auto glyphSurface : glyphSurfaces )
+  {
+    SDL_FreeSurface( glyphSurface );
+  }
+
+  return m_Texture != NULL;
+}
+
+
+void GlyphAtlas::free(void)
+{
+  if( m_Texture != NULL )
+  {
+    SDL_DestroyTexture( m_Texture );
+    m_Texture = NULL;
+    m_Width   = 0;
+    m_Height  = 0;
+  }
+  else { /* Nothing to destroy */ }
+
+  m_Vertices.clear();
+  m_Indices.clear();
+}
+
+
+/**
+ * @brief Queues a string to be drawn by the next flush.
+ *
+ * @param x x position on the window of the top-left corner of the string.
+ * @param y y position on the window of the top-left corner of the string.
+ * @param text The string.
+ * @param color The colour of the string.
+ **/
+void GlyphAtlas::queue( int x, int y, const char* text, SDL_Color color )
+{
+  if ( m_Texture == NULL )
+  {
+    return;
+  }
+  else {;}
+
+  const float invW = 1.0f / static_cast<float>( m_Width  );
+  const float invH = 1.0f / static_cast<float>( m_Height );
+
+  for ( ; *text != '\0'; ++text )
+  {
+    const Glyph* glyph = getGlyph( *text );
+
+    if ( glyph == NULL )
+    {
+      continue;
+    }
+    else {;}
+
+    if ( glyph->Clip.w != 0 )
+    {
+      const float u0 = static_cast<float>( glyph->Clip.x                 ) * invW;
+      const float v0 = static_cast<float>( glyph->Clip.y                 ) * invH;
+      const float u1 = static_cast<float>( glyph->Clip.x + glyph->Clip.w ) * invW;
+      const float v1 = static_cast<float>( glyph->Clip.y + glyph->Clip.h ) * invH;
+
+      const float x0 = static_cast<float>( x                 );
+      const float y0 = static_cast<float>( y                 );
+      const float x1 = static_cast<float>( x + glyph->Clip.w );
+      const float y1 = static_cast<float>( y + glyph->Clip.h );
+
+      const int first = static_cast<int>( m_Vertices.size() );
+
+      m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y0}, color, SDL_FPoint{u0, v0} } );
+      m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y0}, color, SDL_FPoint{u1, v0} } );
+      m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y1}, color, SDL_FPoint{u1, v1} } );
+      m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y1}, color, SDL_FPoint{u0, v1} } );
+
+      for ( int corner : { 0, 1, 2, 2, 3, 0 } ) // Two triangles per glyph
+      {
+        m_Indices.push_back( first + corner );
+      }
+    }
+    else { /* Blank glyph: only moves the pen */ }
+
+    x += glyph->Advance;
+  }
+}
+
+
+/**
+ * @brief Draws all the strings queued since the last flush, with a single draw call.
+ **/
+void GlyphAtlas::flush(void)
+{
+  if ( !m_Indices.empty() )
+  {
+    if ( SDL_RenderGeometry( g_Renderer, m_Texture,
+                             m_Vertices.data(), static_cast<int>( m_Vertices.size() ),
+                             m_Indices.data() , static_cast<int>( m_Indices.size()  ) ) != 0 )
+    {
+      printf( "\nUnable to draw text! SDL Error: %s", SDL_GetError() );
+    }
+    else
+    {
+      LPerfHarness::countDrawCalls( 1 );
+    }
+  }
+  else { /* Nothing queued */ }
+
+  m_Vertices.clear();
+  m_Indices.clear();
+}
+
+
+/**
+ * @brief Width the string would take once drawn.
+ **/
+int GlyphAtlas::getTextWidth( const char* text ) const
+{
+  int width = 0;
+
+  for ( ; *text != '\0'; ++text )
+  {
+    const Glyph* glyph = getGlyph( *text );
+    width += ( glyph != NULL ) ? glyph->Advance : 0;
+  }
+
+  return width;
+}
+
+
+int GlyphAtlas::getLineHeight(void) const
+{
+  return m_LineHeight;
+}
+
+
+const GlyphAtlas::Glyph* GlyphAtlas::getGlyph( char ch ) const
+{
+  if ( ch < FIRST_GLYPH || ch > LAST_GLYPH )
+  {
+    return NULL;
+  }
+  else
+  {
+    return &m_Glyphs[ch - FIRST_GLYPH];
+  }
+}
+
+
+Dot::Dot(void)
+  : m_PosX(0.0), m_PosY(0.0), m_PrevPosX(0.0), m_PrevPosY(0.0), m_VelX(0.0), m_VelY(0.0),
+    m_IsFixedPoint(false), m_FxPosX(), m_FxPosY(), m_FxPrevPosX(), m_FxPrevPosY(), m_FxVelX(), m_FxVelY(),
+    m_IsAccelUp(false), m_IsAccelDown(false), m_IsAccelLeft(false), m_IsAccelRight(false), m_isBrakingRequested(false)
+{ /* Initialise all non-static private members */ }
+
+
+void Dot::handleEvent( SDL_Event& e )
+{
+  // If a key was pressed (e.key.repeat == 0 serve per ignorare la ripetizione automatica in caso di
+  // tasto tenuto premuto)
+  if( e.type == SDL_KEYDOWN && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP    : AccelReq  (Dot::ACCEL_DIR::UP);    break;
+      case SDLK_DOWN  : AccelReq  (Dot::ACCEL_DIR::DOWN);  break;
+      case SDLK_LEFT  : AccelReq  (Dot::ACCEL_DIR::LEFT);  break;
+      case SDLK_RIGHT : AccelReq  (Dot::ACCEL_DIR::RIGHT); break;
+      case SDLK_RETURN: m_isBrakingRequested = true;       break;
+      default         :                                    break;
+    }
+  }
+  // If a key was released
+  else if( e.type == SDL_KEYUP && e.key.repeat == 0 )
+  {
+    // Adjust the velocity
+    switch( e.key.keysym.sym )
+    {
+      case SDLK_UP    : AccelStop(Dot::ACCEL_DIR::UP);    break;
+      case SDLK_DOWN  : AccelStop(Dot::ACCEL_DIR::DOWN);  break;
+      case SDLK_LEFT  : AccelStop(Dot::ACCEL_DIR::LEFT);  break;
+      case SDLK_RIGHT : AccelStop(Dot::ACCEL_DIR::RIGHT); break;
+      case SDLK_RETURN: m_isBrakingRequested = false;     break;
+      default         :                                   break;
+    }
+  }
+  else { /* Ignore this event */ }
+}
+
+
+/**
+ * @brief Processes the movement of the dot for one simulation step.
+ *
+ * @param StepScale Duration of the step, in reference frames (e.g. 0.25 when simulating at 240 Hz
+ * constants tuned at 60 Hz). Accelerations and displacements are scaled accordingly.
+ * @param Physics Gravity, bounce and braking.
+ **/
+void Dot::ProcessMovement( double StepScale, const PhysicsParams& Physics )
+{
+  m_PrevPosX = m_PosX;
+  m_PrevPosY = m_PosY;
+
+ /******************************************************************
+ * Process the acceleration of the dot, based on the user's request
+ *******************************************************************/
+
+  if ( m_IsAccelUp )
+  {
+    m_VelY = m_VelY - 1.0 * StepScale;
+  }
+  else { /* No upwards acceleration requested */ }
+
+  m_VelY = m_VelY + Physics.Gravity * StepScale;
+
+  if ( m_IsAccelLeft )
+  {
+    m_VelX = m_VelX - m_DOT_ACC * StepScale;
+  }
+  else { /* No upwards acceleration requested */ }
+
+  if ( m_IsAccelRight )
+  {
+    m_VelX = m_VelX + m_DOT_ACC * StepScale;
+  }
+  else { /* No downwards acceleration requested */ }
+
+
+  /****************************
+  * Speed check and saturation
+  *****************************/
+
+  if ( m_VelY < -m_DOT_MAX_VEL )
+  {
+    m_VelY = -m_DOT_MAX_VEL;
+  }
+  else { /* Max speed on negative y axis not yet reached */ }
+
+  if ( m_VelY > m_DOT_MAX_VEL )
+  {
+    m_VelY = m_DOT_MAX_VEL;
+  }
+  else { /* Max speed on positive y axis not yet reached */ }
+
+  if ( m_VelX > m_DOT_MAX_VEL )
+  {
+    m_VelX = m_DOT_MAX_VEL;
+  }
+  else { /* Max speed on positive x axis not yet reached */ }
+
+  if ( m_VelX < -m_DOT_MAX_VEL )
+  {
+    m_VelX = -m_DOT_MAX_VEL;
+  }
+  else { /* Max speed on negative x axis not yet reached */ }
+
+
+  /* Process braking */
+
+  if ( m_isBrakingRequested )
+  {
+    if ( m_VelX > 0.0 )
+    {
+      m_VelX -= Physics.BrakingFactor * StepScale;
+
+      if ( m_VelX < 0.0 )
+      {
+        m_VelX = 0.0;
+      }
+      else {;}
+    }
+    else if ( m_VelX < 0.0 )
+    {
+      m_VelX += Physics.BrakingFactor * StepScale;
+
+      if ( m_VelX > 0.0 )
+      {
+        m_VelX = 0.0;
+      }
+      else {;}
     }
     else {;}
   }
@@ -523,7 +1135,7 @@ void Dot::ProcessMovement(void)
  * Move the dot left or right
  *****************************/
 
-  m_PosX += static_cast<int>(m_VelX);
+  m_PosX += m_VelX * StepScale;
 
 
  /**********************************************
@@ -534,7 +1146,7 @@ void Dot::ProcessMovement(void)
   {
     // Move back
     m_IsAccelLeft  = false;
-    m_PosX = 0;
+    m_PosX = 0.0;
     m_VelX = -(m_VelX / 2);
   }
   else { /* Movement was OK */ }
@@ -558,7 +1170,7 @@ void Dot::ProcessMovement(void)
  * Move the dot up or down
  **************************/
 
-  m_PosY += static_cast<int>(m_VelY);
+  m_PosY += m_VelY * StepScale;
 
 
  /************************************
@@ -569,8 +1181,8 @@ void Dot::ProcessMovement(void)
   {
     // Move back
     m_IsAccelUp   = false;
-    m_PosY = 0;
-    m_VelY = -(m_VelY * BOUNCE_FACTOR);
+    m_PosY = 0.0;
+    m_VelY = -(m_VelY * Physics.BounceFactor);
   }
   else { /* Movement was OK */ }
 
@@ -584,67 +1196,183 @@ void Dot::ProcessMovement(void)
     // Move back
     m_IsAccelDown = false;
     m_PosY = LEVEL_H_px - DOT_H_px - WALL_H_px;
-    m_VelY = -(m_VelY * BOUNCE_FACTOR);
+    m_VelY = -(m_VelY * Physics.BounceFactor);
   }
   else { /* Movement was OK */ }
 }
 
 
 /**
- * @brief Requests acceleration in a given direction.
+ * @brief Processes the movement of the dot for one simulation step in 16.16 fixed point: the same
+ * physics as the floating point one, step by step, but with integers only, so that a replay ends in
+ * the same bits on every compiler and platform, and runs fast without an FPU. The two modes drift
+ * apart, as they round differently.
+ *
+ * @param Physics The step and the constants, converted to fixed point once.
  **/
-void Dot::AccelReq( Dot::ACCEL_DIR Direction )
+void Dot::ProcessMovement( const FixedPhysics& Physics )
 {
-  switch ( Direction )
-  {
-    case Dot::ACCEL_DIR::UP:
-      m_IsAccelUp = true;
-      break;
-
-    case Dot::ACCEL_DIR::DOWN:
-      m_IsAccelDown = true;
-      break;
+  const LFixed Zero   = LFixed::FromInt( 0 );
+  const LFixed MaxVel = LFixed::FromInt( m_DOT_MAX_VEL );
 
-    case Dot::ACCEL_DIR::LEFT:
-      m_IsAccelLeft = true;
-      break;
+  m_FxPrevPosX = m_FxPosX;
+  m_FxPrevPosY = m_FxPosY;
 
-    case Dot::ACCEL_DIR::RIGHT:
-      m_IsAccelRight = true;
-      break;
+  /* Acceleration requested by the user, and gravity */
 
-    default:
-      break;
+  if ( m_IsAccelUp )
+  {
+    m_FxVelY -= m_DOT_ACC_UP_FX * Physics.StepScale;
   }
-}
+  else { /* No upwards acceleration requested */ }
 
+  m_FxVelY += Physics.Gravity * Physics.StepScale;
 
-/**
- * @brief Stops acceleration requests in a given direction.
- **/
-void Dot::AccelStop( Dot::ACCEL_DIR Direction )
-{
-  switch ( Direction )
+  if ( m_IsAccelLeft )
   {
-    case Dot::ACCEL_DIR::UP:
-      m_IsAccelUp = false;
-      break;
+    m_FxVelX -= m_DOT_ACC_FX * Physics.StepScale;
+  }
+  else { /* No leftwards acceleration requested */ }
 
-    case Dot::ACCEL_DIR::DOWN:
-      m_IsAccelDown = false;
-      break;
+  if ( m_IsAccelRight )
+  {
+    m_FxVelX += m_DOT_ACC_FX * Physics.StepScale;
+  }
+  else { /* No rightwards acceleration requested */ }
 
-    case Dot::ACCEL_DIR::LEFT:
-      m_IsAccelLeft = false;
-      break;
+  /* Speed saturation */
 
-    case Dot::ACCEL_DIR::RIGHT:
-      m_IsAccelRight = false;
-      break;
+  m_FxVelX = ( m_FxVelX < -MaxVel ) ? -MaxVel : ( ( m_FxVelX > MaxVel ) ? MaxVel : m_FxVelX );
+  m_FxVelY = ( m_FxVelY < -MaxVel ) ? -MaxVel : ( ( m_FxVelY > MaxVel ) ? MaxVel : m_FxVelY );
 
-    default:
-      break;
-  }
+  /* Braking, down to a standstill */
+
+  const LFixed Braking = Physics.BrakingFactor * Physics.StepScale;
+
+  if ( m_isBrakingRequested && m_FxVelX > Zero )
+  {
+    m_FxVelX = ( m_FxVelX > Braking ) ? m_FxVelX - Braking : Zero;
+  }
+  else if ( m_isBrakingRequested && m_FxVelX < Zero )
+  {
+    m_FxVelX = ( m_FxVelX < -Braking ) ? m_FxVelX + Braking : Zero;
+  }
+  else {;}
+
+  /* Move left or right, bouncing off the sides of the level */
+
+  m_FxPosX += m_FxVelX * Physics.StepScale;
+
+  if ( m_FxPosX < Zero )
+  {
+    m_IsAccelLeft = false;
+    m_FxPosX      = Zero;
+    m_FxVelX      = -( m_FxVelX / 2 );
+  }
+  else { /* Movement was OK */ }
+
+  if ( m_FxPosX > LFixed::FromInt( LEVEL_W_px - DOT_W_px ) )
+  {
+    m_IsAccelRight = false;
+    m_FxPosX       = LFixed::FromInt( LEVEL_W_px - DOT_W_px );
+    m_FxVelX       = -( m_FxVelX / 2 );
+  }
+  else { /* Movement was OK */ }
+
+  /* Move up or down, bouncing off the top and the lower wall */
+
+  m_FxPosY += m_FxVelY * Physics.StepScale;
+
+  if ( m_FxPosY < Zero )
+  {
+    m_IsAccelUp = false;
+    m_FxPosY    = Zero;
+    m_FxVelY    = -( m_FxVelY * Physics.BounceFactor );
+  }
+  else { /* Movement was OK */ }
+
+  if ( m_FxPosY > LFixed::FromInt( LEVEL_H_px - DOT_H_px - WALL_H_px ) )
+  {
+    m_IsAccelDown = false;
+    m_FxPosY      = LFixed::FromInt( LEVEL_H_px - DOT_H_px - WALL_H_px );
+    m_FxVelY      = -( m_FxVelY * Physics.BounceFactor );
+  }
+  else { /* Movement was OK */ }
+}
+
+
+/**
+ * @brief Chooses the physics the dot follows, restarting it from the initial state: a simulation
+ * runs all in one mode, for its checksum to mean anything.
+ **/
+void Dot::setFixedPoint( bool IsFixedPoint )
+{
+  *this          = Dot();
+  m_IsFixedPoint = IsFixedPoint;
+}
+
+
+bool Dot::isFixedPoint(void) const
+{
+  return m_IsFixedPoint;
+}
+
+
+/**
+ * @brief Requests acceleration in a given direction.
+ **/
+void Dot::AccelReq( Dot::ACCEL_DIR Direction )
+{
+  switch ( Direction )
+  {
+    case Dot::ACCEL_DIR::UP:
+      m_IsAccelUp = true;
+      break;
+
+    case Dot::ACCEL_DIR::DOWN:
+      m_IsAccelDown = true;
+      break;
+
+    case Dot::ACCEL_DIR::LEFT:
+      m_IsAccelLeft = true;
+      break;
+
+    case Dot::ACCEL_DIR::RIGHT:
+      m_IsAccelRight = true;
+      break;
+
+    default:
+      break;
+  }
+}
+
+
+/**
+ * @brief Stops acceleration requests in a given direction.
+ **/
+void Dot::AccelStop( Dot::ACCEL_DIR Direction )
+{
+  switch ( Direction )
+  {
+    case Dot::ACCEL_DIR::UP:
+      m_IsAccelUp = false;
+      break;
+
+    case Dot::ACCEL_DIR::DOWN:
+      m_IsAccelDown = false;
+      break;
+
+    case Dot::ACCEL_DIR::LEFT:
+      m_IsAccelLeft = false;
+      break;
+
+    case Dot::ACCEL_DIR::RIGHT:
+      m_IsAccelRight = false;
+      break;
+
+    default:
+      break;
+  }
 }
 
 
@@ -653,34 +1381,57 @@ void Dot::AccelStop( Dot::ACCEL_DIR Direction )
  *
  * @param camX Camera's x position
  * @param camY Camera's y position
+ * @param alpha Fraction of the next step already elapsed
  **/
-void Dot::render( int camX, int camY )
+void Dot::render( int camX, int camY, double alpha )
 {
-  g_DotTexture.render( m_PosX - camX, m_PosY - camY );
+  g_DotTexture.render( getRenderPosX( alpha ) - camX, getRenderPosY( alpha ) - camY );
 }
 
 
 int Dot::getPosX(void) const
 {
-  return m_PosX;
+  return m_IsFixedPoint ? m_FxPosX.ToInt() : static_cast<int>( m_PosX );
 }
 
 
 int Dot::getPosY(void) const
 {
-  return m_PosY;
+  return m_IsFixedPoint ? m_FxPosY.ToInt() : static_cast<int>( m_PosY );
+}
+
+
+/**
+ * @brief In fixed point mode as well the interpolation is in floating point: only the simulation
+ * has to be the same everywhere, not what is drawn.
+ **/
+int Dot::getRenderPosX( double alpha ) const
+{
+  const double prevPosX = m_IsFixedPoint ? m_FxPrevPosX.ToDouble() : m_PrevPosX;
+  const double posX     = m_IsFixedPoint ? m_FxPosX.ToDouble()     : m_PosX;
+
+  return static_cast<int>( prevPosX + ( posX - prevPosX ) * alpha );
+}
+
+
+int Dot::getRenderPosY( double alpha ) const
+{
+  const double prevPosY = m_IsFixedPoint ? m_FxPrevPosY.ToDouble() : m_PrevPosY;
+  const double posY     = m_IsFixedPoint ? m_FxPosY.ToDouble()     : m_PosY;
+
+  return static_cast<int>( prevPosY + ( posY - prevPosY ) * alpha );
 }
 
 
 double Dot::getVelX_Debug(void) const
 {
-  return m_VelX;
+  return m_IsFixedPoint ? m_FxVelX.ToDouble() : m_VelX;
 }
 
 
 double Dot::getVelY_Debug(void) const
 {
-  return m_VelY;
+  return m_IsFixedPoint ? m_FxVelY.ToDouble() : m_VelY;
 }
 
 
@@ -690,188 +1441,1391 @@ int Dot::getWidth(void) const
 }
 
 
-int Dot::getHeigth(void) const
-{
-  return DOT_H_px;
-}
+int Dot::getHeigth(void) const
+{
+  return DOT_H_px;
+}
+
+
+/**
+ * @brief In fixed point mode, the hash of the raw values, in a set byte order: the same on every
+ * platform.
+ **/
+Uint64 Dot::getChecksum( Uint64 hash ) const
+{
+  if ( m_IsFixedPoint )
+  {
+    const Sint32 state[] = { m_FxPosX.Raw, m_FxPosY.Raw, m_FxVelX.Raw, m_FxVelY.Raw };
+    Uint8        bytes[sizeof(state)];
+
+    // Little endian whatever the machine
+    for ( size_t i = 0; i != sizeof(bytes); ++i )
+    {
+      bytes[i] = static_cast<Uint8>( static_cast<Uint32>( state[i / 4] ) >> ( 8 * ( i % 4 ) ) );
+    }
+
+    return hashBytes( hash, bytes, sizeof(bytes) );
+  }
+  else
+  {
+    const double state[] = { m_PosX, m_PosY, m_VelX, m_VelY };
+
+    return hashBytes( hash, state, sizeof(state) );
+  }
+}
+
+
+BallSwarm::BallSwarm(void)
+  : m_NumOfBalls(0)
+{ /* Initialise all non-static private members */ }
+
+
+/**
+ * @brief Replaces the swarm with a new one.
+ *
+ * @param NumOfBalls How many balls; 0 disables the swarm.
+ **/
+void BallSwarm::spawn( size_t NumOfBalls )
+{
+  m_NumOfBalls = NumOfBalls;
+
+  const size_t padded = ( NumOfBalls + LANES - 1 ) / LANES * LANES;
+
+  m_PosX.assign( padded, 0.0f );
+  m_PosY.assign( padded, 0.0f );
+  m_VelX.assign( padded, 0.0f );
+  m_VelY.assign( padded, 0.0f );
+
+  const int maxX = LEVEL_W_px - Dot::DOT_W_px;
+  const int maxY = LEVEL_H_px - Dot::DOT_H_px - WALL_H_px;
+
+  srand( 1 ); // Same swarm at every run, for benchmarking
+
+  for ( size_t i = 0; i != NumOfBalls; ++i )
+  {
+    m_PosX[i] = static_cast<float>( rand() % maxX );
+    m_PosY[i] = static_cast<float>( rand() % maxY );
+    m_VelX[i] = static_cast<float>( rand() % ( 2 * Dot::m_DOT_MAX_VEL + 1 ) - Dot::m_DOT_MAX_VEL );
+    m_VelY[i] = static_cast<float>( rand() % ( 2 * Dot::m_DOT_MAX_VEL + 1 ) - Dot::m_DOT_MAX_VEL );
+  }
+
+  m_PrevPosX = m_PosX;
+  m_PrevPosY = m_PosY;
+}
+
+
+/**
+ * @brief Processes the movement of every ball for one simulation step.
+ *
+ * @param StepScale Duration of the step, in reference frames. See Dot::ProcessMovement.
+ * @param Physics Gravity and bounce; the balls do not brake.
+ **/
+void BallSwarm::ProcessMovement( double StepScale, const PhysicsParams& Physics )
+{
+  const size_t padded = m_PosX.size();
+  const float  k      = static_cast<float>( StepScale );
+
+  memcpy( m_PrevPosX.data(), m_PosX.data(), padded * sizeof(float) );
+  memcpy( m_PrevPosY.data(), m_PosY.data(), padded * sizeof(float) );
+
+  #if defined(PALLINA_USE_SSE2)
+  const __m128 gravity = _mm_set1_ps( static_cast<float>( Physics.Gravity ) * k );
+  const __m128 step    = _mm_set1_ps( k );
+  const __m128 maxVel  = _mm_set1_ps(  static_cast<float>( Dot::m_DOT_MAX_VEL ) );
+  const __m128 minVel  = _mm_set1_ps( -static_cast<float>( Dot::m_DOT_MAX_VEL ) );
+  const __m128 zero    = _mm_setzero_ps();
+  const __m128 maxX    = _mm_set1_ps( static_cast<float>( LEVEL_W_px - Dot::DOT_W_px ) );
+  const __m128 maxY    = _mm_set1_ps( static_cast<float>( LEVEL_H_px - Dot::DOT_H_px - WALL_H_px ) );
+  const __m128 bounceX = _mm_set1_ps( -0.5f );
+  const __m128 bounceY = _mm_set1_ps( -static_cast<float>( Physics.BounceFactor ) );
+
+  for ( size_t i = 0; i != padded; i += LANES )
+  {
+    __m128 velX = _mm_loadu_ps( &m_VelX[i] );
+    __m128 velY = _mm_loadu_ps( &m_VelY[i] );
+
+    // Gravity and saturation
+    velY = _mm_add_ps( velY, gravity );
+    velX = _mm_min_ps( _mm_max_ps( velX, minVel ), maxVel );
+    velY = _mm_min_ps( _mm_max_ps( velY, minVel ), maxVel );
+
+    __m128 posX = _mm_add_ps( _mm_loadu_ps( &m_PosX[i] ), _mm_mul_ps( velX, step ) );
+    __m128 posY = _mm_add_ps( _mm_loadu_ps( &m_PosY[i] ), _mm_mul_ps( velY, step ) );
+
+    // Bounces: where a bound was crossed, reflect and damp the velocity
+    const __m128 outX = _mm_or_ps( _mm_cmplt_ps( posX, zero ), _mm_cmpgt_ps( posX, maxX ) );
+    const __m128 outY = _mm_or_ps( _mm_cmplt_ps( posY, zero ), _mm_cmpgt_ps( posY, maxY ) );
+
+    velX = _mm_or_ps( _mm_and_ps( outX, _mm_mul_ps( velX, bounceX ) ), _mm_andnot_ps( outX, velX ) );
+    velY = _mm_or_ps( _mm_and_ps( outY, _mm_mul_ps( velY, bounceY ) ), _mm_andnot_ps( outY, velY ) );
+
+    posX = _mm_min_ps( _mm_max_ps( posX, zero ), maxX );
+    posY = _mm_min_ps( _mm_max_ps( posY, zero ), maxY );
+
+    _mm_storeu_ps( &m_PosX[i], posX );
+    _mm_storeu_ps( &m_PosY[i], posY );
+    _mm_storeu_ps( &m_VelX[i], velX );
+    _mm_storeu_ps( &m_VelY[i], velY );
+  }
+  #else
+  ProcessMovement_Scalar( 0, padded, k, Physics );
+  #endif
+}
+
+
+/**
+ * @brief Portable version of the update kernel. Written with conditional expressions only, so that
+ * the compiler can vectorise it.
+ **/
+void BallSwarm::ProcessMovement_Scalar( size_t first, size_t last, float k, const PhysicsParams& Physics )
+{
+  const float maxVel = static_cast<float>( Dot::m_DOT_MAX_VEL );
+  const float maxX   = static_cast<float>( LEVEL_W_px - Dot::DOT_W_px );
+  const float maxY   = static_cast<float>( LEVEL_H_px - Dot::DOT_H_px - WALL_H_px );
+
+  for ( size_t i = first; i != last; ++i )
+  {
+    float velX = m_VelX[i];
+    float velY = m_VelY[i] + static_cast<float>( Physics.Gravity ) * k;
+
+    velX = velX < -maxVel ? -maxVel : ( velX > maxVel ? maxVel : velX );
+    velY = velY < -maxVel ? -maxVel : ( velY > maxVel ? maxVel : velY );
+
+    float posX = m_PosX[i] + velX * k;
+    float posY = m_PosY[i] + velY * k;
+
+    velX = ( posX < 0.0f || posX > maxX ) ? velX * -0.5f : velX;
+    velY = ( posY < 0.0f || posY > maxY ) ? velY * -static_cast<float>( Physics.BounceFactor ) : velY;
+
+    m_PosX[i] = posX < 0.0f ? 0.0f : ( posX > maxX ? maxX : posX );
+    m_PosY[i] = posY < 0.0f ? 0.0f : ( posY > maxY ? maxY : posY );
+    m_VelX[i] = velX;
+    m_VelY[i] = velY;
+  }
+}
+
+
+/**
+ * @brief Draws the balls inside the camera with a single geometry call.
+ *
+ * @param camera The camera area, in level coordinates.
+ * @param alpha Fraction of the next step already elapsed.
+ **/
+void BallSwarm::render( const SDL_Rect& camera, double alpha )
+{
+  m_Vertices.clear();
+  m_Indices.clear();
+
+  const float a    = static_cast<float>( alpha );
+  const float w    = static_cast<float>( Dot::DOT_W_px );
+  const float h    = static_cast<float>( Dot::DOT_H_px );
+  const float camX = static_cast<float>( camera.x );
+  const float camY = static_cast<float>( camera.y );
+  const float camW = static_cast<float>( camera.w );
+  const float camH = static_cast<float>( camera.h );
+
+  const SDL_Color noModulation{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+  for ( size_t i = 0; i != m_NumOfBalls; ++i )
+  {
+    const float x0 = m_PrevPosX[i] + ( m_PosX[i] - m_PrevPosX[i] ) * a - camX;
+    const float y0 = m_PrevPosY[i] + ( m_PosY[i] - m_PrevPosY[i] ) * a - camY;
+
+    if ( x0 + w < 0.0f || y0 + h < 0.0f || x0 > camW || y0 > camH )
+    {
+      continue; // Outside the camera
+    }
+    else {;}
+
+    LDebugDraw::rect( SDL_Rect{ static_cast<int>( x0 ), static_cast<int>( y0 ), Dot::DOT_W_px, Dot::DOT_H_px }, g_DebugVisibleBall );
+
+    const int first = static_cast<int>( m_Vertices.size() );
+
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0    , y0    }, noModulation, SDL_FPoint{0.0f, 0.0f} } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0 + w, y0    }, noModulation, SDL_FPoint{1.0f, 0.0f} } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0 + w, y0 + h}, noModulation, SDL_FPoint{1.0f, 1.0f} } );
+    m_Vertices.push_back( SDL_Vertex{ SDL_FPoint{x0    , y0 + h}, noModulation, SDL_FPoint{0.0f, 1.0f} } );
+
+    for ( int corner : { 0, 1, 2, 2, 3, 0 } ) // Two triangles per ball
+    {
+      m_Indices.push_back( first + corner );
+    }
+  }
+
+  if ( !m_Indices.empty() )
+  {
+    SDL_RenderGeometry( g_Renderer, g_DotTexture.getSDLTexture(),
+                        m_Vertices.data(), static_cast<int>( m_Vertices.size() ),
+                        m_Indices.data() , static_cast<int>( m_Indices.size()  ) );
+    LPerfHarness::countDrawCalls( 1 );
+  }
+  else { /* Nothing visible */ }
+}
+
+
+size_t BallSwarm::getNumOfBalls(void) const
+{
+  return m_NumOfBalls;
+}
+
+
+/**
+ * @brief Copies the positions of another swarm, the current and the previous ones: all that "render"
+ * reads. Velocities and the render storage are not copied.
+ **/
+void BallSwarm::copyPositions( const BallSwarm& Other )
+{
+  m_NumOfBalls = Other.m_NumOfBalls;
+  m_PosX       = Other.m_PosX;
+  m_PosY       = Other.m_PosY;
+  m_PrevPosX   = Other.m_PrevPosX;
+  m_PrevPosY   = Other.m_PrevPosY;
+}
+
+
+Uint64 BallSwarm::getChecksum( Uint64 hash ) const
+{
+  hash = hashBytes( hash, m_PosX.data(), m_NumOfBalls * sizeof(float) );
+  hash = hashBytes( hash, m_PosY.data(), m_NumOfBalls * sizeof(float) );
+  hash = hashBytes( hash, m_VelX.data(), m_NumOfBalls * sizeof(float) );
+  hash = hashBytes( hash, m_VelY.data(), m_NumOfBalls * sizeof(float) );
+
+  return hash;
+}
+
+
+StreamedBackground::StreamedBackground(void)
+  : m_Pixels(NULL), m_Parallax(1.0), m_NumOfCols(0), m_NumOfRows(0)
+{ /* Initialize members */ }
+
+
+StreamedBackground::~StreamedBackground(void)
+{
+  free();
+}
+
+
+/**
+ * @brief Loads a layer. No texture is created until the layer is rendered.
+ *
+ * @param path The path of the image.
+ * @param parallax How fast the layer scrolls compared to the level.
+ * @return true if the image was loaded; false otherwise.
+ **/
+bool StreamedBackground::loadFromFile( const std::string& path, double parallax )
+{
+  // Get rid of preexisting layer
+  free();
+
+  SDL_Surface* loadedSurface = IMG_Load( path.c_str() );
+
+  if( loadedSurface == NULL )
+  {
+    printf( "\nUnable to load image \"%s\"! SDL_image Error: %s", path.c_str(), IMG_GetError() );
+    return false;
+  }
+  else {;}
+
+  m_Pixels = SDL_ConvertSurfaceFormat( loadedSurface, SDL_PIXELFORMAT_ARGB8888, 0 );
+  SDL_FreeSurface( loadedSurface );
+
+  if( m_Pixels == NULL )
+  {
+    printf( "\nUnable to convert image \"%s\"! SDL Error: %s", path.c_str(), SDL_GetError() );
+    return false;
+  }
+  else {;}
+
+  m_Parallax  = parallax;
+  m_NumOfCols = ( m_Pixels->w + CHUNK_px - 1 ) / CHUNK_px;
+  m_NumOfRows = ( m_Pixels->h + CHUNK_px - 1 ) / CHUNK_px;
+  m_Chunks.assign( static_cast<size_t>( m_NumOfCols * m_NumOfRows ), NULL );
+
+  return true;
+}
+
+
+void StreamedBackground::free(void)
+{
+  for ( auto& chunk : m_Chunks )
+  {
+    if ( chunk != NULL )
+    {
+      SDL_DestroyTexture( chunk );
+      chunk = NULL;
+    }
+    else { /* Not resident */ }
+  }
+
+  m_Chunks.clear();
+
+  SDL_FreeSurface( m_Pixels );
+  m_Pixels    = NULL;
+  m_NumOfCols = 0;
+  m_NumOfRows = 0;
+}
+
+
+/**
+ * @brief Renders the layer, attached to the origin of the window.
+ *
+ * @param camera The camera area, in level coordinates.
+ **/
+void StreamedBackground::render( const SDL_Rect& camera )
+{
+  if ( m_Pixels == NULL )
+  {
+    return;
+  }
+  else {;}
+
+  // The camera, in layer coordinates
+  const int viewX = static_cast<int>( camera.x * m_Parallax );
+  const int viewY = static_cast<int>( camera.y * m_Parallax );
+
+  const int firstCol = viewX / CHUNK_px;
+  const int lastCol  = ( viewX + camera.w - 1 ) / CHUNK_px;
+  const int firstRow = viewY / CHUNK_px;
+  const int lastRow  = ( viewY + camera.h - 1 ) / CHUNK_px;
+
+  int numOfPrefetched = 0;
+
+  for ( int row = 0; row != m_NumOfRows; ++row )
+  {
+    for ( int col = 0; col != m_NumOfCols; ++col )
+    {
+      SDL_Texture*& chunk = m_Chunks[static_cast<size_t>( row * m_NumOfCols + col )];
+
+      const bool isVisible  = col >= firstCol && col <= lastCol && row >= firstRow && row <= lastRow;
+      const bool isInMargin = col >= firstCol - RESIDENT_MARGIN && col <= lastCol + RESIDENT_MARGIN &&
+                              row >= firstRow - RESIDENT_MARGIN && row <= lastRow + RESIDENT_MARGIN;
+
+      if ( isVisible )
+      {
+        if ( chunk == NULL )
+        {
+          chunk = upload( col, row );
+        }
+        else { /* Already resident */ }
+
+        int w = 0, h = 0;
+
+        if ( chunk != NULL && SDL_QueryTexture( chunk, NULL, NULL, &w, &h ) == 0 )
+        {
+          SDL_Rect renderQuad = { col * CHUNK_px - viewX, row * CHUNK_px - viewY, w, h };
+          SDL_RenderCopy( g_Renderer, chunk, NULL, &renderQuad );
+          LPerfHarness::countDrawCalls( 1 );
+        }
+        else { /* Upload failed */ }
+      }
+      else if ( isInMargin )
+      {
+        if ( chunk == NULL && numOfPrefetched != MAX_PREFETCH_PER_FRAME )
+        {
+          chunk = upload( col, row );
+          ++numOfPrefetched;
+        }
+        else { /* Already resident, or enough uploads for this frame */ }
+      }
+      else if ( chunk != NULL )
+      {
+        SDL_DestroyTexture( chunk );
+        chunk = NULL;
+      }
+      else { /* Not needed, not resident */ }
+    }
+  }
+}
+
+
+int StreamedBackground::getResidentChunks(void) const
+{
+  int numOfResident = 0;
+
+  for ( auto chunk : m_Chunks )
+  {
+    numOfResident += ( chunk != NULL ) ? 1 : 0;
+  }
+
+  return numOfResident;
+}
+
+
+/**
+ * @brief Creates the texture of a chunk from the source pixels.
+ *
+ * @return SDL_Texture* The texture; NULL if it could not be created.
+ **/
+SDL_Texture* StreamedBackground::upload( int col, int row )
+{
+  const int x = col * CHUNK_px;
+  const int y = row * CHUNK_px;
+  const int w = SDL_min( CHUNK_px, m_Pixels->w - x );
+  const int h = SDL_min( CHUNK_px, m_Pixels->h - y );
+
+  SDL_Texture* chunk = SDL_CreateTexture( g_Renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, w, h );
+
+  if ( chunk == NULL )
+  {
+    printf( "\nUnable to create background chunk! SDL Error: %s", SDL_GetError() );
+    return NULL;
+  }
+  else {;}
+
+  const Uint8* pixels = static_cast<const Uint8*>( m_Pixels->pixels ) + y * m_Pixels->pitch + x * m_Pixels->format->BytesPerPixel;
+
+  SDL_UpdateTexture( chunk, NULL, pixels, m_Pixels->pitch );
+  SDL_SetTextureBlendMode( chunk, SDL_BLENDMODE_BLEND ); // Nearer layers may be transparent
+
+  return chunk;
+}
+
+
+/***************************************************************************************************
+* Private functions definitions
+****************************************************************************************************/
+
+/**
+ * @brief Starts up SDL and creates window
+ *
+ * @return bool
+ **/
+static bool init(void)
+{
+  // Initialization flag
+  bool success = true;
+
+  // Initialize SDL
+  if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+  {
+    printf( "\nSDL could not initialize! SDL Error: \"%s\"\n", SDL_GetError() );
+    success = false;
+  }
+  else
+  {
+    printf( "\nOK: SDL initialised" );
+
+    // Set texture filtering to linear
+    if( !SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "1" ) )
+    {
+      printf( "\nWarning: Linear texture filtering not enabled!" );
+      success = false;
+    }
+    else
+    {
+      printf( "\nOK: linear texture filtering enabled" );
+    }
+
+    // Create window
+    g_Window = SDL_CreateWindow( "Pallina",
+                                  SDL_WINDOWPOS_UNDEFINED,
+                                  SDL_WINDOWPOS_UNDEFINED,
+                                  WINDOW_W_px,
+                                  WINDOW_H_px,
+                                  SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_FULLSCREEN_DESKTOP );
+
+    if( g_Window == NULL )
+    {
+      printf( "\nWindow could not be created! SDL Error: \"%s\"\n", SDL_GetError() );
+      success = false;
+    }
+    else
+    {
+      printf( "\nOK: window created" );
+
+      // Create accelerated and vsynced renderer for window
+      g_Renderer = SDL_CreateRenderer( g_Window, INIT_FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
+
+      if( g_Renderer == NULL )
+      {
+        printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
+        success = false;
+      }
+      else
+      {
+        printf( "\nOK: renderer created" );
+
+        // Initialize renderer color
+        SDL_SetRenderDrawColor( g_Renderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+
+        // Initialize PNG loading
+        int imgFlags = IMG_INIT_PNG;
+
+        if( !( IMG_Init( imgFlags ) & imgFlags ) )
+        {
+          printf( "\nSDL_image could not initialize! SDL_image Error: %s", IMG_GetError() );
+          success = false;
+        }
+        else
+        {
+          printf( "\nOK: SDL_image initialised" );
+        }
+
+        // Initialize SDL_ttf
+        if( TTF_Init() == -1 )
+        {
+          printf( "\nSDL_ttf could not initialize! SDL_ttf Error: \"%s\"\n", TTF_GetError() );
+          success = false;
+        }
+        else
+        {
+          printf( "\nOK: SDL_ttf initialised" );
+        }
+
+      } // Renderer created
+
+    } // Window created
+
+  } // SDL initialised
+
+  return success;
+}
+
+
+/**
+ * @brief Loads all necessary media for this project.
+ *
+ * @return true if loading was successful; false otherwise
+ **/
+static bool loadMedia(void)
+{
+  // Loading success flag
+  bool success = true;
+
+ // Open the font
+  g_Font = TTF_OpenFont( FontPath.c_str(), FONT_SIZE_pt );
+
+  if( g_Font == NULL )
+  {
+    printf( "\nFailed to load lazy font! SDL_ttf Error: \"%s\"\n", TTF_GetError() );
+    success = false;
+  }
+  else
+  {
+    printf( "\nOK: Lazy Font loaded" );
+
+    // Rasterize its glyphs once
+    if ( !g_TextAtlas.loadFromFont( g_Font ) )
+    {
+      printf( "\nFailed to create the glyph atlas!" );
+      success = false;
+    }
+    else
+    {
+      printf( "\nOK: glyph atlas created" );
+    }
+  }
+
+  // Load dot texture
+  if ( !g_DotTexture.loadFromFile( DotPath.c_str() ) )
+  {
+    printf( "\nFailed to load dot texture!" );
+    success = false;
+  }
+  else
+  {
+    printf( "\nOK: dot texture loaded" );
+  }
+
+  // Load background layers
+  for ( size_t i = 0; i != NUM_OF_BG_LAYERS; ++i )
+  {
+    if ( !g_BGLayers[i].loadFromFile( BackgroundLayers[i].Path, BackgroundLayers[i].Parallax ) )
+    {
+      printf( "\nFailed to load background layer \"%s\"!\n", BackgroundLayers[i].Path );
+      success = false;
+    }
+    else
+    {
+      printf( "\nOK: background layer \"%s\" loaded", BackgroundLayers[i].Path );
+    }
+  }
+
+  // Load sprite sheet
+  if ( !g_SSTexture.loadFromFile( SpriteSheetPath.c_str() ) )
+  {
+    printf( "\nFailed to load sprite sheet texture!\n" );
+    success = false;
+  }
+  else
+  {
+    printf( "\nOK: sprite sheet texture loaded" );
+  }
+
+  return success;
+}
+
+
+static void close(void)
+{
+  // Write out the frames still being captured, while the renderer is there
+  g_Capture.stop();
+  g_Resolution.free();
+
+  if ( g_Latch.IsEnabled() )
+  {
+    g_Latch.report();
+  }
+  else {;}
+
+  // Free loaded images
+  g_DotTexture.free();
+  for ( auto& layer : g_BGLayers )
+  {
+    layer.free();
+  }
+  g_TextAtlas.free();
+
+  // Both threads count: the steady state should leave this at the first few frames
+  const LFrameArena& Frame = LFrameArena::GetFrame();
+
+  printf( "\nFrames that allocated from the heap: %" SDL_PRIu64 " of %" SDL_PRIu64, Frame.GetHeapFrames(), Frame.GetFrames() );
+
+  // Destroy window
+  SDL_DestroyRenderer( g_Renderer );
+  SDL_DestroyWindow  ( g_Window );
+  g_Renderer = NULL;
+  g_Window   = NULL;
+
+  // Quit SDL subsystems
+  IMG_Quit();
+  SDL_Quit();
+}
+
+
+/**
+ * @brief Renders the tiles of the lower wall which intersect the camera, with a single geometry
+ * call. The visible index range is computed from the camera, so the cost does not grow with the
+ * level's width.
+ *
+ * @param camera The camera area, in level coordinates.
+ * @param tileClip The wall tile in the sprite sheet.
+ **/
+static void renderLowerWall( const SDL_Rect& camera, const SDL_Rect& tileClip )
+{
+  static std::vector<SDL_Vertex> vertices; // Storage is kept between frames
+  static std::vector<int>        indices;
+
+  const int wallY = LEVEL_H_px - WALL_H_px;
+
+  if ( wallY >= camera.y + camera.h || wallY + WALL_H_px <= camera.y )
+  {
+    return; // Wall not in view
+  }
+  else {;}
+
+  const int firstTile = SDL_max( camera.x / WALL_W_px, 0 );
+  const int lastTile  = SDL_min( ( camera.x + camera.w - 1 ) / WALL_W_px, NUM_OF_WALL_TILES - 1 );
+
+  if ( firstTile > lastTile )
+  {
+    return;
+  }
+  else {;}
+
+  vertices.clear();
+  indices.clear();
+
+  const float invW = 1.0f / static_cast<float>( g_SSTexture.getWidth()  );
+  const float invH = 1.0f / static_cast<float>( g_SSTexture.getHeight() );
+
+  const float u0 = static_cast<float>( tileClip.x              ) * invW;
+  const float v0 = static_cast<float>( tileClip.y              ) * invH;
+  const float u1 = static_cast<float>( tileClip.x + tileClip.w ) * invW;
+  const float v1 = static_cast<float>( tileClip.y + tileClip.h ) * invH;
+
+  const float y0 = static_cast<float>( wallY - camera.y );
+  const float y1 = y0 + static_cast<float>( WALL_H_px );
+
+  const SDL_Color noModulation{ WHITE_R, WHITE_G, WHITE_B, ALPHA_MAX };
+
+  for ( int i = firstTile; i <= lastTile; ++i )
+  {
+    const float x0 = static_cast<float>( i * WALL_W_px - camera.x );
+    const float x1 = x0 + static_cast<float>( WALL_W_px );
+    const int   first = static_cast<int>( vertices.size() );
+
+    vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y0}, noModulation, SDL_FPoint{u0, v0} } );
+    vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y0}, noModulation, SDL_FPoint{u1, v0} } );
+    vertices.push_back( SDL_Vertex{ SDL_FPoint{x1, y1}, noModulation, SDL_FPoint{u1, v1} } );
+    vertices.push_back( SDL_Vertex{ SDL_FPoint{x0, y1}, noModulation, SDL_FPoint{u0, v1} } );
+
+    for ( int corner : { 0, 1, 2, 2, 3, 0 } ) // Two triangles per tile
+    {
+      indices.push_back( first + corner );
+    }
+  }
+
+  SDL_RenderGeometry( g_Renderer, g_SSTexture.getSDLTexture(),
+                      vertices.data(), static_cast<int>( vertices.size() ),
+                      indices.data() , static_cast<int>( indices.size()  ) );
+  LPerfHarness::countDrawCalls( 1 );
+}
+
+
+/**
+ * @brief FNV-1a hash, chained through "hash". Start from 14695981039346656037.
+ **/
+static Uint64 hashBytes( Uint64 hash, const void* data, size_t size )
+{
+  const Uint8* bytes = static_cast<const Uint8*>( data );
+
+  for ( size_t i = 0; i != size; ++i )
+  {
+    hash = ( hash ^ bytes[i] ) * 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+
+/**
+ * @brief Reads a recording of key events. The file contains one event per line, ordered by step;
+ * empty lines and lines starting with '#' are ignored:
+ *   <step> <down|up> <UP|DOWN|LEFT|RIGHT|RETURN>
+ *
+ * @return true if the file could be read; false otherwise.
+ **/
+static bool loadRecording( const char* path, std::vector<RecordedEvent>& recording )
+{
+  static const struct { const char* Name; SDL_Keycode Key; } keyNames[] =
+  {
+    { "UP", SDLK_UP }, { "DOWN", SDLK_DOWN }, { "LEFT", SDLK_LEFT }, { "RIGHT", SDLK_RIGHT }, { "RETURN", SDLK_RETURN }
+  };
+
+  FILE* file = fopen( path, "r" );
+
+  if ( file == NULL )
+  {
+    printf( "\nUnable to open replay \"%s\"!", path );
+    return false;
+  }
+  else {;}
+
+  recording.clear();
+
+  char line[128];
+  int  lineNumber = 0;
+
+  while ( fgets( line, sizeof(line), file ) != NULL )
+  {
+    ++lineNumber;
+
+    unsigned long step;
+    char action[8];
+    char keyName[16];
+
+    if ( line[0] == '#' || line[0] == '\n' || line[0] == '\r' )
+    {
+      continue;
+    }
+    else if ( sscanf( line, "%lu %7s %15s", &step, action, keyName ) != 3 )
+    {
+      printf( "\nReplay \"%s\", line %d: malformed event, skipped", path, lineNumber );
+      continue;
+    }
+    else {;}
+
+    RecordedEvent recorded;
+    memset( &recorded, 0, sizeof(recorded) );
+    recorded.Step = step;
+    recorded.Event.type = ( strcmp( action, "down" ) == 0 ) ? SDL_KEYDOWN : SDL_KEYUP;
+
+    bool isKnownKey = false;
+
+    for ( const auto& entry : keyNames )
+    {
+      if ( strcmp( keyName, entry.Name ) == 0 )
+      {
+        recorded.Event.key.keysym.sym = entry.Key;
+        isKnownKey = true;
+      }
+      else {;}
+    }
+
+    if ( isKnownKey )
+    {
+      recording.push_back( recorded );
+    }
+    else
+    {
+      printf( "\nReplay \"%s\", line %d: unknown key \"%s\", skipped", path, lineNumber, keyName );
+    }
+  }
+
+  fclose( file );
+
+  return true;
+}
+
+
+/**
+ * @brief Simulates fixed steps from the given state, feeding the recorded events as their step
+ * comes. Touches no global state: any number of simulations can run at once, one per thread. A dot
+ * in fixed point mode gets the physics converted once, here.
+ *
+ * @return The events fed.
+ **/
+static size_t simulateRecording( Dot& dot, BallSwarm& swarm, const std::vector<RecordedEvent>& recording,
+                                 unsigned long numOfSteps, const PhysicsParams& physics )
+{
+  const FixedPhysics fixedPhysics{ DEFAULT_FIXED_PHYSICS.StepScale, LFixed::FromDouble( physics.Gravity ),
+                                   LFixed::FromDouble( physics.BounceFactor ), LFixed::FromDouble( physics.BrakingFactor ) };
+
+  size_t nextEvent = 0;
+
+  for ( unsigned long step = 0; step != numOfSteps; ++step )
+  {
+    while ( nextEvent != recording.size() && recording[nextEvent].Step <= step )
+    {
+      SDL_Event event = recording[nextEvent].Event;
+      dot.handleEvent( event );
+      ++nextEvent;
+    }
+
+    if ( dot.isFixedPoint() )
+    {
+      dot.ProcessMovement( fixedPhysics );
+    }
+    else
+    {
+      dot.ProcessMovement( REFERENCE_HZ / PHYSICS_HZ, physics );
+    }
+
+    swarm.ProcessMovement( REFERENCE_HZ / PHYSICS_HZ, physics );
+  }
+
+  return nextEvent;
+}
+
+
+/**
+ * @brief Headless mode: runs the physics without window nor renderer, feeding the key events
+ * recorded in a file (see loadRecording), then prints the update rate and a checksum of the final
+ * state. The run is deterministic: it always simulates fixed steps, whatever the speed of the
+ * machine.
+ *
+ * @param path The recorded events.
+ * @param numOfSteps Steps to simulate; if 0, up to the step of the last event.
+ * @param numOfBalls Balls of the many-body benchmark to simulate as well.
+ * @param isFixedPoint Whether the dot follows the fixed point physics: its checksum is then the
+ * same on every platform, for lockstep checks; the balls stay in floating point.
+ * @return true if the file could be read; false otherwise.
+ **/
+static bool runReplay( const char* path, unsigned long numOfSteps, size_t numOfBalls, bool isFixedPoint )
+{
+  // Read the whole recording up front, so that parsing is not timed
+  std::vector<RecordedEvent> recording;
+
+  if ( !loadRecording( path, recording ) )
+  {
+    return false;
+  }
+  else {;}
+
+  if ( numOfSteps == 0 && !recording.empty() )
+  {
+    numOfSteps = recording.back().Step + 1;
+  }
+  else {;}
+
+  Dot       replayDot;
+  BallSwarm replaySwarm;
+  replayDot.setFixedPoint( isFixedPoint );
+  replaySwarm.spawn( numOfBalls );
+
+  const Uint64 start = SDL_GetPerformanceCounter();
+
+  const size_t numOfEvents = simulateRecording( replayDot, replaySwarm, recording, numOfSteps, DEFAULT_PHYSICS );
+
+  const double elapsed_s = static_cast<double>( SDL_GetPerformanceCounter() - start ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+
+  Uint64 checksum = replayDot.getChecksum( 14695981039346656037ULL );
+  checksum = replaySwarm.getChecksum( checksum );
+
+  printf( "\nReplay \"%s\": %lu steps, %zu events, %zu balls, %s point", path, numOfSteps, numOfEvents, numOfBalls,
+          isFixedPoint ? "fixed" : "floating" );
+  printf( "\n\tElapsed: %.3f s (%.0f updates/s)", elapsed_s, elapsed_s > 0.0 ? static_cast<double>( numOfSteps ) / elapsed_s : 0.0 );
+  printf( "\n\tFinal dot: x pos %d, y pos %d, x vel %.6f, y vel %.6f",
+          replayDot.getPosX(), replayDot.getPosY(), replayDot.getVelX_Debug(), replayDot.getVelY_Debug() );
+  printf( "\n\tChecksum: %016llx\n", static_cast<unsigned long long>( checksum ) );
+
+  return true;
+}
+
+
+/**
+ * @brief Reads the scenarios of a batch run, one per line; empty lines and lines starting with '#'
+ * are ignored:
+ *   <gravity> <bounce factor> <braking factor> [<steps>]
+ *
+ * @param defaultSteps Steps of the scenarios that do not give theirs.
+ * @return true if the file could be read; false otherwise.
+ **/
+static bool loadScenarios( const char* path, unsigned long defaultSteps, std::vector<BatchScenario>& scenarios )
+{
+  FILE* file = fopen( path, "r" );
+
+  if ( file == NULL )
+  {
+    printf( "\nUnable to open scenarios \"%s\"!", path );
+    return false;
+  }
+  else {;}
+
+  scenarios.clear();
+
+  char line[128];
+  int  lineNumber = 0;
+
+  while ( fgets( line, sizeof(line), file ) != NULL )
+  {
+    ++lineNumber;
+
+    BatchScenario scenario;
+    scenario.NumOfSteps = defaultSteps;
+
+    if ( line[0] == '#' || line[0] == '\n' || line[0] == '\r' )
+    {
+      continue;
+    }
+    else if ( sscanf( line, "%lf %lf %lf %lu", &scenario.Physics.Gravity, &scenario.Physics.BounceFactor,
+                      &scenario.Physics.BrakingFactor, &scenario.NumOfSteps ) < 3 )
+    {
+      printf( "\nScenarios \"%s\", line %d: malformed scenario, skipped", path, lineNumber );
+      continue;
+    }
+    else {;}
+
+    scenarios.push_back( scenario );
+  }
+
+  fclose( file );
+
+  return true;
+}
+
+
+/**
+ * @brief Runs the scenarios of a range, each from the same initial state. The swarm is copied into
+ * storage reused from one scenario to the next.
+ **/
+static void runBatchJob( void* data )
+{
+  const BatchJob* job = static_cast<const BatchJob*>( data );
+
+  BallSwarm swarm;
+
+  for ( size_t i = job->First; i != job->Last; ++i )
+  {
+    const BatchScenario& scenario = job->Scenarios_Ptr[i];
+    BatchResult&         result   = job->Results_Ptr[i];
+
+    Dot dot;
+    dot.setFixedPoint( job->IsFixedPoint );
+    swarm = *job->Swarm_Ptr;
+
+    simulateRecording( dot, swarm, *job->Recording_Ptr, scenario.NumOfSteps, scenario.Physics );
+
+    result.PosX     = dot.getPosX();
+    result.PosY     = dot.getPosY();
+    result.VelX     = dot.getVelX_Debug();
+    result.VelY     = dot.getVelY_Debug();
+    result.Checksum = swarm.getChecksum( dot.getChecksum( 14695981039346656037ULL ) );
+  }
+}
+
+
+/**
+ * @brief Writes the results of a batch run: CSV, one line per scenario, or, if the path ends in
+ * ".bin", a header (magic "PLBR", format version, number of scenarios, all Uint32) followed by
+ * one record per scenario: gravity, bounce and braking factors (double), steps (Uint32), final
+ * dot x and y (Sint32), x and y velocity (double), checksum (Uint64), in the byte order of the
+ * machine.
+ *
+ * @return true if the whole file was written; false otherwise.
+ **/
+static bool writeBatchResults( const char* path, const std::vector<BatchScenario>& scenarios, const std::vector<BatchResult>& results )
+{
+  const size_t pathLength = strlen( path );
+  const bool   isBinary   = ( pathLength >= 4 && strcmp( path + pathLength - 4, ".bin" ) == 0 );
+
+  FILE* file = fopen( path, isBinary ? "wb" : "w" );
+
+  if ( file == NULL )
+  {
+    printf( "\nUnable to create \"%s\"!", path );
+    return false;
+  }
+  else {;}
+
+  bool isWritten = true;
+
+  if ( isBinary )
+  {
+    const Uint32 header[2] = { BATCH_FORMAT_VERSION, static_cast<Uint32>( scenarios.size() ) };
+
+    isWritten = ( fwrite( BatchMagic, sizeof(BatchMagic), 1, file ) == 1 ) && ( fwrite( header, sizeof(header), 1, file ) == 1 );
+
+    for ( size_t i = 0; i != scenarios.size() && isWritten; ++i )
+    {
+      Uint8 record[3 * sizeof(double) + sizeof(Uint32) + 2 * sizeof(Sint32) + 2 * sizeof(double) + sizeof(Uint64)];
+      Uint8* field = record;
+
+      const double gravity = scenarios[i].Physics.Gravity;
+      const double bounce  = scenarios[i].Physics.BounceFactor;
+      const double braking = scenarios[i].Physics.BrakingFactor;
+      const Uint32 steps   = static_cast<Uint32>( scenarios[i].NumOfSteps );
+      const Sint32 posX    = results[i].PosX;
+      const Sint32 posY    = results[i].PosY;
+
+      memcpy( field, &gravity, sizeof(gravity) );               field += sizeof(gravity);
+      memcpy( field, &bounce, sizeof(bounce) );                 field += sizeof(bounce);
+      memcpy( field, &braking, sizeof(braking) );               field += sizeof(braking);
+      memcpy( field, &steps, sizeof(steps) );                   field += sizeof(steps);
+      memcpy( field, &posX, sizeof(posX) );                     field += sizeof(posX);
+      memcpy( field, &posY, sizeof(posY) );                     field += sizeof(posY);
+      memcpy( field, &results[i].VelX, sizeof(double) );        field += sizeof(double);
+      memcpy( field, &results[i].VelY, sizeof(double) );        field += sizeof(double);
+      memcpy( field, &results[i].Checksum, sizeof(Uint64) );
+
+      isWritten = ( fwrite( record, sizeof(record), 1, file ) == 1 );
+    }
+  }
+  else
+  {
+    isWritten = ( fprintf( file, "scenario,gravity,bounce_factor,braking_factor,steps,pos_x,pos_y,vel_x,vel_y,checksum\n" ) > 0 );
+
+    for ( size_t i = 0; i != scenarios.size() && isWritten; ++i )
+    {
+      isWritten = ( fprintf( file, "%zu,%.9g,%.9g,%.9g,%lu,%d,%d,%.9g,%.9g,%016llx\n", i,
+                             scenarios[i].Physics.Gravity, scenarios[i].Physics.BounceFactor, scenarios[i].Physics.BrakingFactor,
+                             scenarios[i].NumOfSteps, results[i].PosX, results[i].PosY, results[i].VelX, results[i].VelY,
+                             static_cast<unsigned long long>( results[i].Checksum ) ) > 0 );
+    }
+  }
+
+  isWritten = ( fclose( file ) == 0 ) && isWritten;
+
+  if ( !isWritten )
+  {
+    printf( "\nUnable to write \"%s\"!", path );
+  }
+  else {;}
+
+  return isWritten;
+}
+
+
+/**
+ * @brief Headless batch mode: runs many simulations with different physics constants, each one a
+ * replay of the same recording (see runReplay) from the same initial state, and writes the final
+ * state of each to a file (see writeBatchResults). The simulations are independent, so they are
+ * split in ranges run by the workers of a job system, on every core; each scenario has its slot
+ * in the results, so the file is the same whatever the number of cores.
+ *
+ * @param scenariosPath The physics constants of each simulation (see loadScenarios).
+ * @param replayPath The recorded events, fed to every simulation; NULL for none.
+ * @param numOfSteps Steps of the scenarios not giving theirs; if 0, up to the step of the last event.
+ * @param numOfBalls Balls of the many-body benchmark to simulate in each scenario as well.
+ * @param outPath The results.
+ * @param isFixedPoint Whether the dot follows the fixed point physics.
+ * @return true if all files could be read and written; false otherwise.
+ **/
+static bool runBatch( const char* scenariosPath, const char* replayPath, unsigned long numOfSteps, size_t numOfBalls, const char* outPath,
+                      bool isFixedPoint )
+{
+  std::vector<RecordedEvent> recording;
+
+  if ( replayPath != NULL && !loadRecording( replayPath, recording ) )
+  {
+    return false;
+  }
+  else {;}
+
+  if ( numOfSteps == 0 && !recording.empty() )
+  {
+    numOfSteps = recording.back().Step + 1;
+  }
+  else {;}
+
+  std::vector<BatchScenario> scenarios;
+
+  if ( !loadScenarios( scenariosPath, numOfSteps, scenarios ) )
+  {
+    return false;
+  }
+  else {;}
+
+  // Spawned once, here: "spawn" draws from rand(), which the workers must not share
+  BallSwarm initialSwarm;
+  initialSwarm.spawn( numOfBalls );
+
+  std::vector<BatchResult> results( scenarios.size() );
+
+  LJobSystem jobs;
+
+  if ( !jobs.init() )
+  {
+    printf( "\nUnable to start the batch workers!" );
+    return false;
+  }
+  else {;}
+
+  const size_t numOfJobs = std::min( scenarios.size(), static_cast<size_t>( jobs.GetWorkerCount() + 1 ) * BATCH_JOBS_PER_THREAD );
+
+  std::vector<BatchJob> batchJobs( numOfJobs );
+  LJobCounter           batchDone;
+
+  const Uint64 start = SDL_GetPerformanceCounter();
+
+  for ( size_t j = 0; j != numOfJobs; ++j )
+  {
+    batchJobs[j] = BatchJob{ &recording, &initialSwarm, scenarios.data(), results.data(),
+                             scenarios.size() * j / numOfJobs, scenarios.size() * ( j + 1 ) / numOfJobs, isFixedPoint };
+
+    jobs.run( runBatchJob, &batchJobs[j], &batchDone );
+  }
+
+  jobs.wait( batchDone );
+
+  const double elapsed_s = static_cast<double>( SDL_GetPerformanceCounter() - start ) / static_cast<double>( SDL_GetPerformanceFrequency() );
+
+  const int numOfThreads = jobs.GetWorkerCount() + 1;
+  jobs.shutdown();
+
+  printf( "\nBatch \"%s\": %zu scenarios, %zu events, %zu balls, %d threads", scenariosPath, scenarios.size(), recording.size(), numOfBalls, numOfThreads );
+  printf( "\n\tElapsed: %.3f s (%.1f scenarios/s)", elapsed_s, elapsed_s > 0.0 ? static_cast<double>( scenarios.size() ) / elapsed_s : 0.0 );
+
+  if ( !writeBatchResults( outPath, scenarios, results ) )
+  {
+    return false;
+  }
+  else {;}
+
+  printf( "\n\tResults: \"%s\"\n", outPath );
 
+  return true;
+}
 
-/***************************************************************************************************
-* Private functions definitions
-****************************************************************************************************/
 
 /**
- * @brief Starts up SDL and creates window
+ * @brief Runs the fixed simulation steps covering the time elapsed since the last call.
  *
- * @return bool
+ * @param accumulator Time not yet simulated, updated.
+ * @param prevCounter Performance counter at the last call, updated.
+ * @return Time spent updating, in milliseconds.
  **/
-static bool init(void)
+static double stepSimulation( Dot& ScreenDot, BallSwarm& Swarm, double& accumulator, Uint64& prevCounter )
 {
-  // Initialization flag
-  bool success = true;
+  const double counterFrequency = static_cast<double>( SDL_GetPerformanceFrequency() );
 
-  // Initialize SDL
-  if( SDL_Init( SDL_INIT_VIDEO ) < 0 )
+  const Uint64 counter = SDL_GetPerformanceCounter();
+  double frameTime = static_cast<double>( counter - prevCounter ) / counterFrequency;
+  prevCounter = counter;
+
+  if ( frameTime > MAX_FRAME_s )
   {
-    printf( "\nSDL could not initialize! SDL Error: \"%s\"\n", SDL_GetError() );
-    success = false;
+    frameTime = MAX_FRAME_s;
   }
-  else
-  {
-    printf( "\nOK: SDL initialised" );
+  else { /* Frame time is OK */ }
 
-    // Set texture filtering to linear
-    if( !SDL_SetHint( SDL_HINT_RENDER_SCALE_QUALITY, "1" ) )
-    {
-      printf( "\nWarning: Linear texture filtering not enabled!" );
-      success = false;
-    }
-    else
-    {
-      printf( "\nOK: linear texture filtering enabled" );
-    }
+  accumulator += frameTime;
 
-    // Create window
-    g_Window = SDL_CreateWindow( "Pallina",
-                                  SDL_WINDOWPOS_UNDEFINED,
-                                  SDL_WINDOWPOS_UNDEFINED,
-                                  WINDOW_W_px,
-                                  WINDOW_H_px,
-                                  SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE | SDL_WINDOW_FULLSCREEN_DESKTOP );
+  const Uint64 updateStart = SDL_GetPerformanceCounter();
 
-    if( g_Window == NULL )
+  while ( accumulator >= PHYSICS_STEP_s )
+  {
+    if ( ScreenDot.isFixedPoint() )
     {
-      printf( "\nWindow could not be created! SDL Error: \"%s\"\n", SDL_GetError() );
-      success = false;
+      ScreenDot.ProcessMovement();
     }
     else
     {
-      printf( "\nOK: window created" );
-
-      // Create accelerated and vsynced renderer for window
-      g_Renderer = SDL_CreateRenderer( g_Window, INIT_FIRST_ONE, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC );
-
-      if( g_Renderer == NULL )
-      {
-        printf( "\nRenderer could not be created! SDL Error: %s", SDL_GetError() );
-        success = false;
-      }
-      else
-      {
-        printf( "\nOK: renderer created" );
-
-        // Initialize renderer color
-        SDL_SetRenderDrawColor( g_Renderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
-
-        // Initialize PNG loading
-        int imgFlags = IMG_INIT_PNG;
-
-        if( !( IMG_Init( imgFlags ) & imgFlags ) )
-        {
-          printf( "\nSDL_image could not initialize! SDL_image Error: %s", IMG_GetError() );
-          success = false;
-        }
-        else
-        {
-          printf( "\nOK: SDL_image initialised" );
-        }
-
-        // Initialize SDL_ttf
-        if( TTF_Init() == -1 )
-        {
-          printf( "\nSDL_ttf could not initialize! SDL_ttf Error: \"%s\"\n", TTF_GetError() );
-          success = false;
-        }
-        else
-        {
-          printf( "\nOK: SDL_ttf initialised" );
-        }
-
-      } // Renderer created
-
-    } // Window created
+      ScreenDot.ProcessMovement( REFERENCE_HZ / PHYSICS_HZ );
+    }
 
-  } // SDL initialised
+    Swarm.ProcessMovement( REFERENCE_HZ / PHYSICS_HZ );
+    accumulator -= PHYSICS_STEP_s;
+  }
 
-  return success;
+  return static_cast<double>( SDL_GetPerformanceCounter() - updateStart ) * 1000.0 / counterFrequency;
 }
 
 
 /**
- * @brief Loads all necessary media for this project.
+ * @brief Draws a frame: the camera follows the dot, the bodies are interpolated between their last
+ * two steps.
  *
- * @return true if loading was successful; false otherwise
+ * @param alpha How far the display is between the last two steps.
+ * @param swarmUpdate_ms Time spent updating the swarm, for the debug text.
  **/
-static bool loadMedia(void)
+static void renderFrame( Dot& ScreenDot, BallSwarm& Swarm, double alpha, double swarmUpdate_ms )
 {
-  // Loading success flag
-  bool success = true;
+  // The camera area
+  SDL_Rect camera = { 0, 0, WINDOW_W_px, WINDOW_H_px };
 
- // Open the font
-  g_Font = TTF_OpenFont( FontPath.c_str(), 28 );
+  // The lower wall tile
+  const SDL_Rect Wall_Lower{0, 0, WALL_W_px, WALL_H_px};
 
-  if( g_Font == NULL )
+  // Center the camera over the dot
+  camera.x = ( ScreenDot.getRenderPosX( alpha ) + ScreenDot.getWidth()  / 2 ) - WINDOW_W_px / 2;
+  camera.y = ( ScreenDot.getRenderPosY( alpha ) + ScreenDot.getHeigth() / 2 ) - WINDOW_H_px / 2;
+
+  // Keep the camera in bounds
+  if( camera.x < 0 )
   {
-    printf( "\nFailed to load lazy font! SDL_ttf Error: \"%s\"\n", TTF_GetError() );
-    success = false;
+    camera.x = 0;
   }
-  else
+  else { /* Camera's position is OK */ }
+
+  if( camera.y < 0 )
   {
-    printf( "\nOK: Lazy Font loaded" );
+    camera.y = 0;
   }
+  else { /* Camera's position is OK */ }
 
-  // Load dot texture
-  if ( !g_DotTexture.loadFromFile( DotPath.c_str() ) )
+  if( camera.x > LEVEL_W_px - camera.w )
   {
-    printf( "\nFailed to load dot texture!" );
-    success = false;
+    camera.x = LEVEL_W_px - camera.w;
   }
-  else
+  else { /* Camera's position is OK */ }
+
+  if( camera.y > LEVEL_H_px - camera.h )
   {
-    printf( "\nOK: dot texture loaded" );
+    camera.y = LEVEL_H_px - camera.h;
   }
+  else { /* Camera's position is OK */ }
+
+
+  // Draw into the capture's staging target, if recording
+  g_Capture.beginFrame();
+
+  // The scene at the dynamic resolution, the text and the debug overlay at the native one
+  g_Resolution.beginScene();
 
-  // Load background texture
-  if ( !g_BGTexture.loadFromFile( BackGroundPath.c_str() ) )
+  // Clear screen
+  SDL_SetRenderDrawColor( g_Renderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
+  SDL_RenderClear       ( g_Renderer );
+
+  // Render background
+  for ( auto& layer : g_BGLayers ) // Il background va sempre agganciato all'origine della finestra
   {
-    printf( "\nFailed to load background texture!\n" );
-    success = false;
+    layer.render( camera );
   }
-  else
+
+  // Render dot
+  Swarm.render( camera, alpha );
+
+  ScreenDot.render( camera.x, camera.y, alpha );
+
+  // Render lower wall
+  renderLowerWall( camera, Wall_Lower );
+
+  g_Resolution.endScene();
+
+  // Debug overlay: the level scaled down, with the camera and the dot on it
+  const SDL_Rect DebugMap{ DEBUG_MAP_X_px, DEBUG_MAP_Y_px, LEVEL_W_px / DEBUG_MAP_SCALE, LEVEL_H_px / DEBUG_MAP_SCALE };
+
+  LDebugDraw::fillRect( DebugMap, g_DebugMapBack );
+  LDebugDraw::rect    ( DebugMap, g_DebugMapBorder );
+  LDebugDraw::rect    ( SDL_Rect{ DebugMap.x + camera.x / DEBUG_MAP_SCALE, DebugMap.y + camera.y / DEBUG_MAP_SCALE,
+                                  camera.w / DEBUG_MAP_SCALE, camera.h / DEBUG_MAP_SCALE }, g_DebugCamera );
+  LDebugDraw::fillRect( SDL_Rect{ DebugMap.x + ScreenDot.getRenderPosX( alpha ) / DEBUG_MAP_SCALE,
+                                  DebugMap.y + ScreenDot.getRenderPosY( alpha ) / DEBUG_MAP_SCALE, 2, 2 }, g_DebugDot );
+
+  /************************************
+  * Stampa info di debugging on-screen
+  *************************************/
+
+  char DebugText[5][48]; // Formatted on the stack, no iostreams
+  int  NumOfDebugLines = 4;
+
+  snprintf( DebugText[0], sizeof(DebugText[0]), "x pos: %d"  , ScreenDot.getPosX() );
+  snprintf( DebugText[1], sizeof(DebugText[1]), "y pos: %d"  , ScreenDot.getPosY() );
+  snprintf( DebugText[2], sizeof(DebugText[2]), "x vel: %.*f", static_cast<int>(Dot::NUM_OF_DIGITS), ScreenDot.getVelX_Debug() );
+  snprintf( DebugText[3], sizeof(DebugText[3]), "y vel: %.*f", static_cast<int>(Dot::NUM_OF_DIGITS), ScreenDot.getVelY_Debug() );
+
+  if ( Swarm.getNumOfBalls() != 0 )
   {
-    printf( "\nOK: background texture loaded" );
+    snprintf( DebugText[4], sizeof(DebugText[4]), "balls: %zu, update: %.2f ms", Swarm.getNumOfBalls(), swarmUpdate_ms );
+    ++NumOfDebugLines;
   }
+  else {;}
 
-  // Load sprite sheet
-  if ( !g_SSTexture.loadFromFile( SpriteSheetPath.c_str() ) )
+  // Centred in the window, one line each
+  const int LineHeight = g_TextAtlas.getLineHeight();
+
+  for ( int i = 0; i != NumOfDebugLines; ++i )
   {
-    printf( "\nFailed to load sprite sheet texture!\n" );
-    success = false;
+    g_TextAtlas.queue( ( WINDOW_W_px - g_TextAtlas.getTextWidth( DebugText[i] ) ) / 2,
+                       ( WINDOW_H_px - LineHeight ) / 2 + i * LineHeight,
+                       DebugText[i], g_TextColorGold );
+  }
+
+  g_TextAtlas.flush();
+
+  LDebugDraw::render( g_Renderer );
+
+  // Copy the frame on the window and read back the previous one for the capture
+  g_Capture.endFrame();
+
+  // Update screen, end the frame's arena, and adapt the resolution or the latch to how long the frame took
+  if ( g_Latch.IsEnabled() )
+  {
+    g_Latch.present( g_Renderer );
   }
   else
   {
-    printf( "\nOK: sprite sheet texture loaded" );
+    g_Resolution.present( g_Renderer );
   }
-
-  return success;
 }
 
 
-static void close(void)
+/**
+ * @brief Simulation thread of the threaded pipeline. Steps the bodies at the fixed rate, applying
+ * the key events queued by the main thread, and publishes their state after every batch of steps;
+ * in the meantime the main thread renders the previous one.
+ *
+ * @param data The Simulation.
+ **/
+static int runSimulation( void* data )
 {
-  // Free loaded images
-  g_DotTexture.free();
-  g_BGTexture.free();
+  Simulation& Sim = *static_cast<Simulation*>( data );
 
-  // Destroy window
-  SDL_DestroyRenderer( g_Renderer );
-  SDL_DestroyWindow  ( g_Window );
-  g_Renderer = NULL;
-  g_Window   = NULL;
+  double accumulator = 0.0;
+  Uint64 prevCounter = SDL_GetPerformanceCounter();
 
-  // Quit SDL subsystems
-  IMG_Quit();
-  SDL_Quit();
+  while ( SDL_AtomicGet( &Sim.Quit ) == 0 )
+  {
+    SDL_Event e;
+
+    while ( Sim.Input.pop( e ) )
+    {
+      Sim.ScreenDot.handleEvent( e );
+    }
+
+    // Not even a step due: the core goes to the renderer
+    if ( accumulator + static_cast<double>( SDL_GetPerformanceCounter() - prevCounter ) / static_cast<double>( SDL_GetPerformanceFrequency() ) < PHYSICS_STEP_s )
+    {
+      SDL_Delay(1);
+      continue;
+    }
+    else {;}
+
+    const double swarmUpdate_ms = stepSimulation( Sim.ScreenDot, Sim.Swarm, accumulator, prevCounter );
+
+    FrameState& Frame = Sim.Frames.GetBack();
+
+    Frame.ScreenDot      = Sim.ScreenDot;
+    Frame.Swarm.copyPositions( Sim.Swarm );
+    Frame.Alpha          = accumulator / PHYSICS_STEP_s;
+    Frame.SwarmUpdate_ms = swarmUpdate_ms;
+
+    Sim.Frames.publish();
+  }
+
+  return 0;
 }
 
 
@@ -897,13 +2851,97 @@ int main( int argc, char* args[] )
   printf("\n*** Debugging console ***\n");
   printf("\nProgram started with %d additional arguments.", argc - 1); // Il primo argomento è il nome dell'eseguibile
 
+  // "--balls=<N>" enables the many-body benchmark
+  size_t NumOfBalls = 0;
+
+  // "--threaded" runs the simulation on its own thread
+  bool IsThreaded = false;
+
+  // "--replay=<file>" runs headless, "--steps=<N>" sets how long
+  const char*   ReplayPath = NULL;
+  unsigned long NumOfSteps = 0;
+
+  // "--batch=<file>" runs the scenarios of the file headless, replaying "--replay" in each, and
+  // writes their results to "--out=<file>" (CSV, or binary if it ends in ".bin")
+  const char* BatchPath = NULL;
+  const char* OutPath   = BatchResultsPath;
+
+  // "--capture=<file>" records the frames: raw video if it ends in ".raw", PNG files otherwise
+  const char* CapturePath = NULL;
+
+  // "--native" keeps the scene at the native resolution, however long the frames take
+  bool IsNative = false;
+
+  // "--fixed" runs the physics of the dot in 16.16 fixed point: the same bits on every platform, for
+  // replays checked in lockstep
+  bool IsFixedPoint = false;
+
+  // "--late-latch" delays the start of each frame to just before the next refresh; the scene stays
+  // at the native resolution, the time the dynamic resolution would spend on pixels going to latency
+  bool IsLateLatched = false;
+
   for (int i = 1; i != argc; ++i)
   {
     printf("\nArgument #%d: %s\n", i, args[i]);
+
+    if ( strncmp( args[i], "--balls=", strlen("--balls=") ) == 0 )
+    {
+      NumOfBalls = strtoul( args[i] + strlen("--balls="), NULL, 10 );
+    }
+    else if ( strncmp( args[i], "--replay=", strlen("--replay=") ) == 0 )
+    {
+      ReplayPath = args[i] + strlen("--replay=");
+    }
+    else if ( strncmp( args[i], "--steps=", strlen("--steps=") ) == 0 )
+    {
+      NumOfSteps = strtoul( args[i] + strlen("--steps="), NULL, 10 );
+    }
+    else if ( strncmp( args[i], "--batch=", strlen("--batch=") ) == 0 )
+    {
+      BatchPath = args[i] + strlen("--batch=");
+    }
+    else if ( strncmp( args[i], "--out=", strlen("--out=") ) == 0 )
+    {
+      OutPath = args[i] + strlen("--out=");
+    }
+    else if ( strncmp( args[i], "--capture=", strlen("--capture=") ) == 0 )
+    {
+      CapturePath = args[i] + strlen("--capture=");
+    }
+    else if ( strcmp( args[i], "--threaded" ) == 0 )
+    {
+      IsThreaded = true;
+    }
+    else if ( strcmp( args[i], "--native" ) == 0 )
+    {
+      IsNative = true;
+    }
+    else if ( strcmp( args[i], "--late-latch" ) == 0 )
+    {
+      IsLateLatched = true;
+    }
+    else if ( strcmp( args[i], "--fixed" ) == 0 )
+    {
+      IsFixedPoint = true;
+    }
+    else {;}
   }
 
+  if ( BatchPath != NULL )
+  {
+    HasProgramSucceeded = runBatch( BatchPath, ReplayPath, NumOfSteps, NumOfBalls, OutPath, IsFixedPoint );
+  }
+  else if ( ReplayPath != NULL )
+  {
+    HasProgramSucceeded = runReplay( ReplayPath, NumOfSteps, NumOfBalls, IsFixedPoint );
+  }
+  // "--perf-frames=<N>" runs the full program headless, scripted and checked against a budget
+  else if ( !LPerfHarness::configure( argc, args ) )
+  {
+    HasProgramSucceeded = false;
+  }
   // Start up SDL and create window
-  if( !init() )
+  else if( !init() )
   {
     printf( "\nFailed to initialize!" );
   }
@@ -920,134 +2958,162 @@ int main( int argc, char* args[] )
     {
       printf( "\nOK: all media loaded" );
 
+      if ( CapturePath != NULL )
+      {
+        g_Capture.start( g_Renderer, CapturePath, LFrameCapture::GetFormatOf( CapturePath ) );
+      }
+      else {;}
+
+      // A frame per refresh at 60 Hz or less, 60 fps on faster displays; not while measuring
+      if ( IsLateLatched && !LPerfHarness::isActive() )
+      {
+        g_Latch.matchDisplay( g_Window );
+        g_Latch.setEnabled( true );
+      }
+      else if ( !IsNative && !LPerfHarness::isActive() )
+      {
+        SDL_DisplayMode Mode;
+        double          Budget = LDynamicResolution::s_DEFAULT_BUDGET_s;
+
+        if ( SDL_GetWindowDisplayMode( g_Window, &Mode ) == 0 && Mode.refresh_rate > 0 )
+        {
+          Budget = std::max( Budget, 1.0 / Mode.refresh_rate );
+        }
+        else {;}
+
+        g_Resolution.create( g_Renderer, WINDOW_W_px, WINDOW_H_px, Budget );
+      }
+      else {;}
+
       // Main loop flag
       bool quit = false;
 
       // Event handler
       SDL_Event e;
 
-      // The dot that will be moving around on the screen
-      Dot ScreenDot;
+      if ( !IsThreaded )
+      {
+        // The dot that will be moving around on the screen
+        Dot ScreenDot;
+        ScreenDot.setFixedPoint( IsFixedPoint );
 
-      // The camera area
-      SDL_Rect camera = { 0, 0, WINDOW_W_px, WINDOW_H_px };
+        // The balls of the many-body benchmark, if enabled
+        BallSwarm Swarm;
+        Swarm.spawn( NumOfBalls );
 
-      // The lower wall tile
-      SDL_Rect Wall_Lower{0, 0, WALL_W_px, WALL_H_px};
+        // Time not yet simulated
+        double accumulator = 0.0;
+        Uint64 prevCounter = SDL_GetPerformanceCounter();
 
-      // While application is running
-      while( !quit )
-      {
-        // Handle events on queue
-        while( SDL_PollEvent( &e ) != 0 )
+        // While application is running
+        while( !quit )
         {
-          // User requests quit
-          if( e.type == SDL_QUIT )
+          // Hold the frame back to the latest start that makes the next refresh, if late latching
+          g_Latch.wait();
+
+          // Scripted input of this frame, if any
+          LPerfHarness::beginFrame();
+
+          // Handle events on queue
+          while( SDL_PollEvent( &e ) != 0 )
           {
-            quit = true;
+            // User requests quit
+            if( e.type == SDL_QUIT )
+            {
+              quit = true;
+            }
+            else { /* ignore event */ }
+
+            // Handle input for the dot
+            ScreenDot.handleEvent( e );
+
+            // F3 shows the debug overlay
+            LDebugDraw::handleEvent( e );
           }
-          else { /* ignore event */ }
-
-          // Handle input for the dot
-          ScreenDot.handleEvent( e );
-        }
 
-        // Move the dot
-        ScreenDot.ProcessMovement();
+          // Move the dot, in fixed steps covering the elapsed time
+          const double swarmUpdate_ms = stepSimulation( ScreenDot, Swarm, accumulator, prevCounter );
 
-        // Center the camera over the dot
-        camera.x = ( ScreenDot.getPosX() + ScreenDot.getWidth()  / 2 ) - WINDOW_W_px / 2;
-        camera.y = ( ScreenDot.getPosY() + ScreenDot.getHeigth() / 2 ) - WINDOW_H_px / 2;
+          // Draw, "accumulator / PHYSICS_STEP_s" being how far the display is between the last two steps
+          renderFrame( ScreenDot, Swarm, accumulator / PHYSICS_STEP_s, swarmUpdate_ms );
 
-        // Keep the camera in bounds
-        if( camera.x < 0 )
-        {
-          camera.x = 0;
-        }
-        else { /* Camera's position is OK */ }
+          LPerfHarness::endFrame();
 
-        if( camera.y < 0 )
-        {
-          camera.y = 0;
-        }
-        else { /* Camera's position is OK */ }
+        } // Main loop
+      }
+      else
+      {
+        // The simulation runs on its own thread, one frame ahead of the renderer
+        Simulation* Simulation_Ptr = new Simulation;
+        Simulation_Ptr->ScreenDot.setFixedPoint( IsFixedPoint );
+        Simulation_Ptr->Swarm.spawn( NumOfBalls );
 
-        if( camera.x > LEVEL_W_px - camera.w )
-        {
-          camera.x = LEVEL_W_px - camera.w;
-        }
-        else { /* Camera's position is OK */ }
+        SDL_Thread* SimulationThread = SDL_CreateThread( runSimulation, "Simulation", Simulation_Ptr );
 
-        if( camera.y > LEVEL_H_px - camera.h )
+        if ( SimulationThread == NULL )
         {
-          camera.y = LEVEL_H_px - camera.h;
+          printf( "\nUnable to create the simulation thread! SDL Error: %s", SDL_GetError() );
+          HasProgramSucceeded = false;
+          quit                = true;
         }
-        else { /* Camera's position is OK */ }
-
-
-        // Clear screen
-        SDL_SetRenderDrawColor( g_Renderer, WHITE_R, WHITE_G, WHITE_B, WHITE_A );
-        SDL_RenderClear       ( g_Renderer );
-
-        // Render background
-        g_BGTexture.render( 0, 0, &camera ); // x = 0, y = 0 --> Il background va sempre agganciato all'origine della finestra
-
-        // Render dot
-        ScreenDot.render( camera.x, camera.y );
-
-        int NumOfWallTiles( LEVEL_W_px / WALL_W_px );
+        else {;}
 
-        // Render lower wall
-        for ( int i = 0; i != NumOfWallTiles; ++i )
+        while( !quit )
         {
-          g_SSTexture.render( i * WALL_W_px - camera.x, ( LEVEL_H_px - WALL_H_px ) - camera.y, &Wall_Lower );
-        }
+          g_Latch.wait();
 
-        /************************************
-        * Stampa info di debugging on-screen
-        *************************************/
+          LPerfHarness::beginFrame();
 
-        std::stringstream StringStream_xPos;
-        std::stringstream StringStream_yPos;
-        std::stringstream StringStream_xVel;
-        std::stringstream StringStream_yVel;
+          // Events are handled here, the key presses are forwarded to the simulation
+          while( SDL_PollEvent( &e ) != 0 )
+          {
+            if( e.type == SDL_QUIT )
+            {
+              quit = true;
+            }
+            else if ( ( e.type == SDL_KEYDOWN || e.type == SDL_KEYUP ) && !Simulation_Ptr->Input.push( e ) )
+            {
+              printf( "\nInput queue full: key event dropped" );
+            }
+            else { /* ignore event */ }
+
+            // F3 shows the debug overlay
+            LDebugDraw::handleEvent( e );
+          }
 
-        StringStream_xPos << "x pos: " << std::fixed << std::setprecision(Dot::NUM_OF_DIGITS) << ScreenDot.getPosX();
-        StringStream_yPos << "y pos: " << std::fixed << std::setprecision(Dot::NUM_OF_DIGITS) << ScreenDot.getPosY();
-        StringStream_xVel << "x vel: " << std::fixed << std::setprecision(Dot::NUM_OF_DIGITS) << ScreenDot.getVelX_Debug();
-        StringStream_yVel << "y vel: " << std::fixed << std::setprecision(Dot::NUM_OF_DIGITS) << ScreenDot.getVelY_Debug();
+          // Renders the latest step published, or the last one again if none is newer
+          Simulation_Ptr->Frames.acquire();
 
-        g_xPosText_Debug.loadFromRenderedText(StringStream_xPos.str(), g_TextColorGold );
-        g_yPosText_Debug.loadFromRenderedText(StringStream_yPos.str(), g_TextColorGold );
-        g_xVelText_Debug.loadFromRenderedText(StringStream_xVel.str(), g_TextColorGold );
-        g_yVelText_Debug.loadFromRenderedText(StringStream_yVel.str(), g_TextColorGold );
+          FrameState& Frame = Simulation_Ptr->Frames.GetFront();
 
-        // Position of debugging text
-        int xPosText_xPos_Debug = ( WINDOW_W_px - g_xPosText_Debug.getWidth()  ) / 2;
-        int xPosText_yPos_Debug = ( WINDOW_H_px - g_xPosText_Debug.getHeight() ) / 2 + 0 * g_yPosText_Debug.getHeight();
-        int yPosText_xPos_Debug = ( WINDOW_W_px - g_yPosText_Debug.getWidth()  ) / 2;
-        int yPosText_yPos_Debug = ( WINDOW_H_px - g_yPosText_Debug.getHeight() ) / 2 + 1 * g_yPosText_Debug.getHeight();
+          renderFrame( Frame.ScreenDot, Frame.Swarm, Frame.Alpha, Frame.SwarmUpdate_ms );
 
-        int xVelText_xPos_Debug = ( WINDOW_W_px - g_xVelText_Debug.getWidth()  ) / 2;
-        int xVelText_yPos_Debug = ( WINDOW_H_px - g_xVelText_Debug.getHeight() ) / 2 + 2 * g_xVelText_Debug.getHeight();
-        int yVelText_xPos_Debug = ( WINDOW_W_px - g_yVelText_Debug.getWidth()  ) / 2;
-        int yVelText_yPos_Debug = ( WINDOW_H_px - g_yVelText_Debug.getHeight() ) / 2 + 3 * g_yVelText_Debug.getHeight();
+          LPerfHarness::endFrame();
 
-        g_xPosText_Debug.render( xPosText_xPos_Debug, xPosText_yPos_Debug );
-        g_yPosText_Debug.render( yPosText_xPos_Debug, yPosText_yPos_Debug );
-        g_xVelText_Debug.render( xVelText_xPos_Debug, xVelText_yPos_Debug );
-        g_yVelText_Debug.render( yVelText_xPos_Debug, yVelText_yPos_Debug );
+        } // Main loop
 
-        // Update screen
-        SDL_RenderPresent( g_Renderer );
+        if ( SimulationThread != NULL )
+        {
+          SDL_AtomicSet( &Simulation_Ptr->Quit, 1 );
+          SDL_WaitThread( SimulationThread, NULL );
+        }
+        else {;}
 
-      } // Main loop
+        delete Simulation_Ptr;
+      }
 
     } // All media loaded
 
   } // All systems initialised
 
-  close(); // Free resources and close SDL
+  if ( ReplayPath == NULL && BatchPath == NULL )
+  {
+    close(); // Free resources and close SDL
+  }
+  else { /* Headless: nothing was created */ }
+
+  // Frame times, allocations and draw calls against the budget, if it was a performance run
+  HasProgramSucceeded = LPerfHarness::finish() && HasProgramSucceeded;
 
   // Integrity check
   if ( HasProgramSucceeded == true )
@@ -1059,7 +3125,11 @@ int main( int argc, char* args[] )
     printf("\nThere was a problem during the execution of the program!\n");
   }
 
-  PressEnter();
+  if ( ReplayPath == NULL && BatchPath == NULL && !LPerfHarness::isActive() )
+  {
+    PressEnter();
+  }
+  else { /* Do not block scripted runs */ }
 
-  return 0;
+  return HasProgramSucceeded ? 0 : 1;
 }
\ No newline at end of file